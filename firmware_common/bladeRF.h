@@ -48,6 +48,109 @@
 #define BLADE_USB_CMD_GET_LOOPBACK            114
 #define BLADE_USB_CMD_READ_LOG_ENTRY          115
 
+/* Multi-page flash transfers, over the bulk endpoints of USB_IF_SPI_FLASH.
+ * wIndex is the first page and wValue is the number of pages. The command
+ * returns an int32_t status, after which the pages are streamed over the
+ * peripheral IN endpoint (read) or are expected on the peripheral OUT
+ * endpoint (write). BLADE_USB_CMD_FLASH_PAGES_STATUS returns the status of
+ * the last transfer, once it has completed. */
+#define BLADE_USB_CMD_FLASH_READ_PAGES        116
+#define BLADE_USB_CMD_FLASH_WRITE_PAGES       117
+#define BLADE_USB_CMD_FLASH_PAGES_STATUS      118
+
+/* SHA-256 digest of a range of flash pages, computed by the firmware.
+ * wIndex is the first page and wValue is the number of pages, which may not
+ * exceed BLADE_FLASH_HASH_MAX_PAGES. The command returns an int32_t status,
+ * followed by the 32-byte digest. */
+#define BLADE_USB_CMD_FLASH_SHA256            119
+
+#define BLADE_FLASH_HASH_MAX_PAGES 1024
+#define BLADE_FLASH_HASH_RESP_SIZE (4 + 32)
+
+/* Wait for the FPGA to assert CONF_DONE. wValue is the maximum time to wait
+ * in milliseconds, which is limited to BLADE_FPGA_CONF_WAIT_MAX_MS. Like
+ * BLADE_USB_CMD_QUERY_FPGA_STATUS, the command returns an int32_t of 1 if
+ * the FPGA is configured, 0 if it is not, or -1 on error. */
+#define BLADE_USB_CMD_WAIT_FPGA_CONFIGURED    120
+
+#define BLADE_FPGA_CONF_WAIT_MAX_MS 500
+
+/* Digest of the FPGA bitstream loaded by the host, which the firmware holds
+ * in RAM until the FPGA is next programmed. BLADE_USB_CMD_SET_FPGA_HASH
+ * receives the BLADE_FPGA_HASH_SIZE byte digest in its data stage.
+ * BLADE_USB_CMD_GET_FPGA_HASH returns an int32_t of 0 if a digest has been
+ * recorded since the FPGA was last programmed, or -1 otherwise, followed by
+ * the digest. */
+#define BLADE_USB_CMD_SET_FPGA_HASH           121
+#define BLADE_USB_CMD_GET_FPGA_HASH           122
+
+#define BLADE_FPGA_HASH_SIZE 32
+#define BLADE_FPGA_HASH_RESP_SIZE (4 + BLADE_FPGA_HASH_SIZE)
+
+/* DMA buffering of the sample endpoints, applied the next time the RF link
+ * interface is selected. BLADE_USB_CMD_SET_SAMPLE_DMA takes the number of
+ * buffers per direction in wValue and the size of each buffer, in units of
+ * the endpoint's maximum packet size, in wIndex. A wValue of 0 restores the
+ * defaults. The command returns an int32_t of 0 on success, or -1 if the
+ * configuration is out of range or would use more than
+ * BLADE_SAMPLE_DMA_MAX_BYTES per direction at the current USB speed.
+ *
+ * BLADE_USB_CMD_GET_SAMPLE_DMA returns an int32_t holding the buffer count
+ * in its upper 16 bits and the buffer size, in packets, in its lower 16
+ * bits. */
+#define BLADE_USB_CMD_SET_SAMPLE_DMA          123
+#define BLADE_USB_CMD_GET_SAMPLE_DMA          124
+
+#define BLADE_SAMPLE_DMA_DEFAULT_COUNT      22
+#define BLADE_SAMPLE_DMA_DEFAULT_PACKETS    2
+#define BLADE_SAMPLE_DMA_MIN_COUNT          2
+#define BLADE_SAMPLE_DMA_MAX_COUNT          64
+#define BLADE_SAMPLE_DMA_MAX_PACKETS        32
+#define BLADE_SAMPLE_DMA_MAX_BYTES          (96 * 1024)
+
+/* Counters of the sample paths, kept since the firmware started or was last
+ * reset. The command returns BLADE_FW_STATS_SIZE bytes: an array of
+ * little-endian uint32_t counters, indexed by BLADE_FW_STATS_IDX_*. The
+ * first holds the number of counters that follow, so that counters may be
+ * appended in later versions. A wValue of 1 resets the counters after they
+ * have been read.
+ *
+ * Buffers are counted in units of the sample DMA buffer size at the time.
+ * Overruns and underruns are errors reported by the FX3's parallel
+ * interface (PIB) when the FPGA writes to a socket with no free buffer, or
+ * reads from one with no data. USB retries and errors are only counted at
+ * SuperSpeed. */
+#define BLADE_USB_CMD_GET_FW_STATS            125
+
+#define BLADE_FW_STATS_IDX_COUNT            0
+#define BLADE_FW_STATS_IDX_TX_BUFFERS       1   /* Host to FPGA */
+#define BLADE_FW_STATS_IDX_RX_BUFFERS       2   /* FPGA to host */
+#define BLADE_FW_STATS_IDX_RX_OVERRUNS      3
+#define BLADE_FW_STATS_IDX_TX_UNDERRUNS     4
+#define BLADE_FW_STATS_IDX_PIB_ERRORS       5   /* Other PIB and GPIF errors */
+#define BLADE_FW_STATS_IDX_USB_RETRIES      6
+#define BLADE_FW_STATS_IDX_USB_PHY_ERRORS   7
+#define BLADE_FW_STATS_IDX_USB_LINK_ERRORS  8
+#define BLADE_FW_STATS_NUM                  9
+#define BLADE_FW_STATS_SIZE                 (4 * BLADE_FW_STATS_NUM)
+
+/* Compressed FPGA bitstreams, selected by passing BLADE_FPGA_PROG_COMPRESSED
+ * as the wValue of BLADE_USB_CMD_BEGIN_PROG.
+ *
+ * A compressed bitstream is a sequence of BLADE_FPGA_CBLOCK_SIZE byte blocks,
+ * of which only the last may be shorter. Each block begins with the
+ * little-endian uint16_t length of the tokens that follow it, and the
+ * remainder of the block is ignored. The tokens are:
+ *
+ *  0x00-0x7f   Literal: (token + 1) bytes follow
+ *  0x80-0xff   Run: ((token & 0x7f) << 8 | next byte) + 1 repetitions of
+ *              the byte that follows
+ *
+ * A block may not decode to more than BLADE_FPGA_CBLOCK_MAX_RAW bytes. */
+#define BLADE_FPGA_PROG_COMPRESSED  1
+#define BLADE_FPGA_CBLOCK_SIZE      512
+#define BLADE_FPGA_CBLOCK_MAX_RAW   4096
+
 /* String descriptor indices */
 #define BLADE_USB_STR_INDEX_MFR     1   /* Manufacturer */
 #define BLADE_USB_STR_INDEX_PRODUCT 2   /* Product */
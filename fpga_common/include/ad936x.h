@@ -820,6 +820,12 @@ int32_t ad9361_set_rx_fir_config(struct ad9361_rf_phy *phy,
 int32_t ad9361_set_rx_fir_en_dis(struct ad9361_rf_phy *phy, uint8_t en_dis);
 int32_t ad9361_set_rx_rf_port_input(struct ad9361_rf_phy *phy, uint32_t mode);
 int32_t ad9361_get_rx_rf_port_input(struct ad9361_rf_phy *phy, uint32_t *mode);
+int32_t ad9361_set_rx_rfdc_track_en_dis(struct ad9361_rf_phy *phy,
+                                        uint8_t en_dis);
+int32_t ad9361_set_rx_bbdc_track_en_dis(struct ad9361_rf_phy *phy,
+                                        uint8_t en_dis);
+int32_t ad9361_set_rx_quad_track_en_dis(struct ad9361_rf_phy *phy,
+                                        uint8_t en_dis);
 int32_t ad9361_set_tx_attenuation(struct ad9361_rf_phy *phy,
                                   uint8_t ch,
                                   uint32_t attenuation_mdb);
@@ -854,5 +860,11 @@ int32_t ad9361_tx_fastlock_save(struct ad9361_rf_phy *phy,
                                 uint32_t profile,
                                 uint8_t *values);
 int32_t ad9361_set_no_ch_mode(struct ad9361_rf_phy *phy, uint8_t no_ch_mode);
+int32_t ad9361_set_trx_path_clks(struct ad9361_rf_phy *phy,
+                                 uint32_t *rx_path_clks,
+                                 uint32_t *tx_path_clks);
+int32_t ad9361_get_trx_path_clks(struct ad9361_rf_phy *phy,
+                                 uint32_t *rx_path_clks,
+                                 uint32_t *tx_path_clks);
 
 #endif  // AD936X_H_
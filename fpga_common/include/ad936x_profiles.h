@@ -0,0 +1,62 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef FPGA_COMMON_AD936X_PROFILES_H_
+#define FPGA_COMMON_AD936X_PROFILES_H_
+
+#include <stdint.h>
+
+/**
+ * Precomputed AD9361 clock chains
+ *
+ * For commonly used sample rates, the BBPLL frequency and the ADC, HB3, HB2,
+ * HB1, FIR and data path clocks are tabulated here, so that the divider
+ * search performed by ad9361_set_rx_sampling_freq() and
+ * ad9361_set_tx_sampling_freq() may be skipped. Each profile is only valid
+ * with the FIR decimation/interpolation ratio it was computed for, which
+ * matches the filter selected for that rate by the bladeRF 2.0 RFIC code.
+ *
+ * The clock arrays are in the order expected by ad9361_set_trx_path_clks():
+ * { BBPLL, ADC/DAC, R2/T2, R1/T1, CLKRF/CLKTF, RX/TX sample }, in Hz.
+ */
+
+#define AD936X_PROFILE_CLKS 6
+
+struct ad936x_profile {
+    uint32_t sample_rate; /**< Sample rate, in Hz */
+    uint32_t fir_ratio;   /**< FIR decimation/interpolation ratio */
+    uint32_t rx_path_clks[AD936X_PROFILE_CLKS];
+    uint32_t tx_path_clks[AD936X_PROFILE_CLKS];
+};
+
+/**
+ * @brief       Find the profile for a sample rate
+ *
+ * @param[in]   sample_rate     Sample rate, in Hz
+ * @param[in]   fir_ratio       FIR decimation/interpolation ratio in use,
+ *                              or 1 if the FIR is bypassed
+ *
+ * @return      Profile, or NULL if none matches
+ */
+struct ad936x_profile const *ad936x_profile_find(uint32_t sample_rate,
+                                                 uint32_t fir_ratio);
+
+#endif  // FPGA_COMMON_AD936X_PROFILES_H_
@@ -193,7 +193,13 @@ typedef enum {
      *    +================+========================+
      *    |      Bit(s)    |         Value          |
      *    +================+========================+
-     *    |      63:16     | Reserved. Set to 0.    |
+     *    |      63:32     | Reserved. Set to 0.    |
+     *    +----------------+------------------------+
+     *    |      31:24     | high-water mark of the |
+     *    |                | write queue            |
+     *    +----------------+------------------------+
+     *    |      23:16     | capacity of the write  |
+     *    |                | queue; 0 if unreported |
      *    +----------------+------------------------+
      *    |      15:8      | count of items in      |
      *    |                | write queue            |
@@ -273,6 +279,17 @@ typedef enum {
      */
     BLADERF_RFIC_COMMAND_FASTLOCK = 0x0B,
 
+    /** Wait for the write queue to drain. (Read)
+     *
+     * Pass ::BLADERF_CHANNEL_INVALID as the `ch` parameter.
+     *
+     * The response is withheld until every queued write has been executed.
+     * It then returns the status register, as ::BLADERF_RFIC_COMMAND_STATUS.
+     * This allows the host to wait upon queued writes with a single request,
+     * rather than by polling the status register.
+     */
+    BLADERF_RFIC_COMMAND_WAIT = 0x0C,
+
     /** User-defined functionality (placeholder 1) */
     BLADERF_RFIC_COMMAND_USER_001 = 0x80,
 
@@ -287,7 +304,12 @@ typedef enum {
  *  +===============+===================================================+
  *  |      Bit(s)   |         Value                                     |
  *  +===============+===================================================+
- *  |      63:16    | Reserved. Set to 0.                               |
+ *  |      63:32    | Reserved. Set to 0.                               |
+ *  +---------------+---------------------------------------------------+
+ *  |      31:24    | largest count of items in write queue since the   |
+ *  |               | NIOS II started                                   |
+ *  +---------------+---------------------------------------------------+
+ *  |      23:16    | capacity of write queue. Older firmware reports 0 |
  *  +---------------+---------------------------------------------------+
  *  |      15:8     | count of items in write queue                     |
  *  +---------------+---------------------------------------------------+
@@ -304,6 +326,10 @@ typedef enum {
 #define BLADERF_RFIC_STATUS_WQSUCCESS_MASK   0x1
 #define BLADERF_RFIC_STATUS_WQLEN_SHIFT      8
 #define BLADERF_RFIC_STATUS_WQLEN_MASK       0xff
+#define BLADERF_RFIC_STATUS_WQMAX_SHIFT      16
+#define BLADERF_RFIC_STATUS_WQMAX_MASK       0xff
+#define BLADERF_RFIC_STATUS_WQHWM_SHIFT      24
+#define BLADERF_RFIC_STATUS_WQHWM_MASK       0xff
 
 #define BLADERF_RFIC_RSSI_MULT_SHIFT         32
 #define BLADERF_RFIC_RSSI_MULT_MASK          0xFFFF
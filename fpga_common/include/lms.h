@@ -37,6 +37,11 @@
 #   include "board/board.h"
 #   define LMS_WRITE(dev, addr, value) dev->backend->lms_write(dev, addr, value)
 #   define LMS_READ(dev, addr, value)  dev->backend->lms_read(dev, addr, value)
+#   define LMS_BATCH(dev, ops, count)  dev->backend->lms_batch(dev, ops, count)
+#   define LMS_READ_BLOCK(dev, addr, data, count) \
+        dev->backend->lms_block(dev, false, addr, data, count)
+#   define LMS_WRITE_BLOCK(dev, addr, data, count) \
+        dev->backend->lms_block(dev, true, addr, data, count)
 #else
 #   include "libbladeRF_nios_compat.h"
 #   include "devices.h"
@@ -60,6 +65,24 @@
  */
 #define LMS_FREQ_FLAGS_FORCE_VCOCAP   (1 << 1)
 
+/**
+ * Set by lms_set_precalculated_frequency() if VTUNE reported the PLL to be
+ * in its normal range once the retune completed. Ignored on input.
+ */
+#define LMS_FREQ_FLAGS_LOCKED         (1 << 2)
+
+/**
+ * Used in bladerf_quick_tune.flags to denote that the quick tune carries DC
+ * offset corrections to apply along with the retune
+ */
+#define LMS_FREQ_FLAGS_DC_CORR        (1 << 3)
+
+/**
+ * Used in bladerf_quick_tune.flags to denote that the quick tune carries IQ
+ * balance corrections to apply along with the retune
+ */
+#define LMS_FREQ_FLAGS_IQ_CORR        (1 << 4)
+
 /**
  * This bit indicates whether the quicktune needs to set XB-200 parameters
  */
@@ -115,6 +138,15 @@ struct lms_freq {
                                      which VCOCAP value was used */
 };
 
+/**
+ * LMS6002D gain stage register values for a module's overall gain
+ */
+struct lms_gain_regs {
+    uint8_t lna;    /**< RX LNA gain, as a bladerf_lna_gain. Unused for TX. */
+    uint8_t vga1;   /**< RXVGA1 (0x76) or TXVGA1 (0x41) register value */
+    uint8_t vga2;   /**< RXVGA2 (0x65) or TXVGA2 (0x45[7:3]) register value */
+};
+
 /* For >= 1.5 GHz uses the high band should be used. Otherwise, the low
  * band should be selected */
 #define BLADERF1_BAND_HIGH 1500000000
@@ -501,6 +533,44 @@ int lms_txvga1_set_gain(struct bladerf *dev, int gain);
  */
 int lms_txvga1_get_gain(struct bladerf *dev, int *gain);
 
+/**
+ * Compute the RX gain stage register values for the specified stage gains.
+ * Out of range gains are clamped.
+ *
+ * @param[in]   lna     LNA gain
+ * @param[in]   rxvga1  RXVGA1 gain in dB (range: 5 to 30)
+ * @param[in]   rxvga2  RXVGA2 gain in dB (range: 0 to 30)
+ * @param[out]  regs    Register values
+ */
+void lms_rx_gain_regs(bladerf_lna_gain lna, int rxvga1, int rxvga2,
+                      struct lms_gain_regs *regs);
+
+/**
+ * Compute the TX gain stage register values for the specified stage gains.
+ * Out of range gains are clamped.
+ *
+ * @param[in]   txvga1  TXVGA1 gain in dB (range: -35 to -4)
+ * @param[in]   txvga2  TXVGA2 gain in dB (range: 0 to 25)
+ * @param[out]  regs    Register values
+ */
+void lms_tx_gain_regs(int txvga1, int txvga2, struct lms_gain_regs *regs);
+
+/**
+ * Apply gain stage register values to a module
+ *
+ * The gain registers are read in a single batch, and only those whose
+ * values change are then written, in a second batch.
+ *
+ * @param[in]   dev     Device handle
+ * @param[in]   module  Module to configure
+ * @param[in]   regs    Register values, from lms_rx_gain_regs() or
+ *                      lms_tx_gain_regs()
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int lms_set_gain_regs(struct bladerf *dev, bladerf_module module,
+                      const struct lms_gain_regs *regs);
+
 /**
  * Enable or disable a PA
  *
@@ -667,6 +737,26 @@ int lms_calculate_tuning_params(unsigned int freq, struct lms_freq *f);
 int lms_set_precalculated_frequency(struct bladerf *dev, bladerf_module mod,
                                     struct lms_freq *f);
 
+/**
+ * Search for the VCOCAP value that places VTUNE in the middle of its normal
+ * range, and then wait for VTUNE to settle there.
+ *
+ * The PLL must already be configured for the desired frequency, with the
+ * VCOCAP estimate written to the VCOCAP register. This is the search
+ * performed by lms_set_precalculated_frequency(), and is also run by the
+ * NIOS II on behalf of the host.
+ *
+ * @param[in]   dev             Device handle
+ * @param[in]   mod             Module to tune
+ * @param[in]   vcocap_est      Initial VCOCAP estimate
+ * @param[out]  vcocap_result   Selected VCOCAP value
+ * @param[out]  locked          Set true if VTUNE settled in its normal range
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int lms_tune_vcocap(struct bladerf *dev, bladerf_module mod,
+                    uint8_t vcocap_est, uint8_t *vcocap_result, bool *locked);
+
 /**
  * Set the frequency of a module in Hz
  *
@@ -712,6 +802,42 @@ int lms_dump_registers(struct bladerf *dev);
  */
 int lms_calibrate_dc(struct bladerf *dev, bladerf_cal_module module);
 
+/**
+ * Run the DC calibration loop of a single DC calibration register, per the
+ * LMS6002D calibration guide, section 4.1.
+ *
+ * The caller is responsible for enabling the module's calibration clock.
+ * This is used by the NIOS II to service NIOS_PKT_8x16_TARGET_LMS_DC_CAL
+ * requests.
+ *
+ * @param[in]   dev         Device handle
+ * @param[in]   base        Base address of the DC calibration module
+ * @param[in]   cal_address DC calibration register address within the module
+ * @param[in]   dc_cntval   Initial DC_CNTVAL value
+ * @param[out]  dc_regval   Resulting DC_REGVAL value
+ *
+ * @return 0 on success, BLADERF_ERR_UNEXPECTED if the loop did not converge,
+ *         or another BLADERF_ERR_* value on failure
+ */
+int lms_dc_cal_loop(struct bladerf *dev, uint8_t base,
+                    uint8_t cal_address, uint8_t dc_cntval,
+                    uint8_t *dc_regval);
+
+/**
+ * Load a value into a single DC calibration register, enabling the module's
+ * calibration clock for the duration of the load.
+ *
+ * @param[in]   dev         Device handle
+ * @param[in]   base        Base address of the DC calibration module
+ *                          (0x00, 0x30, 0x50, or 0x60)
+ * @param[in]   dc_addr     DC calibration register address within the module
+ * @param[in]   value       Value to load
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int lms_load_dc_cal_value(struct bladerf *dev, uint8_t base,
+                          uint8_t dc_addr, uint8_t value);
+
 /**
  * Load DC calibration values directly via device registers instead of
  * running autocalibration routines.
@@ -755,6 +881,16 @@ int lms_config_init(struct bladerf *dev, struct lms_xcvr_config *config);
  */
 int lms_select_band(struct bladerf *dev, bladerf_module module, bool low_band);
 
+/**
+ * Select the TX power amplifier
+ *
+ * @param[in]   dev         Device handle
+ * @param[in]   pa          PA to enable, or PA_NONE to disable all of them
+ *
+ * @return 0 on succes, BLADERF_ERR_* value on failure
+ */
+int lms_select_pa(struct bladerf *dev, lms_pa pa);
+
 /**
  * Select internal or external sampling
  *
@@ -775,6 +911,20 @@ int lms_select_sampling(struct bladerf *dev, bladerf_sampling sampling);
  */
 int lms_get_sampling(struct bladerf *dev, bladerf_sampling *sampling);
 
+/**
+ * Convert a DC offset value to the corresponding LMS6002D DC offset register
+ * value, as written by lms_set_dc_offset_i() and lms_set_dc_offset_q()
+ *
+ * For the RX module, bit 7 of the register is unrelated to the DC offset and
+ * is not included in the returned value.
+ *
+ * @param[in]   module      Module the value is for
+ * @param[in]   value       DC offset value, scaled to [-2048, 2048]
+ *
+ * @return Register value
+ */
+uint8_t lms_dc_offset_to_reg(bladerf_module module, int16_t value);
+
 /**
  * Set the DC offset value on the I channel
  *
@@ -102,6 +102,58 @@
 /* Target IDs */
 #define NIOS_PKT_16x64_TARGET_AD9361  0x00
 #define NIOS_PKT_16x64_TARGET_RFIC    0x01 /* RFIC control */
+#define NIOS_PKT_16x64_TARGET_FASTLOCK 0x02 /* Fast lock profile storage */
+
+/* Fast lock profile storage addressing
+ *
+ * Each of the Nios' RX and TX fast lock profiles holds 16 bytes of AD9361
+ * profile data, accessed as two 8-byte halves. The first profile byte is the
+ * least significant byte of the data field.
+ *
+ *    +================+==========================================+
+ *    |      Bit(s)    |                  Value                   |
+ *    +================+==========================================+
+ *    |       15       |   0 = RX profile, 1 = TX profile         |
+ *    +----------------+------------------------------------------+
+ *    |       14       |   0 = bytes 0-7, 1 = bytes 8-15          |
+ *    +----------------+------------------------------------------+
+ *    |     13:11      | Reserved. Set to 0.                      |
+ *    +----------------+------------------------------------------+
+ *    |     10:8       | RFFE profile number (writes only)        |
+ *    +----------------+------------------------------------------+
+ *    |      7:0       | Nios profile number                      |
+ *    +----------------+------------------------------------------+
+ *
+ * Writing bytes 0-7 invalidates the profile. Writing bytes 8-15 marks it as
+ * saved in the Nios but not loaded in the RFFE, with the given RFFE profile
+ * number, such that it is loaded into the AD9361 when next used by a retune.
+ */
+#define NIOS_PKT_16x64_FASTLOCK_PROFILE_LEN 16
+#define NIOS_PKT_16x64_FASTLOCK_TX          (1 << 15)
+#define NIOS_PKT_16x64_FASTLOCK_UPPER       (1 << 14)
+#define NIOS_PKT_16x64_FASTLOCK_RFFE_SHIFT  8
+#define NIOS_PKT_16x64_FASTLOCK_RFFE_MASK   (0x7 << 8)
+#define NIOS_PKT_16x64_FASTLOCK_NIOS_MASK   0xff
+
+static inline uint16_t nios_pkt_16x64_fastlock_addr(bool is_tx, bool upper,
+                                                    uint8_t rffe_profile,
+                                                    uint8_t nios_profile)
+{
+    uint16_t addr = nios_profile;
+
+    addr |= ((uint16_t)rffe_profile << NIOS_PKT_16x64_FASTLOCK_RFFE_SHIFT) &
+            NIOS_PKT_16x64_FASTLOCK_RFFE_MASK;
+
+    if (is_tx) {
+        addr |= NIOS_PKT_16x64_FASTLOCK_TX;
+    }
+
+    if (upper) {
+        addr |= NIOS_PKT_16x64_FASTLOCK_UPPER;
+    }
+
+    return addr;
+}
 
 /* IDs 0x80 through 0xff will not be assigned by Nuand. These are reserved
  * for user customizations */
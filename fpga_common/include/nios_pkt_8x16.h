@@ -61,7 +61,8 @@
  * A status flag will be set if the operation completed successfully.
  *
  * In the case of a read request, the data field will contain the read data, if
- * the read succeeded.
+ * the read succeeded. Writes to some targets (e.g., VCOCAP search) return a
+ * result in the data field.
  *
  * (Note 1)
  *  The "Target ID" refers to the peripheral, device, or block to access.
@@ -105,6 +106,8 @@
 #define NIOS_PKT_8x16_TARGET_AGC_CORR   0x02
 #define NIOS_PKT_8x16_TARGET_AD56X1_DAC 0x03
 #define NIOS_PKT_8x16_TARGET_INA219     0x04
+#define NIOS_PKT_8x16_TARGET_VCOCAP     0x05 /* LMS6002D VCOCAP search */
+#define NIOS_PKT_8x16_TARGET_LMS_DC_CAL 0x06 /* LMS6002D DC calibration */
 
 /* IDs 0x80 through 0xff will not be assigned by Nuand. These are reserved
  * for user customizations */
@@ -121,6 +124,41 @@
 #define NIOS_PKT_8x16_ADDR_IQ_CORR_TX_GAIN  0x02
 #define NIOS_PKT_8x16_ADDR_IQ_CORR_TX_PHASE 0x03
 
+/* Sub-addresses for the VCOCAP search target block.
+ *
+ * A write to this target runs the LMS6002D VCOCAP search on the NIOS II,
+ * starting from the estimate in the lower 6 bits of the data field. The
+ * PLL must already be configured, with the estimate written to VCOCAP. The
+ * response data contains the selected VCOCAP value, along with the LOCKED
+ * flag if VTUNE settled within the normal range. */
+#define NIOS_PKT_8x16_ADDR_VCOCAP_RX        0x00
+#define NIOS_PKT_8x16_ADDR_VCOCAP_TX        0x01
+
+#define NIOS_PKT_8x16_VCOCAP_MASK           0x3f
+#define NIOS_PKT_8x16_VCOCAP_LOCKED         (1 << 8)
+
+/* Addresses for the LMS6002D DC calibration target block.
+ *
+ * The address is the base address of a DC calibration module (LPF tuning,
+ * TX LPF, RX LPF, or RXVGA2), ORed with the address of a DC calibration
+ * within the module.
+ *
+ * A write to this target runs the module's DC calibration loop for that
+ * address on the NIOS II, with DC_CNTVAL set to the lower 6 bits of the
+ * data field. The module's DC calibration clock must already be enabled.
+ * The response data contains the resulting DC_REGVAL, along with the DONE
+ * flag if the calibration completed.
+ *
+ * If the LOAD flag is set in the data field, the lower 6 bits are instead
+ * loaded as the calibration's value, with the module's DC calibration clock
+ * enabled for the duration of the load. */
+#define NIOS_PKT_8x16_LMS_DC_CAL_BASE_MASK  0xf0
+#define NIOS_PKT_8x16_LMS_DC_CAL_ADDR_MASK  0x07
+
+#define NIOS_PKT_8x16_LMS_DC_CAL_VAL_MASK   0x3f
+#define NIOS_PKT_8x16_LMS_DC_CAL_DONE       (1 << 8)
+#define NIOS_PKT_8x16_LMS_DC_CAL_LOAD       (1 << 15)
+
 /* Sub-addresses for the AGC DC Correction target block */
 #define NIOS_PKT_8x16_ADDR_AGC_DC_Q_MAX  0x00
 #define NIOS_PKT_8x16_ADDR_AGC_DC_I_MAX  0x01
@@ -108,6 +108,140 @@
 #define NIOS_PKT_8x32_TARGET_ADF400X  0x04   /* ADF400x config */
 #define NIOS_PKT_8x32_TARGET_FASTLOCK 0x05   /* Save AD9361 fast lock profile
                                               * to Nios */
+#define NIOS_PKT_8x32_TARGET_RX_DDC   0x06   /* RX digital downconverter
+                                              * control */
+#define NIOS_PKT_8x32_TARGET_TX_DUC   0x07   /* TX digital upconverter
+                                              * control */
+#define NIOS_PKT_8x32_TARGET_RX_POWER 0x08   /* RX power detector */
+#define NIOS_PKT_8x32_TARGET_RX_BURST 0x09   /* RX burst gate */
+#define NIOS_PKT_8x32_TARGET_FIFO_LEVEL 0x0A /* Sample FIFO fill levels */
+#define NIOS_PKT_8x32_TARGET_TX_LOOP  0x0B   /* TX waveform loop */
+#define NIOS_PKT_8x32_TARGET_VCTCXO_TAMER 0x0C /* VCTCXO tamer trim state */
+
+/* NIOS_PKT_8x32_TARGET_RX_DDC register fields. NIOS_PKT_8x32_TARGET_TX_DUC
+ * uses the same layout, with the interpolation in place of the decimation. */
+#define NIOS_PKT_8x32_RX_DDC_ENABLE         (1u << 31)
+#define NIOS_PKT_8x32_RX_DDC_DECIM_SHIFT    24  /* log2(decimation), 0-6 */
+#define NIOS_PKT_8x32_RX_DDC_DECIM_MASK     (0x7u << 24)
+#define NIOS_PKT_8x32_RX_DDC_DPHASE_MASK    0x00ffffffu /* NCO phase
+                                                         * increment, in
+                                                         * 2^-24 cycles */
+
+/* NIOS_PKT_8x32_TARGET_RX_POWER addresses.
+ *
+ * Reading a channel's block count latches that channel's most recent mean
+ * and peak power, which are then returned by its MEAN and PEAK addresses.
+ * Powers are the sum of I^2 and Q^2, in SC16 Q11 units. */
+#define NIOS_PKT_8x32_RX_POWER_ADDR_CONFIG      0x00    /* Read/write */
+#define NIOS_PKT_8x32_RX_POWER_ADDR_COUNT(ch)   (1 + 3 * (ch))  /* Blocks
+                                                                 * completed */
+#define NIOS_PKT_8x32_RX_POWER_ADDR_MEAN(ch)    (2 + 3 * (ch))
+#define NIOS_PKT_8x32_RX_POWER_ADDR_PEAK(ch)    (3 + 3 * (ch))
+
+/* NIOS_PKT_8x32_RX_POWER_ADDR_CONFIG fields */
+#define NIOS_PKT_8x32_RX_POWER_ENABLE           (1u << 31)
+#define NIOS_PKT_8x32_RX_POWER_LENGTH_SHIFT     24  /* log2(block length),
+                                                     * 4-20 */
+#define NIOS_PKT_8x32_RX_POWER_LENGTH_MASK      (0x1fu << 24)
+
+/* NIOS_PKT_8x32_TARGET_RX_BURST addresses */
+#define NIOS_PKT_8x32_RX_BURST_ADDR_CONFIG      0x00
+#define NIOS_PKT_8x32_RX_BURST_ADDR_THRESHOLD   0x01    /* I^2 + Q^2, in SC16
+                                                         * Q11 units */
+
+/* NIOS_PKT_8x32_RX_BURST_ADDR_CONFIG fields */
+#define NIOS_PKT_8x32_RX_BURST_ENABLE           (1u << 31)
+#define NIOS_PKT_8x32_RX_BURST_AVERAGING_SHIFT  27  /* log2(detector time
+                                                     * constant), 0-15 */
+#define NIOS_PKT_8x32_RX_BURST_AVERAGING_MASK   (0xfu << 27)
+#define NIOS_PKT_8x32_RX_BURST_PRETRIGGER_SHIFT 17  /* Samples preceding
+                                                     * detection that begin
+                                                     * a burst, 0-1023 */
+#define NIOS_PKT_8x32_RX_BURST_PRETRIGGER_MASK  (0x3ffu << 17)
+#define NIOS_PKT_8x32_RX_BURST_CHANNEL          (1u << 16)  /* RX channel
+                                                             * that opens the
+                                                             * gate */
+#define NIOS_PKT_8x32_RX_BURST_HANGOVER_MASK    0x0000ffffu /* Samples below
+                                                             * threshold that
+                                                             * close the gate */
+
+/* NIOS_PKT_8x32_TARGET_FIFO_LEVEL addresses.
+ *
+ * Levels are in 32-bit words (SC16 Q11 samples). The RX level is that of
+ * the RX sample FIFO's read side, and the TX level that of the TX sample
+ * FIFO's write side. The high-water marks are the highest levels seen since
+ * they were last cleared. */
+#define NIOS_PKT_8x32_FIFO_LEVEL_ADDR_RX        0x00    /* Read only */
+#define NIOS_PKT_8x32_FIFO_LEVEL_ADDR_TX        0x01    /* Read only */
+#define NIOS_PKT_8x32_FIFO_LEVEL_ADDR_CAPACITY  0x02    /* Read only */
+#define NIOS_PKT_8x32_FIFO_LEVEL_ADDR_CLEAR     0x03    /* Write only. Any
+                                                         * value clears the
+                                                         * high-water marks */
+
+/* NIOS_PKT_8x32_FIFO_LEVEL_ADDR_RX and _TX fields */
+#define NIOS_PKT_8x32_FIFO_LEVEL_LEVEL_MASK     0x0000ffffu
+#define NIOS_PKT_8x32_FIFO_LEVEL_HWM_SHIFT      16
+#define NIOS_PKT_8x32_FIFO_LEVEL_HWM_MASK       0xffff0000u
+
+/* NIOS_PKT_8x32_FIFO_LEVEL_ADDR_CAPACITY fields */
+#define NIOS_PKT_8x32_FIFO_LEVEL_RX_CAP_MASK    0x0000ffffu
+#define NIOS_PKT_8x32_FIFO_LEVEL_TX_CAP_SHIFT   16
+#define NIOS_PKT_8x32_FIFO_LEVEL_TX_CAP_MASK    0xffff0000u
+
+/* NIOS_PKT_8x32_TARGET_TX_LOOP addresses.
+ *
+ * A write to ADDR_START_HI or ADDR_STOP_HI commits the value last written to
+ * the matching _LO address along with it. A start time of 0 starts playback
+ * immediately, and a stop time of 0 plays until a STOP command. */
+#define NIOS_PKT_8x32_TX_LOOP_ADDR_CONTROL      0x00    /* Write: command.
+                                                         * Read: state */
+#define NIOS_PKT_8x32_TX_LOOP_ADDR_LENGTH       0x01    /* Waveform length,
+                                                         * in samples */
+#define NIOS_PKT_8x32_TX_LOOP_ADDR_START_LO     0x02
+#define NIOS_PKT_8x32_TX_LOOP_ADDR_START_HI     0x03
+#define NIOS_PKT_8x32_TX_LOOP_ADDR_STOP_LO      0x04
+#define NIOS_PKT_8x32_TX_LOOP_ADDR_STOP_HI      0x05
+#define NIOS_PKT_8x32_TX_LOOP_ADDR_LOOPS        0x06    /* Read only.
+                                                         * Repetitions
+                                                         * completed */
+#define NIOS_PKT_8x32_TX_LOOP_ADDR_CAPACITY     0x07    /* Read only. Maximum
+                                                         * length */
+
+/* NIOS_PKT_8x32_TX_LOOP_ADDR_CONTROL commands */
+#define NIOS_PKT_8x32_TX_LOOP_CMD_DISABLE       0x00    /* Pass samples
+                                                         * through */
+#define NIOS_PKT_8x32_TX_LOOP_CMD_LOAD          0x01    /* Capture LENGTH
+                                                         * samples */
+#define NIOS_PKT_8x32_TX_LOOP_CMD_PLAY          0x02    /* Play at the start
+                                                         * time */
+#define NIOS_PKT_8x32_TX_LOOP_CMD_STOP          0x03    /* Stop playback, or
+                                                         * abandon a load */
+
+/* NIOS_PKT_8x32_TX_LOOP_ADDR_CONTROL states */
+#define NIOS_PKT_8x32_TX_LOOP_STATE_IDLE        0x00
+#define NIOS_PKT_8x32_TX_LOOP_STATE_LOADING     0x01
+#define NIOS_PKT_8x32_TX_LOOP_STATE_LOADED      0x02
+#define NIOS_PKT_8x32_TX_LOOP_STATE_ARMED       0x03
+#define NIOS_PKT_8x32_TX_LOOP_STATE_PLAYING     0x04
+
+/* NIOS_PKT_8x32_TARGET_VCTCXO_TAMER addresses.
+ *
+ * The slope is in trim DAC counts per count of 1 s error, and is 0 until the
+ * tamer has measured it. Writing ADDR_TRIM sets the trim DAC and starts fine
+ * tuning from it, with the slope last written to ADDR_SLOPE, skipping the
+ * coarse sweep. It fails if no slope has been written. */
+#define NIOS_PKT_8x32_VCTCXO_TAMER_ADDR_SLOPE   0x00    /* Write: seed slope.
+                                                         * Read: slope in
+                                                         * use */
+#define NIOS_PKT_8x32_VCTCXO_TAMER_ADDR_TRIM    0x01    /* Write: seed trim.
+                                                         * Read: trim DAC */
+#define NIOS_PKT_8x32_VCTCXO_TAMER_ADDR_STATE   0x02    /* Read only */
+
+/* NIOS_PKT_8x32_VCTCXO_TAMER_ADDR_STATE states */
+#define NIOS_PKT_8x32_VCTCXO_TAMER_STATE_COARSE 0x00    /* Sweeping the trim
+                                                         * range */
+#define NIOS_PKT_8x32_VCTCXO_TAMER_STATE_FINE   0x01    /* Tracking the
+                                                         * reference */
 
 /* IDs 0x80 through 0xff will not be assigned by Nuand. These are reserved
  * for user customizations */
@@ -102,6 +102,8 @@
 /* Target IDs */
 
 #define NIOS_PKT_8x64_TARGET_TIMESTAMP 0x00 /* Timestamp readback (read only) */
+#define NIOS_PKT_8x64_TARGET_RETUNE_STATS 0x01 /* Last retune (read only) */
+#define NIOS_PKT_8x64_TARGET_TRIGGER 0x02 /* Trigger fire times */
 
 /* IDs 0x80 through 0xff will not be assigned by Nuand. These are reserved
  * for user customizations */
@@ -116,6 +118,42 @@
 #define NIOS_PKT_8x64_TIMESTAMP_RX  0x00
 #define NIOS_PKT_8x64_TIMESTAMP_TX  0x01
 
+/* Sub-addresses for retune stats target. Bit 0 selects the module, as with
+ * the timestamp target, and bits [2:1] select the field. Timestamps are
+ * in the units of the selected module's timestamp counter. */
+#define NIOS_PKT_8x64_RETUNE_STATS_TX         0x01
+#define NIOS_PKT_8x64_RETUNE_STATS_SCHEDULED  (0x00 << 1)
+#define NIOS_PKT_8x64_RETUNE_STATS_START      (0x01 << 1)
+#define NIOS_PKT_8x64_RETUNE_STATS_COMPLETE   (0x02 << 1)
+#define NIOS_PKT_8x64_RETUNE_STATS_FLAGS      (0x03 << 1)
+#define NIOS_PKT_8x64_RETUNE_STATS_FIELD_MASK (0x03 << 1)
+
+/* Bits of the retune stats flags field */
+#define NIOS_PKT_8x64_RETUNE_STATS_FLAG_VALID  (1 << 0)
+#define NIOS_PKT_8x64_RETUNE_STATS_FLAG_LOCKED (1 << 1)
+
+/* Sub-addresses for the trigger target, on the bladeRF 2.0 micro. Bit 0
+ * selects the module, as with the timestamp target, and bits [2:1] select
+ * the field. Timestamps are in the units of the selected module's timestamp
+ * counter.
+ *
+ * Writing FIRE_TIME schedules the armed trigger to fire at that time, or
+ * immediately if it has passed. Writing STATUS cancels a scheduled fire, and
+ * disarming the trigger also cancels it. FIRED_TIME is the time at which the
+ * trigger line was first seen asserted since the trigger was armed, and is
+ * valid when the FIRED flag is set. It is recorded on masters and slaves. */
+#define NIOS_PKT_8x64_TRIGGER_TX             0x01
+#define NIOS_PKT_8x64_TRIGGER_FIRE_TIME      (0x00 << 1)
+#define NIOS_PKT_8x64_TRIGGER_FIRED_TIME     (0x01 << 1)
+#define NIOS_PKT_8x64_TRIGGER_STATUS         (0x02 << 1)
+#define NIOS_PKT_8x64_TRIGGER_FIELD_MASK     (0x03 << 1)
+
+/* Bits of the trigger status field */
+#define NIOS_PKT_8x64_TRIGGER_FLAG_SCHEDULED (1 << 0) /* Fire pending */
+#define NIOS_PKT_8x64_TRIGGER_FLAG_FIRING    (1 << 1) /* Scheduled fire
+                                                       * asserted */
+#define NIOS_PKT_8x64_TRIGGER_FLAG_FIRED     (1 << 2) /* FIRED_TIME valid */
+
 /* Pack the request buffer */
 static inline void nios_pkt_8x64_pack(uint8_t *buf, uint8_t target, bool write,
                                       uint8_t addr, uint64_t data)
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BLADERF_NIOS_PKT_8x8_BATCH_H_
+#define BLADERF_NIOS_PKT_8x8_BATCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/*
+ * This file defines the Host <-> FPGA (NIOS II) packet format for a batch of
+ * up to NIOS_PKT_8x8_BATCH_MAX accesses to a device/block with 8-bit
+ * addresses and 8-bit data. The target IDs are those of the 8x8 format
+ * (see nios_pkt_8x8.h).
+ *
+ * The operations are performed in order, and processing stops at the first
+ * operation that fails. This allows register sequences (e.g., a Si5338
+ * multisynth configuration) to be applied in a single request, rather than
+ * requiring a USB round-trip per register.
+ *
+ *
+ *                              Request
+ *                      ----------------------
+ *
+ * +================+=========================================================+
+ * |  Byte offset   |                       Description                       |
+ * +================+=========================================================+
+ * |        0       | Magic Value                                             |
+ * +----------------+---------------------------------------------------------+
+ * |        1       | Target ID                                               |
+ * +----------------+---------------------------------------------------------+
+ * |        2       | Number of operations (Note 1)                           |
+ * +----------------+---------------------------------------------------------+
+ * |        3       | Write mask (Note 2)                                     |
+ * +----------------+---------------------------------------------------------+
+ * |        4       | Operation 0: 8-bit address                              |
+ * +----------------+---------------------------------------------------------+
+ * |        5       | Operation 0: 8-bit data                                 |
+ * +----------------+---------------------------------------------------------+
+ * |        ...     | ...                                                     |
+ * +----------------+---------------------------------------------------------+
+ * |       14       | Operation 5: 8-bit address                              |
+ * +----------------+---------------------------------------------------------+
+ * |       15       | Operation 5: 8-bit data                                 |
+ * +----------------+---------------------------------------------------------+
+ *
+ *
+ *                              Response
+ *                      ----------------------
+ *
+ * The response packet contains the same information as the request, with
+ * the following exceptions:
+ *
+ *  - Byte 2 contains the number of operations that completed successfully.
+ *    The batch succeeded if this matches the number of requested operations.
+ *
+ *  - The data field of each completed read operation contains the read data.
+ *
+ * (Note 1)
+ *  Values of 0 and those greater than NIOS_PKT_8x8_BATCH_MAX are invalid, and
+ *  will yield a response reporting 0 completed operations.
+ *
+ * (Note 2)
+ *  Bit n denotes whether operation n is a read (0) or write (1). Bits 7:6
+ *  are reserved and should be set to 0.
+ */
+
+#define NIOS_PKT_8x8_BATCH_MAGIC        ((uint8_t) 'F')
+
+/* Maximum number of operations in a single request */
+#define NIOS_PKT_8x8_BATCH_MAX          6
+
+/* Request packet indices */
+#define NIOS_PKT_8x8_BATCH_IDX_MAGIC        0
+#define NIOS_PKT_8x8_BATCH_IDX_TARGET_ID    1
+#define NIOS_PKT_8x8_BATCH_IDX_COUNT        2
+#define NIOS_PKT_8x8_BATCH_IDX_WRITE_MASK   3
+#define NIOS_PKT_8x8_BATCH_IDX_OPS          4
+
+/* Address and data indices of operation n */
+#define NIOS_PKT_8x8_BATCH_IDX_ADDR(n)  (NIOS_PKT_8x8_BATCH_IDX_OPS + 2 * (n))
+#define NIOS_PKT_8x8_BATCH_IDX_DATA(n)  (NIOS_PKT_8x8_BATCH_IDX_ADDR(n) + 1)
+
+/* Pack the request header. Operations are added via
+ * nios_pkt_8x8_batch_pack_op(). */
+static inline void nios_pkt_8x8_batch_pack(uint8_t *buf, uint8_t target)
+{
+    memset(buf, 0, NIOS_PKT_8x8_BATCH_IDX_ADDR(NIOS_PKT_8x8_BATCH_MAX));
+
+    buf[NIOS_PKT_8x8_BATCH_IDX_MAGIC]     = NIOS_PKT_8x8_BATCH_MAGIC;
+    buf[NIOS_PKT_8x8_BATCH_IDX_TARGET_ID] = target;
+}
+
+/* Append an operation to the request buffer. Returns false if the request
+ * is already full. */
+static inline bool nios_pkt_8x8_batch_pack_op(uint8_t *buf, bool write,
+                                              uint8_t addr, uint8_t data)
+{
+    const uint8_t n = buf[NIOS_PKT_8x8_BATCH_IDX_COUNT];
+
+    if (n >= NIOS_PKT_8x8_BATCH_MAX) {
+        return false;
+    }
+
+    if (write) {
+        buf[NIOS_PKT_8x8_BATCH_IDX_WRITE_MASK] |= (1 << n);
+    }
+
+    buf[NIOS_PKT_8x8_BATCH_IDX_ADDR(n)] = addr;
+    buf[NIOS_PKT_8x8_BATCH_IDX_DATA(n)] = data;
+    buf[NIOS_PKT_8x8_BATCH_IDX_COUNT]   = n + 1;
+
+    return true;
+}
+
+/* Unpack the request header */
+static inline void nios_pkt_8x8_batch_unpack(const uint8_t *buf,
+                                             uint8_t *target, uint8_t *count)
+{
+    if (target != NULL) {
+        *target = buf[NIOS_PKT_8x8_BATCH_IDX_TARGET_ID];
+    }
+
+    if (count != NULL) {
+        *count = buf[NIOS_PKT_8x8_BATCH_IDX_COUNT];
+    }
+}
+
+/* Unpack operation n from a request or response buffer */
+static inline void nios_pkt_8x8_batch_unpack_op(const uint8_t *buf, uint8_t n,
+                                                bool *write, uint8_t *addr,
+                                                uint8_t *data)
+{
+    if (write != NULL) {
+        *write = (buf[NIOS_PKT_8x8_BATCH_IDX_WRITE_MASK] & (1 << n)) != 0;
+    }
+
+    if (addr != NULL) {
+        *addr = buf[NIOS_PKT_8x8_BATCH_IDX_ADDR(n)];
+    }
+
+    if (data != NULL) {
+        *data = buf[NIOS_PKT_8x8_BATCH_IDX_DATA(n)];
+    }
+}
+
+/* Pack the response buffer from the request buffer. Read data must be
+ * filled in by the caller via nios_pkt_8x8_batch_resp_set_data(). */
+static inline void nios_pkt_8x8_batch_resp_pack(uint8_t *resp,
+                                                const uint8_t *req,
+                                                uint8_t completed)
+{
+    memcpy(resp, req, NIOS_PKT_8x8_BATCH_IDX_ADDR(NIOS_PKT_8x8_BATCH_MAX));
+    resp[NIOS_PKT_8x8_BATCH_IDX_COUNT] = completed;
+}
+
+/* Set the data field of operation n in the response buffer */
+static inline void nios_pkt_8x8_batch_resp_set_data(uint8_t *resp, uint8_t n,
+                                                    uint8_t data)
+{
+    resp[NIOS_PKT_8x8_BATCH_IDX_DATA(n)] = data;
+}
+
+/* Unpack the number of completed operations from the response buffer */
+static inline void nios_pkt_8x8_batch_resp_unpack(const uint8_t *buf,
+                                                  uint8_t *completed)
+{
+    *completed = buf[NIOS_PKT_8x8_BATCH_IDX_COUNT];
+}
+
+#endif
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BLADERF_NIOS_PKT_8x8_BLOCK_H_
+#define BLADERF_NIOS_PKT_8x8_BLOCK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/*
+ * This file defines the Host <-> FPGA (NIOS II) packet format for reading or
+ * writing a contiguous range of up to NIOS_PKT_8x8_BLOCK_MAX registers of a
+ * device/block with 8-bit addresses and 8-bit data. The target IDs are those
+ * of the 8x8 format (see nios_pkt_8x8.h).
+ *
+ * Registers are accessed in increasing address order, and processing stops
+ * at the first access that fails. This allows register maps (e.g., for a
+ * register dump) to be transferred with a fraction of the USB round-trips
+ * required by the 8x8 format.
+ *
+ *
+ *                              Request
+ *                      ----------------------
+ *
+ * +================+=========================================================+
+ * |  Byte offset   |                       Description                       |
+ * +================+=========================================================+
+ * |        0       | Magic Value                                             |
+ * +----------------+---------------------------------------------------------+
+ * |        1       | Target ID                                               |
+ * +----------------+---------------------------------------------------------+
+ * |        2       | Flags (Note 1)                                          |
+ * +----------------+---------------------------------------------------------+
+ * |        3       | Number of registers (Note 2)                            |
+ * +----------------+---------------------------------------------------------+
+ * |        4       | 8-bit address of the first register                     |
+ * +----------------+---------------------------------------------------------+
+ * |        5       | Data of the first register                              |
+ * +----------------+---------------------------------------------------------+
+ * |        ...     | ...                                                     |
+ * +----------------+---------------------------------------------------------+
+ * |       15       | Data of the eleventh register                           |
+ * +----------------+---------------------------------------------------------+
+ *
+ *
+ *                              Response
+ *                      ----------------------
+ *
+ * The response packet contains the same information as the request, with
+ * the following exceptions:
+ *
+ *  - Byte 3 contains the number of registers that were accessed
+ *    successfully. The request succeeded if this matches the number of
+ *    requested registers.
+ *
+ *  - For a read, the data fields of the accessed registers contain the
+ *    read data.
+ *
+ * (Note 1)
+ *      +================+========================+
+ *      |      Bit(s)    |         Value          |
+ *      +================+========================+
+ *      |       7:1      |        Reserved        |
+ *      +----------------+------------------------+
+ *      |        0       |   0 = Read operation   |
+ *      |                |   1 = Write operation  |
+ *      +----------------+------------------------+
+ *
+ * (Note 2)
+ *  Values of 0, those greater than NIOS_PKT_8x8_BLOCK_MAX, and those that
+ *  would extend the range beyond address 0xff are invalid, and will yield a
+ *  response reporting 0 accessed registers.
+ */
+
+#define NIOS_PKT_8x8_BLOCK_MAGIC        ((uint8_t) 'G')
+
+/* Maximum number of registers in a single request */
+#define NIOS_PKT_8x8_BLOCK_MAX          11
+
+/* Request packet indices */
+#define NIOS_PKT_8x8_BLOCK_IDX_MAGIC        0
+#define NIOS_PKT_8x8_BLOCK_IDX_TARGET_ID    1
+#define NIOS_PKT_8x8_BLOCK_IDX_FLAGS        2
+#define NIOS_PKT_8x8_BLOCK_IDX_COUNT        3
+#define NIOS_PKT_8x8_BLOCK_IDX_ADDR         4
+#define NIOS_PKT_8x8_BLOCK_IDX_DATA         5
+
+/* Request packet flags */
+#define NIOS_PKT_8x8_BLOCK_FLAG_WRITE       (1 << 0)
+
+/* Pack the request buffer. For a write, `data` must contain `count`
+ * values. For a read, `data` is ignored and may be NULL. */
+static inline void nios_pkt_8x8_block_pack(uint8_t *buf, uint8_t target,
+                                           bool write, uint8_t addr,
+                                           const uint8_t *data, uint8_t count)
+{
+    memset(buf, 0, NIOS_PKT_8x8_BLOCK_IDX_DATA + NIOS_PKT_8x8_BLOCK_MAX);
+
+    buf[NIOS_PKT_8x8_BLOCK_IDX_MAGIC]     = NIOS_PKT_8x8_BLOCK_MAGIC;
+    buf[NIOS_PKT_8x8_BLOCK_IDX_TARGET_ID] = target;
+    buf[NIOS_PKT_8x8_BLOCK_IDX_COUNT]     = count;
+    buf[NIOS_PKT_8x8_BLOCK_IDX_ADDR]      = addr;
+
+    if (write) {
+        buf[NIOS_PKT_8x8_BLOCK_IDX_FLAGS] = NIOS_PKT_8x8_BLOCK_FLAG_WRITE;
+        memcpy(&buf[NIOS_PKT_8x8_BLOCK_IDX_DATA], data, count);
+    }
+}
+
+/* Unpack the request buffer */
+static inline void nios_pkt_8x8_block_unpack(const uint8_t *buf,
+                                             uint8_t *target, bool *write,
+                                             uint8_t *addr, uint8_t *count)
+{
+    if (target != NULL) {
+        *target = buf[NIOS_PKT_8x8_BLOCK_IDX_TARGET_ID];
+    }
+
+    if (write != NULL) {
+        *write = (buf[NIOS_PKT_8x8_BLOCK_IDX_FLAGS] &
+                  NIOS_PKT_8x8_BLOCK_FLAG_WRITE) != 0;
+    }
+
+    if (addr != NULL) {
+        *addr = buf[NIOS_PKT_8x8_BLOCK_IDX_ADDR];
+    }
+
+    if (count != NULL) {
+        *count = buf[NIOS_PKT_8x8_BLOCK_IDX_COUNT];
+    }
+}
+
+/* Pack the response buffer from the request buffer. Read data must be
+ * filled in by the caller via nios_pkt_8x8_block_resp_set_data(). */
+static inline void nios_pkt_8x8_block_resp_pack(uint8_t *resp,
+                                                const uint8_t *req,
+                                                uint8_t completed)
+{
+    memcpy(resp, req, NIOS_PKT_8x8_BLOCK_IDX_DATA + NIOS_PKT_8x8_BLOCK_MAX);
+    resp[NIOS_PKT_8x8_BLOCK_IDX_COUNT] = completed;
+}
+
+/* Set the data field of the nth register in the response buffer */
+static inline void nios_pkt_8x8_block_resp_set_data(uint8_t *resp, uint8_t n,
+                                                    uint8_t data)
+{
+    resp[NIOS_PKT_8x8_BLOCK_IDX_DATA + n] = data;
+}
+
+/* Unpack the response buffer. For a read, `data` is populated with the
+ * values of the `*completed` registers accessed, and may be NULL
+ * otherwise. */
+static inline void nios_pkt_8x8_block_resp_unpack(const uint8_t *buf,
+                                                  uint8_t *data,
+                                                  uint8_t *completed)
+{
+    *completed = buf[NIOS_PKT_8x8_BLOCK_IDX_COUNT];
+
+    if (*completed > NIOS_PKT_8x8_BLOCK_MAX) {
+        *completed = 0;
+    }
+
+    if (data != NULL) {
+        memcpy(data, &buf[NIOS_PKT_8x8_BLOCK_IDX_DATA], *completed);
+    }
+}
+
+#endif
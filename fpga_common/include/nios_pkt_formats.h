@@ -26,11 +26,15 @@
 #include "nios_pkt_retune.h"
 #include "nios_pkt_retune2.h"
 #include "nios_pkt_8x8.h"
+#include "nios_pkt_8x8_batch.h"
+#include "nios_pkt_8x8_block.h"
 #include "nios_pkt_8x16.h"
 #include "nios_pkt_8x32.h"
 #include "nios_pkt_8x64.h"
 #include "nios_pkt_32x32.h"
 #include "nios_pkt_16x64.h"
+#include "nios_pkt_16x8_batch.h"
+#include "nios_pkt_ts_latch.h"
 
 #define NIOS_PKT_LEN 16
 
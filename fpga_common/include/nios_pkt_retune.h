@@ -30,6 +30,7 @@
 #endif
 
 #include <stdint.h>
+#include <string.h>
 
 /* Specify this value instead of a timestamp to clear the retune queue */
 #define NIOS_PKT_RETUNE_CLEAR_QUEUE ((uint64_t) -1)
@@ -56,7 +57,8 @@
  * |                | Bit 6:        1=Quick tune, 0=Normal tune               |
  * |                | Bits [5:0]    VCOCAP[5:0] Hint                          |
  * +----------------+---------------------------------------------------------+
- * |       15       | 8-bit reserved word. Should be set to 0x00.             |
+ * |       15       | Bits [7:2]:   XB-200 GPIO settings                      |
+ * |                | Bits [1:0]:   Queue operation (Note 5)                  |
  * +----------------+---------------------------------------------------------+
  *
  * (Note 1) Special Timestamp Values:
@@ -94,6 +96,71 @@
  * +----------------+-----------------------+
  *
  * (Notes 4) Band-selection bit = 1 implies "Low band". 0 = "High band"
+ *
+ * (Note 5) Queue operations, applicable to scheduled retunes only:
+ *
+ *  NIOS_PKT_RETUNE_OP_SCHEDULE:    Append the retune to the queue.
+ *
+ *  NIOS_PKT_RETUNE_OP_CANCEL:      Cancel the queued retune(s) scheduled at
+ *                                  the specified timestamp. The tuning
+ *                                  parameters are ignored.
+ *
+ *  NIOS_PKT_RETUNE_OP_REPLACE:     Replace the tuning parameters of the
+ *                                  queued retune scheduled at the specified
+ *                                  timestamp, retaining its queue position.
+ *
+ *  NIOS_PKT_RETUNE_OP_CORRECT:     Stage DC offset, IQ balance and gain
+ *                                  corrections to be applied along with the
+ *                                  next retune request of the specified
+ *                                  module. This request uses a different
+ *                                  layout (Note 6).
+ *
+ *  Cancel and replace operations fail if no pending retune is scheduled at
+ *  the specified timestamp, including when it is already being performed.
+ *
+ * (Note 6) Correction requests are formatted as follows:
+ *
+ * +================+=========================================================+
+ * |  Byte offset   |                       Description                       |
+ * +================+=========================================================+
+ * |        0       | Magic Value                                             |
+ * +----------------+---------------------------------------------------------+
+ * |        1       | LMS6002D DC offset I register value                     |
+ * +----------------+---------------------------------------------------------+
+ * |        2       | LMS6002D DC offset Q register value                     |
+ * +----------------+---------------------------------------------------------+
+ * |        3       | 16-bit IQ balance gain register value                   |
+ * +----------------+---------------------------------------------------------+
+ * |        5       | 16-bit IQ balance phase register value                  |
+ * +----------------+---------------------------------------------------------+
+ * |        7       | RX: LNA gain, as a bladerf_lna_gain value               |
+ * |                | TX: Reserved. Set to 0.                                 |
+ * +----------------+---------------------------------------------------------+
+ * |        8       | RXVGA1 (0x76) or TXVGA1 (0x41) register value           |
+ * +----------------+---------------------------------------------------------+
+ * |        9       | RXVGA2 (0x65) or TXVGA2 (0x45[7:3]) register value      |
+ * +----------------+---------------------------------------------------------+
+ * |      10-12     | Reserved. Set to 0.                                     |
+ * +----------------+---------------------------------------------------------+
+ * |       13       | RX/TX bits, as in Note 3. Bits [5:0] are reserved.      |
+ * +----------------+---------------------------------------------------------+
+ * |       14       | Bit 0:        1=Apply DC offset correction              |
+ * |                | Bit 1:        1=Apply IQ balance correction             |
+ * |                | Bit 2:        1=Apply gain                              |
+ * |                | Bit 3:        1=Only apply the corrections. The tuning  |
+ * |                |               parameters of the retune request are      |
+ * |                |               ignored.                                  |
+ * |                | Bits [7:4]:   Reserved. Set to 0.                       |
+ * +----------------+---------------------------------------------------------+
+ * |       15       | Bits [7:2]:   Reserved. Set to 0.                       |
+ * |                | Bits [1:0]:   NIOS_PKT_RETUNE_OP_CORRECT                |
+ * +----------------+---------------------------------------------------------+
+ *
+ *  The staged corrections are attached to the next tune "now", schedule, or
+ *  replace request for the module, and are applied immediately after its
+ *  frequency change. If bit 3 of byte 14 is set, that request does not
+ *  change the frequency, allowing gain changes to be scheduled alone. They are discarded once that request has been handled,
+ *  whether or not it succeeded, and when the module's queue is cleared.
  */
 
 #define NIOS_PKT_RETUNE_IDX_MAGIC    0
@@ -118,6 +185,32 @@
 /* Denotes that the retune should not be scheduled - it should occur "now" */
 #define NIOS_PKT_RETUNE_NOW          ((uint64_t) 0x00)
 
+/* Queue operations */
+#define NIOS_PKT_RETUNE_OP_MASK      0x03
+#define NIOS_PKT_RETUNE_OP_SCHEDULE  0x00
+#define NIOS_PKT_RETUNE_OP_CANCEL    0x01
+#define NIOS_PKT_RETUNE_OP_REPLACE   0x02
+#define NIOS_PKT_RETUNE_OP_CORRECT   0x03
+
+/* Correction request fields (Note 6) */
+#define NIOS_PKT_RETUNE_IDX_CORR_DC_I   1
+#define NIOS_PKT_RETUNE_IDX_CORR_DC_Q   2
+#define NIOS_PKT_RETUNE_IDX_CORR_GAIN   3
+#define NIOS_PKT_RETUNE_IDX_CORR_PHASE  5
+#define NIOS_PKT_RETUNE_IDX_CORR_LNA    7
+#define NIOS_PKT_RETUNE_IDX_CORR_VGA1   8
+#define NIOS_PKT_RETUNE_IDX_CORR_VGA2   9
+#define NIOS_PKT_RETUNE_IDX_CORR_FLAGS  14
+
+#define NIOS_PKT_RETUNE_CORR_DC         (1 << 0)
+#define NIOS_PKT_RETUNE_CORR_IQ         (1 << 1)
+#define NIOS_PKT_RETUNE_CORR_GAIN       (1 << 2)
+#define NIOS_PKT_RETUNE_CORR_NO_TUNE    (1 << 3)
+
+#define NIOS_PKT_RETUNE_CORR_MASK \
+    (NIOS_PKT_RETUNE_CORR_DC | NIOS_PKT_RETUNE_CORR_IQ | \
+     NIOS_PKT_RETUNE_CORR_GAIN | NIOS_PKT_RETUNE_CORR_NO_TUNE)
+
 #define PACK_TXRX_FREQSEL(module_, freqsel_) \
     (freqsel_ & 0x3f)
 
@@ -178,7 +271,20 @@ static inline void nios_pkt_retune_pack(uint8_t *buf,
 
     buf[NIOS_PKT_RETUNE_IDX_BANDSEL] |= vcocap;
 
-    buf[NIOS_PKT_RETUNE_IDX_RESV]     = xb_gpio;
+    buf[NIOS_PKT_RETUNE_IDX_RESV]     = xb_gpio & ~NIOS_PKT_RETUNE_OP_MASK;
+}
+
+/* Set the queue operation of a packed retune request */
+static inline void nios_pkt_retune_set_op(uint8_t *buf, uint8_t op)
+{
+    buf[NIOS_PKT_RETUNE_IDX_RESV] &= ~NIOS_PKT_RETUNE_OP_MASK;
+    buf[NIOS_PKT_RETUNE_IDX_RESV] |= op & NIOS_PKT_RETUNE_OP_MASK;
+}
+
+/* Get the queue operation of a retune request */
+static inline uint8_t nios_pkt_retune_get_op(const uint8_t *buf)
+{
+    return buf[NIOS_PKT_RETUNE_IDX_RESV] & NIOS_PKT_RETUNE_OP_MASK;
 }
 
 /* Unpack a retune request */
@@ -222,7 +328,97 @@ static inline void nios_pkt_retune_unpack(const uint8_t *buf,
     *low_band = (buf[NIOS_PKT_RETUNE_IDX_BANDSEL] & FLAG_LOW_BAND) != 0;
     *quick_tune = (buf[NIOS_PKT_RETUNE_IDX_BANDSEL] & FLAG_QUICK_TUNE) != 0;
     *vcocap = buf[NIOS_PKT_RETUNE_IDX_BANDSEL] & 0x3f;
-    *xb_gpio = buf[NIOS_PKT_RETUNE_IDX_RESV];
+    *xb_gpio = buf[NIOS_PKT_RETUNE_IDX_RESV] & ~NIOS_PKT_RETUNE_OP_MASK;
+}
+
+/* Pack a correction request (Note 6) */
+static inline void nios_pkt_retune_corr_pack(uint8_t *buf,
+                                             bladerf_module module,
+                                             uint8_t flags,
+                                             uint8_t dc_i,
+                                             uint8_t dc_q,
+                                             uint16_t gain,
+                                             uint16_t phase)
+{
+    memset(buf, 0, NIOS_PKT_RETUNE_IDX_RESV + 1);
+
+    buf[NIOS_PKT_RETUNE_IDX_MAGIC] = NIOS_PKT_RETUNE_MAGIC;
+
+    buf[NIOS_PKT_RETUNE_IDX_CORR_DC_I]      = dc_i;
+    buf[NIOS_PKT_RETUNE_IDX_CORR_DC_Q]      = dc_q;
+    buf[NIOS_PKT_RETUNE_IDX_CORR_GAIN + 0]  = gain & 0xff;
+    buf[NIOS_PKT_RETUNE_IDX_CORR_GAIN + 1]  = (gain >> 8) & 0xff;
+    buf[NIOS_PKT_RETUNE_IDX_CORR_PHASE + 0] = phase & 0xff;
+    buf[NIOS_PKT_RETUNE_IDX_CORR_PHASE + 1] = (phase >> 8) & 0xff;
+
+    switch (module) {
+        case BLADERF_MODULE_TX:
+            buf[NIOS_PKT_RETUNE_IDX_FREQSEL] = FLAG_TX;
+            break;
+
+        case BLADERF_MODULE_RX:
+            buf[NIOS_PKT_RETUNE_IDX_FREQSEL] = FLAG_RX;
+            break;
+
+        default:
+            /* Erroneous case - should not occur */
+            break;
+    }
+
+    buf[NIOS_PKT_RETUNE_IDX_CORR_FLAGS] = flags & NIOS_PKT_RETUNE_CORR_MASK;
+
+    buf[NIOS_PKT_RETUNE_IDX_RESV] = NIOS_PKT_RETUNE_OP_CORRECT;
+}
+
+/* Unpack a correction request (Note 6) */
+static inline void nios_pkt_retune_corr_unpack(const uint8_t *buf,
+                                               bladerf_module *module,
+                                               uint8_t *flags,
+                                               uint8_t *dc_i,
+                                               uint8_t *dc_q,
+                                               uint16_t *gain,
+                                               uint16_t *phase)
+{
+    *dc_i  = buf[NIOS_PKT_RETUNE_IDX_CORR_DC_I];
+    *dc_q  = buf[NIOS_PKT_RETUNE_IDX_CORR_DC_Q];
+
+    *gain  = buf[NIOS_PKT_RETUNE_IDX_CORR_GAIN + 0];
+    *gain |= buf[NIOS_PKT_RETUNE_IDX_CORR_GAIN + 1] << 8;
+
+    *phase  = buf[NIOS_PKT_RETUNE_IDX_CORR_PHASE + 0];
+    *phase |= buf[NIOS_PKT_RETUNE_IDX_CORR_PHASE + 1] << 8;
+
+    *module = -1;
+
+    if (buf[NIOS_PKT_RETUNE_IDX_FREQSEL] & FLAG_TX) {
+        *module = BLADERF_MODULE_TX;
+    } else if (buf[NIOS_PKT_RETUNE_IDX_FREQSEL] & FLAG_RX) {
+        *module = BLADERF_MODULE_RX;
+    }
+
+    *flags = buf[NIOS_PKT_RETUNE_IDX_CORR_FLAGS] & NIOS_PKT_RETUNE_CORR_MASK;
+}
+
+/* Set the gain register values of a packed correction request (Note 6) */
+static inline void nios_pkt_retune_corr_set_gain(uint8_t *buf,
+                                                 uint8_t lna,
+                                                 uint8_t vga1,
+                                                 uint8_t vga2)
+{
+    buf[NIOS_PKT_RETUNE_IDX_CORR_LNA]  = lna;
+    buf[NIOS_PKT_RETUNE_IDX_CORR_VGA1] = vga1;
+    buf[NIOS_PKT_RETUNE_IDX_CORR_VGA2] = vga2;
+}
+
+/* Get the gain register values of a correction request (Note 6) */
+static inline void nios_pkt_retune_corr_get_gain(const uint8_t *buf,
+                                                 uint8_t *lna,
+                                                 uint8_t *vga1,
+                                                 uint8_t *vga2)
+{
+    *lna  = buf[NIOS_PKT_RETUNE_IDX_CORR_LNA];
+    *vga1 = buf[NIOS_PKT_RETUNE_IDX_CORR_VGA1];
+    *vga2 = buf[NIOS_PKT_RETUNE_IDX_CORR_VGA2];
 }
 
 
@@ -271,7 +467,8 @@ static inline void nios_pkt_retune_unpack(const uint8_t *buf,
  *                unexpected failurs.
  *
  *                The scheduled tune request will failure if the retune queue
- *                is full.
+ *                is full. Cancel and replace requests fail if no pending
+ *                retune is scheduled at the specified timestamp.
  *
  *      flags[7:2]    Reserved. Set to 0.
  */
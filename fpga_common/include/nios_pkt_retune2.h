@@ -58,7 +58,10 @@
  * |                | Bits [3:2]: External RX2 SPDT switch setting            |
  * |                | Bits [1:0]: External RX1 SPDT switch setting            |
  * +----------------+---------------------------------------------------------+
- * |       14-15    | 8-bit reserved words. Should be set to 0x00.            |
+ * |       14       | Entry type (Note 3). Set to 0x00 for a retune.          |
+ * +----------------+---------------------------------------------------------+
+ * |       15       | Bits [7:2]: Reserved. Should be set to 0.               |
+ * |                | Bits [1:0]: Queue operation (Note 4)                    |
  * +----------------+---------------------------------------------------------+
  *
  * (Note 1) Special Timestamp Values:
@@ -79,6 +82,61 @@
  * |       1        |  NIOS_PROFILE[15:8]   |
  * +----------------+-----------------------+
  *
+ * (Note 3) Entry types:
+ *
+ * NIOS_PKT_RETUNE2_TYPE_RETUNE:    A retune, laid out as shown above.
+ *
+ * NIOS_PKT_RETUNE2_TYPE_RFIC_CMD,
+ * NIOS_PKT_RETUNE2_TYPE_RFPORT,
+ * NIOS_PKT_RETUNE2_TYPE_RFFE:      A parameter change. Bytes 9-12 contain a
+ *                                  32-bit value, byte 13 contains the RFIC
+ *                                  command, and byte 15 contains the channel.
+ *                                  For an RFFE control change, bits [15:0]
+ *                                  of the value are written to the
+ *                                  corresponding RFFE control bits selected
+ *                                  by the mask in bits [31:16], and the
+ *                                  command is ignored.
+ *
+ * NIOS_PKT_RETUNE2_TYPE_RETUNE_PAIR:
+ *                                  Simultaneous RX and TX retunes, applied
+ *                                  when the RX timestamp reaches the
+ *                                  specified value. This uses a single entry
+ *                                  in the RX queue. Laid out as follows:
+ *
+ * +================+=========================================================+
+ * |  Byte offset   |                       Description                       |
+ * +================+=========================================================+
+ * |        9       | 8-bit RX Nios fast lock profile number                  |
+ * +----------------+---------------------------------------------------------+
+ * |       10       | 8-bit TX Nios fast lock profile number                  |
+ * +----------------+---------------------------------------------------------+
+ * |       11       | 8-bit RX RFFE fast lock profile slot                    |
+ * +----------------+---------------------------------------------------------+
+ * |       12       | 8-bit TX RFFE fast lock profile slot                    |
+ * +----------------+---------------------------------------------------------+
+ * |       13       | External SPDT switch settings, as above                 |
+ * +----------------+---------------------------------------------------------+
+ * |       15       | Bits 6:     TX output port selection                    |
+ * |                | Bits [5:0]: RX input port selection                     |
+ * +----------------+---------------------------------------------------------+
+ *
+ * (Note 4) Queue operations, applicable to scheduled retunes of type
+ * NIOS_PKT_RETUNE2_TYPE_RETUNE only:
+ *
+ *  NIOS_PKT_RETUNE2_OP_SCHEDULE:   Append the retune to the queue.
+ *
+ *  NIOS_PKT_RETUNE2_OP_CANCEL:     Cancel all of the entries queued for the
+ *                                  module at the specified timestamp,
+ *                                  including parameter changes and paired
+ *                                  retunes. The profile, port, and SPDT
+ *                                  fields are ignored.
+ *
+ *  NIOS_PKT_RETUNE2_OP_REPLACE:    Replace the profile of the retune queued
+ *                                  at the specified timestamp, retaining its
+ *                                  queue position.
+ *
+ *  Cancel and replace operations fail if no pending entry is scheduled at
+ *  the specified timestamp, including when it is already being performed.
  */
 
 #define NIOS_PKT_RETUNE2_IDX_MAGIC        0
@@ -87,7 +145,18 @@
 #define NIOS_PKT_RETUNE2_IDX_RFFE_PROFILE 11
 #define NIOS_PKT_RETUNE2_IDX_RFFE_PORT    12
 #define NIOS_PKT_RETUNE2_IDX_SPDT         13
-#define NIOS_PKT_RETUNE2_IDX_RESV         14
+#define NIOS_PKT_RETUNE2_IDX_TYPE         14
+#define NIOS_PKT_RETUNE2_IDX_RESV         15
+
+#define NIOS_PKT_RETUNE2_IDX_PARAM_VALUE  9
+#define NIOS_PKT_RETUNE2_IDX_PARAM_CMD    13
+#define NIOS_PKT_RETUNE2_IDX_PARAM_CH     15
+
+#define NIOS_PKT_RETUNE2_IDX_PAIR_RX_NIOS 9
+#define NIOS_PKT_RETUNE2_IDX_PAIR_TX_NIOS 10
+#define NIOS_PKT_RETUNE2_IDX_PAIR_RX_RFFE 11
+#define NIOS_PKT_RETUNE2_IDX_PAIR_TX_RFFE 12
+#define NIOS_PKT_RETUNE2_IDX_PAIR_PORT    15
 
 #define NIOS_PKT_RETUNE2_MAGIC            'U'
 
@@ -100,6 +169,33 @@
 /* The IS_RX bit embedded in the 'port' parameter of the retune2 packet */
 #define NIOS_PKT_RETUNE2_PORT_IS_RX_MASK  (0x1 << 7)
 
+/* Entry types */
+#define NIOS_PKT_RETUNE2_TYPE_RETUNE      0x00
+#define NIOS_PKT_RETUNE2_TYPE_RFIC_CMD    0x01
+#define NIOS_PKT_RETUNE2_TYPE_RFPORT      0x02
+#define NIOS_PKT_RETUNE2_TYPE_RETUNE_PAIR 0x03
+#define NIOS_PKT_RETUNE2_TYPE_RFFE        0x04
+
+/* Queue operations */
+#define NIOS_PKT_RETUNE2_OP_MASK          0x03
+#define NIOS_PKT_RETUNE2_OP_SCHEDULE      0x00
+#define NIOS_PKT_RETUNE2_OP_CANCEL        0x01
+#define NIOS_PKT_RETUNE2_OP_REPLACE       0x02
+
+/* Port selection fields of the RFFE port parameter */
+#define NIOS_PKT_RETUNE2_PORT_RX_MASK     (0x3f)
+#define NIOS_PKT_RETUNE2_PORT_TX_MASK     (0x1 << 6)
+
+/* Fields of the value of an RF port change entry */
+#define NIOS_PKT_RETUNE2_RFPORT_PORT_MASK  (0xff)
+#define NIOS_PKT_RETUNE2_RFPORT_SPDT_SHIFT (8)
+#define NIOS_PKT_RETUNE2_RFPORT_SPDT_MASK  (0xff << 8)
+#define NIOS_PKT_RETUNE2_RFPORT_SPDT_VALID (0x1 << 16)
+
+/* Fields of the value of an RFFE control change entry */
+#define NIOS_PKT_RETUNE2_RFFE_BITS_MASK    (0xffff)
+#define NIOS_PKT_RETUNE2_RFFE_MASK_SHIFT   (16)
+
 /* Pack the retune2 request buffer with the provided parameters */
 static inline void nios_pkt_retune2_pack(uint8_t *buf,
                                          bladerf_module module,
@@ -138,8 +234,87 @@ static inline void nios_pkt_retune2_pack(uint8_t *buf,
 
     buf[NIOS_PKT_RETUNE2_IDX_SPDT] = spdt & 0xff;
 
-    buf[NIOS_PKT_RETUNE2_IDX_RESV + 0] = 0x00;
-    buf[NIOS_PKT_RETUNE2_IDX_RESV + 1] = 0x00;
+    buf[NIOS_PKT_RETUNE2_IDX_TYPE] = NIOS_PKT_RETUNE2_TYPE_RETUNE;
+
+    buf[NIOS_PKT_RETUNE2_IDX_RESV] = 0x00;
+}
+
+/* Set the queue operation of a packed retune2 request */
+static inline void nios_pkt_retune2_set_op(uint8_t *buf, uint8_t op)
+{
+    buf[NIOS_PKT_RETUNE2_IDX_RESV] = op & NIOS_PKT_RETUNE2_OP_MASK;
+}
+
+/* Get the queue operation of a retune2 request */
+static inline uint8_t nios_pkt_retune2_get_op(const uint8_t *buf)
+{
+    return buf[NIOS_PKT_RETUNE2_IDX_RESV] & NIOS_PKT_RETUNE2_OP_MASK;
+}
+
+/* Pack a retune2 request buffer for a scheduled parameter change entry */
+static inline void nios_pkt_retune2_param_pack(uint8_t *buf,
+                                               bladerf_channel ch,
+                                               uint64_t timestamp,
+                                               uint8_t type,
+                                               uint8_t cmd,
+                                               uint32_t value)
+{
+    buf[NIOS_PKT_RETUNE2_IDX_MAGIC] = NIOS_PKT_RETUNE2_MAGIC;
+
+    buf[NIOS_PKT_RETUNE2_IDX_TIME + 0] = (timestamp >>  0) & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_TIME + 1] = (timestamp >>  8) & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_TIME + 2] = (timestamp >> 16) & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_TIME + 3] = (timestamp >> 24) & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_TIME + 4] = (timestamp >> 32) & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_TIME + 5] = (timestamp >> 40) & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_TIME + 6] = (timestamp >> 48) & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_TIME + 7] = (timestamp >> 56) & 0xff;
+
+    buf[NIOS_PKT_RETUNE2_IDX_PARAM_VALUE + 0] = (value >>  0) & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_PARAM_VALUE + 1] = (value >>  8) & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_PARAM_VALUE + 2] = (value >> 16) & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_PARAM_VALUE + 3] = (value >> 24) & 0xff;
+
+    buf[NIOS_PKT_RETUNE2_IDX_PARAM_CMD] = cmd;
+
+    buf[NIOS_PKT_RETUNE2_IDX_TYPE] = type;
+
+    buf[NIOS_PKT_RETUNE2_IDX_PARAM_CH] = ch & 0xff;
+}
+
+/* Pack a retune2 request buffer for a paired RX and TX retune. The Nios
+ * profile numbers must be less than 256. */
+static inline void nios_pkt_retune2_pair_pack(uint8_t *buf,
+                                              uint64_t timestamp,
+                                              uint16_t rx_nios_profile,
+                                              uint8_t rx_rffe_profile,
+                                              uint16_t tx_nios_profile,
+                                              uint8_t tx_rffe_profile,
+                                              uint8_t port,
+                                              uint8_t spdt)
+{
+    buf[NIOS_PKT_RETUNE2_IDX_MAGIC] = NIOS_PKT_RETUNE2_MAGIC;
+
+    buf[NIOS_PKT_RETUNE2_IDX_TIME + 0] = (timestamp >>  0) & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_TIME + 1] = (timestamp >>  8) & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_TIME + 2] = (timestamp >> 16) & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_TIME + 3] = (timestamp >> 24) & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_TIME + 4] = (timestamp >> 32) & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_TIME + 5] = (timestamp >> 40) & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_TIME + 6] = (timestamp >> 48) & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_TIME + 7] = (timestamp >> 56) & 0xff;
+
+    buf[NIOS_PKT_RETUNE2_IDX_PAIR_RX_NIOS] = rx_nios_profile & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_PAIR_TX_NIOS] = tx_nios_profile & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_PAIR_RX_RFFE] = rx_rffe_profile & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_PAIR_TX_RFFE] = tx_rffe_profile & 0xff;
+
+    buf[NIOS_PKT_RETUNE2_IDX_SPDT] = spdt & 0xff;
+
+    buf[NIOS_PKT_RETUNE2_IDX_TYPE] = NIOS_PKT_RETUNE2_TYPE_RETUNE_PAIR;
+
+    buf[NIOS_PKT_RETUNE2_IDX_PAIR_PORT] =
+        port & (NIOS_PKT_RETUNE2_PORT_RX_MASK | NIOS_PKT_RETUNE2_PORT_TX_MASK);
 }
 
 /* Unpack a retune request */
@@ -177,6 +352,67 @@ static inline void nios_pkt_retune2_unpack(const uint8_t *buf,
 
 }
 
+/* Unpack a paired RX and TX retune request */
+static inline void nios_pkt_retune2_pair_unpack(const uint8_t *buf,
+                                                uint64_t *timestamp,
+                                                uint16_t *rx_nios_profile,
+                                                uint8_t *rx_rffe_profile,
+                                                uint16_t *tx_nios_profile,
+                                                uint8_t *tx_rffe_profile,
+                                                uint8_t *port,
+                                                uint8_t *spdt)
+{
+    *timestamp  = ( ((uint64_t)buf[NIOS_PKT_RETUNE2_IDX_TIME + 0]) <<  0 );
+    *timestamp |= ( ((uint64_t)buf[NIOS_PKT_RETUNE2_IDX_TIME + 1]) <<  8 );
+    *timestamp |= ( ((uint64_t)buf[NIOS_PKT_RETUNE2_IDX_TIME + 2]) << 16 );
+    *timestamp |= ( ((uint64_t)buf[NIOS_PKT_RETUNE2_IDX_TIME + 3]) << 24 );
+    *timestamp |= ( ((uint64_t)buf[NIOS_PKT_RETUNE2_IDX_TIME + 4]) << 32 );
+    *timestamp |= ( ((uint64_t)buf[NIOS_PKT_RETUNE2_IDX_TIME + 5]) << 40 );
+    *timestamp |= ( ((uint64_t)buf[NIOS_PKT_RETUNE2_IDX_TIME + 6]) << 48 );
+    *timestamp |= ( ((uint64_t)buf[NIOS_PKT_RETUNE2_IDX_TIME + 7]) << 56 );
+
+    *rx_nios_profile = buf[NIOS_PKT_RETUNE2_IDX_PAIR_RX_NIOS];
+    *tx_nios_profile = buf[NIOS_PKT_RETUNE2_IDX_PAIR_TX_NIOS];
+    *rx_rffe_profile = buf[NIOS_PKT_RETUNE2_IDX_PAIR_RX_RFFE];
+    *tx_rffe_profile = buf[NIOS_PKT_RETUNE2_IDX_PAIR_TX_RFFE];
+
+    *port = buf[NIOS_PKT_RETUNE2_IDX_PAIR_PORT];
+
+    *spdt = buf[NIOS_PKT_RETUNE2_IDX_SPDT];
+}
+
+/* Get the entry type of a retune2 request */
+static inline uint8_t nios_pkt_retune2_type(const uint8_t *buf)
+{
+    return buf[NIOS_PKT_RETUNE2_IDX_TYPE];
+}
+
+/* Unpack a scheduled parameter change request */
+static inline void nios_pkt_retune2_param_unpack(const uint8_t *buf,
+                                                 bladerf_channel *ch,
+                                                 uint64_t *timestamp,
+                                                 uint8_t *cmd,
+                                                 uint32_t *value)
+{
+    *timestamp  = ( ((uint64_t)buf[NIOS_PKT_RETUNE2_IDX_TIME + 0]) <<  0 );
+    *timestamp |= ( ((uint64_t)buf[NIOS_PKT_RETUNE2_IDX_TIME + 1]) <<  8 );
+    *timestamp |= ( ((uint64_t)buf[NIOS_PKT_RETUNE2_IDX_TIME + 2]) << 16 );
+    *timestamp |= ( ((uint64_t)buf[NIOS_PKT_RETUNE2_IDX_TIME + 3]) << 24 );
+    *timestamp |= ( ((uint64_t)buf[NIOS_PKT_RETUNE2_IDX_TIME + 4]) << 32 );
+    *timestamp |= ( ((uint64_t)buf[NIOS_PKT_RETUNE2_IDX_TIME + 5]) << 40 );
+    *timestamp |= ( ((uint64_t)buf[NIOS_PKT_RETUNE2_IDX_TIME + 6]) << 48 );
+    *timestamp |= ( ((uint64_t)buf[NIOS_PKT_RETUNE2_IDX_TIME + 7]) << 56 );
+
+    *value  = ( ((uint32_t)buf[NIOS_PKT_RETUNE2_IDX_PARAM_VALUE + 0]) <<  0 );
+    *value |= ( ((uint32_t)buf[NIOS_PKT_RETUNE2_IDX_PARAM_VALUE + 1]) <<  8 );
+    *value |= ( ((uint32_t)buf[NIOS_PKT_RETUNE2_IDX_PARAM_VALUE + 2]) << 16 );
+    *value |= ( ((uint32_t)buf[NIOS_PKT_RETUNE2_IDX_PARAM_VALUE + 3]) << 24 );
+
+    *cmd = buf[NIOS_PKT_RETUNE2_IDX_PARAM_CMD];
+
+    *ch = (bladerf_channel)buf[NIOS_PKT_RETUNE2_IDX_PARAM_CH];
+}
+
 
 /*
  *                             Response
@@ -216,7 +452,8 @@ static inline void nios_pkt_retune2_unpack(const uint8_t *buf,
  *                unexpected failurs.
  *
  *                The scheduled tune request will failure if the retune queue
- *                is full.
+ *                is full. Cancel and replace requests fail if no pending
+ *                entry is scheduled at the specified timestamp.
  *
  *      flags[7:2]    Reserved. Set to 0.
  */
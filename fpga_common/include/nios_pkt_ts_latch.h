@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BLADERF_NIOS_PKT_TS_LATCH_H_
+#define BLADERF_NIOS_PKT_TS_LATCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/*
+ * This file defines the Host <-> FPGA (NIOS II) packet format for latching a
+ * module's timestamp counter as it is correlated with the host clock.
+ *
+ * A pkt_8x64 timestamp read returns a value sampled at some unknown point
+ * between the host sending the request and receiving the response. To narrow
+ * this, the command UART's interrupt handler latches the timestamp as soon as
+ * a request with this format's magic value arrives. The handler then reports
+ * the number of timestamp ticks that elapsed between the latch and the
+ * response being written, which the host can subtract from the round trip.
+ * The latch is therefore known to have occurred within:
+ *
+ *   [ host send time, host receive time - hold ticks ]
+ *
+ *
+ *                              Request
+ *                      ----------------------
+ *
+ * +================+=========================================================+
+ * |  Byte offset   |                       Description                       |
+ * +================+=========================================================+
+ * |        0       | Magic Value                                             |
+ * +----------------+---------------------------------------------------------+
+ * |        1       | Flags (Note 1)                                          |
+ * +----------------+---------------------------------------------------------+
+ * |      15:2      | Reserved. Should be set to 0.                           |
+ * +----------------+---------------------------------------------------------+
+ *
+ *
+ *                              Response
+ *                      ----------------------
+ *
+ * +================+=========================================================+
+ * |  Byte offset   |                       Description                       |
+ * +================+=========================================================+
+ * |        0       | Magic Value                                             |
+ * +----------------+---------------------------------------------------------+
+ * |        1       | Flags (Note 1)                                          |
+ * +----------------+---------------------------------------------------------+
+ * |       9:2      | Latched timestamp, little-endian                        |
+ * +----------------+---------------------------------------------------------+
+ * |      13:10     | Hold time, in timestamp ticks, little-endian (Note 2)   |
+ * +----------------+---------------------------------------------------------+
+ * |      15:14     | Reserved. Set to 0.                                     |
+ * +----------------+---------------------------------------------------------+
+ *
+ * (Note 1)
+ *      +================+========================+
+ *      |      Bit(s)    |         Value          |
+ *      +================+========================+
+ *      |        7       |  1 = Success           |
+ *      |                |  0 = Failure           |
+ *      +----------------+------------------------+
+ *      |       6:1      |        Reserved        |
+ *      +----------------+------------------------+
+ *      |        0       |  0 = RX module         |
+ *      |                |  1 = TX module         |
+ *      +----------------+------------------------+
+ *
+ *  The success bit is ignored in requests.
+ *
+ * (Note 2)
+ *  Ticks of the selected module's counter between the latch and the
+ *  completion of the response, excluding the transfer of the response over
+ *  the command UART. This saturates at 0xffffffff.
+ */
+
+#define NIOS_PKT_TS_LATCH_MAGIC         ((uint8_t) 'H')
+
+/* Packet indices */
+#define NIOS_PKT_TS_LATCH_IDX_MAGIC     0
+#define NIOS_PKT_TS_LATCH_IDX_FLAGS     1
+#define NIOS_PKT_TS_LATCH_IDX_TIMESTAMP 2
+#define NIOS_PKT_TS_LATCH_IDX_HOLD      10
+#define NIOS_PKT_TS_LATCH_IDX_RESV      14
+
+/* Flags */
+#define NIOS_PKT_TS_LATCH_FLAG_TX       (1 << 0)
+#define NIOS_PKT_TS_LATCH_FLAG_SUCCESS  (1 << 7)
+
+/* Pack the request buffer */
+static inline void nios_pkt_ts_latch_pack(uint8_t *buf, bool tx)
+{
+    memset(buf, 0, NIOS_PKT_TS_LATCH_IDX_RESV + 2);
+
+    buf[NIOS_PKT_TS_LATCH_IDX_MAGIC] = NIOS_PKT_TS_LATCH_MAGIC;
+
+    if (tx) {
+        buf[NIOS_PKT_TS_LATCH_IDX_FLAGS] = NIOS_PKT_TS_LATCH_FLAG_TX;
+    }
+}
+
+/* Unpack the request buffer */
+static inline void nios_pkt_ts_latch_unpack(const uint8_t *buf, bool *tx)
+{
+    *tx = (buf[NIOS_PKT_TS_LATCH_IDX_FLAGS] & NIOS_PKT_TS_LATCH_FLAG_TX) != 0;
+}
+
+/* Pack the response buffer */
+static inline void nios_pkt_ts_latch_resp_pack(uint8_t *buf, bool tx,
+                                               uint64_t timestamp,
+                                               uint32_t hold, bool success)
+{
+    int i;
+
+    nios_pkt_ts_latch_pack(buf, tx);
+
+    if (success) {
+        buf[NIOS_PKT_TS_LATCH_IDX_FLAGS] |= NIOS_PKT_TS_LATCH_FLAG_SUCCESS;
+    }
+
+    for (i = 0; i < 8; i++) {
+        buf[NIOS_PKT_TS_LATCH_IDX_TIMESTAMP + i] = (timestamp >> (8 * i)) & 0xff;
+    }
+
+    for (i = 0; i < 4; i++) {
+        buf[NIOS_PKT_TS_LATCH_IDX_HOLD + i] = (hold >> (8 * i)) & 0xff;
+    }
+}
+
+/* Unpack the response buffer */
+static inline void nios_pkt_ts_latch_resp_unpack(const uint8_t *buf,
+                                                 uint64_t *timestamp,
+                                                 uint32_t *hold,
+                                                 bool *success)
+{
+    int i;
+
+    *timestamp = 0;
+    for (i = 0; i < 8; i++) {
+        *timestamp |=
+            (uint64_t)buf[NIOS_PKT_TS_LATCH_IDX_TIMESTAMP + i] << (8 * i);
+    }
+
+    *hold = 0;
+    for (i = 0; i < 4; i++) {
+        *hold |= (uint32_t)buf[NIOS_PKT_TS_LATCH_IDX_HOLD + i] << (8 * i);
+    }
+
+    *success = (buf[NIOS_PKT_TS_LATCH_IDX_FLAGS] &
+                NIOS_PKT_TS_LATCH_FLAG_SUCCESS) != 0;
+}
+
+#endif
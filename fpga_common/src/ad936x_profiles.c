@@ -0,0 +1,74 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stddef.h>
+
+#include "ad936x_profiles.h"
+
+#define ARRAY_LEN(x) (sizeof(x) / sizeof((x)[0]))
+
+/* LTE sample rates. These were produced by ad9361_calculate_rf_clock_chain()
+ * with the default DAC divider and the FIR ratios used by
+ * bladerf2_rfic_rx_fir_config (1/1) and bladerf2_rfic_rx_fir_config_dec4
+ * (1/4). The 30.72 Msps entry matches the path clocks in
+ * bladerf2_rfic_init_params. */
+static const struct ad936x_profile profiles[] = {
+    {
+        30720000, 1,
+        { 983040000, 245760000, 122880000, 61440000, 30720000, 30720000 },
+        { 983040000, 122880000, 122880000, 61440000, 30720000, 30720000 },
+    },
+    {
+        15360000, 1,
+        { 983040000, 122880000, 61440000, 30720000, 15360000, 15360000 },
+        { 983040000, 61440000, 61440000, 30720000, 15360000, 15360000 },
+    },
+    {
+        7680000, 1,
+        { 983040000, 61440000, 30720000, 15360000, 7680000, 7680000 },
+        { 983040000, 30720000, 30720000, 15360000, 7680000, 7680000 },
+    },
+    {
+        3840000, 1,
+        { 983040000, 30720000, 15360000, 7680000, 3840000, 3840000 },
+        { 983040000, 15360000, 15360000, 7680000, 3840000, 3840000 },
+    },
+    {
+        1920000, 4,
+        { 737280000, 92160000, 30720000, 15360000, 7680000, 1920000 },
+        { 737280000, 92160000, 30720000, 15360000, 7680000, 1920000 },
+    },
+};
+
+struct ad936x_profile const *ad936x_profile_find(uint32_t sample_rate,
+                                                 uint32_t fir_ratio)
+{
+    size_t i;
+
+    for (i = 0; i < ARRAY_LEN(profiles); i++) {
+        if (profiles[i].sample_rate == sample_rate &&
+            profiles[i].fir_ratio == fir_ratio) {
+            return &profiles[i];
+        }
+    }
+
+    return NULL;
+}
@@ -65,9 +65,15 @@
             INC_BUSY_WAIT_COUNT(us); \
             log_verbose("VTUNE_BUSY_WAIT(%u)\n", us); \
         } while(0)
+
+#   define DC_CAL_POLL_WAIT() do { } while (0)
 #else
 #   include <unistd.h>
 #   define VTUNE_BUSY_WAIT(us) { usleep(us); INC_BUSY_WAIT_COUNT(us); }
+
+    /* Space out DC_CLBR_DONE polls by roughly the duration of a USB
+     * round trip, so the loop allows as much time as it does on the host */
+#   define DC_CAL_POLL_WAIT() usleep(100)
 #endif
 
 /* By counting the busy waits between a VCOCAP write and VTUNE read, we can
@@ -406,49 +412,30 @@ static int write_pll_config(struct bladerf *dev, bladerf_module module,
 int lms_config_charge_pumps(struct bladerf *dev, bladerf_module module)
 {
     int status;
-    uint8_t data;
+    size_t i;
     const uint8_t base = (module == BLADERF_MODULE_RX) ? 0x20 : 0x10;
 
-    /* Set the PLL Ichp, Iup and Idn currents */
-    status = LMS_READ(dev, base + 6, &data);
-    if (status != 0) {
-        return status;
-    }
-
-    data &= ~(0x1f);
-    data |= 0x0c;
+    /* PLL Ichp, Iup and Idn currents */
+    static const uint8_t currents[3] = { 0x0c, 3, 3 };
+    struct backend_reg_op ops[3];
 
-    status = LMS_WRITE(dev, base + 6, data);
-    if (status != 0) {
-        return status;
+    for (i = 0; i < ARRAY_SIZE(ops); i++) {
+        ops[i].addr  = base + 6 + (uint8_t)i;
+        ops[i].data  = 0;
+        ops[i].write = false;
     }
 
-    status = LMS_READ(dev, base + 7, &data);
+    status = LMS_BATCH(dev, ops, ARRAY_SIZE(ops));
     if (status != 0) {
         return status;
     }
 
-    data &= ~(0x1f);
-    data |= 3;
-
-    status = LMS_WRITE(dev, base + 7, data);
-    if (status != 0) {
-        return status;
+    for (i = 0; i < ARRAY_SIZE(ops); i++) {
+        ops[i].data  = (ops[i].data & ~(0x1f)) | currents[i];
+        ops[i].write = true;
     }
 
-    status = LMS_READ(dev, base + 8, &data);
-    if (status != 0) {
-        return status;
-    }
-
-    data &= ~(0x1f);
-    data |= 3;
-    status = LMS_WRITE(dev, base + 8, data);
-    if (status != 0) {
-        return status;
-    }
-
-    return 0;
+    return LMS_BATCH(dev, ops, ARRAY_SIZE(ops));
 }
 #endif
 
@@ -1095,6 +1082,110 @@ int lms_txvga1_get_gain(struct bladerf *dev, int *gain)
 }
 #endif
 
+#ifndef BLADERF_NIOS_BUILD
+void lms_rx_gain_regs(bladerf_lna_gain lna, int rxvga1, int rxvga2,
+                      struct lms_gain_regs *regs)
+{
+    if (lna != BLADERF_LNA_GAIN_BYPASS && lna != BLADERF_LNA_GAIN_MID) {
+        lna = BLADERF_LNA_GAIN_MAX;
+    }
+
+    if (rxvga1 > BLADERF_RXVGA1_GAIN_MAX) {
+        rxvga1 = BLADERF_RXVGA1_GAIN_MAX;
+    } else if (rxvga1 < BLADERF_RXVGA1_GAIN_MIN) {
+        rxvga1 = BLADERF_RXVGA1_GAIN_MIN;
+    }
+
+    if (rxvga2 > BLADERF_RXVGA2_GAIN_MAX) {
+        rxvga2 = BLADERF_RXVGA2_GAIN_MAX;
+    } else if (rxvga2 < BLADERF_RXVGA2_GAIN_MIN) {
+        rxvga2 = BLADERF_RXVGA2_GAIN_MIN;
+    }
+
+    regs->lna  = (uint8_t)lna;
+    regs->vga1 = rxvga1_lut_val2code[rxvga1];
+    regs->vga2 = (uint8_t)(rxvga2 / 3);
+}
+#endif
+
+#ifndef BLADERF_NIOS_BUILD
+void lms_tx_gain_regs(int txvga1, int txvga2, struct lms_gain_regs *regs)
+{
+    if (txvga1 > BLADERF_TXVGA1_GAIN_MAX) {
+        txvga1 = BLADERF_TXVGA1_GAIN_MAX;
+    } else if (txvga1 < BLADERF_TXVGA1_GAIN_MIN) {
+        txvga1 = BLADERF_TXVGA1_GAIN_MIN;
+    }
+
+    if (txvga2 > BLADERF_TXVGA2_GAIN_MAX) {
+        txvga2 = BLADERF_TXVGA2_GAIN_MAX;
+    } else if (txvga2 < BLADERF_TXVGA2_GAIN_MIN) {
+        txvga2 = BLADERF_TXVGA2_GAIN_MIN;
+    }
+
+    regs->lna  = 0;
+    regs->vga1 = (uint8_t)(txvga1 + 35);
+    regs->vga2 = (uint8_t)txvga2;
+}
+#endif
+
+#ifndef BLADERF_NIOS_BUILD
+int lms_set_gain_regs(struct bladerf *dev, bladerf_module module,
+                      const struct lms_gain_regs *regs)
+{
+    struct backend_reg_op ops[3];
+    uint8_t values[3];
+    unsigned int count, i, n;
+    int status;
+
+    if (module == BLADERF_MODULE_RX) {
+        ops[0].addr = 0x75;
+        ops[1].addr = 0x76;
+        ops[2].addr = 0x65;
+        count       = 3;
+    } else {
+        ops[0].addr = 0x41;
+        ops[1].addr = 0x45;
+        count       = 2;
+    }
+
+    for (i = 0; i < count; i++) {
+        ops[i].data  = 0;
+        ops[i].write = false;
+    }
+
+    status = LMS_BATCH(dev, ops, count);
+    if (status != 0) {
+        return status;
+    }
+
+    if (module == BLADERF_MODULE_RX) {
+        values[0] = (ops[0].data & ~(3 << 6)) | ((regs->lna & 3) << 6);
+        values[1] = regs->vga1;
+        values[2] = regs->vga2;
+    } else {
+        values[0] = regs->vga1;
+        values[1] = (ops[1].data & ~(0x1f << 3)) | ((regs->vga2 & 0x1f) << 3);
+    }
+
+    /* Only write the registers that change */
+    for (i = 0, n = 0; i < count; i++) {
+        if (ops[i].data != values[i]) {
+            ops[n].addr  = ops[i].addr;
+            ops[n].data  = values[i];
+            ops[n].write = true;
+            n++;
+        }
+    }
+
+    if (n == 0) {
+        return 0;
+    }
+
+    return LMS_BATCH(dev, ops, n);
+}
+#endif
+
 #ifndef BLADERF_NIOS_BUILD
 static inline int enable_lna_power(struct bladerf *dev, bool enable)
 {
@@ -1700,51 +1791,26 @@ int lms_get_frequency(struct bladerf *dev, bladerf_module mod,
 {
     const uint8_t base = (mod == BLADERF_MODULE_RX) ? 0x20 : 0x10;
     int status;
-    uint8_t data;
+    uint8_t regs[10];
 
-    status = LMS_READ(dev, base + 0, &data);
+    /* NINT/NFRAC (base + 0..3), FREQSEL (base + 5) and VCOCAP (base + 9) are
+     * read as a single block */
+    status = LMS_READ_BLOCK(dev, base, regs, ARRAY_SIZE(regs));
     if (status != 0) {
         return status;
     }
 
-    f->nint = ((uint16_t)data) << 1;
+    f->nint = ((uint16_t)regs[0]) << 1;
+    f->nint |= (regs[1] & 0x80) >> 7;
 
-    status = LMS_READ(dev, base + 1, &data);
-    if (status != 0) {
-        return status;
-    }
+    f->nfrac = ((uint32_t)regs[1] & 0x7f) << 16;
+    f->nfrac |= ((uint32_t)regs[2])<<8;
+    f->nfrac |= regs[3];
 
-    f->nint |= (data & 0x80) >> 7;
-    f->nfrac = ((uint32_t)data & 0x7f) << 16;
-
-    status = LMS_READ(dev, base + 2, &data);
-    if (status != 0) {
-        return status;
-    }
-
-    f->nfrac |= ((uint32_t)data)<<8;
-
-    status = LMS_READ(dev, base + 3, &data);
-    if (status != 0) {
-        return status;
-    }
-
-    f->nfrac |= data;
-
-    status = LMS_READ(dev, base + 5, &data);
-    if (status != 0) {
-        return status;
-    }
-
-    f->freqsel = (data>>2);
+    f->freqsel = (regs[5]>>2);
     f->x = 1 << ((f->freqsel & 7) - 3);
 
-    status = LMS_READ(dev, base + 9, &data);
-    if (status != 0) {
-        return status;
-    }
-
-    f->vcocap = data & 0x3f;
+    f->vcocap = regs[9] & 0x3f;
 
     return status;
 }
@@ -1782,10 +1848,10 @@ int lms_get_quick_tune(struct bladerf *dev,
             } else {
                 /* BLADERF_XB_CONFIG_TX_BYPASS_MASK */
                 quick_tune->xb_gpio |= ( (val & 0x0C ) >> 2)
-                                            << LMS_FREQ_XB_200_FILTER_SW_SHIFT;
+                                            << LMS_FREQ_XB_200_PATH_SHIFT;
                 /* BLADERF_XB_TX_MASK */
                 quick_tune->xb_gpio |= ( (val & 0x0C000000 ) >> 26)
-                                            << LMS_FREQ_XB_200_PATH_SHIFT;
+                                            << LMS_FREQ_XB_200_FILTER_SW_SHIFT;
             }
         }
 
@@ -2313,6 +2379,86 @@ int lms_calculate_tuning_params(uint32_t freq, struct lms_freq *f)
 }
 #endif
 
+/* Poll VTUNE until it reports the normal range, without any delay between
+ * reads, so that the caller may measure how long the PLL took to settle */
+static int wait_for_lock(struct bladerf *dev, uint8_t base, bool *locked)
+{
+    int status;
+    unsigned int i;
+    uint8_t vtune;
+
+    *locked = false;
+
+    for (i = 0; i < VTUNE_MAX_ITERATIONS; i++) {
+        status = get_vtune(dev, base, 0, &vtune);
+        if (status != 0) {
+            return status;
+        }
+
+        if (vtune == VCO_NORM) {
+            *locked = true;
+            break;
+        }
+    }
+
+    return 0;
+}
+
+int lms_tune_vcocap(struct bladerf *dev, bladerf_module mod,
+                    uint8_t vcocap_est, uint8_t *vcocap_result, bool *locked)
+{
+    const uint8_t base = (mod == BLADERF_MODULE_RX) ? 0x20 : 0x10;
+    uint8_t vcocap_reg_state;
+    int status;
+
+    *locked = false;
+
+    if (vcocap_est > VCOCAP_MAX_VALUE) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    status = LMS_READ(dev, base + 9, &vcocap_reg_state);
+    if (status != 0) {
+        return status;
+    }
+
+    vcocap_reg_state &= ~(0x3f);
+
+    status = tune_vcocap(dev, vcocap_est, base, vcocap_reg_state,
+                         vcocap_result);
+    if (status != 0) {
+        return status;
+    }
+
+    return wait_for_lock(dev, base, locked);
+}
+
+/* Run the VCOCAP search, on the NIOS II if the FPGA supports it. This
+ * avoids a USB round trip for each VTUNE comparator read. */
+static int search_vcocap(struct bladerf *dev, bladerf_module mod,
+                         uint8_t base, uint8_t vcocap_est,
+                         uint8_t vcocap_reg_state, uint8_t *vcocap_result,
+                         bool *locked)
+{
+    int status;
+
+#   ifndef BLADERF_NIOS_BUILD
+    if (have_cap(dev->board->get_capabilities(dev),
+                 BLADERF_CAP_FPGA_VCOCAP_SEARCH)) {
+        return dev->backend->lms_vcocap_search(dev, mod, vcocap_est,
+                                               vcocap_result, locked);
+    }
+#   endif
+
+    status = tune_vcocap(dev, vcocap_est, base, vcocap_reg_state,
+                         vcocap_result);
+    if (status != 0) {
+        return status;
+    }
+
+    return wait_for_lock(dev, base, locked);
+}
+
 int lms_set_precalculated_frequency(struct bladerf *dev, bladerf_module mod,
                                     struct lms_freq *f)
 {
@@ -2322,6 +2468,9 @@ int lms_set_precalculated_frequency(struct bladerf *dev, bladerf_module mod,
     uint8_t data;
     uint8_t vcocap_reg_state;
     int status, dsm_status;
+    struct backend_reg_op pll_ops[4];
+    size_t i;
+    bool locked;
 
     /* Utilize atomic writes to the PLL registers, if possible. This
      * "multiwrite" is indicated by the MSB being set. */
@@ -2335,6 +2484,7 @@ int lms_set_precalculated_frequency(struct bladerf *dev, bladerf_module mod,
 #   endif
 
     f->vcocap_result = 0xff;
+    f->flags &= ~LMS_FREQ_FLAGS_LOCKED;
 
     /* Turn on the DSMs */
     status = LMS_READ(dev, 0x09, &data);
@@ -2369,26 +2519,18 @@ int lms_set_precalculated_frequency(struct bladerf *dev, bladerf_module mod,
         goto error;
     }
 
-    data = f->nint >> 1;
-    status = LMS_WRITE(dev, pll_base + 0, data);
-    if (status != 0) {
-        goto error;
-    }
-
-    data = ((f->nint & 1) << 7) | ((f->nfrac >> 16) & 0x7f);
-    status = LMS_WRITE(dev, pll_base + 1, data);
-    if (status != 0) {
-        goto error;
-    }
+    /* NINT and NFRAC are written in a single batch, if supported */
+    pll_ops[0].data = f->nint >> 1;
+    pll_ops[1].data = ((f->nint & 1) << 7) | ((f->nfrac >> 16) & 0x7f);
+    pll_ops[2].data = ((f->nfrac >> 8) & 0xff);
+    pll_ops[3].data = (f->nfrac & 0xff);
 
-    data = ((f->nfrac >> 8) & 0xff);
-    status = LMS_WRITE(dev, pll_base + 2, data);
-    if (status != 0) {
-        goto error;
+    for (i = 0; i < ARRAY_SIZE(pll_ops); i++) {
+        pll_ops[i].addr  = pll_base + (uint8_t)i;
+        pll_ops[i].write = true;
     }
 
-    data = (f->nfrac & 0xff);
-    status = LMS_WRITE(dev, pll_base + 3, data);
+    status = LMS_BATCH(dev, pll_ops, ARRAY_SIZE(pll_ops));
     if (status != 0) {
         goto error;
     }
@@ -2397,10 +2539,15 @@ int lms_set_precalculated_frequency(struct bladerf *dev, bladerf_module mod,
      * the VCOCAP hint as-is. */
     if (f->flags & LMS_FREQ_FLAGS_FORCE_VCOCAP) {
         f->vcocap_result = f->vcocap;
+        status = wait_for_lock(dev, base, &locked);
     } else {
         /* Walk down VCOCAP values find an optimal values */
-        status = tune_vcocap(dev, f->vcocap, base, vcocap_reg_state,
-                             &f->vcocap_result);
+        status = search_vcocap(dev, mod, base, f->vcocap, vcocap_reg_state,
+                               &f->vcocap_result, &locked);
+    }
+
+    if (status == 0 && locked) {
+        f->flags |= LMS_FREQ_FLAGS_LOCKED;
     }
 
 error:
@@ -2418,16 +2565,27 @@ error:
 int lms_dump_registers(struct bladerf *dev)
 {
     int status = 0;
-    uint8_t data,i;
+    uint8_t data[16];
+    uint16_t i, n, j;
     const uint16_t num_reg = sizeof(lms_reg_dumpset);
 
-    for (i = 0; i < num_reg; i++) {
-        status = LMS_READ(dev, lms_reg_dumpset[i], &data);
+    /* Read each run of consecutive addresses as a block */
+    for (i = 0; i < num_reg; i += n) {
+        for (n = 1; (i + n) < num_reg && n < ARRAY_SIZE(data); n++) {
+            if (lms_reg_dumpset[i + n] != lms_reg_dumpset[i] + n) {
+                break;
+            }
+        }
+
+        status = LMS_READ_BLOCK(dev, lms_reg_dumpset[i], data, n);
         if (status != 0) {
             log_debug("Failed to read LMS @ 0x%02x\n", lms_reg_dumpset[i]);
             return status;
-        } else {
-            log_debug("LMS[0x%02x] = 0x%02x\n", lms_reg_dumpset[i], data);
+        }
+
+        for (j = 0; j < n; j++) {
+            log_debug("LMS[0x%02x] = 0x%02x\n", lms_reg_dumpset[i + j],
+                      data[j]);
         }
     }
 
@@ -2436,10 +2594,9 @@ int lms_dump_registers(struct bladerf *dev)
 #endif
 
 /* Reference LMS6002D calibration guide, section 4.1 flow chart */
-#ifndef BLADERF_NIOS_BUILD
-static int lms_dc_cal_loop(struct bladerf *dev, uint8_t base,
-                           uint8_t cal_address, uint8_t dc_cntval,
-                           uint8_t *dc_regval)
+int lms_dc_cal_loop(struct bladerf *dev, uint8_t base,
+                    uint8_t cal_address, uint8_t dc_cntval,
+                    uint8_t *dc_regval)
 {
     int status;
     uint8_t i, val;
@@ -2496,6 +2653,10 @@ static int lms_dc_cal_loop(struct bladerf *dev, uint8_t base,
 
     /* Main loop checking the calibration */
     for (i = 0 ; i < max_cal_count && !done; i++) {
+        if (i != 0) {
+            DC_CAL_POLL_WAIT();
+        }
+
         /* Read active low DC_CLBR_DONE */
         status = LMS_READ(dev, base + 0x01, &val);
         if (status != 0) {
@@ -2523,6 +2684,38 @@ static int lms_dc_cal_loop(struct bladerf *dev, uint8_t base,
 
     return status;
 }
+
+/* Run the DC calibration loop, on the NIOS II if the FPGA supports it. This
+ * avoids a USB round trip for each register access and DC_CLBR_DONE poll. */
+#ifndef BLADERF_NIOS_BUILD
+static int dc_cal_loop(struct bladerf *dev, uint8_t base,
+                       uint8_t cal_address, uint8_t dc_cntval,
+                       uint8_t *dc_regval)
+{
+    int status;
+    bool done;
+
+    if (!have_cap(dev->board->get_capabilities(dev),
+                  BLADERF_CAP_FPGA_LMS_DC_CAL)) {
+        return lms_dc_cal_loop(dev, base, cal_address, dc_cntval, dc_regval);
+    }
+
+    log_debug("Calibrating module %2.2x:%2.2x\n", base, cal_address);
+
+    status = dev->backend->lms_dc_cal_loop(dev, base, cal_address, dc_cntval,
+                                           dc_regval, &done);
+    if (status != 0) {
+        return status;
+    }
+
+    if (!done) {
+        log_warning("DC calibration loop did not converge.\n");
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    log_debug("DC_REGVAL: %d\n", *dc_regval);
+    return 0;
+}
 #endif
 
 #ifndef BLADERF_NIOS_BUILD
@@ -2772,7 +2965,7 @@ static int dc_cal_submodule(struct bladerf *dev,
         }
     }
 
-    status = lms_dc_cal_loop(dev, state->base_addr, submodule, 31, &dc_regval);
+    status = dc_cal_loop(dev, state->base_addr, submodule, 31, &dc_regval);
     if (status != 0) {
         return status;
     }
@@ -2781,7 +2974,7 @@ static int dc_cal_submodule(struct bladerf *dev,
         log_debug("DC_REGVAL suboptimal value - retrying DC cal loop.\n");
 
         /* FAQ item 4.7 indcates that can retry with DC_CNTVAL reset */
-        status = lms_dc_cal_loop(dev, state->base_addr, submodule, 0, &dc_regval);
+        status = dc_cal_loop(dev, state->base_addr, submodule, 0, &dc_regval);
         if (status != 0) {
             return status;
         } else if (dc_regval == 0) {
@@ -3096,7 +3289,6 @@ static inline int enable_txlpf_dccal_clock(struct bladerf *dev, bool enable)
 }
 #endif
 
-#ifndef BLADERF_NIOS_BUILD
 static int set_dc_cal_value(struct bladerf *dev, uint8_t base,
                              uint8_t dc_addr, int16_t value)
 {
@@ -3136,6 +3328,87 @@ static int set_dc_cal_value(struct bladerf *dev, uint8_t base,
 
     return 0;
 }
+
+int lms_load_dc_cal_value(struct bladerf *dev, uint8_t base,
+                          uint8_t dc_addr, uint8_t value)
+{
+    int status, clear_status;
+    uint8_t mask;
+
+    /* DC calibration clock enables in register 0x09 */
+    switch (base) {
+        case 0x00:
+            mask = (1 << 5);
+            break;
+
+        case 0x30:
+            mask = (1 << 1);
+            break;
+
+        case 0x50:
+            mask = (1 << 3);
+            break;
+
+        case 0x60:
+            mask = (1 << 4);
+            break;
+
+        default:
+            return BLADERF_ERR_INVAL;
+    }
+
+    status = lms_set(dev, 0x09, mask);
+    if (status != 0) {
+        return status;
+    }
+
+    status = set_dc_cal_value(dev, base, dc_addr, value);
+
+    clear_status = lms_clear(dev, 0x09, mask);
+    return (status != 0) ? status : clear_status;
+}
+
+/* Load each value on the NIOS II, requiring a single request per value rather
+ * than a request per register access and clock enable/disable */
+#ifndef BLADERF_NIOS_BUILD
+static int load_dc_cals_fpga(struct bladerf *dev,
+                             const struct bladerf_lms_dc_cals *dc_cals)
+{
+    const struct {
+        uint8_t base;
+        uint8_t dc_addr;
+        int16_t value;
+    } values[] = {
+        { 0x00, 0, dc_cals->lpf_tuning },
+        { 0x30, 0, dc_cals->tx_lpf_i },
+        { 0x30, 1, dc_cals->tx_lpf_q },
+        { 0x50, 0, dc_cals->rx_lpf_i },
+        { 0x50, 1, dc_cals->rx_lpf_q },
+        { 0x60, 0, dc_cals->dc_ref },
+        { 0x60, 1, dc_cals->rxvga2a_i },
+        { 0x60, 2, dc_cals->rxvga2a_q },
+        { 0x60, 3, dc_cals->rxvga2b_i },
+        { 0x60, 4, dc_cals->rxvga2b_q },
+    };
+
+    int status;
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(values); i++) {
+        if (values[i].value < 0) {
+            continue;
+        }
+
+        status = dev->backend->lms_dc_cal_load(dev, values[i].base,
+                                               values[i].dc_addr,
+                                               (uint8_t)values[i].value);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    return 0;
+}
 #endif
 
 #ifndef BLADERF_NIOS_BUILD
@@ -3179,6 +3452,11 @@ int lms_set_dc_cals(struct bladerf *dev,
         (dc_cals->rxvga2a_i >= 0) || (dc_cals->rxvga2a_q >= 0) ||
         (dc_cals->rxvga2b_i >= 0) || (dc_cals->rxvga2b_q >= 0);
 
+    if (have_cap(dev->board->get_capabilities(dev),
+                 BLADERF_CAP_FPGA_LMS_DC_CAL)) {
+        return load_dc_cals_fpga(dev, dc_cals);
+    }
+
     if (dc_cals->lpf_tuning >= 0) {
         status = enable_lpf_cal_clock(dev, true);
         if (status != 0) {
@@ -3521,6 +3799,11 @@ static inline uint8_t scale_dc_offset(bladerf_module module, int16_t value)
 
     return ret;
 }
+
+uint8_t lms_dc_offset_to_reg(bladerf_module module, int16_t value)
+{
+    return scale_dc_offset(module, value);
+}
 #endif
 
 #ifndef BLADERF_NIOS_BUILD
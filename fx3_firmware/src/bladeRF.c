@@ -50,6 +50,9 @@ uint8_t glUsbAltInterface = 0;                 /* Active USB interface. */
 
 uint8_t glSelBuffer[32];
 uint8_t glPageBuffer[FLASH_PAGE_SIZE] __attribute__ ((aligned (32)));
+uint8_t glHashResp[BLADE_FLASH_HASH_RESP_SIZE] __attribute__ ((aligned (32)));
+uint8_t glFpgaHashResp[BLADE_FPGA_HASH_RESP_SIZE] __attribute__ ((aligned (32)));
+uint32_t glFwStatsResp[BLADE_FW_STATS_NUM] __attribute__ ((aligned (32)));
 
 CyBool_t glCalCacheValid = CyFalse;
 uint8_t glCal[CAL_BUFFER_SIZE] __attribute__ ((aligned (32)));
@@ -437,7 +440,11 @@ CyBool_t NuandHandleVendorRequest(
     break;
 
     case BLADE_USB_CMD_BEGIN_PROG:
-        retStatus = FpgaBeginProgram();
+        retStatus = NuandFpgaConfigSetCompressed(
+                wValue == BLADE_FPGA_PROG_COMPRESSED);
+        if (0 == retStatus) {
+            retStatus = FpgaBeginProgram();
+        }
         if(0 == retStatus) {
             NuandSetFpgaConfigSource(NUAND_FPGA_CONFIG_SOURCE_HOST);
         }
@@ -455,6 +462,39 @@ CyBool_t NuandHandleVendorRequest(
         CyU3PUsbSendRetCode(ret);
     break;
 
+    case BLADE_USB_CMD_WAIT_FPGA_CONFIGURED:
+        if (wValue > BLADE_FPGA_CONF_WAIT_MAX_MS) {
+            wValue = BLADE_FPGA_CONF_WAIT_MAX_MS;
+        }
+
+        CyU3PUsbSendRetCode(FpgaWaitConfigured(wValue));
+    break;
+
+    case BLADE_USB_CMD_SET_FPGA_HASH:
+        if (wLength != BLADE_FPGA_HASH_SIZE) {
+            apiRetStatus = CyU3PUsbStall(0x0, CyTrue, CyFalse);
+            break;
+        }
+
+        apiRetStatus = CyU3PUsbGetEP0Data(wLength, glFpgaHashResp, &readC);
+        if (apiRetStatus != CY_U3P_SUCCESS) {
+            LOG_ERROR(apiRetStatus);
+        } else if (readC != wLength) {
+            LOG_ERROR(readC);
+        } else {
+            NuandSetFpgaImageHash(glFpgaHashResp);
+        }
+    break;
+
+    case BLADE_USB_CMD_GET_FPGA_HASH:
+        CyU3PMemSet(glFpgaHashResp, 0, sizeof(glFpgaHashResp));
+        ret = NuandGetFpgaImageHash(&glFpgaHashResp[sizeof(ret)]) ? 0 : -1;
+        CyU3PMemCopy(glFpgaHashResp, (uint8_t *)&ret, sizeof(ret));
+
+        apiRetStatus = CyU3PUsbSendEP0Data(sizeof(glFpgaHashResp),
+                                           glFpgaHashResp);
+    break;
+
     case BLADE_USB_CMD_QUERY_DEVICE_READY:
         ret = glDeviceReady ? 1 : 0;
         CyU3PUsbSendRetCode(ret);
@@ -481,6 +521,26 @@ CyBool_t NuandHandleVendorRequest(
     }
     break;
 
+    case BLADE_USB_CMD_SET_SAMPLE_DMA:
+        ret = NuandRFLinkSetDmaConfig(wValue, wIndex) ? 0 : -1;
+        CyU3PUsbSendRetCode(ret);
+    break;
+
+    case BLADE_USB_CMD_GET_SAMPLE_DMA:
+    {
+        uint16_t count, packets;
+        NuandRFLinkGetDmaConfig(&count, &packets);
+        ret = ((uint32_t)count << 16) | packets;
+        CyU3PUsbSendRetCode(ret);
+    }
+    break;
+
+    case BLADE_USB_CMD_GET_FW_STATS:
+        NuandRFLinkGetStats(glFwStatsResp, wValue == 1);
+        apiRetStatus = CyU3PUsbSendEP0Data(sizeof(glFwStatsResp),
+                                           (uint8_t *)glFwStatsResp);
+    break;
+
     case BLADE_USB_CMD_READ_PAGE_BUFFER:
         if(wIndex + wLength > sizeof(glPageBuffer)) {
             apiRetStatus = CyU3PUsbStall(0x80, CyTrue, CyFalse);
@@ -566,6 +626,45 @@ CyBool_t NuandHandleVendorRequest(
         CyU3PUsbSendRetCode(apiRetStatus);
     break;
 
+    case BLADE_USB_CMD_FLASH_READ_PAGES:
+    case BLADE_USB_CMD_FLASH_WRITE_PAGES:
+        if (glUsbAltInterface != USB_IF_SPI_FLASH) {
+            apiRetStatus = CyU3PUsbStall(0x80, CyTrue, CyFalse);
+        }
+
+        apiRetStatus = NuandFlashBulkPrepare(
+                bRequest == BLADE_USB_CMD_FLASH_READ_PAGES);
+        CyU3PUsbSendRetCode(apiRetStatus);
+
+        /* The pages follow on the bulk endpoints, once the host has the
+         * status of the request */
+        if (apiRetStatus == CY_U3P_SUCCESS) {
+            if (bRequest == BLADE_USB_CMD_FLASH_READ_PAGES) {
+                NuandFlashBulkReadPages(wIndex, wValue);
+            } else {
+                NuandFlashBulkWritePages(wIndex, wValue);
+            }
+        }
+    break;
+
+    case BLADE_USB_CMD_FLASH_PAGES_STATUS:
+        CyU3PUsbSendRetCode(NuandFlashBulkStatus());
+    break;
+
+    case BLADE_USB_CMD_FLASH_SHA256:
+        if (glUsbAltInterface != USB_IF_SPI_FLASH) {
+            apiRetStatus = CyU3PUsbStall(0x80, CyTrue, CyFalse);
+        }
+
+        CyU3PMemSet(glHashResp, 0, sizeof(glHashResp));
+        apiRetStatus = NuandFlashHash(wIndex, wValue,
+                                      &glHashResp[sizeof(apiRetStatus)]);
+        CyU3PMemCopy(glHashResp, (uint8_t *)&apiRetStatus,
+                     sizeof(apiRetStatus));
+
+        apiRetStatus = CyU3PUsbSendEP0Data(sizeof(glHashResp), glHashResp);
+    break;
+
     case BLADE_USB_CMD_READ_CAL_CACHE:
         if(!glCalCacheValid) {
             /* Fail the request if the cache is invalid */
@@ -762,7 +861,10 @@ void CyFxbladeRFApplnUSBEventCB (CyU3PUsbEventType_t evtype, uint16_t evdata)
             switch(glUsbAltInterface) {
                 case USB_IF_CONFIG: NuandFpgaConfig.stop() ; break ;
                 case USB_IF_RF_LINK: NuandRFLink.stop(); break ;
-                case USB_IF_SPI_FLASH: NuandFlashDeinit(); break ;
+                case USB_IF_SPI_FLASH:
+                    NuandFlashBulkStop();
+                    NuandFlashDeinit();
+                    break ;
                 default: break ;
             }
 
@@ -773,6 +875,7 @@ void CyFxbladeRFApplnUSBEventCB (CyU3PUsbEventType_t evtype, uint16_t evdata)
                 NuandRFLink.start();
             } else if (alt_interface == USB_IF_SPI_FLASH) {
                 NuandFlashInit();
+                NuandFlashBulkStart();
             }
             glUsbAltInterface = alt_interface;
         break;
@@ -864,6 +967,11 @@ void bladeRFInit(void)
         usb_product_descr = CyFxUSBProductDscr_bladeRF2;
     }
 
+    if (!NuandRFLinkStatsInit()) {
+        LOG_ERROR(CY_U3P_ERROR_FAILURE);
+        CyFxAppErrorHandler(CY_U3P_ERROR_FAILURE);
+    }
+
     /* Start the USB functionality. */
     apiRetStatus = CyU3PUsbStart();
     if (apiRetStatus != CY_U3P_SUCCESS) {
@@ -1019,8 +1127,10 @@ void bladeRFAppThread_Entry( uint32_t input)
     glDeviceReady = CyTrue;
 
     while ( 1 ) {
-        /* Additional application-specific code can go here */
-        CyU3PThreadSleep(1000);
+        /* The sample channels' byte counts wrap after 4 GiB, which takes
+         * about 10 seconds at full rate */
+        NuandRFLinkPollStats();
+        CyU3PThreadSleep(100);
     }
 }
 
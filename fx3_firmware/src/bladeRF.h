@@ -55,7 +55,10 @@
 #define BLADE_UART_EP_CONSUMER_USB_SOCKET CY_U3P_UIB_SOCKET_CONS_2
 
 // interface #2
-// doesn't actually use BULK, EP exists for debugging purposes
+#define BLADE_FLASH_EP_PRODUCER         0x02
+#define BLADE_FLASH_EP_PRODUCER_USB_SOCKET CY_U3P_UIB_SOCKET_PROD_2
+#define BLADE_FLASH_EP_CONSUMER         0x82
+#define BLADE_FLASH_EP_CONSUMER_USB_SOCKET CY_U3P_UIB_SOCKET_CONS_2
 
 /* Extern definitions for the USB Descriptors */
 extern const uint8_t CyFxUSBDeviceQualDscr[];
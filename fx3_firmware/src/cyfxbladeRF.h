@@ -41,6 +41,8 @@
 #define CY_FX_EP_PRODUCER               0x01    /* EP 1 OUT */
 #define BLADE_FPGA_EP_PRODUCER          0x02    /* EP 2 OUT */
 #define CY_FX_EP_CONSUMER               0x81    /* EP 1 IN */
+#define BLADE_FLASH_EP_PRODUCER         0x02    /* EP 2 OUT */
+#define BLADE_FLASH_EP_CONSUMER         0x82    /* EP 2 IN */
 
 #define CY_FX_PRODUCER_USB_SOCKET    CY_U3P_UIB_SOCKET_PROD_1    /* USB Socket 1 is producer */
 #define BLADE_FPGA_CONFIG_SOCKET     CY_U3P_UIB_SOCKET_PROD_2    /* USB Socket 2 is producer */
@@ -72,7 +72,7 @@ const uint8_t CyFxUSBSSConfigDscr[] __attribute__ ((aligned (32))) __attribute__
     /* Configuration descriptor */
     0x09,                           /* Descriptor size */
     CY_U3P_USB_CONFIG_DESCR,        /* Configuration descriptor type */
-    0x7B,0x00,                      /* Length of this descriptor and all sub descriptors */
+    0x88,0x00,                      /* Length of this descriptor and all sub descriptors */
     0x01,                           /* Number of interfaces */
     0x01,                           /* Configuration number */
     0x00,                           /* COnfiguration string index */
@@ -169,7 +169,7 @@ const uint8_t CyFxUSBSSConfigDscr[] __attribute__ ((aligned (32))) __attribute__
     CY_U3P_USB_INTRFC_DESCR,        /* Interface Descriptor type */
     0x00,                           /* Interface number */
     0x02,                           /* Alternate setting number */
-    0x01,                           /* Number of end points */
+    0x02,                           /* Number of end points */
     0xFF,                           /* Interface class */
     0x00,                           /* Interface sub class */
     0x00,                           /* Interface protocol code */
@@ -178,7 +178,7 @@ const uint8_t CyFxUSBSSConfigDscr[] __attribute__ ((aligned (32))) __attribute__
     /* Endpoint descriptor for producer EP */
     0x07,                           /* Descriptor size */
     CY_U3P_USB_ENDPNT_DESCR,        /* Endpoint descriptor type */
-    BLADE_FPGA_EP_PRODUCER,         /* Endpoint address and description */
+    BLADE_FLASH_EP_PRODUCER,        /* Endpoint address and description */
     CY_U3P_USB_EP_BULK,             /* Bulk endpoint type */
     0x00,0x04,                      /* Max packet size = 1024 bytes */
     0x00,                           /* Servicing interval for data transfers : 0 for bulk */
@@ -186,7 +186,22 @@ const uint8_t CyFxUSBSSConfigDscr[] __attribute__ ((aligned (32))) __attribute__
     /* Super speed endpoint companion descriptor for producer EP */
     0x06,                           /* Descriptor size */
     CY_U3P_SS_EP_COMPN_DESCR,       /* SS endpoint companion descriptor type */
-    0x01,                           /* Max no. of packets in a burst : 0: burst 1 packet at a time */
+    0x00,                           /* Max no. of packets in a burst : 0: burst 1 packet at a time */
+    0x00,                           /* Max streams for bulk EP = 0 (No streams) */
+    0x00,0x00,                      /* Service interval for the EP : 0 for bulk */
+
+    /* Endpoint descriptor for consumer EP */
+    0x07,                           /* Descriptor size */
+    CY_U3P_USB_ENDPNT_DESCR,        /* Endpoint descriptor type */
+    BLADE_FLASH_EP_CONSUMER,        /* Endpoint address and description */
+    CY_U3P_USB_EP_BULK,             /* Bulk endpoint type */
+    0x00,0x04,                      /* Max packet size = 1024 bytes */
+    0x00,                           /* Servicing interval for data transfers : 0 for bulk */
+
+    /* Super speed endpoint companion descriptor for consumer EP */
+    0x06,                           /* Descriptor size */
+    CY_U3P_SS_EP_COMPN_DESCR,       /* SS endpoint companion descriptor type */
+    0x00,                           /* Max no. of packets in a burst : 0: burst 1 packet at a time */
     0x00,                           /* Max streams for bulk EP = 0 (No streams) */
     0x00,0x00,                      /* Service interval for the EP : 0 for bulk */
 
@@ -224,7 +239,7 @@ const uint8_t CyFxUSBHSConfigDscr[] __attribute__ ((aligned (32))) __attribute__
     /* Configuration descriptor */
     0x09,                           /* Descriptor size */
     CY_U3P_USB_CONFIG_DESCR,        /* Configuration descriptor type */
-    0x57,0x00,                      /* Length of this descriptor and all sub descriptors */
+    0x5E,0x00,                      /* Length of this descriptor and all sub descriptors */
     0x01,                           /* Number of interfaces */
     0x01,                           /* Configuration number */
     0x00,                           /* COnfiguration string index */
@@ -290,7 +305,7 @@ const uint8_t CyFxUSBHSConfigDscr[] __attribute__ ((aligned (32))) __attribute__
     CY_U3P_USB_INTRFC_DESCR,        /* Interface Descriptor type */
     0x00,                           /* Interface number */
     0x02,                           /* Alternate setting number */
-    0x01,                           /* Number of endpoints */
+    0x02,                           /* Number of endpoints */
     0xFF,                           /* Interface class */
     0x00,                           /* Interface sub class */
     0x00,                           /* Interface protocol code */
@@ -299,7 +314,15 @@ const uint8_t CyFxUSBHSConfigDscr[] __attribute__ ((aligned (32))) __attribute__
     /* Endpoint descriptor for producer EP */
     0x07,                           /* Descriptor size */
     CY_U3P_USB_ENDPNT_DESCR,        /* Endpoint descriptor type */
-    0x01,                           /* Endpoint address and description */
+    BLADE_FLASH_EP_PRODUCER,        /* Endpoint address and description */
+    CY_U3P_USB_EP_BULK,             /* Bulk endpoint type */
+    0x00,0x02,                      /* Max packet size = 512 bytes */
+    0x00,                           /* Servicing interval for data transfers : 0 for bulk */
+
+    /* Endpoint descriptor for consumer EP */
+    0x07,                           /* Descriptor size */
+    CY_U3P_USB_ENDPNT_DESCR,        /* Endpoint descriptor type */
+    BLADE_FLASH_EP_CONSUMER,        /* Endpoint address and description */
     CY_U3P_USB_EP_BULK,             /* Bulk endpoint type */
     0x00,0x02,                      /* Max packet size = 512 bytes */
     0x00,                           /* Servicing interval for data transfers : 0 for bulk */
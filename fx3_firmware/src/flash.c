@@ -21,11 +21,13 @@
  */
 #include <string.h>
 #include "cyu3spi.h"
+#include "cyu3usb.h"
 #include "cyu3error.h"
 #include "bladeRF.h"
 #include "spi_flash_lib.h"
 #include "flash.h"
 #include "misc.h"
+#include "../../host/common/include/sha256.h"
 
 #define THIS_FILE LOGGER_ID_FLASH_C
 
@@ -229,6 +231,229 @@ void NuandFlashDeinit() {
     CyFxSpiDeInit();
 }
 
+/* Timeout for a DMA buffer to be filled or released by the host */
+#define FLASH_BULK_TIMEOUT_MS 1000
+
+static CyU3PDmaChannel glChHandleFlashUtoCpu;
+static CyU3PDmaChannel glChHandleFlashCpuToU;
+static uint16_t glFlashBulkSize = 0;
+static CyU3PReturnStatus_t glFlashBulkStatus = CY_U3P_SUCCESS;
+
+static CyU3PReturnStatus_t FlashBulkEpConfig(uint8_t ep, CyBool_t enable)
+{
+    CyU3PEpConfig_t epCfg;
+
+    CyU3PMemSet((uint8_t *)&epCfg, 0, sizeof (epCfg));
+    epCfg.enable = enable;
+    epCfg.epType = CY_U3P_USB_EP_BULK;
+    epCfg.burstLen = 1;
+    epCfg.streams = 0;
+    epCfg.pcktSize = glFlashBulkSize;
+
+    return CyU3PSetEpConfig(ep, &epCfg);
+}
+
+CyU3PReturnStatus_t NuandFlashBulkStart() {
+    CyU3PDmaChannelConfig_t dmaCfg;
+    CyU3PReturnStatus_t status;
+
+    /* Each DMA buffer holds a single packet, so that every buffer the host
+     * sends is delivered as soon as it arrives */
+    switch (CyU3PUsbGetSpeed()) {
+        case CY_U3P_HIGH_SPEED:
+            glFlashBulkSize = 512;
+            break;
+
+        case CY_U3P_SUPER_SPEED:
+            glFlashBulkSize = 1024;
+            break;
+
+        default:
+            /* Multi-page transfers are not available */
+            glFlashBulkSize = 0;
+            return CY_U3P_SUCCESS;
+    }
+
+    status = FlashBulkEpConfig(BLADE_FLASH_EP_PRODUCER, CyTrue);
+    if (status == CY_U3P_SUCCESS) {
+        status = FlashBulkEpConfig(BLADE_FLASH_EP_CONSUMER, CyTrue);
+    }
+
+    if (status != CY_U3P_SUCCESS) {
+        LOG_ERROR(status);
+        glFlashBulkSize = 0;
+        return status;
+    }
+
+    CyU3PMemSet((uint8_t *)&dmaCfg, 0, sizeof (dmaCfg));
+    dmaCfg.size  = glFlashBulkSize;
+    dmaCfg.count = BLADE_DMA_BUF_COUNT;
+    dmaCfg.dmaMode = CY_U3P_DMA_MODE_BYTE;
+
+    dmaCfg.prodSckId = BLADE_FLASH_EP_PRODUCER_USB_SOCKET;
+    dmaCfg.consSckId = CY_U3P_CPU_SOCKET_CONS;
+    status = CyU3PDmaChannelCreate(&glChHandleFlashUtoCpu,
+                                   CY_U3P_DMA_TYPE_MANUAL_IN, &dmaCfg);
+    if (status != CY_U3P_SUCCESS) {
+        LOG_ERROR(status);
+        glFlashBulkSize = 0;
+        return status;
+    }
+
+    dmaCfg.prodSckId = CY_U3P_CPU_SOCKET_PROD;
+    dmaCfg.consSckId = BLADE_FLASH_EP_CONSUMER_USB_SOCKET;
+    status = CyU3PDmaChannelCreate(&glChHandleFlashCpuToU,
+                                   CY_U3P_DMA_TYPE_MANUAL_OUT, &dmaCfg);
+    if (status != CY_U3P_SUCCESS) {
+        LOG_ERROR(status);
+        CyU3PDmaChannelDestroy(&glChHandleFlashUtoCpu);
+        glFlashBulkSize = 0;
+        return status;
+    }
+
+    CyU3PUsbFlushEp(BLADE_FLASH_EP_PRODUCER);
+    CyU3PUsbFlushEp(BLADE_FLASH_EP_CONSUMER);
+
+    return CY_U3P_SUCCESS;
+}
+
+void NuandFlashBulkStop() {
+    if (glFlashBulkSize == 0) {
+        return;
+    }
+
+    CyU3PDmaChannelDestroy(&glChHandleFlashUtoCpu);
+    CyU3PDmaChannelDestroy(&glChHandleFlashCpuToU);
+
+    CyU3PUsbFlushEp(BLADE_FLASH_EP_PRODUCER);
+    CyU3PUsbFlushEp(BLADE_FLASH_EP_CONSUMER);
+
+    FlashBulkEpConfig(BLADE_FLASH_EP_PRODUCER, CyFalse);
+    FlashBulkEpConfig(BLADE_FLASH_EP_CONSUMER, CyFalse);
+
+    glFlashBulkSize = 0;
+}
+
+CyU3PReturnStatus_t NuandFlashBulkPrepare(CyBool_t isRead) {
+    CyU3PReturnStatus_t status = CY_U3P_ERROR_NOT_STARTED;
+
+    if (glFlashBulkSize == 0) {
+        return status;
+    }
+
+    /* Discard anything left behind by an earlier, failed transfer */
+    if (isRead) {
+        status = ClearDMAChannel(BLADE_FLASH_EP_CONSUMER,
+                                 &glChHandleFlashCpuToU, 0);
+    } else {
+        status = ClearDMAChannel(BLADE_FLASH_EP_PRODUCER,
+                                 &glChHandleFlashUtoCpu, 0);
+    }
+
+    glFlashBulkStatus = status;
+    return status;
+}
+
+void NuandFlashBulkReadPages(uint16_t page, uint16_t count) {
+    const uint16_t buf_pages = glFlashBulkSize / FLASH_PAGE_SIZE;
+    CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+    CyU3PDmaBuffer_t buf;
+    uint16_t n;
+
+    while (count > 0 && status == CY_U3P_SUCCESS) {
+        n = count < buf_pages ? count : buf_pages;
+
+        status = CyU3PDmaChannelGetBuffer(&glChHandleFlashCpuToU, &buf,
+                                          FLASH_BULK_TIMEOUT_MS);
+        if (status != CY_U3P_SUCCESS) {
+            break;
+        }
+
+        status = CyFxSpiTransfer(page, n * FLASH_PAGE_SIZE, buf.buffer,
+                                 CyTrue, CyFalse);
+        if (status != CY_U3P_SUCCESS) {
+            break;
+        }
+
+        status = CyU3PDmaChannelCommitBuffer(&glChHandleFlashCpuToU,
+                                             n * FLASH_PAGE_SIZE, 0);
+        page += n;
+        count -= n;
+    }
+
+    if (status != CY_U3P_SUCCESS) {
+        LOG_ERROR(status);
+    }
+
+    glFlashBulkStatus = status;
+}
+
+void NuandFlashBulkWritePages(uint16_t page, uint16_t count) {
+    CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+    CyU3PDmaBuffer_t buf;
+    uint16_t n;
+
+    while (count > 0 && status == CY_U3P_SUCCESS) {
+        status = CyU3PDmaChannelGetBuffer(&glChHandleFlashUtoCpu, &buf,
+                                          FLASH_BULK_TIMEOUT_MS);
+        if (status != CY_U3P_SUCCESS) {
+            break;
+        }
+
+        n = buf.count / FLASH_PAGE_SIZE;
+        if ((buf.count % FLASH_PAGE_SIZE) != 0 || n == 0 || n > count) {
+            status = CY_U3P_ERROR_BAD_ARGUMENT;
+        } else {
+            status = CyFxSpiTransfer(page, buf.count, buf.buffer,
+                                     CyFalse, CyFalse);
+        }
+
+        CyU3PDmaChannelDiscardBuffer(&glChHandleFlashUtoCpu);
+        page += n;
+        count -= n;
+    }
+
+    if (status != CY_U3P_SUCCESS) {
+        LOG_ERROR(status);
+    }
+
+    glFlashBulkStatus = status;
+}
+
+CyU3PReturnStatus_t NuandFlashBulkStatus() {
+    return glFlashBulkStatus;
+}
+
+static uint8_t glHashPage[FLASH_PAGE_SIZE] __attribute__ ((aligned (32)));
+
+CyU3PReturnStatus_t NuandFlashHash(uint16_t page, uint16_t count,
+                                   uint8_t *digest) {
+    CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+    SHA256_CTX ctx;
+
+    if (count == 0 || count > BLADE_FLASH_HASH_MAX_PAGES) {
+        return CY_U3P_ERROR_BAD_ARGUMENT;
+    }
+
+    SHA256_Init(&ctx);
+
+    while (count > 0) {
+        status = CyFxSpiTransfer(page, FLASH_PAGE_SIZE, glHashPage,
+                                 CyTrue, CyFalse);
+        if (status != CY_U3P_SUCCESS) {
+            LOG_ERROR(status);
+            return status;
+        }
+
+        SHA256_Update(&ctx, glHashPage, FLASH_PAGE_SIZE);
+        page++;
+        count--;
+    }
+
+    SHA256_Final(digest, &ctx);
+    return status;
+}
+
 static inline size_t min_sz(size_t x, size_t y)
 {
     return x < y ? x : y;
@@ -36,6 +36,19 @@ void cacheSPIManufacturer();
 CyU3PReturnStatus_t NuandFlashInit();
 void NuandFlashDeinit();
 
+/* Multi-page transfers over the USB_IF_SPI_FLASH bulk endpoints. These are
+ * only available at high and super speed. */
+CyU3PReturnStatus_t NuandFlashBulkStart();
+void NuandFlashBulkStop();
+CyU3PReturnStatus_t NuandFlashBulkPrepare(CyBool_t isRead);
+void NuandFlashBulkReadPages(uint16_t page, uint16_t count);
+void NuandFlashBulkWritePages(uint16_t page, uint16_t count);
+CyU3PReturnStatus_t NuandFlashBulkStatus();
+
+/* Compute the SHA-256 digest of up to BLADE_FLASH_HASH_MAX_PAGES pages */
+CyU3PReturnStatus_t NuandFlashHash(uint16_t page, uint16_t count,
+                                   uint8_t *digest);
+
 int NuandExtractField(char *ptr, int len, char *field,
                             char *val, size_t  maxlen);
 
@@ -39,6 +39,24 @@ static uint32_t glDMARxCount = 0;
 
 static uint16_t glFlipLut[256];
 
+/* Each DMA buffer is large enough to hold the bit-flipped output of a packet
+ * of compressed blocks, which the USB side fills only the start of */
+#define FPGA_DMA_BUF_FACTOR \
+    (2 * BLADE_FPGA_CBLOCK_MAX_RAW / BLADE_FPGA_CBLOCK_SIZE)
+
+/* Largest packet size, for which compressed data is staged */
+#define FPGA_MAX_PACKET_SIZE 1024
+
+/* Packet size of the current configuration, and whether the host is sending
+ * a compressed bitstream */
+static uint16_t glFpgaPacketSize = 0;
+static CyBool_t glFpgaCompressed = CyFalse;
+static uint8_t glFpgaCompressedBuf[FPGA_MAX_PACKET_SIZE];
+
+/* Digest of the bitstream last loaded by the host, if it has provided one */
+static uint8_t glFpgaImageHash[BLADE_FPGA_HASH_SIZE];
+static CyBool_t glFpgaImageHashValid = CyFalse;
+
 /* Tracks the last FPGA programmer (SPI flash or USB host) */
 static NuandFpgaConfigSource glFpgaConfigSrc = NUAND_FPGA_CONFIG_SOURCE_INVALID;
 
@@ -48,6 +66,10 @@ int FpgaBeginProgram(void)
 
     unsigned tEnd;
     CyU3PReturnStatus_t apiRetStatus;
+
+    /* Whatever digest was recorded no longer describes the FPGA's contents */
+    glFpgaImageHashValid = CyFalse;
+
     apiRetStatus = CyU3PGpioSetValue(GPIO_nCONFIG, CyFalse);
     if (apiRetStatus != CY_U3P_SUCCESS) {
         return apiRetStatus;
@@ -67,16 +89,139 @@ int FpgaBeginProgram(void)
     return 0;
 }
 
+int FpgaWaitConfigured(uint16_t timeout_ms)
+{
+    CyBool_t value;
+    unsigned tEnd;
+    CyU3PReturnStatus_t apiRetStatus;
+
+    tEnd = CyU3PGetTime() + timeout_ms;
+    for (;;) {
+        apiRetStatus = CyU3PGpioGetValue(GPIO_CONFDONE, &value);
+        if (apiRetStatus != CY_U3P_SUCCESS) {
+            return -1;
+        } else if (value) {
+            return 1;
+        } else if (CyU3PGetTime() >= tEnd) {
+            return 0;
+        }
+
+        CyU3PThreadSleep(1);
+    }
+}
+
 void NuandFpgaConfigSwInit(void) {
     NuandFpgaConfigSwFlipLut(glFlipLut);
 }
 
+/* Decode the compressed blocks in a DMA buffer, flipping the bits of the
+ * output in the same manner as an uncompressed bitstream. Returns the number
+ * of bytes of output, or 0 if the data is malformed. */
+static uint32_t FpgaDecodeCompressed(uint8_t *buf, uint16_t count)
+{
+    uint16_t *out = (uint16_t *)buf;
+    uint16_t off, blk_len, tok_len, n;
+    uint32_t raw;
+    uint16_t value;
+    uint8_t *p, *end;
+    uint8_t tok;
+
+    if (count > sizeof(glFpgaCompressedBuf)) {
+        return 0;
+    }
+
+    /* The output overwrites the input, so work from a copy of it */
+    CyU3PMemCopy(glFpgaCompressedBuf, buf, count);
+
+    for (off = 0; off < count; off += BLADE_FPGA_CBLOCK_SIZE) {
+        p = &glFpgaCompressedBuf[off];
+        blk_len = count - off;
+        if (blk_len > BLADE_FPGA_CBLOCK_SIZE) {
+            blk_len = BLADE_FPGA_CBLOCK_SIZE;
+        }
+
+        if (blk_len < 2) {
+            return 0;
+        }
+
+        tok_len = p[0] | (p[1] << 8);
+        if (tok_len > blk_len - 2) {
+            return 0;
+        }
+
+        p += 2;
+        end = p + tok_len;
+        raw = 0;
+
+        while (p < end) {
+            tok = *p++;
+
+            if (tok < 0x80) {
+                n = tok + 1;
+                if ((end - p) < n || (raw + n) > BLADE_FPGA_CBLOCK_MAX_RAW) {
+                    return 0;
+                }
+
+                raw += n;
+                while (n--) {
+                    *out++ = glFlipLut[*p++];
+                }
+            } else {
+                if ((end - p) < 2) {
+                    return 0;
+                }
+
+                n = (((tok & 0x7f) << 8) | *p++) + 1;
+                if ((raw + n) > BLADE_FPGA_CBLOCK_MAX_RAW) {
+                    return 0;
+                }
+
+                raw += n;
+                value = glFlipLut[*p++];
+                while (n--) {
+                    *out++ = value;
+                }
+            }
+        }
+    }
+
+    return (uint32_t)((uint8_t *)out - buf);
+}
+
+int NuandFpgaConfigSetCompressed(CyBool_t compressed)
+{
+    /* Compressed blocks may not straddle packets */
+    if (compressed && (glFpgaPacketSize < BLADE_FPGA_CBLOCK_SIZE ||
+                       glFpgaPacketSize > FPGA_MAX_PACKET_SIZE)) {
+        return -1;
+    }
+
+    glFpgaCompressed = compressed;
+    return 0;
+}
+
 /* DMA callback function to handle the produce events for U to P transfers. */
 static void bladeRFConfigUtoPDmaCallback(CyU3PDmaChannel *chHandle, CyU3PDmaCbType_t type, CyU3PDmaCBInput_t *input)
 {
     CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
 
-    if (type == CY_U3P_DMA_CB_PROD_EVENT) {
+    if (type == CY_U3P_DMA_CB_PROD_EVENT && glFpgaCompressed) {
+        uint32_t len = FpgaDecodeCompressed(input->buffer_p.buffer,
+                                            input->buffer_p.count);
+
+        if (len == 0) {
+            LOG_ERROR(CY_U3P_ERROR_BAD_ARGUMENT);
+            status = CyU3PDmaChannelDiscardBuffer(chHandle);
+        } else {
+            status = CyU3PDmaChannelCommitBuffer(chHandle, len, 0);
+        }
+
+        if (status != CY_U3P_SUCCESS) {
+            LOG_ERROR(status);
+        }
+
+        glDMARxCount++;
+    } else if (type == CY_U3P_DMA_CB_PROD_EVENT) {
         int i;
 
         uint8_t *end_in_b = &( ((uint8_t *)input->buffer_p.buffer)[input->buffer_p.count - 1]);
@@ -162,7 +307,10 @@ static void NuandFpgaConfigStart(void)
         }
     }
 
-    dmaCfg.size  = size * 4;
+    glFpgaPacketSize = doUsb ? size : 0;
+    glFpgaCompressed = CyFalse;
+
+    dmaCfg.size  = size * FPGA_DMA_BUF_FACTOR;
     dmaCfg.count = BLADE_DMA_BUF_COUNT;
     dmaCfg.prodSckId = BLADE_FPGA_CONFIG_SOCKET;
     dmaCfg.consSckId = CY_U3P_PIB_SOCKET_3;
@@ -173,7 +321,7 @@ static void NuandFpgaConfigStart(void)
 
     dmaCfg.cb = bladeRFConfigUtoPDmaCallback;
     dmaCfg.prodHeader = 0;
-    dmaCfg.prodFooter = size * 3;
+    dmaCfg.prodFooter = size * (FPGA_DMA_BUF_FACTOR - 1);
     dmaCfg.consHeader = 0;
     dmaCfg.prodAvailCount = 0;
 
@@ -397,6 +545,21 @@ void NuandSetFpgaConfigSource(NuandFpgaConfigSource src)
     glFpgaConfigSrc = src;
 }
 
+void NuandSetFpgaImageHash(const uint8_t *hash)
+{
+    CyU3PMemCopy(glFpgaImageHash, (uint8_t *)hash, sizeof(glFpgaImageHash));
+    glFpgaImageHashValid = CyTrue;
+}
+
+CyBool_t NuandGetFpgaImageHash(uint8_t *hash)
+{
+    if (glFpgaImageHashValid) {
+        CyU3PMemCopy(hash, glFpgaImageHash, sizeof(glFpgaImageHash));
+    }
+
+    return glFpgaImageHashValid;
+}
+
 const struct NuandApplication NuandFpgaConfig = {
     .start = NuandFpgaConfigStart,
     .stop = NuandFpgaConfigStop,
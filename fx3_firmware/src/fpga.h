@@ -27,8 +27,12 @@
 void NuandFpgaConfigSwInit(void);
 extern const struct NuandApplication NuandFpgaConfig;
 int FpgaBeginProgram(void);
+int FpgaWaitConfigured(uint16_t timeout_ms);
+int NuandFpgaConfigSetCompressed(CyBool_t compressed);
 CyBool_t NuandLoadFromFlash(int fpga_len);
 NuandFpgaConfigSource NuandGetFpgaConfigSource(void);
 void NuandSetFpgaConfigSource(NuandFpgaConfigSource src);
+void NuandSetFpgaImageHash(const uint8_t *hash);
+CyBool_t NuandGetFpgaImageHash(uint8_t *hash);
 
 #endif /* _FPGA_H_ */
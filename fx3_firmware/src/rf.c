@@ -21,6 +21,8 @@
  */
 #include <cyu3error.h>
 #include <cyu3gpio.h>
+#include <cyu3os.h>
+#include <cyu3pib.h>
 #include <cyu3usb.h>
 #include <cyu3uart.h>
 #include "gpif.h"
@@ -37,6 +39,172 @@ static CyU3PDmaChannel glChHandlePtoU;
 static int loopback = 0;
 static int loopback_when_created;
 
+static uint16_t dma_count = BLADE_SAMPLE_DMA_DEFAULT_COUNT;
+static uint16_t dma_packets = BLADE_SAMPLE_DMA_DEFAULT_PACKETS;
+
+/* Sample path counters. The sample channels' byte counts wrap after 4 GiB
+ * and are cleared when an endpoint is reset, so they are sampled
+ * periodically and whenever they are about to be cleared. */
+static struct {
+    CyU3PMutex lock;
+    CyBool_t active;            /* The sample channels exist */
+    uint32_t buf_size;          /* Bytes per sample DMA buffer */
+    uint32_t tx_last, rx_last;  /* Last sampled channel byte counts */
+    uint64_t tx_bytes, rx_bytes;/* Bytes since the channels were created */
+    uint32_t counters[BLADE_FW_STATS_NUM];
+} stats;
+
+static void StatsSample(void)
+{
+    CyU3PDmaState_t state;
+    uint32_t prod, cons;
+    uint16_t phy_errors, link_errors;
+
+    if (!stats.active) {
+        return;
+    }
+
+    if (CyU3PDmaChannelGetStatus(&glChHandleUtoP, &state, &prod, &cons) ==
+            CY_U3P_SUCCESS) {
+        if (loopback_when_created) {
+            stats.tx_bytes += (uint32_t)(prod - stats.tx_last);
+            stats.tx_last   = prod;
+            stats.rx_bytes += (uint32_t)(cons - stats.rx_last);
+            stats.rx_last   = cons;
+        } else {
+            stats.tx_bytes += (uint32_t)(cons - stats.tx_last);
+            stats.tx_last   = cons;
+        }
+    }
+
+    if (!loopback_when_created &&
+        CyU3PDmaChannelGetStatus(&glChHandlePtoU, &state, &prod, &cons) ==
+            CY_U3P_SUCCESS) {
+        stats.rx_bytes += (uint32_t)(prod - stats.rx_last);
+        stats.rx_last   = prod;
+    }
+
+    /* Only available at SuperSpeed. The counts are cleared when read. */
+    if (CyU3PUsbGetErrorCounts(&phy_errors, &link_errors) == CY_U3P_SUCCESS) {
+        stats.counters[BLADE_FW_STATS_IDX_USB_PHY_ERRORS]  += phy_errors;
+        stats.counters[BLADE_FW_STATS_IDX_USB_LINK_ERRORS] += link_errors;
+    }
+}
+
+static void StatsPibCallback(CyU3PPibIntrType cbType, uint16_t cbArg)
+{
+    if (cbType != CYU3P_PIB_INTR_ERROR) {
+        return;
+    }
+
+    switch (CYU3P_GET_PIB_ERROR_TYPE(cbArg)) {
+        case CYU3P_PIB_ERR_THR0_WR_OVERRUN:
+        case CYU3P_PIB_ERR_THR1_WR_OVERRUN:
+        case CYU3P_PIB_ERR_THR2_WR_OVERRUN:
+        case CYU3P_PIB_ERR_THR3_WR_OVERRUN:
+            stats.counters[BLADE_FW_STATS_IDX_RX_OVERRUNS]++;
+            break;
+
+        case CYU3P_PIB_ERR_THR0_RD_UNDERRUN:
+        case CYU3P_PIB_ERR_THR1_RD_UNDERRUN:
+        case CYU3P_PIB_ERR_THR2_RD_UNDERRUN:
+        case CYU3P_PIB_ERR_THR3_RD_UNDERRUN:
+            stats.counters[BLADE_FW_STATS_IDX_TX_UNDERRUNS]++;
+            break;
+
+        default:
+            stats.counters[BLADE_FW_STATS_IDX_PIB_ERRORS]++;
+            break;
+    }
+}
+
+static void StatsEpCallback(CyU3PUsbEpEvtType evType,
+                            CyU3PUSBSpeed_t usbSpeed, uint8_t epNum)
+{
+    if (evType == CYU3P_USBEP_SS_RETRY_EVT) {
+        stats.counters[BLADE_FW_STATS_IDX_USB_RETRIES]++;
+    }
+}
+
+/* Begin counting once the sample channels have been created */
+static void StatsStart(uint32_t buf_size)
+{
+    const uint32_t ep_mask = 1 << (BLADE_RF_SAMPLE_EP_PRODUCER & 0x0f);
+
+    CyU3PMutexGet(&stats.lock, CYU3P_WAIT_FOREVER);
+    stats.buf_size = buf_size;
+    stats.tx_last  = 0;
+    stats.rx_last  = 0;
+    stats.tx_bytes = 0;
+    stats.rx_bytes = 0;
+    stats.active   = CyTrue;
+    CyU3PMutexPut(&stats.lock);
+
+    /* The PIB is re-initialized along with the GPIF, so this is registered
+     * each time the RF link is started */
+    CyU3PPibRegisterCallback(StatsPibCallback, CYU3P_PIB_INTR_ERROR);
+    CyU3PUsbRegisterEpEvtCallback(StatsEpCallback, CYU3P_USBEP_SS_RETRY_EVT,
+                                  ep_mask, ep_mask);
+}
+
+/* Fold the channels' counts into the totals before they are destroyed */
+static void StatsStop(void)
+{
+    CyU3PMutexGet(&stats.lock, CYU3P_WAIT_FOREVER);
+    StatsSample();
+
+    if (stats.active && stats.buf_size != 0) {
+        stats.counters[BLADE_FW_STATS_IDX_TX_BUFFERS] +=
+            stats.tx_bytes / stats.buf_size;
+        stats.counters[BLADE_FW_STATS_IDX_RX_BUFFERS] +=
+            stats.rx_bytes / stats.buf_size;
+    }
+
+    stats.active = CyFalse;
+    CyU3PMutexPut(&stats.lock);
+
+    CyU3PUsbRegisterEpEvtCallback(NULL, 0, 0, 0);
+}
+
+CyBool_t NuandRFLinkStatsInit(void)
+{
+    CyU3PMemSet((uint8_t *)&stats, 0, sizeof(stats));
+    return CyU3PMutexCreate(&stats.lock, CYU3P_INHERIT) == CY_U3P_SUCCESS;
+}
+
+void NuandRFLinkPollStats(void)
+{
+    CyU3PMutexGet(&stats.lock, CYU3P_WAIT_FOREVER);
+    StatsSample();
+    CyU3PMutexPut(&stats.lock);
+}
+
+void NuandRFLinkGetStats(uint32_t counters[BLADE_FW_STATS_NUM], CyBool_t reset)
+{
+    CyU3PMutexGet(&stats.lock, CYU3P_WAIT_FOREVER);
+    StatsSample();
+
+    CyU3PMemCopy((uint8_t *)counters, (uint8_t *)stats.counters,
+                 sizeof(stats.counters));
+
+    counters[BLADE_FW_STATS_IDX_COUNT] = BLADE_FW_STATS_NUM - 1;
+
+    if (stats.active && stats.buf_size != 0) {
+        counters[BLADE_FW_STATS_IDX_TX_BUFFERS] +=
+            stats.tx_bytes / stats.buf_size;
+        counters[BLADE_FW_STATS_IDX_RX_BUFFERS] +=
+            stats.rx_bytes / stats.buf_size;
+    }
+
+    if (reset) {
+        CyU3PMemSet((uint8_t *)stats.counters, 0, sizeof(stats.counters));
+        stats.tx_bytes = 0;
+        stats.rx_bytes = 0;
+    }
+
+    CyU3PMutexPut(&stats.lock);
+}
+
 void NuandRFLinkLoopBack(int lp) {
     loopback = lp;
 }
@@ -45,6 +213,57 @@ int NuandRFLinkGetLoopBack() {
     return loopback;
 }
 
+/* Maximum packet size of the sample endpoints at the given USB speed */
+static uint16_t SampleEpPacketSize(CyU3PUSBSpeed_t usbSpeed)
+{
+    switch (usbSpeed) {
+        case CY_U3P_FULL_SPEED:
+            return 64;
+
+        case CY_U3P_HIGH_SPEED:
+            return 512;
+
+        case CY_U3P_SUPER_SPEED:
+            return 1024;
+
+        default:
+            return 0;
+    }
+}
+
+static CyBool_t DmaConfigValid(uint16_t count, uint16_t packets,
+                               uint16_t size)
+{
+    if (count < BLADE_SAMPLE_DMA_MIN_COUNT ||
+        count > BLADE_SAMPLE_DMA_MAX_COUNT ||
+        packets < 1 || packets > BLADE_SAMPLE_DMA_MAX_PACKETS) {
+        return CyFalse;
+    }
+
+    return ((uint32_t)count * packets * size <= BLADE_SAMPLE_DMA_MAX_BYTES);
+}
+
+CyBool_t NuandRFLinkSetDmaConfig(uint16_t count, uint16_t packets)
+{
+    if (count == 0) {
+        count   = BLADE_SAMPLE_DMA_DEFAULT_COUNT;
+        packets = BLADE_SAMPLE_DMA_DEFAULT_PACKETS;
+    } else if (!DmaConfigValid(count, packets,
+                               SampleEpPacketSize(CyU3PUsbGetSpeed()))) {
+        return CyFalse;
+    }
+
+    dma_count   = count;
+    dma_packets = packets;
+    return CyTrue;
+}
+
+void NuandRFLinkGetDmaConfig(uint16_t *count, uint16_t *packets)
+{
+    *count   = dma_count;
+    *packets = dma_packets;
+}
+
 static void UartBridgeStart(void)
 {
     uint16_t size = 0;
@@ -248,24 +467,18 @@ static void NuandRFLinkStart(void)
     }
 
     /* Determine max packet size based on USB speed */
-    switch (usbSpeed)
-    {
-        case CY_U3P_FULL_SPEED:
-            size = 64;
-            break;
-
-        case CY_U3P_HIGH_SPEED:
-            size = 512;
-            break;
-
-        case CY_U3P_SUPER_SPEED:
-            size = 1024;
-            break;
+    size = SampleEpPacketSize(usbSpeed);
+    if (size == 0) {
+        LOG_ERROR(usbSpeed);
+        CyFxAppErrorHandler (CY_U3P_ERROR_FAILURE);
+    }
 
-        default:
-            LOG_ERROR(usbSpeed);
-            CyFxAppErrorHandler (CY_U3P_ERROR_FAILURE);
-            break;
+    /* The configuration was validated at the speed in use when it was set,
+     * which may have since changed */
+    if (!DmaConfigValid(dma_count, dma_packets, size)) {
+        LOG_ERROR(dma_count);
+        dma_count   = BLADE_SAMPLE_DMA_DEFAULT_COUNT;
+        dma_packets = BLADE_SAMPLE_DMA_DEFAULT_PACKETS;
     }
 
     CyU3PMemSet ((uint8_t *)&epCfg, 0, sizeof (epCfg));
@@ -290,8 +503,8 @@ static void NuandRFLinkStart(void)
     }
 
     CyU3PMemSet((uint8_t *)&dmaCfg, 0, sizeof(dmaCfg));
-    dmaCfg.size  = size * 2;
-    dmaCfg.count = 22;
+    dmaCfg.size  = size * dma_packets;
+    dmaCfg.count = dma_count;
     dmaCfg.prodSckId = BLADE_RF_SAMPLE_EP_PRODUCER_USB_SOCKET;
     dmaCfg.consSckId = CY_U3P_PIB_SOCKET_3;
     dmaCfg.dmaMode = CY_U3P_DMA_MODE_BYTE;
@@ -346,6 +559,8 @@ static void NuandRFLinkStart(void)
         }
     }
 
+    StatsStart(size * dma_packets);
+
     UartBridgeStart();
     glAppMode = MODE_RF_CONFIG;
 
@@ -367,6 +582,8 @@ static void NuandRFLinkStop (void)
     CyU3PUsbFlushEp(BLADE_RF_SAMPLE_EP_PRODUCER);
     CyU3PUsbFlushEp(BLADE_RF_SAMPLE_EP_CONSUMER);
 
+    StatsStop();
+
     /* Destroy the channels */
     CyU3PDmaChannelDestroy(&glChHandleUtoP);
     if (!loopback_when_created)
@@ -415,14 +632,26 @@ CyU3PReturnStatus_t NuandRFLinkResetEndpoint(uint8_t endpoint)
 
     switch(endpoint) {
         case BLADE_RF_SAMPLE_EP_PRODUCER:
+            /* Clearing the channel also clears its byte counts */
+            CyU3PMutexGet(&stats.lock, CYU3P_WAIT_FOREVER);
+            StatsSample();
             status = ClearDMAChannel(endpoint, &glChHandleUtoP,
                                      BLADE_DMA_TX_SIZE);
+            stats.tx_last = 0;
+            if (loopback_when_created) {
+                stats.rx_last = 0;
+            }
+            CyU3PMutexPut(&stats.lock);
             break;
 
         case BLADE_RF_SAMPLE_EP_CONSUMER:
             if (!loopback_when_created) {
+                CyU3PMutexGet(&stats.lock, CYU3P_WAIT_FOREVER);
+                StatsSample();
                 status = ClearDMAChannel(endpoint, &glChHandlePtoU,
                                          BLADE_DMA_TX_SIZE);
+                stats.rx_last = 0;
+                CyU3PMutexPut(&stats.lock);
             } else {
                 status = CY_U3P_SUCCESS;
             }
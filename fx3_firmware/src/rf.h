@@ -32,4 +32,23 @@ void NuandRFLinkLoopBack(int);
 /* Check if FW sample loopback is enabled */
 int NuandRFLinkGetLoopBack();
 
+/* Set the number and size (in max packet size units) of the sample endpoint
+ * DMA buffers, applied the next time the RF link is started. A count of 0
+ * restores the defaults. Returns CyFalse if the configuration is invalid. */
+CyBool_t NuandRFLinkSetDmaConfig(uint16_t count, uint16_t packets);
+
+/* Get the sample endpoint DMA buffer configuration */
+void NuandRFLinkGetDmaConfig(uint16_t *count, uint16_t *packets);
+
+/* Initialize the sample path counters. Returns CyFalse on failure. */
+CyBool_t NuandRFLinkStatsInit(void);
+
+/* Sample the DMA channels' byte counts, which must be done more often than
+ * they can wrap */
+void NuandRFLinkPollStats(void);
+
+/* Get the sample path counters, as described by BLADE_USB_CMD_GET_FW_STATS,
+ * and optionally reset them */
+void NuandRFLinkGetStats(uint32_t counters[BLADE_FW_STATS_NUM], CyBool_t reset);
+
 #endif /* _RF_H_ */
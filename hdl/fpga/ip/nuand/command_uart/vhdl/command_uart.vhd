@@ -83,6 +83,10 @@ architecture arch of command_uart is
         std_logic_vector(to_unsigned(character'pos('C'),8)),    -- 8x32
         std_logic_vector(to_unsigned(character'pos('D'),8)),    -- 8x64
         std_logic_vector(to_unsigned(character'pos('E'),8)),    -- 16x64
+        std_logic_vector(to_unsigned(character'pos('F'),8)),    -- 8x8 batch
+        std_logic_vector(to_unsigned(character'pos('G'),8)),    -- 8x8 block
+        std_logic_vector(to_unsigned(character'pos('H'),8)),    -- Timestamp latch
+        std_logic_vector(to_unsigned(character'pos('I'),8)),    -- 16x8 batch
         std_logic_vector(to_unsigned(character'pos('K'),8)),    -- 32x32
         std_logic_vector(to_unsigned(character'pos('N'),8)),    -- Legacy
         std_logic_vector(to_unsigned(character'pos('T'),8)),    -- Retune
@@ -0,0 +1,133 @@
+-- Copyright (c) 2026 Nuand LLC
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+
+-- Sample FIFO level monitor
+--
+-- Tracks the fill level and high-water mark of the RX and TX sample FIFOs,
+-- as seen from the FX3 side of each FIFO: the RX FIFO's read side and the TX
+-- FIFO's write side. Levels are in 32-bit words, i.e., SC16 Q11 samples.
+--
+-- `field` selects what is presented on `data`:
+--   "00" - RX high-water mark (31:16) and RX level (15:0)
+--   "01" - TX high-water mark (31:16) and TX level (15:0)
+--   "10" - TX capacity (31:16) and RX capacity (15:0)
+--   "11" - Reserved, reads as 0
+--
+-- The high-water marks are held at the current levels while `clear` is
+-- asserted.
+
+library ieee;
+    use ieee.std_logic_1164.all;
+    use ieee.numeric_std.all;
+
+entity fifo_level_monitor is
+    generic (
+        RX_USED_WIDTH       : natural := 13;
+        TX_USED_WIDTH       : natural := 14
+    );
+    port (
+        clock               : in    std_logic;
+        reset               : in    std_logic;
+
+        -- Control
+        clear               : in    std_logic;
+        field               : in    unsigned(1 downto 0);
+
+        -- FIFO status, in the clock domain
+        rx_used             : in    std_logic_vector(RX_USED_WIDTH-1 downto 0);
+        rx_full             : in    std_logic;
+        tx_used             : in    std_logic_vector(TX_USED_WIDTH-1 downto 0);
+        tx_full             : in    std_logic;
+
+        -- Selected field
+        data                : out   std_logic_vector(31 downto 0)
+    );
+end entity;
+
+architecture arch of fifo_level_monitor is
+
+    constant RX_CAPACITY    : natural := 2**RX_USED_WIDTH;
+    constant TX_CAPACITY    : natural := 2**TX_USED_WIDTH;
+
+    signal rx_level         : unsigned(15 downto 0);
+    signal tx_level         : unsigned(15 downto 0);
+    signal rx_hwm           : unsigned(15 downto 0);
+    signal tx_hwm           : unsigned(15 downto 0);
+
+begin
+
+    -- The used words count wraps to 0 when a FIFO is full
+    level : process(clock, reset)
+    begin
+        if( reset = '1' ) then
+            rx_level <= (others => '0');
+            tx_level <= (others => '0');
+        elsif( rising_edge(clock) ) then
+            if( rx_full = '1' ) then
+                rx_level <= to_unsigned(RX_CAPACITY, rx_level'length);
+            else
+                rx_level <= resize(unsigned(rx_used), rx_level'length);
+            end if;
+
+            if( tx_full = '1' ) then
+                tx_level <= to_unsigned(TX_CAPACITY, tx_level'length);
+            else
+                tx_level <= resize(unsigned(tx_used), tx_level'length);
+            end if;
+        end if;
+    end process;
+
+    high_water : process(clock, reset)
+    begin
+        if( reset = '1' ) then
+            rx_hwm <= (others => '0');
+            tx_hwm <= (others => '0');
+        elsif( rising_edge(clock) ) then
+            if( clear = '1' or rx_level > rx_hwm ) then
+                rx_hwm <= rx_level;
+            end if;
+
+            if( clear = '1' or tx_level > tx_hwm ) then
+                tx_hwm <= tx_level;
+            end if;
+        end if;
+    end process;
+
+    select_field : process(clock, reset)
+    begin
+        if( reset = '1' ) then
+            data <= (others => '0');
+        elsif( rising_edge(clock) ) then
+            case field is
+                when "00" =>
+                    data <= std_logic_vector(rx_hwm & rx_level);
+                when "01" =>
+                    data <= std_logic_vector(tx_hwm & tx_level);
+                when "10" =>
+                    data <= std_logic_vector(
+                                to_unsigned(TX_CAPACITY, 16) &
+                                to_unsigned(RX_CAPACITY, 16));
+                when others =>
+                    data <= (others => '0');
+            end case;
+        end if;
+    end process;
+
+end architecture;
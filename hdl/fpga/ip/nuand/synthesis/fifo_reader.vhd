@@ -41,6 +41,7 @@ entity fifo_reader is
 
         usb_speed           :   in      std_logic;
         meta_en             :   in      std_logic;
+        eight_bit_en        :   in      std_logic := '0';
         packet_en           :   in      std_logic;
         timestamp           :   in      unsigned(63 downto 0);
 
@@ -125,10 +126,10 @@ architecture simple of fifo_reader is
         downcount           : natural range 0 to FIFO_READ_THROTTLE;
         sample_controls_reg : sample_controls_t(in_sample_controls'range);
         enabled_channels    : natural range 0 to in_sample_controls'length;
-        ch_shift            : natural range 0 to out_samples'high;
+        ch_shift            : natural range 0 to 2*out_samples'length-1;
         ch_offsets          : ch_offsets_t(in_sample_controls'range);
-        samples_left_init   : natural range 0 to in_sample_controls'length;
-        samples_left        : natural range 0 to in_sample_controls'length;
+        samples_left_init   : natural range 0 to 2*in_sample_controls'length;
+        samples_left        : natural range 0 to 2*in_sample_controls'length;
         packet_control      : packet_control_t;
         packet_data_cache   : std_logic_vector(31 downto 0);
         fifo_read           : std_logic;
@@ -320,13 +321,18 @@ begin
         --   1. |   Q1  |   I1  |   Q0  |  I0  | Channels 0 & 1 enabled
         --   2. |   Q0' |   I0' |   Q0  |  I0  | Channel 0 only enabled
         --   3. |   Q1' |   I1' |   Q1  |  I1  | Channel 1 only enabled
-        -- This function will return an array of length 2. The 0th
-        -- element containing I0/Q0, and the 1st element I1/Q1. It is up
+        -- This function will return an array of length 4. In 16-bit mode,
+        -- the 0th element contains I0/Q0, and the 1st element I1/Q1. It is up
         -- to the state machine to select between element 0 and 1 based
-        -- on which stream(s) is/are enabled.
+        -- on which stream(s) is/are enabled. In 8-bit mode, each element is
+        -- an 8-bit I/Q pair, and all 4 elements are used:
+        --      | 63:56 | 55:48 | 47:40 | 39:32 | 31:24 | 23:16 | 15:8 | 7:0 |
+        --   1. |  Q1'  |  I1'  |  Q0'  |  I0'  |  Q1   |  I1   |  Q0  | I0  |
+        -- 8-bit values are scaled back up to 12 bits.
         function unpack( c : sample_controls_t;
-                         d : std_logic_vector ) return sample_streams_t is
-            variable rv          : sample_streams_t(c'range);
+                         d : std_logic_vector;
+                         eight_bit : std_logic ) return sample_streams_t is
+            variable rv          : sample_streams_t(0 to 2*c'length-1);
             constant OFFSET_UNIT : natural := rv(rv'low).data_i'length +
                                               rv(rv'low).data_q'length;
             -- The following 4 constants are platform-specific and perhaps
@@ -342,8 +348,13 @@ begin
                 severity failure;
 
             for i in rv'range loop
-                rv(i).data_i := resize(signed(shift_right(unsigned(d),i*OFFSET_UNIT)(I_HIGH downto I_LOW)),rv(i).data_i'length);
-                rv(i).data_q := resize(signed(shift_right(unsigned(d),i*OFFSET_UNIT)(Q_HIGH downto Q_LOW)),rv(i).data_q'length);
+                if( eight_bit = '1' ) then
+                    rv(i).data_i := shift_left(resize(signed(shift_right(unsigned(d),i*OFFSET_UNIT/2)(7 downto 0)),rv(i).data_i'length), 4);
+                    rv(i).data_q := shift_left(resize(signed(shift_right(unsigned(d),i*OFFSET_UNIT/2)(15 downto 8)),rv(i).data_q'length), 4);
+                else
+                    rv(i).data_i := resize(signed(shift_right(unsigned(d),i*OFFSET_UNIT)(I_HIGH downto I_LOW)),rv(i).data_i'length);
+                    rv(i).data_q := resize(signed(shift_right(unsigned(d),i*OFFSET_UNIT)(Q_HIGH downto Q_LOW)),rv(i).data_q'length);
+                end if;
                 rv(i).data_v := '0';
             end loop;
 
@@ -379,7 +390,7 @@ begin
         end function;
 
 
-        variable unpacked         : sample_streams_t(out_samples'range);
+        variable unpacked         : sample_streams_t(0 to 2*out_samples'length-1);
         variable read_req         : std_logic                     := '0';
 
     begin
@@ -391,7 +402,7 @@ begin
 
         fifo_future.packet_control.data_valid <= '0';
         -- MIMO UNPACKER: STEP 1 of 5
-        unpacked := unpack(fifo_current.sample_controls_reg, fifo_data);
+        unpacked := unpack(fifo_current.sample_controls_reg, fifo_data, eight_bit_en);
         for i in fifo_future.out_samples'range loop
             if( fifo_current.sample_controls_reg(i).enable = '1' ) then
                 fifo_future.out_samples(i) <= unpacked(fifo_current.ch_offsets(i) + fifo_current.ch_shift);
@@ -420,8 +431,8 @@ begin
                 --   Compute the number of valid samples that each channel has remaining in fifo_data that
                 --   still need to be processed (not including the first). This becomes the number of clock
                 --   cycles to wait before asserting the FIFO read request to get a new batch of samples.
-                fifo_future.samples_left_init <= NUM_STREAMS - fifo_current.enabled_channels;
-                fifo_future.samples_left      <= NUM_STREAMS - fifo_current.enabled_channels;
+                fifo_future.samples_left_init <= compute_samples_left(fifo_current.sample_controls_reg, eight_bit_en);
+                fifo_future.samples_left      <= compute_samples_left(fifo_current.sample_controls_reg, eight_bit_en);
 
                 if( packet_en = '1' ) then
                     fifo_future.state <= READ_PACKET;
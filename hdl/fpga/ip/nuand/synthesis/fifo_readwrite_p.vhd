@@ -60,6 +60,11 @@ package fifo_readwrite_p is
     -- Count how many channels are enabled
     function count_enabled_channels( x : sample_controls_t ) return natural;
 
+    -- Number of additional sample cycles that fit into one FIFO word once
+    -- the first has been accounted for. In 8-bit mode each I/Q pair only
+    -- occupies half as many bits, so twice as many samples fit in a word.
+    function compute_samples_left( x : sample_controls_t; eight_bit_en : std_logic ) return natural;
+
 end package;
 
 package body fifo_readwrite_p is
@@ -103,4 +108,15 @@ package body fifo_readwrite_p is
         return rv;
     end function;
 
+    function compute_samples_left( x : sample_controls_t; eight_bit_en : std_logic ) return natural is
+        variable enabled : natural := 0;
+    begin
+        enabled := count_enabled_channels(x);
+        if( eight_bit_en = '1' and enabled /= 0 ) then
+            return (2*x'length / enabled) - 1;
+        else
+            return x'length - enabled;
+        end if;
+    end function;
+
 end package body;
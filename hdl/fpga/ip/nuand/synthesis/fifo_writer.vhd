@@ -40,6 +40,7 @@ entity fifo_writer is
 
         usb_speed           :   in      std_logic;
         meta_en             :   in      std_logic;
+        eight_bit_en        :   in      std_logic := '0';
         packet_en           :   in      std_logic;
         timestamp           :   in      unsigned(63 downto 0);
         mini_exp            :   in      std_logic_vector(1 downto 0);
@@ -90,6 +91,7 @@ architecture simple of fifo_writer is
         meta_write      : std_logic;
         meta_data       : std_logic_vector(meta_fifo_data'range);
         meta_written    : std_logic;
+        pkt_timestamp   : unsigned(timestamp'range);
     end record;
 
     constant META_FSM_RESET_VALUE : meta_fsm_t := (
@@ -97,7 +99,8 @@ architecture simple of fifo_writer is
         dma_downcount   => 0,
         meta_write      => '0',
         meta_data       => (others => '-'),
-        meta_written    => '0'
+        meta_written    => '0',
+        pkt_timestamp   => (others => '0')
     );
 
     signal meta_current : meta_fsm_t := META_FSM_RESET_VALUE;
@@ -117,7 +120,7 @@ architecture simple of fifo_writer is
         fifo_clear          : std_logic;
         fifo_write          : std_logic;
         fifo_data           : unsigned(fifo_data'range);
-        samples_left        : natural range 0 to in_sample_controls'length;
+        samples_left        : natural range 0 to 2*in_sample_controls'length;
     end record;
 
     constant FIFO_FSM_RESET_VALUE : fifo_fsm_t := (
@@ -218,7 +221,8 @@ begin
            meta_future.meta_data  <= x"FFF" & "11" & sync_mini_exp & x"FFFF" & std_logic_vector(timestamp) & x"12344321";
         else
            packet_flags := packet_control.pkt_flags;
-           meta_future.meta_data  <= x"FFF" & "11" & sync_mini_exp & x"FFFF" & std_logic_vector(timestamp) &
+           -- Packets are stamped with the time their first DWORD arrived
+           meta_future.meta_data  <= x"FFF" & "11" & sync_mini_exp & x"FFFF" & std_logic_vector(meta_current.pkt_timestamp) &
                           packet_control.pkt_core_id & packet_flags &
                           std_logic_vector(to_unsigned(integer(meta_current.dma_downcount), 16));
         end if;
@@ -235,6 +239,7 @@ begin
 
                        if( packet_control.pkt_sop = '1' ) then
                           meta_future.state  <= PACKET_WAIT_EOP;
+                          meta_future.pkt_timestamp <= timestamp;
 
                           -- meta is not written yet, but there should be space
                           meta_future.meta_written <= '1';
@@ -337,17 +342,27 @@ begin
         --   1. |   Q1  |   I1  |   Q0  |  I0  | Channels 0 & 1 enabled
         --   2. |   Q0' |   I0' |   Q0  |  I0  | Channel 0 only enabled
         --   3. |   Q1' |   I1' |   Q1  |  I1  | Channel 1 only enabled
+        -- In 8-bit mode, only the 8 most significant bits of each 12-bit
+        -- I and Q value are kept, so twice as many samples fit on the bus:
+        --      | 63:56 | 55:48 | 47:40 | 39:32 | 31:24 | 23:16 | 15:8 | 7:0 |
+        --   1. |  Q1'  |  I1'  |  Q0'  |  I0'  |  Q1   |  I1   |  Q0  | I0  |
         function pack( sc : sample_controls_t;
                        ss : sample_streams_t;
-                       d  : unsigned ) return unsigned is
+                       d  : unsigned;
+                       eight_bit : std_logic ) return unsigned is
             constant LEN  : natural           := ss(ss'low).data_i'length + ss(ss'low).data_q'length;
             variable rv   : unsigned(d'range) := (others => '0');
         begin
             rv := d;
             for i in sc'range loop
                 if( (sc(i).enable = '1') and (ss(i).data_v = '1') ) then
-                    rv := unsigned(ss(i).data_q) & unsigned(ss(i).data_i) &
-                          rv(rv'high downto rv'low+LEN);
+                    if( eight_bit = '1' ) then
+                        rv := unsigned(ss(i).data_q(11 downto 4)) & unsigned(ss(i).data_i(11 downto 4)) &
+                              rv(rv'high downto rv'low+LEN/2);
+                    else
+                        rv := unsigned(ss(i).data_q) & unsigned(ss(i).data_i) &
+                              rv(rv'high downto rv'low+LEN);
+                    end if;
                 end if;
             end loop;
             return rv;
@@ -365,7 +380,7 @@ begin
 
         -- MIMO PACKER: STEP 1 of 3
         if( packet_en = '0' ) then
-            fifo_future.fifo_data  <= pack(in_sample_controls, in_samples, fifo_current.fifo_data);
+            fifo_future.fifo_data  <= pack(in_sample_controls, in_samples, fifo_current.fifo_data, eight_bit_en);
         end if;
 
         case fifo_current.state is
@@ -374,7 +389,7 @@ begin
 
                 -- MIMO PACKER: STEP 2 of 3
                 --   Compute "samples left" to fill up the fifo_data bus
-                fifo_future.samples_left      <= NUM_STREAMS - count_enabled_channels(in_sample_controls);
+                fifo_future.samples_left      <= compute_samples_left(in_sample_controls, eight_bit_en);
 
                 if( enable = '1' ) then
                     fifo_future.fifo_clear <= '0';
@@ -446,7 +461,7 @@ begin
                     -- Received valid data
                     if( write_req = '1' ) then
                         if( fifo_current.samples_left = 0 ) then
-                            fifo_future.samples_left <= NUM_STREAMS - count_enabled_channels(in_sample_controls);
+                            fifo_future.samples_left <= compute_samples_left(in_sample_controls, eight_bit_en);
                             fifo_future.fifo_write   <= write_req;
                         else
                             -- MIMO PACKER: STEP 3 of 3
@@ -0,0 +1,315 @@
+-- Copyright (c) 2026 Nuand LLC
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+
+-- RX burst gate
+--
+-- Packetizes received samples only while a signal is present, for use with
+-- the packet metadata format. Bursty signals then cost bus bandwidth only
+-- for as long as they are on the air.
+--
+-- The gate's detector measures the selected channel's power, I^2 + Q^2,
+-- either per sample or, when `averaging` is non-zero, as an exponential
+-- average with a time constant of 2^averaging samples. The gate opens when
+-- the detector reaches `threshold`. It closes once `hangover` consecutive
+-- detector outputs have fallen below the threshold.
+--
+-- The selected channel's samples pass through a history buffer of
+-- `pretrigger` samples on their way to the packetizer, so that each burst
+-- begins with the `pretrigger` samples that preceded the detection. The
+-- gate does not open until the buffer has filled following `enable`.
+-- Closing is delayed to match, so a burst ends `hangover` samples after the
+-- last one at or above the threshold.
+--
+-- While open, samples are emitted one per DWORD (Q in the upper 16 bits, I
+-- in the lower 16 bits), split into packets that each fit in one DMA buffer.
+--
+-- Packets are tagged with core ID 0x01 and the following flags:
+--   Bit 0 - The packet starts a burst
+--   Bit 1 - The packet ends a burst
+--   Bit 2 - Samples were dropped before this packet, because the sample FIFO
+--           did not have room for a packet
+--
+-- out_timestamp is in_timestamp, less the pretrigger length and delayed to
+-- match packet_control, so a FIFO writer latching it at the start of a
+-- packet records the timestamp of the packet's first sample.
+
+library ieee;
+    use ieee.std_logic_1164.all;
+    use ieee.numeric_std.all;
+
+library work;
+    use work.fifo_readwrite_p.all;
+
+entity rx_burst_gate is
+    generic (
+        NUM_STREAMS         : natural := 2;
+        HISTORY_BITS        : natural := 10
+    );
+    port (
+        clock               : in    std_logic;
+        reset               : in    std_logic;
+
+        -- Control
+        enable              : in    std_logic;
+        channel             : in    std_logic;
+        threshold           : in    unsigned(31 downto 0);
+        hangover            : in    unsigned(15 downto 0);
+        pretrigger          : in    unsigned(HISTORY_BITS-1 downto 0);
+        averaging           : in    unsigned(3 downto 0);
+        usb_speed           : in    std_logic;
+
+        -- Samples and timestamp to gate
+        in_timestamp        : in    unsigned(63 downto 0);
+        in_streams          : in    sample_streams_t(0 to NUM_STREAMS-1);
+
+        -- Packets to the sample FIFO writer
+        packet_ready        : in    std_logic;
+        packet_control      : out   packet_control_t;
+        out_timestamp       : out   unsigned(63 downto 0)
+    );
+end entity;
+
+architecture arch of rx_burst_gate is
+
+    constant CORE_ID        : std_logic_vector(7 downto 0) := x"01";
+
+    constant FLAG_START     : natural := 0;
+    constant FLAG_END       : natural := 1;
+    constant FLAG_DROPPED   : natural := 2;
+
+    -- DMA buffer sizes, less the 4 DWORD metadata header
+    constant MAX_LEN_SS     : natural := 512 - 4;
+    constant MAX_LEN_HS     : natural := 256 - 4;
+
+    -- Exponential average accumulator, with 15 fractional bits
+    constant ACC_BITS       : natural := 32 + 15;
+
+    type history_t is array(0 to 2**HISTORY_BITS-1) of std_logic_vector(31 downto 0);
+    signal history          : history_t;
+    signal wr_ptr           : unsigned(HISTORY_BITS-1 downto 0);
+
+    -- Detector outputs, one clock behind the input samples
+    signal det_valid        : std_logic;
+    signal det_loud         : boolean;
+    signal det_primed       : boolean;
+    signal det_live         : std_logic_vector(31 downto 0);
+    signal det_delayed      : std_logic_vector(31 downto 0);
+    signal det_timestamp    : unsigned(63 downto 0);
+
+begin
+
+    -- The history buffer holds the selected channel's samples, and is read
+    -- `pretrigger` samples behind where it is written
+    history_buffer : process(clock)
+        variable sample     : sample_stream_t;
+        variable rd         : unsigned(HISTORY_BITS-1 downto 0);
+    begin
+        if( rising_edge(clock) ) then
+            if( channel = '1' and NUM_STREAMS > 1 ) then
+                sample := in_streams(1);
+            else
+                sample := in_streams(0);
+            end if;
+
+            if( sample.data_v = '1' ) then
+                rd          := wr_ptr - pretrigger;
+                history(to_integer(wr_ptr)) <= std_logic_vector(sample.data_q) &
+                                               std_logic_vector(sample.data_i);
+                det_delayed <= history(to_integer(rd));
+            end if;
+        end if;
+    end process;
+
+    detect : process(clock, reset)
+        variable sample     : sample_stream_t;
+        variable p          : signed(32 downto 0);
+        variable acc        : unsigned(ACC_BITS-1 downto 0);
+        variable seen       : natural range 0 to 2**HISTORY_BITS-1;
+        variable level      : unsigned(ACC_BITS-1 downto 0);
+    begin
+        if( reset = '1' ) then
+            acc           := (others => '0');
+            seen          := 0;
+            wr_ptr        <= (others => '0');
+            det_valid     <= '0';
+            det_loud      <= false;
+            det_primed    <= false;
+            det_live      <= (others => '0');
+            det_timestamp <= (others => '0');
+        elsif( rising_edge(clock) ) then
+            det_timestamp <= in_timestamp - resize(pretrigger, in_timestamp'length);
+            det_valid     <= '0';
+
+            if( channel = '1' and NUM_STREAMS > 1 ) then
+                sample := in_streams(1);
+            else
+                sample := in_streams(0);
+            end if;
+
+            if( enable = '0' ) then
+                acc        := (others => '0');
+                seen       := 0;
+                det_primed <= false;
+            elsif( sample.data_v = '1' ) then
+                p := resize(sample.data_i * sample.data_i, p'length) +
+                     resize(sample.data_q * sample.data_q, p'length);
+
+                -- acc converges on 2^averaging times the mean power
+                acc   := acc - shift_right(acc, to_integer(averaging)) +
+                         resize(unsigned(p(31 downto 0)), ACC_BITS);
+                level := shift_right(acc, to_integer(averaging));
+
+                if( seen < to_integer(pretrigger) ) then
+                    seen := seen + 1;
+                end if;
+
+                det_valid  <= '1';
+                det_loud   <= level(31 downto 0) >= threshold and
+                              level(ACC_BITS-1 downto 32) = 0;
+                det_primed <= seen >= to_integer(pretrigger);
+                det_live   <= std_logic_vector(sample.data_q) &
+                              std_logic_vector(sample.data_i);
+            end if;
+
+            if( sample.data_v = '1' ) then
+                wr_ptr <= wr_ptr + 1;
+            end if;
+        end if;
+    end process;
+
+    gate : process(clock, reset)
+        variable data       : std_logic_vector(31 downto 0);
+        variable is_open    : boolean;
+        variable in_packet  : boolean;
+        variable first      : boolean;
+        variable dropped    : boolean;
+        variable below      : natural range 0 to 2**hangover'length + 2**HISTORY_BITS;
+        variable words      : natural range 0 to MAX_LEN_SS;
+        variable max_len    : natural range MAX_LEN_HS to MAX_LEN_SS;
+        variable limit      : natural range 1 to 2**hangover'length + 2**HISTORY_BITS;
+        variable flags      : std_logic_vector(7 downto 0);
+        variable pkt        : packet_control_t;
+    begin
+        if( reset = '1' ) then
+            is_open        := false;
+            in_packet      := false;
+            first          := false;
+            dropped        := false;
+            below          := 0;
+            words          := 0;
+            flags          := (others => '0');
+            packet_control <= PACKET_CONTROL_DEFAULT;
+            out_timestamp  <= (others => '0');
+        elsif( rising_edge(clock) ) then
+            out_timestamp <= det_timestamp;
+
+            pkt             := PACKET_CONTROL_DEFAULT;
+            pkt.pkt_core_id := CORE_ID;
+
+            if( pretrigger = 0 ) then
+                data := det_live;
+            else
+                data := det_delayed;
+            end if;
+
+            if( usb_speed = '0' ) then
+                max_len := MAX_LEN_SS;
+            else
+                max_len := MAX_LEN_HS;
+            end if;
+
+            -- The detector runs `pretrigger` samples ahead of the samples
+            -- emitted, so the gate is held open that much longer
+            if( hangover = 0 ) then
+                limit := 1 + to_integer(pretrigger);
+            else
+                limit := to_integer(hangover) + to_integer(pretrigger);
+            end if;
+
+            if( enable = '0' ) then
+                is_open   := false;
+                in_packet := false;
+                dropped   := false;
+                below     := 0;
+                words     := 0;
+                flags     := (others => '0');
+            elsif( det_valid = '1' ) then
+                if( det_loud ) then
+                    below := 0;
+                elsif( below < limit ) then
+                    below := below + 1;
+                end if;
+
+                if( not is_open and det_loud and det_primed ) then
+                    is_open := true;
+                    first   := true;
+                end if;
+
+                if( is_open ) then
+                    if( not in_packet ) then
+                        if( packet_ready = '1' ) then
+                            -- Start a packet with this sample
+                            in_packet := true;
+                            words     := 0;
+                            flags     := (others => '0');
+                            if( first ) then
+                                flags(FLAG_START) := '1';
+                            end if;
+                            if( dropped ) then
+                                flags(FLAG_DROPPED) := '1';
+                            end if;
+                            first       := false;
+                            dropped     := false;
+                            pkt.pkt_sop := '1';
+                        else
+                            -- No room for a packet, so this sample is lost
+                            dropped := true;
+                        end if;
+                    end if;
+
+                    if( in_packet ) then
+                        words          := words + 1;
+                        pkt.data       := data;
+                        pkt.data_valid := '1';
+
+                        -- A packet must hold at least two DWORDs, so a burst
+                        -- that would end on a packet's first sample is held
+                        -- open for one more.
+                        if( below >= limit and words > 1 ) then
+                            flags(FLAG_END) := '1';
+                            pkt.pkt_eop     := '1';
+                            in_packet       := false;
+                            is_open         := false;
+                        elsif( words = max_len ) then
+                            pkt.pkt_eop     := '1';
+                            in_packet       := false;
+                        end if;
+                    elsif( below >= limit ) then
+                        is_open := false;
+                    end if;
+                end if;
+            end if;
+
+            pkt.pkt_flags  := flags;
+            packet_control <= pkt;
+        end if;
+    end process;
+
+end architecture;
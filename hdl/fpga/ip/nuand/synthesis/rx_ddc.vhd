@@ -0,0 +1,233 @@
+-- Copyright (c) 2026 Nuand LLC
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+
+-- RX digital downconverter
+--
+-- Each stream is mixed by a CORDIC-based NCO and then decimated by a 3-stage
+-- CIC filter. The decimation is a power of two, from 1 (mix only) to 64.
+-- The CIC's bit growth and the CORDIC's gain are removed, so the output keeps
+-- the scaling of the input samples.
+--
+-- While enabled, the timestamp presented to the sample FIFO writer is divided
+-- by the decimation, so metadata timestamps keep counting one tick per
+-- sample that is delivered to the host.
+--
+-- When disabled, samples and timestamps are passed through with one cycle of
+-- latency.
+
+library ieee;
+    use ieee.std_logic_1164.all;
+    use ieee.numeric_std.all;
+
+library work;
+    use work.cordic_p.all;
+    use work.fifo_readwrite_p.all;
+
+entity rx_ddc is
+    generic (
+        NUM_STREAMS         : natural := 2
+    );
+    port (
+        clock               : in    std_logic;
+        reset               : in    std_logic;
+
+        -- Control
+        enable              : in    std_logic;
+        log2_decimation     : in    unsigned(2 downto 0);
+        dphase              : in    signed(23 downto 0);
+
+        -- Samples and timestamp from the RX mux
+        in_timestamp        : in    unsigned(63 downto 0);
+        in_streams          : in    sample_streams_t(0 to NUM_STREAMS-1);
+
+        -- Samples and timestamp to the sample FIFO writer
+        out_timestamp       : out   unsigned(63 downto 0);
+        out_streams         : out   sample_streams_t(0 to NUM_STREAMS-1)
+    );
+end entity;
+
+architecture arch of rx_ddc is
+
+    constant CIC_STAGES     : natural := 3;
+    constant MAX_LOG2_DECIM : natural := 6;
+    constant CIC_WIDTH      : natural := 16 + CIC_STAGES*MAX_LOG2_DECIM;
+
+    -- round(2^15 / 1.64676), the inverse of the 12-stage CORDIC's gain
+    constant CORDIC_GAIN_INV : signed(15 downto 0) := to_signed(19898, 16);
+
+    type cic_chain_t is array(0 to CIC_STAGES-1) of signed(CIC_WIDTH-1 downto 0);
+
+    constant CIC_CHAIN_ZERO : cic_chain_t := (others => (others => '0'));
+
+    -- Run the comb sections, updating their delay lines and returning the
+    -- filtered sample.
+    procedure comb( input : in    signed(CIC_WIDTH-1 downto 0);
+                    delay : inout cic_chain_t;
+                    rv    : out   signed(CIC_WIDTH-1 downto 0) ) is
+        variable x : signed(CIC_WIDTH-1 downto 0);
+        variable y : signed(CIC_WIDTH-1 downto 0);
+    begin
+        x := input;
+        for i in delay'range loop
+            y        := x - delay(i);
+            delay(i) := x;
+            x        := y;
+        end loop;
+        rv := x;
+    end procedure;
+
+    -- Remove the CIC's bit growth and the CORDIC's gain
+    function normalize( x : signed(CIC_WIDTH-1 downto 0);
+                        l : natural ) return signed is
+        variable s : signed(15 downto 0);
+        variable p : signed(31 downto 0);
+    begin
+        s := resize(shift_right(x, CIC_STAGES*l), s'length);
+        p := s * CORDIC_GAIN_INV;
+        return resize(shift_right(p, 15), s'length);
+    end function;
+
+    signal decim_log2       : natural range 0 to MAX_LOG2_DECIM;
+
+    signal ddc_streams      : sample_streams_t(0 to NUM_STREAMS-1) := (others => ZERO_SAMPLE);
+    signal bypass_streams   : sample_streams_t(0 to NUM_STREAMS-1) := (others => ZERO_SAMPLE);
+
+begin
+
+    decim_log2 <= MAX_LOG2_DECIM when to_integer(log2_decimation) > MAX_LOG2_DECIM else
+                  to_integer(log2_decimation);
+
+    output : process(clock, reset)
+    begin
+        if( reset = '1' ) then
+            out_timestamp  <= (others => '0');
+            bypass_streams <= (others => ZERO_SAMPLE);
+        elsif( rising_edge(clock) ) then
+            bypass_streams <= in_streams;
+
+            if( enable = '1' ) then
+                out_timestamp <= shift_right(in_timestamp, decim_log2);
+            else
+                out_timestamp <= in_timestamp;
+            end if;
+        end if;
+    end process;
+
+    out_streams <= ddc_streams when enable = '1' else bypass_streams;
+
+    generate_ddc : for s in 0 to NUM_STREAMS-1 generate
+
+        signal phase          : signed(23 downto 0);
+        signal cordic_inputs  : cordic_xyz_t;
+        signal cordic_outputs : cordic_xyz_t;
+
+    begin
+
+        -- The CORDIC represents -pi..pi as -4096..4096, so the top 13 bits
+        -- of the phase accumulator are presented to it.
+        accumulate_phase : process(clock, reset)
+        begin
+            if( reset = '1' ) then
+                phase <= (others => '0');
+            elsif( rising_edge(clock) ) then
+                if( enable = '0' ) then
+                    phase <= (others => '0');
+                elsif( in_streams(s).data_v = '1' ) then
+                    phase <= phase + dphase;
+                end if;
+            end if;
+        end process;
+
+        cordic_inputs <= (
+            x     => in_streams(s).data_i,
+            y     => in_streams(s).data_q,
+            z     => resize(phase(phase'high downto phase'high-12), 16),
+            valid => in_streams(s).data_v and enable
+        );
+
+        U_mixer : entity work.cordic
+            port map (
+                clock   => clock,
+                reset   => reset,
+                mode    => CORDIC_ROTATION,
+                inputs  => cordic_inputs,
+                outputs => cordic_outputs
+            );
+
+        decimate : process(clock, reset)
+            variable integ_i : cic_chain_t;
+            variable integ_q : cic_chain_t;
+            variable delay_i : cic_chain_t;
+            variable delay_q : cic_chain_t;
+            variable count   : natural range 0 to 2**MAX_LOG2_DECIM-1;
+            variable last    : natural range 0 to MAX_LOG2_DECIM;
+            variable y_i     : signed(CIC_WIDTH-1 downto 0);
+            variable y_q     : signed(CIC_WIDTH-1 downto 0);
+        begin
+            if( reset = '1' ) then
+                integ_i        := CIC_CHAIN_ZERO;
+                integ_q        := CIC_CHAIN_ZERO;
+                delay_i        := CIC_CHAIN_ZERO;
+                delay_q        := CIC_CHAIN_ZERO;
+                count          := 0;
+                last           := 0;
+                ddc_streams(s) <= ZERO_SAMPLE;
+            elsif( rising_edge(clock) ) then
+                ddc_streams(s).data_v <= '0';
+
+                -- Flush the filter when disabled or reconfigured
+                if( enable = '0' or decim_log2 /= last ) then
+                    integ_i := CIC_CHAIN_ZERO;
+                    integ_q := CIC_CHAIN_ZERO;
+                    delay_i := CIC_CHAIN_ZERO;
+                    delay_q := CIC_CHAIN_ZERO;
+                    count   := 0;
+                    last    := decim_log2;
+                elsif( cordic_outputs.valid = '1' ) then
+                    -- Integrators, at the input rate. The stages are
+                    -- updated last-first so each uses the previous value of
+                    -- the stage before it.
+                    for i in CIC_STAGES-1 downto 1 loop
+                        integ_i(i) := integ_i(i) + integ_i(i-1);
+                        integ_q(i) := integ_q(i) + integ_q(i-1);
+                    end loop;
+                    integ_i(0) := integ_i(0) + resize(cordic_outputs.x, CIC_WIDTH);
+                    integ_q(0) := integ_q(0) + resize(cordic_outputs.y, CIC_WIDTH);
+
+                    -- Combs, at the output rate
+                    if( count = 2**decim_log2 - 1 ) then
+                        count := 0;
+
+                        comb(integ_i(CIC_STAGES-1), delay_i, y_i);
+                        comb(integ_q(CIC_STAGES-1), delay_q, y_q);
+
+                        ddc_streams(s).data_i <= normalize(y_i, decim_log2);
+                        ddc_streams(s).data_q <= normalize(y_q, decim_log2);
+                        ddc_streams(s).data_v <= '1';
+                    else
+                        count := count + 1;
+                    end if;
+                end if;
+            end if;
+        end process;
+
+    end generate;
+
+end architecture;
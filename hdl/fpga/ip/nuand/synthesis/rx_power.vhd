@@ -0,0 +1,190 @@
+-- Copyright (c) 2026 Nuand LLC
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+
+-- RX power detector
+--
+-- Each stream's instantaneous power, I^2 + Q^2, is averaged over blocks of
+-- 2^log2_length samples. At the end of every block the stream's mean power,
+-- its peak power and a count of completed blocks are latched, so the host may
+-- monitor a band without streaming its samples.
+--
+-- The latched results are read one field at a time through `data`, selected
+-- by `channel` and `field`:
+--   "00" - Mean power
+--   "01" - Peak power
+--   "10" - Blocks completed since the detector was enabled
+--
+-- The results are updated in this clock domain, so a reader in another domain
+-- should read the block count before and after the other fields and retry if
+-- it changed.
+--
+-- When disabled, the accumulators and the latched results are cleared.
+
+library ieee;
+    use ieee.std_logic_1164.all;
+    use ieee.numeric_std.all;
+
+library work;
+    use work.fifo_readwrite_p.all;
+
+entity rx_power is
+    generic (
+        NUM_STREAMS         : natural := 2
+    );
+    port (
+        clock               : in    std_logic;
+        reset               : in    std_logic;
+
+        -- Control
+        enable              : in    std_logic;
+        log2_length         : in    unsigned(4 downto 0);
+
+        -- Samples to measure
+        in_streams          : in    sample_streams_t(0 to NUM_STREAMS-1);
+
+        -- Result readback
+        channel             : in    std_logic;
+        field               : in    unsigned(1 downto 0);
+        data                : out   std_logic_vector(31 downto 0)
+    );
+end entity;
+
+architecture arch of rx_power is
+
+    constant MIN_LOG2_LENGTH : natural := 4;
+    constant MAX_LOG2_LENGTH : natural := 20;
+    constant SUM_WIDTH       : natural := 32 + MAX_LOG2_LENGTH;
+
+    type result_t is record
+        mean    : unsigned(31 downto 0);
+        peak    : unsigned(31 downto 0);
+        count   : unsigned(31 downto 0);
+    end record;
+
+    constant RESULT_ZERO : result_t := (
+        mean    => (others => '0'),
+        peak    => (others => '0'),
+        count   => (others => '0')
+    );
+
+    type results_t is array(natural range <>) of result_t;
+
+    signal length_log2      : natural range MIN_LOG2_LENGTH to MAX_LOG2_LENGTH;
+    signal results          : results_t(0 to NUM_STREAMS-1) := (others => RESULT_ZERO);
+
+begin
+
+    length_log2 <= MIN_LOG2_LENGTH when to_integer(log2_length) < MIN_LOG2_LENGTH else
+                   MAX_LOG2_LENGTH when to_integer(log2_length) > MAX_LOG2_LENGTH else
+                   to_integer(log2_length);
+
+    generate_power : for s in 0 to NUM_STREAMS-1 generate
+
+        signal power    : unsigned(31 downto 0);
+        signal power_v  : std_logic;
+
+    begin
+
+        -- Full scale SC16 Q11 samples give at most 2 * 2048^2, so the sum of
+        -- squares always fits in 32 bits.
+        square : process(clock, reset)
+            variable p : signed(32 downto 0);
+        begin
+            if( reset = '1' ) then
+                power   <= (others => '0');
+                power_v <= '0';
+            elsif( rising_edge(clock) ) then
+                p := resize(in_streams(s).data_i * in_streams(s).data_i, p'length) +
+                     resize(in_streams(s).data_q * in_streams(s).data_q, p'length);
+
+                power   <= unsigned(p(31 downto 0));
+                power_v <= in_streams(s).data_v and enable;
+            end if;
+        end process;
+
+        accumulate : process(clock, reset)
+            variable sum    : unsigned(SUM_WIDTH-1 downto 0);
+            variable peak   : unsigned(31 downto 0);
+            variable count  : natural range 0 to 2**MAX_LOG2_LENGTH-1;
+            variable last   : natural range MIN_LOG2_LENGTH to MAX_LOG2_LENGTH;
+        begin
+            if( reset = '1' ) then
+                sum        := (others => '0');
+                peak       := (others => '0');
+                count      := 0;
+                last       := MIN_LOG2_LENGTH;
+                results(s) <= RESULT_ZERO;
+            elsif( rising_edge(clock) ) then
+                if( enable = '0' or length_log2 /= last ) then
+                    -- Start over when disabled or reconfigured
+                    sum   := (others => '0');
+                    peak  := (others => '0');
+                    count := 0;
+                    last  := length_log2;
+
+                    if( enable = '0' ) then
+                        results(s) <= RESULT_ZERO;
+                    end if;
+                elsif( power_v = '1' ) then
+                    sum := sum + power;
+
+                    if( power > peak ) then
+                        peak := power;
+                    end if;
+
+                    if( count = 2**length_log2 - 1 ) then
+                        results(s).mean  <= resize(shift_right(sum, length_log2), 32);
+                        results(s).peak  <= peak;
+                        results(s).count <= results(s).count + 1;
+
+                        sum   := (others => '0');
+                        peak  := (others => '0');
+                        count := 0;
+                    else
+                        count := count + 1;
+                    end if;
+                end if;
+            end if;
+        end process;
+
+    end generate;
+
+    readback : process(clock, reset)
+        variable idx : natural range 0 to NUM_STREAMS-1;
+    begin
+        if( reset = '1' ) then
+            data <= (others => '0');
+        elsif( rising_edge(clock) ) then
+            if( channel = '1' and NUM_STREAMS > 1 ) then
+                idx := 1;
+            else
+                idx := 0;
+            end if;
+
+            case field is
+                when "00"   => data <= std_logic_vector(results(idx).mean);
+                when "01"   => data <= std_logic_vector(results(idx).peak);
+                when "10"   => data <= std_logic_vector(results(idx).count);
+                when others => data <= (others => '0');
+            end case;
+        end if;
+    end process;
+
+end architecture;
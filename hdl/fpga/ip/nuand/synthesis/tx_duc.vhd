@@ -0,0 +1,262 @@
+-- Copyright (c) 2026 Nuand LLC
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+
+-- TX digital upconverter
+--
+-- Each stream is interpolated by a 3-stage CIC filter and then mixed by a
+-- CORDIC-based NCO. The interpolation is a power of two, from 1 (mix only)
+-- to 64. The CIC's gain and the CORDIC's gain are removed, so the output
+-- keeps the scaling of the input samples.
+--
+-- While enabled, only one in every `interpolation` sample requests from the
+-- DAC is passed on to the sample FIFO reader, and the timestamp presented to
+-- the reader is divided by the interpolation. Metadata timestamps therefore
+-- keep counting one tick per sample sent by the host.
+--
+-- When disabled, sample requests, samples and timestamps are passed through.
+
+library ieee;
+    use ieee.std_logic_1164.all;
+    use ieee.numeric_std.all;
+
+library work;
+    use work.cordic_p.all;
+    use work.fifo_readwrite_p.all;
+
+entity tx_duc is
+    generic (
+        NUM_STREAMS         : natural := 2
+    );
+    port (
+        clock               : in    std_logic;
+        reset               : in    std_logic;
+
+        -- Control
+        enable              : in    std_logic;
+        log2_interpolation  : in    unsigned(2 downto 0);
+        dphase              : in    signed(23 downto 0);
+
+        -- Sample requests and timestamp, from the DAC to the FIFO reader
+        in_timestamp        : in    unsigned(63 downto 0);
+        in_controls         : in    sample_controls_t(0 to NUM_STREAMS-1);
+        out_timestamp       : out   unsigned(63 downto 0);
+        out_controls        : out   sample_controls_t(0 to NUM_STREAMS-1);
+
+        -- Samples, from the FIFO reader to the DAC
+        in_streams          : in    sample_streams_t(0 to NUM_STREAMS-1);
+        out_streams         : out   sample_streams_t(0 to NUM_STREAMS-1)
+    );
+end entity;
+
+architecture arch of tx_duc is
+
+    constant CIC_STAGES     : natural := 3;
+    constant MAX_LOG2_INTERP : natural := 6;
+    constant CIC_WIDTH      : natural := 16 + (CIC_STAGES-1)*MAX_LOG2_INTERP;
+
+    -- round(2^15 / 1.64676), the inverse of the 12-stage CORDIC's gain
+    constant CORDIC_GAIN_INV : signed(15 downto 0) := to_signed(19898, 16);
+
+    type cic_chain_t is array(0 to CIC_STAGES-1) of signed(CIC_WIDTH-1 downto 0);
+
+    constant CIC_CHAIN_ZERO : cic_chain_t := (others => (others => '0'));
+
+    -- Run the comb sections, updating their delay lines and returning the
+    -- filtered sample.
+    procedure comb( input : in    signed(CIC_WIDTH-1 downto 0);
+                    delay : inout cic_chain_t;
+                    rv    : out   signed(CIC_WIDTH-1 downto 0) ) is
+        variable x : signed(CIC_WIDTH-1 downto 0);
+        variable y : signed(CIC_WIDTH-1 downto 0);
+    begin
+        x := input;
+        for i in delay'range loop
+            y        := x - delay(i);
+            delay(i) := x;
+            x        := y;
+        end loop;
+        rv := x;
+    end procedure;
+
+    -- Remove the CIC's gain of interpolation^(CIC_STAGES-1)
+    function normalize( x : signed(CIC_WIDTH-1 downto 0);
+                        l : natural ) return signed is
+    begin
+        return resize(shift_right(x, (CIC_STAGES-1)*l), 16);
+    end function;
+
+    -- Remove the CORDIC's gain
+    function unscale( x : signed(15 downto 0) ) return signed is
+        variable p : signed(31 downto 0);
+    begin
+        p := x * CORDIC_GAIN_INV;
+        return resize(shift_right(p, 15), x'length);
+    end function;
+
+    signal interp_log2      : natural range 0 to MAX_LOG2_INTERP;
+
+    signal duc_controls     : sample_controls_t(0 to NUM_STREAMS-1) := (others => SAMPLE_CONTROL_DISABLE);
+    signal duc_streams      : sample_streams_t(0 to NUM_STREAMS-1)  := (others => ZERO_SAMPLE);
+
+begin
+
+    interp_log2 <= MAX_LOG2_INTERP when to_integer(log2_interpolation) > MAX_LOG2_INTERP else
+                   to_integer(log2_interpolation);
+
+    out_timestamp <= shift_right(in_timestamp, interp_log2) when enable = '1' else in_timestamp;
+    out_controls  <= duc_controls when enable = '1' else in_controls;
+    out_streams   <= duc_streams  when enable = '1' else in_streams;
+
+    generate_duc : for s in 0 to NUM_STREAMS-1 generate
+
+        signal phase          : signed(23 downto 0);
+        signal request        : std_logic;
+        signal first          : std_logic;
+        signal cordic_inputs  : cordic_xyz_t;
+        signal cordic_outputs : cordic_xyz_t;
+
+    begin
+
+        -- A request is an output sample period at the DAC rate. The first
+        -- request of every `interpolation` is passed to the FIFO reader.
+        request <= in_controls(s).enable and in_controls(s).data_req;
+
+        pace_requests : process(clock, reset)
+            variable count : natural range 0 to 2**MAX_LOG2_INTERP-1;
+        begin
+            if( reset = '1' ) then
+                count := 0;
+            elsif( rising_edge(clock) ) then
+                if( enable = '0' ) then
+                    count := 0;
+                elsif( request = '1' ) then
+                    if( count = 2**interp_log2 - 1 ) then
+                        count := 0;
+                    else
+                        count := count + 1;
+                    end if;
+                end if;
+                if( count = 0 ) then
+                    first <= '1';
+                else
+                    first <= '0';
+                end if;
+            end if;
+        end process;
+
+        duc_controls(s).enable   <= in_controls(s).enable;
+        duc_controls(s).data_req <= in_controls(s).data_req and first;
+
+        interpolate : process(clock, reset)
+            variable delay_i : cic_chain_t;
+            variable delay_q : cic_chain_t;
+            variable integ_i : cic_chain_t;
+            variable integ_q : cic_chain_t;
+            variable held_i  : signed(CIC_WIDTH-1 downto 0);
+            variable held_q  : signed(CIC_WIDTH-1 downto 0);
+            variable last    : natural range 0 to MAX_LOG2_INTERP;
+        begin
+            if( reset = '1' ) then
+                delay_i       := CIC_CHAIN_ZERO;
+                delay_q       := CIC_CHAIN_ZERO;
+                integ_i       := CIC_CHAIN_ZERO;
+                integ_q       := CIC_CHAIN_ZERO;
+                held_i        := (others => '0');
+                held_q        := (others => '0');
+                last          := 0;
+                cordic_inputs <= (x => (others => '0'), y => (others => '0'),
+                                  z => (others => '0'), valid => '0');
+            elsif( rising_edge(clock) ) then
+                cordic_inputs.valid <= '0';
+
+                -- Flush the filter when disabled or reconfigured
+                if( enable = '0' or interp_log2 /= last ) then
+                    delay_i := CIC_CHAIN_ZERO;
+                    delay_q := CIC_CHAIN_ZERO;
+                    integ_i := CIC_CHAIN_ZERO;
+                    integ_q := CIC_CHAIN_ZERO;
+                    held_i  := (others => '0');
+                    held_q  := (others => '0');
+                    last    := interp_log2;
+                else
+                    -- Combs, at the input rate. The result is held until
+                    -- the next period that starts on a passed request.
+                    if( in_streams(s).data_v = '1' ) then
+                        comb(resize(in_streams(s).data_i, CIC_WIDTH), delay_i, held_i);
+                        comb(resize(in_streams(s).data_q, CIC_WIDTH), delay_q, held_q);
+                    end if;
+
+                    -- Integrators, at the output rate, fed with the held
+                    -- comb output followed by interpolation-1 zeros. The
+                    -- stages are updated last-first so each uses the
+                    -- previous value of the stage before it.
+                    if( request = '1' ) then
+                        for i in CIC_STAGES-1 downto 1 loop
+                            integ_i(i) := integ_i(i) + integ_i(i-1);
+                            integ_q(i) := integ_q(i) + integ_q(i-1);
+                        end loop;
+
+                        if( first = '1' ) then
+                            integ_i(0) := integ_i(0) + held_i;
+                            integ_q(0) := integ_q(0) + held_q;
+                        end if;
+
+                        cordic_inputs <= (
+                            x     => normalize(integ_i(CIC_STAGES-1), interp_log2),
+                            y     => normalize(integ_q(CIC_STAGES-1), interp_log2),
+                            z     => resize(phase(phase'high downto phase'high-12), 16),
+                            valid => '1'
+                        );
+                    end if;
+                end if;
+            end if;
+        end process;
+
+        -- The CORDIC represents -pi..pi as -4096..4096, so the top 13 bits
+        -- of the phase accumulator are presented to it.
+        accumulate_phase : process(clock, reset)
+        begin
+            if( reset = '1' ) then
+                phase <= (others => '0');
+            elsif( rising_edge(clock) ) then
+                if( enable = '0' ) then
+                    phase <= (others => '0');
+                elsif( request = '1' ) then
+                    phase <= phase + dphase;
+                end if;
+            end if;
+        end process;
+
+        U_mixer : entity work.cordic
+            port map (
+                clock   => clock,
+                reset   => reset,
+                mode    => CORDIC_ROTATION,
+                inputs  => cordic_inputs,
+                outputs => cordic_outputs
+            );
+
+        duc_streams(s).data_i <= unscale(cordic_outputs.x);
+        duc_streams(s).data_q <= unscale(cordic_outputs.y);
+        duc_streams(s).data_v <= cordic_outputs.valid;
+
+    end generate;
+
+end architecture;
@@ -0,0 +1,354 @@
+-- Copyright (c) 2026 Nuand LLC
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+
+-- TX waveform loop
+--
+-- A waveform of up to 2**ADDR_WIDTH samples per stream is captured from the
+-- TX sample FIFO reader into block RAM, and then played to the DAC over and
+-- over without further samples from the host.
+--
+--   IDLE       Sample requests and samples are passed through.
+--   LOADING    Samples from the reader are written to the RAM, and zeros are
+--              sent to the DAC in their place. Once LENGTH samples have been
+--              captured, the loop moves to LOADED. A stop command abandons
+--              the capture and returns to IDLE.
+--   LOADED     As IDLE, with a waveform ready to play.
+--   ARMED      Requests are withheld from the reader and zeros are sent to
+--              the DAC until the start time is reached.
+--   PLAYING    Each request is served from the RAM, wrapping from LENGTH-1
+--              back to 0, until the stop time is reached or a stop command
+--              is received. The loop then returns to LOADED.
+--
+-- Each RAM word holds one sample of every stream, so the same streams must
+-- be enabled while loading and playing.
+--
+-- A register is written by presenting its value on `wdata` and then
+-- toggling ctl(8) with its address in ctl(3 downto 0). The register
+-- addressed by ctl(3 downto 0) is presented on `rdata`. See the
+-- NIOS_PKT_8x32_TARGET_TX_LOOP addresses for the register map.
+
+library ieee;
+    use ieee.std_logic_1164.all;
+    use ieee.numeric_std.all;
+
+library work;
+    use work.fifo_readwrite_p.all;
+
+entity tx_loop is
+    generic (
+        NUM_STREAMS         : natural := 2;
+        ADDR_WIDTH          : natural := 13
+    );
+    port (
+        clock               : in    std_logic;
+        reset               : in    std_logic;
+
+        -- Register interface
+        ctl                 : in    std_logic_vector(31 downto 0);
+        wdata               : in    std_logic_vector(31 downto 0);
+        rdata               : out   std_logic_vector(31 downto 0);
+
+        -- Time at which the next requested sample is sent
+        timestamp           : in    unsigned(63 downto 0);
+
+        -- Sample requests, from the DAC to the FIFO reader
+        in_controls         : in    sample_controls_t(0 to NUM_STREAMS-1);
+        out_controls        : out   sample_controls_t(0 to NUM_STREAMS-1);
+
+        -- Samples, from the FIFO reader to the DAC
+        in_streams          : in    sample_streams_t(0 to NUM_STREAMS-1);
+        out_streams         : out   sample_streams_t(0 to NUM_STREAMS-1)
+    );
+end entity;
+
+architecture arch of tx_loop is
+
+    -- Register addresses
+    constant ADDR_CONTROL   : natural := 0;
+    constant ADDR_LENGTH    : natural := 1;
+    constant ADDR_START_LO  : natural := 2;
+    constant ADDR_START_HI  : natural := 3;
+    constant ADDR_STOP_LO   : natural := 4;
+    constant ADDR_STOP_HI   : natural := 5;
+    constant ADDR_LOOPS     : natural := 6;
+    constant ADDR_CAPACITY  : natural := 7;
+
+    -- Commands written to ADDR_CONTROL
+    constant CMD_DISABLE    : natural := 0;
+    constant CMD_LOAD       : natural := 1;
+    constant CMD_PLAY       : natural := 2;
+    constant CMD_STOP       : natural := 3;
+
+    constant CAPACITY       : natural := 2**ADDR_WIDTH;
+
+    type state_t is (IDLE, LOADING, LOADED, ARMED, PLAYING);
+
+    -- Encoding reported in ADDR_CONTROL
+    function encode( x : state_t ) return std_logic_vector is
+    begin
+        return std_logic_vector(to_unsigned(state_t'pos(x), 32));
+    end function;
+
+    subtype word_t is std_logic_vector(32*NUM_STREAMS-1 downto 0);
+    type ram_t is array(0 to CAPACITY-1) of word_t;
+
+    signal ram              : ram_t;
+    signal ram_we           : std_logic;
+    signal ram_waddr        : unsigned(ADDR_WIDTH-1 downto 0);
+    signal ram_wdata        : word_t;
+    signal ram_raddr        : unsigned(ADDR_WIDTH-1 downto 0);
+    signal ram_q            : word_t;
+
+    signal state            : state_t := IDLE;
+    signal length           : unsigned(31 downto 0) := (others => '0');
+    signal start_time       : unsigned(63 downto 0) := (others => '0');
+    signal stop_time        : unsigned(63 downto 0) := (others => '0');
+    signal start_lo         : std_logic_vector(31 downto 0) := (others => '0');
+    signal stop_lo          : std_logic_vector(31 downto 0) := (others => '0');
+    signal loops            : unsigned(31 downto 0) := (others => '0');
+
+    signal addr             : unsigned(ADDR_WIDTH-1 downto 0) := (others => '0');
+    signal last_addr        : unsigned(ADDR_WIDTH-1 downto 0) := (others => '0');
+    signal request          : std_logic;
+    signal request_r        : std_logic := '0';
+    signal enables_r        : std_logic_vector(0 to NUM_STREAMS-1) := (others => '0');
+
+begin
+
+    -- A request from any enabled stream advances the waveform by a sample
+    find_request : process(all)
+        variable rv : std_logic;
+    begin
+        rv := '0';
+        for s in in_controls'range loop
+            rv := rv or (in_controls(s).enable and in_controls(s).data_req);
+        end loop;
+        request <= rv;
+    end process;
+
+    -- Samples from the reader are captured while loading
+    capture : process(all)
+        variable any_v : std_logic;
+    begin
+        any_v := '0';
+        for s in in_streams'range loop
+            any_v := any_v or in_streams(s).data_v;
+            ram_wdata(32*s+31 downto 32*s) <= std_logic_vector(in_streams(s).data_i) &
+                                              std_logic_vector(in_streams(s).data_q);
+        end loop;
+
+        if( state = LOADING ) then
+            ram_we <= any_v;
+        else
+            ram_we <= '0';
+        end if;
+    end process;
+
+    ram_waddr <= addr;
+    ram_raddr <= addr;
+
+    U_ram : process(clock)
+    begin
+        if( rising_edge(clock) ) then
+            if( ram_we = '1' ) then
+                ram(to_integer(ram_waddr)) <= ram_wdata;
+            end if;
+            ram_q <= ram(to_integer(ram_raddr));
+        end if;
+    end process;
+
+    sequence : process(clock, reset)
+        variable toggle   : std_logic;
+        variable primed   : boolean;
+        variable strobe   : boolean;
+        variable reg_addr : natural range 0 to 15;
+        variable any_v    : std_logic;
+    begin
+        if( reset = '1' ) then
+            state      <= IDLE;
+            length     <= (others => '0');
+            start_time <= (others => '0');
+            stop_time  <= (others => '0');
+            start_lo   <= (others => '0');
+            stop_lo    <= (others => '0');
+            loops      <= (others => '0');
+            addr       <= (others => '0');
+            last_addr  <= (others => '0');
+            request_r  <= '0';
+            enables_r  <= (others => '0');
+            toggle     := '0';
+            primed     := false;
+        elsif( rising_edge(clock) ) then
+            -- The toggle's level after reset does not signal a write
+            strobe   := primed and ctl(8) /= toggle;
+            toggle   := ctl(8);
+            primed   := true;
+            reg_addr := to_integer(unsigned(ctl(3 downto 0)));
+
+            request_r <= '0';
+            for s in in_controls'range loop
+                enables_r(s) <= in_controls(s).enable;
+            end loop;
+
+            case state is
+                when LOADING =>
+                    any_v := '0';
+                    for s in in_streams'range loop
+                        any_v := any_v or in_streams(s).data_v;
+                    end loop;
+
+                    if( any_v = '1' ) then
+                        if( addr = last_addr ) then
+                            addr  <= (others => '0');
+                            state <= LOADED;
+                        else
+                            addr <= addr + 1;
+                        end if;
+                    end if;
+
+                when ARMED =>
+                    request_r <= request;
+                    if( start_time = 0 or timestamp >= start_time ) then
+                        state <= PLAYING;
+                    end if;
+
+                when PLAYING =>
+                    if( stop_time /= 0 and timestamp >= stop_time ) then
+                        state <= LOADED;
+                    elsif( request = '1' ) then
+                        request_r <= '1';
+                        if( addr = last_addr ) then
+                            addr  <= (others => '0');
+                            loops <= loops + 1;
+                        else
+                            addr <= addr + 1;
+                        end if;
+                    end if;
+
+                when others =>
+                    null;
+            end case;
+
+            -- Register writes, which take precedence over the sequencing
+            -- above
+            if( strobe ) then
+                case reg_addr is
+                    when ADDR_CONTROL =>
+                        case to_integer(unsigned(wdata(1 downto 0))) is
+                            when CMD_DISABLE =>
+                                state <= IDLE;
+
+                            when CMD_LOAD =>
+                                if( length /= 0 and length <= CAPACITY ) then
+                                    last_addr <= resize(length - 1, ADDR_WIDTH);
+                                    addr      <= (others => '0');
+                                    state     <= LOADING;
+                                end if;
+
+                            when CMD_PLAY =>
+                                if( state = LOADED ) then
+                                    addr  <= (others => '0');
+                                    loops <= (others => '0');
+                                    state <= ARMED;
+                                end if;
+
+                            when others =>
+                                if( state = ARMED or state = PLAYING ) then
+                                    state <= LOADED;
+                                elsif( state = LOADING ) then
+                                    state <= IDLE;
+                                end if;
+                        end case;
+
+                    when ADDR_LENGTH =>
+                        length <= unsigned(wdata);
+
+                    -- The low words are held until the high words are
+                    -- written, so a time is never compared half-updated
+                    when ADDR_START_LO =>
+                        start_lo <= wdata;
+
+                    when ADDR_START_HI =>
+                        start_time <= unsigned(wdata & start_lo);
+
+                    when ADDR_STOP_LO =>
+                        stop_lo <= wdata;
+
+                    when ADDR_STOP_HI =>
+                        stop_time <= unsigned(wdata & stop_lo);
+
+                    when others =>
+                        null;
+                end case;
+            end if;
+        end if;
+    end process;
+
+    -- Register readback
+    readback : process(clock)
+    begin
+        if( rising_edge(clock) ) then
+            case to_integer(unsigned(ctl(3 downto 0))) is
+                when ADDR_CONTROL  => rdata <= encode(state);
+                when ADDR_LENGTH   => rdata <= std_logic_vector(length);
+                when ADDR_START_LO => rdata <= std_logic_vector(start_time(31 downto 0));
+                when ADDR_START_HI => rdata <= std_logic_vector(start_time(63 downto 32));
+                when ADDR_STOP_LO  => rdata <= std_logic_vector(stop_time(31 downto 0));
+                when ADDR_STOP_HI  => rdata <= std_logic_vector(stop_time(63 downto 32));
+                when ADDR_LOOPS    => rdata <= std_logic_vector(loops);
+                when ADDR_CAPACITY => rdata <= std_logic_vector(to_unsigned(CAPACITY, 32));
+                when others        => rdata <= (others => '0');
+            end case;
+        end if;
+    end process;
+
+    -- Requests and samples
+    route : process(all)
+    begin
+        for s in in_controls'range loop
+            case state is
+                when ARMED | PLAYING =>
+                    -- Keep the reader configured, but draw nothing from it
+                    out_controls(s).enable   <= in_controls(s).enable;
+                    out_controls(s).data_req <= '0';
+
+                    if( state = PLAYING ) then
+                        out_streams(s).data_i <= signed(ram_q(32*s+31 downto 32*s+16));
+                        out_streams(s).data_q <= signed(ram_q(32*s+15 downto 32*s));
+                    else
+                        out_streams(s).data_i <= (others => '0');
+                        out_streams(s).data_q <= (others => '0');
+                    end if;
+                    out_streams(s).data_v <= request_r and enables_r(s);
+
+                when LOADING =>
+                    out_controls(s)       <= in_controls(s);
+                    out_streams(s).data_i <= (others => '0');
+                    out_streams(s).data_q <= (others => '0');
+                    out_streams(s).data_v <= in_streams(s).data_v;
+
+                when others =>
+                    out_controls(s) <= in_controls(s);
+                    out_streams(s)  <= in_streams(s);
+            end case;
+        end loop;
+    end process;
+
+end architecture;
@@ -0,0 +1,208 @@
+-- Copyright (c) 2026 Nuand LLC
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+
+-- Trigger timer
+--
+-- Fires a trigger at a scheduled timestamp, and records the timestamp at
+-- which the trigger line was asserted.
+--
+-- A scheduled fire asserts `fire` once `timestamp` reaches the fire time,
+-- or immediately if the fire time has already passed. `fire` is meant to be
+-- OR'd with the trigger control register's fire bit, so it only reaches the
+-- trigger line on a master. It is held until the trigger is disarmed or the
+-- fire is cancelled.
+--
+-- On a master or a slave, the timestamp of the first sample at which the
+-- (active-low) trigger line is seen asserted while armed is latched, and
+-- held until the trigger is armed again.
+--
+-- A register is written by presenting its value on `wdata` and then
+-- toggling ctl(8) with its address in ctl(3 downto 0). The RX and TX timers
+-- share a register interface, so writes are ignored unless ctl(4) matches
+-- SELECT_VALUE. The register addressed by ctl(3 downto 0) is presented on
+-- `rdata`. See the NIOS_PKT_8x64_TARGET_TRIGGER addresses for the fields
+-- these registers make up.
+
+library ieee;
+    use ieee.std_logic_1164.all;
+    use ieee.numeric_std.all;
+
+entity trigger_timer is
+    generic (
+        SELECT_VALUE        : std_logic := '0'
+    );
+    port (
+        clock               : in    std_logic;
+        reset               : in    std_logic;
+
+        -- Register interface
+        ctl                 : in    std_logic_vector(31 downto 0);
+        wdata               : in    std_logic_vector(31 downto 0);
+        rdata               : out   std_logic_vector(31 downto 0);
+
+        -- Time of the current sample
+        timestamp           : in    unsigned(63 downto 0);
+
+        -- Trigger control and line, both asynchronous
+        armed               : in    std_logic;
+        trigger_line        : in    std_logic;
+
+        -- Scheduled fire request
+        fire                : out   std_logic
+    );
+end entity;
+
+architecture arch of trigger_timer is
+
+    -- Register addresses
+    constant ADDR_CONTROL   : natural := 0;
+    constant ADDR_FIRE_LO   : natural := 1;
+    constant ADDR_FIRE_HI   : natural := 2;
+    constant ADDR_FIRED_LO  : natural := 3;
+    constant ADDR_FIRED_HI  : natural := 4;
+
+    -- Commands written to ADDR_CONTROL
+    constant CMD_CANCEL     : std_logic := '0';
+    constant CMD_SCHEDULE   : std_logic := '1';
+
+    signal armed_sync       : std_logic;
+    signal line_sync        : std_logic;
+
+    signal scheduled        : std_logic := '0';
+    signal fire_i           : std_logic := '0';
+    signal latched          : std_logic := '0';
+    signal fire_time        : unsigned(63 downto 0) := (others => '0');
+    signal fire_lo          : std_logic_vector(31 downto 0) := (others => '0');
+    signal fired_time       : unsigned(63 downto 0) := (others => '0');
+
+begin
+
+    U_sync_armed : entity work.synchronizer
+        generic map (
+            RESET_LEVEL =>  '0'
+        )
+        port map (
+            reset       =>  reset,
+            clock       =>  clock,
+            async       =>  armed,
+            sync        =>  armed_sync
+        );
+
+    U_sync_line : entity work.synchronizer
+        generic map (
+            RESET_LEVEL =>  '1'
+        )
+        port map (
+            reset       =>  reset,
+            clock       =>  clock,
+            async       =>  trigger_line,
+            sync        =>  line_sync
+        );
+
+    fire <= fire_i;
+
+    sequence : process(clock, reset)
+        variable toggle   : std_logic;
+        variable primed   : boolean;
+        variable strobe   : boolean;
+        variable armed_r  : std_logic;
+    begin
+        if( reset = '1' ) then
+            scheduled  <= '0';
+            fire_i     <= '0';
+            latched    <= '0';
+            fire_time  <= (others => '0');
+            fire_lo    <= (others => '0');
+            fired_time <= (others => '0');
+            toggle     := '0';
+            primed     := false;
+            armed_r    := '0';
+        elsif( rising_edge(clock) ) then
+            -- The toggle's level after reset does not signal a write
+            strobe := primed and ctl(8) /= toggle;
+            toggle := ctl(8);
+            primed := true;
+
+            if( scheduled = '1' and timestamp >= fire_time ) then
+                scheduled <= '0';
+                fire_i    <= '1';
+            end if;
+
+            if( armed_sync = '1' and line_sync = '0' and latched = '0' ) then
+                fired_time <= timestamp;
+                latched    <= '1';
+            end if;
+
+            -- Arming starts a new record of when the trigger fired
+            if( armed_sync = '1' and armed_r = '0' ) then
+                latched <= '0';
+            end if;
+
+            -- Disarming cancels a scheduled fire
+            if( armed_sync = '0' ) then
+                scheduled <= '0';
+                fire_i    <= '0';
+            end if;
+            armed_r := armed_sync;
+
+            if( strobe and ctl(4) = SELECT_VALUE ) then
+                case to_integer(unsigned(ctl(3 downto 0))) is
+                    when ADDR_CONTROL =>
+                        if( wdata(0) = CMD_SCHEDULE and armed_sync = '1' ) then
+                            scheduled <= '1';
+                        else
+                            scheduled <= '0';
+                        end if;
+                        fire_i <= '0';
+
+                    -- The low word is held until the high word is written,
+                    -- so a time is never compared half-updated
+                    when ADDR_FIRE_LO =>
+                        fire_lo <= wdata;
+
+                    when ADDR_FIRE_HI =>
+                        fire_time <= unsigned(wdata & fire_lo);
+
+                    when others =>
+                        null;
+                end case;
+            end if;
+        end if;
+    end process;
+
+    -- Register readback
+    readback : process(clock)
+    begin
+        if( rising_edge(clock) ) then
+            case to_integer(unsigned(ctl(3 downto 0))) is
+                when ADDR_CONTROL  => rdata <= (0      => scheduled,
+                                                1      => fire_i,
+                                                2      => latched,
+                                                others => '0');
+                when ADDR_FIRE_LO  => rdata <= std_logic_vector(fire_time(31 downto 0));
+                when ADDR_FIRE_HI  => rdata <= std_logic_vector(fire_time(63 downto 32));
+                when ADDR_FIRED_LO => rdata <= std_logic_vector(fired_time(31 downto 0));
+                when ADDR_FIRED_HI => rdata <= std_logic_vector(fired_time(63 downto 32));
+                when others        => rdata <= (others => '0');
+            end case;
+        end if;
+    end process;
+
+end architecture;
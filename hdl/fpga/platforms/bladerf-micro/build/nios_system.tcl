@@ -59,6 +59,19 @@ set_instance_parameter_value control {simDoTestBenchWiring} {0}
 set_instance_parameter_value control {simDrivenValue} {0.0}
 set_instance_parameter_value control {width} {32}
 
+add_instance fifo_level_ctl altera_avalon_pio
+set_instance_parameter_value fifo_level_ctl {bitClearingEdgeCapReg} {0}
+set_instance_parameter_value fifo_level_ctl {bitModifyingOutReg} {0}
+set_instance_parameter_value fifo_level_ctl {captureEdge} {0}
+set_instance_parameter_value fifo_level_ctl {direction} {InOut}
+set_instance_parameter_value fifo_level_ctl {edgeType} {RISING}
+set_instance_parameter_value fifo_level_ctl {generateIRQ} {0}
+set_instance_parameter_value fifo_level_ctl {irqType} {LEVEL}
+set_instance_parameter_value fifo_level_ctl {resetValue} {0.0}
+set_instance_parameter_value fifo_level_ctl {simDoTestBenchWiring} {0}
+set_instance_parameter_value fifo_level_ctl {simDrivenValue} {0.0}
+set_instance_parameter_value fifo_level_ctl {width} {32}
+
 add_instance gpio_rffe_0 altera_avalon_pio
 set_instance_parameter_value gpio_rffe_0 {bitClearingEdgeCapReg} {0}
 set_instance_parameter_value gpio_rffe_0 {bitModifyingOutReg} {1}
@@ -285,6 +298,58 @@ set_instance_parameter_value rffe_spi {syncRegDepth} {2}
 set_instance_parameter_value rffe_spi {targetClockRate} {40000000.0}
 set_instance_parameter_value rffe_spi {targetSlaveSelectToSClkDelay} {0.0}
 
+add_instance rx_burst_ctl altera_avalon_pio
+set_instance_parameter_value rx_burst_ctl {bitClearingEdgeCapReg} {0}
+set_instance_parameter_value rx_burst_ctl {bitModifyingOutReg} {0}
+set_instance_parameter_value rx_burst_ctl {captureEdge} {0}
+set_instance_parameter_value rx_burst_ctl {direction} {Output}
+set_instance_parameter_value rx_burst_ctl {edgeType} {RISING}
+set_instance_parameter_value rx_burst_ctl {generateIRQ} {0}
+set_instance_parameter_value rx_burst_ctl {irqType} {LEVEL}
+set_instance_parameter_value rx_burst_ctl {resetValue} {0.0}
+set_instance_parameter_value rx_burst_ctl {simDoTestBenchWiring} {0}
+set_instance_parameter_value rx_burst_ctl {simDrivenValue} {0.0}
+set_instance_parameter_value rx_burst_ctl {width} {32}
+
+add_instance rx_burst_threshold altera_avalon_pio
+set_instance_parameter_value rx_burst_threshold {bitClearingEdgeCapReg} {0}
+set_instance_parameter_value rx_burst_threshold {bitModifyingOutReg} {0}
+set_instance_parameter_value rx_burst_threshold {captureEdge} {0}
+set_instance_parameter_value rx_burst_threshold {direction} {Output}
+set_instance_parameter_value rx_burst_threshold {edgeType} {RISING}
+set_instance_parameter_value rx_burst_threshold {generateIRQ} {0}
+set_instance_parameter_value rx_burst_threshold {irqType} {LEVEL}
+set_instance_parameter_value rx_burst_threshold {resetValue} {0.0}
+set_instance_parameter_value rx_burst_threshold {simDoTestBenchWiring} {0}
+set_instance_parameter_value rx_burst_threshold {simDrivenValue} {0.0}
+set_instance_parameter_value rx_burst_threshold {width} {32}
+
+add_instance rx_ddc_ctl altera_avalon_pio
+set_instance_parameter_value rx_ddc_ctl {bitClearingEdgeCapReg} {0}
+set_instance_parameter_value rx_ddc_ctl {bitModifyingOutReg} {0}
+set_instance_parameter_value rx_ddc_ctl {captureEdge} {0}
+set_instance_parameter_value rx_ddc_ctl {direction} {Output}
+set_instance_parameter_value rx_ddc_ctl {edgeType} {RISING}
+set_instance_parameter_value rx_ddc_ctl {generateIRQ} {0}
+set_instance_parameter_value rx_ddc_ctl {irqType} {LEVEL}
+set_instance_parameter_value rx_ddc_ctl {resetValue} {0.0}
+set_instance_parameter_value rx_ddc_ctl {simDoTestBenchWiring} {0}
+set_instance_parameter_value rx_ddc_ctl {simDrivenValue} {0.0}
+set_instance_parameter_value rx_ddc_ctl {width} {32}
+
+add_instance rx_power_ctl altera_avalon_pio
+set_instance_parameter_value rx_power_ctl {bitClearingEdgeCapReg} {0}
+set_instance_parameter_value rx_power_ctl {bitModifyingOutReg} {0}
+set_instance_parameter_value rx_power_ctl {captureEdge} {0}
+set_instance_parameter_value rx_power_ctl {direction} {InOut}
+set_instance_parameter_value rx_power_ctl {edgeType} {RISING}
+set_instance_parameter_value rx_power_ctl {generateIRQ} {0}
+set_instance_parameter_value rx_power_ctl {irqType} {LEVEL}
+set_instance_parameter_value rx_power_ctl {resetValue} {0.0}
+set_instance_parameter_value rx_power_ctl {simDoTestBenchWiring} {0}
+set_instance_parameter_value rx_power_ctl {simDrivenValue} {0.0}
+set_instance_parameter_value rx_power_ctl {width} {32}
+
 add_instance rx_tamer time_tamer 1.0
 
 add_instance rx_trigger_ctl altera_avalon_pio
@@ -305,6 +370,71 @@ set_instance_parameter_value system_clock {clockFrequency} {80000000.0}
 set_instance_parameter_value system_clock {clockFrequencyKnown} {1}
 set_instance_parameter_value system_clock {resetSynchronousEdges} {DEASSERT}
 
+add_instance trigger_timer_ctl altera_avalon_pio
+set_instance_parameter_value trigger_timer_ctl {bitClearingEdgeCapReg} {0}
+set_instance_parameter_value trigger_timer_ctl {bitModifyingOutReg} {0}
+set_instance_parameter_value trigger_timer_ctl {captureEdge} {0}
+set_instance_parameter_value trigger_timer_ctl {direction} {InOut}
+set_instance_parameter_value trigger_timer_ctl {edgeType} {RISING}
+set_instance_parameter_value trigger_timer_ctl {generateIRQ} {0}
+set_instance_parameter_value trigger_timer_ctl {irqType} {LEVEL}
+set_instance_parameter_value trigger_timer_ctl {resetValue} {0.0}
+set_instance_parameter_value trigger_timer_ctl {simDoTestBenchWiring} {0}
+set_instance_parameter_value trigger_timer_ctl {simDrivenValue} {0.0}
+set_instance_parameter_value trigger_timer_ctl {width} {32}
+
+add_instance trigger_timer_data altera_avalon_pio
+set_instance_parameter_value trigger_timer_data {bitClearingEdgeCapReg} {0}
+set_instance_parameter_value trigger_timer_data {bitModifyingOutReg} {0}
+set_instance_parameter_value trigger_timer_data {captureEdge} {0}
+set_instance_parameter_value trigger_timer_data {direction} {Output}
+set_instance_parameter_value trigger_timer_data {edgeType} {RISING}
+set_instance_parameter_value trigger_timer_data {generateIRQ} {0}
+set_instance_parameter_value trigger_timer_data {irqType} {LEVEL}
+set_instance_parameter_value trigger_timer_data {resetValue} {0.0}
+set_instance_parameter_value trigger_timer_data {simDoTestBenchWiring} {0}
+set_instance_parameter_value trigger_timer_data {simDrivenValue} {0.0}
+set_instance_parameter_value trigger_timer_data {width} {32}
+
+add_instance tx_duc_ctl altera_avalon_pio
+set_instance_parameter_value tx_duc_ctl {bitClearingEdgeCapReg} {0}
+set_instance_parameter_value tx_duc_ctl {bitModifyingOutReg} {0}
+set_instance_parameter_value tx_duc_ctl {captureEdge} {0}
+set_instance_parameter_value tx_duc_ctl {direction} {Output}
+set_instance_parameter_value tx_duc_ctl {edgeType} {RISING}
+set_instance_parameter_value tx_duc_ctl {generateIRQ} {0}
+set_instance_parameter_value tx_duc_ctl {irqType} {LEVEL}
+set_instance_parameter_value tx_duc_ctl {resetValue} {0.0}
+set_instance_parameter_value tx_duc_ctl {simDoTestBenchWiring} {0}
+set_instance_parameter_value tx_duc_ctl {simDrivenValue} {0.0}
+set_instance_parameter_value tx_duc_ctl {width} {32}
+
+add_instance tx_loop_ctl altera_avalon_pio
+set_instance_parameter_value tx_loop_ctl {bitClearingEdgeCapReg} {0}
+set_instance_parameter_value tx_loop_ctl {bitModifyingOutReg} {0}
+set_instance_parameter_value tx_loop_ctl {captureEdge} {0}
+set_instance_parameter_value tx_loop_ctl {direction} {InOut}
+set_instance_parameter_value tx_loop_ctl {edgeType} {RISING}
+set_instance_parameter_value tx_loop_ctl {generateIRQ} {0}
+set_instance_parameter_value tx_loop_ctl {irqType} {LEVEL}
+set_instance_parameter_value tx_loop_ctl {resetValue} {0.0}
+set_instance_parameter_value tx_loop_ctl {simDoTestBenchWiring} {0}
+set_instance_parameter_value tx_loop_ctl {simDrivenValue} {0.0}
+set_instance_parameter_value tx_loop_ctl {width} {32}
+
+add_instance tx_loop_data altera_avalon_pio
+set_instance_parameter_value tx_loop_data {bitClearingEdgeCapReg} {0}
+set_instance_parameter_value tx_loop_data {bitModifyingOutReg} {0}
+set_instance_parameter_value tx_loop_data {captureEdge} {0}
+set_instance_parameter_value tx_loop_data {direction} {Output}
+set_instance_parameter_value tx_loop_data {edgeType} {RISING}
+set_instance_parameter_value tx_loop_data {generateIRQ} {0}
+set_instance_parameter_value tx_loop_data {irqType} {LEVEL}
+set_instance_parameter_value tx_loop_data {resetValue} {0.0}
+set_instance_parameter_value tx_loop_data {simDoTestBenchWiring} {0}
+set_instance_parameter_value tx_loop_data {simDrivenValue} {0.0}
+set_instance_parameter_value tx_loop_data {width} {32}
+
 add_instance tx_tamer time_tamer 1.0
 
 add_instance tx_trigger_ctl altera_avalon_pio
@@ -414,6 +544,8 @@ add_interface command conduit end
 set_interface_property command EXPORT_OF command_uart.rs232
 add_interface dac conduit end
 set_interface_property dac EXPORT_OF peripheral_spi.external
+add_interface fifo_level_ctl conduit end
+set_interface_property fifo_level_ctl EXPORT_OF fifo_level_ctl.external_connection
 add_interface gpio conduit end
 set_interface_property gpio EXPORT_OF control.external_connection
 add_interface gpio_rffe_0 conduit end
@@ -422,12 +554,30 @@ add_interface oc_i2c conduit end
 set_interface_property oc_i2c EXPORT_OF opencores_i2c.conduit_end
 add_interface reset reset sink
 set_interface_property reset EXPORT_OF system_clock.clk_in_reset
+add_interface rx_burst_ctl conduit end
+set_interface_property rx_burst_ctl EXPORT_OF rx_burst_ctl.external_connection
+add_interface rx_burst_threshold conduit end
+set_interface_property rx_burst_threshold EXPORT_OF rx_burst_threshold.external_connection
+add_interface rx_ddc_ctl conduit end
+set_interface_property rx_ddc_ctl EXPORT_OF rx_ddc_ctl.external_connection
+add_interface rx_power_ctl conduit end
+set_interface_property rx_power_ctl EXPORT_OF rx_power_ctl.external_connection
 add_interface rx_tamer conduit end
 set_interface_property rx_tamer EXPORT_OF rx_tamer.conduit_end
 add_interface rx_trigger_ctl conduit end
 set_interface_property rx_trigger_ctl EXPORT_OF rx_trigger_ctl.external_connection
 add_interface spi conduit end
 set_interface_property spi EXPORT_OF rffe_spi.external
+add_interface trigger_timer_ctl conduit end
+set_interface_property trigger_timer_ctl EXPORT_OF trigger_timer_ctl.external_connection
+add_interface trigger_timer_data conduit end
+set_interface_property trigger_timer_data EXPORT_OF trigger_timer_data.external_connection
+add_interface tx_duc_ctl conduit end
+set_interface_property tx_duc_ctl EXPORT_OF tx_duc_ctl.external_connection
+add_interface tx_loop_ctl conduit end
+set_interface_property tx_loop_ctl EXPORT_OF tx_loop_ctl.external_connection
+add_interface tx_loop_data conduit end
+set_interface_property tx_loop_data EXPORT_OF tx_loop_data.external_connection
 add_interface tx_tamer conduit end
 set_interface_property tx_tamer EXPORT_OF tx_tamer.conduit_end
 add_interface tx_trigger_ctl conduit end
@@ -463,6 +613,11 @@ set_connection_parameter_value nios2.data_master/control.s1 arbitrationPriority
 set_connection_parameter_value nios2.data_master/control.s1 baseAddress {0x9040}
 set_connection_parameter_value nios2.data_master/control.s1 defaultConnection {0}
 
+add_connection nios2.data_master fifo_level_ctl.s1
+set_connection_parameter_value nios2.data_master/fifo_level_ctl.s1 arbitrationPriority {1}
+set_connection_parameter_value nios2.data_master/fifo_level_ctl.s1 baseAddress {0x94b0}
+set_connection_parameter_value nios2.data_master/fifo_level_ctl.s1 defaultConnection {0}
+
 add_connection nios2.data_master gpio_rffe_0.s1
 set_connection_parameter_value nios2.data_master/gpio_rffe_0.s1 arbitrationPriority {1}
 set_connection_parameter_value nios2.data_master/gpio_rffe_0.s1 baseAddress {0x9440}
@@ -498,6 +653,26 @@ set_connection_parameter_value nios2.data_master/rffe_spi.spi_control_port arbit
 set_connection_parameter_value nios2.data_master/rffe_spi.spi_control_port baseAddress {0x9200}
 set_connection_parameter_value nios2.data_master/rffe_spi.spi_control_port defaultConnection {0}
 
+add_connection nios2.data_master rx_burst_ctl.s1
+set_connection_parameter_value nios2.data_master/rx_burst_ctl.s1 arbitrationPriority {1}
+set_connection_parameter_value nios2.data_master/rx_burst_ctl.s1 baseAddress {0x9490}
+set_connection_parameter_value nios2.data_master/rx_burst_ctl.s1 defaultConnection {0}
+
+add_connection nios2.data_master rx_burst_threshold.s1
+set_connection_parameter_value nios2.data_master/rx_burst_threshold.s1 arbitrationPriority {1}
+set_connection_parameter_value nios2.data_master/rx_burst_threshold.s1 baseAddress {0x94a0}
+set_connection_parameter_value nios2.data_master/rx_burst_threshold.s1 defaultConnection {0}
+
+add_connection nios2.data_master rx_ddc_ctl.s1
+set_connection_parameter_value nios2.data_master/rx_ddc_ctl.s1 arbitrationPriority {1}
+set_connection_parameter_value nios2.data_master/rx_ddc_ctl.s1 baseAddress {0x9460}
+set_connection_parameter_value nios2.data_master/rx_ddc_ctl.s1 defaultConnection {0}
+
+add_connection nios2.data_master rx_power_ctl.s1
+set_connection_parameter_value nios2.data_master/rx_power_ctl.s1 arbitrationPriority {1}
+set_connection_parameter_value nios2.data_master/rx_power_ctl.s1 baseAddress {0x9480}
+set_connection_parameter_value nios2.data_master/rx_power_ctl.s1 defaultConnection {0}
+
 add_connection nios2.data_master rx_tamer.avalon_slave_0
 set_connection_parameter_value nios2.data_master/rx_tamer.avalon_slave_0 arbitrationPriority {1}
 set_connection_parameter_value nios2.data_master/rx_tamer.avalon_slave_0 baseAddress {0x9160}
@@ -508,6 +683,31 @@ set_connection_parameter_value nios2.data_master/rx_trigger_ctl.s1 arbitrationPr
 set_connection_parameter_value nios2.data_master/rx_trigger_ctl.s1 baseAddress {0x9400}
 set_connection_parameter_value nios2.data_master/rx_trigger_ctl.s1 defaultConnection {0}
 
+add_connection nios2.data_master trigger_timer_ctl.s1
+set_connection_parameter_value nios2.data_master/trigger_timer_ctl.s1 arbitrationPriority {1}
+set_connection_parameter_value nios2.data_master/trigger_timer_ctl.s1 baseAddress {0x94e0}
+set_connection_parameter_value nios2.data_master/trigger_timer_ctl.s1 defaultConnection {0}
+
+add_connection nios2.data_master trigger_timer_data.s1
+set_connection_parameter_value nios2.data_master/trigger_timer_data.s1 arbitrationPriority {1}
+set_connection_parameter_value nios2.data_master/trigger_timer_data.s1 baseAddress {0x94f0}
+set_connection_parameter_value nios2.data_master/trigger_timer_data.s1 defaultConnection {0}
+
+add_connection nios2.data_master tx_duc_ctl.s1
+set_connection_parameter_value nios2.data_master/tx_duc_ctl.s1 arbitrationPriority {1}
+set_connection_parameter_value nios2.data_master/tx_duc_ctl.s1 baseAddress {0x9470}
+set_connection_parameter_value nios2.data_master/tx_duc_ctl.s1 defaultConnection {0}
+
+add_connection nios2.data_master tx_loop_ctl.s1
+set_connection_parameter_value nios2.data_master/tx_loop_ctl.s1 arbitrationPriority {1}
+set_connection_parameter_value nios2.data_master/tx_loop_ctl.s1 baseAddress {0x94c0}
+set_connection_parameter_value nios2.data_master/tx_loop_ctl.s1 defaultConnection {0}
+
+add_connection nios2.data_master tx_loop_data.s1
+set_connection_parameter_value nios2.data_master/tx_loop_data.s1 arbitrationPriority {1}
+set_connection_parameter_value nios2.data_master/tx_loop_data.s1 baseAddress {0x94d0}
+set_connection_parameter_value nios2.data_master/tx_loop_data.s1 defaultConnection {0}
+
 add_connection nios2.data_master tx_tamer.avalon_slave_0
 set_connection_parameter_value nios2.data_master/tx_tamer.avalon_slave_0 arbitrationPriority {1}
 set_connection_parameter_value nios2.data_master/tx_tamer.avalon_slave_0 baseAddress {0x9140}
@@ -583,6 +783,8 @@ add_connection system_clock.clk command_uart.clock
 
 add_connection system_clock.clk control.clk
 
+add_connection system_clock.clk fifo_level_ctl.clk
+
 add_connection system_clock.clk gpio_rffe_0.clk
 
 add_connection system_clock.clk jtag_uart.clk
@@ -597,10 +799,28 @@ add_connection system_clock.clk ram.clk1
 
 add_connection system_clock.clk rffe_spi.clk
 
+add_connection system_clock.clk rx_burst_ctl.clk
+
+add_connection system_clock.clk rx_burst_threshold.clk
+
+add_connection system_clock.clk rx_ddc_ctl.clk
+
+add_connection system_clock.clk rx_power_ctl.clk
+
 add_connection system_clock.clk rx_tamer.clock_sink
 
 add_connection system_clock.clk rx_trigger_ctl.clk
 
+add_connection system_clock.clk trigger_timer_ctl.clk
+
+add_connection system_clock.clk trigger_timer_data.clk
+
+add_connection system_clock.clk tx_duc_ctl.clk
+
+add_connection system_clock.clk tx_loop_ctl.clk
+
+add_connection system_clock.clk tx_loop_data.clk
+
 add_connection system_clock.clk tx_tamer.clock_sink
 
 add_connection system_clock.clk tx_trigger_ctl.clk
@@ -619,6 +839,8 @@ add_connection system_clock.clk_reset command_uart.reset
 
 add_connection system_clock.clk_reset control.reset
 
+add_connection system_clock.clk_reset fifo_level_ctl.reset
+
 add_connection system_clock.clk_reset gpio_rffe_0.reset
 
 add_connection system_clock.clk_reset jtag_uart.reset
@@ -633,10 +855,28 @@ add_connection system_clock.clk_reset ram.reset1
 
 add_connection system_clock.clk_reset rffe_spi.reset
 
+add_connection system_clock.clk_reset rx_burst_ctl.reset
+
+add_connection system_clock.clk_reset rx_burst_threshold.reset
+
+add_connection system_clock.clk_reset rx_ddc_ctl.reset
+
+add_connection system_clock.clk_reset rx_power_ctl.reset
+
 add_connection system_clock.clk_reset rx_tamer.reset
 
 add_connection system_clock.clk_reset rx_trigger_ctl.reset
 
+add_connection system_clock.clk_reset trigger_timer_ctl.reset
+
+add_connection system_clock.clk_reset trigger_timer_data.reset
+
+add_connection system_clock.clk_reset tx_duc_ctl.reset
+
+add_connection system_clock.clk_reset tx_loop_ctl.reset
+
+add_connection system_clock.clk_reset tx_loop_data.reset
+
 add_connection system_clock.clk_reset tx_tamer.reset
 
 add_connection system_clock.clk_reset tx_trigger_ctl.reset
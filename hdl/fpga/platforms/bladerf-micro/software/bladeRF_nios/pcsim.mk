@@ -2,11 +2,20 @@
 #              VARIABLES TO BE DEFINED BY PLATFORM MAKEFILE
 #------------------------------------------------------------------------------
 
-FPGA_COMMON_DIR    := ../../../../../../fpga_common
-BLADERF_COMMON_DIR := ../../../common/bladerf/software/bladeRF_nios
+FPGA_COMMON_DIR     := ../../../../../../fpga_common
+LIBBLADERF_DIR      := ../../../../../../host/libraries/libbladeRF
+BLADERF_COMMON_DIR  := ../../../common/bladerf/software/bladeRF_nios
+FIRMWARE_COMMON_DIR := ../../../../../../firmware_common
 
-QUARTUS_WORKDIR    := ../../../../../quartus/work/bladerf-micro
-NIOS_BUILD_OUTDIR  := $(QUARTUS_WORKDIR)/bladeRF_nios
+QUARTUS_WORKDIR     := ../../../../../quartus/work/bladerf-micro
+NIOS_BUILD_OUTDIR   := $(QUARTUS_WORKDIR)/bladeRF_nios
+
+PCSIM_MAIN          := ./src/bladeRF_nios.c
+
+PCSIM_SRCS          += $(FPGA_COMMON_DIR)/src/band_select.c
+PCSIM_SRCS          += $(BLADERF_COMMON_DIR)/src/pkt_retune2.c
+
+PCSIM_CFLAGS        += -DBOARD_BLADERF_MICRO
 
 #------------------------------------------------------------------------------
 #              INCLUDE THE COMMON MAKEFILE
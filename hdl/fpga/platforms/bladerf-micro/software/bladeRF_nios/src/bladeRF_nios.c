@@ -45,6 +45,7 @@
 #include "pkt_32x32.h"
 #include "pkt_retune2.h"
 #include "pkt_legacy.h"
+#include "pkt_ts_latch.h"
 #include "debug.h"
 
 #define BLADERF_DEVICE_NAME "Nuand bladeRF 2.0 Micro"
@@ -89,10 +90,15 @@ static const struct pkt_handler pkt_handlers[] = {
     PKT_8x32,
     PKT_8x64,
     PKT_16x64,
+    PKT_16x8_BATCH,
     PKT_32x32,
     PKT_LEGACY,
+    PKT_TS_LATCH,
 };
 
+/* Handlers indexed by magic value, populated from pkt_handlers[] */
+static struct pkt_dispatch pkt_dispatch;
+
 /* A structure that represents a point on a line. Used for calibrating
  * the VCTCXO */
 typedef struct point {
@@ -124,8 +130,6 @@ int main(void)
     DBG("libad936x found: This FPGA image has magic transgirl powers\n");
 #endif  // BLADERF_NIOS_LIBAD936X
 
-    uint8_t i;
-
     /* Pointer to currently active packet handler */
     const struct pkt_handler *handler;
 
@@ -176,16 +180,13 @@ int main(void)
     bladerf_nios_init(&pkt, &vctcxo_tamer_pkt);
 
     /* Initialize packet handlers */
-    for (i = 0; i < ARRAY_SIZE(pkt_handlers); i++) {
-        if (pkt_handlers[i].init != NULL) {
-            pkt_handlers[i].init();
-        }
-    }
+    pkt_dispatch_init(&pkt_dispatch, pkt_handlers, ARRAY_SIZE(pkt_handlers));
 
     /* ====================
      * AD9361 SPI TESTS
      * ==================== */
     #ifdef BLADERF_NIOS_AD9361_SPI_TESTS
+        uint8_t i;
         uint16_t adi_spi_addr;
         uint64_t adi_spi_data;
 
@@ -227,6 +228,7 @@ int main(void)
      * AD5621 SPI TESTS
      * ==================== */
     #ifdef BLADERF_NIOS_AD5621_SPI_TESTS
+        uint8_t i;
         uint16_t dac_val;
 
         // Disable the ADF400x
@@ -251,6 +253,8 @@ int main(void)
      * ADF4001 SPI TESTS
      * ==================== */
     #ifdef BLADERF_NIOS_ADF4001_SPI_TESTS
+        uint8_t i;
+
         // Tristate the DAC
         ad56x1_vctcxo_trim_dac_write( 0xc000 );
         while( 1 ) {
@@ -320,14 +324,9 @@ int main(void)
         /* We have a command in the UART */
         if (have_request) {
             pkt.ready = false;
-            handler = NULL;
 
             /* Determine which packet handler should receive this message */
-            for (i = 0; i < ARRAY_SIZE(pkt_handlers); i++) {
-                if (pkt_handlers[i].magic == *magic) {
-                    handler = &pkt_handlers[i];
-                }
-            }
+            handler = pkt_dispatch_lookup(&pkt_dispatch, *magic);
 
             if (handler == NULL) {
                 /* We somehow got out of sync. Throw away request data until
@@ -439,11 +438,7 @@ int main(void)
 
             } /* VCTCXO Tamer interrupt */
 
-            for (i = 0; i < ARRAY_SIZE(pkt_handlers); i++) {
-                if (pkt_handlers[i].do_work != NULL) {
-                    pkt_handlers[i].do_work();
-                }
-            }
+            pkt_dispatch_work(&pkt_dispatch);
         }
     }
 
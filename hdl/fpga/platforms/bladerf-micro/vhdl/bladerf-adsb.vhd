@@ -408,7 +408,11 @@ begin
             rx_trigger_ctl_out_port         => rx_trigger_ctl_i,
             tx_trigger_ctl_out_port         => tx_trigger_ctl_i,
             rx_trigger_ctl_in_port          => pack(rx_trigger_ctl),
-            tx_trigger_ctl_in_port          => pack(tx_trigger_ctl)
+            tx_trigger_ctl_in_port          => pack(tx_trigger_ctl),
+            rx_power_ctl_in_port            => (others => '0'),
+            fifo_level_ctl_in_port          => (others => '0'),
+            tx_loop_ctl_in_port             => (others => '0'),
+            trigger_timer_ctl_in_port       => (others => '0')
         );
 
     -- FX3 UART
@@ -242,6 +242,20 @@ architecture foxhunt_bladerf of bladerf is
         tx_trigger_ctl_out_port         :   out std_logic_vector(7 downto 0);
         rx_trigger_ctl_in_port          :   in  std_logic_vector(7 downto 0);
         rx_trigger_ctl_out_port         :   out std_logic_vector(7 downto 0);
+        rx_ddc_ctl_export               :   out std_logic_vector(31 downto 0);
+        rx_power_ctl_in_port            :   in  std_logic_vector(31 downto 0);
+        rx_power_ctl_out_port           :   out std_logic_vector(31 downto 0);
+        rx_burst_ctl_export             :   out std_logic_vector(31 downto 0);
+        rx_burst_threshold_export       :   out std_logic_vector(31 downto 0);
+        fifo_level_ctl_in_port          :   in  std_logic_vector(31 downto 0);
+        fifo_level_ctl_out_port         :   out std_logic_vector(31 downto 0);
+        tx_duc_ctl_export               :   out std_logic_vector(31 downto 0);
+        tx_loop_ctl_in_port             :   in  std_logic_vector(31 downto 0);
+        tx_loop_ctl_out_port            :   out std_logic_vector(31 downto 0);
+        tx_loop_data_export             :   out std_logic_vector(31 downto 0);
+        trigger_timer_ctl_in_port       :   in  std_logic_vector(31 downto 0);
+        trigger_timer_ctl_out_port      :   out std_logic_vector(31 downto 0);
+        trigger_timer_data_export       :   out std_logic_vector(31 downto 0);
         tonegen_sample_valid            :   out std_logic;
         tonegen_sample_i                :   out std_logic_vector(15 downto 0);
         tonegen_sample_q                :   out std_logic_vector(15 downto 0);
@@ -497,6 +511,16 @@ begin
             tx_trigger_ctl_out_port         => tx_trigger_ctl_i,
             rx_trigger_ctl_in_port          => pack(rx_trigger_ctl),
             tx_trigger_ctl_in_port          => pack(tx_trigger_ctl),
+            rx_power_ctl_in_port            => (others => '0'),
+            rx_power_ctl_out_port           => open,
+            fifo_level_ctl_in_port          => (others => '0'),
+            fifo_level_ctl_out_port         => open,
+            tx_loop_ctl_in_port             => (others => '0'),
+            tx_loop_ctl_out_port            => open,
+            tx_loop_data_export             => open,
+            trigger_timer_ctl_in_port       => (others => '0'),
+            trigger_timer_ctl_out_port      => open,
+            trigger_timer_data_export       => open,
 
             tonegen_sample_clk              => tx_clock,
             tonegen_sample_valid            => tonegen_sample_v,
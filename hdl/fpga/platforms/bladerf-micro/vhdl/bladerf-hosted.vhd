@@ -91,6 +91,9 @@ architecture hosted_bladerf of bladerf is
     signal packet_en_tx           : std_logic;
     signal packet_en_rx           : std_logic;
 
+    signal eight_bit_en_tx        : std_logic;
+    signal eight_bit_en_rx        : std_logic;
+
     signal tx_timestamp           : unsigned(63 downto 0);
     signal rx_timestamp           : unsigned(63 downto 0);
     signal timestamp_sync         : std_logic;
@@ -127,6 +130,40 @@ architecture hosted_bladerf of bladerf is
 
     signal rx_trigger_ctl_i       : std_logic_vector(7 downto 0);
     signal rx_trigger_ctl         : trigger_t := TRIGGER_T_DEFAULT;
+
+    signal rx_ddc_ctl_i           : std_logic_vector(31 downto 0);
+    signal rx_ddc_ctl             : std_logic_vector(31 downto 0);
+
+    signal rx_power_ctl_i         : std_logic_vector(31 downto 0);
+    signal rx_power_ctl           : std_logic_vector(31 downto 0);
+    signal rx_power_data          : std_logic_vector(31 downto 0);
+
+    signal rx_burst_ctl_i         : std_logic_vector(31 downto 0);
+    signal rx_burst_ctl           : std_logic_vector(31 downto 0);
+    signal rx_burst_threshold_i   : std_logic_vector(31 downto 0);
+    signal rx_burst_threshold     : std_logic_vector(31 downto 0);
+
+    signal fifo_level_ctl_i       : std_logic_vector(31 downto 0);
+    signal fifo_level_ctl         : std_logic_vector(31 downto 0);
+    signal fifo_level_data        : std_logic_vector(31 downto 0);
+
+    signal tx_duc_ctl_i           : std_logic_vector(31 downto 0);
+    signal tx_duc_ctl             : std_logic_vector(31 downto 0);
+
+    signal tx_loop_ctl_i          : std_logic_vector(31 downto 0);
+    signal tx_loop_ctl            : std_logic_vector(31 downto 0);
+    signal tx_loop_data_i         : std_logic_vector(31 downto 0);
+    signal tx_loop_data           : std_logic_vector(31 downto 0);
+    signal tx_loop_rdata          : std_logic_vector(31 downto 0);
+
+    signal trigger_timer_ctl_i    : std_logic_vector(31 downto 0);
+    signal trigger_timer_ctl      : std_logic_vector(31 downto 0);
+    signal trigger_timer_data_i   : std_logic_vector(31 downto 0);
+    signal trigger_timer_data     : std_logic_vector(31 downto 0);
+    signal trigger_timer_rdata    : std_logic_vector(31 downto 0);
+    signal rx_trigger_timer_rdata : std_logic_vector(31 downto 0);
+    signal tx_trigger_timer_rdata : std_logic_vector(31 downto 0);
+
     alias  rx_trigger_line        : std_logic is mini_exp1;
 
     signal tx_trigger_ctl_i       : std_logic_vector(7 downto 0);
@@ -317,6 +354,24 @@ begin
 
     fx3_ctl_in <= fx3_ctl;
 
+    -- Sample FIFO fill levels, as seen by the GPIF
+    U_fifo_level_monitor : entity work.fifo_level_monitor
+        generic map (
+            RX_USED_WIDTH       =>  rx_sample_fifo.rused'length,
+            TX_USED_WIDTH       =>  tx_sample_fifo.wused'length
+        )
+        port map (
+            clock               =>  fx3_pclk_pll,
+            reset               =>  sys_reset_pclk,
+            clear               =>  fifo_level_ctl(8),
+            field               =>  unsigned(fifo_level_ctl(1 downto 0)),
+            rx_used             =>  rx_sample_fifo.rused,
+            rx_full             =>  rx_sample_fifo.rfull,
+            tx_used             =>  tx_sample_fifo.wused,
+            tx_full             =>  tx_sample_fifo.wfull,
+            data                =>  fifo_level_data
+        );
+
     toggle_led1 : process(fx3_pclk_pll)
         variable count : natural range 0 to 10_000_000 := 10_000_000;
     begin
@@ -419,6 +474,20 @@ begin
             tx_tamer_ts_reset               => tx_ts_reset,
             unsigned(tx_tamer_ts_time)      => tx_timestamp,
             rx_trigger_ctl_out_port         => rx_trigger_ctl_i,
+            rx_ddc_ctl_export               => rx_ddc_ctl_i,
+            rx_power_ctl_out_port           => rx_power_ctl_i,
+            rx_power_ctl_in_port            => rx_power_data,
+            rx_burst_ctl_export             => rx_burst_ctl_i,
+            rx_burst_threshold_export       => rx_burst_threshold_i,
+            fifo_level_ctl_out_port         => fifo_level_ctl_i,
+            fifo_level_ctl_in_port          => fifo_level_data,
+            tx_duc_ctl_export               => tx_duc_ctl_i,
+            tx_loop_ctl_out_port            => tx_loop_ctl_i,
+            tx_loop_ctl_in_port             => tx_loop_rdata,
+            tx_loop_data_export             => tx_loop_data_i,
+            trigger_timer_ctl_out_port      => trigger_timer_ctl_i,
+            trigger_timer_ctl_in_port       => trigger_timer_rdata,
+            trigger_timer_data_export       => trigger_timer_data_i,
             tx_trigger_ctl_out_port         => tx_trigger_ctl_i,
             rx_trigger_ctl_in_port          => pack(rx_trigger_ctl),
             tx_trigger_ctl_in_port          => pack(tx_trigger_ctl)
@@ -513,16 +582,30 @@ begin
             tx_enable            => tx_enable,
 
             meta_en              => meta_en_tx,
+            eight_bit_en         => eight_bit_en_tx,
             timestamp_reset      => tx_ts_reset,
             usb_speed            => usb_speed_tx,
             tx_underflow_led     => tx_underflow_led,
             tx_timestamp         => tx_timestamp,
 
+            -- Digital upconverter
+            duc_enable             => tx_duc_ctl(31),
+            duc_log2_interp        => unsigned(tx_duc_ctl(26 downto 24)),
+            duc_dphase             => signed(tx_duc_ctl(23 downto 0)),
+
+            -- Waveform loop
+            loop_ctl             => tx_loop_ctl,
+            loop_wdata           => tx_loop_data,
+            loop_rdata           => tx_loop_rdata,
+
             -- Triggering
             trigger_arm          => tx_trigger_ctl.arm,
             trigger_fire         => tx_trigger_ctl.fire,
             trigger_master       => tx_trigger_ctl.master,
             trigger_line         => tx_trigger_line,
+            trigger_timer_ctl    => trigger_timer_ctl,
+            trigger_timer_wdata  => trigger_timer_data,
+            trigger_timer_rdata  => tx_trigger_timer_rdata,
 
             -- Packet FIFO
             packet_en            => packet_en_tx,
@@ -585,17 +668,41 @@ begin
             rx_enable              => rx_enable,
 
             meta_en                => meta_en_rx,
+            eight_bit_en           => eight_bit_en_rx,
             timestamp_reset        => rx_ts_reset,
             usb_speed              => usb_speed_rx,
             rx_mux_sel             => rx_mux_sel,
             rx_overflow_led        => rx_overflow_led,
             rx_timestamp           => rx_timestamp,
 
+            -- Digital downconverter
+            ddc_enable             => rx_ddc_ctl(31),
+            ddc_log2_decimation    => unsigned(rx_ddc_ctl(26 downto 24)),
+            ddc_dphase             => signed(rx_ddc_ctl(23 downto 0)),
+
+            -- Power detector
+            power_enable           => rx_power_ctl(31),
+            power_log2_length      => unsigned(rx_power_ctl(28 downto 24)),
+            power_channel          => rx_power_ctl(8),
+            power_field            => unsigned(rx_power_ctl(1 downto 0)),
+            power_data             => rx_power_data,
+
+            -- Burst gate
+            burst_enable           => rx_burst_ctl(31),
+            burst_channel          => rx_burst_ctl(16),
+            burst_threshold        => unsigned(rx_burst_threshold),
+            burst_hangover         => unsigned(rx_burst_ctl(15 downto 0)),
+            burst_pretrigger       => unsigned(rx_burst_ctl(26 downto 17)),
+            burst_averaging        => unsigned(rx_burst_ctl(30 downto 27)),
+
             -- Triggering
             trigger_arm            => rx_trigger_ctl.arm,
             trigger_fire           => rx_trigger_ctl.fire,
             trigger_master         => rx_trigger_ctl.master,
             trigger_line           => rx_trigger_line,
+            trigger_timer_ctl      => trigger_timer_ctl,
+            trigger_timer_wdata    => trigger_timer_data,
+            trigger_timer_rdata    => rx_trigger_timer_rdata,
 
             -- Packet FIFO
             packet_en              => packet_en_rx,
@@ -812,6 +919,28 @@ begin
             sync                =>  packet_en_tx
         );
 
+    U_sync_eight_bit_en_rx : entity work.synchronizer
+        generic map (
+            RESET_LEVEL         =>  '0'
+        )
+        port map (
+            reset               =>  '0',
+            clock               =>  rx_clock,
+            async               =>  nios_gpio.o.eight_bit_en,
+            sync                =>  eight_bit_en_rx
+        );
+
+    U_sync_eight_bit_en_tx : entity work.synchronizer
+        generic map (
+            RESET_LEVEL         =>  '0'
+        )
+        port map (
+            reset               =>  '0',
+            clock               =>  tx_clock,
+            async               =>  nios_gpio.o.eight_bit_en,
+            sync                =>  eight_bit_en_tx
+        );
+
     generate_sync_rx_mux_sel : for i in rx_mux_sel'range generate
         U_sync_rx_mux_sel : entity work.synchronizer
             generic map (
@@ -825,6 +954,141 @@ begin
             );
     end generate;
 
+    generate_sync_rx_ddc_ctl : for i in rx_ddc_ctl'range generate
+        U_sync_rx_ddc_ctl : entity work.synchronizer
+            generic map (
+                RESET_LEVEL         =>  '0'
+            )
+            port map (
+                reset               =>  '0',
+                clock               =>  rx_clock,
+                async               =>  rx_ddc_ctl_i(i),
+                sync                =>  rx_ddc_ctl(i)
+            );
+    end generate;
+
+    generate_sync_rx_power_ctl : for i in rx_power_ctl'range generate
+        U_sync_rx_power_ctl : entity work.synchronizer
+            generic map (
+                RESET_LEVEL         =>  '0'
+            )
+            port map (
+                reset               =>  '0',
+                clock               =>  rx_clock,
+                async               =>  rx_power_ctl_i(i),
+                sync                =>  rx_power_ctl(i)
+            );
+    end generate;
+
+    generate_sync_rx_burst_ctl : for i in rx_burst_ctl'range generate
+        U_sync_rx_burst_ctl : entity work.synchronizer
+            generic map (
+                RESET_LEVEL         =>  '0'
+            )
+            port map (
+                reset               =>  '0',
+                clock               =>  rx_clock,
+                async               =>  rx_burst_ctl_i(i),
+                sync                =>  rx_burst_ctl(i)
+            );
+    end generate;
+
+    generate_sync_rx_burst_threshold : for i in rx_burst_threshold'range generate
+        U_sync_rx_burst_threshold : entity work.synchronizer
+            generic map (
+                RESET_LEVEL         =>  '0'
+            )
+            port map (
+                reset               =>  '0',
+                clock               =>  rx_clock,
+                async               =>  rx_burst_threshold_i(i),
+                sync                =>  rx_burst_threshold(i)
+            );
+    end generate;
+
+    generate_sync_fifo_level_ctl : for i in fifo_level_ctl'range generate
+        U_sync_fifo_level_ctl : entity work.synchronizer
+            generic map (
+                RESET_LEVEL         =>  '0'
+            )
+            port map (
+                reset               =>  '0',
+                clock               =>  fx3_pclk_pll,
+                async               =>  fifo_level_ctl_i(i),
+                sync                =>  fifo_level_ctl(i)
+            );
+    end generate;
+
+    generate_sync_tx_duc_ctl : for i in tx_duc_ctl'range generate
+        U_sync_tx_duc_ctl : entity work.synchronizer
+            generic map (
+                RESET_LEVEL         =>  '0'
+            )
+            port map (
+                reset               =>  '0',
+                clock               =>  tx_clock,
+                async               =>  tx_duc_ctl_i(i),
+                sync                =>  tx_duc_ctl(i)
+            );
+    end generate;
+
+    generate_sync_tx_loop_ctl : for i in tx_loop_ctl'range generate
+        U_sync_tx_loop_ctl : entity work.synchronizer
+            generic map (
+                RESET_LEVEL         =>  '0'
+            )
+            port map (
+                reset               =>  '0',
+                clock               =>  tx_clock,
+                async               =>  tx_loop_ctl_i(i),
+                sync                =>  tx_loop_ctl(i)
+            );
+    end generate;
+
+    generate_sync_tx_loop_data : for i in tx_loop_data'range generate
+        U_sync_tx_loop_data : entity work.synchronizer
+            generic map (
+                RESET_LEVEL         =>  '0'
+            )
+            port map (
+                reset               =>  '0',
+                clock               =>  tx_clock,
+                async               =>  tx_loop_data_i(i),
+                sync                =>  tx_loop_data(i)
+            );
+    end generate;
+
+    -- The RX and TX trigger timers share the AD9361 clock, and ctl(4)
+    -- selects which of them is read back
+    generate_sync_trigger_timer_ctl : for i in trigger_timer_ctl'range generate
+        U_sync_trigger_timer_ctl : entity work.synchronizer
+            generic map (
+                RESET_LEVEL         =>  '0'
+            )
+            port map (
+                reset               =>  '0',
+                clock               =>  rx_clock,
+                async               =>  trigger_timer_ctl_i(i),
+                sync                =>  trigger_timer_ctl(i)
+            );
+    end generate;
+
+    generate_sync_trigger_timer_data : for i in trigger_timer_data'range generate
+        U_sync_trigger_timer_data : entity work.synchronizer
+            generic map (
+                RESET_LEVEL         =>  '0'
+            )
+            port map (
+                reset               =>  '0',
+                clock               =>  rx_clock,
+                async               =>  trigger_timer_data_i(i),
+                sync                =>  trigger_timer_data(i)
+            );
+    end generate;
+
+    trigger_timer_rdata <= tx_trigger_timer_rdata when trigger_timer_ctl_i(4) = '1' else
+                           rx_trigger_timer_rdata;
+
     generate_sync_mimo_rx_en : for i in mimo_rx_enables'range generate
         U_sync_mimo_rx_en : entity work.synchronizer
             generic map (
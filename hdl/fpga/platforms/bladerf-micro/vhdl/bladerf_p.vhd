@@ -138,6 +138,20 @@ package bladerf_p is
         tx_trigger_ctl_out_port         :   out std_logic_vector(7 downto 0);
         rx_trigger_ctl_in_port          :   in  std_logic_vector(7 downto 0);
         rx_trigger_ctl_out_port         :   out std_logic_vector(7 downto 0);
+        rx_ddc_ctl_export               :   out std_logic_vector(31 downto 0);
+        rx_power_ctl_in_port            :   in  std_logic_vector(31 downto 0);
+        rx_power_ctl_out_port           :   out std_logic_vector(31 downto 0);
+        rx_burst_ctl_export             :   out std_logic_vector(31 downto 0);
+        rx_burst_threshold_export       :   out std_logic_vector(31 downto 0);
+        fifo_level_ctl_in_port          :   in  std_logic_vector(31 downto 0);
+        fifo_level_ctl_out_port         :   out std_logic_vector(31 downto 0);
+        tx_duc_ctl_export               :   out std_logic_vector(31 downto 0);
+        tx_loop_ctl_in_port             :   in  std_logic_vector(31 downto 0);
+        tx_loop_ctl_out_port            :   out std_logic_vector(31 downto 0);
+        tx_loop_data_export             :   out std_logic_vector(31 downto 0);
+        trigger_timer_ctl_in_port       :   in  std_logic_vector(31 downto 0);
+        trigger_timer_ctl_out_port      :   out std_logic_vector(31 downto 0);
+        trigger_timer_data_export       :   out std_logic_vector(31 downto 0);
         arbiter_request                 :   in  std_logic_vector(1 downto 0)  := (others => 'X');
         arbiter_granted                 :   out std_logic_vector(1 downto 0);
         arbiter_ack                     :   in  std_logic_vector(1 downto 0)  := (others => 'X')
@@ -288,6 +302,7 @@ package bladerf_p is
 
     type nios_gpo_t is record
         xb_mode         : std_logic_vector(1 downto 0);
+        eight_bit_en    : std_logic;
         packet_en       : std_logic;
         si_clock_sel    : std_logic;
         ufl_clock_oe    : std_logic;
@@ -499,6 +514,7 @@ package body bladerf_p is
         variable rv : std_logic_vector(31 downto 0) := (others => 'U');
     begin
         rv(31 downto 30) := x.xb_mode;
+        rv(20)           := x.eight_bit_en;
         rv(19)           := x.packet_en;
         rv(18)           := x.si_clock_sel;
         rv(17)           := x.ufl_clock_oe;
@@ -577,6 +593,7 @@ package body bladerf_p is
         variable rv : nios_gpo_t;
     begin
         rv.xb_mode         := x(31 downto 30);
+        rv.eight_bit_en    := x(20);
         rv.packet_en       := x(19);
         rv.si_clock_sel    := x(18);
         rv.ufl_clock_oe    := x(17);
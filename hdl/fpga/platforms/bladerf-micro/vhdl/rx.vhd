@@ -36,17 +36,41 @@ entity rx is
         rx_enable              : in    std_logic;
 
         meta_en                : in    std_logic := '0';
+        eight_bit_en           : in    std_logic := '0';
         timestamp_reset        : out   std_logic := '1';
         usb_speed              : in    std_logic;
         rx_mux_sel             : in    unsigned;
         rx_overflow_led        : out   std_logic := '1';
         rx_timestamp           : in    unsigned(63 downto 0);
 
+        -- Digital downconverter
+        ddc_enable             : in    std_logic := '0';
+        ddc_log2_decimation    : in    unsigned(2 downto 0) := (others => '0');
+        ddc_dphase             : in    signed(23 downto 0) := (others => '0');
+
+        -- Power detector
+        power_enable           : in    std_logic := '0';
+        power_log2_length      : in    unsigned(4 downto 0) := (others => '0');
+        power_channel          : in    std_logic := '0';
+        power_field            : in    unsigned(1 downto 0) := (others => '0');
+        power_data             : out   std_logic_vector(31 downto 0);
+
+        -- Burst gate
+        burst_enable           : in    std_logic := '0';
+        burst_channel          : in    std_logic := '0';
+        burst_threshold        : in    unsigned(31 downto 0) := (others => '0');
+        burst_hangover         : in    unsigned(15 downto 0) := (others => '0');
+        burst_pretrigger       : in    unsigned(9 downto 0) := (others => '0');
+        burst_averaging        : in    unsigned(3 downto 0) := (others => '0');
+
         -- Triggering
         trigger_arm            : in    std_logic;
         trigger_fire           : in    std_logic;
         trigger_master         : in    std_logic;
         trigger_line           : inout std_logic; -- this is not good, should be in/out/oe
+        trigger_timer_ctl      : in    std_logic_vector(31 downto 0) := (others => '0');
+        trigger_timer_wdata    : in    std_logic_vector(31 downto 0) := (others => '0');
+        trigger_timer_rdata    : out   std_logic_vector(31 downto 0);
 
         -- Packet to host via FX3
         packet_en              : in    std_logic;
@@ -119,14 +143,28 @@ architecture arch of rx is
 
     signal mux_streams              : sample_streams_t(adc_streams'range) := (others => ZERO_SAMPLE);
 
+    signal ddc_streams              : sample_streams_t(adc_streams'range) := (others => ZERO_SAMPLE);
+    signal ddc_timestamp            : unsigned(63 downto 0);
+
+    signal burst_packet             : packet_control_t    := PACKET_CONTROL_DEFAULT;
+    signal burst_timestamp          : unsigned(63 downto 0);
+    signal writer_packet            : packet_control_t    := PACKET_CONTROL_DEFAULT;
+    signal writer_timestamp         : unsigned(63 downto 0);
+
     signal trigger_signal_out       : std_logic;
     signal trigger_signal_out_sync  : std_logic;
+    signal trigger_timer_fire       : std_logic;
+    signal trigger_fired            : std_logic;
 
 begin
 
     rx_mux_mode            <= rx_mux_mode_t'val(to_integer(rx_mux_sel));
     loopback_fifo_wenabled <= loopback_fifo_wenabled_i;
 
+    -- The burst gate replaces the external packet source when enabled
+    writer_packet    <= burst_packet when burst_enable = '1' else packet_control;
+    writer_timestamp <= burst_timestamp when (burst_enable = '1' and packet_en = '1') else ddc_timestamp;
+
     set_timestamp_reset : process(rx_clock, rx_reset)
     begin
         if( rx_reset = '1' ) then
@@ -234,8 +272,9 @@ begin
 
             usb_speed           =>  usb_speed,
             meta_en             =>  meta_en,
+            eight_bit_en        =>  eight_bit_en,
             packet_en           =>  packet_en,
-            timestamp           =>  rx_timestamp,
+            timestamp           =>  writer_timestamp,
             mini_exp            =>  mini_exp,
 
             fifo_full           =>  sample_fifo.wfull,
@@ -243,7 +282,7 @@ begin
             fifo_data           =>  sample_fifo.wdata,
             fifo_write          =>  sample_fifo.wreq,
 
-            packet_control      =>  packet_control,
+            packet_control      =>  writer_packet,
             packet_ready        =>  packet_ready,
 
             meta_fifo_full      =>  meta_fifo.wfull,
@@ -252,7 +291,7 @@ begin
             meta_fifo_write     =>  meta_fifo.wreq,
 
             in_sample_controls  =>  adc_controls,
-            in_samples          =>  mux_streams,
+            in_samples          =>  ddc_streams,
 
             overflow_led        =>  rx_overflow_led,
             overflow_count      =>  open,
@@ -260,6 +299,74 @@ begin
         );
 
 
+    -- Digital downconverter
+    U_rx_ddc : entity work.rx_ddc
+        generic map (
+            NUM_STREAMS         => NUM_STREAMS
+        )
+        port map (
+            clock               =>  rx_clock,
+            reset               =>  rx_reset,
+
+            enable              =>  ddc_enable,
+            log2_decimation     =>  ddc_log2_decimation,
+            dphase              =>  ddc_dphase,
+
+            in_timestamp        =>  rx_timestamp,
+            in_streams          =>  mux_streams,
+
+            out_timestamp       =>  ddc_timestamp,
+            out_streams         =>  ddc_streams
+        );
+
+
+    -- Power detector, measuring the samples that would be sent to the host
+    U_rx_power : entity work.rx_power
+        generic map (
+            NUM_STREAMS         => NUM_STREAMS
+        )
+        port map (
+            clock               =>  rx_clock,
+            reset               =>  rx_reset,
+
+            enable              =>  power_enable,
+            log2_length         =>  power_log2_length,
+
+            in_streams          =>  ddc_streams,
+
+            channel             =>  power_channel,
+            field               =>  power_field,
+            data                =>  power_data
+        );
+
+
+    -- Burst gate, packetizing samples only while a signal is present
+    U_rx_burst_gate : entity work.rx_burst_gate
+        generic map (
+            NUM_STREAMS         => NUM_STREAMS,
+            HISTORY_BITS        => burst_pretrigger'length
+        )
+        port map (
+            clock               =>  rx_clock,
+            reset               =>  rx_reset,
+
+            enable              =>  burst_enable,
+            channel             =>  burst_channel,
+            threshold           =>  burst_threshold,
+            hangover            =>  burst_hangover,
+            pretrigger          =>  burst_pretrigger,
+            averaging           =>  burst_averaging,
+            usb_speed           =>  usb_speed,
+
+            in_timestamp        =>  ddc_timestamp,
+            in_streams          =>  ddc_streams,
+
+            packet_ready        =>  packet_ready,
+            packet_control      =>  burst_packet,
+            out_timestamp       =>  burst_timestamp
+        );
+
+
     loopback_fifo_control : process( rx_reset, loopback_fifo.rclock )
         variable offset     : natural range 0 to loopback_fifo.rdata'length;
         variable remaining  : natural range 0 to loopback_fifo.rdata'length/32;
@@ -376,13 +483,31 @@ begin
 
 
     -- RX Trigger
+    U_rx_trigger_timer : entity work.trigger_timer
+        generic map (
+            SELECT_VALUE    => '0'
+        )
+        port map (
+            clock           => rx_clock,
+            reset           => rx_reset,
+            ctl             => trigger_timer_ctl,
+            wdata           => trigger_timer_wdata,
+            rdata           => trigger_timer_rdata,
+            timestamp       => rx_timestamp,
+            armed           => trigger_arm,
+            trigger_line    => trigger_line,
+            fire            => trigger_timer_fire
+        );
+
+    trigger_fired <= trigger_fire or trigger_timer_fire;
+
     rxtrig : entity work.trigger(async)
         generic map (
             DEFAULT_OUTPUT  => '0'
         )
         port map (
             armed           => trigger_arm,       -- in  sl
-            fired           => trigger_fire,      -- in  sl
+            fired           => trigger_fired,     -- in  sl
             master          => trigger_master,    -- in  sl
             trigger_in      => trigger_line,      -- in  sl
             trigger_out     => trigger_line,      -- out sl
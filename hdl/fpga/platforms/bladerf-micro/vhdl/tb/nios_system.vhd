@@ -94,6 +94,20 @@ entity nios_system is
         rx_tamer_ts_time                : out std_logic_vector(63 downto 0);                    -- ts_time
         rx_trigger_ctl_in_port          : in  std_logic_vector(7 downto 0)  := (others => 'X'); -- in_port
         rx_trigger_ctl_out_port         : out std_logic_vector(7 downto 0);                     -- out_port
+        rx_ddc_ctl_export               : out std_logic_vector(31 downto 0);                    -- export
+        rx_power_ctl_in_port            : in  std_logic_vector(31 downto 0) := (others => 'X'); -- in_port
+        rx_power_ctl_out_port           : out std_logic_vector(31 downto 0);                    -- out_port
+        rx_burst_ctl_export             : out std_logic_vector(31 downto 0);                    -- export
+        rx_burst_threshold_export       : out std_logic_vector(31 downto 0);                    -- export
+        fifo_level_ctl_in_port          : in  std_logic_vector(31 downto 0) := (others => 'X'); -- in_port
+        fifo_level_ctl_out_port         : out std_logic_vector(31 downto 0);                    -- out_port
+        tx_duc_ctl_export               : out std_logic_vector(31 downto 0);                    -- export
+        tx_loop_ctl_in_port             : in  std_logic_vector(31 downto 0) := (others => 'X'); -- in_port
+        tx_loop_ctl_out_port            : out std_logic_vector(31 downto 0);                    -- out_port
+        tx_loop_data_export             : out std_logic_vector(31 downto 0);                    -- export
+        trigger_timer_ctl_in_port       : in  std_logic_vector(31 downto 0) := (others => 'X'); -- in_port
+        trigger_timer_ctl_out_port      : out std_logic_vector(31 downto 0);                    -- out_port
+        trigger_timer_data_export       : out std_logic_vector(31 downto 0);                    -- export
         spi_MISO                        : in  std_logic                     := 'X';             -- MISO
         spi_MOSI                        : out std_logic;                                        -- MOSI
         spi_SCLK                        : out std_logic;                                        -- SCLK
@@ -141,6 +155,16 @@ begin
 
     xb_gpio_out_port <= (others =>'0') ;
     xb_gpio_dir_export <= (others =>'0') ;
+    rx_ddc_ctl_export <= (others =>'0') ;
+    rx_power_ctl_out_port <= (others =>'0') ;
+    rx_burst_ctl_export <= (others =>'0') ;
+    rx_burst_threshold_export <= (others =>'0') ;
+    fifo_level_ctl_out_port <= (others =>'0') ;
+    tx_duc_ctl_export <= (others =>'0') ;
+    tx_loop_ctl_out_port <= (others =>'0') ;
+    tx_loop_data_export <= (others =>'0') ;
+    trigger_timer_ctl_out_port <= (others =>'0') ;
+    trigger_timer_data_export <= (others =>'0') ;
 
 end architecture ;
 
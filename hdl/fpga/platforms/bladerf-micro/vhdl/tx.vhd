@@ -36,16 +36,30 @@ entity tx is
         tx_enable            : in    std_logic;
 
         meta_en              : in    std_logic := '0';
+        eight_bit_en         : in    std_logic := '0';
         timestamp_reset      : out   std_logic := '1';
         usb_speed            : in    std_logic;
         tx_underflow_led     : out   std_logic := '1';
         tx_timestamp         : in    unsigned(63 downto 0);
 
+        -- Digital upconverter
+        duc_enable           : in    std_logic := '0';
+        duc_log2_interp      : in    unsigned(2 downto 0) := (others => '0');
+        duc_dphase           : in    signed(23 downto 0) := (others => '0');
+
+        -- Waveform loop
+        loop_ctl             : in    std_logic_vector(31 downto 0) := (others => '0');
+        loop_wdata           : in    std_logic_vector(31 downto 0) := (others => '0');
+        loop_rdata           : out   std_logic_vector(31 downto 0);
+
         -- Triggering
         trigger_arm          : in    std_logic;
         trigger_fire         : in    std_logic;
         trigger_master       : in    std_logic;
         trigger_line         : inout std_logic; -- this is not good, should be in/out/oe
+        trigger_timer_ctl    : in    std_logic_vector(31 downto 0) := (others => '0');
+        trigger_timer_wdata  : in    std_logic_vector(31 downto 0) := (others => '0');
+        trigger_timer_rdata  : out   std_logic_vector(31 downto 0);
 
         -- Packet from host via FX3
         packet_en            : in    std_logic;
@@ -91,10 +105,19 @@ architecture arch of tx is
     signal trigger_arm_sync               : std_logic;
     signal trigger_line_sync              : std_logic;
     signal sample_fifo_rempty_untriggered : std_logic;
+    signal trigger_timer_fire             : std_logic;
+    signal trigger_fired                  : std_logic;
 
     signal sample_fifo_holdoff            : std_logic;
     signal sample_fifo_holdoff_i          : std_logic;
 
+    signal reader_controls                : sample_controls_t(dac_controls'range) := (others => SAMPLE_CONTROL_DISABLE);
+    signal reader_streams                 : sample_streams_t(dac_streams'range)   := (others => ZERO_SAMPLE);
+    signal reader_timestamp               : unsigned(63 downto 0);
+
+    signal loop_controls                  : sample_controls_t(dac_controls'range) := (others => SAMPLE_CONTROL_DISABLE);
+    signal loop_streams                   : sample_streams_t(dac_streams'range)   := (others => ZERO_SAMPLE);
+
 begin
 
     set_timestamp_reset : process(tx_clock, tx_reset)
@@ -211,8 +234,9 @@ begin
 
             usb_speed           =>  usb_speed,
             meta_en             =>  meta_en,
+            eight_bit_en        =>  eight_bit_en,
             packet_en           =>  packet_en,
-            timestamp           =>  tx_timestamp,
+            timestamp           =>  reader_timestamp,
 
             fifo_empty          =>  sample_fifo.rempty,
             fifo_usedw          =>  sample_fifo.rused,
@@ -229,21 +253,83 @@ begin
             meta_fifo_data      =>  meta_fifo.rdata,
             meta_fifo_read      =>  meta_fifo.rreq,
 
-            in_sample_controls  =>  dac_controls,
-            out_samples         =>  dac_streams,
+            in_sample_controls  =>  reader_controls,
+            out_samples         =>  reader_streams,
 
             underflow_led       =>  tx_underflow_led,
             underflow_count     =>  open,
             underflow_duration  =>  x"ffff"
         );
 
+    -- Waveform loop, played in place of the reader's samples
+    U_tx_loop : entity work.tx_loop
+        generic map (
+            NUM_STREAMS         => NUM_STREAMS
+        )
+        port map (
+            clock               =>  tx_clock,
+            reset               =>  tx_reset,
+
+            ctl                 =>  loop_ctl,
+            wdata               =>  loop_wdata,
+            rdata               =>  loop_rdata,
+
+            timestamp           =>  reader_timestamp,
+
+            in_controls         =>  loop_controls,
+            out_controls        =>  reader_controls,
+
+            in_streams          =>  reader_streams,
+            out_streams         =>  loop_streams
+        );
+
+    -- Digital upconverter
+    U_tx_duc : entity work.tx_duc
+        generic map (
+            NUM_STREAMS         => NUM_STREAMS
+        )
+        port map (
+            clock               =>  tx_clock,
+            reset               =>  tx_reset,
+
+            enable              =>  duc_enable,
+            log2_interpolation  =>  duc_log2_interp,
+            dphase              =>  duc_dphase,
+
+            in_timestamp        =>  tx_timestamp,
+            in_controls         =>  dac_controls,
+            out_timestamp       =>  reader_timestamp,
+            out_controls        =>  loop_controls,
+
+            in_streams          =>  loop_streams,
+            out_streams         =>  dac_streams
+        );
+
+    U_tx_trigger_timer : entity work.trigger_timer
+        generic map (
+            SELECT_VALUE    => '1'
+        )
+        port map (
+            clock           => tx_clock,
+            reset           => tx_reset,
+            ctl             => trigger_timer_ctl,
+            wdata           => trigger_timer_wdata,
+            rdata           => trigger_timer_rdata,
+            timestamp       => tx_timestamp,
+            armed           => trigger_arm,
+            trigger_line    => trigger_line,
+            fire            => trigger_timer_fire
+        );
+
+    trigger_fired <= trigger_fire or trigger_timer_fire;
+
     txtrig : entity work.trigger(async)
         generic map (
             DEFAULT_OUTPUT  => '1'
         )
         port map (
             armed           => trigger_arm_sync,               -- in  sl
-            fired           => trigger_fire,                   -- in  sl
+            fired           => trigger_fired,                  -- in  sl
             master          => trigger_master,                 -- in  sl
             trigger_in      => trigger_line_sync,              -- in  sl
             trigger_out     => trigger_line,                   -- out sl
@@ -43,6 +43,7 @@
 #include "pkt_32x32.h"
 #include "pkt_retune.h"
 #include "pkt_legacy.h"
+#include "pkt_ts_latch.h"
 #include "debug.h"
 
 #ifdef BLADERF_NIOS_PC_SIMULATION
@@ -81,13 +82,19 @@
 static const struct pkt_handler pkt_handlers[] = {
     PKT_RETUNE,
     PKT_8x8,
+    PKT_8x8_BATCH,
+    PKT_8x8_BLOCK,
     PKT_8x16,
     PKT_8x32,
     PKT_8x64,
     PKT_32x32,
     PKT_LEGACY,
+    PKT_TS_LATCH,
 };
 
+/* Handlers indexed by magic value, populated from pkt_handlers[] */
+static struct pkt_dispatch pkt_dispatch;
+
 /* A structure that represents a point on a line. Used for calibrating
  * the VCTCXO */
 typedef struct point {
@@ -112,8 +119,6 @@ typedef enum state {
 
 int main(void)
 {
-    uint8_t i;
-
     /* Pointer to currently active packet handler */
     const struct pkt_handler *handler;
 
@@ -149,14 +154,11 @@ int main(void)
 
     memset(&pkt, 0, sizeof(pkt));
     pkt.ready = false;
+    memset(&vctcxo_tamer_pkt, 0, sizeof(vctcxo_tamer_pkt));
     bladerf_nios_init(&pkt, &vctcxo_tamer_pkt);
 
     /* Initialize packet handlers */
-    for (i = 0; i < ARRAY_SIZE(pkt_handlers); i++) {
-        if (pkt_handlers[i].init != NULL) {
-            pkt_handlers[i].init();
-        }
-    }
+    pkt_dispatch_init(&pkt_dispatch, pkt_handlers, ARRAY_SIZE(pkt_handlers));
 
     while (run_nios) {
         have_request = HAVE_REQUEST();
@@ -164,14 +166,9 @@ int main(void)
         /* We have a command in the UART */
         if (have_request) {
             pkt.ready = false;
-            handler = NULL;
 
             /* Determine which packet handler should receive this message */
-            for (i = 0; i < ARRAY_SIZE(pkt_handlers); i++) {
-                if (pkt_handlers[i].magic == *magic) {
-                    handler = &pkt_handlers[i];
-                }
-            }
+            handler = pkt_dispatch_lookup(&pkt_dispatch, *magic);
 
             if (handler == NULL) {
                 /* We somehow got out of sync. Throw away request data until
@@ -193,6 +190,28 @@ int main(void)
             command_uart_write_response(pkt.resp);
         } else {
 
+            /* The host has a trim and slope from an earlier discipline run,
+             * so skip the coarse sweep and start fine tuning from them. */
+            if( vctcxo_tamer_pkt.seed_pending ) {
+
+                vctcxo_tamer_pkt.seed_pending = false;
+
+                /* Drop any errors measured at the previous trim */
+                vctcxo_tamer_enable_isr( false );
+                vctcxo_tamer_pkt.ready = false;
+
+                vctcxo_trim_dac_write( 0x08, vctcxo_tamer_pkt.seed_trim );
+                trimdac_cal_line.slope = vctcxo_tamer_pkt.seed_slope;
+                tune_state = FINE_TUNE;
+
+                vctcxo_tamer_pkt.slope = trimdac_cal_line.slope;
+                vctcxo_tamer_pkt.state = NIOS_PKT_8x32_VCTCXO_TAMER_STATE_FINE;
+
+                /* Restart the counters, and their interrupts if tuning */
+                vctcxo_tamer_set_tune_mode( vctcxo_tamer_get_tune_mode() );
+
+            }
+
             /* Temporarily putting the VCTCXO Calibration stuff here. */
             if( vctcxo_tamer_pkt.ready ) {
 
@@ -245,6 +264,10 @@ int main(void)
                     /* State to enter upon the next interrupt */
                     tune_state = FINE_TUNE;
 
+                    /* Let the host save the slope for its next seed */
+                    vctcxo_tamer_pkt.slope = trimdac_cal_line.slope;
+                    vctcxo_tamer_pkt.state = NIOS_PKT_8x32_VCTCXO_TAMER_STATE_FINE;
+
                     break;
 
                 case FINE_TUNE:
@@ -283,11 +306,7 @@ int main(void)
 
             } /* VCTCXO Tamer interrupt */
 
-            for (i = 0; i < ARRAY_SIZE(pkt_handlers); i++) {
-                if (pkt_handlers[i].do_work != NULL) {
-                    pkt_handlers[i].do_work();
-                }
-            }
+            pkt_dispatch_work(&pkt_dispatch);
         }
     }
 
@@ -2,28 +2,88 @@
 #              VARIABLES TO BE DEFINED BY PLATFORM MAKEFILE
 #------------------------------------------------------------------------------
 
-#  - FPGA_COMMON_DIR    : Path to fpga_common
-#  - BLADERF_COMMON_DIR : Path to common bladeRF_nios dir
-#  - NIOS_BUILD_OUTDIR  : Path to place the Nios build products
+#  - FPGA_COMMON_DIR     : Path to fpga_common
+#  - FIRMWARE_COMMON_DIR : Path to firmware_common
+#  - LIBBLADERF_DIR      : Path to libbladeRF
+#  - BLADERF_COMMON_DIR  : Path to common bladeRF_nios dir
+#  - NIOS_BUILD_OUTDIR   : Path to place the Nios build products
+
+#------------------------------------------------------------------------------
+#              VARIABLES APPENDED TO BY PLATFORM MAKEFILE
+#------------------------------------------------------------------------------
+
+#  - PCSIM_SRCS          : Platform-specific sources, excluding main()
+#  - PCSIM_MAIN          : Source containing the platform's main()
+#  - PCSIM_CFLAGS        : Platform-specific flags (e.g., -DBOARD_BLADERF)
+
+#------------------------------------------------------------------------------
+#              OPTIONAL VARIABLES
+#------------------------------------------------------------------------------
+
+#  - LIBBLADERF_LIBDIR   : Directory containing a libbladeRF built with
+#                          -DENABLE_BACKEND_DUMMY=ON. Required for the
+#                          bladeRF_nios_dummy.sim target only.
 
 #------------------------------------------------------------------------------
 #              MAKEFILE TARGETS
 #------------------------------------------------------------------------------
 
-INCLUDES := -I $(FPGA_COMMON_DIR)/include -I $(BLADERF_COMMON_DIR)/src
+INCLUDES := -I ./src \
+            -I $(BLADERF_COMMON_DIR)/src \
+            -I $(FIRMWARE_COMMON_DIR) \
+            -I $(FPGA_COMMON_DIR)/include \
+            -I $(LIBBLADERF_DIR)/include
 
 CFLAGS := -Wall -Wextra -Wno-unused-parameter \
-          -O0 -ggdb3 -DBLADERF_NIOS_PC_SIMULATION \
-          $(INCLUDES)
+          -O0 -ggdb3 -DBLADERF_NIOS_BUILD -DBLADERF_NIOS_PC_SIMULATION \
+          $(PCSIM_CFLAGS) $(INCLUDES)
 
-SRC := $(wildcard $(BLADERF_COMMON_DIR)/src/*.c) $(FPGA_COMMON_DIR)/src/band_select.c
+# Packet handlers and the code they share, as listed in the NIOS Makefile
+HANDLER_SRCS := $(BLADERF_COMMON_DIR)/src/pkt_8x8.c \
+                $(BLADERF_COMMON_DIR)/src/pkt_8x16.c \
+                $(BLADERF_COMMON_DIR)/src/pkt_8x32.c \
+                $(BLADERF_COMMON_DIR)/src/pkt_8x64.c \
+                $(BLADERF_COMMON_DIR)/src/pkt_16x64.c \
+                $(BLADERF_COMMON_DIR)/src/pkt_32x32.c \
+                $(BLADERF_COMMON_DIR)/src/pkt_legacy.c \
+                $(BLADERF_COMMON_DIR)/src/pkt_ts_latch.c \
+                $(PCSIM_SRCS)
+
+# Canned request/response test cases from sim_test_cases.h
+SIM_SRCS := $(HANDLER_SRCS) \
+            $(BLADERF_COMMON_DIR)/src/devices_sim.c \
+            $(PCSIM_MAIN)
+
+# Test bench and benchmark, with devices backed by the libbladeRF dummy
+# backend's register file
+DUMMY_SRCS := $(HANDLER_SRCS) \
+              $(BLADERF_COMMON_DIR)/src/devices_dummy.c \
+              $(BLADERF_COMMON_DIR)/src/sim_bench.c
+
+DUMMY_LDFLAGS := -L $(LIBBLADERF_LIBDIR) -Wl,-rpath,$(LIBBLADERF_LIBDIR) \
+                 -lbladeRF
 
 all: $(NIOS_BUILD_OUTDIR)/bladeRF_nios.sim
 
-bladeRF_nios.sim: $(SRC)
+dummy: $(NIOS_BUILD_OUTDIR)/bladeRF_nios_dummy.sim
+
+bladeRF_nios.sim: $(NIOS_BUILD_OUTDIR)/bladeRF_nios.sim
+
+bladeRF_nios_dummy.sim: $(NIOS_BUILD_OUTDIR)/bladeRF_nios_dummy.sim
+
+$(NIOS_BUILD_OUTDIR)/bladeRF_nios.sim: $(SIM_SRCS)
+	mkdir -p $(NIOS_BUILD_OUTDIR)
 	$(CC) $(CFLAGS) $^ -o $@
 
+$(NIOS_BUILD_OUTDIR)/bladeRF_nios_dummy.sim: $(DUMMY_SRCS)
+ifndef LIBBLADERF_LIBDIR
+	$(error LIBBLADERF_LIBDIR must point to a libbladeRF built with the dummy backend)
+endif
+	mkdir -p $(NIOS_BUILD_OUTDIR)
+	$(CC) $(CFLAGS) -O2 $^ -o $@ $(DUMMY_LDFLAGS)
+
 clean:
-	rm -f $(NIOS_BUILD_OUTDIR)/bladeRF_nios.sim
+	rm -f $(NIOS_BUILD_OUTDIR)/bladeRF_nios.sim \
+	      $(NIOS_BUILD_OUTDIR)/bladeRF_nios_dummy.sim
 
-.PHONY: clean
+.PHONY: all dummy bladeRF_nios.sim bladeRF_nios_dummy.sim clean
@@ -31,6 +31,7 @@
 #include <alt_types.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <unistd.h>
 
 /* Define a global variable containing the current VCTCXO DAC setting.
  * This is a 'cached' value of what is written to the DAC and is used
@@ -42,6 +43,9 @@ uint16_t vctcxo_trim_dac_value = 0x7FFF;
 /* Define a cached version of the VCTCXO tamer control register */
 uint8_t vctcxo_tamer_ctrl_reg = 0x00;
 
+/* Tuning loop state shared with the main loop */
+static struct vctcxo_tamer_pkt_buf *vctcxo_tamer_state;
+
 #ifdef BOARD_BLADERF_MICRO
 /* Common bladeRF2 header */
 #include "bladerf2_common.h"
@@ -68,6 +72,14 @@ static void command_uart_isr(void *context)
     /* Reading the request should clear the interrupt */
     command_uart_read_request((uint8_t *)pkt->req);
 
+    /* Latch the timestamp before anything else can delay it */
+    if (pkt->req[PKT_MAGIC_IDX] == NIOS_PKT_TS_LATCH_MAGIC) {
+        pkt->latch = time_tamer_read((pkt->req[NIOS_PKT_TS_LATCH_IDX_FLAGS] &
+                                      NIOS_PKT_TS_LATCH_FLAG_TX)
+                                         ? BLADERF_MODULE_TX
+                                         : BLADERF_MODULE_RX);
+    }
+
     /* Tell the main loop that there is a request pending */
     pkt->ready = true;
 
@@ -194,6 +206,49 @@ bladerf_vctcxo_tamer_mode vctcxo_tamer_get_tune_mode()
     }
 }
 
+bool vctcxo_tamer_seed_write(uint8_t addr, uint32_t data)
+{
+    switch (addr) {
+        case NIOS_PKT_8x32_VCTCXO_TAMER_ADDR_SLOPE:
+            vctcxo_tamer_state->seed_slope = (int32_t)data;
+            return true;
+
+        case NIOS_PKT_8x32_VCTCXO_TAMER_ADDR_TRIM:
+            /* Fine tuning cannot correct the trim without a slope */
+            if (vctcxo_tamer_state->seed_slope == 0) {
+                return false;
+            }
+
+            /* The main loop applies the seed between tamer interrupts */
+            vctcxo_tamer_state->seed_trim    = (uint16_t)data;
+            vctcxo_tamer_state->seed_pending = true;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+bool vctcxo_tamer_seed_read(uint8_t addr, uint32_t *data)
+{
+    switch (addr) {
+        case NIOS_PKT_8x32_VCTCXO_TAMER_ADDR_SLOPE:
+            *data = (uint32_t)vctcxo_tamer_state->slope;
+            return true;
+
+        case NIOS_PKT_8x32_VCTCXO_TAMER_ADDR_TRIM:
+            *data = vctcxo_trim_dac_value;
+            return true;
+
+        case NIOS_PKT_8x32_VCTCXO_TAMER_ADDR_STATE:
+            *data = vctcxo_tamer_state->state;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
 int32_t vctcxo_tamer_read_count(uint8_t addr)
 {
     uint32_t base  = VCTCXO_TAMER_0_BASE;
@@ -259,11 +314,35 @@ void bladerf_nios_init(struct pkt_buf *pkt,
     IOWR_ALTERA_AVALON_PIO_DATA(TX_TRIGGER_CTL_BASE, 0x00);
     IOWR_ALTERA_AVALON_PIO_DATA(RX_TRIGGER_CTL_BASE, 0x00);
 
+#ifdef BOARD_BLADERF_MICRO
+    /* Bypass the RX digital downconverter and TX digital upconverter */
+    rx_ddc_ctl_write(0);
+    tx_duc_ctl_write(0);
+
+    /* Disable the RX power detector and burst gate */
+    rx_power_ctl_write(0);
+    rx_burst_write(NIOS_PKT_8x32_RX_BURST_ADDR_CONFIG, 0);
+    rx_burst_write(NIOS_PKT_8x32_RX_BURST_ADDR_THRESHOLD, 0);
+
+    /* Start the sample FIFO high-water marks from the current levels */
+    fifo_level_write(NIOS_PKT_8x32_FIFO_LEVEL_ADDR_CLEAR, 0);
+
+    /* Pass TX samples through the waveform loop */
+    tx_loop_write(NIOS_PKT_8x32_TX_LOOP_ADDR_CONTROL,
+                  NIOS_PKT_8x32_TX_LOOP_CMD_DISABLE);
+
+    /* Cancel any scheduled trigger fires */
+    trigger_timer_write(NIOS_PKT_8x64_TRIGGER_STATUS, 0);
+    trigger_timer_write(NIOS_PKT_8x64_TRIGGER_TX | NIOS_PKT_8x64_TRIGGER_STATUS,
+                        0);
+#endif  // BOARD_BLADERF_MICRO
+
     /* Register Command UART ISR */
     alt_ic_isr_register(COMMAND_UART_IRQ_INTERRUPT_CONTROLLER_ID,
                         COMMAND_UART_IRQ, command_uart_isr, pkt, NULL);
 
     /* Register the VCTCXO Tamer ISR */
+    vctcxo_tamer_state = vctcxo_tamer_pkt;
     alt_ic_isr_register(VCTCXO_TAMER_0_IRQ_INTERRUPT_CONTROLLER_ID,
                         VCTCXO_TAMER_0_IRQ, vctcxo_tamer_isr, vctcxo_tamer_pkt,
                         NULL);
@@ -457,6 +536,48 @@ void adi_fastlock_save(bool is_tx, uint8_t rffe_profile, uint16_t nios_profile)
 }
 #endif  // BOARD_BLADERF_MICRO
 
+#ifdef BOARD_BLADERF_MICRO
+uint64_t adi_fastlock_read(bool is_tx, bool upper, uint8_t nios_profile)
+{
+    fastlock_profile *p = is_tx ? &fastlocks_tx[nios_profile]
+                                : &fastlocks_rx[nios_profile];
+    uint8_t const *bytes = &p->profile_data[upper ? 8 : 0];
+    uint64_t data = 0;
+    uint32_t i;
+
+    for (i = 0; i < 8; i++) {
+        data |= (uint64_t)bytes[i] << (8 * i);
+    }
+
+    return data;
+}
+#endif  // BOARD_BLADERF_MICRO
+
+#ifdef BOARD_BLADERF_MICRO
+void adi_fastlock_write(bool is_tx, bool upper, uint8_t rffe_profile,
+                        uint8_t nios_profile, uint64_t data)
+{
+    fastlock_profile *p = is_tx ? &fastlocks_tx[nios_profile]
+                                : &fastlocks_rx[nios_profile];
+    uint8_t *bytes = &p->profile_data[upper ? 8 : 0];
+    uint32_t i;
+
+    /* The profile is unusable until both halves have been written */
+    if (!upper) {
+        p->state = FASTLOCK_STATE_INVALID;
+    }
+
+    for (i = 0; i < 8; i++) {
+        bytes[i] = (uint8_t)(data >> (8 * i));
+    }
+
+    if (upper) {
+        p->profile_num = rffe_profile;
+        p->state       = FASTLOCK_STATE_BBP;
+    }
+}
+#endif  // BOARD_BLADERF_MICRO
+
 #ifdef BOARD_BLADERF_MICRO
 void adi_fastlock_load(bladerf_module m, fastlock_profile *p)
 {
@@ -591,6 +712,22 @@ void adi_rfspdt_select(bladerf_module m, fastlock_profile *p)
 }
 #endif  // BOARD_BLADERF_MICRO
 
+#ifdef BOARD_BLADERF_MICRO
+bool adi_synth_locked(bladerf_module m)
+{
+    /* RX/TX CP Overrange/VCO Lock registers. Bit 1 is VCO Lock. */
+    static const uint16_t rx_lock_reg = 0x247;
+    static const uint16_t tx_lock_reg = 0x287;
+    static const uint8_t lock_mask    = 0x02;
+    uint16_t addr;
+
+    addr = (0x0 << 15) | (0x0 << 12) |
+           ((BLADERF_CHANNEL_IS_TX(m) ? tx_lock_reg : rx_lock_reg) & 0x3ff);
+
+    return ((adi_spi_read(addr) >> 56) & lock_mask) != 0;
+}
+#endif  // BOARD_BLADERF_MICRO
+
 uint8_t si5338_read(uint8_t addr)
 {
     uint8_t data;
@@ -878,6 +1015,410 @@ uint8_t rx_trigger_ctl_read(void)
     return IORD_ALTERA_AVALON_PIO_DATA(RX_TRIGGER_CTL_BASE);
 }
 
+#ifdef BOARD_BLADERF_MICRO
+/* The RX DDC control PIO is output-only, so its value is cached for reads */
+static uint32_t rx_ddc_ctl_value = 0;
+
+void rx_ddc_ctl_write(uint32_t data)
+{
+    rx_ddc_ctl_value = data;
+    IOWR_ALTERA_AVALON_PIO_DATA(RX_DDC_CTL_BASE, data);
+}
+
+uint32_t rx_ddc_ctl_read(void)
+{
+    return rx_ddc_ctl_value;
+}
+#endif  // BOARD_BLADERF_MICRO
+
+#ifdef BOARD_BLADERF_MICRO
+/* The TX DUC control PIO is output-only, so its value is cached for reads */
+static uint32_t tx_duc_ctl_value = 0;
+
+void tx_duc_ctl_write(uint32_t data)
+{
+    tx_duc_ctl_value = data;
+    IOWR_ALTERA_AVALON_PIO_DATA(TX_DUC_CTL_BASE, data);
+}
+
+uint32_t tx_duc_ctl_read(void)
+{
+    return tx_duc_ctl_value;
+}
+#endif  // BOARD_BLADERF_MICRO
+
+#ifdef BOARD_BLADERF_MICRO
+/* The RX power detector's control PIO selects which result is presented on
+ * its input port, in addition to holding the configuration */
+#define RX_POWER_SEL_CHANNEL_SHIFT  8
+#define RX_POWER_SEL_MEAN           0x0
+#define RX_POWER_SEL_PEAK           0x1
+#define RX_POWER_SEL_COUNT          0x2
+
+/* Time for a selection to cross into the RX clock domain and back, at the
+ * lowest supported sample rate */
+#define RX_POWER_SETTLE_US          10
+
+/* Attempts to latch a result that was not updated while being read */
+#define RX_POWER_LATCH_TRIES        4
+
+#define RX_POWER_NUM_CHANNELS       2
+
+static uint32_t rx_power_config = 0;
+
+static struct {
+    uint32_t mean;
+    uint32_t peak;
+} rx_power_latched[RX_POWER_NUM_CHANNELS];
+
+static uint32_t rx_power_select(uint8_t ch, uint32_t sel)
+{
+    IOWR_ALTERA_AVALON_PIO_DATA(RX_POWER_CTL_BASE,
+                                rx_power_config |
+                                    (ch << RX_POWER_SEL_CHANNEL_SHIFT) | sel);
+    usleep(RX_POWER_SETTLE_US);
+    return IORD_ALTERA_AVALON_PIO_DATA(RX_POWER_CTL_BASE);
+}
+
+void rx_power_ctl_write(uint32_t data)
+{
+    rx_power_config = data & (NIOS_PKT_8x32_RX_POWER_ENABLE |
+                              NIOS_PKT_8x32_RX_POWER_LENGTH_MASK);
+    IOWR_ALTERA_AVALON_PIO_DATA(RX_POWER_CTL_BASE, rx_power_config);
+}
+
+bool rx_power_read(uint8_t addr, uint32_t *data)
+{
+    uint8_t ch;
+    uint32_t count, mean, peak;
+    unsigned int tries;
+
+    if (addr == NIOS_PKT_8x32_RX_POWER_ADDR_CONFIG) {
+        *data = rx_power_config;
+        return true;
+    }
+
+    ch = (addr - 1) / 3;
+    if (ch >= RX_POWER_NUM_CHANNELS) {
+        return false;
+    }
+
+    if (addr == NIOS_PKT_8x32_RX_POWER_ADDR_MEAN(ch)) {
+        *data = rx_power_latched[ch].mean;
+        return true;
+    } else if (addr == NIOS_PKT_8x32_RX_POWER_ADDR_PEAK(ch)) {
+        *data = rx_power_latched[ch].peak;
+        return true;
+    }
+
+    /* The results are updated in the RX clock domain, so retry if a block
+     * completed while they were being read */
+    count = rx_power_select(ch, RX_POWER_SEL_COUNT);
+    for (tries = 0; tries < RX_POWER_LATCH_TRIES; tries++) {
+        uint32_t check;
+
+        mean  = rx_power_select(ch, RX_POWER_SEL_MEAN);
+        peak  = rx_power_select(ch, RX_POWER_SEL_PEAK);
+        check = rx_power_select(ch, RX_POWER_SEL_COUNT);
+
+        if (check == count) {
+            break;
+        }
+
+        count = check;
+    }
+
+    rx_power_latched[ch].mean = mean;
+    rx_power_latched[ch].peak = peak;
+
+    *data = count;
+    return true;
+}
+#endif  // BOARD_BLADERF_MICRO
+
+#ifdef BOARD_BLADERF_MICRO
+/* The RX burst gate PIOs are output-only, so their values are cached for
+ * reads */
+static uint32_t rx_burst_config    = 0;
+static uint32_t rx_burst_threshold = 0;
+
+bool rx_burst_write(uint8_t addr, uint32_t data)
+{
+    switch (addr) {
+        case NIOS_PKT_8x32_RX_BURST_ADDR_CONFIG:
+            rx_burst_config = data;
+            IOWR_ALTERA_AVALON_PIO_DATA(RX_BURST_CTL_BASE, data);
+            return true;
+
+        case NIOS_PKT_8x32_RX_BURST_ADDR_THRESHOLD:
+            rx_burst_threshold = data;
+            IOWR_ALTERA_AVALON_PIO_DATA(RX_BURST_THRESHOLD_BASE, data);
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+bool rx_burst_read(uint8_t addr, uint32_t *data)
+{
+    switch (addr) {
+        case NIOS_PKT_8x32_RX_BURST_ADDR_CONFIG:
+            *data = rx_burst_config;
+            return true;
+
+        case NIOS_PKT_8x32_RX_BURST_ADDR_THRESHOLD:
+            *data = rx_burst_threshold;
+            return true;
+
+        default:
+            return false;
+    }
+}
+#endif  // BOARD_BLADERF_MICRO
+
+#ifdef BOARD_BLADERF_MICRO
+/* The FIFO level monitor's control PIO selects which field is presented on
+ * its input port, and clears the high-water marks while bit 8 is set */
+#define FIFO_LEVEL_SEL_MASK         0x3
+#define FIFO_LEVEL_CLEAR            (1 << 8)
+
+/* Time for a selection to cross into the FX3 PCLK domain and back */
+#define FIFO_LEVEL_SETTLE_US        1
+
+/* Attempts to read a field that was not changing while being read */
+#define FIFO_LEVEL_READ_TRIES       4
+
+bool fifo_level_write(uint8_t addr, uint32_t data)
+{
+    if (addr != NIOS_PKT_8x32_FIFO_LEVEL_ADDR_CLEAR) {
+        return false;
+    }
+
+    IOWR_ALTERA_AVALON_PIO_DATA(FIFO_LEVEL_CTL_BASE, FIFO_LEVEL_CLEAR);
+    usleep(FIFO_LEVEL_SETTLE_US);
+    IOWR_ALTERA_AVALON_PIO_DATA(FIFO_LEVEL_CTL_BASE, 0);
+
+    return true;
+}
+
+bool fifo_level_read(uint8_t addr, uint32_t *data)
+{
+    uint32_t value, check;
+    unsigned int tries;
+
+    if (addr > NIOS_PKT_8x32_FIFO_LEVEL_ADDR_CAPACITY) {
+        return false;
+    }
+
+    IOWR_ALTERA_AVALON_PIO_DATA(FIFO_LEVEL_CTL_BASE,
+                                addr & FIFO_LEVEL_SEL_MASK);
+    usleep(FIFO_LEVEL_SETTLE_US);
+
+    /* The levels are updated in the FX3 PCLK domain, so retry until a read
+     * is not torn by an update */
+    value = IORD_ALTERA_AVALON_PIO_DATA(FIFO_LEVEL_CTL_BASE);
+    for (tries = 0; tries < FIFO_LEVEL_READ_TRIES; tries++) {
+        check = IORD_ALTERA_AVALON_PIO_DATA(FIFO_LEVEL_CTL_BASE);
+        if (check == value) {
+            break;
+        }
+
+        value = check;
+    }
+
+    *data = value;
+    return true;
+}
+#endif  // BOARD_BLADERF_MICRO
+
+#ifdef BOARD_BLADERF_MICRO
+/* The TX loop's control PIO addresses a register in its low bits, and a
+ * change of bit 8 writes the value on the data PIO to that register. The
+ * addressed register is presented on the control PIO's input port. */
+#define TX_LOOP_ADDR_MASK           0xf
+#define TX_LOOP_WRITE_TOGGLE        (1 << 8)
+
+/* Time for a value to cross into the TX clock domain and back. This covers
+ * a few periods of the TX clock at the lowest sample rate. */
+#define TX_LOOP_SETTLE_US           10
+
+/* Attempts to read a register that was not changing while being read */
+#define TX_LOOP_READ_TRIES          4
+
+static uint32_t tx_loop_ctl;
+
+bool tx_loop_write(uint8_t addr, uint32_t data)
+{
+    /* The last two registers are read only */
+    if (addr >= NIOS_PKT_8x32_TX_LOOP_ADDR_LOOPS) {
+        return false;
+    }
+
+    /* Each bit crosses into the TX clock domain separately, so the address
+     * and value must settle there before the toggle that writes them */
+    tx_loop_ctl = (tx_loop_ctl & TX_LOOP_WRITE_TOGGLE) |
+                  (addr & TX_LOOP_ADDR_MASK);
+    IOWR_ALTERA_AVALON_PIO_DATA(TX_LOOP_CTL_BASE, tx_loop_ctl);
+    IOWR_ALTERA_AVALON_PIO_DATA(TX_LOOP_DATA_BASE, data);
+    usleep(TX_LOOP_SETTLE_US);
+
+    tx_loop_ctl ^= TX_LOOP_WRITE_TOGGLE;
+    IOWR_ALTERA_AVALON_PIO_DATA(TX_LOOP_CTL_BASE, tx_loop_ctl);
+    usleep(TX_LOOP_SETTLE_US);
+
+    return true;
+}
+
+bool tx_loop_read(uint8_t addr, uint32_t *data)
+{
+    uint32_t value, check;
+    unsigned int tries;
+
+    if (addr > NIOS_PKT_8x32_TX_LOOP_ADDR_CAPACITY) {
+        return false;
+    }
+
+    /* Select the register, leaving the write toggle as it is */
+    tx_loop_ctl = (tx_loop_ctl & TX_LOOP_WRITE_TOGGLE) |
+                  (addr & TX_LOOP_ADDR_MASK);
+    IOWR_ALTERA_AVALON_PIO_DATA(TX_LOOP_CTL_BASE, tx_loop_ctl);
+    usleep(TX_LOOP_SETTLE_US);
+
+    /* The registers are updated in the TX clock domain, so retry until a
+     * read is not torn by an update */
+    value = IORD_ALTERA_AVALON_PIO_DATA(TX_LOOP_CTL_BASE);
+    for (tries = 0; tries < TX_LOOP_READ_TRIES; tries++) {
+        check = IORD_ALTERA_AVALON_PIO_DATA(TX_LOOP_CTL_BASE);
+        if (check == value) {
+            break;
+        }
+
+        value = check;
+    }
+
+    *data = value;
+    return true;
+}
+#endif  // BOARD_BLADERF_MICRO
+
+
+#ifdef BOARD_BLADERF_MICRO
+/* The trigger timers share a control PIO, laid out as the TX loop's is.
+ * Bit 4 selects the TX timer, for both writes and readback. */
+#define TRIGGER_TIMER_ADDR_MASK     0xf
+#define TRIGGER_TIMER_SELECT_TX     (1 << 4)
+#define TRIGGER_TIMER_WRITE_TOGGLE  (1 << 8)
+
+/* Trigger timer registers */
+#define TRIGGER_TIMER_REG_CONTROL   0
+#define TRIGGER_TIMER_REG_FIRE_LO   1
+#define TRIGGER_TIMER_REG_FIRE_HI   2
+#define TRIGGER_TIMER_REG_FIRED_LO  3
+#define TRIGGER_TIMER_REG_FIRED_HI  4
+
+/* TRIGGER_TIMER_REG_CONTROL commands. Its readback holds the
+ * NIOS_PKT_8x64_TRIGGER_FLAG_* bits. */
+#define TRIGGER_TIMER_CMD_CANCEL    0
+#define TRIGGER_TIMER_CMD_SCHEDULE  1
+
+static uint32_t trigger_timer_ctl;
+
+static void trigger_timer_select(bool tx, uint8_t reg)
+{
+    trigger_timer_ctl = (trigger_timer_ctl & TRIGGER_TIMER_WRITE_TOGGLE) |
+                        (tx ? TRIGGER_TIMER_SELECT_TX : 0) |
+                        (reg & TRIGGER_TIMER_ADDR_MASK);
+    IOWR_ALTERA_AVALON_PIO_DATA(TRIGGER_TIMER_CTL_BASE, trigger_timer_ctl);
+}
+
+static void trigger_timer_reg_write(bool tx, uint8_t reg, uint32_t data)
+{
+    trigger_timer_select(tx, reg);
+    IOWR_ALTERA_AVALON_PIO_DATA(TRIGGER_TIMER_DATA_BASE, data);
+    usleep(TX_LOOP_SETTLE_US);
+
+    trigger_timer_ctl ^= TRIGGER_TIMER_WRITE_TOGGLE;
+    IOWR_ALTERA_AVALON_PIO_DATA(TRIGGER_TIMER_CTL_BASE, trigger_timer_ctl);
+    usleep(TX_LOOP_SETTLE_US);
+}
+
+static uint32_t trigger_timer_reg_read(bool tx, uint8_t reg)
+{
+    uint32_t value, check;
+    unsigned int tries;
+
+    trigger_timer_select(tx, reg);
+    usleep(TX_LOOP_SETTLE_US);
+
+    value = IORD_ALTERA_AVALON_PIO_DATA(TRIGGER_TIMER_CTL_BASE);
+    for (tries = 0; tries < TX_LOOP_READ_TRIES; tries++) {
+        check = IORD_ALTERA_AVALON_PIO_DATA(TRIGGER_TIMER_CTL_BASE);
+        if (check == value) {
+            break;
+        }
+
+        value = check;
+    }
+
+    return value;
+}
+
+bool trigger_timer_write(uint8_t addr, uint64_t data)
+{
+    bool const tx = (addr & NIOS_PKT_8x64_TRIGGER_TX) != 0;
+
+    switch (addr & NIOS_PKT_8x64_TRIGGER_FIELD_MASK) {
+        case NIOS_PKT_8x64_TRIGGER_FIRE_TIME:
+            trigger_timer_reg_write(tx, TRIGGER_TIMER_REG_FIRE_LO,
+                                    (uint32_t)data);
+            trigger_timer_reg_write(tx, TRIGGER_TIMER_REG_FIRE_HI,
+                                    (uint32_t)(data >> 32));
+            trigger_timer_reg_write(tx, TRIGGER_TIMER_REG_CONTROL,
+                                    TRIGGER_TIMER_CMD_SCHEDULE);
+            return true;
+
+        case NIOS_PKT_8x64_TRIGGER_STATUS:
+            trigger_timer_reg_write(tx, TRIGGER_TIMER_REG_CONTROL,
+                                    TRIGGER_TIMER_CMD_CANCEL);
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+bool trigger_timer_read(uint8_t addr, uint64_t *data)
+{
+    bool const tx = (addr & NIOS_PKT_8x64_TRIGGER_TX) != 0;
+    uint8_t lo, hi;
+
+    switch (addr & NIOS_PKT_8x64_TRIGGER_FIELD_MASK) {
+        case NIOS_PKT_8x64_TRIGGER_FIRE_TIME:
+            lo = TRIGGER_TIMER_REG_FIRE_LO;
+            hi = TRIGGER_TIMER_REG_FIRE_HI;
+            break;
+
+        /* The fired time does not change once the FIRED flag is set */
+        case NIOS_PKT_8x64_TRIGGER_FIRED_TIME:
+            lo = TRIGGER_TIMER_REG_FIRED_LO;
+            hi = TRIGGER_TIMER_REG_FIRED_HI;
+            break;
+
+        case NIOS_PKT_8x64_TRIGGER_STATUS:
+            *data = trigger_timer_reg_read(tx, TRIGGER_TIMER_REG_CONTROL);
+            return true;
+
+        default:
+            return false;
+    }
+
+    *data = ((uint64_t)trigger_timer_reg_read(tx, hi) << 32) |
+            trigger_timer_reg_read(tx, lo);
+    return true;
+}
+#endif  // BOARD_BLADERF_MICRO
+
 void agc_dc_corr_write(uint16_t addr, uint16_t value)
 {
 // Applies only to bladeRF1
@@ -915,4 +1456,22 @@ uint64_t time_tamer_read(bladerf_module m)
     return value;
 }
 
+struct retune_stats retune_stats_rx;
+struct retune_stats retune_stats_tx;
+
+void retune_stats_record(bladerf_module m,
+                         uint64_t scheduled,
+                         uint64_t start,
+                         bool locked)
+{
+    struct retune_stats *s =
+        (m == BLADERF_MODULE_RX) ? &retune_stats_rx : &retune_stats_tx;
+
+    s->complete  = time_tamer_read(m);
+    s->scheduled = scheduled;
+    s->start     = start;
+    s->locked    = locked;
+    s->valid     = true;
+}
+
 #endif
@@ -31,15 +31,11 @@
 #include "fpga_version.h"
 #include "pkt_handler.h"
 
-/* Detect if we are in NIOS Build tools */
-#ifdef BLADERF_NIOS_BUILD
-#   ifdef BLADERF_NIOS_PC_SIMULATION
-#       error "When compiling for the NIOS II, you cannot define BLADERF_NIOS_PC_SIMULATION."
-#   endif
-#else
-#   ifndef BLADERF_NIOS_PC_SIMULATION
-#   error "When compiling for PC simulation, you must define BLADERF_NIOS_PC_SIMULATION."
-#   endif
+/* Detect if we are in NIOS Build tools. PC simulation builds define both
+ * BLADERF_NIOS_BUILD, so that fpga_common code takes its NIOS II code paths,
+ * and BLADERF_NIOS_PC_SIMULATION. */
+#ifndef BLADERF_NIOS_BUILD
+#   error "BLADERF_NIOS_BUILD must be defined, including for PC simulation."
 #endif
 
 #ifndef BLADERF_NIOS_PC_SIMULATION
@@ -99,14 +95,6 @@
 #   define VT_STAT_ERR_10S   (1<<1)
 #   define VT_STAT_ERR_100S  (1<<2)
 
-/* Number of RFFE fast lock profiles to store in the Nios.
- * Make sure this matches what is defined in bladerf2.c.
- */
-#define NUM_BBP_FASTLOCK_PROFILES  256
-
-/* Number of fast lock profiles that can be stored in the RFFE */
-#define NUM_RFFE_FASTLOCK_PROFILES 8
-
 /* Enable libad936x if we have enough RAM. Note that it is very important
  * that all calls to ad9361_* be ifdef-wrapped! */
 #   if RAM_SPAN >= 131072
@@ -118,6 +106,14 @@
     void SIMULATION_FLUSH_UART();
 #endif
 
+/* Number of RFFE fast lock profiles to store in the Nios.
+ * Make sure this matches what is defined in bladerf2.c.
+ */
+#define NUM_BBP_FASTLOCK_PROFILES  256
+
+/* Number of fast lock profiles that can be stored in the RFFE */
+#define NUM_RFFE_FASTLOCK_PROFILES 8
+
 /* Define a global variable containing the current VCTCXO DAC setting.
  * This is a 'cached' value of what is written to the DAC and is used
  * for the calibration algorithm to avoid unnecessary read requests
@@ -220,6 +216,32 @@ void adi_axi_write(uint16_t addr, uint32_t data);
 void adi_fastlock_save(bool is_tx, uint8_t rffe_profile,
                           uint16_t nios_profile);
 
+/**
+ * Read half of a fast lock profile's data from Nios memory.
+ *
+ * @param is_tx        True if TX profile; false if RX.
+ * @param upper        True for profile bytes 8-15; false for bytes 0-7.
+ * @param nios_profile Nios profile number (0-::NUM_BBP_FASTLOCK_PROFILES)
+ *
+ * @return Profile bytes, with the first in the least significant byte
+ */
+uint64_t adi_fastlock_read(bool is_tx, bool upper, uint8_t nios_profile);
+
+/**
+ * Write half of a fast lock profile's data to Nios memory, e.g., to restore
+ * a profile saved by the host in a previous session. Writing the upper half
+ * marks the profile as saved, to be loaded into the AD9361 on next use.
+ *
+ * @param is_tx        True if TX profile; false if RX.
+ * @param upper        True for profile bytes 8-15; false for bytes 0-7.
+ * @param rffe_profile AD9361 profile number (0-::NUM_RFFE_FASTLOCK_PROFILES)
+ * @param nios_profile Nios profile number (0-::NUM_BBP_FASTLOCK_PROFILES)
+ * @param data         Profile bytes, with the first in the least
+ *                     significant byte
+ */
+void adi_fastlock_write(bool is_tx, bool upper, uint8_t rffe_profile,
+                        uint8_t nios_profile, uint64_t data);
+
 /**
  * Load fast lock profile from Nios memory into AD9361 RFIC.
  *
@@ -251,6 +273,15 @@ void adi_rfport_select(fastlock_profile *p);
  */
 void adi_rfspdt_select(bladerf_module m, fastlock_profile *p);
 
+/**
+ * Check whether an AD9361 synthesizer reports lock.
+ *
+ * @param m    Which module's synthesizer to check.
+ *
+ * @return true if locked
+ */
+bool adi_synth_locked(bladerf_module m);
+
 /**
  * Read from Si5338 clock generator register
  *
@@ -451,6 +482,32 @@ INLINE void timer_tamer_clear_interrupt(bladerf_module m);
  */
 void tamer_schedule(bladerf_module m, uint64_t time);
 
+/* Instrumentation of the most recent retune of a module */
+struct retune_stats {
+    bool valid;         /* A retune has been recorded */
+    bool locked;        /* The PLL reported lock after the retune */
+    uint64_t scheduled; /* Timestamp the retune was scheduled for, or 0 */
+    uint64_t start;     /* Timestamp when the retune began */
+    uint64_t complete;  /* Timestamp when the retune completed */
+};
+
+extern struct retune_stats retune_stats_rx;
+extern struct retune_stats retune_stats_tx;
+
+/**
+ * Record a completed retune. The completion time is taken to be now.
+ *
+ * @param   m           Module that was retuned
+ * @param   scheduled   Timestamp the retune was scheduled for, or 0 if it was
+ *                      performed immediately
+ * @param   start       Timestamp when the retune began
+ * @param   locked      Whether the PLL reported lock
+ */
+void retune_stats_record(bladerf_module m,
+                         uint64_t scheduled,
+                         uint64_t start,
+                         bool locked);
+
 /**
  * Read the command UART request buffer
  */
@@ -558,6 +615,152 @@ void rx_trigger_ctl_write(uint8_t data);
  */
 uint8_t rx_trigger_ctl_read(void);
 
+/**
+ * Write the Rx digital downconverter control register
+ *
+ * @param   data    Data to write. See NIOS_PKT_8x32_TARGET_RX_DDC.
+ */
+void rx_ddc_ctl_write(uint32_t data);
+
+/**
+ * Read the Rx digital downconverter control register
+ *
+ * @return Value last written to the Rx DDC control register
+ */
+uint32_t rx_ddc_ctl_read(void);
+
+/**
+ * Write the Tx digital upconverter control register
+ *
+ * @param   data    Data to write. See NIOS_PKT_8x32_TARGET_TX_DUC.
+ */
+void tx_duc_ctl_write(uint32_t data);
+
+/**
+ * Read the Tx digital upconverter control register
+ *
+ * @return Value last written to the Tx DUC control register
+ */
+uint32_t tx_duc_ctl_read(void);
+
+/**
+ * Write the Rx power detector configuration
+ *
+ * @param   data    Data to write. See NIOS_PKT_8x32_RX_POWER_ADDR_CONFIG.
+ */
+void rx_power_ctl_write(uint32_t data);
+
+/**
+ * Read an Rx power detector register
+ *
+ * @param[in]   addr    NIOS_PKT_8x32_RX_POWER_ADDR_* address
+ * @param[out]  data    Register value
+ *
+ * @return true on success, false if the address is invalid
+ */
+bool rx_power_read(uint8_t addr, uint32_t *data);
+
+/**
+ * Write an Rx burst gate register
+ *
+ * @param   addr    NIOS_PKT_8x32_RX_BURST_ADDR_* address
+ * @param   data    Data to write
+ *
+ * @return true on success, false if the address is invalid
+ */
+bool rx_burst_write(uint8_t addr, uint32_t data);
+
+/**
+ * Read an Rx burst gate register
+ *
+ * @param[in]   addr    NIOS_PKT_8x32_RX_BURST_ADDR_* address
+ * @param[out]  data    Value last written to the register
+ *
+ * @return true on success, false if the address is invalid
+ */
+bool rx_burst_read(uint8_t addr, uint32_t *data);
+
+/**
+ * Write a sample FIFO level monitor register
+ *
+ * @param   addr    NIOS_PKT_8x32_FIFO_LEVEL_ADDR_* address
+ * @param   data    Data to write
+ *
+ * @return true on success, false if the address is not writable
+ */
+bool fifo_level_write(uint8_t addr, uint32_t data);
+
+/**
+ * Read a sample FIFO level monitor register
+ *
+ * @param[in]   addr    NIOS_PKT_8x32_FIFO_LEVEL_ADDR_* address
+ * @param[out]  data    Register value
+ *
+ * @return true on success, false if the address is not readable
+ */
+bool fifo_level_read(uint8_t addr, uint32_t *data);
+
+/**
+ * Write a TX waveform loop register
+ *
+ * @param   addr    NIOS_PKT_8x32_TX_LOOP_ADDR_* address
+ * @param   data    Data to write
+ *
+ * @return true on success, false if the address is not writable
+ */
+bool tx_loop_write(uint8_t addr, uint32_t data);
+
+/**
+ * Read a TX waveform loop register
+ *
+ * @param[in]   addr    NIOS_PKT_8x32_TX_LOOP_ADDR_* address
+ * @param[out]  data    Register value
+ *
+ * @return true on success, false if the address is not readable
+ */
+bool tx_loop_read(uint8_t addr, uint32_t *data);
+
+/**
+ * Write a VCTCXO tamer trim state register
+ *
+ * @param   addr    NIOS_PKT_8x32_VCTCXO_TAMER_ADDR_* address
+ * @param   data    Data to write
+ *
+ * @return true on success, false if the address is not writable or there is
+ *         no slope to seed the trim with
+ */
+bool vctcxo_tamer_seed_write(uint8_t addr, uint32_t data);
+
+/**
+ * Read a VCTCXO tamer trim state register
+ *
+ * @param[in]   addr    NIOS_PKT_8x32_VCTCXO_TAMER_ADDR_* address
+ * @param[out]  data    Register value
+ *
+ * @return true on success, false if the address is not readable
+ */
+bool vctcxo_tamer_seed_read(uint8_t addr, uint32_t *data);
+
+/**
+ * Schedule or cancel a trigger fire
+ *
+ * @param   addr    NIOS_PKT_8x64_TARGET_TRIGGER sub-address
+ * @param   data    Fire time, when writing NIOS_PKT_8x64_TRIGGER_FIRE_TIME
+ *
+ * @return true on success, false if the field is not writable
+ */
+bool trigger_timer_write(uint8_t addr, uint64_t data);
+
+/**
+ * Read a trigger fire time or status
+ *
+ * @param[in]   addr    NIOS_PKT_8x64_TARGET_TRIGGER sub-address
+ * @param[out]  data    Field value
+ *
+ * @return true on success, false if the field is not readable
+ */
+bool trigger_timer_read(uint8_t addr, uint64_t *data);
+
 /**
  * Write to bladeRF1 AGC DC correction
  *
@@ -611,6 +814,9 @@ bool rfic_command_read(uint16_t addr, uint64_t *data);
  */
 #ifndef BLADERF_NIOS_PC_SIMULATION
 #   include "devices_inline.h"
+#else
+    uint32_t rffe_csr_read(void);
+    void rffe_csr_write(uint32_t value);
 #endif
 
 
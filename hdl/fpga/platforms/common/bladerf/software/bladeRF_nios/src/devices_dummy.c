@@ -0,0 +1,342 @@
+/* This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* Device accessors for the PC simulation test bench (sim_bench.c).
+ *
+ * Accesses to devices modeled by the libbladeRF dummy backend (LMS6002D,
+ * Si5338, VCTCXO trim DAC and tamer, config and expansion GPIO, IQ
+ * corrections and timestamps) are forwarded to it through the libbladeRF
+ * API. Everything else is kept in local variables, so that a value written
+ * reads back. Retunes and LMS6002D tuning and calibration are not modeled.
+ */
+#ifdef BLADERF_NIOS_PC_SIMULATION
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+#include "pkt_handler.h"
+#include "devices.h"
+#include "devices_dummy.h"
+#include "debug.h"
+
+static struct bladerf *dummy_dev = NULL;
+static unsigned int dummy_errors = 0;
+
+/* State of devices the dummy backend does not model */
+static uint8_t  trigger_ctl[2];
+static uint32_t rffe_csr;
+static uint32_t adf4351_reg;
+
+uint16_t vctcxo_trim_dac_value;
+
+struct retune_stats retune_stats_rx;
+struct retune_stats retune_stats_tx;
+
+static inline void check(int status, const char *fn)
+{
+    if (status != 0) {
+        DBG("%s: %s\n", fn, bladerf_strerror(status));
+        dummy_errors++;
+    }
+}
+
+static inline bladerf_direction module2dir(bladerf_module m)
+{
+    return (m == BLADERF_MODULE_TX) ? BLADERF_TX : BLADERF_RX;
+}
+
+void devices_dummy_attach(struct bladerf *dev)
+{
+    dummy_dev = dev;
+}
+
+unsigned int devices_dummy_take_errors(void)
+{
+    unsigned int ret = dummy_errors;
+    dummy_errors = 0;
+    return ret;
+}
+
+void bladerf_nios_init(struct pkt_buf *pkt,
+                       struct vctcxo_tamer_pkt_buf *vctcxo_tamer_pkt)
+{
+    ASSERT(dummy_dev != NULL);
+}
+
+uint8_t lms6_read(uint8_t addr)
+{
+    uint8_t data = 0;
+    check(bladerf_lms_read(dummy_dev, addr, &data), __FUNCTION__);
+    return data;
+}
+
+void lms6_write(uint8_t addr, uint8_t data)
+{
+    check(bladerf_lms_write(dummy_dev, addr, data), __FUNCTION__);
+}
+
+uint8_t si5338_read(uint8_t addr)
+{
+    uint8_t data = 0;
+    check(bladerf_si5338_read(dummy_dev, addr, &data), __FUNCTION__);
+    return data;
+}
+
+void si5338_write(uint8_t addr, uint8_t data)
+{
+    check(bladerf_si5338_write(dummy_dev, addr, data), __FUNCTION__);
+}
+
+/* The libbladeRF DAC161S055 driver issues the power-up (0x28) command
+ * itself, so only the write-and-update (0x08) command is forwarded */
+void vctcxo_trim_dac_write(uint8_t cmd, uint16_t val)
+{
+    if (cmd == 0x08) {
+        check(bladerf_trim_dac_write(dummy_dev, val), __FUNCTION__);
+        vctcxo_trim_dac_value = val;
+    }
+}
+
+void vctcxo_trim_dac_read(uint8_t cmd, uint16_t *val)
+{
+    *val = 0;
+    check(bladerf_trim_dac_read(dummy_dev, val), __FUNCTION__);
+}
+
+void vctcxo_tamer_enable_isr(bool enable)
+{
+}
+
+void vctcxo_tamer_reset_counters(bool reset)
+{
+}
+
+void vctcxo_tamer_set_tune_mode(bladerf_vctcxo_tamer_mode mode)
+{
+    check(bladerf_set_vctcxo_tamer_mode(dummy_dev, mode), __FUNCTION__);
+}
+
+bladerf_vctcxo_tamer_mode vctcxo_tamer_get_tune_mode()
+{
+    bladerf_vctcxo_tamer_mode mode = BLADERF_VCTCXO_TAMER_INVALID;
+    check(bladerf_get_vctcxo_tamer_mode(dummy_dev, &mode), __FUNCTION__);
+    return mode;
+}
+
+void tx_trigger_ctl_write(uint8_t data)
+{
+    trigger_ctl[1] = data;
+}
+
+uint8_t tx_trigger_ctl_read(void)
+{
+    return trigger_ctl[1];
+}
+
+void rx_trigger_ctl_write(uint8_t data)
+{
+    trigger_ctl[0] = data;
+}
+
+uint8_t rx_trigger_ctl_read(void)
+{
+    return trigger_ctl[0];
+}
+
+void agc_dc_corr_write(uint16_t addr, uint16_t value)
+{
+}
+
+void adf4351_write(uint32_t val)
+{
+    adf4351_reg = val;
+}
+
+uint32_t control_reg_read(void)
+{
+    uint32_t val = 0;
+    check(bladerf_config_gpio_read(dummy_dev, &val), __FUNCTION__);
+    return val;
+}
+
+void control_reg_write(uint32_t value)
+{
+    check(bladerf_config_gpio_write(dummy_dev, value), __FUNCTION__);
+}
+
+uint32_t rffe_csr_read(void)
+{
+    return rffe_csr;
+}
+
+void rffe_csr_write(uint32_t value)
+{
+    rffe_csr = value;
+}
+
+/* The libbladeRF API applies a 4096 offset to gain corrections, which the
+ * FPGA register does not have */
+uint16_t iqbal_get_gain(bladerf_module m)
+{
+    int16_t value = 0;
+    check(bladerf_get_correction(dummy_dev, m, BLADERF_CORR_GAIN, &value),
+          __FUNCTION__);
+    return (uint16_t)(value + 4096);
+}
+
+void iqbal_set_gain(bladerf_module m, uint16_t value)
+{
+    check(bladerf_set_correction(dummy_dev, m, BLADERF_CORR_GAIN,
+                                 (int16_t)(value - 4096)),
+          __FUNCTION__);
+}
+
+uint16_t iqbal_get_phase(bladerf_module m)
+{
+    int16_t value = 0;
+    check(bladerf_get_correction(dummy_dev, m, BLADERF_CORR_PHASE, &value),
+          __FUNCTION__);
+    return (uint16_t)value;
+}
+
+void iqbal_set_phase(bladerf_module m, uint16_t value)
+{
+    check(bladerf_set_correction(dummy_dev, m, BLADERF_CORR_PHASE,
+                                 (int16_t)value),
+          __FUNCTION__);
+}
+
+uint32_t expansion_port_read(void)
+{
+    uint32_t val = 0;
+    check(bladerf_expansion_gpio_read(dummy_dev, &val), __FUNCTION__);
+    return val;
+}
+
+void expansion_port_write(uint32_t value)
+{
+    check(bladerf_expansion_gpio_write(dummy_dev, value), __FUNCTION__);
+}
+
+uint32_t expansion_port_get_direction()
+{
+    uint32_t dir = 0;
+    check(bladerf_expansion_gpio_dir_read(dummy_dev, &dir), __FUNCTION__);
+    return dir;
+}
+
+void expansion_port_set_direction(uint32_t dir)
+{
+    check(bladerf_expansion_gpio_dir_write(dummy_dev, dir), __FUNCTION__);
+}
+
+uint64_t time_tamer_read(bladerf_module m)
+{
+    uint64_t ts = 0;
+    check(bladerf_get_timestamp(dummy_dev, module2dir(m), &ts), __FUNCTION__);
+    return ts;
+}
+
+void time_tamer_reset(bladerf_module m)
+{
+}
+
+void time_tamer_clear_interrupt(bladerf_module m)
+{
+}
+
+void tamer_schedule(bladerf_module m, uint64_t time)
+{
+}
+
+void retune_stats_record(bladerf_module m, uint64_t scheduled, uint64_t start,
+                         bool locked)
+{
+    struct retune_stats *s =
+        (m == BLADERF_MODULE_RX) ? &retune_stats_rx : &retune_stats_tx;
+
+    s->complete  = time_tamer_read(m);
+    s->scheduled = scheduled;
+    s->start     = start;
+    s->locked    = locked;
+    s->valid     = true;
+}
+
+int lms_set_precalculated_frequency(struct bladerf *dev, bladerf_module mod,
+                                    struct lms_freq *f)
+{
+    return 0;
+}
+
+int lms_tune_vcocap(struct bladerf *dev, bladerf_module mod,
+                    uint8_t vcocap_est, uint8_t *vcocap_result, bool *locked)
+{
+    *vcocap_result = vcocap_est;
+    *locked = true;
+    return 0;
+}
+
+int lms_dc_cal_loop(struct bladerf *dev, uint8_t base,
+                    uint8_t cal_address, uint8_t dc_cntval,
+                    uint8_t *dc_regval)
+{
+    *dc_regval = dc_cntval;
+    return 0;
+}
+
+int lms_load_dc_cal_value(struct bladerf *dev, uint8_t base,
+                          uint8_t dc_addr, uint8_t value)
+{
+    return 0;
+}
+
+int lms_select_band(struct bladerf *dev, bladerf_module module, bool low_band)
+{
+    return 0;
+}
+
+/* The dummy backend emulates a bladeRF1, which has no AD9361 */
+uint64_t adi_spi_read(uint16_t addr)
+{
+    return 0;
+}
+
+void adi_spi_write(uint16_t addr, uint64_t data)
+{
+}
+
+bool rfic_command_write(uint16_t addr, uint64_t data)
+{
+    return false;
+}
+
+bool rfic_command_read(uint16_t addr, uint64_t *data)
+{
+    *data = 0;
+    return false;
+}
+
+#endif
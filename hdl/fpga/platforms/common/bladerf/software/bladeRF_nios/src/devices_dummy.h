@@ -0,0 +1,47 @@
+/* This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BLADERF_NIOS_DEVICES_DUMMY_H_
+#define BLADERF_NIOS_DEVICES_DUMMY_H_
+
+/* PC simulation device layer that backs the NIOS II device accessors with a
+ * libbladeRF device opened on the dummy backend, so that packet handlers
+ * operate on the dummy backend's register file. */
+
+#include <libbladeRF.h>
+
+/**
+ * Set the device that subsequent device accesses are forwarded to
+ *
+ * @param   dev     Device opened on the dummy backend
+ */
+void devices_dummy_attach(struct bladerf *dev);
+
+/**
+ * @return  Number of device accesses that have failed since the last call,
+ *          clearing the count.
+ */
+unsigned int devices_dummy_take_errors(void);
+
+#endif
@@ -50,6 +50,26 @@ void rfic_invalidate_frequency(bladerf_module module)
 /* Dispatching */
 /******************************************************************************/
 
+static void rfic_command_work_wq(struct rfic_queue *q);
+
+/**
+ * @brief       Drain the write queue, then read the system status register
+ *
+ * @param[out]  status  Status register value
+ *
+ * @return      true if successful, false if not
+ */
+static bool _rfic_cmd_rd_wait(struct rfic_state *state,
+                              bladerf_channel channel,
+                              uint64_t *status)
+{
+    while (state->write_queue.count > 0) {
+        rfic_command_work_wq(&state->write_queue);
+    }
+
+    return _rfic_cmd_rd_status(state, channel, status);
+}
+
 /**
  * @brief      Function pointers for RFIC command dispatching
  */
@@ -144,6 +164,11 @@ struct rfic_command_fns const funcs[] = {
         FIELD_INIT(.bitmask,
             RFIC_CMD_INIT_REQD | RFIC_CMD_CHAN_TX | RFIC_CMD_CHAN_RX),
     },
+    {
+        FIELD_INIT(.command, BLADERF_RFIC_COMMAND_WAIT),
+        FIELD_INIT(.read64, _rfic_cmd_rd_wait),
+        FIELD_INIT(.bitmask, RFIC_CMD_CHAN_SYSTEM),
+    },
     // clang-format on
 };
 
@@ -245,12 +270,10 @@ static void rfic_command_work_wq(struct rfic_queue *q)
                  _rfic_statestr(e->state), -1, e->value);
     }
 
+    /* Run the command and retire it in the same pass, rather than spending
+     * a main loop iteration on each state transition */
     switch (e->state) {
-        case ENTRY_STATE_NEW: {
-            e->state = ENTRY_STATE_RUNNING;
-            break;
-        }
-
+        case ENTRY_STATE_NEW:
         case ENTRY_STATE_RUNNING: {
             struct rfic_command_fns const *f = _get_cmd_ptr(e->cmd);
 
@@ -262,9 +285,8 @@ static void rfic_command_work_wq(struct rfic_queue *q)
             } else if (NULL != f->write32) {
                 e->rv = f->write32(&state, e->ch, e->value);
             }
-
-            break;
         }
+            /* Fall through */
 
         case ENTRY_STATE_COMPLETE: {
             /* Drop the item from the queue */
@@ -241,6 +241,9 @@ static inline char const *_rfic_cmdstr(uint8_t cmd)
         case BLADERF_RFIC_COMMAND_FASTLOCK:
             return "FASTLOCK";
 
+        case BLADERF_RFIC_COMMAND_WAIT:
+            return "WAIT    ";
+
         default:
             return "        ";
     }
@@ -286,7 +286,14 @@ bool _rfic_cmd_rd_status(struct rfic_state *state,
                << BLADERF_RFIC_STATUS_WQLEN_SHIFT) |
 
               ((state->write_queue.last_rv & BLADERF_RFIC_STATUS_WQSUCCESS_MASK)
-               << BLADERF_RFIC_STATUS_WQSUCCESS_SHIFT);
+               << BLADERF_RFIC_STATUS_WQSUCCESS_SHIFT) |
+
+              (((uint64_t)COMMAND_QUEUE_MAX & BLADERF_RFIC_STATUS_WQMAX_MASK)
+               << BLADERF_RFIC_STATUS_WQMAX_SHIFT) |
+
+              (((uint64_t)state->write_queue.hwm &
+                BLADERF_RFIC_STATUS_WQHWM_MASK)
+               << BLADERF_RFIC_STATUS_WQHWM_SHIFT);
 
     return true;
 }
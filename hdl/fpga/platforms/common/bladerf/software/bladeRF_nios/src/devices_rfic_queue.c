@@ -48,7 +48,11 @@ uint8_t rfic_enqueue(struct rfic_queue *q,
 
     q->ins_idx = (q->ins_idx + 1) & (COMMAND_QUEUE_MAX - 1);
 
-    return ++q->count;
+    if (++q->count > q->hwm) {
+        q->hwm = q->count;
+    }
+
+    return q->count;
 }
 
 uint8_t rfic_dequeue(struct rfic_queue *q, struct rfic_queue_entry *e)
@@ -84,6 +88,7 @@ void rfic_queue_reset(struct rfic_queue *q)
     }
 
     q->last_rv = 0xFF;
+    q->hwm     = 0;
     q->rem_idx = 0;
     q->ins_idx = 0;
 }
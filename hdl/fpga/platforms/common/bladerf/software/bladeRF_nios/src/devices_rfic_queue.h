@@ -25,7 +25,18 @@
 #ifndef BLADERF_NIOS_DEVICES_RFIC_QUEUE_H_
 #define BLADERF_NIOS_DEVICES_RFIC_QUEUE_H_
 
-#define COMMAND_QUEUE_MAX 16
+/* Capacity of the write queue. May be overridden at build time; it must be a
+ * power of two and no larger than 128, as counts are kept in a uint8_t and
+ * 0xfe and 0xff are reserved for COMMAND_QUEUE_EMPTY and COMMAND_QUEUE_FULL */
+#ifndef COMMAND_QUEUE_MAX
+#define COMMAND_QUEUE_MAX 64
+#endif
+
+#if (COMMAND_QUEUE_MAX < 1) || (COMMAND_QUEUE_MAX > 128) || \
+    ((COMMAND_QUEUE_MAX & (COMMAND_QUEUE_MAX - 1)) != 0)
+#error "COMMAND_QUEUE_MAX must be a power of two between 1 and 128"
+#endif
+
 #define COMMAND_QUEUE_FULL 0xff
 #define COMMAND_QUEUE_EMPTY 0xfe
 
@@ -57,6 +68,7 @@ struct rfic_queue {
     uint8_t ins_idx; /* Insertion index */
     uint8_t rem_idx; /* Removal index */
     uint8_t last_rv; /* Returned value from executing last command */
+    uint8_t hwm;     /* Largest count seen since the last reset */
 
     struct rfic_queue_entry entries[COMMAND_QUEUE_MAX];
 };
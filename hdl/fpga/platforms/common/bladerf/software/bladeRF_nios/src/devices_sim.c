@@ -54,7 +54,8 @@ const char *module2str(bladerf_module m)
     }
 }
 
-void bladerf_nios_init(struct pkt_buf *pkt)
+void bladerf_nios_init(struct pkt_buf *pkt,
+                       struct vctcxo_tamer_pkt_buf *vctcxo_tamer_pkt)
 {
     DBG("%s()\n", __FUNCTION__);
 }
@@ -75,14 +76,14 @@ void lms6_write(uint8_t addr, uint8_t data)
 
 uint64_t adi_spi_read(uint16_t addr) {
     const uint64_t ret = 0x17;
-    DBG("%s: addr=0x%04x, returning 0x%04x\n", __FUNCTION__, addr, ret);
+    DBG("%s: addr=0x%04x, returning 0x%04"PRIx64"\n", __FUNCTION__, addr, ret);
     ASSERT(addr == 0x2f2f);
     return ret;
 }
 
 void adi_spi_write(uint16_t addr, uint64_t data)
 {
-    DBG("%s: addr=0x%04x, data=0x%04x\n", __FUNCTION__, addr, data);
+    DBG("%s: addr=0x%04x, data=0x%04"PRIx64"\n", __FUNCTION__, addr, data);
     ASSERT(addr == 0x0707);
     ASSERT(data == 0x09);
 }
@@ -118,6 +119,56 @@ void vctcxo_trim_dac_read(uint8_t cmd, uint16_t *val)
     ASSERT(cmd == 0x98);
 }
 
+uint16_t vctcxo_trim_dac_value = 0x1234;
+
+void vctcxo_tamer_enable_isr(bool enable)
+{
+    DBG("%s: enable=%d\n", __FUNCTION__, enable);
+}
+
+void vctcxo_tamer_reset_counters(bool reset)
+{
+    DBG("%s: reset=%d\n", __FUNCTION__, reset);
+}
+
+void vctcxo_tamer_set_tune_mode(bladerf_vctcxo_tamer_mode mode)
+{
+    DBG("%s: mode=%d\n", __FUNCTION__, mode);
+}
+
+bladerf_vctcxo_tamer_mode vctcxo_tamer_get_tune_mode()
+{
+    DBG("%s: returning %d\n", __FUNCTION__, BLADERF_VCTCXO_TAMER_DISABLED);
+    return BLADERF_VCTCXO_TAMER_DISABLED;
+}
+
+void tx_trigger_ctl_write(uint8_t data)
+{
+    DBG("%s: data=0x%02x\n", __FUNCTION__, data);
+}
+
+uint8_t tx_trigger_ctl_read(void)
+{
+    DBG("%s: returning 0x00\n", __FUNCTION__);
+    return 0x00;
+}
+
+void rx_trigger_ctl_write(uint8_t data)
+{
+    DBG("%s: data=0x%02x\n", __FUNCTION__, data);
+}
+
+uint8_t rx_trigger_ctl_read(void)
+{
+    DBG("%s: returning 0x00\n", __FUNCTION__);
+    return 0x00;
+}
+
+void agc_dc_corr_write(uint16_t addr, uint16_t value)
+{
+    DBG("%s: addr=0x%04x, value=0x%04x\n", __FUNCTION__, addr, value);
+}
+
 void adf4351_write(uint32_t val)
 {
     DBG("%s: val=0x%08x\n", __FUNCTION__, val);
@@ -137,6 +188,17 @@ void control_reg_write(uint32_t value)
     ASSERT(value == 0x80402057);
 }
 
+uint32_t rffe_csr_read(void)
+{
+    DBG("%s: returning 0x00000000\n", __FUNCTION__);
+    return 0;
+}
+
+void rffe_csr_write(uint32_t value)
+{
+    DBG("%s: value=0x%08x\n", __FUNCTION__, value);
+}
+
 uint16_t iqbal_get_gain(bladerf_module m)
 {
     uint16_t ret = 0xffff;
@@ -309,6 +371,25 @@ void tamer_schedule(bladerf_module m, uint64_t time) {
     DBG("%s: module=%s, time=%"PRIu64"\n", __FUNCTION__, module2str(m), time);
 }
 
+struct retune_stats retune_stats_rx;
+struct retune_stats retune_stats_tx;
+
+void retune_stats_record(bladerf_module m, uint64_t scheduled, uint64_t start,
+                         bool locked)
+{
+    struct retune_stats *s =
+        (m == BLADERF_MODULE_RX) ? &retune_stats_rx : &retune_stats_tx;
+
+    DBG("%s: module=%s, scheduled=%"PRIu64", start=%"PRIu64", locked=%d\n",
+        __FUNCTION__, module2str(m), scheduled, start, locked);
+
+    s->complete  = time_tamer_read(m);
+    s->scheduled = scheduled;
+    s->start     = start;
+    s->locked    = locked;
+    s->valid     = true;
+}
+
 int lms_set_precalculated_frequency(struct bladerf *dev, bladerf_module mod,
                                     struct lms_freq *f)
 {
@@ -318,6 +399,37 @@ int lms_set_precalculated_frequency(struct bladerf *dev, bladerf_module mod,
     return 0;
 }
 
+int lms_tune_vcocap(struct bladerf *dev, bladerf_module mod,
+                    uint8_t vcocap_est, uint8_t *vcocap_result, bool *locked)
+{
+    DBG("%s: module=%s, vcocap_est=0x%02x\n",
+        __FUNCTION__, module2str(mod), vcocap_est);
+
+    *vcocap_result = vcocap_est;
+    *locked = true;
+    return 0;
+}
+
+int lms_dc_cal_loop(struct bladerf *dev, uint8_t base,
+                    uint8_t cal_address, uint8_t dc_cntval,
+                    uint8_t *dc_regval)
+{
+    DBG("%s: base=0x%02x, cal_address=0x%02x, dc_cntval=0x%02x\n",
+        __FUNCTION__, base, cal_address, dc_cntval);
+
+    *dc_regval = dc_cntval;
+    return 0;
+}
+
+int lms_load_dc_cal_value(struct bladerf *dev, uint8_t base,
+                          uint8_t dc_addr, uint8_t value)
+{
+    DBG("%s: base=0x%02x, dc_addr=0x%02x, value=0x%02x\n",
+        __FUNCTION__, base, dc_addr, value);
+
+    return 0;
+}
+
 int lms_select_band(struct bladerf *dev, bladerf_module module, bool low_band)
 {
     DBG("%s: module=%s, low_band=%s\n", __FUNCTION__, module2str(module),
@@ -375,4 +487,204 @@ bool rfic_command_read(uint16_t addr, uint64_t *data)
     return true;
 }
 
+
+#ifdef BOARD_BLADERF_MICRO
+fastlock_profile fastlocks_rx[NUM_BBP_FASTLOCK_PROFILES];
+fastlock_profile fastlocks_tx[NUM_BBP_FASTLOCK_PROFILES];
+
+uint32_t adi_axi_read(uint16_t addr)
+{
+    DBG("%s: addr=0x%04x, returning 0x00000000\n", __FUNCTION__, addr);
+    return 0;
+}
+
+void adi_axi_write(uint16_t addr, uint32_t data)
+{
+    DBG("%s: addr=0x%04x, data=0x%08x\n", __FUNCTION__, addr, data);
+}
+
+void adi_fastlock_save(bool is_tx, uint8_t rffe_profile,
+                          uint16_t nios_profile)
+{
+    DBG("%s: is_tx=%d, rffe_profile=%u, nios_profile=%u\n",
+        __FUNCTION__, is_tx, rffe_profile, nios_profile);
+}
+
+uint64_t adi_fastlock_read(bool is_tx, bool upper, uint8_t nios_profile)
+{
+    DBG("%s: is_tx=%d, upper=%d, nios_profile=%u\n",
+        __FUNCTION__, is_tx, upper, nios_profile);
+    return 0;
+}
+
+void adi_fastlock_write(bool is_tx, bool upper, uint8_t rffe_profile,
+                        uint8_t nios_profile, uint64_t data)
+{
+    DBG("%s: is_tx=%d, upper=%d, rffe_profile=%u, nios_profile=%u, "
+        "data=0x%016"PRIx64"\n", __FUNCTION__, is_tx, upper, rffe_profile,
+        nios_profile, data);
+}
+
+void adi_fastlock_load(bladerf_module m, fastlock_profile *p)
+{
+    DBG("%s: module=%s, profile=%u\n", __FUNCTION__, module2str(m),
+        p->profile_num);
+}
+
+void adi_fastlock_recall(bladerf_module m, fastlock_profile *p)
+{
+    DBG("%s: module=%s, profile=%u\n", __FUNCTION__, module2str(m),
+        p->profile_num);
+}
+
+void adi_rfport_select(fastlock_profile *p)
+{
+    DBG("%s: port=0x%02x\n", __FUNCTION__, p->port);
+}
+
+void adi_rfspdt_select(bladerf_module m, fastlock_profile *p)
+{
+    DBG("%s: module=%s, spdt=0x%02x\n", __FUNCTION__, module2str(m), p->spdt);
+}
+
+bool adi_synth_locked(bladerf_module m)
+{
+    DBG("%s: module=%s, returning true\n", __FUNCTION__, module2str(m));
+    return true;
+}
+
+uint16_t ina219_read(uint8_t addr)
+{
+    DBG("%s: addr=0x%02x, returning 0x0000\n", __FUNCTION__, addr);
+    return 0;
+}
+
+void ina219_write(uint8_t addr, uint16_t data)
+{
+    DBG("%s: addr=0x%02x, data=0x%04x\n", __FUNCTION__, addr, data);
+}
+
+void ad56x1_vctcxo_trim_dac_write(uint16_t val)
+{
+    DBG("%s: val=0x%04x\n", __FUNCTION__, val);
+}
+
+void ad56x1_vctcxo_trim_dac_read(uint16_t *val)
+{
+    *val = 0x1234;
+    DBG("%s: val=0x%04x\n", __FUNCTION__, *val);
+}
+
+void adf400x_spi_write(uint32_t val)
+{
+    DBG("%s: val=0x%08x\n", __FUNCTION__, val);
+}
+
+uint32_t adf400x_spi_read(uint8_t addr)
+{
+    DBG("%s: addr=0x%02x, returning 0x00000000\n", __FUNCTION__, addr);
+    return 0;
+}
+
+void rx_ddc_ctl_write(uint32_t data)
+{
+    DBG("%s: data=0x%08x\n", __FUNCTION__, data);
+}
+
+uint32_t rx_ddc_ctl_read(void)
+{
+    DBG("%s: returning 0x00000000\n", __FUNCTION__);
+    return 0;
+}
+
+void tx_duc_ctl_write(uint32_t data)
+{
+    DBG("%s: data=0x%08x\n", __FUNCTION__, data);
+}
+
+uint32_t tx_duc_ctl_read(void)
+{
+    DBG("%s: returning 0x00000000\n", __FUNCTION__);
+    return 0;
+}
+
+void rx_power_ctl_write(uint32_t data)
+{
+    DBG("%s: data=0x%08x\n", __FUNCTION__, data);
+}
+
+bool rx_power_read(uint8_t addr, uint32_t *data)
+{
+    *data = 0;
+    DBG("%s: addr=0x%02x, returning 0x%08x\n", __FUNCTION__, addr, *data);
+    return true;
+}
+
+bool rx_burst_write(uint8_t addr, uint32_t data)
+{
+    DBG("%s: addr=0x%02x, data=0x%08x\n", __FUNCTION__, addr, data);
+    return true;
+}
+
+bool rx_burst_read(uint8_t addr, uint32_t *data)
+{
+    *data = 0;
+    DBG("%s: addr=0x%02x, returning 0x%08x\n", __FUNCTION__, addr, *data);
+    return true;
+}
+
+bool fifo_level_write(uint8_t addr, uint32_t data)
+{
+    DBG("%s: addr=0x%02x, data=0x%08x\n", __FUNCTION__, addr, data);
+    return true;
+}
+
+bool fifo_level_read(uint8_t addr, uint32_t *data)
+{
+    *data = 0;
+    DBG("%s: addr=0x%02x, returning 0x%08x\n", __FUNCTION__, addr, *data);
+    return true;
+}
+
+bool tx_loop_write(uint8_t addr, uint32_t data)
+{
+    DBG("%s: addr=0x%02x, data=0x%08x\n", __FUNCTION__, addr, data);
+    return true;
+}
+
+bool tx_loop_read(uint8_t addr, uint32_t *data)
+{
+    *data = 0;
+    DBG("%s: addr=0x%02x, returning 0x%08x\n", __FUNCTION__, addr, *data);
+    return true;
+}
+
+bool vctcxo_tamer_seed_write(uint8_t addr, uint32_t data)
+{
+    DBG("%s: addr=0x%02x, data=0x%08x\n", __FUNCTION__, addr, data);
+    return true;
+}
+
+bool vctcxo_tamer_seed_read(uint8_t addr, uint32_t *data)
+{
+    *data = 0;
+    DBG("%s: addr=0x%02x, returning 0x%08x\n", __FUNCTION__, addr, *data);
+    return true;
+}
+
+bool trigger_timer_write(uint8_t addr, uint64_t data)
+{
+    DBG("%s: addr=0x%02x, data=0x%016"PRIx64"\n", __FUNCTION__, addr, data);
+    return true;
+}
+
+bool trigger_timer_read(uint8_t addr, uint64_t *data)
+{
+    *data = 0;
+    DBG("%s: addr=0x%02x, returning 0x%016"PRIx64"\n", __FUNCTION__, addr,
+        *data);
+    return true;
+}
+#endif  // BOARD_BLADERF_MICRO
+
 #endif
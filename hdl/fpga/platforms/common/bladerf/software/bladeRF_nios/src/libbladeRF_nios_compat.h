@@ -39,7 +39,9 @@
 /* libbladeRF code uses a FIELD_INIT macro as an MSVC workaround */
 #define FIELD_INIT(param, ...) param = __VA_ARGS__
 
-#define ARRAY_SIZE(n) (sizeof(n) / sizeof(n[0]))
+#ifndef ARRAY_SIZE
+#   define ARRAY_SIZE(n) (sizeof(n) / sizeof(n[0]))
+#endif
 
 /* For >= 1.5 GHz uses the high band should be used. Otherwise, the low
  * band should be selected */
@@ -53,7 +55,9 @@
 #define log_error(...)   DBG(__VA_ARGS__)
 #define log_fatal(...)   DBG(__VA_ARGS__)
 
-/* Output formats... "x" is what alt_printf supports */
+/* Output formats... "x" is what alt_printf supports. PC simulation builds
+ * use printf, so they keep the standard definitions. */
+#ifndef BLADERF_NIOS_PC_SIMULATION
 #ifdef PRIi64
 #undef PRIi64
 #endif
@@ -64,6 +68,7 @@
 
 #define PRIi64 "x"
 #define PRIu64 "x"
+#endif
 
 /* NIOS II builds don't need a device handle. Just forward-declare it to avoid
  * complaints from unused functions */
@@ -80,6 +85,26 @@ struct bladerf;
         0; /* "Return" 0 */ \
     })
 
+/* Register accesses are local to the NIOS II, so batches are simply
+ * performed in order */
+struct backend_reg_op {
+    uint8_t addr;
+    uint8_t data;
+    bool write;
+};
+
+#   define LMS_BATCH(dev, ops, count) ({ \
+        unsigned int i_; \
+        for (i_ = 0; i_ < (count); i_++) { \
+            if ((ops)[i_].write) { \
+                lms6_write((ops)[i_].addr, (ops)[i_].data); \
+            } else { \
+                (ops)[i_].data = lms6_read((ops)[i_].addr); \
+            } \
+        } \
+        0; /* "Return" 0 */ \
+    })
+
 #   define CONFIG_GPIO_READ(dev, data_ptr) ({ \
         *(data_ptr) = control_reg_read(); \
         0; /* "Return" 0 */ \
@@ -45,6 +45,17 @@ static inline bool perform_write(uint8_t id, uint16_t addr, uint64_t data)
             break;
 #endif  // BLADERF_NIOS_LIBAD936X
 
+#ifdef BOARD_BLADERF_MICRO
+        case NIOS_PKT_16x64_TARGET_FASTLOCK:
+            adi_fastlock_write(
+                (addr & NIOS_PKT_16x64_FASTLOCK_TX) != 0,
+                (addr & NIOS_PKT_16x64_FASTLOCK_UPPER) != 0,
+                (addr & NIOS_PKT_16x64_FASTLOCK_RFFE_MASK) >>
+                    NIOS_PKT_16x64_FASTLOCK_RFFE_SHIFT,
+                addr & NIOS_PKT_16x64_FASTLOCK_NIOS_MASK, data);
+            break;
+#endif  // BOARD_BLADERF_MICRO
+
         /* Add user customizations here
 
         case NIOS_PKT_16x64_TARGET_USR1:
@@ -78,6 +89,15 @@ static inline bool perform_read(uint8_t id, uint16_t addr, uint64_t *data)
             break;
 #endif  // BLADERF_NIOS_LIBAD936X
 
+#ifdef BOARD_BLADERF_MICRO
+        case NIOS_PKT_16x64_TARGET_FASTLOCK:
+            *data = adi_fastlock_read(
+                (addr & NIOS_PKT_16x64_FASTLOCK_TX) != 0,
+                (addr & NIOS_PKT_16x64_FASTLOCK_UPPER) != 0,
+                addr & NIOS_PKT_16x64_FASTLOCK_NIOS_MASK);
+            break;
+#endif  // BOARD_BLADERF_MICRO
+
         /* Add user customizations here
 
         case NIOS_PKT_16x64_TARGET_USR1:
@@ -114,6 +134,80 @@ void pkt_16x64(struct pkt_buf *b)
     nios_pkt_16x64_resp_pack(b->resp, id, is_write, addr, data, success);
 }
 
+/* Single-byte accesses, as performed by pkt_16x8_batch */
+static inline bool perform_byte_write(uint8_t id, uint16_t addr, uint8_t data)
+{
+    switch (id) {
+#ifdef BOARD_BLADERF_MICRO
+        case NIOS_PKT_16x64_TARGET_AD9361:
+            /* Single-byte write command: W = 1, N = 0 */
+            adi_spi_write((1 << 15) | (addr & 0x3ff), ((uint64_t)data) << 56);
+            return true;
+#endif  // BOARD_BLADERF_MICRO
+
+        default:
+            DBG("Unsupported batch ID: 0x%x\n", id);
+            return false;
+    }
+}
+
+static inline bool perform_byte_read(uint8_t id, uint16_t addr, uint8_t *data)
+{
+    switch (id) {
+#ifdef BOARD_BLADERF_MICRO
+        case NIOS_PKT_16x64_TARGET_AD9361:
+            /* Single-byte read command: W = 0, N = 0 */
+            *data = adi_spi_read(addr & 0x3ff) >> 56;
+            return true;
+#endif  // BOARD_BLADERF_MICRO
+
+        default:
+            DBG("Unsupported batch ID: 0x%x\n", id);
+            return false;
+    }
+}
+
+void pkt_16x8_batch(struct pkt_buf *b)
+{
+    uint8_t id;
+    uint8_t count;
+    uint8_t completed = 0;
+    uint8_t i;
+
+    nios_pkt_16x8_batch_unpack(b->req, &id, &count);
+
+    if (count > NIOS_PKT_16x8_BATCH_MAX) {
+        DBG("%s: Invalid count: %u\n", __FUNCTION__, count);
+        count = 0;
+    }
+
+    nios_pkt_16x8_batch_resp_pack(b->resp, b->req, 0);
+
+    for (i = 0; i < count; i++) {
+        uint16_t addr;
+        uint8_t  data;
+        bool     is_write;
+        bool     success;
+
+        nios_pkt_16x8_batch_unpack_op(b->req, i, &is_write, &addr, &data);
+
+        if (is_write) {
+            success = perform_byte_write(id, addr, data);
+        } else {
+            success = perform_byte_read(id, addr, &data);
+            nios_pkt_16x8_batch_resp_set_data(b->resp, i, data);
+        }
+
+        if (!success) {
+            break;
+        }
+
+        completed++;
+    }
+
+    b->resp[NIOS_PKT_16x8_BATCH_IDX_COUNT] = completed;
+}
+
 void pkt_16x64_init(void)
 {
 #ifdef BLADERF_NIOS_LIBAD936X
@@ -27,6 +27,7 @@
 #include <stdint.h>
 #include "pkt_handler.h"
 #include "nios_pkt_16x64.h"
+#include "nios_pkt_16x8_batch.h"
 
 void pkt_16x64_init(void);
 
@@ -53,4 +54,14 @@ void pkt_16x64_work(void);
 }
 
 #endif  // BLADERF_NIOS_LIBAD936X
+
+void pkt_16x8_batch(struct pkt_buf *b);
+
+#define PKT_16x8_BATCH { \
+    .magic          = NIOS_PKT_16x8_BATCH_MAGIC, \
+    .init           = NULL, \
+    .exec           = pkt_16x8_batch, \
+    .do_work        = NULL, \
+}
+
 #endif
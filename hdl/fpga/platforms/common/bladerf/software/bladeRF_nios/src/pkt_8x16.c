@@ -82,6 +82,79 @@ static inline bool iq_corr_write(uint8_t addr, uint16_t data)
     return true;
 }
 
+static inline bool vcocap_search(uint8_t addr, uint16_t *data)
+{
+    bladerf_module module;
+    uint8_t vcocap;
+    bool locked;
+
+    switch (addr) {
+        case NIOS_PKT_8x16_ADDR_VCOCAP_RX:
+            module = BLADERF_MODULE_RX;
+            break;
+
+        case NIOS_PKT_8x16_ADDR_VCOCAP_TX:
+            module = BLADERF_MODULE_TX;
+            break;
+
+        default:
+            DBG("%s: Invalid VCOCAP addr: 0x%x\n", __FUNCTION__, addr);
+            return false;
+    }
+
+    if (lms_tune_vcocap(NULL, module, *data & NIOS_PKT_8x16_VCOCAP_MASK,
+                        &vcocap, &locked) != 0) {
+        return false;
+    }
+
+    /* Return the result in the response's data field */
+    *data = vcocap;
+    if (locked) {
+        *data |= NIOS_PKT_8x16_VCOCAP_LOCKED;
+    }
+
+    return true;
+}
+
+static inline bool lms_dc_cal(uint8_t addr, uint16_t *data)
+{
+    const uint8_t base = addr & NIOS_PKT_8x16_LMS_DC_CAL_BASE_MASK;
+    const uint8_t cal_addr = addr & NIOS_PKT_8x16_LMS_DC_CAL_ADDR_MASK;
+    const uint8_t value = *data & NIOS_PKT_8x16_LMS_DC_CAL_VAL_MASK;
+    uint8_t regval;
+    int status;
+
+    switch (base) {
+        case 0x00:
+        case 0x30:
+        case 0x50:
+        case 0x60:
+            break;
+
+        default:
+            DBG("%s: Invalid DC cal addr: 0x%x\n", __FUNCTION__, addr);
+            return false;
+    }
+
+    if (*data & NIOS_PKT_8x16_LMS_DC_CAL_LOAD) {
+        return lms_load_dc_cal_value(NULL, base, cal_addr, value) == 0;
+    }
+
+    status = lms_dc_cal_loop(NULL, base, cal_addr, value, &regval);
+
+    /* A loop that did not converge is reported via the DONE flag */
+    if (status != 0 && status != BLADERF_ERR_UNEXPECTED) {
+        return false;
+    }
+
+    *data = regval;
+    if (status == 0) {
+        *data |= NIOS_PKT_8x16_LMS_DC_CAL_DONE;
+    }
+
+    return true;
+}
+
 static inline bool perform_read(uint8_t id, uint8_t addr, uint16_t *data)
 {
     bool success = true;
@@ -124,30 +197,36 @@ static inline bool perform_read(uint8_t id, uint8_t addr, uint16_t *data)
 }
 
 
-static inline bool perform_write(uint8_t id, uint8_t addr, uint16_t data)
+static inline bool perform_write(uint8_t id, uint8_t addr, uint16_t *data)
 {
     switch (id) {
         case NIOS_PKT_8x16_TARGET_VCTCXO_DAC:
-            vctcxo_trim_dac_write(addr, data);
+            vctcxo_trim_dac_write(addr, *data);
             break;
 
         case NIOS_PKT_8x16_TARGET_IQ_CORR:
-            iq_corr_write(addr, data);
+            iq_corr_write(addr, *data);
             break;
 
         case NIOS_PKT_8x16_TARGET_AGC_CORR:
-            agc_dc_corr_write(addr, data);
+            agc_dc_corr_write(addr, *data);
             break;
 
+        case NIOS_PKT_8x16_TARGET_VCOCAP:
+            return vcocap_search(addr, data);
+
+        case NIOS_PKT_8x16_TARGET_LMS_DC_CAL:
+            return lms_dc_cal(addr, data);
+
 #ifdef BOARD_BLADERF_MICRO
         case NIOS_PKT_8x16_TARGET_AD56X1_DAC:
-            ad56x1_vctcxo_trim_dac_write(data);
+            ad56x1_vctcxo_trim_dac_write(*data);
             break;
 #endif  // BOARD_BLADERF_MICRO
 
 #ifdef BOARD_BLADERF_MICRO
         case NIOS_PKT_8x16_TARGET_INA219:
-            ina219_write(addr, data);
+            ina219_write(addr, *data);
             break;
 #endif  // BOARD_BLADERF_MICRO
 
@@ -178,7 +257,7 @@ void pkt_8x16(struct pkt_buf *b)
     nios_pkt_8x16_unpack(b->req, &id, &is_write, &addr, &data);
 
     if (is_write) {
-        success = perform_write(id, addr, data);
+        success = perform_write(id, addr, &data);
     } else {
         success = perform_read(id, addr, &data);
     }
@@ -62,6 +62,58 @@ static inline bool perform_read(uint8_t id, uint8_t addr, uint32_t *data)
             return false;
 #endif  // BOARD_BLADERF_MICRO
 
+#ifdef BOARD_BLADERF_MICRO
+        case NIOS_PKT_8x32_TARGET_RX_DDC:
+            *data = rx_ddc_ctl_read();
+            break;
+
+        case NIOS_PKT_8x32_TARGET_TX_DUC:
+            *data = tx_duc_ctl_read();
+            break;
+
+        case NIOS_PKT_8x32_TARGET_RX_BURST:
+            if (!rx_burst_read(addr, data)) {
+                DBG("Invalid RX burst gate address: 0x%x\n", addr);
+                *data = 0x00;
+                return false;
+            }
+            break;
+
+        case NIOS_PKT_8x32_TARGET_RX_POWER:
+            if (!rx_power_read(addr, data)) {
+                DBG("Invalid RX power detector address: 0x%x\n", addr);
+                *data = 0x00;
+                return false;
+            }
+            break;
+
+        case NIOS_PKT_8x32_TARGET_FIFO_LEVEL:
+            if (!fifo_level_read(addr, data)) {
+                DBG("Invalid FIFO level address: 0x%x\n", addr);
+                *data = 0x00;
+                return false;
+            }
+            break;
+
+        case NIOS_PKT_8x32_TARGET_TX_LOOP:
+            if (!tx_loop_read(addr, data)) {
+                DBG("Invalid TX loop address: 0x%x\n", addr);
+                *data = 0x00;
+                return false;
+            }
+            break;
+#endif  // BOARD_BLADERF_MICRO
+
+#ifndef BOARD_BLADERF_MICRO
+        case NIOS_PKT_8x32_TARGET_VCTCXO_TAMER:
+            if (!vctcxo_tamer_seed_read(addr, data)) {
+                DBG("Invalid VCTCXO tamer address: 0x%x\n", addr);
+                *data = 0x00;
+                return false;
+            }
+            break;
+#endif  // BOARD_BLADERF_MICRO
+
         default:
             DBG("Invalid id: 0x%x\n", id);
             *data = 0x00;
@@ -102,6 +154,54 @@ static inline bool perform_write(uint8_t id, uint8_t addr, uint32_t data)
             break;
 #endif  // BOARD_BLADERF_MICRO
 
+#ifdef BOARD_BLADERF_MICRO
+        case NIOS_PKT_8x32_TARGET_RX_DDC:
+            rx_ddc_ctl_write(data);
+            break;
+
+        case NIOS_PKT_8x32_TARGET_TX_DUC:
+            tx_duc_ctl_write(data);
+            break;
+
+        case NIOS_PKT_8x32_TARGET_RX_POWER:
+            if (addr != NIOS_PKT_8x32_RX_POWER_ADDR_CONFIG) {
+                DBG("Invalid write to RX power detector result.\n");
+                return false;
+            }
+            rx_power_ctl_write(data);
+            break;
+
+        case NIOS_PKT_8x32_TARGET_RX_BURST:
+            if (!rx_burst_write(addr, data)) {
+                DBG("Invalid RX burst gate address: 0x%x\n", addr);
+                return false;
+            }
+            break;
+
+        case NIOS_PKT_8x32_TARGET_FIFO_LEVEL:
+            if (!fifo_level_write(addr, data)) {
+                DBG("Invalid write to FIFO level address: 0x%x\n", addr);
+                return false;
+            }
+            break;
+
+        case NIOS_PKT_8x32_TARGET_TX_LOOP:
+            if (!tx_loop_write(addr, data)) {
+                DBG("Invalid write to TX loop address: 0x%x\n", addr);
+                return false;
+            }
+            break;
+#endif  // BOARD_BLADERF_MICRO
+
+#ifndef BOARD_BLADERF_MICRO
+        case NIOS_PKT_8x32_TARGET_VCTCXO_TAMER:
+            if (!vctcxo_tamer_seed_write(addr, data)) {
+                DBG("Invalid write to VCTCXO tamer address: 0x%x\n", addr);
+                return false;
+            }
+            break;
+#endif  // BOARD_BLADERF_MICRO
+
         default:
             DBG("Invalid id: 0x%x\n", id);
             return false;
@@ -35,6 +35,19 @@ static inline bool perform_write(uint8_t id, uint8_t addr, uint64_t data)
             DBG("Invalid write access to timestamp: 0x%x\n", addr);
             return false;
 
+        case NIOS_PKT_8x64_TARGET_RETUNE_STATS:
+            DBG("Invalid write access to retune stats: 0x%x\n", addr);
+            return false;
+
+#ifdef BOARD_BLADERF_MICRO
+        case NIOS_PKT_8x64_TARGET_TRIGGER:
+            if (!trigger_timer_write(addr, data)) {
+                DBG("Invalid write to trigger field: 0x%x\n", addr);
+                return false;
+            }
+            return true;
+#endif  // BOARD_BLADERF_MICRO
+
         /* Add user customizations here
 
         case NIOS_PKT_8x64_TARGET_USR1:
@@ -68,6 +81,38 @@ static inline bool read_timestamp(uint8_t addr, uint64_t *data)
     return true;
 }
 
+static inline bool read_retune_stats(uint8_t addr, uint64_t *data)
+{
+    struct retune_stats const *s = (addr & NIOS_PKT_8x64_RETUNE_STATS_TX)
+                                       ? &retune_stats_tx
+                                       : &retune_stats_rx;
+
+    switch (addr & NIOS_PKT_8x64_RETUNE_STATS_FIELD_MASK) {
+        case NIOS_PKT_8x64_RETUNE_STATS_SCHEDULED:
+            *data = s->scheduled;
+            break;
+
+        case NIOS_PKT_8x64_RETUNE_STATS_START:
+            *data = s->start;
+            break;
+
+        case NIOS_PKT_8x64_RETUNE_STATS_COMPLETE:
+            *data = s->complete;
+            break;
+
+        case NIOS_PKT_8x64_RETUNE_STATS_FLAGS:
+            *data = (s->valid ? NIOS_PKT_8x64_RETUNE_STATS_FLAG_VALID : 0) |
+                    (s->locked ? NIOS_PKT_8x64_RETUNE_STATS_FLAG_LOCKED : 0);
+            break;
+
+        default:
+            DBG("Invalid addr: 0x%x\n", addr);
+            return false;
+    }
+
+    return true;
+}
+
 static inline bool perform_read(uint8_t id, uint8_t addr, uint64_t *data)
 {
     bool success;
@@ -77,6 +122,19 @@ static inline bool perform_read(uint8_t id, uint8_t addr, uint64_t *data)
             success = read_timestamp(addr, data);
             break;
 
+        case NIOS_PKT_8x64_TARGET_RETUNE_STATS:
+            success = read_retune_stats(addr, data);
+            break;
+
+#ifdef BOARD_BLADERF_MICRO
+        case NIOS_PKT_8x64_TARGET_TRIGGER:
+            success = trigger_timer_read(addr, data);
+            if (!success) {
+                DBG("Invalid trigger field: 0x%x\n", addr);
+            }
+            break;
+#endif  // BOARD_BLADERF_MICRO
+
         /* Add user customizations here
 
         case NIOS_PKT_8x64_TARGET_USR1:
@@ -144,3 +144,84 @@ void pkt_8x8(struct pkt_buf *b)
 
     nios_pkt_8x8_resp_pack(b->resp, id, is_write, addr, data, success);
 }
+
+void pkt_8x8_batch(struct pkt_buf *b)
+{
+    uint8_t id;
+    uint8_t count;
+    uint8_t completed = 0;
+    uint8_t i;
+
+    nios_pkt_8x8_batch_unpack(b->req, &id, &count);
+
+    if (count > NIOS_PKT_8x8_BATCH_MAX) {
+        DBG("%s: Invalid count: %u\n", __FUNCTION__, count);
+        count = 0;
+    }
+
+    nios_pkt_8x8_batch_resp_pack(b->resp, b->req, 0);
+
+    for (i = 0; i < count; i++) {
+        uint8_t addr;
+        uint8_t data;
+        bool    is_write;
+        bool    success;
+
+        nios_pkt_8x8_batch_unpack_op(b->req, i, &is_write, &addr, &data);
+
+        if (is_write) {
+            success = perform_write(id, addr, data);
+        } else {
+            success = perform_read(id, addr, &data);
+            nios_pkt_8x8_batch_resp_set_data(b->resp, i, data);
+        }
+
+        if (!success) {
+            break;
+        }
+
+        completed++;
+    }
+
+    b->resp[NIOS_PKT_8x8_BATCH_IDX_COUNT] = completed;
+}
+
+void pkt_8x8_block(struct pkt_buf *b)
+{
+    uint8_t id;
+    uint8_t addr;
+    uint8_t count;
+    uint8_t completed = 0;
+    uint8_t i;
+    bool    is_write;
+
+    nios_pkt_8x8_block_unpack(b->req, &id, &is_write, &addr, &count);
+
+    if (count > NIOS_PKT_8x8_BLOCK_MAX || (addr + count - 1) > 0xff) {
+        DBG("%s: Invalid range: 0x%x, %u\n", __FUNCTION__, addr, count);
+        count = 0;
+    }
+
+    nios_pkt_8x8_block_resp_pack(b->resp, b->req, 0);
+
+    for (i = 0; i < count; i++) {
+        uint8_t data;
+        bool    success;
+
+        if (is_write) {
+            data    = b->req[NIOS_PKT_8x8_BLOCK_IDX_DATA + i];
+            success = perform_write(id, addr + i, data);
+        } else {
+            success = perform_read(id, addr + i, &data);
+            nios_pkt_8x8_block_resp_set_data(b->resp, i, data);
+        }
+
+        if (!success) {
+            break;
+        }
+
+        completed++;
+    }
+
+    b->resp[NIOS_PKT_8x8_BLOCK_IDX_COUNT] = completed;
+}
@@ -27,6 +27,8 @@
 #include <stdint.h>
 #include "pkt_handler.h"
 #include "nios_pkt_8x8.h"
+#include "nios_pkt_8x8_batch.h"
+#include "nios_pkt_8x8_block.h"
 
 void pkt_8x8(struct pkt_buf *b);
 
@@ -37,4 +39,22 @@ void pkt_8x8(struct pkt_buf *b);
     .do_work        = NULL, \
 }
 
+void pkt_8x8_batch(struct pkt_buf *b);
+
+#define PKT_8x8_BATCH { \
+    .magic          = NIOS_PKT_8x8_BATCH_MAGIC, \
+    .init           = NULL, \
+    .exec           = pkt_8x8_batch, \
+    .do_work        = NULL, \
+}
+
+void pkt_8x8_block(struct pkt_buf *b);
+
+#define PKT_8x8_BLOCK { \
+    .magic          = NIOS_PKT_8x8_BLOCK_MAGIC, \
+    .init           = NULL, \
+    .exec           = pkt_8x8_block, \
+    .do_work        = NULL, \
+}
+
 #endif
@@ -24,6 +24,7 @@
 #ifndef PKT_HANDLER_H_
 #define PKT_HANDLER_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include "nios_pkt_formats.h"
@@ -39,6 +40,10 @@ struct pkt_buf {
     const uint8_t req[NIOS_PKT_LEN];      /* Request */
     uint8_t       resp[NIOS_PKT_LEN];     /* Response */
     volatile bool ready;                  /* Ready flag */
+
+    /* Timestamp latched by the ISR upon receipt of a timestamp latch
+     * request, for the module it selects */
+    volatile uint64_t latch;
 };
 
 // This is temporary until we figure out where to put it
@@ -50,6 +55,16 @@ struct vctcxo_tamer_pkt_buf {
     volatile bool    pps_10s_error_flag;
     volatile int32_t pps_100s_error;
     volatile bool    pps_100s_error_flag;
+
+    /* Trim and slope to start fine tuning from, set by the host */
+    volatile bool    seed_pending;
+    volatile uint16_t seed_trim;
+    volatile int32_t seed_slope;
+
+    /* Slope in use and NIOS_PKT_8x32_VCTCXO_TAMER_STATE_*, kept up to date
+     * by the tuning loop */
+    volatile int32_t slope;
+    volatile uint8_t state;
 };
 
 struct pkt_handler {
@@ -77,5 +92,64 @@ struct pkt_handler {
     void (*do_work)(void);
 };
 
+/* Upper bound on the number of packet handlers providing do_work() */
+#define PKT_DISPATCH_MAX_WORK 16
+
+/**
+ * Packet handlers, indexed by magic value so that a request is dispatched
+ * with a single lookup, and the list of handlers that have deferred work
+ */
+struct pkt_dispatch {
+    const struct pkt_handler *by_magic[256];
+    void (*work[PKT_DISPATCH_MAX_WORK])(void);
+    uint8_t num_work;
+};
+
+/**
+ * Initialize each packet handler and populate the dispatch tables
+ */
+static inline void pkt_dispatch_init(struct pkt_dispatch *d,
+                                     const struct pkt_handler *handlers,
+                                     uint8_t num_handlers)
+{
+    uint8_t i;
+
+    memset(d, 0, sizeof(*d));
+
+    for (i = 0; i < num_handlers; i++) {
+        if (handlers[i].init != NULL) {
+            handlers[i].init();
+        }
+
+        d->by_magic[handlers[i].magic] = &handlers[i];
+
+        if (handlers[i].do_work != NULL &&
+            d->num_work < PKT_DISPATCH_MAX_WORK) {
+            d->work[d->num_work++] = handlers[i].do_work;
+        }
+    }
+}
+
+/**
+ * Look up the handler for a request. Returns NULL for an invalid magic.
+ */
+static inline const struct pkt_handler *pkt_dispatch_lookup(
+    const struct pkt_dispatch *d, uint8_t magic)
+{
+    return d->by_magic[magic];
+}
+
+/**
+ * Perform each handler's deferred work
+ */
+static inline void pkt_dispatch_work(const struct pkt_dispatch *d)
+{
+    uint8_t i;
+
+    for (i = 0; i < d->num_work; i++) {
+        d->work[i]();
+    }
+}
+
 
 #endif
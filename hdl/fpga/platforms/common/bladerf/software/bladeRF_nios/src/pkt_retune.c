@@ -50,11 +50,26 @@ enum entry_state {
                                * this entry and are awaiting the ISR */
     ENTRY_STATE_READY,        /* The timer interrupt has fired - we should
                                * handle this retune */
+    ENTRY_STATE_CANCELLED,    /* The host cancelled this retune. It is
+                               * dropped once it reaches the queue head. */
+};
+
+/* Corrections applied along with a retune (NIOS_PKT_RETUNE_OP_CORRECT) */
+struct retune_corr {
+    uint8_t flags;      /* NIOS_PKT_RETUNE_CORR_* bits. 0 if none. */
+    uint8_t dc_i;       /* LMS6002D register values */
+    uint8_t dc_q;
+    uint16_t gain;      /* IQ balance register values */
+    uint16_t phase;
+    uint8_t lna;        /* LMS6002D gain stage register values */
+    uint8_t vga1;
+    uint8_t vga2;
 };
 
 struct queue_entry {
     volatile enum entry_state state;
     struct lms_freq freq;
+    struct retune_corr corr;
     uint64_t timestamp;
 };
 
@@ -63,6 +78,9 @@ static struct queue {
     uint8_t ins_idx;    /* Insertion index */
     uint8_t rem_idx;    /* Removal index */
 
+    /* Corrections staged for the next retune request */
+    struct retune_corr staged;
+
     struct queue_entry entries[RETUNE_QUEUE_MAX];
 } rx_queue, tx_queue;
 
@@ -70,6 +88,7 @@ static struct queue {
  * not enqueue the requested item */
 static inline uint8_t enqueue_retune(struct queue *q,
                                      const struct lms_freq *f,
+                                     const struct retune_corr *c,
                                      uint64_t timestamp)
 {
     uint8_t ret;
@@ -79,6 +98,7 @@ static inline uint8_t enqueue_retune(struct queue *q,
     }
 
     memcpy(&q->entries[q->ins_idx].freq, f, sizeof(f[0]));
+    memcpy(&q->entries[q->ins_idx].corr, c, sizeof(c[0]));
 
     q->entries[q->ins_idx].state = ENTRY_STATE_NEW;
     q->entries[q->ins_idx].timestamp = timestamp;
@@ -102,7 +122,7 @@ static inline uint8_t dequeue_retune(struct queue *q, struct queue_entry *e)
     }
 
     if (e != NULL) {
-        memcpy(&e, &q->entries[q->rem_idx], sizeof(e[0]));
+        memcpy(e, &q->entries[q->rem_idx], sizeof(e[0]));
     }
 
     q->rem_idx = (q->rem_idx + 1) & (RETUNE_QUEUE_MAX - 1);
@@ -123,6 +143,69 @@ static inline struct queue_entry * peek_next_retune(struct queue *q)
     }
 }
 
+/* Get the pending entry scheduled at the specified timestamp, at or after
+ * the given offset from the removal index. Returns the offset of the entry,
+ * or QUEUE_EMPTY if there is none. */
+static inline uint8_t find_retune(struct queue *q, uint64_t timestamp,
+                                  uint8_t offset)
+{
+    struct queue_entry *e;
+
+    for (; offset < q->count; offset++) {
+        e = &q->entries[(q->rem_idx + offset) & (RETUNE_QUEUE_MAX - 1)];
+
+        if (e->timestamp == timestamp &&
+            (e->state == ENTRY_STATE_NEW ||
+             e->state == ENTRY_STATE_SCHEDULED)) {
+            return offset;
+        }
+    }
+
+    return QUEUE_EMPTY;
+}
+
+/* Cancel the pending retunes scheduled at the specified timestamp. Entries
+ * remain in place, so that the queue is never reordered beneath the timer
+ * interrupt, and are dropped when they reach the head of the queue.
+ *
+ * If the timer interrupt for the head entry fires during this call, the
+ * retune is simply not performed. Returns the number of cancelled entries. */
+static uint8_t cancel_retunes(struct queue *q, uint64_t timestamp)
+{
+    uint8_t offset = 0;
+    uint8_t n = 0;
+
+    while ((offset = find_retune(q, timestamp, offset)) != QUEUE_EMPTY) {
+        q->entries[(q->rem_idx + offset) & (RETUNE_QUEUE_MAX - 1)].state =
+            ENTRY_STATE_CANCELLED;
+        offset++;
+        n++;
+    }
+
+    return n;
+}
+
+/* Replace the tuning parameters of the pending retune scheduled at the
+ * specified timestamp. Returns false if there is no such retune. */
+static bool replace_retune(struct queue *q, const struct lms_freq *f,
+                           const struct retune_corr *c, uint64_t timestamp)
+{
+    uint8_t offset = find_retune(q, timestamp, 0);
+    struct queue_entry *e;
+
+    if (offset == QUEUE_EMPTY) {
+        return false;
+    }
+
+    /* The parameters are not used until the entry is ready, so they may be
+     * updated in place even if the timer has already been armed */
+    e = &q->entries[(q->rem_idx + offset) & (RETUNE_QUEUE_MAX - 1)];
+    memcpy(&e->freq, f, sizeof(f[0]));
+    memcpy(&e->corr, c, sizeof(c[0]));
+
+    return true;
+}
+
 /* The retune interrupt may fire while this call is occuring, so we should
  * perform these operations in an order that minimizes the race window, and
  * does not cause the race to be problematic. It's fine if the last retune
@@ -132,6 +215,7 @@ static void reset_queue(struct queue *q)
     unsigned int i;
 
     q->count = 0;
+    q->staged.flags = 0;
 
     for (i = 0; i < RETUNE_QUEUE_MAX; i++) {
         q->entries[i].state = ENTRY_STATE_INVALID;
@@ -146,7 +230,7 @@ static inline void retune_isr(struct queue *q)
     if (e != NULL) {
         if (e->state == ENTRY_STATE_SCHEDULED) {
             e->state = ENTRY_STATE_READY;
-        } else {
+        } else if (e->state != ENTRY_STATE_CANCELLED) {
             INCREMENT_ERROR_COUNT();
         }
     }
@@ -210,24 +294,34 @@ void pkt_retune_init()
 
 static void xb_config_write(uint8_t xb_gpio) {
    uint32_t val;
-   val = expansion_port_read();
+   bool mix;
+
    if (!(xb_gpio & LMS_FREQ_XB_200_ENABLE)) {
       return;
    }
+
+   val = expansion_port_read();
+   /* The mixer is only enabled when the path goes through it, as
+    * xb200_set_path() does on the host */
+   mix = ((xb_gpio & LMS_FREQ_XB_200_PATH) >> LMS_FREQ_XB_200_PATH_SHIFT) & 1;
    if (xb_gpio & LMS_FREQ_XB_200_MODULE_RX) {
-      val &= ~(0x30000000 | 0x30);
+      val &= ~(0x30000000 | 0x30 | BLADERF_XB_RX_ENABLE);
       val |= (((xb_gpio & LMS_FREQ_XB_200_FILTER_SW)
                         >> LMS_FREQ_XB_200_FILTER_SW_SHIFT) & 3 ) << 28;
       val |= (((xb_gpio & LMS_FREQ_XB_200_PATH)
                         >> LMS_FREQ_XB_200_PATH_SHIFT) & 3 ) << 4;
-      val |= BLADERF_XB_RX_ENABLE;
+      if (mix) {
+         val |= BLADERF_XB_RX_ENABLE;
+      }
    } else {
-      val &= ~(0x0C000000 | 0x0C);
+      val &= ~(0x0C000000 | 0x0C | BLADERF_XB_TX_ENABLE);
       val |= (((xb_gpio & LMS_FREQ_XB_200_FILTER_SW)
                         >> LMS_FREQ_XB_200_FILTER_SW_SHIFT) & 3 ) << 26;
       val |= (((xb_gpio & LMS_FREQ_XB_200_PATH)
                            >> LMS_FREQ_XB_200_PATH_SHIFT) & 3 ) << 2;
-      val |= BLADERF_XB_TX_ENABLE;
+      if (mix) {
+         val |= BLADERF_XB_TX_ENABLE;
+      }
    }
    expansion_port_write(val);
 
@@ -239,7 +333,7 @@ static void xb_config_write(uint8_t xb_gpio) {
 #define LMS_TX_SWAP 0x08
 
    lreg = reg;
-   if (((xb_gpio & LMS_FREQ_XB_200_PATH) >> LMS_FREQ_XB_200_PATH_SHIFT) & 1) {
+   if (mix) {
       lreg |= (xb_gpio & LMS_FREQ_XB_200_MODULE_RX) ? LMS_RX_SWAP : LMS_TX_SWAP;
    } else {
       lreg &= ~((xb_gpio & LMS_FREQ_XB_200_MODULE_RX) ? LMS_RX_SWAP : LMS_TX_SWAP);
@@ -250,6 +344,49 @@ static void xb_config_write(uint8_t xb_gpio) {
 
 }
 
+/* Apply the corrections accompanying a retune */
+static void apply_corr(bladerf_module module, const struct retune_corr *c)
+{
+    uint8_t reg;
+
+    if (c->flags & NIOS_PKT_RETUNE_CORR_DC) {
+        if (module == BLADERF_MODULE_RX) {
+            /* Bit 7 of the RX DC offset registers is unrelated to the
+             * correction, so its state is preserved */
+            LMS_READ(NULL, 0x71, &reg);
+            LMS_WRITE(NULL, 0x71, (reg & 0x80) | (c->dc_i & 0x7f));
+
+            LMS_READ(NULL, 0x72, &reg);
+            LMS_WRITE(NULL, 0x72, (reg & 0x80) | (c->dc_q & 0x7f));
+        } else {
+            LMS_WRITE(NULL, 0x42, c->dc_i);
+            LMS_WRITE(NULL, 0x43, c->dc_q);
+        }
+    }
+
+    if (c->flags & NIOS_PKT_RETUNE_CORR_IQ) {
+        iqbal_set_gain(module, c->gain);
+        iqbal_set_phase(module, c->phase);
+    }
+
+    if (c->flags & NIOS_PKT_RETUNE_CORR_GAIN) {
+        if (module == BLADERF_MODULE_RX) {
+            /* The LNA selection shares the LNA gain register */
+            LMS_READ(NULL, 0x75, &reg);
+            LMS_WRITE(NULL, 0x75, (reg & ~(3 << 6)) | ((c->lna & 3) << 6));
+
+            LMS_WRITE(NULL, 0x76, c->vga1);
+            LMS_WRITE(NULL, 0x65, c->vga2);
+        } else {
+            LMS_WRITE(NULL, 0x41, c->vga1);
+
+            LMS_READ(NULL, 0x45, &reg);
+            reg = (reg & ~(0x1f << 3)) | ((c->vga2 & 0x1f) << 3);
+            LMS_WRITE(NULL, 0x45, reg);
+        }
+    }
+}
+
 static inline void perform_work(struct queue *q, bladerf_module module)
 {
     struct queue_entry *e = peek_next_retune(q);
@@ -269,7 +406,16 @@ static inline void perform_work(struct queue *q, bladerf_module module)
              * We're just waiting for this entry to become */
             break;
 
-        case ENTRY_STATE_READY:
+        case ENTRY_STATE_READY: {
+            uint64_t start = time_tamer_read(module);
+
+            /* Entries carrying only corrections, such as a gain change, are
+             * not retunes and are not recorded in the retune statistics */
+            if (e->corr.flags & NIOS_PKT_RETUNE_CORR_NO_TUNE) {
+                apply_corr(module, &e->corr);
+                dequeue_retune(q, NULL);
+                break;
+            }
 
             /* Perform our retune */
             if (lms_set_precalculated_frequency(NULL, module, &e->freq)) {
@@ -281,11 +427,21 @@ static inline void perform_work(struct queue *q, bladerf_module module)
                 }
 
                 xb_config_write(e->freq.xb_gpio);
+                apply_corr(module, &e->corr);
             }
 
+            retune_stats_record(module, e->timestamp, start,
+                                (e->freq.flags & LMS_FREQ_FLAGS_LOCKED) != 0);
+
             /* Drop the item from the queue */
             dequeue_retune(q, NULL);
             break;
+        }
+
+        case ENTRY_STATE_CANCELLED:
+            /* Drop the item. The next entry arms the timer in its place. */
+            dequeue_retune(q, NULL);
+            break;
 
         default:
             INCREMENT_ERROR_COUNT();
@@ -312,14 +468,43 @@ void pkt_retune(struct pkt_buf *b)
     bool low_band;
     uint8_t xb_gpio;
     bool quick_tune;
+    struct queue *q;
+    struct retune_corr corr;
 
     flags = NIOS_PKT_RETUNERESP_FLAG_SUCCESS;
 
+    if (nios_pkt_retune_get_op(b->req) == NIOS_PKT_RETUNE_OP_CORRECT) {
+        nios_pkt_retune_corr_unpack(b->req, &module, &corr.flags,
+                                    &corr.dc_i, &corr.dc_q,
+                                    &corr.gain, &corr.phase);
+
+        nios_pkt_retune_corr_get_gain(b->req, &corr.lna, &corr.vga1,
+                                      &corr.vga2);
+
+        switch (module) {
+            case BLADERF_MODULE_RX:
+                rx_queue.staged = corr;
+                break;
+
+            case BLADERF_MODULE_TX:
+                tx_queue.staged = corr;
+                break;
+
+            default:
+                INCREMENT_ERROR_COUNT();
+                flags &= ~(NIOS_PKT_RETUNERESP_FLAG_SUCCESS);
+        }
+
+        nios_pkt_retune_resp_pack(b->resp, 0, 0xff, flags);
+        return;
+    }
+
     nios_pkt_retune_unpack(b->req, &module, &timestamp,
                            &f.nint, &f.nfrac, &f.freqsel, &f.vcocap,
                            &low_band, &xb_gpio, &quick_tune);
 
     f.vcocap_result = 0xff;
+    f.xb_gpio       = xb_gpio;
 
     if (low_band) {
         f.flags = LMS_FREQ_FLAGS_LOW_BAND;
@@ -331,6 +516,27 @@ void pkt_retune(struct pkt_buf *b)
         f.flags |= LMS_FREQ_FLAGS_FORCE_VCOCAP;
     }
 
+    switch (module) {
+        case BLADERF_MODULE_RX:
+            q = &rx_queue;
+            break;
+
+        case BLADERF_MODULE_TX:
+            q = &tx_queue;
+            break;
+
+        default:
+            q = NULL;
+    }
+
+    /* Staged corrections apply to this request only */
+    if (q != NULL) {
+        corr = q->staged;
+        q->staged.flags = 0;
+    } else {
+        corr.flags = 0;
+    }
+
     start_time = time_tamer_read(module);
 
     if (timestamp == NIOS_PKT_RETUNE_NOW) {
@@ -338,6 +544,12 @@ void pkt_retune(struct pkt_buf *b)
         switch (module) {
             case BLADERF_MODULE_RX:
             case BLADERF_MODULE_TX:
+                if (corr.flags & NIOS_PKT_RETUNE_CORR_NO_TUNE) {
+                    apply_corr(module, &corr);
+                    status = 0;
+                    break;
+                }
+
                 status = lms_set_precalculated_frequency(NULL, module, &f);
                 if (status != 0) {
                     goto out;
@@ -351,6 +563,10 @@ void pkt_retune(struct pkt_buf *b)
                 }
 
                 xb_config_write(xb_gpio);
+                apply_corr(module, &corr);
+
+                retune_stats_record(module, NIOS_PKT_RETUNE_NOW, start_time,
+                                    (f.flags & LMS_FREQ_FLAGS_LOCKED) != 0);
 
                 status = 0;
                 break;
@@ -379,25 +595,28 @@ void pkt_retune(struct pkt_buf *b)
     } else {
         uint8_t queue_size;
 
-        switch (module) {
-            case BLADERF_MODULE_RX:
-                queue_size = enqueue_retune(&rx_queue, &f, timestamp);
-                break;
-
-            case BLADERF_MODULE_TX:
-                queue_size = enqueue_retune(&tx_queue, &f, timestamp);
-                break;
+        if (q == NULL) {
+            INCREMENT_ERROR_COUNT();
+            status = -1;
+        } else {
+            switch (nios_pkt_retune_get_op(b->req)) {
+                case NIOS_PKT_RETUNE_OP_SCHEDULE:
+                    queue_size = enqueue_retune(q, &f, &corr, timestamp);
+                    status = (queue_size == QUEUE_FULL) ? -1 : 0;
+                    break;
 
-            default:
-                INCREMENT_ERROR_COUNT();
-                queue_size = QUEUE_FULL;
+                case NIOS_PKT_RETUNE_OP_CANCEL:
+                    status = (cancel_retunes(q, timestamp) == 0) ? -1 : 0;
+                    break;
 
-        }
+                case NIOS_PKT_RETUNE_OP_REPLACE:
+                    status = replace_retune(q, &f, &corr, timestamp) ? 0 : -1;
+                    break;
 
-        if (queue_size == QUEUE_FULL) {
-            status = -1;
-        } else {
-            status = 0;
+                default:
+                    INCREMENT_ERROR_COUNT();
+                    status = -1;
+            }
         }
     }
 
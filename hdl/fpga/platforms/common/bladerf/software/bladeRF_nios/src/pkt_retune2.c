@@ -30,7 +30,7 @@
 #include "debug.h"
 
 #ifdef BLADERF_NIOS_LIBAD936X
-void rfic_invalidate_frequency(bladerf_module module);
+#include "devices_rfic.h"
 #endif  // BLADERF_NIOS_LIBAD936X
 
 #ifdef BLADERF_NIOS_DEBUG
@@ -41,7 +41,7 @@ void rfic_invalidate_frequency(bladerf_module module);
 #endif
 
 /* The enqueue/dequeue routines require that this be a power of two */
-#define RETUNE2_QUEUE_MAX   16
+#define RETUNE2_QUEUE_MAX   64
 #define QUEUE_FULL          0xff
 #define QUEUE_EMPTY         0xfe
 
@@ -54,12 +54,21 @@ enum entry_state {
     ENTRY_STATE_READY,        /* The timer interrupt has fired - we should
                                * handle this retune */
     ENTRY_STATE_DONE,         /* Retune is complete */
+    ENTRY_STATE_CANCELLED,    /* The host cancelled this entry. It is
+                               * dropped once it reaches the queue head. */
 };
 
 struct queue_entry {
     volatile enum entry_state state;
-    fastlock_profile *profile;
+    uint8_t type;               /* NIOS_PKT_RETUNE2_TYPE_* */
+    fastlock_profile *profile;  /* Retunes only. RX profile of a pair. */
+    fastlock_profile *tx_profile; /* TX profile of a paired retune */
     uint64_t timestamp;
+
+    /* Parameter changes only */
+    uint8_t cmd;
+    uint8_t ch;
+    uint32_t value;
 };
 
 static struct queue {
@@ -72,9 +81,14 @@ static struct queue {
 
 /* Returns queue size after enqueue operation, or QUEUE_FULL if we could
  * not enqueue the requested item */
-static inline uint8_t enqueue_retune(struct queue *q,
-                                     fastlock_profile *p,
-                                     uint64_t timestamp)
+static inline uint8_t enqueue_entry(struct queue *q,
+                                    uint8_t type,
+                                    fastlock_profile *p,
+                                    fastlock_profile *tx_p,
+                                    uint64_t timestamp,
+                                    uint8_t cmd,
+                                    uint8_t ch,
+                                    uint32_t value)
 {
     uint8_t ret;
 
@@ -82,9 +96,14 @@ static inline uint8_t enqueue_retune(struct queue *q,
         return QUEUE_FULL;
     }
 
+    q->entries[q->ins_idx].type = type;
     q->entries[q->ins_idx].profile = p;
-    q->entries[q->ins_idx].state = ENTRY_STATE_NEW;
+    q->entries[q->ins_idx].tx_profile = tx_p;
     q->entries[q->ins_idx].timestamp = timestamp;
+    q->entries[q->ins_idx].cmd = cmd;
+    q->entries[q->ins_idx].ch = ch;
+    q->entries[q->ins_idx].value = value;
+    q->entries[q->ins_idx].state = ENTRY_STATE_NEW;
 
     q->ins_idx = (q->ins_idx + 1) & (RETUNE2_QUEUE_MAX - 1);
 
@@ -105,7 +124,7 @@ static inline uint8_t dequeue_retune(struct queue *q, struct queue_entry *e)
     }
 
     if (e != NULL) {
-        memcpy(&e, &q->entries[q->rem_idx], sizeof(e[0]));
+        memcpy(e, &q->entries[q->rem_idx], sizeof(e[0]));
     }
 
     q->entries[q->rem_idx].state = ENTRY_STATE_DONE;
@@ -142,6 +161,47 @@ static inline struct queue_entry* peek_next_retune_offset(struct queue *q,
     }
 }
 
+/* Get the pending entry scheduled at the specified timestamp, at or after
+ * the given offset from the removal index. Returns the offset of the entry,
+ * or QUEUE_EMPTY if there is none. */
+static inline uint8_t find_entry(struct queue *q, uint64_t timestamp,
+                                 uint8_t offset)
+{
+    struct queue_entry *e;
+
+    for (; offset < q->count; offset++) {
+        e = peek_next_retune_offset(q, offset);
+
+        if (e->timestamp == timestamp &&
+            (e->state == ENTRY_STATE_NEW ||
+             e->state == ENTRY_STATE_SCHEDULED)) {
+            return offset;
+        }
+    }
+
+    return QUEUE_EMPTY;
+}
+
+/* Cancel the pending entries scheduled at the specified timestamp. Entries
+ * remain in place, so that the queue is never reordered beneath the timer
+ * interrupt, and are dropped when they reach the head of the queue.
+ *
+ * If the timer interrupt for the head entry fires during this call, the
+ * entry is simply not applied. Returns the number of cancelled entries. */
+static uint8_t cancel_entries(struct queue *q, uint64_t timestamp)
+{
+    uint8_t offset = 0;
+    uint8_t n = 0;
+
+    while ((offset = find_entry(q, timestamp, offset)) != QUEUE_EMPTY) {
+        peek_next_retune_offset(q, offset)->state = ENTRY_STATE_CANCELLED;
+        offset++;
+        n++;
+    }
+
+    return n;
+}
+
 /* The retune interrupt may fire while this call is occuring, so we should
  * perform these operations in an order that minimizes the race window, and
  * does not cause the race to be problematic. It's fine if the last retune
@@ -186,7 +246,9 @@ static inline void profile_load_scheduled(struct queue *q,
     for (i = 0; i < q->count; i++) {
         e = peek_next_retune_offset(q, i);
         if( e != NULL ) {
-            if (e->state == ENTRY_STATE_NEW) {
+            if (e->state == ENTRY_STATE_NEW &&
+                (e->type == NIOS_PKT_RETUNE2_TYPE_RETUNE ||
+                 e->type == NIOS_PKT_RETUNE2_TYPE_RETUNE_PAIR)) {
                 if ( !(used & (1 << e->profile->profile_num)) ) {
                     /* Profile slot is available in RFFE, fill it */
                     profile_load(module, e->profile);
@@ -198,8 +260,46 @@ static inline void profile_load_scheduled(struct queue *q,
     }
 }
 
-static inline void profile_activate(bladerf_module module, fastlock_profile *p)
+/* Replace the profile of the pending retune scheduled at the specified
+ * timestamp. Returns false if there is no such retune. */
+static bool replace_retune(struct queue *q, bladerf_module module,
+                           fastlock_profile *p, uint64_t timestamp)
 {
+    struct queue_entry *e;
+    uint8_t offset = 0;
+
+    while ((offset = find_entry(q, timestamp, offset)) != QUEUE_EMPTY) {
+        e = peek_next_retune_offset(q, offset);
+
+        if (e->type == NIOS_PKT_RETUNE2_TYPE_RETUNE) {
+            e->profile = p;
+
+            /* Profiles of scheduled entries have already been loaded into
+             * the RFFE, so load the replacement now */
+            if (e->state == ENTRY_STATE_SCHEDULED) {
+                profile_load(module, p);
+            }
+
+            return true;
+        }
+
+        offset++;
+    }
+
+    return false;
+}
+
+/* Upper bound on the number of AD9361 lock status reads after a retune */
+#define RETUNE2_LOCK_POLL_MAX 64
+
+static inline void profile_activate(bladerf_module module,
+                                    fastlock_profile *p,
+                                    uint64_t scheduled,
+                                    uint64_t start)
+{
+    unsigned int i;
+    bool locked = false;
+
     if (p == NULL) {
         return;
     }
@@ -217,6 +317,133 @@ static inline void profile_activate(bladerf_module module, fastlock_profile *p)
 
     /* Adjust the RF switches */
     adi_rfspdt_select(module, p);
+
+    /* Wait for the synthesizer to lock, so that the recorded completion time
+     * reflects when the new frequency is usable */
+    for (i = 0; i < RETUNE2_LOCK_POLL_MAX && !locked; i++) {
+        locked = adi_synth_locked(module);
+    }
+
+    retune_stats_record(module, scheduled, start, locked);
+}
+
+/* Retune RX and TX together. Both profiles are recalled before waiting on
+ * either synthesizer, so that they lock concurrently. */
+static inline void pair_activate(fastlock_profile *rx,
+                                 fastlock_profile *tx,
+                                 uint64_t scheduled,
+                                 uint64_t start)
+{
+    unsigned int i;
+    bool rx_locked = false;
+    bool tx_locked = false;
+    uint64_t tx_start;
+
+    if (rx == NULL || tx == NULL) {
+        return;
+    }
+
+    /* The pair is scheduled against the RX timestamp, so the TX retune's
+     * scheduled time is only known in terms of the TX timestamp at which
+     * it started */
+    tx_start = time_tamer_read(BLADERF_MODULE_TX);
+
+#ifdef BLADERF_NIOS_LIBAD936X
+    rfic_invalidate_frequency(BLADERF_MODULE_RX);
+    rfic_invalidate_frequency(BLADERF_MODULE_TX);
+#endif  // BLADERF_NIOS_LIBAD936X
+
+    adi_fastlock_recall(BLADERF_MODULE_RX, rx);
+    adi_fastlock_recall(BLADERF_MODULE_TX, tx);
+
+    adi_rfport_select(rx);
+    adi_rfport_select(tx);
+
+    adi_rfspdt_select(BLADERF_MODULE_RX, rx);
+    adi_rfspdt_select(BLADERF_MODULE_TX, tx);
+
+    for (i = 0; i < RETUNE2_LOCK_POLL_MAX && !(rx_locked && tx_locked); i++) {
+        if (!rx_locked) {
+            rx_locked = adi_synth_locked(BLADERF_MODULE_RX);
+        }
+
+        if (!tx_locked) {
+            tx_locked = adi_synth_locked(BLADERF_MODULE_TX);
+        }
+    }
+
+    retune_stats_record(BLADERF_MODULE_RX, scheduled, start, rx_locked);
+    retune_stats_record(BLADERF_MODULE_TX,
+                        (scheduled == NIOS_PKT_RETUNE2_NOW) ?
+                            NIOS_PKT_RETUNE2_NOW : tx_start,
+                        tx_start, tx_locked);
+}
+
+/* Apply a scheduled parameter change */
+static inline bool param_apply(bladerf_module module,
+                               uint8_t type,
+                               uint8_t cmd,
+                               uint8_t ch,
+                               uint32_t value)
+{
+    fastlock_profile p;
+    uint32_t mask;
+
+    switch (type) {
+#ifdef BLADERF_NIOS_LIBAD936X
+        case NIOS_PKT_RETUNE2_TYPE_RFIC_CMD:
+            return rfic_command_write_immed(cmd, ch, value);
+#endif  // BLADERF_NIOS_LIBAD936X
+
+        case NIOS_PKT_RETUNE2_TYPE_RFPORT:
+            p.port = value & NIOS_PKT_RETUNE2_RFPORT_PORT_MASK;
+            p.spdt = (value & NIOS_PKT_RETUNE2_RFPORT_SPDT_MASK) >>
+                     NIOS_PKT_RETUNE2_RFPORT_SPDT_SHIFT;
+
+            adi_rfport_select(&p);
+
+            if (value & NIOS_PKT_RETUNE2_RFPORT_SPDT_VALID) {
+                adi_rfspdt_select(module, &p);
+            }
+
+            return true;
+
+        case NIOS_PKT_RETUNE2_TYPE_RFFE:
+            mask = value >> NIOS_PKT_RETUNE2_RFFE_MASK_SHIFT;
+            value &= mask;
+
+            rffe_csr_write((rffe_csr_read() & ~mask) | value);
+
+            return true;
+
+        default:
+            INCREMENT_ERROR_COUNT();
+            return false;
+    }
+}
+
+/* Load the fast lock profile(s) of a retune entry into the RFFE */
+static inline void entry_load(bladerf_module module, struct queue_entry *e)
+{
+    if (e->type == NIOS_PKT_RETUNE2_TYPE_RETUNE) {
+        profile_load(module, e->profile);
+    } else if (e->type == NIOS_PKT_RETUNE2_TYPE_RETUNE_PAIR) {
+        profile_load(BLADERF_MODULE_RX, e->profile);
+        profile_load(BLADERF_MODULE_TX, e->tx_profile);
+    }
+}
+
+static inline void entry_apply(bladerf_module module, struct queue_entry *e)
+{
+    if (e->type == NIOS_PKT_RETUNE2_TYPE_RETUNE) {
+        profile_activate(module, e->profile, e->timestamp,
+                         time_tamer_read(module));
+    } else if (e->type == NIOS_PKT_RETUNE2_TYPE_RETUNE_PAIR) {
+        pair_activate(e->profile, e->tx_profile, e->timestamp,
+                      time_tamer_read(module));
+    } else {
+        param_apply(module, e->type, e->cmd, e->ch, e->value);
+    }
 }
 
 static inline void retune_isr(struct queue *q)
@@ -225,7 +452,7 @@ static inline void retune_isr(struct queue *q)
     if (e != NULL) {
         if (e->state == ENTRY_STATE_SCHEDULED) {
             e->state = ENTRY_STATE_READY;
-        } else {
+        } else if (e->state != ENTRY_STATE_CANCELLED) {
             INCREMENT_ERROR_COUNT();
         }
     }
@@ -291,8 +518,8 @@ static inline void perform_work(struct queue *q, bladerf_module module)
     switch (e->state) {
         case ENTRY_STATE_NEW:
 
-            /* Load the fast lock profile into the RFFE */
-            profile_load(module, e->profile);
+            /* Load the fast lock profile(s) into the RFFE */
+            entry_load(module, e);
 
             /* Schedule the retune */
             e->state = ENTRY_STATE_SCHEDULED;
@@ -306,14 +533,38 @@ static inline void perform_work(struct queue *q, bladerf_module module)
              * Waiting for this entry to become ready */
             break;
 
-        case ENTRY_STATE_READY:
+        case ENTRY_STATE_READY: {
+            uint64_t timestamp = e->timestamp;
 
-            /* Activate the fast lock profile for this retune */
-            profile_activate(module, e->profile);
+            /* Activate the fast lock profile for this retune, or apply the
+             * parameter change */
+            entry_apply(module, e);
 
             /* Drop the item from the queue */
             dequeue_retune(q, NULL);
 
+            /* Entries sharing this timestamp are due as well. Apply them now,
+             * rather than waiting on a timer interrupt for a time that has
+             * already passed. */
+            e = peek_next_retune(q);
+            while (e != NULL && e->timestamp == timestamp &&
+                   (e->state == ENTRY_STATE_NEW ||
+                    e->state == ENTRY_STATE_CANCELLED)) {
+                if (e->state == ENTRY_STATE_NEW) {
+                    entry_load(module, e);
+                    entry_apply(module, e);
+                }
+
+                dequeue_retune(q, NULL);
+                e = peek_next_retune(q);
+            }
+
+            break;
+        }
+
+        case ENTRY_STATE_CANCELLED:
+            /* Drop the entry. The next entry arms the timer in its place. */
+            dequeue_retune(q, NULL);
             break;
 
         default:
@@ -328,6 +579,128 @@ void pkt_retune2_work(void)
     perform_work(&tx_queue, BLADERF_MODULE_TX);
 }
 
+/* Handle a scheduled parameter change request */
+static void pkt_retune2_param(struct pkt_buf *b)
+{
+    bool success;
+    bladerf_module module;
+    bladerf_channel ch;
+    uint8_t flags;
+    uint8_t type;
+    uint8_t cmd;
+    uint32_t value;
+    uint64_t timestamp;
+    uint64_t start_time;
+    uint64_t end_time;
+    struct queue *q;
+
+    flags = NIOS_PKT_RETUNE2_RESP_FLAG_SUCCESS;
+
+    type = nios_pkt_retune2_type(b->req);
+    nios_pkt_retune2_param_unpack(b->req, &ch, &timestamp, &cmd, &value);
+
+    module = BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_MODULE_TX : BLADERF_MODULE_RX;
+    q = (module == BLADERF_MODULE_TX) ? &tx_queue : &rx_queue;
+
+    start_time = time_tamer_read(module);
+
+    if (timestamp == NIOS_PKT_RETUNE2_NOW) {
+        success = param_apply(module, type, cmd, ch, value);
+        flags |= NIOS_PKT_RETUNE2_RESP_FLAG_TSVTUNE_VALID;
+    } else if (timestamp == NIOS_PKT_RETUNE2_CLEAR_QUEUE) {
+        reset_queue(q);
+        success = true;
+    } else {
+        success = enqueue_entry(q, type, NULL, NULL, timestamp, cmd, ch,
+                                value) != QUEUE_FULL;
+    }
+
+    end_time = time_tamer_read(module);
+
+    if (!success) {
+        INCREMENT_ERROR_COUNT();
+        flags &= ~(NIOS_PKT_RETUNE2_RESP_FLAG_SUCCESS);
+    }
+
+    nios_pkt_retune2_resp_pack(b->resp, end_time - start_time, flags);
+}
+
+/* Update a Nios fast lock profile with the RFFE slot and RF port settings
+ * provided by the host */
+static inline void profile_update(fastlock_profile *profile,
+                                  uint8_t rffe_profile,
+                                  uint8_t port,
+                                  uint8_t spdt)
+{
+    /* The host may move a profile to a different RFFE slot. If so, the
+     * copy in its old slot must not be mistaken for a loaded profile. */
+    if (profile->profile_num != rffe_profile &&
+        profile->state == FASTLOCK_STATE_BBP_RFFE) {
+        profile->state = FASTLOCK_STATE_BBP;
+    }
+
+    profile->profile_num = rffe_profile;
+    profile->port = port;
+    profile->spdt = spdt;
+}
+
+/* Handle a paired RX and TX retune request */
+static void pkt_retune2_pair(struct pkt_buf *b)
+{
+    bool success = true;
+    uint8_t flags;
+    uint64_t timestamp;
+    uint64_t start_time;
+    uint64_t end_time;
+    uint16_t rx_nios_profile, tx_nios_profile;
+    uint8_t rx_rffe_profile, tx_rffe_profile;
+    uint8_t port;
+    uint8_t spdt;
+    fastlock_profile *rx, *tx;
+
+    flags = NIOS_PKT_RETUNE2_RESP_FLAG_SUCCESS;
+
+    nios_pkt_retune2_pair_unpack(b->req, &timestamp,
+                                 &rx_nios_profile, &rx_rffe_profile,
+                                 &tx_nios_profile, &tx_rffe_profile,
+                                 &port, &spdt);
+
+    rx = &fastlocks_rx[rx_nios_profile];
+    tx = &fastlocks_tx[tx_nios_profile];
+
+    profile_update(rx, rx_rffe_profile,
+                   NIOS_PKT_RETUNE2_PORT_IS_RX_MASK |
+                   (port & NIOS_PKT_RETUNE2_PORT_RX_MASK), spdt);
+
+    profile_update(tx, tx_rffe_profile,
+                   port & NIOS_PKT_RETUNE2_PORT_TX_MASK, spdt);
+
+    start_time = time_tamer_read(BLADERF_MODULE_RX);
+
+    if (timestamp == NIOS_PKT_RETUNE2_NOW) {
+        profile_load(BLADERF_MODULE_RX, rx);
+        profile_load(BLADERF_MODULE_TX, tx);
+        pair_activate(rx, tx, NIOS_PKT_RETUNE2_NOW, start_time);
+        flags |= NIOS_PKT_RETUNE2_RESP_FLAG_TSVTUNE_VALID;
+    } else if (timestamp == NIOS_PKT_RETUNE2_CLEAR_QUEUE) {
+        /* Queues are cleared per module, via the retune entry type */
+        success = false;
+    } else {
+        success = enqueue_entry(&rx_queue, NIOS_PKT_RETUNE2_TYPE_RETUNE_PAIR,
+                                rx, tx, timestamp, 0, 0, 0) != QUEUE_FULL;
+        profile_load_scheduled(&rx_queue, BLADERF_MODULE_RX);
+    }
+
+    end_time = time_tamer_read(BLADERF_MODULE_RX);
+
+    if (!success) {
+        INCREMENT_ERROR_COUNT();
+        flags &= ~(NIOS_PKT_RETUNE2_RESP_FLAG_SUCCESS);
+    }
+
+    nios_pkt_retune2_resp_pack(b->resp, end_time - start_time, flags);
+}
+
 void pkt_retune2(struct pkt_buf *b)
 {
     int status = -1;
@@ -345,6 +718,19 @@ void pkt_retune2(struct pkt_buf *b)
 
     flags = NIOS_PKT_RETUNE2_RESP_FLAG_SUCCESS;
 
+    switch (nios_pkt_retune2_type(b->req)) {
+        case NIOS_PKT_RETUNE2_TYPE_RETUNE:
+            break;
+
+        case NIOS_PKT_RETUNE2_TYPE_RETUNE_PAIR:
+            pkt_retune2_pair(b);
+            return;
+
+        default:
+            pkt_retune2_param(b);
+            return;
+    }
+
     nios_pkt_retune2_unpack(b->req, &module, &timestamp,
                             &nios_profile, &rffe_profile, &port, &spdt);
 
@@ -362,11 +748,10 @@ void pkt_retune2(struct pkt_buf *b)
     if (profile == NULL) {
         INCREMENT_ERROR_COUNT();
         status = -1;
-    } else {
-        /* Update the fastlock profile data */
-        profile->profile_num = rffe_profile;
-        profile->port = port;
-        profile->spdt = spdt;
+    } else if (nios_pkt_retune2_get_op(b->req) != NIOS_PKT_RETUNE2_OP_CANCEL) {
+        /* Update the fastlock profile data. A cancellation carries no
+         * profile, so it must not modify one. */
+        profile_update(profile, rffe_profile, port, spdt);
     }
 
     start_time = time_tamer_read(module);
@@ -381,7 +766,8 @@ void pkt_retune2(struct pkt_buf *b)
                 profile_load(module, profile);
 
                 /* Activate the fast lock profile for this retune */
-                profile_activate(module, profile);
+                profile_activate(module, profile, NIOS_PKT_RETUNE2_NOW,
+                                 start_time);
 
                 flags |= NIOS_PKT_RETUNE2_RESP_FLAG_TSVTUNE_VALID;
 
@@ -410,29 +796,50 @@ void pkt_retune2(struct pkt_buf *b)
                 status = -1;
         }
     } else {
+        struct queue *q;
         uint8_t queue_size;
 
         switch (module) {
             case BLADERF_MODULE_RX:
-                queue_size = enqueue_retune(&rx_queue, profile, timestamp);
-                profile_load_scheduled(&rx_queue, module);
+                q = &rx_queue;
                 break;
 
             case BLADERF_MODULE_TX:
-                queue_size = enqueue_retune(&tx_queue, profile, timestamp);
-                profile_load_scheduled(&tx_queue, module);
+                q = &tx_queue;
                 break;
 
             default:
                 INCREMENT_ERROR_COUNT();
-                queue_size = QUEUE_FULL;
-
+                q = NULL;
         }
 
-        if (queue_size == QUEUE_FULL) {
+        if (q == NULL || profile == NULL) {
             status = -1;
         } else {
-            status = 0;
+            switch (nios_pkt_retune2_get_op(b->req)) {
+                case NIOS_PKT_RETUNE2_OP_SCHEDULE:
+                    queue_size = enqueue_entry(q,
+                                               NIOS_PKT_RETUNE2_TYPE_RETUNE,
+                                               profile, NULL, timestamp,
+                                               0, 0, 0);
+                    status = (queue_size == QUEUE_FULL) ? -1 : 0;
+                    break;
+
+                case NIOS_PKT_RETUNE2_OP_CANCEL:
+                    status = (cancel_entries(q, timestamp) == 0) ? -1 : 0;
+                    break;
+
+                case NIOS_PKT_RETUNE2_OP_REPLACE:
+                    status =
+                        replace_retune(q, module, profile, timestamp) ? 0 : -1;
+                    break;
+
+                default:
+                    INCREMENT_ERROR_COUNT();
+                    status = -1;
+            }
+
+            profile_load_scheduled(q, module);
         }
     }
 
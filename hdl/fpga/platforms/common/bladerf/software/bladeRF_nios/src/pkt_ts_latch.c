@@ -0,0 +1,52 @@
+/* This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include "pkt_handler.h"
+#include "pkt_ts_latch.h"
+#include "devices.h"
+#include "debug.h"
+
+void pkt_ts_latch(struct pkt_buf *b)
+{
+    bool tx;
+    bladerf_module m;
+    uint64_t latch, now;
+    uint32_t hold;
+
+    nios_pkt_ts_latch_unpack(b->req, &tx);
+    m = tx ? BLADERF_MODULE_TX : BLADERF_MODULE_RX;
+
+#ifdef BLADERF_NIOS_PC_SIMULATION
+    /* Requests are not delivered via the ISR in the simulation */
+    latch = time_tamer_read(m);
+#else
+    latch = b->latch;
+#endif
+
+    now  = time_tamer_read(m);
+    hold = (now - latch > UINT32_MAX) ? UINT32_MAX : (uint32_t)(now - latch);
+
+    nios_pkt_ts_latch_resp_pack(b->resp, tx, latch, hold, true);
+}
@@ -0,0 +1,556 @@
+/* This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* PC simulation test bench for the NIOS II packet handlers.
+ *
+ * Requests are packed with the same fpga_common helpers the host uses and
+ * dispatched to the natively built packet handlers, whose device accesses are
+ * forwarded to a libbladeRF device on the dummy backend (devices_dummy.c).
+ * Each test verifies the response against the dummy backend's state, read
+ * back through the libbladeRF API. The benchmarks then time each request
+ * format, to compare the per-register cost of single, batched and block
+ * accesses.
+ *
+ * Usage: bladeRF_nios_dummy.sim [iterations]
+ */
+#ifdef BLADERF_NIOS_PC_SIMULATION
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <inttypes.h>
+
+#include "devices.h"
+#include "devices_dummy.h"
+#include "pkt_handler.h"
+#include "pkt_8x8.h"
+#include "pkt_8x16.h"
+#include "pkt_8x32.h"
+#include "pkt_8x64.h"
+#include "pkt_32x32.h"
+#include "pkt_retune.h"
+#include "pkt_legacy.h"
+#include "pkt_ts_latch.h"
+#include "debug.h"
+
+#ifdef BOARD_BLADERF_MICRO
+#   error "The dummy backend emulates a bladeRF1. Build from the bladerf platform."
+#endif
+
+#define DEFAULT_ITERATIONS 1000000
+
+/* The same handlers as the bladeRF NIOS II application */
+static const struct pkt_handler pkt_handlers[] = {
+    PKT_RETUNE,
+    PKT_8x8,
+    PKT_8x8_BATCH,
+    PKT_8x8_BLOCK,
+    PKT_8x16,
+    PKT_8x32,
+    PKT_8x64,
+    PKT_32x32,
+    PKT_LEGACY,
+    PKT_TS_LATCH,
+};
+
+static struct pkt_dispatch pkt_dispatch;
+static struct pkt_buf pkt;
+static struct bladerf *dev;
+static unsigned int failures;
+
+/* 8-bit register targets, with their libbladeRF API readback */
+struct reg8_target {
+    const char *name;
+    uint8_t id;
+    unsigned int num_regs;
+    int (*read)(struct bladerf *dev, uint8_t addr, uint8_t *data);
+};
+
+static const struct reg8_target reg8_targets[] = {
+    { "LMS6",   NIOS_PKT_8x8_TARGET_LMS6,   128, bladerf_lms_read },
+    { "Si5338", NIOS_PKT_8x8_TARGET_SI5338, 256, bladerf_si5338_read },
+};
+
+#define CHECK(cond, ...) do { \
+        if (!(cond)) { \
+            printf("  Failed: " __VA_ARGS__); \
+            failures++; \
+        } \
+    } while (0)
+
+/* Run one request through the packet handler for its magic value, in the
+ * same manner as the NIOS II main loop */
+static void transact(const uint8_t *req, uint8_t *resp)
+{
+    const struct pkt_handler *handler;
+
+    memcpy((uint8_t *)pkt.req, req, NIOS_PKT_LEN);
+    memset(pkt.resp, 0xff, NIOS_PKT_LEN);
+
+    handler = pkt_dispatch_lookup(&pkt_dispatch, req[PKT_MAGIC_IDX]);
+    if (handler != NULL) {
+        handler->exec(&pkt);
+    }
+
+    memcpy(resp, pkt.resp, NIOS_PKT_LEN);
+    pkt_dispatch_work(&pkt_dispatch);
+}
+
+static inline uint8_t pattern(unsigned int addr, unsigned int pass)
+{
+    return (uint8_t)(addr * 37 + pass * 101 + 1);
+}
+
+static uint8_t api_read8(const struct reg8_target *t, uint8_t addr)
+{
+    uint8_t data = 0;
+    CHECK(t->read(dev, addr, &data) == 0, "%s[0x%02x] API read\n",
+          t->name, addr);
+    return data;
+}
+
+static void test_8x8(const struct reg8_target *t)
+{
+    uint8_t req[NIOS_PKT_LEN], resp[NIOS_PKT_LEN];
+    unsigned int addr;
+    uint8_t data;
+    bool success;
+
+    for (addr = 0; addr < t->num_regs; addr++) {
+        nios_pkt_8x8_pack(req, t->id, true, addr, pattern(addr, 0));
+        transact(req, resp);
+        nios_pkt_8x8_resp_unpack(resp, NULL, NULL, NULL, NULL, &success);
+
+        CHECK(success, "%s[0x%02x] write\n", t->name, addr);
+        CHECK(api_read8(t, addr) == pattern(addr, 0),
+              "%s[0x%02x] write not applied\n", t->name, addr);
+
+        nios_pkt_8x8_pack(req, t->id, false, addr, 0);
+        transact(req, resp);
+        nios_pkt_8x8_resp_unpack(resp, NULL, NULL, NULL, &data, &success);
+
+        CHECK(success && data == pattern(addr, 0),
+              "%s[0x%02x] read 0x%02x\n", t->name, addr, data);
+    }
+}
+
+/* Each batch writes a register and then reads it back */
+static void test_8x8_batch(const struct reg8_target *t)
+{
+    uint8_t req[NIOS_PKT_LEN], resp[NIOS_PKT_LEN];
+    unsigned int addr, n;
+    uint8_t completed, data;
+
+    for (addr = 0; addr < t->num_regs; addr += NIOS_PKT_8x8_BATCH_MAX / 2) {
+        nios_pkt_8x8_batch_pack(req, t->id);
+
+        for (n = 0; n < NIOS_PKT_8x8_BATCH_MAX / 2; n++) {
+            const uint8_t a = (addr + n) % t->num_regs;
+            nios_pkt_8x8_batch_pack_op(req, true, a, pattern(a, 1));
+            nios_pkt_8x8_batch_pack_op(req, false, a, 0);
+        }
+
+        transact(req, resp);
+        nios_pkt_8x8_batch_resp_unpack(resp, &completed);
+
+        CHECK(completed == NIOS_PKT_8x8_BATCH_MAX,
+              "%s[0x%02x] batch completed %u\n", t->name, addr, completed);
+
+        for (n = 0; n < NIOS_PKT_8x8_BATCH_MAX / 2; n++) {
+            const uint8_t a = (addr + n) % t->num_regs;
+
+            nios_pkt_8x8_batch_unpack_op(resp, 2 * n + 1, NULL, NULL, &data);
+            CHECK(data == pattern(a, 1) && api_read8(t, a) == pattern(a, 1),
+                  "%s[0x%02x] batch read 0x%02x\n", t->name, a, data);
+        }
+    }
+}
+
+static void test_8x8_block(const struct reg8_target *t)
+{
+    uint8_t req[NIOS_PKT_LEN], resp[NIOS_PKT_LEN];
+    uint8_t wr[NIOS_PKT_8x8_BLOCK_MAX], rd[NIOS_PKT_8x8_BLOCK_MAX];
+    unsigned int addr, n, count;
+    uint8_t completed;
+
+    for (addr = 0; addr < t->num_regs; addr += count) {
+        count = t->num_regs - addr;
+        if (count > NIOS_PKT_8x8_BLOCK_MAX) {
+            count = NIOS_PKT_8x8_BLOCK_MAX;
+        }
+
+        for (n = 0; n < count; n++) {
+            wr[n] = pattern(addr + n, 2);
+        }
+
+        nios_pkt_8x8_block_pack(req, t->id, true, addr, wr, count);
+        transact(req, resp);
+        nios_pkt_8x8_block_resp_unpack(resp, NULL, &completed);
+
+        CHECK(completed == count, "%s[0x%02x] block write completed %u\n",
+              t->name, addr, completed);
+
+        for (n = 0; n < count; n++) {
+            CHECK(api_read8(t, addr + n) == wr[n],
+                  "%s[0x%02x] block write not applied\n", t->name, addr + n);
+        }
+
+        nios_pkt_8x8_block_pack(req, t->id, false, addr, NULL, count);
+        transact(req, resp);
+        nios_pkt_8x8_block_resp_unpack(resp, rd, &completed);
+
+        CHECK(completed == count && memcmp(rd, wr, count) == 0,
+              "%s[0x%02x] block read\n", t->name, addr);
+    }
+}
+
+static void test_config_gpio(void)
+{
+    uint8_t req[NIOS_PKT_LEN], resp[NIOS_PKT_LEN];
+    uint32_t orig, val, data = 0;
+    bool success;
+
+    CHECK(bladerf_config_gpio_read(dev, &orig) == 0, "Config GPIO read\n");
+
+    val = orig ^ 0x00ff0000;
+    nios_pkt_8x32_pack(req, NIOS_PKT_8x32_TARGET_CONTROL, true, 0, val);
+    transact(req, resp);
+    nios_pkt_8x32_resp_unpack(resp, NULL, NULL, NULL, NULL, &success);
+
+    CHECK(success, "Config GPIO write\n");
+    CHECK(bladerf_config_gpio_read(dev, &data) == 0 && data == val,
+          "Config GPIO write not applied: 0x%08x\n", data);
+
+    nios_pkt_8x32_pack(req, NIOS_PKT_8x32_TARGET_CONTROL, false, 0, 0);
+    transact(req, resp);
+    nios_pkt_8x32_resp_unpack(resp, NULL, NULL, NULL, &data, &success);
+
+    CHECK(success && data == val, "Config GPIO read 0x%08x\n", data);
+
+    CHECK(bladerf_config_gpio_write(dev, orig) == 0, "Config GPIO restore\n");
+}
+
+static void test_expansion(uint8_t target, const char *name)
+{
+    uint8_t req[NIOS_PKT_LEN], resp[NIOS_PKT_LEN];
+    const uint32_t mask = 0x0000ff00;
+    uint32_t data = 0;
+    bool success;
+
+    /* Full write, then a masked write on top of it */
+    nios_pkt_32x32_pack(req, target, true, 0xffffffff, 0x12345678);
+    transact(req, resp);
+    nios_pkt_32x32_resp_unpack(resp, NULL, NULL, NULL, NULL, &success);
+    CHECK(success, "%s write\n", name);
+
+    nios_pkt_32x32_pack(req, target, true, mask, 0xffffa5ff);
+    transact(req, resp);
+    nios_pkt_32x32_resp_unpack(resp, NULL, NULL, NULL, NULL, &success);
+    CHECK(success, "%s masked write\n", name);
+
+    if (target == NIOS_PKT_32x32_TARGET_EXP) {
+        CHECK(bladerf_expansion_gpio_read(dev, &data) == 0, "%s\n", name);
+    } else {
+        CHECK(bladerf_expansion_gpio_dir_read(dev, &data) == 0, "%s\n", name);
+    }
+
+    CHECK(data == 0x1234a578, "%s write not applied: 0x%08x\n", name, data);
+
+    nios_pkt_32x32_pack(req, target, false, 0xffffffff, 0);
+    transact(req, resp);
+    nios_pkt_32x32_resp_unpack(resp, NULL, NULL, NULL, &data, &success);
+
+    CHECK(success && data == 0x1234a578, "%s read 0x%08x\n", name, data);
+}
+
+static void test_iq_corr(void)
+{
+    static const struct {
+        uint8_t addr;
+        bladerf_channel ch;
+        bladerf_correction corr;
+        int16_t value;
+    } corrs[] = {
+        { NIOS_PKT_8x16_ADDR_IQ_CORR_RX_GAIN,  BLADERF_CHANNEL_RX(0),
+          BLADERF_CORR_GAIN,  123 },
+        { NIOS_PKT_8x16_ADDR_IQ_CORR_RX_PHASE, BLADERF_CHANNEL_RX(0),
+          BLADERF_CORR_PHASE, -456 },
+        { NIOS_PKT_8x16_ADDR_IQ_CORR_TX_GAIN,  BLADERF_CHANNEL_TX(0),
+          BLADERF_CORR_GAIN,  -789 },
+        { NIOS_PKT_8x16_ADDR_IQ_CORR_TX_PHASE, BLADERF_CHANNEL_TX(0),
+          BLADERF_CORR_PHASE, 1011 },
+    };
+
+    uint8_t req[NIOS_PKT_LEN], resp[NIOS_PKT_LEN];
+    uint16_t raw, data;
+    int16_t value;
+    bool success;
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(corrs); i++) {
+        /* Gain corrections carry a 4096 offset in the FPGA register */
+        raw = (uint16_t)corrs[i].value;
+        if (corrs[i].corr == BLADERF_CORR_GAIN) {
+            raw += 4096;
+        }
+
+        nios_pkt_8x16_pack(req, NIOS_PKT_8x16_TARGET_IQ_CORR, true,
+                           corrs[i].addr, raw);
+        transact(req, resp);
+        nios_pkt_8x16_resp_unpack(resp, NULL, NULL, NULL, NULL, &success);
+        CHECK(success, "IQ correction %u write\n", corrs[i].addr);
+
+        value = 0;
+        CHECK(bladerf_get_correction(dev, corrs[i].ch, corrs[i].corr,
+                                     &value) == 0 && value == corrs[i].value,
+              "IQ correction %u write not applied: %d\n", corrs[i].addr,
+              value);
+
+        nios_pkt_8x16_pack(req, NIOS_PKT_8x16_TARGET_IQ_CORR, false,
+                           corrs[i].addr, 0);
+        transact(req, resp);
+        nios_pkt_8x16_resp_unpack(resp, NULL, NULL, NULL, &data, &success);
+
+        CHECK(success && data == raw, "IQ correction %u read 0x%04x\n",
+              corrs[i].addr, data);
+    }
+}
+
+static void test_vctcxo_dac(void)
+{
+    uint8_t req[NIOS_PKT_LEN], resp[NIOS_PKT_LEN];
+    uint16_t data = 0;
+    bool success;
+
+    nios_pkt_8x16_pack(req, NIOS_PKT_8x16_TARGET_VCTCXO_DAC, true, 0x08,
+                       0x8012);
+    transact(req, resp);
+    nios_pkt_8x16_resp_unpack(resp, NULL, NULL, NULL, NULL, &success);
+    CHECK(success, "VCTCXO DAC write\n");
+
+    CHECK(bladerf_trim_dac_read(dev, &data) == 0 && data == 0x8012,
+          "VCTCXO DAC write not applied: 0x%04x\n", data);
+
+    nios_pkt_8x16_pack(req, NIOS_PKT_8x16_TARGET_VCTCXO_DAC, false, 0x98, 0);
+    transact(req, resp);
+    nios_pkt_8x16_resp_unpack(resp, NULL, NULL, NULL, &data, &success);
+
+    CHECK(success && data == 0x8012, "VCTCXO DAC read 0x%04x\n", data);
+}
+
+static void test_timestamp(void)
+{
+    uint8_t req[NIOS_PKT_LEN], resp[NIOS_PKT_LEN];
+    uint64_t before = 0, after = 0, data = 0;
+    bool success;
+
+    CHECK(bladerf_get_timestamp(dev, BLADERF_RX, &before) == 0,
+          "Timestamp read\n");
+
+    nios_pkt_8x64_pack(req, NIOS_PKT_8x64_TARGET_TIMESTAMP, false,
+                       NIOS_PKT_8x64_TIMESTAMP_RX, 0);
+    transact(req, resp);
+    nios_pkt_8x64_resp_unpack(resp, NULL, NULL, NULL, &data, &success);
+
+    CHECK(bladerf_get_timestamp(dev, BLADERF_RX, &after) == 0,
+          "Timestamp read\n");
+
+    CHECK(success && data >= before && data <= after,
+          "Timestamp %" PRIu64 " outside [%" PRIu64 ", %" PRIu64 "]\n",
+          data, before, after);
+}
+
+static void run_test(const char *desc, void (*fn)(const struct reg8_target *),
+                     const struct reg8_target *t)
+{
+    const unsigned int prev = failures;
+
+    printf("%-40s", desc);
+    fflush(stdout);
+
+    fn(t);
+
+    failures += devices_dummy_take_errors();
+    printf("%s\n", failures == prev ? "Pass." : "");
+}
+
+/* Adapters for tests without a register target */
+static void run_config_gpio(const struct reg8_target *t)
+{
+    test_config_gpio();
+}
+
+static void run_expansion(const struct reg8_target *t)
+{
+    test_expansion(NIOS_PKT_32x32_TARGET_EXP, "Expansion GPIO");
+    test_expansion(NIOS_PKT_32x32_TARGET_EXP_DIR, "Expansion GPIO direction");
+}
+
+static void run_iq_corr(const struct reg8_target *t)
+{
+    test_iq_corr();
+}
+
+static void run_vctcxo_dac(const struct reg8_target *t)
+{
+    test_vctcxo_dac();
+}
+
+static void run_timestamp(const struct reg8_target *t)
+{
+    test_timestamp();
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void bench(const char *desc, const uint8_t *req, unsigned int regs,
+                  unsigned int iterations)
+{
+    uint8_t resp[NIOS_PKT_LEN];
+    uint64_t start, elapsed;
+    unsigned int i;
+    double per_pkt;
+
+    start = now_ns();
+    for (i = 0; i < iterations; i++) {
+        transact(req, resp);
+    }
+    elapsed = now_ns() - start;
+
+    per_pkt = (double)elapsed / iterations;
+    printf("  %-28s %4u  %10.1f  %10.1f\n", desc, regs, per_pkt,
+           per_pkt / regs);
+}
+
+static void run_benchmarks(unsigned int iterations)
+{
+    uint8_t req[NIOS_PKT_LEN];
+    uint8_t data[NIOS_PKT_8x8_BLOCK_MAX] = { 0 };
+    unsigned int n;
+
+    printf("\nBenchmarks (%u iterations each)\n\n", iterations);
+    printf("  %-28s %4s  %10s  %10s\n", "Request", "Regs", "ns/request",
+           "ns/reg");
+    printf("  ---------------------------- ----  ----------  ----------\n");
+
+    nios_pkt_8x8_pack(req, NIOS_PKT_8x8_TARGET_LMS6, true, 0x07, 0x09);
+    bench("8x8 LMS6 write", req, 1, iterations);
+
+    nios_pkt_8x8_pack(req, NIOS_PKT_8x8_TARGET_LMS6, false, 0x07, 0);
+    bench("8x8 LMS6 read", req, 1, iterations);
+
+    nios_pkt_8x8_batch_pack(req, NIOS_PKT_8x8_TARGET_LMS6);
+    for (n = 0; n < NIOS_PKT_8x8_BATCH_MAX; n++) {
+        nios_pkt_8x8_batch_pack_op(req, true, 0x40 + n, n);
+    }
+    bench("8x8 batch LMS6 write", req, NIOS_PKT_8x8_BATCH_MAX, iterations);
+
+    nios_pkt_8x8_block_pack(req, NIOS_PKT_8x8_TARGET_LMS6, true, 0x40, data,
+                            NIOS_PKT_8x8_BLOCK_MAX);
+    bench("8x8 block LMS6 write", req, NIOS_PKT_8x8_BLOCK_MAX, iterations);
+
+    nios_pkt_8x8_block_pack(req, NIOS_PKT_8x8_TARGET_LMS6, false, 0x40, NULL,
+                            NIOS_PKT_8x8_BLOCK_MAX);
+    bench("8x8 block LMS6 read", req, NIOS_PKT_8x8_BLOCK_MAX, iterations);
+
+    nios_pkt_8x8_pack(req, NIOS_PKT_8x8_TARGET_SI5338, false, 0x03, 0);
+    bench("8x8 Si5338 read", req, 1, iterations);
+
+    nios_pkt_8x32_pack(req, NIOS_PKT_8x32_TARGET_CONTROL, false, 0, 0);
+    bench("8x32 config GPIO read", req, 1, iterations);
+
+    nios_pkt_32x32_pack(req, NIOS_PKT_32x32_TARGET_EXP, true, 0x0000ff00, 0);
+    bench("32x32 expansion masked write", req, 1, iterations);
+
+    printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int iterations = DEFAULT_ITERATIONS;
+    size_t i;
+    int status;
+
+    if (argc > 1) {
+        iterations = (unsigned int)strtoul(argv[1], NULL, 0);
+        if (iterations == 0) {
+            fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    status = bladerf_open(&dev, "*:backend=dummy");
+    if (status != 0) {
+        fprintf(stderr, "Failed to open a dummy device: %s\n",
+                bladerf_strerror(status));
+        return EXIT_FAILURE;
+    }
+
+    devices_dummy_attach(dev);
+
+    memset(&pkt, 0, sizeof(pkt));
+    bladerf_nios_init(&pkt, NULL);
+    pkt_dispatch_init(&pkt_dispatch, pkt_handlers, ARRAY_SIZE(pkt_handlers));
+
+    printf("\nTests\n\n");
+
+    for (i = 0; i < ARRAY_SIZE(reg8_targets); i++) {
+        const struct reg8_target *t = &reg8_targets[i];
+        char desc[64];
+
+        snprintf(desc, sizeof(desc), "8x8 %s", t->name);
+        run_test(desc, test_8x8, t);
+
+        snprintf(desc, sizeof(desc), "8x8 batch %s", t->name);
+        run_test(desc, test_8x8_batch, t);
+
+        snprintf(desc, sizeof(desc), "8x8 block %s", t->name);
+        run_test(desc, test_8x8_block, t);
+    }
+
+    run_test("8x32 config GPIO", run_config_gpio, NULL);
+    run_test("32x32 expansion GPIO", run_expansion, NULL);
+    run_test("8x16 IQ corrections", run_iq_corr, NULL);
+    run_test("8x16 VCTCXO trim DAC", run_vctcxo_dac, NULL);
+    run_test("8x64 timestamp", run_timestamp, NULL);
+
+    if (failures == 0) {
+        run_benchmarks(iterations);
+    } else {
+        printf("\n%u failure(s). Skipping benchmarks.\n", failures);
+    }
+
+    bladerf_close(dev);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#endif
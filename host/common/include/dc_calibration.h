@@ -144,6 +144,41 @@ int dc_calibration(struct bladerf *dev, bladerf_module module,
                    struct dc_calibration_params *params,
                    size_t num_params, bool show_status);
 
+/**
+ * A DC calibration to be performed by dc_calibration_multi()
+ */
+struct dc_calibration_job {
+    struct bladerf *dev;                    /**< Device handle */
+    bladerf_module module;                  /**< Module to calibrate */
+    struct dc_calibration_params *params;   /**< Frequencies and results */
+    size_t num_params;                      /**< Number of `params` entries */
+    int status;                             /**< Result of this job */
+};
+
+/**
+ * Perform DC calibrations on multiple devices concurrently.
+ *
+ * Each distinct device is calibrated by its own thread. Jobs for the same
+ * device, such as an RX and a TX table, are run one after another in the
+ * order in which they appear in the `jobs` list, as the TX calibration uses
+ * the RX module.
+ *
+ * Status information is not printed, as output from the devices would be
+ * interleaved.
+ *
+ * @pre dc_calibration_lms6() should have been called for all modules of each
+ *      device prior to using this function.
+ *
+ * @param[inout]    jobs        Calibrations to perform. The `status` field of
+ *                              each entry is updated with its result.
+ * @param[in]       num_jobs    Number of entries in the `jobs` list.
+ *
+ * @return 0 if all jobs succeeded, the first failing job's error code if
+ *         any failed, or BLADERF_ERR_MEM / BLADERF_ERR_UNEXPECTED if the
+ *         worker threads could not be created.
+ */
+int dc_calibration_multi(struct dc_calibration_job *jobs, size_t num_jobs);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -0,0 +1,112 @@
+/**
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+/* This file provides the sample processing kernels used by the DC calibration
+ * routines. Each kernel has a portable reference implementation (suffixed
+ * with _scalar), which the default implementation matches to within floating
+ * point rounding. */
+
+#ifndef DC_CALIBRATION_MATH_H_
+#define DC_CALIBRATION_MATH_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct complexf {
+    float i;
+    float q;
+};
+
+/** Number of taps in the filter applied by dc_cal_tx_filter() */
+#define DC_CAL_TX_FILT_NUM_TAPS 16
+
+/**
+ * Compute the mean of the I and Q components of SC16 Q11 samples
+ *
+ * @param[in]   samples     Interleaved I/Q samples
+ * @param[in]   count       Number of samples (I/Q pairs). Must be non-zero.
+ * @param[out]  mean_i      Mean of the I samples
+ * @param[out]  mean_q      Mean of the Q samples
+ */
+void dc_cal_sample_mean(const int16_t *samples, size_t count,
+                        float *mean_i, float *mean_q);
+
+void dc_cal_sample_mean_scalar(const int16_t *samples, size_t count,
+                               float *mean_i, float *mean_q);
+
+/**
+ * Deinterleave and scale SC16 Q11 samples, and mix them with an Fs/4 tone
+ *
+ * This is used to shift the TX LO leakage, which is observed at +/- Fs/4, to
+ * baseband.
+ *
+ * @param[in]   samples     Interleaved I/Q samples
+ * @param[out]  out         Mixed samples
+ * @param[in]   count       Number of samples (I/Q pairs)
+ * @param[in]   rx_low      Mix with -Fs/4 if true, and +Fs/4 otherwise
+ */
+void dc_cal_tx_mix(const int16_t *samples, struct complexf *out,
+                   size_t count, bool rx_low);
+
+void dc_cal_tx_mix_scalar(const int16_t *samples, struct complexf *out,
+                          size_t count, bool rx_low);
+
+/**
+ * Low pass filter samples to isolate the TX LO leakage at baseband
+ *
+ * The filter starts from a zeroed state, so the first
+ * DC_CAL_TX_FILT_NUM_TAPS - 1 outputs include the filter's ramp up.
+ *
+ * @param[in]   in          Input samples
+ * @param[out]  out         Filtered samples. Must not alias `in`.
+ * @param[in]   count       Number of samples
+ */
+void dc_cal_tx_filter(const struct complexf *in, struct complexf *out,
+                      size_t count);
+
+void dc_cal_tx_filter_scalar(const struct complexf *in, struct complexf *out,
+                             size_t count);
+
+/**
+ * Compute the average magnitude of the provided samples
+ *
+ * @param[in]   in          Input samples
+ * @param[in]   count       Number of samples. Must be non-zero.
+ *
+ * @return Average magnitude
+ */
+float dc_cal_avg_magnitude(const struct complexf *in, size_t count);
+
+float dc_cal_avg_magnitude_scalar(const struct complexf *in, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -30,6 +30,7 @@
 #define LOG_H__
 
 #include <stdio.h>
+#include <stdbool.h>
 #include <inttypes.h>
 
 #include "libbladeRF.h"
@@ -53,37 +54,140 @@ extern "C" {
 #define LOG_EXPAND__(x) #x
 #define LOG_EXPAND_(x) LOG_EXPAND__(x)
 
+/**
+ * @defgroup LOG_LEVELS Compile-time log levels
+ *
+ * Numeric values of ::bladerf_log_level, for use in preprocessor
+ * conditionals.
+ *
+ * @{
+ */
+#define LOG_LEVEL_VERBOSE   0
+#define LOG_LEVEL_DEBUG     1
+#define LOG_LEVEL_INFO      2
+#define LOG_LEVEL_WARNING   3
+#define LOG_LEVEL_ERROR     4
+#define LOG_LEVEL_CRITICAL  5
+/** @} */
+
+/**
+ * Log statements below this level are compiled out, rather than filtered at
+ * run-time. The build system defines this for data and control path sources
+ * when LIBBLADERF_LOGGING_MIN_LEVEL is set.
+ */
+#ifndef LOG_MIN_LEVEL
+#   define LOG_MIN_LEVEL LOG_LEVEL_VERBOSE
+#endif
+
+/* Compiled-out statements remain visible to the compiler, so that their
+ * arguments are still type-checked and not reported as unused. */
+#define LOG_DISCARD(...) \
+    do { if (0) { log_write(BLADERF_LOG_LEVEL_SILENT, __VA_ARGS__); } } while (0)
+
 /**
  * @defgroup LOG_MACROS Logging macros
  * @{
  */
 
 /** Logs a verbose message. Does not include function/line information */
+#if LOG_MIN_LEVEL <= LOG_LEVEL_VERBOSE
 #define log_verbose(...) \
     LOG_WRITE(BLADERF_LOG_LEVEL_VERBOSE, "[VERBOSE", __VA_ARGS__)
+#else
+#define log_verbose(...) LOG_DISCARD(__VA_ARGS__)
+#endif
 
 /** Logs a debug message. Does not include function/line information */
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
 #define log_debug(...) \
     LOG_WRITE(BLADERF_LOG_LEVEL_DEBUG, "[DEBUG", __VA_ARGS__)
+#else
+#define log_debug(...) LOG_DISCARD(__VA_ARGS__)
+#endif
 
 /** Logs an info message. Does not include function/line information*/
+#if LOG_MIN_LEVEL <= LOG_LEVEL_INFO
 #define log_info(...) \
     LOG_WRITE(BLADERF_LOG_LEVEL_INFO, "[INFO", __VA_ARGS__)
+#else
+#define log_info(...) LOG_DISCARD(__VA_ARGS__)
+#endif
 
 /** Logs a warning message. Includes function/line information */
+#if LOG_MIN_LEVEL <= LOG_LEVEL_WARNING
 #define log_warning(...) \
     LOG_WRITE(BLADERF_LOG_LEVEL_WARNING, "[WARNING", __VA_ARGS__)
+#else
+#define log_warning(...) LOG_DISCARD(__VA_ARGS__)
+#endif
 
 /** Logs an error message. Includes function/line information */
+#if LOG_MIN_LEVEL <= LOG_LEVEL_ERROR
 #define log_error(...) \
     LOG_WRITE(BLADERF_LOG_LEVEL_ERROR, "[ERROR", __VA_ARGS__)
+#else
+#define log_error(...) LOG_DISCARD(__VA_ARGS__)
+#endif
 
 /** Logs a critical error message. Includes function/line information */
+#if LOG_MIN_LEVEL <= LOG_LEVEL_CRITICAL
 #define log_critical(...) \
     LOG_WRITE(BLADERF_LOG_LEVEL_CRITICAL, "[CRITICAL", __VA_ARGS__)
+#else
+#define log_critical(...) LOG_DISCARD(__VA_ARGS__)
+#endif
+
+/**
+ * Logs a debug message, subject to the rate limit of the specified
+ * subsystem. Intended for messages that may be emitted from a data path.
+ */
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
+#define log_debug_ratelimited(subsys, ...) \
+    LOG_WRITE_RATELIMITED(subsys, BLADERF_LOG_LEVEL_DEBUG, log_debug, \
+                          __VA_ARGS__)
+#else
+#define log_debug_ratelimited(subsys, ...) LOG_DISCARD(__VA_ARGS__)
+#endif
+
+/**
+ * Logs a warning message, subject to the rate limit of the specified
+ * subsystem. Intended for messages that may be emitted from a data path.
+ */
+#if LOG_MIN_LEVEL <= LOG_LEVEL_WARNING
+#define log_warning_ratelimited(subsys, ...) \
+    LOG_WRITE_RATELIMITED(subsys, BLADERF_LOG_LEVEL_WARNING, log_warning, \
+                          __VA_ARGS__)
+#else
+#define log_warning_ratelimited(subsys, ...) LOG_DISCARD(__VA_ARGS__)
+#endif
 
 /** @} */
 
+/**
+ * Subsystems with independent rate limits, for use with the
+ * log_*_ratelimited() macros
+ */
+typedef enum {
+    LOG_SUBSYS_USB,     /**< USB backend transfer handling */
+    LOG_SUBSYS_SYNC,    /**< Synchronous interface and its worker */
+    LOG_SUBSYS_STREAM,  /**< Asynchronous stream callbacks */
+    LOG_SUBSYS_COUNT
+} log_subsys;
+
+/**
+ * Number of messages a subsystem may log within a one-second window before
+ * further messages are suppressed. A count of suppressed messages is logged
+ * once the next window begins.
+ */
+#define LOG_RATELIMIT_BURST 10
+
+#define LOG_WRITE_RATELIMITED(SUBSYS, LEVEL, LOG_FN, ...) \
+    do { \
+        if (LEVEL >= log_get_verbosity() && log_ratelimit(SUBSYS)) { \
+            LOG_FN(__VA_ARGS__); \
+        } \
+    } while (0)
+
 #ifdef LOG_INCLUDE_FILE_INFO
 #   define LOG_WRITE(LEVEL, LEVEL_STRING, ...) \
     do { log_write(LEVEL, LEVEL_STRING  \
@@ -137,6 +241,50 @@ bladerf_log_level log_get_verbosity();
 #define log_get_verbosity(...) BLADERF_LOG_LEVEL_SILENT
 #endif
 
+/**
+ * Registers a function that log messages are passed to, in place of stderr
+ * or syslog.
+ *
+ * @param   cb          Callback, or NULL to restore the default output
+ * @param   user_data   Caller data passed to the callback
+ */
+#ifdef LOGGING_ENABLED
+void log_set_callback(bladerf_log_callback cb, void *user_data);
+#else
+#define log_set_callback(cb, user_data) do {} while (0)
+#endif
+
+/**
+ * Enables or disables asynchronous logging, in which messages are formatted
+ * into a lock-free ring and written out by a background thread. Disabling it
+ * writes out any queued messages before returning.
+ *
+ * @param   enable      Enable asynchronous logging
+ *
+ * @return  0 on success, BLADERF_ERR_UNSUPPORTED if built without support
+ *          for asynchronous logging, or another BLADERF_ERR_* value if the
+ *          background thread could not be started.
+ */
+#if defined(LOGGING_ENABLED) && defined(LOG_ASYNC_ENABLED)
+int log_set_async(bool enable);
+#else
+#define log_set_async(enable) BLADERF_ERR_UNSUPPORTED
+#endif
+
+/**
+ * Checks and updates the rate limit of a subsystem. This should only be
+ * invoked indirectly through the log_*_ratelimited() macros.
+ *
+ * @param   subsys      Subsystem issuing a message
+ *
+ * @return  true if the message should be logged, false if it is suppressed
+ */
+#ifdef LOGGING_ENABLED
+bool log_ratelimit(log_subsys subsys);
+#else
+#define log_ratelimit(subsys) false
+#endif
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -0,0 +1,176 @@
+/**
+ * @file sample_convert.h
+ *
+ * @brief Sample format conversions shared by libbladeRF and the utilities
+ *
+ * Conversions are vectorized with SSE2, AVX2 or NEON where available. The
+ * kernels are selected on first use based upon the running CPU.
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2019 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef SAMPLE_CONVERT_H_
+#define SAMPLE_CONVERT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Scaling between SC16Q11 sample values and floating point */
+#define SC16Q11_SCALE 2048.0f
+
+/*
+ * Unless otherwise noted, buffers hold interleaved I, Q pairs, and `n` is a
+ * number of complex samples. Input and output buffers may be the same where
+ * their element sizes match, but must not otherwise overlap.
+ */
+
+/**
+ * Convert SC16Q11 samples to float samples, where [-2048, 2048) maps to
+ * [-1.0, 1.0).
+ *
+ * @param[in]   in      SC16Q11 samples
+ * @param[out]  out     Float samples
+ * @param[in]   n       Number of samples
+ */
+void sc16q11_to_float(const int16_t *in, float *out, size_t n);
+
+/**
+ * Convert every other SC16Q11 sample (in[0], in[2], ...) to float samples,
+ * decimating by 2 without filtering
+ *
+ * @param[in]   in      SC16Q11 samples. This holds at least 2 * n - 1
+ *                      samples.
+ * @param[out]  out     Float samples
+ * @param[in]   n       Number of samples written to `out`
+ */
+void sc16q11_to_float_decim2(const int16_t *in, float *out, size_t n);
+
+/**
+ * Convert float samples to SC16Q11 samples, rounding to the nearest value
+ * and saturating to the valid range of [-2048, 2047].
+ *
+ * @param[in]   in      Float samples
+ * @param[out]  out     SC16Q11 samples
+ * @param[in]   n       Number of samples
+ */
+void float_to_sc16q11(const float *in, int16_t *out, size_t n);
+
+/**
+ * Convert SC16Q11 samples to float samples while applying a linear
+ * correction to each sample.
+ *
+ * Each set of coefficients `c` maps a sample (I, Q) to
+ * (c[0] * I + c[1] * Q, c[2] * I + c[3] * Q), and must include any scaling
+ * to the float range (e.g., 1 / ::SC16Q11_SCALE). Distinct coefficients may
+ * be provided for even and odd samples, for use with interleaved two-channel
+ * streams.
+ *
+ * @param[in]   in      SC16Q11 samples
+ * @param[out]  out     Float samples
+ * @param[in]   n       Number of samples
+ * @param[in]   even    Coefficients applied to in[0], in[2], ...
+ * @param[in]   odd     Coefficients applied to in[1], in[3], ...
+ */
+void sc16q11_to_float_corr(const int16_t *in, float *out, size_t n,
+                           const float even[4], const float odd[4]);
+
+/**
+ * Convert SC16Q11 samples to SC8Q7 samples, as the FPGA's 8-bit sample mode
+ * does: the 4 least significant bits are discarded, and values are
+ * saturated to [-128, 127].
+ *
+ * @param[in]   in      SC16Q11 samples
+ * @param[out]  out     SC8Q7 samples
+ * @param[in]   n       Number of samples
+ */
+void sc16q11_to_sc8q7(const int16_t *in, int8_t *out, size_t n);
+
+/**
+ * Convert SC8Q7 samples to SC16Q11 samples. This is exact.
+ *
+ * @param[in]   in      SC8Q7 samples
+ * @param[out]  out     SC16Q11 samples
+ * @param[in]   n       Number of samples
+ */
+void sc8q7_to_sc16q11(const int8_t *in, int16_t *out, size_t n);
+
+/**
+ * Swap the byte order of SC16Q11 samples
+ *
+ * @param[in]   in      Input samples
+ * @param[out]  out     Output samples, which may be `in`
+ * @param[in]   n       Number of samples
+ */
+void sc16q11_swap(const int16_t *in, int16_t *out, size_t n);
+
+/**
+ * Accumulate the energy, I^2 + Q^2, of SC16Q11 samples
+ *
+ * The energy of even samples (in[0], in[2], ...) is added to `energy[0]`
+ * and that of odd samples to `energy[1]`, so that the channels of an
+ * interleaved two-channel stream may be measured in one pass. Single-channel
+ * callers may sum the two.
+ *
+ * @param[in]       in      SC16Q11 samples
+ * @param[in]       n       Number of samples
+ * @param[in,out]   energy  Energy of the even and odd samples, added to
+ */
+void sc16q11_energy(const int16_t *in, size_t n, uint64_t energy[2]);
+
+/**
+ * Convert little-endian SC16Q11 samples, as sent by the device, to host
+ * byte order. The inverse conversion is the same operation.
+ *
+ * @param[in]   in      Little-endian samples
+ * @param[out]  out     Host byte order samples, which may be `in`
+ * @param[in]   n       Number of samples
+ */
+void sc16q11_le_to_host(const int16_t *in, int16_t *out, size_t n);
+
+/**
+ * Round a float to the nearest int16_t, saturating to [INT16_MIN, INT16_MAX]
+ *
+ * @param[in]   val     Value to convert
+ *
+ * @return rounded value
+ */
+static inline int16_t float_to_int16(float val)
+{
+    if ((val - 0.5) <= INT16_MIN) {
+        return INT16_MIN;
+    }
+    if ((val + 0.5) >= INT16_MAX) {
+        return INT16_MAX;
+    }
+    return val >= 0 ? (int16_t)(val + 0.5) : (int16_t)(val - 0.5);
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * @file simd.h
+ *
+ * @brief Vector instruction set availability
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2017 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef SIMD_H_
+#define SIMD_H_
+
+#include <stdbool.h>
+
+/*
+ * Vector instruction set availability for the sample data paths.
+ *
+ * SSE2 is part of the x86-64 baseline. AVX2 kernels are built via function
+ * target attributes and selected at runtime via simd_have_avx2(), so the
+ * code need not be compiled with -mavx2.
+ */
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define SIMD_HAVE_SSE2 1
+#endif
+
+#if defined(SIMD_HAVE_SSE2) && defined(__GNUC__) && \
+    (__GNUC__ >= 5 || defined(__clang__))
+#   include <immintrin.h>
+#   define SIMD_HAVE_AVX2 1
+#   define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   include <arm_neon.h>
+#   define SIMD_HAVE_NEON 1
+#endif
+
+#ifdef SIMD_HAVE_AVX2
+static inline bool simd_have_avx2(void)
+{
+    return __builtin_cpu_supports("avx2");
+}
+#endif
+
+#endif
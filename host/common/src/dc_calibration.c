@@ -31,12 +31,10 @@
 #include <libbladeRF.h>
 
 #include "dc_calibration.h"
+#include "dc_calibration_math.h"
 #include "conversions.h"
-
-struct complexf {
-    float i;
-    float q;
-};
+#include "sample_convert.h"
+#include "thread.h"
 
 struct gain_mode {
     bladerf_lna_gain lna_gain;
@@ -245,18 +243,6 @@ int dc_calibration_lms6(struct bladerf *dev, const char *module_str)
  * Shared utility routines
  ******************************************************************************/
 
-/* Round float to int16_t */
-static inline int16_t float_to_int16(float val)
-{
-    if ((val - 0.5) <= INT16_MIN) {
-        return INT16_MIN;
-    }
-    if ((val + 0.5) >= INT16_MAX) {
-        return INT16_MAX;
-    }
-    return val >= 0 ? (int16_t)(val + 0.5) : (int16_t)(val - 0.5);
-}
-
 /* Convert ms to samples */
 #define MS_TO_SAMPLES(ms_, rate_) (\
     (unsigned int) (ms_ * ((uint64_t) rate_) / 1000) \
@@ -308,6 +294,24 @@ static int rx_samples(struct bladerf *dev, int16_t *samples,
     return status;
 }
 
+/* Schedule the next RX capture to begin `settle` samples after the present
+ * time. This is used after a correction register write: the write has taken
+ * effect before the current timestamp is read, so every sample in the
+ * capture reflects the new correction value. This avoids padding each
+ * measurement with a worst-case delay for the write to complete. */
+static int schedule_capture(struct bladerf *dev, uint64_t *ts, uint64_t settle)
+{
+    int status;
+    uint64_t now;
+
+    status = bladerf_get_timestamp(dev, BLADERF_MODULE_RX, &now);
+    if (status == 0) {
+        *ts = now + settle;
+    }
+
+    return status;
+}
+
 
 
 /*******************************************************************************
@@ -319,6 +323,13 @@ static int rx_samples(struct bladerf *dev, int16_t *samples,
 #define RX_CAL_TS_INC           (MS_TO_SAMPLES(15, RX_CAL_RATE))
 #define RX_CAL_COUNT            (MS_TO_SAMPLES(5,  RX_CAL_RATE))
 
+/* Time allowed for a DC correction change to settle before a capture */
+#define RX_CAL_SETTLE           (MS_TO_SAMPLES(1,  RX_CAL_RATE))
+
+/* Small buffers are used so that a capture becomes available shortly after
+ * its last sample is received */
+#define CAL_BUFFER_SIZE         4096
+
 #define RX_CAL_MAX_SWEEP_LEN    (2 * 2048 / 32) /* -2048 : 32 : 2048 */
 
 struct rx_cal {
@@ -429,31 +440,6 @@ static int rx_cal_update_frequency(struct rx_cal *cal, uint64_t rx_freq)
     return status;
 }
 
-static inline void sample_mean(int16_t *samples, size_t count,
-                               float *mean_i, float *mean_q)
-{
-    int64_t accum_i = 0;
-    int64_t accum_q = 0;
-
-    size_t n;
-
-
-    if (count == 0) {
-        assert(!"Invalid count (0) provided to sample_mean()");
-        *mean_i = 0;
-        *mean_q = 0;
-        return;
-    }
-
-    for (n = 0; n < (2 * count); n += 2) {
-        accum_i += samples[n];
-        accum_q += samples[n + 1];
-    }
-
-    *mean_i = ((float) accum_i) / count;
-    *mean_q = ((float) accum_q) / count;
-}
-
 static inline int set_rx_dc_corr(struct bladerf *dev, int16_t i, int16_t q)
 {
     int status;
@@ -486,13 +472,18 @@ static int rx_cal_coarse_means(struct rx_cal *cal, int16_t *corr_value,
             return status;
         }
 
+        status = schedule_capture(cal->dev, &cal->ts, RX_CAL_SETTLE);
+        if (status != 0) {
+            return status;
+        }
+
         status = rx_samples(cal->dev, cal->samples, cal->num_samples,
-                            &cal->ts, RX_CAL_TS_INC);
+                            &cal->ts, RX_CAL_SETTLE);
         if (status != 0) {
             return status;
         }
 
-        sample_mean(cal->samples, cal->num_samples, mean_i, mean_q);
+        dc_cal_sample_mean(cal->samples, cal->num_samples, mean_i, mean_q);
 
         if (*mean_i > mean_limit_high || *mean_q > mean_limit_high ||
             *mean_i < mean_limit_low  || *mean_q < mean_limit_low    ) {
@@ -687,13 +678,60 @@ static int rx_cal_dc_off(struct rx_cal *cal, struct gain_mode *gains,
         return status;
     }
 
-    sample_mean(cal->samples, cal->num_samples, &mean_i, &mean_q);
+    dc_cal_sample_mean(cal->samples, cal->num_samples, &mean_i, &mean_q);
     *dc_i = float_to_int16(mean_i);
     *dc_q = float_to_int16(mean_q);
 
     return 0;
 }
 
+/* Measure the mean of the samples received with each of the specified
+ * correction values applied.
+ *
+ * This is pipelined: once the capture for value K has been received, value K+1
+ * is written and its capture is scheduled; the mean of capture K is then
+ * computed while the device acquires capture K+1. */
+static int rx_cal_measure_sweep(struct rx_cal *cal,
+                                const int16_t *corr, unsigned int sweep_len,
+                                float *mean_i, float *mean_q)
+{
+    int status;
+    unsigned int n;
+
+    if (sweep_len == 0) {
+        return 0;
+    }
+
+    status = set_rx_dc_corr(cal->dev, corr[0], corr[0]);
+    if (status != 0) {
+        return status;
+    }
+
+    status = schedule_capture(cal->dev, &cal->ts, RX_CAL_SETTLE);
+
+    for (n = 0; n < sweep_len && status == 0; n++) {
+        status = rx_samples(cal->dev, cal->samples, cal->num_samples,
+                            &cal->ts, RX_CAL_SETTLE);
+        if (status != 0) {
+            return status;
+        }
+
+        if ((n + 1) < sweep_len) {
+            status = set_rx_dc_corr(cal->dev, corr[n + 1], corr[n + 1]);
+            if (status != 0) {
+                return status;
+            }
+
+            status = schedule_capture(cal->dev, &cal->ts, RX_CAL_SETTLE);
+        }
+
+        dc_cal_sample_mean(cal->samples, cal->num_samples,
+                           &mean_i[n], &mean_q[n]);
+    }
+
+    return status;
+}
+
 static int rx_cal_sweep(struct rx_cal *cal,
                         int16_t *corr, unsigned int sweep_len,
                         int16_t *result_i, int16_t *result_q,
@@ -705,24 +743,21 @@ static int rx_cal_sweep(struct rx_cal *cal,
     int16_t min_corr_i = 0;
     int16_t min_corr_q = 0;
 
+    float means_i[RX_CAL_MAX_SWEEP_LEN];
+    float means_q[RX_CAL_MAX_SWEEP_LEN];
     float mean_i, mean_q;
     float min_val_i, min_val_q;
 
     min_val_i = min_val_q = 2048;
 
-    for (n = 0; n < sweep_len; n++) {
-        status = set_rx_dc_corr(cal->dev, corr[n], corr[n]);
-        if (status != 0) {
-            return status;
-        }
-
-        status = rx_samples(cal->dev, cal->samples, cal->num_samples,
-                            &cal->ts, RX_CAL_TS_INC);
-        if (status != 0) {
-            return status;
-        }
+    status = rx_cal_measure_sweep(cal, corr, sweep_len, means_i, means_q);
+    if (status != 0) {
+        return status;
+    }
 
-        sample_mean(cal->samples, cal->num_samples, &mean_i, &mean_q);
+    for (n = 0; n < sweep_len; n++) {
+        mean_i = means_i[n];
+        mean_q = means_q[n];
 
         PR_VERBOSE("  Corr=%4d, Mean_I=%4.2f, Mean_Q=%4.2f\n",
                    corr[n], mean_i, mean_q);
@@ -885,7 +920,7 @@ static int rx_cal_init(struct bladerf *dev)
 
     status = bladerf_sync_config(dev, BLADERF_MODULE_RX,
                                  BLADERF_FORMAT_SC16_Q11_META,
-                                 64, 16384, 16, 1000);
+                                 64, CAL_BUFFER_SIZE, 16, 1000);
     if (status != 0) {
         return status;
     }
@@ -993,6 +1028,9 @@ out:
 
 #define TX_CAL_CORR_SWEEP_LEN (4096 / 16)   /* -2048:16:2048 */
 
+/* Time allowed for a DC correction change to settle before a capture */
+#define TX_CAL_SETTLE   (MS_TO_SAMPLES(1, TX_CAL_RATE))
+
 #define TX_CAL_DEFAULT_LB (BLADERF_LB_RF_LNA1)
 
 struct tx_cal_backup {
@@ -1014,7 +1052,6 @@ struct tx_cal {
     struct bladerf *dev;
     int16_t *samples;           /* Raw samples */
     unsigned int num_samples;   /* Number of raw samples */
-    struct complexf *filt;      /* Filter state */
     struct complexf *filt_out;  /* Filter output */
     struct complexf *post_mix;  /* Post-filter, mixed to baseband */
     int16_t *sweep;             /* Correction sweep */
@@ -1024,21 +1061,6 @@ struct tx_cal {
     bool rx_low;                /* RX tuned lower than TX */
 };
 
-/* Filter used to isolate contribution of TX LO leakage in received
- * signal. 15th order Equiripple FIR with Fs=4e6, Fpass=1, Fstop=1e6
- */
-static const float tx_cal_filt[] = {
-    0.000327949366768f, 0.002460188536582f, 0.009842382390924f,
-    0.027274728394777f, 0.057835200476419f, 0.098632713294830f,
-    0.139062540460741f, 0.164562494987592f, 0.164562494987592f,
-    0.139062540460741f, 0.098632713294830f, 0.057835200476419f,
-    0.027274728394777f, 0.009842382390924f, 0.002460188536582f,
-    0.000327949366768f,
-};
-
-static const unsigned int tx_cal_filt_num_taps =
-    (sizeof(tx_cal_filt) / sizeof(tx_cal_filt[0]));
-
 static inline int set_tx_dc_corr(struct bladerf *dev, int16_t i, int16_t q)
 {
     int status;
@@ -1272,7 +1294,7 @@ static int tx_cal_rx_init(struct bladerf *dev)
 
     status = bladerf_sync_config(dev, BLADERF_MODULE_RX,
                                  BLADERF_FORMAT_SC16_Q11_META,
-                                 64, 16384, 32, 1000);
+                                 64, CAL_BUFFER_SIZE, 32, 1000);
     if (status != 0) {
         return status;
     }
@@ -1286,7 +1308,6 @@ static void tx_cal_state_deinit(struct tx_cal *cal)
     free(cal->sweep);
     free(cal->mag);
     free(cal->samples);
-    free(cal->filt);
     free(cal->filt_out);
     free(cal->post_mix);
 }
@@ -1306,12 +1327,6 @@ static int tx_cal_state_init(struct bladerf *dev, struct tx_cal *cal)
         return BLADERF_ERR_MEM;
     }
 
-    /* Filter state */
-    cal->filt = malloc(2 * sizeof(cal->filt[0]) * tx_cal_filt_num_taps);
-    if (cal->filt == NULL) {
-        return BLADERF_ERR_MEM;
-    }
-
     /* Filter output */
     cal->filt_out = malloc(sizeof(cal->filt_out[0]) * cal->num_samples);
     if (cal->filt_out == NULL) {
@@ -1344,148 +1359,74 @@ static int tx_cal_state_init(struct bladerf *dev, struct tx_cal *cal)
     return status;
 }
 
-/* Filter samples
- *  Input:  state->post_mix
- *  Output: state->filt_out
- */
-static void tx_cal_filter(struct tx_cal *state)
+/* Compute the average magnitude of the TX DC offset in state->samples */
+static float tx_cal_avg_magnitude(struct tx_cal *state)
 {
-    unsigned int n, m;
-    struct complexf *ins1, *ins2;
-    struct complexf *curr; /* Current filter state */
-    const struct complexf *filt_end = &state->filt[2 * tx_cal_filt_num_taps];
-
-    /* Reset filter state */
-    ins1 = &state->filt[0];
-    ins2 = &state->filt[tx_cal_filt_num_taps];
-    memset(state->filt, 0, 2 * sizeof(state->filt[0]) * tx_cal_filt_num_taps);
-
-    for (n = 0; n < state->num_samples; n++) {
-        /* Insert sample */
-        *ins1 = *ins2 = state->post_mix[n];
-
-        /* Convolve */
-        state->filt_out[n].i = 0;
-        state->filt_out[n].q = 0;
-        curr = ins2;
-
-        for (m = 0; m < tx_cal_filt_num_taps; m++, curr--) {
-            state->filt_out[n].i += tx_cal_filt[m] * curr->i;
-            state->filt_out[n].q += tx_cal_filt[m] * curr->q;
-        }
-
-        /* Update insertion points */
-        ins2++;
-        if (ins2 == filt_end) {
-            ins1 = &state->filt[0];
-            ins2 = &state->filt[tx_cal_filt_num_taps];
-        } else {
-            ins1++;
-        }
+    const unsigned int start = (DC_CAL_TX_FILT_NUM_TAPS + 1) / 2;
+    float avg_mag;
 
-    }
-}
-
-/* Deinterleave, scale, and mix with an -Fs/4 tone to shift TX DC offset out at
- * Fs/4 to baseband.
- *  Input:  state->samples
- *  Output: state->post_mix
- */
-static void tx_cal_mix(struct tx_cal *state)
-{
-    unsigned int n, m;
-    int mix_state;
-    float scaled_i, scaled_q;
-
-    /* Mix with -Fs/4 if RX is tuned "lower" than TX, and Fs/4 otherwise */
-    const int mix_state_inc = state->rx_low ? 1 : -1;
-    mix_state = 0;
-
-    for (n = 0, m = 0; n < (2 * state->num_samples); n += 2, m++) {
-        scaled_i = state->samples[n]   / 2048.0f;
-        scaled_q = state->samples[n+1] / 2048.0f;
-
-        switch (mix_state) {
-            case 0:
-                state->post_mix[m].i =  scaled_i;
-                state->post_mix[m].q =  scaled_q;
-                break;
-
-            case 1:
-                state->post_mix[m].i =  scaled_q;
-                state->post_mix[m].q = -scaled_i;
-                break;
+    /* Deinterleave & mix TX's DC offset contribution to baseband */
+    dc_cal_tx_mix(state->samples, state->post_mix, state->num_samples,
+                  state->rx_low);
 
-            case 2:
-                state->post_mix[m].i = -scaled_i;
-                state->post_mix[m].q = -scaled_q;
-                break;
+    /* Filter out everything other than the TX DC offset's contribution */
+    dc_cal_tx_filter(state->post_mix, state->filt_out, state->num_samples);
 
-            case 3:
-                state->post_mix[m].i = -scaled_q;
-                state->post_mix[m].q =  scaled_i;
-                break;
-        }
+    /* Compute the average magnitude. We skip samples here to account for the
+     * group delay of the filter; the initial samples will be ramping up. */
+    avg_mag = dc_cal_avg_magnitude(&state->filt_out[start],
+                                   state->num_samples - start);
 
-        mix_state = (mix_state + mix_state_inc) & 0x3;
-    }
+    /* Scale this back up to DAC/ADC counts, just for convenience */
+    return avg_mag * SC16Q11_SCALE;
 }
 
-static int tx_cal_avg_magnitude(struct tx_cal *state, float *avg_mag)
+/* Apply each of the specified correction values and measure the resulting
+ * TX DC offset magnitude.
+ *
+ * As with the RX calibration, this is pipelined: the next correction value is
+ * applied and its capture scheduled before the current capture is processed,
+ * so the device acquires samples while the host filters the previous set. */
+static int tx_cal_measure_sweep(struct tx_cal *state,
+                                bladerf_correction c,
+                                const int16_t *values, unsigned int len,
+                                float *mag)
 {
     int status;
-    const unsigned int start = (tx_cal_filt_num_taps + 1) / 2;
     unsigned int n;
-    float accum;
 
-    /* Fetch samples at the current settings */
-    status = rx_samples(state->dev, state->samples, state->num_samples,
-                        &state->ts, TX_CAL_TS_INC);
-    if (status != 0) {
-        return status;
+    if (len == 0) {
+        return 0;
     }
 
-    /* Deinterleave & mix TX's DC offset contribution to baseband */
-    tx_cal_mix(state);
-
-    /* Filter out everything other than the TX DC offset's contribution */
-    tx_cal_filter(state);
-
-    /* Compute the power (magnitude^2 to alleviate need for square root).
-     * We skip samples here to account for the group delay of the filter;
-     * the initial samples will be ramping up. */
-    accum = 0;
-    for (n = start; n < state->num_samples; n++) {
-        const struct complexf *s = &state->filt_out[n];
-        const float m = (float) sqrt(s->i * s->i + s->q * s->q);
-        accum += m;
+    status = bladerf_set_correction(state->dev, BLADERF_MODULE_TX, c,
+                                    values[0]);
+    if (status != 0) {
+        return status;
     }
 
-    *avg_mag = (accum / (state->num_samples - start));
-
-    /* Scale this back up to DAC/ADC counts, just for convenience */
-    *avg_mag *= 2048.0;
-
-    return status;
-}
+    status = schedule_capture(state->dev, &state->ts, TX_CAL_SETTLE);
 
-/* Apply the correction value and read the TX DC offset magnitude */
-static int tx_cal_measure_correction(struct tx_cal *state,
-                                     bladerf_correction c,
-                                     int16_t value, float *mag)
-{
-    int status;
+    for (n = 0; n < len && status == 0; n++) {
+        /* Fetch samples at the current settings */
+        status = rx_samples(state->dev, state->samples, state->num_samples,
+                            &state->ts, TX_CAL_SETTLE);
+        if (status != 0) {
+            return status;
+        }
 
-    status = bladerf_set_correction(state->dev, BLADERF_MODULE_TX, c, value);
-    if (status != 0) {
-        return status;
-    }
+        if ((n + 1) < len) {
+            status = bladerf_set_correction(state->dev, BLADERF_MODULE_TX, c,
+                                            values[n + 1]);
+            if (status != 0) {
+                return status;
+            }
 
-    state->ts += TX_CAL_TS_INC;
+            status = schedule_capture(state->dev, &state->ts, TX_CAL_SETTLE);
+        }
 
-    status = tx_cal_avg_magnitude(state, mag);
-    if (status == 0) {
-        PR_VERBOSE("  Corr=%5d, Avg_magnitude=%f\n", value, *mag);
+        mag[n] = tx_cal_avg_magnitude(state);
+        PR_VERBOSE("  Corr=%5d, Avg_magnitude=%f\n", values[n], mag[n]);
     }
 
     return status;
@@ -1495,7 +1436,7 @@ static int tx_cal_get_corr(struct tx_cal *state, bool i_ch,
                            int16_t *corr_value, float *error_value)
 {
     int status;
-    unsigned int n;
+    unsigned int n, sweep_len;
     int16_t corr;
     float mag[4];
     float m1, m2, b1, b2;
@@ -1510,12 +1451,9 @@ static int tx_cal_get_corr(struct tx_cal *state, bool i_ch,
 
     PR_DBG("Getting coarse estimate for %c\n", i_ch ? 'I' : 'Q');
 
-    for (n = 0; n < 4; n++) {
-        status = tx_cal_measure_correction(state, corr_module, x[n], &mag[n]);
-        if (status != 0) {
-            return status;
-        }
-
+    status = tx_cal_measure_sweep(state, corr_module, x, 4, mag);
+    if (status != 0) {
+        return status;
     }
 
     m1 = (mag[1] - mag[0]) / (x[1] - x[0]);
@@ -1566,20 +1504,26 @@ static int tx_cal_get_corr(struct tx_cal *state, bool i_ch,
     for (n = 0, corr = range_min;
          corr <= range_max && n < TX_CAL_CORR_SWEEP_LEN;
          n++, corr += 16) {
+        state->sweep[n] = corr;
+    }
 
-        float tmp;
+    sweep_len = n;
 
-        status = tx_cal_measure_correction(state, corr_module, corr, &tmp);
-        if (status != 0) {
-            return status;
-        }
+    status = tx_cal_measure_sweep(state, corr_module, state->sweep, sweep_len,
+                                  state->mag);
+    if (status != 0) {
+        return status;
+    }
+
+    for (n = 0; n < sweep_len; n++) {
+        float tmp = state->mag[n];
 
         if (tmp < 0) {
             tmp = -tmp;
         }
 
         if (tmp < min_mag) {
-            min_corr = corr;
+            min_corr = state->sweep[n];
             min_mag  = tmp;
         }
     }
@@ -1743,3 +1687,85 @@ int dc_calibration(struct bladerf *dev, bladerf_module module,
 
     return status;
 }
+
+/*******************************************************************************
+ * Multi-device calibration
+ ******************************************************************************/
+
+struct dc_calibration_worker {
+    pthread_t thread;
+    struct dc_calibration_job *jobs;
+    size_t num_jobs;
+    struct bladerf *dev;
+};
+
+static void *dc_calibration_worker_fn(void *arg)
+{
+    struct dc_calibration_worker *w = (struct dc_calibration_worker *) arg;
+    size_t i;
+
+    for (i = 0; i < w->num_jobs; i++) {
+        struct dc_calibration_job *job = &w->jobs[i];
+
+        if (job->dev == w->dev) {
+            job->status = dc_calibration(job->dev, job->module, job->params,
+                                         job->num_params, false);
+        }
+    }
+
+    return NULL;
+}
+
+int dc_calibration_multi(struct dc_calibration_job *jobs, size_t num_jobs)
+{
+    struct dc_calibration_worker *workers;
+    size_t num_workers = 0;
+    size_t num_started = 0;
+    size_t i, j;
+    int status = 0;
+
+    workers = calloc(num_jobs, sizeof(workers[0]));
+    if (workers == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    /* One worker per distinct device. Each worker scans the full job list
+     * for its device's entries, which preserves their order. */
+    for (i = 0; i < num_jobs; i++) {
+        jobs[i].status = BLADERF_ERR_UNEXPECTED;
+
+        for (j = 0; j < num_workers; j++) {
+            if (workers[j].dev == jobs[i].dev) {
+                break;
+            }
+        }
+
+        if (j == num_workers) {
+            workers[num_workers].dev      = jobs[i].dev;
+            workers[num_workers].jobs     = jobs;
+            workers[num_workers].num_jobs = num_jobs;
+            num_workers++;
+        }
+    }
+
+    for (i = 0; i < num_workers; i++) {
+        if (pthread_create(&workers[i].thread, NULL,
+                           dc_calibration_worker_fn, &workers[i]) != 0) {
+            status = BLADERF_ERR_UNEXPECTED;
+            break;
+        }
+
+        num_started++;
+    }
+
+    for (i = 0; i < num_started; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+
+    for (i = 0; i < num_jobs && status == 0; i++) {
+        status = jobs[i].status;
+    }
+
+    free(workers);
+    return status;
+}
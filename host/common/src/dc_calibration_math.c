@@ -0,0 +1,347 @@
+/**
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <assert.h>
+#include <math.h>
+
+#include "dc_calibration_math.h"
+#include "sample_convert.h"
+#include "simd.h"
+
+/* Filter used to isolate contribution of TX LO leakage in received
+ * signal. 15th order Equiripple FIR with Fs=4e6, Fpass=1, Fstop=1e6
+ */
+static const float tx_cal_filt[DC_CAL_TX_FILT_NUM_TAPS] = {
+    0.000327949366768f, 0.002460188536582f, 0.009842382390924f,
+    0.027274728394777f, 0.057835200476419f, 0.098632713294830f,
+    0.139062540460741f, 0.164562494987592f, 0.164562494987592f,
+    0.139062540460741f, 0.098632713294830f, 0.057835200476419f,
+    0.027274728394777f, 0.009842382390924f, 0.002460188536582f,
+    0.000327949366768f,
+};
+
+/*******************************************************************************
+ * Scalar implementations
+ ******************************************************************************/
+
+static inline void mean_finish(int64_t accum_i, int64_t accum_q, size_t count,
+                               float *mean_i, float *mean_q)
+{
+    *mean_i = ((float) accum_i) / count;
+    *mean_q = ((float) accum_q) / count;
+}
+
+void dc_cal_sample_mean_scalar(const int16_t *samples, size_t count,
+                               float *mean_i, float *mean_q)
+{
+    int64_t accum_i = 0;
+    int64_t accum_q = 0;
+    size_t n;
+
+    if (count == 0) {
+        assert(!"Invalid count (0) provided to dc_cal_sample_mean()");
+        *mean_i = 0;
+        *mean_q = 0;
+        return;
+    }
+
+    for (n = 0; n < (2 * count); n += 2) {
+        accum_i += samples[n];
+        accum_q += samples[n + 1];
+    }
+
+    mean_finish(accum_i, accum_q, count, mean_i, mean_q);
+}
+
+/* Mix samples [start, count). The mixer phase advances by one quarter turn
+ * per sample, starting from 0 at sample 0. */
+static void mix_range(const int16_t *samples, struct complexf *out,
+                      size_t start, size_t count, bool rx_low)
+{
+    const int mix_state_inc = rx_low ? 1 : -1;
+    int mix_state = ((int) (start & 0x3) * mix_state_inc) & 0x3;
+    float scaled_i, scaled_q;
+    size_t m;
+
+    for (m = start; m < count; m++) {
+        scaled_i = samples[2 * m]     / SC16Q11_SCALE;
+        scaled_q = samples[2 * m + 1] / SC16Q11_SCALE;
+
+        switch (mix_state) {
+            case 0:
+                out[m].i =  scaled_i;
+                out[m].q =  scaled_q;
+                break;
+
+            case 1:
+                out[m].i =  scaled_q;
+                out[m].q = -scaled_i;
+                break;
+
+            case 2:
+                out[m].i = -scaled_i;
+                out[m].q = -scaled_q;
+                break;
+
+            case 3:
+                out[m].i = -scaled_q;
+                out[m].q =  scaled_i;
+                break;
+        }
+
+        mix_state = (mix_state + mix_state_inc) & 0x3;
+    }
+}
+
+void dc_cal_tx_mix_scalar(const int16_t *samples, struct complexf *out,
+                          size_t count, bool rx_low)
+{
+    mix_range(samples, out, 0, count, rx_low);
+}
+
+/* Filter outputs [start, end), treating samples prior to in[0] as zero */
+static void filter_range(const struct complexf *in, struct complexf *out,
+                         size_t start, size_t end)
+{
+    size_t n, m;
+
+    for (n = start; n < end; n++) {
+        float i = 0, q = 0;
+
+        for (m = 0; m < DC_CAL_TX_FILT_NUM_TAPS && m <= n; m++) {
+            i += tx_cal_filt[m] * in[n - m].i;
+            q += tx_cal_filt[m] * in[n - m].q;
+        }
+
+        out[n].i = i;
+        out[n].q = q;
+    }
+}
+
+void dc_cal_tx_filter_scalar(const struct complexf *in, struct complexf *out,
+                             size_t count)
+{
+    filter_range(in, out, 0, count);
+}
+
+static float magnitude_sum(const struct complexf *in, size_t start,
+                           size_t count)
+{
+    float accum = 0;
+    size_t n;
+
+    for (n = start; n < count; n++) {
+        accum += (float) sqrt(in[n].i * in[n].i + in[n].q * in[n].q);
+    }
+
+    return accum;
+}
+
+float dc_cal_avg_magnitude_scalar(const struct complexf *in, size_t count)
+{
+    assert(count != 0);
+    return magnitude_sum(in, 0, count) / count;
+}
+
+/*******************************************************************************
+ * Vectorized implementations
+ ******************************************************************************/
+
+/* SSE2 is part of the x86-64 baseline, so no runtime detection is needed.
+ * Other architectures use the scalar implementations. */
+#ifdef SIMD_HAVE_SSE2
+
+/* Number of 4-sample blocks that may be summed in 32-bit lanes before they
+ * must be flushed to the 64-bit totals. Each block adds at most 2 * 2^15 to
+ * a lane. */
+#define MEAN_FLUSH_BLOCKS 16384
+
+void dc_cal_sample_mean(const int16_t *samples, size_t count,
+                        float *mean_i, float *mean_q)
+{
+    int64_t accum_i = 0;
+    int64_t accum_q = 0;
+    int32_t lanes[4];
+    size_t n = 0;
+
+    if (count == 0) {
+        dc_cal_sample_mean_scalar(samples, count, mean_i, mean_q);
+        return;
+    }
+
+    while (count - n >= 4) {
+        size_t blocks = (count - n) / 4;
+        __m128i acc = _mm_setzero_si128();
+
+        if (blocks > MEAN_FLUSH_BLOCKS) {
+            blocks = MEAN_FLUSH_BLOCKS;
+        }
+
+        for (; blocks > 0; blocks--, n += 4) {
+            const __m128i x =
+                _mm_loadu_si128((const __m128i *) &samples[2 * n]);
+
+            /* Sign extend to (I0 Q0 I1 Q1) and (I2 Q2 I3 Q3) */
+            const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+            const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+
+            acc = _mm_add_epi32(acc, _mm_add_epi32(lo, hi));
+        }
+
+        _mm_storeu_si128((__m128i *) lanes, acc);
+        accum_i += (int64_t) lanes[0] + lanes[2];
+        accum_q += (int64_t) lanes[1] + lanes[3];
+    }
+
+    for (; n < count; n++) {
+        accum_i += samples[2 * n];
+        accum_q += samples[2 * n + 1];
+    }
+
+    mean_finish(accum_i, accum_q, count, mean_i, mean_q);
+}
+
+void dc_cal_tx_mix(const int16_t *samples, struct complexf *out,
+                   size_t count, bool rx_low)
+{
+    const float s = 1.0f / SC16Q11_SCALE;
+    size_t m;
+
+    /* Four samples span one period of the mixer. Samples 0 and 2 are
+     * multiplied by 1 and -1, and samples 1 and 3 by -j and j (rx_low) or
+     * j and -j. The latter swap I and Q, with the sign applied below. */
+    const __m128 sign_01 = rx_low ? _mm_set_ps(-s,  s,  s,  s) :
+                                    _mm_set_ps( s, -s,  s,  s);
+    const __m128 sign_23 = rx_low ? _mm_set_ps( s, -s, -s, -s) :
+                                    _mm_set_ps(-s,  s, -s, -s);
+
+    for (m = 0; m + 4 <= count; m += 4) {
+        const __m128i x  = _mm_loadu_si128((const __m128i *) &samples[2 * m]);
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+
+        /* (I0 Q0 I1 Q1) -> (I0 Q0 Q1 I1) */
+        __m128 a = _mm_cvtepi32_ps(lo);
+        __m128 b = _mm_cvtepi32_ps(hi);
+        a = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 1, 0));
+        b = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 1, 0));
+
+        _mm_storeu_ps(&out[m].i,     _mm_mul_ps(a, sign_01));
+        _mm_storeu_ps(&out[m + 2].i, _mm_mul_ps(b, sign_23));
+    }
+
+    mix_range(samples, out, m, count, rx_low);
+}
+
+void dc_cal_tx_filter(const struct complexf *in, struct complexf *out,
+                      size_t count)
+{
+    const size_t start = DC_CAL_TX_FILT_NUM_TAPS - 1;
+    size_t n, m;
+
+    if (count <= start) {
+        filter_range(in, out, 0, count);
+        return;
+    }
+
+    /* The first outputs include the zeroed initial filter state */
+    filter_range(in, out, 0, start);
+
+    /* Compute four complex outputs per iteration, as two pairs of
+     * interleaved I/Q values, with the taps accumulated in the same order
+     * as the scalar implementation. */
+    for (n = start; n + 4 <= count; n += 4) {
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+
+        for (m = 0; m < DC_CAL_TX_FILT_NUM_TAPS; m++) {
+            const __m128 h = _mm_set1_ps(tx_cal_filt[m]);
+            const float *x = &in[n - m].i;
+
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(h, _mm_loadu_ps(x)));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(h, _mm_loadu_ps(x + 4)));
+        }
+
+        _mm_storeu_ps(&out[n].i,     acc0);
+        _mm_storeu_ps(&out[n + 2].i, acc1);
+    }
+
+    filter_range(in, out, n, count);
+}
+
+float dc_cal_avg_magnitude(const struct complexf *in, size_t count)
+{
+    __m128 acc = _mm_setzero_ps();
+    float lanes[4];
+    float accum;
+    size_t n;
+
+    assert(count != 0);
+
+    for (n = 0; n + 4 <= count; n += 4) {
+        const __m128 a = _mm_loadu_ps(&in[n].i);
+        const __m128 b = _mm_loadu_ps(&in[n + 2].i);
+        const __m128 a2 = _mm_mul_ps(a, a);
+        const __m128 b2 = _mm_mul_ps(b, b);
+
+        /* (I0^2 I1^2 I2^2 I3^2) + (Q0^2 Q1^2 Q2^2 Q3^2) */
+        const __m128 i2 = _mm_shuffle_ps(a2, b2, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 q2 = _mm_shuffle_ps(a2, b2, _MM_SHUFFLE(3, 1, 3, 1));
+
+        acc = _mm_add_ps(acc, _mm_sqrt_ps(_mm_add_ps(i2, q2)));
+    }
+
+    _mm_storeu_ps(lanes, acc);
+    accum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    accum += magnitude_sum(in, n, count);
+
+    return accum / count;
+}
+
+#else
+
+void dc_cal_sample_mean(const int16_t *samples, size_t count,
+                        float *mean_i, float *mean_q)
+{
+    dc_cal_sample_mean_scalar(samples, count, mean_i, mean_q);
+}
+
+void dc_cal_tx_mix(const int16_t *samples, struct complexf *out,
+                   size_t count, bool rx_low)
+{
+    dc_cal_tx_mix_scalar(samples, out, count, rx_low);
+}
+
+void dc_cal_tx_filter(const struct complexf *in, struct complexf *out,
+                      size_t count)
+{
+    dc_cal_tx_filter_scalar(in, out, count);
+}
+
+float dc_cal_avg_magnitude(const struct complexf *in, size_t count)
+{
+    return dc_cal_avg_magnitude_scalar(in, count);
+}
+
+#endif
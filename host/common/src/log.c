@@ -29,9 +29,289 @@
 #endif
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && \
+    !defined(__STDC_NO_ATOMICS__)
+#   include <stdatomic.h>
+#   define LOG_HAVE_ATOMICS 1
+#else
+#   define LOG_HAVE_ATOMICS 0
+#   undef LOG_ASYNC_ENABLED
+#endif
+
+#ifdef LOG_ASYNC_ENABLED
+#include "thread.h"
+#include "host_config.h"
+#if BLADERF_OS_WINDOWS || BLADERF_OS_OSX
+#include "clock_gettime.h"
+#endif
+#endif
+
+/* Maximum length of a message passed to a callback or queued for
+ * asynchronous output, including the NUL terminator. Longer messages are
+ * truncated. */
+#define LOG_MSG_MAX 256
 
 static bladerf_log_level filter_level = BLADERF_LOG_LEVEL_INFO;
 
+static bladerf_log_callback log_cb = NULL;
+static void *log_cb_data = NULL;
+
+#if defined(WIN32) || defined(__CYGWIN__) || !defined(LOG_SYSLOG_ENABLED)
+#   define LOG_USE_SYSLOG 0
+#else
+#   define LOG_USE_SYSLOG 1
+
+static int syslog_level(bladerf_log_level level)
+{
+    switch (level) {
+        case BLADERF_LOG_LEVEL_VERBOSE:
+        case BLADERF_LOG_LEVEL_DEBUG:
+            return LOG_DEBUG;
+
+        case BLADERF_LOG_LEVEL_INFO:
+            return LOG_INFO;
+
+        case BLADERF_LOG_LEVEL_WARNING:
+            return LOG_WARNING;
+
+        case BLADERF_LOG_LEVEL_ERROR:
+            return LOG_ERR;
+
+        case BLADERF_LOG_LEVEL_CRITICAL:
+            return LOG_CRIT;
+
+        default:
+            /* Shouldn't be used, so just route it to a low level */
+            return LOG_DEBUG;
+    }
+}
+#endif
+
+/* Write a formatted message to the registered callback, or to the default
+ * output if there is none */
+static void log_emit(bladerf_log_level level, const char *msg)
+{
+    bladerf_log_callback cb = log_cb;
+
+    if (cb != NULL) {
+        cb(level, msg, log_cb_data);
+    } else {
+#if LOG_USE_SYSLOG
+        syslog(syslog_level(level) | LOG_USER, "%s", msg);
+#else
+        fputs(msg, stderr);
+#endif
+    }
+}
+
+#ifdef LOG_ASYNC_ENABLED
+
+/* Number of messages the ring can hold. Must be a power of two. */
+#define LOG_RING_LEN 256
+
+/* Interval at which the flusher thread drains the ring */
+#define LOG_FLUSH_INTERVAL_MS 10
+
+/* Slots are claimed by atomically incrementing the ring's head, allowing
+ * any number of threads to queue messages without locking.
+ *
+ * A slot whose sequence number equals position `pos` is free to be claimed
+ * for that position. Once its message has been written, the sequence number
+ * is set to pos + 1, marking it ready for the flusher. The flusher then sets
+ * it to pos + LOG_RING_LEN, freeing it for the next pass around the ring. A
+ * producer finding the ring full drops its message rather than waiting. */
+struct log_slot {
+    atomic_size_t seq;
+    bladerf_log_level level;
+    char msg[LOG_MSG_MAX];
+};
+
+static struct {
+    atomic_bool enabled;
+    atomic_size_t head;
+    atomic_uint dropped;
+
+    /* Flusher state, protected by lock */
+    MUTEX lock;
+    pthread_cond_t wake;
+    pthread_t thread;
+    bool running;
+    bool stop;
+    bool initialized;
+    size_t tail;
+
+    struct log_slot slots[LOG_RING_LEN];
+} log_ring;
+
+/* Serializes log_set_async() callers */
+static pthread_mutex_t log_async_ctl = PTHREAD_MUTEX_INITIALIZER;
+
+/* Queue a message, returning false if asynchronous logging is disabled */
+static bool log_ring_push(bladerf_log_level level,
+                          const char *format, va_list args)
+{
+    struct log_slot *slot;
+    size_t pos;
+
+    if (!atomic_load_explicit(&log_ring.enabled, memory_order_acquire)) {
+        return false;
+    }
+
+    pos = atomic_load_explicit(&log_ring.head, memory_order_relaxed);
+
+    for (;;) {
+        size_t seq;
+        intptr_t diff;
+
+        slot = &log_ring.slots[pos & (LOG_RING_LEN - 1)];
+        seq  = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        diff = (intptr_t)seq - (intptr_t)pos;
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &log_ring.head, &pos, pos + 1,
+                    memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* Full */
+            atomic_fetch_add_explicit(&log_ring.dropped, 1,
+                                      memory_order_relaxed);
+            return true;
+        } else {
+            pos = atomic_load_explicit(&log_ring.head, memory_order_relaxed);
+        }
+    }
+
+    slot->level = level;
+    vsnprintf(slot->msg, sizeof(slot->msg), format, args);
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+
+    return true;
+}
+
+/* Write out all queued messages. Only called by the flusher thread, or by
+ * log_set_async() once the flusher has stopped. */
+static void log_ring_drain(void)
+{
+    unsigned int dropped;
+
+    for (;;) {
+        size_t tail = log_ring.tail;
+        struct log_slot *slot = &log_ring.slots[tail & (LOG_RING_LEN - 1)];
+
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) !=
+            tail + 1) {
+            break;
+        }
+
+        log_emit(slot->level, slot->msg);
+
+        atomic_store_explicit(&slot->seq, tail + LOG_RING_LEN,
+                              memory_order_release);
+        log_ring.tail = tail + 1;
+    }
+
+    dropped = atomic_exchange_explicit(&log_ring.dropped, 0,
+                                       memory_order_relaxed);
+    if (dropped != 0) {
+        char msg[64];
+
+        snprintf(msg, sizeof(msg),
+                 "[WARNING] %u log messages dropped\n", dropped);
+        log_emit(BLADERF_LOG_LEVEL_WARNING, msg);
+    }
+}
+
+static void *log_flusher(void *arg)
+{
+    const long nsec_per_sec = 1000 * 1000 * 1000;
+    struct timespec deadline;
+
+    MUTEX_LOCK(&log_ring.lock);
+
+    while (!log_ring.stop) {
+        MUTEX_UNLOCK(&log_ring.lock);
+        log_ring_drain();
+        MUTEX_LOCK(&log_ring.lock);
+
+        if (clock_gettime(CLOCK_REALTIME, &deadline) != 0) {
+            break;
+        }
+
+        deadline.tv_nsec += LOG_FLUSH_INTERVAL_MS * 1000 * 1000;
+        if (deadline.tv_nsec >= nsec_per_sec) {
+            deadline.tv_sec  += 1;
+            deadline.tv_nsec -= nsec_per_sec;
+        }
+
+        if (!log_ring.stop) {
+            pthread_cond_timedwait(&log_ring.wake, &log_ring.lock, &deadline);
+        }
+    }
+
+    MUTEX_UNLOCK(&log_ring.lock);
+    return NULL;
+}
+
+int log_set_async(bool enable)
+{
+    int status = 0;
+
+    MUTEX_LOCK(&log_async_ctl);
+
+    if (!log_ring.initialized) {
+        size_t i;
+
+        /* The ring is never reset afterwards, so that a message queued by a
+         * thread that raced with disabling is written out the next time
+         * asynchronous logging is enabled, rather than corrupting the ring */
+        for (i = 0; i < LOG_RING_LEN; i++) {
+            atomic_init(&log_ring.slots[i].seq, i);
+        }
+
+        atomic_init(&log_ring.enabled, false);
+        atomic_init(&log_ring.head, 0);
+        atomic_init(&log_ring.dropped, 0);
+        MUTEX_INIT(&log_ring.lock);
+        pthread_cond_init(&log_ring.wake, NULL);
+        log_ring.tail = 0;
+        log_ring.initialized = true;
+    }
+
+    if (enable && !log_ring.running) {
+        log_ring.stop = false;
+
+        if (pthread_create(&log_ring.thread, NULL, log_flusher, NULL) != 0) {
+            status = BLADERF_ERR_UNEXPECTED;
+        } else {
+            log_ring.running = true;
+            atomic_store_explicit(&log_ring.enabled, true,
+                                  memory_order_release);
+        }
+    } else if (!enable && log_ring.running) {
+        atomic_store_explicit(&log_ring.enabled, false, memory_order_release);
+
+        MUTEX_LOCK(&log_ring.lock);
+        log_ring.stop = true;
+        pthread_cond_signal(&log_ring.wake);
+        MUTEX_UNLOCK(&log_ring.lock);
+
+        pthread_join(log_ring.thread, NULL);
+        log_ring.running = false;
+
+        log_ring_drain();
+    }
+
+    MUTEX_UNLOCK(&log_async_ctl);
+    return status;
+}
+
+#endif /* LOG_ASYNC_ENABLED */
+
 void log_write(bladerf_log_level level, const char *format, ...)
 {
     /* Only process this message if its level exceeds the current threshold */
@@ -41,47 +321,26 @@ void log_write(bladerf_log_level level, const char *format, ...)
 
         /* Write the log message */
         va_start(args, format);
-#if defined(WIN32) || defined(__CYGWIN__)
-        vfprintf(stderr, format, args);
-#else
-#  if defined (LOG_SYSLOG_ENABLED)
-        {
-            int syslog_level;
-
-            switch (level) {
-                case BLADERF_LOG_LEVEL_VERBOSE:
-                case BLADERF_LOG_LEVEL_DEBUG:
-                    syslog_level = LOG_DEBUG;
-                    break;
-
-                case BLADERF_LOG_LEVEL_INFO:
-                    syslog_level = LOG_INFO;
-                    break;
-
-                case BLADERF_LOG_LEVEL_WARNING:
-                    syslog_level = LOG_WARNING;
-                    break;
-
-                case BLADERF_LOG_LEVEL_ERROR:
-                    syslog_level = LOG_ERR;
-                    break;
-
-                case BLADERF_LOG_LEVEL_CRITICAL:
-                    syslog_level = LOG_CRIT;
-                    break;
-
-                default:
-                    /* Shouldn't be used, so just route it to a low level */
-                    syslog_level = LOG_DEBUG;
-                    break;
-            }
 
-            vsyslog(syslog_level | LOG_USER, format, args);
+#ifdef LOG_ASYNC_ENABLED
+        if (log_ring_push(level, format, args)) {
+            va_end(args);
+            return;
         }
-#  else
-        vfprintf(stderr, format, args);
-#  endif
 #endif
+
+        if (log_cb != NULL) {
+            char msg[LOG_MSG_MAX];
+            vsnprintf(msg, sizeof(msg), format, args);
+            log_emit(level, msg);
+        } else {
+#if LOG_USE_SYSLOG
+            vsyslog(syslog_level(level) | LOG_USER, format, args);
+#else
+            vfprintf(stderr, format, args);
+#endif
+        }
+
         va_end(args);
     }
 }
@@ -95,4 +354,114 @@ bladerf_log_level log_get_verbosity()
 {
     return filter_level;
 }
+
+void log_set_callback(bladerf_log_callback cb, void *user_data)
+{
+    /* The data is published before the callback, so that a concurrent
+     * log_write() does not pass a new callback the previous data */
+    log_cb_data = user_data;
+    log_cb = cb;
+}
+
+static const char *subsys2str(log_subsys subsys)
+{
+    switch (subsys) {
+        case LOG_SUBSYS_USB:
+            return "USB";
+        case LOG_SUBSYS_SYNC:
+            return "sync";
+        case LOG_SUBSYS_STREAM:
+            return "stream";
+        default:
+            return "unknown";
+    }
+}
+
+/* Rate limiting is done over one-second windows of time(). Without atomics,
+ * the counts may be off when multiple threads log from the same subsystem at
+ * once, which is harmless. */
+#if LOG_HAVE_ATOMICS
+static struct {
+    atomic_llong window;
+    atomic_uint count;
+    atomic_uint suppressed;
+} ratelimit[LOG_SUBSYS_COUNT];
+
+bool log_ratelimit(log_subsys subsys)
+{
+    long long now = (long long)time(NULL);
+    long long window;
+
+    if ((unsigned int)subsys >= LOG_SUBSYS_COUNT) {
+        return true;
+    }
+
+    window = atomic_load_explicit(&ratelimit[subsys].window,
+                                  memory_order_relaxed);
+
+    /* The thread that moves the window forward resets the count */
+    if (now != window &&
+        atomic_compare_exchange_strong_explicit(&ratelimit[subsys].window,
+                                                &window, now,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+        unsigned int suppressed;
+
+        atomic_store_explicit(&ratelimit[subsys].count, 0,
+                              memory_order_relaxed);
+
+        suppressed = atomic_exchange_explicit(&ratelimit[subsys].suppressed,
+                                              0, memory_order_relaxed);
+        if (suppressed != 0) {
+            log_write(BLADERF_LOG_LEVEL_WARNING,
+                      "[WARNING] %u %s log messages suppressed\n",
+                      suppressed, subsys2str(subsys));
+        }
+    }
+
+    if (atomic_fetch_add_explicit(&ratelimit[subsys].count, 1,
+                                  memory_order_relaxed) < LOG_RATELIMIT_BURST) {
+        return true;
+    }
+
+    atomic_fetch_add_explicit(&ratelimit[subsys].suppressed, 1,
+                              memory_order_relaxed);
+    return false;
+}
+#else
+static struct {
+    long long window;
+    unsigned int count;
+    unsigned int suppressed;
+} ratelimit[LOG_SUBSYS_COUNT];
+
+bool log_ratelimit(log_subsys subsys)
+{
+    long long now = (long long)time(NULL);
+
+    if ((unsigned int)subsys >= LOG_SUBSYS_COUNT) {
+        return true;
+    }
+
+    if (now != ratelimit[subsys].window) {
+        ratelimit[subsys].window = now;
+        ratelimit[subsys].count = 0;
+
+        if (ratelimit[subsys].suppressed != 0) {
+            log_write(BLADERF_LOG_LEVEL_WARNING,
+                      "[WARNING] %u %s log messages suppressed\n",
+                      ratelimit[subsys].suppressed, subsys2str(subsys));
+            ratelimit[subsys].suppressed = 0;
+        }
+    }
+
+    if (ratelimit[subsys].count < LOG_RATELIMIT_BURST) {
+        ratelimit[subsys].count++;
+        return true;
+    }
+
+    ratelimit[subsys].suppressed++;
+    return false;
+}
+#endif
 #endif
@@ -0,0 +1,708 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2019 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "host_config.h"
+#include "sample_convert.h"
+#include "simd.h"
+
+#define SC16Q11_MIN (-2048)
+#define SC16Q11_MAX 2047
+
+#define SC8Q7_MIN (-128)
+#define SC8Q7_MAX 127
+
+/* SC8Q7 values are the 8 most significant bits of SC16Q11 values */
+#define SC8Q7_SHIFT 4
+
+typedef void (*to_cf32_fn)(int16_t const *in, float *out, size_t n);
+typedef void (*from_cf32_fn)(float const *in, int16_t *out, size_t n);
+typedef void (*to_cf32_corr_fn)(int16_t const *in, float *out, size_t n,
+                                float const even[4], float const odd[4]);
+typedef void (*to_sc8_fn)(int16_t const *in, int8_t *out, size_t n);
+typedef void (*from_sc8_fn)(int8_t const *in, int16_t *out, size_t n);
+typedef void (*swap_fn)(int16_t const *in, int16_t *out, size_t n);
+typedef void (*energy_fn)(int16_t const *in, size_t n, uint64_t energy[2]);
+
+static void to_cf32_scalar(int16_t const *in, float *out, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < 2 * n; i++) {
+        out[i] = (float)in[i] * (1.0f / SC16Q11_SCALE);
+    }
+}
+
+static void from_cf32_scalar(float const *in, int16_t *out, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < 2 * n; i++) {
+        float v = in[i] * SC16Q11_SCALE;
+
+        if (v < SC16Q11_MIN) {
+            v = SC16Q11_MIN;
+        } else if (v > SC16Q11_MAX) {
+            v = SC16Q11_MAX;
+        }
+
+        /* Round half away from zero */
+        out[i] = (int16_t)(v >= 0 ? v + 0.5f : v - 0.5f);
+    }
+}
+
+static void to_cf32_corr_scalar(int16_t const *in, float *out, size_t n,
+                                float const even[4], float const odd[4])
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        float const *c = (i % 2 == 0) ? even : odd;
+        const float s_i = (float)in[2 * i];
+        const float s_q = (float)in[2 * i + 1];
+
+        out[2 * i]     = c[0] * s_i + c[1] * s_q;
+        out[2 * i + 1] = c[2] * s_i + c[3] * s_q;
+    }
+}
+
+static void to_sc8_scalar(int16_t const *in, int8_t *out, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < 2 * n; i++) {
+        int v = in[i] >> SC8Q7_SHIFT;
+
+        if (v < SC8Q7_MIN) {
+            v = SC8Q7_MIN;
+        } else if (v > SC8Q7_MAX) {
+            v = SC8Q7_MAX;
+        }
+
+        out[i] = (int8_t)v;
+    }
+}
+
+static void from_sc8_scalar(int8_t const *in, int16_t *out, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < 2 * n; i++) {
+        out[i] = (int16_t)(in[i] * (1 << SC8Q7_SHIFT));
+    }
+}
+
+static void to_cf32_decim2_scalar(int16_t const *in, float *out, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        out[2 * i]     = (float)in[4 * i] * (1.0f / SC16Q11_SCALE);
+        out[2 * i + 1] = (float)in[4 * i + 1] * (1.0f / SC16Q11_SCALE);
+    }
+}
+
+static void swap_scalar(int16_t const *in, int16_t *out, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < 2 * n; i++) {
+        const uint16_t v = (uint16_t)in[i];
+        out[i]           = (int16_t)(uint16_t)((v >> 8) | (v << 8));
+    }
+}
+
+static void energy_scalar(int16_t const *in, size_t n, uint64_t energy[2])
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        const int32_t s_i = in[2 * i];
+        const int32_t s_q = in[2 * i + 1];
+
+        energy[i % 2] += (uint64_t)(s_i * s_i) + (uint64_t)(s_q * s_q);
+    }
+}
+
+#ifdef SIMD_HAVE_SSE2
+static void to_cf32_sse2(int16_t const *in, float *out, size_t n)
+{
+    const __m128 scale = _mm_set1_ps(1.0f / SC16Q11_SCALE);
+    size_t i;
+
+    /* 4 complex samples per iteration */
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128i v  = _mm_loadu_si128((__m128i const *)(in + 2 * i));
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+
+        _mm_storeu_ps(out + 2 * i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(out + 2 * i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+
+    to_cf32_scalar(in + 2 * i, out + 2 * i, n - i);
+}
+
+static void from_cf32_sse2(float const *in, int16_t *out, size_t n)
+{
+    const __m128 scale  = _mm_set1_ps(SC16Q11_SCALE);
+    const __m128i min   = _mm_set1_epi16(SC16Q11_MIN);
+    const __m128i max   = _mm_set1_epi16(SC16Q11_MAX);
+    size_t i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128i a = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + 2 * i), scale));
+        __m128i b =
+            _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + 2 * i + 4), scale));
+        __m128i v = _mm_packs_epi32(a, b);
+
+        v = _mm_min_epi16(_mm_max_epi16(v, min), max);
+        _mm_storeu_si128((__m128i *)(out + 2 * i), v);
+    }
+
+    from_cf32_scalar(in + 2 * i, out + 2 * i, n - i);
+}
+
+static void to_cf32_corr_sse2(int16_t const *in, float *out, size_t n,
+                              float const even[4], float const odd[4])
+{
+    /* Each vector holds an even and an odd sample. The diagonal terms apply
+     * to (I, Q) and the cross terms to the swapped (Q, I). */
+    const __m128 diag  = _mm_setr_ps(even[0], even[3], odd[0], odd[3]);
+    const __m128 cross = _mm_setr_ps(even[1], even[2], odd[1], odd[2]);
+    size_t i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128i v  = _mm_loadu_si128((__m128i const *)(in + 2 * i));
+        __m128 lo  = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v),
+                                                    16));
+        __m128 hi  = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v),
+                                                    16));
+        __m128 lo_s = _mm_shuffle_ps(lo, lo, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 hi_s = _mm_shuffle_ps(hi, hi, _MM_SHUFFLE(2, 3, 0, 1));
+
+        _mm_storeu_ps(out + 2 * i, _mm_add_ps(_mm_mul_ps(lo, diag),
+                                              _mm_mul_ps(lo_s, cross)));
+        _mm_storeu_ps(out + 2 * i + 4, _mm_add_ps(_mm_mul_ps(hi, diag),
+                                                  _mm_mul_ps(hi_s, cross)));
+    }
+
+    to_cf32_corr_scalar(in + 2 * i, out + 2 * i, n - i, even, odd);
+}
+
+static void to_sc8_sse2(int16_t const *in, int8_t *out, size_t n)
+{
+    size_t i;
+
+    /* 8 complex samples per iteration */
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m128i a = _mm_loadu_si128((__m128i const *)(in + 2 * i));
+        __m128i b = _mm_loadu_si128((__m128i const *)(in + 2 * i + 8));
+
+        _mm_storeu_si128((__m128i *)(out + 2 * i),
+                         _mm_packs_epi16(_mm_srai_epi16(a, SC8Q7_SHIFT),
+                                         _mm_srai_epi16(b, SC8Q7_SHIFT)));
+    }
+
+    to_sc8_scalar(in + 2 * i, out + 2 * i, n - i);
+}
+
+static void from_sc8_sse2(int8_t const *in, int16_t *out, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128((__m128i const *)(in + 2 * i));
+
+        /* Widen each byte into the high byte of a 16-bit lane, and then
+         * shift it back down, which sign extends it */
+        __m128i lo = _mm_unpacklo_epi8(_mm_setzero_si128(), v);
+        __m128i hi = _mm_unpackhi_epi8(_mm_setzero_si128(), v);
+
+        _mm_storeu_si128((__m128i *)(out + 2 * i),
+                         _mm_srai_epi16(lo, 8 - SC8Q7_SHIFT));
+        _mm_storeu_si128((__m128i *)(out + 2 * i + 8),
+                         _mm_srai_epi16(hi, 8 - SC8Q7_SHIFT));
+    }
+
+    from_sc8_scalar(in + 2 * i, out + 2 * i, n - i);
+}
+
+static void to_cf32_decim2_sse2(int16_t const *in, float *out, size_t n)
+{
+    const __m128 scale = _mm_set1_ps(1.0f / SC16Q11_SCALE);
+    size_t i;
+
+    /* 4 output samples from 8 input samples per iteration. Each 32-bit lane
+     * holds one complex sample, so keeping the even lanes decimates. The
+     * final odd sample may not exist, so the last block is left to the
+     * scalar loop. */
+    for (i = 0; i + 4 < n; i += 4) {
+        __m128 a = _mm_castsi128_ps(
+            _mm_loadu_si128((__m128i const *)(in + 4 * i)));
+        __m128 b = _mm_castsi128_ps(
+            _mm_loadu_si128((__m128i const *)(in + 4 * i + 8)));
+        __m128i v  = _mm_castps_si128(
+            _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+
+        _mm_storeu_ps(out + 2 * i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(out + 2 * i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+
+    to_cf32_decim2_scalar(in + 4 * i, out + 2 * i, n - i);
+}
+
+static void swap_sse2(int16_t const *in, int16_t *out, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128((__m128i const *)(in + 2 * i));
+
+        _mm_storeu_si128((__m128i *)(out + 2 * i),
+                         _mm_or_si128(_mm_slli_epi16(v, 8),
+                                      _mm_srli_epi16(v, 8)));
+    }
+
+    swap_scalar(in + 2 * i, out + 2 * i, n - i);
+}
+
+static void energy_sse2(int16_t const *in, size_t n, uint64_t energy[2])
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc        = _mm_setzero_si128();
+    uint64_t lanes[2];
+    size_t i;
+
+    /* 4 complex samples per iteration. Each 32-bit lane of the multiply-add
+     * holds one sample's I^2 + Q^2, which is at most 2^31 and so is exact
+     * when taken as unsigned. The lanes are widened to 64 bits, even
+     * samples accumulating in the low half and odd samples in the high
+     * half. */
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128((__m128i const *)(in + 2 * i));
+        __m128i p = _mm_madd_epi16(v, v);
+
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(p, zero));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(p, zero));
+    }
+
+    _mm_storeu_si128((__m128i *)lanes, acc);
+    energy[0] += lanes[0];
+    energy[1] += lanes[1];
+
+    energy_scalar(in + 2 * i, n - i, energy);
+}
+#endif
+
+#ifdef SIMD_HAVE_AVX2
+SIMD_TARGET_AVX2
+static void to_cf32_avx2(int16_t const *in, float *out, size_t n)
+{
+    const __m256 scale = _mm256_set1_ps(1.0f / SC16Q11_SCALE);
+    size_t i;
+
+    /* 8 complex samples per iteration */
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m256i lo = _mm256_cvtepi16_epi32(
+            _mm_loadu_si128((__m128i const *)(in + 2 * i)));
+        __m256i hi = _mm256_cvtepi16_epi32(
+            _mm_loadu_si128((__m128i const *)(in + 2 * i + 8)));
+
+        _mm256_storeu_ps(out + 2 * i,
+                         _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+        _mm256_storeu_ps(out + 2 * i + 8,
+                         _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+    }
+
+    to_cf32_sse2(in + 2 * i, out + 2 * i, n - i);
+}
+
+SIMD_TARGET_AVX2
+static void from_cf32_avx2(float const *in, int16_t *out, size_t n)
+{
+    const __m256 scale = _mm256_set1_ps(SC16Q11_SCALE);
+    const __m256i min  = _mm256_set1_epi16(SC16Q11_MIN);
+    const __m256i max  = _mm256_set1_epi16(SC16Q11_MAX);
+    size_t i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m256i a = _mm256_cvtps_epi32(
+            _mm256_mul_ps(_mm256_loadu_ps(in + 2 * i), scale));
+        __m256i b = _mm256_cvtps_epi32(
+            _mm256_mul_ps(_mm256_loadu_ps(in + 2 * i + 8), scale));
+
+        /* packs operates per 128-bit lane; restore sample order */
+        __m256i v = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xd8);
+
+        v = _mm256_min_epi16(_mm256_max_epi16(v, min), max);
+        _mm256_storeu_si256((__m256i *)(out + 2 * i), v);
+    }
+
+    from_cf32_sse2(in + 2 * i, out + 2 * i, n - i);
+}
+
+SIMD_TARGET_AVX2
+static void to_cf32_corr_avx2(int16_t const *in, float *out, size_t n,
+                              float const even[4], float const odd[4])
+{
+    const __m256 diag  = _mm256_setr_ps(even[0], even[3], odd[0], odd[3],
+                                        even[0], even[3], odd[0], odd[3]);
+    const __m256 cross = _mm256_setr_ps(even[1], even[2], odd[1], odd[2],
+                                        even[1], even[2], odd[1], odd[2]);
+    size_t i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m256 lo = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(
+            _mm_loadu_si128((__m128i const *)(in + 2 * i))));
+        __m256 hi = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(
+            _mm_loadu_si128((__m128i const *)(in + 2 * i + 8))));
+
+        /* Swap I and Q within each sample */
+        __m256 lo_s = _mm256_permute_ps(lo, _MM_SHUFFLE(2, 3, 0, 1));
+        __m256 hi_s = _mm256_permute_ps(hi, _MM_SHUFFLE(2, 3, 0, 1));
+
+        _mm256_storeu_ps(out + 2 * i,
+                         _mm256_add_ps(_mm256_mul_ps(lo, diag),
+                                       _mm256_mul_ps(lo_s, cross)));
+        _mm256_storeu_ps(out + 2 * i + 8,
+                         _mm256_add_ps(_mm256_mul_ps(hi, diag),
+                                       _mm256_mul_ps(hi_s, cross)));
+    }
+
+    to_cf32_corr_sse2(in + 2 * i, out + 2 * i, n - i, even, odd);
+}
+
+SIMD_TARGET_AVX2
+static void swap_avx2(int16_t const *in, int16_t *out, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((__m256i const *)(in + 2 * i));
+
+        _mm256_storeu_si256((__m256i *)(out + 2 * i),
+                            _mm256_or_si256(_mm256_slli_epi16(v, 8),
+                                            _mm256_srli_epi16(v, 8)));
+    }
+
+    swap_sse2(in + 2 * i, out + 2 * i, n - i);
+}
+#endif
+
+#ifdef SIMD_HAVE_NEON
+static void to_cf32_neon(int16_t const *in, float *out, size_t n)
+{
+    const float32x4_t scale = vdupq_n_f32(1.0f / SC16Q11_SCALE);
+    size_t i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        int16x8_t v = vld1q_s16(in + 2 * i);
+
+        vst1q_f32(out + 2 * i,
+                  vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+        vst1q_f32(out + 2 * i + 4,
+                  vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+    }
+
+    to_cf32_scalar(in + 2 * i, out + 2 * i, n - i);
+}
+
+static inline int16x4_t from_cf32_neon_4(float const *in)
+{
+    const float32x4_t scale = vdupq_n_f32(SC16Q11_SCALE);
+    const uint32x4_t sign   = vdupq_n_u32(0x80000000);
+    float32x4_t v           = vmulq_f32(vld1q_f32(in), scale);
+
+    /* Round half away from zero, as vcvtq_s32_f32 truncates */
+    float32x4_t half = vreinterpretq_f32_u32(
+        vorrq_u32(vandq_u32(vreinterpretq_u32_f32(v), sign),
+                  vreinterpretq_u32_f32(vdupq_n_f32(0.5f))));
+
+    return vqmovn_s32(vcvtq_s32_f32(vaddq_f32(v, half)));
+}
+
+static void from_cf32_neon(float const *in, int16_t *out, size_t n)
+{
+    const int16x8_t min = vdupq_n_s16(SC16Q11_MIN);
+    const int16x8_t max = vdupq_n_s16(SC16Q11_MAX);
+    size_t i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        int16x8_t v = vcombine_s16(from_cf32_neon_4(in + 2 * i),
+                                   from_cf32_neon_4(in + 2 * i + 4));
+
+        vst1q_s16(out + 2 * i, vminq_s16(vmaxq_s16(v, min), max));
+    }
+
+    from_cf32_scalar(in + 2 * i, out + 2 * i, n - i);
+}
+
+static void to_cf32_corr_neon(int16_t const *in, float *out, size_t n,
+                              float const even[4], float const odd[4])
+{
+    const float diag_v[4]   = { even[0], even[3], odd[0], odd[3] };
+    const float cross_v[4]  = { even[1], even[2], odd[1], odd[2] };
+    const float32x4_t diag  = vld1q_f32(diag_v);
+    const float32x4_t cross = vld1q_f32(cross_v);
+    size_t i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        int16x8_t v    = vld1q_s16(in + 2 * i);
+        float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v)));
+        float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(v)));
+
+        vst1q_f32(out + 2 * i,
+                  vmlaq_f32(vmulq_f32(lo, diag), vrev64q_f32(lo), cross));
+        vst1q_f32(out + 2 * i + 4,
+                  vmlaq_f32(vmulq_f32(hi, diag), vrev64q_f32(hi), cross));
+    }
+
+    to_cf32_corr_scalar(in + 2 * i, out + 2 * i, n - i, even, odd);
+}
+
+static void to_sc8_neon(int16_t const *in, int8_t *out, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        int8x8_t lo = vqshrn_n_s16(vld1q_s16(in + 2 * i), SC8Q7_SHIFT);
+        int8x8_t hi = vqshrn_n_s16(vld1q_s16(in + 2 * i + 8), SC8Q7_SHIFT);
+
+        vst1q_s8(out + 2 * i, vcombine_s8(lo, hi));
+    }
+
+    to_sc8_scalar(in + 2 * i, out + 2 * i, n - i);
+}
+
+static void from_sc8_neon(int8_t const *in, int16_t *out, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        int8x16_t v = vld1q_s8(in + 2 * i);
+
+        vst1q_s16(out + 2 * i, vshll_n_s8(vget_low_s8(v), SC8Q7_SHIFT));
+        vst1q_s16(out + 2 * i + 8, vshll_n_s8(vget_high_s8(v), SC8Q7_SHIFT));
+    }
+
+    from_sc8_scalar(in + 2 * i, out + 2 * i, n - i);
+}
+
+static void to_cf32_decim2_neon(int16_t const *in, float *out, size_t n)
+{
+    const float32x4_t scale = vdupq_n_f32(1.0f / SC16Q11_SCALE);
+    size_t i;
+
+    /* De-interleaving 32-bit lanes separates even and odd samples */
+    for (i = 0; i + 4 < n; i += 4) {
+        int32x4x2_t v = vld2q_s32((int32_t const *)(in + 4 * i));
+        int16x8_t even = vreinterpretq_s16_s32(v.val[0]);
+
+        vst1q_f32(out + 2 * i,
+                  vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(even))),
+                            scale));
+        vst1q_f32(out + 2 * i + 4,
+                  vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(even))),
+                            scale));
+    }
+
+    to_cf32_decim2_scalar(in + 4 * i, out + 2 * i, n - i);
+}
+
+static void swap_neon(int16_t const *in, int16_t *out, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        uint8x16_t v = vreinterpretq_u8_s16(vld1q_s16(in + 2 * i));
+        vst1q_s16(out + 2 * i, vreinterpretq_s16_u8(vrev16q_u8(v)));
+    }
+
+    swap_scalar(in + 2 * i, out + 2 * i, n - i);
+}
+
+static void energy_neon(int16_t const *in, size_t n, uint64_t energy[2])
+{
+    uint64x2_t acc = vdupq_n_u64(0);
+    size_t i;
+
+    /* 2 complex samples per iteration. Adjacent squares are summed as they
+     * are accumulated, leaving even samples in lane 0 and odd in lane 1. */
+    for (i = 0; i + 2 <= n; i += 2) {
+        int16x4_t v = vld1_s16(in + 2 * i);
+        acc = vpadalq_u32(acc, vreinterpretq_u32_s32(vmull_s16(v, v)));
+    }
+
+    energy[0] += vgetq_lane_u64(acc, 0);
+    energy[1] += vgetq_lane_u64(acc, 1);
+
+    energy_scalar(in + 2 * i, n - i, energy);
+}
+#endif
+
+static to_cf32_fn to_cf32_impl     = NULL;
+static from_cf32_fn from_cf32_impl = NULL;
+static to_cf32_corr_fn to_cf32_corr_impl = NULL;
+static to_sc8_fn to_sc8_impl       = NULL;
+static from_sc8_fn from_sc8_impl   = NULL;
+static to_cf32_fn to_cf32_decim2_impl = NULL;
+static swap_fn swap_impl           = NULL;
+static energy_fn energy_impl       = NULL;
+
+/* Select the best available kernels for this CPU. Concurrent first calls
+ * may race to perform this, but will arrive at the same result. */
+static void select_kernels(void)
+{
+    to_cf32_fn to        = to_cf32_scalar;
+    from_cf32_fn from    = from_cf32_scalar;
+    to_cf32_corr_fn corr = to_cf32_corr_scalar;
+    to_sc8_fn to_sc8     = to_sc8_scalar;
+    from_sc8_fn from_sc8 = from_sc8_scalar;
+    to_cf32_fn decim2    = to_cf32_decim2_scalar;
+    swap_fn swap         = swap_scalar;
+    energy_fn energy     = energy_scalar;
+
+#if defined(SIMD_HAVE_NEON)
+    to       = to_cf32_neon;
+    from     = from_cf32_neon;
+    corr     = to_cf32_corr_neon;
+    to_sc8   = to_sc8_neon;
+    from_sc8 = from_sc8_neon;
+    decim2   = to_cf32_decim2_neon;
+    swap     = swap_neon;
+    energy   = energy_neon;
+#elif defined(SIMD_HAVE_SSE2)
+    to       = to_cf32_sse2;
+    from     = from_cf32_sse2;
+    corr     = to_cf32_corr_sse2;
+    to_sc8   = to_sc8_sse2;
+    from_sc8 = from_sc8_sse2;
+    decim2   = to_cf32_decim2_sse2;
+    swap     = swap_sse2;
+    energy   = energy_sse2;
+#   ifdef SIMD_HAVE_AVX2
+    if (simd_have_avx2()) {
+        to   = to_cf32_avx2;
+        from = from_cf32_avx2;
+        corr = to_cf32_corr_avx2;
+        swap = swap_avx2;
+    }
+#   endif
+#endif
+
+    energy_impl       = energy;
+    to_cf32_decim2_impl = decim2;
+    swap_impl         = swap;
+    to_sc8_impl       = to_sc8;
+    from_sc8_impl     = from_sc8;
+    to_cf32_corr_impl = corr;
+    to_cf32_impl      = to;
+    from_cf32_impl    = from;
+}
+
+void sc16q11_to_float(const int16_t *in, float *out, size_t n)
+{
+    if (to_cf32_impl == NULL) {
+        select_kernels();
+    }
+
+    to_cf32_impl(in, out, n);
+}
+
+void sc16q11_to_float_decim2(const int16_t *in, float *out, size_t n)
+{
+    if (to_cf32_decim2_impl == NULL) {
+        select_kernels();
+    }
+
+    to_cf32_decim2_impl(in, out, n);
+}
+
+void float_to_sc16q11(const float *in, int16_t *out, size_t n)
+{
+    if (from_cf32_impl == NULL) {
+        select_kernels();
+    }
+
+    from_cf32_impl(in, out, n);
+}
+
+void sc16q11_to_float_corr(const int16_t *in, float *out, size_t n,
+                           const float even[4], const float odd[4])
+{
+    if (to_cf32_corr_impl == NULL) {
+        select_kernels();
+    }
+
+    to_cf32_corr_impl(in, out, n, even, odd);
+}
+
+void sc16q11_to_sc8q7(const int16_t *in, int8_t *out, size_t n)
+{
+    if (to_sc8_impl == NULL) {
+        select_kernels();
+    }
+
+    to_sc8_impl(in, out, n);
+}
+
+void sc8q7_to_sc16q11(const int8_t *in, int16_t *out, size_t n)
+{
+    if (from_sc8_impl == NULL) {
+        select_kernels();
+    }
+
+    from_sc8_impl(in, out, n);
+}
+
+void sc16q11_swap(const int16_t *in, int16_t *out, size_t n)
+{
+    if (swap_impl == NULL) {
+        select_kernels();
+    }
+
+    swap_impl(in, out, n);
+}
+
+void sc16q11_energy(const int16_t *in, size_t n, uint64_t energy[2])
+{
+    if (energy_impl == NULL) {
+        select_kernels();
+    }
+
+    energy_impl(in, n, energy);
+}
+
+void sc16q11_le_to_host(const int16_t *in, int16_t *out, size_t n)
+{
+#if BLADERF_BIG_ENDIAN
+    sc16q11_swap(in, out, n);
+#else
+    if (in != out) {
+        memmove(out, in, 2 * n * sizeof(int16_t));
+    }
+#endif
+}
@@ -25,11 +25,40 @@
  * SUCH DAMAGE.
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
 #include "sha256.h"
 
+/*
+ * Where the CPU supports it, blocks are compressed with the SHA-256
+ * instructions of x86 (SHA-NI) or of the ARMv8 cryptography extension. The
+ * implementation is selected at runtime, so neither needs to be enabled at
+ * compile time.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    (__GNUC__ >= 5 || defined(__clang__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define SHA256_HAVE_SHANI 1
+#define SHA256_TARGET_SHANI __attribute__((target("ssse3,sse4.1,sha")))
+#endif
+
+#if defined(__aarch64__) && !defined(__AARCH64EB__) && defined(__GNUC__) && \
+    (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO) || \
+     defined(__linux__))
+#include <arm_neon.h>
+#define SHA256_HAVE_ARMV8 1
+#if defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO)
+#define SHA256_TARGET_ARMV8
+#else
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#define SHA256_TARGET_ARMV8 __attribute__((target("+crypto")))
+#endif
+#endif
+
 #if BLADERF_BIG_ENDIAN == 1
 
 /* Copy a vector of big-endian uint32_t into a vector of bytes */
@@ -233,6 +262,192 @@ SHA256_Transform(uint32_t * state, const unsigned char block[64])
 		state[i] += S[i];
 }
 
+/* Compress `blocks` consecutive 64-byte blocks into the state */
+typedef void (*sha256_blocks_fn)(uint32_t *, const unsigned char *, size_t);
+
+static void
+SHA256_Blocks_Portable(uint32_t * state, const unsigned char *data,
+    size_t blocks)
+{
+
+	for (; blocks > 0; blocks--, data += 64)
+		SHA256_Transform(state, data);
+}
+
+#if defined(SHA256_HAVE_SHANI) || defined(SHA256_HAVE_ARMV8)
+/* Round constants, for the hardware implementations */
+static const uint32_t K[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+#endif
+
+#ifdef SHA256_HAVE_SHANI
+/*
+ * Each group of 4 rounds is two sha256rnds2 instructions, which operate on
+ * the state as ABEF and CDGH.  W[] holds the last 4 groups of the message
+ * schedule, indexed by group number mod 4.
+ */
+SHA256_TARGET_SHANI
+static void
+SHA256_Blocks_SHANI(uint32_t * state, const unsigned char *data,
+    size_t blocks)
+{
+	const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,
+	    0x0405060700010203ULL);
+	__m128i abef, cdgh, abef_save, cdgh_save, t, msg;
+	__m128i W[4];
+	int i;
+
+	/* Rearrange the state from ABCD EFGH into ABEF CDGH */
+	t = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]), 0xb1);
+	cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]),
+	    0x1b);
+	abef = _mm_alignr_epi8(t, cdgh, 8);
+	cdgh = _mm_blend_epi16(cdgh, t, 0xf0);
+
+	for (; blocks > 0; blocks--, data += 64) {
+		abef_save = abef;
+		cdgh_save = cdgh;
+
+		for (i = 0; i < 16; i++) {
+			if (i < 4) {
+				W[i] = _mm_shuffle_epi8(_mm_loadu_si128(
+				    (const __m128i *)(data + 16 * i)), bswap);
+			} else {
+				/* W[i & 3] still holds group i - 4 */
+				t = _mm_sha256msg1_epu32(W[i & 3],
+				    W[(i + 1) & 3]);
+				t = _mm_add_epi32(t, _mm_alignr_epi8(
+				    W[(i + 3) & 3], W[(i + 2) & 3], 4));
+				W[i & 3] = _mm_sha256msg2_epu32(t,
+				    W[(i + 3) & 3]);
+			}
+
+			msg = _mm_add_epi32(W[i & 3],
+			    _mm_loadu_si128((const __m128i *)&K[4 * i]));
+			cdgh = _mm_sha256rnds2_epu32(cdgh, abef, msg);
+			abef = _mm_sha256rnds2_epu32(abef, cdgh,
+			    _mm_shuffle_epi32(msg, 0x0e));
+		}
+
+		abef = _mm_add_epi32(abef, abef_save);
+		cdgh = _mm_add_epi32(cdgh, cdgh_save);
+	}
+
+	/* Rearrange the state back into ABCD EFGH */
+	t = _mm_shuffle_epi32(abef, 0x1b);
+	cdgh = _mm_shuffle_epi32(cdgh, 0xb1);
+	_mm_storeu_si128((__m128i *)&state[0], _mm_blend_epi16(t, cdgh, 0xf0));
+	_mm_storeu_si128((__m128i *)&state[4], _mm_alignr_epi8(cdgh, t, 8));
+}
+
+static bool
+have_shani(void)
+{
+	unsigned int eax, ebx, ecx, edx;
+
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) ||
+	    !(ecx & (1u << 9)) || !(ecx & (1u << 19)))
+		return (false);		/* No SSSE3 or SSE4.1 */
+
+	if (__get_cpuid_max(0, NULL) < 7)
+		return (false);
+
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+	return ((ebx & (1u << 29)) != 0);
+}
+#endif
+
+#ifdef SHA256_HAVE_ARMV8
+/* As for SHA-NI, W[] holds the last 4 groups of the message schedule. */
+SHA256_TARGET_ARMV8
+static void
+SHA256_Blocks_ARMv8(uint32_t * state, const unsigned char *data,
+    size_t blocks)
+{
+	uint32x4_t abcd = vld1q_u32(&state[0]);
+	uint32x4_t efgh = vld1q_u32(&state[4]);
+	uint32x4_t abcd_save, efgh_save, msg, t;
+	uint32x4_t W[4];
+	int i;
+
+	for (; blocks > 0; blocks--, data += 64) {
+		abcd_save = abcd;
+		efgh_save = efgh;
+
+		for (i = 0; i < 16; i++) {
+			if (i < 4) {
+				W[i] = vreinterpretq_u32_u8(
+				    vrev32q_u8(vld1q_u8(data + 16 * i)));
+			} else {
+				W[i & 3] = vsha256su1q_u32(
+				    vsha256su0q_u32(W[i & 3], W[(i + 1) & 3]),
+				    W[(i + 2) & 3], W[(i + 3) & 3]);
+			}
+
+			msg = vaddq_u32(W[i & 3], vld1q_u32(&K[4 * i]));
+			t = abcd;
+			abcd = vsha256hq_u32(abcd, efgh, msg);
+			efgh = vsha256h2q_u32(efgh, t, msg);
+		}
+
+		abcd = vaddq_u32(abcd, abcd_save);
+		efgh = vaddq_u32(efgh, efgh_save);
+	}
+
+	vst1q_u32(&state[0], abcd);
+	vst1q_u32(&state[4], efgh);
+}
+
+static bool
+have_armv8_sha2(void)
+{
+#if defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO)
+	return (true);
+#else
+	return ((getauxval(AT_HWCAP) & HWCAP_SHA2) != 0);
+#endif
+}
+#endif
+
+static sha256_blocks_fn
+select_blocks(void)
+{
+
+#ifdef SHA256_HAVE_SHANI
+	if (have_shani())
+		return (SHA256_Blocks_SHANI);
+#endif
+
+#ifdef SHA256_HAVE_ARMV8
+	if (have_armv8_sha2())
+		return (SHA256_Blocks_ARMv8);
+#endif
+
+	return (SHA256_Blocks_Portable);
+}
+
+/*
+ * Selected on first use.  Every thread selects the same implementation, so a
+ * race to set this is harmless.
+ */
+static sha256_blocks_fn sha256_blocks = NULL;
+
 static unsigned char PAD[64] = {
 	0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
 	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -307,17 +522,20 @@ SHA256_Update(SHA256_CTX * ctx, const void *in, size_t len)
 		return;
 	}
 
+	if (sha256_blocks == NULL)
+		sha256_blocks = select_blocks();
+
 	/* Finish the current block */
 	memcpy(&ctx->buf[r], src, 64 - r);
-	SHA256_Transform(ctx->state, ctx->buf);
+	sha256_blocks(ctx->state, ctx->buf, 1);
 	src += 64 - r;
 	len -= 64 - r;
 
 	/* Perform complete blocks */
-	while (len >= 64) {
-		SHA256_Transform(ctx->state, src);
-		src += 64;
-		len -= 64;
+	if (len >= 64) {
+		sha256_blocks(ctx->state, src, len / 64);
+		src += len & ~(size_t)63;
+		len &= 63;
 	}
 
 	/* Copy left over data into buffer */
@@ -28,9 +28,19 @@
 #include <string.h>
 #include <limits.h>
 #include <inttypes.h>
+#include <math.h>
+
+#include "host_config.h"
+
+#if BLADERF_OS_WINDOWS || BLADERF_OS_OSX
+#include "clock_gettime.h"
+#else
+#include <time.h>
+#endif
 
 #include <libbladeRF.h>
 #include "dc_calibration.h"
+#include "dc_calibration_math.h"
 #include "conversions.h"
 
 const struct numeric_suffix freq_suffixes[] = {
@@ -43,9 +53,16 @@ const struct numeric_suffix freq_suffixes[] = {
 };
 #define NUM_FREQ_SUFFIXES (sizeof(freq_suffixes) / sizeof(freq_suffixes[0]))
 
+#define MAX_DEVICES 16
+
+/* Matches the 5 ms captures performed at 4 Msps by the TX calibration */
+#define BENCH_NUM_SAMPLES   20000
+#define BENCH_ITERATIONS    1000
+
 void usage(const char *argv0) {
-    printf("Usage: %s <LMS6 cal>\n", argv0);
-    printf("Usage: %s <rx|tx> <frequency_low> [<step> <count>]\n", argv0);
+    printf("Usage: %s [-d <device>]... <LMS6 cal>\n", argv0);
+    printf("Usage: %s [-d <device>]... <rx|tx> <frequency_low> "
+           "[<step> <count>]\n", argv0);
     printf("\n");
     printf("To perform LMS6 calibrations, provide a single argument that is\n");
     printf("one of the following:\n");
@@ -55,54 +72,371 @@ void usage(const char *argv0) {
     printf("A step size and count may be specified to calibrate over a range.\n");
     printf("The results will be printed to stdout.\n");
     printf("\n");
+    printf("The -d option may be repeated (up to %d times) to calibrate\n",
+           MAX_DEVICES);
+    printf("multiple devices concurrently. By default, the first available\n");
+    printf("device is used.\n");
+    printf("\n");
+    printf("Usage: %s bench [<iterations>]\n", argv0);
+    printf("\n");
+    printf("Benchmark the DC calibration kernels against their scalar\n");
+    printf("reference implementations. No device is required.\n");
+    printf("\n");
+}
+
+static double now_us(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+static void print_bench(const char *name, double scalar_us, double vector_us,
+                        unsigned int iterations, double max_err)
+{
+    printf("%-16s %12.2f %12.2f %8.2fx %12.3g\n", name,
+           scalar_us / iterations, vector_us / iterations,
+           scalar_us / vector_us, max_err);
+}
+
+static double max_diff(const struct complexf *a, const struct complexf *b,
+                       size_t count)
+{
+    double err = 0;
+    size_t n;
+
+    for (n = 0; n < count; n++) {
+        err = fmax(err, fabs(a[n].i - b[n].i));
+        err = fmax(err, fabs(a[n].q - b[n].q));
+    }
+
+    return err;
+}
+
+/* Time each DC calibration kernel against its scalar reference, using
+ * samples that resemble a TX calibration capture: LO leakage at Fs/4, an RX
+ * DC offset and noise. */
+static int run_benchmark(unsigned int iterations)
+{
+    const size_t count = BENCH_NUM_SAMPLES;
+    int16_t *samples;
+    struct complexf *mixed, *mixed_ref, *filt, *filt_ref;
+    float mean_i, mean_q, ref_i, ref_q;
+    volatile float sink = 0;
+    double t_scalar, t_vector, err;
+    unsigned int it;
+    size_t n;
+    int status = 0;
+
+    samples   = malloc(2 * count * sizeof(samples[0]));
+    mixed     = malloc(count * sizeof(mixed[0]));
+    mixed_ref = malloc(count * sizeof(mixed_ref[0]));
+    filt      = malloc(count * sizeof(filt[0]));
+    filt_ref  = malloc(count * sizeof(filt_ref[0]));
+
+    if (!samples || !mixed || !mixed_ref || !filt || !filt_ref) {
+        fprintf(stderr, "Failed to allocate benchmark buffers.\n");
+        status = EXIT_FAILURE;
+        goto out;
+    }
+
+    srand(1);
+    for (n = 0; n < count; n++) {
+        static const int tone_i[4] = { 200, 0, -200, 0 };
+        static const int tone_q[4] = { 0, 200, 0, -200 };
+
+        samples[2 * n]     = 40  + tone_i[n & 3] + (rand() % 64) - 32;
+        samples[2 * n + 1] = -25 + tone_q[n & 3] + (rand() % 64) - 32;
+    }
+
+    printf("%u iterations of %u samples\n\n", iterations, (unsigned) count);
+    printf("%-16s %12s %12s %9s %12s\n",
+           "Kernel", "Scalar (us)", "Vector (us)", "Speedup", "Max error");
+
+    /* Sample mean */
+    t_scalar = now_us();
+    for (it = 0; it < iterations; it++) {
+        dc_cal_sample_mean_scalar(samples, count, &ref_i, &ref_q);
+        sink += ref_i;
+    }
+    t_scalar = now_us() - t_scalar;
+
+    t_vector = now_us();
+    for (it = 0; it < iterations; it++) {
+        dc_cal_sample_mean(samples, count, &mean_i, &mean_q);
+        sink += mean_i;
+    }
+    t_vector = now_us() - t_vector;
+
+    err = fmax(fabs(mean_i - ref_i), fabs(mean_q - ref_q));
+    print_bench("sample_mean", t_scalar, t_vector, iterations, err);
+
+    /* Fs/4 mix */
+    t_scalar = now_us();
+    for (it = 0; it < iterations; it++) {
+        dc_cal_tx_mix_scalar(samples, mixed_ref, count, it & 1);
+        sink += mixed_ref[0].i;
+    }
+    t_scalar = now_us() - t_scalar;
+
+    t_vector = now_us();
+    for (it = 0; it < iterations; it++) {
+        dc_cal_tx_mix(samples, mixed, count, it & 1);
+        sink += mixed[0].i;
+    }
+    t_vector = now_us() - t_vector;
+
+    err = max_diff(mixed, mixed_ref, count);
+    dc_cal_tx_mix_scalar(samples, mixed_ref, count, true);
+    dc_cal_tx_mix(samples, mixed, count, true);
+    err = fmax(err, max_diff(mixed, mixed_ref, count));
+    print_bench("tx_cal_mix", t_scalar, t_vector, iterations, err);
+
+    /* Low pass filter */
+    t_scalar = now_us();
+    for (it = 0; it < iterations; it++) {
+        dc_cal_tx_filter_scalar(mixed, filt_ref, count);
+        sink += filt_ref[0].i;
+    }
+    t_scalar = now_us() - t_scalar;
+
+    t_vector = now_us();
+    for (it = 0; it < iterations; it++) {
+        dc_cal_tx_filter(mixed, filt, count);
+        sink += filt[0].i;
+    }
+    t_vector = now_us() - t_vector;
+
+    err = max_diff(filt, filt_ref, count);
+    print_bench("tx_cal_filter", t_scalar, t_vector, iterations, err);
+
+    /* Average magnitude */
+    t_scalar = now_us();
+    for (it = 0; it < iterations; it++) {
+        ref_i = dc_cal_avg_magnitude_scalar(filt_ref, count);
+        sink += ref_i;
+    }
+    t_scalar = now_us() - t_scalar;
+
+    t_vector = now_us();
+    for (it = 0; it < iterations; it++) {
+        mean_i = dc_cal_avg_magnitude(filt_ref, count);
+        sink += mean_i;
+    }
+    t_vector = now_us() - t_vector;
+
+    err = fabs(mean_i - ref_i);
+    print_bench("avg_magnitude", t_scalar, t_vector, iterations, err);
+
+    /* Rounding differences aside, the kernels must agree */
+    if (err > 1e-3 * fabs(ref_i) || max_diff(filt, filt_ref, count) > 1e-5) {
+        fprintf(stderr, "\nError: Vector and scalar results differ.\n");
+        status = EXIT_FAILURE;
+    }
+
+    (void) sink;
+
+out:
+    free(samples);
+    free(mixed);
+    free(mixed_ref);
+    free(filt);
+    free(filt_ref);
+    return status;
+}
+
+static void print_params(const char *serial,
+                         const struct dc_calibration_params *p, size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        if (serial != NULL) {
+            printf("%s: ", serial);
+        }
+
+        printf("F=%10" PRIu64 ", Corr_I=%4d, Corr_Q=%4d, Error_I=%4.2f, Error_Q=%4.2f\n",
+               p[i].frequency, p[i].corr_i, p[i].corr_q,
+               p[i].error_i, p[i].error_q);
+    }
+}
+
+static int lms6_cal(struct bladerf *dev, const char *serial, const char *cal)
+{
+    int status;
+    struct bladerf_lms_dc_cals cals;
+    const char *prefix = (serial != NULL) ? serial : "";
+    const char *sep    = (serial != NULL) ? ": " : "";
+
+    status = dc_calibration_lms6(dev, cal);
+    if (status == BLADERF_ERR_INVAL) {
+        fprintf(stderr, "Invalid LMS6 module: %s\n", cal);
+        return status;
+    } else if (status != 0) {
+        fprintf(stderr, "Calibration failed: %s\n", bladerf_strerror(status));
+        return status;
+    }
+
+    status = bladerf_lms_get_dc_cals(dev, &cals);
+    if (status != 0) {
+        fprintf(stderr, "Failed to read LMS6 DC cals: %s\n",
+                bladerf_strerror(status));
+        return status;
+    }
+
+    printf("%s%sLPF Tuning:     %d\n", prefix, sep, cals.lpf_tuning);
+    printf("%s%sTX LPF I:       %d\n", prefix, sep, cals.tx_lpf_i);
+    printf("%s%sTX LPF Q:       %d\n", prefix, sep, cals.tx_lpf_q);
+    printf("%s%sRX LPF I:       %d\n", prefix, sep, cals.rx_lpf_i);
+    printf("%s%sRX LPF Q:       %d\n", prefix, sep, cals.rx_lpf_q);
+    printf("%s%sRXVGA2 DC REF:  %d\n", prefix, sep, cals.dc_ref);
+    printf("%s%sRXVGA2 AI:      %d\n", prefix, sep, cals.rxvga2a_i);
+    printf("%s%sRXVGA2 AQ:      %d\n", prefix, sep, cals.rxvga2a_q);
+    printf("%s%sRXVGA2 BI:      %d\n", prefix, sep, cals.rxvga2b_i);
+    printf("%s%sRXVGA2 BQ:      %d\n", prefix, sep, cals.rxvga2b_q);
+
+    return 0;
+}
+
+/* Calibrate the same frequencies on each device. When more than one
+ * device is used, they are calibrated concurrently. */
+static int run_cal(struct bladerf **devs, char serials[][BLADERF_SERIAL_LENGTH],
+                   size_t num_devs, bladerf_module module,
+                   struct dc_calibration_params *p, size_t count)
+{
+    struct dc_calibration_job jobs[MAX_DEVICES];
+    struct dc_calibration_params *params[MAX_DEVICES];
+    size_t i;
+    int status = 0;
+
+    if (num_devs == 1) {
+        status = dc_calibration(devs[0], module, p, count, count > 1);
+        if (status == 0) {
+            print_params(NULL, p, count);
+        } else {
+            fprintf(stderr, "Calibration failed: %s\n",
+                    bladerf_strerror(status));
+        }
+
+        return status;
+    }
+
+    memset(params, 0, sizeof(params));
+
+    for (i = 0; i < num_devs; i++) {
+        params[i] = calloc(count, sizeof(p[0]));
+        if (params[i] == NULL) {
+            status = BLADERF_ERR_MEM;
+            goto out;
+        }
+
+        memcpy(params[i], p, count * sizeof(p[0]));
+
+        jobs[i].dev        = devs[i];
+        jobs[i].module     = module;
+        jobs[i].params     = params[i];
+        jobs[i].num_params = count;
+        jobs[i].status     = 0;
+    }
+
+    status = dc_calibration_multi(jobs, num_devs);
+
+    for (i = 0; i < num_devs; i++) {
+        if (jobs[i].status == 0) {
+            print_params(serials[i], params[i], count);
+        } else {
+            fprintf(stderr, "%s: Calibration failed: %s\n",
+                    serials[i], bladerf_strerror(jobs[i].status));
+        }
+    }
+
+out:
+    for (i = 0; i < num_devs; i++) {
+        free(params[i]);
+    }
+
+    return status;
 }
 
 int main(int argc, char *argv[])
 {
     int status = 0;
-    struct bladerf *dev = NULL;
+    struct bladerf *devs[MAX_DEVICES];
+    char serials[MAX_DEVICES][BLADERF_SERIAL_LENGTH];
+    const char *dev_ids[MAX_DEVICES];
+    size_t num_devs = 0;
+    size_t i;
+    int argi = 1;
     bladerf_module module;
+    struct bladerf_serial sn;
+
+    while (argi + 1 < argc && !strcmp(argv[argi], "-d")) {
+        if (num_devs == MAX_DEVICES) {
+            fprintf(stderr, "Error: At most %d devices may be specified.\n",
+                    MAX_DEVICES);
+            return EXIT_FAILURE;
+        }
+
+        dev_ids[num_devs++] = argv[argi + 1];
+        argi += 2;
+    }
+
+    /* Drop the device options so that argv[1] is the first positional
+     * argument */
+    argv[argi - 1] = argv[0];
+    argv += argi - 1;
+    argc -= argi - 1;
 
     if (argc < 2 || !strcmp(argv[1], "-h") || !strcmp(argv[1], "--help")) {
         usage(argv[0]);
         return 0;
     }
 
-    status = bladerf_open(&dev, NULL);
-    if (status != 0) {
-        fprintf(stderr, "Unable to open device: %s\n", bladerf_strerror(status));
-        return EXIT_FAILURE;
+    if (!strcmp(argv[1], "bench")) {
+        unsigned int iterations = BENCH_ITERATIONS;
+
+        if (argc > 2) {
+            bool ok;
+            iterations = str2uint(argv[2], 1, UINT_MAX, &ok);
+            if (!ok) {
+                fprintf(stderr, "Invalid iteration count: %s\n", argv[2]);
+                return EXIT_FAILURE;
+            }
+        }
+
+        return run_benchmark(iterations);
     }
 
-    if (argc == 2) {
-        struct bladerf_lms_dc_cals cals;
+    if (num_devs == 0) {
+        dev_ids[num_devs++] = NULL;
+    }
 
-        status = dc_calibration_lms6(dev, argv[1]);
-        if (status == BLADERF_ERR_INVAL) {
-            fprintf(stderr, "Invalid LMS6 module: %s\n", argv[1]);
-            goto out;
-        } else if (status != 0) {
-            fprintf(stderr, "Calibration failed: %s\n", bladerf_strerror(status));
+    memset(devs, 0, sizeof(devs));
+
+    for (i = 0; i < num_devs; i++) {
+        status = bladerf_open(&devs[i], dev_ids[i]);
+        if (status != 0) {
+            fprintf(stderr, "Unable to open device%s%s: %s\n",
+                    dev_ids[i] ? " " : "", dev_ids[i] ? dev_ids[i] : "",
+                    bladerf_strerror(status));
             goto out;
         }
 
-        status = bladerf_lms_get_dc_cals(dev, &cals);
-        if (status != 0) {
-            fprintf(stderr, "Failed to read LMS6 DC cals: %s\n",
+        status = bladerf_get_serial_struct(devs[i], &sn);
+        if (status == 0) {
+            memcpy(serials[i], sn.serial, sizeof(serials[i]));
+        } else {
+            fprintf(stderr, "Failed to read serial number: %s\n",
                     bladerf_strerror(status));
             goto out;
         }
+    }
 
-        printf("LPF Tuning:     %d\n", cals.lpf_tuning);
-        printf("TX LPF I:       %d\n", cals.tx_lpf_i);
-        printf("TX LPF Q:       %d\n", cals.tx_lpf_q);
-        printf("RX LPF I:       %d\n", cals.rx_lpf_i);
-        printf("RX LPF Q:       %d\n", cals.rx_lpf_q);
-        printf("RXVGA2 DC REF:  %d\n", cals.dc_ref);
-        printf("RXVGA2 AI:      %d\n", cals.rxvga2a_i);
-        printf("RXVGA2 AQ:      %d\n", cals.rxvga2a_q);
-        printf("RXVGA2 BI:      %d\n", cals.rxvga2b_i);
-        printf("RXVGA2 BQ:      %d\n", cals.rxvga2b_q);
+    if (argc == 2) {
+        for (i = 0; i < num_devs && status == 0; i++) {
+            status = lms6_cal(devs[i], num_devs > 1 ? serials[i] : NULL,
+                              argv[1]);
+        }
 
     } else if (argc == 3 || argc == 5) {
         bool ok;
@@ -132,16 +466,9 @@ int main(int argc, char *argv[])
             p.corr_i  = p.corr_q = 0;
             p.error_i = p.error_q = 0;
 
-            status = dc_calibration(dev, module, &p, 1, false);
-            if (status == 0) {
-                printf("F=%10" PRIu64 ", Corr_I=%4d, Corr_Q=%4d, Error_I=%4.2f, Error_Q=%4.2f\n",
-                       p.frequency, p.corr_i, p.corr_q, p.error_i, p.error_q);
-            } else {
-                fprintf(stderr, "Calibration failed: %s\n",
-                        bladerf_strerror(status));
-            }
+            status = run_cal(devs, serials, num_devs, module, &p, 1);
         } else {
-            unsigned int f_inc, count, i;
+            unsigned int f_inc, count;
             struct dc_calibration_params *p;
 
             f_inc = str2uint_suffix(argv[3], 1, UINT_MAX,
@@ -160,22 +487,17 @@ int main(int argc, char *argv[])
             }
 
             p = calloc(count, sizeof(p[0]));
+            if (p == NULL) {
+                status = EXIT_FAILURE;
+                goto out;
+            }
+
             for (i = 0; i < count; i++) {
                 p[i].frequency = f_start + i * f_inc;
             }
 
             if (p[count - 1].frequency <= BLADERF_FREQUENCY_MAX) {
-                status = dc_calibration(dev, module, p, count, true);
-                if (status == 0) {
-                    for (i = 0; i < count; i++) {
-                        printf("F=%10" PRIu64 ", Corr_I=%4d, Corr_Q=%4d, Error_I=%4.2f, Error_Q=%4.2f\n",
-                               p[i].frequency, p[i].corr_i, p[i].corr_q,
-                               p[i].error_i, p[i].error_q);
-                    }
-                } else {
-                    fprintf(stderr, "Calibration failed: %s\n",
-                            bladerf_strerror(status));
-                }
+                status = run_cal(devs, serials, num_devs, module, p, count);
             } else {
                 fprintf(stderr,
                         "Error: Provided parameters yield out of range frequency.\n");
@@ -191,7 +513,11 @@ int main(int argc, char *argv[])
     }
 
 out:
-    bladerf_close(dev);
+    for (i = 0; i < num_devs; i++) {
+        if (devs[i] != NULL) {
+            bladerf_close(devs[i]);
+        }
+    }
 
     if (status != 0) {
         status = EXIT_FAILURE;
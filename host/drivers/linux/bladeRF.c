@@ -101,37 +101,53 @@ static struct usb_device_id bladerf_table[] = {
 };
 MODULE_DEVICE_TABLE(usb, bladerf_table);
 
+// Maximum number of URBs submitted per acquisition of a data lock, so the
+// lock is not taken once per URB. URBs are submitted (GFP_ATOMIC) with the
+// lock held, so a failed submission can be un-claimed before any other
+// context moves the ring indices past it.
+#define SUBMIT_BATCH    NUM_CONCURRENT
+
 static int __submit_rx_urb(bladerf_device_t *dev, unsigned int flags) {
-    struct urb *urb;
     unsigned long irq_flags;
+    int n;
     int ret = 0;
 
     do {
+        n = 0;
+
         spin_lock_irqsave(&dev->data_in_lock, irq_flags);
-        if (atomic_read(&dev->data_in_inflight) < NUM_CONCURRENT && atomic_read(&dev->data_in_used) < NUM_DATA_URB) {
-            urb = dev->data_in_bufs[dev->data_in_producer_idx].urb;
+        while (n < SUBMIT_BATCH &&
+               atomic_read(&dev->data_in_inflight) < NUM_CONCURRENT &&
+               atomic_read(&dev->data_in_used) < NUM_DATA_URB) {
+            unsigned int idx = dev->data_in_producer_idx;
+            struct data_buffer *db = &dev->data_in_bufs[idx];
 
-            if (!dev->data_in_bufs[dev->data_in_producer_idx].valid) {
+            if (!db->valid) {
                 printk("data_in error\n");
                 break;
             }
 
-            dev->data_in_bufs[dev->data_in_producer_idx].valid = 0; // mark this RX packet as being in use
-
+            db->valid = 0; // mark this RX packet as being in use
+            dev->data_in_producer_idx = (idx + 1) & (NUM_DATA_URB - 1);
             atomic_inc(&dev->data_in_used);
-
-            usb_anchor_urb(urb, &dev->data_in_anchor);
-            spin_unlock_irqrestore(&dev->data_in_lock, irq_flags);
             atomic_inc(&dev->data_in_inflight);
-            ret = usb_submit_urb(urb, GFP_ATOMIC);
+
+            usb_anchor_urb(db->urb, &dev->data_in_anchor);
+            ret = usb_submit_urb(db->urb, GFP_ATOMIC);
             if (ret) {
+                // return the slot to the ring
+                usb_unanchor_urb(db->urb);
                 atomic_dec(&dev->data_in_inflight);
-                goto leave_rx;
+                atomic_dec(&dev->data_in_used);
+                dev->data_in_producer_idx = idx;
+                db->valid = 1;
+                break;
             }
+
+            n++;
         }
-    } while(1);
-    spin_unlock_irqrestore(&dev->data_in_lock, irq_flags);
-leave_rx:
+        spin_unlock_irqrestore(&dev->data_in_lock, irq_flags);
+    } while (ret == 0 && n == SUBMIT_BATCH);
 
     return ret;
 }
@@ -142,11 +158,12 @@ static void __bladeRF_read_cb(struct urb *urb) {
     unsigned char *buf;
     unsigned long flags;
 
+    dev = (bladerf_device_t *)urb->context;
+
     usb_unanchor_urb(urb);
 
     spin_lock_irqsave(&dev->data_in_lock, flags);
     buf = (unsigned char *)urb->transfer_buffer;
-    dev = (bladerf_device_t *)urb->context;
     atomic_dec(&dev->data_in_inflight);
     dev->bytes += DATA_BUF_SZ;
     atomic_inc(&dev->data_in_queued);
@@ -423,17 +440,19 @@ static ssize_t bladerf_read(struct file *file, char __user *buf, size_t count, l
 }
 
 static int __submit_tx_urb(bladerf_device_t *dev) {
-    struct urb *urb;
-    struct data_buffer *db;
     unsigned long flags;
-
+    int n;
     int ret = 0;
 
     do {
+        n = 0;
+
         spin_lock_irqsave(&dev->data_out_lock, flags);
-        if (atomic_read(&dev->data_out_inflight) < NUM_CONCURRENT && atomic_read(&dev->data_out_queued)) {
-            db = &dev->data_out_bufs[dev->data_out_consumer_idx];
-            urb = db->urb;
+        while (n < SUBMIT_BATCH &&
+               atomic_read(&dev->data_out_inflight) < NUM_CONCURRENT &&
+               atomic_read(&dev->data_out_queued)) {
+            unsigned int idx = dev->data_out_consumer_idx;
+            struct data_buffer *db = &dev->data_out_bufs[idx];
 
             if (!db->valid) {
                 // if it is not yet valid, it will be when bladerf_write calls __submit_tx_urb
@@ -443,24 +462,26 @@ static int __submit_tx_urb(bladerf_device_t *dev) {
             // clear this packet's valid flag so it is not submitted until the next time it
             // is used and copy_from_user() has copied data into the buffer
             db->valid = 0;
-            dev->data_out_consumer_idx++;
-            dev->data_out_consumer_idx &= (NUM_DATA_URB - 1);
-
+            dev->data_out_consumer_idx = (idx + 1) & (NUM_DATA_URB - 1);
             atomic_dec(&dev->data_out_queued);
-
-            usb_anchor_urb(urb, &dev->data_out_anchor);
             atomic_inc(&dev->data_out_inflight);
-            spin_unlock_irqrestore(&dev->data_out_lock, flags);
 
-            ret = usb_submit_urb(urb, GFP_ATOMIC);
+            usb_anchor_urb(db->urb, &dev->data_out_anchor);
+            ret = usb_submit_urb(db->urb, GFP_ATOMIC);
             if (ret) {
+                // leave the samples queued, to be submitted by a later call
+                usb_unanchor_urb(db->urb);
                 atomic_dec(&dev->data_out_inflight);
-                goto leave_tx;
+                atomic_inc(&dev->data_out_queued);
+                dev->data_out_consumer_idx = idx;
+                db->valid = 1;
+                break;
             }
-        } else break;
-    } while (1);
-    spin_unlock_irqrestore(&dev->data_out_lock, flags);
-leave_tx:
+
+            n++;
+        }
+        spin_unlock_irqrestore(&dev->data_out_lock, flags);
+    } while (ret == 0 && n == SUBMIT_BATCH);
 
     return ret;
 }
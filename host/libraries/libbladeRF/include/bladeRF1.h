@@ -1273,6 +1273,58 @@ int CALL_CONV bladerf_calibrate_dc(struct bladerf *dev,
 
 /** @} (End of FN_BLADERF1_DC_CAL) */
 
+/**
+ * @defgroup FN_BLADERF1_QUICK_TUNE Offline quick tune
+ *
+ * The LMS6002D's VCOCAP value is normally found by a search performed in
+ * hardware each time a channel is tuned. libbladeRF records the VCOCAP value
+ * found each time the host tunes a channel (::BLADERF_TUNING_MODE_HOST), and
+ * each time bladerf_get_quick_tune() reads back a tuned channel. From these
+ * measurements, quick tune parameters for arbitrary frequencies can be
+ * computed without accessing the device, e.g., to fill a large hop table
+ * (see bladerf_set_hop_table()) from a handful of calibration tunes.
+ *
+ * Measurements are retained for the lifetime of the device handle. VCOCAP
+ * drifts with temperature, so applications operating for long periods may
+ * wish to periodically retune a few frequencies to refresh the model.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Compute quick tune parameters for a frequency without touching hardware
+ *
+ * When measurements exist in the same VCO band on both sides of `frequency`,
+ * the VCOCAP value is interpolated between them and the result is flagged
+ * such that no VCOCAP search is performed when it is applied. Otherwise, the
+ * VCOCAP value is an estimate that the FPGA refines with its usual search
+ * when the retune is performed.
+ *
+ * If a DC calibration table is loaded for the channel, the DC offset
+ * corrections for `frequency` are included, to be applied by the FPGA along
+ * with the retune (FPGA v0.13.0 or later).
+ *
+ * With an XB-200 attached, the quick tune also carries the XB-200 signal path
+ * and filterbank for `frequency`, selected as bladerf_set_frequency() would,
+ * so that the FPGA switches them along with the retune.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   frequency   Desired frequency, in Hz
+ * @param[out]  quick_tune  Quick retune parameters
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_calc_quick_tune(struct bladerf *dev,
+                                      bladerf_channel ch,
+                                      bladerf_frequency frequency,
+                                      struct bladerf_quick_tune *quick_tune);
+
+/** @} (End of FN_BLADERF1_QUICK_TUNE) */
+
 /**
  * @defgroup FN_BLADERF1_LOW_LEVEL Low-level accessors
  *
@@ -1371,6 +1423,15 @@ int CALL_CONV bladerf_calibrate_dc(struct bladerf *dev,
  */
 #define BLADERF_GPIO_PACKET (1 << 19)
 
+/**
+ * Enable 8-bit sample mode
+ *
+ * @note This is set by bladerf_sync_config() when an 8-bit sample format is
+ *       selected. It is only available on the bladeRF 2.0 micro, with FPGA
+ *       v0.13.0 or later.
+ */
+#define BLADERF_GPIO_8BIT_MODE (1 << 20)
+
 /**
  * AGC enable control bit
  *
@@ -1498,6 +1559,80 @@ int CALL_CONV bladerf_lms_write(struct bladerf *dev,
                                 uint8_t address,
                                 uint8_t val);
 
+/**
+ * Read a block of consecutive Si5338 registers
+ *
+ * With FPGA v0.13.0 or later, up to 11 registers are read per control
+ * transaction. Earlier FPGAs fall back to one transaction per register.
+ *
+ * @param       dev         Device handle
+ * @param[in]   address     First Si5338 register address
+ * @param[out]  vals        Register values. Must hold `count` entries.
+ * @param[in]   count       Number of registers to read
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_si5338_read_block(struct bladerf *dev,
+                                        uint8_t address,
+                                        uint8_t *vals,
+                                        unsigned int count);
+
+/**
+ * Write a block of consecutive Si5338 registers
+ *
+ * @see bladerf_si5338_read_block()
+ *
+ * @param       dev         Device handle
+ * @param[in]   address     First Si5338 register address
+ * @param[in]   vals        Values to write, one per register
+ * @param[in]   count       Number of registers to write
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_si5338_write_block(struct bladerf *dev,
+                                         uint8_t address,
+                                         const uint8_t *vals,
+                                         unsigned int count);
+
+/**
+ * Read a block of consecutive LMS registers
+ *
+ * With FPGA v0.13.0 or later, up to 11 registers are read per control
+ * transaction. Earlier FPGAs fall back to one transaction per register.
+ *
+ * @param       dev         Device handle
+ * @param[in]   address     First LMS register address
+ * @param[out]  vals        Register values. Must hold `count` entries.
+ * @param[in]   count       Number of registers to read
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_lms_read_block(struct bladerf *dev,
+                                     uint8_t address,
+                                     uint8_t *vals,
+                                     unsigned int count);
+
+/**
+ * Write a block of consecutive LMS registers
+ *
+ * @see bladerf_lms_read_block()
+ *
+ * @param       dev         Device handle
+ * @param[in]   address     First LMS register address
+ * @param[in]   vals        Values to write, one per register
+ * @param[in]   count       Number of registers to write
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_lms_write_block(struct bladerf *dev,
+                                      uint8_t address,
+                                      const uint8_t *vals,
+                                      unsigned int count);
+
 /**
  * This structure is used to directly apply DC calibration register values to
  * the LMS, rather than use the values resulting from an auto-calibration.
@@ -66,6 +66,239 @@ int CALL_CONV bladerf_set_bias_tee(struct bladerf *dev,
 
 /** @} (End of FN_BLADERF2_BIAS_TEE) */
 
+/**
+ * @defgroup FN_BLADERF2_QUICK_TUNE_CACHE Quick tune cache
+ *
+ * Quick tune parameters created via bladerf_get_quick_tune(), along with the
+ * AD9361 fast lock profiles backing them, are saved to the user's bladeRF
+ * config directory when the device is closed. They are keyed by the device
+ * serial number and the reference clock source (see
+ * bladerf_set_clock_select()). When the device is next opened, the profiles
+ * are written back to the FPGA, and their quick tune parameters may be
+ * retrieved via bladerf_get_cached_quick_tune() without retuning.
+ *
+ * This requires FPGA v0.13.0 or later. Define
+ * BLADERF_DISABLE_QUICK_TUNE_CACHE in the environment to disable it.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Retrieve previously created quick tune parameters for a frequency
+ *
+ * The result may be passed to bladerf_schedule_retune() as if it had been
+ * returned by bladerf_get_quick_tune(). bladerf_get_quick_tune() also returns
+ * the cached parameters when the channel is tuned to a cached frequency,
+ * rather than consuming a new profile.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   frequency   Frequency, in Hz. Cached profiles within 1 kHz
+ *                          are considered a match.
+ * @param[out]  quick_tune  Quick retune parameters
+ *
+ * @return 0 on success, BLADERF_ERR_RANGE if no cached profile matches
+ *         `frequency`, BLADERF_ERR_UNSUPPORTED if the cache is not available,
+ *         or a value from \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_cached_quick_tune(struct bladerf *dev,
+                                            bladerf_channel ch,
+                                            bladerf_frequency frequency,
+                                            struct bladerf_quick_tune *quick_tune);
+
+/** @} (End of FN_BLADERF2_QUICK_TUNE_CACHE) */
+
+/**
+ * @defgroup FN_BLADERF2_CORRECTION_TABLE Correction tables
+ *
+ * A correction table holds the AD9361 DC offset, phase, and gain correction
+ * values (see ::bladerf_correction) of both channels in one direction, over
+ * a range of frequencies. Tables may be generated by bladeRF-cli's
+ * `calibrate table iq` command.
+ *
+ * While a table is loaded, bladerf_set_frequency() writes the values for the
+ * new frequency, interpolated between the table's entries, and the AD9361 is
+ * forced to use them. For RX, the AD9361's RF DC, baseband DC, and
+ * quadrature tracking loops are disabled while a table is loaded, so samples
+ * received after a retune do not depend upon the loops converging.
+ *
+ * Tables named `<serial>_iq_rx.tbl` and `<serial>_iq_tx.tbl` are loaded
+ * automatically when the device is opened, if they are found in the
+ * locations searched for bladeRF1 DC calibration tables.
+ *
+ * Corrections are only applied when the tuning mode is
+ * ::BLADERF_TUNING_MODE_HOST.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Load a correction table, or unload the current table
+ *
+ * Unloading a table releases the forced correction values and, for RX,
+ * re-enables the AD9361's tracking loops. The values of a newly loaded table
+ * are applied at the next bladerf_set_frequency() call.
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Direction of the table
+ * @param[in]   filename    Table file, or NULL to unload the current table
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if the file is not a correction
+ *         table for `dir`, or a value from \ref RETCODES list on other
+ *         failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_load_correction_table(struct bladerf *dev,
+                                            bladerf_direction dir,
+                                            const char *filename);
+
+/** @} (End of FN_BLADERF2_CORRECTION_TABLE) */
+
+/**
+ * @defgroup FN_BLADERF2_SCHEDULED_PARAMS Scheduled parameter changes
+ *
+ * Gain, bandwidth, TX mute, RF port, and RFFE control changes may be
+ * scheduled to occur at a sample timestamp, in the same queue as bladerf_schedule_retune(). Changes
+ * and retunes scheduled for the same timestamp are applied together, in the
+ * order they were scheduled, by the FPGA when the timestamp is reached. This
+ * allows, for example, a retune and the gain for the new frequency to take
+ * effect on the same sample.
+ *
+ * The channel's retune queue is shared with scheduled retunes, and is cleared
+ * by bladerf_cancel_scheduled_retunes(). Entries must be scheduled in
+ * timestamp order. ::BLADERF_RETUNE_NOW may be used to apply a change
+ * immediately.
+ *
+ * Bandwidth changes re-run the AD9361's baseband filter calibration, which
+ * takes on the order of hundreds of microseconds to complete after the
+ * timestamp is reached.
+ *
+ * For TDD operation, TX mute and RFFE control changes allow the transmitter
+ * and the AD9361's ENABLE and TXNRX pins to be switched on a given sample,
+ * rather than with the jitter of an immediate USB request.
+ *
+ * With the exception of bladerf_schedule_rf_port() and
+ * bladerf_schedule_rffe_control(), these require the RFIC to be controlled by
+ * the FPGA (::BLADERF_TUNING_MODE_FPGA).
+ *
+ * These require FPGA v0.13.0 or later.
+ *
+ * Overall gain changes are scheduled with bladerf_schedule_gain(), in the
+ * same manner (see \ref FN_SCHEDULED_TUNING).
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Schedule a bandwidth change
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   timestamp   Channel's sample timestamp at which to change
+ *                          bandwidth
+ * @param[in]   bandwidth   Desired bandwidth, in Hz
+ *
+ * @return 0 on success, ::BLADERF_ERR_QUEUE_FULL if the retune queue is full,
+ *         or a value from \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_schedule_bandwidth(struct bladerf *dev,
+                                         bladerf_channel ch,
+                                         bladerf_timestamp timestamp,
+                                         bladerf_bandwidth bandwidth);
+
+/**
+ * Schedule a TX mute change
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          TX channel
+ * @param[in]   timestamp   Channel's sample timestamp at which to change the
+ *                          TX mute state
+ * @param[in]   state       True to mute, false to unmute
+ *
+ * @return 0 on success, ::BLADERF_ERR_QUEUE_FULL if the retune queue is full,
+ *         or a value from \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_schedule_txmute(struct bladerf *dev,
+                                      bladerf_channel ch,
+                                      bladerf_timestamp timestamp,
+                                      bool state);
+
+/**
+ * Schedule an RF port change
+ *
+ * The RF switches are changed to match the port, if the port is used by one
+ * of the RF front end's bands. The TX_MON ports may not be scheduled.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   timestamp   Channel's sample timestamp at which to change port
+ * @param[in]   port        RF port name, as used by bladerf_set_rf_port()
+ *
+ * @return 0 on success, ::BLADERF_ERR_QUEUE_FULL if the retune queue is full,
+ *         or a value from \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_schedule_rf_port(struct bladerf *dev,
+                                       bladerf_channel ch,
+                                       bladerf_timestamp timestamp,
+                                       const char *port);
+
+/**
+ * @defgroup BLADERF2_RFFE_CONTROL RFFE control bits
+ *
+ * RF front end control bits that may be changed by
+ * bladerf_schedule_rffe_control()
+ *
+ * @{
+ */
+#define BLADERF_RFFE_CONTROL_ENABLE (1 << 1)     /**< AD9361 ENABLE pin */
+#define BLADERF_RFFE_CONTROL_TXNRX (1 << 2)      /**< AD9361 TXNRX pin */
+#define BLADERF_RFFE_CONTROL_RX_BIAS_EN (1 << 5) /**< RX bias tee enable */
+#define BLADERF_RFFE_CONTROL_TX_BIAS_EN (1 << 10) /**< TX bias tee enable */
+/** @} */
+
+/**
+ * Schedule an RF front end control change
+ *
+ * The bits of the RFFE control register selected by `mask` are set to the
+ * corresponding bits of `value`. With the AD9361 in pin-controlled ENSM mode,
+ * ::BLADERF_RFFE_CONTROL_ENABLE and ::BLADERF_RFFE_CONTROL_TXNRX switch it
+ * between its RX and TX states.
+ *
+ * The library does not track scheduled changes, and a later call that
+ * reconfigures the RF front end, such as bladerf_enable_module(), may undo
+ * them.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel whose sample timestamp `timestamp` refers
+ *                          to
+ * @param[in]   timestamp   Channel's sample timestamp at which to change the
+ *                          control bits
+ * @param[in]   mask        Bits to change, from \ref BLADERF2_RFFE_CONTROL
+ * @param[in]   value       New values of the bits in `mask`
+ *
+ * @return 0 on success, ::BLADERF_ERR_QUEUE_FULL if the retune queue is full,
+ *         ::BLADERF_ERR_INVAL if `mask` contains other bits, or a value from
+ *         \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_schedule_rffe_control(struct bladerf *dev,
+                                            bladerf_channel ch,
+                                            bladerf_timestamp timestamp,
+                                            uint32_t mask,
+                                            uint32_t value);
+
+/** @} (End of FN_BLADERF2_SCHEDULED_PARAMS) */
+
 /**
  * @defgroup FN_BLADERF2_LOW_LEVEL Low-level accessors
  *
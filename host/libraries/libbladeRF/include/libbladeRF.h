@@ -115,6 +115,8 @@ typedef enum {
     BLADERF_BACKEND_LINUX,       /**< Linux kernel driver */
     BLADERF_BACKEND_LIBUSB,      /**< libusb */
     BLADERF_BACKEND_CYPRESS,     /**< CyAPI */
+    BLADERF_BACKEND_SHM,         /**< Device served by another process.
+                                  *   See bladerf_shm_server_start(). */
     BLADERF_BACKEND_DUMMY = 100, /**< Dummy used for development purposes */
 } bladerf_backend;
 
@@ -169,6 +171,8 @@ struct bladerf_backendinfo {
  *   - libusb:  libusb (See libusb changelog notes for required version, given
  *   your OS and controller)
  *   - cypress: Cypress CyUSB/CyAPI backend (Windows only)
+ *   - dummy:   Development backend with no hardware attached (only present
+ *              in builds with ENABLE_BACKEND_DUMMY)
  *
  * If no arguments are provided after the backend, the first encountered
  * device on the specified backend will be opened. Note that a backend is
@@ -211,6 +215,39 @@ API_EXPORT
 int CALL_CONV bladerf_open(struct bladerf **device,
                            const char *device_identifier);
 
+/**
+ * Open and initialize multiple devices concurrently
+ *
+ * This is equivalent to calling bladerf_open() for each identifier, but
+ * performs the per-device work (e.g., FPGA autoloading and RFIC
+ * initialization) on up to 8 threads at once. This substantially reduces
+ * the time required to bring up a multi-device system.
+ *
+ * Each identifier should uniquely specify a device, typically via its
+ * serial number (e.g., `"*:serial=f12ce1037830a1b27f3ceeba1f521413"`).
+ *
+ * Devices that were opened successfully remain open even if others could
+ * not be opened, and must be closed via bladerf_close().
+ *
+ * @param[out]  devices             Array of `count` handles, each updated
+ *                                  with the corresponding device handle, or
+ *                                  NULL if it could not be opened
+ * @param[in]   device_identifiers  Array of `count` device identifiers, as
+ *                                  described for bladerf_open()
+ * @param[in]   count               Number of devices to open
+ * @param[out]  statuses            Optional array of `count` values, each
+ *                                  updated with the status of opening the
+ *                                  corresponding device. May be NULL.
+ *
+ * @return 0 if all devices were opened, or the first failing status (in
+ *         identifier order) from the \ref RETCODES list
+ */
+API_EXPORT
+int CALL_CONV bladerf_open_many(struct bladerf **devices,
+                                const char *const *device_identifiers,
+                                unsigned int count,
+                                int *statuses);
+
 /**
  * Close device
  *
@@ -268,6 +305,28 @@ int CALL_CONV bladerf_get_device_list(struct bladerf_devinfo **devices);
 API_EXPORT
 void CALL_CONV bladerf_free_device_list(struct bladerf_devinfo *devices);
 
+/**
+ * Track attached devices in the background
+ *
+ * By default, bladerf_get_device_list() and bladerf_open() read the serial
+ * number and strings of each candidate device when called. On Linux these
+ * are read from sysfs; elsewhere, this requires briefly opening each device.
+ *
+ * When enabled, libbladeRF instead registers for USB hotplug notifications
+ * and reads this information once, on a background thread, as each device
+ * is attached. Subsequent listing and opening then use this information
+ * without touching devices that are not being opened.
+ *
+ * This setting is global to the library.
+ *
+ * @param[in]   enable      Start (true) or stop (false) the monitor
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if no backend supports
+ *         hotplug notifications, or value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_device_monitor(bool enable);
+
 /**
  * Initialize a device identifier information structure to a "wildcard" state.
  *
@@ -1130,6 +1189,44 @@ int CALL_CONV
                                      bladerf_channel ch,
                                      struct bladerf_rational_rate *rate);
 
+/**
+ * Change the sample rate of a running stream
+ *
+ * Unlike bladerf_set_sample_rate(), this may be called while streams are
+ * active, without stopping and restarting them. The RFIC's ENSM is held
+ * in its wait state while its clock chain and FIR filters are reconfigured,
+ * so that no samples are produced or consumed at an intermediate rate, and
+ * is then returned to its previous state. The stream's worker, buffers and
+ * USB transfers are left in place.
+ *
+ * When receiving with ::BLADERF_FORMAT_SC16_Q11_META or
+ * ::BLADERF_FORMAT_SC8_Q7_META, the first bladerf_sync_rx() call to return
+ * samples at the new rate reports ::BLADERF_META_STATUS_RATE_CHANGE, along
+ * with the new rate in the metadata's `sample_rate` field. A call that would
+ * otherwise span the change ends early, as it does for an overrun.
+ *
+ * @note The RX and TX sample rates are coupled on the bladeRF2, so both
+ *       directions are affected. TX timestamps scheduled before the change
+ *       are expressed in samples at the old rate.
+ *
+ * @note This is currently only supported on the bladeRF2, and requires
+ *       host-controlled RFIC operation.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   rate        Sample rate
+ * @param[out]  actual      If non-NULL, this is written with the actual
+ *                          sample rate achieved.
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if the device does not
+ *         support this, or a value from \ref RETCODES list upon failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_switch_sample_rate(struct bladerf *dev,
+                                         bladerf_channel ch,
+                                         bladerf_sample_rate rate,
+                                         bladerf_sample_rate *actual);
+
 /** @} (End of FN_SAMPLING) */
 
 /**
@@ -1440,6 +1537,69 @@ int CALL_CONV bladerf_set_loopback(struct bladerf *dev, bladerf_loopback lb);
 API_EXPORT
 int CALL_CONV bladerf_get_loopback(struct bladerf *dev, bladerf_loopback *lb);
 
+/**
+ * Firmware loopback benchmark configuration
+ */
+struct bladerf_fw_loopback_bench_config {
+    /** Buffers per direction, as with bladerf_sync_config() */
+    unsigned int num_buffers;
+
+    /** Samples per buffer. This must be a multiple of 1024. */
+    unsigned int buffer_size;
+
+    unsigned int num_transfers; /**< Transfers in flight in each direction */
+    unsigned int count;         /**< Number of buffers to loop back */
+};
+
+/**
+ * Firmware loopback benchmark results
+ *
+ * A buffer's latency is the time from its submission to bladerf_sync_tx()
+ * until it is returned by bladerf_sync_rx(). This includes the time that it
+ * spends queued behind the other buffers in flight, so it grows with the
+ * number of buffers and transfers.
+ */
+struct bladerf_fw_loopback_bench_results {
+    uint64_t bytes;       /**< Bytes received */
+    uint64_t errors;      /**< Buffers received out of sequence */
+    double throughput;    /**< Bytes received per second */
+    double latency_min;   /**< Minimum latency, in microseconds */
+    double latency_p50;   /**< Median latency, in microseconds */
+    double latency_p90;   /**< 90th percentile latency, in microseconds */
+    double latency_p99;   /**< 99th percentile latency, in microseconds */
+    double latency_max;   /**< Maximum latency, in microseconds */
+};
+
+/**
+ * Measure the USB throughput and latency of the host and FX3 alone
+ *
+ * This places the device in ::BLADERF_LB_FIRMWARE loopback, in which the FX3
+ * returns the samples transmitted on TX channel 0 to RX channel 0 without
+ * passing them to the FPGA. `config->count` buffers of sequence-numbered
+ * ::BLADERF_FORMAT_SC16_Q11 samples are then streamed through it with the
+ * synchronous interface, from a separate transmit thread.
+ *
+ * The results therefore bound what the host, its USB controller and driver,
+ * and the FX3 can sustain. A stream that falls short of them, but which is
+ * within them in this benchmark, is limited by the FPGA or RF configuration
+ * instead.
+ *
+ * The synchronous interface of both directions is reconfigured, and the
+ * channels are disabled and the previous loopback mode is restored on
+ * return. This must not be called while the device is streaming.
+ *
+ * @param       dev         Device handle
+ * @param[in]   config      Benchmark configuration
+ * @param[out]  results     Updated with the benchmark results on success
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_fw_loopback_bench(
+    struct bladerf *dev,
+    const struct bladerf_fw_loopback_bench_config *config,
+    struct bladerf_fw_loopback_bench_results *results);
+
 /** @} (End of FN_LOOPBACK) */
 
 /**
@@ -1724,6 +1884,58 @@ int CALL_CONV bladerf_trigger_state(struct bladerf *dev,
                                     uint64_t *resv1,
                                     uint64_t *resv2);
 
+/**
+ * Fire a master trigger at a scheduled timestamp
+ *
+ * The trigger must be armed first. It fires once the timestamp of its
+ * channel's samples reaches `timestamp`, or immediately if that time has
+ * already passed. Disarming the trigger cancels a scheduled fire, as does
+ * scheduling it again.
+ *
+ * This requires a bladeRF 2.0 micro with FPGA v0.13.0 or later.
+ *
+ * @param       dev         Device handle
+ * @param[in]   trigger     Trigger to fire
+ * @param[in]   timestamp   Timestamp, in the trigger channel's samples, at
+ *                          which to fire
+ *
+ * @return 0 on success, BLADERF_ERR_UNSUPPORTED if the device does not
+ *         support scheduled triggers, BLADERF_ERR_INVAL if the trigger is not
+ *         a master, value from \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_trigger_fire_at(struct bladerf *dev,
+                                      const struct bladerf_trigger *trigger,
+                                      uint64_t timestamp);
+
+/**
+ * Query when a trigger fired
+ *
+ * On a master or a slave, the timestamp of the first sample at which the
+ * trigger line was seen asserted since the trigger was armed is recorded.
+ * Comparing these across the boards sharing a trigger line gives the offset
+ * between their timestamp counters.
+ *
+ * This requires a bladeRF 2.0 micro with FPGA v0.13.0 or later.
+ *
+ * @param       dev         Device handle
+ * @param[in]   trigger     Trigger to query
+ * @param[out]  has_fired   Set to true if the trigger has fired since it was
+ *                          armed, and false otherwise
+ * @param[out]  timestamp   Timestamp at which the trigger fired, in the
+ *                          trigger channel's samples. Only valid if
+ *                          `has_fired` is true.
+ *
+ * @return 0 on success, BLADERF_ERR_UNSUPPORTED if the device does not
+ *         record trigger fire times, value from \ref RETCODES list on other
+ *         failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_trigger_fire_time(struct bladerf *dev,
+                                        const struct bladerf_trigger *trigger,
+                                        bool *has_fired,
+                                        uint64_t *timestamp);
+
 /** @} (End of FN_TRIG) */
 
 /**
@@ -1797,144 +2009,374 @@ int CALL_CONV bladerf_get_rx_mux(struct bladerf *dev, bladerf_rx_mux *mode);
 /** @} (End of FN_RECEIVE_MUX) */
 
 /**
- * @defgroup FN_SCHEDULED_TUNING Scheduled Tuning
+ * @defgroup FN_RX_DDC RX digital downconverter
+ *
+ * FPGA v0.13.0 on the bladeRF 2.0 micro can downconvert and decimate
+ * received samples before they are sent to the host. This allows a
+ * narrowband signal to be received at a wide RFIC sample rate, while using
+ * only a fraction of the USB bandwidth and host CPU time.
+ *
+ * Each RX channel is mixed by a numerically controlled oscillator, moving
+ * the signal at `offset` Hz from the RX frequency to 0 Hz. It is then
+ * decimated by a 3-stage CIC filter. The CIC's passband droop and its
+ * limited rejection near multiples of the output rate should be considered
+ * when choosing the decimation. A host-side filter, or a sample rate that
+ * leaves some margin around the signal of interest, may be needed.
+ *
+ * While the downconverter is enabled:
+ *  - Samples are delivered at the sample rate divided by the decimation.
+ *    bladerf_get_sample_rate() continues to report the RFIC's sample rate.
+ *  - RX metadata timestamps are divided by the decimation, so they keep
+ *    counting one tick per delivered sample. bladerf_get_timestamp() and
+ *    scheduled retunes continue to use undecimated RX timestamps.
+ *  - The same configuration applies to all RX channels.
+ *
+ * The phase increment is computed from the current sample rate, so this
+ * must be configured again after the sample rate is changed.
  *
  * These functions are thread-safe.
  *
  * @{
  */
 
+/** Maximum RX downconverter decimation */
+#define BLADERF_RX_DDC_MAX_DECIMATION 64
+
 /**
- * @ingroup STREAMING
+ * Configure the RX digital downconverter
  *
- * Timestamp, in ticks
+ * The RX stream should be disabled while the downconverter's configuration
+ * is changed.
  *
- * A channel's timestamp typically increments at the sample rate.
+ * @param       dev         Device handle
+ * @param[in]   offset      Frequency of the signal of interest, in Hz,
+ *                          relative to the RX frequency. This must be less
+ *                          than half the sample rate in magnitude.
+ * @param[in]   decimation  Decimation: a power of two, from 1 to
+ *                          ::BLADERF_RX_DDC_MAX_DECIMATION. A decimation of
+ *                          1 with an offset of 0 disables the downconverter.
  *
- * @see Format macros for fprintf() and fscanf(): `BLADERF_PRIuTS`,
- * `BLADERF_PRIxTS`, `BLADERF_SCNuTS`, `BLADERF_SCNxTS`
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if the device or FPGA
+ *         does not provide a downconverter, value from \ref RETCODES list
+ *         on other failures.
  */
-typedef uint64_t bladerf_timestamp;
+API_EXPORT
+int CALL_CONV bladerf_set_rx_ddc(struct bladerf *dev,
+                                 int64_t offset,
+                                 unsigned int decimation);
 
 /**
- * Specifies that scheduled retune should occur immediately when using
- * bladerf_schedule_retune().
+ * Get the RX digital downconverter configuration
+ *
+ * @param       dev         Device handle
+ * @param[out]  offset      Frequency offset, in Hz, as quantized by the
+ *                          NCO at the current sample rate
+ * @param[out]  decimation  Decimation. 1 if the downconverter is disabled.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure.
  */
-#define BLADERF_RETUNE_NOW (bladerf_timestamp)0
+API_EXPORT
+int CALL_CONV bladerf_get_rx_ddc(struct bladerf *dev,
+                                 int64_t *offset,
+                                 unsigned int *decimation);
+
+/** @} (End of FN_RX_DDC) */
 
 /**
- * Quick Re-tune parameters.
+ * @defgroup FN_TX_DUC TX digital upconverter
  *
- * @note These parameters, which are associated with the RFIC's register values,
- *       are sensitive to changes in the operating environment (e.g.,
- *       temperature).
+ * FPGA v0.13.0 on the bladeRF 2.0 micro can interpolate and upconvert
+ * transmitted samples after they are received from the host. This allows a
+ * narrowband waveform to be streamed at its baseband rate, while the RFIC
+ * runs at a higher sample rate.
  *
- * This structure should be filled in via bladerf_get_quick_tune().
+ * Each TX channel is interpolated by a 3-stage CIC filter and then mixed by
+ * a numerically controlled oscillator, moving the waveform from 0 Hz to
+ * `offset` Hz from the TX frequency. The CIC's images are attenuated but not
+ * removed, so the waveform should be band-limited well within half of its
+ * baseband rate.
+ *
+ * While the upconverter is enabled:
+ *  - Samples are consumed at the sample rate divided by the interpolation.
+ *    bladerf_get_sample_rate() continues to report the RFIC's sample rate.
+ *  - TX metadata timestamps are divided by the interpolation, so they keep
+ *    counting one tick per sample sent by the host. bladerf_get_timestamp()
+ *    and scheduled retunes continue to use uninterpolated TX timestamps.
+ *  - The same configuration applies to all TX channels.
+ *
+ * The phase increment is computed from the current sample rate, so this
+ * must be configured again after the sample rate is changed.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
  */
-struct bladerf_quick_tune {
-    union {
-        /* bladeRF1 quick tune parameters */
-        struct {
-            uint8_t freqsel; /**< Choice of VCO and VCO division factor */
-            uint8_t vcocap;  /**< VCOCAP value */
-            uint16_t nint;   /**< Integer portion of LO frequency value */
-            uint32_t nfrac;  /**< Fractional portion of LO frequency value */
-            uint8_t flags;   /**< Flag bits used internally by libbladeRF */
-            uint8_t xb_gpio;   /**< Flag bits used to configure XB */
-        };
-        /* bladeRF2 quick tune parameters */
-        struct {
-            uint16_t nios_profile; /**< Profile number in Nios */
-            uint8_t rffe_profile;  /**< Profile number in RFFE */
-            uint8_t port;          /**< RFFE port settings */
-            uint8_t spdt;          /**< External SPDT settings */
-        };
-    };
-};
+
+/** Maximum TX upconverter interpolation */
+#define BLADERF_TX_DUC_MAX_INTERPOLATION 64
 
 /**
- * Schedule a frequency retune to occur at specified sample timestamp value.
+ * Configure the TX digital upconverter
  *
- * @pre bladerf_sync_config() must have been called with the
- *      \ref BLADERF_FORMAT_SC16_Q11_META format for the associated channel in
- *      order to enable timestamps. (The timestamped metadata format must be
- *      enabled in order to use this function.)
+ * The TX stream should be disabled while the upconverter's configuration is
+ * changed.
  *
  * @param       dev             Device handle
- * @param[in]   ch              Channel
- * @param[in]   timestamp       Channel's sample timestamp to perform the
- *                              retune operation. If this value is in the past,
- *                              the retune will occur immediately. To perform
- *                              the retune immediately, specify
- *                              ::BLADERF_RETUNE_NOW.
- * @param[in]   frequency       Desired frequency, in Hz.
- * @param[in]   quick_tune      If non-NULL, the provided "quick retune" values
- *                              will be applied to the transceiver to tune it
- *                              according to a previous state retrieved via
- *                              bladerf_get_quick_tune().
+ * @param[in]   offset          Frequency, in Hz relative to the TX
+ *                              frequency, to move the waveform to. This must
+ *                              be less than half the sample rate in
+ *                              magnitude.
+ * @param[in]   interpolation   Interpolation: a power of two, from 1 to
+ *                              ::BLADERF_TX_DUC_MAX_INTERPOLATION. An
+ *                              interpolation of 1 with an offset of 0
+ *                              disables the upconverter.
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if the device or FPGA
+ *         does not provide an upconverter, value from \ref RETCODES list
+ *         on other failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_tx_duc(struct bladerf *dev,
+                                 int64_t offset,
+                                 unsigned int interpolation);
+
+/**
+ * Get the TX digital upconverter configuration
+ *
+ * @param       dev             Device handle
+ * @param[out]  offset          Frequency offset, in Hz, as quantized by the
+ *                              NCO at the current sample rate
+ * @param[out]  interpolation   Interpolation. 1 if the upconverter is
+ *                              disabled.
  *
  * @return 0 on success, value from \ref RETCODES list on failure.
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_tx_duc(struct bladerf *dev,
+                                 int64_t *offset,
+                                 unsigned int *interpolation);
+
+/** @} (End of FN_TX_DUC) */
+
+/**
+ * @defgroup FN_RX_POWER RX power detector
  *
- * @note If the underlying queue of scheduled retune requests becomes full, \ref
- *       BLADERF_ERR_QUEUE_FULL will be returned. In this case, it should be
- *       possible to schedule a retune after the timestamp of one of the earlier
- *       requests occurs.
+ * FPGA v0.13.0 on the bladeRF 2.0 micro can measure the power of received
+ * samples, so a band may be monitored without streaming its samples to the
+ * host.
+ *
+ * While enabled, the detector averages each RX channel's instantaneous
+ * power, \f$I^2 + Q^2\f$, over consecutive blocks of samples. At the end of
+ * every block it latches the block's mean and peak power. These results may
+ * be polled with bladerf_get_rx_power(), which costs a few control transfers
+ * regardless of the sample rate.
+ *
+ * The detector measures the samples that would be delivered to the host, so
+ * it follows the RX digital downconverter (see \ref FN_RX_DDC) when that is
+ * enabled. It runs whether or not an RX stream is active, but it requires
+ * the RX channel to be enabled.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/** Minimum RX power detector block length, in samples */
+#define BLADERF_RX_POWER_MIN_BLOCK_LENGTH 16
+
+/** Maximum RX power detector block length, in samples */
+#define BLADERF_RX_POWER_MAX_BLOCK_LENGTH (1 << 20)
+
+/**
+ * RX power detector measurement
+ *
+ * Power values are \f$I^2 + Q^2\f$ in SC16 Q11 units, so a full scale
+ * complex sinusoid measures \f$2048^2\f$, or 0 dBFS.
+ */
+struct bladerf_rx_power {
+    uint32_t blocks; /**< Blocks completed since the detector was enabled.
+                      *   This changes when a new measurement is available
+                      *   and is 0 until the first block completes. */
+    uint32_t mean;   /**< Mean power over the latest block */
+    uint32_t peak;   /**< Peak power over the latest block */
+    double mean_dbfs; /**< Mean power, in dB relative to full scale */
+    double peak_dbfs; /**< Peak power, in dB relative to full scale */
+};
+
+/**
+ * Configure the RX power detector
+ *
+ * The configuration applies to all RX channels. Changing it restarts the
+ * current block; disabling the detector also clears its results.
+ *
+ * @param       dev             Device handle
+ * @param[in]   block_length    Samples averaged per measurement: a power of
+ *                              two, from ::BLADERF_RX_POWER_MIN_BLOCK_LENGTH
+ *                              to ::BLADERF_RX_POWER_MAX_BLOCK_LENGTH. 0
+ *                              disables the detector.
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if the device or FPGA
+ *         does not provide a power detector, value from \ref RETCODES list
+ *         on other failures.
  */
 API_EXPORT
-int CALL_CONV bladerf_schedule_retune(struct bladerf *dev,
-                                      bladerf_channel ch,
-                                      bladerf_timestamp timestamp,
-                                      bladerf_frequency frequency,
-                                      struct bladerf_quick_tune *quick_tune);
+int CALL_CONV bladerf_set_rx_power_detector(struct bladerf *dev,
+                                            unsigned int block_length);
 
 /**
- * Cancel all pending scheduled retune operations for the specified channel.
+ * Get the RX power detector configuration
  *
- * This will be done automatically during bladerf_close() to ensure that
- * previously queued retunes do not continue to occur after closing and then
- * later re-opening a device.
+ * @param       dev             Device handle
+ * @param[out]  block_length    Samples averaged per measurement, or 0 if the
+ *                              detector is disabled
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure.
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_rx_power_detector(struct bladerf *dev,
+                                            unsigned int *block_length);
+
+/**
+ * Read the latest RX power detector measurement
+ *
+ * The returned mean and peak are from the same block.
  *
  * @param       dev     Device handle
- * @param[in]   ch      Channel
+ * @param[in]   ch      RX channel
+ * @param[out]  power   Updated with the latest measurement
  *
  * @return 0 on success, value from \ref RETCODES list on failure.
  */
 API_EXPORT
-int CALL_CONV bladerf_cancel_scheduled_retunes(struct bladerf *dev,
-                                               bladerf_channel ch);
+int CALL_CONV bladerf_get_rx_power(struct bladerf *dev,
+                                   bladerf_channel ch,
+                                   struct bladerf_rx_power *power);
+
+/** @} (End of FN_RX_POWER) */
+
+/**
+ * @defgroup FN_RX_BURST_GATE RX burst gate
+ *
+ * FPGA v0.13.0 on the bladeRF 2.0 micro can forward received samples to the
+ * host only while a signal is present, so bursty signals may be captured
+ * without streaming the noise between them.
+ *
+ * While enabled, and while an RX stream is configured for
+ * ::BLADERF_FORMAT_PACKET_META, the gate compares one RX channel's power,
+ * \f$I^2 + Q^2\f$ in SC16 Q11 units, against a threshold. The power is
+ * either that of each sample or, to gate on a steadier RSSI-like level, an
+ * exponential average over \f$2^{averaging}\f$ samples. The gate opens on
+ * the first sample at or above the threshold and closes once `hangover`
+ * consecutive samples have fallen below it.
+ *
+ * Each burst begins with the `pretrigger` samples received before the
+ * detection, which the FPGA holds in a history buffer. This captures the
+ * leading edge of a burst that the detector, particularly when averaging,
+ * is slow to respond to. The timestamps account for the history, and the
+ * gate does not open until the buffer has filled after being enabled.
+ *
+ * Samples received while the gate is open are delivered as packets, in
+ * which each DWORD of the payload holds one SC16 Q11 sample of the gated
+ * channel. Each packet's timestamp is that of its first sample, so a burst's
+ * time of arrival is known to the resolution of one sample. Long bursts are
+ * split across packets; the first packet of a burst reports
+ * ::BLADERF_META_FLAG_RX_HW_BURST_START and the last reports
+ * ::BLADERF_META_FLAG_RX_HW_BURST_END. Packets that the FPGA had to drop for
+ * lack of buffer space are reported as ::BLADERF_META_STATUS_OVERRUN on the
+ * following packet.
+ *
+ * A threshold in dBFS may be converted with
+ * \f$threshold = 2048^2 \cdot 10^{dBFS / 10}\f$. The RX power detector
+ * (see \ref FN_RX_POWER) may be used to measure the noise floor from which
+ * to choose it.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/** Minimum RX burst gate hangover, in samples */
+#define BLADERF_RX_BURST_GATE_MIN_HANGOVER 1
+
+/** Maximum RX burst gate hangover, in samples */
+#define BLADERF_RX_BURST_GATE_MAX_HANGOVER 65535
+
+/** Maximum RX burst gate pretrigger history, in samples */
+#define BLADERF_RX_BURST_GATE_MAX_PRETRIGGER 1023
+
+/** Maximum RX burst gate power averaging, as log2 of the samples averaged */
+#define BLADERF_RX_BURST_GATE_MAX_AVERAGING 15
 
 /**
- * Fetch parameters used to tune the transceiver to the current frequency for
- * use with bladerf_schedule_retune() to perform a "quick retune."
+ * RX burst gate configuration
+ */
+struct bladerf_rx_burst_gate {
+    bool enable;             /**< Gate the RX stream */
+    bladerf_channel channel; /**< RX channel whose power opens the gate and
+                              *   whose samples are delivered */
+    uint32_t threshold;      /**< Power, \f$I^2 + Q^2\f$ in SC16 Q11 units,
+                              *   at or above which the gate opens. Must be
+                              *   non-zero. */
+    unsigned int hangover;   /**< Consecutive samples below the threshold
+                              *   after which the gate closes, from
+                              *   ::BLADERF_RX_BURST_GATE_MIN_HANGOVER to
+                              *   ::BLADERF_RX_BURST_GATE_MAX_HANGOVER */
+    unsigned int pretrigger; /**< Samples preceding the detection to begin
+                              *   each burst with, up to
+                              *   ::BLADERF_RX_BURST_GATE_MAX_PRETRIGGER */
+    unsigned int averaging;  /**< log2 of the number of samples over which
+                              *   the power is averaged, up to
+                              *   ::BLADERF_RX_BURST_GATE_MAX_AVERAGING. 0
+                              *   compares each sample's power. */
+};
+
+/**
+ * Configure the RX burst gate
  *
- * This allows for a faster retune, with a potential trade off of increased
- * phase noise.
+ * When `gate->enable` is false, the remaining fields are ignored and the RX
+ * stream is packetized as usual for ::BLADERF_FORMAT_PACKET_META.
  *
- * @note These parameters are sensitive to changes in the operating environment,
- *       and should be "refreshed" if planning to use the "quick retune"
- *       functionality over a long period of time.
+ * @param       dev     Device handle
+ * @param[in]   gate    Gate configuration
  *
- * @pre bladerf_set_frequency() or bladerf_schedule_retune() have previously
- *      been used to retune to the desired frequency.
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if the device or FPGA
+ *         does not provide a burst gate, value from \ref RETCODES list on
+ *         other failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_rx_burst_gate(
+    struct bladerf *dev, const struct bladerf_rx_burst_gate *gate);
+
+/**
+ * Get the RX burst gate configuration
  *
- * @param       dev         Device handle
- * @param[in]   ch          Channel
- * @param[out]  quick_tune  Quick retune parameters
+ * @param       dev     Device handle
+ * @param[out]  gate    Updated with the gate configuration
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return 0 on success, value from \ref RETCODES list on failure.
  */
 API_EXPORT
-int CALL_CONV bladerf_get_quick_tune(struct bladerf *dev,
-                                     bladerf_channel ch,
-                                     struct bladerf_quick_tune *quick_tune);
+int CALL_CONV bladerf_get_rx_burst_gate(struct bladerf *dev,
+                                        struct bladerf_rx_burst_gate *gate);
 
-/** @} (End of FN_SCHEDULED_TUNING) */
+/** @} (End of FN_RX_BURST_GATE) */
 
 /**
- * @defgroup FN_CORR    Correction
+ * @defgroup FN_FIFO_LEVELS Sample FIFO levels
  *
- * This group provides routines for applying manual offset, gain, and phase
- * corrections.
+ * FPGA v0.13.0 on the bladeRF 2.0 micro reports how full its RX and TX
+ * sample FIFOs are. An application may poll these to react to a stream
+ * falling behind before samples are lost, rather than learning of it from
+ * ::BLADERF_META_STATUS_OVERRUN or ::BLADERF_META_STATUS_UNDERRUN after
+ * the fact.
+ *
+ * Levels are measured in SC16 Q11 samples, summed over all channels of a
+ * direction, and include samples that have yet to be transferred to or from
+ * the FX3. A rising RX level means the host is not keeping up with the
+ * received samples; a falling TX level means the host is not keeping up
+ * with the transmitted samples. The high-water marks hold the largest levels
+ * seen since they were last reset, so short excursions between polls are
+ * not missed.
  *
  * These functions are thread-safe.
  *
@@ -1942,774 +2384,4380 @@ int CALL_CONV bladerf_get_quick_tune(struct bladerf *dev,
  */
 
 /**
- * Correction value, in arbitrary units
- *
- * @see ::bladerf_correction
- * @see bladerf_get_correction()
- * @see bladerf_set_correction()
+ * Sample FIFO levels, in samples
  */
-typedef int16_t bladerf_correction_value;
+struct bladerf_fifo_levels {
+    unsigned int rx_level;      /**< Samples waiting in the RX FIFO */
+    unsigned int rx_high_water; /**< Highest RX level since the last reset */
+    unsigned int rx_capacity;   /**< RX FIFO size */
+    unsigned int tx_level;      /**< Samples waiting in the TX FIFO */
+    unsigned int tx_high_water; /**< Highest TX level since the last reset */
+    unsigned int tx_capacity;   /**< TX FIFO size */
+};
 
 /**
- * Correction parameter selection
+ * Read the sample FIFO levels
  *
- * These values specify the correction parameter to modify or query when calling
- * bladerf_set_correction() or bladerf_get_correction(). Note that the meaning
- * of the `value` parameter to these functions depends upon the correction
- * parameter.
+ * @param       dev                 Device handle
+ * @param[out]  levels              Updated with the current levels
+ * @param[in]   reset_high_water    Restart the high-water marks from the
+ *                                  current levels after reading them
  *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if the device or FPGA
+ *         does not report its FIFO levels, value from \ref RETCODES list on
+ *         other failures.
  */
-typedef enum {
-    /**
-     * Adjusts the in-phase DC offset. Valid values are [-2048, 2048], which are
-     * scaled to the available control bits.
+API_EXPORT
+int CALL_CONV bladerf_get_fifo_levels(struct bladerf *dev,
+                                      struct bladerf_fifo_levels *levels,
+                                      bool reset_high_water);
+
+/** @} (End of FN_FIFO_LEVELS) */
+
+/**
+ * @defgroup FN_TX_LOOP TX waveform loop
+ *
+ * FPGA v0.13.0 on the bladeRF 2.0 micro can capture a short TX waveform into
+ * block RAM and then transmit it repeatedly, without the host supplying any
+ * further samples. This is useful for test signals, beacons, and radar
+ * pulses, where streaming the same samples over USB would otherwise tie up
+ * the host and the bus, and where an underrun would corrupt the signal.
+ *
+ * A waveform is loaded through the TX sync interface, which must be
+ * configured with ::BLADERF_FORMAT_SC16_Q11_META or
+ * ::BLADERF_FORMAT_SC8_Q7_META, and with the TX channels enabled. No other
+ * TX samples may be in flight while a waveform is loaded. Up to
+ * bladerf_tx_loop_status::capacity samples per channel are held. Each
+ * position in the waveform holds a sample for every channel of the layout,
+ * so the same TX channels must be enabled while it is played.
+ *
+ * While the waveform plays, samples submitted through the sync or
+ * asynchronous interfaces are not transmitted, and should not be
+ * submitted. Once it stops, the TX path passes samples through as usual.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * TX waveform loop state
+ */
+typedef enum {
+    BLADERF_TX_LOOP_IDLE = 0, /**< No waveform is loaded */
+    BLADERF_TX_LOOP_LOADING,  /**< A waveform is being captured */
+    BLADERF_TX_LOOP_LOADED,   /**< A waveform is ready to play */
+    BLADERF_TX_LOOP_ARMED,    /**< Waiting for the start time */
+    BLADERF_TX_LOOP_PLAYING,  /**< The waveform is being transmitted */
+} bladerf_tx_loop_state;
+
+/**
+ * TX waveform loop status
+ */
+struct bladerf_tx_loop_status {
+    bladerf_tx_loop_state state; /**< Current state */
+    unsigned int length;         /**< Waveform length, in samples per
+                                  *   channel */
+    unsigned int capacity;       /**< Maximum waveform length, in samples
+                                  *   per channel */
+    uint32_t loops;              /**< Complete repetitions of the waveform
+                                  *   since playback last started */
+};
+
+/**
+ * Load a waveform into the TX loop
+ *
+ * The samples are sent as a single burst through the TX sync interface,
+ * and this call returns once the FPGA has captured all of them. Any
+ * waveform previously loaded is replaced.
+ *
+ * @param       dev             Device handle
+ * @param[in]   samples         Samples, in the format and layout the TX sync
+ *                              interface was configured with
+ * @param[in]   num_samples     Number of samples, across all channels of
+ *                              the layout, as for bladerf_sync_tx()
+ * @param[in]   timeout_ms      Time to wait for the waveform to be captured,
+ *                              in milliseconds. 0 waits indefinitely.
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if the device or FPGA has
+ *         no TX loop, ::BLADERF_ERR_INVAL if the TX sync interface is not
+ *         suitably configured or the waveform does not fit,
+ *         ::BLADERF_ERR_TIMEOUT if the waveform was not captured in time,
+ *         value from \ref RETCODES list on other failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_tx_loop_load(struct bladerf *dev,
+                                   const void *samples,
+                                   unsigned int num_samples,
+                                   unsigned int timeout_ms);
+
+/**
+ * Play the loaded waveform
+ *
+ * @param       dev         Device handle
+ * @param[in]   start       TX timestamp at which to begin, or 0 to begin
+ *                          immediately
+ * @param[in]   stop        TX timestamp at which to end, or 0 to play until
+ *                          bladerf_tx_loop_stop() is called
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if the device or FPGA has
+ *         no TX loop, ::BLADERF_ERR_INVAL if no waveform is loaded, it is
+ *         already playing, or `stop` does not follow `start`, value from
+ *         \ref RETCODES list on other failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_tx_loop_start(struct bladerf *dev,
+                                    uint64_t start,
+                                    uint64_t stop);
+
+/**
+ * Stop playing the waveform
+ *
+ * The waveform remains loaded, and may be played again. Stopping while a
+ * waveform is being loaded abandons the load.
+ *
+ * @param       dev         Device handle
+ * @param[in]   timestamp   TX timestamp at which to stop, or 0 to stop
+ *                          immediately
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if the device or FPGA has
+ *         no TX loop, value from \ref RETCODES list on other failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_tx_loop_stop(struct bladerf *dev, uint64_t timestamp);
+
+/**
+ * Read the TX waveform loop's status
+ *
+ * @param       dev         Device handle
+ * @param[out]  status      Updated with the current status
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if the device or FPGA has
+ *         no TX loop, value from \ref RETCODES list on other failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_tx_loop_get_status(struct bladerf *dev,
+                                         struct bladerf_tx_loop_status *status);
+
+/** @} (End of FN_TX_LOOP) */
+
+/**
+ * @defgroup FN_SCHEDULED_TUNING Scheduled Tuning
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * @ingroup STREAMING
+ *
+ * Timestamp, in ticks
+ *
+ * A channel's timestamp typically increments at the sample rate.
+ *
+ * @see Format macros for fprintf() and fscanf(): `BLADERF_PRIuTS`,
+ * `BLADERF_PRIxTS`, `BLADERF_SCNuTS`, `BLADERF_SCNxTS`
+ */
+typedef uint64_t bladerf_timestamp;
+
+/**
+ * Specifies that scheduled retune should occur immediately when using
+ * bladerf_schedule_retune().
+ */
+#define BLADERF_RETUNE_NOW (bladerf_timestamp)0
+
+/**
+ * Quick Re-tune parameters.
+ *
+ * @note These parameters, which are associated with the RFIC's register values,
+ *       are sensitive to changes in the operating environment (e.g.,
+ *       temperature).
+ *
+ * This structure should be filled in via bladerf_get_quick_tune().
+ */
+struct bladerf_quick_tune {
+    union {
+        /* bladeRF1 quick tune parameters */
+        struct {
+            uint8_t freqsel; /**< Choice of VCO and VCO division factor */
+            uint8_t vcocap;  /**< VCOCAP value */
+            uint16_t nint;   /**< Integer portion of LO frequency value */
+            uint32_t nfrac;  /**< Fractional portion of LO frequency value */
+            uint8_t flags;   /**< Flag bits used internally by libbladeRF */
+            uint8_t xb_gpio;   /**< Flag bits used to configure XB */
+
+            /* Corrections applied along with the retune, when denoted by
+             * `flags`. See ::bladerf_correction for their ranges. */
+            int16_t dc_i;     /**< DC offset I correction */
+            int16_t dc_q;     /**< DC offset Q correction */
+            int16_t iq_gain;  /**< IQ balance gain correction */
+            int16_t iq_phase; /**< IQ balance phase correction */
+        };
+        /* bladeRF2 quick tune parameters */
+        struct {
+            uint16_t nios_profile; /**< Profile number in Nios */
+            uint8_t rffe_profile;  /**< Profile number in RFFE. This is
+                                        managed by libbladeRF when the
+                                        retune is scheduled. */
+            uint8_t port;          /**< RFFE port settings */
+            uint8_t spdt;          /**< External SPDT settings */
+        };
+    };
+};
+
+/**
+ * Schedule a frequency retune to occur at specified sample timestamp value.
+ *
+ * @pre bladerf_sync_config() must have been called with the
+ *      \ref BLADERF_FORMAT_SC16_Q11_META format for the associated channel in
+ *      order to enable timestamps. (The timestamped metadata format must be
+ *      enabled in order to use this function.)
+ *
+ * @param       dev             Device handle
+ * @param[in]   ch              Channel
+ * @param[in]   timestamp       Channel's sample timestamp to perform the
+ *                              retune operation. If this value is in the past,
+ *                              the retune will occur immediately. To perform
+ *                              the retune immediately, specify
+ *                              ::BLADERF_RETUNE_NOW.
+ * @param[in]   frequency       Desired frequency, in Hz.
+ * @param[in]   quick_tune      If non-NULL, the provided "quick retune" values
+ *                              will be applied to the transceiver to tune it
+ *                              according to a previous state retrieved via
+ *                              bladerf_get_quick_tune().
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure.
+ *
+ * @note If the underlying queue of scheduled retune requests becomes full, \ref
+ *       BLADERF_ERR_QUEUE_FULL will be returned. In this case, it should be
+ *       possible to schedule a retune after the timestamp of one of the earlier
+ *       requests occurs.
+ */
+API_EXPORT
+int CALL_CONV bladerf_schedule_retune(struct bladerf *dev,
+                                      bladerf_channel ch,
+                                      bladerf_timestamp timestamp,
+                                      bladerf_frequency frequency,
+                                      struct bladerf_quick_tune *quick_tune);
+
+/**
+ * Cancel all pending scheduled retune operations for the specified channel.
+ *
+ * This will be done automatically during bladerf_close() to ensure that
+ * previously queued retunes do not continue to occur after closing and then
+ * later re-opening a device.
+ *
+ * @param       dev     Device handle
+ * @param[in]   ch      Channel
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure.
+ */
+API_EXPORT
+int CALL_CONV bladerf_cancel_scheduled_retunes(struct bladerf *dev,
+                                               bladerf_channel ch);
+
+/**
+ * Cancel the pending scheduled retune for the specified channel at the
+ * specified timestamp, leaving the rest of the retune queue intact.
+ *
+ * Any other changes scheduled at the same timestamp, such as those queued
+ * by bladerf_schedule_gain(), are cancelled as well. On an RX channel, this
+ * includes paired retunes scheduled with bladerf_schedule_retune_pair().
+ *
+ * A cancelled entry continues to occupy its place in the retune queue until
+ * its timestamp is reached, at which point it is discarded without effect.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   timestamp   Timestamp the retune was scheduled at
+ *
+ * @note Requires FPGA v0.13.0 or later.
+ *
+ * @return 0 on success, ::BLADERF_ERR_INVAL if no pending retune is scheduled
+ *         at the specified timestamp (e.g., it has already occurred),
+ *         ::BLADERF_ERR_UNSUPPORTED if the FPGA does not support this
+ *         operation, or a value from \ref RETCODES list on other failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_cancel_scheduled_retune(struct bladerf *dev,
+                                              bladerf_channel ch,
+                                              bladerf_timestamp timestamp);
+
+/**
+ * Replace the frequency of the pending scheduled retune for the specified
+ * channel at the specified timestamp.
+ *
+ * The retune keeps its position in the retune queue, so the remaining
+ * scheduled retunes need not be cancelled and scheduled again. The
+ * `frequency` and `quick_tune` parameters are interpreted as they are by
+ * bladerf_schedule_retune().
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   timestamp   Timestamp the retune was scheduled at
+ * @param[in]   frequency   New frequency. Ignored if `quick_tune` is not NULL.
+ * @param[in]   quick_tune  New quick tune parameters, or NULL
+ *
+ * @note Requires FPGA v0.13.0 or later. To move a retune to a different
+ *       time, cancel it with bladerf_cancel_scheduled_retune() and, provided
+ *       no later retunes are queued, schedule it again.
+ *
+ * @return 0 on success, ::BLADERF_ERR_INVAL if no pending retune is scheduled
+ *         at the specified timestamp (e.g., it has already occurred),
+ *         ::BLADERF_ERR_UNSUPPORTED if the FPGA does not support this
+ *         operation, or a value from \ref RETCODES list on other failures.
+ */
+API_EXPORT
+int CALL_CONV
+    bladerf_replace_scheduled_retune(struct bladerf *dev,
+                                     bladerf_channel ch,
+                                     bladerf_timestamp timestamp,
+                                     bladerf_frequency frequency,
+                                     struct bladerf_quick_tune *quick_tune);
+
+/**
+ * Schedule an RX and a TX retune to occur together, at the same instant.
+ *
+ * Unlike two calls to bladerf_schedule_retune(), which are timed by the
+ * independent RX and TX timestamp counters and checked by the FPGA at
+ * different points in its processing loop, both retunes are carried in a
+ * single queue entry. The FPGA recalls both fast lock profiles before waiting
+ * for either synthesizer to lock, so the two directions are always hopped
+ * within a few microseconds of each other. This is intended for frequency
+ * hopping links in which both directions hop in step.
+ *
+ * The paired retune occupies one entry in the RX retune queue; it is cleared,
+ * along with any other RX retunes, by bladerf_cancel_scheduled_retunes() on
+ * an RX channel.
+ *
+ * @param       dev         Device handle
+ * @param[in]   timestamp   RX timestamp at which to retune both directions,
+ *                          or ::BLADERF_RETUNE_NOW
+ * @param[in]   rx          RX quick tune parameters, from
+ *                          bladerf_get_quick_tune() on an RX channel
+ * @param[in]   tx          TX quick tune parameters, from
+ *                          bladerf_get_quick_tune() on a TX channel
+ *
+ * @note This is currently supported only by the bladeRF 2.0 Micro, with
+ *       FPGA v0.13.0 or later. Nios profiles numbered 256 and above cannot be
+ *       used in a paired retune.
+ *
+ * @return 0 on success, ::BLADERF_ERR_QUEUE_FULL if the RX retune queue is
+ *         full, ::BLADERF_ERR_UNSUPPORTED if the device or FPGA does not
+ *         support paired retunes, or a value from \ref RETCODES list on
+ *         other failures.
+ */
+API_EXPORT
+int CALL_CONV
+    bladerf_schedule_retune_pair(struct bladerf *dev,
+                                 bladerf_timestamp timestamp,
+                                 const struct bladerf_quick_tune *rx,
+                                 const struct bladerf_quick_tune *tx);
+
+/**
+ * Fetch parameters used to tune the transceiver to the current frequency for
+ * use with bladerf_schedule_retune() to perform a "quick retune."
+ *
+ * This allows for a faster retune, with a potential trade off of increased
+ * phase noise.
+ *
+ * @note These parameters are sensitive to changes in the operating environment,
+ *       and should be "refreshed" if planning to use the "quick retune"
+ *       functionality over a long period of time.
+ *
+ * On the bladeRF x40/x115 with FPGA v0.13.0 or later, the channel's current
+ * DC offset and IQ balance corrections are also captured. These are applied
+ * by the FPGA immediately after the frequency change when the quick tune is
+ * used, so that corrections looked up from a DC calibration table by
+ * bladerf_set_frequency() accompany scheduled retunes.
+ *
+ * @pre bladerf_set_frequency() or bladerf_schedule_retune() have previously
+ *      been used to retune to the desired frequency.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[out]  quick_tune  Quick retune parameters
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_quick_tune(struct bladerf *dev,
+                                     bladerf_channel ch,
+                                     struct bladerf_quick_tune *quick_tune);
+
+/**
+ * Measurements of the most recent retune performed by the FPGA
+ *
+ * The settling time of a retune is `complete - start`, in ticks of the
+ * channel's timestamp counter. For scheduled retunes, `start - scheduled` is
+ * the latency between the requested timestamp and the start of the retune.
+ */
+struct bladerf_retune_stats {
+    bladerf_timestamp scheduled; /**< Timestamp the retune was scheduled for,
+                                      or ::BLADERF_RETUNE_NOW */
+    bladerf_timestamp start;     /**< Timestamp when the retune began */
+    bladerf_timestamp complete;  /**< Timestamp when the retune completed and,
+                                      if `locked` is set, the PLL reported
+                                      lock */
+    bool locked;                 /**< The PLL reported lock once the retune
+                                      completed. If not set, the PLL did not
+                                      report lock within the FPGA's polling
+                                      limit. */
+};
+
+/**
+ * Retrieve measurements of the most recent retune of a channel
+ *
+ * This covers retunes performed by the FPGA: those requested via
+ * bladerf_schedule_retune(), and, on the bladeRF1 in
+ * ::BLADERF_TUNING_MODE_FPGA, via bladerf_set_frequency(). Channels sharing an
+ * LO (e.g., RX1 and RX2 on the bladeRF2) report the same measurements.
+ *
+ * The timestamp counter must be running (see bladerf_schedule_retune()) for
+ * the timestamps to be meaningful.
+ *
+ * @param       dev     Device handle
+ * @param[in]   ch      Channel
+ * @param[out]  stats   Retune measurements
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if the FPGA does not
+ *         support this, ::BLADERF_ERR_UNEXPECTED if no retune has been
+ *         performed by the FPGA, or value from \ref RETCODES list on other
+ *         failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_retune_stats(struct bladerf *dev,
+                                       bladerf_channel ch,
+                                       struct bladerf_retune_stats *stats);
+
+/**
+ * Schedule an overall gain change to occur at the specified sample timestamp
+ *
+ * The gain is apportioned among the gain stages exactly as per
+ * bladerf_set_gain(), and the resulting settings are applied by the FPGA when
+ * the timestamp is reached, without retuning. This is intended for gain
+ * control loops that must change the gain on a known sample boundary.
+ *
+ * Gain changes share the channel's retune queue with scheduled retunes, and
+ * are removed along with them by bladerf_cancel_scheduled_retunes(). The
+ * same timestamp requirements as bladerf_schedule_retune() apply.
+ *
+ * @note This requires FPGA v0.13.0 or later. On the bladeRF 2.0 micro, the
+ *       RFIC must be controlled by the FPGA (::BLADERF_TUNING_MODE_FPGA), and
+ *       RX gain may only be changed in manual gain mode (::BLADERF_GAIN_MGC).
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   timestamp   Channel's sample timestamp at which to apply the
+ *                          gain, or ::BLADERF_RETUNE_NOW to apply it
+ *                          immediately
+ * @param[in]   gain        Desired gain, in dB
+ *
+ * @return 0 on success, ::BLADERF_ERR_QUEUE_FULL if the retune queue is full,
+ *         ::BLADERF_ERR_UNSUPPORTED if the device or FPGA does not support
+ *         this, or value from \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_schedule_gain(struct bladerf *dev,
+                                    bladerf_channel ch,
+                                    bladerf_timestamp timestamp,
+                                    int gain);
+
+/** @} (End of FN_SCHEDULED_TUNING) */
+
+/**
+ * @defgroup FN_HOP_TABLE Hop tables
+ *
+ * A hop table is a frequency plan of quick tune parameters, loaded once per
+ * channel, from which scheduled retunes may then be requested by index.
+ * This avoids passing a full ::bladerf_quick_tune for every hop, and allows
+ * a sequence of hops to be scheduled with a single call.
+ *
+ * Hops are scheduled via the same queue used by bladerf_schedule_retune(),
+ * and are subject to the same preconditions. On the bladeRF 2.0 micro,
+ * each entry refers to a fastlock profile saved on the device, so entries
+ * must have been obtained via bladerf_get_quick_tune() since the device was
+ * opened.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Load a channel's hop table, replacing any previously loaded table
+ *
+ * The entries are copied, and need not remain valid after this call.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   entries     Quick tune parameters, typically obtained via
+ *                          bladerf_get_quick_tune(). May be NULL if `count`
+ *                          is 0, which discards the channel's table.
+ * @param[in]   count       Number of entries
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_hop_table(struct bladerf *dev,
+                                    bladerf_channel ch,
+                                    const struct bladerf_quick_tune *entries,
+                                    unsigned int count);
+
+/**
+ * Schedule a retune to the specified hop table entry
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   timestamp   Channel's sample timestamp at which to retune, or
+ *                          ::BLADERF_RETUNE_NOW
+ * @param[in]   index       Index of the entry in the channel's hop table
+ *
+ * @return 0 on success, ::BLADERF_ERR_INVAL if `index` is outside of the
+ *         hop table, ::BLADERF_ERR_QUEUE_FULL if the retune queue is full,
+ *         or value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_schedule_hop(struct bladerf *dev,
+                                   bladerf_channel ch,
+                                   bladerf_timestamp timestamp,
+                                   unsigned int index);
+
+/**
+ * Schedule a sequence of retunes to hop table entries
+ *
+ * Hops are scheduled in order until all have been scheduled or an error
+ * occurs. If the device's retune queue fills, ::BLADERF_ERR_QUEUE_FULL is
+ * returned, and the remaining hops may be scheduled once earlier ones have
+ * occurred.
+ *
+ * @param       dev             Device handle
+ * @param[in]   ch              Channel
+ * @param[in]   timestamps      Sample timestamp of each hop
+ * @param[in]   indices         Hop table index of each hop
+ * @param[in]   count           Number of hops
+ * @param[out]  num_scheduled   If non-NULL, updated with the number of hops
+ *                              that were scheduled
+ *
+ * @return 0 if all hops were scheduled, or value from \ref RETCODES list on
+ *         failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_schedule_hops(struct bladerf *dev,
+                                    bladerf_channel ch,
+                                    const bladerf_timestamp *timestamps,
+                                    const unsigned int *indices,
+                                    unsigned int count,
+                                    unsigned int *num_scheduled);
+
+/** @} (End of FN_HOP_TABLE) */
+
+/**
+ * @defgroup FN_SWEEP Frequency sweeps
+ *
+ * The sweep engine steps a receive channel through a range of frequencies,
+ * delivering a block of samples captured at each step. Retunes are scheduled
+ * ahead of time via quick tune parameters, so the retune for a step occurs
+ * at a precise sample timestamp while the previous step is still being
+ * captured. The samples received while the PLL settles after each retune
+ * are discarded automatically.
+ *
+ * Prior to a sweep, the synchronous interface must be configured for the RX
+ * direction with a metadata format (e.g., ::BLADERF_FORMAT_SC16_Q11_META),
+ * and the channel must be enabled. No other bladerf_sync_rx() calls should be
+ * made while the sweep is running.
+ *
+ * @{
+ */
+
+/**
+ * Default number of retunes kept scheduled ahead of the step being captured
+ */
+#define BLADERF_SWEEP_LOOKAHEAD_DEFAULT 4
+
+/**
+ * Sweep configuration
+ */
+struct bladerf_sweep_config {
+    bladerf_frequency start; /**< First frequency, in Hz */
+    bladerf_frequency stop;  /**< Last frequency, in Hz. This is included in
+                              *   the sweep if it is a whole number of steps
+                              *   from `start`. */
+    bladerf_frequency step;  /**< Frequency step, in Hz */
+
+    unsigned int samples_per_step; /**< Samples delivered per step */
+
+    /**
+     * Samples to discard after each retune, while the PLL settles. This may
+     * be chosen from the settling times reported by
+     * bladerf_get_retune_stats().
+     */
+    unsigned int settle_samples;
+
+    /**
+     * Number of retunes to keep scheduled ahead of the step being captured.
+     * 0 selects ::BLADERF_SWEEP_LOOKAHEAD_DEFAULT. This should not exceed
+     * the depth of the device's retune queue.
+     */
+    unsigned int lookahead;
+
+    unsigned int timeout_ms; /**< Timeout for each step's capture, in ms */
+};
+
+/**
+ * A block of samples captured at one step of a sweep
+ */
+struct bladerf_sweep_block {
+    unsigned int sweep;          /**< Sweep number, starting at 0 */
+    unsigned int step;           /**< Step number within the sweep */
+    bladerf_frequency frequency; /**< Frequency of this step, in Hz */
+    bladerf_timestamp timestamp; /**< Timestamp of the first sample */
+
+    /**
+     * Samples, in the format configured via bladerf_sync_config(). This
+     * buffer is only valid for the duration of the callback.
+     */
+    const void *samples;
+
+    /**
+     * Number of samples in the block. This is less than
+     * bladerf_sweep_config.samples_per_step if an overrun occurred.
+     */
+    unsigned int num_samples;
+
+    /**
+     * Status flags, as in bladerf_metadata.status (e.g.,
+     * ::BLADERF_META_STATUS_OVERRUN)
+     */
+    uint32_t status;
+};
+
+/**
+ * Callback invoked for each block of a sweep
+ *
+ * @param       dev         Device handle
+ * @param[in]   block       Captured block
+ * @param       user_data   User data provided to bladerf_sweep()
+ *
+ * @return 0 to continue the sweep, or any other value to end it
+ */
+typedef int (*bladerf_sweep_cb)(struct bladerf *dev,
+                                const struct bladerf_sweep_block *block,
+                                void *user_data);
+
+/**
+ * Sweep a receive channel across a range of frequencies
+ *
+ * Quick tune parameters are first obtained for every step, which leaves the
+ * channel tuned to the final step. The engine then schedules the retune
+ * for each step at a sample timestamp, keeping up to
+ * bladerf_sweep_config.lookahead retunes queued. Each step's samples are
+ * read starting `settle_samples` after its retune. If capture falls behind
+ * the schedule, pending retunes are cancelled and the schedule restarts at
+ * the current step.
+ *
+ * This function blocks until the requested number of sweeps completes, the
+ * callback ends the sweep, or an error occurs. Pending retunes are cancelled
+ * before it returns.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          RX channel
+ * @param[in]   config      Sweep configuration
+ * @param[in]   num_sweeps  Number of sweeps to perform. 0 continues until
+ *                          the callback ends the sweep.
+ * @param[in]   cb          Callback invoked for each block
+ * @param       user_data   Passed to `cb`
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if scheduled retunes are
+ *         not supported by the device, or value from \ref RETCODES list on
+ *         failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_sweep(struct bladerf *dev,
+                            bladerf_channel ch,
+                            const struct bladerf_sweep_config *config,
+                            unsigned int num_sweeps,
+                            bladerf_sweep_cb cb,
+                            void *user_data);
+
+/** @} (End of FN_SWEEP) */
+
+/**
+ * @defgroup FN_ASYNC_CONTROL Asynchronous control
+ *
+ * These functions enqueue a control operation and return immediately, rather
+ * than blocking the caller for the duration of the associated USB
+ * transactions. Each device has one queue. Its operations run in
+ * submission order, on a worker thread that starts when the first
+ * operation is submitted.
+ *
+ * Completion is reported via an optional callback, which is executed on the
+ * worker thread, and may also be checked via bladerf_ctrl_poll() or
+ * awaited via bladerf_ctrl_wait().
+ *
+ * Queued operations are performed as if the associated blocking function
+ * were called, and may be freely interleaved with calls to blocking
+ * functions. bladerf_close() waits for all queued operations to complete.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Identifies a queued control operation. Tickets are assigned in
+ * increasing order, starting at 1.
+ */
+typedef uint64_t bladerf_ctrl_ticket;
+
+/**
+ * Maximum number of pending control operations per device. The status of
+ * an operation remains available via bladerf_ctrl_poll() and
+ * bladerf_ctrl_wait() until this many
+ * subsequent operations have been submitted.
+ */
+#define BLADERF_CTRL_QUEUE_LEN 32
+
+/**
+ * Control operation completion callback
+ *
+ * This is executed on the device's control worker thread. It may submit
+ * further operations and call blocking functions, but must not wait upon
+ * queued operations or call bladerf_close().
+ *
+ * @param       dev         Device handle
+ * @param[in]   ticket      Ticket of the completed operation
+ * @param[in]   status      0 on success, value from \ref RETCODES list on
+ *                          failure
+ * @param       user_data   User data provided when submitting the operation
+ */
+typedef void (*bladerf_ctrl_cb)(struct bladerf *dev,
+                                bladerf_ctrl_ticket ticket,
+                                int status,
+                                void *user_data);
+
+/**
+ * Enqueue a bladerf_set_gain() operation
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   gain        Desired gain, in dB
+ * @param[in]   cb          Completion callback. May be NULL.
+ * @param       user_data   Passed to the completion callback
+ * @param[out]  ticket      Updated with the operation's ticket. May be NULL.
+ *
+ * @return 0 on success, BLADERF_ERR_QUEUE_FULL if BLADERF_CTRL_QUEUE_LEN
+ *         operations are pending, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_gain_async(struct bladerf *dev,
+                                     bladerf_channel ch,
+                                     bladerf_gain gain,
+                                     bladerf_ctrl_cb cb,
+                                     void *user_data,
+                                     bladerf_ctrl_ticket *ticket);
+
+/**
+ * Enqueue a bladerf_set_frequency() operation
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   frequency   Desired frequency, in Hz
+ * @param[in]   cb          Completion callback. May be NULL.
+ * @param       user_data   Passed to the completion callback
+ * @param[out]  ticket      Updated with the operation's ticket. May be NULL.
+ *
+ * @return 0 on success, BLADERF_ERR_QUEUE_FULL if BLADERF_CTRL_QUEUE_LEN
+ *         operations are pending, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_frequency_async(struct bladerf *dev,
+                                          bladerf_channel ch,
+                                          bladerf_frequency frequency,
+                                          bladerf_ctrl_cb cb,
+                                          void *user_data,
+                                          bladerf_ctrl_ticket *ticket);
+
+/**
+ * Enqueue a bladerf_set_bandwidth() operation
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   bandwidth   Desired bandwidth, in Hz
+ * @param[out]  actual      If non-NULL, updated with the actual bandwidth
+ *                          prior to completion. Must remain valid until the
+ *                          operation completes.
+ * @param[in]   cb          Completion callback. May be NULL.
+ * @param       user_data   Passed to the completion callback
+ * @param[out]  ticket      Updated with the operation's ticket. May be NULL.
+ *
+ * @return 0 on success, BLADERF_ERR_QUEUE_FULL if BLADERF_CTRL_QUEUE_LEN
+ *         operations are pending, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_bandwidth_async(struct bladerf *dev,
+                                          bladerf_channel ch,
+                                          bladerf_bandwidth bandwidth,
+                                          bladerf_bandwidth *actual,
+                                          bladerf_ctrl_cb cb,
+                                          void *user_data,
+                                          bladerf_ctrl_ticket *ticket);
+
+/**
+ * Check whether a queued control operation has completed, without blocking
+ *
+ * @param       dev         Device handle
+ * @param[in]   ticket      Operation's ticket
+ * @param[out]  status      If non-NULL, updated with the status of the
+ *                          completed operation
+ *
+ * @return 0 if the operation has completed, BLADERF_ERR_WOULD_BLOCK if it is
+ *         pending, BLADERF_ERR_INVAL if the ticket is invalid or its status is
+ *         no longer available
+ */
+API_EXPORT
+int CALL_CONV bladerf_ctrl_poll(struct bladerf *dev,
+                                bladerf_ctrl_ticket ticket,
+                                int *status);
+
+/**
+ * Wait for a queued control operation to complete
+ *
+ * @param       dev         Device handle
+ * @param[in]   ticket      Operation's ticket
+ * @param[in]   timeout_ms  Timeout, in milliseconds. 0 implies an infinite
+ *                          wait.
+ * @param[out]  status      If non-NULL, updated with the status of the
+ *                          completed operation
+ *
+ * @return 0 if the operation has completed, BLADERF_ERR_TIMEOUT if it did not
+ *         complete in time, BLADERF_ERR_INVAL if the ticket is invalid or its
+ *         status is no longer available
+ */
+API_EXPORT
+int CALL_CONV bladerf_ctrl_wait(struct bladerf *dev,
+                                bladerf_ctrl_ticket ticket,
+                                unsigned int timeout_ms,
+                                int *status);
+
+/** @} (End of FN_ASYNC_CONTROL) */
+
+/**
+ * @defgroup FN_CHANNEL_CONFIG Channel configuration
+ *
+ * These functions apply several channel parameters in a single call. Only
+ * parameters that differ from the channel's current configuration are
+ * written, and they are applied in an order that avoids redundant RFIC
+ * calibrations.
+ *
+ * On the bladeRF 2.0 micro with FPGA-based RFIC control, the resulting
+ * commands are submitted to the FPGA's RFIC command queue together, and
+ * the host waits once for the queue to drain, rather than after each
+ * command.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * @defgroup BLADERF_CHANNEL_CONFIG Channel configuration fields
+ *
+ * Flags selecting which members of a bladerf_channel_config are applied
+ *
+ * @{
+ */
+
+/** Apply bladerf_channel_config::sample_rate */
+#define BLADERF_CHANNEL_CONFIG_SAMPLE_RATE (1 << 0)
+
+/** Apply bladerf_channel_config::bandwidth */
+#define BLADERF_CHANNEL_CONFIG_BANDWIDTH (1 << 1)
+
+/** Apply bladerf_channel_config::frequency */
+#define BLADERF_CHANNEL_CONFIG_FREQUENCY (1 << 2)
+
+/** Apply bladerf_channel_config::rf_port */
+#define BLADERF_CHANNEL_CONFIG_RF_PORT (1 << 3)
+
+/** Apply bladerf_channel_config::gain_mode. This is ignored for TX
+ *  channels. */
+#define BLADERF_CHANNEL_CONFIG_GAIN_MODE (1 << 4)
+
+/** Apply bladerf_channel_config::gain */
+#define BLADERF_CHANNEL_CONFIG_GAIN (1 << 5)
+
+/** All of the above */
+#define BLADERF_CHANNEL_CONFIG_ALL (0x3f)
+
+/** @} (End of BLADERF_CHANNEL_CONFIG) */
+
+/**
+ * Channel operating point, for use with bladerf_apply_config()
+ */
+struct bladerf_channel_config {
+    uint32_t fields; /**< Members to apply. Bitwise OR of
+                      *   \ref BLADERF_CHANNEL_CONFIG flags. */
+
+    bladerf_sample_rate sample_rate; /**< Sample rate, in samples/second */
+    bladerf_bandwidth bandwidth;     /**< Bandwidth, in Hz */
+    bladerf_frequency frequency;     /**< Frequency, in Hz */
+    const char *rf_port;             /**< RF port name */
+    bladerf_gain_mode gain_mode;     /**< Gain control mode */
+    bladerf_gain gain;               /**< Overall gain, in dB */
+};
+
+/**
+ * Apply a channel configuration
+ *
+ * All selected parameters are range-checked before anything is written.
+ * They are then applied in the following order, skipping any that already
+ * match the channel's current configuration: sample rate, bandwidth,
+ * frequency, RF port, gain mode, gain.
+ *
+ * Parameters that the hardware quantizes (e.g., bandwidth on the bladeRF
+ * x40/x115) are compared against the value read back from the device, and
+ * so may be rewritten each time if the requested value is not exactly
+ * achievable.
+ *
+ * @note If an error occurs while writing, parameters applied before the
+ *       failure remain in effect.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   config      Configuration to apply
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_apply_config(struct bladerf *dev,
+                                   bladerf_channel ch,
+                                   const struct bladerf_channel_config *config);
+
+/**
+ * Save the device's operating point to a binary profile
+ *
+ * For each channel, this records the bladerf_channel_config fields that can
+ * be read back (the RX gain only under ::BLADERF_GAIN_MGC), the
+ * ::bladerf_correction values, and on the bladeRF x40/x115 the quick tune
+ * parameters of the current frequency. The profile is tied to this device's
+ * board type and serial number.
+ *
+ * @param       dev         Device handle
+ * @param[in]   filename    Profile path, or NULL to use
+ *                          `profile-<serial>.bin` in the user's bladeRF
+ *                          configuration directory (e.g.,
+ *                          ~/.config/Nuand/bladeRF/)
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if `filename` is NULL and
+ *         the device's serial number is unknown, or a value from
+ *         \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_save_profile(struct bladerf *dev, const char *filename);
+
+/**
+ * Restore an operating point saved by bladerf_save_profile()
+ *
+ * Every channel's saved configuration is validated before anything is
+ * written. Each channel is then restored as if by bladerf_apply_config(),
+ * followed by its corrections. Where the profile holds quick tune
+ * parameters, the frequency is restored via a ::BLADERF_RETUNE_NOW retune
+ * using them, bypassing the tuning search, and falls back to a full tune if
+ * the FPGA does not support this.
+ *
+ * A profile can also be restored when the device is opened, via a
+ * `profile` entry in bladeRF.conf whose value is a path, or `default` for
+ * the path used by bladerf_save_profile() with a NULL `filename`.
+ *
+ * @note If an error occurs while writing, parameters applied before the
+ *       failure remain in effect.
+ *
+ * @param       dev         Device handle
+ * @param[in]   filename    Profile path, or NULL for the default path
+ *
+ * @return 0 on success, ::BLADERF_ERR_INVAL if the profile is malformed,
+ *         corrupt, or was saved from another device, or a value from
+ *         \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_load_profile(struct bladerf *dev, const char *filename);
+
+/** @} (End of FN_CHANNEL_CONFIG) */
+
+/**
+ * @defgroup FN_STATE_CACHE Device state cache
+ *
+ * libbladeRF caches the values returned by bladerf_get_frequency(),
+ * bladerf_get_gain(), bladerf_get_gain_mode(), bladerf_get_sample_rate()
+ * and bladerf_get_bandwidth(), so that polling these does not require a
+ * round trip to the device each time.
+ *
+ * A cached value is filled from the first read of the hardware, or from
+ * the actual value reported by a setter, and is invalidated by any
+ * libbladeRF call that may change it. For example, a frequency change
+ * invalidates the gain of the channels it affects, and a sample rate
+ * change invalidates the sample rate and bandwidth of all channels.
+ *
+ * Values are not cached in the following cases:
+ *  - The frequency and gain of a direction with scheduled retunes
+ *    outstanding, as the host is not notified as they complete. This holds
+ *    until bladerf_cancel_scheduled_retunes() is called.
+ *  - The RX gain of a channel whose gain mode is not ::BLADERF_GAIN_MGC,
+ *    as the AGC may change it at any time.
+ *
+ * The cache is flushed by bladerf_device_reset(), bladerf_load_fpga(),
+ * bladerf_apply_config(), bladerf_load_profile() and the low-level register
+ * access functions.
+ * If the device's state is changed by other means, such as another process
+ * or bladerf_lms_write(), call bladerf_invalidate_state_cache() or disable
+ * the cache.
+ *
+ * The cache is enabled by default.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Enable or disable the device state cache
+ *
+ * When disabled, every call to a getter reads the device.
+ *
+ * @param       dev         Device handle
+ * @param[in]   enable      true to enable the cache, false to disable it
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_state_cache(struct bladerf *dev, bool enable);
+
+/**
+ * Determine whether the device state cache is enabled
+ *
+ * @param       dev         Device handle
+ * @param[out]  enabled     Set to true if the cache is enabled
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_state_cache(struct bladerf *dev, bool *enabled);
+
+/**
+ * Invalidate the device state cache, so that the next call to each getter
+ * reads the device
+ *
+ * @param       dev         Device handle
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_invalidate_state_cache(struct bladerf *dev);
+
+/** @} (End of FN_STATE_CACHE) */
+
+/**
+ * @defgroup FN_CORR    Correction
+ *
+ * This group provides routines for applying manual offset, gain, and phase
+ * corrections.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Correction value, in arbitrary units
+ *
+ * @see ::bladerf_correction
+ * @see bladerf_get_correction()
+ * @see bladerf_set_correction()
+ */
+typedef int16_t bladerf_correction_value;
+
+/**
+ * Correction parameter selection
+ *
+ * These values specify the correction parameter to modify or query when calling
+ * bladerf_set_correction() or bladerf_get_correction(). Note that the meaning
+ * of the `value` parameter to these functions depends upon the correction
+ * parameter.
+ *
+ */
+typedef enum {
+    /**
+     * Adjusts the in-phase DC offset. Valid values are [-2048, 2048], which are
+     * scaled to the available control bits.
+     */
+    BLADERF_CORR_DCOFF_I,
+
+    /**
+     * Adjusts the quadrature DC offset. Valid values are [-2048, 2048], which
+     * are scaled to the available control bits.
+     */
+    BLADERF_CORR_DCOFF_Q,
+
+    /**
+     * Adjusts phase correction of [-10, 10] degrees, via a provided count value
+     * of [-4096, 4096].
+     */
+    BLADERF_CORR_PHASE,
+
+    /**
+     * Adjusts gain correction value in [-1.0, 1.0], via provided values in the
+     * range of [-4096, 4096].
+     */
+    BLADERF_CORR_GAIN
+} bladerf_correction;
+
+/** @cond IGNORE */
+/* Backwards compatible mapping to `bladerf_correction`. */
+#define BLADERF_CORR_LMS_DCOFF_I BLADERF_CORR_DCOFF_I
+#define BLADERF_CORR_LMS_DCOFF_Q BLADERF_CORR_DCOFF_Q
+#define BLADERF_CORR_FPGA_PHASE BLADERF_CORR_PHASE
+#define BLADERF_CORR_FPGA_GAIN BLADERF_CORR_GAIN
+/** @endcond */
+
+/**
+ * Set the value of the specified configuration parameter
+ *
+ * @see The ::bladerf_correction description for the valid ranges of the `value`
+ *      parameter.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   corr        Correction type
+ * @param[in]   value       Value to apply
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_correction(struct bladerf *dev,
+                                     bladerf_channel ch,
+                                     bladerf_correction corr,
+                                     bladerf_correction_value value);
+
+/**
+ * Obtain the current value of the specified configuration parameter
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   corr        Correction type
+ * @param[out]  value       Current value
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_correction(struct bladerf *dev,
+                                     bladerf_channel ch,
+                                     bladerf_correction corr,
+                                     bladerf_correction_value *value);
+
+/**
+ * @defgroup FN_CORR_CACHE Calibration cache
+ *
+ * Correction values drift with temperature, as well as depending upon the
+ * frequency and gain. When the calibration cache is enabled for a channel,
+ * each value written via bladerf_set_correction() is recorded under the
+ * channel's current frequency, gain, and temperature bucket. Whenever the
+ * channel is subsequently retuned via bladerf_set_frequency() or its gain
+ * is changed via bladerf_set_gain(), the values of the nearest entry are
+ * applied: an entry in the nearest temperature bucket is preferred, followed
+ * by the nearest frequency, and then the nearest gain.
+ *
+ * This allows an application to calibrate once per operating point and
+ * temperature (e.g., via the routines in bladeRF-cli's `calibrate dc`), and
+ * reuse the results, rather than recalibrating each time the board warms
+ * up.
+ *
+ * The temperature is read from the AD9361 on the bladeRF 2.0, which requires
+ * ::BLADERF_TUNING_MODE_HOST. The bladeRF 1's LMS6002D does not provide a
+ * temperature sensor, so entries are keyed by frequency and gain only.
+ *
+ * Optionally, a refresh callback may be provided. About once per second, a
+ * background thread checks whether the channel's current operating point
+ * lacks an entry for the current temperature bucket, or whether that entry
+ * is older than the configured maximum age. If so, and the TX synchronous
+ * interface has not completed a transfer for the configured idle time, the
+ * callback is invoked from the background thread to recalibrate. The
+ * corrections it writes via bladerf_set_correction() are recorded as usual.
+ *
+ * @{
+ */
+
+/**
+ * Calibration refresh callback
+ *
+ * This is invoked from the calibration cache's background thread, without
+ * the device's handle lock held, so it may use any libbladeRF function.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel whose current entry is missing or stale
+ * @param       user_data   User data provided in the configuration
+ *
+ * @return 0 on success, or a value from \ref RETCODES list on failure, which
+ *         is logged
+ */
+typedef int (*bladerf_cal_refresh_cb)(struct bladerf *dev,
+                                      bladerf_channel ch,
+                                      void *user_data);
+
+/**
+ * Calibration cache configuration
+ */
+struct bladerf_cal_cache_config {
+    /** Width of each temperature bucket, in degrees C. 0 selects
+     *  ::BLADERF_CAL_CACHE_TEMP_BUCKET_DEFAULT. */
+    unsigned int temp_bucket_c;
+
+    /** Entries farther than this from the current frequency are not
+     *  applied. 0 permits entries at any frequency. */
+    bladerf_frequency max_freq_delta;
+
+    /** Age, in milliseconds, beyond which an entry is considered stale and
+     *  is refreshed. 0 disables age-based refreshes. */
+    unsigned int max_age_ms;
+
+    /** Optional callback that recalibrates the channel. NULL disables
+     *  background refreshes. */
+    bladerf_cal_refresh_cb refresh;
+
+    /** User data passed to `refresh` */
+    void *user_data;
+
+    /** Time, in milliseconds, that TX must have been idle before `refresh`
+     *  is invoked */
+    unsigned int tx_idle_ms;
+};
+
+/** Default temperature bucket width, in degrees C */
+#define BLADERF_CAL_CACHE_TEMP_BUCKET_DEFAULT 5
+
+/** Maximum number of entries held per channel. When full, the least recently
+ *  updated entry is replaced. */
+#define BLADERF_CAL_CACHE_MAX_ENTRIES 128
+
+/**
+ * Enable or disable the calibration cache for a channel
+ *
+ * Reconfiguring an enabled channel retains its entries. Disabling it
+ * discards them.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   config      Configuration, or NULL to disable the cache
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV
+    bladerf_set_cal_cache(struct bladerf *dev,
+                          bladerf_channel ch,
+                          const struct bladerf_cal_cache_config *config);
+
+/**
+ * Record a channel's current correction values in its calibration cache
+ *
+ * This is useful for recording values that were determined without
+ * bladerf_set_correction(), such as those of a bladeRF 2.0's AD9361
+ * tracking loops.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if the cache is not enabled for
+ *         `ch`, or a value from \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_cal_cache_record(struct bladerf *dev,
+                                       bladerf_channel ch);
+
+/** @} (End of FN_CORR_CACHE) */
+
+/**
+ * @defgroup FN_CORR_SAMPLE RX sample calibration
+ *
+ * The gain corrections applied by libbladeRF, such as those of the bladeRF
+ * 2.0's gain calibration offsets, only adjust the gain that is requested of
+ * the RF frontend. Applications that require power-calibrated samples may
+ * instead load a per-frequency RX sample calibration table for a channel.
+ *
+ * While a table is loaded, each sample provided by the synchronous
+ * interface is scaled by the inverse of the channel's overall gain (per
+ * bladerf_get_gain()) and of the table's gain at the current frequency, and
+ * is corrected for the table's I/Q gain and phase imbalance. A full-scale
+ * sample at the antenna port therefore reads as the table's reference
+ * level. This is performed in the same pass that converts samples to
+ * ::BLADERF_FORMAT_CF32, so it is only applied to streams using the
+ * ::BLADERF_FORMAT_CF32 and ::BLADERF_FORMAT_CF32_META formats.
+ *
+ * Table values are linearly interpolated between entries, and are clamped to
+ * those of the first and last entries outside of the table's range. The
+ * correction is updated when the channel is retuned via
+ * bladerf_set_frequency() or its gain is changed via bladerf_set_gain(), and
+ * takes effect at the next synchronous RX call. Scheduled retunes and
+ * automatic gain control are not tracked.
+ *
+ * With ::BLADERF_RX_X1, the table of the lowest-numbered RX channel that has
+ * one is used.
+ *
+ * @{
+ */
+
+/**
+ * RX sample calibration table entry
+ */
+struct bladerf_rx_sample_cal_entry {
+    /** Frequency, in Hz. Entries must be sorted by increasing frequency. */
+    bladerf_frequency frequency;
+
+    /** Gain, in dB, from the antenna port to full scale, in addition to the
+     *  channel's overall gain. Samples are scaled by
+     *  10^(-(gain + gain_db) / 20). */
+    float gain_db;
+
+    /** Ratio of the Q amplitude to the I amplitude. 1.0 for none. */
+    float iq_gain;
+
+    /** Phase error of Q relative to I, in degrees. 0.0 for none. */
+    float iq_phase;
+};
+
+/** Maximum number of entries in an RX sample calibration table */
+#define BLADERF_RX_SAMPLE_CAL_MAX_ENTRIES 8192
+
+/**
+ * Load or unload an RX sample calibration table for a channel
+ *
+ * The table is copied.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          RX channel
+ * @param[in]   entries     Table entries, or NULL to unload the table
+ * @param[in]   num_entries Number of entries
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL for a TX channel or an invalid
+ *         table, or a value from \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_rx_sample_cal(
+    struct bladerf *dev,
+    bladerf_channel ch,
+    const struct bladerf_rx_sample_cal_entry *entries,
+    unsigned int num_entries);
+
+/** @} (End of FN_CORR_SAMPLE) */
+
+/** @} (End of FN_CORR) */
+
+/**
+ * @defgroup FN_RX_AGC Host-side digital AGC
+ *
+ * The host-side AGC regulates an RX channel's mean power by adjusting its
+ * overall gain, as bladerf_set_gain() does, in manual gain mode. Unlike the
+ * RF frontend's own AGC modes, its loop is under the application's control:
+ * the bladeRF1 has no automatic gain control to offer, and the AD9361's is
+ * configured once, by its init parameters.
+ *
+ * Power is measured in the synchronous interface's copy-out pass, as
+ * bladerf_sync_rx() and its variants provide samples, so no additional pass
+ * over the samples is needed. Samples obtained via bladerf_sync_rx_acquire()
+ * are not measured. Once `block_samples` samples have been measured, a gain
+ * change of up to `max_step_db` toward the target is computed and submitted
+ * to the device's control worker (see \ref FN_ASYNC_CONTROL), so the RX call
+ * does not wait on the control transfer. Only one change is in flight at a
+ * time, and measurement resumes `settle_samples` after it takes effect.
+ *
+ * Where the stream carries timestamps and the device can schedule gain
+ * changes (see bladerf_schedule_gain()), the change is scheduled
+ * `lead_samples` after the last sample measured, so that it takes effect on
+ * a known sample. Otherwise, it is applied once the control worker reaches
+ * it.
+ *
+ * The gain in effect for the first sample returned by each RX call is
+ * reported in the bladerf_metadata structure's `rx_gain` field, and
+ * ::BLADERF_META_STATUS_GAIN_CHANGE is set when a change takes effect
+ * within the returned samples. This is exact for scheduled changes. An
+ * immediate change is reported by the first call to complete after it has
+ * been applied.
+ *
+ * Only SC16 Q11 and CF32 streams are measured. With ::BLADERF_RX_X1, the
+ * lowest-numbered RX channel that has the AGC enabled is regulated.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/** Default number of samples measured per AGC update */
+#define BLADERF_RX_AGC_BLOCK_DEFAULT 16384
+
+/** Default number of samples by which a scheduled AGC change leads the
+ *  samples it follows */
+#define BLADERF_RX_AGC_LEAD_DEFAULT 65536
+
+/**
+ * Host-side AGC configuration
+ */
+struct bladerf_rx_agc_config {
+    /** Mean power to regulate to, in dBFS */
+    float target_dbfs;
+
+    /** No change is made while the measured power is within this many dB
+     *  of the target */
+    float deadband_db;
+
+    /** Largest gain change made per update, in dB. Must be positive. */
+    float max_step_db;
+
+    /** Samples measured per update. 0 selects
+     *  ::BLADERF_RX_AGC_BLOCK_DEFAULT. */
+    unsigned int block_samples;
+
+    /** Samples discarded from measurement once a change has taken effect */
+    unsigned int settle_samples;
+
+    /** Samples by which a scheduled change follows the last sample
+     *  measured. 0 selects ::BLADERF_RX_AGC_LEAD_DEFAULT. */
+    unsigned int lead_samples;
+};
+
+/**
+ * Enable, reconfigure, or disable the host-side AGC for an RX channel
+ *
+ * Enabling the AGC places the channel in manual gain mode
+ * (::BLADERF_GAIN_MGC). Disabling it leaves the channel at its last gain.
+ *
+ * @param       dev     Device handle
+ * @param[in]   ch      RX channel
+ * @param[in]   config  Configuration, or NULL to disable the AGC
+ *
+ * @return 0 on success, ::BLADERF_ERR_INVAL for a TX channel or an invalid
+ *         configuration, or a value from \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_rx_agc(struct bladerf *dev,
+                                 bladerf_channel ch,
+                                 const struct bladerf_rx_agc_config *config);
+
+/** @} (End of FN_RX_AGC) */
+
+/** @} (End of FN_CHANNEL) */
+
+/**
+ * @defgroup STREAMING Streaming
+ *
+ * This section defines the streaming APIs.
+ *
+ * @{
+ */
+
+/** printf format for timestamps in unsigned decimal */
+#define BLADERF_PRIuTS PRIu64
+/** printf format for timestamps in hexadecimal */
+#define BLADERF_PRIxTS PRIx64
+/** scanf format for timestamps in unsigned decimal */
+#define BLADERF_SCNuTS SCNu64
+/** scanf format for timestamps in hexadecimal */
+#define BLADERF_SCNxTS SCNx64
+
+/**
+ * @defgroup STREAMING_FORMAT Formats
+ *
+ * This section defines the available sample formats and metadata flags.
+ *
+ * @{
+ */
+
+/**
+ * Sample format
+ */
+typedef enum {
+    /**
+     * Signed, Complex 16-bit Q11. This is the native format of the DAC data.
+     *
+     * Values in the range [-2048, 2048) are used to represent [-1.0, 1.0).
+     * Note that the lower bound here is inclusive, and the upper bound is
+     * exclusive. Ensure that provided samples stay within [-2048, 2047].
+     *
+     * Samples consist of interleaved IQ value pairs, with I being the first
+     * value in the pair. Each value in the pair is a right-aligned,
+     * little-endian int16_t. The FPGA ensures that these values are
+     * sign-extended.
+     *
+     * <pre>
+     *  .--------------.--------------.
+     *  | Bits 31...16 | Bits 15...0  |
+     *  +--------------+--------------+
+     *  |   Q[15..0]   |   I[15..0]   |
+     *  `--------------`--------------`
+     * </pre>
+     *
+     * When using this format the minimum required buffer size, in bytes, is:
+     *
+     * \f$
+     *  buffer\_size\_min = (2 \times num\_samples \times num\_channels \times
+     *                      sizeof(int16\_t))
+     * \f$
+     *
+     * For example, to hold 2048 samples for one channel, a buffer must be at
+     * least 8192 bytes large.
+     *
+     * When a multi-channel ::bladerf_channel_layout is selected, samples
+     * will be interleaved per channel. For example, with ::BLADERF_RX_X2
+     * or ::BLADERF_TX_X2 (x2 MIMO), the buffer is structured like:
+     *
+     * <pre>
+     *  .-------------.--------------.--------------.------------------.
+     *  | Byte offset | Bits 31...16 | Bits 15...0  |    Description   |
+     *  +-------------+--------------+--------------+------------------+
+     *  |    0x00     |     Q0[0]    |     I0[0]    |  Ch 0, sample 0  |
+     *  |    0x04     |     Q1[0]    |     I1[0]    |  Ch 1, sample 0  |
+     *  |    0x08     |     Q0[1]    |     I0[1]    |  Ch 0, sample 1  |
+     *  |    0x0c     |     Q1[1]    |     I1[1]    |  Ch 1, sample 1  |
+     *  |    ...      |      ...     |      ...     |        ...       |
+     *  |    0xxx     |     Q0[n]    |     I0[n]    |  Ch 0, sample n  |
+     *  |    0xxx     |     Q1[n]    |     I1[n]    |  Ch 1, sample n  |
+     *  `-------------`--------------`--------------`------------------`
+     * </pre>
+     *
+     * Per the `buffer_size_min` formula above, 2048 samples for two channels
+     * will generate 4096 total samples, and require at least 16384 bytes.
+     *
+     * Implementors may use the interleaved buffers directly, or may use
+     * bladerf_deinterleave_stream_buffer() / bladerf_interleave_stream_buffer()
+     * if contiguous blocks of samples are desired.
+     */
+    BLADERF_FORMAT_SC16_Q11,
+
+    /**
+     * This format is the same as the ::BLADERF_FORMAT_SC16_Q11 format, except
+     * the first 4 samples in every <i>block*</i> of samples are replaced with
+     * metadata organized as follows. All fields are little-endian byte order.
+     *
+     * <pre>
+     *  .-------------.------------.----------------------------------.
+     *  | Byte offset |   Type     | Description                      |
+     *  +-------------+------------+----------------------------------+
+     *  |    0x00     | uint16_t   | Reserved                         |
+     *  |    0x02     |  uint8_t   | Stream flags                     |
+     *  |    0x03     |  uint8_t   | Meta version ID                  |
+     *  |    0x04     | uint64_t   | 64-bit Timestamp                 |
+     *  |    0x0c     | uint32_t   | BLADERF_META_FLAG_* flags        |
+     *  |  0x10..end  |            | Payload                          |
+     *  `-------------`------------`----------------------------------`
+     * </pre>
+     *
+     * For IQ sample meta mode, the Meta version ID and Stream flags should
+     * currently be set to values 0x00 and 0x00, respectively.
+     *
+     * <i>*</i>The number of samples in a <i>block</i> is dependent upon
+     * the USB speed being used:
+     *  - USB 2.0 Hi-Speed: 256 samples
+     *  - USB 3.0 SuperSpeed: 512 samples
+     *
+     * When using the bladerf_sync_rx() and bladerf_sync_tx() functions, the
+     * above details are entirely transparent; the caller need not be concerned
+     * with these details. These functions take care of packing/unpacking the
+     * metadata into/from the underlying stream and convey this information
+     * through the ::bladerf_metadata structure.
+     *
+     * However, when using the \ref FN_STREAMING_ASYNC interface, the user is
+     * responsible for manually packing/unpacking the above metadata into/from
+     * their samples.
+     *
+     * @see STREAMING_FORMAT_METADATA
+     * @see The `src/streaming/metadata.h` header in the libbladeRF codebase.
+     */
+    BLADERF_FORMAT_SC16_Q11_META,
+
+    /**
+     * This format is for exchanging packets containing digital payloads with
+     * the FPGA. A packet is generall a digital payload, that the FPGA then
+     * processes to either modulate, demodulate, filter, etc.
+     *
+     * All fields are little-endian byte order.
+     *
+     * <pre>
+     *  .-------------.------------.----------------------------------.
+     *  | Byte offset |   Type     | Description                      |
+     *  +-------------+------------+----------------------------------+
+     *  |    0x00     | uint16_t   | Packet length (in 32bit DWORDs)  |
+     *  |    0x02     |  uint8_t   | Packet flags                     |
+     *  |    0x03     |  uint8_t   | Packet core ID                   |
+     *  |    0x04     | uint64_t   | 64-bit Timestamp                 |
+     *  |    0x0c     | uint32_t   | BLADERF_META_FLAG_* flags        |
+     *  |  0x10..end  |            | Payload                          |
+     *  `-------------`------------`----------------------------------`
+     * </pre>
+     *
+     * A target core (for example a modem) must be specified when calling the
+     * bladerf_sync_rx() and bladerf_sync_tx() functions.
+     *
+     * When in packet mode, lengths for all functions and data formats are
+     * expressed in number of 32-bit DWORDs. As an example, a 12 byte packet
+     * is considered to be 3 32-bit DWORDs long.
+     *
+     * This packet format does not send or receive raw IQ samples. The digital
+     * payloads contain configurations, and digital payloads that are specific
+     * to the digital core to which they are addressed. It is the FPGA core
+     * that should generate, interpret, and process the digital payloads.
+     *
+     * With the exception of packet lenghts, no difference should exist between
+     * USB 2.0 Hi-Speed or USB 3.0 SuperSpeed for packets for this streaming
+     * format.
+     *
+     * @see STREAMING_FORMAT_METADATA
+     * @see The `src/streaming/metadata.h` header in the libbladeRF codebase.
+     */
+    BLADERF_FORMAT_PACKET_META,
+
+    /**
+     * Complex single-precision floating point samples, interleaved I and Q.
+     * Each component is a `float`, scaled such that the SC16 Q11 range of
+     * [-2048, 2048) maps to [-1.0, 1.0).
+     *
+     * Samples are carried over the bus as ::BLADERF_FORMAT_SC16_Q11; the
+     * conversion is performed by the synchronous interface as samples are
+     * copied to or from the caller's buffer. Values outside of [-1.0, 1.0)
+     * are saturated on transmit.
+     *
+     * This format is only supported by the synchronous interface, and may
+     * not be used with the zero-copy acquire/release/commit functions.
+     * Buffer sizes given to bladerf_sync_config() refer to the on-the-wire
+     * SC16 Q11 samples.
+     */
+    BLADERF_FORMAT_CF32,
+
+    /**
+     * This format is the same as the ::BLADERF_FORMAT_CF32 format, except
+     * that timestamps and metadata are used as with the
+     * ::BLADERF_FORMAT_SC16_Q11_META format.
+     */
+    BLADERF_FORMAT_CF32_META,
+
+    /**
+     * Signed, Complex 8-bit Q7. This is the native format of the 8-bit
+     * sample mode: the FPGA discards the 4 least significant bits of each
+     * 12-bit value, halving the USB bandwidth required relative to
+     * ::BLADERF_FORMAT_SC16_Q11.
+     *
+     * Values in the range [-128, 127] are used to represent [-1.0, 1.0).
+     * Note that the lower bound here is inclusive, and the upper bound is
+     * exclusive. Ensure that provided samples stay within [-128, 127].
+     *
+     * Samples consist of interleaved IQ value pairs, with I being the first
+     * value in the pair. Each value in the pair is a int8_t. For each value,
+     * the data in the lower bits of the buffer contain the I data.
+     *
+     * Multiple channels may be interleaved, as with ::BLADERF_FORMAT_SC16_Q11.
+     *
+     * Buffer sizes given to bladerf_sync_config() must be a multiple of 2048
+     * samples, as each sample occupies 2 bytes.
+     *
+     * This format requires a bladeRF 2.0 micro, with FPGA v0.13.0 or later.
+     * The sample width applies to both directions, so RX and TX must both
+     * use 8-bit formats when both are configured.
+     */
+    BLADERF_FORMAT_SC8_Q7,
+
+    /**
+     * This format is the same as the ::BLADERF_FORMAT_SC8_Q7 format, except
+     * that timestamps and metadata are used as with the
+     * ::BLADERF_FORMAT_SC16_Q11_META format. Each message carries 1016
+     * samples (with SuperSpeed), rather than 508.
+     */
+    BLADERF_FORMAT_SC8_Q7_META,
+} bladerf_format;
+
+/**
+ * @defgroup STREAMING_FORMAT_METADATA Metadata structure and flags
+ *
+ * @{
+ */
+
+/*
+ * Metadata status bits
+ *
+ * These are used in conjunction with the bladerf_metadata structure's `status`
+ * field.
+ */
+
+/**
+ * A sample overrun has occurred.
+ *
+ * This indicates that either the host (more likely) or the FPGA is not keeping
+ * up with the incoming samples.
+ */
+#define BLADERF_META_STATUS_OVERRUN (1 << 0)
+
+/**
+ * A sample underrun has occurred.
+ *
+ * This generally only occurs on the TX channel when the FPGA is starved of
+ * samples.
+ *
+ * @note libbladeRF does not report this status. It is here for future use.
+ */
+#define BLADERF_META_STATUS_UNDERRUN (1 << 1)
+
+/**
+ * The sample rate changed, via bladerf_switch_sample_rate(), before the first
+ * sample returned by this call.
+ *
+ * The new rate is reported in the bladerf_metadata structure's `sample_rate`
+ * field. Timestamps remain monotonic across the change, but count samples at
+ * the new rate after it.
+ */
+#define BLADERF_META_STATUS_RATE_CHANGE (1 << 2)
+
+/**
+ * A gain change made by the host-side AGC took effect within the samples
+ * returned by this call. See \ref FN_RX_AGC.
+ */
+#define BLADERF_META_STATUS_GAIN_CHANGE (1 << 3)
+
+/*
+ * Metadata flags
+ *
+ * These are used in conjunction with the bladerf_metadata structure's `flags`
+ * field.
+ */
+
+/**
+ * Mark the associated buffer as the start of a burst transmission.
+ *
+ * @note This is only used for the bladerf_sync_tx() call.
+ *
+ * When using this flag, the bladerf_metadata::timestamp field should contain
+ * the timestamp at which samples should be sent.
+ *
+ * Between specifying the ::BLADERF_META_FLAG_TX_BURST_START and
+ * ::BLADERF_META_FLAG_TX_BURST_END flags, there is no need for the user to the
+ * bladerf_metadata::timestamp field because the library will ensure the
+ * correct value is used, based upon the timestamp initially provided and
+ * the number of samples that have been sent.
+ */
+#define BLADERF_META_FLAG_TX_BURST_START (1 << 0)
+
+/**
+ * Mark the associated buffer as the end of a burst transmission. This will
+ * flush the remainder of the sync interface's current working buffer and
+ * enqueue samples into the hardware's transmit FIFO.
+ *
+ * As of libbladeRF v1.3.0, it is no longer necessary for the API user to ensure
+ * that the final 3 samples of a burst are \f$0 + 0 j\f$. libbladeRF now ensures
+ * this hardware requirement is upheld.
+ *
+ * Specifying this flag and flushing the sync interface's working buffer implies
+ * that the next timestamp that can be transmitted is the current timestamp plus
+ * the duration of the burst that this flag is ending <b>and</b> the remaining
+ * length of the remaining buffer that is flushed. (The buffer size, in this
+ * case, is the `buffer_size` value passed to the previous bladerf_sync_config()
+ * call.)
+ *
+ * Rather than attempting to keep track of the number of samples sent with
+ * respect to buffer sizes, it is easiest to always assume 1 buffer's worth of
+ * time is required between bursts. In this case "buffer" refers to the
+ * `buffer_size` parameter provided to bladerf_sync_config().) If this is too
+ * much time, consider using the ::BLADERF_META_FLAG_TX_UPDATE_TIMESTAMP
+ * flag.
+ *
+ * @note This is only used for the bladerf_sync_tx() call. It is ignored by the
+ *       bladerf_sync_rx() call.
+ */
+#define BLADERF_META_FLAG_TX_BURST_END (1 << 1)
+
+/**
+ * Use this flag in conjunction with ::BLADERF_META_FLAG_TX_BURST_START to
+ * indicate that the burst should be transmitted as soon as possible, as opposed
+ * to waiting for a specific timestamp.
+ *
+ * When this flag is used, there is no need to set the
+ * bladerf_metadata::timestamp field.
+ */
+#define BLADERF_META_FLAG_TX_NOW (1 << 2)
+
+/**
+ * Use this flag within a burst (i.e., between the use of
+ * ::BLADERF_META_FLAG_TX_BURST_START and ::BLADERF_META_FLAG_TX_BURST_END) to
+ * specify that bladerf_sync_tx() should read the bladerf_metadata::timestamp
+ * field and zero-pad samples up to the specified timestamp. The provided
+ * samples will then be transmitted at that timestamp.
+ *
+ * Use this flag when potentially flushing an entire buffer via the
+ * ::BLADERF_META_FLAG_TX_BURST_END would yield an unacceptably large gap in the
+ * transmitted samples.
+ *
+ * In some applications where a transmitter is constantly transmitting with
+ * extremely small gaps (less than a buffer), users may end up using a single
+ * ::BLADERF_META_FLAG_TX_BURST_START, and then numerous calls to
+ * bladerf_sync_tx() with the ::BLADERF_META_FLAG_TX_UPDATE_TIMESTAMP flag set.
+ * The ::BLADERF_META_FLAG_TX_BURST_END would only be used to end the stream
+ * when shutting down.
+ */
+#define BLADERF_META_FLAG_TX_UPDATE_TIMESTAMP (1 << 3)
+
+/**
+ * Use this flag in conjunction with ::BLADERF_META_FLAG_TX_BURST_END to pack
+ * the following burst into the same working buffer, rather than flushing
+ * the remainder of the buffer with zeros.
+ *
+ * The burst is ended by zero-padding only the remainder of the current
+ * message (plus one more message, if needed to end the burst with 3 zero
+ * samples). The next burst starts in the following message, with its own
+ * timestamp, and the FPGA holds the DAC at \f$0 + 0 j\f$ until then. Many
+ * short bursts can therefore share a single transfer, and the next burst may
+ * be scheduled as soon as the end of the current message, rather than the
+ * end of the buffer.
+ *
+ * The working buffer is only submitted once it fills, so the final burst of
+ * a sequence must be ended without this flag, to flush it out. Because bursts
+ * wait in the working buffer until it is submitted, they must be scheduled
+ * far enough in advance to account for this.
+ *
+ * @note This is only used for the bladerf_sync_tx() call, and is ignored
+ *       unless ::BLADERF_META_FLAG_TX_BURST_END is also specified.
+ */
+#define BLADERF_META_FLAG_TX_COALESCE (1 << 4)
+
+/**
+ * This flag indicates that calls to bladerf_sync_rx should return any available
+ * samples, rather than wait until the timestamp indicated in the
+ * bladerf_metadata timestamp field.
+ */
+#define BLADERF_META_FLAG_RX_NOW (1 << 31)
+
+/**
+ * Resynchronize to the stream, rather than fail, when the samples at the
+ * requested timestamp have been lost to an overrun.
+ *
+ * Without this flag, bladerf_sync_rx() fails with ::BLADERF_ERR_TIME_PAST
+ * when the metadata timestamp is older than the oldest sample still
+ * available. Applications commonly respond by disabling and re-enabling the
+ * RX channel, which costs a stream restart.
+ *
+ * With this flag, samples are instead returned from the oldest available
+ * timestamp. The ::BLADERF_META_STATUS_OVERRUN status is set, the
+ * bladerf_metadata::timestamp field is updated to the timestamp of the first
+ * returned sample, and bladerf_metadata::gap reports the number of samples
+ * that were skipped. The stream is left running throughout.
+ */
+#define BLADERF_META_FLAG_RX_RESYNC (1 << 30)
+
+/**
+ * This flag is asserted in bladerf_metadata.status by the hardware when an
+ * underflow is detected in the sample buffering system on the device.
+ */
+#define BLADERF_META_FLAG_RX_HW_UNDERFLOW (1 << 0)
+
+/**
+ * This flag is asserted in bladerf_metadata.status when a
+ * ::BLADERF_FORMAT_PACKET_META packet holds the first samples of a burst
+ * detected by the RX burst gate. See \ref FN_RX_BURST_GATE.
+ */
+#define BLADERF_META_FLAG_RX_HW_BURST_START (1 << 8)
+
+/**
+ * This flag is asserted in bladerf_metadata.status when a
+ * ::BLADERF_FORMAT_PACKET_META packet holds the last samples of a burst
+ * detected by the RX burst gate. See \ref FN_RX_BURST_GATE.
+ */
+#define BLADERF_META_FLAG_RX_HW_BURST_END (1 << 9)
+
+/**
+ * This flag is asserted in bladerf_metadata.status by the hardware if mini
+ * expansion IO pin 1 is asserted.
+ */
+#define BLADERF_META_FLAG_RX_HW_MINIEXP1 (1 << 16)
+
+/**
+ * This flag is asserted in bladerf_metadata.status by the hardware if mini
+ * expansion IO pin 2 is asserted.
+ */
+#define BLADERF_META_FLAG_RX_HW_MINIEXP2 (1 << 17)
+
+/**
+ * Sample metadata
+ *
+ * This structure is used in conjunction with the ::BLADERF_FORMAT_SC16_Q11_META
+ * format to TX scheduled bursts or retrieve timestamp information about
+ * received samples.
+ */
+struct bladerf_metadata {
+    /**
+     * Free-running FPGA counter that monotonically increases at the sample rate
+     * of the associated channel.
+     */
+    bladerf_timestamp timestamp;
+
+    /**
+     * Input bit field to control the behavior of the call that the metadata
+     * structure is passed to. API calls read this field from the provided data
+     * structure, and do not modify it.
+     *
+     * Valid flags include
+     *  ::BLADERF_META_FLAG_TX_BURST_START,
+     *  ::BLADERF_META_FLAG_TX_BURST_END,
+     *  ::BLADERF_META_FLAG_TX_NOW,
+     *  ::BLADERF_META_FLAG_TX_UPDATE_TIMESTAMP,
+     *  ::BLADERF_META_FLAG_TX_COALESCE,
+     *  ::BLADERF_META_FLAG_RX_NOW, and
+     *  ::BLADERF_META_FLAG_RX_RESYNC
+     */
+    uint32_t flags;
+
+    /**
+     * Output bit field to denoting the status of transmissions/receptions. API
+     * calls will write this field.
+     *
+     * Possible status flags include ::BLADERF_META_STATUS_OVERRUN,
+     * ::BLADERF_META_STATUS_UNDERRUN and ::BLADERF_META_STATUS_RATE_CHANGE.
+     */
+    uint32_t status;
+
+    /**
+     * This output parameter is updated to reflect the actual number of
+     * contiguous samples that have been populated in an RX buffer during a
+     * bladerf_sync_rx() call.
+     *
+     * This will not be equal to the requested count in the event of a
+     * discontinuity (i.e., when the status field has the
+     * ::BLADERF_META_STATUS_OVERRUN flag set). When an overrun occurs, it is
+     * important not to read past the number of samples specified by this value,
+     * as the remaining contents of the buffer are undefined.
+     *
+     * @note This parameter is not currently used by bladerf_sync_tx().
+     */
+    unsigned int actual_count;
+
+    /**
+     * RX only: Number of samples lost between the last sample returned by the
+     * previous call and the first sample returned by this one. This is
+     * derived from the timestamps in the sample stream, so it is only
+     * reported with ::BLADERF_FORMAT_SC16_Q11_META and
+     * ::BLADERF_FORMAT_SC8_Q7_META, and is otherwise 0.
+     *
+     * When a call ends early due to a discontinuity (i.e., with
+     * ::BLADERF_META_STATUS_OVERRUN set), the gap is reported by the call
+     * that returns the samples following it. With
+     * ::BLADERF_META_FLAG_RX_RESYNC, this is the number of samples between
+     * the requested timestamp and the returned one.
+     */
+    uint64_t gap;
+
+    /**
+     * RX only: The new sample rate, when ::BLADERF_META_STATUS_RATE_CHANGE is
+     * set in the status field. Otherwise, this is 0.
+     */
+    bladerf_sample_rate sample_rate;
+
+    /**
+     * RX only: With the host-side AGC enabled (see \ref FN_RX_AGC), the gain
+     * in effect for the first sample returned, in dB, indexed by the
+     * position of a channel's samples within the stream. Otherwise, this is
+     * 0.
+     */
+    bladerf_gain rx_gain[2];
+
+    /**
+     * Reserved for future use. This is not used by any functions. It is
+     * recommended that users zero out this field.
+     */
+    uint8_t reserved[12];
+};
+
+/** @} (End of STREAMING_FORMAT_METADATA) */
+
+/**
+ * Interleaves contiguous blocks of samples in preparation for MIMO TX.
+ *
+ * Given a `buffer` loaded with data as such:
+ *
+ * <pre>
+ *  .-------------------.--------------.--------------.------------------.
+ *  |    Byte offset    | Bits 31...16 | Bits 15...0  |    Description   |
+ *  +-------------------+--------------+--------------+------------------+
+ *  |  0x00 + 0*chsize  |     Q0[0]    |     I0[0]    |  Ch 0, sample 0  |
+ *  |  0x04 + 0*chsize  |     Q0[1]    |     I0[1]    |  Ch 0, sample 1  |
+ *  |  0x08 + 0*chsize  |     Q0[2]    |     I0[2]    |  Ch 0, sample 2  |
+ *  |  0x0c + 0*chsize  |     Q0[3]    |     I0[3]    |  Ch 0, sample 3  |
+ *  |        ...        |      ...     |      ...     |        ...       |
+ *  |  0x00 + 1*chsize  |     Q1[0]    |     I1[0]    |  Ch 1, sample 0  |
+ *  |  0x04 + 1*chsize  |     Q1[1]    |     I1[1]    |  Ch 1, sample 1  |
+ *  |  0x08 + 1*chsize  |     Q1[2]    |     I1[2]    |  Ch 1, sample 2  |
+ *  |  0x0c + 1*chsize  |     Q1[3]    |     I1[3]    |  Ch 1, sample 3  |
+ *  |        ...        |      ...     |      ...     |        ...       |
+ *  `-------------------`--------------`--------------`------------------`
+ * </pre>
+ *
+ * where \f$chsize = \frac{sizeof(buffer)}{num\_channels}\f$.
+ *
+ * This function interleaves the samples in the manner described by the
+ * ::BLADERF_FORMAT_SC16_Q11 format, in place. Each channel must have
+ * \f$buffer\_size / num\_channels\f$ samples, and they must be concatenated in
+ * order.
+ *
+ * If the ::BLADERF_FORMAT_SC16_Q11_META format is specified, the first 16 bytes
+ * will skipped.
+ *
+ * This function's inverse is bladerf_deinterleave_stream_buffer().
+ *
+ * @param[in]   layout        Stream direction and layout
+ * @param[in]   format        Data format to use
+ * @param[in]   buffer_size   The size of the buffer, in samples. Note that this
+ *                            is the entire buffer, not just a single channel.
+ * @param       samples       Buffer to process. The user is responsible for
+ *                            ensuring this buffer contains exactly
+ *                            `buffer_size` samples.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_interleave_stream_buffer(bladerf_channel_layout layout,
+                                               bladerf_format format,
+                                               unsigned int buffer_size,
+                                               void *samples);
+
+/**
+ * Deinterleaves samples into contiguous blocks after MIMO RX.
+ *
+ * This function deinterleaves a multi-channel interleaved buffer, as described
+ * by the ::BLADERF_FORMAT_SC16_Q11 format. The output is in the format
+ * described as the input to this function's inverse,
+ * bladerf_interleave_stream_buffer().
+ *
+ * If the ::BLADERF_FORMAT_SC16_Q11_META format is specified, the first 16 bytes
+ * will skipped.
+ *
+ * @param[in]   layout          Stream direction and layout
+ * @param[in]   format          Data format to use
+ * @param[in]   buffer_size     The size of the buffer, in samples. Note that
+ *                              this is the entire buffer, not just a single
+ *                              channel.
+ * @param       samples         Buffer to process. The user is responsible for
+ *                              ensuring this buffer contains exactly
+ *                              `buffer_size` samples.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_deinterleave_stream_buffer(bladerf_channel_layout layout,
+                                                 bladerf_format format,
+                                                 unsigned int buffer_size,
+                                                 void *samples);
+
+/**
+ * Convert samples between formats, using the same vectorized routines as
+ * the synchronous interface.
+ *
+ * The ::BLADERF_FORMAT_SC16_Q11, ::BLADERF_FORMAT_CF32 and
+ * ::BLADERF_FORMAT_SC8_Q7 formats are supported, in any combination.
+ * Conversions to ::BLADERF_FORMAT_SC8_Q7 discard the 4 least significant
+ * bits of each SC16 Q11 value, as the 8-bit sample mode does, and
+ * conversions from ::BLADERF_FORMAT_CF32 saturate as described for that
+ * format.
+ *
+ * As samples are treated independently, interleaved multi-channel buffers
+ * may be converted as-is. This does not require a device handle.
+ *
+ * @param[in]   in_format   Format of `in`
+ * @param[in]   in          Samples to convert
+ * @param[in]   out_format  Format of `out`
+ * @param[out]  out         Converted samples. This may not overlap `in`,
+ *                          unless the formats are the same.
+ * @param[in]   num_samples Number of samples (I, Q pairs) to convert
+ *
+ * @return 0 on success, ::BLADERF_ERR_INVAL if a format is not supported
+ */
+API_EXPORT
+int CALL_CONV bladerf_convert_samples(bladerf_format in_format,
+                                      const void *in,
+                                      bladerf_format out_format,
+                                      void *out,
+                                      size_t num_samples);
+
+/** @} (End of STREAMING_FORMAT) */
+
+/**
+ * Enable or disable the RF front end of the specified direction.
+ *
+ * RF front ends must always be enabled prior to streaming samples on the
+ * associated interface.
+ *
+ * When a synchronous stream is associated with the specified channel, this will
+ * shut down the underlying asynchronous stream when `enable` = false.
+ *
+ * When transmitting samples, be sure to provide ample time for TX samples reach
+ * the RF front-end before calling this function with `enable` = false. (This
+ * can be achieved easily when using metadata, as shown on
+ * \link sync_tx_meta_bursts.html this page\endlink.)
+ *
+ * @param       dev     Device handle
+ * @param[in]   ch      Channel
+ * @param[in]   enable  true to enable, false to disable
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_enable_module(struct bladerf *dev,
+                                    bladerf_channel ch,
+                                    bool enable);
+
+/**
+ * Place a channel's RF front end in warm standby.
+ *
+ * In warm standby, the channel's synthesizer is kept locked and its RF chain
+ * powered and biased, while its data path is stopped and, for TX, its output
+ * is muted. A subsequent call to bladerf_enable_module() with `enable` = true
+ * then only needs to restart the data path, avoiding the PLL relock and
+ * calibration time of a full power-up. This is intended for bursty links
+ * with short idle periods. Calling bladerf_enable_module() with `enable` =
+ * false powers the channel down as usual.
+ *
+ * A channel may be placed in standby whether or not it is enabled. Any
+ * synchronous stream on the channel is kept configured; RX calls will time
+ * out until it is re-enabled.
+ *
+ * Standby draws more power than a disabled channel. On the bladeRF 2.0
+ * micro, the board's power draw may be read with bladerf_get_pmic_register()
+ * and ::BLADERF_PMIC_POWER; it is also logged at the debug level on each
+ * transition into standby.
+ *
+ * @param       dev     Device handle
+ * @param[in]   ch      Channel
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_standby_module(struct bladerf *dev, bladerf_channel ch);
+
+/**
+ * Retrieve the specified stream's current timestamp counter value from the
+ * FPGA.
+ *
+ * This function is only intended to be used to retrieve a coarse estimate of
+ * the current timestamp when starting up a stream. It <b>should not</b> be used
+ * as a means to accurately retrieve the current timestamp of individual samples
+ * within a running stream. The reasons for this are:
+ *  - The timestamp counter will have advanced during the time that the captured
+ *      value is propagated back from the FPGA to the host
+ *  - The value retrieved in this manner is not tightly-coupled with
+ *      specific sample positions in the stream.
+ *
+ * When actively receiving a sample stream, instead use the
+ * ::bladerf_metadata::timestamp field (provided when using the
+ * ::BLADERF_FORMAT_SC16_Q11_META format) to retrieve the timestamp value
+ * associated with a block of samples. See the \link sync_rx_meta.html RX with
+ * metadata\endlink page for examples of this.
+ *
+ * An example use-case of this function is to schedule an initial TX burst in a
+ * set of bursts:
+ *
+ *  - Configure and start a TX stream using the ::BLADERF_FORMAT_SC16_Q11_META
+ *      format.
+ *  - Retrieve timestamp \f$T\f$, a coarse estimate the TX's current timestamp
+ *      via this function.
+ *  - Schedule the first burst, \f$F\f$ to occur in the future: \f$F = T + N\f$.
+ *      Generally, adding \f$N\f$ in tens to low hundreds of milliseconds is
+ *      sufficient to account for timestamp retrieval overhead and stream
+ *      startup.
+ *  - Schedule additional bursts relative to the first burst \f$F\f$.
+ *
+ * Examples of the above are shown on the \link sync_tx_meta_bursts.html TX
+ * with metadata\endlink page.
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Stream direction
+ * @param[out]  timestamp   Coarse timestamp value
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_timestamp(struct bladerf *dev,
+                                    bladerf_direction dir,
+                                    bladerf_timestamp *timestamp);
+
+/**
+ * Scheduling attributes for the thread servicing a stream
+ *
+ * @see bladerf_set_stream_thread_attrs()
+ */
+struct bladerf_stream_thread_attrs {
+    /**
+     * Bitmask of CPUs the thread may run on, where bit `n` corresponds to
+     * CPU `n`. A value of 0 leaves the thread's affinity unchanged.
+     */
+    uint64_t cpu_mask;
+
+    /**
+     * Real-time priority to request for the thread, or 0 to leave the
+     * thread's scheduling policy unchanged.
+     *
+     * On Linux, FreeBSD and OSX, a non-zero value selects `SCHED_FIFO` with
+     * this priority, clamped to the range supported by the system. On
+     * Windows, any non-zero value selects `THREAD_PRIORITY_TIME_CRITICAL`.
+     */
+    int priority;
+};
+
+/**
+ * Set the scheduling attributes applied to the thread that services streams
+ * of the specified direction.
+ *
+ * For the synchronous interface, this is the worker thread created by
+ * bladerf_sync_config(). For the asynchronous interface, this is the thread
+ * that calls bladerf_stream(); its previous attributes are restored when
+ * bladerf_stream() returns. In both cases, this is also the thread driving
+ * the USB backend's event handling.
+ *
+ * The attributes take effect for streams initialized after this call. Note
+ * that requesting a real-time priority typically requires elevated
+ * privileges (e.g., `CAP_SYS_NICE` or an `rtprio` limit on Linux). If the
+ * attributes cannot be applied when the stream starts, a warning is logged
+ * and the stream continues with its current scheduling.
+ *
+ * @param       dev     Device handle
+ * @param[in]   dir     Stream direction
+ * @param[in]   attrs   Attributes to apply. NULL restores the default
+ *                      behavior of leaving the thread unchanged.
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_UNSUPPORTED if a CPU affinity is requested on a
+ *         platform that does not support it,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_stream_thread_attrs(
+    struct bladerf *dev,
+    bladerf_direction dir,
+    const struct bladerf_stream_thread_attrs *attrs);
+
+/**
+ * @defgroup STREAM_MEM_FLAGS Stream buffer allocation flags
+ *
+ * These flags select how stream buffers are allocated. They may be combined,
+ * and each is a request: when one cannot be honored, allocation falls back
+ * to the next option, ultimately to ordinary heap memory.
+ *
+ * @see bladerf_set_stream_mem_flags()
+ *
+ * @{
+ */
+
+/** Allocate buffers from page-aligned, mapped memory */
+#define BLADERF_STREAM_MEM_PAGE_ALIGNED (1 << 0)
+
+/**
+ * Back buffers with huge pages, to reduce TLB pressure at high sample rates.
+ * On Linux, explicit huge pages (`MAP_HUGETLB`) are tried before
+ * transparent huge pages. On Windows, large pages require the "Lock pages
+ * in memory" privilege. Implies ::BLADERF_STREAM_MEM_PAGE_ALIGNED.
+ */
+#define BLADERF_STREAM_MEM_HUGEPAGES (1 << 1)
+
+/**
+ * (Linux only) Prefer the NUMA node local to the USB host controller the
+ * device is attached to. Implies ::BLADERF_STREAM_MEM_PAGE_ALIGNED.
+ */
+#define BLADERF_STREAM_MEM_NUMA_LOCAL (1 << 2)
+
+/**
+ * Use memory that the backend can transfer without an intermediate kernel
+ * copy. With the libusb backend on Linux, this is usbfs-mapped memory from
+ * `libusb_dev_mem_alloc()`, which is limited by the `usbfs_memory_mb`
+ * module parameter. This takes precedence over the other flags.
+ */
+#define BLADERF_STREAM_MEM_DEVICE (1 << 3)
+
+/** @} (End of STREAM_MEM_FLAGS) */
+
+/**
+ * Select how buffers are allocated for streams subsequently initialized with
+ * bladerf_init_stream() or bladerf_sync_config().
+ *
+ * @param       dev     Device handle
+ * @param[in]   flags   Bitwise OR of \ref STREAM_MEM_FLAGS values, or 0 for
+ *                      ordinary heap memory (the default)
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if `flags` contains unknown bits,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_stream_mem_flags(struct bladerf *dev, uint32_t flags);
+
+/**
+ * Register application memory to back the buffers of streams subsequently
+ * initialized with bladerf_init_stream() or bladerf_sync_config()
+ *
+ * This allows samples to be transferred to and from memory the application
+ * has prepared for its own processing, such as pinned memory from
+ * `cudaHostAlloc()` that a GPU accesses directly, or a pre-registered
+ * packet buffer arena, without copying them through libbladeRF's buffers.
+ *
+ * A stream's buffers are laid out contiguously, in the order they are
+ * returned by bladerf_init_stream(), so a region must hold
+ * `num_buffers` times the size of one buffer, in bytes. Each stream takes
+ * the smallest unused region that is large enough, in preference to the
+ * memory selected by bladerf_set_stream_mem_flags(). When no region is large
+ * enough, that memory is used instead. A region is zeroed when a stream
+ * takes it, and returned to the registered set when the stream is
+ * deinitialized. Page-aligned regions are recommended.
+ *
+ * The libusb backend submits transfers directly from a stream's buffers, so
+ * only the copy the USB driver makes, if any, remains. The region remains
+ * owned by the application, and must remain valid until it has been
+ * unregistered or the device has been closed.
+ *
+ * @param       dev     Device handle
+ * @param[in]   mem     Start of the region
+ * @param[in]   len     Length of the region, in bytes
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if `mem` is NULL, `len` is 0, or the region
+ *         overlaps one already registered,
+ *         ::BLADERF_ERR_MEM if the maximum of 8 regions are already
+ *         registered
+ */
+API_EXPORT
+int CALL_CONV bladerf_register_stream_mem(struct bladerf *dev,
+                                          void *mem,
+                                          size_t len);
+
+/**
+ * Remove a region registered via bladerf_register_stream_mem()
+ *
+ * @param       dev     Device handle
+ * @param[in]   mem     Start of the region, as registered
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if the region is not registered, or still backs
+ *         a stream that has not been deinitialized
+ */
+API_EXPORT
+int CALL_CONV bladerf_unregister_stream_mem(struct bladerf *dev, void *mem);
+
+/**
+ * Allocator for the streaming interfaces' bookkeeping
+ *
+ * Applications with real-time constraints may install one to verify that
+ * streaming does not allocate once it has been configured, or to place its
+ * state in memory of their choosing.
+ *
+ * @see bladerf_set_allocator()
+ */
+struct bladerf_allocator {
+    /**
+     * Allocate `size` bytes, suitably aligned for any type. Return NULL on
+     * failure.
+     */
+    void *(*alloc)(size_t size, void *user_data);
+
+    /** Free memory returned by `alloc`. `ptr` is never NULL. */
+    void (*free)(void *ptr, void *user_data);
+
+    /** Passed to the callbacks as provided */
+    void *user_data;
+};
+
+/**
+ * Install an allocator for the memory libbladeRF allocates when streams are
+ * initialized with bladerf_init_stream() or bladerf_sync_config(). This
+ * covers the stream and sync interface state, the backend's per-stream
+ * state, and stream buffers taken from the heap, as per
+ * bladerf_set_stream_mem_flags().
+ *
+ * Once a stream has been configured, bladerf_sync_rx(), bladerf_sync_tx(),
+ * and the asynchronous stream's data path do not allocate. An allocator
+ * that counts calls may therefore be used to check that a steady-state
+ * stream is allocation-free.
+ *
+ * The allocator is global, and must only be changed while no device is
+ * open. The structure is copied, but the callbacks must remain usable until
+ * every device has been closed.
+ *
+ * @param[in]   allocator   Allocator, or NULL to restore the default of
+ *                          `malloc()` and `free()`
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if either callback is NULL
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_allocator(const struct bladerf_allocator *allocator);
+
+/**
+ * @defgroup FN_STREAMING_SYNC  Synchronous API
+ *
+ * This group of functions presents synchronous, blocking calls (with optional
+ * timeouts) for transmitting and receiving samples.
+ *
+ * The synchronous interface is built atop the asynchronous interface, and is
+ * generally less complex and easier to work with.  It alleviates the need to
+ * explicitly spawn threads (it is done under the hood) and manually manage
+ * sample buffers.
+ *
+ * Under the hood, this interface spawns worker threads to handle an
+ * asynchronous stream and perform thread-safe buffer management.
+ *
+ * These functions are thread-safe.
+ *
+ * The following pages provide additional information and example usage:
+ *
+ *  - \link sync_no_meta.html Basic usage without metadata\endlink
+ *  - \link sync_rx_meta.html Synchronous RX with metadata\endlink
+ *  - \link sync_tx_meta_bursts.html Synchronous TX with metadata\endlink
+ *
+ * @{
+ */
+
+/**
+ * Pass as the `num_buffers`, `buffer_size`, and `num_transfers` parameters
+ * of bladerf_sync_config() to have them derived automatically.
+ */
+#define BLADERF_SYNC_CONFIG_AUTO 0
+
+/**
+ * (Re)Configure a device for synchronous transmission or reception
+ *
+ * This function sets up the device for the specified format and initializes
+ * the underlying asynchronous stream parameters
+ *
+ * This function does not call bladerf_enable_module(). The API user is
+ * responsible for enabling/disable streams when desired.
+ *
+ * Note that (re)configuring the TX direction does not affect the RX direction,
+ * and vice versa. This call configures each direction independently.
+ *
+ * Memory allocated by this function will be deallocated when bladerf_close()
+ * is called.
+ *
+ * @see The bladerf_init_stream() documentation for information on determining
+ *      appropriate values for `buffers_size`, `num_transfers`, and
+ *      `stream_timeout`.
+ *
+ * @note The `num_buffers` parameter should generally be increased as the amount
+ *       of work done between bladerf_sync_rx() or bladerf_sync_tx() calls
+ *       increases.
+ *
+ * If `num_buffers`, `buffer_size`, and `num_transfers` are all
+ * ::BLADERF_SYNC_CONFIG_AUTO, they are derived from the current sample rate,
+ * the channel layout, the USB speed, and the target latency set via
+ * bladerf_set_sync_auto_latency(), unless specific values have been set via
+ * bladerf_set_sync_auto_sizing(). When the sample rate is later changed, they
+ * are derived again and applied, provided that the stream is not yet running.
+ * This is not supported for ::BLADERF_FORMAT_PACKET_META.
+ *
+ * @param       dev             Device to configure
+ * @param[in]   layout          Stream direction and layout
+ * @param[in]   format          Format to use in synchronous data transfers
+ * @param[in]   num_buffers     The number of buffers to use in the underlying
+ *                              data stream. This must be greater than the
+ *                              `num_xfers` parameter.
+ * @param[in]   buffer_size     The size of the underlying stream buffers, in
+ *                              samples. This value must be a multiple of 1024,
+ *                              or of one USB message under the low-latency
+ *                              profile (see bladerf_set_sync_low_latency()).
+ *                              Note that samples are only transferred when a
+ *                              buffer of this size is filled.
+ * @param[in]   num_transfers   The number of active USB transfers that may be
+ *                              in-flight at any given time. If unsure of what
+ *                              to use here, try values of 4, 8, or 16.
+ * @param[in]   stream_timeout  Timeout (milliseconds) for transfers in the
+ *                              underlying data stream.
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_UNSUPPORTED if libbladeRF is not built with support
+ *         for this functionality,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_config(struct bladerf *dev,
+                                  bladerf_channel_layout layout,
+                                  bladerf_format format,
+                                  unsigned int num_buffers,
+                                  unsigned int buffer_size,
+                                  unsigned int num_transfers,
+                                  unsigned int stream_timeout);
+
+/**
+ * Set the target latency used when automatically sizing a synchronous stream
+ *
+ * This is the approximate time spanned by the samples in the transfers that
+ * are in flight. Lower values reduce latency, at the expense of robustness
+ * against overruns and underruns. The number of transfers and size of the
+ * buffers are bounded, so very low targets may not be met at low sample rates.
+ *
+ * If the direction is currently configured with ::BLADERF_SYNC_CONFIG_AUTO and
+ * its stream is not running, it is resized immediately.
+ *
+ * @see bladerf_sync_config()
+ *
+ * @param       dev             Device handle
+ * @param[in]   dir             Stream direction
+ * @param[in]   latency_us      Target latency, in microseconds. 0 selects the
+ *                              default of 10 ms, which favors robustness.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_sync_auto_latency(struct bladerf *dev,
+                                            bladerf_direction dir,
+                                            unsigned int latency_us);
+
+/**
+ * Set the stream sizing used in place of ::BLADERF_SYNC_CONFIG_AUTO
+ *
+ * When set, a synchronous stream configured with ::BLADERF_SYNC_CONFIG_AUTO
+ * uses these values instead of deriving them from the target latency. This
+ * allows a sizing measured on a particular host, such as that recommended by
+ * the bladeRF-cli `tune_host` command, to be applied to applications that
+ * leave the sizing to libbladeRF. It is usually set in the configuration file
+ * (see \ref configfile), via the `sync_sizing_rx` and `sync_sizing_tx`
+ * options.
+ *
+ * The values are used as given, regardless of the sample rate. They are
+ * validated by bladerf_sync_config(), which requires a `buffer_size` that is
+ * a multiple of 1024 samples unless the low-latency profile is enabled (see
+ * bladerf_set_sync_low_latency()).
+ *
+ * If the direction is currently configured with ::BLADERF_SYNC_CONFIG_AUTO and
+ * its stream is not running, it is resized immediately. Setting all three
+ * values to 0 restores the derivation of the sizing from the target latency.
+ *
+ * @param       dev             Device handle
+ * @param[in]   dir             Stream direction
+ * @param[in]   num_buffers     Number of buffers. This must be greater than
+ *                              `num_transfers`.
+ * @param[in]   buffer_size     Samples per buffer
+ * @param[in]   num_transfers   Number of transfers in flight
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_sync_auto_sizing(struct bladerf *dev,
+                                           bladerf_direction dir,
+                                           unsigned int num_buffers,
+                                           unsigned int buffer_size,
+                                           unsigned int num_transfers);
+
+/**
+ * Enable or disable the low-latency profile of the synchronous interface
+ *
+ * By default, the synchronous interface's buffers must be a multiple of 1024
+ * samples. Under the low-latency profile, they need only be a multiple of one
+ * USB message, which is the FX3's DMA buffer size: 2048 bytes at SuperSpeed
+ * and 1024 bytes at Hi-Speed (512 and 256 SC16 Q11 samples, respectively).
+ * Many such short transfers may then be kept in flight, such that samples are
+ * handed off shortly after they are captured, without increasing the risk of
+ * overruns.
+ *
+ * For the metadata formats, each buffer then holds as few as one message, and
+ * so one timestamp.
+ *
+ * Short transfers incur more per-transfer overhead on the host. This suits
+ * modest sample rates, or hosts that can dedicate a core to the stream (see
+ * bladerf_set_stream_thread_attrs()).
+ *
+ * This takes effect the next time bladerf_sync_config() is called for `dir`.
+ * If `dir` is configured with ::BLADERF_SYNC_CONFIG_AUTO and its stream is not
+ * running, it is resized immediately, using single-message buffers and up to
+ * 64 transfers.
+ *
+ * The resulting latency may be monitored via bladerf_get_sync_latency().
+ *
+ * @param       dev             Device handle
+ * @param[in]   dir             Stream direction
+ * @param[in]   enable          Set `true` to enable the low-latency profile
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_sync_low_latency(struct bladerf *dev,
+                                           bladerf_direction dir,
+                                           bool enable);
+
+/**
+ * Handle that may be waited upon with the platform's readiness facilities:
+ * a file descriptor for poll(), select() or epoll on POSIX systems, and an
+ * event HANDLE for WaitForMultipleObjects() on Windows.
+ */
+#if defined _WIN32 || defined __CYGWIN__
+typedef void *bladerf_poll_handle;
+#else
+typedef int bladerf_poll_handle;
+#endif
+
+/**
+ * Get a handle indicating the readiness of the synchronous interface
+ *
+ * For ::BLADERF_RX, the handle is readable (signaled, on Windows) while at
+ * least one buffer's worth of received samples is available. For
+ * ::BLADERF_TX, it is readable while space for at least one buffer's worth
+ * of samples is available. A buffer's worth of samples is the `buffer_size`
+ * provided to bladerf_sync_config().
+ *
+ * The handle is level-triggered, and is owned by the library: it must not be
+ * read from, written to, or closed. It remains valid until the next
+ * bladerf_sync_config() call for `dir`, or until the device is closed.
+ *
+ * The RX stream is started by the first receive call, so the RX handle only
+ * becomes readable once a call has been made. This is typically paired with
+ * bladerf_set_sync_nonblocking(), so that a single thread may service several
+ * streams.
+ *
+ * @pre A bladerf_sync_config() call has been made for `dir`
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Stream direction
+ * @param[out]  handle      Updated with the handle on success
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if per-channel RX queues,
+ *         RX taps, or the RX resampler are in use (see
+ *         bladerf_set_rx_channel_queues(), bladerf_set_rx_taps(), and
+ *         bladerf_set_rx_resampler()), or a value from \ref RETCODES list on
+ *         failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_sync_poll_handle(struct bladerf *dev,
+                                           bladerf_direction dir,
+                                           bladerf_poll_handle *handle);
+
+/**
+ * Enable or disable non-blocking operation of the synchronous interface
+ *
+ * In non-blocking mode, the receive and transmit calls for `dir` return
+ * ::BLADERF_ERR_WOULD_BLOCK, rather than waiting, when they cannot complete
+ * with the buffers presently available. Their `timeout_ms` is then unused.
+ * Whether a call would have to wait is determined before any samples are
+ * transferred, so a call that returns ::BLADERF_ERR_WOULD_BLOCK may simply
+ * be retried later with the same arguments. A request for more samples than
+ * all of the interface's buffers hold can never complete, and fails with
+ * ::BLADERF_ERR_INVAL.
+ *
+ * For ::BLADERF_FORMAT_SC16_Q11_META and ::BLADERF_FORMAT_SC8_Q7_META, a read
+ * at a future timestamp first discards the samples preceding it, and this
+ * may exhaust the available buffers. Samples that are available by then are
+ * returned, with `actual_count` updated accordingly. If there are none,
+ * ::BLADERF_ERR_WOULD_BLOCK is returned, and the discarding resumes upon the
+ * next call.
+ *
+ * Starting the underlying stream, upon the first call following
+ * bladerf_sync_config() or an error, may still block briefly.
+ *
+ * @see bladerf_get_sync_poll_handle()
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Stream direction
+ * @param[in]   enable      Set `true` to enable non-blocking operation
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_sync_nonblocking(struct bladerf *dev,
+                                           bladerf_direction dir,
+                                           bool enable);
+
+/**
+ * Start a synchronous interface's underlying stream ahead of the first
+ * bladerf_sync_rx() or bladerf_sync_tx() call
+ *
+ * The stream is otherwise started by the first call following
+ * bladerf_sync_config() or a stream error, which must then wait for the
+ * worker to start and, for RX, for the first transfers to be submitted and
+ * completed. Once started here, the first RX call returns samples as soon as
+ * a buffer has been filled.
+ *
+ * An RX stream receives samples from this point on. If they are not read
+ * promptly, the buffers fill and the stream overruns, as it would between any
+ * two bladerf_sync_rx() calls.
+ *
+ * The worker threads of the synchronous interfaces are retained when they are
+ * reconfigured, so a subsequent bladerf_sync_config() does not create a new
+ * thread.
+ *
+ * This is a no-op if the stream is already running.
+ *
+ * @pre A bladerf_sync_config() call has been made for `dir`, and the
+ *      direction's channels have been enabled via bladerf_enable_module().
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Stream direction
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if the synchronous interface has not been
+ *         configured for `dir`,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_start(struct bladerf *dev, bladerf_direction dir);
+
+/**
+ * Transmit IQ samples.
+ *
+ * Under the hood, this call starts up an underlying asynchronous stream as
+ * needed. This stream can be stopped by disabling the TX channel. (See
+ * bladerf_enable_module for more details.)
+ *
+ * Samples will only be sent to the FPGA when a buffer have been filled. The
+ * number of samples required to fill a buffer corresponds to the `buffer_size`
+ * parameter passed to bladerf_sync_config().
+ *
+ * @pre A bladerf_sync_config() call has been to configure the device for
+ *      synchronous data transfer.
+ *
+ * @note A call to bladerf_enable_module() should be made before attempting to
+ *       transmit samples. Failing to do this may result in timeouts and other
+ *       errors.
+ *
+ * @param       dev         Device handle
+ * @param[in]   samples     Array of samples
+ * @param[in]   num_samples Number of samples to write
+ * @param[in]   metadata    Sample metadata. This must be provided when using
+ *                          the ::BLADERF_FORMAT_SC16_Q11_META format, but may
+ *                          be NULL when the interface is configured for
+ *                          the ::BLADERF_FORMAT_SC16_Q11 format.
+ * @param[in]   timeout_ms  Timeout (milliseconds) for this call to complete.
+ *                          Zero implies "infinite."
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_UNSUPPORTED if libbladeRF is not built with support
+ *         for this functionality,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_tx(struct bladerf *dev,
+                              const void *samples,
+                              unsigned int num_samples,
+                              struct bladerf_metadata *metadata,
+                              unsigned int timeout_ms);
+
+/**
+ * Obtain a buffer to fill with IQ samples for transmission, without an
+ * intermediate copy.
+ *
+ * Rather than copying samples from a caller-provided buffer, this function
+ * provides a pointer to the next available internal buffer, into which the
+ * caller writes samples directly. The region must be handed back via
+ * bladerf_sync_tx_commit().
+ *
+ * The region provided is determined by the configured format:
+ *  - ::BLADERF_FORMAT_SC16_Q11: the unfilled remainder of the current buffer
+ *  - ::BLADERF_FORMAT_SC16_Q11_META: the entire buffer, in its raw message
+ *    layout. The caller is responsible for writing each message's
+ *    16-byte metadata header, and `num_samples` includes the space occupied
+ *    by these headers. Burst handling performed by bladerf_sync_tx() does not
+ *    apply to this buffer.
+ *  - ::BLADERF_FORMAT_PACKET_META: the payload area of the next packet. The
+ *    packet header is filled in by bladerf_sync_tx_commit().
+ *
+ * Only one region may be held at a time. bladerf_sync_tx() returns
+ * ::BLADERF_ERR_INVAL while a region is held.
+ *
+ * @pre A bladerf_sync_config() call has been made to configure the device for
+ *      synchronous data transfer.
+ *
+ * @note The provided pointer is invalidated by disabling the TX channel,
+ *       calling bladerf_sync_config() or closing the device.
+ *
+ * @param       dev         Device handle
+ * @param[out]  samples     Updated to point to the region to fill
+ * @param[out]  num_samples Updated with the capacity of the region, in samples
+ * @param[in]   timeout_ms  Timeout (milliseconds) for this call to complete.
+ *                          Zero implies "infinite."
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if a previously acquired region has not been
+ *         committed,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_tx_acquire(struct bladerf *dev,
+                                      void **samples,
+                                      unsigned int *num_samples,
+                                      unsigned int timeout_ms);
+
+/**
+ * Commit samples written to a region obtained via bladerf_sync_tx_acquire().
+ *
+ * The underlying buffer is submitted for transmission once it has been
+ * filled. For ::BLADERF_FORMAT_SC16_Q11, committing fewer samples than
+ * the region's capacity leaves the buffer pending, and the next call to
+ * bladerf_sync_tx_acquire() or bladerf_sync_tx() continues filling it.
+ * For ::BLADERF_FORMAT_SC16_Q11_META, the entire region must be committed.
+ * For ::BLADERF_FORMAT_PACKET_META, `num_samples` is the length of the packet.
+ *
+ * @param       dev         Device handle
+ * @param[in]   samples     Pointer previously returned by
+ *                          bladerf_sync_tx_acquire()
+ * @param[in]   num_samples Number of samples written to the region
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if `samples` does not refer to the currently
+ *         acquired region or `num_samples` is invalid,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_tx_commit(struct bladerf *dev,
+                                     const void *samples,
+                                     unsigned int num_samples);
+
+/**
+ * Receive IQ samples.
+ *
+ * Under the hood, this call starts up an underlying asynchronous stream as
+ * needed. This stream can be stopped by disabling the RX channel. (See
+ * bladerf_enable_module for more details.)
+ *
+ * @pre A bladerf_sync_config() call has been to configure the device for
+ *      synchronous data transfer.
+ *
+ * @note A call to bladerf_enable_module() should be made before attempting to
+ *       receive samples. Failing to do this may result in timeouts and other
+ *       errors.
+ *
+ * @param       dev         Device handle
+ * @param[out]  samples     Buffer to store samples in. The caller is
+ *                          responsible for ensuring this buffer is sufficiently
+ *                          large for the number of samples requested,
+ *                          considering the size of the sample format being
+ *                          used.
+ * @param[in]   num_samples Number of samples to read
+ * @param[out]  metadata    Sample metadata. This must be provided when using
+ *                          the ::BLADERF_FORMAT_SC16_Q11_META format, but may
+ *                          be NULL when the interface is configured for
+ *                          the ::BLADERF_FORMAT_SC16_Q11 format.
+ * @param[in]   timeout_ms  Timeout (milliseconds) for this call to complete.
+ *                          Zero implies "infinite."
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_UNSUPPORTED if libbladeRF is not built with support
+ *         for this functionality,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_rx(struct bladerf *dev,
+                              void *samples,
+                              unsigned int num_samples,
+                              struct bladerf_metadata *metadata,
+                              unsigned int timeout_ms);
+
+
+/**
+ * Receive IQ samples into separate per-channel buffers.
+ *
+ * This behaves like bladerf_sync_rx(), except that when the interface is
+ * configured for ::BLADERF_RX_X2, the samples are deinterleaved as they are
+ * copied out of the internal buffers. This avoids a separate
+ * bladerf_deinterleave_stream_buffer() pass over the received data.
+ *
+ * To obtain the contiguous per-channel block layout produced by
+ * bladerf_deinterleave_stream_buffer(), simply point `samples[1]` at
+ * `samples[0] + num_samples` (in units of samples).
+ *
+ * For ::BLADERF_RX_X1, only `samples[0]` is used and this function is
+ * equivalent to bladerf_sync_rx().
+ *
+ * @pre A bladerf_sync_config() call has been made to configure the device for
+ *      synchronous data transfer.
+ *
+ * @param       dev         Device handle
+ * @param[out]  samples     Array of per-channel buffers: one for
+ *                          ::BLADERF_RX_X1 and two for ::BLADERF_RX_X2. Each
+ *                          must be large enough to hold `num_samples` samples.
+ * @param[in]   num_samples Number of samples to read, per channel
+ * @param[out]  metadata    Sample metadata, as with bladerf_sync_rx(). Note
+ *                          that `actual_count` is reported per channel.
+ * @param[in]   timeout_ms  Timeout (milliseconds) for this call to complete.
+ *                          Zero implies "infinite."
+ *
+ * @return 0 on success,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_rx_planar(struct bladerf *dev,
+                                     void *const samples[],
+                                     unsigned int num_samples,
+                                     struct bladerf_metadata *metadata,
+                                     unsigned int timeout_ms);
+
+/**
+ * Enable or disable per-channel RX queues for ::BLADERF_RX_X2.
+ *
+ * When enabled, bladerf_sync_config() for ::BLADERF_RX_X2 creates a queue
+ * for each channel. A worker thread deinterleaves (and, for
+ * ::BLADERF_FORMAT_CF32, converts) the received samples once, into blocks of
+ * one buffer's worth of samples. Each channel is then received independently
+ * via bladerf_sync_rx_channel(), such that each may be serviced by its own
+ * thread.
+ *
+ * A block is reused only once both channels have consumed it, so both
+ * channels must be received from to keep the stream running. While the
+ * queues are in use, bladerf_sync_rx(), bladerf_sync_rx_planar(),
+ * bladerf_sync_rxv(), and bladerf_sync_rx_acquire() are not available.
+ *
+ * ::BLADERF_FORMAT_PACKET_META is not supported.
+ *
+ * This takes effect the next time bladerf_sync_config() is called for RX.
+ *
+ * @param       dev         Device handle
+ * @param[in]   enable      Set true to enable the per-channel queues
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_rx_channel_queues(struct bladerf *dev, bool enable);
+
+/**
+ * Receive IQ samples of a single channel from the per-channel RX queues.
+ *
+ * This behaves like bladerf_sync_rx() for a single channel of a
+ * ::BLADERF_RX_X2 stream. With metadata formats, the `timestamp` field is in
+ * units of per-channel samples, and a discontinuity ends the call early with
+ * ::BLADERF_META_STATUS_OVERRUN set, as with bladerf_sync_rx().
+ *
+ * Each channel may be received by a different thread, but only one thread
+ * may receive from a given channel at a time.
+ *
+ * @pre bladerf_set_rx_channel_queues() has enabled the per-channel queues,
+ *      and a bladerf_sync_config() call has been made for ::BLADERF_RX_X2.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          BLADERF_CHANNEL_RX(0) or BLADERF_CHANNEL_RX(1)
+ * @param[out]  samples     Buffer to store samples in, large enough to hold
+ *                          `num_samples` samples
+ * @param[in]   num_samples Number of samples to read
+ * @param[out]  metadata    Sample metadata, as with bladerf_sync_rx()
+ * @param[in]   timeout_ms  Timeout (milliseconds) for this call to complete.
+ *                          Zero implies "infinite."
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if the per-channel queues are not in use,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_rx_channel(struct bladerf *dev,
+                                      bladerf_channel ch,
+                                      void *samples,
+                                      unsigned int num_samples,
+                                      struct bladerf_metadata *metadata,
+                                      unsigned int timeout_ms);
+
+/**
+ * Maximum number of RX taps
+ *
+ * @see bladerf_set_rx_taps()
+ */
+#define BLADERF_RX_TAPS_MAX 8
+
+/**
+ * Handling of an RX tap that falls behind the stream
+ */
+typedef enum {
+    /**
+     * Buffers are retained until the tap has acquired and released them.
+     * A slow tap thus stalls the stream for all taps, and samples are lost
+     * to overruns once all buffers are in use.
      */
-    BLADERF_CORR_DCOFF_I,
+    BLADERF_RX_TAP_BACKPRESSURE,
 
     /**
-     * Adjusts the quadrature DC offset. Valid values are [-2048, 2048], which
-     * are scaled to the available control bits.
+     * When all buffers are in use, the oldest buffer is discarded for a
+     * tap that has not yet acquired it, rather than stalling the stream.
+     * The tap's next bladerf_rx_tap_acquire() then reports
+     * ::BLADERF_META_STATUS_OVERRUN. A buffer that a tap holds is never
+     * discarded, so such a tap should release each buffer promptly.
      */
-    BLADERF_CORR_DCOFF_Q,
+    BLADERF_RX_TAP_DROP,
+} bladerf_rx_tap_policy;
+
+/**
+ * Set the number of RX taps, which fan the RX stream out to several
+ * consumers.
+ *
+ * When taps are enabled, each of the sync interface's RX buffers is shared
+ * by all taps, without copying. Each tap is a consumer with its own position
+ * in the stream, receiving every buffer via bladerf_rx_tap_acquire() and
+ * bladerf_rx_tap_release(). A buffer is reused only once all taps have
+ * released it, or have had it discarded by ::BLADERF_RX_TAP_DROP.
+ *
+ * While taps are in use, bladerf_sync_rx(), bladerf_sync_rx_planar(),
+ * bladerf_sync_rxv(), and bladerf_sync_rx_acquire() are not available. Taps
+ * cannot be combined with per-channel RX queues, and
+ * ::BLADERF_FORMAT_CF32 is not supported.
+ *
+ * This takes effect the next time bladerf_sync_config() is called for RX.
+ *
+ * @param       dev         Device handle
+ * @param[in]   num_taps    Number of taps, up to ::BLADERF_RX_TAPS_MAX.
+ *                          0 disables the taps.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_rx_taps(struct bladerf *dev, unsigned int num_taps);
+
+/**
+ * Set the policy applied to an RX tap that falls behind the stream.
+ *
+ * Taps default to ::BLADERF_RX_TAP_BACKPRESSURE. This takes effect the next
+ * time bladerf_sync_config() is called for RX.
+ *
+ * @param       dev         Device handle
+ * @param[in]   tap         Tap index, less than ::BLADERF_RX_TAPS_MAX
+ * @param[in]   policy      Policy to apply
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_rx_tap_policy(struct bladerf *dev,
+                                        unsigned int tap,
+                                        bladerf_rx_tap_policy policy);
+
+/**
+ * Obtain the next received buffer of an RX tap, without copying it.
+ *
+ * The buffer is shared with the other taps and must not be modified. It
+ * holds samples in the configured format as received from the device; for
+ * ::BLADERF_FORMAT_SC16_Q11_META and ::BLADERF_FORMAT_SC8_Q7_META, this
+ * includes each message's header, as with bladerf_stream callbacks. The
+ * `timestamp` field of `metadata` is then set to that of the first message.
+ *
+ * If provided, `metadata->actual_count` is set to `num_samples`, and
+ * ::BLADERF_META_STATUS_OVERRUN is set in `metadata->status` if buffers have
+ * been discarded for this tap since its previous buffer. `flags` are
+ * ignored.
+ *
+ * Each tap may hold one buffer at a time, which must be returned via
+ * bladerf_rx_tap_release(). Each tap may be serviced by a different thread,
+ * but only one thread may use a given tap at a time.
+ *
+ * @pre bladerf_set_rx_taps() has enabled taps, and a bladerf_sync_config()
+ *      call has been made for RX.
+ *
+ * @param       dev         Device handle
+ * @param[in]   tap         Tap index
+ * @param[out]  samples     Updated with a pointer to the buffer
+ * @param[out]  num_samples Updated with the number of samples in the buffer
+ * @param[out]  metadata    Buffer metadata. May be NULL.
+ * @param[in]   timeout_ms  Timeout (milliseconds) for this call to complete.
+ *                          Zero implies "infinite."
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if the taps are not in use, the tap index is
+ *         out of range, or the tap already holds a buffer,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_rx_tap_acquire(struct bladerf *dev,
+                                     unsigned int tap,
+                                     const void **samples,
+                                     unsigned int *num_samples,
+                                     struct bladerf_metadata *metadata,
+                                     unsigned int timeout_ms);
+
+/**
+ * Release the buffer held by an RX tap.
+ *
+ * @param       dev         Device handle
+ * @param[in]   tap         Tap index
+ * @param[in]   samples     Pointer provided by bladerf_rx_tap_acquire()
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if `samples` is not the buffer held by the tap,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_rx_tap_release(struct bladerf *dev,
+                                     unsigned int tap,
+                                     const void *samples);
+
+/**
+ * Resample received samples to a rate of the caller's choosing on the host.
+ *
+ * The device continues to sample at the rate set via
+ * bladerf_set_sample_rate() or bladerf_set_rational_sample_rate(), and
+ * bladerf_sync_rx() returns samples at `rate` instead. The ratio between the
+ * two is tracked exactly, so that the output rate does not drift relative to
+ * the device's. This allows a rate the device's clocking cannot produce to
+ * be met exactly, e.g., 44.1 kHz multiples from a 30.72 MHz device rate.
+ *
+ * Samples are filtered with a 48-tap windowed-sinc filter, widened in
+ * proportion to any decimation. Its response is flat to within 0.01 dB up
+ * to 0.41 of the lower of the two rates, and is down by at least 68 dB from
+ * that rate's Nyquist frequency onwards. The device rate may exceed `rate`
+ * by up to a factor of 16.
+ *
+ * With ::BLADERF_FORMAT_SC16_Q11_META and ::BLADERF_FORMAT_CF32_META,
+ * ::BLADERF_META_FLAG_RX_NOW is required, and the `timestamp` reported
+ * remains in units of device samples: it is that of the device sample at or
+ * preceding the first returned sample. A discontinuity restarts the
+ * resampler, which discards the samples awaiting the filter's second half
+ * (24 device samples, when not decimating). As without resampling, the call
+ * ending at a discontinuity reports ::BLADERF_META_STATUS_OVERRUN, and the
+ * next reports the `gap` in device samples. A sample rate change scheduled
+ * via bladerf_switch_sample_rate() is applied to the device rate, and is
+ * reported likewise via ::BLADERF_META_STATUS_RATE_CHANGE.
+ *
+ * Resampling is supported with the ::BLADERF_FORMAT_SC16_Q11 and
+ * ::BLADERF_FORMAT_CF32 formats and their metadata variants. While it is in
+ * use, only bladerf_sync_rx() may be used to receive samples; it cannot be
+ * combined with per-channel RX queues or RX taps.
+ *
+ * This takes effect the next time bladerf_sync_config() is called for RX.
+ *
+ * @param       dev         Device handle
+ * @param[in]   rate        Output sample rate. NULL or a zero rate disables
+ *                          resampling.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_rx_resampler(struct bladerf *dev,
+                                       const struct bladerf_rational_rate *rate);
+
+/**
+ * Obtain received IQ samples without copying them.
+ *
+ * Rather than copying samples into a caller-provided buffer, this function
+ * provides a pointer into the internal buffer that holds the next block of
+ * received samples. The caller must return this region via
+ * bladerf_sync_rx_release() to allow the underlying buffer to be reused; until
+ * it is released, the region is owned by the caller.
+ *
+ * The size of the region is determined by the configured format:
+ *  - ::BLADERF_FORMAT_SC16_Q11: the remainder of the current buffer
+ *  - ::BLADERF_FORMAT_SC16_Q11_META: the remainder of the current message.
+ *    The `timestamp` field of `metadata` is set to that of the first sample
+ *    in the region, and ::BLADERF_META_STATUS_OVERRUN is set when a
+ *    discontinuity precedes it. `flags` are ignored; timestamps cannot be
+ *    targeted with this function.
+ *  - ::BLADERF_FORMAT_PACKET_META: the payload of the current packet
+ *
+ * In all cases, `metadata->actual_count` (if provided) is set to the number of
+ * samples in the region.
+ *
+ * Only one region may be held at a time. bladerf_sync_rx() returns
+ * ::BLADERF_ERR_INVAL while a region is held.
+ *
+ * @pre A bladerf_sync_config() call has been made to configure the device for
+ *      synchronous data transfer.
+ *
+ * @note The provided pointer is invalidated by disabling the RX channel,
+ *       calling bladerf_sync_config() or closing the device, even if it has
+ *       not yet been released.
+ *
+ * @param       dev         Device handle
+ * @param[out]  samples     Updated to point to the received samples
+ * @param[out]  num_samples Updated with the number of samples available
+ *                          at `samples`
+ * @param[out]  metadata    Sample metadata. This must be provided when using
+ *                          the ::BLADERF_FORMAT_SC16_Q11_META or
+ *                          ::BLADERF_FORMAT_PACKET_META formats, but may be
+ *                          NULL otherwise.
+ * @param[in]   timeout_ms  Timeout (milliseconds) for this call to complete.
+ *                          Zero implies "infinite."
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if a previously acquired region has not been
+ *         released,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_rx_acquire(struct bladerf *dev,
+                                      void **samples,
+                                      unsigned int *num_samples,
+                                      struct bladerf_metadata *metadata,
+                                      unsigned int timeout_ms);
+
+/**
+ * Release a region of samples obtained via bladerf_sync_rx_acquire().
+ *
+ * @param       dev         Device handle
+ * @param[in]   samples     Pointer previously returned by
+ *                          bladerf_sync_rx_acquire()
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if `samples` does not refer to the currently
+ *         acquired region,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_rx_release(struct bladerf *dev, const void *samples);
 
-    /**
-     * Adjusts phase correction of [-10, 10] degrees, via a provided count value
-     * of [-4096, 4096].
-     */
-    BLADERF_CORR_PHASE,
+/**
+ * A block of samples, and its metadata, for bladerf_sync_rxv() and
+ * bladerf_sync_txv()
+ */
+struct bladerf_sync_iov {
+    /** Sample buffer */
+    void *samples;
+
+    /** Number of samples in `samples` */
+    unsigned int num_samples;
 
     /**
-     * Adjusts gain correction value in [-1.0, 1.0], via provided values in the
-     * range of [-4096, 4096].
+     * Metadata for this block, as would be passed to bladerf_sync_rx() or
+     * bladerf_sync_tx(). This may be NULL for formats without metadata.
      */
-    BLADERF_CORR_GAIN
-} bladerf_correction;
-
-/** @cond IGNORE */
-/* Backwards compatible mapping to `bladerf_correction`. */
-#define BLADERF_CORR_LMS_DCOFF_I BLADERF_CORR_DCOFF_I
-#define BLADERF_CORR_LMS_DCOFF_Q BLADERF_CORR_DCOFF_Q
-#define BLADERF_CORR_FPGA_PHASE BLADERF_CORR_PHASE
-#define BLADERF_CORR_FPGA_GAIN BLADERF_CORR_GAIN
-/** @endcond */
+    struct bladerf_metadata *metadata;
+};
 
 /**
- * Set the value of the specified configuration parameter
+ * Receive into several blocks of samples in a single call
  *
- * @see The ::bladerf_correction description for the valid ranges of the `value`
- *      parameter.
+ * This is equivalent to calling bladerf_sync_rx() for each block in turn,
+ * but the synchronous interface's lock is acquired only once for the entire
+ * sequence. This reduces per-call overhead when reading many small blocks,
+ * each with its own metadata.
+ *
+ * Processing stops at the first block that fails. Its status is returned,
+ * and the blocks that follow it are left untouched.
+ *
+ * This is not supported with ::BLADERF_RX_X2 planar buffers; use
+ * interleaved buffers, as with bladerf_sync_rx().
  *
  * @param       dev         Device handle
- * @param[in]   ch          Channel
- * @param[in]   corr        Correction type
- * @param[in]   value       Value to apply
+ * @param[in]   iov         Blocks to receive into
+ * @param[in]   iovcnt      Number of blocks in `iov`
+ * @param[out]  completed   If non-NULL, updated with the number of blocks
+ *                          that were received successfully
+ * @param[in]   timeout_ms  Timeout (milliseconds) applied to each block, as
+ *                          per bladerf_sync_rx()
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return 0 on success, or the status of the first block that failed, as per
+ *         bladerf_sync_rx()
  */
 API_EXPORT
-int CALL_CONV bladerf_set_correction(struct bladerf *dev,
-                                     bladerf_channel ch,
-                                     bladerf_correction corr,
-                                     bladerf_correction_value value);
+int CALL_CONV bladerf_sync_rxv(struct bladerf *dev,
+                               const struct bladerf_sync_iov *iov,
+                               unsigned int iovcnt,
+                               unsigned int *completed,
+                               unsigned int timeout_ms);
 
 /**
- * Obtain the current value of the specified configuration parameter
+ * Transmit several blocks of samples in a single call
+ *
+ * This is equivalent to calling bladerf_sync_tx() for each block in turn,
+ * but the synchronous interface's lock is acquired only once for the entire
+ * sequence. For example, an entire burst may be submitted at once, as a
+ * block flagged with ::BLADERF_META_FLAG_TX_BURST_START, any number of
+ * blocks with no flags, and a block flagged with
+ * ::BLADERF_META_FLAG_TX_BURST_END. Several bursts may also be submitted in
+ * one call.
+ *
+ * Processing stops at the first block that fails. Its status is returned,
+ * and the blocks that follow it are not transmitted.
  *
  * @param       dev         Device handle
- * @param[in]   ch          Channel
- * @param[in]   corr        Correction type
- * @param[out]  value       Current value
+ * @param[in]   iov         Blocks to transmit
+ * @param[in]   iovcnt      Number of blocks in `iov`
+ * @param[out]  completed   If non-NULL, updated with the number of blocks
+ *                          that were accepted successfully
+ * @param[in]   timeout_ms  Timeout (milliseconds) applied to each block, as
+ *                          per bladerf_sync_tx()
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return 0 on success, or the status of the first block that failed, as per
+ *         bladerf_sync_tx()
  */
 API_EXPORT
-int CALL_CONV bladerf_get_correction(struct bladerf *dev,
-                                     bladerf_channel ch,
-                                     bladerf_correction corr,
-                                     bladerf_correction_value *value);
+int CALL_CONV bladerf_sync_txv(struct bladerf *dev,
+                               const struct bladerf_sync_iov *iov,
+                               unsigned int iovcnt,
+                               unsigned int *completed,
+                               unsigned int timeout_ms);
 
-/** @} (End of FN_CORR) */
+/**
+ * Get the current time of the clock used by bladerf_sync_rx_deadline() and
+ * bladerf_sync_tx_deadline()
+ *
+ * This is `CLOCK_MONOTONIC` where the platform allows condition variables to
+ * wait against it, so that deadlines are unaffected by adjustments to the
+ * system time (e.g., by NTP). Otherwise, this is the system time.
+ *
+ * Synchronous interface timeouts are also measured against this clock.
+ *
+ * @return Current time, in nanoseconds, or 0 if the clock could not be read
+ */
+API_EXPORT
+uint64_t CALL_CONV bladerf_get_deadline_clock_ns(void);
 
-/** @} (End of FN_CHANNEL) */
+/**
+ * Receive IQ samples, as per bladerf_sync_rx(), by an absolute deadline
+ *
+ * Rather than limiting each wait for a buffer, as `timeout_ms` does,
+ * the deadline bounds the entire call. This allows callers with a fixed
+ * time budget per frame to compute a single deadline, rather than a relative
+ * timeout for each call.
+ *
+ * @param       dev         Device handle
+ * @param[out]  samples     Buffer to store samples in
+ * @param[in]   num_samples Number of samples to read
+ * @param[out]  metadata    Sample metadata, as per bladerf_sync_rx()
+ * @param[in]   deadline_ns Deadline, in nanoseconds of
+ *                          bladerf_get_deadline_clock_ns(). Must be non-zero.
+ *
+ * @return 0 on success, ::BLADERF_ERR_TIMEOUT if the deadline passed while
+ *         waiting for samples, or a value from \ref RETCODES list on failure,
+ *         as per bladerf_sync_rx()
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_rx_deadline(struct bladerf *dev,
+                                       void *samples,
+                                       unsigned int num_samples,
+                                       struct bladerf_metadata *metadata,
+                                       uint64_t deadline_ns);
 
 /**
- * @defgroup STREAMING Streaming
+ * Transmit IQ samples, as per bladerf_sync_tx(), by an absolute deadline
  *
- * This section defines the streaming APIs.
+ * The deadline bounds the time spent waiting for buffers to become available,
+ * as per bladerf_sync_rx_deadline().
  *
- * @{
+ * @param       dev         Device handle
+ * @param[in]   samples     Array of samples
+ * @param[in]   num_samples Number of samples to write
+ * @param[in]   metadata    Sample metadata, as per bladerf_sync_tx()
+ * @param[in]   deadline_ns Deadline, in nanoseconds of
+ *                          bladerf_get_deadline_clock_ns(). Must be non-zero.
+ *
+ * @return 0 on success, ::BLADERF_ERR_TIMEOUT if the deadline passed while
+ *         waiting for buffer space, or a value from \ref RETCODES list on
+ *         failure, as per bladerf_sync_tx()
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_tx_deadline(struct bladerf *dev,
+                                       void const *samples,
+                                       unsigned int num_samples,
+                                       struct bladerf_metadata *metadata,
+                                       uint64_t deadline_ns);
+
+/**
+ * Receive one block of samples and transmit one block in a single call
+ *
+ * This is intended for echo, relay and transceiver applications, which
+ * would otherwise alternate bladerf_sync_rx() and bladerf_sync_tx() calls,
+ * or make them from two threads. Both synchronous interfaces are locked
+ * once, and a single wait covers both the received samples becoming
+ * available and buffer space for the transmitted samples.
+ *
+ * The RX block is received first, as per bladerf_sync_rx(). If `tx_offset`
+ * is non-zero, `tx_metadata->timestamp` is then set to the timestamp of the
+ * first received sample plus `tx_offset`, before the TX block is transmitted
+ * as per bladerf_sync_tx(). For example, a relay might start a burst with
+ * ::BLADERF_META_FLAG_TX_BURST_START in its first call, and continue it in
+ * the calls that follow, such that each block is retransmitted a fixed
+ * offset after it was received. The offset must cover the relay's
+ * processing time and the TX path's latency.
+ *
+ * Both directions must be configured with a format providing per-sample
+ * metadata (::BLADERF_FORMAT_SC16_Q11_META or ::BLADERF_FORMAT_CF32_META).
+ * This is not supported with RX per-channel queues or RX taps.
+ *
+ * The combined wait expects the RX samples to be taken from the buffers as
+ * they are, as with ::BLADERF_META_FLAG_RX_NOW. Should an RX timestamp in the
+ * future be requested, the RX side waits further as per bladerf_sync_rx().
+ *
+ * @param       dev             Device handle
+ * @param[out]  rx_samples      Buffer to store received samples in
+ * @param[in]   rx_num_samples  Number of samples to receive
+ * @param[inout] rx_metadata    RX metadata, as per bladerf_sync_rx()
+ * @param[in]   tx_samples      Samples to transmit
+ * @param[in]   tx_num_samples  Number of samples to transmit
+ * @param[inout] tx_metadata    TX metadata, as per bladerf_sync_tx(). Its
+ *                              timestamp is updated if `tx_offset` is
+ *                              non-zero.
+ * @param[in]   tx_offset       Ticks after the first received sample at
+ *                              which to transmit, or 0 to use
+ *                              `tx_metadata` as provided. Must be 0 if
+ *                              ::BLADERF_META_FLAG_TX_NOW is set.
+ * @param[in]   timeout_ms      Timeout (milliseconds) for the combined wait.
+ *                              0 implies no timeout.
+ *
+ * @return 0 on success, ::BLADERF_ERR_TIMEOUT if the wait timed out,
+ *         ::BLADERF_ERR_WOULD_BLOCK if either interface is non-blocking and
+ *         would need to wait (see bladerf_set_sync_nonblocking()), or a value
+ *         from \ref RETCODES list on failure, as per bladerf_sync_rx() and
+ *         bladerf_sync_tx(). If the RX block fails, the TX block is not
+ *         transmitted.
  */
+API_EXPORT
+int CALL_CONV bladerf_sync_rxtx(struct bladerf *dev,
+                                void *rx_samples,
+                                unsigned int rx_num_samples,
+                                struct bladerf_metadata *rx_metadata,
+                                void const *tx_samples,
+                                unsigned int tx_num_samples,
+                                struct bladerf_metadata *tx_metadata,
+                                uint64_t tx_offset,
+                                unsigned int timeout_ms);
 
-/** printf format for timestamps in unsigned decimal */
-#define BLADERF_PRIuTS PRIu64
-/** printf format for timestamps in hexadecimal */
-#define BLADERF_PRIxTS PRIx64
-/** scanf format for timestamps in unsigned decimal */
-#define BLADERF_SCNuTS SCNu64
-/** scanf format for timestamps in hexadecimal */
-#define BLADERF_SCNxTS SCNx64
+/**
+ * Number of bins in the bladerf_stream_stats::callback_latency histogram
+ */
+#define BLADERF_STREAM_STATS_LATENCY_BINS 16
 
 /**
- * @defgroup STREAMING_FORMAT Formats
+ * Stream throughput and health counters
  *
- * This section defines the available sample formats and metadata flags.
+ * Counters are cumulative from the time the stream (or synchronous interface)
+ * was initialized. To monitor a stream, sample these periodically and
+ * consider the differences between successive snapshots.
+ */
+struct bladerf_stream_stats {
+    uint64_t bytes;           /**< Bytes moved by completed transfers */
+    uint64_t transfers;       /**< Number of completed transfers */
+    uint64_t short_transfers; /**< Transfers that completed with fewer bytes
+                               *   than requested */
+    uint64_t timeouts;        /**< Transfers that timed out */
+
+    /**
+     * RX: Number of times samples were dropped because the host did not
+     * keep up. For the synchronous interface, this includes buffers
+     * discarded by the worker and discontinuities detected via metadata.
+     */
+    uint64_t overruns;
+
+    /**
+     * TX: Number of times the synchronous interface had no buffers in
+     * flight when a transfer completed. Note that this includes
+     * intentional gaps in transmission, such as those between bursts.
+     */
+    uint64_t underruns;
+
+    /**
+     * Synchronous interface only: Maximum time, in microseconds, that a
+     * filled buffer waited before being consumed (RX) or submitted (TX).
+     */
+    uint64_t max_buffer_full_us;
+
+    /** Maximum time, in microseconds, spent in the stream callback */
+    uint64_t callback_max_us;
+
+    /**
+     * Histogram of time spent in the stream callback. Bin 0 counts
+     * callbacks that took less than 1 us, and bin `n` counts those that
+     * took [2^(n-1), 2^n) us. The final bin also counts all longer
+     * callbacks.
+     */
+    uint64_t callback_latency[BLADERF_STREAM_STATS_LATENCY_BINS];
+};
+
+/**
+ * Retrieve throughput and health counters for the synchronous interface
  *
- * @{
+ * The transfer and callback counters reflect the underlying stream managed
+ * by the synchronous interface's worker.
+ *
+ * This may be called from any thread, including while another thread is
+ * blocked in bladerf_sync_rx() or bladerf_sync_tx().
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Direction of the synchronous interface
+ * @param[out]  stats       Updated with the current counter values
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if the synchronous interface has not been
+ *         configured for `dir`,
+ *         or a value from \ref RETCODES list on failures.
  */
+API_EXPORT
+int CALL_CONV bladerf_get_sync_stats(struct bladerf *dev,
+                                     bladerf_direction dir,
+                                     struct bladerf_stream_stats *stats);
 
 /**
- * Sample format
+ * Measured latency of the synchronous interface's buffer pipeline
+ *
+ * These are measured on the host, from the times at which buffers fill and
+ * are consumed. They do not include the fixed delays within the FPGA and FX3.
  */
-typedef enum {
+struct bladerf_sync_latency {
     /**
-     * Signed, Complex 16-bit Q11. This is the native format of the DAC data.
-     *
-     * Values in the range [-2048, 2048) are used to represent [-1.0, 1.0).
-     * Note that the lower bound here is inclusive, and the upper bound is
-     * exclusive. Ensure that provided samples stay within [-2048, 2047].
-     *
-     * Samples consist of interleaved IQ value pairs, with I being the first
-     * value in the pair. Each value in the pair is a right-aligned,
-     * little-endian int16_t. The FPGA ensures that these values are
-     * sign-extended.
-     *
-     * <pre>
-     *  .--------------.--------------.
-     *  | Bits 31...16 | Bits 15...0  |
-     *  +--------------+--------------+
-     *  |   Q[15..0]   |   I[15..0]   |
-     *  `--------------`--------------`
-     * </pre>
-     *
-     * When using this format the minimum required buffer size, in bytes, is:
-     *
-     * \f$
-     *  buffer\_size\_min = (2 \times num\_samples \times num\_channels \times
-     *                      sizeof(int16\_t))
-     * \f$
-     *
-     * For example, to hold 2048 samples for one channel, a buffer must be at
-     * least 8192 bytes large.
-     *
-     * When a multi-channel ::bladerf_channel_layout is selected, samples
-     * will be interleaved per channel. For example, with ::BLADERF_RX_X2
-     * or ::BLADERF_TX_X2 (x2 MIMO), the buffer is structured like:
-     *
-     * <pre>
-     *  .-------------.--------------.--------------.------------------.
-     *  | Byte offset | Bits 31...16 | Bits 15...0  |    Description   |
-     *  +-------------+--------------+--------------+------------------+
-     *  |    0x00     |     Q0[0]    |     I0[0]    |  Ch 0, sample 0  |
-     *  |    0x04     |     Q1[0]    |     I1[0]    |  Ch 1, sample 0  |
-     *  |    0x08     |     Q0[1]    |     I0[1]    |  Ch 0, sample 1  |
-     *  |    0x0c     |     Q1[1]    |     I1[1]    |  Ch 1, sample 1  |
-     *  |    ...      |      ...     |      ...     |        ...       |
-     *  |    0xxx     |     Q0[n]    |     I0[n]    |  Ch 0, sample n  |
-     *  |    0xxx     |     Q1[n]    |     I1[n]    |  Ch 1, sample n  |
-     *  `-------------`--------------`--------------`------------------`
-     * </pre>
-     *
-     * Per the `buffer_size_min` formula above, 2048 samples for two channels
-     * will generate 4096 total samples, and require at least 16384 bytes.
-     *
-     * Implementors may use the interleaved buffers directly, or may use
-     * bladerf_deinterleave_stream_buffer() / bladerf_interleave_stream_buffer()
-     * if contiguous blocks of samples are desired.
+     * Smoothed interval between successive buffers completing, i.e., the
+     * time spanned by one buffer of samples at the current sample rate
      */
-    BLADERF_FORMAT_SC16_Q11,
+    uint64_t buffer_us;
 
     /**
-     * This format is the same as the ::BLADERF_FORMAT_SC16_Q11 format, except
-     * the first 4 samples in every <i>block*</i> of samples are replaced with
-     * metadata organized as follows. All fields are little-endian byte order.
-     *
-     * <pre>
-     *  .-------------.------------.----------------------------------.
-     *  | Byte offset |   Type     | Description                      |
-     *  +-------------+------------+----------------------------------+
-     *  |    0x00     | uint16_t   | Reserved                         |
-     *  |    0x02     |  uint8_t   | Stream flags                     |
-     *  |    0x03     |  uint8_t   | Meta version ID                  |
-     *  |    0x04     | uint64_t   | 64-bit Timestamp                 |
-     *  |    0x0c     | uint32_t   | BLADERF_META_FLAG_* flags        |
-     *  |  0x10..end  |            | Payload                          |
-     *  `-------------`------------`----------------------------------`
-     * </pre>
-     *
-     * For IQ sample meta mode, the Meta version ID and Stream flags should
-     * currently be set to values 0x00 and 0x00, respectively.
-     *
-     * <i>*</i>The number of samples in a <i>block</i> is dependent upon
-     * the USB speed being used:
-     *  - USB 2.0 Hi-Speed: 256 samples
-     *  - USB 3.0 SuperSpeed: 512 samples
-     *
-     * When using the bladerf_sync_rx() and bladerf_sync_tx() functions, the
-     * above details are entirely transparent; the caller need not be concerned
-     * with these details. These functions take care of packing/unpacking the
-     * metadata into/from the underlying stream and convey this information
-     * through the ::bladerf_metadata structure.
-     *
-     * However, when using the \ref FN_STREAMING_ASYNC interface, the user is
-     * responsible for manually packing/unpacking the above metadata into/from
-     * their samples.
-     *
-     * @see STREAMING_FORMAT_METADATA
-     * @see The `src/streaming/metadata.h` header in the libbladeRF codebase.
+     * Time the most recently consumed buffer waited after completing. For
+     * RX, this is from the transfer completing until bladerf_sync_rx()
+     * consumed it. For TX, this is from bladerf_sync_tx() filling it until
+     * it was submitted.
      */
-    BLADERF_FORMAT_SC16_Q11_META,
+    uint64_t wait_us;
+
+    /** Maximum of `wait_us` since the interface was configured */
+    uint64_t wait_max_us;
+
+    /** Time spanned by the transfers in flight: `buffer_us` x transfers */
+    uint64_t pipeline_us;
 
     /**
-     * This format is for exchanging packets containing digital payloads with
-     * the FPGA. A packet is generall a digital payload, that the FPGA then
-     * processes to either modulate, demodulate, filter, etc.
-     *
-     * All fields are little-endian byte order.
-     *
-     * <pre>
-     *  .-------------.------------.----------------------------------.
-     *  | Byte offset |   Type     | Description                      |
-     *  +-------------+------------+----------------------------------+
-     *  |    0x00     | uint16_t   | Packet length (in 32bit DWORDs)  |
-     *  |    0x02     |  uint8_t   | Packet flags                     |
-     *  |    0x03     |  uint8_t   | Packet core ID                   |
-     *  |    0x04     | uint64_t   | 64-bit Timestamp                 |
-     *  |    0x0c     | uint32_t   | BLADERF_META_FLAG_* flags        |
-     *  |  0x10..end  |            | Payload                          |
-     *  `-------------`------------`----------------------------------`
-     * </pre>
-     *
-     * A target core (for example a modem) must be specified when calling the
-     * bladerf_sync_rx() and bladerf_sync_tx() functions.
-     *
-     * When in packet mode, lengths for all functions and data formats are
-     * expressed in number of 32-bit DWORDs. As an example, a 12 byte packet
-     * is considered to be 3 32-bit DWORDs long.
-     *
-     * This packet format does not send or receive raw IQ samples. The digital
-     * payloads contain configurations, and digital payloads that are specific
-     * to the digital core to which they are addressed. It is the FPGA core
-     * that should generate, interpret, and process the digital payloads.
-     *
-     * With the exception of packet lenghts, no difference should exist between
-     * USB 2.0 Hi-Speed or USB 3.0 SuperSpeed for packets for this streaming
-     * format.
-     *
-     * @see STREAMING_FORMAT_METADATA
-     * @see The `src/streaming/metadata.h` header in the libbladeRF codebase.
+     * Estimated host-to-sample latency. For RX, this is the age of the
+     * oldest sample of the most recently consumed buffer when it was handed
+     * to the caller: `buffer_us` + `wait_us`. For TX, this is the delay
+     * between a sample being accepted and being transferred to the device:
+     * `wait_us` + `pipeline_us`.
      */
-    BLADERF_FORMAT_PACKET_META,
-} bladerf_format;
+    uint64_t total_us;
+};
+
+/**
+ * Retrieve the measured latency of the synchronous interface
+ *
+ * Values are 0 until enough buffers have been transferred to measure them.
+ *
+ * This may be called from any thread, including while another thread is
+ * blocked in bladerf_sync_rx() or bladerf_sync_tx().
+ *
+ * @see bladerf_set_sync_low_latency()
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Direction of the synchronous interface
+ * @param[out]  latency     Updated with the current measurements
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if the synchronous interface has not been
+ *         configured for `dir`,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_sync_latency(struct bladerf *dev,
+                                       bladerf_direction dir,
+                                       struct bladerf_sync_latency *latency);
 
 /**
- * @defgroup STREAMING_FORMAT_METADATA Metadata structure and flags
+ * Set the duration of the RX capture
  *
- * @{
+ * While the RX synchronous interface is streaming, a copy of the most
+ * recently received samples is retained, spanning at least `duration_ms`.
+ * These may be read from any timestamp within that window via
+ * bladerf_read_rx_capture(), such as to retrieve the samples that preceded
+ * an event, without stopping the stream or consuming them via
+ * bladerf_sync_rx(). Samples are retained whether or not they have been
+ * consumed via bladerf_sync_rx().
+ *
+ * The capture requires ::BLADERF_FORMAT_SC16_Q11_META and ::BLADERF_RX_X1.
+ * It is sized from the sample rate at the time it is applied.
+ *
+ * This takes effect the next time bladerf_sync_config() is called for RX.
+ *
+ * @param       dev             Device handle
+ * @param[in]   duration_ms     Duration to retain, in milliseconds. 0
+ *                              disables the capture.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
  */
+API_EXPORT
+int CALL_CONV bladerf_set_rx_capture(struct bladerf *dev,
+                                     unsigned int duration_ms);
 
-/*
- * Metadata status bits
+/**
+ * Read samples from the RX capture
  *
- * These are used in conjunction with the bladerf_metadata structure's `status`
- * field.
+ * The samples starting at `metadata->timestamp` are located directly from
+ * their timestamp, and copied into `samples` in ::BLADERF_FORMAT_SC16_Q11
+ * (i.e., without metadata headers). Copying stops early upon reaching the
+ * newest sample received, or a gap left by samples dropped before reaching
+ * the host (in which case ::BLADERF_META_STATUS_OVERRUN is set in
+ * `metadata->status`). `metadata->actual_count` is set to the number of
+ * samples copied.
+ *
+ * This may be called from any thread, including while another thread is
+ * blocked in bladerf_sync_rx().
+ *
+ * @see bladerf_set_rx_capture()
+ *
+ * @param       dev             Device handle
+ * @param[out]  samples         Buffer to store samples in
+ * @param[in]   num_samples     Number of samples to read
+ * @param[inout] metadata       The `timestamp` field specifies the timestamp
+ *                              of the first sample to read. The
+ *                              `actual_count` and `status` fields are
+ *                              updated as described above.
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_TIME_PAST if the first sample is no longer retained,
+ *         ::BLADERF_ERR_RANGE if the first sample has not yet been received,
+ *         ::BLADERF_ERR_UNSUPPORTED if the capture is not enabled,
+ *         or a value from \ref RETCODES list on failures.
  */
+API_EXPORT
+int CALL_CONV bladerf_read_rx_capture(struct bladerf *dev,
+                                      void *samples,
+                                      unsigned int num_samples,
+                                      struct bladerf_metadata *metadata);
 
 /**
- * A sample overrun has occurred.
+ * Get the range of timestamps currently retained by the RX capture
  *
- * This indicates that either the host (more likely) or the FPGA is not keeping
- * up with the incoming samples.
+ * @param       dev         Device handle
+ * @param[out]  oldest      Timestamp of the oldest sample retained
+ * @param[out]  newest      Timestamp of the newest sample retained
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_RANGE if no samples have been received yet,
+ *         ::BLADERF_ERR_UNSUPPORTED if the capture is not enabled,
+ *         or a value from \ref RETCODES list on failures.
  */
-#define BLADERF_META_STATUS_OVERRUN (1 << 0)
+API_EXPORT
+int CALL_CONV bladerf_get_rx_capture_range(struct bladerf *dev,
+                                           bladerf_timestamp *oldest,
+                                           bladerf_timestamp *newest);
+
+/** @} (End of FN_STREAMING_SYNC) */
 
 /**
- * A sample underrun has occurred.
+ * @defgroup FN_GROUP Device groups
  *
- * This generally only occurs on the TX channel when the FPGA is starved of
- * samples.
+ * A device group receives from several devices as one coherent array. The
+ * group arms a trigger on every member, with one member as the trigger
+ * master, starts each member's RX stream, and fires the trigger so that all
+ * streams start on the same sample. One thread per member then reads fixed
+ * size blocks from that member, and bladerf_group_rx() delivers a block from
+ * every member covering the same sample period.
  *
- * @note libbladeRF does not report this status. It is here for future use.
+ * Blocks are numbered from the trigger, independently of each device's
+ * timestamp counter, and each member reads block `n` at the timestamp of its
+ * first sample plus `n` blocks. If a member falls behind, it skips the blocks
+ * that have already passed, and the other members' copies of those blocks
+ * are discarded, so that delivered blocks always stay aligned.
+ *
+ * The members must share a reference clock and the trigger signal, and be
+ * configured with the same sample rate, as described in \ref FN_TRIG. The
+ * group owns the members' RX synchronous interfaces and triggers while it is
+ * started, and no other bladerf_sync_rx() calls should be made on them.
+ *
+ * These functions are thread-safe, although bladerf_group_rx() is intended
+ * to be called from a single thread.
+ *
+ * @{
  */
-#define BLADERF_META_STATUS_UNDERRUN (1 << 1)
 
-/*
- * Metadata flags
- *
- * These are used in conjunction with the bladerf_metadata structure's `flags`
- * field.
+/** Maximum number of devices in a group */
+#define BLADERF_GROUP_MAX_DEVICES 16
+
+/** Default number of blocks buffered for each member of a group */
+#define BLADERF_GROUP_QUEUE_DEFAULT 16
+
+/** Opaque device group handle */
+struct bladerf_group;
+
+/**
+ * Device group configuration
+ */
+struct bladerf_group_config {
+    bladerf_channel_layout layout; /**< RX layout: ::BLADERF_RX_X1 or
+                                    *   ::BLADERF_RX_X2 */
+
+    /**
+     * Sample format. This must be a format with metadata (e.g.,
+     * ::BLADERF_FORMAT_SC16_Q11_META), as blocks are read at timestamps.
+     */
+    bladerf_format format;
+
+    unsigned int num_buffers;    /**< As for bladerf_sync_config() */
+    unsigned int buffer_size;    /**< As for bladerf_sync_config() */
+    unsigned int num_transfers;  /**< As for bladerf_sync_config() */
+    unsigned int stream_timeout; /**< As for bladerf_sync_config(). This
+                                  *   also bounds the wait for the trigger
+                                  *   to fire. */
+
+    /**
+     * Samples per channel in each block. For ::BLADERF_RX_X2, a block holds
+     * twice this number of interleaved samples.
+     */
+    unsigned int block_samples;
+
+    /**
+     * Number of blocks buffered for each member. 0 selects
+     * ::BLADERF_GROUP_QUEUE_DEFAULT.
+     */
+    unsigned int queue_blocks;
+
+    bladerf_trigger_signal trigger; /**< Trigger signal shared by the
+                                     *   members */
+    unsigned int master;            /**< Index of the trigger master */
+
+    /**
+     * Array of scheduling attributes, one per member, or NULL. Each member's
+     * block reading thread, and the worker thread of its RX stream, are run
+     * with its attributes. This allows each device's threads to be pinned to
+     * their own CPU.
+     */
+    const struct bladerf_stream_thread_attrs *thread_attrs;
+};
+
+/**
+ * Statistics for one member of a device group
  */
+struct bladerf_group_stats {
+    uint64_t blocks;    /**< Blocks read from the device */
+    uint64_t skipped;   /**< Blocks lost because the member fell behind */
+    uint64_t discarded; /**< Blocks read, but discarded because another
+                         *   member lost them */
+    uint64_t overruns;  /**< Blocks flagged with
+                         *   ::BLADERF_META_STATUS_OVERRUN */
+};
 
 /**
- * Mark the associated buffer as the start of a burst transmission.
+ * Create a device group
  *
- * @note This is only used for the bladerf_sync_tx() call.
+ * The devices must already be open. They remain owned by the caller, and
+ * must stay open until the group is closed.
  *
- * When using this flag, the bladerf_metadata::timestamp field should contain
- * the timestamp at which samples should be sent.
+ * @param[out]  group       Updated with the group handle on success
+ * @param[in]   devices     Array of `num_devices` device handles
+ * @param[in]   num_devices Number of devices, up to
+ *                          ::BLADERF_GROUP_MAX_DEVICES
+ * @param[in]   config      Group configuration
  *
- * Between specifying the ::BLADERF_META_FLAG_TX_BURST_START and
- * ::BLADERF_META_FLAG_TX_BURST_END flags, there is no need for the user to the
- * bladerf_metadata::timestamp field because the library will ensure the
- * correct value is used, based upon the timestamp initially provided and
- * the number of samples that have been sent.
+ * @return 0 on success, value from \ref RETCODES list on failure
  */
-#define BLADERF_META_FLAG_TX_BURST_START (1 << 0)
+API_EXPORT
+int CALL_CONV bladerf_group_open(struct bladerf_group **group,
+                                 struct bladerf *const *devices,
+                                 unsigned int num_devices,
+                                 const struct bladerf_group_config *config);
 
 /**
- * Mark the associated buffer as the end of a burst transmission. This will
- * flush the remainder of the sync interface's current working buffer and
- * enqueue samples into the hardware's transmit FIFO.
- *
- * As of libbladeRF v1.3.0, it is no longer necessary for the API user to ensure
- * that the final 3 samples of a burst are \f$0 + 0 j\f$. libbladeRF now ensures
- * this hardware requirement is upheld.
+ * Start a device group's streams
  *
- * Specifying this flag and flushing the sync interface's working buffer implies
- * that the next timestamp that can be transmitted is the current timestamp plus
- * the duration of the burst that this flag is ending <b>and</b> the remaining
- * length of the remaining buffer that is flushed. (The buffer size, in this
- * case, is the `buffer_size` value passed to the previous bladerf_sync_config()
- * call.)
+ * This arms the trigger on each member, configures and enables each
+ * member's RX stream, starts the block reading threads, and then fires the
+ * trigger from the master.
  *
- * Rather than attempting to keep track of the number of samples sent with
- * respect to buffer sizes, it is easiest to always assume 1 buffer's worth of
- * time is required between bursts. In this case "buffer" refers to the
- * `buffer_size` parameter provided to bladerf_sync_config().) If this is too
- * much time, consider using the ::BLADERF_META_FLAG_TX_UPDATE_TIMESTAMP
- * flag.
+ * @param       group   Group handle
  *
- * @note This is only used for the bladerf_sync_tx() call. It is ignored by the
- *       bladerf_sync_rx() call.
+ * @return 0 on success, value from \ref RETCODES list on failure. On
+ *         failure, any members already started are stopped.
  */
-#define BLADERF_META_FLAG_TX_BURST_END (1 << 1)
+API_EXPORT
+int CALL_CONV bladerf_group_start(struct bladerf_group *group);
 
 /**
- * Use this flag in conjunction with ::BLADERF_META_FLAG_TX_BURST_START to
- * indicate that the burst should be transmitted as soon as possible, as opposed
- * to waiting for a specific timestamp.
+ * Receive a time-aligned block from every member of a device group
  *
- * When this flag is used, there is no need to set the
- * bladerf_metadata::timestamp field.
+ * @param       group       Group handle
+ * @param[out]  samples     Array of buffers, one per member, each updated
+ *                          with that member's block of samples
+ * @param[out]  block       Updated with the number of the block, counted in
+ *                          blocks since the trigger fired. Block numbers
+ *                          increase, and gaps indicate lost blocks. May be
+ *                          NULL.
+ * @param[out]  timestamps  Array, one per member, updated with the device
+ *                          timestamp of the first sample of each member's
+ *                          block. May be NULL.
+ * @param[in]   timeout_ms  Time to wait for a block, in ms. 0 waits
+ *                          indefinitely.
+ *
+ * @return 0 on success, ::BLADERF_ERR_TIMEOUT if no aligned block arrived
+ *         in time, or the status of a member whose stream failed
  */
-#define BLADERF_META_FLAG_TX_NOW (1 << 2)
+API_EXPORT
+int CALL_CONV bladerf_group_rx(struct bladerf_group *group,
+                               void *const *samples,
+                               uint64_t *block,
+                               bladerf_timestamp *timestamps,
+                               unsigned int timeout_ms);
 
 /**
- * Use this flag within a burst (i.e., between the use of
- * ::BLADERF_META_FLAG_TX_BURST_START and ::BLADERF_META_FLAG_TX_BURST_END) to
- * specify that bladerf_sync_tx() should read the bladerf_metadata::timestamp
- * field and zero-pad samples up to the specified timestamp. The provided
- * samples will then be transmitted at that timestamp.
+ * Get the statistics of a member of a device group
  *
- * Use this flag when potentially flushing an entire buffer via the
- * ::BLADERF_META_FLAG_TX_BURST_END would yield an unacceptably large gap in the
- * transmitted samples.
+ * @param       group   Group handle
+ * @param[in]   member  Index of the member
+ * @param[out]  stats   Updated with the member's statistics since the group
+ *                      was last started
  *
- * In some applications where a transmitter is constantly transmitting with
- * extremely small gaps (less than a buffer), users may end up using a single
- * ::BLADERF_META_FLAG_TX_BURST_START, and then numerous calls to
- * bladerf_sync_tx() with the ::BLADERF_META_FLAG_TX_UPDATE_TIMESTAMP flag set.
- * The ::BLADERF_META_FLAG_TX_BURST_END would only be used to end the stream
- * when shutting down.
+ * @return 0 on success, value from \ref RETCODES list on failure
  */
-#define BLADERF_META_FLAG_TX_UPDATE_TIMESTAMP (1 << 3)
+API_EXPORT
+int CALL_CONV bladerf_group_get_stats(struct bladerf_group *group,
+                                      unsigned int member,
+                                      struct bladerf_group_stats *stats);
 
 /**
- * This flag indicates that calls to bladerf_sync_rx should return any available
- * samples, rather than wait until the timestamp indicated in the
- * bladerf_metadata timestamp field.
+ * Stop a device group's streams
+ *
+ * The triggers are disarmed before the streams are stopped, so the members'
+ * RX channels are left disabled with normal RX operation restored.
+ *
+ * @param       group   Group handle
+ *
+ * @return 0 on success, or the first failure from \ref RETCODES list
  */
-#define BLADERF_META_FLAG_RX_NOW (1 << 31)
+API_EXPORT
+int CALL_CONV bladerf_group_stop(struct bladerf_group *group);
 
 /**
- * This flag is asserted in bladerf_metadata.status by the hardware when an
- * underflow is detected in the sample buffering system on the device.
+ * Close a device group, stopping it first if it is started. The member
+ * devices are not closed.
+ *
+ * @param       group   Group handle. May be NULL.
  */
-#define BLADERF_META_FLAG_RX_HW_UNDERFLOW (1 << 0)
+API_EXPORT
+void CALL_CONV bladerf_group_close(struct bladerf_group *group);
 
-/**
- * This flag is asserted in bladerf_metadata.status by the hardware if mini
- * expansion IO pin 1 is asserted.
- */
-#define BLADERF_META_FLAG_RX_HW_MINIEXP1 (1 << 16)
+/** @} (End of FN_GROUP) */
 
 /**
- * This flag is asserted in bladerf_metadata.status by the hardware if mini
- * expansion IO pin 2 is asserted.
+ * @defgroup FN_TIME_SYNC Host and device clock correlation
+ *
+ * A single bladerf_get_timestamp() call places a device timestamp somewhere
+ * within the USB round trip of the request, and devices' sample clocks
+ * drift relative to the host clock, and to each other, unless they share a
+ * reference perfectly.
+ *
+ * bladerf_get_timestamp_estimate() narrows this down. It reads the timestamp
+ * several times in a tight loop, and keeps the read with the shortest round
+ * trip, placing it at the midpoint of that round trip. Where the FPGA
+ * supports it, each read latches the timestamp as the request arrives and
+ * reports how long the device took to respond, which is excluded from the
+ * round trip.
+ *
+ * The time sync service correlates the host clock with a device's timestamp
+ * counter over time. A weighted linear fit over recent estimates yields the
+ * device clock's offset, and its rate relative to the host clock.
+ * Measurements can be taken on demand, or periodically on a background
+ * thread.
+ *
+ * The result maps host times to device timestamps and back. As every device
+ * is correlated against the same host clock, a TX burst can be scheduled on
+ * several devices for the same host time without a loopback calibration.
+ *
+ * Host times are in nanoseconds, as returned by bladerf_time_sync_host_ns().
+ *
+ * These functions are thread-safe.
+ *
+ * @{
  */
-#define BLADERF_META_FLAG_RX_HW_MINIEXP2 (1 << 17)
+
+/** Default number of timestamp reads per measurement */
+#define BLADERF_TIME_SYNC_PROBES_DEFAULT 16
 
 /**
- * Sample metadata
- *
- * This structure is used in conjunction with the ::BLADERF_FORMAT_SC16_Q11_META
- * format to TX scheduled bursts or retrieve timestamp information about
- * received samples.
+ * A device timestamp, and the host time at which it was sampled
  */
-struct bladerf_metadata {
-    /**
-     * Free-running FPGA counter that monotonically increases at the sample rate
-     * of the associated channel.
-     */
-    bladerf_timestamp timestamp;
+struct bladerf_timestamp_estimate {
+    bladerf_timestamp timestamp; /**< Device timestamp */
+    uint64_t host_ns;            /**< Host time of the timestamp, in ns */
 
     /**
-     * Input bit field to control the behavior of the call that the metadata
-     * structure is passed to. API calls read this field from the provided data
-     * structure, and do not modify it.
-     *
-     * Valid flags include
-     *  ::BLADERF_META_FLAG_TX_BURST_START,
-     *  ::BLADERF_META_FLAG_TX_BURST_END,
-     *  ::BLADERF_META_FLAG_TX_NOW,
-     *  ::BLADERF_META_FLAG_TX_UPDATE_TIMESTAMP, and
-     *  ::BLADERF_META_FLAG_RX_NOW
+     * The timestamp was sampled within this many ns of `host_ns`
      */
-    uint32_t flags;
+    uint64_t uncertainty_ns;
 
-    /**
-     * Output bit field to denoting the status of transmissions/receptions. API
-     * calls will write this field.
-     *
-     * Possible status flags include ::BLADERF_META_STATUS_OVERRUN and
-     * ::BLADERF_META_STATUS_UNDERRUN.
-     */
-    uint32_t status;
+    /** Device time excluded from the best read's round trip, in ns */
+    uint64_t hold_ns;
+
+    /** Whether the reads latched the timestamp on the device */
+    bool latched;
+};
+
+/** Number of recent measurements the clock fit is made over */
+#define BLADERF_TIME_SYNC_WINDOW 16
 
+/**
+ * Time sync configuration
+ */
+struct bladerf_time_sync_config {
     /**
-     * This output parameter is updated to reflect the actual number of
-     * contiguous samples that have been populated in an RX buffer during a
-     * bladerf_sync_rx() call.
-     *
-     * This will not be equal to the requested count in the event of a
-     * discontinuity (i.e., when the status field has the
-     * ::BLADERF_META_STATUS_OVERRUN flag set). When an overrun occurs, it is
-     * important not to read past the number of samples specified by this value,
-     * as the remaining contents of the buffer are undefined.
-     *
-     * @note This parameter is not currently used by bladerf_sync_tx().
+     * Timestamp reads per measurement. The read with the shortest round
+     * trip is kept. 0 selects ::BLADERF_TIME_SYNC_PROBES_DEFAULT.
      */
-    unsigned int actual_count;
+    unsigned int probes;
 
     /**
-     * Reserved for future use. This is not used by any functions. It is
-     * recommended that users zero out this field.
+     * Interval between measurements taken by the background thread, in ms.
+     * 0 disables the thread, so that measurements are only taken by
+     * bladerf_time_sync_measure().
      */
-    uint8_t reserved[32];
+    unsigned int interval_ms;
 };
 
-/** @} (End of STREAMING_FORMAT_METADATA) */
-
 /**
- * Interleaves contiguous blocks of samples in preparation for MIMO TX.
- *
- * Given a `buffer` loaded with data as such:
- *
- * <pre>
- *  .-------------------.--------------.--------------.------------------.
- *  |    Byte offset    | Bits 31...16 | Bits 15...0  |    Description   |
- *  +-------------------+--------------+--------------+------------------+
- *  |  0x00 + 0*chsize  |     Q0[0]    |     I0[0]    |  Ch 0, sample 0  |
- *  |  0x04 + 0*chsize  |     Q0[1]    |     I0[1]    |  Ch 0, sample 1  |
- *  |  0x08 + 0*chsize  |     Q0[2]    |     I0[2]    |  Ch 0, sample 2  |
- *  |  0x0c + 0*chsize  |     Q0[3]    |     I0[3]    |  Ch 0, sample 3  |
- *  |        ...        |      ...     |      ...     |        ...       |
- *  |  0x00 + 1*chsize  |     Q1[0]    |     I1[0]    |  Ch 1, sample 0  |
- *  |  0x04 + 1*chsize  |     Q1[1]    |     I1[1]    |  Ch 1, sample 1  |
- *  |  0x08 + 1*chsize  |     Q1[2]    |     I1[2]    |  Ch 1, sample 2  |
- *  |  0x0c + 1*chsize  |     Q1[3]    |     I1[3]    |  Ch 1, sample 3  |
- *  |        ...        |      ...     |      ...     |        ...       |
- *  `-------------------`--------------`--------------`------------------`
- * </pre>
- *
- * where \f$chsize = \frac{sizeof(buffer)}{num\_channels}\f$.
- *
- * This function interleaves the samples in the manner described by the
- * ::BLADERF_FORMAT_SC16_Q11 format, in place. Each channel must have
- * \f$buffer\_size / num\_channels\f$ samples, and they must be concatenated in
- * order.
- *
- * If the ::BLADERF_FORMAT_SC16_Q11_META format is specified, the first 16 bytes
- * will skipped.
- *
- * This function's inverse is bladerf_deinterleave_stream_buffer().
- *
- * @param[in]   layout        Stream direction and layout
- * @param[in]   format        Data format to use
- * @param[in]   buffer_size   The size of the buffer, in samples. Note that this
- *                            is the entire buffer, not just a single channel.
- * @param       samples       Buffer to process. The user is responsible for
- *                            ensuring this buffer contains exactly
- *                            `buffer_size` samples.
+ * Time sync state
+ */
+struct bladerf_time_sync_stats {
+    uint64_t measurements;   /**< Measurements taken since the fit was last
+                              *   reset */
+    unsigned int fit_points; /**< Measurements the fit is made over */
+
+    /**
+     * Estimated device timestamp rate, in ticks per host second. Until a
+     * second measurement is taken, this is the nominal sample rate.
+     */
+    double rate;
+
+    /**
+     * Device clock drift relative to the host clock, in parts per million
+     * of the nominal sample rate
+     */
+    double drift_ppm;
+
+    /** RMS deviation of the measurements from the fit, in ns */
+    double residual_ns;
+
+    /** Uncertainty of the latest measurement's best read, in ns */
+    uint64_t read_uncertainty_ns;
+
+    /**
+     * Uncertainty of a mapping at the latest measurement, in ns. This is
+     * the uncertainty of the latest best read, plus the fit residual.
+     */
+    double uncertainty_ns;
+};
+
+/**
+ * Get the current host time, in the clock used by the time sync service
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return Host time, in ns
  */
 API_EXPORT
-int CALL_CONV bladerf_interleave_stream_buffer(bladerf_channel_layout layout,
-                                               bladerf_format format,
-                                               unsigned int buffer_size,
-                                               void *samples);
+uint64_t CALL_CONV bladerf_time_sync_host_ns(void);
 
 /**
- * Deinterleaves samples into contiguous blocks after MIMO RX.
+ * Estimate when a device timestamp was sampled, in host time
  *
- * This function deinterleaves a multi-channel interleaved buffer, as described
- * by the ::BLADERF_FORMAT_SC16_Q11 format. The output is in the format
- * described as the input to this function's inverse,
- * bladerf_interleave_stream_buffer().
+ * The timestamp is read `samples` times in a tight loop, and the read that
+ * bounds the sample time most tightly is returned.
  *
- * If the ::BLADERF_FORMAT_SC16_Q11_META format is specified, the first 16 bytes
- * will skipped.
+ * FPGA v0.13.0 or later latches the timestamp as each request arrives. Older
+ * FPGAs fall back to bladerf_get_timestamp() reads, which are bounded only by
+ * the request's round trip.
  *
- * @param[in]   layout          Stream direction and layout
- * @param[in]   format          Data format to use
- * @param[in]   buffer_size     The size of the buffer, in samples. Note that
- *                              this is the entire buffer, not just a single
- *                              channel.
- * @param       samples         Buffer to process. The user is responsible for
- *                              ensuring this buffer contains exactly
- *                              `buffer_size` samples.
+ * @param       dev         Device handle
+ * @param[in]   dir         Stream direction
+ * @param[in]   samples     Number of reads. 0 selects
+ *                          ::BLADERF_TIME_SYNC_PROBES_DEFAULT.
+ * @param[out]  estimate    Updated with the best estimate
  *
  * @return 0 on success, value from \ref RETCODES list on failure
  */
 API_EXPORT
-int CALL_CONV bladerf_deinterleave_stream_buffer(bladerf_channel_layout layout,
-                                                 bladerf_format format,
-                                                 unsigned int buffer_size,
-                                                 void *samples);
-
-/** @} (End of STREAMING_FORMAT) */
+int CALL_CONV
+    bladerf_get_timestamp_estimate(struct bladerf *dev,
+                                   bladerf_direction dir,
+                                   unsigned int samples,
+                                   struct bladerf_timestamp_estimate *estimate);
 
 /**
- * Enable or disable the RF front end of the specified direction.
- *
- * RF front ends must always be enabled prior to streaming samples on the
- * associated interface.
+ * Enable, reconfigure, or disable the time sync service for a direction
  *
- * When a synchronous stream is associated with the specified channel, this will
- * shut down the underlying asynchronous stream when `enable` = false.
- *
- * When transmitting samples, be sure to provide ample time for TX samples reach
- * the RF front-end before calling this function with `enable` = false. (This
- * can be achieved easily when using metadata, as shown on
- * \link sync_tx_meta_bursts.html this page\endlink.)
+ * Enabling the service, or changing the device's sample rate, resets the
+ * fit. The first measurement is taken before this returns.
  *
  * @param       dev     Device handle
- * @param[in]   ch      Channel
- * @param[in]   enable  true to enable, false to disable
+ * @param[in]   dir     Direction whose timestamp counter is correlated
+ * @param[in]   config  Configuration, or NULL to disable the service
  *
  * @return 0 on success, value from \ref RETCODES list on failure
  */
 API_EXPORT
-int CALL_CONV bladerf_enable_module(struct bladerf *dev,
-                                    bladerf_channel ch,
-                                    bool enable);
+int CALL_CONV
+    bladerf_time_sync_configure(struct bladerf *dev,
+                                bladerf_direction dir,
+                                const struct bladerf_time_sync_config *config);
 
 /**
- * Retrieve the specified stream's current timestamp counter value from the
- * FPGA.
+ * Take a measurement now, and update the fit
  *
- * This function is only intended to be used to retrieve a coarse estimate of
- * the current timestamp when starting up a stream. It <b>should not</b> be used
- * as a means to accurately retrieve the current timestamp of individual samples
- * within a running stream. The reasons for this are:
- *  - The timestamp counter will have advanced during the time that the captured
- *      value is propagated back from the FPGA to the host
- *  - The value retrieved in this manner is not tightly-coupled with
- *      specific sample positions in the stream.
+ * A measurement that deviates from the fit by more than 1 ms is taken to be
+ * a restart of the timestamp counter (e.g., after a sample rate change), and
+ * resets the fit.
  *
- * When actively receiving a sample stream, instead use the
- * ::bladerf_metadata::timestamp field (provided when using the
- * ::BLADERF_FORMAT_SC16_Q11_META format) to retrieve the timestamp value
- * associated with a block of samples. See the \link sync_rx_meta.html RX with
- * metadata\endlink page for examples of this.
+ * @param       dev     Device handle
+ * @param[in]   dir     Direction
  *
- * An example use-case of this function is to schedule an initial TX burst in a
- * set of bursts:
+ * @return 0 on success, ::BLADERF_ERR_INVAL if the service is not enabled,
+ *         or value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_time_sync_measure(struct bladerf *dev,
+                                        bladerf_direction dir);
+
+/**
+ * Map a host time to a device timestamp
  *
- *  - Configure and start a TX stream using the ::BLADERF_FORMAT_SC16_Q11_META
- *      format.
- *  - Retrieve timestamp \f$T\f$, a coarse estimate the TX's current timestamp
- *      via this function.
- *  - Schedule the first burst, \f$F\f$ to occur in the future: \f$F = T + N\f$.
- *      Generally, adding \f$N\f$ in tens to low hundreds of milliseconds is
- *      sufficient to account for timestamp retrieval overhead and stream
- *      startup.
- *  - Schedule additional bursts relative to the first burst \f$F\f$.
+ * @param       dev         Device handle
+ * @param[in]   dir         Direction
+ * @param[in]   host_ns     Host time, in ns
+ * @param[out]  timestamp   Device timestamp at that host time
  *
- * Examples of the above are shown on the \link sync_tx_meta_bursts.html TX
- * with metadata\endlink page.
+ * @return 0 on success, ::BLADERF_ERR_INVAL if the service is not enabled,
+ *         or ::BLADERF_ERR_RANGE if the time maps to before the counter
+ *         started
+ */
+API_EXPORT
+int CALL_CONV bladerf_time_sync_host_to_device(struct bladerf *dev,
+                                               bladerf_direction dir,
+                                               uint64_t host_ns,
+                                               bladerf_timestamp *timestamp);
+
+/**
+ * Map a device timestamp to a host time
  *
  * @param       dev         Device handle
- * @param[in]   dir         Stream direction
- * @param[out]  timestamp   Coarse timestamp value
+ * @param[in]   dir         Direction
+ * @param[in]   timestamp   Device timestamp
+ * @param[out]  host_ns     Host time of that timestamp, in ns
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return 0 on success, ::BLADERF_ERR_INVAL if the service is not enabled
  */
 API_EXPORT
-int CALL_CONV bladerf_get_timestamp(struct bladerf *dev,
-                                    bladerf_direction dir,
-                                    bladerf_timestamp *timestamp);
+int CALL_CONV bladerf_time_sync_device_to_host(struct bladerf *dev,
+                                               bladerf_direction dir,
+                                               bladerf_timestamp timestamp,
+                                               uint64_t *host_ns);
 
 /**
- * @defgroup FN_STREAMING_SYNC  Synchronous API
+ * Get the state of the time sync service
  *
- * This group of functions presents synchronous, blocking calls (with optional
- * timeouts) for transmitting and receiving samples.
+ * @param       dev     Device handle
+ * @param[in]   dir     Direction
+ * @param[out]  stats   Updated with the service's state
  *
- * The synchronous interface is built atop the asynchronous interface, and is
- * generally less complex and easier to work with.  It alleviates the need to
- * explicitly spawn threads (it is done under the hood) and manually manage
- * sample buffers.
+ * @return 0 on success, ::BLADERF_ERR_INVAL if the service is not enabled
+ */
+API_EXPORT
+int CALL_CONV
+    bladerf_time_sync_get_stats(struct bladerf *dev,
+                                bladerf_direction dir,
+                                struct bladerf_time_sync_stats *stats);
+
+/** @} (End of FN_TIME_SYNC) */
+
+/**
+ * @defgroup FN_TELEMETRY Telemetry sampler
  *
- * Under the hood, this interface spawns worker threads to handle an
- * asynchronous stream and perform thread-safe buffer management.
+ * Polling the RFIC temperature, RSSI, board power and PLL lock state with
+ * their individual getters takes a handle lock acquisition and one or more
+ * blocking control transactions per reading, each of which may delay a
+ * retune or other time-critical control operation.
  *
- * These functions are thread-safe.
+ * The telemetry sampler instead reads the selected items on a background
+ * thread, at a configured interval, in a single acquisition of the handle
+ * lock. Reads that share a device register are combined. The results are
+ * published in a snapshot that bladerf_telemetry_get() copies out without
+ * locking and without any device I/O, so it may be called from any thread,
+ * including stream callbacks, as often as desired.
  *
- * The following pages provide additional information and example usage:
+ * The sampler requires C11 atomics. Not all items are available on all
+ * boards; those that are not are left clear in
+ * bladerf_telemetry::valid. At present, only the bladeRF 2.0 micro
+ * provides any of them.
  *
- *  - \link sync_no_meta.html Basic usage without metadata\endlink
- *  - \link sync_rx_meta.html Synchronous RX with metadata\endlink
- *  - \link sync_tx_meta_bursts.html Synchronous TX with metadata\endlink
+ * These functions are thread-safe.
  *
  * @{
  */
 
+/** RFIC temperature */
+#define BLADERF_TELEMETRY_TEMPERATURE (1 << 0)
+
+/** RSSI of each enabled RX channel */
+#define BLADERF_TELEMETRY_RSSI (1 << 1)
+
+/** Board power consumption */
+#define BLADERF_TELEMETRY_POWER (1 << 2)
+
+/** Reference clock PLL lock state */
+#define BLADERF_TELEMETRY_PLL_LOCK (1 << 3)
+
+/** All telemetry items */
+#define BLADERF_TELEMETRY_ALL                                     \
+    (BLADERF_TELEMETRY_TEMPERATURE | BLADERF_TELEMETRY_RSSI |     \
+     BLADERF_TELEMETRY_POWER | BLADERF_TELEMETRY_PLL_LOCK)
+
+/** Default sampling interval, in ms */
+#define BLADERF_TELEMETRY_INTERVAL_DEFAULT_MS 1000
+
+/** Shortest sampling interval, in ms */
+#define BLADERF_TELEMETRY_INTERVAL_MIN_MS 10
+
+/** Number of RX channels for which RSSI is reported */
+#define BLADERF_TELEMETRY_RX_CHANNELS 2
+
+/**
+ * Telemetry sampler configuration
+ */
+struct bladerf_telemetry_config {
+    /**
+     * Interval between samples, in ms. 0 selects
+     * ::BLADERF_TELEMETRY_INTERVAL_DEFAULT_MS.
+     */
+    unsigned int interval_ms;
+
+    /** Bitmask of BLADERF_TELEMETRY_* items to sample */
+    uint32_t items;
+};
+
 /**
- * (Re)Configure a device for synchronous transmission or reception
- *
- * This function sets up the device for the specified format and initializes
- * the underlying asynchronous stream parameters
- *
- * This function does not call bladerf_enable_module(). The API user is
- * responsible for enabling/disable streams when desired.
+ * Telemetry snapshot
+ */
+struct bladerf_telemetry {
+    /** Samples taken since the sampler was enabled */
+    uint64_t samples;
+
+    /** Host time of the sample, as returned by bladerf_time_sync_host_ns() */
+    uint64_t host_ns;
+
+    /** Bitmask of BLADERF_TELEMETRY_* items read by the sample */
+    uint32_t valid;
+
+    /** RFIC temperature, in degrees C */
+    float temperature;
+
+    /** Bit `i` set if the RSSI of RX channel `i` was read */
+    uint32_t rssi_channels;
+
+    /** Preamble RSSI of each RX channel, as by bladerf_get_rfic_rssi() */
+    int pre_rssi[BLADERF_TELEMETRY_RX_CHANNELS];
+
+    /** Symbol RSSI of each RX channel, as by bladerf_get_rfic_rssi() */
+    int sym_rssi[BLADERF_TELEMETRY_RX_CHANNELS];
+
+    /** Board power consumption, in W */
+    float power;
+
+    /** Reference clock PLL is locked */
+    bool pll_locked;
+};
+
+/**
+ * Enable, reconfigure, or disable the telemetry sampler
  *
- * Note that (re)configuring the TX direction does not affect the RX direction,
- * and vice versa. This call configures each direction independently.
+ * The first sample is taken before this returns.
  *
- * Memory allocated by this function will be deallocated when bladerf_close()
- * is called.
+ * @param       dev     Device handle
+ * @param[in]   config  Configuration, or NULL to disable the sampler
  *
- * @see The bladerf_init_stream() documentation for information on determining
- *      appropriate values for `buffers_size`, `num_transfers`, and
- *      `stream_timeout`.
+ * @return 0 on success, ::BLADERF_ERR_INVAL for an invalid configuration,
+ *         ::BLADERF_ERR_UNSUPPORTED if none of the requested items are
+ *         available, or value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV
+    bladerf_telemetry_configure(struct bladerf *dev,
+                                const struct bladerf_telemetry_config *config);
+
+/**
+ * Copy out the most recent telemetry snapshot
  *
- * @note The `num_buffers` parameter should generally be increased as the amount
- *       of work done between bladerf_sync_rx() or bladerf_sync_tx() calls
- *       increases.
+ * This does not lock the device or perform any device I/O.
  *
- * @param       dev             Device to configure
- * @param[in]   layout          Stream direction and layout
- * @param[in]   format          Format to use in synchronous data transfers
- * @param[in]   num_buffers     The number of buffers to use in the underlying
- *                              data stream. This must be greater than the
- *                              `num_xfers` parameter.
- * @param[in]   buffer_size     The size of the underlying stream buffers, in
- *                              samples. This value must be a multiple of 1024.
- *                              Note that samples are only transferred when a
- *                              buffer of this size is filled.
- * @param[in]   num_transfers   The number of active USB transfers that may be
- *                              in-flight at any given time. If unsure of what
- *                              to use here, try values of 4, 8, or 16.
- * @param[in]   stream_timeout  Timeout (milliseconds) for transfers in the
- *                              underlying data stream.
+ * @param       dev         Device handle
+ * @param[out]  snapshot    Updated with the most recent sample
  *
- * @return 0 on success,
- *         ::BLADERF_ERR_UNSUPPORTED if libbladeRF is not built with support
- *         for this functionality,
- *         or a value from \ref RETCODES list on failures.
+ * @return 0 on success, ::BLADERF_ERR_INVAL if the sampler is not enabled
  */
 API_EXPORT
-int CALL_CONV bladerf_sync_config(struct bladerf *dev,
-                                  bladerf_channel_layout layout,
-                                  bladerf_format format,
-                                  unsigned int num_buffers,
-                                  unsigned int buffer_size,
-                                  unsigned int num_transfers,
-                                  unsigned int stream_timeout);
+int CALL_CONV bladerf_telemetry_get(struct bladerf *dev,
+                                    struct bladerf_telemetry *snapshot);
+
+/** @} (End of FN_TELEMETRY) */
 
 /**
- * Transmit IQ samples.
+ * @defgroup FN_REPEATER RX to TX repeater
  *
- * Under the hood, this call starts up an underlying asynchronous stream as
- * needed. This stream can be stopped by disabling the TX channel. (See
- * bladerf_enable_module for more details.)
+ * A repeater retransmits the samples received on one channel, a fixed
+ * number of samples after they were received. The TX channel may be on the
+ * same device, or on another device whose timestamp counter runs in step
+ * with the receiving device's (e.g., having shared a reference clock and
+ * been started by a common trigger, as described in \ref FN_TRIG).
  *
- * Samples will only be sent to the FPGA when a buffer have been filled. The
- * number of samples required to fill a buffer corresponds to the `buffer_size`
- * parameter passed to bladerf_sync_config().
+ * The repeater runs an RX and a TX asynchronous stream of
+ * ::BLADERF_FORMAT_SC16_Q11_META. Received buffers are not copied. Each is
+ * handed to the TX stream as is, once the timestamp in each of its message
+ * headers has been advanced by the configured delay. The two streams share
+ * one pool of buffers, and a received buffer goes straight to an idle TX
+ * transfer where there is one.
  *
- * @pre A bladerf_sync_config() call has been to configure the device for
- *      synchronous data transfer.
+ * Each sample is therefore transmitted at exactly its receive timestamp
+ * plus the delay. The delay must cover one buffer, plus the time taken for
+ * a buffer to cross USB in each direction. Two or three buffers is a
+ * typical choice. It should not exceed the buffers that the TX stream keeps
+ * in flight, `num_transfers`, or received buffers will back up and be
+ * dropped.
  *
- * @note A call to bladerf_enable_module() should be made before attempting to
- *       transmit samples. Failing to do this may result in timeouts and other
- *       errors.
+ * The repeater owns the asynchronous streams of both directions that it
+ * uses, and enables the RX and TX channels while it runs. The sample rates,
+ * frequencies and gains are left to the caller.
  *
- * @param       dev         Device handle
- * @param[in]   samples     Array of samples
- * @param[in]   num_samples Number of samples to write
- * @param[in]   metadata    Sample metadata. This must be provided when using
- *                          the ::BLADERF_FORMAT_SC16_Q11_META format, but may
- *                          be NULL when the interface is configured for
- *                          the ::BLADERF_FORMAT_SC16_Q11 format.
- * @param[in]   timeout_ms  Timeout (milliseconds) for this call to complete.
- *                          Zero implies "infinite."
+ * @{
+ */
+
+/** Opaque repeater handle */
+struct bladerf_repeater;
+
+/**
+ * Repeater configuration
+ */
+struct bladerf_repeater_config {
+    bladerf_channel rx_channel; /**< Channel to receive from */
+    bladerf_channel tx_channel; /**< Channel to transmit from */
+
+    /**
+     * Number of buffers shared by the two streams. Each stream keeps
+     * `num_transfers` in flight, so this must exceed twice that number.
+     */
+    unsigned int num_buffers;
+
+    /**
+     * Samples per buffer, including the metadata headers as with
+     * bladerf_init_stream(). This must be a multiple of 1024.
+     */
+    unsigned int buffer_size;
+
+    unsigned int num_transfers; /**< Transfers in flight in each stream */
+
+    /** Delay between reception and transmission, in samples */
+    uint64_t delay;
+};
+
+/**
+ * Repeater statistics
+ */
+struct bladerf_repeater_stats {
+    uint64_t relayed;         /**< Buffers transmitted */
+    uint64_t dropped;         /**< Received buffers dropped because TX had
+                               *   fallen behind */
+    uint64_t underruns;       /**< Times that TX ran out of buffers to send */
+    uint64_t discontinuities; /**< Gaps in the received timestamps, such as
+                               *   from RX overruns. These are reproduced
+                               *   in the transmission. */
+};
+
+/**
+ * Start a repeater
  *
- * @return 0 on success,
- *         ::BLADERF_ERR_UNSUPPORTED if libbladeRF is not built with support
- *         for this functionality,
- *         or a value from \ref RETCODES list on failures.
+ * The devices must already be open, and remain owned by the caller. They
+ * must stay open until the repeater is stopped.
+ *
+ * @param[out]  rep         Updated with the repeater handle on success
+ * @param       rx_dev      Device to receive from
+ * @param       tx_dev      Device to transmit from. This may be `rx_dev`.
+ * @param[in]   config      Repeater configuration
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV
+    bladerf_repeater_start(struct bladerf_repeater **rep,
+                           struct bladerf *rx_dev,
+                           struct bladerf *tx_dev,
+                           const struct bladerf_repeater_config *config);
+
+/**
+ * Get the statistics of a running repeater
+ *
+ * @param       rep     Repeater handle
+ * @param[out]  stats   Updated with the repeater's statistics
+ *
+ * @return 0 on success, or the failure from \ref RETCODES list that ended
+ *         one of the repeater's streams
  */
 API_EXPORT
-int CALL_CONV bladerf_sync_tx(struct bladerf *dev,
-                              const void *samples,
-                              unsigned int num_samples,
-                              struct bladerf_metadata *metadata,
-                              unsigned int timeout_ms);
+int CALL_CONV bladerf_repeater_get_stats(struct bladerf_repeater *rep,
+                                         struct bladerf_repeater_stats *stats);
 
 /**
- * Receive IQ samples.
+ * Stop a repeater's streams, disable its channels, and free it
  *
- * Under the hood, this call starts up an underlying asynchronous stream as
- * needed. This stream can be stopped by disabling the RX channel. (See
- * bladerf_enable_module for more details.)
+ * @param       rep     Repeater handle. May be NULL.
  *
- * @pre A bladerf_sync_config() call has been to configure the device for
- *      synchronous data transfer.
+ * @return 0 on success, or the first failure from \ref RETCODES list
+ */
+API_EXPORT
+int CALL_CONV bladerf_repeater_stop(struct bladerf_repeater *rep);
+
+/** @} (End of FN_REPEATER) */
+
+/**
+ * @defgroup FN_SHM_SERVER Sharing a device between processes
+ *
+ * One process opens a device as usual and serves it via a POSIX shared
+ * memory segment. Other processes then open the device with bladerf_open()
+ * as they would any other, and reach it via the ::BLADERF_BACKEND_SHM
+ * backend, which libbladeRF selects for a served device. Served devices are
+ * also reported by bladerf_get_device_list().
+ *
+ * The serving process performs its clients' control transfers on their
+ * behalf, one at a time. While any client streams RX, the server receives
+ * into a ring of slots in the segment, which all such clients read
+ * concurrently. A single client at a time may stream TX, which it writes to
+ * a second ring. The server does not copy samples. Each client copies them
+ * from or to its own stream buffers.
+ *
+ * The device's configuration is shared by all of its users:
+ *  - Sample rates, frequencies, gains and sample formats apply to every
+ *    client. Clients sharing RX should agree on a format, such as each
+ *    using ::BLADERF_FORMAT_SC16_Q11_META. ::BLADERF_FORMAT_PACKET_META is
+ *    not supported.
+ *  - A module stays enabled while any client has it enabled.
+ *  - Register caches are kept by each process. It is therefore recommended
+ *    that a single client makes configuration changes.
+ *  - Flash and FPGA operations should not be performed while other clients
+ *    are in use.
+ *  - Clients run the board's usual open sequence. This preserves the
+ *    configuration of a bladeRF x40/x115, but initializes the RFIC of a
+ *    bladeRF 2.0 micro, so its clients should be opened before streaming
+ *    begins.
+ *
+ * The serving process itself should not stream on its handle. To stream, it
+ * may open a second handle, which becomes a client.
+ *
+ * A client that falls more than a ring's worth of slots behind skips ahead
+ * to the newest samples, which is reported as an overrun in its stream
+ * statistics.
+ *
+ * This is only available on Linux.
  *
- * @note A call to bladerf_enable_module() should be made before attempting to
- *       receive samples. Failing to do this may result in timeouts and other
- *       errors.
+ * @{
+ */
+
+/**
+ * Serve a device to other processes
+ *
+ * The device must have been opened via a USB backend, with its FPGA loaded.
+ * The server runs until bladerf_shm_server_stop() or bladerf_close().
  *
  * @param       dev         Device handle
- * @param[out]  samples     Buffer to store samples in. The caller is
- *                          responsible for ensuring this buffer is sufficiently
- *                          large for the number of samples requested,
- *                          considering the size of the sample format being
- *                          used.
- * @param[in]   num_samples Number of samples to read
- * @param[out]  metadata    Sample metadata. This must be provided when using
- *                          the ::BLADERF_FORMAT_SC16_Q11_META format, but may
- *                          be NULL when the interface is configured for
- *                          the ::BLADERF_FORMAT_SC16_Q11 format.
- * @param[in]   timeout_ms  Timeout (milliseconds) for this call to complete.
- *                          Zero implies "infinite."
+ * @param[in]   num_slots   Number of slots in each of the RX and TX rings.
+ *                          This must be at least 4. Half, up to 32, are
+ *                          kept in flight as USB transfers.
+ * @param[in]   slot_size   Size of each slot, in bytes. This must be a
+ *                          multiple of 4096. A client's TX buffers may not
+ *                          exceed it.
  *
- * @return 0 on success,
- *         ::BLADERF_ERR_UNSUPPORTED if libbladeRF is not built with support
- *         for this functionality,
- *         or a value from \ref RETCODES list on failures.
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if the device was not
+ *         opened via a USB backend or this functionality was not built, or
+ *         a value from \ref RETCODES list on failure
  */
 API_EXPORT
-int CALL_CONV bladerf_sync_rx(struct bladerf *dev,
-                              void *samples,
-                              unsigned int num_samples,
-                              struct bladerf_metadata *metadata,
-                              unsigned int timeout_ms);
+int CALL_CONV bladerf_shm_server_start(struct bladerf *dev,
+                                       unsigned int num_slots,
+                                       unsigned int slot_size);
 
+/**
+ * Stop serving a device
+ *
+ * Clients' subsequent operations fail with ::BLADERF_ERR_IO, and they
+ * should be closed. Modules that clients left enabled are disabled.
+ *
+ * @param       dev         Device handle
+ *
+ * @return 0 on success, or ::BLADERF_ERR_INVAL if the device is not being
+ *         served
+ */
+API_EXPORT
+int CALL_CONV bladerf_shm_server_stop(struct bladerf *dev);
 
-/** @} (End of FN_STREAMING_SYNC) */
+/** @} (End of FN_SHM_SERVER) */
 
 /**
  * @defgroup FN_STREAMING_ASYNC    Asynchronous API
@@ -2773,8 +6821,7 @@ struct bladerf_stream;
  * For both RX and TX, the stream callback receives:
  *  - dev:          Device structure
  *  - stream:       The associated stream
- *  - metadata:     For future support - do not attempt to read/write this
- *                  in the current library implementation.
+ *  - metadata:     See below
  *  - user_data:    User data provided when initializing stream
  *
  * For TX callbacks:
@@ -2789,6 +6836,26 @@ struct bladerf_stream;
  *  - Return value:     The user specifies the next buffer to fill with RX data,
  *                      which should be `num_samples` in size,
  *                      ::BLADERF_STREAM_SHUTDOWN, or ::BLADERF_STREAM_NO_DATA.
+ *
+ * For RX streams using ::BLADERF_FORMAT_SC16_Q11_META or
+ * ::BLADERF_FORMAT_SC8_Q7_META, the metadata describes the first message of
+ * the received buffer:
+ *  - timestamp:    Timestamp of the first sample in the buffer
+ *  - flags:        The first message's `BLADERF_META_FLAG_RX_HW_*` flags
+ *  - actual_count: Number of samples, excluding message headers, that are
+ *                  contiguous with the first sample. When this does not
+ *                  cover the entire buffer, ::BLADERF_META_STATUS_OVERRUN is
+ *                  set in `status`.
+ *  - gap:          Number of samples lost between the previous buffer and
+ *                  this one
+ *
+ * Use bladerf_get_stream_msgs() to obtain the timestamp and flags of each
+ * message in the buffer. In batch callbacks, the metadata describes the first
+ * buffer of the batch.
+ *
+ * Otherwise, the metadata is zeroed. TX callbacks for streams using
+ * ::BLADERF_FORMAT_PACKET_META set `actual_count` to the length of the
+ * returned buffer, and must not otherwise read or write the metadata.
  */
 typedef void *(*bladerf_stream_cb)(struct bladerf *dev,
                                    struct bladerf_stream *stream,
@@ -2870,6 +6937,100 @@ int CALL_CONV bladerf_init_stream(struct bladerf_stream **stream,
                                   size_t num_transfers,
                                   void *user_data);
 
+/**
+ * This typedef represents a callback function that handles several completed
+ * transfers at once. See bladerf_set_stream_batch().
+ *
+ * The constraints described for ::bladerf_stream_cb apply here as well.
+ *
+ * The batch callback receives:
+ *  - dev, stream, meta, user_data:  As for ::bladerf_stream_cb
+ *  - buffers:      Array of `num_buffers` buffers whose transfers completed,
+ *                  oldest first. When a TX stream requests its initial
+ *                  buffers, the entry is NULL.
+ *  - num_buffers:  Number of entries in `buffers`
+ *  - num_samples:  Number of samples in each of the buffers, and the size of
+ *                  the next buffers
+ *
+ * Before returning, the callback replaces each entry of `buffers` with the
+ * next buffer to transmit or fill in its place, ::BLADERF_STREAM_NO_DATA, or
+ * ::BLADERF_STREAM_SHUTDOWN. Entries are processed in order, and those
+ * following a ::BLADERF_STREAM_SHUTDOWN are ignored.
+ */
+typedef void (*bladerf_stream_batch_cb)(struct bladerf *dev,
+                                        struct bladerf_stream *stream,
+                                        struct bladerf_metadata *meta,
+                                        void **buffers,
+                                        size_t num_buffers,
+                                        size_t num_samples,
+                                        void *user_data);
+
+/**
+ * Deliver a stream's completed transfers to a callback in batches
+ *
+ * By default, the stream callback is invoked and a transfer is resubmitted for
+ * each completed transfer. When buffers are small and many transfers are in
+ * flight, the associated locking and submission overhead can dominate.
+ *
+ * In batched mode, completed transfers are accumulated and provided to
+ * `callback` up to `max_batch` at a time. The buffers it returns are then
+ * submitted together. A partial batch is delivered as soon as no further
+ * completions are pending, so batching does not stall a stream.
+ *
+ * Completions are presently only accumulated by the libusb backend. Other
+ * backends invoke `callback` with one buffer per call.
+ *
+ * @param       stream      Stream handle. The stream must not be running.
+ * @param[in]   callback    Batch callback, which is used in place of the
+ *                          callback provided to bladerf_init_stream(). Pass
+ *                          NULL to revert to that callback.
+ * @param[in]   max_batch   Maximum number of buffers per callback. Values
+ *                          exceeding the stream's number of transfers are
+ *                          treated as that number.
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED for streams using
+ *         ::BLADERF_FORMAT_PACKET_META, or another value from \ref RETCODES
+ *         on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_stream_batch(struct bladerf_stream *stream,
+                                       bladerf_stream_batch_cb callback,
+                                       size_t max_batch);
+
+/**
+ * Location and header contents of a message within an RX stream buffer
+ */
+struct bladerf_stream_msg {
+    bladerf_timestamp timestamp; /**< Timestamp of the message's first
+                                  *   sample */
+    uint32_t flags;              /**< `BLADERF_META_FLAG_RX_HW_*` flags */
+    void *samples;               /**< First sample, following the header */
+    unsigned int num_samples;    /**< Number of samples in the message */
+};
+
+/**
+ * Index the messages of a buffer received by an RX stream using
+ * ::BLADERF_FORMAT_SC16_Q11_META or ::BLADERF_FORMAT_SC8_Q7_META
+ *
+ * This saves callbacks from parsing each message header themselves.
+ *
+ * @param       stream      Stream the buffer was received on
+ * @param[in]   buffer      Buffer provided to the stream callback
+ * @param[in]   num_samples Number of samples provided with the buffer
+ * @param[out]  msgs        Updated with the buffer's messages, in order
+ * @param[in]   max_msgs    Number of entries available in `msgs`
+ *
+ * @return Number of messages indexed, which is at most `max_msgs`, on
+ *         success, ::BLADERF_ERR_UNSUPPORTED if the stream's format does not
+ *         carry metadata, or another value from \ref RETCODES on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_stream_msgs(struct bladerf_stream *stream,
+                                      void *buffer,
+                                      size_t num_samples,
+                                      struct bladerf_stream_msg *msgs,
+                                      size_t max_msgs);
+
 /**
  * Begin running a stream. This call will block until the stream completes.
  *
@@ -2991,6 +7152,24 @@ int CALL_CONV bladerf_get_stream_timeout(struct bladerf *dev,
                                          bladerf_direction dir,
                                          unsigned int *timeout);
 
+/**
+ * Retrieve throughput and health counters for an asynchronous stream
+ *
+ * This may be called from any thread, including from within the stream
+ * callback.
+ *
+ * @param       stream      Stream handle
+ * @param[out]  stats       Updated with the current counter values. The
+ *                          `overruns`, `underruns` and `max_buffer_full_us`
+ *                          fields are only maintained by the synchronous
+ *                          interface, and are zero here.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_stream_stats(struct bladerf_stream *stream,
+                                       struct bladerf_stream_stats *stats);
+
 /** @} (End of FN_STREAMING_ASYNC) */
 
 /** @} (End of STREAMING) */
@@ -3026,6 +7205,11 @@ int CALL_CONV bladerf_flash_firmware(struct bladerf *dev, const char *firmware);
 /**
  * Load device's FPGA.
  *
+ * With FX3 firmware v2.5.0 or later, the firmware records a digest of each
+ * bitstream loaded by the host. If the device has already been initialized
+ * with the same bitstream, by this or any earlier process, it is not
+ * reloaded and this returns immediately.
+ *
  * @note This FPGA configuration will be reset at the next power cycle.
  *
  * @param       dev         Device handle
@@ -3059,6 +7243,60 @@ int CALL_CONV bladerf_flash_fpga(struct bladerf *dev, const char *fpga_image);
 API_EXPORT
 int CALL_CONV bladerf_erase_stored_fpga(struct bladerf *dev);
 
+/**
+ * Methods by which bladerf_flash_firmware() and bladerf_flash_fpga() update
+ * the flash
+ */
+typedef enum {
+    /** Erase the entire region, write the image, and then read back and
+     *  verify it. This is the default. */
+    BLADERF_FLASH_WRITE_FULL,
+
+    /** Read back each erase block of the region, and only erase, write, and
+     *  verify those whose contents differ from the image. When reflashing a
+     *  similar image, this avoids most of the erases and writes, as well as
+     *  the separate verification pass. */
+    BLADERF_FLASH_WRITE_DIFFERENTIAL,
+} bladerf_flash_write_mode;
+
+/**
+ * Statistics describing the most recent bladerf_flash_firmware() or
+ * bladerf_flash_fpga() call
+ */
+struct bladerf_flash_write_stats {
+    uint32_t blocks_total;   /**< Erase blocks in the region */
+    uint32_t blocks_updated; /**< Erase blocks erased and rewritten */
+    uint64_t bytes_written;  /**< Bytes written to flash */
+};
+
+/**
+ * Select the method by which bladerf_flash_firmware() and
+ * bladerf_flash_fpga() update the flash
+ *
+ * @param       dev         Device handle
+ * @param[in]   mode        Write mode
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_flash_write_mode(struct bladerf *dev,
+                                           bladerf_flash_write_mode mode);
+
+/**
+ * Get statistics describing the most recent bladerf_flash_firmware() or
+ * bladerf_flash_fpga() call
+ *
+ * @param       dev         Device handle
+ * @param[out]  stats       Statistics. These are zero if neither function
+ *                          has yet been called.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV
+    bladerf_get_flash_write_stats(struct bladerf *dev,
+                                  struct bladerf_flash_write_stats *stats);
+
 /**
  * Reset the device, causing it to reload its firmware from flash
  *
@@ -3120,6 +7358,10 @@ int CALL_CONV bladerf_get_bootloader_list(struct bladerf_devinfo **list);
  * is desired, open the newly enumerated device with bladerf_open() and use
  * bladerf_flash_firmware().
  *
+ * @note The uploaded image is read back and its checksum verified before it
+ * is executed. Set the BLADERF_SKIP_BOOTLOADER_VERIFY environment variable
+ * to skip this step when a faster RAM boot is preferred.
+ *
  * @param[in]   device_identifier   Device identifier string describing the
  *                                  backend to use via the
  *                                  `<backend>:device=<bus>:<addr>` syntax.  If
@@ -3264,8 +7506,7 @@ struct bladerf_image {
  *
  * @note A non-zero `length` should be use only with bladerf_image_write();
  *       bladerf_image_read() allocates and sets `data` based upon size of the
- *       image contents, and does not attempt to free() the `data` field before
- *       setting it.
+ *       image contents, freeing any previous `data`.
  *
  * The `address` and `length` fields should be set 0 when reading an image from
  * a file.
@@ -3350,6 +7591,35 @@ int CALL_CONV bladerf_image_write(struct bladerf *dev,
 API_EXPORT
 int CALL_CONV bladerf_image_read(struct bladerf_image *image, const char *file);
 
+/**
+ * Back up a region of flash to an image file.
+ *
+ * This produces the same file as reading the region into an image's `data`
+ * and passing it to bladerf_image_write(), without holding the region in
+ * memory. The region is read in chunks, each of which is hashed and written
+ * to the file while the next is read from the device.
+ *
+ * The image's serial number is that of the device, and its remaining
+ * metadata are the defaults provided by bladerf_alloc_image().
+ *
+ * @param[in]    dev         Device handle
+ * @param[in]    type        Image type
+ * @param[in]    address     Flash address of the region. This must be
+ *                           page-aligned, or erase block-aligned for
+ *                           ::BLADERF_IMAGE_TYPE_RAW.
+ * @param[in]    length      Length of the region, in bytes, with the same
+ *                           alignment requirements as `address`
+ * @param[in]    file        File to write the flash image to
+ *
+ * @return 0 upon success, or a value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_image_backup(struct bladerf *dev,
+                                   bladerf_image_type type,
+                                   uint32_t address,
+                                   uint32_t length,
+                                   const char *file);
+
 /** @} (End of FN_IMAGE) */
 
 /**
@@ -3398,6 +7668,14 @@ typedef enum {
 /**
  * Set the VCTCXO tamer mode.
  *
+ * On the bladeRF x40/x115, the trim DAC value and tuning slope the tamer
+ * settles on are saved when the tamer is disabled or the device is closed,
+ * per device serial, in the user's bladeRF config directory. The VCTCXO is
+ * trimmed with the saved value when the device is next opened, and enabling
+ * the tamer starts fine tuning from it, without first sweeping the trim
+ * range, provided the FPGA supports it (v0.13.0 and later). Define
+ * BLADERF_DISABLE_VCTCXO_TRIM_CACHE in the environment to disable this.
+ *
  * @param       dev         Device handle
  * @param[in]   mode        VCTCXO taming mode
  *
@@ -3927,6 +8205,302 @@ int CALL_CONV bladerf_get_rf_ports(struct bladerf *dev,
 
 /** @} (End of FN_RF_PORTS) */
 
+/**
+ * @defgroup FN_CTRL_TRACE Control-path tracing
+ *
+ * When enabled, every NIOS II packet and FX3 vendor command issued to a
+ * device is recorded, along with its round-trip time and status, in a
+ * per-device ring of ::BLADERF_CTRL_TRACE_LEN entries. Recording does not
+ * block, and does not take the device's handle lock.
+ *
+ * If entries are not read quickly enough, the oldest are overwritten. The
+ * number of entries lost in this manner is reported by
+ * bladerf_read_ctrl_trace().
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Number of entries retained in a device's control trace
+ */
+#define BLADERF_CTRL_TRACE_LEN 4096
+
+/**
+ * Type of a traced control transaction
+ */
+typedef enum {
+    BLADERF_CTRL_TRACE_NIOS,   /**< NIOS II packet. The opcode is the packet's
+                                *   magic value (see `nios_pkt_formats.h`). */
+    BLADERF_CTRL_TRACE_VENDOR, /**< FX3 vendor command. The opcode is the
+                                *   request (see `bladeRF.h`). */
+} bladerf_ctrl_trace_kind;
+
+/**
+ * A traced control transaction
+ */
+struct bladerf_ctrl_trace_entry {
+    uint64_t timestamp;           /**< Host time at submission, in ns */
+    uint64_t duration;            /**< Round-trip time, in ns */
+    bladerf_ctrl_trace_kind kind; /**< Transaction type */
+    uint8_t opcode;               /**< Packet magic or vendor request */
+    uint8_t target;               /**< NIOS II packet target ID, or 0 for
+                                   *   packets without one and for vendor
+                                   *   commands */
+    bool write;                   /**< Transaction writes to the device */
+    int status;                   /**< 0 on success, or a value from
+                                   *   \ref RETCODES */
+};
+
+/**
+ * Enable or disable control-path tracing
+ *
+ * Entries recorded prior to disabling tracing remain available to
+ * bladerf_read_ctrl_trace(). Enabling tracing does not discard them.
+ *
+ * @param       dev         Device handle
+ * @param[in]   enable      Set true to enable tracing, false to disable it
+ *
+ * @return 0 on success, BLADERF_ERR_UNSUPPORTED if the library was built
+ *         without C11 atomics, or a value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_enable_ctrl_trace(struct bladerf *dev, bool enable);
+
+/**
+ * Read and remove traced transactions, oldest first
+ *
+ * @param       dev         Device handle
+ * @param[out]  entries     Populated with up to `max_entries` entries
+ * @param[in]   max_entries Capacity of `entries`
+ * @param[out]  num_read    Set to the number of entries read
+ * @param[out]  dropped     If non-NULL, set to the number of entries that
+ *                          were overwritten before they could be read,
+ *                          since the previous call
+ *
+ * @return 0 on success, BLADERF_ERR_UNSUPPORTED if tracing was never enabled,
+ *         or a value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV
+    bladerf_read_ctrl_trace(struct bladerf *dev,
+                            struct bladerf_ctrl_trace_entry *entries,
+                            unsigned int max_entries,
+                            unsigned int *num_read,
+                            uint64_t *dropped);
+
+/** @} (End of FN_CTRL_TRACE) */
+
+/**
+ * @defgroup FN_TIMELINE Stream timeline
+ *
+ * When enabled, a device records a timeline of the events surrounding its
+ * streams into a ring of the most recent ::BLADERF_TIMELINE_LEN events:
+ *
+ *  - Transitions of the synchronous interface's RX and TX state machines
+ *  - Each sync buffer's status changes, as it is filled and drained
+ *  - Sync worker state changes, and the entry and exit of each stream
+ *    callback
+ *  - Control transactions, as reported by \ref FN_CTRL_TRACE
+ *  - Scheduled retunes
+ *  - Failed synchronous calls, and overruns reported in RX metadata
+ *
+ * The timeline may be written out at any time, or automatically upon the
+ * first error, as a JSON trace that may be opened with Perfetto
+ * (https://ui.perfetto.dev) or `chrome://tracing`. Each sync buffer is
+ * displayed on its own track, alongside the state machines, callbacks, and
+ * control transactions.
+ *
+ * Recording does not block, and does not take the device's handle lock.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Number of events retained in a device's timeline
+ */
+#define BLADERF_TIMELINE_LEN 16384
+
+/**
+ * Enable or disable the stream timeline
+ *
+ * Events recorded prior to disabling the timeline remain available to
+ * bladerf_dump_timeline(). Enabling it does not discard them.
+ *
+ * @param       dev         Device handle
+ * @param[in]   enable      Set true to enable the timeline, false to disable
+ *                          it
+ *
+ * @return 0 on success, BLADERF_ERR_UNSUPPORTED if the library was built
+ *         without C11 atomics, or a value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_enable_timeline(struct bladerf *dev, bool enable);
+
+/**
+ * Write the timeline's retained events to a file, as a Chrome JSON trace
+ *
+ * The events are not removed, so successive dumps overlap.
+ *
+ * @param       dev         Device handle
+ * @param[in]   path        File to write
+ *
+ * @return 0 on success, BLADERF_ERR_UNSUPPORTED if the timeline was never
+ *         enabled, BLADERF_ERR_IO if the file could not be written, or a
+ *         value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_dump_timeline(struct bladerf *dev, const char *path);
+
+/**
+ * Write the timeline to a file when a synchronous call next fails, or
+ * reports an overrun in its metadata
+ *
+ * The dump is written once, by the thread that observed the error, before
+ * its call returns. Call this again to re-arm it. A timeout or
+ * ::BLADERF_ERR_WOULD_BLOCK from a non-blocking call is not considered an
+ * error for this purpose, nor is a call rejected before it reaches the sync
+ * interface, such as one made while the module is disabled.
+ *
+ * @param       dev         Device handle
+ * @param[in]   path        File to write, or NULL to cancel a pending dump
+ *
+ * @return 0 on success, BLADERF_ERR_UNSUPPORTED if the timeline was never
+ *         enabled, or a value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_timeline_error_dump(struct bladerf *dev,
+                                              const char *path);
+
+/** @} (End of FN_TIMELINE) */
+
+/**
+ * @defgroup FN_FX3_DMA FX3 sample buffering
+ *
+ * The FX3 buffers samples between the FPGA and the USB host in a ring of DMA
+ * buffers per direction. By default, each direction has
+ * ::BLADERF_FX3_DMA_DEFAULT_BUFFERS buffers of
+ * ::BLADERF_FX3_DMA_DEFAULT_BUFFER_PACKETS USB packets, which is a few
+ * microseconds of samples at high sample rates. Enlarging the ring lets
+ * receive streams ride out longer host scheduling gaps without an overrun,
+ * at the cost of latency.
+ *
+ * The size of a USB packet is 1024 bytes at SuperSpeed and 512 bytes at
+ * Hi-Speed. Each direction's ring may not exceed
+ * ::BLADERF_FX3_DMA_MAX_BYTES.
+ *
+ * These functions require FX3 firmware v2.5.0 or later, and are
+ * thread-safe.
+ *
+ * @{
+ */
+
+/** Default number of DMA buffers per direction */
+#define BLADERF_FX3_DMA_DEFAULT_BUFFERS 22
+
+/** Default size of each DMA buffer, in USB packets */
+#define BLADERF_FX3_DMA_DEFAULT_BUFFER_PACKETS 2
+
+/** Minimum number of DMA buffers per direction */
+#define BLADERF_FX3_DMA_MIN_BUFFERS 2
+
+/** Maximum number of DMA buffers per direction */
+#define BLADERF_FX3_DMA_MAX_BUFFERS 64
+
+/** Maximum size of each DMA buffer, in USB packets */
+#define BLADERF_FX3_DMA_MAX_BUFFER_PACKETS 32
+
+/** Maximum total size of each direction's DMA buffers, in bytes */
+#define BLADERF_FX3_DMA_MAX_BYTES (96 * 1024)
+
+/**
+ * Configure the FX3's sample DMA buffers
+ *
+ * This restarts the FX3's sample interface, which resets the FPGA's sample
+ * path. It must not be called while streams are active, and is best called
+ * right after bladerf_open(). The configuration persists until it is next
+ * changed or the FX3 is reset.
+ *
+ * @param       dev             Device handle
+ * @param[in]   num_buffers     Number of buffers per direction, from
+ *                              ::BLADERF_FX3_DMA_MIN_BUFFERS to
+ *                              ::BLADERF_FX3_DMA_MAX_BUFFERS. 0 restores the
+ *                              defaults.
+ * @param[in]   buffer_packets  Size of each buffer, in USB packets, from 1 to
+ *                              ::BLADERF_FX3_DMA_MAX_BUFFER_PACKETS. Ignored
+ *                              if `num_buffers` is 0.
+ *
+ * @return 0 on success, ::BLADERF_ERR_INVAL if the configuration is out of
+ *         range or exceeds ::BLADERF_FX3_DMA_MAX_BYTES at the current USB
+ *         speed, ::BLADERF_ERR_UNSUPPORTED if the firmware does not support
+ *         this, or a value from \ref RETCODES list on other failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_fx3_dma_buffers(struct bladerf *dev,
+                                          unsigned int num_buffers,
+                                          unsigned int buffer_packets);
+
+/**
+ * Get the FX3's sample DMA buffer configuration
+ *
+ * With firmware that predates this configuration, the defaults are
+ * returned.
+ *
+ * @param       dev             Device handle
+ * @param[out]  num_buffers     Number of buffers per direction
+ * @param[out]  buffer_packets  Size of each buffer, in USB packets
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure.
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_fx3_dma_buffers(struct bladerf *dev,
+                                          unsigned int *num_buffers,
+                                          unsigned int *buffer_packets);
+
+/**
+ * Counters of the FX3's sample paths
+ *
+ * Counts accumulate from when the FX3 starts, or was last reset via
+ * bladerf_get_fx3_stats(), and wrap at 2^32.
+ *
+ * Overruns and underruns occur when the FPGA finds no free DMA buffer to
+ * write received samples into, or no samples to transmit. Comparing them to
+ * the host's own stream metadata shows whether samples were lost in the FX3
+ * or on the host. USB retries and errors are only counted at SuperSpeed.
+ */
+struct bladerf_fx3_stats {
+    uint32_t tx_buffers;      /**< DMA buffers passed from the host to the
+                               *   FPGA */
+    uint32_t rx_buffers;      /**< DMA buffers passed from the FPGA to the
+                               *   host */
+    uint32_t rx_overruns;     /**< Received data with no free DMA buffer */
+    uint32_t tx_underruns;    /**< Transmit requests with no data */
+    uint32_t pib_errors;      /**< Other FPGA interface errors */
+    uint32_t usb_retries;     /**< Sample endpoint USB retries */
+    uint32_t usb_phy_errors;  /**< USB 3.0 PHY errors */
+    uint32_t usb_link_errors; /**< USB 3.0 link errors */
+};
+
+/**
+ * Read, and optionally reset, the FX3's sample path counters
+ *
+ * @param       dev     Device handle
+ * @param[out]  stats   Counters
+ * @param[in]   reset   Reset the counters after reading them
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if the firmware does not
+ *         support this, or a value from \ref RETCODES list on other failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_fx3_stats(struct bladerf *dev,
+                                    struct bladerf_fx3_stats *stats,
+                                    bool reset);
+
+/** @} (End of FN_FX3_DMA) */
+
 /** @} (End of FN_LOW_LEVEL) */
 
 /**
@@ -4020,6 +8594,57 @@ typedef enum {
 API_EXPORT
 void CALL_CONV bladerf_log_set_verbosity(bladerf_log_level level);
 
+/**
+ * Log message callback
+ *
+ * @param[in]   level       Severity level of the message
+ * @param[in]   msg         NUL-terminated message, including its level
+ *                          prefix and trailing newline. It is only valid for
+ *                          the duration of the call.
+ * @param[in]   user_data   Data provided to bladerf_log_set_callback()
+ */
+typedef void (*bladerf_log_callback)(bladerf_log_level level,
+                                     const char *msg,
+                                     void *user_data);
+
+/**
+ * Register a function to receive log messages, in place of the default
+ * output to stderr (or syslog, if enabled at compile-time).
+ *
+ * Messages passed to the callback are subject to the filter level set via
+ * bladerf_log_set_verbosity(), and are truncated to 255 characters. The
+ * callback may be invoked from any thread that logs, or from the background
+ * thread when asynchronous logging is enabled. It must not call into
+ * libbladeRF.
+ *
+ * @param[in]   cb          Callback, or NULL to restore the default output
+ * @param[in]   user_data   Caller-provided data passed to the callback
+ */
+API_EXPORT
+void CALL_CONV bladerf_log_set_callback(bladerf_log_callback cb,
+                                        void *user_data);
+
+/**
+ * Enable or disable asynchronous logging.
+ *
+ * When enabled, log messages are formatted into a lock-free ring and written
+ * out by a background thread, rather than by the thread that logs them. This
+ * prevents the time spent writing to stderr or syslog from stalling stream
+ * callbacks and the synchronous interface's worker thread. If the ring
+ * fills, messages are dropped and a count of them is logged.
+ *
+ * Disabling asynchronous logging writes out any queued messages before
+ * returning, so this should be done prior to exiting.
+ *
+ * @param[in]   enable      Enable asynchronous logging
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if libbladeRF was built
+ *         without support for asynchronous logging, or a value from \ref
+ *         RETCODES list on failure.
+ */
+API_EXPORT
+int CALL_CONV bladerf_log_set_async(bool enable);
+
 /** @} (End of FN_LOGGING) */
 
 /**
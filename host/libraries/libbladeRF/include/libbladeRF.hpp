@@ -0,0 +1,695 @@
+/**
+ * @file libbladeRF.hpp
+ *
+ * @brief Header-only C++17 interface to libbladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#ifndef LIBBLADERF_HPP_
+#define LIBBLADERF_HPP_
+
+#if !defined(__cplusplus) || (__cplusplus < 201703L && \
+                              (!defined(_MSVC_LANG) || _MSVC_LANG < 201703L))
+#error "libbladeRF.hpp requires C++17 or later"
+#endif
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<span>) && __cplusplus >= 202002L
+#include <span>
+#endif
+
+#include <libbladeRF.h>
+
+/**
+ * @defgroup FN_CPP C++ interface
+ *
+ * Thin, header-only C++17 wrappers around the C API.
+ *
+ * The wrappers own the underlying handles (closing devices and deinitializing
+ * streams when they go out of scope), but otherwise forward directly to the C
+ * functions: they do not allocate, copy samples, or throw exceptions. Errors
+ * are reported as the C API reports them, as a value from the \ref RETCODES
+ * list.
+ *
+ * @code
+ * bladeRF::device dev;
+ * bladeRF::rx_stream<bladeRF::cf32> rx;
+ * std::vector<bladeRF::cf32> samples(8192);
+ *
+ * int status = bladeRF::device::open(dev, nullptr);
+ * if (status == 0) {
+ *     status = bladeRF::rx_stream<bladeRF::cf32>::configure(rx, dev,
+ *                                                           BLADERF_RX_X1);
+ * }
+ * if (status == 0) {
+ *     status = rx.read(samples, nullptr, 1000);
+ * }
+ * @endcode
+ *
+ * These classes are not thread-safe; the thread-safety of the C functions
+ * they call applies.
+ *
+ * @{
+ */
+
+namespace bladeRF {
+
+/******************************************************************************/
+/* Sample views */
+/******************************************************************************/
+
+#if defined(__cpp_lib_span)
+/**
+ * Non-owning view of contiguous samples. This is std::span when it is
+ * available.
+ */
+template <typename T> using span = std::span<T>;
+#else
+/**
+ * Non-owning view of contiguous samples, providing the subset of
+ * std::span used by this interface.
+ */
+template <typename T> class span {
+public:
+    using element_type = T;
+    using value_type   = std::remove_cv_t<T>;
+    using size_type    = std::size_t;
+    using pointer      = T *;
+    using iterator     = T *;
+
+    constexpr span() noexcept : data_(nullptr), size_(0) {}
+
+    constexpr span(T *data, size_type size) noexcept
+        : data_(data), size_(size)
+    {
+    }
+
+    template <std::size_t N>
+    constexpr span(T (&array)[N]) noexcept : data_(array), size_(N)
+    {
+    }
+
+    /** From any contiguous container (e.g., std::vector, std::array) */
+    template <typename Container,
+              typename = std::enable_if_t<std::is_convertible_v<
+                  decltype(std::declval<Container &>().data()), T *>>>
+    constexpr span(Container &c) noexcept : data_(c.data()), size_(c.size())
+    {
+    }
+
+    /** From a span of non-const elements */
+    template <typename U,
+              typename = std::enable_if_t<std::is_convertible_v<U *, T *>>>
+    constexpr span(const span<U> &other) noexcept
+        : data_(other.data()), size_(other.size())
+    {
+    }
+
+    constexpr pointer data() const noexcept { return data_; }
+    constexpr size_type size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr T &operator[](size_type i) const noexcept { return data_[i]; }
+    constexpr iterator begin() const noexcept { return data_; }
+    constexpr iterator end() const noexcept { return data_ + size_; }
+
+    constexpr span subspan(size_type offset, size_type count) const noexcept
+    {
+        return span(data_ + offset, count);
+    }
+
+private:
+    T *data_;
+    size_type size_;
+};
+#endif
+
+/******************************************************************************/
+/* Sample formats */
+/******************************************************************************/
+
+/** ::BLADERF_FORMAT_SC16_Q11 sample */
+struct sc16q11 {
+    int16_t i;
+    int16_t q;
+};
+
+/** ::BLADERF_FORMAT_SC8_Q7 sample */
+struct sc8q7 {
+    int8_t i;
+    int8_t q;
+};
+
+/** ::BLADERF_FORMAT_CF32 sample. The C API converts to and from SC16 Q11. */
+using cf32 = std::complex<float>;
+
+static_assert(sizeof(sc16q11) == 2 * sizeof(int16_t), "Unexpected padding");
+static_assert(sizeof(sc8q7) == 2 * sizeof(int8_t), "Unexpected padding");
+static_assert(sizeof(cf32) == 2 * sizeof(float), "Unexpected padding");
+
+/**
+ * Compile-time mapping of a sample type to its ::bladerf_format, with
+ * (`Meta` = true) or without metadata.
+ *
+ * Only the specializations below are defined, such that an unsupported sample
+ * type fails to compile.
+ */
+template <typename Sample, bool Meta = false> struct format;
+
+template <> struct format<sc16q11, false> {
+    static constexpr bladerf_format value = BLADERF_FORMAT_SC16_Q11;
+};
+
+template <> struct format<sc16q11, true> {
+    static constexpr bladerf_format value = BLADERF_FORMAT_SC16_Q11_META;
+};
+
+template <> struct format<sc8q7, false> {
+    static constexpr bladerf_format value = BLADERF_FORMAT_SC8_Q7;
+};
+
+template <> struct format<sc8q7, true> {
+    static constexpr bladerf_format value = BLADERF_FORMAT_SC8_Q7_META;
+};
+
+template <> struct format<cf32, false> {
+    static constexpr bladerf_format value = BLADERF_FORMAT_CF32;
+};
+
+template <> struct format<cf32, true> {
+    static constexpr bladerf_format value = BLADERF_FORMAT_CF32_META;
+};
+
+template <typename Sample, bool Meta = false>
+inline constexpr bladerf_format format_v = format<Sample, Meta>::value;
+
+/**
+ * Convert samples between the sample types, using the same scaling as the
+ * C API: [-2048, 2048) and [-128, 128) map to [-1.0, 1.0).
+ *
+ * Conversions to integer types saturate. Only `min(in.size(), out.size())`
+ * samples are converted.
+ *
+ * @return Number of samples converted
+ */
+template <typename From, typename To>
+std::size_t convert(span<const From> in, span<To> out) noexcept
+{
+    const std::size_t n = (in.size() < out.size()) ? in.size() : out.size();
+
+    for (std::size_t k = 0; k < n; k++) {
+        float i, q;
+
+        if constexpr (std::is_same_v<From, cf32>) {
+            i = in[k].real();
+            q = in[k].imag();
+        } else if constexpr (std::is_same_v<From, sc16q11>) {
+            i = in[k].i * (1.0f / 2048.0f);
+            q = in[k].q * (1.0f / 2048.0f);
+        } else {
+            static_assert(std::is_same_v<From, sc8q7>, "Unsupported type");
+            i = in[k].i * (1.0f / 128.0f);
+            q = in[k].q * (1.0f / 128.0f);
+        }
+
+        if constexpr (std::is_same_v<To, cf32>) {
+            out[k] = cf32(i, q);
+        } else {
+            static_assert(std::is_same_v<To, sc16q11> ||
+                              std::is_same_v<To, sc8q7>,
+                          "Unsupported type");
+
+            constexpr float scale =
+                std::is_same_v<To, sc16q11> ? 2048.0f : 128.0f;
+
+            auto sat = [](float v) noexcept {
+                v *= scale;
+                v = (v < -scale) ? -scale : v;
+                v = (v > scale - 1.0f) ? scale - 1.0f : v;
+                return v + ((v < 0.0f) ? -0.5f : 0.5f);
+            };
+
+            using T = decltype(out[k].i);
+            out[k].i = static_cast<T>(sat(i));
+            out[k].q = static_cast<T>(sat(q));
+        }
+    }
+
+    return n;
+}
+
+/**
+ * @return Description of a \ref RETCODES value
+ */
+inline const char *strerror(int status) noexcept
+{
+    return bladerf_strerror(status);
+}
+
+/******************************************************************************/
+/* Device */
+/******************************************************************************/
+
+/**
+ * Owning, movable device handle. The device is closed when the handle is
+ * destroyed.
+ */
+class device {
+public:
+    device() noexcept = default;
+
+    /** Take ownership of a device opened with the C API */
+    explicit device(struct bladerf *dev) noexcept : dev_(dev) {}
+
+    ~device() { close(); }
+
+    device(const device &) = delete;
+    device &operator=(const device &) = delete;
+
+    device(device &&other) noexcept : dev_(other.release()) {}
+
+    device &operator=(device &&other) noexcept
+    {
+        if (this != &other) {
+            close();
+            dev_ = other.release();
+        }
+        return *this;
+    }
+
+    /**
+     * Open a device. See bladerf_open().
+     *
+     * @param[out]  out         Receives the device on success. Any device it
+     *                          already held is closed.
+     * @param[in]   identifier  Device identifier string, or nullptr for any
+     *
+     * @return 0 on success, value from \ref RETCODES list on failure
+     */
+    [[nodiscard]] static int open(device &out,
+                                  const char *identifier) noexcept
+    {
+        struct bladerf *dev = nullptr;
+        int status          = bladerf_open(&dev, identifier);
+
+        if (status == 0) {
+            out = device(dev);
+        }
+
+        return status;
+    }
+
+    /** Close the device, if one is held */
+    void close() noexcept
+    {
+        if (dev_ != nullptr) {
+            bladerf_close(dev_);
+            dev_ = nullptr;
+        }
+    }
+
+    /** Give up ownership of the device, without closing it */
+    struct bladerf *release() noexcept
+    {
+        return std::exchange(dev_, nullptr);
+    }
+
+    /** Underlying handle, for use with the C API */
+    struct bladerf *get() const noexcept { return dev_; }
+
+    explicit operator bool() const noexcept { return dev_ != nullptr; }
+
+    /** See bladerf_enable_module() */
+    [[nodiscard]] int enable(bladerf_channel ch, bool enable) noexcept
+    {
+        return bladerf_enable_module(dev_, ch, enable);
+    }
+
+    /** See bladerf_set_frequency() */
+    [[nodiscard]] int set_frequency(bladerf_channel ch,
+                                    bladerf_frequency frequency) noexcept
+    {
+        return bladerf_set_frequency(dev_, ch, frequency);
+    }
+
+    /** See bladerf_set_sample_rate() */
+    [[nodiscard]] int set_sample_rate(bladerf_channel ch,
+                                      bladerf_sample_rate rate,
+                                      bladerf_sample_rate *actual) noexcept
+    {
+        return bladerf_set_sample_rate(dev_, ch, rate, actual);
+    }
+
+    /** See bladerf_set_bandwidth() */
+    [[nodiscard]] int set_bandwidth(bladerf_channel ch,
+                                    bladerf_bandwidth bandwidth,
+                                    bladerf_bandwidth *actual) noexcept
+    {
+        return bladerf_set_bandwidth(dev_, ch, bandwidth, actual);
+    }
+
+    /** See bladerf_set_gain() */
+    [[nodiscard]] int set_gain(bladerf_channel ch, bladerf_gain gain) noexcept
+    {
+        return bladerf_set_gain(dev_, ch, gain);
+    }
+
+private:
+    struct bladerf *dev_ = nullptr;
+};
+
+/******************************************************************************/
+/* Synchronous streams */
+/******************************************************************************/
+
+/**
+ * Synchronous interface stream for one direction, with samples of type
+ * `Sample`, with or without metadata.
+ *
+ * The stream configures the synchronous interface and enables the channels
+ * of its layout; it disables them when destroyed. The device must outlive the
+ * stream.
+ *
+ * Use the rx_stream and tx_stream aliases.
+ */
+template <bladerf_direction Dir, typename Sample, bool Meta = false>
+class sync_stream {
+public:
+    using sample_type = Sample;
+
+    /** Sample format of the stream */
+    static constexpr bladerf_format format = format_v<Sample, Meta>;
+
+    sync_stream() noexcept = default;
+
+    ~sync_stream() { close(); }
+
+    sync_stream(const sync_stream &) = delete;
+    sync_stream &operator=(const sync_stream &) = delete;
+
+    sync_stream(sync_stream &&other) noexcept
+        : dev_(std::exchange(other.dev_, nullptr)), layout_(other.layout_)
+    {
+    }
+
+    sync_stream &operator=(sync_stream &&other) noexcept
+    {
+        if (this != &other) {
+            close();
+            dev_    = std::exchange(other.dev_, nullptr);
+            layout_ = other.layout_;
+        }
+        return *this;
+    }
+
+    /**
+     * Configure the synchronous interface and enable the channels in
+     * `layout`. See bladerf_sync_config().
+     *
+     * The default buffering parameters (all 0) select automatic sizing; see
+     * bladerf_sync_config().
+     *
+     * @param[out]  out             Receives the stream on success
+     * @param       dev             Device
+     * @param[in]   layout          Channel layout, which must match `Dir`
+     * @param[in]   num_buffers     Number of buffers
+     * @param[in]   buffer_size     Buffer size, in samples
+     * @param[in]   num_transfers   Number of transfers
+     * @param[in]   stream_timeout  Transfer timeout, in milliseconds
+     *
+     * @return 0 on success, value from \ref RETCODES list on failure
+     */
+    [[nodiscard]] static int configure(sync_stream &out,
+                                       device &dev,
+                                       bladerf_channel_layout layout,
+                                       unsigned int num_buffers    = 0,
+                                       unsigned int buffer_size    = 0,
+                                       unsigned int num_transfers  = 0,
+                                       unsigned int stream_timeout = 0) noexcept
+    {
+        int status;
+
+        if ((layout & BLADERF_DIRECTION_MASK) != Dir) {
+            return BLADERF_ERR_INVAL;
+        }
+
+        status = bladerf_sync_config(dev.get(), layout, format, num_buffers,
+                                     buffer_size, num_transfers,
+                                     stream_timeout);
+        if (status != 0) {
+            return status;
+        }
+
+        for (unsigned int i = 0; i < num_channels(layout); i++) {
+            status = bladerf_enable_module(dev.get(), channel(i), true);
+            if (status != 0) {
+                while (i-- > 0) {
+                    bladerf_enable_module(dev.get(), channel(i), false);
+                }
+                return status;
+            }
+        }
+
+        out.close();
+        out.dev_    = dev.get();
+        out.layout_ = layout;
+
+        return 0;
+    }
+
+    /** Disable the stream's channels, if it is configured */
+    void close() noexcept
+    {
+        if (dev_ != nullptr) {
+            for (unsigned int i = 0; i < num_channels(layout_); i++) {
+                bladerf_enable_module(dev_, channel(i), false);
+            }
+            dev_ = nullptr;
+        }
+    }
+
+    explicit operator bool() const noexcept { return dev_ != nullptr; }
+
+    /** Device the stream is configured on, for use with the C API */
+    struct bladerf *get() const noexcept { return dev_; }
+
+    /**
+     * Receive samples directly into `samples`. See bladerf_sync_rx().
+     *
+     * With a multi-channel layout, samples are interleaved and
+     * `samples.size()` counts the samples of all channels.
+     *
+     * @pre The stream has been configured.
+     *
+     * @return 0 on success, value from \ref RETCODES list on failure
+     */
+    [[nodiscard]] int read(span<Sample> samples,
+                           struct bladerf_metadata *meta,
+                           unsigned int timeout_ms) noexcept
+    {
+        static_assert(Dir == BLADERF_RX, "read() requires an RX stream");
+        return bladerf_sync_rx(dev_, samples.data(),
+                               static_cast<unsigned int>(samples.size()),
+                               meta, timeout_ms);
+    }
+
+    /**
+     * Transmit the samples in `samples`. See bladerf_sync_tx().
+     *
+     * @pre The stream has been configured.
+     *
+     * @return 0 on success, value from \ref RETCODES list on failure
+     */
+    [[nodiscard]] int write(span<const Sample> samples,
+                            struct bladerf_metadata *meta,
+                            unsigned int timeout_ms) noexcept
+    {
+        static_assert(Dir == BLADERF_TX, "write() requires a TX stream");
+        return bladerf_sync_tx(dev_, samples.data(),
+                               static_cast<unsigned int>(samples.size()),
+                               meta, timeout_ms);
+    }
+
+private:
+    static constexpr unsigned int
+    num_channels(bladerf_channel_layout layout) noexcept
+    {
+        return (layout == BLADERF_RX_X2 || layout == BLADERF_TX_X2) ? 2 : 1;
+    }
+
+    static constexpr bladerf_channel channel(unsigned int i) noexcept
+    {
+        return (Dir == BLADERF_RX) ? BLADERF_CHANNEL_RX(i)
+                                   : BLADERF_CHANNEL_TX(i);
+    }
+
+    struct bladerf *dev_           = nullptr;
+    bladerf_channel_layout layout_ = BLADERF_RX_X1;
+};
+
+/** Synchronous RX stream of `Sample` */
+template <typename Sample, bool Meta = false>
+using rx_stream = sync_stream<BLADERF_RX, Sample, Meta>;
+
+/** Synchronous TX stream of `Sample` */
+template <typename Sample, bool Meta = false>
+using tx_stream = sync_stream<BLADERF_TX, Sample, Meta>;
+
+/******************************************************************************/
+/* Asynchronous streams */
+/******************************************************************************/
+
+/**
+ * Owning, movable handle for an asynchronous stream. The stream is
+ * deinitialized when the handle is destroyed, which must not happen while
+ * bladerf_stream() is running on it. The device must outlive the stream.
+ */
+template <typename Sample, bool Meta = false> class async_stream {
+public:
+    using sample_type = Sample;
+
+    /** Sample format of the stream */
+    static constexpr bladerf_format format = format_v<Sample, Meta>;
+
+    static_assert(!std::is_same_v<Sample, cf32>,
+                  "CF32 is only supported by the synchronous interface");
+
+    async_stream() noexcept = default;
+
+    ~async_stream() { reset(); }
+
+    async_stream(const async_stream &) = delete;
+    async_stream &operator=(const async_stream &) = delete;
+
+    async_stream(async_stream &&other) noexcept
+        : stream_(std::exchange(other.stream_, nullptr)),
+          buffers_(std::exchange(other.buffers_, nullptr)),
+          num_buffers_(std::exchange(other.num_buffers_, 0)),
+          samples_per_buffer_(std::exchange(other.samples_per_buffer_, 0))
+    {
+    }
+
+    async_stream &operator=(async_stream &&other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            stream_             = std::exchange(other.stream_, nullptr);
+            buffers_            = std::exchange(other.buffers_, nullptr);
+            num_buffers_        = std::exchange(other.num_buffers_, 0);
+            samples_per_buffer_ = std::exchange(other.samples_per_buffer_, 0);
+        }
+        return *this;
+    }
+
+    /**
+     * Initialize a stream. See bladerf_init_stream().
+     *
+     * @return 0 on success, value from \ref RETCODES list on failure
+     */
+    [[nodiscard]] static int init(async_stream &out,
+                                  device &dev,
+                                  bladerf_stream_cb callback,
+                                  std::size_t num_buffers,
+                                  std::size_t samples_per_buffer,
+                                  std::size_t num_transfers,
+                                  void *user_data) noexcept
+    {
+        struct bladerf_stream *stream = nullptr;
+        void **buffers                = nullptr;
+        int status;
+
+        status = bladerf_init_stream(&stream, dev.get(), callback, &buffers,
+                                     num_buffers, format, samples_per_buffer,
+                                     num_transfers, user_data);
+        if (status == 0) {
+            out.reset();
+            out.stream_             = stream;
+            out.buffers_            = buffers;
+            out.num_buffers_        = num_buffers;
+            out.samples_per_buffer_ = samples_per_buffer;
+        }
+
+        return status;
+    }
+
+    /** Deinitialize the stream, if one is held */
+    void reset() noexcept
+    {
+        if (stream_ != nullptr) {
+            bladerf_deinit_stream(stream_);
+            stream_  = nullptr;
+            buffers_ = nullptr;
+        }
+    }
+
+    /** Underlying handle, for use with the C API */
+    struct bladerf_stream *get() const noexcept { return stream_; }
+
+    explicit operator bool() const noexcept { return stream_ != nullptr; }
+
+    /** Number of buffers allocated by init() */
+    std::size_t num_buffers() const noexcept { return num_buffers_; }
+
+    /**
+     * View of one of the stream's buffers. With metadata formats, this
+     * includes the message headers.
+     */
+    span<Sample> buffer(std::size_t i) const noexcept
+    {
+        return span<Sample>(static_cast<Sample *>(buffers_[i]),
+                            samples_per_buffer_);
+    }
+
+    /**
+     * Run the stream until a callback shuts it down. See bladerf_stream().
+     *
+     * @return 0 on success, value from \ref RETCODES list on failure
+     */
+    [[nodiscard]] int run(bladerf_channel_layout layout) noexcept
+    {
+        return bladerf_stream(stream_, layout);
+    }
+
+    /**
+     * Submit one of the stream's buffers from outside of the callback.
+     * See bladerf_submit_stream_buffer().
+     *
+     * @return 0 on success, value from \ref RETCODES list on failure
+     */
+    [[nodiscard]] int submit(span<Sample> buffer,
+                             unsigned int timeout_ms) noexcept
+    {
+        return bladerf_submit_stream_buffer(stream_, buffer.data(),
+                                            timeout_ms);
+    }
+
+private:
+    struct bladerf_stream *stream_  = nullptr;
+    void **buffers_                 = nullptr;
+    std::size_t num_buffers_        = 0;
+    std::size_t samples_per_buffer_ = 0;
+};
+
+} // namespace bladeRF
+
+/** @} (End of FN_CPP) */
+
+#endif
@@ -0,0 +1,657 @@
+/**
+ * @file libbladeRF_coro.hpp
+ *
+ * @brief C++20 coroutine support for the libbladeRF C++ interface
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#ifndef LIBBLADERF_CORO_HPP_
+#define LIBBLADERF_CORO_HPP_
+
+#include <libbladeRF.hpp>
+
+#if !__has_include(<coroutine>) || !defined(__cpp_impl_coroutine)
+#error "libbladeRF_coro.hpp requires C++20 coroutines"
+#endif
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <vector>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @defgroup FN_CPP_CORO C++ coroutines
+ *
+ * Awaitable forms of the synchronous stream calls and the asynchronous
+ * control operations (see \ref FN_ASYNC_CONTROL), such that one thread may
+ * drive the streams and control operations of many devices without blocking.
+ *
+ * Coroutines are resumed by an executor. Streams wait upon their readiness
+ * handles (see bladerf_get_sync_poll_handle()), and control operations upon
+ * their completion callbacks, which the executor is notified of. An
+ * epoll-based executor is provided on Linux; other event loops (e.g., one
+ * built on io_uring) may implement the executor interface.
+ *
+ * @code
+ * bladeRF::coro::task<int> receive(bladeRF::coro::executor &exec,
+ *                                  bladeRF::device &dev,
+ *                                  bladeRF::rx_stream<bladeRF::sc16q11> &rx,
+ *                                  bladeRF::span<bladeRF::sc16q11> buf)
+ * {
+ *     int status = co_await bladeRF::coro::set_frequency(
+ *         exec, dev, BLADERF_CHANNEL_RX(0), 915000000);
+ *
+ *     while (status == 0) {
+ *         status = co_await bladeRF::coro::read(exec, rx, buf, nullptr);
+ *     }
+ *
+ *     co_return status;
+ * }
+ *
+ * bladeRF::coro::epoll_executor exec;
+ * bladeRF::coro::spawn(receive(exec, dev, rx, buf));
+ * exec.run();
+ * @endcode
+ *
+ * The executor is single-threaded: coroutines run only on the thread calling
+ * run(). Streams awaited upon must have non-blocking operation enabled via
+ * bladerf_set_sync_nonblocking(), and each request should not exceed the
+ * `buffer_size` given to bladerf_sync_config(), as the readiness handle
+ * indicates the availability of one buffer.
+ *
+ * @{
+ */
+
+namespace bladeRF {
+namespace coro {
+
+/******************************************************************************/
+/* Executor interface */
+/******************************************************************************/
+
+/**
+ * Event loop that resumes coroutines awaiting libbladeRF operations
+ */
+class executor {
+public:
+    virtual ~executor() = default;
+
+    /**
+     * Resume `h` from the executor's thread. This may be called from any
+     * thread, including libbladeRF's control worker.
+     */
+    virtual void post(std::coroutine_handle<> h) noexcept = 0;
+
+    /**
+     * Resume `h` once `handle` becomes readable
+     *
+     * Only one coroutine may wait upon a given handle at a time.
+     *
+     * @return 0 on success, or a value from \ref RETCODES list if the handle
+     *         could not be waited upon, in which case `h` is not resumed
+     */
+    virtual int wait_readable(bladerf_poll_handle handle,
+                              std::coroutine_handle<> h) noexcept = 0;
+
+    /**
+     * Note that a coroutine will be posted by an operation in flight, such
+     * as a queued control operation. Each call is balanced by a call to
+     * work_finished(), made after the coroutine has been posted.
+     */
+    virtual void work_started() noexcept {}
+
+    /** See work_started() */
+    virtual void work_finished() noexcept {}
+};
+
+/******************************************************************************/
+/* Tasks */
+/******************************************************************************/
+
+/**
+ * Lazily started coroutine producing a `T`. The coroutine starts when the
+ * task is awaited, and resumes its awaiter upon completion.
+ *
+ * Exceptions escaping the coroutine terminate the program, as the rest of the
+ * interface does not throw.
+ */
+template <typename T> class task {
+public:
+    struct promise_type {
+        T value{};
+        std::coroutine_handle<> continuation;
+
+        task get_return_object() noexcept
+        {
+            return task(
+                std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct final_awaiter {
+            bool await_ready() noexcept { return false; }
+
+            std::coroutine_handle<>
+            await_suspend(std::coroutine_handle<promise_type> h) noexcept
+            {
+                std::coroutine_handle<> next = h.promise().continuation;
+                return next ? next : std::noop_coroutine();
+            }
+
+            void await_resume() noexcept {}
+        };
+
+        final_awaiter final_suspend() noexcept { return {}; }
+
+        void return_value(T v) noexcept { value = std::move(v); }
+
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+
+    task() noexcept = default;
+
+    ~task()
+    {
+        if (h_) {
+            h_.destroy();
+        }
+    }
+
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+
+    task(task &&other) noexcept : h_(std::exchange(other.h_, nullptr)) {}
+
+    task &operator=(task &&other) noexcept
+    {
+        if (this != &other) {
+            if (h_) {
+                h_.destroy();
+            }
+            h_ = std::exchange(other.h_, nullptr);
+        }
+        return *this;
+    }
+
+    bool await_ready() const noexcept { return !h_ || h_.done(); }
+
+    std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<> awaiter) noexcept
+    {
+        h_.promise().continuation = awaiter;
+        return h_;
+    }
+
+    T await_resume() noexcept { return std::move(h_.promise().value); }
+
+private:
+    explicit task(std::coroutine_handle<promise_type> h) noexcept : h_(h) {}
+
+    std::coroutine_handle<promise_type> h_;
+};
+
+namespace detail {
+
+/* Eagerly started, self-destroying coroutine that runs a task to completion */
+struct detached {
+    struct promise_type {
+        detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+template <typename T> detached run_detached(task<T> t)
+{
+    co_await t;
+}
+
+/* Resumes the awaiting coroutine from the executor's thread */
+struct post_awaiter {
+    executor &exec;
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> h) noexcept { exec.post(h); }
+
+    void await_resume() const noexcept {}
+};
+
+/* Resumes the awaiting coroutine once a readiness handle is readable */
+struct readable_awaiter {
+    executor &exec;
+    bladerf_poll_handle handle;
+    int status;
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> h) noexcept
+    {
+        status = exec.wait_readable(handle, h);
+        return status == 0;
+    }
+
+    int await_resume() const noexcept { return status; }
+};
+
+} // namespace detail
+
+/**
+ * Start a task on the calling thread, running it until its first suspension.
+ * The task's result is discarded, and its frame is freed upon completion.
+ */
+template <typename T> void spawn(task<T> t)
+{
+    detail::run_detached(std::move(t));
+}
+
+/**
+ * Suspend the calling coroutine until the executor next runs it, allowing
+ * other coroutines to run
+ */
+inline detail::post_awaiter yield(executor &exec) noexcept
+{
+    return detail::post_awaiter{ exec };
+}
+
+/**
+ * Suspend the calling coroutine until `handle` is readable
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+inline detail::readable_awaiter readable(executor &exec,
+                                         bladerf_poll_handle handle) noexcept
+{
+    return detail::readable_awaiter{ exec, handle, 0 };
+}
+
+/******************************************************************************/
+/* Streams */
+/******************************************************************************/
+
+/**
+ * Receive samples, suspending the calling coroutine while they are not yet
+ * available. See rx_stream::read().
+ *
+ * @pre Non-blocking operation is enabled for ::BLADERF_RX.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+template <typename Sample, bool Meta>
+task<int> read(executor &exec,
+               rx_stream<Sample, Meta> &rx,
+               span<Sample> samples,
+               struct bladerf_metadata *meta)
+{
+    bladerf_poll_handle handle;
+    int status;
+
+    for (;;) {
+        status = rx.read(samples, meta, 0);
+        if (status != BLADERF_ERR_WOULD_BLOCK) {
+            co_return status;
+        }
+
+        /* The handle is created once the stream has started */
+        status = bladerf_get_sync_poll_handle(rx.get(), BLADERF_RX, &handle);
+        if (status == 0) {
+            status = co_await readable(exec, handle);
+        }
+
+        if (status != 0) {
+            co_return status;
+        }
+    }
+}
+
+/**
+ * Transmit samples, suspending the calling coroutine while buffer space is
+ * not yet available. See tx_stream::write().
+ *
+ * @pre Non-blocking operation is enabled for ::BLADERF_TX.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+template <typename Sample, bool Meta>
+task<int> write(executor &exec,
+                tx_stream<Sample, Meta> &tx,
+                span<const Sample> samples,
+                struct bladerf_metadata *meta)
+{
+    bladerf_poll_handle handle;
+    int status;
+
+    for (;;) {
+        status = tx.write(samples, meta, 0);
+        if (status != BLADERF_ERR_WOULD_BLOCK) {
+            co_return status;
+        }
+
+        status = bladerf_get_sync_poll_handle(tx.get(), BLADERF_TX, &handle);
+        if (status == 0) {
+            status = co_await readable(exec, handle);
+        }
+
+        if (status != 0) {
+            co_return status;
+        }
+    }
+}
+
+/******************************************************************************/
+/* Control operations */
+/******************************************************************************/
+
+/**
+ * Awaitable control operation, submitted to the device's control queue when
+ * awaited. Its result is the operation's status, or the submission's status
+ * if it could not be queued.
+ *
+ * `Submit` is invoked as `submit(cb, user_data)`, and must return the status
+ * of the `bladerf_*_async()` call it makes.
+ */
+template <typename Submit> class ctrl_awaitable {
+public:
+    ctrl_awaitable(executor &exec, Submit submit) noexcept
+        : exec_(exec), submit_(std::move(submit))
+    {
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> h) noexcept
+    {
+        h_ = h;
+
+        exec_.work_started();
+        status_ = submit_(&ctrl_awaitable::complete, this);
+
+        if (status_ != 0) {
+            /* Not queued: resume immediately with the submission's status */
+            exec_.work_finished();
+            return false;
+        }
+
+        return true;
+    }
+
+    int await_resume() const noexcept { return status_; }
+
+private:
+    static void complete(struct bladerf *, bladerf_ctrl_ticket, int status,
+                         void *user_data) noexcept
+    {
+        auto *self     = static_cast<ctrl_awaitable *>(user_data);
+        executor &exec = self->exec_;
+
+        /* The awaitable may be destroyed as soon as it has been posted */
+        self->status_ = status;
+        exec.post(self->h_);
+        exec.work_finished();
+    }
+
+    executor &exec_;
+    Submit submit_;
+    std::coroutine_handle<> h_;
+    int status_ = 0;
+};
+
+/** Awaitable bladerf_set_frequency(). See bladerf_set_frequency_async(). */
+inline auto set_frequency(executor &exec,
+                          device &dev,
+                          bladerf_channel ch,
+                          bladerf_frequency frequency) noexcept
+{
+    struct bladerf *d = dev.get();
+    auto submit = [d, ch, frequency](bladerf_ctrl_cb cb, void *user_data) {
+        return bladerf_set_frequency_async(d, ch, frequency, cb, user_data,
+                                           nullptr);
+    };
+
+    return ctrl_awaitable<decltype(submit)>(exec, submit);
+}
+
+/** Awaitable bladerf_set_gain(). See bladerf_set_gain_async(). */
+inline auto set_gain(executor &exec,
+                     device &dev,
+                     bladerf_channel ch,
+                     bladerf_gain gain) noexcept
+{
+    struct bladerf *d = dev.get();
+    auto submit = [d, ch, gain](bladerf_ctrl_cb cb, void *user_data) {
+        return bladerf_set_gain_async(d, ch, gain, cb, user_data, nullptr);
+    };
+
+    return ctrl_awaitable<decltype(submit)>(exec, submit);
+}
+
+/**
+ * Awaitable bladerf_set_bandwidth(). See bladerf_set_bandwidth_async().
+ *
+ * `actual`, if non-NULL, must remain valid until the operation completes.
+ */
+inline auto set_bandwidth(executor &exec,
+                          device &dev,
+                          bladerf_channel ch,
+                          bladerf_bandwidth bandwidth,
+                          bladerf_bandwidth *actual) noexcept
+{
+    struct bladerf *d = dev.get();
+    auto submit = [d, ch, bandwidth, actual](bladerf_ctrl_cb cb,
+                                             void *user_data) {
+        return bladerf_set_bandwidth_async(d, ch, bandwidth, actual, cb,
+                                           user_data, nullptr);
+    };
+
+    return ctrl_awaitable<decltype(submit)>(exec, submit);
+}
+
+/******************************************************************************/
+/* epoll executor */
+/******************************************************************************/
+
+#if defined(__linux__)
+/**
+ * Single-threaded executor built on epoll. Coroutines posted from other
+ * threads are handed over via an eventfd.
+ */
+class epoll_executor final : public executor {
+public:
+    epoll_executor() noexcept
+    {
+        epfd_ = epoll_create1(EPOLL_CLOEXEC);
+        evfd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+        if (epfd_ >= 0 && evfd_ >= 0) {
+            struct epoll_event ev = {};
+            ev.events   = EPOLLIN;
+            ev.data.ptr = nullptr;
+
+            if (epoll_ctl(epfd_, EPOLL_CTL_ADD, evfd_, &ev) != 0) {
+                close_fds();
+            }
+        } else {
+            close_fds();
+        }
+    }
+
+    ~epoll_executor() override { close_fds(); }
+
+    epoll_executor(const epoll_executor &) = delete;
+    epoll_executor &operator=(const epoll_executor &) = delete;
+
+    /** Whether the epoll instance and eventfd were created */
+    explicit operator bool() const noexcept { return epfd_ >= 0; }
+
+    void post(std::coroutine_handle<> h) noexcept override
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            posted_.push_back(h);
+        }
+
+        post_wakeup();
+    }
+
+    int wait_readable(bladerf_poll_handle handle,
+                      std::coroutine_handle<> h) noexcept override
+    {
+        struct epoll_event ev = {};
+
+        /* One-shot, so that a level-triggered handle reports each wait
+         * once. The handle's registration is re-armed by the next wait. */
+        ev.events   = EPOLLIN | EPOLLONESHOT;
+        ev.data.ptr = h.address();
+
+        if (epoll_ctl(epfd_, EPOLL_CTL_MOD, handle, &ev) != 0) {
+            if (errno != ENOENT ||
+                epoll_ctl(epfd_, EPOLL_CTL_ADD, handle, &ev) != 0) {
+                return BLADERF_ERR_UNEXPECTED;
+            }
+        }
+
+        waiting_++;
+        return 0;
+    }
+
+    void work_started() noexcept override { outstanding_++; }
+
+    void work_finished() noexcept override
+    {
+        if (--outstanding_ == 0) {
+            post_wakeup();
+        }
+    }
+
+    /**
+     * Resume coroutines as they become ready, until stop() is called or no
+     * coroutine remains suspended on the executor, awaiting a readiness
+     * handle or an operation in flight.
+     *
+     * @return 0 on success, value from \ref RETCODES list on failure
+     */
+    int run() noexcept
+    {
+        struct epoll_event events[16];
+        std::vector<std::coroutine_handle<>> ready;
+
+        stop_ = false;
+
+        while (!stop_) {
+            {
+                std::lock_guard<std::mutex> guard(lock_);
+                ready.swap(posted_);
+            }
+
+            for (std::coroutine_handle<> h : ready) {
+                h.resume();
+            }
+
+            if (!ready.empty()) {
+                ready.clear();
+                continue;
+            }
+
+            if (waiting_ == 0 && outstanding_ == 0) {
+                /* Operations post their coroutine before finishing */
+                std::lock_guard<std::mutex> guard(lock_);
+                if (posted_.empty()) {
+                    break;
+                }
+                continue;
+            }
+
+            int n = epoll_wait(epfd_, events, 16, -1);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return BLADERF_ERR_UNEXPECTED;
+            }
+
+            for (int i = 0; i < n; i++) {
+                if (events[i].data.ptr == nullptr) {
+                    uint64_t count;
+                    ssize_t r = ::read(evfd_, &count, sizeof(count));
+                    (void)r;
+                } else {
+                    waiting_--;
+                    std::coroutine_handle<>::from_address(events[i].data.ptr)
+                        .resume();
+                }
+            }
+        }
+
+        return 0;
+    }
+
+    /**
+     * Make run() return once the coroutine currently running suspends. This
+     * must be called from the executor's thread.
+     */
+    void stop() noexcept { stop_ = true; }
+
+private:
+    void post_wakeup() noexcept
+    {
+        const uint64_t one = 1;
+        ssize_t n          = ::write(evfd_, &one, sizeof(one));
+        (void)n;
+    }
+
+    void close_fds() noexcept
+    {
+        if (evfd_ >= 0) {
+            ::close(evfd_);
+            evfd_ = -1;
+        }
+
+        if (epfd_ >= 0) {
+            ::close(epfd_);
+            epfd_ = -1;
+        }
+    }
+
+    int epfd_ = -1;
+    int evfd_ = -1;
+
+    std::mutex lock_;
+    std::vector<std::coroutine_handle<>> posted_;
+
+    unsigned int waiting_ = 0;
+    std::atomic<int> outstanding_{ 0 };
+    bool stop_ = false;
+};
+#endif
+
+} // namespace coro
+} // namespace bladeRF
+
+/** @} (End of FN_CPP_CORO) */
+
+#endif
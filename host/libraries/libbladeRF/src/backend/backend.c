@@ -114,6 +114,25 @@ int backend_probe(backend_probe_target probe_target,
     return status;
 }
 
+int backend_set_device_monitor(bool enable)
+{
+    int status = BLADERF_ERR_UNSUPPORTED;
+    size_t i;
+    const size_t n_backends = ARRAY_SIZE(backend_list);
+
+    for (i = 0; i < n_backends; i++) {
+        if (backend_list[i]->set_device_monitor != NULL) {
+            int backend_status = backend_list[i]->set_device_monitor(enable);
+
+            if (status != 0) {
+                status = backend_status;
+            }
+        }
+    }
+
+    return status;
+}
+
 int backend_load_fw_from_bootloader(bladerf_backend backend,
                                     uint8_t bus, uint8_t addr,
                                     struct fx3_firmware *fw)
@@ -133,6 +152,64 @@ int backend_load_fw_from_bootloader(bladerf_backend backend,
     return status;
 }
 
+int backend_reg_batch_sequential(struct bladerf *dev,
+                                 int (*write_fn)(struct bladerf *dev,
+                                                 uint8_t addr,
+                                                 uint8_t data),
+                                 int (*read_fn)(struct bladerf *dev,
+                                                uint8_t addr,
+                                                uint8_t *data),
+                                 struct backend_reg_op *ops,
+                                 unsigned int count)
+{
+    unsigned int i;
+    int status;
+
+    for (i = 0; i < count; i++) {
+        if (ops[i].write) {
+            status = write_fn(dev, ops[i].addr, ops[i].data);
+        } else {
+            status = read_fn(dev, ops[i].addr, &ops[i].data);
+        }
+
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    return 0;
+}
+
+int backend_reg_block_sequential(struct bladerf *dev,
+                                 int (*write_fn)(struct bladerf *dev,
+                                                 uint8_t addr,
+                                                 uint8_t data),
+                                 int (*read_fn)(struct bladerf *dev,
+                                                uint8_t addr,
+                                                uint8_t *data),
+                                 bool write,
+                                 uint8_t addr,
+                                 uint8_t *data,
+                                 unsigned int count)
+{
+    unsigned int i;
+    int status;
+
+    for (i = 0; i < count; i++) {
+        if (write) {
+            status = write_fn(dev, (uint8_t)(addr + i), data[i]);
+        } else {
+            status = read_fn(dev, (uint8_t)(addr + i), &data[i]);
+        }
+
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    return 0;
+}
+
 const char *backend2str(bladerf_backend backend)
 {
     switch (backend) {
@@ -145,6 +222,12 @@ const char *backend2str(bladerf_backend backend)
         case BLADERF_BACKEND_CYPRESS:
             return BACKEND_STR_CYPRESS;
 
+        case BLADERF_BACKEND_DUMMY:
+            return BACKEND_STR_DUMMY;
+
+        case BLADERF_BACKEND_SHM:
+            return BACKEND_STR_SHM;
+
         default:
             return BACKEND_STR_ANY;
     }
@@ -160,6 +243,10 @@ int str2backend(const char *str, bladerf_backend *backend)
         *backend = BLADERF_BACKEND_LINUX;
     } else if (!strcasecmp(BACKEND_STR_CYPRESS, str)) {
         *backend = BLADERF_BACKEND_CYPRESS;
+    } else if (!strcasecmp(BACKEND_STR_DUMMY, str)) {
+        *backend = BLADERF_BACKEND_DUMMY;
+    } else if (!strcasecmp(BACKEND_STR_SHM, str)) {
+        *backend = BLADERF_BACKEND_SHM;
     } else if (!strcasecmp(BACKEND_STR_ANY, str)) {
         *backend = BLADERF_BACKEND_ANY;
     } else {
@@ -37,6 +37,8 @@
 #define BACKEND_STR_LIBUSB "libusb"
 #define BACKEND_STR_LINUX "linux"
 #define BACKEND_STR_CYPRESS "cypress"
+#define BACKEND_STR_DUMMY "dummy"
+#define BACKEND_STR_SHM "shm"
 
 /**
  * Specifies what to probe for
@@ -57,6 +59,26 @@ typedef enum {
 struct bladerf_devinfo_list;
 struct fx3_firmware;
 
+/**
+ * A register access with an 8-bit address and 8-bit data, as performed by
+ * the backend's *_batch functions
+ */
+struct backend_reg_op {
+    uint8_t addr;
+    uint8_t data; /**< Data to write, or updated with the data read */
+    bool write;
+};
+
+/**
+ * A single-byte AD9361 register access, as performed by the backend's
+ * ad9361_spi_batch function
+ */
+struct backend_ad9361_op {
+    uint16_t addr;
+    uint8_t data; /**< Data to write, or updated with the data read */
+    bool write;
+};
+
 /**
  * Backend-specific function table
  *
@@ -76,6 +98,10 @@ struct backend_fns {
     int (*probe)(backend_probe_target probe_target,
                  struct bladerf_devinfo_list *info_list);
 
+    /* Start or stop maintaining a list of attached devices in the background.
+     * May be NULL if unsupported. */
+    int (*set_device_monitor)(bool enable);
+
     /* Get VID and PID of the device */
     int (*get_vid_pid)(struct bladerf *dev, uint16_t *vid, uint16_t *pid);
 
@@ -105,6 +131,13 @@ struct backend_fns {
     int (*is_fpga_configured)(struct bladerf *dev);
     bladerf_fpga_source (*get_fpga_source)(struct bladerf *dev);
 
+    /* Is the FPGA known to be running the specified image, as loaded by a
+     * previous load_fpga()? Returns 1 if so, 0 if not (or if this cannot be
+     * determined), or a BLADERF_ERR_* value on failure. */
+    int (*is_fpga_image_loaded)(struct bladerf *dev,
+                                const uint8_t *image,
+                                size_t image_size);
+
     /* Version checking */
     int (*get_fw_version)(struct bladerf *dev, struct bladerf_version *version);
     int (*get_fpga_version)(struct bladerf *dev,
@@ -127,6 +160,12 @@ struct backend_fns {
                              uint32_t page,
                              uint32_t count);
 
+    /* Compute the SHA-256 digest of the specified pages on the device */
+    int (*hash_flash_pages)(struct bladerf *dev,
+                            uint32_t page,
+                            uint32_t count,
+                            uint8_t *digest);
+
     /* Device startup and reset */
     int (*device_reset)(struct bladerf *dev);
     int (*jump_to_bootloader)(struct bladerf *dev);
@@ -180,6 +219,14 @@ struct backend_fns {
                          bladerf_direction dir,
                          uint64_t *value);
 
+    /* Latch a timestamp counter value as the request arrives. `hold` is
+     * updated with the counter ticks that elapsed between the latch and
+     * the response. */
+    int (*get_timestamp_latch)(struct bladerf *dev,
+                               bladerf_direction dir,
+                               uint64_t *value,
+                               uint32_t *hold);
+
     /* Si5338 accessors */
     int (*si5338_write)(struct bladerf *dev, uint8_t addr, uint8_t data);
     int (*si5338_read)(struct bladerf *dev, uint8_t addr, uint8_t *data);
@@ -188,6 +235,52 @@ struct backend_fns {
     int (*lms_write)(struct bladerf *dev, uint8_t addr, uint8_t data);
     int (*lms_read)(struct bladerf *dev, uint8_t addr, uint8_t *data);
 
+    /* Perform a sequence of Si5338 or LMS6002D register accesses, in order,
+     * stopping at the first failure. Backends may carry multiple accesses
+     * in a single request. */
+    int (*si5338_batch)(struct bladerf *dev,
+                        struct backend_reg_op *ops,
+                        unsigned int count);
+    int (*lms_batch)(struct bladerf *dev,
+                     struct backend_reg_op *ops,
+                     unsigned int count);
+
+    /* Read or write `count` consecutive Si5338 or LMS6002D registers,
+     * starting at `addr`. For a read, `data` is updated with the values
+     * read. */
+    int (*si5338_block)(struct bladerf *dev,
+                        bool write,
+                        uint8_t addr,
+                        uint8_t *data,
+                        unsigned int count);
+    int (*lms_block)(struct bladerf *dev,
+                     bool write,
+                     uint8_t addr,
+                     uint8_t *data,
+                     unsigned int count);
+
+    /* Perform the LMS6002D VCOCAP search on the device. The PLL must already
+     * be configured, with the estimate written to VCOCAP. */
+    int (*lms_vcocap_search)(struct bladerf *dev,
+                             bladerf_module mod,
+                             uint8_t vcocap_est,
+                             uint8_t *vcocap_result,
+                             bool *locked);
+
+    /* Run an LMS6002D DC calibration loop on the device, or load a DC
+     * calibration value. `base` is the base address of the DC calibration
+     * module. */
+    int (*lms_dc_cal_loop)(struct bladerf *dev,
+                           uint8_t base,
+                           uint8_t cal_addr,
+                           uint8_t dc_cntval,
+                           uint8_t *dc_regval,
+                           bool *done);
+    int (*lms_dc_cal_load)(struct bladerf *dev,
+                           uint8_t base,
+                           uint8_t cal_addr,
+                           uint8_t value);
+
     /* INA219 accessors */
     int (*ina219_write)(struct bladerf *dev, uint8_t addr, uint16_t data);
     int (*ina219_read)(struct bladerf *dev, uint8_t addr, uint16_t *data);
@@ -195,6 +288,9 @@ struct backend_fns {
     /* AD9361 accessors */
     int (*ad9361_spi_write)(struct bladerf *dev, uint16_t cmd, uint64_t data);
     int (*ad9361_spi_read)(struct bladerf *dev, uint16_t cmd, uint64_t *data);
+    int (*ad9361_spi_batch)(struct bladerf *dev,
+                            struct backend_ad9361_op *ops,
+                            unsigned int count);
 
     /* AD9361 accessors */
     int (*adi_axi_write)(struct bladerf *dev, uint32_t addr, uint32_t data);
@@ -203,6 +299,10 @@ struct backend_fns {
     /* RFIC command accessors */
     int (*rfic_command_write)(struct bladerf *dev, uint16_t cmd, uint64_t data);
     int (*rfic_command_read)(struct bladerf *dev, uint16_t cmd, uint64_t *data);
+    int (*rfic_command_wait)(struct bladerf *dev,
+                             uint16_t cmd,
+                             unsigned int timeout_ms,
+                             uint64_t *data);
 
     /* RFFE control accessors */
     int (*rffe_control_write)(struct bladerf *dev, uint32_t value);
@@ -214,6 +314,57 @@ struct backend_fns {
                               uint8_t rffe_profile,
                               uint16_t nios_profile);
 
+    /* Nios fast lock profile storage accessors. `data` holds
+     * NIOS_PKT_16x64_FASTLOCK_PROFILE_LEN bytes. */
+    int (*rffe_fastlock_read)(struct bladerf *dev,
+                              bool is_tx,
+                              uint8_t nios_profile,
+                              uint8_t *data);
+    int (*rffe_fastlock_write)(struct bladerf *dev,
+                               bool is_tx,
+                               uint8_t rffe_profile,
+                               uint8_t nios_profile,
+                               const uint8_t *data);
+
+    /* RX digital downconverter control register accessors. See
+     * NIOS_PKT_8x32_TARGET_RX_DDC for the register's fields. */
+    int (*rx_ddc_write)(struct bladerf *dev, uint32_t value);
+    int (*rx_ddc_read)(struct bladerf *dev, uint32_t *value);
+
+    /* TX digital upconverter control register accessors. See
+     * NIOS_PKT_8x32_TARGET_TX_DUC for the register's fields. */
+    int (*tx_duc_write)(struct bladerf *dev, uint32_t value);
+    int (*tx_duc_read)(struct bladerf *dev, uint32_t *value);
+
+    /* RX power detector register accessors. See
+     * NIOS_PKT_8x32_TARGET_RX_POWER for the register addresses. */
+    int (*rx_power_write)(struct bladerf *dev, uint8_t addr, uint32_t value);
+    int (*rx_power_read)(struct bladerf *dev, uint8_t addr, uint32_t *value);
+
+    /* RX burst gate register accessors. See
+     * NIOS_PKT_8x32_TARGET_RX_BURST for the register addresses. */
+    int (*rx_burst_write)(struct bladerf *dev, uint8_t addr, uint32_t value);
+    int (*rx_burst_read)(struct bladerf *dev, uint8_t addr, uint32_t *value);
+
+    /* Sample FIFO level monitor register accessors. See
+     * NIOS_PKT_8x32_TARGET_FIFO_LEVEL for the register addresses. */
+    int (*fifo_level_write)(struct bladerf *dev, uint8_t addr, uint32_t value);
+    int (*fifo_level_read)(struct bladerf *dev, uint8_t addr, uint32_t *value);
+
+    /* TX waveform loop register accessors. See NIOS_PKT_8x32_TARGET_TX_LOOP
+     * for the register addresses. */
+    int (*tx_loop_write)(struct bladerf *dev, uint8_t addr, uint32_t value);
+    int (*tx_loop_read)(struct bladerf *dev, uint8_t addr, uint32_t *value);
+
+    /* VCTCXO tamer trim state accessors. See
+     * NIOS_PKT_8x32_TARGET_VCTCXO_TAMER for the register addresses. */
+    int (*vctcxo_tamer_write)(struct bladerf *dev,
+                              uint8_t addr,
+                              uint32_t value);
+    int (*vctcxo_tamer_read)(struct bladerf *dev,
+                             uint8_t addr,
+                             uint32_t *value);
+
     /* AD56X1 VCTCXO Trim DAC accessors */
     int (*ad56x1_vctcxo_trim_dac_write)(struct bladerf *dev, uint16_t value);
     int (*ad56x1_vctcxo_trim_dac_read)(struct bladerf *dev, uint16_t *value);
@@ -238,6 +389,21 @@ struct backend_fns {
     int (*set_firmware_loopback)(struct bladerf *dev, bool enable);
     int (*get_firmware_loopback)(struct bladerf *dev, bool *is_enabled);
 
+    /* Configure the FX3's sample endpoint DMA buffers. A count of 0
+     * restores the defaults. The size of each buffer is in units of the
+     * endpoint's maximum packet size. */
+    int (*set_sample_dma)(struct bladerf *dev,
+                          unsigned int count,
+                          unsigned int packets);
+    int (*get_sample_dma)(struct bladerf *dev,
+                          unsigned int *count,
+                          unsigned int *packets);
+
+    /* Read, and optionally reset, the FX3's sample path counters */
+    int (*get_fw_stats)(struct bladerf *dev,
+                        struct bladerf_fx3_stats *stats,
+                        bool reset);
+
     /* Sample stream */
     int (*enable_module)(struct bladerf *dev,
                          bladerf_direction dir,
@@ -252,7 +418,14 @@ struct backend_fns {
                                 bool nonblock);
     void (*deinit_stream)(struct bladerf_stream *stream);
 
-    /* Schedule a frequency retune operation */
+    /* Allocate and free memory for stream buffers that can be transferred
+     * without an intermediate copy (e.g., usbfs-mapped memory). Allocation
+     * returns NULL when such memory is unavailable. */
+    void *(*alloc_stream_mem)(struct bladerf *dev, size_t len);
+    void (*free_stream_mem)(struct bladerf *dev, void *mem, size_t len);
+
+    /* Schedule, cancel, or replace a frequency retune operation, as
+     * specified by a NIOS_PKT_RETUNE_OP_* value */
     int (*retune)(struct bladerf *dev,
                   bladerf_channel ch,
                   uint64_t timestamp,
@@ -262,16 +435,57 @@ struct backend_fns {
                   uint8_t vcocap,
                   bool low_band,
                   uint8_t xb_gpio,
-                  bool quick_tune);
-
-    /* Schedule a frequency retune2 operation */
+                  bool quick_tune,
+                  uint8_t op);
+
+    /* Stage DC offset, IQ balance and gain corrections, as
+     * NIOS_PKT_RETUNE_CORR_* flags and register values, for the channel's
+     * next retune request */
+    int (*retune_corr)(struct bladerf *dev,
+                       bladerf_channel ch,
+                       uint8_t flags,
+                       uint8_t dc_i,
+                       uint8_t dc_q,
+                       uint16_t gain,
+                       uint16_t phase,
+                       uint8_t lna,
+                       uint8_t vga1,
+                       uint8_t vga2);
+
+    /* Schedule, cancel, or replace a frequency retune2 operation, as
+     * specified by a NIOS_PKT_RETUNE2_OP_* value */
     int (*retune2)(struct bladerf *dev,
                    bladerf_channel ch,
                    uint64_t timestamp,
                    uint16_t nios_profile,
                    uint8_t rffe_profile,
                    uint8_t port,
-                   uint8_t spdt);
+                   uint8_t spdt,
+                   uint8_t op);
+
+    /* Schedule a parameter change in the retune2 queue */
+    int (*retune2_param)(struct bladerf *dev,
+                         bladerf_channel ch,
+                         uint64_t timestamp,
+                         uint8_t type,
+                         uint8_t cmd,
+                         uint32_t value);
+
+    /* Schedule simultaneous RX and TX retune2 operations, as a single
+     * entry timed against the RX timestamp */
+    int (*retune2_pair)(struct bladerf *dev,
+                        uint64_t timestamp,
+                        uint16_t rx_nios_profile,
+                        uint8_t rx_rffe_profile,
+                        uint16_t tx_nios_profile,
+                        uint8_t tx_rffe_profile,
+                        uint8_t port,
+                        uint8_t spdt);
+
+    /* Read measurements of the most recent FPGA retune */
+    int (*get_retune_stats)(struct bladerf *dev,
+                            bladerf_channel ch,
+                            struct bladerf_retune_stats *stats);
 
     /* Load firmware from FX3 bootloader */
     int (*load_fw_from_bootloader)(bladerf_backend backend,
@@ -292,6 +506,18 @@ struct backend_fns {
                          bladerf_trigger_signal trigger,
                          uint8_t val);
 
+    /* Schedule a trigger fire, and read back when a trigger fired.
+     * Timestamps are in the units of the channel's timestamp counter. */
+    int (*trigger_fire_at)(struct bladerf *dev,
+                           bladerf_channel ch,
+                           bladerf_trigger_signal trigger,
+                           uint64_t timestamp);
+    int (*trigger_fire_time)(struct bladerf *dev,
+                             bladerf_channel ch,
+                             bladerf_trigger_signal trigger,
+                             bool *fired,
+                             uint64_t *timestamp);
+
     /* Backend name */
     const char *name;
 };
@@ -321,6 +547,16 @@ int backend_probe(backend_probe_target probe_target,
                   struct bladerf_devinfo **devinfo_items,
                   size_t *num_items);
 
+/**
+ * Start or stop each backend's background device monitor
+ *
+ * @param[in]   enable          Start (true) or stop (false) the monitors
+ *
+ * @return 0 if any backend supports a monitor, BLADERF_ERR_UNSUPPORTED if
+ *         none do, or another BLADERF_ERR_* value on failure
+ */
+int backend_set_device_monitor(bool enable);
+
 /**
  * Search for bootloader via provided specification, download firmware,
  * and boot it.
@@ -337,6 +573,57 @@ int backend_load_fw_from_bootloader(bladerf_backend backend,
                                     uint8_t addr,
                                     struct fx3_firmware *fw);
 
+/**
+ * Perform a sequence of register accesses one at a time, in order, via the
+ * provided single-access functions. This is intended to be used by backends
+ * that cannot carry multiple accesses in a single request.
+ *
+ * @param       dev         Device handle
+ * @param[in]   write_fn    Register write function
+ * @param[in]   read_fn     Register read function
+ * @param       ops         Accesses to perform. Read data is stored in the
+ *                          associated `data` fields.
+ * @param[in]   count       Number of accesses
+ *
+ * @return 0 on success, or the status of the first access that failed
+ */
+int backend_reg_batch_sequential(struct bladerf *dev,
+                                 int (*write_fn)(struct bladerf *dev,
+                                                 uint8_t addr,
+                                                 uint8_t data),
+                                 int (*read_fn)(struct bladerf *dev,
+                                                uint8_t addr,
+                                                uint8_t *data),
+                                 struct backend_reg_op *ops,
+                                 unsigned int count);
+
+/**
+ * Read or write a range of consecutive registers, one at a time. This is
+ * intended for use by backends that cannot access multiple registers in a
+ * single request.
+ *
+ * @param       dev         Device handle
+ * @param[in]   write_fn    Register write function
+ * @param[in]   read_fn     Register read function
+ * @param[in]   write       Write (true) or read (false) the registers
+ * @param[in]   addr        Address of the first register
+ * @param       data        Data to write, or updated with the data read
+ * @param[in]   count       Number of registers
+ *
+ * @return 0 on success, or the status of the first access that failed
+ */
+int backend_reg_block_sequential(struct bladerf *dev,
+                                 int (*write_fn)(struct bladerf *dev,
+                                                 uint8_t addr,
+                                                 uint8_t data),
+                                 int (*read_fn)(struct bladerf *dev,
+                                                uint8_t addr,
+                                                uint8_t *data),
+                                 bool write,
+                                 uint8_t addr,
+                                 uint8_t *data,
+                                 unsigned int count);
+
 /**
  * Convert a backend enumeration value to a string
  *
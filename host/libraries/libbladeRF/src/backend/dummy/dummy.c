@@ -1,7 +1,45 @@
 /*
- * Dummy backend to allow libbladeRF to build when no other backends are
- * enabled. This is intended for development purposes only, and should
- * generally should not be enabled for libbladeRF releases.
+ * Dummy backend, emulating a bladeRF x115 without any hardware attached.
+ * This allows libbladeRF to build when no other backends are enabled, and
+ * provides a synthetic device for exercising the control and streaming
+ * paths (e.g., in benchmarks and CI) via the "dummy" device identifier.
+ *
+ * Register accesses are stored in and read back from in-memory register
+ * files. Sample streams are paced against the host's wall clock at the
+ * configured sample rate. RX buffers are filled with a synthetic pattern and
+ * TX buffers are consumed, honoring the timestamps in metadata headers.
+ *
+ * The following environment variables alter the emulated device's behavior:
+ *
+ *  BLADERF_DUMMY_SAMPLERATE   Overrides the sample rate used to pace streams.
+ *                             A value of 0 disables pacing entirely, and
+ *                             buffers complete as quickly as possible.
+ *
+ *  BLADERF_DUMMY_RX_PATTERN   Selects the RX sample pattern: "counter"
+ *                             (default; I/Q form a 32-bit sample counter),
+ *                             "tone" (fs/16 complex tone), "noise", or "zero".
+ *
+ *  BLADERF_DUMMY_FAULTS       Injects stream faults, as a comma-separated list
+ *                             of <fault>:<period>, where every <period>th
+ *                             transfer completion of a stream is affected:
+ *
+ *                               short    completes with half of its data
+ *                               timeout  times out after the stream's
+ *                                        transfer timeout
+ *                               stall    fails as if the endpoint stalled
+ *                               delay    completes late; "delay:<period>:<us>"
+ *                                        sets the delay (default 5000 us)
+ *                               reorder  completes after the transfer that
+ *                                        follows it
+ *
+ *                             Faults are scheduled by transfer count alone,
+ *                             so a given stream sees them at the same points
+ *                             on every run. Timeouts and stalls end the
+ *                             stream with BLADERF_ERR_TIMEOUT and
+ *                             BLADERF_ERR_IO, as the libusb backend does.
+ *
+ * This is intended for development purposes only, and should generally not
+ * be enabled for libbladeRF releases.
  *
  * This file is part of the bladeRF project:
  *   http://www.github.com/nuand/bladeRF
@@ -23,16 +61,151 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#include "rel_assert.h"
+#include "log.h"
+#include "conversions.h"
+#include "bladeRF.h"
+
 #include "backend/backend.h"
+#include "backend/backend_config.h"
+#include "backend/usb/usb.h"
 
 #include "board/board.h"
+#include "board/bladerf1/flash.h"
+
+#include "streaming/async.h"
+#include "streaming/format.h"
+#include "streaming/metadata.h"
+
+#include "helpers/alloc.h"
+#include "helpers/timeout.h"
+#include "helpers/version.h"
+#include "helpers/wallclock.h"
+
+#define DUMMY_FW_VERSION "2.4.0"
+#define DUMMY_DEFAULT_RATE 1000000
+
+/* Largest period the stream thread sleeps for while idle */
+#define DUMMY_IDLE_WAIT_NS 100000000ull
+
+/* Default lateness of a "delay" fault */
+#define DUMMY_FAULT_DELAY_NS 5000000ull
+
+typedef enum {
+    DUMMY_PATTERN_COUNTER,
+    DUMMY_PATTERN_TONE,
+    DUMMY_PATTERN_NOISE,
+    DUMMY_PATTERN_ZERO,
+} dummy_pattern;
+
+/* Faults that may be injected into streams, in order of precedence */
+typedef enum {
+    DUMMY_FAULT_STALL,
+    DUMMY_FAULT_TIMEOUT,
+    DUMMY_FAULT_SHORT,
+    DUMMY_FAULT_REORDER,
+    DUMMY_FAULT_DELAY,
+    DUMMY_NUM_FAULTS,
+    DUMMY_FAULT_NONE = DUMMY_NUM_FAULTS,
+} dummy_fault;
+
+static const char *const dummy_fault_names[DUMMY_NUM_FAULTS] = {
+    "stall", "timeout", "short", "reorder", "delay",
+};
+
+struct dummy_device {
+    MUTEX lock;
+
+    uint32_t config_gpio;
+    uint32_t expansion_gpio;
+    uint32_t expansion_gpio_dir;
+    int16_t iq_gain[2];
+    int16_t iq_phase[2];
+    uint16_t vctcxo_dac;
+    bladerf_vctcxo_tamer_mode tamer_mode;
+    bool fw_loopback;
+
+    uint8_t lms_regs[128];
+    uint8_t si5338_regs[256];
+
+    /* Emulated timestamp counter, anchored to the wall clock */
+    uint64_t clock_rate;
+    uint64_t clock_anchor_ns;
+    uint64_t clock_anchor_ts;
+
+    /* Environment overrides. A negative rate implies no override. */
+    int64_t rate_override;
+    dummy_pattern rx_pattern;
+
+    /* Transfers between injected faults of each kind. 0 disables a fault. */
+    uint64_t fault_period[DUMMY_NUM_FAULTS];
+    uint64_t fault_delay_ns;
+};
+
+struct dummy_stream_data {
+    size_t num_transfers;
+    size_t num_avail;
+
+    /* In-flight transfers, completed in submission order */
+    void **buf;
+    size_t *len;
+    uint64_t *submit_ns;
+    size_t head;
+    size_t count;
+
+    pthread_cond_t work;
+
+    bool paced;
+    uint64_t ts;       /* Timestamp of the next sample on the "wire" */
+    uint32_t noise;    /* xorshift state for the noise pattern */
+
+    uint64_t completed; /* Transfers completed, for scheduling faults */
+    bool out_of_order_event;
+};
+
+/* fs/16 complex tone at roughly -3 dBFS */
+static const int16_t dummy_tone[16][2] = {
+    { 1448,     0 }, {  1338,   554 }, {  1024,  1024 }, {   554,  1338 },
+    {    0,  1448 }, {  -554,  1338 }, { -1024,  1024 }, { -1338,   554 },
+    { -1448,     0 }, { -1338,  -554 }, { -1024, -1024 }, {  -554, -1338 },
+    {    0, -1448 }, {   554, -1338 }, {  1024, -1024 }, {  1338,  -554 },
+};
+
+static inline struct dummy_device *dummy_backend(struct bladerf *dev)
+{
+    return dev->backend_data;
+}
+
+/* Must be called with d->lock held */
+static uint64_t dummy_clock_now(struct dummy_device *d, uint64_t now_ns)
+{
+    const double elapsed_ns = (double)(now_ns - d->clock_anchor_ns);
+    return d->clock_anchor_ts +
+           (uint64_t)(elapsed_ns * d->clock_rate / 1e9);
+}
+
+/* Must be called with d->lock held */
+static uint64_t dummy_clock_to_ns(struct dummy_device *d, uint64_t ts)
+{
+    if (ts <= d->clock_anchor_ts) {
+        return d->clock_anchor_ns;
+    }
+
+    return d->clock_anchor_ns +
+           (uint64_t)((ts - d->clock_anchor_ts) * 1e9 / d->clock_rate);
+}
 
 static bool dummy_matches(bladerf_backend backend)
 {
-    return false;
+    return backend == BLADERF_BACKEND_DUMMY;
 }
 
-/* We never "find" dummy devices */
+/* We never "find" dummy devices; they must be opened explicitly */
 static int dummy_probe(backend_probe_target probe_target,
                        struct bladerf_devinfo_list *info_list)
 {
@@ -41,12 +214,163 @@ static int dummy_probe(backend_probe_target probe_target,
 
 static int dummy_get_vid_pid(struct bladerf *dev, uint16_t *vid, uint16_t *pid)
 {
-    return BLADERF_ERR_UNSUPPORTED;
+    *vid = USB_NUAND_VENDOR_ID;
+    *pid = USB_NUAND_BLADERF_PRODUCT_ID;
+    return 0;
+}
+
+/* Parse a BLADERF_DUMMY_FAULTS list. Invalid entries are skipped. */
+static void dummy_parse_faults(struct dummy_device *d, const char *env)
+{
+    const char *p = env;
+
+    while (*p != '\0') {
+        const char *end = strchr(p, ',');
+        const size_t len = (end != NULL) ? (size_t)(end - p) : strlen(p);
+        char entry[64];
+        char *period, *delay, *tail;
+        unsigned long long value;
+        unsigned int i;
+
+        if (len >= sizeof(entry)) {
+            log_warning("Ignoring invalid BLADERF_DUMMY_FAULTS entry\n");
+            goto next;
+        }
+
+        memcpy(entry, p, len);
+        entry[len] = '\0';
+
+        period = strchr(entry, ':');
+        if (period == NULL) {
+            log_warning("Ignoring BLADERF_DUMMY_FAULTS entry without a "
+                        "period: %s\n", entry);
+            goto next;
+        }
+        *period++ = '\0';
+
+        delay = strchr(period, ':');
+        if (delay != NULL) {
+            *delay++ = '\0';
+        }
+
+        for (i = 0; i < DUMMY_NUM_FAULTS; i++) {
+            if (!strcasecmp(entry, dummy_fault_names[i])) {
+                break;
+            }
+        }
+
+        value = strtoull(period, &tail, 0);
+        if (i == DUMMY_NUM_FAULTS || tail == period || *tail != '\0' ||
+            (delay != NULL && i != DUMMY_FAULT_DELAY)) {
+            log_warning("Ignoring invalid BLADERF_DUMMY_FAULTS entry: %s\n",
+                        entry);
+            goto next;
+        }
+
+        d->fault_period[i] = value;
+
+        if (delay != NULL) {
+            value = strtoull(delay, &tail, 0);
+            if (tail == delay || *tail != '\0') {
+                log_warning("Ignoring invalid fault delay: %s\n", delay);
+            } else {
+                d->fault_delay_ns = value * 1000;
+            }
+        }
+
+        log_debug("Injecting a %s fault every %" PRIu64 " transfers\n",
+                  dummy_fault_names[i], d->fault_period[i]);
+
+    next:
+        if (end == NULL) {
+            break;
+        }
+        p = end + 1;
+    }
+}
+
+static void dummy_parse_env(struct dummy_device *d)
+{
+    const char *env;
+
+    d->rate_override  = -1;
+    d->rx_pattern     = DUMMY_PATTERN_COUNTER;
+    d->fault_delay_ns = DUMMY_FAULT_DELAY_NS;
+
+    env = getenv("BLADERF_DUMMY_SAMPLERATE");
+    if (env != NULL) {
+        char *end;
+        const long long rate = strtoll(env, &end, 0);
+
+        if (end == env || *end != '\0' || rate < 0) {
+            log_warning("Ignoring invalid BLADERF_DUMMY_SAMPLERATE: %s\n",
+                        env);
+        } else {
+            d->rate_override = rate;
+        }
+    }
+
+    env = getenv("BLADERF_DUMMY_RX_PATTERN");
+    if (env != NULL) {
+        if (!strcasecmp(env, "counter")) {
+            d->rx_pattern = DUMMY_PATTERN_COUNTER;
+        } else if (!strcasecmp(env, "tone")) {
+            d->rx_pattern = DUMMY_PATTERN_TONE;
+        } else if (!strcasecmp(env, "noise")) {
+            d->rx_pattern = DUMMY_PATTERN_NOISE;
+        } else if (!strcasecmp(env, "zero")) {
+            d->rx_pattern = DUMMY_PATTERN_ZERO;
+        } else {
+            log_warning("Ignoring invalid BLADERF_DUMMY_RX_PATTERN: %s\n",
+                        env);
+        }
+    }
+
+    env = getenv("BLADERF_DUMMY_FAULTS");
+    if (env != NULL) {
+        dummy_parse_faults(d, env);
+    }
 }
 
 static int dummy_open(struct bladerf *dev, struct bladerf_devinfo *info)
 {
-    return BLADERF_ERR_NODEV;
+    struct dummy_device *d;
+
+    if (info->backend != BLADERF_BACKEND_DUMMY) {
+        return BLADERF_ERR_NODEV;
+    }
+
+    d = calloc(1, sizeof(*d));
+    if (d == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    MUTEX_INIT(&d->lock);
+
+    d->vctcxo_dac      = 0x8000;
+    d->tamer_mode      = BLADERF_VCTCXO_TAMER_DISABLED;
+    d->clock_rate      = DUMMY_DEFAULT_RATE;
+    d->clock_anchor_ns = wallclock_get_current_nsec();
+    d->clock_anchor_ts = 0;
+
+    dummy_parse_env(d);
+
+    dev->backend      = &backend_fns_dummy;
+    dev->backend_data = d;
+
+    bladerf_init_devinfo(&dev->ident);
+    dev->ident.backend  = BLADERF_BACKEND_DUMMY;
+    dev->ident.usb_bus  = 0;
+    dev->ident.usb_addr = 0;
+    dev->ident.instance = 0;
+    memset(dev->ident.serial, '0', BLADERF_SERIAL_LENGTH - 1);
+    dev->ident.serial[BLADERF_SERIAL_LENGTH - 1] = '\0';
+    strncpy(dev->ident.manufacturer, "Nuand", BLADERF_DESCRIPTION_LENGTH - 1);
+    strncpy(dev->ident.product, "bladeRF (dummy)",
+            BLADERF_DESCRIPTION_LENGTH - 1);
+
+    log_verbose("Opened dummy device\n");
+    return 0;
 }
 
 static int dummy_set_fpga_protocol(struct bladerf *dev,
@@ -57,22 +381,32 @@ static int dummy_set_fpga_protocol(struct bladerf *dev,
 
 static void dummy_close(struct bladerf *dev)
 {
-    /* Nothing to do */
+    struct dummy_device *d = dummy_backend(dev);
+
+    if (d != NULL) {
+        MUTEX_DESTROY(&d->lock);
+        free(d);
+        dev->backend_data = NULL;
+    }
 }
 
 static int dummy_is_fw_ready(struct bladerf *dev)
 {
-    return 0;
+    return 1;
 }
 
 static int dummy_get_handle(struct bladerf *dev, void **handle)
 {
+    *handle = NULL;
     return 0;
 }
 
 static int dummy_get_flash_id(struct bladerf *dev, uint8_t *mid, uint8_t *did)
 {
-    return BLADERF_ERR_UNSUPPORTED;
+    /* Winbond W25Q32JV, as populated on bladeRF x115 boards */
+    *mid = 0xef;
+    *did = 0x15;
+    return 0;
 }
 
 static int dummy_load_fpga(struct bladerf *dev,
@@ -83,19 +417,40 @@ static int dummy_load_fpga(struct bladerf *dev,
 }
 
 static int dummy_is_fpga_configured(struct bladerf *dev)
+{
+    return 1;
+}
+
+static int dummy_is_fpga_image_loaded(struct bladerf *dev,
+                                      const uint8_t *image,
+                                      size_t image_size)
 {
     return 0;
 }
 
+static bladerf_fpga_source dummy_get_fpga_source(struct bladerf *dev)
+{
+    return BLADERF_FPGA_SOURCE_FLASH;
+}
+
 static int dummy_get_fw_version(struct bladerf *dev,
                                 struct bladerf_version *version)
 {
-    return 0;
+    strncpy((char *)version->describe, DUMMY_FW_VERSION,
+            BLADERF_VERSION_STR_MAX);
+    return str2version(version->describe, version);
 }
 
 static int dummy_get_fpga_version(struct bladerf *dev,
                                   struct bladerf_version *version)
 {
+    version->major = 0;
+    version->minor = 12;
+    version->patch = 0;
+
+    snprintf((char *)version->describe, BLADERF_VERSION_STR_MAX, "%d.%d.%d",
+             version->major, version->minor, version->patch);
+
     return 0;
 }
 
@@ -122,6 +477,14 @@ static int dummy_write_flash_pages(struct bladerf *dev,
     return 0;
 }
 
+static int dummy_hash_flash_pages(struct bladerf *dev,
+                                  uint32_t page,
+                                  uint32_t count,
+                                  uint8_t *digest)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
 static int dummy_device_reset(struct bladerf *dev)
 {
     return 0;
@@ -134,11 +497,23 @@ static int dummy_jump_to_bootloader(struct bladerf *dev)
 
 static int dummy_get_cal(struct bladerf *dev, char *cal)
 {
-    return 0;
+    int status;
+
+    memset(cal, 0xff, CAL_BUFFER_SIZE);
+
+    status = binkv_add_field(cal, CAL_BUFFER_SIZE, "B", "115");
+    if (status < 0) {
+        return status;
+    }
+
+    return binkv_add_field(cal, CAL_BUFFER_SIZE, "DAC", "32768");
 }
 
 static int dummy_get_otp(struct bladerf *dev, char *otp)
 {
+    /* Never-programmed OTP is read back as all 0xff. The caller provides
+     * a page-sized buffer, which matches the calibration region's size. */
+    memset(otp, 0xff, CAL_BUFFER_SIZE);
     return 0;
 }
 
@@ -155,16 +530,19 @@ static int dummy_lock_otp(struct bladerf *dev)
 static int dummy_get_device_speed(struct bladerf *dev,
                                   bladerf_dev_speed *device_speed)
 {
+    *device_speed = BLADERF_DEVICE_SPEED_SUPER;
     return 0;
 }
 
 static int dummy_config_gpio_write(struct bladerf *dev, uint32_t val)
 {
+    dummy_backend(dev)->config_gpio = val;
     return 0;
 }
 
 static int dummy_config_gpio_read(struct bladerf *dev, uint32_t *val)
 {
+    *val = dummy_backend(dev)->config_gpio;
     return 0;
 }
 
@@ -172,11 +550,14 @@ static int dummy_expansion_gpio_write(struct bladerf *dev,
                                       uint32_t mask,
                                       uint32_t val)
 {
+    struct dummy_device *d = dummy_backend(dev);
+    d->expansion_gpio = (d->expansion_gpio & ~mask) | (val & mask);
     return 0;
 }
 
 static int dummy_expansion_gpio_read(struct bladerf *dev, uint32_t *val)
 {
+    *val = dummy_backend(dev)->expansion_gpio;
     return 0;
 }
 
@@ -184,11 +565,14 @@ static int dummy_expansion_gpio_dir_write(struct bladerf *dev,
                                           uint32_t mask,
                                           uint32_t val)
 {
+    struct dummy_device *d = dummy_backend(dev);
+    d->expansion_gpio_dir = (d->expansion_gpio_dir & ~mask) | (val & mask);
     return 0;
 }
 
 static int dummy_expansion_gpio_dir_read(struct bladerf *dev, uint32_t *val)
 {
+    *val = dummy_backend(dev)->expansion_gpio_dir;
     return 0;
 }
 
@@ -196,6 +580,7 @@ static int dummy_set_iq_gain_correction(struct bladerf *dev,
                                         bladerf_channel ch,
                                         int16_t value)
 {
+    dummy_backend(dev)->iq_gain[BLADERF_CHANNEL_IS_TX(ch) ? 1 : 0] = value;
     return 0;
 }
 
@@ -203,6 +588,7 @@ static int dummy_set_iq_phase_correction(struct bladerf *dev,
                                          bladerf_channel ch,
                                          int16_t value)
 {
+    dummy_backend(dev)->iq_phase[BLADERF_CHANNEL_IS_TX(ch) ? 1 : 0] = value;
     return 0;
 }
 
@@ -210,7 +596,7 @@ static int dummy_get_iq_gain_correction(struct bladerf *dev,
                                         bladerf_channel ch,
                                         int16_t *value)
 {
-    *value = 0;
+    *value = dummy_backend(dev)->iq_gain[BLADERF_CHANNEL_IS_TX(ch) ? 1 : 0];
     return 0;
 }
 
@@ -218,7 +604,18 @@ static int dummy_get_iq_phase_correction(struct bladerf *dev,
                                          bladerf_channel ch,
                                          int16_t *value)
 {
-    *value = 0;
+    *value = dummy_backend(dev)->iq_phase[BLADERF_CHANNEL_IS_TX(ch) ? 1 : 0];
+    return 0;
+}
+
+static int dummy_set_agc_dc_correction(struct bladerf *dev,
+                                       int16_t q_max,
+                                       int16_t i_max,
+                                       int16_t q_mid,
+                                       int16_t i_mid,
+                                       int16_t q_low,
+                                       int16_t i_low)
+{
     return 0;
 }
 
@@ -226,29 +623,112 @@ static int dummy_get_timestamp(struct bladerf *dev,
                                bladerf_direction dir,
                                uint64_t *val)
 {
+    struct dummy_device *d = dummy_backend(dev);
+
+    MUTEX_LOCK(&d->lock);
+    *val = dummy_clock_now(d, wallclock_get_current_nsec());
+    MUTEX_UNLOCK(&d->lock);
+
     return 0;
 }
 
+static int dummy_get_timestamp_latch(struct bladerf *dev,
+                                     bladerf_direction dir,
+                                     uint64_t *val,
+                                     uint32_t *hold)
+{
+    *hold = 0;
+    return dummy_get_timestamp(dev, dir, val);
+}
+
 static int dummy_si5338_read(struct bladerf *dev, uint8_t addr, uint8_t *data)
 {
+    *data = dummy_backend(dev)->si5338_regs[addr];
     return 0;
 }
 
 static int dummy_si5338_write(struct bladerf *dev, uint8_t addr, uint8_t data)
 {
+    dummy_backend(dev)->si5338_regs[addr] = data;
     return 0;
 }
 
 static int dummy_lms_write(struct bladerf *dev, uint8_t addr, uint8_t data)
 {
+    dummy_backend(dev)->lms_regs[addr & 0x7f] = data;
     return 0;
 }
 
 static int dummy_lms_read(struct bladerf *dev, uint8_t addr, uint8_t *data)
 {
+    *data = dummy_backend(dev)->lms_regs[addr & 0x7f];
     return 0;
 }
 
+static int dummy_si5338_batch(struct bladerf *dev,
+                              struct backend_reg_op *ops,
+                              unsigned int count)
+{
+    return backend_reg_batch_sequential(dev, dummy_si5338_write,
+                                        dummy_si5338_read, ops, count);
+}
+
+static int dummy_lms_batch(struct bladerf *dev,
+                           struct backend_reg_op *ops,
+                           unsigned int count)
+{
+    return backend_reg_batch_sequential(dev, dummy_lms_write, dummy_lms_read,
+                                        ops, count);
+}
+
+static int dummy_si5338_block(struct bladerf *dev,
+                              bool write,
+                              uint8_t addr,
+                              uint8_t *data,
+                              unsigned int count)
+{
+    return backend_reg_block_sequential(dev, dummy_si5338_write,
+                                        dummy_si5338_read, write, addr, data,
+                                        count);
+}
+
+static int dummy_lms_block(struct bladerf *dev,
+                           bool write,
+                           uint8_t addr,
+                           uint8_t *data,
+                           unsigned int count)
+{
+    return backend_reg_block_sequential(dev, dummy_lms_write, dummy_lms_read,
+                                        write, addr, data, count);
+}
+
+static int dummy_lms_vcocap_search(struct bladerf *dev,
+                                   bladerf_module mod,
+                                   uint8_t vcocap_est,
+                                   uint8_t *vcocap_result,
+                                   bool *locked)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_lms_dc_cal_loop(struct bladerf *dev,
+                                 uint8_t base,
+                                 uint8_t cal_addr,
+                                 uint8_t dc_cntval,
+                                 uint8_t *dc_regval,
+                                 bool *done)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_lms_dc_cal_load(struct bladerf *dev,
+                                 uint8_t base,
+                                 uint8_t cal_addr,
+                                 uint8_t value)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
 static int dummy_ina219_write(struct bladerf *dev, uint8_t cmd, uint16_t data)
 {
     return 0;
@@ -256,6 +736,7 @@ static int dummy_ina219_write(struct bladerf *dev, uint8_t cmd, uint16_t data)
 
 static int dummy_ina219_read(struct bladerf *dev, uint8_t addr, uint16_t *data)
 {
+    *data = 0;
     return 0;
 }
 
@@ -270,6 +751,7 @@ static int dummy_ad9361_spi_read(struct bladerf *dev,
                                  uint16_t cmd,
                                  uint64_t *data)
 {
+    *data = 0;
     return 0;
 }
 
@@ -283,10 +765,35 @@ static int dummy_adi_axi_write(struct bladerf *dev,
 static int dummy_adi_axi_read(struct bladerf *dev,
                               uint32_t addr,
                               uint32_t *data)
+{
+    *data = 0;
+    return 0;
+}
+
+static int dummy_rfic_command_write(struct bladerf *dev,
+                                    uint16_t cmd,
+                                    uint64_t data)
 {
     return 0;
 }
 
+static int dummy_rfic_command_read(struct bladerf *dev,
+                                   uint16_t cmd,
+                                   uint64_t *data)
+{
+    *data = 0;
+    return 0;
+}
+
+static int dummy_rfic_command_wait(struct bladerf *dev,
+                                   uint16_t cmd,
+                                   unsigned int timeout_ms,
+                                   uint64_t *data)
+{
+    *data = 0;
+    return 0;
+}
+
 static int dummy_rffe_control_write(struct bladerf *dev, uint32_t value)
 {
     return 0;
@@ -294,6 +801,7 @@ static int dummy_rffe_control_write(struct bladerf *dev, uint32_t value)
 
 static int dummy_rffe_control_read(struct bladerf *dev, uint32_t *value)
 {
+    *value = 0;
     return 0;
 }
 
@@ -305,15 +813,124 @@ static int dummy_rffe_fastlock_save(struct bladerf *dev,
     return 0;
 }
 
+static int dummy_rffe_fastlock_read(struct bladerf *dev,
+                                    bool is_tx,
+                                    uint8_t nios_profile,
+                                    uint8_t *data)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_rffe_fastlock_write(struct bladerf *dev,
+                                     bool is_tx,
+                                     uint8_t rffe_profile,
+                                     uint8_t nios_profile,
+                                     const uint8_t *data)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_rx_ddc_write(struct bladerf *dev, uint32_t value)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_rx_ddc_read(struct bladerf *dev, uint32_t *value)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_tx_duc_write(struct bladerf *dev, uint32_t value)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_tx_duc_read(struct bladerf *dev, uint32_t *value)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_rx_power_write(struct bladerf *dev,
+                                uint8_t addr,
+                                uint32_t value)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_rx_power_read(struct bladerf *dev,
+                               uint8_t addr,
+                               uint32_t *value)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_rx_burst_write(struct bladerf *dev,
+                                uint8_t addr,
+                                uint32_t value)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_rx_burst_read(struct bladerf *dev,
+                               uint8_t addr,
+                               uint32_t *value)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_fifo_level_write(struct bladerf *dev,
+                                  uint8_t addr,
+                                  uint32_t value)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_fifo_level_read(struct bladerf *dev,
+                                 uint8_t addr,
+                                 uint32_t *value)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_tx_loop_write(struct bladerf *dev,
+                               uint8_t addr,
+                               uint32_t value)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_tx_loop_read(struct bladerf *dev,
+                              uint8_t addr,
+                              uint32_t *value)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_vctcxo_tamer_write(struct bladerf *dev,
+                                    uint8_t addr,
+                                    uint32_t value)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_vctcxo_tamer_read(struct bladerf *dev,
+                                   uint8_t addr,
+                                   uint32_t *value)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
 static int dummy_ad56x1_vctcxo_trim_dac_write(struct bladerf *dev,
                                               uint16_t value)
 {
+    dummy_backend(dev)->vctcxo_dac = value;
     return 0;
 }
 
 static int dummy_ad56x1_vctcxo_trim_dac_read(struct bladerf *dev,
                                              uint16_t *value)
 {
+    *value = dummy_backend(dev)->vctcxo_dac;
     return 0;
 }
 
@@ -324,6 +941,7 @@ static int dummy_adf400x_write(struct bladerf *dev, uint8_t addr, uint32_t data)
 
 static int dummy_adf400x_read(struct bladerf *dev, uint8_t addr, uint32_t *data)
 {
+    *data = 0;
     return 0;
 }
 
@@ -331,6 +949,7 @@ static int dummy_vctcxo_dac_write(struct bladerf *dev,
                                   uint8_t addr,
                                   uint16_t value)
 {
+    dummy_backend(dev)->vctcxo_dac = value;
     return 0;
 }
 
@@ -338,19 +957,21 @@ static int dummy_vctcxo_dac_read(struct bladerf *dev,
                                  uint8_t addr,
                                  uint16_t *value)
 {
+    *value = dummy_backend(dev)->vctcxo_dac;
     return 0;
 }
 
 static int dummy_set_vctcxo_tamer_mode(struct bladerf *dev,
                                        bladerf_vctcxo_tamer_mode mode)
 {
+    dummy_backend(dev)->tamer_mode = mode;
     return 0;
 }
 
 static int dummy_get_vctcxo_tamer_mode(struct bladerf *dev,
                                        bladerf_vctcxo_tamer_mode *mode)
 {
-    *mode = BLADERF_VCTCXO_TAMER_INVALID;
+    *mode = dummy_backend(dev)->tamer_mode;
     return 0;
 }
 
@@ -361,15 +982,37 @@ static int dummy_xb_spi(struct bladerf *dev, uint32_t value)
 
 static int dummy_set_firmware_loopback(struct bladerf *dev, bool enable)
 {
+    dummy_backend(dev)->fw_loopback = enable;
     return 0;
 }
 
 static int dummy_get_firmware_loopback(struct bladerf *dev, bool *is_enabled)
 {
-    *is_enabled = false;
+    *is_enabled = dummy_backend(dev)->fw_loopback;
     return 0;
 }
 
+static int dummy_set_sample_dma(struct bladerf *dev,
+                                unsigned int count,
+                                unsigned int packets)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_get_sample_dma(struct bladerf *dev,
+                                unsigned int *count,
+                                unsigned int *packets)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_get_fw_stats(struct bladerf *dev,
+                              struct bladerf_fx3_stats *stats,
+                              bool reset)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
 static int dummy_enable_module(struct bladerf *dev,
                                bladerf_direction dir,
                                bool enable)
@@ -377,31 +1020,591 @@ static int dummy_enable_module(struct bladerf *dev,
     return 0;
 }
 
+/******************************************************************************/
+/* Streaming */
+/******************************************************************************/
+
+static void dummy_deinit_stream(struct bladerf_stream *stream)
+{
+    struct dummy_stream_data *sd = stream->backend_data;
+
+    if (sd == NULL) {
+        return;
+    }
+
+    pthread_cond_destroy(&sd->work);
+    alloc_free(sd->buf);
+    alloc_free(sd->len);
+    alloc_free(sd->submit_ns);
+    alloc_free(sd);
+
+    stream->backend_data = NULL;
+}
+
 static int dummy_init_stream(struct bladerf_stream *stream,
                              size_t num_transfers)
 {
+    struct dummy_stream_data *sd;
+
+    if (stream->format != BLADERF_FORMAT_SC16_Q11 &&
+        stream->format != BLADERF_FORMAT_SC16_Q11_META) {
+        log_debug("Dummy backend does not support stream format %d\n",
+                  stream->format);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    sd = alloc_calloc(1, sizeof(*sd));
+    if (sd == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    stream->backend_data = sd;
+
+    sd->num_transfers = num_transfers;
+    sd->num_avail     = num_transfers;
+    sd->noise         = 0x2545f491;
+
+    sd->buf       = alloc_calloc(num_transfers, sizeof(sd->buf[0]));
+    sd->len       = alloc_calloc(num_transfers, sizeof(sd->len[0]));
+    sd->submit_ns = alloc_calloc(num_transfers, sizeof(sd->submit_ns[0]));
+
+    if (sd->buf == NULL || sd->len == NULL || sd->submit_ns == NULL) {
+        alloc_free(sd->buf);
+        alloc_free(sd->len);
+        alloc_free(sd->submit_ns);
+        alloc_free(sd);
+        stream->backend_data = NULL;
+        return BLADERF_ERR_MEM;
+    }
+
+    if (pthread_cond_init(&sd->work, NULL) != 0) {
+        alloc_free(sd->buf);
+        alloc_free(sd->len);
+        alloc_free(sd->submit_ns);
+        alloc_free(sd);
+        stream->backend_data = NULL;
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
     return 0;
 }
 
+static inline size_t dummy_samples_per_msg(void)
+{
+    return (USB_MSG_SIZE_SS - METADATA_HEADER_SIZE) / (2 * sizeof(int16_t));
+}
+
+/* Number of samples carried by a transfer of the specified length */
+static size_t dummy_transfer_samples(struct bladerf_stream *stream,
+                                     size_t len)
+{
+    if (stream->format == BLADERF_FORMAT_SC16_Q11_META) {
+        return (len / USB_MSG_SIZE_SS) * dummy_samples_per_msg();
+    }
+
+    return bytes_to_sc16q11(len);
+}
+
+static void dummy_gen_samples(struct dummy_stream_data *sd,
+                              dummy_pattern pattern,
+                              int16_t *samples,
+                              size_t n,
+                              uint64_t ts)
+{
+    size_t i;
+
+    switch (pattern) {
+        case DUMMY_PATTERN_COUNTER:
+            for (i = 0; i < n; i++, ts++) {
+                samples[2 * i]     = HOST_TO_LE16((uint16_t)ts);
+                samples[2 * i + 1] = HOST_TO_LE16((uint16_t)(ts >> 16));
+            }
+            break;
+
+        case DUMMY_PATTERN_TONE:
+            for (i = 0; i < n; i++, ts++) {
+                samples[2 * i]     = HOST_TO_LE16(dummy_tone[ts & 15][0]);
+                samples[2 * i + 1] = HOST_TO_LE16(dummy_tone[ts & 15][1]);
+            }
+            break;
+
+        case DUMMY_PATTERN_NOISE:
+            for (i = 0; i < 2 * n; i++) {
+                uint32_t x = sd->noise;
+                x ^= x << 13;
+                x ^= x >> 17;
+                x ^= x << 5;
+                sd->noise  = x;
+                samples[i] = HOST_TO_LE16((int16_t)(x & 0xfff) - 2048);
+            }
+            break;
+
+        case DUMMY_PATTERN_ZERO:
+        default:
+            memset(samples, 0, n * 2 * sizeof(int16_t));
+            break;
+    }
+}
+
+/* Fill an RX buffer, starting at timestamp ts. Returns the timestamp
+ * following the last sample. */
+static uint64_t dummy_fill_rx(struct bladerf_stream *stream,
+                              dummy_pattern pattern,
+                              uint8_t *buf,
+                              size_t len,
+                              uint64_t ts)
+{
+    struct dummy_stream_data *sd = stream->backend_data;
+
+    if (stream->format == BLADERF_FORMAT_SC16_Q11_META) {
+        const size_t spm = dummy_samples_per_msg();
+        size_t off;
+
+        for (off = 0; off + USB_MSG_SIZE_SS <= len; off += USB_MSG_SIZE_SS) {
+            metadata_set(buf + off, ts, 0);
+            dummy_gen_samples(sd, pattern,
+                              (int16_t *)(buf + off + METADATA_HEADER_SIZE),
+                              spm, ts);
+            ts += spm;
+        }
+    } else {
+        const size_t n = bytes_to_sc16q11(len);
+        dummy_gen_samples(sd, pattern, (int16_t *)buf, n, ts);
+        ts += n;
+    }
+
+    return ts;
+}
+
+/* Consume a TX buffer, starting at timestamp ts. Messages timestamped in the
+ * future are held until their time, as the FPGA would. Returns the timestamp
+ * following the last sample. */
+static uint64_t dummy_drain_tx(struct bladerf_stream *stream,
+                               const uint8_t *buf,
+                               size_t len,
+                               uint64_t ts)
+{
+    if (stream->format == BLADERF_FORMAT_SC16_Q11_META) {
+        const size_t spm = dummy_samples_per_msg();
+        size_t off;
+
+        for (off = 0; off + USB_MSG_SIZE_SS <= len; off += USB_MSG_SIZE_SS) {
+            const uint64_t msg_ts = metadata_get_timestamp(buf + off);
+            if (msg_ts > ts) {
+                ts = msg_ts;
+            }
+            ts += spm;
+        }
+
+        return ts;
+    }
+
+    return ts + bytes_to_sc16q11(len);
+}
+
+/* Precondition: A transfer is available, and stream->lock is held. */
+static void dummy_submit_transfer(struct bladerf_stream *stream,
+                                  void *buffer,
+                                  size_t len)
+{
+    struct dummy_device *d       = dummy_backend(stream->dev);
+    struct dummy_stream_data *sd = stream->backend_data;
+    const uint64_t now_ns        = wallclock_get_current_nsec();
+    size_t i;
+
+    assert(sd->num_avail != 0);
+
+    /* Nothing was in flight for longer than a transfer's worth of samples:
+     * the device overran (RX) or underran (TX), and resumes at "now." */
+    if (sd->paced && sd->count == 0) {
+        uint64_t now_ts;
+
+        MUTEX_LOCK(&d->lock);
+        now_ts = dummy_clock_now(d, now_ns);
+        MUTEX_UNLOCK(&d->lock);
+
+        if (now_ts > sd->ts + dummy_transfer_samples(stream, len)) {
+            sd->ts = now_ts;
+        }
+    }
+
+    i = (sd->head + sd->count) % sd->num_transfers;
+    sd->buf[i]       = buffer;
+    sd->len[i]       = len;
+    sd->submit_ns[i] = now_ns;
+    sd->count++;
+    sd->num_avail--;
+
+    pthread_cond_signal(&sd->work);
+}
+
+/* Return the head transfer to the available pool. stream->lock is held. */
+static void dummy_retire_transfer(struct bladerf_stream *stream)
+{
+    struct dummy_stream_data *sd = stream->backend_data;
+
+    sd->head = (sd->head + 1) % sd->num_transfers;
+    sd->count--;
+    sd->num_avail++;
+    pthread_cond_signal(&stream->can_submit_buffer);
+}
+
+static size_t dummy_submit_len(struct bladerf_stream *stream,
+                               struct bladerf_metadata *metadata)
+{
+    if ((stream->layout & BLADERF_DIRECTION_MASK) == BLADERF_TX &&
+        stream->format == BLADERF_FORMAT_PACKET_META) {
+        return metadata->actual_count;
+    }
+
+    return async_stream_buf_bytes(stream);
+}
+
+static void dummy_wait_work(struct dummy_stream_data *sd,
+                            struct bladerf_stream *stream,
+                            uint64_t until_ns)
+{
+    struct timespec abs;
+
+    abs.tv_sec  = until_ns / 1000000000ull;
+    abs.tv_nsec = until_ns % 1000000000ull;
+
+    pthread_cond_timedwait(&sd->work, &stream->lock, &abs);
+}
+
+/* Select the fault, if any, to inject into the next transfer completion.
+ * stream->lock is held. */
+static dummy_fault dummy_next_fault(struct dummy_device *d,
+                                    struct dummy_stream_data *sd)
+{
+    const uint64_t n = sd->completed + 1;
+    unsigned int i;
+
+    for (i = 0; i < DUMMY_NUM_FAULTS; i++) {
+        if (d->fault_period[i] != 0 && (n % d->fault_period[i]) == 0) {
+            return (dummy_fault)i;
+        }
+    }
+
+    return DUMMY_FAULT_NONE;
+}
+
+/* Length of a short transfer in place of one of len bytes: half of its
+ * messages, or of its samples */
+static size_t dummy_short_len(struct bladerf_stream *stream, size_t len)
+{
+    if (stream->format == BLADERF_FORMAT_SC16_Q11_META) {
+        return (len / USB_MSG_SIZE_SS / 2) * USB_MSG_SIZE_SS;
+    }
+
+    return (len / 2) & ~(size_t)3;
+}
+
+/* Hand a retired transfer, of which `actual` bytes were transferred, to the
+ * stream callback, and submit the buffer it returns. stream->lock is held. */
+static void dummy_complete_transfer(struct bladerf_stream *stream,
+                                    bool is_tx,
+                                    uint8_t *buf,
+                                    size_t len,
+                                    size_t actual,
+                                    struct bladerf_metadata *metadata)
+{
+    const size_t num_samples = bytes_to_samples(stream->format, actual);
+    uint64_t cb_start;
+    void *next_buffer;
+
+    async_stats_transfer(stream, len, actual);
+
+    if (!is_tx) {
+        async_rx_metadata(stream, buf, num_samples, metadata);
+    }
+
+    cb_start    = wallclock_get_current_nsec();
+    next_buffer = stream->cb(stream->dev, stream, metadata, buf, num_samples,
+                             stream->user_data);
+    async_stats_callback(stream, cb_start);
+
+    if (next_buffer == BLADERF_STREAM_SHUTDOWN) {
+        stream->state = STREAM_SHUTTING_DOWN;
+    } else if (next_buffer != BLADERF_STREAM_NO_DATA) {
+        dummy_submit_transfer(stream, next_buffer,
+                              dummy_submit_len(stream, metadata));
+    }
+}
+
 static int dummy_stream(struct bladerf_stream *stream,
                         bladerf_channel_layout layout)
 {
+    size_t i;
+    void *buffer;
+    struct bladerf_metadata metadata;
+    struct bladerf *dev          = stream->dev;
+    struct dummy_device *d       = dummy_backend(dev);
+    struct dummy_stream_data *sd = stream->backend_data;
+    const bool is_tx = (layout & BLADERF_DIRECTION_MASK) == BLADERF_TX;
+    uint64_t rate;
+
+    /* Currently unused, so zero it out for a sanity check when debugging */
+    memset(&metadata, 0, sizeof(metadata));
+
+    if (d->rate_override >= 0) {
+        rate = (uint64_t)d->rate_override;
+    } else {
+        bladerf_sample_rate board_rate = 0;
+        const bladerf_channel ch =
+            is_tx ? BLADERF_CHANNEL_TX(0) : BLADERF_CHANNEL_RX(0);
+
+        if (dev->board->get_sample_rate(dev, ch, &board_rate) != 0 ||
+            board_rate == 0) {
+            board_rate = DUMMY_DEFAULT_RATE;
+        }
+
+        rate = board_rate;
+    }
+
+    /* Re-anchor the device clock at the stream's sample rate */
+    MUTEX_LOCK(&d->lock);
+    if (rate != 0) {
+        const uint64_t now_ns = wallclock_get_current_nsec();
+        d->clock_anchor_ts    = dummy_clock_now(d, now_ns);
+        d->clock_anchor_ns    = now_ns;
+        d->clock_rate         = rate;
+    }
+    sd->ts = dummy_clock_now(d, wallclock_get_current_nsec());
+    MUTEX_UNLOCK(&d->lock);
+
+    MUTEX_LOCK(&stream->lock);
+
+    sd->paced = (rate != 0);
+
+    /* Set up initial set of buffers */
+    for (i = 0; i < sd->num_transfers; i++) {
+        if (is_tx) {
+            buffer = stream->cb(dev,
+                                stream,
+                                &metadata,
+                                NULL,
+                                stream->samples_per_buffer,
+                                stream->user_data);
+
+            if (buffer == BLADERF_STREAM_SHUTDOWN) {
+                if (sd->count != 0) {
+                    stream->state = STREAM_SHUTTING_DOWN;
+                } else {
+                    stream->state = STREAM_DONE;
+                }
+                break;
+            }
+        } else {
+            buffer = stream->buffers[i];
+        }
+
+        if (buffer != BLADERF_STREAM_NO_DATA) {
+            dummy_submit_transfer(stream, buffer,
+                                  dummy_submit_len(stream, &metadata));
+        }
+    }
+
+    while (stream->state != STREAM_DONE) {
+        uint8_t *bufs[2];
+        size_t lens[2];
+        uint64_t submit_ns, end_ts, due_ns;
+        dummy_fault fault;
+        size_t n;
+
+        if (stream->state == STREAM_SHUTTING_DOWN) {
+            /* "Cancel" everything in flight */
+            while (sd->count != 0) {
+                dummy_retire_transfer(stream);
+            }
+
+            stream->state = STREAM_DONE;
+            break;
+        }
+
+        if (sd->count == 0) {
+            dummy_wait_work(sd, stream,
+                            wallclock_get_current_nsec() + DUMMY_IDLE_WAIT_NS);
+            continue;
+        }
+
+        /* A reordered completion is that of the two transfers at the head,
+         * in reverse order. Their data is still produced in order. */
+        fault = dummy_next_fault(d, sd);
+        if (fault == DUMMY_FAULT_REORDER && sd->count < 2) {
+            fault = DUMMY_FAULT_NONE;
+        }
+
+        n = (fault == DUMMY_FAULT_REORDER) ? 2 : 1;
+        for (i = 0; i < n; i++) {
+            const size_t t = (sd->head + i) % sd->num_transfers;
+            bufs[i] = sd->buf[t];
+            lens[i] = sd->len[t];
+        }
+
+        submit_ns = sd->submit_ns[sd->head];
+        end_ts    = sd->ts;
+
+        /* The transfers belong to us until they are retired, so their
+         * contents may be produced or consumed without holding the lock. */
+        MUTEX_UNLOCK(&stream->lock);
+
+        for (i = 0; i < n; i++) {
+            if (is_tx) {
+                end_ts = dummy_drain_tx(stream, bufs[i], lens[i], end_ts);
+            } else {
+                end_ts = dummy_fill_rx(stream, d->rx_pattern, bufs[i],
+                                       lens[i], end_ts);
+            }
+        }
+
+        MUTEX_LOCK(&d->lock);
+        due_ns = sd->paced ? dummy_clock_to_ns(d, end_ts) : 0;
+        MUTEX_UNLOCK(&d->lock);
+
+        MUTEX_LOCK(&stream->lock);
+
+        switch (fault) {
+            case DUMMY_FAULT_STALL:
+                due_ns = 0;
+                break;
+
+            case DUMMY_FAULT_TIMEOUT:
+                due_ns = submit_ns + (uint64_t)(stream->transfer_timeout != 0
+                                                    ? stream->transfer_timeout
+                                                    : 1000) * 1000000;
+                break;
+
+            case DUMMY_FAULT_DELAY:
+                if (due_ns == 0) {
+                    due_ns = wallclock_get_current_nsec();
+                }
+                due_ns += d->fault_delay_ns;
+                break;
+
+            default:
+                break;
+        }
+
+        /* Wait for the emulated wire time of these transfers to elapse */
+        while (due_ns != 0 && stream->state == STREAM_RUNNING &&
+               wallclock_get_current_nsec() < due_ns) {
+            dummy_wait_work(sd, stream, due_ns);
+        }
+
+        if (stream->state != STREAM_RUNNING) {
+            continue;
+        }
+
+        sd->completed += n;
+
+        if (fault == DUMMY_FAULT_TIMEOUT ||
+            (sd->paced && stream->transfer_timeout != 0 &&
+             due_ns > submit_ns &&
+             (due_ns - submit_ns) / 1000000 > stream->transfer_timeout)) {
+            log_error("Transfer timed out for buffer %p\n", bufs[0]);
+            stream->stats.timeouts++;
+            stream->error_code = BLADERF_ERR_TIMEOUT;
+            stream->state      = STREAM_SHUTTING_DOWN;
+            continue;
+        } else if (fault == DUMMY_FAULT_STALL) {
+            log_error("Hit stall for buffer %p\n", bufs[0]);
+            stream->error_code = BLADERF_ERR_IO;
+            stream->state      = STREAM_SHUTTING_DOWN;
+            continue;
+        }
+
+        for (i = 0; i < n; i++) {
+            dummy_retire_transfer(stream);
+        }
+        sd->ts = end_ts;
+
+        if (fault == DUMMY_FAULT_REORDER && !sd->out_of_order_event) {
+            log_warning("Transfer callback occurred out of order. "
+                        "(Warning only this time.)\n");
+            sd->out_of_order_event = true;
+        }
+
+        for (i = 0; i < n && stream->state == STREAM_RUNNING; i++) {
+            const size_t t = (fault == DUMMY_FAULT_REORDER) ? n - 1 - i : i;
+            size_t actual  = lens[t];
+
+            if (fault == DUMMY_FAULT_SHORT) {
+                actual = dummy_short_len(stream, lens[t]);
+                log_warning_ratelimited(LOG_SUBSYS_USB,
+                                        "Received short transfer\n");
+            }
+
+            dummy_complete_transfer(stream, is_tx, bufs[t], lens[t], actual,
+                                    &metadata);
+        }
+    }
+
+    MUTEX_UNLOCK(&stream->lock);
+
     return 0;
 }
 
+/* The top-level code will have aquired the stream->lock for us */
 static int dummy_submit_stream_buffer(struct bladerf_stream *stream,
                                       void *buffer,
+                                      size_t *length,
                                       unsigned int timeout_ms,
                                       bool nonblock)
 {
+    int status = 0;
+    struct dummy_stream_data *sd = stream->backend_data;
+    struct timespec timeout_abs;
+
+    if (buffer == BLADERF_STREAM_SHUTDOWN) {
+        if (sd->num_avail == sd->num_transfers) {
+            stream->state = STREAM_DONE;
+        } else {
+            stream->state = STREAM_SHUTTING_DOWN;
+        }
+
+        pthread_cond_signal(&sd->work);
+        return 0;
+    }
+
+    if (sd->num_avail == 0) {
+        if (nonblock) {
+            log_debug("Non-blocking buffer submission requested, but no "
+                      "transfers are currently available.\n");
+
+            return BLADERF_ERR_WOULD_BLOCK;
+        }
+
+        if (timeout_ms != 0) {
+            status = populate_abs_timeout(&timeout_abs, timeout_ms);
+            if (status != 0) {
+                return BLADERF_ERR_UNEXPECTED;
+            }
+
+            while (sd->num_avail == 0 && status == 0) {
+                status = pthread_cond_timedwait(&stream->can_submit_buffer,
+                                                &stream->lock, &timeout_abs);
+            }
+        } else {
+            while (sd->num_avail == 0 && status == 0) {
+                status = pthread_cond_wait(&stream->can_submit_buffer,
+                                           &stream->lock);
+            }
+        }
+    }
+
+    if (status == ETIMEDOUT) {
+        log_debug("%s: Timed out waiting for a transfer to become available.\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_TIMEOUT;
+    } else if (status != 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    dummy_submit_transfer(stream, buffer, *length);
     return 0;
 }
 
-static void dummy_deinit_stream(struct bladerf_stream *stream)
-{
-    return;
-}
-
 static int dummy_retune(struct bladerf *dev,
                         bladerf_channel ch,
                         uint64_t timestamp,
@@ -410,11 +1613,68 @@ static int dummy_retune(struct bladerf *dev,
                         uint8_t freqsel,
                         uint8_t vcocap,
                         bool low_band,
-                        bool quick_tune)
+                        uint8_t xb_gpio,
+                        bool quick_tune,
+                        uint8_t op)
+{
+    return 0;
+}
+
+
+static int dummy_retune_corr(struct bladerf *dev,
+                             bladerf_channel ch,
+                             uint8_t flags,
+                             uint8_t dc_i,
+                             uint8_t dc_q,
+                             uint16_t gain,
+                             uint16_t phase,
+                             uint8_t lna,
+                             uint8_t vga1,
+                             uint8_t vga2)
+{
+    return 0;
+}
+
+static int dummy_retune2(struct bladerf *dev,
+                         bladerf_channel ch,
+                         uint64_t timestamp,
+                         uint16_t nios_profile,
+                         uint8_t rffe_profile,
+                         uint8_t port,
+                         uint8_t spdt,
+                         uint8_t op)
+{
+    return 0;
+}
+
+static int dummy_retune2_param(struct bladerf *dev,
+                               bladerf_channel ch,
+                               uint64_t timestamp,
+                               uint8_t type,
+                               uint8_t cmd,
+                               uint32_t value)
+{
+    return 0;
+}
+
+static int dummy_retune2_pair(struct bladerf *dev,
+                              uint64_t timestamp,
+                              uint16_t rx_nios_profile,
+                              uint8_t rx_rffe_profile,
+                              uint16_t tx_nios_profile,
+                              uint8_t tx_rffe_profile,
+                              uint8_t port,
+                              uint8_t spdt)
 {
     return 0;
 }
 
+static int dummy_get_retune_stats(struct bladerf *dev,
+                                  bladerf_channel ch,
+                                  struct bladerf_retune_stats *stats)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
 
 static int dummy_load_fw_from_bootloader(bladerf_backend backend,
                                          uint8_t bus,
@@ -447,10 +1707,28 @@ static int dummy_write_trigger(struct bladerf *dev,
     return 0;
 }
 
+static int dummy_trigger_fire_at(struct bladerf *dev,
+                                 bladerf_channel ch,
+                                 bladerf_trigger_signal trigger,
+                                 uint64_t timestamp)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_trigger_fire_time(struct bladerf *dev,
+                                   bladerf_channel ch,
+                                   bladerf_trigger_signal trigger,
+                                   bool *fired,
+                                   uint64_t *timestamp)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
 const struct backend_fns backend_fns_dummy = {
     FIELD_INIT(.matches, dummy_matches),
 
     FIELD_INIT(.probe, dummy_probe),
+    FIELD_INIT(.set_device_monitor, NULL),
 
     FIELD_INIT(.get_vid_pid, dummy_get_vid_pid),
     FIELD_INIT(.get_flash_id, dummy_get_flash_id),
@@ -464,6 +1742,8 @@ const struct backend_fns backend_fns_dummy = {
 
     FIELD_INIT(.load_fpga, dummy_load_fpga),
     FIELD_INIT(.is_fpga_configured, dummy_is_fpga_configured),
+    FIELD_INIT(.get_fpga_source, dummy_get_fpga_source),
+    FIELD_INIT(.is_fpga_image_loaded, dummy_is_fpga_image_loaded),
 
     FIELD_INIT(.get_fw_version, dummy_get_fw_version),
     FIELD_INIT(.get_fpga_version, dummy_get_fpga_version),
@@ -471,6 +1751,7 @@ const struct backend_fns backend_fns_dummy = {
     FIELD_INIT(.erase_flash_blocks, dummy_erase_flash_blocks),
     FIELD_INIT(.read_flash_pages, dummy_read_flash_pages),
     FIELD_INIT(.write_flash_pages, dummy_write_flash_pages),
+    FIELD_INIT(.hash_flash_pages, dummy_hash_flash_pages),
 
     FIELD_INIT(.device_reset, dummy_device_reset),
     FIELD_INIT(.jump_to_bootloader, dummy_jump_to_bootloader),
@@ -494,7 +1775,10 @@ const struct backend_fns backend_fns_dummy = {
     FIELD_INIT(.get_iq_gain_correction, dummy_get_iq_gain_correction),
     FIELD_INIT(.get_iq_phase_correction, dummy_get_iq_phase_correction),
 
+    FIELD_INIT(.set_agc_dc_correction, dummy_set_agc_dc_correction),
+
     FIELD_INIT(.get_timestamp, dummy_get_timestamp),
+    FIELD_INIT(.get_timestamp_latch, dummy_get_timestamp_latch),
 
     FIELD_INIT(.si5338_write, dummy_si5338_write),
     FIELD_INIT(.si5338_read, dummy_si5338_read),
@@ -502,6 +1786,14 @@ const struct backend_fns backend_fns_dummy = {
     FIELD_INIT(.lms_write, dummy_lms_write),
     FIELD_INIT(.lms_read, dummy_lms_read),
 
+    FIELD_INIT(.si5338_batch, dummy_si5338_batch),
+    FIELD_INIT(.lms_batch, dummy_lms_batch),
+    FIELD_INIT(.si5338_block, dummy_si5338_block),
+    FIELD_INIT(.lms_block, dummy_lms_block),
+    FIELD_INIT(.lms_vcocap_search, dummy_lms_vcocap_search),
+    FIELD_INIT(.lms_dc_cal_loop, dummy_lms_dc_cal_loop),
+    FIELD_INIT(.lms_dc_cal_load, dummy_lms_dc_cal_load),
+
     FIELD_INIT(.ina219_write, dummy_ina219_write),
     FIELD_INIT(.ina219_read, dummy_ina219_read),
 
@@ -511,10 +1803,30 @@ const struct backend_fns backend_fns_dummy = {
     FIELD_INIT(.adi_axi_write, dummy_adi_axi_write),
     FIELD_INIT(.adi_axi_read, dummy_adi_axi_read),
 
+    FIELD_INIT(.rfic_command_write, dummy_rfic_command_write),
+    FIELD_INIT(.rfic_command_read, dummy_rfic_command_read),
+    FIELD_INIT(.rfic_command_wait, dummy_rfic_command_wait),
+
     FIELD_INIT(.rffe_control_write, dummy_rffe_control_write),
     FIELD_INIT(.rffe_control_read, dummy_rffe_control_read),
 
     FIELD_INIT(.rffe_fastlock_save, dummy_rffe_fastlock_save),
+    FIELD_INIT(.rffe_fastlock_read, dummy_rffe_fastlock_read),
+    FIELD_INIT(.rffe_fastlock_write, dummy_rffe_fastlock_write),
+    FIELD_INIT(.rx_ddc_write, dummy_rx_ddc_write),
+    FIELD_INIT(.rx_ddc_read, dummy_rx_ddc_read),
+    FIELD_INIT(.tx_duc_write, dummy_tx_duc_write),
+    FIELD_INIT(.tx_duc_read, dummy_tx_duc_read),
+    FIELD_INIT(.rx_power_write, dummy_rx_power_write),
+    FIELD_INIT(.rx_power_read, dummy_rx_power_read),
+    FIELD_INIT(.rx_burst_write, dummy_rx_burst_write),
+    FIELD_INIT(.rx_burst_read, dummy_rx_burst_read),
+    FIELD_INIT(.fifo_level_write, dummy_fifo_level_write),
+    FIELD_INIT(.fifo_level_read, dummy_fifo_level_read),
+    FIELD_INIT(.tx_loop_write, dummy_tx_loop_write),
+    FIELD_INIT(.tx_loop_read, dummy_tx_loop_read),
+    FIELD_INIT(.vctcxo_tamer_write, dummy_vctcxo_tamer_write),
+    FIELD_INIT(.vctcxo_tamer_read, dummy_vctcxo_tamer_read),
 
     FIELD_INIT(.ad56x1_vctcxo_trim_dac_write,
                dummy_ad56x1_vctcxo_trim_dac_write),
@@ -533,6 +1845,9 @@ const struct backend_fns backend_fns_dummy = {
 
     FIELD_INIT(.set_firmware_loopback, dummy_set_firmware_loopback),
     FIELD_INIT(.get_firmware_loopback, dummy_get_firmware_loopback),
+    FIELD_INIT(.set_sample_dma, dummy_set_sample_dma),
+    FIELD_INIT(.get_sample_dma, dummy_get_sample_dma),
+    FIELD_INIT(.get_fw_stats, dummy_get_fw_stats),
 
     FIELD_INIT(.enable_module, dummy_enable_module),
 
@@ -541,7 +1856,15 @@ const struct backend_fns backend_fns_dummy = {
     FIELD_INIT(.submit_stream_buffer, dummy_submit_stream_buffer),
     FIELD_INIT(.deinit_stream, dummy_deinit_stream),
 
+    FIELD_INIT(.alloc_stream_mem, NULL),
+    FIELD_INIT(.free_stream_mem, NULL),
+
     FIELD_INIT(.retune, dummy_retune),
+    FIELD_INIT(.retune_corr, dummy_retune_corr),
+    FIELD_INIT(.retune2, dummy_retune2),
+    FIELD_INIT(.retune2_param, dummy_retune2_param),
+    FIELD_INIT(.retune2_pair, dummy_retune2_pair),
+    FIELD_INIT(.get_retune_stats, dummy_get_retune_stats),
 
     FIELD_INIT(.load_fw_from_bootloader, dummy_load_fw_from_bootloader),
 
@@ -549,6 +1872,8 @@ const struct backend_fns backend_fns_dummy = {
 
     FIELD_INIT(.read_trigger, dummy_read_trigger),
     FIELD_INIT(.write_trigger, dummy_write_trigger),
+    FIELD_INIT(.trigger_fire_at, dummy_trigger_fire_at),
+    FIELD_INIT(.trigger_fire_time, dummy_trigger_fire_time),
 
     FIELD_INIT(.name, "dummy"),
 };
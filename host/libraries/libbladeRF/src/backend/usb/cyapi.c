@@ -55,6 +55,7 @@ struct transfer {
     OVERLAPPED event;           /* Transfer completion event handle */
     PUCHAR handle;              /* Handle for in-flight transfer */
     PUCHAR buffer;              /* Buffer associated with transfer */
+    size_t length;              /* Requested transfer length (bytes) */
 };
 
 struct stream_data {
@@ -512,7 +513,7 @@ static int cyapi_init_stream(void *driver, struct bladerf_stream *stream,
         data->transfers[i].event.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
         if (data->transfers[i].event.hEvent == NULL) {
             log_debug("%s: Failed to create EventObject for transfer %u\n",
-                      (unsigned int) i);
+                      __FUNCTION__, (unsigned int) i);
             goto out;
         }
     }
@@ -533,20 +534,6 @@ out:
     return status;
 }
 
-#ifdef LOGGING_ENABLED
-static inline int find_buf(void* ptr, struct bladerf_stream *stream)
-{
-    for (unsigned int i=0; i<stream->num_buffers; i++) {
-        if (stream->buffers[i] == ptr) {
-            return i;
-        }
-    }
-
-    log_debug("Unabled to find buffer %p\n:", ptr);
-    return -1;
-}
-#endif
-
 #ifndef ENABLE_LIBBLADERF_ASYNC_LOG_VERBOSE
 #undef log_verbose
 #define log_verbose(...)
@@ -576,6 +563,7 @@ static int submit_transfer(struct bladerf_stream *stream, void *buffer, size_t l
     if (xfer != NULL) {
         data->transfers[data->avail_i].handle = xfer;
         data->transfers[data->avail_i].buffer = (PUCHAR) buffer;
+        data->transfers[data->avail_i].length = len;
 
         log_verbose("Submitted buffer %p using transfer slot %u.\n",
                     buffer, (unsigned int) data->avail_i);
@@ -591,12 +579,75 @@ static int submit_transfer(struct bladerf_stream *stream, void *buffer, size_t l
     return status;
 }
 
+/* Complete the oldest in-flight transfer, which must have finished, and
+ * submit the buffer the stream callback provides in its place. Assumes the
+ * stream lock is being held. */
+static int finish_transfer(struct bladerf_stream *stream,
+                           bladerf_channel_layout layout,
+                           struct bladerf_metadata *meta,
+                           bool *done)
+{
+    struct stream_data *data = get_stream_data(stream);
+    const size_t i = data->inflight_i;
+    struct transfer *xfer = &data->transfers[i];
+    void *next_buffer = NULL;
+    long len = 0;
+    int status = 0;
+    bool success;
+
+    log_verbose("Got transfer complete in slot %u (buffer %p)\n",
+                (unsigned int) i, xfer->buffer);
+
+    success = data->ep->FinishDataXfer(xfer->buffer, (LONG &)len,
+                                       &xfer->event, xfer->handle);
+
+    if (success) {
+        const uint64_t cb_start = wallclock_get_current_nsec();
+
+        async_stats_transfer(stream, xfer->length, (size_t)len);
+
+        next_buffer = stream->cb(stream->dev, stream, meta, xfer->buffer,
+                                 bytes_to_samples(stream->format, (LONG &)len),
+                                 stream->user_data);
+
+        async_stats_callback(stream, cb_start);
+    } else {
+        *done = true;
+        status = BLADERF_ERR_IO;
+        log_debug("Failed to finish transfer %u, buf=%p.\n",
+                  (unsigned int)i, xfer->buffer);
+    }
+
+    xfer->buffer = NULL;
+    xfer->handle = NULL;
+    data->num_avail++;
+    data->inflight_i = next_idx(data, data->inflight_i);
+
+    if (*done) {
+        return status;
+    }
+
+    if (next_buffer == BLADERF_STREAM_SHUTDOWN) {
+        *done = true;
+    } else if (next_buffer != BLADERF_STREAM_NO_DATA) {
+        if ((layout & BLADERF_DIRECTION_MASK) == BLADERF_TX
+                && stream->format == BLADERF_FORMAT_PACKET_META) {
+            status = submit_transfer(stream, next_buffer, meta->actual_count);
+        } else {
+            status = submit_transfer(stream, next_buffer,
+                                     async_stream_buf_bytes(stream));
+        }
+
+        *done = (status != 0);
+    }
+
+    return status;
+}
+
 static int cyapi_stream(void *driver, struct bladerf_stream *stream,
                         bladerf_channel_layout layout)
 {
     int status;
-    int idx = 0;
-    long len;
     void *next_buffer;
     ULONG timeout_ms;
     bool success, done;
@@ -667,62 +718,33 @@ static int cyapi_stream(void *driver, struct bladerf_stream *stream,
     }
 
     while (!done) {
-        struct transfer *xfer;
-        size_t i;
+        struct transfer *xfer = &data->transfers[data->inflight_i];
 
-        i = data->inflight_i;
-        xfer = &data->transfers[i];
+        /* Bulk transfers on an endpoint complete in the order in which they
+         * were submitted, so only the oldest in-flight transfer need be
+         * waited upon */
         success = data->ep->WaitForXfer(&xfer->event, timeout_ms);
 
         if (!success) {
             status = BLADERF_ERR_TIMEOUT;
             log_debug("Steam timed out.\n");
+            MUTEX_LOCK(&stream->lock);
+            stream->stats.timeouts++;
+            MUTEX_UNLOCK(&stream->lock);
             break;
         }
 
-        len = 0;
-        next_buffer = NULL;
-
-        log_verbose("Got transfer complete in slot %u (buffer %p)\n",
-                    i, data->transfers[i].buffer);
-
+        /* Handle this and any other transfers that have completed behind it
+         * under one acquisition of the stream lock */
         MUTEX_LOCK(&stream->lock);
-        success = data->ep->FinishDataXfer(data->transfers[i].buffer, (LONG &)len,
-                                           &data->transfers[i].event,
-                                           xfer->handle);
-
-        if (success) {
-            next_buffer = stream->cb(stream->dev, stream, &meta,
-                                     data->transfers[i].buffer,
-                                     bytes_to_samples(stream->format, (LONG &)len),
-                                     stream->user_data);
 
-        } else {
-            done = true;
-            status = BLADERF_ERR_IO;
-            log_debug("Failed to finish transfer %u, buf=%p.\n",
-                      (unsigned int)i, &data->transfers[i].buffer);
-        }
-
-        data->transfers[i].buffer = NULL;
-        data->transfers[i].handle = NULL;
-        data->num_avail++;
-        pthread_cond_signal(&stream->can_submit_buffer);
-
-        if (next_buffer == BLADERF_STREAM_SHUTDOWN) {
-            done = true;
-        } else if (next_buffer != BLADERF_STREAM_NO_DATA) {
-            if ((layout & BLADERF_DIRECTION_MASK) == BLADERF_TX
-                    && stream->format == BLADERF_FORMAT_PACKET_META) {
-                status = submit_transfer(stream, next_buffer, meta.actual_count);
-            } else {
-                status = submit_transfer(stream, next_buffer, async_stream_buf_bytes(stream));
-            }
-
-            done = (status != 0);
-        }
+        do {
+            status = finish_transfer(stream, layout, &meta, &done);
+            xfer   = &data->transfers[data->inflight_i];
+        } while (!done && xfer->handle != NULL &&
+                 HasOverlappedIoCompleted(&xfer->event));
 
-        data->inflight_i = next_idx(data, data->inflight_i);
+        pthread_cond_broadcast(&stream->can_submit_buffer);
         MUTEX_UNLOCK(&stream->lock);
     }
 
@@ -829,6 +851,7 @@ int cyapi_open_bootloader(void **driver, uint8_t bus, uint8_t addr)
 extern "C" {
     static const struct usb_fns cypress_fns = {
         FIELD_INIT(.probe, cyapi_probe),
+        FIELD_INIT(.set_device_monitor, NULL),
         FIELD_INIT(.open, cyapi_open),
         FIELD_INIT(.close, cyapi_close),
         FIELD_INIT(.get_vid_pid, cyapi_get_vid_pid),
@@ -35,6 +35,9 @@
 #include "backend/backend.h"
 #include "backend/usb/usb.h"
 #include "streaming/async.h"
+#include "helpers/alloc.h"
+#include "helpers/probes.h"
+#include "helpers/thread_attrs.h"
 #include "helpers/timeout.h"
 
 #include "bladeRF.h"
@@ -42,31 +45,105 @@
 #include "host_config.h"
 
 #ifndef LIBUSB_HANDLE_EVENTS_TIMEOUT_NSEC
-#   define LIBUSB_HANDLE_EVENTS_TIMEOUT_NSEC    (15 * 1000)
+#   ifdef HAVE_LIBUSB_INTERRUPT_EVENT_HANDLER
+#       define LIBUSB_HANDLE_EVENTS_TIMEOUT_NSEC    (15 * 1000)
+#   else
+        /* Without libusb_interrupt_event_handler(), the event thread can
+         * only notice newly queued transfers once this timeout elapses */
+#       define LIBUSB_HANDLE_EVENTS_TIMEOUT_NSEC    (1 * 1000)
+#   endif
 #endif
 
+/* Maximum number of streams the event thread services concurrently, across
+ * all devices */
+#define LUSB_MAX_STREAMS 32
+
+/* Number of torn-down streams' transfer sets retained per device. This covers
+ * the common case of one RX and one TX stream being repeatedly restarted. */
+#define LUSB_STREAM_POOL_SIZE 2
+
+struct lusb_stream_data;
+
+/* A single thread handles libusb events for the streams of all devices. All
+ * stream transfers are submitted and cancelled from this thread, such that
+ * only the order "libusb event lock, then stream->lock" ever occurs. */
+struct lusb_event_thread {
+    pthread_t thread;
+    bool started;
+    bool stop;
+
+    /* Protects the fields below. Taken before any stream->lock. */
+    MUTEX lock;
+    pthread_cond_t streams_changed;
+    struct bladerf_stream *streams[LUSB_MAX_STREAMS];
+    size_t num_streams;
+
+    /* Scheduling attributes of the stream that started the thread */
+    struct bladerf_stream_thread_attrs attrs;
+};
+
+/* libusb context shared by all devices opened, and probes performed, by this
+ * process. It is created by the first user and destroyed when the last one
+ * releases it, after stopping the event thread that services it. */
+static struct {
+    pthread_mutex_t lock;   /* Protects `context` and `refcount` */
+    libusb_context *context;
+    unsigned int refcount;
+    struct lusb_event_thread events;
+} shared = {
+    FIELD_INIT(.lock, PTHREAD_MUTEX_INITIALIZER),
+};
+
 struct bladerf_lusb {
     libusb_device           *dev;
     libusb_device_handle    *handle;
-    libusb_context          *context;
+    libusb_context          *context;   /* The shared context */
 #if 1 == BLADERF_OS_WINDOWS
     HANDLE                  mutex;
 #endif // BLADERF_OS_WINDOWS
+
+    /* Transfers retained from previous streams, for reuse by subsequent
+     * streams with the same number of transfers */
+    MUTEX                   pool_lock;
+    struct lusb_stream_data *pool[LUSB_STREAM_POOL_SIZE];
 };
 
 typedef enum {
     TRANSFER_UNINITIALIZED = 0,
     TRANSFER_AVAIL,
+    TRANSFER_PENDING,       /* Filled, awaiting submission by event thread */
     TRANSFER_IN_FLIGHT,
     TRANSFER_CANCEL_PENDING
 } transfer_status;
 
+/* Per-transfer context provided to libusb as a transfer's user_data. This
+ * allows the completion callback to locate both the associated stream and the
+ * transfer's index without searching for it. */
+struct lusb_transfer_ctx {
+    struct bladerf_stream *stream;
+    size_t idx;
+};
+
 struct lusb_stream_data {
     size_t num_transfers;               /* Total # of allocated transfers */
     size_t num_avail;                   /* # of currently available transfers */
     size_t i;                           /* Index to next transfer */
     struct libusb_transfer **transfers; /* Array of transfer metadata */
     transfer_status *transfer_status;   /* Status of each transfer */
+    struct lusb_transfer_ctx *transfer_ctx; /* Context of each transfer */
+
+    /* FIFO of TRANSFER_PENDING transfer indices, in submission order */
+    size_t *pending;
+    size_t pending_head;
+    size_t num_pending;
+
+    /* Signaled when the stream reaches STREAM_DONE */
+    pthread_cond_t done;
+
+    /* Completed buffers accumulated for a batch callback */
+    void **batch;
+    size_t num_batched;
+    size_t batch_samples;   /* # of samples in each accumulated buffer */
 
    /* Warn the first time we get a transfer callback out of order.
     * This shouldn't happen normally, but we've seen it intermittently on
@@ -136,6 +213,86 @@ static int error_conv(int error)
     return ret;
 }
 
+#if 1 == BLADERF_OS_LINUX
+/* Read a string attribute (e.g., "serial") that the kernel cached from the
+ * device's descriptors at enumeration time. Returns 0 on success. */
+static int sysfs_read_string(libusb_device *dev, const char *attr,
+                             char *buf, size_t len)
+{
+    uint8_t ports[7];
+    char path[128];
+    size_t n;
+    FILE *f;
+    int num_ports, i;
+
+    num_ports = libusb_get_port_numbers(dev, ports, sizeof(ports));
+    if (num_ports <= 0) {
+        return -1;
+    }
+
+    n = snprintf(path, sizeof(path), "/sys/bus/usb/devices/%u-%u",
+                 libusb_get_bus_number(dev), ports[0]);
+
+    for (i = 1; i < num_ports && n < sizeof(path); i++) {
+        n += snprintf(path + n, sizeof(path) - n, ".%u", ports[i]);
+    }
+
+    if (n >= sizeof(path) ||
+        snprintf(path + n, sizeof(path) - n, "/%s", attr) >=
+            (int)(sizeof(path) - n)) {
+        return -1;
+    }
+
+    f = fopen(path, "r");
+    if (f == NULL) {
+        return -1;
+    }
+
+    if (fgets(buf, (int)len, f) == NULL) {
+        fclose(f);
+        return -1;
+    }
+
+    fclose(f);
+    buf[strcspn(buf, "\n")] = '\0';
+
+    return 0;
+}
+
+/* Fill in the device's strings from sysfs, without opening the device.
+ * Returns true if the serial number was available. */
+static bool get_devinfo_sysfs(libusb_device *dev, struct bladerf_devinfo *info)
+{
+    if (sysfs_read_string(dev, "serial", info->serial,
+                          BLADERF_SERIAL_LENGTH) != 0) {
+        memset(info->serial, 0, BLADERF_SERIAL_LENGTH);
+        return false;
+    }
+
+    if (sysfs_read_string(dev, "manufacturer", info->manufacturer,
+                          BLADERF_DESCRIPTION_LENGTH) != 0) {
+        memset(info->manufacturer, 0, BLADERF_DESCRIPTION_LENGTH);
+    }
+
+    if (sysfs_read_string(dev, "product", info->product,
+                          BLADERF_DESCRIPTION_LENGTH) != 0) {
+        memset(info->product, 0, BLADERF_DESCRIPTION_LENGTH);
+    }
+
+    log_debug("Bus %03d Device %03d: %s %s, serial %s (sysfs)\n",
+              info->usb_bus, info->usb_addr, info->manufacturer,
+              info->product, info->serial);
+
+    return true;
+}
+#else
+static inline bool get_devinfo_sysfs(libusb_device *dev,
+                                     struct bladerf_devinfo *info)
+{
+    return false;
+}
+#endif // BLADERF_OS_LINUX
+
 /* Returns libusb error codes */
 static int get_devinfo(libusb_device *dev, struct bladerf_devinfo *info)
 {
@@ -149,6 +306,12 @@ static int get_devinfo(libusb_device *dev, struct bladerf_devinfo *info)
     info->usb_bus  = libusb_get_bus_number(dev);
     info->usb_addr = libusb_get_device_address(dev);
 
+    /* Avoid opening the device, which may be in use by another process,
+     * when its strings are available elsewhere */
+    if (get_devinfo_sysfs(dev, info)) {
+        return 0;
+    }
+
     status = libusb_open(dev, &handle);
 
     if (status == 0) {
@@ -297,6 +460,322 @@ static bool device_is_probe_target(backend_probe_target probe_target,
     return is_probe_target;
 }
 
+#ifdef LIBUSB_HOTPLUG_MATCH_ANY
+/* Maximum number of bladeRFs tracked by the device monitor */
+#define MONITOR_MAX_DEVICES 64
+
+/* Interval at which the monitor thread checks for a stop request */
+#define MONITOR_POLL_USEC 100000
+
+struct monitor_entry {
+    libusb_device *dev;     /* Referenced device, or NULL if unused */
+    bool probed;            /* get_devinfo() has been attempted */
+    bool valid;             /* `info` was populated successfully */
+    struct bladerf_devinfo info;
+};
+
+/* Devices attached while the monitor is enabled. Entries are only added and
+ * removed by hotplug callbacks, which run on the monitor thread (or within
+ * libusb_hotplug_register_callback()). `lock` guards entries against
+ * concurrent lookups by other threads. */
+static struct {
+    pthread_mutex_t ctrl_lock; /* Serializes enabling and disabling */
+    pthread_mutex_t lock;
+    libusb_context *context;
+    libusb_hotplug_callback_handle handle;
+    pthread_t thread;
+    volatile bool running;
+    struct monitor_entry entries[MONITOR_MAX_DEVICES];
+} monitor = {
+    FIELD_INIT(.ctrl_lock, PTHREAD_MUTEX_INITIALIZER),
+    FIELD_INIT(.lock, PTHREAD_MUTEX_INITIALIZER),
+};
+
+static int LIBUSB_CALL monitor_hotplug_cb(libusb_context *context,
+                                          libusb_device *dev,
+                                          libusb_hotplug_event event,
+                                          void *user_data)
+{
+    size_t i;
+
+    pthread_mutex_lock(&monitor.lock);
+
+    if (event == LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED) {
+        if (device_is_bladerf(dev)) {
+            for (i = 0; i < MONITOR_MAX_DEVICES; i++) {
+                if (monitor.entries[i].dev == NULL) {
+                    monitor.entries[i].dev    = libusb_ref_device(dev);
+                    monitor.entries[i].probed = false;
+                    monitor.entries[i].valid  = false;
+                    break;
+                }
+            }
+
+            if (i == MONITOR_MAX_DEVICES) {
+                log_debug("Device monitor is full; not tracking bus %u "
+                          "addr %u\n", libusb_get_bus_number(dev),
+                          libusb_get_device_address(dev));
+            }
+        }
+    } else {
+        for (i = 0; i < MONITOR_MAX_DEVICES; i++) {
+            if (monitor.entries[i].dev == dev) {
+                libusb_unref_device(dev);
+                monitor.entries[i].dev   = NULL;
+                monitor.entries[i].valid = false;
+                break;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&monitor.lock);
+    return 0;
+}
+
+/* Read the information of newly attached devices. Only called from the
+ * thread that handles hotplug events, so entries can't be removed here. */
+static void monitor_probe_new(void)
+{
+    struct bladerf_devinfo info;
+    size_t i;
+    int status;
+
+    for (i = 0; i < MONITOR_MAX_DEVICES; i++) {
+        libusb_device *dev;
+
+        pthread_mutex_lock(&monitor.lock);
+        dev = monitor.entries[i].probed ? NULL : monitor.entries[i].dev;
+        pthread_mutex_unlock(&monitor.lock);
+
+        if (dev == NULL) {
+            continue;
+        }
+
+        status = get_devinfo(dev, &info);
+
+        pthread_mutex_lock(&monitor.lock);
+        monitor.entries[i].probed = true;
+        if (status == 0) {
+            monitor.entries[i].info  = info;
+            monitor.entries[i].valid = true;
+        }
+        pthread_mutex_unlock(&monitor.lock);
+    }
+}
+
+static void *monitor_thread(void *arg)
+{
+    struct timeval tv;
+    int status;
+
+    while (monitor.running) {
+        monitor_probe_new();
+
+        tv.tv_sec  = 0;
+        tv.tv_usec = MONITOR_POLL_USEC;
+
+        status = libusb_handle_events_timeout_completed(monitor.context, &tv,
+                                                         NULL);
+        if (status < 0 && status != LIBUSB_ERROR_INTERRUPTED) {
+            log_debug("Device monitor event handling failed: %s\n",
+                      libusb_error_name(status));
+        }
+    }
+
+    return NULL;
+}
+
+static void monitor_stop(void)
+{
+    size_t i;
+
+    monitor.running = false;
+    pthread_join(monitor.thread, NULL);
+
+    libusb_hotplug_deregister_callback(monitor.context, monitor.handle);
+
+    for (i = 0; i < MONITOR_MAX_DEVICES; i++) {
+        if (monitor.entries[i].dev != NULL) {
+            libusb_unref_device(monitor.entries[i].dev);
+            monitor.entries[i].dev   = NULL;
+            monitor.entries[i].valid = false;
+        }
+    }
+
+    libusb_exit(monitor.context);
+    monitor.context = NULL;
+}
+
+static int monitor_start(void)
+{
+    int status;
+
+    status = libusb_init(&monitor.context);
+    if (status != 0) {
+        log_debug("Could not initialize libusb: %s\n",
+                  libusb_error_name(status));
+        return error_conv(status);
+    }
+
+    if (!libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG)) {
+        log_debug("libusb does not support hotplug on this platform.\n");
+        libusb_exit(monitor.context);
+        monitor.context = NULL;
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    /* Existing devices are reported via LIBUSB_HOTPLUG_ENUMERATE */
+    status = libusb_hotplug_register_callback(
+        monitor.context,
+        LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED | LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT,
+        LIBUSB_HOTPLUG_ENUMERATE, LIBUSB_HOTPLUG_MATCH_ANY,
+        LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY,
+        monitor_hotplug_cb, NULL, &monitor.handle);
+
+    if (status != LIBUSB_SUCCESS) {
+        log_debug("Failed to register hotplug callback: %s\n",
+                  libusb_error_name(status));
+        libusb_exit(monitor.context);
+        monitor.context = NULL;
+        return error_conv(status);
+    }
+
+    monitor.running = true;
+
+    status = pthread_create(&monitor.thread, NULL, monitor_thread, NULL);
+    if (status != 0) {
+        monitor.running = false;
+        libusb_hotplug_deregister_callback(monitor.context, monitor.handle);
+        libusb_exit(monitor.context);
+        monitor.context = NULL;
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    return 0;
+}
+
+static int lusb_set_device_monitor(bool enable)
+{
+    int status = 0;
+
+    pthread_mutex_lock(&monitor.ctrl_lock);
+
+    if (enable && monitor.context == NULL) {
+        status = monitor_start();
+        if (status == 0) {
+            log_verbose("Started libusb device monitor.\n");
+        }
+    } else if (!enable && monitor.context != NULL) {
+        monitor_stop();
+        log_verbose("Stopped libusb device monitor.\n");
+    }
+
+    pthread_mutex_unlock(&monitor.ctrl_lock);
+    return status;
+}
+
+/* Copy the monitor's information for the device at the same bus and
+ * address as `dev`, if available */
+static bool monitor_lookup(libusb_device *dev, struct bladerf_devinfo *info)
+{
+    const uint8_t bus  = libusb_get_bus_number(dev);
+    const uint8_t addr = libusb_get_device_address(dev);
+    bool found = false;
+    size_t i;
+
+    pthread_mutex_lock(&monitor.lock);
+
+    for (i = 0; i < MONITOR_MAX_DEVICES && !found; i++) {
+        if (monitor.entries[i].valid && monitor.entries[i].info.usb_bus == bus &&
+            monitor.entries[i].info.usb_addr == addr) {
+            *info = monitor.entries[i].info;
+            found = true;
+        }
+    }
+
+    pthread_mutex_unlock(&monitor.lock);
+
+    return found;
+}
+#else
+static int lusb_set_device_monitor(bool enable)
+{
+    if (enable) {
+        log_debug("This libusb version does not support hotplug.\n");
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return 0;
+}
+
+static inline bool monitor_lookup(libusb_device *dev,
+                                  struct bladerf_devinfo *info)
+{
+    return false;
+}
+#endif // LIBUSB_HOTPLUG_MATCH_ANY
+
+static void event_thread_stop(void);
+
+/* Acquire a reference to the shared libusb context, creating it if needed.
+ * Returns libusb error codes. */
+static int shared_context_get(libusb_context **context)
+{
+    int status = 0;
+
+    pthread_mutex_lock(&shared.lock);
+
+    if (shared.refcount == 0) {
+        status = libusb_init(&shared.context);
+        if (status != 0) {
+            log_error("Could not initialize libusb: %s\n",
+                      libusb_error_name(status));
+            shared.context = NULL;
+            goto out;
+        }
+
+        MUTEX_INIT(&shared.events.lock);
+        pthread_cond_init(&shared.events.streams_changed, NULL);
+    }
+
+    shared.refcount++;
+    *context = shared.context;
+
+out:
+    pthread_mutex_unlock(&shared.lock);
+    return status;
+}
+
+/* Release a reference to the shared libusb context */
+static void shared_context_put(void)
+{
+    pthread_mutex_lock(&shared.lock);
+
+    assert(shared.refcount > 0);
+
+    if (--shared.refcount == 0) {
+        /* No streams remain, as each holds a device open */
+        event_thread_stop();
+        pthread_cond_destroy(&shared.events.streams_changed);
+        MUTEX_DESTROY(&shared.events.lock);
+
+        libusb_exit(shared.context);
+        shared.context = NULL;
+    }
+
+    pthread_mutex_unlock(&shared.lock);
+}
+
+/* Returns libusb error codes */
+static int lookup_devinfo(libusb_device *dev, struct bladerf_devinfo *info)
+{
+    if (monitor_lookup(dev, info)) {
+        return 0;
+    }
+
+    return get_devinfo(dev, info);
+}
+
 static int lusb_probe(backend_probe_target probe_target,
                       struct bladerf_devinfo_list *info_list)
 {
@@ -308,11 +787,8 @@ static int lusb_probe(backend_probe_target probe_target,
 
     libusb_context *context;
 
-    /* Initialize libusb for device tree walking */
-    status = libusb_init(&context);
+    status = shared_context_get(&context);
     if (status) {
-        log_error("Could not initialize libusb: %s\n",
-                  libusb_error_name(status));
         goto lusb_probe_done;
     }
 
@@ -323,7 +799,7 @@ static int lusb_probe(backend_probe_target probe_target,
             bool do_add = true;
 
             /* Open the USB device and get some information */
-            status = get_devinfo(list[i], &info);
+            status = lookup_devinfo(list[i], &info);
             if (status) {
                 /* We may not be able to open the device if another driver
                  * (e.g., CyUSB3) is associated with it. Therefore, just log to
@@ -368,7 +844,7 @@ static int lusb_probe(backend_probe_target probe_target,
     }
 
     libusb_free_device_list(list, 1);
-    libusb_exit(context);
+    shared_context_put();
 
 lusb_probe_done:
     return status;
@@ -483,6 +959,7 @@ out:
 
         free(dev);
     } else {
+        MUTEX_INIT(&dev->pool_lock);
         *dev_out = dev;
     }
 
@@ -519,7 +996,7 @@ static int find_and_open_device(libusb_context *context,
             log_verbose("Found a bladeRF (idx=%d)\n", i);
 
             /* Open the USB device and get some information */
-            status = get_devinfo(list[i], &curr_info);
+            status = lookup_devinfo(list[i], &curr_info);
             if (status < 0) {
 
                 /* Give the user a helpful hint in case the have forgotten
@@ -542,6 +1019,13 @@ static int find_and_open_device(libusb_context *context,
             /* Check to see if this matches the info struct */
             if (bladerf_devinfo_matches(&curr_info, info_in)) {
                 status = open_device(&curr_info, context, list[i], dev_out);
+                if (status == BLADERF_ERR_PERMISSION &&
+                    !printed_access_warning) {
+                    printed_access_warning = true;
+                    log_warning("Found a bladeRF via VID/PID, but could not "
+                                "open it due to insufficient permissions.\n");
+                }
+
                 if (status < 0) {
                     status = BLADERF_ERR_NODEV;
                     continue; /* Continue trying the next matching device */
@@ -625,11 +1109,8 @@ static int lusb_open(void **driver,
     struct bladerf_lusb *lusb = NULL;
     libusb_context *context;
 
-    /* Initialize libusb for device tree walking */
-    status = libusb_init(&context);
+    status = shared_context_get(&context);
     if (status) {
-        log_error("Could not initialize libusb: %s\n",
-                  libusb_error_name(status));
         return error_conv(status);
     }
 
@@ -645,7 +1126,7 @@ static int lusb_open(void **driver,
 
     status = find_and_open_device(context, info_in, &lusb, info_out);
     if (status != 0) {
-        libusb_exit(context);
+        shared_context_put();
 
         if (status == BLADERF_ERR_NODEV) {
             log_debug("No devices available on the libusb backend.\n");
@@ -684,11 +1165,19 @@ static int lusb_change_setting(void *driver, uint8_t setting)
     return error_conv(status);
 }
 
+static void free_stream_data(struct lusb_stream_data *stream_data);
+
 static void lusb_close(void *driver)
 {
     int status;
+    size_t i;
     struct bladerf_lusb *lusb = (struct bladerf_lusb *) driver;
 
+    for (i = 0; i < LUSB_STREAM_POOL_SIZE; i++) {
+        free_stream_data(lusb->pool[i]);
+        lusb->pool[i] = NULL;
+    }
+
     status = libusb_release_interface(lusb->handle, 0);
     if (status < 0) {
         log_error("Failed to release interface: %s\n",
@@ -696,7 +1185,7 @@ static void lusb_close(void *driver)
     }
 
     libusb_close(lusb->handle);
-    libusb_exit(lusb->context);
+    shared_context_put();
 #if 1 == BLADERF_OS_WINDOWS
     ReleaseMutex(lusb->mutex);
     CloseHandle(lusb->mutex);
@@ -721,7 +1210,7 @@ static void lusb_close_bootloader(void *driver)
         }
 
         if (lusb->context != NULL) {
-            libusb_exit(lusb->context);
+            shared_context_put();
         }
 
 #if 1 == BLADERF_OS_WINDOWS
@@ -759,10 +1248,9 @@ static int lusb_open_bootloader(void **driver, uint8_t bus, uint8_t addr)
         return BLADERF_ERR_MEM;
     }
 
-    status = libusb_init(&lusb->context);
+    status = shared_context_get(&lusb->context);
     if (status != 0) {
-        log_debug("Failed to initialize libusb context: %s\n",
-                  libusb_error_name(status));
+        lusb->context = NULL;
         goto error;
     }
 
@@ -1019,32 +1507,120 @@ static inline void cancel_all_transfers(struct bladerf_stream *stream)
 static inline size_t transfer_idx(struct lusb_stream_data *stream_data,
                                   struct libusb_transfer *transfer)
 {
-    size_t i;
-    for (i = 0; i < stream_data->num_transfers; i++) {
-        if (stream_data->transfers[i] == transfer) {
-            return i;
-        }
+    const struct lusb_transfer_ctx *ctx = transfer->user_data;
+
+    if (ctx->idx < stream_data->num_transfers &&
+        stream_data->transfers[ctx->idx] == transfer) {
+        return ctx->idx;
     }
 
     return UINT_MAX;
 }
 
-static int submit_transfer(struct bladerf_stream *stream, void *buffer, size_t len);
+static void queue_transfer(struct bladerf_stream *stream,
+                           void *buffer, size_t len);
+static void flush_pending(struct bladerf_stream *stream);
+
+/* Provide the accumulated completions to the stream's batch callback, and
+ * queue the buffers it returns. Called with stream->lock held. */
+static void dispatch_batch(struct bladerf_stream *stream)
+{
+    struct lusb_stream_data *stream_data = stream->backend_data;
+    const size_t n = stream_data->num_batched;
+    struct bladerf_metadata metadata;
+    uint64_t cb_start;
+    size_t i;
+
+    stream_data->num_batched = 0;
+
+    /* Completions accumulated prior to a shutdown are discarded, as are the
+     * buffers of any transfers cancelled during it */
+    if (n == 0 || stream->state != STREAM_RUNNING) {
+        return;
+    }
+
+    /* The metadata describes the first buffer. The others are still parsed,
+     * so that the next batch's gap is measured from the end of this one. */
+    async_rx_metadata(stream, stream_data->batch[0],
+                      stream_data->batch_samples, &metadata);
+
+    for (i = 1; i < n; i++) {
+        struct bladerf_metadata unused;
+        async_rx_metadata(stream, stream_data->batch[i],
+                          stream_data->batch_samples, &unused);
+    }
+
+    cb_start = wallclock_get_current_nsec();
+
+    stream->batch_cb(stream->dev, stream, &metadata, stream_data->batch, n,
+                     stream_data->batch_samples, stream->user_data);
+
+    async_stats_callback(stream, cb_start);
+
+    for (i = 0; i < n; i++) {
+        void *next_buffer = stream_data->batch[i];
+
+        if (next_buffer == BLADERF_STREAM_SHUTDOWN) {
+            stream->state = STREAM_SHUTTING_DOWN;
+            break;
+        } else if (next_buffer != BLADERF_STREAM_NO_DATA) {
+            queue_transfer(stream, next_buffer, async_stream_buf_bytes(stream));
+        }
+    }
+}
+
+/* Accumulate a completed transfer's buffer for the batch callback, which is
+ * invoked once a full batch is available. Called with stream->lock held. */
+static void batch_transfer(struct bladerf_stream *stream,
+                           struct libusb_transfer *transfer)
+{
+    struct lusb_stream_data *stream_data = stream->backend_data;
+    const size_t num_samples =
+        bytes_to_samples(stream->format, transfer->actual_length);
+    size_t limit = stream->batch_size;
+
+    if (limit > stream_data->num_transfers) {
+        limit = stream_data->num_transfers;
+    }
+
+    if (transfer->length != transfer->actual_length) {
+        log_warning_ratelimited(LOG_SUBSYS_USB,
+                                "Received short transfer\n");
+    }
+
+    /* All buffers in a batch are of the same length */
+    if (stream_data->num_batched != 0 &&
+        stream_data->batch_samples != num_samples) {
+        dispatch_batch(stream);
+    }
+
+    stream_data->batch[stream_data->num_batched++] = transfer->buffer;
+    stream_data->batch_samples = num_samples;
+
+    if (stream_data->num_batched >= limit) {
+        dispatch_batch(stream);
+    }
+}
 
 static void LIBUSB_CALL lusb_stream_cb(struct libusb_transfer *transfer)
 {
-    struct bladerf_stream *stream = transfer->user_data;
+    struct lusb_transfer_ctx *ctx = transfer->user_data;
+    struct bladerf_stream *stream = ctx->stream;
     void *next_buffer             = NULL;
     struct bladerf_metadata metadata;
     struct lusb_stream_data *stream_data = stream->backend_data;
     size_t transfer_i;
 
-    /* Currently unused - zero out for out own debugging sanity... */
+    /* Populated for RX callbacks below. For TX packet meta, the callback
+     * provides the length of the buffer to send. */
     memset(&metadata, 0, sizeof(metadata));
 
     MUTEX_LOCK(&stream->lock);
 
     transfer_i = transfer_idx(stream_data, transfer);
+    PROBE4(transfer_done, stream->layout & BLADERF_DIRECTION_MASK, transfer_i,
+           transfer->status, transfer->actual_length);
+
     assert(stream_data->transfer_status[transfer_i] == TRANSFER_IN_FLIGHT ||
            stream_data->transfer_status[transfer_i] == TRANSFER_CANCEL_PENDING);
 
@@ -1057,6 +1633,13 @@ static void LIBUSB_CALL lusb_stream_cb(struct libusb_transfer *transfer)
         pthread_cond_signal(&stream->can_submit_buffer);
     }
 
+    if (transfer->status == LIBUSB_TRANSFER_COMPLETED) {
+        async_stats_transfer(stream, transfer->length,
+                             transfer->actual_length);
+    } else if (transfer->status == LIBUSB_TRANSFER_TIMED_OUT) {
+        stream->stats.timeouts++;
+    }
+
     /* Check to see if the transfer has been cancelled or errored */
     if (transfer->status != LIBUSB_TRANSFER_COMPLETED) {
         /* Errored out for some reason .. */
@@ -1101,7 +1684,11 @@ static void LIBUSB_CALL lusb_stream_cb(struct libusb_transfer *transfer)
         }
     }
 
-    if (stream->state == STREAM_RUNNING) {
+    if (stream->state == STREAM_RUNNING && stream->batch_cb != NULL) {
+        batch_transfer(stream, transfer);
+    } else if (stream->state == STREAM_RUNNING) {
+        const uint64_t cb_start = wallclock_get_current_nsec();
+
         if (stream->format == BLADERF_FORMAT_PACKET_META) {
             /* Call user callback requesting more data to transmit */
             next_buffer = stream->cb(
@@ -1110,45 +1697,39 @@ static void LIBUSB_CALL lusb_stream_cb(struct libusb_transfer *transfer)
         } else {
             /* Sanity check for debugging purposes */
             if (transfer->length != transfer->actual_length) {
-                log_warning("Received short transfer\n");
+                log_warning_ratelimited(LOG_SUBSYS_USB,
+                                "Received short transfer\n");
             }
 
+            async_rx_metadata(stream, transfer->buffer,
+                bytes_to_samples(stream->format, transfer->actual_length),
+                &metadata);
+
             /* Call user callback requesting more data to transmit */
             next_buffer = stream->cb(
                 stream->dev, stream, &metadata, transfer->buffer,
-                bytes_to_sc16q11(transfer->actual_length), stream->user_data);
+                bytes_to_samples(stream->format, transfer->actual_length),
+                stream->user_data);
         }
 
+        async_stats_callback(stream, cb_start);
+
         if (next_buffer == BLADERF_STREAM_SHUTDOWN) {
             stream->state = STREAM_SHUTTING_DOWN;
         } else if (next_buffer != BLADERF_STREAM_NO_DATA) {
-            int status;
             if((stream->layout & BLADERF_DIRECTION_MASK) == BLADERF_TX
                   && stream->format == BLADERF_FORMAT_PACKET_META) {
-               status = submit_transfer(stream, next_buffer, metadata.actual_count);
+               queue_transfer(stream, next_buffer, metadata.actual_count);
             } else {
-               status = submit_transfer(stream, next_buffer, async_stream_buf_bytes(stream));
-            }
-            if (status != 0) {
-                /* If this fails, we probably have a serious problem...so just
-                 * shut it down. */
-                stream->state = STREAM_SHUTTING_DOWN;
+               queue_transfer(stream, next_buffer, async_stream_buf_bytes(stream));
             }
         }
     }
 
-
-    /* Check to see if all the transfers have been cancelled,
-     * and if so, clean up the stream */
-    if (stream->state == STREAM_SHUTTING_DOWN) {
-        /* We know we're done when all of our transfers have returned to their
-         * "available" states */
-        if (stream_data->num_avail == stream_data->num_transfers) {
-            stream->state = STREAM_DONE;
-        } else {
-            cancel_all_transfers(stream);
-        }
-    }
+    /* We're on the event thread, so submit the next buffer right away, along
+     * with any queued ahead of it. This also completes a shutdown once all
+     * transfers have returned. */
+    flush_pending(stream);
 
     MUTEX_UNLOCK(&stream->lock);
 }
@@ -1181,146 +1762,436 @@ get_next_available_transfer(struct lusb_stream_data *stream_data)
 }
 
 /* Precondition: A transfer is available. */
-static int submit_transfer(struct bladerf_stream *stream, void *buffer, size_t len)
+/* Fill the next available transfer and queue it for submission by the event
+ * thread. Called with stream->lock held, from any thread. */
+static void queue_transfer(struct bladerf_stream *stream,
+                           void *buffer, size_t len)
 {
-    int status;
     struct bladerf_lusb *lusb = lusb_backend(stream->dev);
     struct lusb_stream_data *stream_data = stream->backend_data;
     struct libusb_transfer *transfer;
-    const size_t bytes_per_buffer = async_stream_buf_bytes(stream);
-    size_t prev_idx;
+    size_t tail;
     const unsigned char ep =
         (stream->layout & BLADERF_DIRECTION_MASK) == BLADERF_TX ? SAMPLE_EP_OUT : SAMPLE_EP_IN;
 
     transfer = get_next_available_transfer(stream_data);
     assert(transfer != NULL);
 
-    assert(bytes_per_buffer <= INT_MAX);
+    assert(len <= INT_MAX);
     libusb_fill_bulk_transfer(transfer,
                               lusb->handle,
                               ep,
                               buffer,
                               (int)len,
                               lusb_stream_cb,
-                              stream,
+                              &stream_data->transfer_ctx[stream_data->i],
                               stream->transfer_timeout);
 
-    prev_idx = stream_data->i;
-    stream_data->transfer_status[stream_data->i] = TRANSFER_IN_FLIGHT;
+    tail = (stream_data->pending_head + stream_data->num_pending) %
+           stream_data->num_transfers;
+
+    stream_data->pending[tail] = stream_data->i;
+    stream_data->num_pending++;
+
+    stream_data->transfer_status[stream_data->i] = TRANSFER_PENDING;
     stream_data->i = (stream_data->i + 1) % stream_data->num_transfers;
     assert(stream_data->num_avail != 0);
     stream_data->num_avail--;
+}
 
-    /* FIXME We have an inherent issue here with lock ordering between
-     *       stream->lock and libusb's underlying event lock, so we
-     *       have to drop the stream->lock as a workaround.
-     *
-     *       This implies that a callback can potentially execute,
-     *       including a callback for this transfer. Therefore, the transfer
-     *       has been setup and its metadata logged.
-     *
-     *       Ultimately, we need to review our async scheme and associated
-     *       lock schemes.
-     */
-    MUTEX_UNLOCK(&stream->lock);
-    status = libusb_submit_transfer(transfer);
-    MUTEX_LOCK(&stream->lock);
+/* Once a stream is shutting down, cancel its transfers, and mark it done when
+ * all of them have returned. Called with stream->lock held, on the event
+ * thread. */
+static void update_shutdown(struct bladerf_stream *stream)
+{
+    struct lusb_stream_data *stream_data = stream->backend_data;
 
-    if (status != 0) {
-        log_error("Failed to submit transfer in %s: %s\n",
-                  __FUNCTION__, libusb_error_name(status));
+    if (stream->state != STREAM_SHUTTING_DOWN) {
+        return;
+    }
+
+    /* We know we're done when all of our transfers have returned to their
+     * "available" states */
+    if (stream_data->num_avail == stream_data->num_transfers) {
+        stream->state = STREAM_DONE;
+        pthread_cond_broadcast(&stream_data->done);
+    } else {
+        cancel_all_transfers(stream);
+    }
+}
+
+/* Submit the stream's queued transfers, in order. Called with stream->lock
+ * held, on the event thread.
+ *
+ * Only the event thread submits and cancels transfers, and it does so
+ * without holding any of libusb's locks. Therefore, stream->lock need not be
+ * dropped around libusb_submit_transfer(). */
+static void flush_pending(struct bladerf_stream *stream)
+{
+    struct lusb_stream_data *stream_data = stream->backend_data;
+    int status;
+
+    while (stream_data->num_pending != 0) {
+        const size_t idx = stream_data->pending[stream_data->pending_head];
+
+        stream_data->pending_head =
+            (stream_data->pending_head + 1) % stream_data->num_transfers;
+        stream_data->num_pending--;
+
+        assert(stream_data->transfer_status[idx] == TRANSFER_PENDING);
+
+        if (stream->state == STREAM_RUNNING) {
+            stream_data->transfer_status[idx] = TRANSFER_IN_FLIGHT;
+
+            PROBE3(transfer_submit, stream->layout & BLADERF_DIRECTION_MASK,
+                   idx, stream_data->transfers[idx]->length);
 
-        /* We need to undo the metadata we updated prior to dropping
-         * the lock and attempting to submit the transfer */
-        assert(stream_data->transfer_status[prev_idx] == TRANSFER_IN_FLIGHT);
-        stream_data->transfer_status[prev_idx] = TRANSFER_AVAIL;
+            status = libusb_submit_transfer(stream_data->transfers[idx]);
+            if (status == 0) {
+                continue;
+            }
+
+            log_error("Failed to submit transfer in %s: %s\n",
+                      __FUNCTION__, libusb_error_name(status));
+
+            /* If this fails, we probably have a serious problem...so just
+             * shut it down. */
+            stream->error_code = error_conv(status);
+            stream->state = STREAM_SHUTTING_DOWN;
+        }
+
+        /* Return transfers that will not be submitted */
+        stream_data->transfer_status[idx] = TRANSFER_AVAIL;
         stream_data->num_avail++;
-        if (stream_data->i == 0) {
-            stream_data->i = stream_data->num_transfers - 1;
-        } else {
-            stream_data->i--;
+        pthread_cond_signal(&stream->can_submit_buffer);
+    }
+
+    update_shutdown(stream);
+}
+
+/* Wake the event thread so it notices newly queued transfers or a shutdown
+ * request. Without libusb_interrupt_event_handler(), the event thread
+ * instead notices these within LIBUSB_HANDLE_EVENTS_TIMEOUT_NSEC. */
+static void event_thread_wake(struct bladerf_lusb *lusb)
+{
+#ifdef HAVE_LIBUSB_INTERRUPT_EVENT_HANDLER
+    libusb_interrupt_event_handler(lusb->context);
+#endif
+}
+
+static void *lusb_event_thread(void *arg)
+{
+    libusb_context *context = (libusb_context *) arg;
+    struct lusb_event_thread *ev = &shared.events;
+    struct thread_attrs_saved saved_attrs;
+    struct timeval tv = { 0, LIBUSB_HANDLE_EVENTS_TIMEOUT_NSEC };
+    size_t i;
+    int status;
+
+    /* Stream callbacks execute on this thread */
+    thread_attrs_apply(&ev->attrs, &saved_attrs);
+
+    MUTEX_LOCK(&ev->lock);
+
+    while (!ev->stop) {
+        if (ev->num_streams == 0) {
+            pthread_cond_wait(&ev->streams_changed, &ev->lock);
+            continue;
+        }
+
+        /* The previous pass handled all pending completions, so deliver
+         * any partial batches now rather than waiting for them to fill */
+        for (i = 0; i < ev->num_streams; i++) {
+            struct bladerf_stream *stream = ev->streams[i];
+            struct lusb_stream_data *stream_data = stream->backend_data;
+
+            MUTEX_LOCK(&stream->lock);
+            if (stream_data->num_batched != 0) {
+                dispatch_batch(stream);
+            }
+            flush_pending(stream);
+            MUTEX_UNLOCK(&stream->lock);
+        }
+
+        /* Streams may only detach while we're not touching them */
+        MUTEX_UNLOCK(&ev->lock);
+
+        status = libusb_handle_events_timeout(context, &tv);
+        if (status < 0 && status != LIBUSB_ERROR_INTERRUPTED) {
+            log_warning("unexpected value from events processing: "
+                        "%d: %s\n", status, libusb_error_name(status));
         }
+
+        MUTEX_LOCK(&ev->lock);
     }
 
-    return error_conv(status);
+    MUTEX_UNLOCK(&ev->lock);
+
+    thread_attrs_restore(&saved_attrs);
+    return NULL;
 }
 
-static int lusb_init_stream(void *driver, struct bladerf_stream *stream,
-                            size_t num_transfers)
+/* Register a stream with the event thread, starting the thread if it is not
+ * running. The thread adopts the scheduling attributes of the stream that
+ * starts it, and runs until the shared context is released. */
+static int event_thread_attach(struct bladerf_lusb *lusb,
+                               struct bladerf_stream *stream)
 {
+    struct lusb_event_thread *ev = &shared.events;
+    const bladerf_direction dir = stream->layout & BLADERF_DIRECTION_MASK;
     int status = 0;
+
+    MUTEX_LOCK(&ev->lock);
+
+    if (ev->num_streams >= LUSB_MAX_STREAMS) {
+        log_error("Cannot service more than %u concurrent streams.\n",
+                  LUSB_MAX_STREAMS);
+        status = BLADERF_ERR_UNEXPECTED;
+        goto out;
+    }
+
+    if (!ev->started) {
+        ev->attrs = stream->thread_attrs[dir];
+        ev->stop  = false;
+
+        status = pthread_create(&ev->thread, NULL, lusb_event_thread,
+                                lusb->context);
+        if (status != 0) {
+            log_error("Failed to start libusb event thread: %s\n",
+                      strerror(status));
+            status = BLADERF_ERR_UNEXPECTED;
+            goto out;
+        }
+
+        ev->started = true;
+    }
+
+    ev->streams[ev->num_streams++] = stream;
+    pthread_cond_signal(&ev->streams_changed);
+
+out:
+    MUTEX_UNLOCK(&ev->lock);
+    return status;
+}
+
+static void event_thread_detach(struct bladerf_lusb *lusb,
+                                struct bladerf_stream *stream)
+{
+    struct lusb_event_thread *ev = &shared.events;
+    size_t i;
+
+    MUTEX_LOCK(&ev->lock);
+
+    for (i = 0; i < ev->num_streams; i++) {
+        if (ev->streams[i] == stream) {
+            ev->streams[i] = ev->streams[--ev->num_streams];
+            break;
+        }
+    }
+
+    MUTEX_UNLOCK(&ev->lock);
+}
+
+/* Called with shared.lock held, once the last user of the shared context
+ * has released it */
+static void event_thread_stop(void)
+{
+    struct lusb_event_thread *ev = &shared.events;
+    bool started;
+
+    MUTEX_LOCK(&ev->lock);
+    started  = ev->started;
+    ev->stop = true;
+    pthread_cond_signal(&ev->streams_changed);
+    MUTEX_UNLOCK(&ev->lock);
+
+    if (started) {
+#ifdef HAVE_LIBUSB_INTERRUPT_EVENT_HANDLER
+        libusb_interrupt_event_handler(shared.context);
+#endif
+        pthread_join(ev->thread, NULL);
+        ev->started = false;
+    }
+}
+
+static void free_stream_data(struct lusb_stream_data *stream_data)
+{
+    size_t i;
+
+    if (stream_data == NULL) {
+        return;
+    }
+
+    if (stream_data->transfers != NULL) {
+        for (i = 0; i < stream_data->num_transfers; i++) {
+            libusb_free_transfer(stream_data->transfers[i]);
+        }
+    }
+
+    alloc_free(stream_data->transfers);
+    alloc_free(stream_data->transfer_status);
+    alloc_free(stream_data->transfer_ctx);
+    alloc_free(stream_data->pending);
+    alloc_free(stream_data->batch);
+    pthread_cond_destroy(&stream_data->done);
+    alloc_free(stream_data);
+}
+
+/* Take a retained set of transfers of the requested size from the pool,
+ * or NULL if there is none */
+static struct lusb_stream_data *pool_take(struct bladerf_lusb *lusb,
+                                          size_t num_transfers)
+{
+    struct lusb_stream_data *stream_data = NULL;
+    size_t i;
+
+    MUTEX_LOCK(&lusb->pool_lock);
+
+    for (i = 0; i < LUSB_STREAM_POOL_SIZE; i++) {
+        if (lusb->pool[i] != NULL &&
+            lusb->pool[i]->num_transfers == num_transfers) {
+            stream_data   = lusb->pool[i];
+            lusb->pool[i] = NULL;
+            break;
+        }
+    }
+
+    MUTEX_UNLOCK(&lusb->pool_lock);
+
+    return stream_data;
+}
+
+/* Retain a torn-down stream's transfers. When the pool is full, the oldest
+ * entry is released to make room. */
+static void pool_put(struct bladerf_lusb *lusb,
+                     struct lusb_stream_data *stream_data)
+{
+    struct lusb_stream_data *evicted = NULL;
+    size_t i;
+
+    MUTEX_LOCK(&lusb->pool_lock);
+
+    for (i = 0; i < LUSB_STREAM_POOL_SIZE; i++) {
+        if (lusb->pool[i] == NULL) {
+            break;
+        }
+    }
+
+    if (i == LUSB_STREAM_POOL_SIZE) {
+        evicted = lusb->pool[0];
+        memmove(&lusb->pool[0], &lusb->pool[1],
+                (LUSB_STREAM_POOL_SIZE - 1) * sizeof(lusb->pool[0]));
+        i = LUSB_STREAM_POOL_SIZE - 1;
+    }
+
+    lusb->pool[i] = stream_data;
+
+    MUTEX_UNLOCK(&lusb->pool_lock);
+
+    free_stream_data(evicted);
+}
+
+static void reset_stream_data(struct lusb_stream_data *stream_data,
+                              struct bladerf_stream *stream)
+{
     size_t i;
+
+    for (i = 0; i < stream_data->num_transfers; i++) {
+        stream_data->transfer_status[i]     = TRANSFER_AVAIL;
+        stream_data->transfer_ctx[i].stream = stream;
+        stream_data->transfer_ctx[i].idx    = i;
+    }
+
+    stream_data->num_avail          = stream_data->num_transfers;
+    stream_data->i                  = 0;
+    stream_data->pending_head       = 0;
+    stream_data->num_pending        = 0;
+    stream_data->num_batched        = 0;
+    stream_data->out_of_order_event = false;
+}
+
+static int lusb_init_stream(void *driver, struct bladerf_stream *stream,
+                            size_t num_transfers)
+{
+    struct bladerf_lusb *lusb = (struct bladerf_lusb *) driver;
     struct lusb_stream_data *stream_data;
+    size_t i;
 
-    /* Fill in backend stream information */
-    stream_data = malloc(sizeof(struct lusb_stream_data));
+    /* Reuse a previous stream's transfers, if they fit. They are filled in
+     * upon each submission, so only their bookkeeping needs resetting. */
+    stream_data = pool_take(lusb, num_transfers);
+    if (stream_data != NULL) {
+        log_verbose("Reusing %u retained libusb transfers.\n",
+                    (unsigned int)num_transfers);
+        reset_stream_data(stream_data, stream);
+        stream->backend_data = stream_data;
+        return 0;
+    }
+
+    stream_data = alloc_calloc(1, sizeof(struct lusb_stream_data));
     if (!stream_data) {
         return BLADERF_ERR_MEM;
     }
 
-    /* Backend stream information */
-    stream->backend_data = stream_data;
-    stream_data->transfers = NULL;
-    stream_data->transfer_status = NULL;
     stream_data->num_transfers = num_transfers;
-    stream_data->num_avail = 0;
-    stream_data->i = 0;
-    stream_data->out_of_order_event = false;
+    pthread_cond_init(&stream_data->done, NULL);
 
     stream_data->transfers =
-        malloc(num_transfers * sizeof(struct libusb_transfer *));
+        alloc_calloc(num_transfers, sizeof(struct libusb_transfer *));
 
     if (stream_data->transfers == NULL) {
         log_error("Failed to allocate libusb tranfers\n");
-        status = BLADERF_ERR_MEM;
         goto error;
     }
 
     stream_data->transfer_status =
-        calloc(num_transfers, sizeof(transfer_status));
+        alloc_calloc(num_transfers, sizeof(transfer_status));
 
     if (stream_data->transfer_status == NULL) {
         log_error("Failed to allocated libusb transfer status array\n");
-        status = BLADERF_ERR_MEM;
         goto error;
     }
 
-    /* Create the libusb transfers */
-    for (i = 0; i < stream_data->num_transfers; i++) {
-        stream_data->transfers[i] = libusb_alloc_transfer(0);
+    stream_data->transfer_ctx =
+        alloc_calloc(num_transfers, sizeof(struct lusb_transfer_ctx));
 
-        /* Upon error, start tearing down anything we've started allocating
-         * and report that the stream is in a bad state */
-        if (stream_data->transfers[i] == NULL) {
+    if (stream_data->transfer_ctx == NULL) {
+        log_error("Failed to allocate libusb transfer context array\n");
+        goto error;
+    }
 
-            /* Note: <= 0 not appropriate as we're dealing
-             *       with an unsigned index */
-            while (i > 0) {
-                if (--i) {
-                    libusb_free_transfer(stream_data->transfers[i]);
-                    stream_data->transfers[i] = NULL;
-                    stream_data->transfer_status[i] = TRANSFER_UNINITIALIZED;
-                    stream_data->num_avail--;
-                }
-            }
+    stream_data->pending = alloc_calloc(num_transfers, sizeof(size_t));
 
-            status = BLADERF_ERR_MEM;
-            break;
-        } else {
-            stream_data->transfer_status[i] = TRANSFER_AVAIL;
-            stream_data->num_avail++;
-        }
+    if (stream_data->pending == NULL) {
+        log_error("Failed to allocate libusb pending transfer queue\n");
+        goto error;
     }
 
-error:
-    if (status != 0) {
-        free(stream_data->transfer_status);
-        free(stream_data->transfers);
-        free(stream_data);
-        stream->backend_data = NULL;
+    stream_data->batch = alloc_calloc(num_transfers, sizeof(void *));
+
+    if (stream_data->batch == NULL) {
+        log_error("Failed to allocate libusb batch array\n");
+        goto error;
     }
 
-    return status;
+    /* Create the libusb transfers */
+    for (i = 0; i < num_transfers; i++) {
+        stream_data->transfers[i] = libusb_alloc_transfer(0);
+        if (stream_data->transfers[i] == NULL) {
+            goto error;
+        }
+    }
+
+    reset_stream_data(stream_data, stream);
+    stream->backend_data = stream_data;
+    return 0;
+
+error:
+    /* libusb_free_transfer() accepts NULL, so a partially-populated set of
+     * transfers may be freed in its entirety */
+    free_stream_data(stream_data);
+    stream->backend_data = NULL;
+    return BLADERF_ERR_MEM;
 }
 
 static int lusb_stream(void *driver, struct bladerf_stream *stream,
@@ -1333,7 +2204,6 @@ static int lusb_stream(void *driver, struct bladerf_stream *stream,
     struct bladerf *dev = stream->dev;
     struct bladerf_lusb *lusb = (struct bladerf_lusb *) driver;
     struct lusb_stream_data *stream_data = stream->backend_data;
-    struct timeval tv = { 0, LIBUSB_HANDLE_EVENTS_TIMEOUT_NSEC };
 
     /* Currently unused, so zero it out for a sanity check when debugging */
     memset(&metadata, 0, sizeof(metadata));
@@ -1351,7 +2221,7 @@ static int lusb_stream(void *driver, struct bladerf_stream *stream,
                                 stream->user_data);
 
             if (buffer == BLADERF_STREAM_SHUTDOWN) {
-                /* If we have transfers in flight and the user prematurely
+                /* If we have transfers queued and the user prematurely
                  * cancels the stream, we'll start shutting down */
                 if (stream_data->num_avail != stream_data->num_transfers) {
                     stream->state = STREAM_SHUTTING_DOWN;
@@ -1372,31 +2242,44 @@ static int lusb_stream(void *driver, struct bladerf_stream *stream,
         if (buffer != BLADERF_STREAM_NO_DATA) {
             if((layout & BLADERF_DIRECTION_MASK) == BLADERF_TX
                   && stream->format == BLADERF_FORMAT_PACKET_META) {
-               status = submit_transfer(stream, buffer, metadata.actual_count);
+               queue_transfer(stream, buffer, metadata.actual_count);
             } else {
-               status = submit_transfer(stream, buffer, async_stream_buf_bytes(stream));
-            }
-
-            /* If we failed to submit any transfers, cancel everything in
-             * flight.  We'll leave the stream in the running state so we can
-             * have libusb fire off callbacks with the cancelled status*/
-            if (status < 0) {
-                stream->error_code = status;
-                cancel_all_transfers(stream);
+               queue_transfer(stream, buffer, async_stream_buf_bytes(stream));
             }
         }
     }
+
+    if (stream->state == STREAM_DONE) {
+        MUTEX_UNLOCK(&stream->lock);
+        return 0;
+    }
+
     MUTEX_UNLOCK(&stream->lock);
 
-    /* This loop is required so libusb can do callbacks and whatnot */
+    /* The event thread submits the queued transfers, and services the
+     * stream's callbacks until it is done */
+    status = event_thread_attach(lusb, stream);
+
+    MUTEX_LOCK(&stream->lock);
+
+    if (status != 0) {
+        /* Nothing has been submitted, so this only returns the queued
+         * transfers and marks the stream done */
+        stream->error_code = status;
+        stream->state      = STREAM_SHUTTING_DOWN;
+        flush_pending(stream);
+    } else {
+        event_thread_wake(lusb);
+    }
+
     while (stream->state != STREAM_DONE) {
-        status = libusb_handle_events_timeout(lusb->context, &tv);
+        pthread_cond_wait(&stream_data->done, &stream->lock);
+    }
 
-        if (status < 0 && status != LIBUSB_ERROR_INTERRUPTED) {
-            log_warning("unexpected value from events processing: "
-                        "%d: %s\n", status, libusb_error_name(status));
-            status = error_conv(status);
-        }
+    MUTEX_UNLOCK(&stream->lock);
+
+    if (status == 0) {
+        event_thread_detach(lusb, stream);
     }
 
     return status;
@@ -1408,14 +2291,18 @@ int lusb_submit_stream_buffer(void *driver, struct bladerf_stream *stream,
                               unsigned int timeout_ms, bool nonblock)
 {
     int status = 0;
+    struct bladerf_lusb *lusb = (struct bladerf_lusb *) driver;
     struct lusb_stream_data *stream_data = stream->backend_data;
     struct timespec timeout_abs;
 
     if (buffer == BLADERF_STREAM_SHUTDOWN) {
         if (stream_data->num_avail == stream_data->num_transfers) {
             stream->state = STREAM_DONE;
+            pthread_cond_broadcast(&stream_data->done);
         } else {
+            /* The event thread cancels any transfers in flight */
             stream->state = STREAM_SHUTTING_DOWN;
+            event_thread_wake(lusb);
         }
 
         return 0;
@@ -1455,31 +2342,52 @@ int lusb_submit_stream_buffer(void *driver, struct bladerf_stream *stream,
     } else if (status != 0) {
         return BLADERF_ERR_UNEXPECTED;
     } else {
-        return submit_transfer(stream, buffer, *length);
+        queue_transfer(stream, buffer, *length);
+        event_thread_wake(lusb);
+        return 0;
     }
 }
 
 static int lusb_deinit_stream(void *driver, struct bladerf_stream *stream)
 {
-    size_t i;
+    struct bladerf_lusb *lusb = (struct bladerf_lusb *) driver;
     struct lusb_stream_data *stream_data = stream->backend_data;
 
-    for (i = 0; i < stream_data->num_transfers; i++) {
-        libusb_free_transfer(stream_data->transfers[i]);
-        stream_data->transfers[i] = NULL;
-        stream_data->transfer_status[i] = TRANSFER_UNINITIALIZED;
-    }
+    /* The stream may be torn down as soon as it is done, before the thread
+     * that ran it has detached it from the event thread */
+    event_thread_detach(lusb, stream);
 
-    free(stream_data->transfers);
-    free(stream_data->transfer_status);
-    free(stream->backend_data);
+    /* The stream is complete, so none of its transfers are in flight. Retain
+     * them for the next stream, rather than freeing them. */
+    if (stream_data != NULL) {
+        pool_put(lusb, stream_data);
+    }
 
     stream->backend_data = NULL;
     return 0;
 }
 
+static void *lusb_dev_mem_alloc(void *driver, size_t len)
+{
+#ifdef HAVE_LIBUSB_DEV_MEM_ALLOC
+    struct bladerf_lusb *lusb = (struct bladerf_lusb *) driver;
+    return libusb_dev_mem_alloc(lusb->handle, len);
+#else
+    return NULL;
+#endif
+}
+
+static void lusb_dev_mem_free(void *driver, void *mem, size_t len)
+{
+#ifdef HAVE_LIBUSB_DEV_MEM_ALLOC
+    struct bladerf_lusb *lusb = (struct bladerf_lusb *) driver;
+    libusb_dev_mem_free(lusb->handle, mem, len);
+#endif
+}
+
 static const struct usb_fns libusb_fns = {
     FIELD_INIT(.probe, lusb_probe),
+    FIELD_INIT(.set_device_monitor, lusb_set_device_monitor),
     FIELD_INIT(.open, lusb_open),
     FIELD_INIT(.close, lusb_close),
     FIELD_INIT(.get_vid_pid, lusb_get_vid_pid),
@@ -1496,6 +2404,8 @@ static const struct usb_fns libusb_fns = {
     FIELD_INIT(.deinit_stream, lusb_deinit_stream),
     FIELD_INIT(.open_bootloader, lusb_open_bootloader),
     FIELD_INIT(.close_bootloader, lusb_close_bootloader),
+    FIELD_INIT(.dev_mem_alloc, lusb_dev_mem_alloc),
+    FIELD_INIT(.dev_mem_free, lusb_dev_mem_free),
 };
 
 const struct usb_driver usb_driver_libusb = {
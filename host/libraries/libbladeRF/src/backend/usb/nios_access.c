@@ -33,52 +33,122 @@
 #include "nios_pkt_formats.h"
 
 #include "board/board.h"
+#include "helpers/ctrl_trace.h"
+#include "helpers/have_cap.h"
+#include "helpers/probes.h"
 #include "helpers/version.h"
 
-#if 0
+/* Packet dumps are only compiled in when verbose NIOS access logging has been
+ * requested and LOGGING_MIN_LEVEL has not compiled out verbose messages */
+#if defined(LOGGING_ENABLED) && \
+    defined(ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE) && \
+    (LOG_MIN_LEVEL <= LOG_LEVEL_VERBOSE)
 static void print_buf(const char *msg, const uint8_t *buf, size_t len)
 {
+    char hex[3 * NIOS_PKT_LEN + 1];
     size_t i;
-    if (msg != NULL) {
-        fputs(msg, stderr);
+
+    if (log_get_verbosity() > BLADERF_LOG_LEVEL_VERBOSE) {
+        return;
     }
 
-    for (i = 0; i < len; i++) {
-        fprintf(stderr, " %02x", buf[i]);
+    for (i = 0; i < len && i < NIOS_PKT_LEN; i++) {
+        snprintf(&hex[3 * i], 4, " %02x", buf[i]);
     }
+    hex[3 * i] = '\0';
 
-    fputc('\n', stderr);
+    log_verbose("%s%s\n", msg, hex);
 }
 #else
 #define print_buf(msg, data, len) do {} while(0)
 #endif
 
-/* Buf is assumed to be NIOS_PKT_LEN bytes */
-static int nios_access(struct bladerf *dev, uint8_t *buf)
+/* Determine the target and direction of a request, for tracing. The retune
+ * packets have neither, and are reported as writes to target 0. */
+static void pkt_trace_info(const uint8_t *buf, uint8_t *target, bool *write)
+{
+    switch (buf[0]) {
+        case NIOS_PKT_8x8_MAGIC:
+        case NIOS_PKT_8x8_BLOCK_MAGIC:
+        case NIOS_PKT_8x16_MAGIC:
+        case NIOS_PKT_8x32_MAGIC:
+        case NIOS_PKT_8x64_MAGIC:
+        case NIOS_PKT_16x64_MAGIC:
+        case NIOS_PKT_32x32_MAGIC:
+            /* These formats share their target and flag layout */
+            *target = buf[NIOS_PKT_8x8_IDX_TARGET_ID];
+            *write  = (buf[NIOS_PKT_8x8_IDX_FLAGS] &
+                       NIOS_PKT_8x8_FLAG_WRITE) != 0;
+            break;
+
+        case NIOS_PKT_8x8_BATCH_MAGIC:
+            *target = buf[NIOS_PKT_8x8_BATCH_IDX_TARGET_ID];
+            *write  = buf[NIOS_PKT_8x8_BATCH_IDX_WRITE_MASK] != 0;
+            break;
+
+        default:
+            *target = 0;
+            *write  = true;
+            break;
+    }
+}
+
+/* Perform a request, without reporting errors. Buf is assumed to be
+ * NIOS_PKT_LEN bytes. */
+static int nios_transfer(struct bladerf *dev,
+                         uint8_t *buf,
+                         unsigned int timeout_ms,
+                         bool *sent)
 {
     struct bladerf_usb *usb = dev->backend_data;
+    const uint64_t trace_start = ctrl_trace_begin(dev);
+    const uint8_t magic = buf[0];
+    uint8_t target = 0;
+    bool write = false;
     int status;
 
+    if (trace_start != 0) {
+        pkt_trace_info(buf, &target, &write);
+    }
+
     print_buf("NIOS II REQ:", buf, NIOS_PKT_LEN);
+    PROBE1(nios_start, magic);
 
     /* Send the command */
     status = usb->fn->bulk_transfer(usb->driver, PERIPHERAL_EP_OUT, buf,
                                     NIOS_PKT_LEN, PERIPHERAL_TIMEOUT_MS);
-    if (status != 0) {
-        log_error("Failed to send NIOS II request: %s\n",
-                  bladerf_strerror(status));
-        return status;
-    }
+    *sent = (status == 0);
 
     /* Retrieve the request */
-    status = usb->fn->bulk_transfer(usb->driver, PERIPHERAL_EP_IN, buf,
-                                    NIOS_PKT_LEN, PERIPHERAL_TIMEOUT_MS);
-    if (status != 0) {
-        log_error("Failed to receive NIOS II response: %s\n",
-                  bladerf_strerror(status));
+    if (status == 0) {
+        status = usb->fn->bulk_transfer(usb->driver, PERIPHERAL_EP_IN, buf,
+                                        NIOS_PKT_LEN, timeout_ms);
+        print_buf("NIOS II res:", buf, NIOS_PKT_LEN);
     }
 
-    print_buf("NIOS II res:", buf, NIOS_PKT_LEN);
+    PROBE2(nios_done, magic, status);
+
+    ctrl_trace_end(dev, trace_start, BLADERF_CTRL_TRACE_NIOS, magic, target,
+                   write, status);
+
+    return status;
+}
+
+static int nios_access(struct bladerf *dev, uint8_t *buf)
+{
+    bool sent;
+    int status;
+
+    status = nios_transfer(dev, buf, PERIPHERAL_TIMEOUT_MS, &sent);
+    if (status != 0) {
+        if (!sent) {
+            log_error("Failed to send NIOS II request: %s\n",
+                      bladerf_strerror(status));
+        } else {
+            log_error("Failed to receive NIOS II response: %s\n",
+                      bladerf_strerror(status));
+        }
+    }
 
     return status;
 }
@@ -86,25 +156,173 @@ static int nios_access(struct bladerf *dev, uint8_t *buf)
 /* Variant that doesn't output to log_error on error. */
 static int nios_access_quiet(struct bladerf *dev, uint8_t *buf)
 {
-    struct bladerf_usb *usb = dev->backend_data;
-    int status;
+    bool sent;
 
-    print_buf("NIOS II REQ:", buf, NIOS_PKT_LEN);
+    return nios_transfer(dev, buf, PERIPHERAL_TIMEOUT_MS, &sent);
+}
 
-    /* Send the command */
-    status = usb->fn->bulk_transfer(usb->driver, PERIPHERAL_EP_OUT, buf,
-                                    NIOS_PKT_LEN, PERIPHERAL_TIMEOUT_MS);
-    if (status != 0) {
-        return status;
+/* Register shadows
+ *
+ * Read-modify-write sequences make up much of the LMS6002D, Si5338 and AD9361
+ * control traffic, and the reads typically return values the host itself
+ * wrote. Writes and reads of registers that only change at the host's
+ * request are therefore recorded, and subsequent reads of these registers
+ * are served without a round-trip to the device. */
+
+#define LMS_SOFT_RESET_ADDR     0x05
+#define LMS_SOFT_RESET_N        (1 << 5)
+
+#define SI5338_PAGE_ADDR        255
+
+#define AD9361_SPI_CONF_ADDR    0x000
+#define AD9361_SPI_SOFT_RESET   0x81
+#define AD9361_SPI_WRITE        (1 << 15)
+#define AD9361_SPI_ADDR(cmd)    ((cmd) & 0x3ff)
+#define AD9361_SPI_BYTES(cmd)   ((((cmd) >> 12) & 0x7) + 1)
+
+/* AD9361 reset line in the RFFE control register (RFFE_CONTROL_RESET_N) */
+#define RFFE_CSR_RESET_N        (1 << 0)
+
+/* Excludes the DC calibration result/status/control registers of each
+ * calibration module, as well as the DSM enables, PLL registers (which
+ * include the VTUNE comparators) and XB-200 path swap bits. The latter are
+ * updated by the NIOS II when performing FPGA-based tuning. */
+static bool lms_shadowable(uint8_t addr)
+{
+    return !(addr <= 0x03 || addr == 0x09 ||
+             (addr >= 0x10 && addr <= 0x2f) ||
+             (addr >= 0x30 && addr <= 0x33) ||
+             (addr >= 0x50 && addr <= 0x53) || addr == 0x5a ||
+             (addr >= 0x60 && addr <= 0x63));
+}
+
+/* Excludes the status, PLL calibration result, soft reset and page
+ * select registers */
+static bool si5338_shadowable(uint8_t addr)
+{
+    return !(addr == 218 || (addr >= 235 && addr <= 237) || addr == 246 ||
+             addr == SI5338_PAGE_ADDR);
+}
+
+/* The AD9361 has a large number of status and self-clearing registers.
+ * Rather than enumerating these, only the configuration registers commonly
+ * updated via read-modify-write during gain and bandwidth changes are
+ * shadowed: the TX/RX enable and filter configuration, TX attenuation,
+ * gain control configuration, and TIA configuration. */
+static bool ad9361_shadowable(uint16_t addr)
+{
+    return (addr >= 0x002 && addr <= 0x003) ||
+           (addr >= 0x073 && addr <= 0x076) ||
+           (addr >= 0x0fa && addr <= 0x12f) ||
+           (addr >= 0x1db && addr <= 0x1df);
+}
+
+static inline struct bladerf_usb *usb_data(struct bladerf *dev)
+{
+    return (struct bladerf_usb *) dev->backend_data;
+}
+
+static void lms_shadow_update(struct bladerf *dev, bool write,
+                              uint8_t addr, uint8_t data, bool success)
+{
+    struct reg_shadow *shadow = &usb_data(dev)->lms_shadow;
+
+    /* The MSB of the address denotes an atomic multi-write */
+    addr &= 0x7f;
+
+    if (!success) {
+        reg_shadow_invalidate(shadow, addr);
+    } else if (write && addr == LMS_SOFT_RESET_ADDR &&
+               (data & LMS_SOFT_RESET_N) == 0) {
+        reg_shadow_invalidate_all(shadow);
+    } else if (lms_shadowable(addr)) {
+        reg_shadow_set(shadow, addr, data);
     }
+}
 
-    /* Retrieve the request */
-    status = usb->fn->bulk_transfer(usb->driver, PERIPHERAL_EP_IN, buf,
-                                    NIOS_PKT_LEN, PERIPHERAL_TIMEOUT_MS);
+static void si5338_shadow_update(struct bladerf *dev, bool write,
+                                 uint8_t addr, uint8_t data, bool success)
+{
+    struct reg_shadow *shadow = &usb_data(dev)->si5338_shadow;
+
+    if (!success) {
+        reg_shadow_invalidate(shadow, addr);
+    } else if (write && addr == SI5338_PAGE_ADDR) {
+        /* Subsequent addresses may refer to another page */
+        reg_shadow_invalidate_all(shadow);
+    } else if (si5338_shadowable(addr)) {
+        reg_shadow_set(shadow, addr, data);
+    }
+}
 
-    print_buf("NIOS II res:", buf, NIOS_PKT_LEN);
+static void ad9361_shadow_update(struct bladerf *dev, uint16_t cmd,
+                                 uint64_t data, bool success)
+{
+    struct reg_shadow *shadow = &usb_data(dev)->ad9361_shadow;
+    const uint16_t addr   = AD9361_SPI_ADDR(cmd);
+    const unsigned int n  = AD9361_SPI_BYTES(cmd);
+    unsigned int i;
+
+    /* Multi-byte accesses proceed in descending address order, with the
+     * first byte in the MSB of the data word */
+    for (i = 0; i < n && i <= addr; i++) {
+        const uint16_t byte_addr = addr - i;
+        const uint8_t byte       = (data >> (56 - 8 * i)) & 0xff;
+
+        if (!success) {
+            reg_shadow_invalidate(shadow, byte_addr);
+        } else if ((cmd & AD9361_SPI_WRITE) &&
+                   byte_addr == AD9361_SPI_CONF_ADDR &&
+                   (byte & AD9361_SPI_SOFT_RESET) != 0) {
+            reg_shadow_invalidate_all(shadow);
+        } else if (ad9361_shadowable(byte_addr)) {
+            reg_shadow_set(shadow, byte_addr, byte);
+        }
+    }
+}
 
-    return status;
+/* Serve a block read from the shadow. Returns false if any register in the
+ * block is not shadowed. */
+static bool block_shadow_read(const struct reg_shadow *shadow, uint8_t addr,
+                              uint8_t *data, unsigned int count)
+{
+    unsigned int i;
+    uint8_t tmp;
+
+    for (i = 0; i < count; i++) {
+        if (!reg_shadow_get(shadow, addr + i, &tmp)) {
+            return false;
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        reg_shadow_get(shadow, addr + i, &data[i]);
+    }
+
+    return true;
+}
+
+/* Serve a batch of reads from the shadow. Returns false if any access in the
+ * batch is a write, or an access to a register that is not shadowed. */
+static bool batch_shadow_read(const struct reg_shadow *shadow,
+                              struct backend_reg_op *ops, unsigned int count,
+                              uint8_t addr_mask)
+{
+    unsigned int i;
+    uint8_t tmp;
+
+    for (i = 0; i < count; i++) {
+        if (ops[i].write ||
+            !reg_shadow_get(shadow, ops[i].addr & addr_mask, &tmp)) {
+            return false;
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        reg_shadow_get(shadow, ops[i].addr & addr_mask, &ops[i].data);
+    }
+
+    return true;
 }
 
 static int nios_8x8_read(struct bladerf *dev, uint8_t id,
@@ -156,6 +374,135 @@ static int nios_8x8_write(struct bladerf *dev, uint8_t id,
     }
 }
 
+static int nios_8x8_batch(struct bladerf *dev, uint8_t id,
+                          struct backend_reg_op *ops, unsigned int count)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+    uint8_t completed;
+    unsigned int i, n;
+
+    while (count > 0) {
+        n = count;
+        if (n > NIOS_PKT_8x8_BATCH_MAX) {
+            n = NIOS_PKT_8x8_BATCH_MAX;
+        }
+
+        nios_pkt_8x8_batch_pack(buf, id);
+        for (i = 0; i < n; i++) {
+            nios_pkt_8x8_batch_pack_op(buf, ops[i].write,
+                                       ops[i].addr, ops[i].data);
+        }
+
+        status = nios_access(dev, buf);
+        if (status != 0) {
+            return status;
+        }
+
+        nios_pkt_8x8_batch_resp_unpack(buf, &completed);
+
+        for (i = 0; i < completed && i < n; i++) {
+            if (!ops[i].write) {
+                nios_pkt_8x8_batch_unpack_op(buf, (uint8_t) i, NULL, NULL,
+                                             &ops[i].data);
+            }
+        }
+
+        if (completed != n) {
+            log_debug("%s: response packet reported failure of op %u.\n",
+                      __FUNCTION__, completed);
+            return BLADERF_ERR_FPGA_OP;
+        }
+
+        ops   += n;
+        count -= n;
+    }
+
+    return 0;
+}
+
+static int nios_16x8_batch(struct bladerf *dev, uint8_t id,
+                           struct backend_ad9361_op *ops, unsigned int count)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+    uint8_t completed;
+    unsigned int i, n;
+
+    while (count > 0) {
+        n = count;
+        if (n > NIOS_PKT_16x8_BATCH_MAX) {
+            n = NIOS_PKT_16x8_BATCH_MAX;
+        }
+
+        nios_pkt_16x8_batch_pack(buf, id);
+        for (i = 0; i < n; i++) {
+            nios_pkt_16x8_batch_pack_op(buf, ops[i].write,
+                                        ops[i].addr, ops[i].data);
+        }
+
+        status = nios_access(dev, buf);
+        if (status != 0) {
+            return status;
+        }
+
+        nios_pkt_16x8_batch_resp_unpack(buf, &completed);
+
+        for (i = 0; i < completed && i < n; i++) {
+            if (!ops[i].write) {
+                nios_pkt_16x8_batch_unpack_op(buf, (uint8_t) i, NULL, NULL,
+                                              &ops[i].data);
+            }
+        }
+
+        if (completed != n) {
+            log_debug("%s: response packet reported failure of op %u.\n",
+                      __FUNCTION__, completed);
+            return BLADERF_ERR_FPGA_OP;
+        }
+
+        ops   += n;
+        count -= n;
+    }
+
+    return 0;
+}
+
+static int nios_8x8_block(struct bladerf *dev, uint8_t id, bool write,
+                          uint8_t addr, uint8_t *data, unsigned int count)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+    uint8_t completed;
+    uint8_t n;
+
+    while (count > 0) {
+        n = (count > NIOS_PKT_8x8_BLOCK_MAX) ? NIOS_PKT_8x8_BLOCK_MAX
+                                             : (uint8_t) count;
+
+        nios_pkt_8x8_block_pack(buf, id, write, addr, data, n);
+
+        status = nios_access(dev, buf);
+        if (status != 0) {
+            return status;
+        }
+
+        nios_pkt_8x8_block_resp_unpack(buf, write ? NULL : data, &completed);
+
+        if (completed != n) {
+            log_debug("%s: response packet reported failure at 0x%02x.\n",
+                      __FUNCTION__, addr + completed);
+            return BLADERF_ERR_FPGA_OP;
+        }
+
+        addr  += n;
+        data  += n;
+        count -= n;
+    }
+
+    return 0;
+}
+
 static int nios_8x16_read(struct bladerf *dev, uint8_t id,
                           uint8_t addr, uint16_t *data)
 {
@@ -259,17 +606,19 @@ static int nios_8x32_write(struct bladerf *dev, uint8_t id,
 static int nios_16x64_read(struct bladerf *dev,
                            uint8_t id,
                            uint16_t addr,
-                           uint64_t *data)
+                           uint64_t *data,
+                           unsigned int timeout_ms)
 {
     int status;
     uint8_t buf[NIOS_PKT_LEN];
     bool success;
+    bool sent;
 
     nios_pkt_16x64_pack(buf, id, false, addr, 0);
 
     /* RFIC access times out occasionally, and this is fine. */
     if (NIOS_PKT_16x64_TARGET_RFIC == id) {
-        status = nios_access_quiet(dev, buf);
+        status = nios_transfer(dev, buf, timeout_ms, &sent);
     } else {
         status = nios_access(dev, buf);
     }
@@ -508,9 +857,50 @@ int nios_get_timestamp(struct bladerf *dev,
     }
 }
 
+int nios_get_timestamp_latch(struct bladerf *dev,
+                             bladerf_direction dir,
+                             uint64_t *timestamp,
+                             uint32_t *hold)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+    bool success;
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        log_debug("Invalid direction: %d\n", dir);
+        return BLADERF_ERR_INVAL;
+    }
+
+    nios_pkt_ts_latch_pack(buf, dir == BLADERF_TX);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_ts_latch_resp_unpack(buf, timestamp, hold, &success);
+
+    if (success) {
+        log_verbose("%s: Latched %s timestamp: %" PRIu64 ", hold %u\n",
+                    __FUNCTION__, direction2str(dir), *timestamp, *hold);
+        return 0;
+    } else {
+        log_debug("%s: response packet reported failure.\n", __FUNCTION__);
+        *timestamp = 0;
+        return BLADERF_ERR_FPGA_OP;
+    }
+}
+
 int nios_si5338_read(struct bladerf *dev, uint8_t addr, uint8_t *data)
 {
-    int status = nios_8x8_read(dev, NIOS_PKT_8x8_TARGET_SI5338, addr, data);
+    int status;
+
+    if (reg_shadow_get(&usb_data(dev)->si5338_shadow, addr, data)) {
+        return 0;
+    }
+
+    status = nios_8x8_read(dev, NIOS_PKT_8x8_TARGET_SI5338, addr, data);
+    si5338_shadow_update(dev, false, addr, *data, status == 0);
 
 #ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
     if (status == 0) {
@@ -526,6 +916,8 @@ int nios_si5338_write(struct bladerf *dev, uint8_t addr, uint8_t data)
 {
     int status = nios_8x8_write(dev, NIOS_PKT_8x8_TARGET_SI5338, addr, data);
 
+    si5338_shadow_update(dev, true, addr, data, status == 0);
+
 #ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
     if (status == 0) {
         log_verbose("%s: Wrote 0x%02x to addr 0x%02x\n",
@@ -538,7 +930,14 @@ int nios_si5338_write(struct bladerf *dev, uint8_t addr, uint8_t data)
 
 int nios_lms6_read(struct bladerf *dev, uint8_t addr, uint8_t *data)
 {
-    int status = nios_8x8_read(dev, NIOS_PKT_8x8_TARGET_LMS6, addr, data);
+    int status;
+
+    if (reg_shadow_get(&usb_data(dev)->lms_shadow, addr & 0x7f, data)) {
+        return 0;
+    }
+
+    status = nios_8x8_read(dev, NIOS_PKT_8x8_TARGET_LMS6, addr, data);
+    lms_shadow_update(dev, false, addr, *data, status == 0);
 
 #ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
     if (status == 0) {
@@ -554,6 +953,8 @@ int nios_lms6_write(struct bladerf *dev, uint8_t addr, uint8_t data)
 {
     int status = nios_8x8_write(dev, NIOS_PKT_8x8_TARGET_LMS6, addr, data);
 
+    lms_shadow_update(dev, true, addr, data, status == 0);
+
 #ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
     if (status == 0) {
         log_verbose("%s: Wrote 0x%02x to addr 0x%02x\n",
@@ -564,200 +965,790 @@ int nios_lms6_write(struct bladerf *dev, uint8_t addr, uint8_t data)
     return status;
 }
 
-int nios_ina219_read(struct bladerf *dev, uint8_t addr, uint16_t *data)
+int nios_si5338_batch(struct bladerf *dev,
+                      struct backend_reg_op *ops,
+                      unsigned int count)
 {
+    unsigned int i;
     int status;
 
-    status = nios_8x16_read(dev, NIOS_PKT_8x16_TARGET_INA219, addr, data);
-    if (status == 0) {
-        log_verbose("%s: Read 0x%04x from addr 0x%02x\n",
-                    __FUNCTION__, *data, addr);
+    if (!have_cap_dev(dev, BLADERF_CAP_FPGA_8x8_BATCH)) {
+        return backend_reg_batch_sequential(dev, nios_si5338_write,
+                                            nios_si5338_read, ops, count);
+    }
+
+    if (batch_shadow_read(&usb_data(dev)->si5338_shadow, ops, count, 0xff)) {
+        return 0;
+    }
+
+    status = nios_8x8_batch(dev, NIOS_PKT_8x8_TARGET_SI5338, ops, count);
+
+    for (i = 0; i < count; i++) {
+        si5338_shadow_update(dev, ops[i].write, ops[i].addr, ops[i].data,
+                             status == 0);
     }
 
     return status;
 }
 
-int nios_ina219_write(struct bladerf *dev, uint8_t addr, uint16_t data)
+int nios_lms6_batch(struct bladerf *dev,
+                    struct backend_reg_op *ops,
+                    unsigned int count)
 {
+    unsigned int i;
     int status;
 
-    status = nios_8x16_write(dev, NIOS_PKT_8x16_TARGET_INA219, addr, data);
-    if (status == 0) {
-        log_verbose("%s: Wrote 0x%04x to addr 0x%02x\n",
-                    __FUNCTION__, data, addr);
+    if (!have_cap_dev(dev, BLADERF_CAP_FPGA_8x8_BATCH)) {
+        return backend_reg_batch_sequential(dev, nios_lms6_write,
+                                            nios_lms6_read, ops, count);
+    }
+
+    if (batch_shadow_read(&usb_data(dev)->lms_shadow, ops, count, 0x7f)) {
+        return 0;
+    }
+
+    status = nios_8x8_batch(dev, NIOS_PKT_8x8_TARGET_LMS6, ops, count);
+
+    for (i = 0; i < count; i++) {
+        lms_shadow_update(dev, ops[i].write, ops[i].addr, ops[i].data,
+                          status == 0);
     }
 
     return status;
 }
 
-#define VERBOSE_OUT_SINGLEBYTE "%s: %s 0x%02x @ addr 0x%04x\n"
-#define VERBOSE_OUT_MULTIBYTE "%s: %s 0x%02x @ addr 0x%04x (%d/%d)\n"
+int nios_si5338_block(struct bladerf *dev,
+                      bool write,
+                      uint8_t addr,
+                      uint8_t *data,
+                      unsigned int count)
+{
+    unsigned int i;
+    int status;
 
-int nios_ad9361_spi_read(struct bladerf *dev, uint16_t cmd, uint64_t *data)
+    if (count == 0 || (addr + count - 1) > 0xff) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!have_cap_dev(dev, BLADERF_CAP_FPGA_8x8_BLOCK)) {
+        return backend_reg_block_sequential(dev, nios_si5338_write,
+                                            nios_si5338_read, write, addr,
+                                            data, count);
+    }
+
+    if (!write && block_shadow_read(&usb_data(dev)->si5338_shadow,
+                                    addr, data, count)) {
+        return 0;
+    }
+
+    status = nios_8x8_block(dev, NIOS_PKT_8x8_TARGET_SI5338, write, addr,
+                            data, count);
+
+    for (i = 0; i < count; i++) {
+        si5338_shadow_update(dev, write, (uint8_t)(addr + i), data[i],
+                             status == 0);
+    }
+
+    return status;
+}
+
+int nios_lms6_block(struct bladerf *dev,
+                    bool write,
+                    uint8_t addr,
+                    uint8_t *data,
+                    unsigned int count)
 {
+    unsigned int i;
     int status;
 
-    status = nios_16x64_read(dev, NIOS_PKT_16x64_TARGET_AD9361, cmd, data);
+    /* The MSB of an LMS6002D address is reserved for atomic multi-writes */
+    if (count == 0 || (addr + count - 1) > 0x7f) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!have_cap_dev(dev, BLADERF_CAP_FPGA_8x8_BLOCK)) {
+        return backend_reg_block_sequential(dev, nios_lms6_write,
+                                            nios_lms6_read, write, addr,
+                                            data, count);
+    }
 
-#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
-    if (log_get_verbosity() == BLADERF_LOG_LEVEL_VERBOSE && status == 0) {
-        size_t bytes = (((cmd >> 12) & 0x7) + 1);
-        size_t addr  = cmd & 0xFFF;
+    if (!write && block_shadow_read(&usb_data(dev)->lms_shadow,
+                                    addr, data, count)) {
+        return 0;
+    }
 
-        if (bytes > 1) {
-            size_t i;
-            for (i = 0; i < bytes; ++i) {
-                uint8_t byte = (*data >> (56 - 8 * i)) & 0xFF;
-                log_verbose(VERBOSE_OUT_MULTIBYTE, "ad9361_spi", " MRead", byte,
-                            addr - i, i + 1, bytes);
-            }
-        } else {
-            uint8_t byte = (*data >> 56) & 0xFF;
-            log_verbose(VERBOSE_OUT_SINGLEBYTE, "ad9361_spi", "  Read", byte,
-                        addr);
-        }
+    status = nios_8x8_block(dev, NIOS_PKT_8x8_TARGET_LMS6, write, addr,
+                            data, count);
+
+    for (i = 0; i < count; i++) {
+        lms_shadow_update(dev, write, (uint8_t)(addr + i), data[i],
+                          status == 0);
+    }
+
+    return status;
+}
+
+int nios_lms6_vcocap_search(struct bladerf *dev,
+                            bladerf_module mod,
+                            uint8_t vcocap_est,
+                            uint8_t *vcocap_result,
+                            bool *locked)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+    uint16_t data;
+    bool success;
+    const uint8_t addr = (mod == BLADERF_MODULE_TX) ?
+                            NIOS_PKT_8x16_ADDR_VCOCAP_TX :
+                            NIOS_PKT_8x16_ADDR_VCOCAP_RX;
+
+    *locked = false;
+
+    nios_pkt_8x16_pack(buf, NIOS_PKT_8x16_TARGET_VCOCAP, true, addr,
+                       vcocap_est & NIOS_PKT_8x16_VCOCAP_MASK);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    /* The response data contains the search result */
+    nios_pkt_8x16_resp_unpack(buf, NULL, NULL, NULL, &data, &success);
+
+    if (!success) {
+        log_debug("%s: response packet reported failure.\n", __FUNCTION__);
+        return BLADERF_ERR_FPGA_OP;
+    }
+
+    *vcocap_result = data & NIOS_PKT_8x16_VCOCAP_MASK;
+    *locked = (data & NIOS_PKT_8x16_VCOCAP_LOCKED) != 0;
+
+    log_verbose("%s: VCOCAP=%u (est. %u), %s\n", __FUNCTION__,
+                *vcocap_result, vcocap_est, *locked ? "locked" : "unlocked");
+
+    return 0;
+}
+
+static int nios_lms6_dc_cal(struct bladerf *dev, uint8_t base,
+                            uint8_t cal_addr, uint16_t *data)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+    bool success;
+    const uint8_t addr = (base & NIOS_PKT_8x16_LMS_DC_CAL_BASE_MASK) |
+                         (cal_addr & NIOS_PKT_8x16_LMS_DC_CAL_ADDR_MASK);
+
+    nios_pkt_8x16_pack(buf, NIOS_PKT_8x16_TARGET_LMS_DC_CAL, true, addr,
+                       *data);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_8x16_resp_unpack(buf, NULL, NULL, NULL, data, &success);
+
+    if (!success) {
+        log_debug("%s: response packet reported failure.\n", __FUNCTION__);
+        return BLADERF_ERR_FPGA_OP;
+    }
+
+    return 0;
+}
+
+int nios_lms6_dc_cal_loop(struct bladerf *dev,
+                          uint8_t base,
+                          uint8_t cal_addr,
+                          uint8_t dc_cntval,
+                          uint8_t *dc_regval,
+                          bool *done)
+{
+    uint16_t data = dc_cntval & NIOS_PKT_8x16_LMS_DC_CAL_VAL_MASK;
+    int status;
+
+    *done = false;
+
+    status = nios_lms6_dc_cal(dev, base, cal_addr, &data);
+    if (status != 0) {
+        return status;
+    }
+
+    /* The response data contains the calibration result */
+    *dc_regval = data & NIOS_PKT_8x16_LMS_DC_CAL_VAL_MASK;
+    *done = (data & NIOS_PKT_8x16_LMS_DC_CAL_DONE) != 0;
+
+    log_verbose("%s: %02x:%02x DC_REGVAL=%u, %s\n", __FUNCTION__, base,
+                cal_addr, *dc_regval, *done ? "done" : "not done");
+
+    return 0;
+}
+
+int nios_lms6_dc_cal_load(struct bladerf *dev,
+                          uint8_t base,
+                          uint8_t cal_addr,
+                          uint8_t value)
+{
+    uint16_t data = NIOS_PKT_8x16_LMS_DC_CAL_LOAD |
+                    (value & NIOS_PKT_8x16_LMS_DC_CAL_VAL_MASK);
+
+    /* Only the DC calibration registers and clock enables are accessed,
+     * none of which are shadowed */
+    return nios_lms6_dc_cal(dev, base, cal_addr, &data);
+}
+
+int nios_ina219_read(struct bladerf *dev, uint8_t addr, uint16_t *data)
+{
+    int status;
+
+    status = nios_8x16_read(dev, NIOS_PKT_8x16_TARGET_INA219, addr, data);
+    if (status == 0) {
+        log_verbose("%s: Read 0x%04x from addr 0x%02x\n",
+                    __FUNCTION__, *data, addr);
+    }
+
+    return status;
+}
+
+int nios_ina219_write(struct bladerf *dev, uint8_t addr, uint16_t data)
+{
+    int status;
+
+    status = nios_8x16_write(dev, NIOS_PKT_8x16_TARGET_INA219, addr, data);
+    if (status == 0) {
+        log_verbose("%s: Wrote 0x%04x to addr 0x%02x\n",
+                    __FUNCTION__, data, addr);
+    }
+
+    return status;
+}
+
+#define VERBOSE_OUT_SINGLEBYTE "%s: %s 0x%02x @ addr 0x%04x\n"
+#define VERBOSE_OUT_MULTIBYTE "%s: %s 0x%02x @ addr 0x%04x (%d/%d)\n"
+
+int nios_ad9361_spi_read(struct bladerf *dev, uint16_t cmd, uint64_t *data)
+{
+    int status;
+
+    if (AD9361_SPI_BYTES(cmd) == 1) {
+        uint8_t byte;
+
+        if (reg_shadow_get(&usb_data(dev)->ad9361_shadow,
+                           AD9361_SPI_ADDR(cmd), &byte)) {
+            *data = ((uint64_t) byte) << 56;
+            return 0;
+        }
+    }
+
+    status = nios_16x64_read(dev, NIOS_PKT_16x64_TARGET_AD9361, cmd, data,
+                             PERIPHERAL_TIMEOUT_MS);
+    ad9361_shadow_update(dev, cmd, *data, status == 0);
+
+#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
+    if (log_get_verbosity() == BLADERF_LOG_LEVEL_VERBOSE && status == 0) {
+        size_t bytes = (((cmd >> 12) & 0x7) + 1);
+        size_t addr  = cmd & 0xFFF;
+
+        if (bytes > 1) {
+            size_t i;
+            for (i = 0; i < bytes; ++i) {
+                uint8_t byte = (*data >> (56 - 8 * i)) & 0xFF;
+                log_verbose(VERBOSE_OUT_MULTIBYTE, "ad9361_spi", " MRead", byte,
+                            addr - i, i + 1, bytes);
+            }
+        } else {
+            uint8_t byte = (*data >> 56) & 0xFF;
+            log_verbose(VERBOSE_OUT_SINGLEBYTE, "ad9361_spi", "  Read", byte,
+                        addr);
+        }
+    }
+#endif
+
+    return status;
+}
+
+int nios_ad9361_spi_write(struct bladerf *dev, uint16_t cmd, uint64_t data)
+{
+    int status;
+
+    status = nios_16x64_write(dev, NIOS_PKT_16x64_TARGET_AD9361, cmd, data);
+    ad9361_shadow_update(dev, cmd, data, status == 0);
+
+#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
+    if (log_get_verbosity() == BLADERF_LOG_LEVEL_VERBOSE && status == 0) {
+        size_t bytes = (((cmd >> 12) & 0x7) + 1) & 0xFF;
+        size_t addr  = cmd & 0xFFF;
+
+        if (bytes > 1) {
+            size_t i;
+            for (i = 0; i < bytes; ++i) {
+                uint8_t byte = (data >> (56 - 8 * i)) & 0xFF;
+                log_verbose(VERBOSE_OUT_MULTIBYTE, "ad9361_spi", "MWrite", byte,
+                            addr - i, i + 1, bytes);
+            }
+        } else {
+            uint8_t byte = (data >> 56) & 0xFF;
+            log_verbose(VERBOSE_OUT_SINGLEBYTE, "ad9361_spi", " Write", byte,
+                        addr);
+        }
+    }
+#endif
+
+    return status;
+}
+
+int nios_ad9361_spi_batch(struct bladerf *dev,
+                          struct backend_ad9361_op *ops,
+                          unsigned int count)
+{
+    unsigned int i;
+    uint16_t cmd;
+    uint64_t data;
+    int status = 0;
+
+    if (!have_cap_dev(dev, BLADERF_CAP_FPGA_16x8_BATCH)) {
+        for (i = 0; i < count && status == 0; i++) {
+            cmd = AD9361_SPI_ADDR(ops[i].addr);
+            if (ops[i].write) {
+                cmd |= AD9361_SPI_WRITE;
+                status = nios_ad9361_spi_write(dev, cmd,
+                                               ((uint64_t) ops[i].data) << 56);
+            } else {
+                status = nios_ad9361_spi_read(dev, cmd, &data);
+                ops[i].data = (uint8_t) (data >> 56);
+            }
+        }
+
+        return status;
+    }
+
+    status = nios_16x8_batch(dev, NIOS_PKT_16x64_TARGET_AD9361, ops, count);
+
+    for (i = 0; i < count; i++) {
+        cmd = AD9361_SPI_ADDR(ops[i].addr);
+        if (ops[i].write) {
+            cmd |= AD9361_SPI_WRITE;
+        }
+
+        ad9361_shadow_update(dev, cmd, ((uint64_t) ops[i].data) << 56,
+                             status == 0);
+    }
+
+    return status;
+}
+
+int nios_adi_axi_read(struct bladerf *dev, uint32_t addr, uint32_t *data)
+{
+    int status;
+
+    status = nios_32x32_read(dev, NIOS_PKT_32x32_TARGET_ADI_AXI, addr, data);
+
+#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
+    if (status == 0) {
+        log_verbose("%s:  Read  0x%08" PRIx32 " from addr 0x%04" PRIx32 "\n",
+                    __FUNCTION__, *data, addr);
+    }
+#endif
+
+    return status;
+}
+
+int nios_adi_axi_write(struct bladerf *dev, uint32_t addr, uint32_t data)
+{
+    int status;
+
+    status = nios_32x32_write(dev, NIOS_PKT_32x32_TARGET_ADI_AXI, addr, data);
+
+#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
+    if (status == 0) {
+        log_verbose("%s: Wrote 0x%08" PRIx32 " to   addr 0x%04" PRIx32 "\n",
+                    __FUNCTION__, data, addr);
+    }
+#endif
+
+    return status;
+}
+
+int nios_rfic_command_read(struct bladerf *dev, uint16_t cmd, uint64_t *data)
+{
+    int status;
+
+    status = nios_16x64_read(dev, NIOS_PKT_16x64_TARGET_RFIC, cmd, data,
+                             PERIPHERAL_TIMEOUT_MS);
+
+#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
+    if (status == 0) {
+        log_verbose("%s: Read 0x%04x 0x%08x\n", __FUNCTION__, cmd, *data);
+    }
+#endif
+
+    return status;
+}
+
+int nios_rfic_command_wait(struct bladerf *dev,
+                           uint16_t cmd,
+                           unsigned int timeout_ms,
+                           uint64_t *data)
+{
+    int status;
+
+    status = nios_16x64_read(dev, NIOS_PKT_16x64_TARGET_RFIC, cmd, data,
+                             timeout_ms);
+
+    /* Queued writes executed while waiting may have accessed the AD9361 */
+    reg_shadow_invalidate_all(&usb_data(dev)->ad9361_shadow);
+
+#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
+    if (status == 0) {
+        log_verbose("%s: Read 0x%04x 0x%08x\n", __FUNCTION__, cmd, *data);
+    }
+#endif
+
+    return status;
+}
+
+int nios_rfic_command_write(struct bladerf *dev, uint16_t cmd, uint64_t data)
+{
+    int status;
+
+    status = nios_16x64_write(dev, NIOS_PKT_16x64_TARGET_RFIC, cmd, data);
+
+    /* The NIOS II may access the AD9361 on our behalf */
+    reg_shadow_invalidate_all(&usb_data(dev)->ad9361_shadow);
+
+#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
+    if (status == 0) {
+        log_verbose("%s: Write 0x%04x 0x%08x\n", __FUNCTION__, cmd, data);
+    }
+#endif
+
+    return status;
+}
+
+int nios_rffe_control_read(struct bladerf *dev, uint32_t *value)
+{
+    int status;
+
+    status = nios_8x32_read(dev, NIOS_PKT_8x32_TARGET_RFFE_CSR, 0, value);
+
+#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
+    if (status == 0) {
+        log_verbose("%s: Read 0x%08x\n", __FUNCTION__, *value);
+    }
+#endif
+
+    return status;
+}
+
+int nios_rffe_control_write(struct bladerf *dev, uint32_t value)
+{
+    int status;
+
+    status = nios_8x32_write(dev, NIOS_PKT_8x32_TARGET_RFFE_CSR, 0, value);
+
+    if ((value & RFFE_CSR_RESET_N) == 0) {
+        reg_shadow_invalidate_all(&usb_data(dev)->ad9361_shadow);
+    }
+
+#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
+    if (status == 0) {
+        log_verbose("%s: Wrote 0x%08x\n", __FUNCTION__, value);
+    }
+#endif
+
+    return status;
+}
+
+int nios_rffe_fastlock_save(struct bladerf *dev, bool is_tx,
+                            uint8_t rffe_profile, uint16_t nios_profile)
+{
+    int status;
+    uint8_t  addr;
+    uint32_t data = 0;
+
+    addr = is_tx ? 1 : 0;
+    data = (rffe_profile << 16) | nios_profile;
+
+    status = nios_8x32_write(dev, NIOS_PKT_8x32_TARGET_FASTLOCK, addr, data);
+
+#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
+    if (status == 0) {
+        log_verbose("%s: Wrote 0x%08x\n", __FUNCTION__, data);
+    }
+#endif
+
+    return status;
+}
+
+int nios_rffe_fastlock_read(struct bladerf *dev, bool is_tx,
+                            uint8_t nios_profile, uint8_t *data)
+{
+    int status;
+    uint16_t addr;
+    uint64_t half;
+    size_t i, n;
+
+    for (n = 0; n < 2; n++) {
+        addr = nios_pkt_16x64_fastlock_addr(is_tx, n == 1, 0, nios_profile);
+
+        status = nios_16x64_read(dev, NIOS_PKT_16x64_TARGET_FASTLOCK, addr,
+                                 &half, PERIPHERAL_TIMEOUT_MS);
+        if (status != 0) {
+            return status;
+        }
+
+        for (i = 0; i < 8; i++) {
+            data[8 * n + i] = (uint8_t)(half >> (8 * i));
+        }
+    }
+
+    return 0;
+}
+
+int nios_rffe_fastlock_write(struct bladerf *dev, bool is_tx,
+                             uint8_t rffe_profile, uint8_t nios_profile,
+                             const uint8_t *data)
+{
+    int status;
+    uint16_t addr;
+    uint64_t half;
+    size_t i, n;
+
+    /* The upper half is written last, as it marks the profile valid */
+    for (n = 0; n < 2; n++) {
+        addr = nios_pkt_16x64_fastlock_addr(is_tx, n == 1, rffe_profile,
+                                            nios_profile);
+
+        half = 0;
+        for (i = 0; i < 8; i++) {
+            half |= (uint64_t)data[8 * n + i] << (8 * i);
+        }
+
+        status = nios_16x64_write(dev, NIOS_PKT_16x64_TARGET_FASTLOCK, addr,
+                                  half);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    return 0;
+}
+
+int nios_rx_ddc_write(struct bladerf *dev, uint32_t value)
+{
+    int status;
+
+    status = nios_8x32_write(dev, NIOS_PKT_8x32_TARGET_RX_DDC, 0, value);
+
+#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
+    if (status == 0) {
+        log_verbose("%s: Wrote 0x%08x\n", __FUNCTION__, value);
+    }
+#endif
+
+    return status;
+}
+
+int nios_rx_ddc_read(struct bladerf *dev, uint32_t *value)
+{
+    int status;
+
+    status = nios_8x32_read(dev, NIOS_PKT_8x32_TARGET_RX_DDC, 0, value);
+
+#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
+    if (status == 0) {
+        log_verbose("%s: Read 0x%08x\n", __FUNCTION__, *value);
+    }
+#endif
+
+    return status;
+}
+
+int nios_tx_duc_write(struct bladerf *dev, uint32_t value)
+{
+    int status;
+
+    status = nios_8x32_write(dev, NIOS_PKT_8x32_TARGET_TX_DUC, 0, value);
+
+#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
+    if (status == 0) {
+        log_verbose("%s: Wrote 0x%08x\n", __FUNCTION__, value);
+    }
+#endif
+
+    return status;
+}
+
+int nios_tx_duc_read(struct bladerf *dev, uint32_t *value)
+{
+    int status;
+
+    status = nios_8x32_read(dev, NIOS_PKT_8x32_TARGET_TX_DUC, 0, value);
+
+#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
+    if (status == 0) {
+        log_verbose("%s: Read 0x%08x\n", __FUNCTION__, *value);
+    }
+#endif
+
+    return status;
+}
+
+int nios_rx_power_write(struct bladerf *dev, uint8_t addr, uint32_t value)
+{
+    int status;
+
+    status = nios_8x32_write(dev, NIOS_PKT_8x32_TARGET_RX_POWER, addr, value);
+
+#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
+    if (status == 0) {
+        log_verbose("%s: Wrote 0x%08x to addr 0x%02x\n", __FUNCTION__, value,
+                    addr);
     }
 #endif
 
     return status;
 }
 
-int nios_ad9361_spi_write(struct bladerf *dev, uint16_t cmd, uint64_t data)
+int nios_rx_power_read(struct bladerf *dev, uint8_t addr, uint32_t *value)
 {
     int status;
 
-    status = nios_16x64_write(dev, NIOS_PKT_16x64_TARGET_AD9361, cmd, data);
+    status = nios_8x32_read(dev, NIOS_PKT_8x32_TARGET_RX_POWER, addr, value);
 
 #ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
-    if (log_get_verbosity() == BLADERF_LOG_LEVEL_VERBOSE && status == 0) {
-        size_t bytes = (((cmd >> 12) & 0x7) + 1) & 0xFF;
-        size_t addr  = cmd & 0xFFF;
-
-        if (bytes > 1) {
-            size_t i;
-            for (i = 0; i < bytes; ++i) {
-                uint8_t byte = (data >> (56 - 8 * i)) & 0xFF;
-                log_verbose(VERBOSE_OUT_MULTIBYTE, "ad9361_spi", "MWrite", byte,
-                            addr - i, i + 1, bytes);
-            }
-        } else {
-            uint8_t byte = (data >> 56) & 0xFF;
-            log_verbose(VERBOSE_OUT_SINGLEBYTE, "ad9361_spi", " Write", byte,
-                        addr);
-        }
+    if (status == 0) {
+        log_verbose("%s: Read 0x%08x from addr 0x%02x\n", __FUNCTION__,
+                    *value, addr);
     }
 #endif
 
     return status;
 }
 
-int nios_adi_axi_read(struct bladerf *dev, uint32_t addr, uint32_t *data)
+int nios_rx_burst_write(struct bladerf *dev, uint8_t addr, uint32_t value)
 {
     int status;
 
-    status = nios_32x32_read(dev, NIOS_PKT_32x32_TARGET_ADI_AXI, addr, data);
+    status = nios_8x32_write(dev, NIOS_PKT_8x32_TARGET_RX_BURST, addr, value);
 
 #ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
     if (status == 0) {
-        log_verbose("%s:  Read  0x%08" PRIx32 " from addr 0x%04" PRIx32 "\n",
-                    __FUNCTION__, *data, addr);
+        log_verbose("%s: Wrote 0x%08x to addr 0x%02x\n", __FUNCTION__, value,
+                    addr);
     }
 #endif
 
     return status;
 }
 
-int nios_adi_axi_write(struct bladerf *dev, uint32_t addr, uint32_t data)
+int nios_rx_burst_read(struct bladerf *dev, uint8_t addr, uint32_t *value)
 {
     int status;
 
-    status = nios_32x32_write(dev, NIOS_PKT_32x32_TARGET_ADI_AXI, addr, data);
+    status = nios_8x32_read(dev, NIOS_PKT_8x32_TARGET_RX_BURST, addr, value);
 
 #ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
     if (status == 0) {
-        log_verbose("%s: Wrote 0x%08" PRIx32 " to   addr 0x%04" PRIx32 "\n",
-                    __FUNCTION__, data, addr);
+        log_verbose("%s: Read 0x%08x from addr 0x%02x\n", __FUNCTION__,
+                    *value, addr);
     }
 #endif
 
     return status;
 }
 
-int nios_rfic_command_read(struct bladerf *dev, uint16_t cmd, uint64_t *data)
+int nios_fifo_level_write(struct bladerf *dev, uint8_t addr, uint32_t value)
 {
     int status;
 
-    status = nios_16x64_read(dev, NIOS_PKT_16x64_TARGET_RFIC, cmd, data);
+    status = nios_8x32_write(dev, NIOS_PKT_8x32_TARGET_FIFO_LEVEL, addr, value);
 
 #ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
     if (status == 0) {
-        log_verbose("%s: Read 0x%04x 0x%08x\n", __FUNCTION__, cmd, *data);
+        log_verbose("%s: Wrote 0x%08x to addr 0x%02x\n", __FUNCTION__, value,
+                    addr);
     }
 #endif
 
     return status;
 }
 
-int nios_rfic_command_write(struct bladerf *dev, uint16_t cmd, uint64_t data)
+int nios_fifo_level_read(struct bladerf *dev, uint8_t addr, uint32_t *value)
 {
     int status;
 
-    status = nios_16x64_write(dev, NIOS_PKT_16x64_TARGET_RFIC, cmd, data);
+    status = nios_8x32_read(dev, NIOS_PKT_8x32_TARGET_FIFO_LEVEL, addr, value);
 
 #ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
     if (status == 0) {
-        log_verbose("%s: Write 0x%04x 0x%08x\n", __FUNCTION__, cmd, data);
+        log_verbose("%s: Read 0x%08x from addr 0x%02x\n", __FUNCTION__,
+                    *value, addr);
     }
 #endif
 
     return status;
 }
 
-int nios_rffe_control_read(struct bladerf *dev, uint32_t *value)
+int nios_tx_loop_write(struct bladerf *dev, uint8_t addr, uint32_t value)
 {
     int status;
 
-    status = nios_8x32_read(dev, NIOS_PKT_8x32_TARGET_RFFE_CSR, 0, value);
+    status = nios_8x32_write(dev, NIOS_PKT_8x32_TARGET_TX_LOOP, addr, value);
 
 #ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
     if (status == 0) {
-        log_verbose("%s: Read 0x%08x\n", __FUNCTION__, *value);
+        log_verbose("%s: Wrote 0x%08x to addr 0x%02x\n", __FUNCTION__, value,
+                    addr);
     }
 #endif
 
     return status;
 }
 
-int nios_rffe_control_write(struct bladerf *dev, uint32_t value)
+int nios_tx_loop_read(struct bladerf *dev, uint8_t addr, uint32_t *value)
 {
     int status;
 
-    status = nios_8x32_write(dev, NIOS_PKT_8x32_TARGET_RFFE_CSR, 0, value);
+    status = nios_8x32_read(dev, NIOS_PKT_8x32_TARGET_TX_LOOP, addr, value);
 
 #ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
     if (status == 0) {
-        log_verbose("%s: Wrote 0x%08x\n", __FUNCTION__, value);
+        log_verbose("%s: Read 0x%08x from addr 0x%02x\n", __FUNCTION__,
+                    *value, addr);
     }
 #endif
 
     return status;
 }
 
-int nios_rffe_fastlock_save(struct bladerf *dev, bool is_tx,
-                            uint8_t rffe_profile, uint16_t nios_profile)
+int nios_vctcxo_tamer_write(struct bladerf *dev, uint8_t addr, uint32_t value)
 {
     int status;
-    uint8_t  addr;
-    uint32_t data = 0;
 
-    addr = is_tx ? 1 : 0;
-    data = (rffe_profile << 16) | nios_profile;
+    status = nios_8x32_write(dev, NIOS_PKT_8x32_TARGET_VCTCXO_TAMER, addr,
+                             value);
 
-    status = nios_8x32_write(dev, NIOS_PKT_8x32_TARGET_FASTLOCK, addr, data);
+#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
+    if (status == 0) {
+        log_verbose("%s: Wrote 0x%08x to addr 0x%02x\n", __FUNCTION__, value,
+                    addr);
+    }
+#endif
+
+    return status;
+}
+
+int nios_vctcxo_tamer_read(struct bladerf *dev, uint8_t addr, uint32_t *value)
+{
+    int status;
+
+    status = nios_8x32_read(dev, NIOS_PKT_8x32_TARGET_VCTCXO_TAMER, addr,
+                            value);
 
 #ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
     if (status == 0) {
-        log_verbose("%s: Wrote 0x%08x\n", __FUNCTION__, data);
+        log_verbose("%s: Read 0x%08x from addr 0x%02x\n", __FUNCTION__,
+                    *value, addr);
     }
 #endif
 
@@ -1078,7 +2069,7 @@ int nios_expansion_gpio_dir_write(struct bladerf *dev,
 int nios_retune(struct bladerf *dev, bladerf_channel ch,
                 uint64_t timestamp, uint16_t nint, uint32_t nfrac,
                 uint8_t freqsel, uint8_t vcocap, bool low_band,
-                uint8_t xb_gpio, bool quick_tune)
+                uint8_t xb_gpio, bool quick_tune, uint8_t op)
 {
     int status;
     uint8_t buf[NIOS_PKT_LEN];
@@ -1088,6 +2079,9 @@ int nios_retune(struct bladerf *dev, bladerf_channel ch,
 
     if (timestamp == NIOS_PKT_RETUNE_CLEAR_QUEUE) {
         log_verbose("Clearing %s retune queue.\n", channel2str(ch));
+    } else if (op == NIOS_PKT_RETUNE_OP_CANCEL) {
+        log_verbose("Cancelling %s retune at %"PRIu64".\n",
+                    channel2str(ch), timestamp);
     } else {
         log_verbose("%s: channel=%s timestamp=%"PRIu64" nint=%u nfrac=%u\n\t\t\t\t"
                     "freqsel=0x%02x vcocap=0x%02x low_band=%d quick_tune=%d\n",
@@ -1099,6 +2093,8 @@ int nios_retune(struct bladerf *dev, bladerf_channel ch,
                          nint, nfrac, freqsel, vcocap, low_band,
                          xb_gpio, quick_tune);
 
+    nios_pkt_retune_set_op(buf, op);
+
     status = nios_access(dev, buf);
     if (status != 0) {
         return status;
@@ -1118,6 +2114,10 @@ int nios_retune(struct bladerf *dev, bladerf_channel ch,
         if (timestamp == BLADERF_RETUNE_NOW) {
             log_debug("FPGA tuning reported failure.\n");
             status = BLADERF_ERR_UNEXPECTED;
+        } else if (op != NIOS_PKT_RETUNE_OP_SCHEDULE) {
+            log_debug("No pending %s retune is scheduled at %"PRIu64".\n",
+                      channel2str(ch), timestamp);
+            status = BLADERF_ERR_INVAL;
         } else {
             log_debug("The FPGA's retune queue is full. Try again after "
                       "a previous request has completed.\n");
@@ -1128,10 +2128,44 @@ int nios_retune(struct bladerf *dev, bladerf_channel ch,
     return status;
 }
 
+int nios_retune_corr(struct bladerf *dev, bladerf_channel ch, uint8_t flags,
+                     uint8_t dc_i, uint8_t dc_q, uint16_t gain, uint16_t phase,
+                     uint8_t lna, uint8_t vga1, uint8_t vga2)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+
+    uint8_t resp_flags;
+    uint64_t duration;
+    uint8_t vcocap;
+
+    log_verbose("%s: channel=%s flags=0x%02x dc_i=0x%02x dc_q=0x%02x "
+                "gain=0x%04x phase=0x%04x lna=%u vga1=0x%02x vga2=0x%02x\n",
+                __FUNCTION__, channel2str(ch), flags, dc_i, dc_q, gain, phase,
+                lna, vga1, vga2);
+
+    nios_pkt_retune_corr_pack(buf, ch, flags, dc_i, dc_q, gain, phase);
+    nios_pkt_retune_corr_set_gain(buf, lna, vga1, vga2);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_retune_resp_unpack(buf, &duration, &vcocap, &resp_flags);
+
+    if ((resp_flags & NIOS_PKT_RETUNERESP_FLAG_SUCCESS) == 0) {
+        log_debug("FPGA rejected %s retune corrections.\n", channel2str(ch));
+        status = BLADERF_ERR_UNEXPECTED;
+    }
+
+    return status;
+}
+
 int nios_retune2(struct bladerf *dev, bladerf_channel ch,
                  uint64_t timestamp, uint16_t nios_profile,
                  uint8_t rffe_profile, uint8_t port,
-                 uint8_t spdt)
+                 uint8_t spdt, uint8_t op)
 {
     int status;
     uint8_t buf[NIOS_PKT_LEN];
@@ -1141,6 +2175,9 @@ int nios_retune2(struct bladerf *dev, bladerf_channel ch,
 
     if (timestamp == NIOS_PKT_RETUNE2_CLEAR_QUEUE) {
         log_verbose("Clearing %s retune queue.\n", channel2str(ch));
+    } else if (op == NIOS_PKT_RETUNE2_OP_CANCEL) {
+        log_verbose("Cancelling %s entries at %"PRIu64".\n",
+                    channel2str(ch), timestamp);
     } else {
         log_verbose("%s: channel=%s timestamp=%"PRIu64" nios_profile=%u "
                     "rffe_profile=%u\n\t\t\t\tport=0x%02x spdt=0x%02x\n",
@@ -1151,6 +2188,8 @@ int nios_retune2(struct bladerf *dev, bladerf_channel ch,
     nios_pkt_retune2_pack(buf, ch, timestamp, nios_profile, rffe_profile,
                           port, spdt);
 
+    nios_pkt_retune2_set_op(buf, op);
+
     status = nios_access(dev, buf);
     if (status != 0) {
         return status;
@@ -1170,6 +2209,96 @@ int nios_retune2(struct bladerf *dev, bladerf_channel ch,
         if (timestamp == BLADERF_RETUNE_NOW) {
             log_debug("FPGA tuning reported failure.\n");
             status = BLADERF_ERR_UNEXPECTED;
+        } else if (op != NIOS_PKT_RETUNE2_OP_SCHEDULE) {
+            log_debug("No pending %s entry is scheduled at %"PRIu64".\n",
+                      channel2str(ch), timestamp);
+            status = BLADERF_ERR_INVAL;
+        } else {
+            log_debug("The FPGA's retune queue is full. Try again after "
+                      "a previous request has completed.\n");
+            status = BLADERF_ERR_QUEUE_FULL;
+        }
+    }
+
+    return status;
+}
+
+int nios_retune2_param(struct bladerf *dev, bladerf_channel ch,
+                       uint64_t timestamp, uint8_t type, uint8_t cmd,
+                       uint32_t value)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+
+    uint8_t resp_flags;
+    uint64_t duration;
+
+    log_verbose("%s: channel=%s timestamp=%"PRIu64" type=%u cmd=0x%02x "
+                "value=0x%08x\n", __FUNCTION__, channel2str(ch), timestamp,
+                type, cmd, value);
+
+    nios_pkt_retune2_param_pack(buf, ch, timestamp, type, cmd, value);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_retune2_resp_unpack(buf, &duration, &resp_flags);
+
+    log_verbose("%s operation duration: %"PRIu64"\n", channel2str(ch),
+                duration);
+
+    if ((resp_flags & NIOS_PKT_RETUNE2_RESP_FLAG_SUCCESS) == 0) {
+        if (timestamp == BLADERF_RETUNE_NOW) {
+            log_debug("FPGA reported failure to apply parameter change.\n");
+            status = BLADERF_ERR_UNEXPECTED;
+        } else {
+            log_debug("The FPGA's retune queue is full. Try again after "
+                      "a previous request has completed.\n");
+            status = BLADERF_ERR_QUEUE_FULL;
+        }
+    }
+
+    return status;
+}
+
+int nios_retune2_pair(struct bladerf *dev, uint64_t timestamp,
+                      uint16_t rx_nios_profile, uint8_t rx_rffe_profile,
+                      uint16_t tx_nios_profile, uint8_t tx_rffe_profile,
+                      uint8_t port, uint8_t spdt)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+
+    uint8_t resp_flags;
+    uint64_t duration;
+
+    log_verbose("%s: timestamp=%"PRIu64" rx_nios_profile=%u "
+                "rx_rffe_profile=%u tx_nios_profile=%u tx_rffe_profile=%u "
+                "port=0x%02x spdt=0x%02x\n", __FUNCTION__, timestamp,
+                rx_nios_profile, rx_rffe_profile, tx_nios_profile,
+                tx_rffe_profile, port, spdt);
+
+    nios_pkt_retune2_pair_pack(buf, timestamp, rx_nios_profile,
+                               rx_rffe_profile, tx_nios_profile,
+                               tx_rffe_profile, port, spdt);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_retune2_resp_unpack(buf, &duration, &resp_flags);
+
+    if (resp_flags & NIOS_PKT_RETUNE2_RESP_FLAG_TSVTUNE_VALID) {
+        log_verbose("Paired retune duration: %"PRIu64"\n", duration);
+    }
+
+    if ((resp_flags & NIOS_PKT_RETUNE2_RESP_FLAG_SUCCESS) == 0) {
+        if (timestamp == BLADERF_RETUNE_NOW) {
+            log_debug("FPGA paired retune failed to lock.\n");
+            status = BLADERF_ERR_UNEXPECTED;
         } else {
             log_debug("The FPGA's retune queue is full. Try again after "
                       "a previous request has completed.\n");
@@ -1180,6 +2309,76 @@ int nios_retune2(struct bladerf *dev, bladerf_channel ch,
     return status;
 }
 
+static int retune_stats_read(struct bladerf *dev, uint8_t addr, uint64_t *data)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+    bool success;
+
+    nios_pkt_8x64_pack(buf, NIOS_PKT_8x64_TARGET_RETUNE_STATS, false, addr, 0);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_8x64_resp_unpack(buf, NULL, NULL, NULL, data, &success);
+
+    if (!success) {
+        log_debug("%s: response packet reported failure.\n", __FUNCTION__);
+        return BLADERF_ERR_FPGA_OP;
+    }
+
+    return 0;
+}
+
+int nios_get_retune_stats(struct bladerf *dev, bladerf_channel ch,
+                          struct bladerf_retune_stats *stats)
+{
+    uint8_t const base =
+        BLADERF_CHANNEL_IS_TX(ch) ? NIOS_PKT_8x64_RETUNE_STATS_TX : 0;
+    uint64_t flags;
+    int status;
+
+    status = retune_stats_read(dev, base | NIOS_PKT_8x64_RETUNE_STATS_FLAGS,
+                               &flags);
+    if (status != 0) {
+        return status;
+    }
+
+    if ((flags & NIOS_PKT_8x64_RETUNE_STATS_FLAG_VALID) == 0) {
+        log_debug("No %s retune has been recorded.\n", channel2str(ch));
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    stats->locked = (flags & NIOS_PKT_8x64_RETUNE_STATS_FLAG_LOCKED) != 0;
+
+    status = retune_stats_read(
+        dev, base | NIOS_PKT_8x64_RETUNE_STATS_SCHEDULED, &stats->scheduled);
+    if (status != 0) {
+        return status;
+    }
+
+    status = retune_stats_read(dev, base | NIOS_PKT_8x64_RETUNE_STATS_START,
+                               &stats->start);
+    if (status != 0) {
+        return status;
+    }
+
+    status = retune_stats_read(
+        dev, base | NIOS_PKT_8x64_RETUNE_STATS_COMPLETE, &stats->complete);
+    if (status != 0) {
+        return status;
+    }
+
+    log_verbose("%s: %s scheduled=%" PRIu64 " start=%" PRIu64
+                " complete=%" PRIu64 " locked=%d\n",
+                __FUNCTION__, channel2str(ch), stats->scheduled, stats->start,
+                stats->complete, stats->locked);
+
+    return 0;
+}
+
 int nios_read_trigger(struct bladerf *dev, bladerf_channel ch,
                       bladerf_trigger_signal trigger, uint8_t *value)
 {
@@ -1259,3 +2458,101 @@ int nios_write_trigger(struct bladerf *dev, bladerf_channel ch,
 
     return status;
 }
+
+static int trigger_time_access(struct bladerf *dev, bladerf_channel ch,
+                               bladerf_trigger_signal trigger, uint8_t field,
+                               bool write, uint64_t *data)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+    uint8_t addr;
+    bool success;
+
+    switch (ch) {
+        case BLADERF_CHANNEL_TX(0):
+            addr = NIOS_PKT_8x64_TRIGGER_TX | field;
+            break;
+
+        case BLADERF_CHANNEL_RX(0):
+            addr = field;
+            break;
+
+        default:
+            log_debug("Invalid channel: 0x%x\n", ch);
+            return BLADERF_ERR_INVAL;
+    }
+
+    /* Only 1 external trigger is currently supported */
+    switch (trigger) {
+        case BLADERF_TRIGGER_J71_4:
+        case BLADERF_TRIGGER_J51_1:
+        case BLADERF_TRIGGER_MINI_EXP_1:
+            break;
+
+        default:
+            log_debug("Invalid trigger: %d\n", trigger);
+            return BLADERF_ERR_INVAL;
+    }
+
+    nios_pkt_8x64_pack(buf, NIOS_PKT_8x64_TARGET_TRIGGER, write, addr, *data);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_8x64_resp_unpack(buf, NULL, NULL, NULL, data, &success);
+
+    if (!success) {
+        log_debug("%s: response packet reported failure.\n", __FUNCTION__);
+        return BLADERF_ERR_FPGA_OP;
+    }
+
+    return 0;
+}
+
+int nios_trigger_fire_at(struct bladerf *dev, bladerf_channel ch,
+                         bladerf_trigger_signal trigger, uint64_t timestamp)
+{
+    int status;
+
+    status = trigger_time_access(dev, ch, trigger,
+                                 NIOS_PKT_8x64_TRIGGER_FIRE_TIME, true,
+                                 &timestamp);
+    if (status == 0) {
+        log_verbose("%s trigger scheduled at %" PRIu64 "\n", channel2str(ch),
+                    timestamp);
+    }
+
+    return status;
+}
+
+int nios_trigger_fire_time(struct bladerf *dev, bladerf_channel ch,
+                           bladerf_trigger_signal trigger, bool *fired,
+                           uint64_t *timestamp)
+{
+    uint64_t flags = 0;
+    int status;
+
+    status = trigger_time_access(dev, ch, trigger,
+                                 NIOS_PKT_8x64_TRIGGER_STATUS, false, &flags);
+    if (status != 0) {
+        return status;
+    }
+
+    *fired = (flags & NIOS_PKT_8x64_TRIGGER_FLAG_FIRED) != 0;
+    if (!*fired) {
+        return 0;
+    }
+
+    *timestamp = 0;
+    status = trigger_time_access(dev, ch, trigger,
+                                 NIOS_PKT_8x64_TRIGGER_FIRED_TIME, false,
+                                 timestamp);
+    if (status == 0) {
+        log_verbose("%s trigger fired at %" PRIu64 "\n", channel2str(ch),
+                    *timestamp);
+    }
+
+    return status;
+}
@@ -83,6 +83,22 @@ int nios_get_timestamp(struct bladerf *dev,
                        bladerf_direction dir,
                        uint64_t *timestamp);
 
+/**
+ * Latch a timestamp counter value as the request arrives at the NIOS II
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Stream direction
+ * @param[out]  timestamp   On success, updated with the latched value
+ * @param[out]  hold        On success, updated with the counter ticks that
+ *                          elapsed between the latch and the response
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_get_timestamp_latch(struct bladerf *dev,
+                             bladerf_direction dir,
+                             uint64_t *timestamp,
+                             uint32_t *hold);
+
 /**
  * Read from an Si5338 register
  *
@@ -127,6 +143,140 @@ int nios_lms6_read(struct bladerf *dev, uint8_t addr, uint8_t *data);
  */
 int nios_lms6_write(struct bladerf *dev, uint8_t addr, uint8_t data);
 
+/**
+ * Perform a sequence of Si5338 register accesses
+ *
+ * When supported by the FPGA, up to NIOS_PKT_8x8_BATCH_MAX accesses are
+ * carried in each request. Otherwise, the accesses are performed one at a
+ * time.
+ *
+ * @param       dev         Device handle
+ * @param       ops         Accesses to perform, in order. Read data is
+ *                          stored in the associated `data` fields.
+ * @param[in]   count       Number of accesses
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_si5338_batch(struct bladerf *dev,
+                      struct backend_reg_op *ops,
+                      unsigned int count);
+
+/**
+ * Perform a sequence of LMS6002D register accesses
+ *
+ * When supported by the FPGA, up to NIOS_PKT_8x8_BATCH_MAX accesses are
+ * carried in each request. Otherwise, the accesses are performed one at a
+ * time.
+ *
+ * @param       dev         Device handle
+ * @param       ops         Accesses to perform, in order. Read data is
+ *                          stored in the associated `data` fields.
+ * @param[in]   count       Number of accesses
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_lms6_batch(struct bladerf *dev,
+                    struct backend_reg_op *ops,
+                    unsigned int count);
+
+/**
+ * Read or write a range of consecutive Si5338 registers
+ *
+ * When supported by the FPGA, up to NIOS_PKT_8x8_BLOCK_MAX registers are
+ * carried in each request. Otherwise, the registers are accessed one at a
+ * time.
+ *
+ * @param       dev         Device handle
+ * @param[in]   write       Write (true) or read (false) the registers
+ * @param[in]   addr        Address of the first register
+ * @param       data        Data to write, or updated with the data read
+ * @param[in]   count       Number of registers
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_si5338_block(struct bladerf *dev,
+                      bool write,
+                      uint8_t addr,
+                      uint8_t *data,
+                      unsigned int count);
+
+/**
+ * Read or write a range of consecutive LMS6002D registers
+ *
+ * When supported by the FPGA, up to NIOS_PKT_8x8_BLOCK_MAX registers are
+ * carried in each request. Otherwise, the registers are accessed one at a
+ * time.
+ *
+ * @param       dev         Device handle
+ * @param[in]   write       Write (true) or read (false) the registers
+ * @param[in]   addr        Address of the first register
+ * @param       data        Data to write, or updated with the data read
+ * @param[in]   count       Number of registers
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_lms6_block(struct bladerf *dev,
+                    bool write,
+                    uint8_t addr,
+                    uint8_t *data,
+                    unsigned int count);
+
+/**
+ * Perform the LMS6002D VCOCAP search on the NIOS II, in a single request
+ *
+ * The PLL must already be configured, with the estimate written to VCOCAP.
+ *
+ * @param       dev             Device handle
+ * @param[in]   mod             Module
+ * @param[in]   vcocap_est      Initial VCOCAP estimate
+ * @param[out]  vcocap_result   Selected VCOCAP value
+ * @param[out]  locked          Set true if VTUNE settled in its normal range
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_lms6_vcocap_search(struct bladerf *dev,
+                            bladerf_module mod,
+                            uint8_t vcocap_est,
+                            uint8_t *vcocap_result,
+                            bool *locked);
+
+/**
+ * Run an LMS6002D DC calibration loop on the NIOS II, in a single request
+ *
+ * The module's DC calibration clock must already be enabled.
+ *
+ * @param       dev         Device handle
+ * @param[in]   base        Base address of the DC calibration module
+ * @param[in]   cal_addr    DC calibration address within the module
+ * @param[in]   dc_cntval   DC_CNTVAL to start the calibration from
+ * @param[out]  dc_regval   Resulting DC_REGVAL
+ * @param[out]  done        Set true if the calibration completed
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_lms6_dc_cal_loop(struct bladerf *dev,
+                          uint8_t base,
+                          uint8_t cal_addr,
+                          uint8_t dc_cntval,
+                          uint8_t *dc_regval,
+                          bool *done);
+
+/**
+ * Load an LMS6002D DC calibration value from the NIOS II, in a single
+ * request
+ *
+ * @param       dev         Device handle
+ * @param[in]   base        Base address of the DC calibration module
+ * @param[in]   cal_addr    DC calibration address within the module
+ * @param[in]   value       Value to load
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_lms6_dc_cal_load(struct bladerf *dev,
+                          uint8_t base,
+                          uint8_t cal_addr,
+                          uint8_t value);
+
 /**
  * Read from an INA219 register
  *
@@ -171,6 +321,24 @@ int nios_ad9361_spi_read(struct bladerf *dev, uint16_t cmd, uint64_t *data);
  */
 int nios_ad9361_spi_write(struct bladerf *dev, uint16_t cmd, uint64_t data);
 
+/**
+ * Perform a sequence of single-byte AD9361 register accesses
+ *
+ * When supported by the FPGA, up to NIOS_PKT_16x8_BATCH_MAX accesses are
+ * carried in each request. Otherwise, the accesses are performed one at a
+ * time.
+ *
+ * @param       dev         Device handle
+ * @param       ops         Accesses to perform, in order. Read data is
+ *                          stored in the associated `data` fields.
+ * @param[in]   count       Number of accesses
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_ad9361_spi_batch(struct bladerf *dev,
+                          struct backend_ad9361_op *ops,
+                          unsigned int count);
+
 /**
  * Read the ADI AXI memory mapped region.
  *
@@ -204,6 +372,22 @@ int nios_adi_axi_write(struct bladerf *dev, uint32_t cmd, uint32_t data);
  */
 int nios_rfic_command_read(struct bladerf *dev, uint16_t cmd, uint64_t *data);
 
+/**
+ * Read RFIC command that the NIOS II may take a while to answer, such as
+ * BLADERF_RFIC_COMMAND_WAIT
+ *
+ * @param       dev         Device handle
+ * @param[in]   cmd         Command: `(command & 0xFF) + ((channel & 0xF) << 8)`
+ * @param[in]   timeout_ms  Time to allow for the response, in milliseconds
+ * @param[out]  data        Data
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_rfic_command_wait(struct bladerf *dev,
+                           uint16_t cmd,
+                           unsigned int timeout_ms,
+                           uint64_t *data);
+
 /**
  * Write RFIC command
  *
@@ -250,6 +434,186 @@ int nios_rffe_control_write(struct bladerf *dev, uint32_t value);
 int nios_rffe_fastlock_save(struct bladerf *dev, bool is_tx,
                             uint8_t rffe_profile, uint16_t nios_profile);
 
+/**
+ * Read a fast lock profile's data from the Nios.
+ *
+ * @param           dev          Device handle
+ * @param[in]       is_tx        True if TX profile, false if RX profile
+ * @param[in]       nios_profile Nios profile to read
+ * @param[out]      data         NIOS_PKT_16x64_FASTLOCK_PROFILE_LEN bytes of
+ *                               profile data
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_rffe_fastlock_read(struct bladerf *dev, bool is_tx,
+                            uint8_t nios_profile, uint8_t *data);
+
+/**
+ * Write a fast lock profile's data to the Nios, marking it as saved.
+ *
+ * @param           dev          Device handle
+ * @param[in]       is_tx        True if TX profile, false if RX profile
+ * @param[in]       rffe_profile RFFE profile the data belongs in
+ * @param[in]       nios_profile Nios profile to write
+ * @param[in]       data         NIOS_PKT_16x64_FASTLOCK_PROFILE_LEN bytes of
+ *                               profile data
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_rffe_fastlock_write(struct bladerf *dev, bool is_tx,
+                             uint8_t rffe_profile, uint8_t nios_profile,
+                             const uint8_t *data);
+
+/**
+ * Write the RX digital downconverter control register.
+ *
+ * @param           dev         Device handle
+ * @param[in]       value       Value. See NIOS_PKT_8x32_TARGET_RX_DDC.
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_rx_ddc_write(struct bladerf *dev, uint32_t value);
+
+/**
+ * Read the RX digital downconverter control register.
+ *
+ * @param           dev         Device handle
+ * @param[out]      value       Value
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_rx_ddc_read(struct bladerf *dev, uint32_t *value);
+
+/**
+ * Write the TX digital upconverter control register.
+ *
+ * @param           dev         Device handle
+ * @param[in]       value       Value. See NIOS_PKT_8x32_TARGET_TX_DUC.
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_tx_duc_write(struct bladerf *dev, uint32_t value);
+
+/**
+ * Read the TX digital upconverter control register.
+ *
+ * @param           dev         Device handle
+ * @param[out]      value       Value
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_tx_duc_read(struct bladerf *dev, uint32_t *value);
+
+/**
+ * Write an RX power detector register.
+ *
+ * @param           dev         Device handle
+ * @param[in]       addr        Address. See NIOS_PKT_8x32_TARGET_RX_POWER.
+ * @param[in]       value       Value
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_rx_power_write(struct bladerf *dev, uint8_t addr, uint32_t value);
+
+/**
+ * Read an RX power detector register.
+ *
+ * @param           dev         Device handle
+ * @param[in]       addr        Address. See NIOS_PKT_8x32_TARGET_RX_POWER.
+ * @param[out]      value       Value
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_rx_power_read(struct bladerf *dev, uint8_t addr, uint32_t *value);
+
+/**
+ * Write an RX burst gate register.
+ *
+ * @param           dev         Device handle
+ * @param[in]       addr        Address. See NIOS_PKT_8x32_TARGET_RX_BURST.
+ * @param[in]       value       Value
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_rx_burst_write(struct bladerf *dev, uint8_t addr, uint32_t value);
+
+/**
+ * Read an RX burst gate register.
+ *
+ * @param           dev         Device handle
+ * @param[in]       addr        Address. See NIOS_PKT_8x32_TARGET_RX_BURST.
+ * @param[out]      value       Value
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_rx_burst_read(struct bladerf *dev, uint8_t addr, uint32_t *value);
+
+/**
+ * Write a sample FIFO level monitor register.
+ *
+ * @param           dev         Device handle
+ * @param[in]       addr        Address. See NIOS_PKT_8x32_TARGET_FIFO_LEVEL.
+ * @param[in]       value       Value
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_fifo_level_write(struct bladerf *dev, uint8_t addr, uint32_t value);
+
+/**
+ * Read a sample FIFO level monitor register.
+ *
+ * @param           dev         Device handle
+ * @param[in]       addr        Address. See NIOS_PKT_8x32_TARGET_FIFO_LEVEL.
+ * @param[out]      value       Value
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_fifo_level_read(struct bladerf *dev, uint8_t addr, uint32_t *value);
+
+/**
+ * Write a TX waveform loop register.
+ *
+ * @param           dev         Device handle
+ * @param[in]       addr        Address. See NIOS_PKT_8x32_TARGET_TX_LOOP.
+ * @param[in]       value       Value
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_tx_loop_write(struct bladerf *dev, uint8_t addr, uint32_t value);
+
+/**
+ * Read a TX waveform loop register.
+ *
+ * @param           dev         Device handle
+ * @param[in]       addr        Address. See NIOS_PKT_8x32_TARGET_TX_LOOP.
+ * @param[out]      value       Value
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_tx_loop_read(struct bladerf *dev, uint8_t addr, uint32_t *value);
+
+/**
+ * Write a VCTCXO tamer trim state register.
+ *
+ * @param           dev         Device handle
+ * @param[in]       addr        Address. See NIOS_PKT_8x32_TARGET_VCTCXO_TAMER.
+ * @param[in]       value       Value
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_vctcxo_tamer_write(struct bladerf *dev, uint8_t addr, uint32_t value);
+
+/**
+ * Read a VCTCXO tamer trim state register.
+ *
+ * @param           dev         Device handle
+ * @param[in]       addr        Address. See NIOS_PKT_8x32_TARGET_VCTCXO_TAMER.
+ * @param[out]      value       Value
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_vctcxo_tamer_read(struct bladerf *dev, uint8_t addr, uint32_t *value);
+
 /**
  * Write to the AD56X1 VCTCXO trim DAC.
  *
@@ -483,6 +847,8 @@ int nios_expansion_gpio_dir_write(struct bladerf *dev,
  * @param[in]   xb_gpio     XB configuration bits
  * @param[in]   quick_tune  Denotes quick tune should be used instead of
  *                          tuning algorithm
+ * @param[in]   op          Queue operation (NIOS_PKT_RETUNE_OP_*) to perform
+ *                          for a scheduled retune
  *
  * @return BLADERF_ERR_UNSUPPORTED
  */
@@ -495,7 +861,30 @@ int nios_retune(struct bladerf *dev,
                 uint8_t vcocap,
                 bool low_band,
                 uint8_t xb_gpio,
-                bool quick_tune);
+                bool quick_tune,
+                uint8_t op);
+
+/**
+ * Stage DC offset, IQ balance and gain corrections to be applied along with
+ * the channel's next retune request
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel the corrections are for
+ * @param[in]   flags       NIOS_PKT_RETUNE_CORR_* flags denoting which
+ *                          corrections to apply
+ * @param[in]   dc_i        LMS6002D DC offset I register value
+ * @param[in]   dc_q        LMS6002D DC offset Q register value
+ * @param[in]   gain        IQ balance gain register value
+ * @param[in]   phase       IQ balance phase register value
+ * @param[in]   lna         RX LNA gain, as a bladerf_lna_gain value
+ * @param[in]   vga1        RXVGA1 or TXVGA1 register value
+ * @param[in]   vga2        RXVGA2 or TXVGA2 register value
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_retune_corr(struct bladerf *dev, bladerf_channel ch, uint8_t flags,
+                     uint8_t dc_i, uint8_t dc_q, uint16_t gain, uint16_t phase,
+                     uint8_t lna, uint8_t vga1, uint8_t vga2);
 
 /**
  * Handler for a retune request on bladeRF2 devices. The RFFEs used in these
@@ -519,12 +908,66 @@ int nios_retune(struct bladerf *dev,
  *                           the Nios profile will be loaded.
  * @param[in]   port         RFFE port settings
  * @param[in]   spdt         RF SPDT switch settings
+ * @param[in]   op           Queue operation (NIOS_PKT_RETUNE2_OP_*) to
+ *                           perform for a scheduled retune
  *
  * @return 0 on success, BLADERF_ERR_* code on error.
  */
 int nios_retune2(struct bladerf *dev, bladerf_channel ch,
                  uint64_t timestamp, uint16_t nios_profile,
-                 uint8_t rffe_profile, uint8_t port, uint8_t spdt);
+                 uint8_t rffe_profile, uint8_t port, uint8_t spdt,
+                 uint8_t op);
+
+/**
+ * Schedule a parameter change in the retune2 queue
+ *
+ * @param       dev          Device handle
+ * @param[in]   ch           Channel the change applies to
+ * @param[in]   timestamp    Time to apply the change at
+ * @param[in]   type         NIOS_PKT_RETUNE2_TYPE_RFIC_CMD or
+ *                           NIOS_PKT_RETUNE2_TYPE_RFPORT
+ * @param[in]   cmd          RFIC command, for RFIC command entries
+ * @param[in]   value        Command value, or packed RF port settings
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_retune2_param(struct bladerf *dev, bladerf_channel ch,
+                       uint64_t timestamp, uint8_t type, uint8_t cmd,
+                       uint32_t value);
+
+/**
+ * Schedule simultaneous RX and TX retunes, which the Nios applies together
+ * when the RX timestamp reaches the specified value. This consumes a single
+ * entry in the RX retune queue.
+ *
+ * @param       dev             Device handle
+ * @param[in]   timestamp       RX timestamp to retune at
+ * @param[in]   rx_nios_profile RX Nios profile number (0-255)
+ * @param[in]   rx_rffe_profile RX RFFE fast lock profile slot (0-7)
+ * @param[in]   tx_nios_profile TX Nios profile number (0-255)
+ * @param[in]   tx_rffe_profile TX RFFE fast lock profile slot (0-7)
+ * @param[in]   port            RX and TX RFFE port settings
+ * @param[in]   spdt            RF SPDT switch settings
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_retune2_pair(struct bladerf *dev, uint64_t timestamp,
+                      uint16_t rx_nios_profile, uint8_t rx_rffe_profile,
+                      uint16_t tx_nios_profile, uint8_t tx_rffe_profile,
+                      uint8_t port, uint8_t spdt);
+
+/**
+ * Read measurements of the most recent retune performed by the FPGA
+ *
+ * @param       dev          Device handle
+ * @param[in]   ch           Channel
+ * @param[out]  stats        Retune measurements
+ *
+ * @return 0 on success, BLADERF_ERR_UNEXPECTED if no retune has been
+ *         recorded, or BLADERF_ERR_* code on other errors.
+ */
+int nios_get_retune_stats(struct bladerf *dev, bladerf_channel ch,
+                          struct bladerf_retune_stats *stats);
 
 /**
  * Read trigger register value
@@ -557,4 +1000,37 @@ int nios_write_trigger(struct bladerf *dev,
                        bladerf_trigger_signal trigger,
                        uint8_t value);
 
+/**
+ * Schedule a trigger fire
+ *
+ * @param       dev        Device handle
+ * @param[in]   ch         Channel
+ * @param[in]   trigger    Trigger to fire
+ * @param[in]   timestamp  Time to fire at, in the channel's timestamp units
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error
+ */
+int nios_trigger_fire_at(struct bladerf *dev,
+                         bladerf_channel ch,
+                         bladerf_trigger_signal trigger,
+                         uint64_t timestamp);
+
+/**
+ * Read the time at which a trigger fired
+ *
+ * @param       dev        Device handle
+ * @param[in]   ch         Channel
+ * @param[in]   trigger    Trigger to query
+ * @param[out]  fired      Set to whether the trigger has fired since it was
+ *                         armed
+ * @param[out]  timestamp  If it has, the time at which it fired
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error
+ */
+int nios_trigger_fire_time(struct bladerf *dev,
+                           bladerf_channel ch,
+                           bladerf_trigger_signal trigger,
+                           bool *fired,
+                           uint64_t *timestamp);
+
 #endif
@@ -42,6 +42,7 @@
 
 #include "board/board.h"
 #include "board/bladerf1/capabilities.h"
+#include "helpers/ctrl_trace.h"
 #include "helpers/version.h"
 
 #include "board/bladerf1/capabilities.h"
@@ -76,6 +77,7 @@ static int nios_access(struct bladerf *dev, uint8_t peripheral,
                        size_t len)
 {
     struct bladerf_usb *usb = dev->backend_data;
+    const uint64_t trace_start = ctrl_trace_begin(dev);
 
     int status;
     size_t i;
@@ -104,6 +106,9 @@ static int nios_access(struct bladerf *dev, uint8_t peripheral,
     if (status != 0) {
         log_debug("Failed to submit NIOS II request: %s\n",
                   bladerf_strerror(status));
+        ctrl_trace_end(dev, trace_start, BLADERF_CTRL_TRACE_NIOS,
+                       NIOS_PKT_LEGACY_MAGIC, peripheral,
+                       dir == USB_DIR_HOST_TO_DEVICE, status);
         return status;
     }
 
@@ -113,6 +118,10 @@ static int nios_access(struct bladerf *dev, uint8_t peripheral,
                                     buf, sizeof(buf),
                                     PERIPHERAL_TIMEOUT_MS);
 
+    ctrl_trace_end(dev, trace_start, BLADERF_CTRL_TRACE_NIOS,
+                   NIOS_PKT_LEGACY_MAGIC, peripheral,
+                   dir == USB_DIR_HOST_TO_DEVICE, status);
+
     if (dir == NIOS_PKT_LEGACY_MODE_DIR_READ && status == 0) {
         for (i = 0; i < len; i++) {
             cmd[i].data = buf[i * 2 + 3];
@@ -360,6 +369,74 @@ int nios_legacy_lms6_write(struct bladerf *dev, uint8_t addr, uint8_t data)
     return status;
 }
 
+int nios_legacy_si5338_batch(struct bladerf *dev,
+                             struct backend_reg_op *ops,
+                             unsigned int count)
+{
+    return backend_reg_batch_sequential(dev, nios_legacy_si5338_write,
+                                        nios_legacy_si5338_read, ops, count);
+}
+
+int nios_legacy_lms6_batch(struct bladerf *dev,
+                           struct backend_reg_op *ops,
+                           unsigned int count)
+{
+    return backend_reg_batch_sequential(dev, nios_legacy_lms6_write,
+                                        nios_legacy_lms6_read, ops, count);
+}
+
+int nios_legacy_si5338_block(struct bladerf *dev,
+                             bool write,
+                             uint8_t addr,
+                             uint8_t *data,
+                             unsigned int count)
+{
+    return backend_reg_block_sequential(dev, nios_legacy_si5338_write,
+                                        nios_legacy_si5338_read, write, addr,
+                                        data, count);
+}
+
+int nios_legacy_lms6_block(struct bladerf *dev,
+                           bool write,
+                           uint8_t addr,
+                           uint8_t *data,
+                           unsigned int count)
+{
+    return backend_reg_block_sequential(dev, nios_legacy_lms6_write,
+                                        nios_legacy_lms6_read, write, addr,
+                                        data, count);
+}
+
+int nios_legacy_lms6_vcocap_search(struct bladerf *dev,
+                                   bladerf_module mod,
+                                   uint8_t vcocap_est,
+                                   uint8_t *vcocap_result,
+                                   bool *locked)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_lms6_dc_cal_loop(struct bladerf *dev,
+                                 uint8_t base,
+                                 uint8_t cal_addr,
+                                 uint8_t dc_cntval,
+                                 uint8_t *dc_regval,
+                                 bool *done)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_lms6_dc_cal_load(struct bladerf *dev,
+                                 uint8_t base,
+                                 uint8_t cal_addr,
+                                 uint8_t value)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
 int nios_legacy_ina219_read(struct bladerf *dev, uint8_t addr, uint16_t *data)
 {
     log_debug("This operation is not supported by the legacy NIOS packet format\n");
@@ -408,6 +485,15 @@ int nios_legacy_rfic_command_read(struct bladerf *dev,
     return BLADERF_ERR_UNSUPPORTED;
 }
 
+int nios_legacy_rfic_command_wait(struct bladerf *dev,
+                                  uint16_t cmd,
+                                  unsigned int timeout_ms,
+                                  uint64_t *data)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
 int nios_legacy_rfic_command_write(struct bladerf *dev,
                                    uint16_t cmd,
                                    uint64_t data)
@@ -435,6 +521,141 @@ int nios_legacy_rffe_fastlock_save(struct bladerf *dev, bool is_tx,
     return BLADERF_ERR_UNSUPPORTED;
 }
 
+int nios_legacy_rffe_fastlock_read(struct bladerf *dev, bool is_tx,
+                                   uint8_t nios_profile, uint8_t *data)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_rffe_fastlock_write(struct bladerf *dev, bool is_tx,
+                                    uint8_t rffe_profile, uint8_t nios_profile,
+                                    const uint8_t *data)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_rx_ddc_write(struct bladerf *dev, uint32_t value)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_rx_ddc_read(struct bladerf *dev, uint32_t *value)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_tx_duc_write(struct bladerf *dev, uint32_t value)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_tx_duc_read(struct bladerf *dev, uint32_t *value)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_rx_power_write(struct bladerf *dev,
+                               uint8_t addr,
+                               uint32_t value)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_rx_power_read(struct bladerf *dev,
+                              uint8_t addr,
+                              uint32_t *value)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_rx_burst_write(struct bladerf *dev,
+                               uint8_t addr,
+                               uint32_t value)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_rx_burst_read(struct bladerf *dev,
+                              uint8_t addr,
+                              uint32_t *value)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_fifo_level_write(struct bladerf *dev,
+                                 uint8_t addr,
+                                 uint32_t value)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_fifo_level_read(struct bladerf *dev,
+                                uint8_t addr,
+                                uint32_t *value)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_tx_loop_write(struct bladerf *dev,
+                              uint8_t addr,
+                              uint32_t value)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_tx_loop_read(struct bladerf *dev,
+                             uint8_t addr,
+                             uint32_t *value)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_vctcxo_tamer_write(struct bladerf *dev,
+                                   uint8_t addr,
+                                   uint32_t value)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_vctcxo_tamer_read(struct bladerf *dev,
+                                  uint8_t addr,
+                                  uint32_t *value)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_get_timestamp_latch(struct bladerf *dev,
+                                    bladerf_direction dir,
+                                    uint64_t *timestamp,
+                                    uint32_t *hold)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_get_retune_stats(struct bladerf *dev, bladerf_channel ch,
+                                 struct bladerf_retune_stats *stats)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
 int nios_legacy_ad56x1_vctcxo_trim_dac_read(struct bladerf *dev, uint16_t *value)
 {
     log_debug("This operation is not supported by the legacy NIOS packet format\n");
@@ -742,3 +963,19 @@ int nios_legacy_write_trigger(struct bladerf *dev, bladerf_channel ch,
     log_debug("This operation is not supported by the legacy NIOS packet format\n");
     return BLADERF_ERR_UNSUPPORTED;
 }
+
+int nios_legacy_trigger_fire_at(struct bladerf *dev, bladerf_channel ch,
+                                bladerf_trigger_signal trigger,
+                                uint64_t timestamp)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int nios_legacy_trigger_fire_time(struct bladerf *dev, bladerf_channel ch,
+                                  bladerf_trigger_signal trigger, bool *fired,
+                                  uint64_t *timestamp)
+{
+    log_debug("This operation is not supported by the legacy NIOS packet format\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
@@ -109,6 +109,22 @@ int nios_legacy_get_timestamp(struct bladerf *dev,
                               bladerf_direction dir,
                               uint64_t *timestamp);
 
+/**
+ * Latch a timestamp counter value. This is not supported by the legacy
+ * packet format.
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Stream direction
+ * @param[out]  timestamp   Unused
+ * @param[out]  hold        Unused
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_get_timestamp_latch(struct bladerf *dev,
+                                    bladerf_direction dir,
+                                    uint64_t *timestamp,
+                                    uint32_t *hold);
+
 /**
  * Read from an Si5338 register
  *
@@ -153,6 +169,120 @@ int nios_legacy_lms6_read(struct bladerf *dev, uint8_t addr, uint8_t *data);
  */
 int nios_legacy_lms6_write(struct bladerf *dev, uint8_t addr, uint8_t data);
 
+/**
+ * Perform a sequence of Si5338 register accesses, one at a time
+ *
+ * @param       dev         Device handle
+ * @param       ops         Accesses to perform, in order
+ * @param[in]   count       Number of accesses
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_legacy_si5338_batch(struct bladerf *dev,
+                             struct backend_reg_op *ops,
+                             unsigned int count);
+
+/**
+ * Perform a sequence of LMS6002D register accesses, one at a time
+ *
+ * @param       dev         Device handle
+ * @param       ops         Accesses to perform, in order
+ * @param[in]   count       Number of accesses
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_legacy_lms6_batch(struct bladerf *dev,
+                           struct backend_reg_op *ops,
+                           unsigned int count);
+
+/**
+ * Read or write a range of consecutive Si5338 registers, one at a time
+ *
+ * @param       dev         Device handle
+ * @param[in]   write       Write (true) or read (false) the registers
+ * @param[in]   addr        Address of the first register
+ * @param       data        Data to write, or updated with the data read
+ * @param[in]   count       Number of registers
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_legacy_si5338_block(struct bladerf *dev,
+                             bool write,
+                             uint8_t addr,
+                             uint8_t *data,
+                             unsigned int count);
+
+/**
+ * Read or write a range of consecutive LMS6002D registers, one at a time
+ *
+ * @param       dev         Device handle
+ * @param[in]   write       Write (true) or read (false) the registers
+ * @param[in]   addr        Address of the first register
+ * @param       data        Data to write, or updated with the data read
+ * @param[in]   count       Number of registers
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_legacy_lms6_block(struct bladerf *dev,
+                           bool write,
+                           uint8_t addr,
+                           uint8_t *data,
+                           unsigned int count);
+
+/**
+ * Perform the LMS6002D VCOCAP search on the NIOS II. This is not supported
+ * by the legacy packet format.
+ *
+ * @param       dev             Device handle
+ * @param[in]   mod             Module
+ * @param[in]   vcocap_est      Initial VCOCAP estimate
+ * @param[out]  vcocap_result   Selected VCOCAP value
+ * @param[out]  locked          Set true if VTUNE settled in its normal range
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_lms6_vcocap_search(struct bladerf *dev,
+                                   bladerf_module mod,
+                                   uint8_t vcocap_est,
+                                   uint8_t *vcocap_result,
+                                   bool *locked);
+
+/**
+ * Run an LMS6002D DC calibration loop on the NIOS II. This is not supported
+ * by the legacy packet format.
+ *
+ * @param       dev         Device handle
+ * @param[in]   base        Base address of the DC calibration module
+ * @param[in]   cal_addr    DC calibration address within the module
+ * @param[in]   dc_cntval   DC_CNTVAL to start the calibration from
+ * @param[out]  dc_regval   Resulting DC_REGVAL
+ * @param[out]  done        Set true if the calibration completed
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_lms6_dc_cal_loop(struct bladerf *dev,
+                                 uint8_t base,
+                                 uint8_t cal_addr,
+                                 uint8_t dc_cntval,
+                                 uint8_t *dc_regval,
+                                 bool *done);
+
+/**
+ * Load an LMS6002D DC calibration value from the NIOS II. This is not
+ * supported by the legacy packet format.
+ *
+ * @param       dev         Device handle
+ * @param[in]   base        Base address of the DC calibration module
+ * @param[in]   cal_addr    DC calibration address within the module
+ * @param[in]   value       Value to load
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_lms6_dc_cal_load(struct bladerf *dev,
+                                 uint8_t base,
+                                 uint8_t cal_addr,
+                                 uint8_t value);
+
 /**
  * Read from an INA219 register
  *
@@ -240,6 +370,21 @@ int nios_legacy_rfic_command_read(struct bladerf *dev,
                                   uint16_t cmd,
                                   uint64_t *data);
 
+/**
+ * Read RFIC command, allowing an extended time for the response
+ *
+ * @param       dev         Device handle
+ * @param[in]   cmd         Command
+ * @param[in]   timeout_ms  Time to allow for the response, in milliseconds
+ * @param[out]  data        Data
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_legacy_rfic_command_wait(struct bladerf *dev,
+                                  uint16_t cmd,
+                                  unsigned int timeout_ms,
+                                  uint64_t *data);
+
 /**
  * Write RFIC command
  *
@@ -289,6 +434,183 @@ int nios_legacy_rffe_fastlock_save(struct bladerf *dev, bool is_tx,
                                    uint8_t rffe_profile,
                                    uint16_t nios_profile);
 
+/**
+ * Read a fast lock profile's data from the Nios.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_rffe_fastlock_read(struct bladerf *dev, bool is_tx,
+                                   uint8_t nios_profile, uint8_t *data);
+
+/**
+ * Write a fast lock profile's data to the Nios.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_rffe_fastlock_write(struct bladerf *dev, bool is_tx,
+                                    uint8_t rffe_profile, uint8_t nios_profile,
+                                    const uint8_t *data);
+
+/**
+ * Write the RX digital downconverter control register.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_rx_ddc_write(struct bladerf *dev, uint32_t value);
+
+/**
+ * Read the RX digital downconverter control register.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_rx_ddc_read(struct bladerf *dev, uint32_t *value);
+
+/**
+ * Write the TX digital upconverter control register.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_tx_duc_write(struct bladerf *dev, uint32_t value);
+
+/**
+ * Read the TX digital upconverter control register.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_tx_duc_read(struct bladerf *dev, uint32_t *value);
+
+/**
+ * Write an RX power detector register.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_rx_power_write(struct bladerf *dev,
+                               uint8_t addr,
+                               uint32_t value);
+
+/**
+ * Read an RX power detector register.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_rx_power_read(struct bladerf *dev,
+                              uint8_t addr,
+                              uint32_t *value);
+
+/**
+ * Write an RX burst gate register.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_rx_burst_write(struct bladerf *dev,
+                               uint8_t addr,
+                               uint32_t value);
+
+/**
+ * Read an RX burst gate register.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_rx_burst_read(struct bladerf *dev,
+                              uint8_t addr,
+                              uint32_t *value);
+
+/**
+ * Write a sample FIFO level monitor register.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_fifo_level_write(struct bladerf *dev,
+                                 uint8_t addr,
+                                 uint32_t value);
+
+/**
+ * Read a sample FIFO level monitor register.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_fifo_level_read(struct bladerf *dev,
+                                uint8_t addr,
+                                uint32_t *value);
+
+/**
+ * Write a TX waveform loop register.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_tx_loop_write(struct bladerf *dev,
+                              uint8_t addr,
+                              uint32_t value);
+
+/**
+ * Read a TX waveform loop register.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_tx_loop_read(struct bladerf *dev,
+                             uint8_t addr,
+                             uint32_t *value);
+
+/**
+ * Write a VCTCXO tamer trim state register.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_vctcxo_tamer_write(struct bladerf *dev,
+                                   uint8_t addr,
+                                   uint32_t value);
+
+/**
+ * Read a VCTCXO tamer trim state register.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_vctcxo_tamer_read(struct bladerf *dev,
+                                  uint8_t addr,
+                                  uint32_t *value);
+
+/**
+ * Read measurements of the most recent FPGA retune.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_get_retune_stats(struct bladerf *dev, bladerf_channel ch,
+                                 struct bladerf_retune_stats *stats);
+
 /**
  * Write to the AD56X1 VCTCXO trim DAC.
  *
@@ -485,4 +807,29 @@ int nios_legacy_write_trigger(struct bladerf *dev,
                               bladerf_trigger_signal trigger,
                               uint8_t value);
 
+/**
+ * Schedule a trigger fire.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_trigger_fire_at(struct bladerf *dev,
+                                bladerf_channel ch,
+                                bladerf_trigger_signal trigger,
+                                uint64_t timestamp);
+
+/**
+ * Read the time at which a trigger fired.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_trigger_fire_time(struct bladerf *dev,
+                                  bladerf_channel ch,
+                                  bladerf_trigger_signal trigger,
+                                  bool *fired,
+                                  uint64_t *timestamp);
+
 #endif
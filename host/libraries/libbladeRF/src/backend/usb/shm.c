@@ -0,0 +1,1043 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* USB driver for devices served by another process. See shm_server.c.
+ *
+ * Transfers are forwarded to the server through the segment's mailbox, such
+ * that the usb backend's NIOS II, flash and FPGA code runs unmodified. Stream
+ * buffers are copied from and to the segment's rings. */
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <libbladeRF.h>
+
+#include "log.h"
+#include "minmax.h"
+
+#include "backend/backend.h"
+#include "backend/usb/shm.h"
+#include "backend/usb/usb.h"
+#include "devinfo.h"
+#include "streaming/async.h"
+
+#include "nios_pkt_formats.h"
+
+/* Returned by the ring accessors when the stream is being shut down */
+#define SHM_STREAM_STOPPED 1
+
+struct shm_dev {
+    int fd;
+    struct shm_header *hdr;
+    size_t size;
+    int32_t client;
+
+    /* NIOS II requests are held until their response is read, and then
+     * forwarded as a single transaction */
+    bool nios_pending;
+    uint8_t nios_req[NIOS_PKT_LEN];
+    uint32_t nios_timeout_ms;
+};
+
+struct shm_stream_data {
+    /* Buffers submitted by the stream's callback, in order */
+    void **buf;
+    size_t *len;
+    size_t num_transfers;
+    size_t num_avail;
+    size_t head;
+    size_t count;
+
+    pthread_cond_t work;
+
+    /* RX: Index of the slot being read, and the offset into it */
+    uint64_t rx_idx;
+    size_t rx_off;
+};
+
+/******************************************************************************/
+/* Segment access */
+/******************************************************************************/
+
+static void shm_unmap(int fd, struct shm_header *hdr, size_t size)
+{
+    munmap(hdr, size);
+    close(fd);
+}
+
+/* Map a server's segment, if the server is running */
+static int shm_map(const char *name,
+                   int *fd_out,
+                   struct shm_header **hdr_out,
+                   size_t *size_out)
+{
+    struct shm_header *hdr;
+    struct stat st;
+    int fd;
+
+    fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        log_verbose("Could not open %s: %s\n", name, strerror(errno));
+        return BLADERF_ERR_NODEV;
+    }
+
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(*hdr)) {
+        close(fd);
+        return BLADERF_ERR_NODEV;
+    }
+
+    hdr = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+               fd, 0);
+    if (hdr == MAP_FAILED) {
+        log_debug("Could not map %s: %s\n", name, strerror(errno));
+        close(fd);
+        return BLADERF_ERR_NODEV;
+    }
+
+    if (hdr->magic != SHM_MAGIC || hdr->version != SHM_VERSION ||
+        hdr->size != (uint64_t)st.st_size || !shm_server_alive(hdr)) {
+        log_verbose("Ignoring %s, whose server is not running\n", name);
+        shm_unmap(fd, hdr, (size_t)st.st_size);
+        return BLADERF_ERR_NODEV;
+    }
+
+    *fd_out   = fd;
+    *hdr_out  = hdr;
+    *size_out = (size_t)st.st_size;
+    return 0;
+}
+
+/* Invoke fn on each running server's segment, until it returns nonzero.
+ * Segments are numbered as device instances. */
+static int shm_foreach(int (*fn)(int fd,
+                                 struct shm_header *hdr,
+                                 size_t size,
+                                 unsigned int instance,
+                                 void *arg),
+                       void *arg)
+{
+    const size_t prefix_len = strlen(SHM_NAME_PREFIX) - 1;
+    char name[SHM_NAME_MAX + 1];
+    unsigned int instance = 0;
+    struct dirent *ent;
+    DIR *dir;
+    int status = 0;
+
+    dir = opendir(SHM_DIR);
+    if (dir == NULL) {
+        return 0;
+    }
+
+    while (status == 0 && (ent = readdir(dir)) != NULL) {
+        struct shm_header *hdr;
+        size_t size;
+        int fd;
+
+        if (strncmp(ent->d_name, SHM_NAME_PREFIX + 1, prefix_len) != 0 ||
+            strlen(ent->d_name) >= sizeof(name) - 1) {
+            continue;
+        }
+
+        name[0] = '/';
+        strcpy(name + 1, ent->d_name);
+
+        if (shm_map(name, &fd, &hdr, &size) == 0) {
+            status = fn(fd, hdr, size, instance++, arg);
+        }
+    }
+
+    closedir(dir);
+    return status;
+}
+
+static void shm_devinfo(struct shm_header *hdr,
+                        unsigned int instance,
+                        struct bladerf_devinfo *info)
+{
+    memcpy(info, &hdr->devinfo, sizeof(*info));
+    info->backend  = BLADERF_BACKEND_SHM;
+    info->instance = instance;
+}
+
+/* Perform a request via the server's mailbox. args->len bytes of tx are
+ * sent with the request, and up to rx_len bytes of its response are
+ * copied to rx. */
+static int shm_request(struct shm_dev *d,
+                       struct shm_args *args,
+                       const void *tx,
+                       void *rx,
+                       uint32_t rx_len)
+{
+    struct shm_header *hdr = d->hdr;
+    struct shm_ctrl *ctrl  = &hdr->ctrl;
+    uint32_t seq;
+    int status;
+
+    args->client = d->client;
+
+    shm_lock(&ctrl->lock);
+
+    while (ctrl->busy && shm_server_alive(hdr)) {
+        if (!shm_pid_alive(ctrl->owner_pid)) {
+            ctrl->busy = 0;
+            break;
+        }
+
+        shm_wait(&ctrl->response, &ctrl->lock, SHM_WAIT_SLICE_MS);
+    }
+
+    if (!shm_server_alive(hdr)) {
+        shm_unlock(&ctrl->lock);
+        log_debug("The device server has stopped\n");
+        return BLADERF_ERR_IO;
+    }
+
+    ctrl->busy      = 1;
+    ctrl->owner_pid = (int32_t)getpid();
+    ctrl->args      = *args;
+
+    if (tx != NULL) {
+        memcpy(ctrl->data, tx, args->len);
+    }
+
+    seq = ++ctrl->req_seq;
+    pthread_cond_signal(&ctrl->request);
+
+    while (ctrl->done_seq != seq) {
+        if (!shm_server_alive(hdr)) {
+            log_debug("The device server stopped during a request\n");
+            status = BLADERF_ERR_IO;
+            goto out;
+        }
+
+        shm_wait(&ctrl->response, &ctrl->lock, SHM_WAIT_SLICE_MS);
+    }
+
+    status = ctrl->status;
+
+    if (rx != NULL) {
+        memcpy(rx, ctrl->data, u32_min(rx_len, ctrl->actual_len));
+    }
+
+out:
+    ctrl->busy      = 0;
+    ctrl->owner_pid = 0;
+    pthread_cond_broadcast(&ctrl->response);
+    shm_unlock(&ctrl->lock);
+
+    return status;
+}
+
+/* Send a NIOS II request that is not followed by a read of its response */
+static int shm_flush_nios(struct shm_dev *d)
+{
+    struct shm_args args;
+
+    if (!d->nios_pending) {
+        return 0;
+    }
+
+    d->nios_pending = false;
+
+    memset(&args, 0, sizeof(args));
+    args.op         = SHM_OP_BULK;
+    args.endpoint   = PERIPHERAL_EP_OUT;
+    args.len        = NIOS_PKT_LEN;
+    args.timeout_ms = d->nios_timeout_ms;
+
+    return shm_request(d, &args, d->nios_req, NULL, 0);
+}
+
+/******************************************************************************/
+/* Device operations */
+/******************************************************************************/
+
+static int probe_one(int fd,
+                     struct shm_header *hdr,
+                     size_t size,
+                     unsigned int instance,
+                     void *arg)
+{
+    struct bladerf_devinfo_list *info_list = arg;
+    struct bladerf_devinfo info;
+    int status;
+
+    shm_devinfo(hdr, instance, &info);
+    shm_unmap(fd, hdr, size);
+
+    status = bladerf_devinfo_list_add(info_list, &info);
+    if (status != 0) {
+        log_error("Could not add device to list: %s\n",
+                  bladerf_strerror(status));
+    }
+
+    return status;
+}
+
+static int shm_usb_probe(backend_probe_target probe_target,
+                         struct bladerf_devinfo_list *info_list)
+{
+    if (probe_target != BACKEND_PROBE_BLADERF) {
+        return 0;
+    }
+
+    return shm_foreach(probe_one, info_list);
+}
+
+struct open_args {
+    struct bladerf_devinfo *info_in;
+    struct bladerf_devinfo *info_out;
+    struct shm_dev *d;
+};
+
+static int open_one(int fd,
+                    struct shm_header *hdr,
+                    size_t size,
+                    unsigned int instance,
+                    void *arg)
+{
+    struct open_args *o = arg;
+    struct bladerf_devinfo info;
+
+    shm_devinfo(hdr, instance, &info);
+
+    if (!bladerf_devinfo_matches(&info, o->info_in)) {
+        shm_unmap(fd, hdr, size);
+        return 0;
+    }
+
+    o->d->fd   = fd;
+    o->d->hdr  = hdr;
+    o->d->size = size;
+    memcpy(o->info_out, &info, sizeof(info));
+
+    return 1;
+}
+
+static int shm_usb_open(void **driver,
+                        struct bladerf_devinfo *info_in,
+                        struct bladerf_devinfo *info_out)
+{
+    struct shm_dev *d;
+    struct open_args o;
+    struct shm_args args;
+    int status;
+
+    d = calloc(1, sizeof(*d));
+    if (d == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    o.info_in  = info_in;
+    o.info_out = info_out;
+    o.d        = d;
+
+    if (shm_foreach(open_one, &o) == 0) {
+        free(d);
+        return BLADERF_ERR_NODEV;
+    }
+
+    memset(&args, 0, sizeof(args));
+    args.op = SHM_OP_ATTACH;
+
+    status = shm_request(d, &args, NULL, &d->client, sizeof(d->client));
+    if (status != 0) {
+        log_debug("Failed to attach to the device server: %s\n",
+                  bladerf_strerror(status));
+        shm_unmap(d->fd, d->hdr, d->size);
+        free(d);
+        return status;
+    }
+
+    log_debug("Attached to the server of device %s as client %d\n",
+              info_out->serial, d->client);
+
+    *driver = d;
+    return 0;
+}
+
+static void shm_usb_close(void *driver)
+{
+    struct shm_dev *d = driver;
+    struct shm_args args;
+
+    shm_flush_nios(d);
+
+    memset(&args, 0, sizeof(args));
+    args.op = SHM_OP_DETACH;
+    shm_request(d, &args, NULL, NULL, 0);
+
+    shm_unmap(d->fd, d->hdr, d->size);
+    free(d);
+}
+
+static int shm_usb_get_vid_pid(void *driver, uint16_t *vid, uint16_t *pid)
+{
+    struct shm_dev *d = driver;
+
+    *vid = d->hdr->vid;
+    *pid = d->hdr->pid;
+    return 0;
+}
+
+static int shm_usb_get_flash_id(void *driver, uint8_t *mid, uint8_t *did)
+{
+    struct shm_dev *d = driver;
+
+    *mid = d->hdr->flash_mid;
+    *did = d->hdr->flash_did;
+    return 0;
+}
+
+static int shm_usb_get_handle(void *driver, void **handle)
+{
+    /* The underlying handle belongs to the server */
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int shm_usb_get_speed(void *driver, bladerf_dev_speed *speed)
+{
+    struct shm_dev *d = driver;
+
+    *speed = (bladerf_dev_speed)d->hdr->speed;
+    return 0;
+}
+
+static int shm_usb_change_setting(void *driver, uint8_t setting)
+{
+    struct shm_dev *d = driver;
+    struct shm_args args;
+    int status;
+
+    status = shm_flush_nios(d);
+    if (status != 0) {
+        return status;
+    }
+
+    memset(&args, 0, sizeof(args));
+    args.op      = SHM_OP_CHANGE_SETTING;
+    args.setting = setting;
+
+    return shm_request(d, &args, NULL, NULL, 0);
+}
+
+static int shm_usb_control_transfer(void *driver,
+                                    usb_target target_type,
+                                    usb_request req_type,
+                                    usb_direction dir,
+                                    uint8_t request,
+                                    uint16_t wvalue,
+                                    uint16_t windex,
+                                    void *buffer,
+                                    uint32_t buffer_len,
+                                    uint32_t timeout_ms)
+{
+    struct shm_dev *d = driver;
+    struct shm_args args;
+    int status;
+
+    if (buffer_len > SHM_CTRL_DATA_SIZE) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    status = shm_flush_nios(d);
+    if (status != 0) {
+        return status;
+    }
+
+    memset(&args, 0, sizeof(args));
+    args.op         = SHM_OP_CONTROL;
+    args.target     = (uint8_t)target_type;
+    args.req_type   = (uint8_t)req_type;
+    args.dir        = (uint8_t)dir;
+    args.request    = request;
+    args.wvalue     = wvalue;
+    args.windex     = windex;
+    args.len        = buffer_len;
+    args.timeout_ms = timeout_ms;
+
+    if (dir == USB_DIR_HOST_TO_DEVICE) {
+        return shm_request(d, &args, buffer, NULL, 0);
+    } else {
+        return shm_request(d, &args, NULL, buffer, buffer_len);
+    }
+}
+
+static int shm_usb_bulk_transfer(void *driver,
+                                 uint8_t endpoint,
+                                 void *buffer,
+                                 uint32_t buffer_len,
+                                 uint32_t timeout_ms)
+{
+    struct shm_dev *d    = driver;
+    const bool is_in     = (endpoint & USB_DIR_DEVICE_TO_HOST) != 0;
+    uint8_t *buf         = buffer;
+    struct shm_args args;
+    uint32_t off;
+    int status;
+
+    if (endpoint == PERIPHERAL_EP_OUT && buffer_len == NIOS_PKT_LEN &&
+        !d->nios_pending) {
+        memcpy(d->nios_req, buffer, NIOS_PKT_LEN);
+        d->nios_timeout_ms = timeout_ms;
+        d->nios_pending    = true;
+        return 0;
+    }
+
+    memset(&args, 0, sizeof(args));
+
+    if (endpoint == PERIPHERAL_EP_IN && buffer_len == NIOS_PKT_LEN &&
+        d->nios_pending) {
+        d->nios_pending = false;
+
+        args.op         = SHM_OP_NIOS;
+        args.len        = NIOS_PKT_LEN;
+        args.timeout_ms = u32_max(timeout_ms, d->nios_timeout_ms);
+
+        return shm_request(d, &args, d->nios_req, buffer, buffer_len);
+    }
+
+    status = shm_flush_nios(d);
+    if (status != 0) {
+        return status;
+    }
+
+    /* Split the transfer into pieces that fit in the mailbox. Each piece but
+     * the last is a multiple of the maximum packet size, so the device sees
+     * the same packets. */
+    args.op         = SHM_OP_BULK;
+    args.endpoint   = endpoint;
+    args.timeout_ms = timeout_ms;
+
+    for (off = 0, status = 0; off < buffer_len && status == 0;
+         off += args.len) {
+        args.len = u32_min(buffer_len - off, SHM_CTRL_DATA_SIZE);
+
+        if (is_in) {
+            status = shm_request(d, &args, NULL, buf + off, args.len);
+        } else {
+            status = shm_request(d, &args, buf + off, NULL, 0);
+        }
+    }
+
+    return status;
+}
+
+static int shm_usb_get_string_descriptor(void *driver,
+                                         uint8_t index,
+                                         void *buffer,
+                                         uint32_t buffer_len)
+{
+    struct shm_dev *d = driver;
+    struct shm_args args;
+    int status;
+
+    if (buffer_len > SHM_CTRL_DATA_SIZE) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    status = shm_flush_nios(d);
+    if (status != 0) {
+        return status;
+    }
+
+    memset(&args, 0, sizeof(args));
+    args.op      = SHM_OP_STRING_DESC;
+    args.request = index;
+    args.len     = buffer_len;
+
+    return shm_request(d, &args, NULL, buffer, buffer_len);
+}
+
+static int shm_usb_open_bootloader(void **driver, uint8_t bus, uint8_t addr)
+{
+    return BLADERF_ERR_NODEV;
+}
+
+static void shm_usb_close_bootloader(void *driver)
+{
+}
+
+/******************************************************************************/
+/* Streaming */
+/******************************************************************************/
+
+static int shm_usb_deinit_stream(void *driver, struct bladerf_stream *stream)
+{
+    struct shm_stream_data *sd = stream->backend_data;
+
+    if (sd == NULL) {
+        return 0;
+    }
+
+    pthread_cond_destroy(&sd->work);
+    free(sd->buf);
+    free(sd->len);
+    free(sd);
+
+    stream->backend_data = NULL;
+    return 0;
+}
+
+static int shm_usb_init_stream(void *driver,
+                               struct bladerf_stream *stream,
+                               size_t num_transfers)
+{
+    struct shm_stream_data *sd;
+
+    /* Buffers are carried as a byte stream, which loses the boundaries of
+     * variable-length packets */
+    if (stream->format == BLADERF_FORMAT_PACKET_META) {
+        log_debug("Served devices do not support the packet format\n");
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    sd = calloc(1, sizeof(*sd));
+    if (sd == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    sd->num_transfers = num_transfers;
+    sd->num_avail     = num_transfers;
+    sd->buf           = calloc(num_transfers, sizeof(sd->buf[0]));
+    sd->len           = calloc(num_transfers, sizeof(sd->len[0]));
+
+    if (sd->buf == NULL || sd->len == NULL ||
+        timeout_cond_init(&sd->work) != 0) {
+        free(sd->buf);
+        free(sd->len);
+        free(sd);
+        return BLADERF_ERR_MEM;
+    }
+
+    stream->backend_data = sd;
+    return 0;
+}
+
+/* Check whether a ring transfer should be abandoned */
+static int ring_check(struct shm_dev *d,
+                      struct shm_ring *ring,
+                      struct bladerf_stream *stream)
+{
+    if (stream->state != STREAM_RUNNING) {
+        return SHM_STREAM_STOPPED;
+    }
+
+    if (!shm_server_alive(d->hdr)) {
+        log_debug("The device server has stopped\n");
+        return BLADERF_ERR_IO;
+    }
+
+    if (!atomic_load(&ring->running)) {
+        return (ring->error != 0) ? ring->error : BLADERF_ERR_IO;
+    }
+
+    return 0;
+}
+
+/* Copy the next len bytes received by the server into buf. Whenever the
+ * server overtakes the reader, the buffer restarts at the newest data. */
+static int ring_read(struct shm_dev *d,
+                     struct shm_stream_data *sd,
+                     struct bladerf_stream *stream,
+                     uint8_t *buf,
+                     size_t len,
+                     unsigned int *overruns)
+{
+    struct shm_header *hdr = d->hdr;
+    struct shm_ring *ring  = &hdr->rx;
+    size_t off             = 0;
+    int status;
+
+    while (off < len) {
+        _Atomic uint64_t *seq;
+        size_t slot_len, n;
+
+        status = ring_check(d, ring, stream);
+        if (status != 0) {
+            return status;
+        }
+
+        if (atomic_load(&ring->head) == sd->rx_idx) {
+            shm_lock(&ring->lock);
+            if (atomic_load(&ring->head) == sd->rx_idx) {
+                shm_wait(&ring->cond, &ring->lock, SHM_WAIT_SLICE_MS);
+            }
+            shm_unlock(&ring->lock);
+            continue;
+        }
+
+        seq      = shm_slot_seq(hdr, ring, sd->rx_idx);
+        slot_len = *shm_slot_len(hdr, ring, sd->rx_idx);
+
+        if (atomic_load(seq) == sd->rx_idx + 1) {
+            n = min_sz(len - off, slot_len - sd->rx_off);
+            memcpy(buf + off, shm_slot(hdr, ring, sd->rx_idx) + sd->rx_off, n);
+
+            /* Complete the copy before confirming the slot wasn't reused */
+            atomic_thread_fence(memory_order_acquire);
+
+            if (atomic_load_explicit(seq, memory_order_relaxed) ==
+                sd->rx_idx + 1) {
+                off += n;
+                sd->rx_off += n;
+
+                if (sd->rx_off >= slot_len) {
+                    sd->rx_idx++;
+                    sd->rx_off = 0;
+                }
+                continue;
+            }
+        }
+
+        log_debug("Overrun of the served RX ring at slot %" PRIu64 "\n",
+                  sd->rx_idx);
+
+        (*overruns)++;
+        sd->rx_idx = atomic_load(&ring->head);
+        sd->rx_off = 0;
+        off        = 0;
+    }
+
+    return 0;
+}
+
+/* Write a buffer to the next slot of the TX ring, waiting for one to be
+ * free */
+static int ring_write(struct shm_dev *d,
+                      struct bladerf_stream *stream,
+                      const uint8_t *buf,
+                      size_t len)
+{
+    struct shm_header *hdr = d->hdr;
+    struct shm_ring *ring  = &hdr->tx;
+    const uint64_t head    = atomic_load(&ring->head);
+    int status;
+
+    while (head - atomic_load(&ring->tail) >= ring->num_slots) {
+        status = ring_check(d, ring, stream);
+        if (status != 0) {
+            return status;
+        }
+
+        shm_lock(&ring->lock);
+        if (head - atomic_load(&ring->tail) >= ring->num_slots) {
+            shm_wait(&ring->cond, &ring->lock, SHM_WAIT_SLICE_MS);
+        }
+        shm_unlock(&ring->lock);
+    }
+
+    memcpy(shm_slot(hdr, ring, head), buf, len);
+    *shm_slot_len(hdr, ring, head) = (uint32_t)len;
+    atomic_store(&ring->head, head + 1);
+    shm_ring_broadcast(ring);
+
+    return 0;
+}
+
+/* Wait for the server to transmit what has been written to the TX ring */
+static void ring_drain(struct shm_dev *d, unsigned int timeout_ms)
+{
+    struct shm_ring *ring = &d->hdr->tx;
+    const uint64_t head   = atomic_load(&ring->head);
+    unsigned int waited   = 0;
+
+    while (atomic_load(&ring->tail) != head && atomic_load(&ring->running) &&
+           shm_server_alive(d->hdr) && waited < timeout_ms) {
+        shm_lock(&ring->lock);
+        if (atomic_load(&ring->tail) != head) {
+            shm_wait(&ring->cond, &ring->lock, SHM_WAIT_SLICE_MS);
+        }
+        shm_unlock(&ring->lock);
+        waited += SHM_WAIT_SLICE_MS;
+    }
+}
+
+/* Precondition: A transfer is available, and stream->lock is held. */
+static void submit_transfer(struct bladerf_stream *stream,
+                            void *buffer,
+                            size_t len)
+{
+    struct shm_stream_data *sd = stream->backend_data;
+    const size_t i = (sd->head + sd->count) % sd->num_transfers;
+
+    sd->buf[i] = buffer;
+    sd->len[i] = len;
+    sd->count++;
+    sd->num_avail--;
+
+    pthread_cond_signal(&sd->work);
+}
+
+/* Return the head transfer to the available pool. stream->lock is held. */
+static void retire_transfer(struct bladerf_stream *stream)
+{
+    struct shm_stream_data *sd = stream->backend_data;
+
+    sd->head = (sd->head + 1) % sd->num_transfers;
+    sd->count--;
+    sd->num_avail++;
+    pthread_cond_signal(&stream->can_submit_buffer);
+}
+
+static int shm_usb_stream(void *driver,
+                          struct bladerf_stream *stream,
+                          bladerf_channel_layout layout)
+{
+    struct shm_dev *d          = driver;
+    struct shm_stream_data *sd = stream->backend_data;
+    struct bladerf *dev        = stream->dev;
+    const bool is_tx = (layout & BLADERF_DIRECTION_MASK) == BLADERF_TX;
+    const size_t buf_bytes     = async_stream_buf_bytes(stream);
+    struct bladerf_metadata metadata;
+    struct shm_args args;
+    struct timespec abs;
+    void *buffer;
+    size_t i;
+    int status;
+
+    if (is_tx && buf_bytes > d->hdr->tx.slot_size) {
+        log_debug("TX buffers of %zu bytes exceed the served slot size of "
+                  "%u bytes\n", buf_bytes, d->hdr->tx.slot_size);
+        return BLADERF_ERR_INVAL;
+    }
+
+    memset(&args, 0, sizeof(args));
+    args.op  = is_tx ? SHM_OP_TX_START : SHM_OP_RX_START;
+    args.len = (uint32_t)buf_bytes;
+
+    status = shm_request(d, &args, NULL, NULL, 0);
+    if (status != 0) {
+        return status;
+    }
+
+    /* Start at the next slot the server receives into */
+    sd->rx_idx = atomic_load(&d->hdr->rx.head);
+    sd->rx_off = 0;
+
+    /* Currently unused, so zero it out for a sanity check when debugging */
+    memset(&metadata, 0, sizeof(metadata));
+
+    MUTEX_LOCK(&stream->lock);
+
+    /* Set up initial set of buffers */
+    for (i = 0; i < sd->num_transfers; i++) {
+        if (is_tx) {
+            buffer = stream->cb(dev, stream, &metadata, NULL,
+                                stream->samples_per_buffer,
+                                stream->user_data);
+
+            if (buffer == BLADERF_STREAM_SHUTDOWN) {
+                stream->state = STREAM_SHUTTING_DOWN;
+                break;
+            }
+        } else {
+            buffer = stream->buffers[i];
+        }
+
+        if (buffer != BLADERF_STREAM_NO_DATA) {
+            submit_transfer(stream, buffer, buf_bytes);
+        }
+    }
+
+    while (stream->state != STREAM_DONE) {
+        unsigned int overruns = 0;
+        void *next_buffer;
+        uint8_t *buf;
+        size_t len;
+
+        if (stream->state == STREAM_SHUTTING_DOWN) {
+            /* "Cancel" everything not yet copied */
+            while (sd->count != 0) {
+                retire_transfer(stream);
+            }
+
+            stream->state = STREAM_DONE;
+            break;
+        }
+
+        if (sd->count == 0) {
+            if (populate_abs_timeout(&abs, SHM_WAIT_SLICE_MS) == 0) {
+                pthread_cond_timedwait(&sd->work, &stream->lock, &abs);
+            }
+            continue;
+        }
+
+        buf = sd->buf[sd->head];
+        len = sd->len[sd->head];
+
+        /* The transfer belongs to us until it is retired, so its contents may
+         * be produced or consumed without holding the lock. */
+        MUTEX_UNLOCK(&stream->lock);
+
+        if (is_tx) {
+            status = ring_write(d, stream, buf, len);
+        } else {
+            status = ring_read(d, sd, stream, buf, len, &overruns);
+        }
+
+        MUTEX_LOCK(&stream->lock);
+
+        stream->stats.overruns += overruns;
+
+        if (status == SHM_STREAM_STOPPED) {
+            continue;
+        } else if (status != 0) {
+            stream->error_code = status;
+            stream->state      = STREAM_SHUTTING_DOWN;
+            continue;
+        }
+
+        retire_transfer(stream);
+        async_stats_transfer(stream, len, len);
+
+        if (!is_tx) {
+            async_rx_metadata(stream, buf,
+                              bytes_to_samples(stream->format, len),
+                              &metadata);
+        }
+
+        {
+            const uint64_t cb_start = wallclock_get_current_nsec();
+
+            next_buffer =
+                stream->cb(dev, stream, &metadata, buf,
+                           bytes_to_samples(stream->format, len),
+                           stream->user_data);
+
+            async_stats_callback(stream, cb_start);
+        }
+
+        if (next_buffer == BLADERF_STREAM_SHUTDOWN) {
+            stream->state = STREAM_SHUTTING_DOWN;
+        } else if (next_buffer != BLADERF_STREAM_NO_DATA) {
+            submit_transfer(stream, next_buffer, buf_bytes);
+        }
+    }
+
+    MUTEX_UNLOCK(&stream->lock);
+
+    if (is_tx) {
+        ring_drain(d, (stream->transfer_timeout != 0) ? stream->transfer_timeout
+                                                      : BULK_TIMEOUT_MS);
+    }
+
+    memset(&args, 0, sizeof(args));
+    args.op = is_tx ? SHM_OP_TX_STOP : SHM_OP_RX_STOP;
+    shm_request(d, &args, NULL, NULL, 0);
+
+    return 0;
+}
+
+/* The top-level code will have aquired the stream->lock for us */
+static int shm_usb_submit_stream_buffer(void *driver,
+                                        struct bladerf_stream *stream,
+                                        void *buffer,
+                                        size_t *length,
+                                        unsigned int timeout_ms,
+                                        bool nonblock)
+{
+    int status = 0;
+    struct shm_stream_data *sd = stream->backend_data;
+    struct timespec timeout_abs;
+
+    if (buffer == BLADERF_STREAM_SHUTDOWN) {
+        if (sd->num_avail == sd->num_transfers) {
+            stream->state = STREAM_DONE;
+        } else {
+            stream->state = STREAM_SHUTTING_DOWN;
+        }
+
+        pthread_cond_signal(&sd->work);
+        return 0;
+    }
+
+    if (sd->num_avail == 0) {
+        if (nonblock) {
+            log_debug("Non-blocking buffer submission requested, but no "
+                      "transfers are currently available.\n");
+
+            return BLADERF_ERR_WOULD_BLOCK;
+        }
+
+        if (timeout_ms != 0) {
+            status = populate_abs_timeout(&timeout_abs, timeout_ms);
+            if (status != 0) {
+                return BLADERF_ERR_UNEXPECTED;
+            }
+
+            while (sd->num_avail == 0 && status == 0) {
+                status = pthread_cond_timedwait(&stream->can_submit_buffer,
+                                                &stream->lock, &timeout_abs);
+            }
+        } else {
+            while (sd->num_avail == 0 && status == 0) {
+                status = pthread_cond_wait(&stream->can_submit_buffer,
+                                           &stream->lock);
+            }
+        }
+    }
+
+    if (status == ETIMEDOUT) {
+        log_debug("%s: Timed out waiting for a transfer to become available.\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_TIMEOUT;
+    } else if (status != 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    submit_transfer(stream, buffer, *length);
+    return 0;
+}
+
+static const struct usb_fns shm_fns = {
+    FIELD_INIT(.probe, shm_usb_probe),
+    FIELD_INIT(.set_device_monitor, NULL),
+    FIELD_INIT(.open, shm_usb_open),
+    FIELD_INIT(.close, shm_usb_close),
+    FIELD_INIT(.get_vid_pid, shm_usb_get_vid_pid),
+    FIELD_INIT(.get_flash_id, shm_usb_get_flash_id),
+    FIELD_INIT(.get_handle, shm_usb_get_handle),
+    FIELD_INIT(.get_speed, shm_usb_get_speed),
+    FIELD_INIT(.change_setting, shm_usb_change_setting),
+    FIELD_INIT(.control_transfer, shm_usb_control_transfer),
+    FIELD_INIT(.bulk_transfer, shm_usb_bulk_transfer),
+    FIELD_INIT(.get_string_descriptor, shm_usb_get_string_descriptor),
+    FIELD_INIT(.init_stream, shm_usb_init_stream),
+    FIELD_INIT(.stream, shm_usb_stream),
+    FIELD_INIT(.submit_stream_buffer, shm_usb_submit_stream_buffer),
+    FIELD_INIT(.deinit_stream, shm_usb_deinit_stream),
+    FIELD_INIT(.open_bootloader, shm_usb_open_bootloader),
+    FIELD_INIT(.close_bootloader, shm_usb_close_bootloader),
+    FIELD_INIT(.dev_mem_alloc, NULL),
+    FIELD_INIT(.dev_mem_free, NULL),
+};
+
+const struct usb_driver usb_driver_shm = {
+    FIELD_INIT(.fn, &shm_fns),
+    FIELD_INIT(.id, BLADERF_BACKEND_SHM),
+};
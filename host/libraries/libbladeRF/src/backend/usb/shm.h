@@ -0,0 +1,256 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Layout of the POSIX shared memory segment through which a device server
+ * (shm_server.c) shares a device with client processes (shm.c).
+ *
+ * The segment is named SHM_NAME_PREFIX followed by the device's serial
+ * number. It begins with a struct shm_header, which is followed by the
+ * per-slot sequence numbers and lengths of each ring, and then by the slots
+ * themselves.
+ *
+ * Control traffic passes through a single mailbox: a client claims it,
+ * writes a request, and waits for the server to complete it. RX samples are
+ * received by the server directly into the RX ring's slots, which any number
+ * of clients read concurrently. TX samples are written to the TX ring's slots
+ * by a single client, and are submitted from there by the server.
+ *
+ * Ring indices are monotonically increasing counts of slots, accessed with
+ * C11 atomics. The process-shared mutex and condition variable of each ring
+ * are only used to sleep while waiting on the indices. */
+
+#ifndef BACKEND_USB_SHM_H_
+#define BACKEND_USB_SHM_H_
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/types.h>
+
+#include <libbladeRF.h>
+
+#include "helpers/timeout.h"
+
+#define SHM_MAGIC   0x62524653 /* "bRFS" */
+#define SHM_VERSION 1
+
+/* Segment names are SHM_NAME_PREFIX<serial>. Linux exposes them in
+ * SHM_DIR, without the leading '/', which is how clients enumerate them. */
+#define SHM_NAME_PREFIX "/bladerf-shm-"
+#define SHM_NAME_MAX    (sizeof(SHM_NAME_PREFIX) + BLADERF_SERIAL_LENGTH)
+#define SHM_DIR         "/dev/shm"
+
+/* Size of the mailbox's data area. Longer bulk transfers are split. */
+#define SHM_CTRL_DATA_SIZE 65536
+
+/* Processes waiting on the other side of the segment wake up at least this
+ * often, to check that their peer is still alive. */
+#define SHM_WAIT_SLICE_MS 100
+
+/* Slot sizes must be a multiple of this many bytes, which is an async stream
+ * buffer granularity's worth of SC16 Q11 samples. */
+#define SHM_SLOT_GRANULARITY 4096
+
+/* Number of client handles a server accepts at once */
+#define SHM_CLIENTS_MAX 16
+
+typedef enum {
+    SHM_OP_ATTACH,         /* Register a client. Returns its ID. */
+    SHM_OP_DETACH,         /* Release a client's resources */
+    SHM_OP_CONTROL,        /* USB control transfer */
+    SHM_OP_BULK,           /* USB bulk transfer */
+    SHM_OP_NIOS,           /* NIOS II request, followed by its response */
+    SHM_OP_STRING_DESC,    /* String descriptor query */
+    SHM_OP_CHANGE_SETTING, /* USB alternate setting change */
+    SHM_OP_RX_START,       /* Start (or share) the RX stream */
+    SHM_OP_RX_STOP,        /* Stop sharing the RX stream */
+    SHM_OP_TX_START,       /* Take ownership of the TX stream */
+    SHM_OP_TX_STOP,        /* Release ownership of the TX stream */
+} shm_op;
+
+/* Arguments of a mailbox request */
+struct shm_args {
+    int32_t client;
+    int32_t op;
+    uint8_t target;
+    uint8_t req_type;
+    uint8_t dir;
+    uint8_t request;
+    uint8_t endpoint;
+    uint8_t setting;
+    uint16_t wvalue;
+    uint16_t windex;
+    uint32_t len;
+    uint32_t timeout_ms;
+};
+
+struct shm_ctrl {
+    pthread_mutex_t lock;
+    pthread_cond_t request;  /* Signaled when req_seq advances */
+    pthread_cond_t response; /* Broadcast when done_seq advances, and when
+                              * the mailbox is released */
+
+    /* A client holds the mailbox from posting its request until it has read
+     * the response. owner_pid allows a dead holder to be detected. */
+    int32_t busy;
+    int32_t owner_pid;
+
+    uint32_t req_seq;
+    uint32_t done_seq;
+
+    struct shm_args args;
+    int32_t status;
+    uint32_t actual_len;
+    uint8_t data[SHM_CTRL_DATA_SIZE];
+};
+
+struct shm_ring {
+    uint32_t num_slots;
+    uint32_t slot_size;
+    uint64_t seq_offset;  /* Offset of the per-slot sequence numbers */
+    uint64_t len_offset;  /* Offset of the per-slot lengths */
+    uint64_t data_offset; /* Offset of the first slot */
+
+    /* RX: slots filled by the server. TX: slots filled by the client. */
+    _Atomic uint64_t head;
+
+    /* TX: slots transmitted by the server. Unused for RX. */
+    _Atomic uint64_t tail;
+
+    /* Whether the server's stream is running, and why it last stopped */
+    _Atomic int32_t running;
+    int32_t error;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond; /* Broadcast whenever head or tail advance */
+};
+
+struct shm_header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t size;
+    int32_t server_pid;
+    _Atomic int32_t running;
+
+    /* Details of the served device, reported to clients as-is */
+    struct bladerf_devinfo devinfo;
+    uint16_t vid;
+    uint16_t pid;
+    uint8_t flash_mid;
+    uint8_t flash_did;
+    int32_t speed;
+
+    struct shm_ctrl ctrl;
+    struct shm_ring rx;
+    struct shm_ring tx;
+};
+
+/* The sequence number of a slot is one more than the monotonic index of the
+ * contents it holds, or 0 while it is being filled. RX readers compare it
+ * before and after copying a slot, to detect the server reusing it. */
+static inline _Atomic uint64_t *shm_slot_seq(struct shm_header *hdr,
+                                             struct shm_ring *ring,
+                                             uint64_t idx)
+{
+    _Atomic uint64_t *seq =
+        (_Atomic uint64_t *)((uint8_t *)hdr + ring->seq_offset);
+    return &seq[idx % ring->num_slots];
+}
+
+static inline uint32_t *shm_slot_len(struct shm_header *hdr,
+                                     struct shm_ring *ring,
+                                     uint64_t idx)
+{
+    uint32_t *len = (uint32_t *)((uint8_t *)hdr + ring->len_offset);
+    return &len[idx % ring->num_slots];
+}
+
+static inline uint8_t *shm_slot(struct shm_header *hdr,
+                                struct shm_ring *ring,
+                                uint64_t idx)
+{
+    return (uint8_t *)hdr + ring->data_offset +
+           (idx % ring->num_slots) * (uint64_t)ring->slot_size;
+}
+
+static inline void shm_name(char *name, const char *serial)
+{
+    snprintf(name, SHM_NAME_MAX, "%s%s", SHM_NAME_PREFIX, serial);
+}
+
+static inline bool shm_pid_alive(pid_t pid)
+{
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+static inline bool shm_server_alive(struct shm_header *hdr)
+{
+    return atomic_load(&hdr->running) && shm_pid_alive(hdr->server_pid);
+}
+
+/* Lock a process-shared mutex, recovering it if its holder died. The state
+ * it protects is consistent between any two of its holder's operations. */
+static inline void shm_lock(pthread_mutex_t *m)
+{
+    if (pthread_mutex_lock(m) == EOWNERDEAD) {
+        pthread_mutex_consistent(m);
+    }
+}
+
+static inline void shm_unlock(pthread_mutex_t *m)
+{
+    pthread_mutex_unlock(m);
+}
+
+static inline void shm_ring_broadcast(struct shm_ring *ring)
+{
+    shm_lock(&ring->lock);
+    pthread_cond_broadcast(&ring->cond);
+    shm_unlock(&ring->lock);
+}
+
+/* Wait on a process-shared condition variable for up to timeout_ms.
+ * Returns ETIMEDOUT once the time has elapsed. */
+static inline int shm_wait(pthread_cond_t *c,
+                           pthread_mutex_t *m,
+                           unsigned int timeout_ms)
+{
+    struct timespec abs;
+    int status;
+
+    if (populate_abs_timeout(&abs, timeout_ms) != 0) {
+        return EINVAL;
+    }
+
+    status = pthread_cond_timedwait(c, m, &abs);
+    if (status == EOWNERDEAD) {
+        pthread_mutex_consistent(m);
+        status = 0;
+    }
+
+    return status;
+}
+
+#endif
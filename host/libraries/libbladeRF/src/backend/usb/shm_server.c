@@ -0,0 +1,991 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Device server for the shared-memory USB driver (shm.c)
+ *
+ * A thread services the control mailbox, performing clients' transfers on
+ * the served device's own USB driver while holding the device's handle lock.
+ * RX and TX are serviced by async streams on the served device, whose
+ * buffers are the slots of the segment's rings. */
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <libbladeRF.h>
+
+#include "host_config.h"
+#include "log.h"
+#include "minmax.h"
+
+#include "backend/usb/shm.h"
+#include "backend/usb/shm_server.h"
+#include "backend/usb/usb.h"
+#include "board/board.h"
+#include "streaming/async.h"
+#include "streaming/format.h"
+
+#include "bladeRF.h"
+
+struct shm_client {
+    bool in_use;
+    pid_t pid;
+    bool enabled[2];   /* RF module enabled, indexed by direction */
+    bool streaming[2]; /* Stream in use, indexed by direction */
+};
+
+struct shm_stream {
+    struct shm_ring *ring;
+    struct bladerf_stream *stream;
+    pthread_t thread;
+    bladerf_direction dir;
+
+    /* RX: Index of the slot that the next buffer returned to the stream
+     * will fill. TX: Index of the next slot to submit. */
+    uint64_t next;
+
+    /* TX: Thread submitting the slots written by the client */
+    pthread_t feeder;
+    _Atomic bool stop;
+};
+
+struct shm_server {
+    struct bladerf *dev;
+    struct bladerf_usb *usb;
+
+    char name[SHM_NAME_MAX];
+    int fd;
+    struct shm_header *hdr;
+    size_t size;
+
+    pthread_t ctrl_thread;
+    _Atomic bool stop;
+
+    /* Alternate setting last selected on behalf of a client */
+    uint8_t setting;
+
+    size_t num_transfers;
+    struct shm_client clients[SHM_CLIENTS_MAX];
+    struct shm_stream rx;
+    struct shm_stream tx;
+};
+
+static int shm_mutex_init(pthread_mutex_t *m)
+{
+    pthread_mutexattr_t attr;
+    int status;
+
+    status = pthread_mutexattr_init(&attr);
+    if (status != 0) {
+        return status;
+    }
+
+    status = pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    if (status == 0) {
+        status = pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    }
+    if (status == 0) {
+        status = pthread_mutex_init(m, &attr);
+    }
+
+    pthread_mutexattr_destroy(&attr);
+    return status;
+}
+
+/* Process-shared condition variables use the clock that
+ * populate_abs_timeout() measures against */
+static int shm_cond_init(pthread_cond_t *c)
+{
+    pthread_condattr_t attr;
+    int status;
+
+    status = pthread_condattr_init(&attr);
+    if (status != 0) {
+        return status;
+    }
+
+    status = pthread_condattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+#if HAVE_PTHREAD_CONDATTR_SETCLOCK && defined(CLOCK_MONOTONIC)
+    if (status == 0) {
+        status = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    }
+#endif
+    if (status == 0) {
+        status = pthread_cond_init(c, &attr);
+    }
+
+    pthread_condattr_destroy(&attr);
+    return status;
+}
+
+/******************************************************************************/
+/* Streams */
+/******************************************************************************/
+
+static void *rx_callback(struct bladerf *dev,
+                         struct bladerf_stream *stream,
+                         struct bladerf_metadata *meta,
+                         void *samples,
+                         size_t num_samples,
+                         void *user_data)
+{
+    struct shm_server *s    = user_data;
+    struct shm_header *hdr  = s->hdr;
+    struct shm_ring *ring   = s->rx.ring;
+    const uint64_t head     = atomic_load(&ring->head);
+    void *next;
+
+    if (atomic_load(&s->rx.stop)) {
+        return BLADERF_STREAM_SHUTDOWN;
+    }
+
+    /* Transfers complete in the order they were submitted, so this is the
+     * slot at the head of the ring */
+    *shm_slot_len(hdr, ring, head) = (uint32_t)sc16q11_to_bytes(num_samples);
+    atomic_store(shm_slot_seq(hdr, ring, head), head + 1);
+    atomic_store(&ring->head, head + 1);
+    shm_ring_broadcast(ring);
+
+    /* Invalidate the slot before handing it back to the device, such that
+     * readers still copying its old contents notice */
+    atomic_store(shm_slot_seq(hdr, ring, s->rx.next), 0);
+    next = shm_slot(hdr, ring, s->rx.next++);
+
+    return next;
+}
+
+static void *tx_callback(struct bladerf *dev,
+                         struct bladerf_stream *stream,
+                         struct bladerf_metadata *meta,
+                         void *samples,
+                         size_t num_samples,
+                         void *user_data)
+{
+    struct shm_server *s  = user_data;
+    struct shm_ring *ring = s->tx.ring;
+
+    /* The feeder thread submits buffers; completions free their slots */
+    if (samples != NULL) {
+        atomic_fetch_add(&ring->tail, 1);
+        shm_ring_broadcast(ring);
+    }
+
+    return BLADERF_STREAM_NO_DATA;
+}
+
+static void *stream_thread(void *arg)
+{
+    struct shm_stream *st = arg;
+    int status;
+
+    status = async_run_stream(st->stream, (st->dir == BLADERF_RX)
+                                              ? BLADERF_RX_X1
+                                              : BLADERF_TX_X1);
+    if (status == 0) {
+        status = st->stream->error_code;
+    }
+
+    if (status != 0 && !atomic_load(&st->stop)) {
+        log_warning("Served %s stream ended: %s\n",
+                    (st->dir == BLADERF_RX) ? "RX" : "TX",
+                    bladerf_strerror(status));
+    }
+
+    st->ring->error = status;
+    atomic_store(&st->ring->running, 0);
+    shm_ring_broadcast(st->ring);
+
+    return NULL;
+}
+
+static void *tx_feeder(void *arg)
+{
+    struct shm_server *s   = arg;
+    struct shm_header *hdr = s->hdr;
+    struct shm_ring *ring  = s->tx.ring;
+    int status;
+
+    while (!atomic_load(&s->tx.stop) && atomic_load(&ring->running)) {
+        size_t len;
+
+        if (s->tx.next == atomic_load(&ring->head)) {
+            shm_lock(&ring->lock);
+            if (s->tx.next == atomic_load(&ring->head)) {
+                shm_wait(&ring->cond, &ring->lock, SHM_WAIT_SLICE_MS);
+            }
+            shm_unlock(&ring->lock);
+            continue;
+        }
+
+        len    = *shm_slot_len(hdr, ring, s->tx.next);
+        status = async_submit_stream_buffer(s->tx.stream,
+                                            shm_slot(hdr, ring, s->tx.next),
+                                            &len, SHM_WAIT_SLICE_MS, false);
+        if (status == 0) {
+            s->tx.next++;
+        } else if (status != BLADERF_ERR_TIMEOUT) {
+            log_debug("Failed to submit served TX buffer: %s\n",
+                      bladerf_strerror(status));
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+static void stream_stop(struct shm_server *s, struct shm_stream *st)
+{
+    size_t len = 0;
+
+    if (st->stream == NULL) {
+        return;
+    }
+
+    atomic_store(&st->stop, true);
+
+    if (st->dir == BLADERF_TX) {
+        pthread_join(st->feeder, NULL);
+    }
+
+    async_submit_stream_buffer(st->stream, BLADERF_STREAM_SHUTDOWN, &len, 0,
+                               false);
+    pthread_join(st->thread, NULL);
+
+    async_deinit_stream(st->stream);
+    st->stream = NULL;
+
+    atomic_store(&st->ring->running, 0);
+    shm_ring_broadcast(st->ring);
+}
+
+/* Start a stream of buffers of buf_bytes. RX buffers are a whole slot, and
+ * TX buffers are the client's buffer size. */
+static int stream_start(struct shm_server *s,
+                        struct shm_stream *st,
+                        size_t buf_bytes)
+{
+    struct shm_header *hdr = s->hdr;
+    struct shm_ring *ring  = st->ring;
+    void **buffers;
+    size_t i;
+    int status;
+
+    MUTEX_LOCK(&s->dev->lock);
+    status = async_init_stream(&st->stream, s->dev,
+                               (st->dir == BLADERF_RX) ? rx_callback
+                                                       : tx_callback,
+                               &buffers, ring->num_slots,
+                               BLADERF_FORMAT_SC16_Q11,
+                               bytes_to_sc16q11(buf_bytes),
+                               ASYNC_BUFFER_GRANULARITY, s->num_transfers, s);
+    MUTEX_UNLOCK(&s->dev->lock);
+
+    if (status != 0) {
+        st->stream = NULL;
+        return status;
+    }
+
+    /* The stream must not time out while the device is idle */
+    async_set_transfer_timeout(st->stream, 0);
+
+    /* Transfers are made directly to and from the ring's slots. The RX
+     * stream initially submits buffers[0] through buffers[num_transfers-1],
+     * which are the slots following the ring's head. */
+    if (st->dir == BLADERF_RX) {
+        const uint64_t head = atomic_load(&ring->head);
+
+        for (i = 0; i < ring->num_slots; i++) {
+            buffers[i] = shm_slot(hdr, ring, head + i);
+        }
+
+        for (i = 0; i < s->num_transfers; i++) {
+            atomic_store(shm_slot_seq(hdr, ring, head + i), 0);
+        }
+
+        st->next = head + s->num_transfers;
+    } else {
+        atomic_store(&ring->head, 0);
+        atomic_store(&ring->tail, 0);
+        st->next = 0;
+    }
+
+    atomic_store(&st->stop, false);
+    ring->error = 0;
+    atomic_store(&ring->running, 1);
+
+    status = pthread_create(&st->thread, NULL, stream_thread, st);
+    if (status != 0) {
+        atomic_store(&ring->running, 0);
+        async_deinit_stream(st->stream);
+        st->stream = NULL;
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    if (st->dir == BLADERF_TX) {
+        status = pthread_create(&st->feeder, NULL, tx_feeder, s);
+        if (status != 0) {
+            size_t len = 0;
+
+            atomic_store(&st->stop, true);
+            async_submit_stream_buffer(st->stream, BLADERF_STREAM_SHUTDOWN,
+                                       &len, 0, false);
+            pthread_join(st->thread, NULL);
+            async_deinit_stream(st->stream);
+            st->stream = NULL;
+            return BLADERF_ERR_UNEXPECTED;
+        }
+    }
+
+    log_debug("Started served %s stream\n",
+              (st->dir == BLADERF_RX) ? "RX" : "TX");
+
+    return 0;
+}
+
+static unsigned int stream_users(struct shm_server *s, bladerf_direction dir)
+{
+    unsigned int n = 0;
+    size_t i;
+
+    for (i = 0; i < SHM_CLIENTS_MAX; i++) {
+        if (s->clients[i].in_use && s->clients[i].streaming[dir]) {
+            n++;
+        }
+    }
+
+    return n;
+}
+
+static int stream_acquire(struct shm_server *s,
+                          struct shm_client *c,
+                          bladerf_direction dir,
+                          size_t buf_bytes)
+{
+    struct shm_stream *st = (dir == BLADERF_RX) ? &s->rx : &s->tx;
+    int status;
+
+    if (c->streaming[dir]) {
+        return 0;
+    }
+
+    if (dir == BLADERF_TX && stream_users(s, BLADERF_TX) != 0) {
+        log_warning("The served TX stream is in use by another client\n");
+        return BLADERF_ERR_PERMISSION;
+    }
+
+    /* Restart a stream that ended due to an error */
+    if (st->stream != NULL && !atomic_load(&st->ring->running)) {
+        stream_stop(s, st);
+    }
+
+    if (st->stream == NULL) {
+        status = stream_start(s, st, buf_bytes);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    c->streaming[dir] = true;
+    return 0;
+}
+
+static void stream_release(struct shm_server *s,
+                           struct shm_client *c,
+                           bladerf_direction dir)
+{
+    if (!c->streaming[dir]) {
+        return;
+    }
+
+    c->streaming[dir] = false;
+
+    if (stream_users(s, dir) == 0) {
+        stream_stop(s, (dir == BLADERF_RX) ? &s->rx : &s->tx);
+    }
+}
+
+/******************************************************************************/
+/* Control requests */
+/******************************************************************************/
+
+static unsigned int module_users(struct shm_server *s, bladerf_direction dir)
+{
+    unsigned int n = 0;
+    size_t i;
+
+    for (i = 0; i < SHM_CLIENTS_MAX; i++) {
+        if (s->clients[i].in_use && s->clients[i].enabled[dir]) {
+            n++;
+        }
+    }
+
+    return n;
+}
+
+static int enable_module(struct shm_server *s, bladerf_direction dir,
+                         bool enable)
+{
+    int32_t fx3_ret = 0;
+    int status;
+
+    MUTEX_LOCK(&s->dev->lock);
+    status = s->usb->fn->control_transfer(
+        s->usb->driver, USB_TARGET_DEVICE, USB_REQUEST_VENDOR,
+        USB_DIR_DEVICE_TO_HOST,
+        (dir == BLADERF_RX) ? BLADE_USB_CMD_RF_RX : BLADE_USB_CMD_RF_TX,
+        enable ? 1 : 0, 0, &fx3_ret, sizeof(fx3_ret), CTRL_TIMEOUT_MS);
+    MUTEX_UNLOCK(&s->dev->lock);
+
+    return status;
+}
+
+/* RF modules are enabled while any client has them enabled. A client's
+ * request that doesn't change this is answered without reaching the device,
+ * as the FX3 would answer it. */
+static bool handle_module_request(struct shm_server *s,
+                                  struct shm_client *c,
+                                  struct shm_ctrl *ctrl)
+{
+    const struct shm_args *a = &ctrl->args;
+    bladerf_direction dir;
+    unsigned int before;
+    bool enable;
+
+    if (a->req_type != USB_REQUEST_VENDOR ||
+        a->dir != USB_DIR_DEVICE_TO_HOST) {
+        return false;
+    }
+
+    if (a->request == BLADE_USB_CMD_RF_RX) {
+        dir = BLADERF_RX;
+    } else if (a->request == BLADE_USB_CMD_RF_TX) {
+        dir = BLADERF_TX;
+    } else {
+        return false;
+    }
+
+    enable = (a->wvalue != 0);
+    before = module_users(s, dir);
+    c->enabled[dir] = enable;
+
+    if ((before != 0) != (module_users(s, dir) != 0)) {
+        return false;
+    }
+
+    memset(ctrl->data, 0, sizeof(int32_t));
+    ctrl->actual_len = u32_min(a->len, sizeof(int32_t));
+    ctrl->status     = 0;
+
+    return true;
+}
+
+static void release_client(struct shm_server *s, struct shm_client *c)
+{
+    bladerf_direction dir;
+
+    for (dir = BLADERF_RX; dir <= BLADERF_TX; dir++) {
+        stream_release(s, c, dir);
+
+        if (c->enabled[dir]) {
+            c->enabled[dir] = false;
+            if (module_users(s, dir) == 0) {
+                enable_module(s, dir, false);
+            }
+        }
+    }
+
+    memset(c, 0, sizeof(*c));
+}
+
+static void reap_clients(struct shm_server *s)
+{
+    size_t i;
+
+    for (i = 0; i < SHM_CLIENTS_MAX; i++) {
+        struct shm_client *c = &s->clients[i];
+
+        if (c->in_use && !shm_pid_alive(c->pid)) {
+            log_debug("Releasing client %zu (pid %d), which has exited\n", i,
+                      (int)c->pid);
+            release_client(s, c);
+        }
+    }
+}
+
+static int handle_attach(struct shm_server *s, struct shm_ctrl *ctrl)
+{
+    size_t i;
+
+    reap_clients(s);
+
+    for (i = 0; i < SHM_CLIENTS_MAX; i++) {
+        if (!s->clients[i].in_use) {
+            const int32_t id = (int32_t)i;
+
+            memset(&s->clients[i], 0, sizeof(s->clients[i]));
+            s->clients[i].in_use = true;
+            s->clients[i].pid    = ctrl->owner_pid;
+
+            memcpy(ctrl->data, &id, sizeof(id));
+            ctrl->actual_len = sizeof(id);
+
+            log_debug("Attached client %zu (pid %d)\n", i, ctrl->owner_pid);
+            return 0;
+        }
+    }
+
+    log_warning("Rejected a client, as all %d client handles are in use\n",
+                SHM_CLIENTS_MAX);
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int handle_request(struct shm_server *s, struct shm_ctrl *ctrl)
+{
+    const struct shm_args *a = &ctrl->args;
+    struct bladerf_usb *usb  = s->usb;
+    struct shm_client *c     = NULL;
+    int status;
+
+    ctrl->actual_len = 0;
+
+    if (a->op == SHM_OP_ATTACH) {
+        return handle_attach(s, ctrl);
+    }
+
+    if (a->client < 0 || a->client >= SHM_CLIENTS_MAX ||
+        !s->clients[a->client].in_use) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    c = &s->clients[a->client];
+
+    switch (a->op) {
+        case SHM_OP_DETACH:
+            release_client(s, c);
+            return 0;
+
+        case SHM_OP_CONTROL:
+            if (a->len > SHM_CTRL_DATA_SIZE) {
+                return BLADERF_ERR_INVAL;
+            }
+
+            if (handle_module_request(s, c, ctrl)) {
+                return 0;
+            }
+
+            MUTEX_LOCK(&s->dev->lock);
+            status = usb->fn->control_transfer(
+                usb->driver, (usb_target)a->target, (usb_request)a->req_type,
+                (usb_direction)a->dir, a->request, a->wvalue, a->windex,
+                ctrl->data, a->len, a->timeout_ms);
+            MUTEX_UNLOCK(&s->dev->lock);
+
+            ctrl->actual_len = a->len;
+            return status;
+
+        case SHM_OP_BULK:
+            if (a->len > SHM_CTRL_DATA_SIZE) {
+                return BLADERF_ERR_INVAL;
+            }
+
+            MUTEX_LOCK(&s->dev->lock);
+            status = usb->fn->bulk_transfer(usb->driver, a->endpoint,
+                                            ctrl->data, a->len,
+                                            a->timeout_ms);
+            MUTEX_UNLOCK(&s->dev->lock);
+
+            ctrl->actual_len = a->len;
+            return status;
+
+        case SHM_OP_NIOS:
+            /* The request and its response are made as one transaction, so
+             * that they cannot interleave with another process's */
+            if (a->len > SHM_CTRL_DATA_SIZE) {
+                return BLADERF_ERR_INVAL;
+            }
+
+            MUTEX_LOCK(&s->dev->lock);
+            status = usb->fn->bulk_transfer(usb->driver, PERIPHERAL_EP_OUT,
+                                            ctrl->data, a->len,
+                                            a->timeout_ms);
+            if (status == 0) {
+                status = usb->fn->bulk_transfer(usb->driver, PERIPHERAL_EP_IN,
+                                                ctrl->data, a->len,
+                                                a->timeout_ms);
+            }
+            MUTEX_UNLOCK(&s->dev->lock);
+
+            ctrl->actual_len = a->len;
+            return status;
+
+        case SHM_OP_STRING_DESC:
+            if (a->len > SHM_CTRL_DATA_SIZE) {
+                return BLADERF_ERR_INVAL;
+            }
+
+            MUTEX_LOCK(&s->dev->lock);
+            status = usb->fn->get_string_descriptor(usb->driver, a->request,
+                                                    ctrl->data, a->len);
+            MUTEX_UNLOCK(&s->dev->lock);
+
+            ctrl->actual_len = a->len;
+            return status;
+
+        case SHM_OP_CHANGE_SETTING:
+            /* Clients select USB_IF_NULL when opening and closing, which
+             * would stop the device for everyone. Reselecting the current
+             * setting would reset the sample endpoints. */
+            if (a->setting == USB_IF_NULL || a->setting == s->setting) {
+                return 0;
+            }
+
+            MUTEX_LOCK(&s->dev->lock);
+            status = usb->fn->change_setting(usb->driver, a->setting);
+            MUTEX_UNLOCK(&s->dev->lock);
+
+            if (status == 0) {
+                s->setting = a->setting;
+            }
+            return status;
+
+        case SHM_OP_RX_START:
+            return stream_acquire(s, c, BLADERF_RX, s->hdr->rx.slot_size);
+
+        case SHM_OP_RX_STOP:
+            stream_release(s, c, BLADERF_RX);
+            return 0;
+
+        case SHM_OP_TX_START:
+            if (a->len == 0 || a->len > s->hdr->tx.slot_size ||
+                a->len % SHM_SLOT_GRANULARITY != 0) {
+                return BLADERF_ERR_INVAL;
+            }
+
+            return stream_acquire(s, c, BLADERF_TX, a->len);
+
+        case SHM_OP_TX_STOP:
+            stream_release(s, c, BLADERF_TX);
+            return 0;
+
+        default:
+            return BLADERF_ERR_INVAL;
+    }
+}
+
+static void *ctrl_thread(void *arg)
+{
+    struct shm_server *s  = arg;
+    struct shm_ctrl *ctrl = &s->hdr->ctrl;
+
+    while (!atomic_load(&s->stop)) {
+        bool pending;
+        uint32_t seq;
+
+        shm_lock(&ctrl->lock);
+
+        if (ctrl->done_seq == ctrl->req_seq) {
+            shm_wait(&ctrl->request, &ctrl->lock, SHM_WAIT_SLICE_MS);
+        }
+
+        pending = (ctrl->done_seq != ctrl->req_seq);
+        seq     = ctrl->req_seq;
+
+        /* Free the mailbox if its holder died after its request completed */
+        if (!pending && ctrl->busy && !shm_pid_alive(ctrl->owner_pid)) {
+            ctrl->busy      = 0;
+            ctrl->owner_pid = 0;
+            pthread_cond_broadcast(&ctrl->response);
+        }
+
+        shm_unlock(&ctrl->lock);
+
+        if (pending) {
+            /* The requesting client doesn't touch the mailbox until
+             * done_seq advances */
+            const int status = handle_request(s, ctrl);
+
+            shm_lock(&ctrl->lock);
+            ctrl->status   = status;
+            ctrl->done_seq = seq;
+            pthread_cond_broadcast(&ctrl->response);
+            shm_unlock(&ctrl->lock);
+        } else {
+            reap_clients(s);
+        }
+    }
+
+    return NULL;
+}
+
+/******************************************************************************/
+/* Segment setup */
+/******************************************************************************/
+
+static size_t align_up(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+/* Lay out a ring at *offset, advancing it past the ring's slots */
+static int ring_init(struct shm_ring *ring,
+                     unsigned int num_slots,
+                     unsigned int slot_size,
+                     size_t *offset)
+{
+    int status;
+
+    ring->num_slots = num_slots;
+    ring->slot_size = slot_size;
+
+    ring->seq_offset = *offset;
+    *offset += num_slots * sizeof(uint64_t);
+
+    ring->len_offset = *offset;
+    *offset += num_slots * sizeof(uint32_t);
+
+    *offset           = align_up(*offset, SHM_SLOT_GRANULARITY);
+    ring->data_offset = *offset;
+    *offset += (size_t)num_slots * slot_size;
+
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->running, 0);
+
+    status = shm_mutex_init(&ring->lock);
+    if (status == 0) {
+        status = shm_cond_init(&ring->cond);
+    }
+
+    return status;
+}
+
+static void segment_free(struct shm_server *s)
+{
+    if (s->hdr != NULL) {
+        munmap(s->hdr, s->size);
+    }
+
+    if (s->fd >= 0) {
+        close(s->fd);
+        shm_unlink(s->name);
+    }
+
+    free(s);
+}
+
+int shm_server_start(struct bladerf *dev,
+                     unsigned int num_slots,
+                     unsigned int slot_size)
+{
+    struct shm_server *s;
+    struct bladerf_usb *usb;
+    struct shm_header *hdr;
+    bladerf_dev_speed speed;
+    size_t offset;
+    int status;
+
+    switch (dev->ident.backend) {
+        case BLADERF_BACKEND_LIBUSB:
+        case BLADERF_BACKEND_LINUX:
+        case BLADERF_BACKEND_CYPRESS:
+            break;
+
+        default:
+            log_debug("Only devices opened on a USB driver may be served\n");
+            return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (dev->shm_server != NULL) {
+        log_debug("The device is already being served\n");
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (num_slots < 4 || slot_size == 0 ||
+        slot_size % SHM_SLOT_GRANULARITY != 0) {
+        log_debug("Invalid ring dimensions: %u slots of %u bytes\n", num_slots,
+                  slot_size);
+        return BLADERF_ERR_INVAL;
+    }
+
+    usb = dev->backend_data;
+
+    s = calloc(1, sizeof(*s));
+    if (s == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    s->dev     = dev;
+    s->usb     = usb;
+    s->fd      = -1;
+    s->rx.dir  = BLADERF_RX;
+    s->tx.dir  = BLADERF_TX;
+
+    /* The device was opened into RF link mode */
+    s->setting = USB_IF_RF_LINK;
+
+    /* Leave at least half of the RX ring readable by clients */
+    s->num_transfers = min_sz(num_slots / 2, 32);
+
+    offset = align_up(sizeof(struct shm_header), SHM_SLOT_GRANULARITY);
+    s->size = offset + 2 * (num_slots * (sizeof(uint64_t) + sizeof(uint32_t)) +
+                            SHM_SLOT_GRANULARITY +
+                            (size_t)num_slots * slot_size);
+
+    shm_name(s->name, dev->ident.serial);
+
+    s->fd = shm_open(s->name, O_RDWR | O_CREAT | O_EXCL, 0660);
+    if (s->fd < 0 && errno == EEXIST) {
+        /* Left behind by a server that did not exit cleanly */
+        log_debug("Replacing stale segment %s\n", s->name);
+        shm_unlink(s->name);
+        s->fd = shm_open(s->name, O_RDWR | O_CREAT | O_EXCL, 0660);
+    }
+
+    if (s->fd < 0) {
+        log_debug("Failed to create %s: %s\n", s->name, strerror(errno));
+        status = (errno == EACCES) ? BLADERF_ERR_PERMISSION : BLADERF_ERR_IO;
+        free(s);
+        return status;
+    }
+
+    if (ftruncate(s->fd, (off_t)s->size) != 0) {
+        log_debug("Failed to size %s: %s\n", s->name, strerror(errno));
+        segment_free(s);
+        return BLADERF_ERR_MEM;
+    }
+
+    hdr = mmap(NULL, s->size, PROT_READ | PROT_WRITE, MAP_SHARED, s->fd, 0);
+    if (hdr == MAP_FAILED) {
+        log_debug("Failed to map %s: %s\n", s->name, strerror(errno));
+        s->hdr = NULL;
+        segment_free(s);
+        return BLADERF_ERR_MEM;
+    }
+
+    s->hdr     = hdr;
+    s->rx.ring = &hdr->rx;
+    s->tx.ring = &hdr->tx;
+
+    hdr->size       = s->size;
+    hdr->server_pid = (int32_t)getpid();
+    atomic_init(&hdr->running, 0);
+
+    memcpy(&hdr->devinfo, &dev->ident, sizeof(hdr->devinfo));
+
+    status = usb->fn->get_vid_pid(usb->driver, &hdr->vid, &hdr->pid);
+    if (status == 0) {
+        status = usb->fn->get_flash_id(usb->driver, &hdr->flash_mid,
+                                       &hdr->flash_did);
+    }
+    if (status == 0) {
+        status = usb->fn->get_speed(usb->driver, &speed);
+        hdr->speed = (int32_t)speed;
+    }
+
+    if (status == 0) {
+        status = shm_mutex_init(&hdr->ctrl.lock);
+        if (status == 0) {
+            status = shm_cond_init(&hdr->ctrl.request);
+        }
+        if (status == 0) {
+            status = shm_cond_init(&hdr->ctrl.response);
+        }
+        if (status == 0) {
+            status = ring_init(&hdr->rx, num_slots, slot_size, &offset);
+        }
+        if (status == 0) {
+            status = ring_init(&hdr->tx, num_slots, slot_size, &offset);
+        }
+        if (status != 0) {
+            status = BLADERF_ERR_UNEXPECTED;
+        }
+    }
+
+    if (status != 0) {
+        segment_free(s);
+        return status;
+    }
+
+    status = pthread_create(&s->ctrl_thread, NULL, ctrl_thread, s);
+    if (status != 0) {
+        segment_free(s);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    /* Clients check the magic number last */
+    hdr->version = SHM_VERSION;
+    atomic_store(&hdr->running, 1);
+    atomic_thread_fence(memory_order_seq_cst);
+    hdr->magic = SHM_MAGIC;
+
+    dev->shm_server = s;
+
+    log_debug("Serving device %s via %s: %u slots of %u bytes\n",
+              dev->ident.serial, s->name, num_slots, slot_size);
+
+    return 0;
+}
+
+void shm_server_stop(struct bladerf *dev)
+{
+    struct shm_server *s = dev->shm_server;
+    struct shm_header *hdr;
+    size_t i;
+
+    if (s == NULL) {
+        return;
+    }
+
+    hdr = s->hdr;
+
+    /* New clients are turned away, and waiting ones give up */
+    atomic_store(&hdr->running, 0);
+    hdr->magic = 0;
+    shm_unlink(s->name);
+
+    atomic_store(&s->stop, true);
+    pthread_join(s->ctrl_thread, NULL);
+
+    shm_lock(&hdr->ctrl.lock);
+    pthread_cond_broadcast(&hdr->ctrl.response);
+    shm_unlock(&hdr->ctrl.lock);
+
+    for (i = 0; i < SHM_CLIENTS_MAX; i++) {
+        if (s->clients[i].in_use) {
+            release_client(s, &s->clients[i]);
+        }
+    }
+
+    stream_stop(s, &s->rx);
+    stream_stop(s, &s->tx);
+
+    /* Clients may still have the segment mapped, and unmap it upon their
+     * next request */
+    munmap(s->hdr, s->size);
+    close(s->fd);
+    free(s);
+
+    dev->shm_server = NULL;
+
+    log_debug("Stopped serving device %s\n", dev->ident.serial);
+}
@@ -0,0 +1,71 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef BACKEND_USB_SHM_SERVER_H_
+#define BACKEND_USB_SHM_SERVER_H_
+
+#include <libbladeRF.h>
+
+#include "backend/backend_config.h"
+
+#ifdef ENABLE_BACKEND_SHM
+
+/**
+ * Publish a device opened on a USB driver to other processes.
+ * See bladerf_shm_server_start().
+ *
+ * @param       dev         Device handle
+ * @param[in]   num_slots   Number of slots in each of the RX and TX rings
+ * @param[in]   slot_size   Size of each slot, in bytes
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int shm_server_start(struct bladerf *dev,
+                     unsigned int num_slots,
+                     unsigned int slot_size);
+
+/**
+ * Stop serving a device, if it is being served. Clients' subsequent requests
+ * fail with BLADERF_ERR_IO.
+ *
+ * This acquires the device's handle lock, and therefore must not be called
+ * with it held.
+ *
+ * @param       dev         Device handle
+ */
+void shm_server_stop(struct bladerf *dev);
+
+#else
+
+static inline int shm_server_start(struct bladerf *dev,
+                                   unsigned int num_slots,
+                                   unsigned int slot_size)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static inline void shm_server_stop(struct bladerf *dev)
+{
+}
+
+#endif
+
+#endif
@@ -26,6 +26,7 @@
 #include <inttypes.h>
 
 #include "rel_assert.h"
+#include "sha256.h"
 #include "log.h"
 #include "minmax.h"
 #include "conversions.h"
@@ -35,9 +36,14 @@
 #include "backend/backend.h"
 #include "backend/backend_config.h"
 #include "backend/usb/usb.h"
+#include "backend/usb/usb_bench.h"
 #include "driver/fx3_fw.h"
 #include "streaming/async.h"
+#include "helpers/ctrl_trace.h"
+#include "helpers/fpga_compress.h"
+#include "helpers/have_cap.h"
 #include "helpers/version.h"
+#include "helpers/wallclock.h"
 
 #include "bladeRF.h"
 #include "nios_pkt_formats.h"
@@ -53,34 +59,42 @@ static const struct usb_driver *usb_driver_list[] = BLADERF_USB_BACKEND_LIST;
 /* FW declaration of fn table declared at the end of this file */
 const struct backend_fns backend_fns_usb_legacy;
 
+/* Issue a vendor command, recording it in the control-path trace */
+static int vendor_cmd(struct bladerf *dev, usb_direction dir, uint8_t cmd,
+                      uint16_t wvalue, uint16_t windex,
+                      void *buf, uint32_t len)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    const uint64_t trace_start = ctrl_trace_begin(dev);
+    int status;
+
+    status = usb->fn->control_transfer(usb->driver,
+                                       USB_TARGET_DEVICE,
+                                       USB_REQUEST_VENDOR,
+                                       dir, cmd, wvalue, windex,
+                                       buf, len,
+                                       CTRL_TIMEOUT_MS);
+
+    ctrl_trace_end(dev, trace_start, BLADERF_CTRL_TRACE_VENDOR, cmd, 0,
+                   dir == USB_DIR_HOST_TO_DEVICE, status);
+
+    return status;
+}
+
 /* Vendor command wrapper to gets a 32-bit integer and supplies a wIndex */
 static inline int vendor_cmd_int_windex(struct bladerf *dev, uint8_t cmd,
                                         uint16_t windex, int32_t *val)
 {
-    struct bladerf_usb *usb = dev->backend_data;
-
-    return usb->fn->control_transfer(usb->driver,
-                                      USB_TARGET_DEVICE,
-                                      USB_REQUEST_VENDOR,
-                                      USB_DIR_DEVICE_TO_HOST,
-                                      cmd, 0, windex,
-                                      val, sizeof(uint32_t),
-                                      CTRL_TIMEOUT_MS);
+    return vendor_cmd(dev, USB_DIR_DEVICE_TO_HOST, cmd, 0, windex,
+                      val, sizeof(uint32_t));
 }
 
 /* Vendor command wrapper to get a 32-bit integer and supplies wValue */
 static inline int vendor_cmd_int_wvalue(struct bladerf *dev, uint8_t cmd,
                                         uint16_t wvalue, int32_t *val)
 {
-    struct bladerf_usb *usb = dev->backend_data;
-
-    return usb->fn->control_transfer(usb->driver,
-                                      USB_TARGET_DEVICE,
-                                      USB_REQUEST_VENDOR,
-                                      USB_DIR_DEVICE_TO_HOST,
-                                      cmd, wvalue, 0,
-                                      val, sizeof(uint32_t),
-                                      CTRL_TIMEOUT_MS);
+    return vendor_cmd(dev, USB_DIR_DEVICE_TO_HOST, cmd, wvalue, 0,
+                      val, sizeof(uint32_t));
 }
 
 
@@ -88,14 +102,7 @@ static inline int vendor_cmd_int_wvalue(struct bladerf *dev, uint8_t cmd,
 static inline int vendor_cmd_int(struct bladerf *dev, uint8_t cmd,
                                  usb_direction dir, int32_t *val)
 {
-    struct bladerf_usb *usb = dev->backend_data;
-
-    return usb->fn->control_transfer(usb->driver,
-                                      USB_TARGET_DEVICE,
-                                      USB_REQUEST_VENDOR,
-                                      dir, cmd, 0, 0,
-                                      val, sizeof(int32_t),
-                                      CTRL_TIMEOUT_MS);
+    return vendor_cmd(dev, dir, cmd, 0, 0, val, sizeof(int32_t));
 }
 
 static inline int change_setting(struct bladerf *dev, uint8_t setting)
@@ -208,7 +215,8 @@ static bool usb_matches(bladerf_backend backend)
     return backend == BLADERF_BACKEND_ANY ||
            backend == BLADERF_BACKEND_LINUX ||
            backend == BLADERF_BACKEND_LIBUSB ||
-           backend == BLADERF_BACKEND_CYPRESS;
+           backend == BLADERF_BACKEND_CYPRESS ||
+           backend == BLADERF_BACKEND_SHM;
 }
 
 static int usb_probe(backend_probe_target probe_target,
@@ -224,6 +232,26 @@ static int usb_probe(backend_probe_target probe_target,
     return status;
 }
 
+static int usb_set_device_monitor(bool enable)
+{
+    int status = BLADERF_ERR_UNSUPPORTED;
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(usb_driver_list); i++) {
+        const struct usb_fns *fn = usb_driver_list[i]->fn;
+
+        if (fn->set_device_monitor != NULL) {
+            int driver_status = fn->set_device_monitor(enable);
+
+            if (status != 0) {
+                status = driver_status;
+            }
+        }
+    }
+
+    return status;
+}
+
 static void usb_close(struct bladerf *dev)
 {
     int status;
@@ -317,33 +345,49 @@ static int usb_get_fpga_version(struct bladerf *dev,
 static int usb_open(struct bladerf *dev, struct bladerf_devinfo *info)
 {
     int status;
-    size_t i;
+    size_t first = 0;
+    size_t pass, n, i;
+    bool found = false;
     struct bladerf_usb *usb;
 
-    usb = malloc(sizeof(*usb));
+    usb = calloc(1, sizeof(*usb));
     if (usb == NULL) {
         return BLADERF_ERR_MEM;
     }
 
-    /* Try each matching usb driver */
-    for (i = 0; i < ARRAY_SIZE(usb_driver_list); i++) {
-        if (info->backend == BLADERF_BACKEND_ANY
-                || usb_driver_list[i]->id == info->backend) {
-            usb->fn = usb_driver_list[i]->fn;
-            status = usb->fn->open(&usb->driver, info, &dev->ident);
-            if (status == 0) {
-                break;
-            } else if (status == BLADERF_ERR_NODEV) {
+    if (info->backend == BLADERF_BACKEND_ANY) {
+        first = usb_bench_select(info, usb_driver_list,
+                                 ARRAY_SIZE(usb_driver_list));
+    }
+
+    /* Try each matching usb driver, starting with the preferred one. A
+     * device served by another process is busy to the other drivers, so the
+     * shm driver is always tried first. */
+    for (pass = 0; pass < 2 && !found; pass++) {
+        for (n = 0; n < ARRAY_SIZE(usb_driver_list) && !found; n++) {
+            i = (first + n) % ARRAY_SIZE(usb_driver_list);
+
+            if ((usb_driver_list[i]->id == BLADERF_BACKEND_SHM) !=
+                (pass == 0)) {
                 continue;
-            } else {
-                free(usb);
-                return status;
+            }
+
+            if (info->backend == BLADERF_BACKEND_ANY
+                    || usb_driver_list[i]->id == info->backend) {
+                usb->fn = usb_driver_list[i]->fn;
+                status = usb->fn->open(&usb->driver, info, &dev->ident);
+                if (status == 0) {
+                    found = true;
+                } else if (status != BLADERF_ERR_NODEV) {
+                    free(usb);
+                    return status;
+                }
             }
         }
     }
 
     /* If no usb driver was found */
-    if (i == ARRAY_SIZE(usb_driver_list)) {
+    if (!found) {
         free(usb);
         return BLADERF_ERR_NODEV;
     }
@@ -392,11 +436,11 @@ static int usb_get_flash_id(struct bladerf *dev, uint8_t *mid, uint8_t *did)
     return status;
 }
 
-static int begin_fpga_programming(struct bladerf *dev)
+static int begin_fpga_programming(struct bladerf *dev, uint16_t mode)
 {
-    int result;
-    int status = vendor_cmd_int(dev, BLADE_USB_CMD_BEGIN_PROG,
-                                USB_DIR_DEVICE_TO_HOST, &result);
+    int32_t result;
+    int status = vendor_cmd_int_wvalue(dev, BLADE_USB_CMD_BEGIN_PROG, mode,
+                                       &result);
 
     if (status != 0) {
         return status;
@@ -408,32 +452,160 @@ static int begin_fpga_programming(struct bladerf *dev)
     }
 }
 
+/* Interval at which CONF_DONE is polled, with firmware that cannot wait for
+ * it on our behalf */
+#define FPGA_CONF_POLL_US 5000
+
+/* Wait for the FPGA to report that it is configured. Returns 1 once it has,
+ * 0 on timeout, or a BLADERF_ERR_* value on failure. */
+static int wait_fpga_configured(struct bladerf *dev, unsigned int timeout_ms)
+{
+    const uint64_t deadline =
+        wallclock_get_current_nsec() + (uint64_t)timeout_ms * 1000000;
+    const bool fw_wait = have_cap_dev(dev, BLADERF_CAP_FW_FPGA_CONF_WAIT);
+    uint64_t now;
+    int32_t result;
+    int status;
+
+    do {
+        if (fw_wait) {
+            now = wallclock_get_current_nsec();
+            timeout_ms = (now < deadline)
+                             ? (unsigned int)((deadline - now) / 1000000)
+                             : 0;
+
+            status = vendor_cmd_int_wvalue(
+                dev, BLADE_USB_CMD_WAIT_FPGA_CONFIGURED,
+                (uint16_t)uint_min(timeout_ms, BLADE_FPGA_CONF_WAIT_MAX_MS),
+                &result);
+            if (status < 0) {
+                return status;
+            } else if (result < 0) {
+                log_debug("Unexpected FPGA wait result: %d\n", result);
+                return BLADERF_ERR_UNEXPECTED;
+            } else if (result != 0) {
+                return 1;
+            }
+        } else {
+            status = usb_is_fpga_configured(dev);
+            if (status != 0) {
+                return status;
+            }
+
+            usleep(FPGA_CONF_POLL_US);
+        }
+    } while (wallclock_get_current_nsec() < deadline);
+
+    return 0;
+}
+
+static void fpga_image_hash(const uint8_t *image, size_t image_size,
+                            uint8_t *digest)
+{
+    SHA256_CTX ctx;
+
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, image, image_size);
+    SHA256_Final(digest, &ctx);
+}
+
+static int usb_is_fpga_image_loaded(struct bladerf *dev,
+                                    const uint8_t *image,
+                                    size_t image_size)
+{
+    uint8_t resp[BLADE_FPGA_HASH_RESP_SIZE];
+    uint8_t digest[BLADE_FPGA_HASH_SIZE];
+    int32_t op_status;
+    int status;
+
+    if (!have_cap_dev(dev, BLADERF_CAP_FW_FPGA_HASH)) {
+        return 0;
+    }
+
+    status = usb_is_fpga_configured(dev);
+    if (status != 1) {
+        return status;
+    }
+
+    status = vendor_cmd(dev, USB_DIR_DEVICE_TO_HOST,
+                        BLADE_USB_CMD_GET_FPGA_HASH, 0, 0,
+                        resp, sizeof(resp));
+    if (status != 0) {
+        return status;
+    }
+
+    memcpy(&op_status, resp, sizeof(op_status));
+    if (LE32_TO_HOST(op_status) != 0) {
+        log_debug("No FPGA image digest has been recorded\n");
+        return 0;
+    }
+
+    fpga_image_hash(image, image_size, digest);
+
+    return memcmp(digest, &resp[sizeof(op_status)], sizeof(digest)) == 0;
+}
+
 static int usb_load_fpga(struct bladerf *dev, const uint8_t *image, size_t image_size)
 {
     struct bladerf_usb *usb = dev->backend_data;
 
-    unsigned int wait_count;
     const unsigned int timeout_ms = (2 * CTRL_TIMEOUT_MS);
+    uint64_t start_ns, sent_ns, done_ns;
+    uint16_t mode = 0;
+    uint8_t *compressed = NULL;
+    size_t compressed_size;
+    uint8_t digest[BLADE_FPGA_HASH_SIZE];
     int status;
 
+    /* Computed up front, as the image may be replaced by a compressed copy */
+    fpga_image_hash(image, image_size, digest);
+
+    /* Send the bitstream compressed if the firmware can decompress it, and
+     * doing so actually shrinks it */
+    if (have_cap_dev(dev, BLADERF_CAP_FW_FPGA_COMPRESSED)) {
+        status = fpga_compress(image, image_size,
+                               &compressed, &compressed_size);
+        if (status != 0) {
+            return status;
+        }
+
+        if (compressed_size < image_size) {
+            log_debug("Compressed FPGA bitstream from %zu to %zu bytes\n",
+                      image_size, compressed_size);
+
+            image      = compressed;
+            image_size = compressed_size;
+            mode       = BLADE_FPGA_PROG_COMPRESSED;
+        } else {
+            free(compressed);
+            compressed = NULL;
+        }
+    }
+
+    /* The new image's NIOS II may reconfigure the devices behind our back */
+    reg_shadow_invalidate_all(&usb->lms_shadow);
+    reg_shadow_invalidate_all(&usb->si5338_shadow);
+    reg_shadow_invalidate_all(&usb->ad9361_shadow);
+
     /* Switch to the FPGA configuration interface */
     status = change_setting(dev, USB_IF_CONFIG);
     if(status < 0) {
         log_debug("Failed to switch to FPGA config setting: %s\n",
                   bladerf_strerror(status));
-        return status;
+        goto out;
     }
 
     /* Begin programming */
-    status = begin_fpga_programming(dev);
+    status = begin_fpga_programming(dev, mode);
     if (status < 0) {
         log_debug("Failed to initiate FPGA programming: %s\n",
                   bladerf_strerror(status));
-        return status;
+        goto out;
     }
 
     /* Send the file down */
     assert(image_size <= UINT32_MAX);
+    start_ns = wallclock_get_current_nsec();
     status = usb->fn->bulk_transfer(usb->driver, PERIPHERAL_EP_OUT,
                                     (void *)image,
                                     (uint32_t)image_size,
@@ -441,49 +613,53 @@ static int usb_load_fpga(struct bladerf *dev, const uint8_t *image, size_t image
     if (status < 0) {
         log_debug("Failed to write FPGA bitstream to FPGA: %s\n",
                   bladerf_strerror(status));
-        return status;
+        goto out;
     }
 
-    /* Poll FPGA status to determine if programming was a success */
-    wait_count = 10;
-    status = 0;
+    sent_ns = wallclock_get_current_nsec();
 
-    while (wait_count > 0 && status == 0) {
-        status = usb_is_fpga_configured(dev);
-        if (status == 1) {
-            break;
-        }
-
-        usleep(200000);
-        wait_count--;
-    }
-
-    /* Failed to determine if FPGA is loaded */
+    /* Wait for the FPGA to report that programming was a success */
+    status = wait_fpga_configured(dev, timeout_ms);
     if (status < 0) {
         log_debug("Failed to determine if FPGA is loaded: %s\n",
                   bladerf_strerror(status));
-        return status;
-    } else if (wait_count == 0 && status != 0) {
+    } else if (status == 0) {
         log_debug("Timeout while waiting for FPGA configuration status\n");
-        return BLADERF_ERR_TIMEOUT;
+        status = BLADERF_ERR_TIMEOUT;
+    } else {
+        done_ns = wallclock_get_current_nsec();
+        log_verbose("FPGA configured in %" PRIu64 " ms (%" PRIu64
+                    " ms transferring bitstream)\n",
+                    (done_ns - start_ns) / 1000000,
+                    (sent_ns - start_ns) / 1000000);
+        status = 0;
+
+        /* Record what was loaded, so that a later load of the same image
+         * may be skipped. This is only an optimization, so failures here are
+         * non-fatal. */
+        if (have_cap_dev(dev, BLADERF_CAP_FW_FPGA_HASH)) {
+            int hash_status = vendor_cmd(dev, USB_DIR_HOST_TO_DEVICE,
+                                         BLADE_USB_CMD_SET_FPGA_HASH, 0, 0,
+                                         digest, sizeof(digest));
+            if (hash_status != 0) {
+                log_debug("Failed to record FPGA image digest: %s\n",
+                          bladerf_strerror(hash_status));
+            }
+        }
     }
 
-    return 0;
+out:
+    free(compressed);
+    return status;
 }
 
 static inline int perform_erase(struct bladerf *dev, uint16_t block)
 {
     int status, erase_ret;
-    struct bladerf_usb *usb = dev->backend_data;
 
-    status = usb->fn->control_transfer(usb->driver,
-                                        USB_TARGET_DEVICE,
-                                        USB_REQUEST_VENDOR,
-                                        USB_DIR_DEVICE_TO_HOST,
-                                        BLADE_USB_CMD_FLASH_ERASE,
-                                        0, block,
-                                        &erase_ret, sizeof(erase_ret),
-                                        CTRL_TIMEOUT_MS);
+    status = vendor_cmd(dev, USB_DIR_DEVICE_TO_HOST,
+                        BLADE_USB_CMD_FLASH_ERASE, 0, block,
+                        &erase_ret, sizeof(erase_ret));
 
 
     return status;
@@ -573,16 +749,9 @@ static inline int read_page(struct bladerf *dev, uint8_t read_operation,
 
     /* Retrieve data from the firmware page buffer */
     for (offset = 0; offset < dev->flash_arch->psize_bytes; offset += read_size) {
-        status = usb->fn->control_transfer(usb->driver,
-                                           USB_TARGET_DEVICE,
-                                           USB_REQUEST_VENDOR,
-                                           USB_DIR_DEVICE_TO_HOST,
-                                           request,
-                                           0,
-                                           offset, /* in bytes */
-                                           buf + offset,
-                                           read_size,
-                                           CTRL_TIMEOUT_MS);
+        status = vendor_cmd(dev, USB_DIR_DEVICE_TO_HOST, request,
+                            0, offset, /* in bytes */
+                            buf + offset, read_size);
 
         if(status < 0) {
             log_debug("Failed to read page buffer at offset 0x%02x: %s\n",
@@ -594,14 +763,66 @@ static inline int read_page(struct bladerf *dev, uint8_t read_operation,
     return 0;
 }
 
+/* Maximum number of pages moved by a single multi-page flash request */
+#define FLASH_BULK_MAX_PAGES 256
+
+/* Timeout for the bulk transfer of a multi-page flash request */
+#define FLASH_BULK_TIMEOUT_MS (5 * CTRL_TIMEOUT_MS)
+
+/* Read or write contiguous pages with a single request, streaming them over
+ * the SPI flash interface's bulk endpoints */
+static int transfer_pages_bulk(struct bladerf *dev, uint8_t operation,
+                               uint16_t page, uint16_t count, uint8_t *buf)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    const bool is_read = (operation == BLADE_USB_CMD_FLASH_READ_PAGES);
+    const uint32_t len = (uint32_t)count * dev->flash_arch->psize_bytes;
+    int32_t op_status;
+    int status;
+
+    status = vendor_cmd(dev, USB_DIR_DEVICE_TO_HOST, operation, count, page,
+                        &op_status, sizeof(op_status));
+    if (status != 0) {
+        return status;
+    } else if (op_status != 0) {
+        log_error("Firmware multi-page request (op=%d) failed at page %u: "
+                  "%d\n", operation, page, op_status);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    status = usb->fn->bulk_transfer(usb->driver,
+                                    is_read ? PERIPHERAL_EP_IN
+                                            : PERIPHERAL_EP_OUT,
+                                    buf, len, FLASH_BULK_TIMEOUT_MS);
+    if (status != 0) {
+        log_debug("Failed to transfer %u pages starting at page %u: %s\n",
+                  count, page, bladerf_strerror(status));
+        return status;
+    }
+
+    /* This completes once the firmware has finished with the last page */
+    status = vendor_cmd_int(dev, BLADE_USB_CMD_FLASH_PAGES_STATUS,
+                            USB_DIR_DEVICE_TO_HOST, &op_status);
+    if (status != 0) {
+        return status;
+    } else if (op_status != 0) {
+        log_error("Firmware multi-page request (op=%d) failed after page %u: "
+                  "%d\n", operation, page, op_status);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    return 0;
+}
+
 static int usb_read_flash_pages(struct bladerf *dev,
                                 uint8_t *buf,
                                 uint32_t page_u32,
                                 uint32_t count_u32)
 {
-    int status;
+    int status, restore_status;
     size_t n_read;
-    uint16_t i;
+    uint16_t i, n;
+    bool bulk;
 
     /* 16-bit control transfer fields are used for these.
      * The current bladeRF build only has a 4MiB flash, anyway. */
@@ -616,28 +837,39 @@ static int usb_read_flash_pages(struct bladerf *dev,
         return status;
     }
 
+    bulk = have_cap(dev->board->get_capabilities(dev),
+                    BLADERF_CAP_FW_FLASH_BULK);
+
     log_info("Reading %u page%s starting at page %u\n", count,
              1 == count ? "" : "s", page);
 
-    for (n_read = i = 0; i < count; i++) {
+    for (n_read = i = 0; i < count; i += n) {
+        n = bulk ? (uint16_t)uint_min(count - i, FLASH_BULK_MAX_PAGES) : 1;
+
         log_info("Reading page %u (%u%%)...%c", page + i,
-                 (i + 1) == count ? 100 : 100 * i / count,
-                 (i + 1) == count ? '\n' : '\r');
+                 (i + n) == count ? 100 : 100 * i / count,
+                 (i + n) == count ? '\n' : '\r');
+
+        if (bulk) {
+            status = transfer_pages_bulk(dev, BLADE_USB_CMD_FLASH_READ_PAGES,
+                                         page + i, n, buf + n_read);
+        } else {
+            status = read_page(dev, BLADE_USB_CMD_FLASH_READ, page + i,
+                               buf + n_read);
+        }
 
-        status =
-            read_page(dev, BLADE_USB_CMD_FLASH_READ, page + i, buf + n_read);
         if (status != 0) {
             goto error;
         }
 
-        n_read += dev->flash_arch->psize_bytes;
+        n_read += (size_t)n * dev->flash_arch->psize_bytes;
     }
 
     log_info("Done reading %u page%s\n", count, 1 == count ? "" : "s");
 
 error:
-    status = restore_post_flash_setting(dev);
-    return status;
+    restore_status = restore_post_flash_setting(dev);
+    return status != 0 ? status : restore_status;
 }
 
 static int write_page(struct bladerf *dev, uint8_t write_operation,
@@ -668,16 +900,9 @@ static int write_page(struct bladerf *dev, uint8_t write_operation,
      * Casting away the buffer's const-ness here is gross, but this buffer
      * will not be written to on an out transfer. */
     for (offset = 0; offset < dev->flash_arch->psize_bytes; offset += write_size) {
-        status = usb->fn->control_transfer(usb->driver,
-                                            USB_TARGET_DEVICE,
-                                            USB_REQUEST_VENDOR,
-                                            USB_DIR_HOST_TO_DEVICE,
-                                            BLADE_USB_CMD_WRITE_PAGE_BUFFER,
-                                            0,
-                                            offset,
-                                            (uint8_t*)&buf[offset],
-                                            write_size,
-                                            CTRL_TIMEOUT_MS);
+        status = vendor_cmd(dev, USB_DIR_HOST_TO_DEVICE,
+                            BLADE_USB_CMD_WRITE_PAGE_BUFFER, 0, offset,
+                            (uint8_t*)&buf[offset], write_size);
 
         if(status < 0) {
             log_error("Failed to write page buffer at offset 0x%02x "
@@ -712,8 +937,9 @@ static int usb_write_flash_pages(struct bladerf *dev,
 
 {
     int status, restore_status;
-    uint16_t i;
+    uint16_t i, n;
     size_t n_written;
+    bool bulk;
 
     /* 16-bit control transfer fields are used for these.
      * The current bladeRF build only has a 4MiB flash, anyway. */
@@ -728,21 +954,36 @@ static int usb_write_flash_pages(struct bladerf *dev,
         return status;
     }
 
+    bulk = have_cap(dev->board->get_capabilities(dev),
+                    BLADERF_CAP_FW_FLASH_BULK);
+
     log_info("Writing %u page%s starting at page %u\n", count,
              1 == count ? "" : "s", page);
 
     n_written = 0;
-    for (i = 0; i < count; i++) {
+    for (i = 0; i < count; i += n) {
+        n = bulk ? (uint16_t)uint_min(count - i, FLASH_BULK_MAX_PAGES) : 1;
+
         log_info("Writing page %u (%u%%)...%c", page + i,
-                 (i + 1) == count ? 100 : 100 * i / count,
-                 (i + 1) == count ? '\n' : '\r');
+                 (i + n) == count ? 100 : 100 * i / count,
+                 (i + n) == count ? '\n' : '\r');
+
+        if (bulk) {
+            /* As with write_page(), this buffer is not written to on an
+             * out transfer */
+            status = transfer_pages_bulk(dev, BLADE_USB_CMD_FLASH_WRITE_PAGES,
+                                         page + i, n,
+                                         (uint8_t *)&buf[n_written]);
+        } else {
+            status = write_page(dev, BLADE_USB_CMD_FLASH_WRITE, page + i,
+                                buf + n_written);
+        }
 
-        status = write_page(dev, BLADE_USB_CMD_FLASH_WRITE, page + i, buf + n_written);
         if (status) {
             goto error;
         }
 
-        n_written += dev->flash_arch->psize_bytes;
+        n_written += (size_t)n * dev->flash_arch->psize_bytes;
     }
     log_info("Done writing %u page%s\n", count, 1 == count ? "" : "s");
 
@@ -757,27 +998,67 @@ error:
     }
 }
 
-static int usb_device_reset(struct bladerf *dev)
+static int usb_hash_flash_pages(struct bladerf *dev,
+                                uint32_t page_u32,
+                                uint32_t count_u32,
+                                uint8_t *digest)
 {
-    struct bladerf_usb *usb = dev->backend_data;
+    int status, restore_status;
+    int32_t op_status;
+    uint8_t resp[BLADE_FLASH_HASH_RESP_SIZE];
+
+    const uint16_t page  = (uint16_t)page_u32;
+    const uint16_t count = (uint16_t)count_u32;
+
+    assert(page == page_u32);
+    assert(count == count_u32);
+
+    if (!have_cap(dev->board->get_capabilities(dev),
+                  BLADERF_CAP_FW_FLASH_HASH)) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (count == 0 || count > BLADE_FLASH_HASH_MAX_PAGES) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    status = change_setting(dev, USB_IF_SPI_FLASH);
+    if (status != 0) {
+        return status;
+    }
 
-    return usb->fn->control_transfer(usb->driver, USB_TARGET_DEVICE,
-                                      USB_REQUEST_VENDOR,
-                                      USB_DIR_HOST_TO_DEVICE,
-                                      BLADE_USB_CMD_RESET,
-                                      0, 0, 0, 0, CTRL_TIMEOUT_MS);
+    status = vendor_cmd(dev, USB_DIR_DEVICE_TO_HOST,
+                        BLADE_USB_CMD_FLASH_SHA256, count, page,
+                        resp, sizeof(resp));
+    if (status == 0) {
+        memcpy(&op_status, resp, sizeof(op_status));
+        op_status = LE32_TO_HOST(op_status);
+
+        if (op_status != 0) {
+            log_error("Firmware failed to hash %u pages starting at page %u: "
+                      "%d\n", count, page, op_status);
+            status = BLADERF_ERR_UNEXPECTED;
+        } else {
+            memcpy(digest, resp + sizeof(op_status),
+                   sizeof(resp) - sizeof(op_status));
+        }
+    }
 
+    restore_status = restore_post_flash_setting(dev);
+    return status != 0 ? status : restore_status;
 }
 
-static int usb_jump_to_bootloader(struct bladerf *dev)
+static int usb_device_reset(struct bladerf *dev)
 {
-    struct bladerf_usb *usb = dev->backend_data;
+    return vendor_cmd(dev, USB_DIR_HOST_TO_DEVICE, BLADE_USB_CMD_RESET,
+                      0, 0, NULL, 0);
+
+}
 
-    return usb->fn->control_transfer(usb->driver, USB_TARGET_DEVICE,
-                                      USB_REQUEST_VENDOR,
-                                      USB_DIR_HOST_TO_DEVICE,
-                                      BLADE_USB_CMD_JUMP_TO_BOOTLOADER,
-                                      0, 0, 0, 0, CTRL_TIMEOUT_MS);
+static int usb_jump_to_bootloader(struct bladerf *dev)
+{
+    return vendor_cmd(dev, USB_DIR_HOST_TO_DEVICE,
+                      BLADE_USB_CMD_JUMP_TO_BOOTLOADER, 0, 0, NULL, 0);
 }
 
 static int usb_get_cal(struct bladerf *dev, char *cal)
@@ -891,6 +1172,91 @@ static int usb_get_firmware_loopback(struct bladerf *dev, bool *is_enabled)
     return status;
 }
 
+static int usb_set_sample_dma(struct bladerf *dev,
+                              unsigned int count,
+                              unsigned int packets)
+{
+    int32_t result = -1;
+    int status;
+
+    status = vendor_cmd(dev, USB_DIR_DEVICE_TO_HOST,
+                        BLADE_USB_CMD_SET_SAMPLE_DMA, count, packets,
+                        &result, sizeof(result));
+    if (status != 0) {
+        return status;
+    }
+
+    result = LE32_TO_HOST(result);
+    if (result != 0) {
+        log_debug("FX3 rejected %u DMA buffers of %u packets.\n", count,
+                  packets);
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* The buffers are allocated when the RF link interface is selected */
+    status = change_setting(dev, USB_IF_NULL);
+    if (status == 0) {
+        status = change_setting(dev, USB_IF_RF_LINK);
+    }
+
+    return status;
+}
+
+static int usb_get_sample_dma(struct bladerf *dev,
+                              unsigned int *count,
+                              unsigned int *packets)
+{
+    int32_t result;
+    int status;
+
+    status = vendor_cmd_int(dev, BLADE_USB_CMD_GET_SAMPLE_DMA,
+                            USB_DIR_DEVICE_TO_HOST, &result);
+    if (status == 0) {
+        result   = LE32_TO_HOST(result);
+        *count   = ((uint32_t)result >> 16) & 0xffff;
+        *packets = (uint32_t)result & 0xffff;
+    }
+
+    return status;
+}
+
+static int usb_get_fw_stats(struct bladerf *dev,
+                            struct bladerf_fx3_stats *stats,
+                            bool reset)
+{
+    uint32_t resp[BLADE_FW_STATS_NUM];
+    uint32_t counters[BLADE_FW_STATS_NUM];
+    uint32_t count;
+    size_t i;
+    int status;
+
+    status = vendor_cmd(dev, USB_DIR_DEVICE_TO_HOST,
+                        BLADE_USB_CMD_GET_FW_STATS, reset ? 1 : 0, 0,
+                        resp, sizeof(resp));
+    if (status != 0) {
+        return status;
+    }
+
+    memset(counters, 0, sizeof(counters));
+
+    /* Later firmware may append counters, which are ignored */
+    count = LE32_TO_HOST(resp[BLADE_FW_STATS_IDX_COUNT]);
+    for (i = 1; i < BLADE_FW_STATS_NUM && i <= count; i++) {
+        counters[i] = LE32_TO_HOST(resp[i]);
+    }
+
+    stats->tx_buffers      = counters[BLADE_FW_STATS_IDX_TX_BUFFERS];
+    stats->rx_buffers      = counters[BLADE_FW_STATS_IDX_RX_BUFFERS];
+    stats->rx_overruns     = counters[BLADE_FW_STATS_IDX_RX_OVERRUNS];
+    stats->tx_underruns    = counters[BLADE_FW_STATS_IDX_TX_UNDERRUNS];
+    stats->pib_errors      = counters[BLADE_FW_STATS_IDX_PIB_ERRORS];
+    stats->usb_retries     = counters[BLADE_FW_STATS_IDX_USB_RETRIES];
+    stats->usb_phy_errors  = counters[BLADE_FW_STATS_IDX_USB_PHY_ERRORS];
+    stats->usb_link_errors = counters[BLADE_FW_STATS_IDX_USB_LINK_ERRORS];
+
+    return 0;
+}
+
 static int usb_enable_module(struct bladerf *dev, bladerf_direction dir, bool enable)
 {
     int status;
@@ -954,6 +1320,23 @@ static void usb_deinit_stream(struct bladerf_stream *stream)
     usb->fn->deinit_stream(usb->driver, stream);
 }
 
+static void *usb_alloc_stream_mem(struct bladerf *dev, size_t len)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+
+    if (usb->fn->dev_mem_alloc == NULL) {
+        return NULL;
+    }
+
+    return usb->fn->dev_mem_alloc(usb->driver, len);
+}
+
+static void usb_free_stream_mem(struct bladerf *dev, void *mem, size_t len)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    usb->fn->dev_mem_free(usb->driver, mem, len);
+}
+
 /*
  * Information about the boot image format and boot over USB can be found in
  * Cypress AN76405: EZ-USB (R) FX3 (TM) Boot Options:
@@ -970,12 +1353,11 @@ static void usb_deinit_stream(struct bladerf_stream *stream)
 #define FX3_BOOTLOADER_ADDR_WINDEX(addr) (HOST_TO_LE16(((addr >> 16) & 0xffff)))
 #define FX3_BOOTLOADER_MAX_LOAD_LEN      4096
 
-static int write_and_verify_fw_chunk(struct bladerf_usb *usb, uint32_t addr,
-                                     uint8_t *data, uint32_t len,
-                                     uint8_t *readback_buf) {
-
+static int write_fw_chunk(struct bladerf_usb *usb, uint32_t addr,
+                          uint8_t *data, uint32_t len)
+{
     int status;
-    log_verbose("Writing %u bytes to bootloader @ 0x%08x\n", len, addr);
+
     status = usb->fn->control_transfer(usb->driver,
                                        USB_TARGET_DEVICE,
                                        USB_REQUEST_VENDOR,
@@ -988,11 +1370,20 @@ static int write_and_verify_fw_chunk(struct bladerf_usb *usb, uint32_t addr,
                                        CTRL_TIMEOUT_MS);
 
     if (status != 0) {
-        log_debug("Failed to write FW chunk (%d)\n", status);
-        return status;
+        log_debug("Failed to write FW chunk @ 0x%08x (%d)\n", addr, status);
     }
 
-    log_verbose("Reading back %u bytes from bootloader @ 0x%08x\n", len, addr);
+    return status;
+}
+
+/* Read back a chunk of FX3 RAM, adding its 32-bit words to `checksum' */
+static int checksum_fw_chunk(struct bladerf_usb *usb, uint32_t addr,
+                             uint32_t len, uint8_t *readback_buf,
+                             uint32_t *checksum)
+{
+    int status;
+    uint32_t i, word;
+
     status = usb->fn->control_transfer(usb->driver,
                                        USB_TARGET_DEVICE,
                                        USB_REQUEST_VENDOR,
@@ -1005,16 +1396,20 @@ static int write_and_verify_fw_chunk(struct bladerf_usb *usb, uint32_t addr,
                                        CTRL_TIMEOUT_MS);
 
     if (status != 0) {
-        log_debug("Failed to read back FW chunk (%d)\n", status);
+        log_debug("Failed to read back FW chunk @ 0x%08x (%d)\n",
+                  addr, status);
         return status;
     }
 
-    if (memcmp(data, readback_buf, len) != 0) {
-        log_debug("Readback did match written data.\n");
-        status = BLADERF_ERR_UNEXPECTED;
+    /* Section lengths are specified in words */
+    assert((len % sizeof(uint32_t)) == 0);
+
+    for (i = 0; i < len; i += sizeof(uint32_t)) {
+        memcpy(&word, &readback_buf[i], sizeof(word));
+        *checksum += LE32_TO_HOST(word);
     }
 
-    return status;
+    return 0;
 }
 
 static int execute_fw_from_bootloader(struct bladerf_usb *usb, uint32_t addr)
@@ -1048,19 +1443,26 @@ static int execute_fw_from_bootloader(struct bladerf_usb *usb, uint32_t addr)
     return status;
 }
 
+/* The ROM bootloader only accepts firmware via control transfers, so the
+ * upload cannot be moved to a bulk endpoint. Instead, every section is
+ * written back-to-back, and then the image is verified in a single pass that
+ * reads it back and compares its sum against the image's own checksum, rather
+ * than interleaving a readback and comparison with each chunk written.
+ *
+ * The verification pass may be skipped by defining
+ * BLADERF_SKIP_BOOTLOADER_VERIFY, for RAM-boot scenarios where the upload
+ * time matters more than detecting a corrupted transfer. */
 static int write_fw_to_bootloader(void *driver, struct fx3_firmware *fw)
 {
     int status = 0;
     uint32_t to_write;
     uint32_t data_len;
     uint32_t addr;
+    uint32_t checksum = 0;
     uint8_t *data;
     bool got_section;
-
-    uint8_t *readback = malloc(FX3_BOOTLOADER_MAX_LOAD_LEN);
-    if (readback == NULL) {
-        return BLADERF_ERR_MEM;
-    }
+    uint8_t *readback = NULL;
+    uint64_t start = wallclock_get_current_nsec();
 
     do {
         got_section = fx3_fw_next_section(fw, &addr, &data, &data_len);
@@ -1069,12 +1471,13 @@ static int write_fw_to_bootloader(void *driver, struct fx3_firmware *fw)
              * include the terminating section in its count */
             assert(data_len != 0);
 
+            log_verbose("Writing %u bytes to bootloader @ 0x%08x\n",
+                        data_len, addr);
+
             do {
                 to_write = u32_min(data_len, FX3_BOOTLOADER_MAX_LOAD_LEN);
 
-                status = write_and_verify_fw_chunk(driver,
-                                                   addr, data, to_write,
-                                                   readback);
+                status = write_fw_chunk(driver, addr, data, to_write);
 
                 data_len -= to_write;
                 addr += to_write;
@@ -1083,12 +1486,54 @@ static int write_fw_to_bootloader(void *driver, struct fx3_firmware *fw)
         }
     } while (got_section && status == 0);
 
-    if (status == 0) {
-        status = execute_fw_from_bootloader(driver, fx3_fw_entry_point(fw));
+    if (status != 0) {
+        return status;
     }
 
+    log_verbose("Firmware upload took %" PRIu64 " ms\n",
+                (wallclock_get_current_nsec() - start) / 1000000);
+
+    if (getenv("BLADERF_SKIP_BOOTLOADER_VERIFY")) {
+        log_info("Skipping verification of firmware uploaded to bootloader.\n");
+        goto exec;
+    }
+
+    readback = malloc(FX3_BOOTLOADER_MAX_LOAD_LEN);
+    if (readback == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    fx3_fw_rewind(fw);
+
+    do {
+        got_section = fx3_fw_next_section(fw, &addr, &data, &data_len);
+        while (got_section && data_len != 0 && status == 0) {
+            to_write = u32_min(data_len, FX3_BOOTLOADER_MAX_LOAD_LEN);
+
+            status = checksum_fw_chunk(driver, addr, to_write, readback,
+                                       &checksum);
+
+            data_len -= to_write;
+            addr += to_write;
+        }
+    } while (got_section && status == 0);
+
     free(readback);
-    return status;
+
+    if (status != 0) {
+        return status;
+    }
+
+    if (checksum != fx3_fw_checksum(fw)) {
+        log_debug("Readback checksum 0x%08x did not match image's 0x%08x.\n",
+                  checksum, fx3_fw_checksum(fw));
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    log_verbose("Readback checksum OK.\n");
+
+exec:
+    return execute_fw_from_bootloader(driver, fx3_fw_entry_point(fw));
 }
 
 static int usb_load_fw_from_bootloader(bladerf_backend backend,
@@ -1205,6 +1650,7 @@ const struct backend_fns backend_fns_usb_legacy = {
     FIELD_INIT(.matches, usb_matches),
 
     FIELD_INIT(.probe, usb_probe),
+    FIELD_INIT(.set_device_monitor, usb_set_device_monitor),
 
     FIELD_INIT(.get_vid_pid, usb_get_vid_pid),
     FIELD_INIT(.get_flash_id, usb_get_flash_id),
@@ -1219,6 +1665,7 @@ const struct backend_fns backend_fns_usb_legacy = {
     FIELD_INIT(.load_fpga, usb_load_fpga),
     FIELD_INIT(.is_fpga_configured, usb_is_fpga_configured),
     FIELD_INIT(.get_fpga_source, usb_get_fpga_source),
+    FIELD_INIT(.is_fpga_image_loaded, usb_is_fpga_image_loaded),
 
     FIELD_INIT(.get_fw_version, usb_get_fw_version),
     FIELD_INIT(.get_fpga_version, usb_get_fpga_version),
@@ -1226,6 +1673,7 @@ const struct backend_fns backend_fns_usb_legacy = {
     FIELD_INIT(.erase_flash_blocks, usb_erase_flash_blocks),
     FIELD_INIT(.read_flash_pages, usb_read_flash_pages),
     FIELD_INIT(.write_flash_pages, usb_write_flash_pages),
+    FIELD_INIT(.hash_flash_pages, usb_hash_flash_pages),
 
     FIELD_INIT(.device_reset, usb_device_reset),
     FIELD_INIT(.jump_to_bootloader, usb_jump_to_bootloader),
@@ -1252,6 +1700,7 @@ const struct backend_fns backend_fns_usb_legacy = {
     FIELD_INIT(.set_agc_dc_correction, set_agc_dc_correction_unsupported),
 
     FIELD_INIT(.get_timestamp, nios_legacy_get_timestamp),
+    FIELD_INIT(.get_timestamp_latch, nios_legacy_get_timestamp_latch),
 
     FIELD_INIT(.si5338_write, nios_legacy_si5338_write),
     FIELD_INIT(.si5338_read, nios_legacy_si5338_read),
@@ -1259,6 +1708,14 @@ const struct backend_fns backend_fns_usb_legacy = {
     FIELD_INIT(.lms_write, nios_legacy_lms6_write),
     FIELD_INIT(.lms_read, nios_legacy_lms6_read),
 
+    FIELD_INIT(.si5338_batch, nios_legacy_si5338_batch),
+    FIELD_INIT(.lms_batch, nios_legacy_lms6_batch),
+    FIELD_INIT(.si5338_block, nios_legacy_si5338_block),
+    FIELD_INIT(.lms_block, nios_legacy_lms6_block),
+    FIELD_INIT(.lms_vcocap_search, nios_legacy_lms6_vcocap_search),
+    FIELD_INIT(.lms_dc_cal_loop, nios_legacy_lms6_dc_cal_loop),
+    FIELD_INIT(.lms_dc_cal_load, nios_legacy_lms6_dc_cal_load),
+
     FIELD_INIT(.ina219_write, nios_legacy_ina219_write),
     FIELD_INIT(.ina219_read, nios_legacy_ina219_read),
 
@@ -1270,11 +1727,28 @@ const struct backend_fns backend_fns_usb_legacy = {
 
     FIELD_INIT(.rfic_command_write, nios_legacy_rfic_command_write),
     FIELD_INIT(.rfic_command_read, nios_legacy_rfic_command_read),
+    FIELD_INIT(.rfic_command_wait, nios_legacy_rfic_command_wait),
 
     FIELD_INIT(.rffe_control_write, nios_legacy_rffe_control_write),
     FIELD_INIT(.rffe_control_read, nios_legacy_rffe_control_read),
 
     FIELD_INIT(.rffe_fastlock_save, nios_legacy_rffe_fastlock_save),
+    FIELD_INIT(.rffe_fastlock_read, nios_legacy_rffe_fastlock_read),
+    FIELD_INIT(.rffe_fastlock_write, nios_legacy_rffe_fastlock_write),
+    FIELD_INIT(.rx_ddc_write, nios_legacy_rx_ddc_write),
+    FIELD_INIT(.rx_ddc_read, nios_legacy_rx_ddc_read),
+    FIELD_INIT(.tx_duc_write, nios_legacy_tx_duc_write),
+    FIELD_INIT(.tx_duc_read, nios_legacy_tx_duc_read),
+    FIELD_INIT(.rx_power_write, nios_legacy_rx_power_write),
+    FIELD_INIT(.rx_power_read, nios_legacy_rx_power_read),
+    FIELD_INIT(.rx_burst_write, nios_legacy_rx_burst_write),
+    FIELD_INIT(.rx_burst_read, nios_legacy_rx_burst_read),
+    FIELD_INIT(.fifo_level_write, nios_legacy_fifo_level_write),
+    FIELD_INIT(.fifo_level_read, nios_legacy_fifo_level_read),
+    FIELD_INIT(.tx_loop_write, nios_legacy_tx_loop_write),
+    FIELD_INIT(.tx_loop_read, nios_legacy_tx_loop_read),
+    FIELD_INIT(.vctcxo_tamer_write, nios_legacy_vctcxo_tamer_write),
+    FIELD_INIT(.vctcxo_tamer_read, nios_legacy_vctcxo_tamer_read),
 
     FIELD_INIT(.ad56x1_vctcxo_trim_dac_write, nios_legacy_ad56x1_vctcxo_trim_dac_write),
     FIELD_INIT(.ad56x1_vctcxo_trim_dac_read, nios_legacy_ad56x1_vctcxo_trim_dac_read),
@@ -1292,6 +1766,9 @@ const struct backend_fns backend_fns_usb_legacy = {
 
     FIELD_INIT(.set_firmware_loopback, usb_set_firmware_loopback),
     FIELD_INIT(.get_firmware_loopback, usb_get_firmware_loopback),
+    FIELD_INIT(.set_sample_dma, usb_set_sample_dma),
+    FIELD_INIT(.get_sample_dma, usb_get_sample_dma),
+    FIELD_INIT(.get_fw_stats, usb_get_fw_stats),
 
     FIELD_INIT(.enable_module, usb_enable_module),
 
@@ -1299,9 +1776,15 @@ const struct backend_fns backend_fns_usb_legacy = {
     FIELD_INIT(.stream, usb_stream),
     FIELD_INIT(.submit_stream_buffer, usb_submit_stream_buffer),
     FIELD_INIT(.deinit_stream, usb_deinit_stream),
+    FIELD_INIT(.alloc_stream_mem, usb_alloc_stream_mem),
+    FIELD_INIT(.free_stream_mem, usb_free_stream_mem),
 
     FIELD_INIT(.retune, nios_retune),
+    FIELD_INIT(.retune_corr, nios_retune_corr),
     FIELD_INIT(.retune2, nios_retune2),
+    FIELD_INIT(.retune2_param, nios_retune2_param),
+    FIELD_INIT(.retune2_pair, nios_retune2_pair),
+    FIELD_INIT(.get_retune_stats, nios_legacy_get_retune_stats),
 
     FIELD_INIT(.load_fw_from_bootloader, usb_load_fw_from_bootloader),
 
@@ -1309,6 +1792,8 @@ const struct backend_fns backend_fns_usb_legacy = {
 
     FIELD_INIT(.read_trigger, nios_legacy_read_trigger),
     FIELD_INIT(.write_trigger, nios_legacy_write_trigger),
+    FIELD_INIT(.trigger_fire_at, nios_legacy_trigger_fire_at),
+    FIELD_INIT(.trigger_fire_time, nios_legacy_trigger_fire_time),
 
     FIELD_INIT(.name, "usb"),
 };
@@ -1318,6 +1803,7 @@ const struct backend_fns backend_fns_usb = {
     FIELD_INIT(.matches, usb_matches),
 
     FIELD_INIT(.probe, usb_probe),
+    FIELD_INIT(.set_device_monitor, usb_set_device_monitor),
 
     FIELD_INIT(.get_vid_pid, usb_get_vid_pid),
     FIELD_INIT(.get_flash_id, usb_get_flash_id),
@@ -1332,6 +1818,7 @@ const struct backend_fns backend_fns_usb = {
     FIELD_INIT(.load_fpga, usb_load_fpga),
     FIELD_INIT(.is_fpga_configured, usb_is_fpga_configured),
     FIELD_INIT(.get_fpga_source, usb_get_fpga_source),
+    FIELD_INIT(.is_fpga_image_loaded, usb_is_fpga_image_loaded),
 
     FIELD_INIT(.get_fw_version, usb_get_fw_version),
     FIELD_INIT(.get_fpga_version, usb_get_fpga_version),
@@ -1339,6 +1826,7 @@ const struct backend_fns backend_fns_usb = {
     FIELD_INIT(.erase_flash_blocks, usb_erase_flash_blocks),
     FIELD_INIT(.read_flash_pages, usb_read_flash_pages),
     FIELD_INIT(.write_flash_pages, usb_write_flash_pages),
+    FIELD_INIT(.hash_flash_pages, usb_hash_flash_pages),
 
     FIELD_INIT(.device_reset, usb_device_reset),
     FIELD_INIT(.jump_to_bootloader, usb_jump_to_bootloader),
@@ -1365,6 +1853,7 @@ const struct backend_fns backend_fns_usb = {
     FIELD_INIT(.set_agc_dc_correction, nios_set_agc_dc_correction),
 
     FIELD_INIT(.get_timestamp, nios_get_timestamp),
+    FIELD_INIT(.get_timestamp_latch, nios_get_timestamp_latch),
 
     FIELD_INIT(.si5338_write, nios_si5338_write),
     FIELD_INIT(.si5338_read, nios_si5338_read),
@@ -1372,22 +1861,48 @@ const struct backend_fns backend_fns_usb = {
     FIELD_INIT(.lms_write, nios_lms6_write),
     FIELD_INIT(.lms_read, nios_lms6_read),
 
+    FIELD_INIT(.si5338_batch, nios_si5338_batch),
+    FIELD_INIT(.lms_batch, nios_lms6_batch),
+    FIELD_INIT(.si5338_block, nios_si5338_block),
+    FIELD_INIT(.lms_block, nios_lms6_block),
+    FIELD_INIT(.lms_vcocap_search, nios_lms6_vcocap_search),
+    FIELD_INIT(.lms_dc_cal_loop, nios_lms6_dc_cal_loop),
+    FIELD_INIT(.lms_dc_cal_load, nios_lms6_dc_cal_load),
+
     FIELD_INIT(.ina219_write, nios_ina219_write),
     FIELD_INIT(.ina219_read, nios_ina219_read),
 
     FIELD_INIT(.ad9361_spi_write, nios_ad9361_spi_write),
     FIELD_INIT(.ad9361_spi_read, nios_ad9361_spi_read),
+    FIELD_INIT(.ad9361_spi_batch, nios_ad9361_spi_batch),
 
     FIELD_INIT(.adi_axi_write, nios_adi_axi_write),
     FIELD_INIT(.adi_axi_read, nios_adi_axi_read),
 
     FIELD_INIT(.rfic_command_write, nios_rfic_command_write),
     FIELD_INIT(.rfic_command_read, nios_rfic_command_read),
+    FIELD_INIT(.rfic_command_wait, nios_rfic_command_wait),
 
     FIELD_INIT(.rffe_control_write, nios_rffe_control_write),
     FIELD_INIT(.rffe_control_read, nios_rffe_control_read),
 
     FIELD_INIT(.rffe_fastlock_save, nios_rffe_fastlock_save),
+    FIELD_INIT(.rffe_fastlock_read, nios_rffe_fastlock_read),
+    FIELD_INIT(.rffe_fastlock_write, nios_rffe_fastlock_write),
+    FIELD_INIT(.rx_ddc_write, nios_rx_ddc_write),
+    FIELD_INIT(.rx_ddc_read, nios_rx_ddc_read),
+    FIELD_INIT(.tx_duc_write, nios_tx_duc_write),
+    FIELD_INIT(.tx_duc_read, nios_tx_duc_read),
+    FIELD_INIT(.rx_power_write, nios_rx_power_write),
+    FIELD_INIT(.rx_power_read, nios_rx_power_read),
+    FIELD_INIT(.rx_burst_write, nios_rx_burst_write),
+    FIELD_INIT(.rx_burst_read, nios_rx_burst_read),
+    FIELD_INIT(.fifo_level_write, nios_fifo_level_write),
+    FIELD_INIT(.fifo_level_read, nios_fifo_level_read),
+    FIELD_INIT(.tx_loop_write, nios_tx_loop_write),
+    FIELD_INIT(.tx_loop_read, nios_tx_loop_read),
+    FIELD_INIT(.vctcxo_tamer_write, nios_vctcxo_tamer_write),
+    FIELD_INIT(.vctcxo_tamer_read, nios_vctcxo_tamer_read),
 
     FIELD_INIT(.ad56x1_vctcxo_trim_dac_write, nios_ad56x1_vctcxo_trim_dac_write),
     FIELD_INIT(.ad56x1_vctcxo_trim_dac_read, nios_ad56x1_vctcxo_trim_dac_read),
@@ -1405,6 +1920,9 @@ const struct backend_fns backend_fns_usb = {
 
     FIELD_INIT(.set_firmware_loopback, usb_set_firmware_loopback),
     FIELD_INIT(.get_firmware_loopback, usb_get_firmware_loopback),
+    FIELD_INIT(.set_sample_dma, usb_set_sample_dma),
+    FIELD_INIT(.get_sample_dma, usb_get_sample_dma),
+    FIELD_INIT(.get_fw_stats, usb_get_fw_stats),
 
     FIELD_INIT(.enable_module, usb_enable_module),
 
@@ -1412,9 +1930,15 @@ const struct backend_fns backend_fns_usb = {
     FIELD_INIT(.stream, usb_stream),
     FIELD_INIT(.submit_stream_buffer, usb_submit_stream_buffer),
     FIELD_INIT(.deinit_stream, usb_deinit_stream),
+    FIELD_INIT(.alloc_stream_mem, usb_alloc_stream_mem),
+    FIELD_INIT(.free_stream_mem, usb_free_stream_mem),
 
     FIELD_INIT(.retune, nios_retune),
+    FIELD_INIT(.retune_corr, nios_retune_corr),
     FIELD_INIT(.retune2, nios_retune2),
+    FIELD_INIT(.retune2_param, nios_retune2_param),
+    FIELD_INIT(.retune2_pair, nios_retune2_pair),
+    FIELD_INIT(.get_retune_stats, nios_get_retune_stats),
 
     FIELD_INIT(.load_fw_from_bootloader, usb_load_fw_from_bootloader),
 
@@ -1422,6 +1946,8 @@ const struct backend_fns backend_fns_usb = {
 
     FIELD_INIT(.read_trigger, nios_read_trigger),
     FIELD_INIT(.write_trigger, nios_write_trigger),
+    FIELD_INIT(.trigger_fire_at, nios_trigger_fire_at),
+    FIELD_INIT(.trigger_fire_time, nios_trigger_fire_time),
 
     FIELD_INIT(.name, "usb"),
 };
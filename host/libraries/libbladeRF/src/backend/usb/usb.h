@@ -25,6 +25,7 @@
 #include "host_config.h"
 
 #include "board/board.h"
+#include "helpers/reg_shadow.h"
 
 #if ENABLE_USB_DEV_RESET_ON_OPEN
 extern bool bladerf_usb_reset_device_on_open;
@@ -92,6 +93,10 @@ struct usb_fns {
     int (*probe)(backend_probe_target probe_target,
                  struct bladerf_devinfo_list *info_list);
 
+    /* Start or stop maintaining a list of attached devices in the background,
+     * for use by probe() and open(). May be NULL if unsupported. */
+    int (*set_device_monitor)(bool enable);
+
     /* Populates the `driver` pointer with a handle for the specific USB driver.
      * `info_in` describes the device to open, and may contain wildcards.
      * On success, the driver should fill in `info_out` with the complete
@@ -153,6 +158,10 @@ struct usb_fns {
 
     int (*open_bootloader)(void **driver, uint8_t bus, uint8_t addr);
     void (*close_bootloader)(void *driver);
+
+    /* Optional: memory for zero-copy stream buffers. NULL if unsupported. */
+    void *(*dev_mem_alloc)(void *driver, size_t len);
+    void (*dev_mem_free)(void *driver, void *mem, size_t len);
 };
 
 struct usb_driver {
@@ -163,6 +172,11 @@ struct usb_driver {
 struct bladerf_usb {
     const struct usb_fns *fn;
     void *driver;
+
+    /* Shadows of register accesses made via the NIOS II. See nios_access.c */
+    struct reg_shadow lms_shadow;
+    struct reg_shadow si5338_shadow;
+    struct reg_shadow ad9361_shadow;
 };
 
 #endif
@@ -0,0 +1,302 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "log.h"
+#include "minmax.h"
+
+#include "backend/backend.h"
+#include "backend/usb/usb.h"
+#include "backend/usb/usb_bench.h"
+#include "helpers/file.h"
+#include "helpers/wallclock.h"
+
+#include "bladeRF.h"
+
+/* Increment when the cache file format changes */
+#define USB_BENCH_CACHE_FORMAT 1
+
+#define USB_BENCH_CACHE_FILE "usb-backend.cache"
+
+/* Round trips of a single DMA buffer used to measure latency */
+#define USB_BENCH_LATENCY_ITERATIONS 64
+
+/* Bytes looped back, in each direction, to measure throughput */
+#define USB_BENCH_THROUGHPUT_BYTES (8 * 1024 * 1024)
+
+/* Largest number of DMA buffers written before they are read back */
+#define USB_BENCH_MAX_CHUNK_BUFFERS 8
+
+struct usb_bench_result {
+    double throughput; /* Bytes per second, both directions combined */
+    double latency;    /* Seconds per single-buffer round trip */
+};
+
+static int lb_vendor_cmd(const struct usb_fns *fn, void *driver, uint8_t cmd,
+                         uint16_t wvalue, int32_t *result)
+{
+    return fn->control_transfer(driver, USB_TARGET_DEVICE, USB_REQUEST_VENDOR,
+                                USB_DIR_DEVICE_TO_HOST, cmd, wvalue, 0, result,
+                                sizeof(*result), CTRL_TIMEOUT_MS);
+}
+
+static int lb_round_trip(const struct usb_fns *fn, void *driver,
+                         uint8_t *buf, uint32_t len)
+{
+    int status;
+
+    status = fn->bulk_transfer(driver, SAMPLE_EP_OUT, buf, len,
+                               BULK_TIMEOUT_MS);
+    if (status == 0) {
+        status = fn->bulk_transfer(driver, SAMPLE_EP_IN, buf, len,
+                                   BULK_TIMEOUT_MS);
+    }
+
+    return status;
+}
+
+/* Time bulk transfers through an open device's firmware loopback. Data
+ * written to the sample OUT endpoint is returned on the sample IN endpoint
+ * in whole DMA buffers, so every transfer is a multiple of the buffer size
+ * and no more buffers are written than the FX3 can hold. */
+static int lb_measure(const struct usb_fns *fn, void *driver,
+                      struct usb_bench_result *result)
+{
+    bladerf_dev_speed speed;
+    unsigned int count   = BLADE_SAMPLE_DMA_DEFAULT_COUNT;
+    unsigned int packets = BLADE_SAMPLE_DMA_DEFAULT_PACKETS;
+    uint32_t buf_size, chunk;
+    uint64_t start, elapsed;
+    uint8_t *buf;
+    int32_t dma;
+    size_t i, n;
+    int status;
+
+    status = fn->get_speed(driver, &speed);
+    if (status != 0) {
+        return status;
+    }
+
+    /* Older firmware does not support reading back its DMA configuration */
+    if (lb_vendor_cmd(fn, driver, BLADE_USB_CMD_GET_SAMPLE_DMA, 0, &dma) == 0) {
+        dma     = LE32_TO_HOST(dma);
+        count   = ((uint32_t)dma >> 16) & 0xffff;
+        packets = (uint32_t)dma & 0xffff;
+    }
+
+    buf_size = packets * (speed == BLADERF_DEVICE_SPEED_SUPER ? 1024 : 512);
+    chunk    = buf_size * uint_min(count, USB_BENCH_MAX_CHUNK_BUFFERS);
+
+    if (buf_size == 0 || chunk == 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    buf = calloc(1, chunk);
+    if (buf == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    start = wallclock_get_current_nsec();
+    for (i = 0; i < USB_BENCH_LATENCY_ITERATIONS && status == 0; i++) {
+        status = lb_round_trip(fn, driver, buf, buf_size);
+    }
+    elapsed = wallclock_get_current_nsec() - start;
+
+    if (status != 0) {
+        goto out;
+    }
+
+    result->latency = (elapsed / 1e9) / USB_BENCH_LATENCY_ITERATIONS;
+
+    n     = USB_BENCH_THROUGHPUT_BYTES / chunk;
+    start = wallclock_get_current_nsec();
+    for (i = 0; i < n && status == 0; i++) {
+        status = lb_round_trip(fn, driver, buf, chunk);
+    }
+    elapsed = wallclock_get_current_nsec() - start;
+
+    if (status == 0 && elapsed != 0) {
+        result->throughput = (2.0 * n * chunk) / (elapsed / 1e9);
+    }
+
+out:
+    free(buf);
+    return status;
+}
+
+static int bench_driver(const struct usb_driver *drv,
+                        struct bladerf_devinfo *info,
+                        struct usb_bench_result *result)
+{
+    const struct usb_fns *fn = drv->fn;
+    struct bladerf_devinfo ident;
+    void *driver = NULL;
+    int32_t fx3_ret;
+    int status;
+
+    status = fn->open(&driver, info, &ident);
+    if (status != 0) {
+        return status;
+    }
+
+    /* The loopback setting takes effect when the RF link is selected */
+    status = lb_vendor_cmd(fn, driver, BLADE_USB_CMD_SET_LOOPBACK, 1, &fx3_ret);
+    if (status == 0) {
+        status = fn->change_setting(driver, USB_IF_NULL);
+    }
+    if (status == 0) {
+        status = fn->change_setting(driver, USB_IF_RF_LINK);
+    }
+    if (status == 0) {
+        status = lb_measure(fn, driver, result);
+    }
+
+    fn->change_setting(driver, USB_IF_NULL);
+    lb_vendor_cmd(fn, driver, BLADE_USB_CMD_SET_LOOPBACK, 0, &fx3_ret);
+    fn->close(driver);
+
+    return status;
+}
+
+static int cache_load(const char *path,
+                      const struct usb_driver *const *drivers,
+                      size_t num_drivers,
+                      size_t *selected)
+{
+    char name[32];
+    unsigned int format;
+    bladerf_backend backend;
+    size_t i;
+    int status = BLADERF_ERR_INVAL;
+    FILE *f;
+
+    f = fopen(path, "r");
+    if (f == NULL) {
+        return BLADERF_ERR_NO_FILE;
+    }
+
+    if (fscanf(f, "format=%u\nbackend=%31s", &format, name) != 2 ||
+        format != USB_BENCH_CACHE_FORMAT ||
+        str2backend(name, &backend) != 0) {
+        goto out;
+    }
+
+    for (i = 0; i < num_drivers; i++) {
+        if (drivers[i]->id == backend) {
+            *selected = i;
+            status    = 0;
+            break;
+        }
+    }
+
+out:
+    fclose(f);
+    return status;
+}
+
+static void cache_store(const char *path, bladerf_backend backend)
+{
+    FILE *f;
+
+    f = fopen(path, "w");
+    if (f == NULL) {
+        log_debug("Unable to write USB backend cache %s\n", path);
+        return;
+    }
+
+    fprintf(f, "format=%u\nbackend=%s\n", USB_BENCH_CACHE_FORMAT,
+            backend2str(backend));
+
+    if (fclose(f) != 0) {
+        log_debug("Failed to write USB backend cache %s\n", path);
+        remove(path);
+    }
+}
+
+size_t usb_bench_select(struct bladerf_devinfo *info,
+                        const struct usb_driver *const *drivers,
+                        size_t num_drivers)
+{
+    struct usb_bench_result best = { 0.0, 0.0 };
+    size_t selected = 0;
+    bool found = false;
+    char *path;
+    size_t i;
+    int status;
+
+    if (num_drivers < 2 || !getenv("BLADERF_USB_BACKEND_BENCHMARK")) {
+        return 0;
+    }
+
+    path = file_user_path(USB_BENCH_CACHE_FILE);
+
+    if (path != NULL &&
+        cache_load(path, drivers, num_drivers, &selected) == 0) {
+        log_verbose("Using cached USB backend selection from %s\n", path);
+        free(path);
+        return selected;
+    }
+
+    for (i = 0; i < num_drivers; i++) {
+        struct usb_bench_result result = { 0.0, 0.0 };
+        const char *name = backend2str(drivers[i]->id);
+
+        /* Served devices are reached via the server's own driver */
+        if (drivers[i]->id == BLADERF_BACKEND_SHM) {
+            continue;
+        }
+
+        status = bench_driver(drivers[i], info, &result);
+        if (status != 0) {
+            log_debug("Unable to benchmark the %s backend: %s\n", name,
+                      bladerf_strerror(status));
+            continue;
+        }
+
+        log_info("USB backend %s: %.1f MB/s loopback, %.1f us latency\n",
+                 name, result.throughput / 1e6, result.latency * 1e6);
+
+        if (!found || result.throughput > best.throughput ||
+            (result.throughput == best.throughput &&
+             result.latency < best.latency)) {
+            best     = result;
+            selected = i;
+            found    = true;
+        }
+    }
+
+    if (found) {
+        log_info("Selected the %s USB backend.\n",
+                 backend2str(drivers[selected]->id));
+
+        if (path != NULL) {
+            cache_store(path, drivers[selected]->id);
+        }
+    }
+
+    free(path);
+    return selected;
+}
@@ -0,0 +1,50 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef BACKEND_USB_BENCH_H_
+#define BACKEND_USB_BENCH_H_
+
+#include <stddef.h>
+
+#include "backend/usb/usb.h"
+
+/**
+ * Choose which USB driver to try first when opening a device with
+ * BLADERF_BACKEND_ANY
+ *
+ * This only has an effect when BLADERF_USB_BACKEND_BENCHMARK is defined in
+ * the environment. The driver named in the user's usb-backend.cache is
+ * returned if it is one of `drivers`. Otherwise, each driver is used to open
+ * the device described by `info` and time bulk transfers through the FX3's
+ * firmware loopback. The driver with the highest throughput (or, for equal
+ * throughput, the lowest latency) is returned and recorded in the cache.
+ *
+ * @param[in]   info        Device to open
+ * @param[in]   drivers     Available USB drivers, in their default order
+ * @param[in]   num_drivers Number of entries in `drivers`
+ *
+ * @return Index into `drivers` of the driver to try first
+ */
+size_t usb_bench_select(struct bladerf_devinfo *info,
+                        const struct usb_driver *const *drivers,
+                        size_t num_drivers);
+
+#endif
@@ -28,16 +28,22 @@
 #include <libbladeRF.h>
 
 #include "log.h"
+#include "minmax.h"
 #include "rel_assert.h"
+#include "sample_convert.h"
 #define LOGGER_ID_STRING
 #include "logger_entry.h"
 #include "logger_id.h"
 
 #include "backend/backend.h"
+#include "backend/usb/shm_server.h"
 #include "backend/usb/usb.h"
 #include "board/board.h"
+#include "board/bladerf1/flash.h"
 #include "driver/fx3_fw.h"
 #include "streaming/async.h"
+#include "streaming/sync.h"
+#include "streaming/sync_worker.h"
 #include "version.h"
 
 #include "expansion/xb100.h"
@@ -45,10 +51,30 @@
 #include "expansion/xb300.h"
 
 #include "devinfo.h"
+#include "helpers/alloc.h"
+#include "helpers/cal_cache.h"
+#include "helpers/sample_cal.h"
+#include "helpers/state_cache.h"
 #include "helpers/configfile.h"
+#include "helpers/ctrl_queue.h"
+#include "helpers/ctrl_trace.h"
+#include "helpers/timeline.h"
 #include "helpers/file.h"
+#include "helpers/fw_loopback_bench.h"
+#include "helpers/group.h"
 #include "helpers/have_cap.h"
 #include "helpers/interleave.h"
+#include "helpers/probe_cache.h"
+#include "helpers/profile.h"
+#include "helpers/repeater.h"
+#include "helpers/rx_agc.h"
+#include "helpers/stream_mem.h"
+#include "helpers/sweep.h"
+#include "helpers/telemetry.h"
+#include "helpers/time_sync.h"
+#include "helpers/timeout.h"
+#include "helpers/wallclock.h"
+#include "helpers/thread_attrs.h"
 
 
 /******************************************************************************/
@@ -72,6 +98,110 @@ int bladerf_open(struct bladerf **dev, const char *dev_id)
     return status;
 }
 
+/* Maximum number of devices bladerf_open_many() opens concurrently */
+#define OPEN_MANY_MAX_THREADS 8
+
+struct open_many {
+    MUTEX lock;
+    unsigned int next;
+    unsigned int count;
+    struct bladerf **devices;
+    const char *const *ids;
+    int *statuses;
+};
+
+static void *open_many_worker(void *arg)
+{
+    struct open_many *o = arg;
+    unsigned int i;
+
+    while (true) {
+        MUTEX_LOCK(&o->lock);
+        i = o->next;
+        if (i < o->count) {
+            o->next++;
+        }
+        MUTEX_UNLOCK(&o->lock);
+
+        if (i >= o->count) {
+            break;
+        }
+
+        o->statuses[i] = bladerf_open(&o->devices[i], o->ids[i]);
+    }
+
+    return NULL;
+}
+
+int bladerf_open_many(struct bladerf **devices,
+                      const char *const *device_identifiers,
+                      unsigned int count,
+                      int *statuses)
+{
+    pthread_t threads[OPEN_MANY_MAX_THREADS - 1];
+    struct open_many o;
+    unsigned int i, num_threads;
+    int status = 0;
+
+    if (devices == NULL || device_identifiers == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (count == 0) {
+        return 0;
+    }
+
+    o.next     = 0;
+    o.count    = count;
+    o.devices  = devices;
+    o.ids      = device_identifiers;
+    o.statuses = statuses;
+
+    if (o.statuses == NULL) {
+        o.statuses = calloc(count, sizeof(o.statuses[0]));
+        if (o.statuses == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        devices[i]    = NULL;
+        o.statuses[i] = BLADERF_ERR_UNEXPECTED;
+    }
+
+    MUTEX_INIT(&o.lock);
+
+    /* The calling thread opens devices too, so it needs one fewer helper */
+    for (num_threads = 0; num_threads < ARRAY_SIZE(threads) &&
+                          num_threads < (count - 1);
+         num_threads++) {
+        if (pthread_create(&threads[num_threads], NULL, open_many_worker,
+                           &o) != 0) {
+            log_debug("%s: only started %u threads\n", __FUNCTION__,
+                      num_threads);
+            break;
+        }
+    }
+
+    open_many_worker(&o);
+
+    for (i = 0; i < num_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    MUTEX_DESTROY(&o.lock);
+
+    for (i = 0; i < count && status == 0; i++) {
+        status = o.statuses[i];
+    }
+
+    if (statuses == NULL) {
+        free(o.statuses);
+    }
+
+    return status;
+}
+
 int bladerf_open_with_devinfo(struct bladerf **opened_device,
                               struct bladerf_devinfo *devinfo)
 {
@@ -114,6 +244,7 @@ int bladerf_open_with_devinfo(struct bladerf **opened_device,
     }
 
     MUTEX_INIT(&dev->lock);
+    MUTEX_INIT(&dev->stream_mem_lock);
 
     /* Open board */
     status = dev->board->open(dev, devinfo);
@@ -166,15 +297,47 @@ int bladerf_get_backendinfo(struct bladerf *dev, struct bladerf_backendinfo *inf
 
 void bladerf_close(struct bladerf *dev)
 {
+    size_t i;
+
     if (dev) {
+        /* Queued control operations require the handle lock */
+        ctrl_queue_deinit(dev);
+
+        /* As do the calibration cache's refresh thread, the time sync
+         * measurement thread and the telemetry sampler thread */
+        cal_cache_deinit(dev);
+        time_sync_deinit(dev);
+        telemetry_deinit(dev);
+
+        /* And the shared-memory server's control thread */
+        shm_server_stop(dev);
+
         MUTEX_LOCK(&dev->lock);
 
         dev->board->close(dev);
 
+        /* Read by the sync interfaces, which the board has now closed */
+        sample_cal_deinit(dev);
+        rx_agc_deinit(dev);
+
+        /* Parked by the sync interfaces' workers */
+        sync_worker_pool_deinit(dev);
+        sync_duplex_deinit(dev);
+
+        /* Stream buffers may be device memory, and must precede the backend */
+        stream_mem_pool_flush(dev);
+
         if (dev->backend) {
             dev->backend->close(dev);
         }
 
+        ctrl_trace_deinit(dev);
+        timeline_deinit(dev);
+
+        for (i = 0; i < HOP_TABLE_CHANNELS; i++) {
+            free(dev->hop_table[i]);
+        }
+
         MUTEX_UNLOCK(&dev->lock);
 
         free(dev);
@@ -499,16 +662,66 @@ int bladerf_enable_module(struct bladerf *dev, bladerf_channel ch, bool enable)
     return status;
 }
 
+int bladerf_standby_module(struct bladerf *dev, bladerf_channel ch)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->standby_module(dev, ch);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
 /******************************************************************************/
 /* Gain */
 /******************************************************************************/
 
+/* An RX gain is only cached under manual gain control, as the AGC may change
+ * it at any time. Must be called with the device lock held. */
+static bool gain_cacheable(struct bladerf *dev, bladerf_channel ch)
+{
+    bladerf_gain_mode mode;
+    int64_t cached;
+    int status;
+
+    if (dev->state_cache.disabled) {
+        return false;
+    }
+
+    if (BLADERF_CHANNEL_IS_TX(ch)) {
+        return true;
+    }
+
+    if (state_cache_lookup(&dev->state_cache, ch, STATE_CACHE_GAIN_MODE,
+                           &cached)) {
+        return (bladerf_gain_mode)cached == BLADERF_GAIN_MGC;
+    }
+
+    status = dev->board->get_gain_mode(dev, ch, &mode);
+    if (status != 0) {
+        return false;
+    }
+
+    state_cache_fill(&dev->state_cache, ch, STATE_CACHE_GAIN_MODE, mode);
+    return mode == BLADERF_GAIN_MGC;
+}
+
 int bladerf_set_gain(struct bladerf *dev, bladerf_channel ch, int gain)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
     status = dev->board->set_gain(dev, ch, gain);
+    state_cache_invalidate(&dev->state_cache, ch, STATE_CACHE_GAIN);
+
+    if (status == 0) {
+        status = cal_cache_update(dev, ch);
+    }
+
+    if (status == 0) {
+        status = sample_cal_update(dev, ch);
+    }
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -516,10 +729,18 @@ int bladerf_set_gain(struct bladerf *dev, bladerf_channel ch, int gain)
 
 int bladerf_get_gain(struct bladerf *dev, bladerf_channel ch, int *gain)
 {
-    int status;
+    int64_t cached;
+    int status = 0;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_gain(dev, ch, gain);
+    if (state_cache_lookup(&dev->state_cache, ch, STATE_CACHE_GAIN, &cached)) {
+        *gain = (int)cached;
+    } else {
+        status = dev->board->get_gain(dev, ch, gain);
+        if (status == 0 && gain_cacheable(dev, ch)) {
+            state_cache_fill(&dev->state_cache, ch, STATE_CACHE_GAIN, *gain);
+        }
+    }
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -533,6 +754,12 @@ int bladerf_set_gain_mode(struct bladerf *dev,
     MUTEX_LOCK(&dev->lock);
 
     status = dev->board->set_gain_mode(dev, ch, mode);
+    state_cache_invalidate(&dev->state_cache, ch, STATE_CACHE_GAIN_MODE);
+
+    /* BLADERF_GAIN_DEFAULT selects a board-specific mode */
+    if (status == 0 && mode != BLADERF_GAIN_DEFAULT) {
+        state_cache_fill(&dev->state_cache, ch, STATE_CACHE_GAIN_MODE, mode);
+    }
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -542,10 +769,20 @@ int bladerf_get_gain_mode(struct bladerf *dev,
                           bladerf_channel ch,
                           bladerf_gain_mode *mode)
 {
-    int status;
+    int64_t cached;
+    int status = 0;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_gain_mode(dev, ch, mode);
+    if (state_cache_lookup(&dev->state_cache, ch, STATE_CACHE_GAIN_MODE,
+                           &cached)) {
+        *mode = (bladerf_gain_mode)cached;
+    } else {
+        status = dev->board->get_gain_mode(dev, ch, mode);
+        if (status == 0) {
+            state_cache_fill(&dev->state_cache, ch, STATE_CACHE_GAIN_MODE,
+                             *mode);
+        }
+    }
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -574,6 +811,7 @@ int bladerf_set_gain_stage(struct bladerf *dev,
     MUTEX_LOCK(&dev->lock);
 
     status = dev->board->set_gain_stage(dev, ch, stage, gain);
+    state_cache_invalidate(&dev->state_cache, ch, STATE_CACHE_GAIN);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -618,10 +856,58 @@ int bladerf_set_sample_rate(struct bladerf *dev,
                             bladerf_sample_rate rate,
                             bladerf_sample_rate *actual)
 {
+    bladerf_sample_rate actual_rate;
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->set_sample_rate(dev, ch, rate, &actual_rate);
+    state_cache_invalidate(&dev->state_cache, ch, STATE_CACHE_SAMPLE_RATE);
+
+    if (status == 0) {
+        state_cache_fill(&dev->state_cache, ch, STATE_CACHE_SAMPLE_RATE,
+                         actual_rate);
+
+        if (actual != NULL) {
+            *actual = actual_rate;
+        }
+    }
+
+    /* The RX and TX sample rates may be coupled, so reassess both */
+    if (status == 0) {
+        sync_auto_retune(dev, BLADERF_RX);
+        sync_auto_retune(dev, BLADERF_TX);
+    }
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_switch_sample_rate(struct bladerf *dev,
+                               bladerf_channel ch,
+                               bladerf_sample_rate rate,
+                               bladerf_sample_rate *actual)
+{
+    bladerf_sample_rate actual_rate;
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->set_sample_rate(dev, ch, rate, actual);
+    status = dev->board->switch_sample_rate(dev, ch, rate, &actual_rate);
+    state_cache_invalidate(&dev->state_cache, ch, STATE_CACHE_SAMPLE_RATE);
+
+    if (status == 0) {
+        state_cache_fill(&dev->state_cache, ch, STATE_CACHE_SAMPLE_RATE,
+                         actual_rate);
+
+        if (actual != NULL) {
+            *actual = actual_rate;
+        }
+    }
+
+    /* Running streams keep their sizing; idle ones are reassessed */
+    if (status == 0) {
+        sync_auto_retune(dev, BLADERF_RX);
+        sync_auto_retune(dev, BLADERF_TX);
+    }
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -631,10 +917,20 @@ int bladerf_get_sample_rate(struct bladerf *dev,
                             bladerf_channel ch,
                             bladerf_sample_rate *rate)
 {
-    int status;
+    int64_t cached;
+    int status = 0;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_sample_rate(dev, ch, rate);
+    if (state_cache_lookup(&dev->state_cache, ch, STATE_CACHE_SAMPLE_RATE,
+                           &cached)) {
+        *rate = (bladerf_sample_rate)cached;
+    } else {
+        status = dev->board->get_sample_rate(dev, ch, rate);
+        if (status == 0) {
+            state_cache_fill(&dev->state_cache, ch, STATE_CACHE_SAMPLE_RATE,
+                             *rate);
+        }
+    }
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -656,6 +952,12 @@ int bladerf_set_rational_sample_rate(struct bladerf *dev,
     MUTEX_LOCK(&dev->lock);
 
     status = dev->board->set_rational_sample_rate(dev, ch, rate, actual);
+    state_cache_invalidate(&dev->state_cache, ch, STATE_CACHE_SAMPLE_RATE);
+
+    if (status == 0) {
+        sync_auto_retune(dev, BLADERF_RX);
+        sync_auto_retune(dev, BLADERF_TX);
+    }
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -683,10 +985,21 @@ int bladerf_set_bandwidth(struct bladerf *dev,
                           bladerf_bandwidth bandwidth,
                           bladerf_bandwidth *actual)
 {
+    bladerf_bandwidth actual_bw;
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->set_bandwidth(dev, ch, bandwidth, actual);
+    status = dev->board->set_bandwidth(dev, ch, bandwidth, &actual_bw);
+    state_cache_invalidate(&dev->state_cache, ch, STATE_CACHE_BANDWIDTH);
+
+    if (status == 0) {
+        state_cache_fill(&dev->state_cache, ch, STATE_CACHE_BANDWIDTH,
+                         actual_bw);
+
+        if (actual != NULL) {
+            *actual = actual_bw;
+        }
+    }
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -696,10 +1009,20 @@ int bladerf_get_bandwidth(struct bladerf *dev,
                           bladerf_channel ch,
                           bladerf_bandwidth *bandwidth)
 {
-    int status;
+    int64_t cached;
+    int status = 0;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_bandwidth(dev, ch, bandwidth);
+    if (state_cache_lookup(&dev->state_cache, ch, STATE_CACHE_BANDWIDTH,
+                           &cached)) {
+        *bandwidth = (bladerf_bandwidth)cached;
+    } else {
+        status = dev->board->get_bandwidth(dev, ch, bandwidth);
+        if (status == 0) {
+            state_cache_fill(&dev->state_cache, ch, STATE_CACHE_BANDWIDTH,
+                             *bandwidth);
+        }
+    }
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -725,6 +1048,18 @@ int bladerf_set_frequency(struct bladerf *dev,
 
     status = dev->board->set_frequency(dev, ch, frequency);
 
+    /* The hardware quantizes the frequency, so the value is cached when it
+     * is next read back */
+    state_cache_invalidate(&dev->state_cache, ch, STATE_CACHE_FREQUENCY);
+
+    if (status == 0) {
+        status = cal_cache_update(dev, ch);
+    }
+
+    if (status == 0) {
+        status = sample_cal_update(dev, ch);
+    }
+
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
@@ -733,10 +1068,20 @@ int bladerf_get_frequency(struct bladerf *dev,
                           bladerf_channel ch,
                           bladerf_frequency *frequency)
 {
-    int status;
+    int64_t cached;
+    int status = 0;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_frequency(dev, ch, frequency);
+    if (state_cache_lookup(&dev->state_cache, ch, STATE_CACHE_FREQUENCY,
+                           &cached)) {
+        *frequency = (bladerf_frequency)cached;
+    } else {
+        status = dev->board->get_frequency(dev, ch, frequency);
+        if (status == 0) {
+            state_cache_fill(&dev->state_cache, ch, STATE_CACHE_FREQUENCY,
+                             (int64_t)*frequency);
+        }
+    }
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -807,475 +1152,1939 @@ int bladerf_get_rf_ports(struct bladerf *dev,
 }
 
 /******************************************************************************/
-/* Scheduled Tuning */
+/* Channel configuration */
 /******************************************************************************/
 
-int bladerf_get_quick_tune(struct bladerf *dev,
-                           bladerf_channel ch,
-                           struct bladerf_quick_tune *quick_tune)
+int bladerf_apply_config(struct bladerf *dev,
+                         bladerf_channel ch,
+                         const struct bladerf_channel_config *config)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_quick_tune(dev, ch, quick_tune);
+    status = dev->board->apply_config(dev, ch, config);
+    state_cache_flush(&dev->state_cache);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_schedule_retune(struct bladerf *dev,
-                            bladerf_channel ch,
-                            bladerf_timestamp timestamp,
-                            bladerf_frequency frequency,
-                            struct bladerf_quick_tune *quick_tune)
-
+int bladerf_save_profile(struct bladerf *dev, const char *filename)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status =
-        dev->board->schedule_retune(dev, ch, timestamp, frequency, quick_tune);
+    status = profile_save(dev, filename);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_cancel_scheduled_retunes(struct bladerf *dev, bladerf_channel ch)
+int bladerf_load_profile(struct bladerf *dev, const char *filename)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->cancel_scheduled_retunes(dev, ch);
+    status = profile_load(dev, filename);
+    state_cache_flush(&dev->state_cache);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
 /******************************************************************************/
-/* DC/Phase/Gain Correction */
+/* Device state cache */
 /******************************************************************************/
 
-int bladerf_get_correction(struct bladerf *dev,
-                           bladerf_channel ch,
-                           bladerf_correction corr,
-                           bladerf_correction_value *value)
+int bladerf_set_state_cache(struct bladerf *dev, bool enable)
 {
-    int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_correction(dev, ch, corr, value);
+    dev->state_cache.disabled = !enable;
+    state_cache_flush(&dev->state_cache);
 
     MUTEX_UNLOCK(&dev->lock);
-    return status;
+    return 0;
 }
 
-int bladerf_set_correction(struct bladerf *dev,
-                           bladerf_channel ch,
-                           bladerf_correction corr,
-                           bladerf_correction_value value)
+int bladerf_get_state_cache(struct bladerf *dev, bool *enabled)
 {
-    int status;
+    if (enabled == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
     MUTEX_LOCK(&dev->lock);
+    *enabled = !dev->state_cache.disabled;
+    MUTEX_UNLOCK(&dev->lock);
 
-    status = dev->board->set_correction(dev, ch, corr, value);
+    return 0;
+}
 
+int bladerf_invalidate_state_cache(struct bladerf *dev)
+{
+    MUTEX_LOCK(&dev->lock);
+    state_cache_flush(&dev->state_cache);
     MUTEX_UNLOCK(&dev->lock);
-    return status;
+
+    return 0;
 }
 
 /******************************************************************************/
-/* Trigger */
+/* Scheduled Tuning */
 /******************************************************************************/
 
-int bladerf_trigger_init(struct bladerf *dev,
-                         bladerf_channel ch,
-                         bladerf_trigger_signal signal,
-                         struct bladerf_trigger *trigger)
+int bladerf_get_quick_tune(struct bladerf *dev,
+                           bladerf_channel ch,
+                           struct bladerf_quick_tune *quick_tune)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->trigger_init(dev, ch, signal, trigger);
+    status = dev->board->get_quick_tune(dev, ch, quick_tune);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_trigger_arm(struct bladerf *dev,
-                        const struct bladerf_trigger *trigger,
-                        bool arm,
-                        uint64_t resv1,
-                        uint64_t resv2)
+int bladerf_schedule_retune(struct bladerf *dev,
+                            bladerf_channel ch,
+                            bladerf_timestamp timestamp,
+                            bladerf_frequency frequency,
+                            struct bladerf_quick_tune *quick_tune)
+
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->trigger_arm(dev, trigger, arm, resv1, resv2);
+    status =
+        dev->board->schedule_retune(dev, ch, timestamp, frequency, quick_tune);
+    state_cache_retune_scheduled(&dev->state_cache, ch);
+    timeline_retune(dev, ch, timestamp, quick_tune ? 0 : frequency, status);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_trigger_fire(struct bladerf *dev,
-                         const struct bladerf_trigger *trigger)
+int bladerf_cancel_scheduled_retunes(struct bladerf *dev, bladerf_channel ch)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->trigger_fire(dev, trigger);
+    status = dev->board->cancel_scheduled_retunes(dev, ch);
+    if (status == 0) {
+        state_cache_retunes_cancelled(&dev->state_cache, ch);
+    }
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_trigger_state(struct bladerf *dev,
-                          const struct bladerf_trigger *trigger,
-                          bool *is_armed,
-                          bool *has_fired,
-                          bool *fire_requested,
-                          uint64_t *reserved1,
-                          uint64_t *reserved2)
+int bladerf_cancel_scheduled_retune(struct bladerf *dev,
+                                    bladerf_channel ch,
+                                    bladerf_timestamp timestamp)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->trigger_state(dev, trigger, is_armed, has_fired,
-                                       fire_requested, reserved1, reserved2);
+    status = dev->board->cancel_scheduled_retune(dev, ch, timestamp);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-/******************************************************************************/
-/* Streaming */
-/******************************************************************************/
-
-int bladerf_init_stream(struct bladerf_stream **stream,
-                        struct bladerf *dev,
-                        bladerf_stream_cb callback,
-                        void ***buffers,
-                        size_t num_buffers,
-                        bladerf_format format,
-                        size_t samples_per_buffer,
-                        size_t num_transfers,
-                        void *data)
+int bladerf_replace_scheduled_retune(struct bladerf *dev,
+                                     bladerf_channel ch,
+                                     bladerf_timestamp timestamp,
+                                     bladerf_frequency frequency,
+                                     struct bladerf_quick_tune *quick_tune)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->init_stream(stream, dev, callback, buffers,
-                                     num_buffers, format, samples_per_buffer,
-                                     num_transfers, data);
+    status = dev->board->replace_scheduled_retune(dev, ch, timestamp,
+                                                  frequency, quick_tune);
+    state_cache_retune_scheduled(&dev->state_cache, ch);
+    timeline_retune(dev, ch, timestamp, quick_tune ? 0 : frequency, status);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_stream(struct bladerf_stream *stream, bladerf_channel_layout layout)
+int bladerf_schedule_retune_pair(struct bladerf *dev,
+                                 bladerf_timestamp timestamp,
+                                 const struct bladerf_quick_tune *rx,
+                                 const struct bladerf_quick_tune *tx)
 {
-    return stream->dev->board->stream(stream, layout);
-}
+    int status;
+    MUTEX_LOCK(&dev->lock);
 
-int bladerf_submit_stream_buffer(struct bladerf_stream *stream,
-                                 void *buffer,
-                                 unsigned int timeout_ms)
-{
-    return stream->dev->board->submit_stream_buffer(stream, buffer, timeout_ms,
-                                                    false);
-}
+    status = dev->board->schedule_retune_pair(dev, timestamp, rx, tx);
+    state_cache_retune_scheduled(&dev->state_cache, BLADERF_CHANNEL_RX(0));
+    state_cache_retune_scheduled(&dev->state_cache, BLADERF_CHANNEL_TX(0));
+    timeline_retune(dev, BLADERF_CHANNEL_INVALID, timestamp, 0, status);
 
-int bladerf_submit_stream_buffer_nb(struct bladerf_stream *stream, void *buffer)
-{
-    return stream->dev->board->submit_stream_buffer(stream, buffer, 0, true);
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
 }
 
-void bladerf_deinit_stream(struct bladerf_stream *stream)
+int bladerf_get_retune_stats(struct bladerf *dev,
+                             bladerf_channel ch,
+                             struct bladerf_retune_stats *stats)
 {
-    if (stream) {
-        stream->dev->board->deinit_stream(stream);
-    }
-}
+    int status;
+
+    if (stats == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->get_retune_stats(dev, ch, stats);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_schedule_gain(struct bladerf *dev,
+                          bladerf_channel ch,
+                          bladerf_timestamp timestamp,
+                          int gain)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->schedule_gain(dev, ch, timestamp, gain);
+
+    if (timestamp == BLADERF_RETUNE_NOW) {
+        state_cache_invalidate(&dev->state_cache, ch, STATE_CACHE_GAIN);
+    } else {
+        state_cache_retune_scheduled(&dev->state_cache, ch);
+    }
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+/******************************************************************************/
+/* Hop tables */
+/******************************************************************************/
+
+int bladerf_set_hop_table(struct bladerf *dev,
+                          bladerf_channel ch,
+                          const struct bladerf_quick_tune *entries,
+                          unsigned int count)
+{
+    struct bladerf_quick_tune *table = NULL;
+
+    if (ch < 0 || ch >= HOP_TABLE_CHANNELS || (entries == NULL && count != 0)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (count != 0) {
+        table = malloc(count * sizeof(table[0]));
+        if (table == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+
+        memcpy(table, entries, count * sizeof(table[0]));
+    }
+
+    MUTEX_LOCK(&dev->lock);
+
+    free(dev->hop_table[ch]);
+    dev->hop_table[ch]     = table;
+    dev->hop_table_len[ch] = count;
+
+    MUTEX_UNLOCK(&dev->lock);
+
+    return 0;
+}
+
+int bladerf_schedule_hops(struct bladerf *dev,
+                          bladerf_channel ch,
+                          const bladerf_timestamp *timestamps,
+                          const unsigned int *indices,
+                          unsigned int count,
+                          unsigned int *num_scheduled)
+{
+    unsigned int i;
+    int status = 0;
+
+    if (ch < 0 || ch >= HOP_TABLE_CHANNELS || timestamps == NULL ||
+        indices == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+
+    if (count != 0) {
+        state_cache_retune_scheduled(&dev->state_cache, ch);
+    }
+
+    for (i = 0; i < count && status == 0; i++) {
+        if (indices[i] >= dev->hop_table_len[ch]) {
+            log_debug("Hop table index %u exceeds table length %u.\n",
+                      indices[i], dev->hop_table_len[ch]);
+            status = BLADERF_ERR_INVAL;
+            break;
+        }
+
+        status = dev->board->schedule_retune(dev, ch, timestamps[i], 0,
+                                             &dev->hop_table[ch][indices[i]]);
+        if (status != 0) {
+            break;
+        }
+    }
+
+    MUTEX_UNLOCK(&dev->lock);
+
+    if (num_scheduled != NULL) {
+        *num_scheduled = i;
+    }
+
+    return status;
+}
+
+int bladerf_schedule_hop(struct bladerf *dev,
+                         bladerf_channel ch,
+                         bladerf_timestamp timestamp,
+                         unsigned int index)
+{
+    return bladerf_schedule_hops(dev, ch, &timestamp, &index, 1, NULL);
+}
+
+/******************************************************************************/
+/* Frequency sweeps */
+/******************************************************************************/
+
+int bladerf_sweep(struct bladerf *dev,
+                  bladerf_channel ch,
+                  const struct bladerf_sweep_config *config,
+                  unsigned int num_sweeps,
+                  bladerf_sweep_cb cb,
+                  void *user_data)
+{
+    bladerf_format format;
+    bladerf_channel_layout layout;
+
+    if (config == NULL || cb == NULL || ch < 0 || BLADERF_CHANNEL_IS_TX(ch)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+    format = dev->sync_auto[BLADERF_RX].format;
+    layout = dev->sync_auto[BLADERF_RX].layout;
+    MUTEX_UNLOCK(&dev->lock);
+
+    return sweep_run(dev, ch, config, format, layout, num_sweeps, cb,
+                     user_data);
+}
+
+/******************************************************************************/
+/* Device groups */
+/******************************************************************************/
+
+int bladerf_group_open(struct bladerf_group **group,
+                       struct bladerf *const *devices,
+                       unsigned int num_devices,
+                       const struct bladerf_group_config *config)
+{
+    if (group == NULL || devices == NULL || config == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return group_open(group, devices, num_devices, config);
+}
+
+int bladerf_group_start(struct bladerf_group *group)
+{
+    if (group == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return group_start(group);
+}
+
+int bladerf_group_rx(struct bladerf_group *group,
+                     void *const *samples,
+                     uint64_t *block,
+                     bladerf_timestamp *timestamps,
+                     unsigned int timeout_ms)
+{
+    if (group == NULL || samples == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return group_rx(group, samples, block, timestamps, timeout_ms);
+}
+
+int bladerf_group_get_stats(struct bladerf_group *group,
+                            unsigned int member,
+                            struct bladerf_group_stats *stats)
+{
+    if (group == NULL || stats == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return group_get_stats(group, member, stats);
+}
+
+int bladerf_group_stop(struct bladerf_group *group)
+{
+    if (group == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return group_stop(group);
+}
+
+void bladerf_group_close(struct bladerf_group *group)
+{
+    if (group != NULL) {
+        group_close(group);
+    }
+}
+
+/******************************************************************************/
+/* Host and device clock correlation */
+/******************************************************************************/
+
+uint64_t bladerf_time_sync_host_ns(void)
+{
+    return wallclock_get_current_nsec();
+}
+
+int bladerf_get_timestamp_estimate(struct bladerf *dev,
+                                   bladerf_direction dir,
+                                   unsigned int samples,
+                                   struct bladerf_timestamp_estimate *estimate)
+{
+    if (estimate == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return time_sync_estimate(dev, dir, samples, estimate);
+}
+
+int bladerf_time_sync_configure(struct bladerf *dev,
+                                bladerf_direction dir,
+                                const struct bladerf_time_sync_config *config)
+{
+    return time_sync_configure(dev, dir, config);
+}
+
+int bladerf_time_sync_measure(struct bladerf *dev, bladerf_direction dir)
+{
+    return time_sync_measure(dev, dir);
+}
+
+int bladerf_time_sync_host_to_device(struct bladerf *dev,
+                                     bladerf_direction dir,
+                                     uint64_t host_ns,
+                                     bladerf_timestamp *timestamp)
+{
+    if (timestamp == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return time_sync_host_to_device(dev, dir, host_ns, timestamp);
+}
+
+int bladerf_time_sync_device_to_host(struct bladerf *dev,
+                                     bladerf_direction dir,
+                                     bladerf_timestamp timestamp,
+                                     uint64_t *host_ns)
+{
+    if (host_ns == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return time_sync_device_to_host(dev, dir, timestamp, host_ns);
+}
+
+int bladerf_time_sync_get_stats(struct bladerf *dev,
+                                bladerf_direction dir,
+                                struct bladerf_time_sync_stats *stats)
+{
+    if (stats == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return time_sync_get_stats(dev, dir, stats);
+}
+
+/******************************************************************************/
+/* Telemetry sampler */
+/******************************************************************************/
+
+int bladerf_telemetry_configure(struct bladerf *dev,
+                                const struct bladerf_telemetry_config *config)
+{
+    return telemetry_configure(dev, config);
+}
+
+int bladerf_telemetry_get(struct bladerf *dev,
+                          struct bladerf_telemetry *snapshot)
+{
+    if (snapshot == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return telemetry_get(dev, snapshot);
+}
+
+/******************************************************************************/
+/* RX to TX repeater */
+/******************************************************************************/
+
+int bladerf_repeater_start(struct bladerf_repeater **rep,
+                           struct bladerf *rx_dev,
+                           struct bladerf *tx_dev,
+                           const struct bladerf_repeater_config *config)
+{
+    if (rep == NULL || rx_dev == NULL || tx_dev == NULL || config == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return repeater_start(rep, rx_dev, tx_dev, config);
+}
+
+int bladerf_repeater_get_stats(struct bladerf_repeater *rep,
+                               struct bladerf_repeater_stats *stats)
+{
+    if (rep == NULL || stats == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return repeater_get_stats(rep, stats);
+}
+
+int bladerf_repeater_stop(struct bladerf_repeater *rep)
+{
+    if (rep == NULL) {
+        return 0;
+    }
+
+    return repeater_stop(rep);
+}
+
+/******************************************************************************/
+/* Sharing a device between processes */
+/******************************************************************************/
+
+int bladerf_shm_server_start(struct bladerf *dev,
+                             unsigned int num_slots,
+                             unsigned int slot_size)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = shm_server_start(dev, num_slots, slot_size);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_shm_server_stop(struct bladerf *dev)
+{
+    /* The server's control thread acquires the handle lock */
+    if (dev->shm_server == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    shm_server_stop(dev);
+    return 0;
+}
+
+/******************************************************************************/
+/* Asynchronous control */
+/******************************************************************************/
+
+int bladerf_set_gain_async(struct bladerf *dev,
+                           bladerf_channel ch,
+                           bladerf_gain gain,
+                           bladerf_ctrl_cb cb,
+                           void *user_data,
+                           bladerf_ctrl_ticket *ticket)
+{
+    struct ctrl_op op;
+
+    memset(&op, 0, sizeof(op));
+    op.type        = CTRL_OP_SET_GAIN;
+    op.ch          = ch;
+    op.params.gain = gain;
+    op.cb          = cb;
+    op.user_data   = user_data;
+
+    return ctrl_queue_submit(dev, &op, ticket);
+}
+
+int bladerf_set_frequency_async(struct bladerf *dev,
+                                bladerf_channel ch,
+                                bladerf_frequency frequency,
+                                bladerf_ctrl_cb cb,
+                                void *user_data,
+                                bladerf_ctrl_ticket *ticket)
+{
+    struct ctrl_op op;
+
+    memset(&op, 0, sizeof(op));
+    op.type             = CTRL_OP_SET_FREQUENCY;
+    op.ch               = ch;
+    op.params.frequency = frequency;
+    op.cb               = cb;
+    op.user_data        = user_data;
+
+    return ctrl_queue_submit(dev, &op, ticket);
+}
+
+int bladerf_set_bandwidth_async(struct bladerf *dev,
+                                bladerf_channel ch,
+                                bladerf_bandwidth bandwidth,
+                                bladerf_bandwidth *actual,
+                                bladerf_ctrl_cb cb,
+                                void *user_data,
+                                bladerf_ctrl_ticket *ticket)
+{
+    struct ctrl_op op;
+
+    memset(&op, 0, sizeof(op));
+    op.type                = CTRL_OP_SET_BANDWIDTH;
+    op.ch                  = ch;
+    op.params.bw.bandwidth = bandwidth;
+    op.params.bw.actual    = actual;
+    op.cb                  = cb;
+    op.user_data           = user_data;
+
+    return ctrl_queue_submit(dev, &op, ticket);
+}
+
+int bladerf_ctrl_poll(struct bladerf *dev,
+                      bladerf_ctrl_ticket ticket,
+                      int *status)
+{
+    return ctrl_queue_wait(dev, ticket, false, 0, status);
+}
+
+int bladerf_ctrl_wait(struct bladerf *dev,
+                      bladerf_ctrl_ticket ticket,
+                      unsigned int timeout_ms,
+                      int *status)
+{
+    return ctrl_queue_wait(dev, ticket, true, timeout_ms, status);
+}
+
+/******************************************************************************/
+/* DC/Phase/Gain Correction */
+/******************************************************************************/
+
+int bladerf_get_correction(struct bladerf *dev,
+                           bladerf_channel ch,
+                           bladerf_correction corr,
+                           bladerf_correction_value *value)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->get_correction(dev, ch, corr, value);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_set_correction(struct bladerf *dev,
+                           bladerf_channel ch,
+                           bladerf_correction corr,
+                           bladerf_correction_value value)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->set_correction(dev, ch, corr, value);
+    if (status == 0) {
+        cal_cache_record_value(dev, ch, corr, value);
+    }
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_set_cal_cache(struct bladerf *dev,
+                          bladerf_channel ch,
+                          const struct bladerf_cal_cache_config *config)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = cal_cache_configure(dev, ch, config);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_cal_cache_record(struct bladerf *dev, bladerf_channel ch)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = cal_cache_record(dev, ch);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_set_rx_sample_cal(struct bladerf *dev,
+                              bladerf_channel ch,
+                              const struct bladerf_rx_sample_cal_entry *entries,
+                              unsigned int num_entries)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = sample_cal_set(dev, ch, entries, num_entries);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_set_rx_agc(struct bladerf *dev,
+                       bladerf_channel ch,
+                       const struct bladerf_rx_agc_config *config)
+{
+    return rx_agc_configure(dev, ch, config);
+}
+
+/******************************************************************************/
+/* Trigger */
+/******************************************************************************/
+
+int bladerf_trigger_init(struct bladerf *dev,
+                         bladerf_channel ch,
+                         bladerf_trigger_signal signal,
+                         struct bladerf_trigger *trigger)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->trigger_init(dev, ch, signal, trigger);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_trigger_arm(struct bladerf *dev,
+                        const struct bladerf_trigger *trigger,
+                        bool arm,
+                        uint64_t resv1,
+                        uint64_t resv2)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->trigger_arm(dev, trigger, arm, resv1, resv2);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_trigger_fire(struct bladerf *dev,
+                         const struct bladerf_trigger *trigger)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->trigger_fire(dev, trigger);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_trigger_state(struct bladerf *dev,
+                          const struct bladerf_trigger *trigger,
+                          bool *is_armed,
+                          bool *has_fired,
+                          bool *fire_requested,
+                          uint64_t *reserved1,
+                          uint64_t *reserved2)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->trigger_state(dev, trigger, is_armed, has_fired,
+                                       fire_requested, reserved1, reserved2);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_trigger_fire_at(struct bladerf *dev,
+                            const struct bladerf_trigger *trigger,
+                            uint64_t timestamp)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->trigger_fire_at(dev, trigger, timestamp);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_trigger_fire_time(struct bladerf *dev,
+                              const struct bladerf_trigger *trigger,
+                              bool *has_fired,
+                              uint64_t *timestamp)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->trigger_fire_time(dev, trigger, has_fired, timestamp);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+/******************************************************************************/
+/* Streaming */
+/******************************************************************************/
+
+int bladerf_init_stream(struct bladerf_stream **stream,
+                        struct bladerf *dev,
+                        bladerf_stream_cb callback,
+                        void ***buffers,
+                        size_t num_buffers,
+                        bladerf_format format,
+                        size_t samples_per_buffer,
+                        size_t num_transfers,
+                        void *data)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->init_stream(stream, dev, callback, buffers,
+                                     num_buffers, format, samples_per_buffer,
+                                     num_transfers, data);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_stream(struct bladerf_stream *stream, bladerf_channel_layout layout)
+{
+    return stream->dev->board->stream(stream, layout);
+}
+
+int bladerf_submit_stream_buffer(struct bladerf_stream *stream,
+                                 void *buffer,
+                                 unsigned int timeout_ms)
+{
+    return stream->dev->board->submit_stream_buffer(stream, buffer, timeout_ms,
+                                                    false);
+}
+
+int bladerf_submit_stream_buffer_nb(struct bladerf_stream *stream, void *buffer)
+{
+    return stream->dev->board->submit_stream_buffer(stream, buffer, 0, true);
+}
+
+void bladerf_deinit_stream(struct bladerf_stream *stream)
+{
+    if (stream) {
+        stream->dev->board->deinit_stream(stream);
+    }
+}
+
+int bladerf_set_stream_timeout(struct bladerf *dev,
+                               bladerf_direction dir,
+                               unsigned int timeout)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->set_stream_timeout(dev, dir, timeout);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_get_stream_timeout(struct bladerf *dev,
+                               bladerf_direction dir,
+                               unsigned int *timeout)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->get_stream_timeout(dev, dir, timeout);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_sync_config(struct bladerf *dev,
+                        bladerf_channel_layout layout,
+                        bladerf_format format,
+                        unsigned int num_buffers,
+                        unsigned int buffer_size,
+                        unsigned int num_transfers,
+                        unsigned int stream_timeout)
+{
+    const bladerf_direction dir = layout & BLADERF_DIRECTION_MASK;
+    struct sync_auto *sync_auto = &dev->sync_auto[dir];
+    bool auto_size;
+    int status = 0;
+
+    MUTEX_LOCK(&dev->lock);
+
+    auto_size = (num_buffers == BLADERF_SYNC_CONFIG_AUTO &&
+                 buffer_size == BLADERF_SYNC_CONFIG_AUTO &&
+                 num_transfers == BLADERF_SYNC_CONFIG_AUTO);
+
+    if (auto_size) {
+        status = sync_auto_config(dev, layout, format, sync_auto->latency_us,
+                                  &num_buffers, &buffer_size, &num_transfers);
+    }
+
+    if (status == 0) {
+        status = dev->board->sync_config(dev, layout, format, num_buffers,
+                                         buffer_size, num_transfers,
+                                         stream_timeout);
+    }
+
+    if (status == 0) {
+        sync_auto->enabled        = auto_size;
+        sync_auto->layout         = layout;
+        sync_auto->format         = format;
+        sync_auto->stream_timeout = stream_timeout;
+    }
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_set_sync_auto_latency(struct bladerf *dev,
+                                  bladerf_direction dir,
+                                  unsigned int latency_us)
+{
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+
+    dev->sync_auto[dir].latency_us = latency_us;
+    sync_auto_retune(dev, dir);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return 0;
+}
+
+int bladerf_set_sync_auto_sizing(struct bladerf *dev,
+                                 bladerf_direction dir,
+                                 unsigned int num_buffers,
+                                 unsigned int buffer_size,
+                                 unsigned int num_transfers)
+{
+    const bool clear = (num_buffers == 0 && buffer_size == 0 &&
+                        num_transfers == 0);
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!clear && (buffer_size == 0 || num_transfers == 0 ||
+                   num_buffers <= num_transfers)) {
+        log_debug("%s: invalid sizing (%u buffers, %u samples, %u "
+                  "transfers)\n", __FUNCTION__, num_buffers, buffer_size,
+                  num_transfers);
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+
+    dev->sync_auto[dir].num_buffers   = num_buffers;
+    dev->sync_auto[dir].buffer_size   = buffer_size;
+    dev->sync_auto[dir].num_transfers = num_transfers;
+    sync_auto_retune(dev, dir);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return 0;
+}
+
+int bladerf_set_sync_low_latency(struct bladerf *dev,
+                                 bladerf_direction dir,
+                                 bool enable)
+{
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+
+    dev->sync_low_latency[dir] = enable;
+    sync_auto_retune(dev, dir);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return 0;
+}
+
+int bladerf_set_sync_nonblocking(struct bladerf *dev,
+                                 bladerf_direction dir,
+                                 bool enable)
+{
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+    dev->sync_nonblock[dir] = enable;
+    MUTEX_UNLOCK(&dev->lock);
+
+    return 0;
+}
+
+int bladerf_sync_start(struct bladerf *dev, bladerf_direction dir)
+{
+    return dev->board->sync_start(dev, dir);
+}
+
+int bladerf_sync_tx(struct bladerf *dev,
+                    void const *samples,
+                    unsigned int num_samples,
+                    struct bladerf_metadata *metadata,
+                    unsigned int timeout_ms)
+{
+    return dev->board->sync_tx(dev, samples, num_samples, metadata, timeout_ms);
+}
+
+int bladerf_sync_tx_acquire(struct bladerf *dev,
+                            void **samples,
+                            unsigned int *num_samples,
+                            unsigned int timeout_ms)
+{
+    return dev->board->sync_tx_acquire(dev, samples, num_samples, timeout_ms);
+}
+
+int bladerf_sync_tx_commit(struct bladerf *dev,
+                           const void *samples,
+                           unsigned int num_samples)
+{
+    return dev->board->sync_tx_commit(dev, samples, num_samples);
+}
+
+int bladerf_sync_rx(struct bladerf *dev,
+                    void *samples,
+                    unsigned int num_samples,
+                    struct bladerf_metadata *metadata,
+                    unsigned int timeout_ms)
+{
+    return dev->board->sync_rx(dev, samples, num_samples, metadata, timeout_ms);
+}
+
+int bladerf_sync_rx_planar(struct bladerf *dev,
+                           void *const samples[],
+                           unsigned int num_samples,
+                           struct bladerf_metadata *metadata,
+                           unsigned int timeout_ms)
+{
+    return dev->board->sync_rx_planar(dev, samples, num_samples, metadata,
+                                      timeout_ms);
+}
+
+int bladerf_sync_rx_channel(struct bladerf *dev,
+                            bladerf_channel ch,
+                            void *samples,
+                            unsigned int num_samples,
+                            struct bladerf_metadata *metadata,
+                            unsigned int timeout_ms)
+{
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_RX(1)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return dev->board->sync_rx_channel(dev, ch, samples, num_samples,
+                                       metadata, timeout_ms);
+}
+
+int bladerf_sync_rx_acquire(struct bladerf *dev,
+                            void **samples,
+                            unsigned int *num_samples,
+                            struct bladerf_metadata *metadata,
+                            unsigned int timeout_ms)
+{
+    return dev->board->sync_rx_acquire(dev, samples, num_samples, metadata,
+                                       timeout_ms);
+}
+
+int bladerf_sync_rx_release(struct bladerf *dev, const void *samples)
+{
+    return dev->board->sync_rx_release(dev, samples);
+}
+
+int bladerf_sync_rx_deadline(struct bladerf *dev,
+                             void *samples,
+                             unsigned int num_samples,
+                             struct bladerf_metadata *metadata,
+                             uint64_t deadline_ns)
+{
+    return dev->board->sync_rx_deadline(dev, samples, num_samples, metadata,
+                                        deadline_ns);
+}
+
+int bladerf_sync_tx_deadline(struct bladerf *dev,
+                             void const *samples,
+                             unsigned int num_samples,
+                             struct bladerf_metadata *metadata,
+                             uint64_t deadline_ns)
+{
+    return dev->board->sync_tx_deadline(dev, samples, num_samples, metadata,
+                                        deadline_ns);
+}
+
+uint64_t bladerf_get_deadline_clock_ns(void)
+{
+    return timeout_clock_get_nsec();
+}
+
+int bladerf_sync_rxv(struct bladerf *dev,
+                     const struct bladerf_sync_iov *iov,
+                     unsigned int iovcnt,
+                     unsigned int *completed,
+                     unsigned int timeout_ms)
+{
+    return dev->board->sync_rxv(dev, iov, iovcnt, completed, timeout_ms);
+}
+
+int bladerf_sync_txv(struct bladerf *dev,
+                     const struct bladerf_sync_iov *iov,
+                     unsigned int iovcnt,
+                     unsigned int *completed,
+                     unsigned int timeout_ms)
+{
+    return dev->board->sync_txv(dev, iov, iovcnt, completed, timeout_ms);
+}
+
+int bladerf_sync_rxtx(struct bladerf *dev,
+                      void *rx_samples,
+                      unsigned int rx_num_samples,
+                      struct bladerf_metadata *rx_metadata,
+                      void const *tx_samples,
+                      unsigned int tx_num_samples,
+                      struct bladerf_metadata *tx_metadata,
+                      uint64_t tx_offset,
+                      unsigned int timeout_ms)
+{
+    return dev->board->sync_rxtx(dev, rx_samples, rx_num_samples, rx_metadata,
+                                 tx_samples, tx_num_samples, tx_metadata,
+                                 tx_offset, timeout_ms);
+}
+
+int bladerf_get_sync_stats(struct bladerf *dev,
+                           bladerf_direction dir,
+                           struct bladerf_stream_stats *stats)
+{
+    return dev->board->get_sync_stats(dev, dir, stats);
+}
+
+int bladerf_get_sync_latency(struct bladerf *dev,
+                             bladerf_direction dir,
+                             struct bladerf_sync_latency *latency)
+{
+    return dev->board->get_sync_latency(dev, dir, latency);
+}
+
+int bladerf_get_sync_poll_handle(struct bladerf *dev,
+                                 bladerf_direction dir,
+                                 bladerf_poll_handle *handle)
+{
+    if (handle == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return dev->board->get_sync_poll_handle(dev, dir, handle);
+}
+
+int bladerf_set_rx_capture(struct bladerf *dev, unsigned int duration_ms)
+{
+    MUTEX_LOCK(&dev->lock);
+    dev->rx_capture_ms = duration_ms;
+    MUTEX_UNLOCK(&dev->lock);
+
+    return 0;
+}
+
+int bladerf_set_rx_channel_queues(struct bladerf *dev, bool enable)
+{
+    MUTEX_LOCK(&dev->lock);
+    dev->rx_channel_queues = enable;
+    MUTEX_UNLOCK(&dev->lock);
+
+    return 0;
+}
+
+int bladerf_set_rx_taps(struct bladerf *dev, unsigned int num_taps)
+{
+    if (num_taps > BLADERF_RX_TAPS_MAX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+    dev->rx_taps = num_taps;
+    MUTEX_UNLOCK(&dev->lock);
+
+    return 0;
+}
+
+int bladerf_set_rx_tap_policy(struct bladerf *dev,
+                              unsigned int tap,
+                              bladerf_rx_tap_policy policy)
+{
+    if (tap >= BLADERF_RX_TAPS_MAX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    switch (policy) {
+        case BLADERF_RX_TAP_BACKPRESSURE:
+        case BLADERF_RX_TAP_DROP:
+            break;
+
+        default:
+            return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+    dev->rx_tap_policy[tap] = policy;
+    MUTEX_UNLOCK(&dev->lock);
+
+    return 0;
+}
+
+int bladerf_rx_tap_acquire(struct bladerf *dev,
+                           unsigned int tap,
+                           const void **samples,
+                           unsigned int *num_samples,
+                           struct bladerf_metadata *metadata,
+                           unsigned int timeout_ms)
+{
+    return dev->board->rx_tap_acquire(dev, tap, samples, num_samples,
+                                      metadata, timeout_ms);
+}
+
+int bladerf_rx_tap_release(struct bladerf *dev,
+                           unsigned int tap,
+                           const void *samples)
+{
+    return dev->board->rx_tap_release(dev, tap, samples);
+}
+
+int bladerf_set_rx_resampler(struct bladerf *dev,
+                             const struct bladerf_rational_rate *rate)
+{
+    struct bladerf_rational_rate r = { 0, 0, 1 };
+
+    if (rate != NULL) {
+        if (rate->den == 0 && rate->num != 0) {
+            return BLADERF_ERR_INVAL;
+        }
+
+        r = *rate;
+        if (r.den == 0) {
+            r.den = 1;
+        }
+
+        /* Keep the rate representable as a single fraction */
+        if (r.integer > (UINT64_MAX - r.num) / r.den) {
+            return BLADERF_ERR_INVAL;
+        }
+    }
+
+    MUTEX_LOCK(&dev->lock);
+    dev->rx_resample_rate = r;
+    MUTEX_UNLOCK(&dev->lock);
+
+    return 0;
+}
+
+int bladerf_read_rx_capture(struct bladerf *dev,
+                            void *samples,
+                            unsigned int num_samples,
+                            struct bladerf_metadata *metadata)
+{
+    return dev->board->read_rx_capture(dev, samples, num_samples, metadata);
+}
+
+int bladerf_get_rx_capture_range(struct bladerf *dev,
+                                 bladerf_timestamp *oldest,
+                                 bladerf_timestamp *newest)
+{
+    return dev->board->get_rx_capture_range(dev, oldest, newest);
+}
+
+int bladerf_get_stream_stats(struct bladerf_stream *stream,
+                             struct bladerf_stream_stats *stats)
+{
+    if (stream == NULL || stats == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return async_get_stats(stream, stats);
+}
+
+int bladerf_set_stream_batch(struct bladerf_stream *stream,
+                             bladerf_stream_batch_cb callback,
+                             size_t max_batch)
+{
+    if (stream == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return async_set_batch(stream, callback, max_batch);
+}
+
+int bladerf_get_stream_msgs(struct bladerf_stream *stream,
+                            void *buffer,
+                            size_t num_samples,
+                            struct bladerf_stream_msg *msgs,
+                            size_t max_msgs)
+{
+    if (stream == NULL || buffer == NULL ||
+        (msgs == NULL && max_msgs != 0)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return async_get_msgs(stream, buffer, num_samples, msgs, max_msgs);
+}
+
+int bladerf_get_timestamp(struct bladerf *dev,
+                          bladerf_direction dir,
+                          bladerf_timestamp *timestamp)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->get_timestamp(dev, dir, timestamp);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_set_stream_mem_flags(struct bladerf *dev, uint32_t flags)
+{
+    if ((flags & ~STREAM_MEM_FLAGS_ALL) != 0) {
+        return BLADERF_ERR_INVAL;
+    }
 
-int bladerf_set_stream_timeout(struct bladerf *dev,
-                               bladerf_direction dir,
-                               unsigned int timeout)
+    MUTEX_LOCK(&dev->lock);
+    dev->stream_mem_flags = flags;
+    MUTEX_UNLOCK(&dev->lock);
+
+    return 0;
+}
+
+int bladerf_register_stream_mem(struct bladerf *dev, void *mem, size_t len)
+{
+    return stream_mem_register(dev, mem, len);
+}
+
+int bladerf_unregister_stream_mem(struct bladerf *dev, void *mem)
+{
+    return stream_mem_unregister(dev, mem);
+}
+
+int bladerf_set_allocator(const struct bladerf_allocator *allocator)
+{
+    return alloc_set(allocator);
+}
+
+int bladerf_set_stream_thread_attrs(
+    struct bladerf *dev,
+    bladerf_direction dir,
+    const struct bladerf_stream_thread_attrs *attrs)
+{
+    int status = 0;
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (attrs != NULL) {
+        status = thread_attrs_check(attrs);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    MUTEX_LOCK(&dev->lock);
+
+    if (attrs == NULL) {
+        memset(&dev->stream_thread_attrs[dir], 0,
+               sizeof(dev->stream_thread_attrs[dir]));
+    } else {
+        dev->stream_thread_attrs[dir] = *attrs;
+    }
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_interleave_stream_buffer(bladerf_channel_layout layout,
+                                     bladerf_format format,
+                                     unsigned int buffer_size,
+                                     void *samples)
+{
+    return _interleave_interleave_buf(layout, format, buffer_size, samples);
+}
+
+int bladerf_deinterleave_stream_buffer(bladerf_channel_layout layout,
+                                       bladerf_format format,
+                                       unsigned int buffer_size,
+                                       void *samples)
+{
+    return _interleave_deinterleave_buf(layout, format, buffer_size, samples);
+}
+
+int bladerf_convert_samples(bladerf_format in_format,
+                            const void *in,
+                            bladerf_format out_format,
+                            void *out,
+                            size_t num_samples)
+{
+    /* Conversions between CF32 and SC8 Q7 pass through SC16 Q11, in
+     * blocks of this many samples */
+    int16_t tmp[2 * 512];
+    size_t i, n;
+
+    if ((in_format != BLADERF_FORMAT_SC16_Q11 &&
+         in_format != BLADERF_FORMAT_CF32 &&
+         in_format != BLADERF_FORMAT_SC8_Q7) ||
+        (out_format != BLADERF_FORMAT_SC16_Q11 &&
+         out_format != BLADERF_FORMAT_CF32 &&
+         out_format != BLADERF_FORMAT_SC8_Q7)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (in_format == out_format) {
+        size_t size = 2 * sizeof(int16_t);
+
+        if (in_format == BLADERF_FORMAT_CF32) {
+            size = 2 * sizeof(float);
+        } else if (in_format == BLADERF_FORMAT_SC8_Q7) {
+            size = 2 * sizeof(int8_t);
+        }
+
+        memmove(out, in, num_samples * size);
+        return 0;
+    }
+
+    if (in_format == BLADERF_FORMAT_SC16_Q11) {
+        if (out_format == BLADERF_FORMAT_CF32) {
+            sc16q11_to_float(in, out, num_samples);
+        } else {
+            sc16q11_to_sc8q7(in, out, num_samples);
+        }
+    } else if (out_format == BLADERF_FORMAT_SC16_Q11) {
+        if (in_format == BLADERF_FORMAT_CF32) {
+            float_to_sc16q11(in, out, num_samples);
+        } else {
+            sc8q7_to_sc16q11(in, out, num_samples);
+        }
+    } else if (in_format == BLADERF_FORMAT_CF32) {
+        for (i = 0; i < num_samples; i += n) {
+            n = min_sz(num_samples - i, ARRAY_SIZE(tmp) / 2);
+            float_to_sc16q11((const float *)in + 2 * i, tmp, n);
+            sc16q11_to_sc8q7(tmp, (int8_t *)out + 2 * i, n);
+        }
+    } else {
+        for (i = 0; i < num_samples; i += n) {
+            n = min_sz(num_samples - i, ARRAY_SIZE(tmp) / 2);
+            sc8q7_to_sc16q11((const int8_t *)in + 2 * i, tmp, n);
+            sc16q11_to_float(tmp, (float *)out + 2 * i, n);
+        }
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+/* FPGA/Firmware Loading/Flashing */
+/******************************************************************************/
+
+int bladerf_load_fpga(struct bladerf *dev, const char *fpga_file)
 {
+    const uint8_t *buf = NULL;
+    size_t buf_size;
     int status;
+
+    status = file_map(fpga_file, &buf, &buf_size);
+    if (status != 0) {
+        return status;
+    }
+
+    status = dev->board->load_fpga(dev, buf, buf_size);
+
     MUTEX_LOCK(&dev->lock);
+    state_cache_reset(&dev->state_cache);
+    MUTEX_UNLOCK(&dev->lock);
 
-    status = dev->board->set_stream_timeout(dev, dir, timeout);
+    file_unmap(buf, buf_size);
+    return status;
+}
+
+int bladerf_flash_fpga(struct bladerf *dev, const char *fpga_file)
+{
+    const uint8_t *buf = NULL;
+    size_t buf_size;
+    int status;
+
+    status = file_map(fpga_file, &buf, &buf_size);
+    if (status != 0) {
+        return status;
+    }
 
+    MUTEX_LOCK(&dev->lock);
+    status = dev->board->flash_fpga(dev, buf, buf_size);
     MUTEX_UNLOCK(&dev->lock);
+
+    file_unmap(buf, buf_size);
     return status;
 }
 
-int bladerf_get_stream_timeout(struct bladerf *dev,
-                               bladerf_direction dir,
-                               unsigned int *timeout)
+int bladerf_erase_stored_fpga(struct bladerf *dev)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->erase_stored_fpga(dev);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_set_flash_write_mode(struct bladerf *dev,
+                                 bladerf_flash_write_mode mode)
+{
+    if (mode != BLADERF_FLASH_WRITE_FULL &&
+        mode != BLADERF_FLASH_WRITE_DIFFERENTIAL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+    dev->flash_write_mode = mode;
+    MUTEX_UNLOCK(&dev->lock);
+
+    return 0;
+}
+
+int bladerf_get_flash_write_stats(struct bladerf *dev,
+                                  struct bladerf_flash_write_stats *stats)
+{
+    if (stats == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+    *stats = dev->flash_write_stats;
+    MUTEX_UNLOCK(&dev->lock);
+
+    return 0;
+}
+
+int bladerf_flash_firmware(struct bladerf *dev, const char *firmware_file)
+{
+    const uint8_t *buf = NULL;
+    size_t buf_size;
+    int status;
+
+    status = file_map(firmware_file, &buf, &buf_size);
+    if (status != 0) {
+        return status;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+    status = dev->board->flash_firmware(dev, buf, buf_size);
+    MUTEX_UNLOCK(&dev->lock);
+
+    file_unmap(buf, buf_size);
+    return status;
+}
+
+int bladerf_device_reset(struct bladerf *dev)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->device_reset(dev);
+    state_cache_reset(&dev->state_cache);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+/******************************************************************************/
+/* Tuning mode */
+/******************************************************************************/
+
+int bladerf_set_tuning_mode(struct bladerf *dev, bladerf_tuning_mode mode)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->set_tuning_mode(dev, mode);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_get_tuning_mode(struct bladerf *dev, bladerf_tuning_mode *mode)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->get_tuning_mode(dev, mode);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+/******************************************************************************/
+/* Loopback */
+/******************************************************************************/
+
+int bladerf_get_loopback_modes(struct bladerf *dev,
+                               struct bladerf_loopback_modes const **modes)
+{
+    int status;
+
+    status = dev->board->get_loopback_modes(dev, modes);
+
+    return status;
+}
+
+bool bladerf_is_loopback_mode_supported(struct bladerf *dev,
+                                        bladerf_loopback mode)
+{
+    struct bladerf_loopback_modes modes;
+    struct bladerf_loopback_modes const *modesptr = &modes;
+    int i, count;
+
+    count = bladerf_get_loopback_modes(dev, &modesptr);
+
+    for (i = 0; i < count; ++i) {
+        if (modesptr[i].mode == mode) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int bladerf_set_loopback(struct bladerf *dev, bladerf_loopback l)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->set_loopback(dev, l);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_get_loopback(struct bladerf *dev, bladerf_loopback *l)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->get_loopback(dev, l);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_fw_loopback_bench(
+    struct bladerf *dev,
+    const struct bladerf_fw_loopback_bench_config *config,
+    struct bladerf_fw_loopback_bench_results *results)
+{
+    if (config == NULL || results == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return fw_loopback_bench(dev, config, results);
+}
+
+/******************************************************************************/
+/* Sample RX FPGA Mux */
+/******************************************************************************/
+
+int bladerf_set_rx_mux(struct bladerf *dev, bladerf_rx_mux mux)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_stream_timeout(dev, dir, timeout);
+    status = dev->board->set_rx_mux(dev, mux);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_sync_config(struct bladerf *dev,
-                        bladerf_channel_layout layout,
-                        bladerf_format format,
-                        unsigned int num_buffers,
-                        unsigned int buffer_size,
-                        unsigned int num_transfers,
-                        unsigned int stream_timeout)
+int bladerf_get_rx_mux(struct bladerf *dev, bladerf_rx_mux *mux)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status =
-        dev->board->sync_config(dev, layout, format, num_buffers, buffer_size,
-                                num_transfers, stream_timeout);
+    status = dev->board->get_rx_mux(dev, mux);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_sync_tx(struct bladerf *dev,
-                    void const *samples,
-                    unsigned int num_samples,
-                    struct bladerf_metadata *metadata,
-                    unsigned int timeout_ms)
-{
-    return dev->board->sync_tx(dev, samples, num_samples, metadata, timeout_ms);
-}
-
-int bladerf_sync_rx(struct bladerf *dev,
-                    void *samples,
-                    unsigned int num_samples,
-                    struct bladerf_metadata *metadata,
-                    unsigned int timeout_ms)
-{
-    return dev->board->sync_rx(dev, samples, num_samples, metadata, timeout_ms);
-}
+/******************************************************************************/
+/* RX digital downconverter */
+/******************************************************************************/
 
-int bladerf_get_timestamp(struct bladerf *dev,
-                          bladerf_direction dir,
-                          bladerf_timestamp *timestamp)
+int bladerf_set_rx_ddc(struct bladerf *dev,
+                       int64_t offset,
+                       unsigned int decimation)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_timestamp(dev, dir, timestamp);
+    status = dev->board->set_rx_ddc(dev, offset, decimation);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_interleave_stream_buffer(bladerf_channel_layout layout,
-                                     bladerf_format format,
-                                     unsigned int buffer_size,
-                                     void *samples)
+int bladerf_get_rx_ddc(struct bladerf *dev,
+                       int64_t *offset,
+                       unsigned int *decimation)
 {
-    return _interleave_interleave_buf(layout, format, buffer_size, samples);
-}
+    int status;
+    MUTEX_LOCK(&dev->lock);
 
-int bladerf_deinterleave_stream_buffer(bladerf_channel_layout layout,
-                                       bladerf_format format,
-                                       unsigned int buffer_size,
-                                       void *samples)
-{
-    return _interleave_deinterleave_buf(layout, format, buffer_size, samples);
+    status = dev->board->get_rx_ddc(dev, offset, decimation);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
 }
 
 /******************************************************************************/
-/* FPGA/Firmware Loading/Flashing */
+/* TX digital upconverter */
 /******************************************************************************/
 
-int bladerf_load_fpga(struct bladerf *dev, const char *fpga_file)
+int bladerf_set_tx_duc(struct bladerf *dev,
+                       int64_t offset,
+                       unsigned int interpolation)
 {
-    uint8_t *buf = NULL;
-    size_t buf_size;
     int status;
+    MUTEX_LOCK(&dev->lock);
 
-    status = file_read_buffer(fpga_file, &buf, &buf_size);
-    if (status != 0) {
-        goto exit;
-    }
-
-    status = dev->board->load_fpga(dev, buf, buf_size);
+    status = dev->board->set_tx_duc(dev, offset, interpolation);
 
-exit:
-    free(buf);
+    MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_flash_fpga(struct bladerf *dev, const char *fpga_file)
+int bladerf_get_tx_duc(struct bladerf *dev,
+                       int64_t *offset,
+                       unsigned int *interpolation)
 {
-    uint8_t *buf = NULL;
-    size_t buf_size;
     int status;
+    MUTEX_LOCK(&dev->lock);
 
-    status = file_read_buffer(fpga_file, &buf, &buf_size);
-    if (status != 0) {
-        goto exit;
-    }
+    status = dev->board->get_tx_duc(dev, offset, interpolation);
 
-    MUTEX_LOCK(&dev->lock);
-    status = dev->board->flash_fpga(dev, buf, buf_size);
     MUTEX_UNLOCK(&dev->lock);
-
-exit:
-    free(buf);
     return status;
 }
 
-int bladerf_erase_stored_fpga(struct bladerf *dev)
+/******************************************************************************/
+/* RX power detector */
+/******************************************************************************/
+
+int bladerf_set_rx_power_detector(struct bladerf *dev,
+                                  unsigned int block_length)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->erase_stored_fpga(dev);
+    status = dev->board->set_rx_power_detector(dev, block_length);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_flash_firmware(struct bladerf *dev, const char *firmware_file)
+int bladerf_get_rx_power_detector(struct bladerf *dev,
+                                  unsigned int *block_length)
 {
-    uint8_t *buf = NULL;
-    size_t buf_size;
     int status;
+    MUTEX_LOCK(&dev->lock);
 
-    status = file_read_buffer(firmware_file, &buf, &buf_size);
-    if (status != 0) {
-        goto exit;
-    }
+    status = dev->board->get_rx_power_detector(dev, block_length);
 
-    MUTEX_LOCK(&dev->lock);
-    status = dev->board->flash_firmware(dev, buf, buf_size);
     MUTEX_UNLOCK(&dev->lock);
-
-exit:
-    free(buf);
     return status;
 }
 
-int bladerf_device_reset(struct bladerf *dev)
+int bladerf_get_rx_power(struct bladerf *dev,
+                         bladerf_channel ch,
+                         struct bladerf_rx_power *power)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->device_reset(dev);
+    status = dev->board->get_rx_power(dev, ch, power);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
 /******************************************************************************/
-/* Tuning mode */
+/* RX burst gate */
 /******************************************************************************/
 
-int bladerf_set_tuning_mode(struct bladerf *dev, bladerf_tuning_mode mode)
+int bladerf_set_rx_burst_gate(struct bladerf *dev,
+                              const struct bladerf_rx_burst_gate *gate)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->set_tuning_mode(dev, mode);
+    status = dev->board->set_rx_burst_gate(dev, gate);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_get_tuning_mode(struct bladerf *dev, bladerf_tuning_mode *mode)
+int bladerf_get_rx_burst_gate(struct bladerf *dev,
+                              struct bladerf_rx_burst_gate *gate)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_tuning_mode(dev, mode);
+    status = dev->board->get_rx_burst_gate(dev, gate);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
 /******************************************************************************/
-/* Loopback */
+/* Sample FIFO levels */
 /******************************************************************************/
 
-int bladerf_get_loopback_modes(struct bladerf *dev,
-                               struct bladerf_loopback_modes const **modes)
+int bladerf_get_fifo_levels(struct bladerf *dev,
+                            struct bladerf_fifo_levels *levels,
+                            bool reset_high_water)
 {
     int status;
+    MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_loopback_modes(dev, modes);
+    status = dev->board->get_fifo_levels(dev, levels, reset_high_water);
 
+    MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-bool bladerf_is_loopback_mode_supported(struct bladerf *dev,
-                                        bladerf_loopback mode)
+/******************************************************************************/
+/* TX waveform loop */
+/******************************************************************************/
+
+/* Interval at which the loop's state is polled while a waveform loads */
+#define TX_LOOP_POLL_US 1000
+
+int bladerf_tx_loop_load(struct bladerf *dev,
+                         const void *samples,
+                         unsigned int num_samples,
+                         unsigned int timeout_ms)
 {
-    struct bladerf_loopback_modes modes;
-    struct bladerf_loopback_modes const *modesptr = &modes;
-    int i, count;
+    struct bladerf_metadata meta;
+    struct bladerf_tx_loop_status loop;
+    uint64_t deadline = 0;
+    int status;
 
-    count = bladerf_get_loopback_modes(dev, &modesptr);
+    MUTEX_LOCK(&dev->lock);
+    status = dev->board->tx_loop_load(dev, num_samples);
+    MUTEX_UNLOCK(&dev->lock);
 
-    for (i = 0; i < count; ++i) {
-        if (modesptr[i].mode == mode) {
-            return true;
-        }
+    if (status != 0) {
+        return status;
     }
 
-    return false;
-}
+    if (timeout_ms != 0) {
+        deadline = wallclock_get_current_nsec() +
+                   (uint64_t)timeout_ms * 1000000;
+    }
 
-int bladerf_set_loopback(struct bladerf *dev, bladerf_loopback l)
-{
-    int status;
-    MUTEX_LOCK(&dev->lock);
+    memset(&meta, 0, sizeof(meta));
+    meta.flags = BLADERF_META_FLAG_TX_BURST_START |
+                 BLADERF_META_FLAG_TX_BURST_END | BLADERF_META_FLAG_TX_NOW;
 
-    status = dev->board->set_loopback(dev, l);
+    status = dev->board->sync_tx(dev, samples, num_samples, &meta, timeout_ms);
+    if (status != 0) {
+        goto abandon;
+    }
 
+    for (;;) {
+        MUTEX_LOCK(&dev->lock);
+        status = dev->board->get_tx_loop_status(dev, &loop);
+        MUTEX_UNLOCK(&dev->lock);
+
+        if (status != 0) {
+            return status;
+        }
+
+        if (loop.state != BLADERF_TX_LOOP_LOADING) {
+            return (loop.state == BLADERF_TX_LOOP_LOADED) ? 0
+                                                          : BLADERF_ERR_IO;
+        }
+
+        if (deadline != 0 && wallclock_get_current_nsec() >= deadline) {
+            status = BLADERF_ERR_TIMEOUT;
+            goto abandon;
+        }
+
+        usleep(TX_LOOP_POLL_US);
+    }
+
+abandon:
+    /* Don't leave the loop capturing whatever is transmitted next */
+    MUTEX_LOCK(&dev->lock);
+    dev->board->tx_loop_stop(dev, 0);
     MUTEX_UNLOCK(&dev->lock);
+
     return status;
 }
 
-int bladerf_get_loopback(struct bladerf *dev, bladerf_loopback *l)
+int bladerf_tx_loop_start(struct bladerf *dev, uint64_t start, uint64_t stop)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_loopback(dev, l);
+    status = dev->board->tx_loop_start(dev, start, stop);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-/******************************************************************************/
-/* Sample RX FPGA Mux */
-/******************************************************************************/
-
-int bladerf_set_rx_mux(struct bladerf *dev, bladerf_rx_mux mux)
+int bladerf_tx_loop_stop(struct bladerf *dev, uint64_t timestamp)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->set_rx_mux(dev, mux);
+    status = dev->board->tx_loop_stop(dev, timestamp);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_get_rx_mux(struct bladerf *dev, bladerf_rx_mux *mux)
+int bladerf_tx_loop_get_status(struct bladerf *dev,
+                               struct bladerf_tx_loop_status *status)
 {
-    int status;
+    int rv;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_rx_mux(dev, mux);
+    rv = dev->board->get_tx_loop_status(dev, status);
 
     MUTEX_UNLOCK(&dev->lock);
-    return status;
+    return rv;
 }
 
 /******************************************************************************/
@@ -1423,6 +3232,9 @@ int bladerf_erase_flash(struct bladerf *dev,
 
     status = dev->board->erase_flash(dev, erase_block, count);
 
+    /* The calibration region may have changed */
+    probe_cache_invalidate(dev);
+
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
@@ -1512,6 +3324,9 @@ int bladerf_write_flash(struct bladerf *dev,
 
     status = dev->board->write_flash(dev, buf, page, count);
 
+    /* The calibration region may have changed */
+    probe_cache_invalidate(dev);
+
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
@@ -1560,6 +3375,9 @@ int bladerf_write_otp(struct bladerf *dev,
 
     status = dev->backend->write_otp(dev, (char *)buf);
 
+    /* The OTP region may have changed */
+    spi_flash_invalidate_otp(dev);
+
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
@@ -1571,6 +3389,155 @@ int bladerf_lock_otp(struct bladerf *dev)
 
     status = dev->backend->lock_otp(dev);
 
+    /* The OTP region may have changed */
+    spi_flash_invalidate_otp(dev);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+/******************************************************************************/
+/* Low-level control-path tracing */
+/******************************************************************************/
+
+int bladerf_enable_ctrl_trace(struct bladerf *dev, bool enable)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = ctrl_trace_enable(dev, enable);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_read_ctrl_trace(struct bladerf *dev,
+                            struct bladerf_ctrl_trace_entry *entries,
+                            unsigned int max_entries,
+                            unsigned int *num_read,
+                            uint64_t *dropped)
+{
+    if (entries == NULL || num_read == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* The trace has its own lock, such that it may be read while a lengthy
+     * control operation is in progress */
+    return ctrl_trace_read(dev, entries, max_entries, num_read, dropped);
+}
+
+/******************************************************************************/
+/* Stream timeline */
+/******************************************************************************/
+
+int bladerf_enable_timeline(struct bladerf *dev, bool enable)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = timeline_enable(dev, enable);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_dump_timeline(struct bladerf *dev, const char *path)
+{
+    if (path == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* Dumps do not take the handle lock, so that they may be taken while a
+     * stream or lengthy control operation is in progress */
+    return timeline_dump(dev, path);
+}
+
+int bladerf_set_timeline_error_dump(struct bladerf *dev, const char *path)
+{
+    return timeline_set_error_dump(dev, path);
+}
+
+/******************************************************************************/
+/* Low-level FX3 sample buffering */
+/******************************************************************************/
+
+int bladerf_set_fx3_dma_buffers(struct bladerf *dev,
+                                unsigned int num_buffers,
+                                unsigned int buffer_packets)
+{
+    int status;
+
+    if (num_buffers != 0 &&
+        (num_buffers < BLADERF_FX3_DMA_MIN_BUFFERS ||
+         num_buffers > BLADERF_FX3_DMA_MAX_BUFFERS ||
+         buffer_packets < 1 ||
+         buffer_packets > BLADERF_FX3_DMA_MAX_BUFFER_PACKETS)) {
+        log_debug("%s: Invalid configuration: %u buffers of %u packets\n",
+                  __FUNCTION__, num_buffers, buffer_packets);
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+
+    if (!have_cap(dev->board->get_capabilities(dev),
+                  BLADERF_CAP_FW_SAMPLE_DMA)) {
+        log_debug("FX3 firmware does not support DMA buffer configuration.\n");
+        status = BLADERF_ERR_UNSUPPORTED;
+    } else {
+        status = dev->backend->set_sample_dma(dev, num_buffers,
+                                              buffer_packets);
+    }
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_get_fx3_dma_buffers(struct bladerf *dev,
+                                unsigned int *num_buffers,
+                                unsigned int *buffer_packets)
+{
+    int status;
+
+    if (num_buffers == NULL || buffer_packets == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+
+    if (!have_cap(dev->board->get_capabilities(dev),
+                  BLADERF_CAP_FW_SAMPLE_DMA)) {
+        /* Older firmware always uses the defaults */
+        *num_buffers    = BLADERF_FX3_DMA_DEFAULT_BUFFERS;
+        *buffer_packets = BLADERF_FX3_DMA_DEFAULT_BUFFER_PACKETS;
+        status          = 0;
+    } else {
+        status = dev->backend->get_sample_dma(dev, num_buffers,
+                                              buffer_packets);
+    }
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_get_fx3_stats(struct bladerf *dev,
+                          struct bladerf_fx3_stats *stats,
+                          bool reset)
+{
+    int status;
+
+    if (stats == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+
+    if (!have_cap(dev->board->get_capabilities(dev), BLADERF_CAP_FW_STATS)) {
+        log_debug("FX3 firmware does not support sample path counters.\n");
+        status = BLADERF_ERR_UNSUPPORTED;
+    } else {
+        status = dev->backend->get_fw_stats(dev, stats, reset);
+    }
+
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
@@ -1641,6 +3608,16 @@ void bladerf_log_set_verbosity(bladerf_log_level level)
 #endif
 }
 
+void bladerf_log_set_callback(bladerf_log_callback cb, void *user_data)
+{
+    log_set_callback(cb, user_data);
+}
+
+int bladerf_log_set_async(bool enable)
+{
+    return log_set_async(enable);
+}
+
 void bladerf_set_usb_reset_on_open(bool enabled)
 {
 #if ENABLE_USB_DEV_RESET_ON_OPEN
@@ -1664,6 +3641,7 @@ int bladerf_expansion_attach(struct bladerf *dev, bladerf_xb xb)
     MUTEX_LOCK(&dev->lock);
 
     status = dev->board->expansion_attach(dev, xb);
+    state_cache_flush(&dev->state_cache);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -1699,6 +3677,7 @@ int bladerf_expansion_gpio_write(struct bladerf *dev, uint32_t val)
     MUTEX_LOCK(&dev->lock);
 
     status = xb100_gpio_write(dev, val);
+    xb200_gpio_invalidate(dev);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -1712,6 +3691,7 @@ int bladerf_expansion_gpio_masked_write(struct bladerf *dev,
     MUTEX_LOCK(&dev->lock);
 
     status = xb100_gpio_masked_write(dev, mask, val);
+    xb200_gpio_invalidate(dev);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -1762,6 +3742,7 @@ int bladerf_xb200_set_filterbank(struct bladerf *dev,
     MUTEX_LOCK(&dev->lock);
 
     status = xb200_set_filterbank(dev, ch, filter);
+    state_cache_flush(&dev->state_cache);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -1788,6 +3769,7 @@ int bladerf_xb200_set_path(struct bladerf *dev,
     MUTEX_LOCK(&dev->lock);
 
     status = xb200_set_path(dev, ch, path);
+    state_cache_flush(&dev->state_cache);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -35,6 +35,8 @@
 #include "capabilities.h"
 #include "calibration.h"
 #include "flash.h"
+#include "vcocap.h"
+#include "tamer_cache.h"
 
 #include "driver/smb_clock.h"
 #include "driver/si5338.h"
@@ -42,6 +44,7 @@
 #include "driver/spi_flash.h"
 #include "driver/fpga_trigger.h"
 #include "lms.h"
+#include "nios_pkt_8x32.h"
 #include "nios_pkt_retune.h"
 #include "band_select.h"
 
@@ -54,10 +57,14 @@
 
 #include "streaming/async.h"
 #include "streaming/sync.h"
+#include "streaming/sync_split.h"
+#include "streaming/sync_tap.h"
 
 #include "devinfo.h"
 #include "helpers/version.h"
 #include "helpers/file.h"
+#include "helpers/channel_config.h"
+#include "helpers/probe_cache.h"
 #include "version.h"
 
 /******************************************************************************
@@ -67,6 +74,16 @@
 /* 1 TX, 1 RX */
 #define NUM_MODULES 2
 
+/* Number of overall gain values, in 1 dB steps */
+#define RX_GAIN_TABLE_LEN                                                   \
+    (BLADERF_LNA_GAIN_MAX_DB + BLADERF_RXVGA1_GAIN_MAX -                    \
+     BLADERF_RXVGA1_GAIN_MIN + BLADERF_RXVGA2_GAIN_MAX -                    \
+     BLADERF_RXVGA2_GAIN_MIN + 1)
+
+#define TX_GAIN_TABLE_LEN                                                   \
+    (BLADERF_TXVGA1_GAIN_MAX - BLADERF_TXVGA1_GAIN_MIN +                    \
+     BLADERF_TXVGA2_GAIN_MAX - BLADERF_TXVGA2_GAIN_MIN + 1)
+
 struct bladerf1_board_data {
     /* Board state */
     enum {
@@ -92,6 +109,20 @@ struct bladerf1_board_data {
     } cal;
     uint16_t dac_trim;
 
+    /* Trim and slope from the last VCTCXO tamer run */
+    struct tamer_cache tamer;
+
+    /* VCOCAP values observed on this device, per module */
+    struct vcocap_model vcocap[NUM_MODULES];
+
+    /* Computed Si5338 configurations and current register values */
+    struct si5338_cache si5338;
+
+    /* Gain stage register values for each overall gain, from the minimum of
+     * the overall gain range upwards */
+    struct lms_gain_regs rx_gain_table[RX_GAIN_TABLE_LEN];
+    struct lms_gain_regs tx_gain_table[TX_GAIN_TABLE_LEN];
+
     /* Board properties */
     bladerf_fpga_size fpga_size;
     /* Data message size */
@@ -105,6 +136,11 @@ struct bladerf1_board_data {
 
     /* Synchronous interface handles */
     struct bladerf_sync sync[NUM_MODULES];
+
+    /* Modules in warm standby (see bladerf_standby_module()), and the TX PA
+     * configuration to restore when TX leaves standby */
+    bool standby[NUM_MODULES];
+    uint8_t standby_tx_pa;
 };
 
 #define _CHECK_BOARD_STATE(_state, _locked) \
@@ -717,12 +753,14 @@ static int bladerf1_initialize(struct bladerf *dev)
         }
 
         /* Set a default samplerate */
-        status = si5338_set_sample_rate(dev, BLADERF_CHANNEL_TX(0), 1000000, NULL);
+        status = si5338_set_sample_rate(dev, &board_data->si5338,
+                                        BLADERF_CHANNEL_TX(0), 1000000, NULL);
         if (status != 0) {
             return status;
         }
 
-        status = si5338_set_sample_rate(dev, BLADERF_CHANNEL_RX(0), 1000000, NULL);
+        status = si5338_set_sample_rate(dev, &board_data->si5338,
+                                        BLADERF_CHANNEL_RX(0), 1000000, NULL);
         if (status != 0) {
             return status;
         }
@@ -739,8 +777,11 @@ static int bladerf1_initialize(struct bladerf *dev)
             return status;
         }
 
-        /* Set the calibrated VCTCXO DAC value */
-        status = dac161s055_write(dev, board_data->dac_trim);
+        /* Set the calibrated VCTCXO DAC value, preferring the trim the
+         * VCTCXO tamer last settled on to the factory calibration */
+        status = dac161s055_write(dev, board_data->tamer.valid
+                                           ? board_data->tamer.trim
+                                           : board_data->dac_trim);
         if (status != 0) {
             return status;
         }
@@ -809,6 +850,8 @@ static bool bladerf1_matches(struct bladerf *dev)
 /* Open/close */
 /******************************************************************************/
 
+static int gain_tables_init(struct bladerf1_board_data *board_data);
+
 static int bladerf1_open(struct bladerf *dev, struct bladerf_devinfo *devinfo)
 {
     struct bladerf1_board_data *board_data;
@@ -838,6 +881,11 @@ static int bladerf1_open(struct bladerf *dev, struct bladerf_devinfo *devinfo)
     board_data->module_format[BLADERF_RX] = -1;
     board_data->module_format[BLADERF_TX] = -1;
 
+    status = gain_tables_init(board_data);
+    if (status != 0) {
+        return status;
+    }
+
     dev->flash_arch->status          = STATUS_FLASH_UNINITIALIZED;
     dev->flash_arch->manufacturer_id = 0x0;
     dev->flash_arch->device_id       = 0x0;
@@ -932,14 +980,13 @@ static int bladerf1_open(struct bladerf *dev, struct bladerf_devinfo *devinfo)
         return status;
     }
 
-    /* Probe SPI flash architecture information */
-    if (have_cap(board_data->capabilities, BLADERF_CAP_FW_FLASH_ID)) {
-        status = spi_flash_read_flash_id(dev, &dev->flash_arch->manufacturer_id,
-                                         &dev->flash_arch->device_id);
-        if (status < 0) {
-            log_error("Failed to probe SPI flash ID information.\n");
-        }
-    } else {
+    /* Probe SPI flash architecture information and the calibration region.
+     * These are cached per device and firmware version. */
+    probe_cache_read(dev, &board_data->fw_version,
+                     have_cap(board_data->capabilities,
+                              BLADERF_CAP_FW_FLASH_ID));
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FW_FLASH_ID)) {
         log_debug("FX3 firmware v%u.%u.%u does not support SPI flash ID. A "
                   "firmware update is recommended in order to probe the SPI "
                   "flash ID information.\n",
@@ -968,6 +1015,8 @@ static int bladerf1_open(struct bladerf *dev, struct bladerf_devinfo *devinfo)
         board_data->dac_trim = 0x8000;
     }
 
+    tamer_cache_load(&board_data->tamer, dev->ident.serial);
+
     status = spi_flash_read_fpga_size(dev, &board_data->fpga_size);
     if (status < 0) {
         log_warning("Failed to get FPGA size %s\n", bladerf_strerror(status));
@@ -1065,12 +1114,12 @@ static int bladerf1_open(struct bladerf *dev, struct bladerf_devinfo *devinfo)
         }
 
         if (full_path != NULL) {
-            uint8_t *buf;
+            const uint8_t *buf;
             size_t buf_size;
 
             log_debug("Loading FPGA from: %s\n", full_path);
 
-            status = file_read_buffer(full_path, &buf, &buf_size);
+            status = file_map(full_path, &buf, &buf_size);
 
             free(full_path);
             full_path = NULL;
@@ -1080,6 +1129,7 @@ static int bladerf1_open(struct bladerf *dev, struct bladerf_devinfo *devinfo)
             }
 
             status = dev->backend->load_fpga(dev, buf, buf_size);
+            file_unmap(buf, buf_size);
             if (status != 0) {
                 log_warning("Failure loading FPGA: %s\n",
                             bladerf_strerror(status));
@@ -1127,6 +1177,8 @@ static int bladerf1_open(struct bladerf *dev, struct bladerf_devinfo *devinfo)
     return 0;
 }
 
+static void tamer_seed_save(struct bladerf *dev);
+
 static void bladerf1_close(struct bladerf *dev)
 {
     struct bladerf1_board_data *board_data = dev->board_data;
@@ -1153,6 +1205,11 @@ static void bladerf1_close(struct bladerf *dev)
             dev->board->cancel_scheduled_retunes(dev, BLADERF_CHANNEL_TX(0));
         }
 
+        if (status == 1) {
+            tamer_seed_save(dev);
+        }
+        tamer_cache_store(&board_data->tamer, dev->ident.serial);
+
         /* Detach expansion board */
         switch (dev->xb) {
             case BLADERF_XB_100:
@@ -1176,6 +1233,7 @@ static void bladerf1_close(struct bladerf *dev)
     }
 
     if( flash_arch != NULL ) {
+        probe_cache_deinit(dev);
         free(flash_arch);
         flash_arch = NULL;
     }
@@ -1337,6 +1395,19 @@ static int bladerf1_enable_module(struct bladerf *dev,
               BLADERF_CHANNEL_IS_TX(ch) ? "TX" : "RX",
               enable ? "True" : "False");
 
+    /* Leaving standby: the RF chain is already powered, but the TX PA must
+     * be restored */
+    if (board_data->standby[ch]) {
+        board_data->standby[ch] = false;
+
+        if (BLADERF_CHANNEL_IS_TX(ch)) {
+            status = LMS_WRITE(dev, 0x44, board_data->standby_tx_pa);
+            if (status != 0) {
+                return status;
+            }
+        }
+    }
+
     if (enable == false) {
         sync_deinit(&board_data->sync[ch]);
         perform_format_deconfig(
@@ -1350,6 +1421,53 @@ static int bladerf1_enable_module(struct bladerf *dev,
     return status;
 }
 
+static int bladerf1_standby_module(struct bladerf *dev, bladerf_channel ch)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+    int status;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_TX(0)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (board_data->standby[ch]) {
+        return 0;
+    }
+
+    log_debug("Standby channel: %s\n", BLADERF_CHANNEL_IS_TX(ch) ? "TX" : "RX");
+
+    /* Keep the RF chain, and with it the synthesizer, powered up */
+    status = lms_enable_rffe(dev, ch, true);
+    if (status != 0) {
+        return status;
+    }
+
+    /* The LMS6002D has no TX mute, so deselect the PAs instead */
+    if (BLADERF_CHANNEL_IS_TX(ch)) {
+        status = LMS_READ(dev, 0x44, &board_data->standby_tx_pa);
+        if (status != 0) {
+            return status;
+        }
+
+        status = lms_select_pa(dev, PA_NONE);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    status = dev->backend->enable_module(
+        dev, BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_TX : BLADERF_RX, false);
+    if (status != 0) {
+        return status;
+    }
+
+    board_data->standby[ch] = true;
+
+    return 0;
+}
+
 /******************************************************************************/
 /* Gain */
 /******************************************************************************/
@@ -1441,35 +1559,21 @@ static int bladerf1_get_gain_stage_range(struct bladerf *dev,
     return BLADERF_ERR_INVAL;
 }
 
-static int set_rx_gain(struct bladerf *dev, int gain)
+/* Apportion an overall RX gain to the gain stages. Returns the gain that
+ * could not be apportioned. */
+static int _rx_gain_stages(int gain, int *lna, int *rxvga1, int *rxvga2)
 {
-    struct bladerf_range const *lna_range    = NULL;
-    struct bladerf_range const *rxvga1_range = NULL;
-    struct bladerf_range const *rxvga2_range = NULL;
-    bladerf_channel const ch                 = BLADERF_CHANNEL_RX(0);
-    int orig_gain                            = gain;
-    int lna, rxvga1, rxvga2;
-    int status;
-
-    // get our gain stage ranges!
-    status = bladerf1_get_gain_stage_range(dev, ch, "lna", &lna_range);
-    if (status < 0) {
-        return status;
-    }
-
-    status = bladerf1_get_gain_stage_range(dev, ch, "rxvga1", &rxvga1_range);
-    if (status < 0) {
-        return status;
-    }
-
-    status = bladerf1_get_gain_stage_range(dev, ch, "rxvga2", &rxvga2_range);
-    if (status < 0) {
-        return status;
-    }
+    /* In the order of bladerf1_rx_gain_stages */
+    struct bladerf_range const *lna_range =
+        &bladerf1_rx_gain_stages[0].range;
+    struct bladerf_range const *rxvga1_range =
+        &bladerf1_rx_gain_stages[1].range;
+    struct bladerf_range const *rxvga2_range =
+        &bladerf1_rx_gain_stages[2].range;
 
-    lna    = __unscale_int(lna_range, lna_range->min);
-    rxvga1 = __unscale_int(rxvga1_range, rxvga1_range->min);
-    rxvga2 = __unscale_int(rxvga2_range, rxvga2_range->min);
+    *lna    = __unscale_int(lna_range, lna_range->min);
+    *rxvga1 = __unscale_int(rxvga1_range, rxvga1_range->min);
+    *rxvga2 = __unscale_int(rxvga2_range, rxvga2_range->min);
 
     // offset gain so that we can use it as a counter when apportioning gain
     gain -= __round_int((BLADERF1_RX_GAIN_OFFSET +
@@ -1478,56 +1582,132 @@ static int set_rx_gain(struct bladerf *dev, int gain)
                          __unscale_int(rxvga2_range, rxvga2_range->min)));
 
     // apportion some gain to RXLNA (but only half of it for now)
-    _apportion_gain(lna_range, &lna, &gain);
-    if (lna > BLADERF_LNA_GAIN_MID_DB) {
-        gain += (lna - BLADERF_LNA_GAIN_MID_DB);
-        lna -= (lna - BLADERF_LNA_GAIN_MID_DB);
+    _apportion_gain(lna_range, lna, &gain);
+    if (*lna > BLADERF_LNA_GAIN_MID_DB) {
+        gain += (*lna - BLADERF_LNA_GAIN_MID_DB);
+        *lna -= (*lna - BLADERF_LNA_GAIN_MID_DB);
     }
 
     // apportion gain to RXVGA1
-    _apportion_gain(rxvga1_range, &rxvga1, &gain);
+    _apportion_gain(rxvga1_range, rxvga1, &gain);
 
     // apportion more gain to RXLNA
-    _apportion_gain(lna_range, &lna, &gain);
+    _apportion_gain(lna_range, lna, &gain);
 
     // apportion gain to RXVGA2
-    _apportion_gain(rxvga2_range, &rxvga2, &gain);
+    _apportion_gain(rxvga2_range, rxvga2, &gain);
 
     // if we still have remaining gain, it's because rxvga2 has a step size of
     // 3 dB. Steal a few dB from rxvga1...
-    if (gain > 0 && rxvga1 >= __unscale_int(rxvga1_range, rxvga1_range->max)) {
-        rxvga1 -= __unscale_int(rxvga2_range, rxvga2_range->step);
+    if (gain > 0 && *rxvga1 >= __unscale_int(rxvga1_range, rxvga1_range->max)) {
+        *rxvga1 -= __unscale_int(rxvga2_range, rxvga2_range->step);
         gain += __unscale_int(rxvga2_range, rxvga2_range->step);
 
-        _apportion_gain(rxvga2_range, &rxvga2, &gain);
-        _apportion_gain(rxvga1_range, &rxvga1, &gain);
+        _apportion_gain(rxvga2_range, rxvga2, &gain);
+        _apportion_gain(rxvga1_range, rxvga1, &gain);
     }
 
-    // verification
-    if (gain != 0) {
-        log_warning("%s: unable to achieve requested gain %d (missed by %d)\n",
-                    __FUNCTION__, orig_gain, gain);
-        log_debug("%s: gain=%d -> rxvga1=%d lna=%d rxvga2=%d remainder=%d\n",
-                  __FUNCTION__, orig_gain, rxvga1, lna, rxvga2, gain);
+    return gain;
+}
+
+/* Apportion an overall TX gain to the gain stages. Returns the gain that
+ * could not be apportioned. */
+static int _tx_gain_stages(int gain, int *txvga1, int *txvga2)
+{
+    /* In the order of bladerf1_tx_gain_stages */
+    struct bladerf_range const *txvga1_range =
+        &bladerf1_tx_gain_stages[0].range;
+    struct bladerf_range const *txvga2_range =
+        &bladerf1_tx_gain_stages[1].range;
+
+    *txvga1 = __unscale_int(txvga1_range, txvga1_range->min);
+    *txvga2 = __unscale_int(txvga2_range, txvga2_range->min);
+
+    // offset gain so that we can use it as a counter when apportioning gain
+    gain -= __round_int((BLADERF1_TX_GAIN_OFFSET +
+                         __unscale_int(txvga1_range, txvga1_range->min) +
+                         __unscale_int(txvga2_range, txvga2_range->min)));
+
+    // apportion gain to TXVGA2
+    _apportion_gain(txvga2_range, txvga2, &gain);
+
+    // apportion gain to TXVGA1
+    _apportion_gain(txvga1_range, txvga1, &gain);
+
+    return gain;
+}
+
+/* Precompute the stage register values for each overall gain, so that a gain
+ * change only needs a table lookup */
+static int gain_tables_init(struct bladerf1_board_data *board_data)
+{
+    int lna, rxvga1, rxvga2, txvga1, txvga2, remainder;
+    size_t i;
+
+    for (i = 0; i < RX_GAIN_TABLE_LEN; i++) {
+        const int gain = (int)bladerf1_rx_gain_range.min + (int)i;
+
+        remainder = _rx_gain_stages(gain, &lna, &rxvga1, &rxvga2);
+        if (remainder != 0) {
+            log_error("%s: unable to apportion RX gain %d (off by %d)\n",
+                      __FUNCTION__, gain, remainder);
+            return BLADERF_ERR_UNEXPECTED;
+        }
+
+        lms_rx_gain_regs(_convert_gain_to_lna_gain(lna), rxvga1, rxvga2,
+                         &board_data->rx_gain_table[i]);
     }
 
-    // that should do it.  actually apply the changes:
-    status = lms_lna_set_gain(dev, _convert_gain_to_lna_gain(lna));
-    if (status < 0) {
-        return status;
+    for (i = 0; i < TX_GAIN_TABLE_LEN; i++) {
+        const int gain = (int)bladerf1_tx_gain_range.min + (int)i;
+
+        remainder = _tx_gain_stages(gain, &txvga1, &txvga2);
+        if (remainder != 0) {
+            log_error("%s: unable to apportion TX gain %d (off by %d)\n",
+                      __FUNCTION__, gain, remainder);
+            return BLADERF_ERR_UNEXPECTED;
+        }
+
+        lms_tx_gain_regs(txvga1, txvga2, &board_data->tx_gain_table[i]);
     }
 
-    status = lms_rxvga1_set_gain(dev, __scale_int(rxvga1_range, rxvga1));
-    if (status < 0) {
-        return status;
+    return 0;
+}
+
+/* Look up the table entry for an overall gain, clamping it to the gain
+ * range */
+static const struct lms_gain_regs *_gain_table_entry(
+    struct bladerf1_board_data *board_data, bladerf_channel ch, int gain)
+{
+    struct bladerf_range const *range;
+    struct lms_gain_regs const *table;
+
+    if (BLADERF_CHANNEL_IS_TX(ch)) {
+        range = &bladerf1_tx_gain_range;
+        table = board_data->tx_gain_table;
+    } else {
+        range = &bladerf1_rx_gain_range;
+        table = board_data->rx_gain_table;
     }
 
-    status = lms_rxvga2_set_gain(dev, __scale_int(rxvga2_range, rxvga2));
-    if (status < 0) {
-        return status;
+    if (gain < range->min || gain > range->max) {
+        int clamped = (gain < range->min) ? (int)range->min : (int)range->max;
+
+        log_warning("%s: unable to achieve requested gain %d (missed by %d)\n",
+                    __FUNCTION__, gain, gain - clamped);
+        gain = clamped;
     }
 
-    return 0;
+    return &table[gain - range->min];
+}
+
+static int set_rx_gain(struct bladerf *dev, int gain)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    return lms_set_gain_regs(
+        dev, BLADERF_MODULE_RX,
+        _gain_table_entry(board_data, BLADERF_CHANNEL_RX(0), gain));
 }
 
 static int get_rx_gain(struct bladerf *dev, int *gain)
@@ -1577,57 +1757,11 @@ static int get_rx_gain(struct bladerf *dev, int *gain)
 
 static int set_tx_gain(struct bladerf *dev, int gain)
 {
-    struct bladerf_range const *txvga1_range = NULL;
-    struct bladerf_range const *txvga2_range = NULL;
-    bladerf_channel const ch                 = BLADERF_CHANNEL_TX(0);
-    int orig_gain                            = gain;
-    int txvga1, txvga2;
-    int status;
-
-    // get our gain stage ranges!
-    status = bladerf1_get_gain_stage_range(dev, ch, "txvga1", &txvga1_range);
-    if (status < 0) {
-        return status;
-    }
-
-    status = bladerf1_get_gain_stage_range(dev, ch, "txvga2", &txvga2_range);
-    if (status < 0) {
-        return status;
-    }
-
-    txvga1 = __unscale_int(txvga1_range, txvga1_range->min);
-    txvga2 = __unscale_int(txvga2_range, txvga2_range->min);
-
-    // offset gain so that we can use it as a counter when apportioning gain
-    gain -= __round_int((BLADERF1_TX_GAIN_OFFSET +
-                         __unscale_int(txvga1_range, txvga1_range->min) +
-                         __unscale_int(txvga2_range, txvga2_range->min)));
-
-    // apportion gain to TXVGA2
-    _apportion_gain(txvga2_range, &txvga2, &gain);
-
-    // apportion gain to TXVGA1
-    _apportion_gain(txvga1_range, &txvga1, &gain);
-
-    // verification
-    if (gain != 0) {
-        log_warning("%s: unable to achieve requested gain %d (missed by %d)\n",
-                    __FUNCTION__, orig_gain, gain);
-        log_debug("%s: gain=%d -> txvga2=%d txvga1=%d remainder=%d\n",
-                  __FUNCTION__, orig_gain, txvga2, txvga1, gain);
-    }
-
-    status = lms_txvga1_set_gain(dev, txvga1);
-    if (status < 0) {
-        return status;
-    }
-
-    status = lms_txvga2_set_gain(dev, txvga2);
-    if (status < 0) {
-        return status;
-    }
+    struct bladerf1_board_data *board_data = dev->board_data;
 
-    return 0;
+    return lms_set_gain_regs(
+        dev, BLADERF_MODULE_TX,
+        _gain_table_entry(board_data, BLADERF_CHANNEL_TX(0), gain));
 }
 
 static int get_tx_gain(struct bladerf *dev, int *gain)
@@ -1911,16 +2045,20 @@ static int bladerf1_get_gain_stages(struct bladerf *dev,
 
 static int bladerf1_set_sample_rate(struct bladerf *dev, bladerf_channel ch, unsigned int rate, unsigned int *actual)
 {
+    struct bladerf1_board_data *board_data = dev->board_data;
+
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-    return si5338_set_sample_rate(dev, ch, rate, actual);
+    return si5338_set_sample_rate(dev, &board_data->si5338, ch, rate, actual);
 }
 
 static int bladerf1_get_sample_rate(struct bladerf *dev, bladerf_channel ch, unsigned int *rate)
 {
+    struct bladerf1_board_data *board_data = dev->board_data;
+
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-    return si5338_get_sample_rate(dev, ch, rate);
+    return si5338_get_sample_rate(dev, &board_data->si5338, ch, rate);
 }
 
 static int bladerf1_get_sample_rate_range(struct bladerf *dev, bladerf_channel ch, const struct bladerf_range **range)
@@ -1931,16 +2069,28 @@ static int bladerf1_get_sample_rate_range(struct bladerf *dev, bladerf_channel c
 
 static int bladerf1_set_rational_sample_rate(struct bladerf *dev, bladerf_channel ch, struct bladerf_rational_rate *rate, struct bladerf_rational_rate *actual)
 {
+    struct bladerf1_board_data *board_data = dev->board_data;
+
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-    return si5338_set_rational_sample_rate(dev, ch, rate, actual);
+    return si5338_set_rational_sample_rate(dev, &board_data->si5338, ch, rate,
+                                           actual);
 }
 
 static int bladerf1_get_rational_sample_rate(struct bladerf *dev, bladerf_channel ch, struct bladerf_rational_rate *rate)
 {
+    struct bladerf1_board_data *board_data = dev->board_data;
+
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-    return si5338_get_rational_sample_rate(dev, ch, rate);
+    return si5338_get_rational_sample_rate(dev, &board_data->si5338, ch, rate);
+}
+
+static int bladerf1_switch_sample_rate(struct bladerf *dev, bladerf_channel ch, unsigned int rate, unsigned int *actual)
+{
+    log_debug("Switching the sample rate of a running stream is not "
+              "supported by the bladeRF x40/x115\n");
+    return BLADERF_ERR_UNSUPPORTED;
 }
 
 /******************************************************************************/
@@ -2055,14 +2205,25 @@ static int bladerf1_set_frequency(struct bladerf *dev,
     }
 
     switch (board_data->tuning_mode) {
-        case BLADERF_TUNING_MODE_HOST:
-            status = lms_set_frequency(dev, ch, (uint32_t)frequency);
+        case BLADERF_TUNING_MODE_HOST: {
+            struct lms_freq f;
+
+            status = lms_calculate_tuning_params((uint32_t)frequency, &f);
+            if (status != 0) {
+                return status;
+            }
+
+            status = lms_set_precalculated_frequency(dev, ch, &f);
             if (status != 0) {
                 return status;
             }
 
+            vcocap_model_record(&board_data->vcocap[ch], (uint32_t)frequency,
+                                f.freqsel, f.vcocap_result);
+
             status = band_select(dev, ch, frequency < BLADERF1_BAND_HIGH);
             break;
+        }
 
         case BLADERF_TUNING_MODE_FPGA: {
             status = dev->board->schedule_retune(dev, ch, BLADERF_RETUNE_NOW,
@@ -2356,79 +2517,290 @@ static int bladerf1_get_rf_ports(struct bladerf *dev,
 }
 
 /******************************************************************************/
-/* Scheduled Tuning */
+/* Channel configuration */
 /******************************************************************************/
 
-static int bladerf1_get_quick_tune(struct bladerf *dev,
-                                   bladerf_channel ch,
-                                   struct bladerf_quick_tune *quick_tune)
+static int bladerf1_apply_config(struct bladerf *dev,
+                                 bladerf_channel ch,
+                                 const struct bladerf_channel_config *config)
 {
+    uint32_t changes;
+    int status;
+
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-    return lms_get_quick_tune(dev, ch, quick_tune);
+    if (config == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    status = channel_config_check(dev, ch, config);
+    if (status != 0) {
+        return status;
+    }
+
+    status = channel_config_changes(dev, ch, config, &changes);
+    if (status != 0) {
+        return status;
+    }
+
+    return channel_config_apply(dev, ch, config, changes);
 }
 
-static int bladerf1_schedule_retune(struct bladerf *dev,
-                                    bladerf_channel ch,
-                                    bladerf_timestamp timestamp,
-                                    bladerf_frequency frequency,
-                                    struct bladerf_quick_tune *quick_tune)
+/******************************************************************************/
+/* Scheduled Tuning */
+/******************************************************************************/
 
+/* Capture the channel's current DC offset and IQ balance corrections */
+static int _quick_tune_get_corr(struct bladerf *dev,
+                                bladerf_channel ch,
+                                struct bladerf_quick_tune *quick_tune)
 {
-    struct bladerf1_board_data *board_data = dev->board_data;
     int status;
-    struct lms_freq f;
 
-    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+    status = lms_get_dc_offset_i(dev, ch, &quick_tune->dc_i);
+    if (status != 0) {
+        return status;
+    }
 
-    if (!have_cap(board_data->capabilities, BLADERF_CAP_SCHEDULED_RETUNE)) {
-        log_debug("This FPGA version (%u.%u.%u) does not support "
-                  "scheduled retunes.\n",
-                  board_data->fpga_version.major,
-                  board_data->fpga_version.minor,
-                  board_data->fpga_version.patch);
+    status = lms_get_dc_offset_q(dev, ch, &quick_tune->dc_q);
+    if (status != 0) {
+        return status;
+    }
 
-        return BLADERF_ERR_UNSUPPORTED;
+    status = dev->backend->get_iq_gain_correction(dev, ch,
+                                                  &quick_tune->iq_gain);
+    if (status != 0) {
+        return status;
     }
 
-    if (quick_tune == NULL) {
-        if (dev->xb == BLADERF_XB_200) {
-           log_error("Consider supplying the quick_tune parameter to"
-                 " bladerf_schedule_retune() when the XB-200 is enabled.\n");
-        }
-        status = lms_calculate_tuning_params((uint32_t)frequency, &f);
-        if (status != 0) {
-            return status;
-        }
-    } else {
-        f.freqsel       = quick_tune->freqsel;
-        f.vcocap        = quick_tune->vcocap;
-        f.nint          = quick_tune->nint;
-        f.nfrac         = quick_tune->nfrac;
-        f.flags         = quick_tune->flags;
-        f.xb_gpio       = quick_tune->xb_gpio;
-        f.x             = 0;
-        f.vcocap_result = 0;
+    /* Undo the gain control offset */
+    quick_tune->iq_gain -= 4096;
+
+    status = dev->backend->get_iq_phase_correction(dev, ch,
+                                                   &quick_tune->iq_phase);
+    if (status != 0) {
+        return status;
     }
 
-    return dev->backend->retune(dev, ch, timestamp, f.nint, f.nfrac, f.freqsel,
-                                f.vcocap,
-                                (f.flags & LMS_FREQ_FLAGS_LOW_BAND) != 0,
-                                f.xb_gpio,
-                                (f.flags & LMS_FREQ_FLAGS_FORCE_VCOCAP) != 0);
+    quick_tune->flags |= LMS_FREQ_FLAGS_DC_CORR | LMS_FREQ_FLAGS_IQ_CORR;
+
+    return 0;
 }
 
-static int bladerf1_cancel_scheduled_retunes(struct bladerf *dev,
-                                             bladerf_channel ch)
+/* Fill in the DC offset corrections for the specified frequency from the
+ * channel's DC calibration table, if one is loaded */
+static void _quick_tune_table_corr(struct bladerf *dev,
+                                   bladerf_channel ch,
+                                   uint32_t frequency,
+                                   struct bladerf_quick_tune *quick_tune)
 {
     struct bladerf1_board_data *board_data = dev->board_data;
-    int status;
+    const struct dc_cal_tbl *dc_cal = (ch == BLADERF_CHANNEL_RX(0))
+                                          ? board_data->cal.dc_rx
+                                          : board_data->cal.dc_tx;
+    struct dc_cal_entry entry;
 
-    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+    if (dc_cal != NULL) {
+        dc_cal_tbl_entry(dc_cal, frequency, &entry);
+
+        quick_tune->dc_i   = entry.dc_i;
+        quick_tune->dc_q   = entry.dc_q;
+        quick_tune->flags |= LMS_FREQ_FLAGS_DC_CORR;
+    }
+}
+
+static int bladerf1_get_quick_tune(struct bladerf *dev,
+                                   bladerf_channel ch,
+                                   struct bladerf_quick_tune *quick_tune)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+    struct lms_freq f;
+    int status;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    status = lms_get_quick_tune(dev, ch, quick_tune);
+    if (status != 0) {
+        return status;
+    }
+
+    quick_tune->dc_i     = 0;
+    quick_tune->dc_q     = 0;
+    quick_tune->iq_gain  = 0;
+    quick_tune->iq_phase = 0;
+
+    if (have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RETUNE_CORR)) {
+        status = _quick_tune_get_corr(dev, ch, quick_tune);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    f.freqsel = quick_tune->freqsel;
+    f.nint    = quick_tune->nint;
+    f.nfrac   = quick_tune->nfrac;
+    f.x       = 1 << ((f.freqsel & 7) - 3);
+
+    vcocap_model_record(&board_data->vcocap[ch], lms_frequency_to_hz(&f),
+                        quick_tune->freqsel, quick_tune->vcocap);
+
+    return 0;
+}
+
+/* Stage the corrections carried by a quick tune, to be applied by the FPGA
+ * along with the retune request that follows */
+static int _retune_corr(struct bladerf *dev,
+                        bladerf_channel ch,
+                        const struct bladerf_quick_tune *quick_tune)
+{
+    uint8_t flags = 0;
+    uint8_t dc_i  = 0;
+    uint8_t dc_q  = 0;
+
+    if (quick_tune->flags & LMS_FREQ_FLAGS_DC_CORR) {
+        flags |= NIOS_PKT_RETUNE_CORR_DC;
+        dc_i   = lms_dc_offset_to_reg(ch, quick_tune->dc_i);
+        dc_q   = lms_dc_offset_to_reg(ch, quick_tune->dc_q);
+    }
+
+    if (quick_tune->flags & LMS_FREQ_FLAGS_IQ_CORR) {
+        flags |= NIOS_PKT_RETUNE_CORR_IQ;
+    }
+
+    /* Gain correction requires than an offset be applied */
+    return dev->backend->retune_corr(dev, ch, flags, dc_i, dc_q,
+                                     (uint16_t)(quick_tune->iq_gain + 4096),
+                                     (uint16_t)quick_tune->iq_phase, 0, 0, 0);
+}
+
+/* Schedule or replace a retune, as specified by a NIOS_PKT_RETUNE_OP_* value */
+static int _retune_op(struct bladerf *dev,
+                      bladerf_channel ch,
+                      bladerf_timestamp timestamp,
+                      bladerf_frequency frequency,
+                      struct bladerf_quick_tune *quick_tune,
+                      uint8_t op)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+    const bool corr = have_cap(board_data->capabilities,
+                               BLADERF_CAP_FPGA_RETUNE_CORR);
+    int status;
+    struct lms_freq f;
+    uint8_t xb_gpio = 0;
+
+    if (quick_tune == NULL) {
+        /* The FPGA switches the XB-200 path and filterbank along with the
+         * retune, so that they take effect at its timestamp */
+        if (dev->xb == BLADERF_XB_200) {
+            status = xb200_retune_params(dev, ch, frequency, &frequency,
+                                         &xb_gpio);
+            if (status != 0) {
+                return status;
+            }
+        }
+
+        status = lms_calculate_tuning_params((uint32_t)frequency, &f);
+        if (status != 0) {
+            return status;
+        }
+
+        f.xb_gpio = xb_gpio;
+
+        /* bladerf_set_frequency() applies the DC calibration table itself
+         * after retuning "now" */
+        if (corr && timestamp != BLADERF_RETUNE_NOW) {
+            struct bladerf_quick_tune table_corr;
+
+            table_corr.flags = 0;
+            _quick_tune_table_corr(dev, ch, (uint32_t)frequency, &table_corr);
+
+            if (table_corr.flags != 0) {
+                table_corr.iq_gain  = 0;
+                table_corr.iq_phase = 0;
+
+                status = _retune_corr(dev, ch, &table_corr);
+                if (status != 0) {
+                    return status;
+                }
+            }
+        }
+    } else {
+        if (corr && (quick_tune->flags & (LMS_FREQ_FLAGS_DC_CORR |
+                                          LMS_FREQ_FLAGS_IQ_CORR))) {
+            status = _retune_corr(dev, ch, quick_tune);
+            if (status != 0) {
+                return status;
+            }
+        }
+
+        f.freqsel       = quick_tune->freqsel;
+        f.vcocap        = quick_tune->vcocap;
+        f.nint          = quick_tune->nint;
+        f.nfrac         = quick_tune->nfrac;
+        f.flags         = quick_tune->flags;
+        f.xb_gpio       = quick_tune->xb_gpio;
+        f.x             = 0;
+        f.vcocap_result = 0;
+    }
+
+    status = dev->backend->retune(dev, ch, timestamp, f.nint, f.nfrac,
+                                  f.freqsel, f.vcocap,
+                                  (f.flags & LMS_FREQ_FLAGS_LOW_BAND) != 0,
+                                  f.xb_gpio,
+                                  (f.flags & LMS_FREQ_FLAGS_FORCE_VCOCAP) != 0,
+                                  op);
+
+    if (f.xb_gpio & LMS_FREQ_XB_200_ENABLE) {
+        if (timestamp == BLADERF_RETUNE_NOW) {
+            xb200_gpio_invalidate(dev);
+        } else {
+            xb200_retune_scheduled(dev, ch, true);
+        }
+    }
+
+    return status;
+}
+
+static int bladerf1_schedule_retune(struct bladerf *dev,
+                                    bladerf_channel ch,
+                                    bladerf_timestamp timestamp,
+                                    bladerf_frequency frequency,
+                                    struct bladerf_quick_tune *quick_tune)
+
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_SCHEDULED_RETUNE)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "scheduled retunes.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return _retune_op(dev, ch, timestamp, frequency, quick_tune,
+                      NIOS_PKT_RETUNE_OP_SCHEDULE);
+}
+
+static int bladerf1_cancel_scheduled_retunes(struct bladerf *dev,
+                                             bladerf_channel ch)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+    int status;
+
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
 
     if (have_cap(board_data->capabilities, BLADERF_CAP_SCHEDULED_RETUNE)) {
         status = dev->backend->retune(dev, ch, NIOS_PKT_RETUNE_CLEAR_QUEUE, 0,
-                                      0, 0, 0, false, 0, false);
+                                      0, 0, 0, false, 0, false,
+                                      NIOS_PKT_RETUNE_OP_SCHEDULE);
+        if (status == 0) {
+            xb200_retune_scheduled(dev, ch, false);
+        }
     } else {
         log_debug("This FPGA version (%u.%u.%u) does not support "
                   "scheduled retunes.\n",
@@ -2442,6 +2814,133 @@ static int bladerf1_cancel_scheduled_retunes(struct bladerf *dev,
     return status;
 }
 
+static int bladerf1_cancel_scheduled_retune(struct bladerf *dev,
+                                            bladerf_channel ch,
+                                            bladerf_timestamp timestamp)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RETUNE_EDIT)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "cancelling individual scheduled retunes.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return dev->backend->retune(dev, ch, timestamp, 0, 0, 0, 0, false, 0,
+                                false, NIOS_PKT_RETUNE_OP_CANCEL);
+}
+
+static int bladerf1_replace_scheduled_retune(
+    struct bladerf *dev,
+    bladerf_channel ch,
+    bladerf_timestamp timestamp,
+    bladerf_frequency frequency,
+    struct bladerf_quick_tune *quick_tune)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RETUNE_EDIT)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "replacing individual scheduled retunes.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return _retune_op(dev, ch, timestamp, frequency, quick_tune,
+                      NIOS_PKT_RETUNE_OP_REPLACE);
+}
+
+static int bladerf1_schedule_retune_pair(struct bladerf *dev,
+                                         bladerf_timestamp timestamp,
+                                         const struct bladerf_quick_tune *rx,
+                                         const struct bladerf_quick_tune *tx)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    /* The LMS6002D retune parameters for both modules do not fit in a single
+     * retune packet, so each module must be scheduled separately. */
+    log_debug("Paired RX/TX retunes are not supported on the bladeRF x40/x115."
+              " Use bladerf_schedule_retune() for each module.\n");
+
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int bladerf1_get_retune_stats(struct bladerf *dev,
+                                     bladerf_channel ch,
+                                     struct bladerf_retune_stats *stats)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RETUNE_STATS)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "retune statistics.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return dev->backend->get_retune_stats(dev, ch, stats);
+}
+
+static int bladerf1_schedule_gain(struct bladerf *dev,
+                                  bladerf_channel ch,
+                                  bladerf_timestamp timestamp,
+                                  int gain)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+    struct lms_gain_regs const *regs;
+    int status;
+
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_TX(0)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (timestamp == BLADERF_RETUNE_NOW) {
+        return bladerf1_set_gain(dev, ch, gain);
+    }
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RETUNE_GAIN)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "scheduled gain changes.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    regs = _gain_table_entry(board_data, ch, gain);
+
+    /* Stage the gain stage settings, then queue an entry at the requested
+     * time that applies them without retuning. */
+    status = dev->backend->retune_corr(
+        dev, ch, NIOS_PKT_RETUNE_CORR_GAIN | NIOS_PKT_RETUNE_CORR_NO_TUNE, 0,
+        0, 0, 0, regs->lna, regs->vga1, regs->vga2);
+    if (status != 0) {
+        return status;
+    }
+
+    return dev->backend->retune(dev, ch, timestamp, 0, 0, 0, 0, false, 0,
+                                false, NIOS_PKT_RETUNE_OP_SCHEDULE);
+}
+
 /******************************************************************************/
 /* DC/Phase/Gain Correction */
 /******************************************************************************/
@@ -2519,6 +3018,20 @@ static int bladerf1_set_correction(struct bladerf *dev, bladerf_channel ch,
     return status;
 }
 
+static int bladerf1_get_temperature(struct bladerf *dev, float *val)
+{
+    /* The LMS6002D does not provide a temperature sensor */
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int bladerf1_read_telemetry(struct bladerf *dev,
+                                   uint32_t items,
+                                   struct bladerf_telemetry *t)
+{
+    /* None of the telemetry items are available on the bladeRF1 */
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
 /******************************************************************************/
 /* Trigger */
 /******************************************************************************/
@@ -2598,6 +3111,17 @@ static int bladerf1_trigger_state(struct bladerf *dev, const struct bladerf_trig
     return status;
 }
 
+static int bladerf1_trigger_fire_at(struct bladerf *dev, const struct bladerf_trigger *trigger, uint64_t timestamp)
+{
+    /* The bladeRF x40/x115 FPGA has no trigger timer */
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int bladerf1_trigger_fire_time(struct bladerf *dev, const struct bladerf_trigger *trigger, bool *has_fired, uint64_t *timestamp)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
 /******************************************************************************/
 /* Streaming */
 /******************************************************************************/
@@ -2609,13 +3133,20 @@ static inline int requires_timestamps(bladerf_format format, bool *required)
     switch (format) {
         case BLADERF_FORMAT_SC16_Q11_META:
         case BLADERF_FORMAT_PACKET_META:
+        case BLADERF_FORMAT_CF32_META:
             *required = true;
             break;
 
         case BLADERF_FORMAT_SC16_Q11:
+        case BLADERF_FORMAT_CF32:
             *required = false;
             break;
 
+        case BLADERF_FORMAT_SC8_Q7:
+        case BLADERF_FORMAT_SC8_Q7_META:
+            /* 8-bit sample mode is only implemented by the bladeRF 2 FPGA */
+            return BLADERF_ERR_UNSUPPORTED;
+
         default:
             return BLADERF_ERR_INVAL;
     }
@@ -2647,7 +3178,7 @@ static int perform_format_config(struct bladerf *dev, bladerf_direction dir,
 
     status = requires_timestamps(format, &use_timestamps);
     if (status != 0) {
-        log_debug("%s: Invalid format: %d\n", __FUNCTION__, format);
+        log_debug("%s: Unsupported format: %d\n", __FUNCTION__, format);
         return status;
     }
 
@@ -2731,7 +3262,8 @@ static int bladerf1_init_stream(struct bladerf_stream **stream, struct bladerf *
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
     return async_init_stream(stream, dev, callback, buffers, num_buffers,
-                             format, samples_per_buffer, num_transfers, user_data);
+                             format, samples_per_buffer,
+                             ASYNC_BUFFER_GRANULARITY, num_transfers, user_data);
 }
 
 static int bladerf1_stream(struct bladerf_stream *stream, bladerf_channel_layout layout)
@@ -2818,6 +3350,21 @@ static int bladerf1_sync_config(struct bladerf *dev, bladerf_channel_layout layo
     return status;
 }
 
+static int bladerf1_sync_start(struct bladerf *dev, bladerf_direction dir)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!board_data->sync[dir].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_start(&board_data->sync[dir]);
+}
+
 static int bladerf1_sync_tx(struct bladerf *dev,
                             void const *samples,
                             unsigned int num_samples,
@@ -2837,6 +3384,34 @@ static int bladerf1_sync_tx(struct bladerf *dev,
     return status;
 }
 
+static int bladerf1_sync_tx_acquire(struct bladerf *dev,
+                                    void **samples,
+                                    unsigned int *num_samples,
+                                    unsigned int timeout_ms)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_tx_acquire(&board_data->sync[BLADERF_TX], samples, num_samples,
+                           timeout_ms);
+}
+
+static int bladerf1_sync_tx_commit(struct bladerf *dev,
+                                   const void *samples,
+                                   unsigned int num_samples)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_tx_commit(&board_data->sync[BLADERF_TX], samples, num_samples);
+}
+
 static int bladerf1_sync_rx(struct bladerf *dev,
                             void *samples,
                             unsigned int num_samples,
@@ -2844,16 +3419,272 @@ static int bladerf1_sync_rx(struct bladerf *dev,
                             unsigned int timeout_ms)
 {
     struct bladerf1_board_data *board_data = dev->board_data;
-    int status;
+    int status;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    status = sync_rx(&board_data->sync[BLADERF_RX], samples, num_samples,
+                     metadata, timeout_ms);
+
+    return status;
+}
+
+static int bladerf1_sync_rx_planar(struct bladerf *dev,
+                                   void *const samples[],
+                                   unsigned int num_samples,
+                                   struct bladerf_metadata *metadata,
+                                   unsigned int timeout_ms)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_rx_planar(&board_data->sync[BLADERF_RX], samples, num_samples,
+                          metadata, timeout_ms);
+}
+
+static int bladerf1_sync_rx_channel(struct bladerf *dev,
+                                    bladerf_channel ch,
+                                    void *samples,
+                                    unsigned int num_samples,
+                                    struct bladerf_metadata *metadata,
+                                    unsigned int timeout_ms)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_split_rx(&board_data->sync[BLADERF_RX], ch >> 1, samples,
+                         num_samples, metadata, timeout_ms);
+}
+
+static int bladerf1_sync_rx_acquire(struct bladerf *dev,
+                                    void **samples,
+                                    unsigned int *num_samples,
+                                    struct bladerf_metadata *metadata,
+                                    unsigned int timeout_ms)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_rx_acquire(&board_data->sync[BLADERF_RX], samples, num_samples,
+                           metadata, timeout_ms);
+}
+
+static int bladerf1_sync_rx_release(struct bladerf *dev, const void *samples)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_rx_release(&board_data->sync[BLADERF_RX], samples);
+}
+
+static int bladerf1_rx_tap_acquire(struct bladerf *dev,
+                                   unsigned int tap,
+                                   const void **samples,
+                                   unsigned int *num_samples,
+                                   struct bladerf_metadata *metadata,
+                                   unsigned int timeout_ms)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_tap_acquire(&board_data->sync[BLADERF_RX], tap, samples,
+                            num_samples, metadata, timeout_ms);
+}
+
+static int bladerf1_rx_tap_release(struct bladerf *dev,
+                                   unsigned int tap,
+                                   const void *samples)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_tap_release(&board_data->sync[BLADERF_RX], tap, samples);
+}
+
+static int bladerf1_sync_rx_deadline(struct bladerf *dev,
+                                     void *samples,
+                                     unsigned int num_samples,
+                                     struct bladerf_metadata *metadata,
+                                     uint64_t deadline_ns)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_rx_deadline(&board_data->sync[BLADERF_RX], samples,
+                            num_samples, metadata, deadline_ns);
+}
+
+static int bladerf1_sync_tx_deadline(struct bladerf *dev,
+                                     void const *samples,
+                                     unsigned int num_samples,
+                                     struct bladerf_metadata *metadata,
+                                     uint64_t deadline_ns)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_tx_deadline(&board_data->sync[BLADERF_TX], samples,
+                            num_samples, metadata, deadline_ns);
+}
+
+static int bladerf1_sync_rxv(struct bladerf *dev,
+                             const struct bladerf_sync_iov *iov,
+                             unsigned int iovcnt,
+                             unsigned int *completed,
+                             unsigned int timeout_ms)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_rxv(&board_data->sync[BLADERF_RX], iov, iovcnt, completed,
+                    timeout_ms);
+}
+
+static int bladerf1_sync_txv(struct bladerf *dev,
+                             const struct bladerf_sync_iov *iov,
+                             unsigned int iovcnt,
+                             unsigned int *completed,
+                             unsigned int timeout_ms)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_txv(&board_data->sync[BLADERF_TX], iov, iovcnt, completed,
+                    timeout_ms);
+}
+
+static int bladerf1_sync_rxtx(struct bladerf *dev,
+                              void *rx_samples,
+                              unsigned int rx_num_samples,
+                              struct bladerf_metadata *rx_metadata,
+                              const void *tx_samples,
+                              unsigned int tx_num_samples,
+                              struct bladerf_metadata *tx_metadata,
+                              uint64_t tx_offset,
+                              unsigned int timeout_ms)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized ||
+        !board_data->sync[BLADERF_TX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_rxtx(&board_data->sync[BLADERF_RX],
+                     &board_data->sync[BLADERF_TX], rx_samples,
+                     rx_num_samples, rx_metadata, tx_samples,
+                     tx_num_samples, tx_metadata, tx_offset, timeout_ms);
+}
+
+static int bladerf1_get_sync_stats(struct bladerf *dev,
+                                   bladerf_direction dir,
+                                   struct bladerf_stream_stats *stats)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!board_data->sync[dir].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_get_stats(&board_data->sync[dir], stats);
+}
+
+static int bladerf1_get_sync_latency(struct bladerf *dev,
+                                     bladerf_direction dir,
+                                     struct bladerf_sync_latency *latency)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!board_data->sync[dir].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_get_latency(&board_data->sync[dir], latency);
+}
+
+static int bladerf1_get_sync_poll_handle(struct bladerf *dev,
+                                         bladerf_direction dir,
+                                         bladerf_poll_handle *handle)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!board_data->sync[dir].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_get_poll_handle(&board_data->sync[dir], handle);
+}
+
+static int bladerf1_read_rx_capture(struct bladerf *dev,
+                                    void *samples,
+                                    unsigned int num_samples,
+                                    struct bladerf_metadata *metadata)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_capture_read(&board_data->sync[BLADERF_RX], samples,
+                             num_samples, metadata);
+}
+
+static int bladerf1_get_rx_capture_range(struct bladerf *dev,
+                                         bladerf_timestamp *oldest,
+                                         bladerf_timestamp *newest)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
 
     if (!board_data->sync[BLADERF_RX].initialized) {
         return BLADERF_ERR_INVAL;
     }
 
-    status = sync_rx(&board_data->sync[BLADERF_RX], samples, num_samples,
-                     metadata, timeout_ms);
-
-    return status;
+    return sync_capture_range(&board_data->sync[BLADERF_RX], oldest, newest);
 }
 
 static int bladerf1_get_timestamp(struct bladerf *dev,
@@ -2865,6 +3696,22 @@ static int bladerf1_get_timestamp(struct bladerf *dev,
     return dev->backend->get_timestamp(dev, dir, value);
 }
 
+static int bladerf1_get_timestamp_latch(struct bladerf *dev,
+                                        bladerf_direction dir,
+                                        bladerf_timestamp *timestamp,
+                                        uint32_t *hold)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_TS_LATCH)) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return dev->backend->get_timestamp_latch(dev, dir, timestamp, hold);
+}
+
 /******************************************************************************/
 /* FPGA/Firmware Loading/Flashing */
 /******************************************************************************/
@@ -2932,6 +3779,14 @@ static int bladerf1_load_fpga(struct bladerf *dev, const uint8_t *buf, size_t le
 
     MUTEX_LOCK(&dev->lock);
 
+    /* Nothing to do if the device was already initialized with this image */
+    if (board_data->state == STATE_INITIALIZED &&
+        dev->backend->is_fpga_image_loaded(dev, buf, length) == 1) {
+        log_debug("%s: FPGA image is already loaded\n", __FUNCTION__);
+        MUTEX_UNLOCK(&dev->lock);
+        return 0;
+    }
+
     status = dev->backend->load_fpga(dev, buf, length);
     if (status != 0) {
         MUTEX_UNLOCK(&dev->lock);
@@ -3229,10 +4084,201 @@ static int bladerf1_get_rx_mux(struct bladerf *dev, bladerf_rx_mux *mode)
     return status;
 }
 
+/******************************************************************************/
+/* RX digital downconverter */
+/******************************************************************************/
+
+static int bladerf1_set_rx_ddc(struct bladerf *dev,
+                               int64_t offset,
+                               unsigned int decimation)
+{
+    /* The bladeRF x40/x115 FPGA does not provide a downconverter */
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int bladerf1_get_rx_ddc(struct bladerf *dev,
+                               int64_t *offset,
+                               unsigned int *decimation)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+/******************************************************************************/
+/* TX digital upconverter */
+/******************************************************************************/
+
+static int bladerf1_set_tx_duc(struct bladerf *dev,
+                               int64_t offset,
+                               unsigned int interpolation)
+{
+    /* The bladeRF x40/x115 FPGA does not provide an upconverter */
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int bladerf1_get_tx_duc(struct bladerf *dev,
+                               int64_t *offset,
+                               unsigned int *interpolation)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+/******************************************************************************/
+/* RX power detector */
+/******************************************************************************/
+
+static int bladerf1_set_rx_power_detector(struct bladerf *dev,
+                                          unsigned int block_length)
+{
+    /* The bladeRF x40/x115 FPGA does not provide a power detector */
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int bladerf1_get_rx_power_detector(struct bladerf *dev,
+                                          unsigned int *block_length)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int bladerf1_get_rx_power(struct bladerf *dev,
+                                 bladerf_channel ch,
+                                 struct bladerf_rx_power *power)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+/******************************************************************************/
+/* RX burst gate */
+/******************************************************************************/
+
+static int bladerf1_set_rx_burst_gate(struct bladerf *dev,
+                                      const struct bladerf_rx_burst_gate *gate)
+{
+    /* The bladeRF x40/x115 FPGA does not provide a burst gate */
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int bladerf1_get_rx_burst_gate(struct bladerf *dev,
+                                      struct bladerf_rx_burst_gate *gate)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+/******************************************************************************/
+/* Sample FIFO levels */
+/******************************************************************************/
+
+static int bladerf1_get_fifo_levels(struct bladerf *dev,
+                                    struct bladerf_fifo_levels *levels,
+                                    bool reset_high_water)
+{
+    /* The bladeRF x40/x115 FPGA does not report its FIFO levels */
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+/******************************************************************************/
+/* TX waveform loop */
+/******************************************************************************/
+
+static int bladerf1_tx_loop_load(struct bladerf *dev, unsigned int num_samples)
+{
+    /* The bladeRF x40/x115 FPGA has no TX waveform loop */
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int bladerf1_tx_loop_start(struct bladerf *dev,
+                                  uint64_t start,
+                                  uint64_t stop)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int bladerf1_tx_loop_stop(struct bladerf *dev, uint64_t timestamp)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int bladerf1_get_tx_loop_status(struct bladerf *dev,
+                                       struct bladerf_tx_loop_status *status)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
 /******************************************************************************/
 /* Low-level VCTCXO Tamer Mode */
 /******************************************************************************/
 
+/* Record the tamer's trim and slope, if it is running and has measured the
+ * slope */
+static void tamer_seed_save(struct bladerf *dev)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+    bladerf_vctcxo_tamer_mode mode;
+    uint32_t state, slope, trim;
+    int status;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_TAMER_SEED)) {
+        return;
+    }
+
+    /* The trim DAC may have been written directly while the tamer was off */
+    status = dev->backend->get_vctcxo_tamer_mode(dev, &mode);
+    if (status != 0 || mode == BLADERF_VCTCXO_TAMER_DISABLED) {
+        return;
+    }
+
+    status = dev->backend->vctcxo_tamer_read(
+        dev, NIOS_PKT_8x32_VCTCXO_TAMER_ADDR_STATE, &state);
+    if (status != 0 || state != NIOS_PKT_8x32_VCTCXO_TAMER_STATE_FINE) {
+        return;
+    }
+
+    status = dev->backend->vctcxo_tamer_read(
+        dev, NIOS_PKT_8x32_VCTCXO_TAMER_ADDR_SLOPE, &slope);
+    if (status == 0) {
+        status = dev->backend->vctcxo_tamer_read(
+            dev, NIOS_PKT_8x32_VCTCXO_TAMER_ADDR_TRIM, &trim);
+    }
+
+    if (status != 0) {
+        log_debug("Failed to read VCTCXO tamer state: %s\n",
+                  bladerf_strerror(status));
+        return;
+    }
+
+    if ((int32_t)slope != 0 && trim <= UINT16_MAX) {
+        tamer_cache_update(&board_data->tamer, (uint16_t)trim,
+                           (int32_t)slope);
+    }
+}
+
+/* Start the tamer fine tuning from the last recorded trim and slope */
+static void tamer_seed_restore(struct bladerf *dev)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+    int status;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_TAMER_SEED) ||
+        !board_data->tamer.valid) {
+        return;
+    }
+
+    status = dev->backend->vctcxo_tamer_write(
+        dev, NIOS_PKT_8x32_VCTCXO_TAMER_ADDR_SLOPE,
+        (uint32_t)board_data->tamer.slope);
+    if (status == 0) {
+        status = dev->backend->vctcxo_tamer_write(
+            dev, NIOS_PKT_8x32_VCTCXO_TAMER_ADDR_TRIM, board_data->tamer.trim);
+    }
+
+    if (status != 0) {
+        log_debug("Failed to seed VCTCXO tamer: %s\n",
+                  bladerf_strerror(status));
+    } else {
+        log_verbose("Seeded VCTCXO tamer with trim 0x%04x, slope %d\n",
+                    board_data->tamer.trim, (int)board_data->tamer.slope);
+    }
+}
+
 static int bladerf1_set_vctcxo_tamer_mode(struct bladerf *dev,
                                           bladerf_vctcxo_tamer_mode mode)
 {
@@ -3246,6 +4292,15 @@ static int bladerf1_set_vctcxo_tamer_mode(struct bladerf *dev,
         return BLADERF_ERR_UNSUPPORTED;
     }
 
+    /* Keep the result of any run in progress, so that a new run, or the next
+     * session, starts from it */
+    tamer_seed_save(dev);
+
+    if (mode == BLADERF_VCTCXO_TAMER_1_PPS ||
+        mode == BLADERF_VCTCXO_TAMER_10_MHZ) {
+        tamer_seed_restore(dev);
+    }
+
     return dev->backend->set_vctcxo_tamer_mode(dev, mode);
 }
 
@@ -3528,6 +4583,7 @@ const struct board_fns bladerf1_board_fns = {
     FIELD_INIT(.get_sample_rate, bladerf1_get_sample_rate),
     FIELD_INIT(.get_sample_rate_range, bladerf1_get_sample_rate_range),
     FIELD_INIT(.get_rational_sample_rate, bladerf1_get_rational_sample_rate),
+    FIELD_INIT(.switch_sample_rate, bladerf1_switch_sample_rate),
     FIELD_INIT(.set_bandwidth, bladerf1_set_bandwidth),
     FIELD_INIT(.get_bandwidth, bladerf1_get_bandwidth),
     FIELD_INIT(.get_bandwidth_range, bladerf1_get_bandwidth_range),
@@ -3538,16 +4594,27 @@ const struct board_fns bladerf1_board_fns = {
     FIELD_INIT(.set_rf_port, bladerf1_set_rf_port),
     FIELD_INIT(.get_rf_port, bladerf1_get_rf_port),
     FIELD_INIT(.get_rf_ports, bladerf1_get_rf_ports),
+    FIELD_INIT(.apply_config, bladerf1_apply_config),
     FIELD_INIT(.get_quick_tune, bladerf1_get_quick_tune),
     FIELD_INIT(.schedule_retune, bladerf1_schedule_retune),
     FIELD_INIT(.cancel_scheduled_retunes, bladerf1_cancel_scheduled_retunes),
+    FIELD_INIT(.cancel_scheduled_retune, bladerf1_cancel_scheduled_retune),
+    FIELD_INIT(.replace_scheduled_retune, bladerf1_replace_scheduled_retune),
+    FIELD_INIT(.schedule_retune_pair, bladerf1_schedule_retune_pair),
+    FIELD_INIT(.get_retune_stats, bladerf1_get_retune_stats),
+    FIELD_INIT(.schedule_gain, bladerf1_schedule_gain),
     FIELD_INIT(.get_correction, bladerf1_get_correction),
     FIELD_INIT(.set_correction, bladerf1_set_correction),
+    FIELD_INIT(.get_temperature, bladerf1_get_temperature),
+    FIELD_INIT(.read_telemetry, bladerf1_read_telemetry),
     FIELD_INIT(.trigger_init, bladerf1_trigger_init),
     FIELD_INIT(.trigger_arm, bladerf1_trigger_arm),
     FIELD_INIT(.trigger_fire, bladerf1_trigger_fire),
     FIELD_INIT(.trigger_state, bladerf1_trigger_state),
+    FIELD_INIT(.trigger_fire_at, bladerf1_trigger_fire_at),
+    FIELD_INIT(.trigger_fire_time, bladerf1_trigger_fire_time),
     FIELD_INIT(.enable_module, bladerf1_enable_module),
+    FIELD_INIT(.standby_module, bladerf1_standby_module),
     FIELD_INIT(.init_stream, bladerf1_init_stream),
     FIELD_INIT(.stream, bladerf1_stream),
     FIELD_INIT(.submit_stream_buffer, bladerf1_submit_stream_buffer),
@@ -3555,9 +4622,29 @@ const struct board_fns bladerf1_board_fns = {
     FIELD_INIT(.set_stream_timeout, bladerf1_set_stream_timeout),
     FIELD_INIT(.get_stream_timeout, bladerf1_get_stream_timeout),
     FIELD_INIT(.sync_config, bladerf1_sync_config),
+    FIELD_INIT(.sync_start, bladerf1_sync_start),
     FIELD_INIT(.sync_tx, bladerf1_sync_tx),
+    FIELD_INIT(.sync_tx_acquire, bladerf1_sync_tx_acquire),
+    FIELD_INIT(.sync_tx_commit, bladerf1_sync_tx_commit),
     FIELD_INIT(.sync_rx, bladerf1_sync_rx),
+    FIELD_INIT(.sync_rx_planar, bladerf1_sync_rx_planar),
+    FIELD_INIT(.sync_rx_channel, bladerf1_sync_rx_channel),
+    FIELD_INIT(.sync_rx_acquire, bladerf1_sync_rx_acquire),
+    FIELD_INIT(.sync_rx_release, bladerf1_sync_rx_release),
+    FIELD_INIT(.rx_tap_acquire, bladerf1_rx_tap_acquire),
+    FIELD_INIT(.rx_tap_release, bladerf1_rx_tap_release),
+    FIELD_INIT(.sync_rx_deadline, bladerf1_sync_rx_deadline),
+    FIELD_INIT(.sync_tx_deadline, bladerf1_sync_tx_deadline),
+    FIELD_INIT(.sync_rxv, bladerf1_sync_rxv),
+    FIELD_INIT(.sync_txv, bladerf1_sync_txv),
+    FIELD_INIT(.sync_rxtx, bladerf1_sync_rxtx),
+    FIELD_INIT(.get_sync_stats, bladerf1_get_sync_stats),
+    FIELD_INIT(.get_sync_latency, bladerf1_get_sync_latency),
+    FIELD_INIT(.get_sync_poll_handle, bladerf1_get_sync_poll_handle),
+    FIELD_INIT(.read_rx_capture, bladerf1_read_rx_capture),
+    FIELD_INIT(.get_rx_capture_range, bladerf1_get_rx_capture_range),
     FIELD_INIT(.get_timestamp, bladerf1_get_timestamp),
+    FIELD_INIT(.get_timestamp_latch, bladerf1_get_timestamp_latch),
     FIELD_INIT(.load_fpga, bladerf1_load_fpga),
     FIELD_INIT(.flash_fpga, bladerf1_flash_fpga),
     FIELD_INIT(.erase_stored_fpga, bladerf1_erase_stored_fpga),
@@ -3570,6 +4657,20 @@ const struct board_fns bladerf1_board_fns = {
     FIELD_INIT(.get_loopback, bladerf1_get_loopback),
     FIELD_INIT(.get_rx_mux, bladerf1_get_rx_mux),
     FIELD_INIT(.set_rx_mux, bladerf1_set_rx_mux),
+    FIELD_INIT(.set_rx_ddc, bladerf1_set_rx_ddc),
+    FIELD_INIT(.get_rx_ddc, bladerf1_get_rx_ddc),
+    FIELD_INIT(.set_tx_duc, bladerf1_set_tx_duc),
+    FIELD_INIT(.get_tx_duc, bladerf1_get_tx_duc),
+    FIELD_INIT(.set_rx_power_detector, bladerf1_set_rx_power_detector),
+    FIELD_INIT(.get_rx_power_detector, bladerf1_get_rx_power_detector),
+    FIELD_INIT(.get_rx_power, bladerf1_get_rx_power),
+    FIELD_INIT(.set_rx_burst_gate, bladerf1_set_rx_burst_gate),
+    FIELD_INIT(.get_rx_burst_gate, bladerf1_get_rx_burst_gate),
+    FIELD_INIT(.get_fifo_levels, bladerf1_get_fifo_levels),
+    FIELD_INIT(.tx_loop_load, bladerf1_tx_loop_load),
+    FIELD_INIT(.tx_loop_start, bladerf1_tx_loop_start),
+    FIELD_INIT(.tx_loop_stop, bladerf1_tx_loop_stop),
+    FIELD_INIT(.get_tx_loop_status, bladerf1_get_tx_loop_status),
     FIELD_INIT(.set_vctcxo_tamer_mode, bladerf1_set_vctcxo_tamer_mode),
     FIELD_INIT(.get_vctcxo_tamer_mode, bladerf1_get_vctcxo_tamer_mode),
     FIELD_INIT(.get_vctcxo_trim, bladerf1_get_vctcxo_trim),
@@ -3610,6 +4711,8 @@ int bladerf_set_txvga2(struct bladerf *dev, int gain)
 
     status = lms_txvga2_set_gain(dev, gain);
 
+    state_cache_flush(&dev->state_cache);
+
     MUTEX_UNLOCK(&dev->lock);
 
     return status;
@@ -3646,6 +4749,8 @@ int bladerf_set_txvga1(struct bladerf *dev, int gain)
 
     status = lms_txvga1_set_gain(dev, gain);
 
+    state_cache_flush(&dev->state_cache);
+
     MUTEX_UNLOCK(&dev->lock);
 
     return status;
@@ -3686,6 +4791,8 @@ int bladerf_set_lna_gain(struct bladerf *dev, bladerf_lna_gain gain)
 
     status = lms_lna_set_gain(dev, gain);
 
+    state_cache_flush(&dev->state_cache);
+
     MUTEX_UNLOCK(&dev->lock);
 
     return status;
@@ -3722,6 +4829,8 @@ int bladerf_set_rxvga1(struct bladerf *dev, int gain)
 
     status = lms_rxvga1_set_gain(dev, gain);
 
+    state_cache_flush(&dev->state_cache);
+
     MUTEX_UNLOCK(&dev->lock);
 
     return status;
@@ -3758,6 +4867,8 @@ int bladerf_set_rxvga2(struct bladerf *dev, int gain)
 
     status = lms_rxvga2_set_gain(dev, gain);
 
+    state_cache_flush(&dev->state_cache);
+
     MUTEX_UNLOCK(&dev->lock);
 
     return status;
@@ -3799,6 +4910,8 @@ int bladerf_set_lpf_mode(struct bladerf *dev, bladerf_channel ch,
 
     status = lms_lpf_set_mode(dev, ch, mode);
 
+    state_cache_flush(&dev->state_cache);
+
     MUTEX_UNLOCK(&dev->lock);
 
     return status;
@@ -3905,16 +5018,19 @@ int bladerf_set_smb_mode(struct bladerf *dev, bladerf_smb_mode mode)
 
 int bladerf_get_smb_frequency(struct bladerf *dev, unsigned int *rate)
 {
+    struct bladerf1_board_data *board_data;
     int status;
 
     if (dev->board != &bladerf1_board_fns)
         return BLADERF_ERR_UNSUPPORTED;
 
+    board_data = dev->board_data;
+
     MUTEX_LOCK(&dev->lock);
 
     CHECK_BOARD_STATE_LOCKED(STATE_INITIALIZED);
 
-    status = si5338_get_smb_freq(dev, rate);
+    status = si5338_get_smb_freq(dev, &board_data->si5338, rate);
 
     MUTEX_UNLOCK(&dev->lock);
 
@@ -3923,16 +5039,19 @@ int bladerf_get_smb_frequency(struct bladerf *dev, unsigned int *rate)
 
 int bladerf_set_smb_frequency(struct bladerf *dev, uint32_t rate, uint32_t *actual)
 {
+    struct bladerf1_board_data *board_data;
     int status;
 
     if (dev->board != &bladerf1_board_fns)
         return BLADERF_ERR_UNSUPPORTED;
 
+    board_data = dev->board_data;
+
     MUTEX_LOCK(&dev->lock);
 
     CHECK_BOARD_STATE_LOCKED(STATE_INITIALIZED);
 
-    status = si5338_set_smb_freq(dev, rate, actual);
+    status = si5338_set_smb_freq(dev, &board_data->si5338, rate, actual);
 
     MUTEX_UNLOCK(&dev->lock);
 
@@ -3941,16 +5060,19 @@ int bladerf_set_smb_frequency(struct bladerf *dev, uint32_t rate, uint32_t *actu
 
 int bladerf_get_rational_smb_frequency(struct bladerf *dev, struct bladerf_rational_rate *rate)
 {
+    struct bladerf1_board_data *board_data;
     int status;
 
     if (dev->board != &bladerf1_board_fns)
         return BLADERF_ERR_UNSUPPORTED;
 
+    board_data = dev->board_data;
+
     MUTEX_LOCK(&dev->lock);
 
     CHECK_BOARD_STATE_LOCKED(STATE_INITIALIZED);
 
-    status = si5338_get_rational_smb_freq(dev, rate);
+    status = si5338_get_rational_smb_freq(dev, &board_data->si5338, rate);
 
     MUTEX_UNLOCK(&dev->lock);
 
@@ -3959,16 +5081,20 @@ int bladerf_get_rational_smb_frequency(struct bladerf *dev, struct bladerf_ratio
 
 int bladerf_set_rational_smb_frequency(struct bladerf *dev, struct bladerf_rational_rate *rate, struct bladerf_rational_rate *actual)
 {
+    struct bladerf1_board_data *board_data;
     int status;
 
     if (dev->board != &bladerf1_board_fns)
         return BLADERF_ERR_UNSUPPORTED;
 
+    board_data = dev->board_data;
+
     MUTEX_LOCK(&dev->lock);
 
     CHECK_BOARD_STATE_LOCKED(STATE_INITIALIZED);
 
-    status = si5338_set_rational_smb_freq(dev, rate, actual);
+    status = si5338_set_rational_smb_freq(dev, &board_data->si5338, rate,
+                                          actual);
 
     MUTEX_UNLOCK(&dev->lock);
 
@@ -3997,6 +5123,73 @@ int bladerf_calibrate_dc(struct bladerf *dev, bladerf_cal_module module)
     return status;
 }
 
+/******************************************************************************/
+/* Offline quick tune */
+/******************************************************************************/
+
+int bladerf_calc_quick_tune(struct bladerf *dev,
+                            bladerf_channel ch,
+                            bladerf_frequency frequency,
+                            struct bladerf_quick_tune *quick_tune)
+{
+    struct bladerf1_board_data *board_data;
+    struct lms_freq f;
+    int status;
+
+    if (dev->board != &bladerf1_board_fns)
+        return BLADERF_ERR_UNSUPPORTED;
+
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_TX(0)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+
+    CHECK_BOARD_STATE_LOCKED(STATE_INITIALIZED);
+
+    board_data = dev->board_data;
+
+    quick_tune->xb_gpio = 0;
+
+    if (dev->xb == BLADERF_XB_200) {
+        status = xb200_retune_params(dev, ch, frequency, &frequency,
+                                     &quick_tune->xb_gpio);
+        if (status != 0) {
+            goto out;
+        }
+    }
+
+    status = lms_calculate_tuning_params((uint32_t)frequency, &f);
+    if (status != 0) {
+        goto out;
+    }
+
+    if (vcocap_model_predict(&board_data->vcocap[ch], (uint32_t)frequency,
+                             &f)) {
+        f.flags |= LMS_FREQ_FLAGS_FORCE_VCOCAP;
+    }
+
+    quick_tune->freqsel = f.freqsel;
+    quick_tune->vcocap  = f.vcocap;
+    quick_tune->nint    = f.nint;
+    quick_tune->nfrac   = f.nfrac;
+    quick_tune->flags   = f.flags;
+
+    quick_tune->dc_i     = 0;
+    quick_tune->dc_q     = 0;
+    quick_tune->iq_gain  = 0;
+    quick_tune->iq_phase = 0;
+
+    if (have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RETUNE_CORR)) {
+        _quick_tune_table_corr(dev, ch, (uint32_t)frequency, quick_tune);
+    }
+
+out:
+    MUTEX_UNLOCK(&dev->lock);
+
+    return status;
+}
+
 /******************************************************************************/
 /* Low-level Si5338 access */
 /******************************************************************************/
@@ -4021,17 +5214,82 @@ int bladerf_si5338_read(struct bladerf *dev, uint8_t address, uint8_t *val)
 
 int bladerf_si5338_write(struct bladerf *dev, uint8_t address, uint8_t val)
 {
+    struct bladerf1_board_data *board_data;
     int status;
 
     if (dev->board != &bladerf1_board_fns)
         return BLADERF_ERR_UNSUPPORTED;
 
+    board_data = dev->board_data;
+
     MUTEX_LOCK(&dev->lock);
 
     CHECK_BOARD_STATE_LOCKED(STATE_FPGA_LOADED);
 
     status = dev->backend->si5338_write(dev,address,val);
 
+    /* The register values the Si5338 driver last wrote may have changed */
+    si5338_cache_invalidate(&board_data->si5338);
+
+    state_cache_flush(&dev->state_cache);
+
+    MUTEX_UNLOCK(&dev->lock);
+
+    return status;
+}
+
+int bladerf_si5338_read_block(struct bladerf *dev,
+                              uint8_t address,
+                              uint8_t *vals,
+                              unsigned int count)
+{
+    int status;
+
+    if (dev->board != &bladerf1_board_fns)
+        return BLADERF_ERR_UNSUPPORTED;
+
+    MUTEX_LOCK(&dev->lock);
+
+    CHECK_BOARD_STATE_LOCKED(STATE_FPGA_LOADED);
+
+    status = dev->backend->si5338_block(dev, false, address, vals, count);
+
+    MUTEX_UNLOCK(&dev->lock);
+
+    return status;
+}
+
+int bladerf_si5338_write_block(struct bladerf *dev,
+                               uint8_t address,
+                               const uint8_t *vals,
+                               unsigned int count)
+{
+    struct bladerf1_board_data *board_data;
+    uint8_t data[256];
+    int status;
+
+    if (dev->board != &bladerf1_board_fns)
+        return BLADERF_ERR_UNSUPPORTED;
+
+    board_data = dev->board_data;
+
+    if (count > ARRAY_SIZE(data)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* The backend interface is shared between reads and writes */
+    memcpy(data, vals, count);
+
+    MUTEX_LOCK(&dev->lock);
+
+    CHECK_BOARD_STATE_LOCKED(STATE_FPGA_LOADED);
+
+    status = dev->backend->si5338_block(dev, true, address, data, count);
+
+    si5338_cache_invalidate(&board_data->si5338);
+
+    state_cache_flush(&dev->state_cache);
+
     MUTEX_UNLOCK(&dev->lock);
 
     return status;
@@ -4072,6 +5330,60 @@ int bladerf_lms_write(struct bladerf *dev, uint8_t address, uint8_t val)
 
     status = dev->backend->lms_write(dev,address,val);
 
+    state_cache_flush(&dev->state_cache);
+
+    MUTEX_UNLOCK(&dev->lock);
+
+    return status;
+}
+
+int bladerf_lms_read_block(struct bladerf *dev,
+                           uint8_t address,
+                           uint8_t *vals,
+                           unsigned int count)
+{
+    int status;
+
+    if (dev->board != &bladerf1_board_fns)
+        return BLADERF_ERR_UNSUPPORTED;
+
+    MUTEX_LOCK(&dev->lock);
+
+    CHECK_BOARD_STATE_LOCKED(STATE_FPGA_LOADED);
+
+    status = dev->backend->lms_block(dev, false, address, vals, count);
+
+    MUTEX_UNLOCK(&dev->lock);
+
+    return status;
+}
+
+int bladerf_lms_write_block(struct bladerf *dev,
+                            uint8_t address,
+                            const uint8_t *vals,
+                            unsigned int count)
+{
+    uint8_t data[256];
+    int status;
+
+    if (dev->board != &bladerf1_board_fns)
+        return BLADERF_ERR_UNSUPPORTED;
+
+    if (count > ARRAY_SIZE(data)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* The backend interface is shared between reads and writes */
+    memcpy(data, vals, count);
+
+    MUTEX_LOCK(&dev->lock);
+
+    CHECK_BOARD_STATE_LOCKED(STATE_FPGA_LOADED);
+
+    status = dev->backend->lms_block(dev, true, address, data, count);
+
+    state_cache_flush(&dev->state_cache);
+
     MUTEX_UNLOCK(&dev->lock);
 
     return status;
@@ -4132,6 +5444,8 @@ int bladerf_xb_spi_write(struct bladerf *dev, uint32_t val)
 
     status = dev->backend->xb_spi(dev, val);
 
+    state_cache_flush(&dev->state_cache);
+
     MUTEX_UNLOCK(&dev->lock);
 
     return status;
@@ -42,16 +42,47 @@
  *        [uint32_t: Frequency]
  *        [int16_t:  DC I correction value]
  *        [int16_t:  DC Q correction value]
+ *
+ * Tables of version 2 and later follow these with the int16_t max, mid, and
+ * min DC I and Q values used for AGC.
+ *
+ * Packed tables are stored directly in a file, rather than in a
+ * bladerf_image, so that they may be memory-mapped and used without being
+ * expanded. All values are little-endian byte order.
+ *
+ * 0x0000 [uint16_t: Fixed value of 0x1ab2]
+ * 0x0002 [uint16_t: Packed format version (1)]
+ * 0x0004 [uint32_t: Table format version of the entries, as above]
+ * 0x0008 [uint32_t: Number of entries]
+ * 0x000c [uint32_t: Number of blocks]
+ * 0x0010 [uint16_t: Entries per block]
+ * 0x0012 [uint8_t:  LMS register values, in the order above (10 bytes)]
+ * 0x001c [uint32_t: Reserved. Set to 0x00000000]
+ * 0x0020 [Block index]
+ *
+ * Where a block index entry is:
+ *        [uint32_t: Frequency of the block's first entry]
+ *        [uint32_t: Offset of the block from the start of the file]
+ *
+ * Entries are sorted by increasing frequency and divided into blocks of the
+ * specified length, with the last block holding any remainder. A block's
+ * first entry is stored in full as a version 2 entry. Each subsequent entry
+ * is stored as the difference from the previous one: an unsigned LEB128
+ * frequency increment, followed by the zigzag-encoded LEB128 change in each
+ * of the eight correction values. A lookup searches the block index and
+ * decodes at most one block.
  */
 
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
-#include <float.h>
+#include <limits.h>
 
 #include "host_config.h"
 #include "minmax.h"
 
+#include "helpers/file.h"
+
 #include "calibration.h"
 
 #ifdef TEST_DC_CAL_TABLE
@@ -70,6 +101,21 @@
 #define DC_CAL_TBL_ENTRY_SIZE   (sizeof(uint32_t) + 2 * sizeof(int16_t))
 #define DC_CAL_TBL_MIN_SIZE     (DC_CAL_TBL_META_SIZE + DC_CAL_TBL_ENTRY_SIZE)
 
+#define DC_CAL_PACKED_MAGIC     0x1ab2
+#define DC_CAL_PACKED_VERSION   1
+
+#define DC_CAL_PACKED_HDR_SIZE  0x20
+#define DC_CAL_PACKED_IDX_SIZE  (2 * sizeof(uint32_t))
+#define DC_CAL_PACKED_BASE_SIZE (sizeof(uint32_t) + \
+                                 DC_CAL_NUM_VALUES * sizeof(int16_t))
+
+/* Correction values per entry, in the order stored */
+#define DC_CAL_NUM_VALUES       8
+
+/* Upper bound on the size of the dense index. A table spanning the full
+ * 300 MHz - 3.8 GHz range at 1 MHz spacing requires 6676 bins. */
+#define DC_CAL_TBL_MAX_BINS     16384
+
 static inline bool entry_matches(const struct dc_cal_tbl *tbl,
                                  unsigned int entry_idx, unsigned int freq)
 {
@@ -119,11 +165,216 @@ static unsigned int find_entry(const struct dc_cal_tbl *tbl,
     }
 }
 
+static unsigned int dense_lookup(const struct dc_cal_tbl *tbl,
+                                 unsigned int freq)
+{
+    const unsigned int f_first = tbl->entries[0].freq;
+    unsigned int bin, idx;
+
+    if (freq < f_first) {
+        return 0;
+    }
+
+    bin = (freq - f_first) >> tbl->bin_shift;
+    if (bin >= tbl->n_bins) {
+        return tbl->n_entries - 1;
+    }
+
+    idx = tbl->bins[bin];
+    while (idx < (tbl->n_entries - 1) && freq >= tbl->entries[idx + 1].freq) {
+        idx++;
+    }
+
+    return idx;
+}
+
+static inline uint32_t read_le32(const uint8_t *buf)
+{
+    uint32_t value;
+    memcpy(&value, buf, sizeof(value));
+    return LE32_TO_HOST(value);
+}
+
+static inline uint16_t read_le16(const uint8_t *buf)
+{
+    uint16_t value;
+    memcpy(&value, buf, sizeof(value));
+    return LE16_TO_HOST(value);
+}
+
+static void set_values(struct dc_cal_entry *entry,
+                       const int16_t values[DC_CAL_NUM_VALUES])
+{
+    entry->dc_i     = values[0];
+    entry->dc_q     = values[1];
+    entry->max_dc_i = values[2];
+    entry->max_dc_q = values[3];
+    entry->mid_dc_i = values[4];
+    entry->mid_dc_q = values[5];
+    entry->min_dc_i = values[6];
+    entry->min_dc_q = values[7];
+}
+
+static void get_values(const struct dc_cal_entry *entry,
+                       int16_t values[DC_CAL_NUM_VALUES])
+{
+    values[0] = entry->dc_i;
+    values[1] = entry->dc_q;
+    values[2] = entry->max_dc_i;
+    values[3] = entry->max_dc_q;
+    values[4] = entry->mid_dc_i;
+    values[5] = entry->mid_dc_q;
+    values[6] = entry->min_dc_i;
+    values[7] = entry->min_dc_q;
+}
+
+static bool read_varint(const uint8_t **p, const uint8_t *end, uint32_t *value)
+{
+    uint32_t v = 0;
+    unsigned int shift;
+
+    for (shift = 0; shift < 32 && *p < end; shift += 7) {
+        const uint8_t b = *(*p)++;
+
+        v |= (uint32_t)(b & 0x7f) << shift;
+        if ((b & 0x80) == 0) {
+            *value = v;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static inline uint32_t block_offset(const struct dc_cal_tbl *tbl, uint32_t b)
+{
+    return read_le32(tbl->packed + DC_CAL_PACKED_HDR_SIZE +
+                     b * DC_CAL_PACKED_IDX_SIZE + sizeof(uint32_t));
+}
+
+static inline uint32_t block_freq(const struct dc_cal_tbl *tbl, uint32_t b)
+{
+    return read_le32(tbl->packed + DC_CAL_PACKED_HDR_SIZE +
+                     b * DC_CAL_PACKED_IDX_SIZE);
+}
+
+/* Read a block's first entry. Its bounds were validated at load time. */
+static void read_block_base(const struct dc_cal_tbl *tbl, uint32_t b,
+                            struct dc_cal_entry *entry)
+{
+    const uint8_t *p = tbl->packed + block_offset(tbl, b);
+    int16_t values[DC_CAL_NUM_VALUES];
+    size_t i;
+
+    entry->freq = read_le32(p);
+    p += sizeof(uint32_t);
+
+    for (i = 0; i < DC_CAL_NUM_VALUES; i++) {
+        values[i] = (int16_t)read_le16(p);
+        p += sizeof(int16_t);
+    }
+
+    set_values(entry, values);
+}
+
+/* Decode the entry following `prev'. Returns false on malformed data. */
+static bool read_delta(const uint8_t **p, const uint8_t *end,
+                       const struct dc_cal_entry *prev,
+                       struct dc_cal_entry *entry)
+{
+    int16_t values[DC_CAL_NUM_VALUES];
+    uint32_t v;
+    size_t i;
+
+    if (!read_varint(p, end, &v) || v == 0 || v > UINT_MAX - prev->freq) {
+        return false;
+    }
+
+    entry->freq = prev->freq + v;
+    get_values(prev, values);
+
+    for (i = 0; i < DC_CAL_NUM_VALUES; i++) {
+        if (!read_varint(p, end, &v)) {
+            return false;
+        }
+
+        values[i] += (int16_t)((v >> 1) ^ (~(v & 1) + 1));
+    }
+
+    set_values(entry, values);
+    return true;
+}
+
+/* Find the entry in effect at `freq', and the entry following it, if any.
+ * Returns the index of the former. */
+static unsigned int packed_lookup(const struct dc_cal_tbl *tbl,
+                                  unsigned int freq,
+                                  struct dc_cal_entry *lo,
+                                  struct dc_cal_entry *hi,
+                                  bool *have_hi)
+{
+    uint32_t low = 0, high = tbl->n_blocks - 1, mid, b;
+    unsigned int i, count;
+    const uint8_t *p, *end;
+
+    /* Last block starting at or below freq, or the first block */
+    while (low < high) {
+        mid = low + (high - low + 1) / 2;
+
+        if (block_freq(tbl, mid) <= freq) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+
+    b     = low;
+    count = (unsigned int)u64_min(tbl->block_len,
+                                  tbl->n_entries -
+                                      (uint64_t)b * tbl->block_len);
+
+    p   = tbl->packed + block_offset(tbl, b) + DC_CAL_PACKED_BASE_SIZE;
+    end = (b + 1 < tbl->n_blocks) ? tbl->packed + block_offset(tbl, b + 1)
+                                  : tbl->packed + tbl->packed_len;
+
+    read_block_base(tbl, b, lo);
+
+    for (i = 1; i < count; i++) {
+        if (!read_delta(&p, end, lo, hi)) {
+            log_debug("Malformed DC cal table block %u\n", b);
+            break;
+        } else if (hi->freq > freq) {
+            *have_hi = true;
+            return b * tbl->block_len + i - 1;
+        }
+
+        *lo = *hi;
+    }
+
+    *have_hi = (b + 1 < tbl->n_blocks);
+    if (*have_hi) {
+        read_block_base(tbl, b + 1, hi);
+    }
+
+    return b * tbl->block_len + i - 1;
+}
+
 unsigned int dc_cal_tbl_lookup(const struct dc_cal_tbl *tbl, unsigned int freq)
 {
     unsigned int ret = 0;
     bool limit = false; /* Hit a limit before finding a match */
 
+    if (tbl->packed != NULL) {
+        struct dc_cal_entry lo, hi;
+        bool have_hi;
+
+        return packed_lookup(tbl, freq, &lo, &hi, &have_hi);
+    }
+
+    if (tbl->bins != NULL) {
+        return dense_lookup(tbl, freq);
+    }
+
     /* First check if we're at a nearby change. This is generally the case
      * when the frequecy change */
     if (tbl->n_entries > SHORT_SEARCH) {
@@ -142,6 +393,90 @@ unsigned int dc_cal_tbl_lookup(const struct dc_cal_tbl *tbl, unsigned int freq)
     return find_entry(tbl, tbl->curr_idx, 0, tbl->n_entries - 1, freq, &limit);
 }
 
+static void compute_slope(const struct dc_cal_entry *lo,
+                          const struct dc_cal_entry *hi,
+                          struct dc_cal_slope *slope)
+{
+    const float df = (float) (hi->freq - lo->freq);
+
+    if (df == 0) {
+        memset(slope, 0, sizeof(slope[0]));
+        return;
+    }
+
+#define SLOPE(x) slope->x = ((float) hi->x - lo->x) / df
+
+    SLOPE(dc_i);
+    SLOPE(dc_q);
+
+    SLOPE(max_dc_i);
+    SLOPE(max_dc_q);
+    SLOPE(mid_dc_i);
+    SLOPE(mid_dc_q);
+    SLOPE(min_dc_i);
+    SLOPE(min_dc_q);
+
+#undef SLOPE
+}
+
+/* Build the dense index and interpolation slopes. The table is left
+ * unindexed if its entries are not sorted. */
+static void build_dense_index(struct dc_cal_tbl *tbl)
+{
+    const unsigned int n = tbl->n_entries;
+    unsigned int min_gap = UINT_MAX;
+    unsigned int span, shift, bin, idx, i;
+
+    for (i = 1; i < n; i++) {
+        const unsigned int gap =
+            tbl->entries[i].freq - tbl->entries[i - 1].freq;
+
+        if (tbl->entries[i].freq < tbl->entries[i - 1].freq) {
+            log_debug("DC cal table is not sorted. Not indexing it.\n");
+            return;
+        } else if (gap != 0 && gap < min_gap) {
+            min_gap = gap;
+        }
+    }
+
+    span = tbl->entries[n - 1].freq - tbl->entries[0].freq;
+
+    /* Largest power of two Hz not exceeding the smallest entry spacing,
+     * widened if needed to keep within the bin limit */
+    for (shift = 0; shift < 31 && (2u << shift) <= min_gap; shift++);
+    while ((span >> shift) >= DC_CAL_TBL_MAX_BINS) {
+        shift++;
+    }
+
+    tbl->n_bins = (span >> shift) + 1;
+    tbl->bins   = malloc(tbl->n_bins * sizeof(tbl->bins[0]));
+    tbl->slopes = calloc(n, sizeof(tbl->slopes[0]));
+
+    if (tbl->bins == NULL || tbl->slopes == NULL) {
+        free(tbl->bins);
+        free(tbl->slopes);
+        tbl->bins   = NULL;
+        tbl->slopes = NULL;
+        return;
+    }
+
+    tbl->bin_shift = shift;
+
+    for (bin = 0, idx = 0; bin < tbl->n_bins; bin++) {
+        const unsigned int f = tbl->entries[0].freq + (bin << shift);
+
+        while (idx < (n - 1) && f >= tbl->entries[idx + 1].freq) {
+            idx++;
+        }
+
+        tbl->bins[bin] = idx;
+    }
+
+    for (i = 0; i + 1 < n; i++) {
+        compute_slope(&tbl->entries[i], &tbl->entries[i + 1], &tbl->slopes[i]);
+    }
+}
+
 struct dc_cal_tbl * dc_cal_tbl_load(const uint8_t *buf, size_t buf_len)
 {
     struct dc_cal_tbl *ret;
@@ -159,7 +494,7 @@ struct dc_cal_tbl * dc_cal_tbl_load(const uint8_t *buf, size_t buf_len)
     }
     buf += sizeof(magic);
 
-    ret = malloc(sizeof(ret[0]));
+    ret = calloc(1, sizeof(ret[0]));
     if (ret == NULL) {
         return NULL;
     }
@@ -181,7 +516,7 @@ struct dc_cal_tbl * dc_cal_tbl_load(const uint8_t *buf, size_t buf_len)
         return NULL;
     }
 
-    ret->entries = malloc(sizeof(ret->entries[0]) * ret->n_entries);
+    ret->entries = calloc(ret->n_entries, sizeof(ret->entries[0]));
     if (ret->entries == NULL) {
         free(ret);
         return NULL;
@@ -241,6 +576,81 @@ struct dc_cal_tbl * dc_cal_tbl_load(const uint8_t *buf, size_t buf_len)
         }
     }
 
+    build_dense_index(ret);
+
+    return ret;
+}
+
+struct dc_cal_tbl *dc_cal_tbl_packed_load(const uint8_t *buf, size_t buf_len)
+{
+    struct dc_cal_tbl *ret;
+    uint32_t b, off, prev_off = 0, freq, prev_freq = 0;
+    const uint8_t *p;
+
+    if (buf_len < DC_CAL_PACKED_HDR_SIZE ||
+        read_le16(buf) != DC_CAL_PACKED_MAGIC) {
+        return NULL;
+    }
+
+    if (read_le16(buf + 0x02) != DC_CAL_PACKED_VERSION) {
+        log_debug("Unsupported packed DC cal table version: %u\n",
+                  read_le16(buf + 0x02));
+        return NULL;
+    }
+
+    ret = calloc(1, sizeof(ret[0]));
+    if (ret == NULL) {
+        return NULL;
+    }
+
+    ret->version   = read_le32(buf + 0x04);
+    ret->n_entries = read_le32(buf + 0x08);
+    ret->n_blocks  = read_le32(buf + 0x0c);
+    ret->block_len = read_le16(buf + 0x10);
+
+    if (ret->n_entries == 0 || ret->block_len == 0 ||
+        ret->n_blocks != (ret->n_entries - 1) / ret->block_len + 1 ||
+        (buf_len - DC_CAL_PACKED_HDR_SIZE) / DC_CAL_PACKED_IDX_SIZE <
+            ret->n_blocks) {
+        log_debug("Invalid packed DC cal table dimensions\n");
+        free(ret);
+        return NULL;
+    }
+
+    p = buf + 0x12;
+    ret->reg_vals.lpf_tuning = *p++;
+    ret->reg_vals.tx_lpf_i = *p++;
+    ret->reg_vals.tx_lpf_q = *p++;
+    ret->reg_vals.rx_lpf_i = *p++;
+    ret->reg_vals.rx_lpf_q = *p++;
+    ret->reg_vals.dc_ref = *p++;
+    ret->reg_vals.rxvga2a_i = *p++;
+    ret->reg_vals.rxvga2a_q = *p++;
+    ret->reg_vals.rxvga2b_i = *p++;
+    ret->reg_vals.rxvga2b_q = *p++;
+
+    ret->packed     = buf;
+    ret->packed_len = buf_len;
+
+    /* Blocks must follow the index, in order, and be sorted by frequency */
+    prev_off = DC_CAL_PACKED_HDR_SIZE + ret->n_blocks * DC_CAL_PACKED_IDX_SIZE;
+
+    for (b = 0; b < ret->n_blocks; b++) {
+        off  = block_offset(ret, b);
+        freq = block_freq(ret, b);
+
+        if (off < prev_off || off > buf_len ||
+            buf_len - off < DC_CAL_PACKED_BASE_SIZE ||
+            read_le32(buf + off) != freq || (b > 0 && freq <= prev_freq)) {
+            log_debug("Invalid packed DC cal table block %u\n", b);
+            free(ret);
+            return NULL;
+        }
+
+        prev_off  = off + DC_CAL_PACKED_BASE_SIZE;
+        prev_freq = freq;
+    }
+
     return ret;
 }
 
@@ -249,6 +659,28 @@ int dc_cal_tbl_image_load(struct bladerf *dev,
 {
     int status;
     struct bladerf_image *img;
+    const uint8_t *buf;
+    size_t buf_len;
+
+    /* Packed tables are identified by their magic value, as bladerf_image
+     * files begin with a different one */
+    status = file_map(img_file, &buf, &buf_len);
+    if (status != 0) {
+        return status;
+    }
+
+    if (buf_len >= sizeof(uint16_t) &&
+        read_le16(buf) == DC_CAL_PACKED_MAGIC) {
+        *tbl = dc_cal_tbl_packed_load(buf, buf_len);
+        if (*tbl == NULL) {
+            file_unmap(buf, buf_len);
+            return BLADERF_ERR_INVAL;
+        }
+
+        return 0;
+    }
+
+    file_unmap(buf, buf_len);
 
     img = bladerf_alloc_image(dev, BLADERF_IMAGE_TYPE_INVALID, 0, 0);
     if (img == NULL) {
@@ -257,6 +689,7 @@ int dc_cal_tbl_image_load(struct bladerf *dev,
 
     status = bladerf_image_read(img, img_file);
     if (status != 0) {
+        bladerf_free_image(img);
         return status;
     }
 
@@ -273,37 +706,16 @@ int dc_cal_tbl_image_load(struct bladerf *dev,
     return status;
 }
 
-/* Interpolate a y value given two points and a desired x value
- *
- * y = interp( (x0, y0), (x1, y1), x )
- *
- * Returns
- */
-static inline unsigned int interp(unsigned int x0, unsigned int y0,
-                           unsigned int x1, unsigned int y1,
-                           unsigned int x)
+static inline void dc_cal_interp(const struct dc_cal_entry *lo,
+                                 const struct dc_cal_slope *slope,
+                                 unsigned int freq,
+                                 struct dc_cal_entry *entry)
 {
-    const float num = (float) y1 - y0;
-    const float den = (float) x1 - x0;
-    const float m = den == 0 ? FLT_MAX : num / den;
-    const float y = (x - x0) * m + y0;
+    const float df = (float) (freq - lo->freq);
 
-    return (unsigned int) y;
-}
+    entry->freq = freq;
 
-static inline void dc_cal_interp_entry(const struct dc_cal_tbl *tbl,
-                                       unsigned int idx_low,
-                                       unsigned int idx_high,
-                                       unsigned int freq,
-                                       struct dc_cal_entry *entry)
-{
-    const unsigned int f_low = tbl->entries[idx_low].freq;
-    const unsigned int f_high = tbl->entries[idx_high].freq;
-
-#define ENTRY_VAR(x)                                                        \
-    entry->x    = (int16_t) interp(f_low, tbl->entries[idx_low].x,          \
-                             f_high, tbl->entries[idx_low].x,               \
-                             freq)
+#define ENTRY_VAR(x) entry->x = (int16_t) (lo->x + df * slope->x)
 
     ENTRY_VAR(dc_i);
     ENTRY_VAR(dc_q);
@@ -314,19 +726,63 @@ static inline void dc_cal_interp_entry(const struct dc_cal_tbl *tbl,
     ENTRY_VAR(mid_dc_q);
     ENTRY_VAR(min_dc_i);
     ENTRY_VAR(min_dc_q);
+
+#undef ENTRY_VAR
+}
+
+static inline void dc_cal_interp_entry(const struct dc_cal_tbl *tbl,
+                                       unsigned int idx,
+                                       unsigned int freq,
+                                       struct dc_cal_entry *entry)
+{
+    const struct dc_cal_entry *lo = &tbl->entries[idx];
+    struct dc_cal_slope slope;
+
+    if (tbl->slopes != NULL) {
+        slope = tbl->slopes[idx];
+    } else {
+        compute_slope(lo, &tbl->entries[idx + 1], &slope);
+    }
+
+    dc_cal_interp(lo, &slope, freq, entry);
+}
+
+static void dc_cal_packed_entry(const struct dc_cal_tbl *tbl,
+                                unsigned int freq,
+                                struct dc_cal_entry *entry)
+{
+    struct dc_cal_entry lo, hi;
+    struct dc_cal_slope slope;
+    bool have_hi;
+
+    packed_lookup(tbl, freq, &lo, &hi, &have_hi);
+
+    if (lo.freq == freq || freq < lo.freq || !have_hi) {
+        *entry = lo;
+    } else {
+        compute_slope(&lo, &hi, &slope);
+        dc_cal_interp(&lo, &slope, freq, entry);
+    }
 }
 
 void dc_cal_tbl_entry(const struct dc_cal_tbl *tbl, unsigned int freq,
                       struct dc_cal_entry *entry)
 {
-    const unsigned int idx = dc_cal_tbl_lookup(tbl, freq);
+    unsigned int idx;
 
-    if (tbl->entries[idx].freq == freq) {
+    if (tbl->packed != NULL) {
+        dc_cal_packed_entry(tbl, freq, entry);
+        return;
+    }
+
+    idx = dc_cal_tbl_lookup(tbl, freq);
+
+    /* Entries outside of the table's range are not extrapolated */
+    if (tbl->entries[idx].freq == freq || freq < tbl->entries[idx].freq ||
+        idx == (tbl->n_entries - 1)) {
         memcpy(entry, &tbl->entries[idx], sizeof(struct dc_cal_entry));
-    } else if (idx == (tbl->n_entries - 1)) {
-        dc_cal_interp_entry(tbl, idx - 1, idx, freq, entry);
     } else {
-        dc_cal_interp_entry(tbl, idx, idx + 1, freq, entry);
+        dc_cal_interp_entry(tbl, idx, freq, entry);
     }
 }
 
@@ -334,6 +790,13 @@ void dc_cal_tbl_free(struct dc_cal_tbl **tbl)
 {
     if (*tbl != NULL) {
         free((*tbl)->entries);
+        free((*tbl)->bins);
+        free((*tbl)->slopes);
+
+        if ((*tbl)->packed != NULL) {
+            file_unmap((*tbl)->packed, (*tbl)->packed_len);
+        }
+
         free(*tbl);
         *tbl = NULL;
     }
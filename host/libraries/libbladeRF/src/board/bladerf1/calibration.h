@@ -39,6 +39,19 @@ struct dc_cal_entry {
     int16_t min_dc_q;
 };
 
+/* Change in each dc_cal_entry value per Hz, from one entry to the next */
+struct dc_cal_slope {
+    float dc_i;
+    float dc_q;
+
+    float max_dc_i;
+    float max_dc_q;
+    float mid_dc_i;
+    float mid_dc_q;
+    float min_dc_i;
+    float min_dc_q;
+};
+
 struct dc_cal_tbl {
     uint32_t version;
     uint32_t n_entries;
@@ -46,6 +59,30 @@ struct dc_cal_tbl {
 
     unsigned int curr_idx;
     struct dc_cal_entry *entries; /* Sorted (increasing) by freq */
+
+    /* Dense index built by dc_cal_tbl_load(), dividing the table's frequency
+     * range into uniform bins of 2^bin_shift Hz. bins[n] is the index of the
+     * entry in effect at the start of bin n. The bin width does not exceed
+     * the smallest spacing between entries, where the bin count limit
+     * allows, so a lookup advances by at most one entry from bins[n].
+     *
+     * slopes[n] holds the interpolation slopes from entries[n] to
+     * entries[n + 1].
+     *
+     * These are NULL if the table could not be indexed, in which case
+     * lookups fall back to a binary search. */
+    unsigned int bin_shift;
+    unsigned int n_bins;
+    unsigned int *bins;
+    struct dc_cal_slope *slopes;
+
+    /* Packed table data (see calibration.c), used in place rather than
+     * being expanded into entries[], which is then NULL. This is NULL for
+     * tables loaded from a bladerf_image. */
+    const uint8_t *packed;
+    size_t packed_len;
+    uint32_t n_blocks;
+    unsigned int block_len;
 };
 
 extern struct dc_cal_tbl rx_cal_test;
@@ -63,7 +100,8 @@ unsigned int dc_cal_tbl_lookup(const struct dc_cal_tbl *tbl, unsigned int freq);
 /**
  * Get the DC cal values associated with the specified frequencies. If the
  * specified frequency is not in the table, the DC calibration values will
- * be interpolated from surrounding entries.
+ * be interpolated from surrounding entries. Frequencies outside of the table's
+ * range use the values of the first or last entry.
  *
  * @param[in]   tbl      Table to search
  * @param[in]   freq     Desired frequency
@@ -84,11 +122,28 @@ void dc_cal_tbl_entry(const struct dc_cal_tbl *tbl,
 struct dc_cal_tbl *dc_cal_tbl_load(const uint8_t *buf, size_t buf_len);
 
 /**
- * Load a DC calibration table from an image file
+ * Use a packed DC calibration table in place
+ *
+ * Only the header and block index are validated here. Entries are decoded as
+ * they are looked up.
+ *
+ * @param[in]   buf   Packed table data obtained with file_map(). On
+ *                    success, the table takes ownership of it.
+ * @param[in]   len   Length of packed data, in bytes
+ *
+ * @return DC calibration table referring to the data, or NULL on error
+ */
+struct dc_cal_tbl *dc_cal_tbl_packed_load(const uint8_t *buf, size_t buf_len);
+
+/**
+ * Load a DC calibration table from a file, which may contain either a packed
+ * table or a bladerf_image
+ *
+ * Packed tables are memory-mapped and used in place.
  *
  * @param[in]   dev         bladeRF device handle
  * @param[out]  tbl         DC calibration Table
- * @param[in]   img_file    Path to image file
+ * @param[in]   img_file    Path to table or image file
  *
  * @return 0 on success, BLADERF_ERR_* value on failure
  */
@@ -54,6 +54,16 @@ uint64_t bladerf1_get_fw_capabilities(const struct bladerf_version *fw_version)
         capabilities |= BLADERF_CAP_FW_SHORT_PACKET;
     }
 
+    if (version_fields_greater_or_equal(fw_version, 2, 5, 0)) {
+        capabilities |= BLADERF_CAP_FW_FLASH_BULK;
+        capabilities |= BLADERF_CAP_FW_FLASH_HASH;
+        capabilities |= BLADERF_CAP_FW_FPGA_COMPRESSED;
+        capabilities |= BLADERF_CAP_FW_FPGA_CONF_WAIT;
+        capabilities |= BLADERF_CAP_FW_FPGA_HASH;
+        capabilities |= BLADERF_CAP_FW_SAMPLE_DMA;
+        capabilities |= BLADERF_CAP_FW_STATS;
+    }
+
     return capabilities;
 }
 
@@ -110,5 +120,18 @@ uint64_t bladerf1_get_fpga_capabilities(const struct bladerf_version *fpga_versi
         capabilities |= BLADERF_CAP_FPGA_PACKET_META;
     }
 
+    if (version_fields_greater_or_equal(fpga_version, 0, 13, 0)) {
+        capabilities |= BLADERF_CAP_FPGA_8x8_BATCH;
+        capabilities |= BLADERF_CAP_FPGA_8x8_BLOCK;
+        capabilities |= BLADERF_CAP_FPGA_RETUNE_STATS;
+        capabilities |= BLADERF_CAP_FPGA_RETUNE_EDIT;
+        capabilities |= BLADERF_CAP_FPGA_RETUNE_CORR;
+        capabilities |= BLADERF_CAP_FPGA_VCOCAP_SEARCH;
+        capabilities |= BLADERF_CAP_FPGA_LMS_DC_CAL;
+        capabilities |= BLADERF_CAP_FPGA_TS_LATCH;
+        capabilities |= BLADERF_CAP_FPGA_RETUNE_GAIN;
+        capabilities |= BLADERF_CAP_FPGA_TAMER_SEED;
+    }
+
     return capabilities;
 }
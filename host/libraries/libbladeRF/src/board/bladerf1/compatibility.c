@@ -35,6 +35,7 @@ const struct version_compat_table bladerf1_fw_compat_table = {fw_compat, ARRAY_S
 
 static const struct compat fpga_compat[] = {
     /*    FPGA          requires >=        Firmware */
+    { VERSION(0, 13, 0),                VERSION(2, 2, 0) },
     { VERSION(0, 12, 0),                VERSION(2, 2, 0) },
     { VERSION(0, 11, 1),                VERSION(2, 1, 0) },
     { VERSION(0, 11, 0),                VERSION(1, 6, 1) },
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "log.h"
@@ -15,6 +16,45 @@
 
 #define OTP_BUFFER_SIZE 256
 
+/* Differentially update a region of flash with the provided data, which is
+ * padded with 0xff to the end of the region, as a full erase would leave it */
+static int update_region(struct bladerf *dev, const uint8_t *data,
+                         size_t len, uint32_t eb, uint32_t eb_count)
+{
+    const size_t region_len = (size_t)eb_count * dev->flash_arch->ebsize_bytes;
+    uint8_t *region;
+    int status;
+
+    if (len > region_len) {
+        log_debug("Image does not fit within its flash region\n");
+        return BLADERF_ERR_INVAL;
+    }
+
+    region = malloc(region_len);
+    if (region == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    memcpy(region, data, len);
+    memset(region + len, 0xff, region_len - len);
+
+    memset(&dev->flash_write_stats, 0, sizeof(dev->flash_write_stats));
+    status = spi_flash_update(dev, region, eb, eb_count,
+                              &dev->flash_write_stats);
+
+    free(region);
+    return status;
+}
+
+static void set_write_stats(struct bladerf *dev, uint32_t eb_count,
+                            uint32_t eb_updated, uint32_t pages)
+{
+    dev->flash_write_stats.blocks_total   = eb_count;
+    dev->flash_write_stats.blocks_updated = eb_updated;
+    dev->flash_write_stats.bytes_written  =
+        (uint64_t)pages * dev->flash_arch->psize_bytes;
+}
+
 int spi_flash_write_fx3_fw(struct bladerf *dev, const uint8_t *image, size_t len)
 {
     int status;
@@ -62,6 +102,21 @@ int spi_flash_write_fx3_fw(struct bladerf *dev, const uint8_t *image, size_t len
     /* Clear the padded region */
     memset(padded_image + len, 0xFF, padded_image_len - len);
 
+    if (dev->flash_write_mode == BLADERF_FLASH_WRITE_DIFFERENTIAL) {
+        status = update_region(dev, padded_image, padded_image_len,
+                               flash_eb_fw, flash_eb_len_fw);
+        goto error;
+    }
+
+    /* Leave the flash untouched if it already holds this image */
+    if (spi_flash_compare(dev, padded_image, flash_page_fw,
+                          padded_image_len / page_size) == 0) {
+        log_info("Firmware image is already in flash\n");
+        set_write_stats(dev, flash_eb_len_fw, 0, 0);
+        status = 0;
+        goto error;
+    }
+
     /* Erase the entire firmware region */
     status = spi_flash_erase(dev, flash_eb_fw, flash_eb_len_fw);
     if (status != 0) {
@@ -90,6 +145,8 @@ int spi_flash_write_fx3_fw(struct bladerf *dev, const uint8_t *image, size_t len
         goto error;
     }
 
+    set_write_stats(dev, flash_eb_len_fw, flash_eb_len_fw, padded_image_len);
+
 error:
     free(padded_image);
     free(readback_buf);
@@ -136,6 +193,31 @@ static inline size_t get_flash_eb_len_fpga(struct bladerf *dev)
 
 #define METADATA_LEN 256
 
+/* Differentially update the FPGA region with the metadata page, followed by
+ * the padded bitstream */
+static int update_fpga_region(struct bladerf *dev, const uint8_t *metadata,
+                              const uint8_t *bitstream, uint32_t len,
+                              uint32_t eb, uint32_t eb_count)
+{
+    const uint32_t page_size = dev->flash_arch->psize_bytes;
+    uint8_t *image;
+    int status;
+
+    image = malloc((size_t)page_size + len);
+    if (image == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    memcpy(image, metadata, METADATA_LEN);
+    memset(image + METADATA_LEN, 0xff, page_size - METADATA_LEN);
+    memcpy(image + page_size, bitstream, len);
+
+    status = update_region(dev, image, (size_t)page_size + len, eb, eb_count);
+
+    free(image);
+    return status;
+}
+
 int spi_flash_write_fpga_bitstream(struct bladerf *dev,
                                    const uint8_t *bitstream,
                                    size_t len)
@@ -190,6 +272,23 @@ int spi_flash_write_fpga_bitstream(struct bladerf *dev,
     /* Clear the padded region */
     memset(padded_bitstream + len, 0xFF, padded_bitstream_len - len);
 
+    if (dev->flash_write_mode == BLADERF_FLASH_WRITE_DIFFERENTIAL) {
+        status = update_fpga_region(dev, metadata, padded_bitstream,
+                                    padded_bitstream_len, flash_eb_fpga,
+                                    flash_eb_len_fpga);
+        goto error;
+    }
+
+    /* Leave the flash untouched if it already holds this bitstream */
+    if (spi_flash_compare(dev, metadata, flash_page_fpga, 1) == 0 &&
+        spi_flash_compare(dev, padded_bitstream, flash_page_fpga + 1,
+                          padded_bitstream_len / page_size) == 0) {
+        log_info("FPGA bitstream is already in flash\n");
+        set_write_stats(dev, flash_eb_len_fpga, 0, 0);
+        status = 0;
+        goto error;
+    }
+
     /* Erase FPGA metadata and bitstream region */
     status = spi_flash_erase(dev, flash_eb_fpga, flash_eb_len_fpga);
     if (status != 0) {
@@ -233,6 +332,9 @@ int spi_flash_write_fpga_bitstream(struct bladerf *dev,
         goto error;
     }
 
+    set_write_stats(dev, flash_eb_len_fpga, flash_eb_len_fpga,
+                    padded_bitstream_len + 1);
+
 error:
     free(padded_bitstream);
     free(readback_buf);
@@ -282,18 +384,98 @@ int spi_flash_read_cal(struct bladerf *dev, char *field,
     int status;
     char cal[CAL_BUFFER_SIZE];
 
-    status = dev->backend->get_cal(dev, cal);
+    if (dev->flash_arch->cal != NULL) {
+        memcpy(cal, dev->flash_arch->cal, CAL_BUFFER_SIZE);
+        status = 0;
+    } else {
+        status = dev->backend->get_cal(dev, cal);
+    }
+
     if (status < 0)
         return status;
     else
         return binkv_decode_field(cal, CAL_BUFFER_SIZE, field, data, data_size);
 }
 
+/* Decode all of the calibration fields in one pass over the region */
+static void decode_cal_fields(struct bladerf *dev)
+{
+    struct bladerf_flash_fields *f = &dev->flash_arch->fields;
+    char cal[CAL_BUFFER_SIZE];
+    struct binkv_field fields[] = {
+        { "DAC", f->dac, sizeof(f->dac) - 1, 0 },
+        { "B", f->size, sizeof(f->size) - 1, 0 },
+    };
+    int status;
+
+    if (f->cal_decoded) {
+        return;
+    }
+
+    if (dev->flash_arch->cal != NULL) {
+        memcpy(cal, dev->flash_arch->cal, CAL_BUFFER_SIZE);
+        status = 0;
+    } else {
+        status = dev->backend->get_cal(dev, cal);
+    }
+
+    if (status < 0) {
+        fields[0].status = status;
+        fields[1].status = status;
+    } else {
+        binkv_decode_fields(cal, CAL_BUFFER_SIZE, fields, ARRAY_SIZE(fields));
+    }
+
+    f->dac_status  = fields[0].status;
+    f->size_status = fields[1].status;
+    f->cal_decoded = true;
+}
+
+/* Decode all of the OTP fields in one pass over the region */
+static void decode_otp_fields(struct bladerf *dev)
+{
+    struct bladerf_flash_fields *f = &dev->flash_arch->fields;
+    char otp[OTP_BUFFER_SIZE];
+    struct binkv_field fields[] = {
+        { "S", f->serial, BLADERF_SERIAL_LENGTH - 1, 0 },
+    };
+    int status;
+
+    if (f->otp_decoded) {
+        return;
+    }
+
+    memset(otp, 0xff, OTP_BUFFER_SIZE);
+
+    status = dev->backend->get_otp(dev, otp);
+    if (status < 0) {
+        fields[0].status = status;
+    } else {
+        binkv_decode_fields(otp, OTP_BUFFER_SIZE, fields, ARRAY_SIZE(fields));
+    }
+
+    f->serial_status = fields[0].status;
+    f->otp_decoded   = true;
+}
+
+void spi_flash_invalidate_otp(struct bladerf *dev)
+{
+    if (dev->flash_arch != NULL) {
+        dev->flash_arch->fields.otp_decoded = false;
+    }
+}
+
 int spi_flash_read_serial(struct bladerf *dev, char *serial_buf)
 {
+    struct bladerf_flash_fields *f = &dev->flash_arch->fields;
     int status;
 
-    status = spi_flash_read_otp(dev, "S", serial_buf, BLADERF_SERIAL_LENGTH - 1);
+    decode_otp_fields(dev);
+
+    status = f->serial_status;
+    if (status == 0) {
+        memcpy(serial_buf, f->serial, BLADERF_SERIAL_LENGTH - 1);
+    }
 
     if (status < 0) {
         log_info("Unable to fetch serial number. Defaulting to 0's.\n");
@@ -310,17 +492,17 @@ int spi_flash_read_serial(struct bladerf *dev, char *serial_buf)
 
 int spi_flash_read_vctcxo_trim(struct bladerf *dev, uint16_t *dac_trim)
 {
-    int status;
+    struct bladerf_flash_fields *f = &dev->flash_arch->fields;
     bool ok;
     int16_t trim;
-    char tmp[7] = { 0 };
 
-    status = spi_flash_read_cal(dev, "DAC", tmp, sizeof(tmp) - 1);
-    if (status < 0) {
-        return status;
+    decode_cal_fields(dev);
+
+    if (f->dac_status < 0) {
+        return f->dac_status;
     }
 
-    trim = str2uint(tmp, 0, 0xffff, &ok);
+    trim = str2uint(f->dac, 0, 0xffff, &ok);
     if (ok == false) {
         return BLADERF_ERR_INVAL;
     }
@@ -332,12 +514,13 @@ int spi_flash_read_vctcxo_trim(struct bladerf *dev, uint16_t *dac_trim)
 
 int spi_flash_read_fpga_size(struct bladerf *dev, bladerf_fpga_size *fpga_size)
 {
-    int status;
-    char tmp[7] = { 0 };
+    struct bladerf_flash_fields *f = &dev->flash_arch->fields;
+    const char *tmp = f->size;
 
-    status = spi_flash_read_cal(dev, "B", tmp, sizeof(tmp) - 1);
-    if (status < 0) {
-        return status;
+    decode_cal_fields(dev);
+
+    if (f->size_status < 0) {
+        return f->size_status;
     }
 
     if (!strcmp("40", tmp)) {
@@ -352,7 +535,7 @@ int spi_flash_read_fpga_size(struct bladerf *dev, bladerf_fpga_size *fpga_size)
         *fpga_size = BLADERF_FPGA_UNKNOWN;
     }
 
-    return status;
+    return 0;
 }
 
 int spi_flash_read_flash_id(struct bladerf *dev, uint8_t *mid, uint8_t *did)
@@ -489,6 +672,56 @@ int binkv_decode_field(char *ptr, int len, char *field,
     return BLADERF_ERR_INVAL;
 }
 
+void binkv_decode_fields(char *ptr, int len,
+                         struct binkv_field *fields, size_t count)
+{
+    int c;
+    unsigned char *ub, *end;
+    unsigned short a1, a2;
+    size_t i, flen, wlen, remaining;
+
+    for (i = 0; i < count; i++) {
+        fields[i].status = BLADERF_ERR_INVAL;
+    }
+
+    remaining = count;
+
+    ub = (unsigned char *)ptr;
+    end = ub + len;
+    while (ub < end && remaining > 0) {
+        c = *ub;
+
+        if (c == 0xff) // flash and OTP are 0xff if they've never been written to
+            break;
+
+        a1 = LE16_TO_HOST(*(unsigned short *)(&ub[c+1]));  // read checksum
+        a2 = zcrc(ub, c+1);  // calculate checksum
+
+        if (a1 != a2) {
+            log_debug( "%s: Field checksum mismatch\n", __FUNCTION__);
+            return;
+        }
+
+        /* As with binkv_decode_field(), the first matching record wins */
+        for (i = 0; i < count; i++) {
+            if (fields[i].status == 0) {
+                continue;
+            }
+
+            flen = strlen(fields[i].name);
+            if (!strncmp((char *)ub + 1, fields[i].name, flen)) {
+                wlen = min_sz(c - flen, fields[i].maxlen);
+                strncpy(fields[i].val, (char *)ub + 1 + flen, wlen);
+                fields[i].val[wlen] = 0;
+                fields[i].status = 0;
+                remaining--;
+            }
+        }
+
+        ub += c + 3; //skip past `c' bytes, 2 byte CRC field, and 1 byte len field
+    }
+}
+
 int binkv_encode_field(char *ptr, int len, int *idx,
                        const char *field, const char *val)
 {
@@ -105,6 +105,14 @@ int spi_flash_read_vctcxo_trim(struct bladerf *dev, uint16_t *dac_trim);
  */
 int spi_flash_read_fpga_size(struct bladerf *dev, bladerf_fpga_size *fpga_size);
 
+/**
+ * Discard the decoded OTP fields. This must be called after writing or
+ * locking the OTP region.
+ *
+ * @param       dev         Device handle
+ */
+void spi_flash_invalidate_otp(struct bladerf *dev);
+
 /**
  * Retrieve SPI flash manufacturer ID and device ID.
  *
@@ -157,6 +165,29 @@ int binkv_encode_field(
 int binkv_decode_field(
     char *ptr, int len, char *field, char *val, size_t maxlen);
 
+/**
+ * A field to be decoded by binkv_decode_fields()
+ */
+struct binkv_field {
+    const char *name; /**< Key of value to be decoded */
+    char *val;        /**< Value retrieved from encoded data buffer */
+    size_t maxlen;    /**< Maximum length of value to be retrieved */
+    int status;       /**< 0 if the field was found, BLADERF_ERR_* otherwise */
+};
+
+/**
+ * Decode several binary key-value pairs in a single pass over the encoded
+ * data. Each field is decoded as binkv_decode_field() would decode it.
+ *
+ * @param[in]       ptr     Pointer to data buffer containing encoded data
+ * @param[in]       len     Length of data buffer containing encoded data
+ * @param[inout]    fields  Fields to be decoded. The `val` and `status`
+ *                          members are updated.
+ * @param[in]       count   Number of fields
+ */
+void binkv_decode_fields(char *ptr, int len,
+                         struct binkv_field *fields, size_t count);
+
 /**
  * Add a binary key-value pair to an existing binkv data buffer.
  *
@@ -21,6 +21,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include <limits.h>
@@ -38,6 +39,7 @@
 #include "board/board.h"
 #include "driver/spi_flash.h"
 #include "helpers/file.h"
+#include "thread.h"
 
 #include "flash.h"
 
@@ -96,32 +98,30 @@ static void sha256_buffer(const char *buf, size_t len,
     SHA256_Final((uint8_t*)digest, &ctx);
 }
 
-static int verify_checksum(uint8_t *buf, size_t buf_len)
+static int verify_checksum(const uint8_t *buf, size_t buf_len)
 {
-    char checksum_expected[SHA256_DIGEST_SIZE];
-    char checksum_calc[SHA256_DIGEST_SIZE];
+    static const uint8_t zeros[SHA256_DIGEST_SIZE] = { 0 };
+    uint8_t checksum_calc[SHA256_DIGEST_SIZE];
+    SHA256_CTX ctx;
 
     if (buf_len <= CALC_IMAGE_SIZE(0)) {
         log_debug("Provided buffer isn't a full image\n");
         return BLADERF_ERR_INVAL;
     }
 
-    /* Backup and clear the expected checksum before we calculate the
-     * expected checksum */
-    memcpy(checksum_expected, &buf[BLADERF_IMAGE_MAGIC_LEN],
-           sizeof(checksum_expected));
-
-    memset(&buf[BLADERF_IMAGE_MAGIC_LEN], 0, SHA256_DIGEST_SIZE);
-
-    sha256_buffer((const char *)buf, buf_len, checksum_calc);
-
-    if (memcmp(checksum_expected, checksum_calc, SHA256_DIGEST_SIZE) != 0) {
+    /* The checksum is calculated with the checksum field cleared, so hash
+     * zeros in its place rather than modifying the buffer */
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, buf, BLADERF_IMAGE_MAGIC_LEN);
+    SHA256_Update(&ctx, zeros, sizeof(zeros));
+    SHA256_Update(&ctx, &buf[BLADERF_IMAGE_MAGIC_LEN + SHA256_DIGEST_SIZE],
+                  buf_len - BLADERF_IMAGE_MAGIC_LEN - SHA256_DIGEST_SIZE);
+    SHA256_Final(checksum_calc, &ctx);
+
+    if (memcmp(&buf[BLADERF_IMAGE_MAGIC_LEN], checksum_calc,
+               SHA256_DIGEST_SIZE) != 0) {
         return BLADERF_ERR_CHECKSUM;
     } else {
-        /* Restore the buffer's checksum so the caller can still use it */
-        memcpy(&buf[BLADERF_IMAGE_MAGIC_LEN], checksum_expected,
-               sizeof(checksum_expected));
-
         return 0;
     }
 }
@@ -146,14 +146,13 @@ static bool image_type_is_valid(bladerf_image_type type) {
     }
 }
 
-/* Serialize image contents and fill in checksum */
-static size_t pack_image(struct bladerf_image *img, uint8_t *buf)
+/* Serialize image metadata, with the checksum field cleared */
+static size_t pack_header(struct bladerf_image *img, uint8_t *buf)
 {
     size_t i = 0;
     uint16_t ver_field;
     uint32_t type, len, addr;
     uint64_t timestamp;
-    char checksum[BLADERF_IMAGE_CHECKSUM_LEN];
 
     memcpy(&buf[i], img->magic, BLADERF_IMAGE_MAGIC_LEN);
     i += BLADERF_IMAGE_MAGIC_LEN;
@@ -195,6 +194,18 @@ static size_t pack_image(struct bladerf_image *img, uint8_t *buf)
     memcpy(&buf[i], &len, sizeof(len));
     i += sizeof(len);
 
+    assert(i == CALC_IMAGE_SIZE(0));
+    return i;
+}
+
+/* Serialize image contents and fill in checksum */
+static size_t pack_image(struct bladerf_image *img, uint8_t *buf)
+{
+    size_t i;
+    char checksum[BLADERF_IMAGE_CHECKSUM_LEN];
+
+    i = pack_header(img, buf);
+
     memcpy(&buf[i], img->data, img->length);
     i += img->length;
 
@@ -205,10 +216,13 @@ static size_t pack_image(struct bladerf_image *img, uint8_t *buf)
 }
 
 /* Unpack flash image from file and validate fields */
-static int unpack_image(struct bladerf_image *img, uint8_t *buf, size_t len)
+static int unpack_image(struct bladerf_image *img,
+                        const uint8_t *buf,
+                        size_t len)
 {
     size_t i = 0;
     uint32_t type;
+    uint8_t *data;
 
     /* Ensure we have at least a full set of metadata */
     if (len < CALC_IMAGE_SIZE(0)) {
@@ -272,9 +286,16 @@ static int unpack_image(struct bladerf_image *img, uint8_t *buf, size_t len)
         return BLADERF_ERR_INVAL;
     }
 
-    /* Just slide the data over */
-    memmove(&buf[0], &buf[i], img->length);
-    img->data = buf;
+    /* Copy only the data out of the file's contents */
+    data = malloc(img->length);
+    if (data == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    memcpy(data, &buf[i], img->length);
+
+    free(img->data);
+    img->data = data;
 
     return 0;
 }
@@ -358,30 +379,21 @@ error:
 
 int bladerf_image_read(struct bladerf_image *img, const char *file)
 {
-    int rv = -1;
-    uint8_t *buf = NULL;
+    int rv;
+    const uint8_t *buf = NULL;
     size_t buf_len;
 
-    rv = file_read_buffer(file, &buf, &buf_len);
+    rv = file_map(file, &buf, &buf_len);
     if (rv < 0) {
-        goto bladerf_image_read_out;
+        return rv;
     }
 
     rv = verify_checksum(buf, buf_len);
-    if (rv < 0) {
-        goto bladerf_image_read_out;
-    }
-
-    /* Note: On success, buf->data = buf, with the data memmove'd over.
-     *       Static analysis tools might indicate a false postive leak when
-     *       buf goes out of scope with rv == 0 */
-    rv = unpack_image(img, buf, buf_len);
-
-bladerf_image_read_out:
-    if (rv != 0) {
-        free(buf);
+    if (rv == 0) {
+        rv = unpack_image(img, buf, buf_len);
     }
 
+    file_unmap(buf, buf_len);
     return rv;
 }
 
@@ -404,6 +416,234 @@ static inline bool is_valid_addr_len(struct bladerf *dev,
     }
 }
 
+/* Flash pages read per chunk when streaming an image to a file */
+#define IMAGE_STREAM_CHUNK_PAGES 256
+
+/* Chunks are double-buffered, so that one is written to the file while the
+ * next is read from flash */
+#define IMAGE_STREAM_NUM_BUFS 2
+
+struct image_stream {
+    FILE *f;
+    SHA256_CTX ctx;
+
+    MUTEX lock;
+    pthread_cond_t cond;
+
+    uint8_t *buf[IMAGE_STREAM_NUM_BUFS];
+    size_t len[IMAGE_STREAM_NUM_BUFS];  /* Non-zero while awaiting write */
+    bool done;                          /* No more chunks will be read */
+    int status;                         /* First file write failure */
+};
+
+/* Hash and write out chunks, in order, as they are filled */
+static void *image_stream_writer(void *arg)
+{
+    struct image_stream *s = arg;
+    unsigned int i = 0;
+    size_t len;
+    int status;
+
+    MUTEX_LOCK(&s->lock);
+
+    for (;;) {
+        while (s->len[i] == 0 && !s->done) {
+            pthread_cond_wait(&s->cond, &s->lock);
+        }
+
+        len = s->len[i];
+        if (len == 0) {
+            break;
+        }
+
+        MUTEX_UNLOCK(&s->lock);
+
+        SHA256_Update(&s->ctx, s->buf[i], len);
+        status = file_write(s->f, s->buf[i], len);
+
+        MUTEX_LOCK(&s->lock);
+
+        s->len[i] = 0;
+        s->status = status;
+        pthread_cond_broadcast(&s->cond);
+
+        if (status != 0) {
+            break;
+        }
+
+        i = (i + 1) % IMAGE_STREAM_NUM_BUFS;
+    }
+
+    MUTEX_UNLOCK(&s->lock);
+
+    return NULL;
+}
+
+/* Read a region of flash in chunks, handing each to the writer thread */
+static int image_stream_flash(struct bladerf *dev,
+                              struct image_stream *s,
+                              uint32_t page,
+                              uint32_t count)
+{
+    const uint32_t psize = dev->flash_arch->psize_bytes;
+    unsigned int i = 0;
+    uint32_t n;
+    int status = 0;
+
+    while (count > 0 && status == 0) {
+        n = u32_min(count, IMAGE_STREAM_CHUNK_PAGES);
+
+        /* Wait for the writer to finish with this buffer */
+        MUTEX_LOCK(&s->lock);
+        while (s->len[i] != 0 && s->status == 0) {
+            pthread_cond_wait(&s->cond, &s->lock);
+        }
+        status = s->status;
+        MUTEX_UNLOCK(&s->lock);
+
+        if (status != 0) {
+            break;
+        }
+
+        status = bladerf_read_flash(dev, s->buf[i], page, n);
+        if (status != 0) {
+            break;
+        }
+
+        MUTEX_LOCK(&s->lock);
+        s->len[i] = (size_t)n * psize;
+        pthread_cond_broadcast(&s->cond);
+        MUTEX_UNLOCK(&s->lock);
+
+        i = (i + 1) % IMAGE_STREAM_NUM_BUFS;
+        page += n;
+        count -= n;
+    }
+
+    MUTEX_LOCK(&s->lock);
+    s->done = true;
+    pthread_cond_broadcast(&s->cond);
+    MUTEX_UNLOCK(&s->lock);
+
+    return status;
+}
+
+int bladerf_image_backup(struct bladerf *dev,
+                         bladerf_image_type type,
+                         uint32_t address,
+                         uint32_t length,
+                         const char *file)
+{
+    struct bladerf_image *img = NULL;
+    struct image_stream s;
+    uint8_t header[CALC_IMAGE_SIZE(0)];
+    uint8_t checksum[BLADERF_IMAGE_CHECKSUM_LEN];
+    pthread_t writer;
+    size_t header_len, i;
+    int status, write_status;
+
+    if (!image_type_is_valid(type) || length == 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (type == BLADERF_IMAGE_TYPE_RAW &&
+        (address % dev->flash_arch->ebsize_bytes != 0 ||
+         length % dev->flash_arch->ebsize_bytes != 0)) {
+        log_debug("Image address and length must be erase block-aligned for "
+                  "RAW.\n");
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* Validates the address and length, and fills in the metadata defaults.
+     * The data itself is never held in memory, so none is allocated. */
+    img = bladerf_alloc_image(dev, type, address, 0);
+    if (img == NULL || !is_page_aligned(dev, length) ||
+        !is_valid_addr_len(dev, address, length)) {
+        bladerf_free_image(img);
+        return BLADERF_ERR_INVAL;
+    }
+
+    img->length = length;
+    strncpy(img->serial, dev->ident.serial, BLADERF_SERIAL_LENGTH);
+
+    header_len = pack_header(img, header);
+    bladerf_free_image(img);
+
+    memset(&s, 0, sizeof(s));
+
+    for (i = 0; i < IMAGE_STREAM_NUM_BUFS; i++) {
+        s.buf[i] = malloc((size_t)IMAGE_STREAM_CHUNK_PAGES *
+                          dev->flash_arch->psize_bytes);
+        if (s.buf[i] == NULL) {
+            status = BLADERF_ERR_MEM;
+            goto out;
+        }
+    }
+
+    s.f = fopen(file, "wb");
+    if (s.f == NULL) {
+        status = (errno == EACCES) ? BLADERF_ERR_PERMISSION : BLADERF_ERR_IO;
+        log_debug("Failed to open \"%s\": %s\n", file, strerror(errno));
+        goto out;
+    }
+
+    /* The checksum field is hashed while cleared, and filled in once the
+     * rest of the file has been written */
+    SHA256_Init(&s.ctx);
+    SHA256_Update(&s.ctx, header, header_len);
+
+    status = file_write(s.f, header, header_len);
+    if (status != 0) {
+        goto out;
+    }
+
+    MUTEX_INIT(&s.lock);
+    pthread_cond_init(&s.cond, NULL);
+
+    status = pthread_create(&writer, NULL, image_stream_writer, &s);
+    if (status != 0) {
+        log_debug("Failed to start image writer: %s\n", strerror(status));
+        status = BLADERF_ERR_UNEXPECTED;
+    } else {
+        status = image_stream_flash(dev, &s,
+                                    address / dev->flash_arch->psize_bytes,
+                                    length / dev->flash_arch->psize_bytes);
+
+        pthread_join(writer, NULL);
+
+        if (status == 0) {
+            status = s.status;
+        }
+    }
+
+    pthread_cond_destroy(&s.cond);
+    MUTEX_DESTROY(&s.lock);
+
+    if (status == 0) {
+        SHA256_Final(checksum, &s.ctx);
+
+        if (fseek(s.f, BLADERF_IMAGE_MAGIC_LEN, SEEK_SET) != 0) {
+            status = BLADERF_ERR_IO;
+        } else {
+            status = file_write(s.f, checksum, sizeof(checksum));
+        }
+    }
+
+out:
+    if (s.f != NULL) {
+        write_status = (fclose(s.f) == 0) ? 0 : BLADERF_ERR_IO;
+        if (status == 0) {
+            status = write_status;
+        }
+    }
+
+    for (i = 0; i < IMAGE_STREAM_NUM_BUFS; i++) {
+        free(s.buf[i]);
+    }
+
+    return status;
+}
+
 struct bladerf_image * bladerf_alloc_image(struct bladerf *dev,
                                            bladerf_image_type type,
                                            uint32_t address,
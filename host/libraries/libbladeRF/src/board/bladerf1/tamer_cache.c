@@ -0,0 +1,131 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libbladeRF.h>
+
+#include "log.h"
+
+#include "helpers/file.h"
+
+#include "tamer_cache.h"
+
+/* Increment when the cache file format changes */
+#define TAMER_CACHE_FORMAT 1
+
+static char *cache_path(char const *serial)
+{
+    if (getenv("BLADERF_DISABLE_VCTCXO_TRIM_CACHE")) {
+        return NULL;
+    }
+
+    return file_device_path("vctcxo-trim", serial, ".cache");
+}
+
+void tamer_cache_load(struct tamer_cache *cache, char const *serial)
+{
+    char *path;
+    FILE *f;
+    unsigned int format, trim;
+    int32_t slope;
+
+    cache->valid = false;
+    cache->dirty = false;
+
+    path = cache_path(serial);
+    if (path == NULL) {
+        return;
+    }
+
+    f = fopen(path, "r");
+    if (f == NULL) {
+        goto out;
+    }
+
+    if (fscanf(f, "format=%u\ntrim=%x\nslope=%" SCNd32 "\n", &format, &trim,
+               &slope) != 3 ||
+        format != TAMER_CACHE_FORMAT || trim > UINT16_MAX || slope == 0) {
+        log_debug("Ignoring stale VCTCXO trim cache %s\n", path);
+    } else {
+        cache->valid = true;
+        cache->trim  = (uint16_t)trim;
+        cache->slope = slope;
+
+        log_verbose("Loaded VCTCXO trim 0x%04x, slope %" PRId32 "\n",
+                    cache->trim, cache->slope);
+    }
+
+    fclose(f);
+
+out:
+    free(path);
+}
+
+void tamer_cache_update(struct tamer_cache *cache,
+                        uint16_t trim,
+                        int32_t slope)
+{
+    if (cache->valid && cache->trim == trim && cache->slope == slope) {
+        return;
+    }
+
+    cache->valid = true;
+    cache->dirty = true;
+    cache->trim  = trim;
+    cache->slope = slope;
+}
+
+void tamer_cache_store(struct tamer_cache *cache, char const *serial)
+{
+    char *path;
+    FILE *f;
+
+    if (!cache->valid || !cache->dirty) {
+        return;
+    }
+
+    path = cache_path(serial);
+    if (path == NULL) {
+        return;
+    }
+
+    f = fopen(path, "w");
+    if (f == NULL) {
+        log_debug("Unable to write VCTCXO trim cache %s\n", path);
+        goto out;
+    }
+
+    fprintf(f, "format=%u\ntrim=%04x\nslope=%" PRId32 "\n",
+            TAMER_CACHE_FORMAT, cache->trim, cache->slope);
+
+    if (fclose(f) != 0) {
+        log_debug("Failed to write VCTCXO trim cache %s\n", path);
+        remove(path);
+    } else {
+        cache->dirty = false;
+    }
+
+out:
+    free(path);
+}
@@ -0,0 +1,79 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef BLADERF1_TAMER_CACHE_H_
+#define BLADERF1_TAMER_CACHE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * VCTCXO trim and tuning slope found by the last VCTCXO tamer run
+ *
+ * The result is saved to the user's bladeRF config directory, keyed by the
+ * device serial. On the next open, the trim DAC is set to the saved trim
+ * rather than the factory value, and enabling the tamer starts it fine tuning
+ * from the saved trim and slope (::BLADERF_CAP_FPGA_TAMER_SEED), so it locks
+ * without first sweeping the trim range.
+ *
+ * The structure is zero-initialized when empty, so it may be embedded
+ * directly in board data. The cache may be disabled by defining
+ * BLADERF_DISABLE_VCTCXO_TRIM_CACHE in the environment.
+ */
+struct tamer_cache {
+    bool valid;     /* trim and slope are set */
+    bool dirty;     /* Changed since it was loaded */
+    uint16_t trim;  /* Trim DAC value */
+    int32_t slope;  /* Trim DAC counts per Hz of error */
+};
+
+/**
+ * Load the saved result for a device
+ *
+ * Failures are logged and are non-fatal; the cache is left empty.
+ *
+ * @param       cache       Cache to fill
+ * @param[in]   serial      Device serial number
+ */
+void tamer_cache_load(struct tamer_cache *cache, char const *serial);
+
+/**
+ * Record a tamer result
+ *
+ * @param       cache       Cache to update
+ * @param[in]   trim        Trim DAC value
+ * @param[in]   slope       Trim DAC counts per Hz of error. Must be non-zero.
+ */
+void tamer_cache_update(struct tamer_cache *cache,
+                        uint16_t trim,
+                        int32_t slope);
+
+/**
+ * Save the result, if it has changed since it was loaded
+ *
+ * Failures are logged and are non-fatal.
+ *
+ * @param       cache       Cache to save
+ * @param[in]   serial      Device serial number
+ */
+void tamer_cache_store(struct tamer_cache *cache, char const *serial);
+
+#endif
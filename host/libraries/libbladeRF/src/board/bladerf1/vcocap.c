@@ -0,0 +1,149 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <string.h>
+
+#include "log.h"
+
+#include "vcocap.h"
+
+#define VCOCAP_MAX 0x3f
+
+static uint32_t freq_diff(uint32_t a, uint32_t b)
+{
+    return (a > b) ? (a - b) : (b - a);
+}
+
+static void remove_point(struct vcocap_model *model, size_t i)
+{
+    memmove(&model->points[i], &model->points[i + 1],
+            (model->count - i - 1) * sizeof(model->points[0]));
+    model->count--;
+}
+
+void vcocap_model_record(struct vcocap_model *model,
+                         uint32_t freq,
+                         uint8_t freqsel,
+                         uint8_t vcocap)
+{
+    size_t i, nearest = 0;
+    uint32_t nearest_diff = UINT32_MAX;
+
+    if (vcocap > VCOCAP_MAX) {
+        return;
+    }
+
+    /* Replace a prior measurement of (nearly) the same frequency */
+    for (i = 0; i < model->count; i++) {
+        const struct vcocap_point *p = &model->points[i];
+        const uint32_t diff = freq_diff(p->freq, freq);
+
+        if (p->freqsel == freqsel && diff < VCOCAP_MODEL_MERGE_HZ) {
+            remove_point(model, i);
+            break;
+        }
+
+        if (diff < nearest_diff) {
+            nearest_diff = diff;
+            nearest      = i;
+        }
+    }
+
+    /* When full, the closest point contributes the least information */
+    if (model->count == VCOCAP_MODEL_MAX_POINTS) {
+        remove_point(model, nearest);
+    }
+
+    for (i = model->count; i > 0 && model->points[i - 1].freq > freq; i--) {
+        model->points[i] = model->points[i - 1];
+    }
+
+    model->points[i].freq    = freq;
+    model->points[i].freqsel = freqsel;
+    model->points[i].vcocap  = vcocap;
+    model->count++;
+
+    log_verbose("VCOCAP model: %u Hz (freqsel 0x%02x) -> %u, %u points\n",
+                freq, freqsel, vcocap, (unsigned int)model->count);
+}
+
+void vcocap_model_clear(struct vcocap_model *model)
+{
+    model->count = 0;
+}
+
+static uint8_t clamp_vcocap(int value)
+{
+    if (value < 0) {
+        return 0;
+    } else if (value > VCOCAP_MAX) {
+        return VCOCAP_MAX;
+    }
+
+    return (uint8_t)value;
+}
+
+bool vcocap_model_predict(const struct vcocap_model *model,
+                          uint32_t freq,
+                          struct lms_freq *f)
+{
+    const struct vcocap_point *below = NULL;
+    const struct vcocap_point *above = NULL;
+    const struct vcocap_point *p;
+    struct lms_freq ref;
+    size_t i;
+
+    for (i = 0; i < model->count; i++) {
+        p = &model->points[i];
+
+        if (p->freqsel != f->freqsel) {
+            continue;
+        }
+
+        if (p->freq <= freq) {
+            below = p;
+        } else {
+            above = p;
+            break;
+        }
+    }
+
+    if (below != NULL && above != NULL) {
+        const uint32_t span = above->freq - below->freq;
+        const int delta     = (int)above->vcocap - (int)below->vcocap;
+        const float pos     = (float)(freq - below->freq) / (float)span;
+        const float value   = (float)below->vcocap + pos * (float)delta;
+
+        f->vcocap = clamp_vcocap((int)(value + 0.5f));
+        return true;
+    } else if (below != NULL || above != NULL) {
+        p = (below != NULL) ? below : above;
+
+        /* Carry the measured error of the linear estimate over to the
+         * target frequency, as both lie on the same VCO curve */
+        if (lms_calculate_tuning_params(p->freq, &ref) == 0) {
+            f->vcocap = clamp_vcocap((int)f->vcocap + (int)p->vcocap -
+                                     (int)ref.vcocap);
+        }
+    }
+
+    return false;
+}
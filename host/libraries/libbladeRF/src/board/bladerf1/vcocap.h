@@ -0,0 +1,96 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef BLADERF1_VCOCAP_H_
+#define BLADERF1_VCOCAP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lms.h"
+
+/* Maximum number of measurements retained per module */
+#define VCOCAP_MODEL_MAX_POINTS 128
+
+/* Measurements in the same VCO band closer than this replace one another */
+#define VCOCAP_MODEL_MERGE_HZ 1000000u
+
+struct vcocap_point {
+    uint32_t freq;   /* LO frequency, in Hz */
+    uint8_t freqsel; /* FREQSEL (VCO and divider) the point was tuned with */
+    uint8_t vcocap;  /* VCOCAP value the tuning algorithm settled on */
+};
+
+/**
+ * Per-module record of VCOCAP values found by hardware tuning.
+ *
+ * Points are kept sorted by frequency. The structure is zero-initialized
+ * when empty, so it may be embedded directly in board data.
+ */
+struct vcocap_model {
+    struct vcocap_point points[VCOCAP_MODEL_MAX_POINTS];
+    size_t count;
+};
+
+/**
+ * Record the VCOCAP value found for a tuned frequency
+ *
+ * @param       model       Model to update
+ * @param[in]   freq        LO frequency, in Hz
+ * @param[in]   freqsel     FREQSEL value used for the tune
+ * @param[in]   vcocap      Resulting VCOCAP value
+ */
+void vcocap_model_record(struct vcocap_model *model,
+                         uint32_t freq,
+                         uint8_t freqsel,
+                         uint8_t vcocap);
+
+/**
+ * Discard all recorded points
+ *
+ * @param       model       Model to clear
+ */
+void vcocap_model_clear(struct vcocap_model *model);
+
+/**
+ * Predict the VCOCAP value for the tuning parameters in `f`
+ *
+ * When the model holds points in the same VCO band on both sides of the
+ * target frequency, the VCOCAP value is linearly interpolated between the
+ * nearest two. When points exist on only one side, the nearest point's
+ * deviation from the linear estimate is applied to the estimate in
+ * f->vcocap. Otherwise f->vcocap is left unchanged.
+ *
+ * @param[in]   model       Model to consult
+ * @param[in]   freq        Target frequency, in Hz
+ * @param       f           Tuning parameters from
+ *                          lms_calculate_tuning_params(). f->vcocap is
+ *                          updated with the prediction.
+ *
+ * @return true if the prediction was interpolated between two measurements
+ *         and may be used without a VCOCAP search, false otherwise
+ */
+bool vcocap_model_predict(const struct vcocap_model *model,
+                          uint32_t freq,
+                          struct lms_freq *f);
+
+#endif
@@ -19,6 +19,7 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <math.h>
 #include <string.h>
 
 #include <libbladeRF.h>
@@ -47,12 +48,18 @@
 #include "backend/backend_config.h"
 #include "backend/usb/usb.h"
 
+#include "nios_pkt_8x32.h"
+
 #include "streaming/async.h"
 #include "streaming/sync.h"
+#include "streaming/sync_split.h"
+#include "streaming/sync_tap.h"
 
 #include "conversions.h"
 #include "devinfo.h"
+#include "helpers/channel_config.h"
 #include "helpers/file.h"
+#include "helpers/probe_cache.h"
 #include "helpers/version.h"
 #include "helpers/wallclock.h"
 #include "iterators.h"
@@ -60,6 +67,8 @@
 
 #include "bladerf2_common.h"
 #include "common.h"
+#include "corr_tbl.h"
+#include "fastlock_cache.h"
 
 
 /******************************************************************************/
@@ -67,6 +76,12 @@
 /******************************************************************************/
 
 static int bladerf2_read_flash_vctcxo_trim(struct bladerf *dev, uint16_t *trim);
+static int _schedule_param(struct bladerf *dev,
+                           bladerf_channel ch,
+                           bladerf_timestamp timestamp,
+                           uint8_t type,
+                           uint8_t cmd,
+                           uint32_t value);
 
 
 /******************************************************************************/
@@ -204,6 +219,12 @@ static int _bladerf2_initialize(struct bladerf *dev)
     board_data->quick_tune_rx_profile = 0;
     board_data->quick_tune_tx_profile = 0;
 
+    /* The RFIC was just initialized, so no profiles are loaded in it */
+    memset(board_data->fastlock_slots, 0, sizeof(board_data->fastlock_slots));
+
+    /* Restore quick tune profiles saved in a previous session */
+    fastlock_cache_init(dev);
+
     log_debug("%s: complete\n", __FUNCTION__);
 
     return 0;
@@ -356,14 +377,13 @@ static int bladerf2_open(struct bladerf *dev, struct bladerf_devinfo *devinfo)
         return status;
     }
 
-    /* Probe SPI flash architecture information */
-    if (have_cap(board_data->capabilities, BLADERF_CAP_FW_FLASH_ID)) {
-        status = spi_flash_read_flash_id(dev, &dev->flash_arch->manufacturer_id,
-                                         &dev->flash_arch->device_id);
-        if (status < 0) {
-            log_error("Failed to probe SPI flash ID information.\n");
-        }
-    } else {
+    /* Probe SPI flash architecture information and the calibration region.
+     * These are cached per device and firmware version. */
+    probe_cache_read(dev, &board_data->fw_version,
+                     have_cap(board_data->capabilities,
+                              BLADERF_CAP_FW_FLASH_ID));
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FW_FLASH_ID)) {
         log_debug("FX3 firmware v%u.%u.%u does not support SPI flash ID. A "
                   "firmware update is recommended in order to probe the SPI "
                   "flash ID information.\n",
@@ -437,20 +457,22 @@ static int bladerf2_open(struct bladerf *dev, struct bladerf_devinfo *devinfo)
         }
 
         if (full_path != NULL) {
-            uint8_t *buf;
+            const uint8_t *buf;
             size_t buf_size;
 
             log_debug("Loading FPGA from: %s\n", full_path);
 
-            status = file_read_buffer(full_path, &buf, &buf_size);
+            status = file_map(full_path, &buf, &buf_size);
             free(full_path);
             full_path = NULL;
 
             if (status != 0) {
-                RETURN_ERROR_STATUS("file_read_buffer", status);
+                RETURN_ERROR_STATUS("file_map", status);
             }
 
-            CHECK_STATUS(dev->backend->load_fpga(dev, buf, buf_size));
+            status = dev->backend->load_fpga(dev, buf, buf_size);
+            file_unmap(buf, buf_size);
+            CHECK_STATUS(status);
 
             board_data->state = STATE_FPGA_LOADED;
         } else {
@@ -538,11 +560,15 @@ static void bladerf2_close(struct bladerf *dev)
                 }
             }
 
+            fastlock_cache_deinit(dev);
+            corr_tbl_deinit(dev);
+
             free(board_data);
             board_data = NULL;
         }
 
         if (flash_arch != NULL) {
+            probe_cache_deinit(dev);
             free(flash_arch);
             flash_arch = NULL;
         }
@@ -709,6 +735,44 @@ static int bladerf2_get_fw_version(struct bladerf *dev,
 /* Enable/disable */
 /******************************************************************************/
 
+#define STANDBY_BIT(ch) (((uint32_t)1) << (ch))
+
+/* Stop a direction's data path while all of its enabled channels are in
+ * standby, and restart it once one of them is active again */
+static int _bladerf2_standby_gate(struct bladerf *dev, bladerf_direction dir)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    bool active  = false;
+    bool standby = false;
+    uint32_t reg;
+    size_t i;
+
+    CHECK_STATUS(dev->backend->rffe_control_read(dev, &reg));
+
+    for (i = 0; i < 2; i++) {
+        bladerf_channel ch = (BLADERF_TX == dir) ? BLADERF_CHANNEL_TX(i)
+                                                 : BLADERF_CHANNEL_RX(i);
+
+        if (board_data->standby & STANDBY_BIT(ch)) {
+            standby = true;
+        } else if (_rffe_ch_enabled(reg, ch)) {
+            active = true;
+        }
+    }
+
+    if (standby && !active && !board_data->standby_gated[dir]) {
+        CHECK_STATUS(dev->backend->enable_module(dev, dir, false));
+        board_data->standby_gated[dir] = true;
+    } else if ((active || !standby) && board_data->standby_gated[dir]) {
+        board_data->standby_gated[dir] = false;
+        if (active) {
+            CHECK_STATUS(dev->backend->enable_module(dev, dir, true));
+        }
+    }
+
+    return 0;
+}
+
 static int bladerf2_enable_module(struct bladerf *dev,
                                   bladerf_channel ch,
                                   bool enable)
@@ -716,8 +780,72 @@ static int bladerf2_enable_module(struct bladerf *dev,
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
     struct bladerf2_board_data *board_data = dev->board_data;
+    struct controller_fns const *rfic      = board_data->rfic;
+    bladerf_direction dir = BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_TX : BLADERF_RX;
+
+    if (0 == (board_data->standby & STANDBY_BIT(ch))) {
+        CHECK_STATUS(rfic->enable_module(dev, ch, enable));
+    } else {
+        board_data->standby &= ~STANDBY_BIT(ch);
+
+        if (enable) {
+            /* The channel is already configured; it only needs to be
+             * unmuted and its data path restarted */
+            if (BLADERF_CHANNEL_IS_TX(ch)) {
+                CHECK_STATUS(rfic->set_txmute(dev, ch, false));
+            }
+        } else {
+            CHECK_STATUS(rfic->enable_module(dev, ch, false));
+        }
+    }
+
+    if (board_data->standby != 0 || board_data->standby_gated[dir]) {
+        CHECK_STATUS(_bladerf2_standby_gate(dev, dir));
+    }
+
+    return 0;
+}
+
+static int bladerf2_standby_module(struct bladerf *dev, bladerf_channel ch)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct controller_fns const *rfic      = board_data->rfic;
+    bladerf_direction dir = BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_TX : BLADERF_RX;
+    float before = 0.0f;
+    float after  = 0.0f;
+    bool have_power;
+
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_RX(1) &&
+        ch != BLADERF_CHANNEL_TX(0) && ch != BLADERF_CHANNEL_TX(1)) {
+        RETURN_INVAL_ARG("channel", ch, "is not valid");
+    }
+
+    if (board_data->standby & STANDBY_BIT(ch)) {
+        return 0;
+    }
+
+    have_power = (0 == ina219_read_power(dev, &before));
+
+    /* Bring the channel up, if it is not already, so that its synthesizer
+     * locks and its RF chain is biased. The data path is stopped below. */
+    CHECK_STATUS(rfic->enable_module(dev, ch, true));
+
+    if (BLADERF_CHANNEL_IS_TX(ch)) {
+        CHECK_STATUS(rfic->set_txmute(dev, ch, true));
+    }
+
+    board_data->standby |= STANDBY_BIT(ch);
+
+    CHECK_STATUS(_bladerf2_standby_gate(dev, dir));
 
-    return board_data->rfic->enable_module(dev, ch, enable);
+    if (have_power && 0 == ina219_read_power(dev, &after)) {
+        log_debug("%s: %s in standby, board power %.3f W (was %.3f W)\n",
+                  __FUNCTION__, channel2str(ch), after, before);
+    }
+
+    return 0;
 }
 
 
@@ -1007,31 +1135,20 @@ static int bladerf2_get_sample_rate(struct bladerf *dev,
     return board_data->rfic->get_sample_rate(dev, ch, rate);
 }
 
-static int bladerf2_set_sample_rate(struct bladerf *dev,
-                                    bladerf_channel ch,
-                                    bladerf_sample_rate rate,
-                                    bladerf_sample_rate *actual)
+/* Change the sample rate from `current` to `rate`, switching the RFIC's 4x
+ * decimation/interpolation filters in or out as required. */
+static int _bladerf2_set_sample_rate(struct bladerf *dev,
+                                     bladerf_channel ch,
+                                     bladerf_sample_rate rate,
+                                     bladerf_sample_rate current)
 {
-    CHECK_BOARD_STATE(STATE_INITIALIZED);
-
     struct bladerf2_board_data *board_data = dev->board_data;
     struct controller_fns const *rfic      = board_data->rfic;
-    struct bladerf_range const *range      = NULL;
-    bladerf_sample_rate current;
     bool old_low, new_low;
     bladerf_rfic_rxfir rxfir;
     bladerf_rfic_txfir txfir;
 
-    /* Range checking */
-    CHECK_STATUS(dev->board->get_sample_rate_range(dev, ch, &range));
-
-    if (!is_within_range(range, rate)) {
-        return BLADERF_ERR_RANGE;
-    }
-
-    /* Get current sample rate, and check it against the low-rate range */
-    CHECK_STATUS(dev->board->get_sample_rate(dev, ch, &current));
-
+    /* Check the current sample rate against the low-rate range */
     old_low = is_within_range(&bladerf2_sample_rate_range_4x, current);
     new_low = is_within_range(&bladerf2_sample_rate_range_4x, rate);
 
@@ -1102,6 +1219,31 @@ static int bladerf2_set_sample_rate(struct bladerf *dev,
         }
     }
 
+    return 0;
+}
+
+static int bladerf2_set_sample_rate(struct bladerf *dev,
+                                    bladerf_channel ch,
+                                    bladerf_sample_rate rate,
+                                    bladerf_sample_rate *actual)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf_range const *range = NULL;
+    bladerf_sample_rate current;
+
+    /* Range checking */
+    CHECK_STATUS(dev->board->get_sample_rate_range(dev, ch, &range));
+
+    if (!is_within_range(range, rate)) {
+        return BLADERF_ERR_RANGE;
+    }
+
+    /* Get current sample rate */
+    CHECK_STATUS(dev->board->get_sample_rate(dev, ch, &current));
+
+    CHECK_STATUS(_bladerf2_set_sample_rate(dev, ch, rate, current));
+
     /* If requested, fetch the new sample rate and return it. */
     if (actual != NULL) {
         CHECK_STATUS(dev->board->get_sample_rate(dev, ch, actual));
@@ -1113,6 +1255,79 @@ static int bladerf2_set_sample_rate(struct bladerf *dev,
     return 0;
 }
 
+static int bladerf2_switch_sample_rate(struct bladerf *dev,
+                                       bladerf_channel ch,
+                                       bladerf_sample_rate rate,
+                                       bladerf_sample_rate *actual)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct bladerf_range const *range      = NULL;
+    bladerf_sample_rate current, new_rate;
+    uint64_t timestamp = 0;
+    uint32_t reg, quiesced;
+    int status;
+
+    if (board_data->rfic->command_mode != RFIC_COMMAND_HOST) {
+        log_debug("%s: requires host-controlled RFIC operation\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    /* Range checking */
+    CHECK_STATUS(dev->board->get_sample_rate_range(dev, ch, &range));
+
+    if (!is_within_range(range, rate)) {
+        return BLADERF_ERR_RANGE;
+    }
+
+    /* Get current sample rate */
+    CHECK_STATUS(dev->board->get_sample_rate(dev, ch, &current));
+
+    /* Hold the ENSM in its wait state while the clock chain and FIRs are
+     * reconfigured, so that the FPGA's sample FIFOs neither fill nor drain
+     * at an intermediate rate. The streams themselves are left running. */
+    CHECK_STATUS(dev->backend->rffe_control_read(dev, &reg));
+
+    quiesced = reg & ~((1 << RFFE_CONTROL_ENABLE) | (1 << RFFE_CONTROL_TXNRX));
+    CHECK_STATUS(dev->backend->rffe_control_write(dev, quiesced));
+
+    status = _bladerf2_set_sample_rate(dev, ch, rate, current);
+
+    if (status == 0) {
+        status = dev->board->get_sample_rate(dev, ch, &new_rate);
+    }
+
+    /* Samples from here on are at the new rate */
+    if (status == 0) {
+        status = dev->backend->get_timestamp(dev, BLADERF_RX, &timestamp);
+    }
+
+    /* Resume, whether or not the change succeeded */
+    CHECK_STATUS(dev->backend->rffe_control_write(dev, reg));
+
+    if (status < 0) {
+        log_error("%s: failed to switch sample rate: %s\n", __FUNCTION__,
+                  bladerf_strerror(status));
+        return status;
+    }
+
+    log_debug("%s: switched from %u to %u Hz at RX t=%llu\n", __FUNCTION__,
+              current, new_rate, (unsigned long long)timestamp);
+
+    sync_rate_change(&board_data->sync[BLADERF_RX], timestamp, new_rate);
+
+    if (actual != NULL) {
+        *actual = new_rate;
+    }
+
+    /* Warn the user if this isn't achievable */
+    check_total_sample_rate(dev);
+
+    return 0;
+}
+
 
 /******************************************************************************/
 /* Bandwidth */
@@ -1203,7 +1418,10 @@ static int bladerf2_set_frequency(struct bladerf *dev,
 
     struct bladerf2_board_data *board_data = dev->board_data;
 
-    return board_data->rfic->set_frequency(dev, ch, frequency);
+    CHECK_STATUS(board_data->rfic->set_frequency(dev, ch, frequency));
+
+    /* Correction registers are selected by the band of the new frequency */
+    return corr_tbl_apply(dev, ch, frequency);
 }
 
 
@@ -1340,10 +1558,170 @@ static int bladerf2_get_rf_ports(struct bladerf *dev,
 }
 
 
+/******************************************************************************/
+/* Channel configuration */
+/******************************************************************************/
+
+static int _bladerf2_apply_config(struct bladerf *dev,
+                                  bladerf_channel ch,
+                                  struct bladerf_channel_config const *config,
+                                  uint32_t changes,
+                                  bladerf_sample_rate current_rate,
+                                  bladerf_frequency frequency)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct controller_fns const *rfic      = board_data->rfic;
+
+    /* Changing the sample rate reprograms the clock chain, which re-runs the
+     * baseband filter calibrations for the current bandwidth. Apply it first
+     * so that a bandwidth change calibrates against the final clocks, and
+     * retune only once the baseband configuration is settled. */
+    if (changes & BLADERF_CHANNEL_CONFIG_SAMPLE_RATE) {
+        CHECK_STATUS(_bladerf2_set_sample_rate(dev, ch, config->sample_rate,
+                                               current_rate));
+    }
+
+    if (changes & BLADERF_CHANNEL_CONFIG_BANDWIDTH) {
+        CHECK_STATUS(rfic->set_bandwidth(dev, ch, config->bandwidth, NULL));
+    }
+
+    if (changes & BLADERF_CHANNEL_CONFIG_FREQUENCY) {
+        CHECK_STATUS(rfic->set_frequency(dev, ch, config->frequency));
+    }
+
+    if (changes & BLADERF_CHANNEL_CONFIG_RF_PORT) {
+        CHECK_STATUS(dev->board->set_rf_port(dev, ch, config->rf_port));
+    }
+
+    if (changes & BLADERF_CHANNEL_CONFIG_FREQUENCY) {
+        CHECK_STATUS(corr_tbl_apply(dev, ch, config->frequency));
+    }
+
+    if (changes & BLADERF_CHANNEL_CONFIG_GAIN_MODE) {
+        CHECK_STATUS(rfic->set_gain_mode(dev, ch, config->gain_mode));
+    }
+
+    if (changes & BLADERF_CHANNEL_CONFIG_GAIN) {
+        struct bladerf_range const *range = NULL;
+        int gain;
+
+        CHECK_STATUS(dev->board->get_gain_range(dev, ch, &range));
+
+        gain = clamp_to_range(range, config->gain);
+
+        if (RFIC_COMMAND_FPGA == rfic->command_mode) {
+            /* Use the gain offset for the target frequency, rather than
+             * reading the frequency back mid-batch */
+            char const *stage = BLADERF_CHANNEL_IS_TX(ch) ? "dsa" : "full";
+            float offset;
+
+            CHECK_STATUS(get_gain_offset_at(ch, frequency, &offset));
+            CHECK_STATUS(rfic->set_gain_stage(dev, ch, stage,
+                                              __round_int(gain - offset)));
+        } else {
+            CHECK_STATUS(rfic->set_gain(dev, ch, gain));
+        }
+    }
+
+    return 0;
+}
+
+static int bladerf2_apply_config(struct bladerf *dev,
+                                 bladerf_channel ch,
+                                 struct bladerf_channel_config const *config)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(config);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct controller_fns const *rfic      = board_data->rfic;
+    bladerf_sample_rate current_rate       = 0;
+    bladerf_frequency frequency            = 0;
+    uint32_t changes;
+    int status;
+
+    CHECK_STATUS(channel_config_check(dev, ch, config));
+    CHECK_STATUS(channel_config_changes(dev, ch, config, &changes));
+
+    if (0 == changes) {
+        return 0;
+    }
+
+    /* Gather everything that must be read before commands are queued */
+    if (changes & BLADERF_CHANNEL_CONFIG_SAMPLE_RATE) {
+        CHECK_STATUS(dev->board->get_sample_rate(dev, ch, &current_rate));
+    }
+
+    if (changes & BLADERF_CHANNEL_CONFIG_FREQUENCY) {
+        frequency = config->frequency;
+    } else if (changes & BLADERF_CHANNEL_CONFIG_GAIN) {
+        CHECK_STATUS(dev->board->get_frequency(dev, ch, &frequency));
+    }
+
+    CHECK_STATUS(rfic->batch_begin(dev));
+
+    status = _bladerf2_apply_config(dev, ch, config, changes, current_rate,
+                                    frequency);
+
+    /* Always wait for whatever was queued, even on failure */
+    if (0 == status) {
+        status = rfic->batch_end(dev);
+    } else {
+        rfic->batch_end(dev);
+    }
+
+    if (0 == status && (changes & BLADERF_CHANNEL_CONFIG_SAMPLE_RATE)) {
+        /* Warn the user if this isn't achievable */
+        check_total_sample_rate(dev);
+    }
+
+    return status;
+}
+
+
 /******************************************************************************/
 /* Scheduled Tuning */
 /******************************************************************************/
 
+/* Choose the RFFE fast lock slot for a Nios profile. A profile already
+ * loaded keeps its slot; otherwise the least recently used slot is
+ * reassigned. Retunes are queued in the Nios in the order they are
+ * scheduled, and the Nios preloads queued profiles whose slots do not
+ * collide, so LRU order keeps up to NUM_RFFE_FASTLOCK_PROFILES distinct
+ * upcoming profiles resident at once. */
+static uint8_t _fastlock_slot_assign(struct bladerf *dev,
+                                     bladerf_channel ch,
+                                     uint16_t nios_profile)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct bladerf2_fastlock_slots *slots =
+        &board_data->fastlock_slots[BLADERF_CHANNEL_IS_TX(ch) ? 1 : 0];
+    uint8_t i, slot = 0;
+
+    for (i = 0; i < NUM_RFFE_FASTLOCK_PROFILES; i++) {
+        if (slots->loaded[i] && slots->owner[i] == nios_profile) {
+            slots->last_use[i] = ++slots->uses;
+            return i;
+        }
+    }
+
+    /* Unused slots have a last_use of 0, so they are taken first */
+    for (i = 1; i < NUM_RFFE_FASTLOCK_PROFILES; i++) {
+        if (slots->last_use[i] < slots->last_use[slot]) {
+            slot = i;
+        }
+    }
+
+    log_verbose("%s fast lock profile %u assigned to RFFE slot %u\n",
+                BLADERF_CHANNEL_IS_TX(ch) ? "TX" : "RX", nios_profile, slot);
+
+    slots->owner[slot]    = nios_profile;
+    slots->loaded[slot]   = true;
+    slots->last_use[slot] = ++slots->uses;
+
+    return slot;
+}
+
 static int bladerf2_get_quick_tune(struct bladerf *dev,
                                    bladerf_channel ch,
                                    struct bladerf_quick_tune *quick_tune)
@@ -1364,6 +1742,14 @@ static int bladerf2_get_quick_tune(struct bladerf *dev,
 
     CHECK_STATUS(dev->board->get_frequency(dev, ch, &freq));
 
+    /* Reuse a profile already stored for this frequency */
+    if (fastlock_cache_lookup(dev, ch, freq, quick_tune)) {
+        log_verbose("Quick tune reusing Nios fast lock index: %u\n",
+                    quick_tune->nios_profile);
+        board_data->rfic_reset_on_close = true;
+        return 0;
+    }
+
     pm = _get_band_port_map_by_freq(ch, freq);
 
     if (BLADERF_CHANNEL_IS_TX(ch)) {
@@ -1373,7 +1759,7 @@ static int bladerf2_get_quick_tune(struct bladerf *dev,
             log_verbose("Quick tune assigned Nios TX fast lock index: %u\n",
                         quick_tune->nios_profile);
             quick_tune->rffe_profile =
-                quick_tune->nios_profile % NUM_RFFE_FASTLOCK_PROFILES;
+                _fastlock_slot_assign(dev, ch, quick_tune->nios_profile);
             log_verbose("Quick tune assigned RFFE TX fast lock index: %u\n",
                         quick_tune->rffe_profile);
         } else {
@@ -1402,7 +1788,7 @@ static int bladerf2_get_quick_tune(struct bladerf *dev,
             log_verbose("Quick tune assigned Nios RX fast lock index: %u\n",
                         quick_tune->nios_profile);
             quick_tune->rffe_profile =
-                quick_tune->nios_profile % NUM_RFFE_FASTLOCK_PROFILES;
+                _fastlock_slot_assign(dev, ch, quick_tune->nios_profile);
             log_verbose("Quick tune assigned RFFE RX fast lock index: %u\n",
                         quick_tune->rffe_profile);
         } else {
@@ -1432,6 +1818,8 @@ static int bladerf2_get_quick_tune(struct bladerf *dev,
         quick_tune->spdt = (pm->spdt << 2) | (pm->spdt);
     }
 
+    fastlock_cache_record(dev, ch, freq, quick_tune);
+
     /* Workaround: the RFIC can end up in a bad state after fastlock use, and
      * needs to be reset and re-initialized. This is likely due to our direct
      * SPI writes causing state incongruence. */
@@ -1461,9 +1849,12 @@ static int bladerf2_schedule_retune(struct bladerf *dev,
         return BLADERF_ERR_UNSUPPORTED;
     }
 
-    return dev->backend->retune2(dev, ch, timestamp, quick_tune->nios_profile,
-                                 quick_tune->rffe_profile, quick_tune->port,
-                                 quick_tune->spdt);
+    /* The RFFE slot is managed here, so that profiles stay resident for as
+     * long as possible regardless of the slot they were created in */
+    return dev->backend->retune2(
+        dev, ch, timestamp, quick_tune->nios_profile,
+        _fastlock_slot_assign(dev, ch, quick_tune->nios_profile),
+        quick_tune->port, quick_tune->spdt, NIOS_PKT_RETUNE2_OP_SCHEDULE);
 }
 
 static int bladerf2_cancel_scheduled_retunes(struct bladerf *dev,
@@ -1484,41 +1875,202 @@ static int bladerf2_cancel_scheduled_retunes(struct bladerf *dev,
     }
 
     return dev->backend->retune2(dev, ch, NIOS_PKT_RETUNE2_CLEAR_QUEUE, 0, 0, 0,
-                                 0);
+                                 0, NIOS_PKT_RETUNE2_OP_SCHEDULE);
 }
 
+static int bladerf2_cancel_scheduled_retune(struct bladerf *dev,
+                                            bladerf_channel ch,
+                                            bladerf_timestamp timestamp)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
 
-/******************************************************************************/
-/* DC/Phase/Gain Correction */
-/******************************************************************************/
+    struct bladerf2_board_data *board_data = dev->board_data;
 
-// clang-format off
-static const struct {
-    struct {
-        uint16_t reg[2];        /* Low/High band */
-        unsigned int shift;     /* Value scaling */
-    } corr[4];
-} ad9361_correction_reg_table[4] = {
-    [BLADERF_CHANNEL_RX(0)].corr = {
-        [BLADERF_CORR_DCOFF_I] = {
-            FIELD_INIT(.reg, {0, 0}),  /* More complex look up */
-            FIELD_INIT(.shift, 0),
-        },
-        [BLADERF_CORR_DCOFF_Q] = {
-            FIELD_INIT(.reg, {0, 0}),  /* More complex look up */
-            FIELD_INIT(.shift, 0),
-        },
-        [BLADERF_CORR_PHASE] = {
-            FIELD_INIT(.reg, {  AD936X_REG_RX1_INPUT_A_PHASE_CORR,
-                                AD936X_REG_RX1_INPUT_BC_PHASE_CORR  }),
-            FIELD_INIT(.shift, 6),
-        },
-        [BLADERF_CORR_GAIN] = {
-            FIELD_INIT(.reg, {  AD936X_REG_RX1_INPUT_A_GAIN_CORR,
-                                AD936X_REG_RX1_INPUT_BC_PHASE_CORR  }),
-            FIELD_INIT(.shift, 6),
-        }
-    },
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RETUNE_EDIT)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "cancelling individual scheduled retunes.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return dev->backend->retune2(dev, ch, timestamp, 0, 0, 0, 0,
+                                 NIOS_PKT_RETUNE2_OP_CANCEL);
+}
+
+static int bladerf2_replace_scheduled_retune(
+    struct bladerf *dev,
+    bladerf_channel ch,
+    bladerf_timestamp timestamp,
+    bladerf_frequency frequency,
+    struct bladerf_quick_tune *quick_tune)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+    NULL_CHECK(quick_tune);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RETUNE_EDIT)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "replacing individual scheduled retunes.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return dev->backend->retune2(
+        dev, ch, timestamp, quick_tune->nios_profile,
+        _fastlock_slot_assign(dev, ch, quick_tune->nios_profile),
+        quick_tune->port, quick_tune->spdt, NIOS_PKT_RETUNE2_OP_REPLACE);
+}
+
+static int bladerf2_schedule_retune_pair(struct bladerf *dev,
+                                         bladerf_timestamp timestamp,
+                                         const struct bladerf_quick_tune *rx,
+                                         const struct bladerf_quick_tune *tx)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+    NULL_CHECK(rx);
+    NULL_CHECK(tx);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    uint8_t rx_rffe_profile, tx_rffe_profile, port, spdt;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RETUNE_PAIR)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "paired RX/TX retunes.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    /* The pair entry carries 8-bit Nios profile numbers */
+    if (rx->nios_profile > UINT8_MAX || tx->nios_profile > UINT8_MAX) {
+        log_debug("Nios profile out of range for a paired retune.\n");
+        return BLADERF_ERR_INVAL;
+    }
+
+    rx_rffe_profile =
+        _fastlock_slot_assign(dev, BLADERF_CHANNEL_RX(0), rx->nios_profile);
+    tx_rffe_profile =
+        _fastlock_slot_assign(dev, BLADERF_CHANNEL_TX(0), tx->nios_profile);
+
+    /* Each quick tune only describes the port and SPDT bits of its own
+     * direction */
+    port = (rx->port & NIOS_PKT_RETUNE2_PORT_RX_MASK) |
+           (tx->port & NIOS_PKT_RETUNE2_PORT_TX_MASK);
+    spdt = (rx->spdt & 0x0f) | (tx->spdt & 0xf0);
+
+    return dev->backend->retune2_pair(dev, timestamp, rx->nios_profile,
+                                      rx_rffe_profile, tx->nios_profile,
+                                      tx_rffe_profile, port, spdt);
+}
+
+static int bladerf2_get_retune_stats(struct bladerf *dev,
+                                     bladerf_channel ch,
+                                     struct bladerf_retune_stats *stats)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RETUNE_STATS)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "retune statistics.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return dev->backend->get_retune_stats(dev, ch, stats);
+}
+
+static int bladerf2_schedule_gain(struct bladerf *dev,
+                                  bladerf_channel ch,
+                                  bladerf_timestamp timestamp,
+                                  int gain)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf_range const *range = NULL;
+    char const *stage = BLADERF_CHANNEL_IS_TX(ch) ? "dsa" : "full";
+    float offset;
+    int64_t val;
+
+    /* RFIC commands are executed by the Nios, which requires it to be in
+     * control of the RFIC */
+    IF_COMMAND_MODE(dev, RFIC_COMMAND_HOST, {
+        log_debug("%s: host command mode not supported\n", __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    });
+
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_RX(1) &&
+        ch != BLADERF_CHANNEL_TX(0) && ch != BLADERF_CHANNEL_TX(1)) {
+        RETURN_INVAL_ARG("channel", ch, "is not valid");
+    }
+
+    /* Convert the overall gain into a value for the RFIC, as in rfic_fpga's
+     * set_gain and set_gain_stage */
+    CHECK_STATUS(get_gain_offset(dev, ch, &offset));
+    CHECK_STATUS(dev->board->get_gain_stage_range(dev, ch, stage, &range));
+
+    gain = __round_int(gain - offset);
+
+    if (BLADERF_CHANNEL_IS_TX(ch) && gain < -89) {
+        val = -89750;
+    } else {
+        val = __scale_int64(range, clamp_to_range(range, gain));
+    }
+
+    if (BLADERF_CHANNEL_IS_TX(ch)) {
+        val = -val;
+    }
+
+    return _schedule_param(dev, ch, timestamp,
+                           NIOS_PKT_RETUNE2_TYPE_RFIC_CMD,
+                           BLADERF_RFIC_COMMAND_GAIN, (uint32_t)val);
+}
+
+
+/******************************************************************************/
+/* DC/Phase/Gain Correction */
+/******************************************************************************/
+
+// clang-format off
+static const struct {
+    struct {
+        uint16_t reg[2];        /* Low/High band */
+        unsigned int shift;     /* Value scaling */
+    } corr[4];
+} ad9361_correction_reg_table[4] = {
+    [BLADERF_CHANNEL_RX(0)].corr = {
+        [BLADERF_CORR_DCOFF_I] = {
+            FIELD_INIT(.reg, {0, 0}),  /* More complex look up */
+            FIELD_INIT(.shift, 0),
+        },
+        [BLADERF_CORR_DCOFF_Q] = {
+            FIELD_INIT(.reg, {0, 0}),  /* More complex look up */
+            FIELD_INIT(.shift, 0),
+        },
+        [BLADERF_CORR_PHASE] = {
+            FIELD_INIT(.reg, {  AD936X_REG_RX1_INPUT_A_PHASE_CORR,
+                                AD936X_REG_RX1_INPUT_BC_PHASE_CORR  }),
+            FIELD_INIT(.shift, 6),
+        },
+        [BLADERF_CORR_GAIN] = {
+            FIELD_INIT(.reg, {  AD936X_REG_RX1_INPUT_A_GAIN_CORR,
+                                AD936X_REG_RX1_INPUT_BC_PHASE_CORR  }),
+            FIELD_INIT(.shift, 6),
+        }
+    },
     [BLADERF_CHANNEL_RX(1)].corr = {
         [BLADERF_CORR_DCOFF_I] = {
             FIELD_INIT(.reg, {0, 0}), /* More complex look up */
@@ -1924,6 +2476,94 @@ static int bladerf2_set_correction(struct bladerf *dev,
     return 0;
 }
 
+static int bladerf2_get_temperature(struct bladerf *dev, float *val)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+    NULL_CHECK(val);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    IF_COMMAND_MODE(dev, RFIC_COMMAND_FPGA, {
+        log_debug("%s: FPGA command mode not supported\n", __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    });
+
+    *val = ad9361_get_temp(board_data->phy) / 1000.0F;
+
+    return 0;
+}
+
+static int bladerf2_read_telemetry(struct bladerf *dev,
+                                   uint32_t items,
+                                   struct bladerf_telemetry *t)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+    NULL_CHECK(t);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct controller_fns const *rfic      = board_data->rfic;
+    uint32_t reg                           = 0;
+    int status                             = 0;
+    size_t i;
+
+    t->valid         = 0;
+    t->rssi_channels = 0;
+
+    /* The PLL lock state, and which RX channels are enabled, are both read
+     * from the RFFE control register */
+    if ((items & (BLADERF_TELEMETRY_PLL_LOCK | BLADERF_TELEMETRY_RSSI)) != 0) {
+        status = dev->backend->rffe_control_read(dev, &reg);
+        if (status != 0) {
+            items &= ~(BLADERF_TELEMETRY_PLL_LOCK | BLADERF_TELEMETRY_RSSI);
+        }
+    }
+
+    if ((items & BLADERF_TELEMETRY_PLL_LOCK) != 0) {
+        t->pll_locked = (reg >> RFFE_CONTROL_ADF_MUXOUT) & 0x1;
+        t->valid |= BLADERF_TELEMETRY_PLL_LOCK;
+    }
+
+    /* Not available in FPGA command mode */
+    if ((items & BLADERF_TELEMETRY_TEMPERATURE) != 0 &&
+        rfic->command_mode == RFIC_COMMAND_HOST) {
+        t->temperature = ad9361_get_temp(board_data->phy) / 1000.0F;
+        t->valid |= BLADERF_TELEMETRY_TEMPERATURE;
+    }
+
+    if ((items & BLADERF_TELEMETRY_RSSI) != 0 &&
+        board_data->state >= STATE_INITIALIZED) {
+        for (i = 0; i < BLADERF_TELEMETRY_RX_CHANNELS; i++) {
+            bladerf_channel const ch = BLADERF_CHANNEL_RX(i);
+
+            if (!_rffe_ch_enabled(reg, ch)) {
+                continue;
+            }
+
+            status = rfic->get_rssi(dev, ch, &t->pre_rssi[i], &t->sym_rssi[i]);
+            if (status == 0) {
+                t->rssi_channels |= (1 << i);
+            }
+        }
+
+        if (t->rssi_channels != 0) {
+            t->valid |= BLADERF_TELEMETRY_RSSI;
+        }
+    }
+
+    if ((items & BLADERF_TELEMETRY_POWER) != 0) {
+        status = ina219_read_power(dev, &t->power);
+        if (status == 0) {
+            t->valid |= BLADERF_TELEMETRY_POWER;
+        }
+    }
+
+    if (t->valid != 0) {
+        return 0;
+    }
+
+    return (status != 0) ? status : BLADERF_ERR_UNSUPPORTED;
+}
+
 
 /******************************************************************************/
 /* Trigger */
@@ -1988,6 +2628,45 @@ static int bladerf2_trigger_state(struct bladerf *dev,
                               fire_requested);
 }
 
+static int bladerf2_trigger_fire_at(struct bladerf *dev,
+                                    struct bladerf_trigger const *trigger,
+                                    uint64_t timestamp)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(trigger);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_TRIGGER_TIME)) {
+        log_debug("FPGA %s does not support scheduled triggers.\n",
+                  board_data->fpga_version.describe);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return fpga_trigger_fire_at(dev, trigger, timestamp);
+}
+
+static int bladerf2_trigger_fire_time(struct bladerf *dev,
+                                      struct bladerf_trigger const *trigger,
+                                      bool *has_fired,
+                                      uint64_t *timestamp)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(trigger);
+    NULL_CHECK(has_fired);
+    NULL_CHECK(timestamp);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_TRIGGER_TIME)) {
+        log_debug("FPGA %s does not record trigger fire times.\n",
+                  board_data->fpga_version.describe);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return fpga_trigger_fire_time(dev, trigger, has_fired, timestamp);
+}
+
 
 /******************************************************************************/
 /* Streaming */
@@ -2006,7 +2685,8 @@ static int bladerf2_init_stream(struct bladerf_stream **stream,
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
     return async_init_stream(stream, dev, callback, buffers, num_buffers,
-                             format, samples_per_buffer, num_transfers,
+                             format, samples_per_buffer,
+                             ASYNC_BUFFER_GRANULARITY, num_transfers,
                              user_data);
 }
 
@@ -2117,6 +2797,23 @@ static int bladerf2_sync_config(struct bladerf *dev,
     return status;
 }
 
+static int bladerf2_sync_start(struct bladerf *dev, bladerf_direction dir)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        RETURN_INVAL("direction", "is invalid");
+    }
+
+    if (!board_data->sync[dir].initialized) {
+        RETURN_INVAL("sync", "not initialized");
+    }
+
+    return sync_start(&board_data->sync[dir]);
+}
+
 static int bladerf2_sync_tx(struct bladerf *dev,
                             void const *samples,
                             unsigned int num_samples,
@@ -2135,6 +2832,38 @@ static int bladerf2_sync_tx(struct bladerf *dev,
                    metadata, timeout_ms);
 }
 
+static int bladerf2_sync_tx_acquire(struct bladerf *dev,
+                                    void **samples,
+                                    unsigned int *num_samples,
+                                    unsigned int timeout_ms)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        RETURN_INVAL("sync tx", "not initialized");
+    }
+
+    return sync_tx_acquire(&board_data->sync[BLADERF_TX], samples, num_samples,
+                           timeout_ms);
+}
+
+static int bladerf2_sync_tx_commit(struct bladerf *dev,
+                                   const void *samples,
+                                   unsigned int num_samples)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        RETURN_INVAL("sync tx", "not initialized");
+    }
+
+    return sync_tx_commit(&board_data->sync[BLADERF_TX], samples, num_samples);
+}
+
 static int bladerf2_sync_rx(struct bladerf *dev,
                             void *samples,
                             unsigned int num_samples,
@@ -2153,40 +2882,361 @@ static int bladerf2_sync_rx(struct bladerf *dev,
                    metadata, timeout_ms);
 }
 
-static int bladerf2_get_timestamp(struct bladerf *dev,
-                                  bladerf_direction dir,
-                                  bladerf_timestamp *value)
+static int bladerf2_sync_rx_planar(struct bladerf *dev,
+                                   void *const samples[],
+                                   unsigned int num_samples,
+                                   struct bladerf_metadata *metadata,
+                                   unsigned int timeout_ms)
 {
     CHECK_BOARD_STATE(STATE_INITIALIZED);
-    NULL_CHECK(value);
 
-    return dev->backend->get_timestamp(dev, dir, value);
-}
+    struct bladerf2_board_data *board_data = dev->board_data;
 
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        RETURN_INVAL("sync rx", "not initialized");
+    }
 
-/******************************************************************************/
-/* FPGA/Firmware Loading/Flashing */
-/******************************************************************************/
+    return sync_rx_planar(&board_data->sync[BLADERF_RX], samples, num_samples,
+                          metadata, timeout_ms);
+}
 
-static int bladerf2_load_fpga(struct bladerf *dev,
-                              uint8_t const *buf,
-                              size_t length)
+static int bladerf2_sync_rx_channel(struct bladerf *dev,
+                                    bladerf_channel ch,
+                                    void *samples,
+                                    unsigned int num_samples,
+                                    struct bladerf_metadata *metadata,
+                                    unsigned int timeout_ms)
 {
-    CHECK_BOARD_STATE(STATE_FIRMWARE_LOADED);
-    NULL_CHECK(buf);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
 
     struct bladerf2_board_data *board_data = dev->board_data;
 
-    if (!is_valid_fpga_size(dev, board_data->fpga_size, length)) {
-        RETURN_INVAL("fpga file", "incorrect file size");
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        RETURN_INVAL("sync rx", "not initialized");
     }
 
-    CHECK_STATUS(dev->backend->load_fpga(dev, buf, length));
+    return sync_split_rx(&board_data->sync[BLADERF_RX], ch >> 1, samples,
+                         num_samples, metadata, timeout_ms);
+}
 
-    /* Update device state */
-    board_data->state = STATE_FPGA_LOADED;
+static int bladerf2_sync_rx_acquire(struct bladerf *dev,
+                                    void **samples,
+                                    unsigned int *num_samples,
+                                    struct bladerf_metadata *metadata,
+                                    unsigned int timeout_ms)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-    CHECK_STATUS(_bladerf2_initialize(dev));
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        RETURN_INVAL("sync rx", "not initialized");
+    }
+
+    return sync_rx_acquire(&board_data->sync[BLADERF_RX], samples, num_samples,
+                           metadata, timeout_ms);
+}
+
+static int bladerf2_sync_rx_release(struct bladerf *dev, const void *samples)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        RETURN_INVAL("sync rx", "not initialized");
+    }
+
+    return sync_rx_release(&board_data->sync[BLADERF_RX], samples);
+}
+
+static int bladerf2_rx_tap_acquire(struct bladerf *dev,
+                                   unsigned int tap,
+                                   const void **samples,
+                                   unsigned int *num_samples,
+                                   struct bladerf_metadata *metadata,
+                                   unsigned int timeout_ms)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        RETURN_INVAL("sync rx", "not initialized");
+    }
+
+    return sync_tap_acquire(&board_data->sync[BLADERF_RX], tap, samples,
+                            num_samples, metadata, timeout_ms);
+}
+
+static int bladerf2_rx_tap_release(struct bladerf *dev,
+                                   unsigned int tap,
+                                   const void *samples)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        RETURN_INVAL("sync rx", "not initialized");
+    }
+
+    return sync_tap_release(&board_data->sync[BLADERF_RX], tap, samples);
+}
+
+static int bladerf2_sync_rx_deadline(struct bladerf *dev,
+                                     void *samples,
+                                     unsigned int num_samples,
+                                     struct bladerf_metadata *metadata,
+                                     uint64_t deadline_ns)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        RETURN_INVAL("sync rx", "not initialized");
+    }
+
+    return sync_rx_deadline(&board_data->sync[BLADERF_RX], samples,
+                            num_samples, metadata, deadline_ns);
+}
+
+static int bladerf2_sync_tx_deadline(struct bladerf *dev,
+                                     void const *samples,
+                                     unsigned int num_samples,
+                                     struct bladerf_metadata *metadata,
+                                     uint64_t deadline_ns)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        RETURN_INVAL("sync tx", "not initialized");
+    }
+
+    return sync_tx_deadline(&board_data->sync[BLADERF_TX], samples,
+                            num_samples, metadata, deadline_ns);
+}
+
+static int bladerf2_sync_rxv(struct bladerf *dev,
+                             const struct bladerf_sync_iov *iov,
+                             unsigned int iovcnt,
+                             unsigned int *completed,
+                             unsigned int timeout_ms)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        RETURN_INVAL("sync rx", "not initialized");
+    }
+
+    return sync_rxv(&board_data->sync[BLADERF_RX], iov, iovcnt, completed,
+                    timeout_ms);
+}
+
+static int bladerf2_sync_txv(struct bladerf *dev,
+                             const struct bladerf_sync_iov *iov,
+                             unsigned int iovcnt,
+                             unsigned int *completed,
+                             unsigned int timeout_ms)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        RETURN_INVAL("sync tx", "not initialized");
+    }
+
+    return sync_txv(&board_data->sync[BLADERF_TX], iov, iovcnt, completed,
+                    timeout_ms);
+}
+
+static int bladerf2_sync_rxtx(struct bladerf *dev,
+                              void *rx_samples,
+                              unsigned int rx_num_samples,
+                              struct bladerf_metadata *rx_metadata,
+                              const void *tx_samples,
+                              unsigned int tx_num_samples,
+                              struct bladerf_metadata *tx_metadata,
+                              uint64_t tx_offset,
+                              unsigned int timeout_ms)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        RETURN_INVAL("sync rx", "not initialized");
+    }
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        RETURN_INVAL("sync tx", "not initialized");
+    }
+
+    return sync_rxtx(&board_data->sync[BLADERF_RX],
+                     &board_data->sync[BLADERF_TX], rx_samples,
+                     rx_num_samples, rx_metadata, tx_samples,
+                     tx_num_samples, tx_metadata, tx_offset, timeout_ms);
+}
+
+static int bladerf2_get_sync_stats(struct bladerf *dev,
+                                   bladerf_direction dir,
+                                   struct bladerf_stream_stats *stats)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(stats);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        RETURN_INVAL("direction", "is invalid");
+    }
+
+    /* Not logged, as this is polled to detect stream activity */
+    if (!board_data->sync[dir].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_get_stats(&board_data->sync[dir], stats);
+}
+
+static int bladerf2_get_sync_latency(struct bladerf *dev,
+                                     bladerf_direction dir,
+                                     struct bladerf_sync_latency *latency)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(latency);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        RETURN_INVAL("direction", "is invalid");
+    }
+
+    if (!board_data->sync[dir].initialized) {
+        RETURN_INVAL("sync", "not initialized");
+    }
+
+    return sync_get_latency(&board_data->sync[dir], latency);
+}
+
+static int bladerf2_get_sync_poll_handle(struct bladerf *dev,
+                                         bladerf_direction dir,
+                                         bladerf_poll_handle *handle)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(handle);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        RETURN_INVAL("direction", "is invalid");
+    }
+
+    if (!board_data->sync[dir].initialized) {
+        RETURN_INVAL("sync", "not initialized");
+    }
+
+    return sync_get_poll_handle(&board_data->sync[dir], handle);
+}
+
+static int bladerf2_read_rx_capture(struct bladerf *dev,
+                                    void *samples,
+                                    unsigned int num_samples,
+                                    struct bladerf_metadata *metadata)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(metadata);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        RETURN_INVAL("sync rx", "not initialized");
+    }
+
+    return sync_capture_read(&board_data->sync[BLADERF_RX], samples,
+                             num_samples, metadata);
+}
+
+static int bladerf2_get_rx_capture_range(struct bladerf *dev,
+                                         bladerf_timestamp *oldest,
+                                         bladerf_timestamp *newest)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(oldest);
+    NULL_CHECK(newest);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        RETURN_INVAL("sync rx", "not initialized");
+    }
+
+    return sync_capture_range(&board_data->sync[BLADERF_RX], oldest, newest);
+}
+
+static int bladerf2_get_timestamp(struct bladerf *dev,
+                                  bladerf_direction dir,
+                                  bladerf_timestamp *value)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(value);
+
+    return dev->backend->get_timestamp(dev, dir, value);
+}
+
+static int bladerf2_get_timestamp_latch(struct bladerf *dev,
+                                        bladerf_direction dir,
+                                        bladerf_timestamp *timestamp,
+                                        uint32_t *hold)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_TS_LATCH)) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return dev->backend->get_timestamp_latch(dev, dir, timestamp, hold);
+}
+
+
+/******************************************************************************/
+/* FPGA/Firmware Loading/Flashing */
+/******************************************************************************/
+
+static int bladerf2_load_fpga(struct bladerf *dev,
+                              uint8_t const *buf,
+                              size_t length)
+{
+    CHECK_BOARD_STATE(STATE_FIRMWARE_LOADED);
+    NULL_CHECK(buf);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!is_valid_fpga_size(dev, board_data->fpga_size, length)) {
+        RETURN_INVAL("fpga file", "incorrect file size");
+    }
+
+    /* Nothing to do if the device was already initialized with this image */
+    if (board_data->state == STATE_INITIALIZED &&
+        dev->backend->is_fpga_image_loaded(dev, buf, length) == 1) {
+        log_debug("%s: FPGA image is already loaded\n", __FUNCTION__);
+        return 0;
+    }
+
+    CHECK_STATUS(dev->backend->load_fpga(dev, buf, length));
+
+    /* Update device state */
+    board_data->state = STATE_FPGA_LOADED;
+
+    CHECK_STATUS(_bladerf2_initialize(dev));
 
     return 0;
 }
@@ -2321,6 +3371,9 @@ static int bladerf2_set_tuning_mode(struct bladerf *dev,
     board_data->rfic        = rfic_new;
     board_data->tuning_mode = mode;
 
+    /* The FPGA may have changed, so re-read its RFIC write queue depth */
+    board_data->rfic_queue_max = 0;
+
     /* Bring RFIC to initialized state */
     CHECK_STATUS(rfic_new->get_init_state(dev, &init_state));
 
@@ -2328,12 +3381,19 @@ static int bladerf2_set_tuning_mode(struct bladerf *dev,
         case BLADERF_RFIC_INIT_STATE_OFF:
             log_debug("%s: %s %s RFIC control\n", __FUNCTION__, "Initializing",
                       tuningmode2str(mode));
-            return rfic_new->initialize(dev);
+            CHECK_STATUS(rfic_new->initialize(dev));
+
+            /* Re-apply any correction tables to the fresh RFIC state */
+            corr_tbl_init(dev);
+            return 0;
 
         case BLADERF_RFIC_INIT_STATE_STANDBY:
             log_debug("%s: %s %s RFIC control\n", __FUNCTION__, "Restoring",
                       tuningmode2str(mode));
-            return rfic_new->initialize(dev);
+            CHECK_STATUS(rfic_new->initialize(dev));
+
+            corr_tbl_init(dev);
+            return 0;
 
         case BLADERF_RFIC_INIT_STATE_ON:
             log_debug("%s: %s %s RFIC control\n", __FUNCTION__, "Maintaining",
@@ -2448,78 +3508,695 @@ static int bladerf2_get_loopback(struct bladerf *dev, bladerf_loopback *mode)
         }
     });
 
-    *mode = BLADERF_LB_NONE;
+    *mode = BLADERF_LB_NONE;
+
+    return 0;
+}
+
+
+/******************************************************************************/
+/* Sample RX FPGA Mux */
+/******************************************************************************/
+
+static int bladerf2_set_rx_mux(struct bladerf *dev, bladerf_rx_mux mode)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    uint32_t rx_mux_val, config_gpio;
+
+    /* Validate desired mux mode */
+    switch (mode) {
+        case BLADERF_RX_MUX_BASEBAND:
+        case BLADERF_RX_MUX_12BIT_COUNTER:
+        case BLADERF_RX_MUX_32BIT_COUNTER:
+        case BLADERF_RX_MUX_DIGITAL_LOOPBACK:
+            rx_mux_val = ((uint32_t)mode) << BLADERF_GPIO_RX_MUX_SHIFT;
+            break;
+
+        default:
+            log_debug("Invalid RX mux mode setting passed to %s(): %d\n", mode,
+                      __FUNCTION__);
+            RETURN_INVAL_ARG("bladerf_rx_mux", mode, "is invalid");
+    }
+
+    CHECK_STATUS(dev->backend->config_gpio_read(dev, &config_gpio));
+
+    /* Clear out and assign the associated RX mux bits */
+    config_gpio &= ~BLADERF_GPIO_RX_MUX_MASK;
+    config_gpio |= rx_mux_val;
+
+    CHECK_STATUS(dev->backend->config_gpio_write(dev, config_gpio));
+
+    return 0;
+}
+
+static int bladerf2_get_rx_mux(struct bladerf *dev, bladerf_rx_mux *mode)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(mode);
+
+    bladerf_rx_mux val;
+    uint32_t config_gpio;
+
+    CHECK_STATUS(dev->backend->config_gpio_read(dev, &config_gpio));
+
+    /* Extract RX mux bits */
+    config_gpio &= BLADERF_GPIO_RX_MUX_MASK;
+    config_gpio >>= BLADERF_GPIO_RX_MUX_SHIFT;
+    val = config_gpio;
+
+    /* Ensure it's a valid/supported value */
+    switch (val) {
+        case BLADERF_RX_MUX_BASEBAND:
+        case BLADERF_RX_MUX_12BIT_COUNTER:
+        case BLADERF_RX_MUX_32BIT_COUNTER:
+        case BLADERF_RX_MUX_DIGITAL_LOOPBACK:
+            *mode = val;
+            break;
+
+        default:
+            *mode = BLADERF_RX_MUX_INVALID;
+            log_debug("Invalid rx mux mode %d read from config gpio\n", val);
+            return BLADERF_ERR_UNEXPECTED;
+    }
+
+    return 0;
+}
+
+
+/******************************************************************************/
+/* RX digital downconverter and TX digital upconverter */
+/******************************************************************************/
+
+/* NCO phase increments are in units of 2^-24 cycles per sample. The DDC and
+ * DUC control registers share the NIOS_PKT_8x32_RX_DDC_* layout. */
+#define NCO_PHASE_SCALE (INT64_C(1) << 24)
+
+/* Divide, rounding to the nearest integer */
+static inline int64_t div_round(int64_t num, int64_t den)
+{
+    return (num >= 0) ? (num + den / 2) / den : (num - den / 2) / den;
+}
+
+/* Encode a DDC/DUC configuration, rotating by `rotation` Hz at the sample
+ * rate of `ch`, into a control register value */
+static int nco_ctl_encode(struct bladerf *dev,
+                          bladerf_channel ch,
+                          int64_t rotation,
+                          unsigned int factor,
+                          unsigned int max_factor,
+                          uint32_t *value)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    bladerf_sample_rate rate;
+    unsigned int log2_factor;
+    int64_t dphase;
+
+    for (log2_factor = 0; (1u << log2_factor) < factor; log2_factor++) {
+        /* Find the smallest power of two >= factor */
+    }
+
+    if (factor == 0 || factor > max_factor || (1u << log2_factor) != factor) {
+        RETURN_INVAL_ARG("factor", factor, "is not a power of two from 1 to 64");
+    }
+
+    if (rotation == 0 && factor == 1) {
+        *value = 0;
+        return 0;
+    }
+
+    CHECK_STATUS(board_data->rfic->get_sample_rate(dev, ch, &rate));
+
+    if (rotation >= (int64_t)rate / 2 || rotation <= -((int64_t)rate / 2)) {
+        RETURN_INVAL_ARG("offset", rotation, "exceeds half of the sample rate");
+    }
+
+    dphase = div_round(rotation * NCO_PHASE_SCALE, rate);
+
+    *value = NIOS_PKT_8x32_RX_DDC_ENABLE |
+             (log2_factor << NIOS_PKT_8x32_RX_DDC_DECIM_SHIFT) |
+             ((uint32_t)dphase & NIOS_PKT_8x32_RX_DDC_DPHASE_MASK);
+
+    return 0;
+}
+
+/* Decode a DDC/DUC control register value into the rotation it applies, in
+ * Hz at the sample rate of `ch`, and its decimation/interpolation */
+static int nco_ctl_decode(struct bladerf *dev,
+                          bladerf_channel ch,
+                          uint32_t value,
+                          int64_t *rotation,
+                          unsigned int *factor)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    bladerf_sample_rate rate;
+    int64_t dphase;
+
+    if ((value & NIOS_PKT_8x32_RX_DDC_ENABLE) == 0) {
+        *rotation = 0;
+        *factor   = 1;
+        return 0;
+    }
+
+    CHECK_STATUS(board_data->rfic->get_sample_rate(dev, ch, &rate));
+
+    /* Sign-extend the 24-bit phase increment */
+    dphase = (int64_t)(value & NIOS_PKT_8x32_RX_DDC_DPHASE_MASK);
+    if (dphase & (NCO_PHASE_SCALE / 2)) {
+        dphase -= NCO_PHASE_SCALE;
+    }
+
+    *rotation = div_round(dphase * (int64_t)rate, NCO_PHASE_SCALE);
+    *factor   = 1u << ((value & NIOS_PKT_8x32_RX_DDC_DECIM_MASK) >>
+                       NIOS_PKT_8x32_RX_DDC_DECIM_SHIFT);
+
+    return 0;
+}
+
+static int bladerf2_set_rx_ddc(struct bladerf *dev,
+                               int64_t offset,
+                               unsigned int decimation)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    uint32_t value;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RX_DDC)) {
+        log_debug("FPGA %s does not support the RX downconverter.\n",
+                  board_data->fpga_version.describe);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    /* Rotate by -offset to move the signal of interest to 0 Hz */
+    CHECK_STATUS(nco_ctl_encode(dev, BLADERF_CHANNEL_RX(0), -offset,
+                                decimation, BLADERF_RX_DDC_MAX_DECIMATION,
+                                &value));
+
+    log_debug("%s: offset %" PRIi64 " Hz, decimation %u (0x%08x)\n",
+              __FUNCTION__, offset, decimation, value);
+
+    return dev->backend->rx_ddc_write(dev, value);
+}
+
+static int bladerf2_get_rx_ddc(struct bladerf *dev,
+                               int64_t *offset,
+                               unsigned int *decimation)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(offset);
+    NULL_CHECK(decimation);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    uint32_t value = 0;
+    int64_t rotation;
+
+    if (have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RX_DDC)) {
+        CHECK_STATUS(dev->backend->rx_ddc_read(dev, &value));
+    }
+
+    CHECK_STATUS(nco_ctl_decode(dev, BLADERF_CHANNEL_RX(0), value, &rotation,
+                                decimation));
+
+    *offset = -rotation;
+
+    return 0;
+}
+
+static int bladerf2_set_tx_duc(struct bladerf *dev,
+                               int64_t offset,
+                               unsigned int interpolation)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    uint32_t value;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_TX_DUC)) {
+        log_debug("FPGA %s does not support the TX upconverter.\n",
+                  board_data->fpga_version.describe);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    CHECK_STATUS(nco_ctl_encode(dev, BLADERF_CHANNEL_TX(0), offset,
+                                interpolation,
+                                BLADERF_TX_DUC_MAX_INTERPOLATION, &value));
+
+    log_debug("%s: offset %" PRIi64 " Hz, interpolation %u (0x%08x)\n",
+              __FUNCTION__, offset, interpolation, value);
+
+    return dev->backend->tx_duc_write(dev, value);
+}
+
+static int bladerf2_get_tx_duc(struct bladerf *dev,
+                               int64_t *offset,
+                               unsigned int *interpolation)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(offset);
+    NULL_CHECK(interpolation);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    uint32_t value = 0;
+
+    if (have_cap(board_data->capabilities, BLADERF_CAP_FPGA_TX_DUC)) {
+        CHECK_STATUS(dev->backend->tx_duc_read(dev, &value));
+    }
+
+    return nco_ctl_decode(dev, BLADERF_CHANNEL_TX(0), value, offset,
+                          interpolation);
+}
+
+
+/******************************************************************************/
+/* RX power detector */
+/******************************************************************************/
+
+/* Power of a full scale SC16 Q11 sample, (2^11)^2 */
+#define RX_POWER_FULL_SCALE 4194304.0
+
+static double rx_power_dbfs(uint32_t power)
+{
+    if (power == 0) {
+        return -INFINITY;
+    }
+
+    return 10.0 * log10((double)power / RX_POWER_FULL_SCALE);
+}
+
+static int bladerf2_set_rx_power_detector(struct bladerf *dev,
+                                          unsigned int block_length)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    uint32_t value = 0;
+    uint32_t log2_length;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RX_POWER)) {
+        log_debug("FPGA %s does not support the RX power detector.\n",
+                  board_data->fpga_version.describe);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (block_length != 0) {
+        if (block_length < BLADERF_RX_POWER_MIN_BLOCK_LENGTH ||
+            block_length > BLADERF_RX_POWER_MAX_BLOCK_LENGTH ||
+            (block_length & (block_length - 1)) != 0) {
+            RETURN_INVAL_ARG("block length", block_length,
+                             "not a power of two within range");
+        }
+
+        for (log2_length = 0; (1u << log2_length) < block_length;
+             log2_length++) {
+            /* Find log2(block_length) */
+        }
+
+        value = NIOS_PKT_8x32_RX_POWER_ENABLE |
+                (log2_length << NIOS_PKT_8x32_RX_POWER_LENGTH_SHIFT);
+    }
+
+    log_debug("%s: block length %u (0x%08x)\n", __FUNCTION__, block_length,
+              value);
+
+    return dev->backend->rx_power_write(
+        dev, NIOS_PKT_8x32_RX_POWER_ADDR_CONFIG, value);
+}
+
+static int bladerf2_get_rx_power_detector(struct bladerf *dev,
+                                          unsigned int *block_length)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(block_length);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    uint32_t value = 0;
+
+    if (have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RX_POWER)) {
+        CHECK_STATUS(dev->backend->rx_power_read(
+            dev, NIOS_PKT_8x32_RX_POWER_ADDR_CONFIG, &value));
+    }
+
+    if ((value & NIOS_PKT_8x32_RX_POWER_ENABLE) == 0) {
+        *block_length = 0;
+    } else {
+        *block_length = 1u << ((value & NIOS_PKT_8x32_RX_POWER_LENGTH_MASK) >>
+                               NIOS_PKT_8x32_RX_POWER_LENGTH_SHIFT);
+    }
+
+    return 0;
+}
+
+static int bladerf2_get_rx_power(struct bladerf *dev,
+                                 bladerf_channel ch,
+                                 struct bladerf_rx_power *power)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(power);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    unsigned int idx;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RX_POWER)) {
+        log_debug("FPGA %s does not support the RX power detector.\n",
+                  board_data->fpga_version.describe);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_RX(1)) {
+        RETURN_INVAL_ARG("channel", ch, "is not an RX channel");
+    }
+
+    idx = (ch == BLADERF_CHANNEL_RX(0)) ? 0 : 1;
+
+    /* Reading the block count latches the mean and peak of that block */
+    CHECK_STATUS(dev->backend->rx_power_read(
+        dev, NIOS_PKT_8x32_RX_POWER_ADDR_COUNT(idx), &power->blocks));
+    CHECK_STATUS(dev->backend->rx_power_read(
+        dev, NIOS_PKT_8x32_RX_POWER_ADDR_MEAN(idx), &power->mean));
+    CHECK_STATUS(dev->backend->rx_power_read(
+        dev, NIOS_PKT_8x32_RX_POWER_ADDR_PEAK(idx), &power->peak));
+
+    power->mean_dbfs = rx_power_dbfs(power->mean);
+    power->peak_dbfs = rx_power_dbfs(power->peak);
+
+    return 0;
+}
+
+/******************************************************************************/
+/* RX burst gate */
+/******************************************************************************/
+
+static int bladerf2_set_rx_burst_gate(struct bladerf *dev,
+                                      const struct bladerf_rx_burst_gate *gate)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(gate);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    uint32_t config = 0;
+    uint32_t threshold = 0;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RX_BURST_GATE)) {
+        log_debug("FPGA %s does not support the RX burst gate.\n",
+                  board_data->fpga_version.describe);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (gate->enable) {
+        if (gate->channel != BLADERF_CHANNEL_RX(0) &&
+            gate->channel != BLADERF_CHANNEL_RX(1)) {
+            RETURN_INVAL_ARG("channel", gate->channel,
+                             "is not an RX channel");
+        }
+
+        if (gate->threshold == 0) {
+            RETURN_INVAL_ARG("threshold", gate->threshold, "is zero");
+        }
+
+        if (gate->hangover < BLADERF_RX_BURST_GATE_MIN_HANGOVER ||
+            gate->hangover > BLADERF_RX_BURST_GATE_MAX_HANGOVER) {
+            RETURN_INVAL_ARG("hangover", gate->hangover, "is out of range");
+        }
+
+        if (gate->pretrigger > BLADERF_RX_BURST_GATE_MAX_PRETRIGGER) {
+            RETURN_INVAL_ARG("pretrigger", gate->pretrigger,
+                             "is out of range");
+        }
+
+        if (gate->averaging > BLADERF_RX_BURST_GATE_MAX_AVERAGING) {
+            RETURN_INVAL_ARG("averaging", gate->averaging, "is out of range");
+        }
+
+        config = NIOS_PKT_8x32_RX_BURST_ENABLE | gate->hangover |
+                 (gate->pretrigger << NIOS_PKT_8x32_RX_BURST_PRETRIGGER_SHIFT) |
+                 (gate->averaging << NIOS_PKT_8x32_RX_BURST_AVERAGING_SHIFT);
+        if (gate->channel == BLADERF_CHANNEL_RX(1)) {
+            config |= NIOS_PKT_8x32_RX_BURST_CHANNEL;
+        }
+
+        threshold = gate->threshold;
+    }
+
+    log_debug("%s: config 0x%08x, threshold %u\n", __FUNCTION__, config,
+              threshold);
+
+    /* Disable the gate while it is reconfigured, and only enable it once the
+     * threshold is in place */
+    CHECK_STATUS(dev->backend->rx_burst_write(
+        dev, NIOS_PKT_8x32_RX_BURST_ADDR_CONFIG, 0));
+    CHECK_STATUS(dev->backend->rx_burst_write(
+        dev, NIOS_PKT_8x32_RX_BURST_ADDR_THRESHOLD, threshold));
+
+    if (config != 0) {
+        CHECK_STATUS(dev->backend->rx_burst_write(
+            dev, NIOS_PKT_8x32_RX_BURST_ADDR_CONFIG, config));
+    }
+
+    return 0;
+}
+
+static int bladerf2_get_rx_burst_gate(struct bladerf *dev,
+                                      struct bladerf_rx_burst_gate *gate)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(gate);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    uint32_t config = 0;
+    uint32_t threshold = 0;
+
+    if (have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RX_BURST_GATE)) {
+        CHECK_STATUS(dev->backend->rx_burst_read(
+            dev, NIOS_PKT_8x32_RX_BURST_ADDR_CONFIG, &config));
+        CHECK_STATUS(dev->backend->rx_burst_read(
+            dev, NIOS_PKT_8x32_RX_BURST_ADDR_THRESHOLD, &threshold));
+    }
+
+    gate->enable     = (config & NIOS_PKT_8x32_RX_BURST_ENABLE) != 0;
+    gate->channel    = (config & NIOS_PKT_8x32_RX_BURST_CHANNEL)
+                           ? BLADERF_CHANNEL_RX(1)
+                           : BLADERF_CHANNEL_RX(0);
+    gate->threshold  = threshold;
+    gate->hangover   = config & NIOS_PKT_8x32_RX_BURST_HANGOVER_MASK;
+    gate->pretrigger = (config & NIOS_PKT_8x32_RX_BURST_PRETRIGGER_MASK) >>
+                       NIOS_PKT_8x32_RX_BURST_PRETRIGGER_SHIFT;
+    gate->averaging  = (config & NIOS_PKT_8x32_RX_BURST_AVERAGING_MASK) >>
+                       NIOS_PKT_8x32_RX_BURST_AVERAGING_SHIFT;
+
+    return 0;
+}
+
+/******************************************************************************/
+/* Sample FIFO levels */
+/******************************************************************************/
+
+static int bladerf2_get_fifo_levels(struct bladerf *dev,
+                                    struct bladerf_fifo_levels *levels,
+                                    bool reset_high_water)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(levels);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    uint32_t rx, tx, capacity;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_FIFO_LEVEL)) {
+        log_debug("FPGA %s does not report its FIFO levels.\n",
+                  board_data->fpga_version.describe);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    CHECK_STATUS(dev->backend->fifo_level_read(
+        dev, NIOS_PKT_8x32_FIFO_LEVEL_ADDR_RX, &rx));
+    CHECK_STATUS(dev->backend->fifo_level_read(
+        dev, NIOS_PKT_8x32_FIFO_LEVEL_ADDR_TX, &tx));
+    CHECK_STATUS(dev->backend->fifo_level_read(
+        dev, NIOS_PKT_8x32_FIFO_LEVEL_ADDR_CAPACITY, &capacity));
+
+    if (reset_high_water) {
+        CHECK_STATUS(dev->backend->fifo_level_write(
+            dev, NIOS_PKT_8x32_FIFO_LEVEL_ADDR_CLEAR, 0));
+    }
+
+    levels->rx_level      = rx & NIOS_PKT_8x32_FIFO_LEVEL_LEVEL_MASK;
+    levels->rx_high_water = (rx & NIOS_PKT_8x32_FIFO_LEVEL_HWM_MASK) >>
+                            NIOS_PKT_8x32_FIFO_LEVEL_HWM_SHIFT;
+    levels->rx_capacity   = capacity & NIOS_PKT_8x32_FIFO_LEVEL_RX_CAP_MASK;
+    levels->tx_level      = tx & NIOS_PKT_8x32_FIFO_LEVEL_LEVEL_MASK;
+    levels->tx_high_water = (tx & NIOS_PKT_8x32_FIFO_LEVEL_HWM_MASK) >>
+                            NIOS_PKT_8x32_FIFO_LEVEL_HWM_SHIFT;
+    levels->tx_capacity   = (capacity & NIOS_PKT_8x32_FIFO_LEVEL_TX_CAP_MASK) >>
+                            NIOS_PKT_8x32_FIFO_LEVEL_TX_CAP_SHIFT;
+
+    return 0;
+}
+
+/******************************************************************************/
+/* TX waveform loop */
+/******************************************************************************/
+
+static int bladerf2_tx_loop_load(struct bladerf *dev, unsigned int num_samples)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct stream_config const *config;
+    unsigned int num_chans, length;
+    uint32_t capacity;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_TX_LOOP)) {
+        log_debug("FPGA %s does not support the TX waveform loop.\n",
+                  board_data->fpga_version.describe);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        log_debug("The TX sync interface must be configured to load a "
+                  "waveform.\n");
+        return BLADERF_ERR_INVAL;
+    }
+
+    config = &board_data->sync[BLADERF_TX].stream_config;
+
+    /* The waveform is sent as a single burst, which requires metadata */
+    if (config->format != BLADERF_FORMAT_SC16_Q11_META &&
+        config->format != BLADERF_FORMAT_SC8_Q7_META) {
+        log_debug("Loading a waveform requires a sample format with "
+                  "metadata.\n");
+        return BLADERF_ERR_INVAL;
+    }
+
+    num_chans = (config->layout == BLADERF_TX_X2) ? 2 : 1;
+
+    if (num_samples == 0 || (num_samples % num_chans) != 0) {
+        log_debug("Invalid waveform length: %u samples.\n", num_samples);
+        return BLADERF_ERR_INVAL;
+    }
+
+    length = num_samples / num_chans;
+
+    CHECK_STATUS(dev->backend->tx_loop_read(
+        dev, NIOS_PKT_8x32_TX_LOOP_ADDR_CAPACITY, &capacity));
 
-    return 0;
-}
+    if (length > capacity) {
+        log_debug("Waveform of %u samples per channel exceeds the loop's "
+                  "%u.\n", length, capacity);
+        return BLADERF_ERR_INVAL;
+    }
 
+    CHECK_STATUS(dev->backend->tx_loop_write(
+        dev, NIOS_PKT_8x32_TX_LOOP_ADDR_LENGTH, length));
+    CHECK_STATUS(dev->backend->tx_loop_write(
+        dev, NIOS_PKT_8x32_TX_LOOP_ADDR_CONTROL,
+        NIOS_PKT_8x32_TX_LOOP_CMD_LOAD));
 
-/******************************************************************************/
-/* Sample RX FPGA Mux */
-/******************************************************************************/
+    return 0;
+}
 
-static int bladerf2_set_rx_mux(struct bladerf *dev, bladerf_rx_mux mode)
+static int bladerf2_tx_loop_start(struct bladerf *dev,
+                                  uint64_t start,
+                                  uint64_t stop)
 {
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-    uint32_t rx_mux_val, config_gpio;
+    struct bladerf2_board_data *board_data = dev->board_data;
+    uint32_t state;
 
-    /* Validate desired mux mode */
-    switch (mode) {
-        case BLADERF_RX_MUX_BASEBAND:
-        case BLADERF_RX_MUX_12BIT_COUNTER:
-        case BLADERF_RX_MUX_32BIT_COUNTER:
-        case BLADERF_RX_MUX_DIGITAL_LOOPBACK:
-            rx_mux_val = ((uint32_t)mode) << BLADERF_GPIO_RX_MUX_SHIFT;
-            break;
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_TX_LOOP)) {
+        log_debug("FPGA %s does not support the TX waveform loop.\n",
+                  board_data->fpga_version.describe);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
 
-        default:
-            log_debug("Invalid RX mux mode setting passed to %s(): %d\n", mode,
-                      __FUNCTION__);
-            RETURN_INVAL_ARG("bladerf_rx_mux", mode, "is invalid");
+    if (stop != 0 && stop <= start) {
+        return BLADERF_ERR_INVAL;
     }
 
-    CHECK_STATUS(dev->backend->config_gpio_read(dev, &config_gpio));
+    CHECK_STATUS(dev->backend->tx_loop_read(
+        dev, NIOS_PKT_8x32_TX_LOOP_ADDR_CONTROL, &state));
 
-    /* Clear out and assign the associated RX mux bits */
-    config_gpio &= ~BLADERF_GPIO_RX_MUX_MASK;
-    config_gpio |= rx_mux_val;
+    if (state != NIOS_PKT_8x32_TX_LOOP_STATE_LOADED) {
+        log_debug("No waveform is loaded, or it is already playing.\n");
+        return BLADERF_ERR_INVAL;
+    }
 
-    CHECK_STATUS(dev->backend->config_gpio_write(dev, config_gpio));
+    CHECK_STATUS(dev->backend->tx_loop_write(
+        dev, NIOS_PKT_8x32_TX_LOOP_ADDR_START_LO, (uint32_t)start));
+    CHECK_STATUS(dev->backend->tx_loop_write(
+        dev, NIOS_PKT_8x32_TX_LOOP_ADDR_START_HI, (uint32_t)(start >> 32)));
+    CHECK_STATUS(dev->backend->tx_loop_write(
+        dev, NIOS_PKT_8x32_TX_LOOP_ADDR_STOP_LO, (uint32_t)stop));
+    CHECK_STATUS(dev->backend->tx_loop_write(
+        dev, NIOS_PKT_8x32_TX_LOOP_ADDR_STOP_HI, (uint32_t)(stop >> 32)));
+    CHECK_STATUS(dev->backend->tx_loop_write(
+        dev, NIOS_PKT_8x32_TX_LOOP_ADDR_CONTROL,
+        NIOS_PKT_8x32_TX_LOOP_CMD_PLAY));
 
     return 0;
 }
 
-static int bladerf2_get_rx_mux(struct bladerf *dev, bladerf_rx_mux *mode)
+static int bladerf2_tx_loop_stop(struct bladerf *dev, uint64_t timestamp)
 {
     CHECK_BOARD_STATE(STATE_INITIALIZED);
-    NULL_CHECK(mode);
 
-    bladerf_rx_mux val;
-    uint32_t config_gpio;
+    struct bladerf2_board_data *board_data = dev->board_data;
 
-    CHECK_STATUS(dev->backend->config_gpio_read(dev, &config_gpio));
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_TX_LOOP)) {
+        log_debug("FPGA %s does not support the TX waveform loop.\n",
+                  board_data->fpga_version.describe);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
 
-    /* Extract RX mux bits */
-    config_gpio &= BLADERF_GPIO_RX_MUX_MASK;
-    config_gpio >>= BLADERF_GPIO_RX_MUX_SHIFT;
-    val = config_gpio;
+    if (timestamp == 0) {
+        return dev->backend->tx_loop_write(dev,
+                                           NIOS_PKT_8x32_TX_LOOP_ADDR_CONTROL,
+                                           NIOS_PKT_8x32_TX_LOOP_CMD_STOP);
+    }
 
-    /* Ensure it's a valid/supported value */
-    switch (val) {
-        case BLADERF_RX_MUX_BASEBAND:
-        case BLADERF_RX_MUX_12BIT_COUNTER:
-        case BLADERF_RX_MUX_32BIT_COUNTER:
-        case BLADERF_RX_MUX_DIGITAL_LOOPBACK:
-            *mode = val;
-            break;
+    CHECK_STATUS(dev->backend->tx_loop_write(
+        dev, NIOS_PKT_8x32_TX_LOOP_ADDR_STOP_LO, (uint32_t)timestamp));
+    CHECK_STATUS(dev->backend->tx_loop_write(
+        dev, NIOS_PKT_8x32_TX_LOOP_ADDR_STOP_HI,
+        (uint32_t)(timestamp >> 32)));
 
-        default:
-            *mode = BLADERF_RX_MUX_INVALID;
-            log_debug("Invalid rx mux mode %d read from config gpio\n", val);
-            return BLADERF_ERR_UNEXPECTED;
+    return 0;
+}
+
+static int bladerf2_get_tx_loop_status(struct bladerf *dev,
+                                       struct bladerf_tx_loop_status *status)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(status);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    uint32_t state, length, capacity, loops;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_TX_LOOP)) {
+        log_debug("FPGA %s does not support the TX waveform loop.\n",
+                  board_data->fpga_version.describe);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    CHECK_STATUS(dev->backend->tx_loop_read(
+        dev, NIOS_PKT_8x32_TX_LOOP_ADDR_CONTROL, &state));
+    CHECK_STATUS(dev->backend->tx_loop_read(
+        dev, NIOS_PKT_8x32_TX_LOOP_ADDR_LENGTH, &length));
+    CHECK_STATUS(dev->backend->tx_loop_read(
+        dev, NIOS_PKT_8x32_TX_LOOP_ADDR_CAPACITY, &capacity));
+    CHECK_STATUS(dev->backend->tx_loop_read(
+        dev, NIOS_PKT_8x32_TX_LOOP_ADDR_LOOPS, &loops));
+
+    if (state > NIOS_PKT_8x32_TX_LOOP_STATE_PLAYING) {
+        log_debug("Unexpected TX loop state: %u\n", state);
+        return BLADERF_ERR_UNEXPECTED;
     }
 
+    status->state    = (bladerf_tx_loop_state)state;
+    status->length   = length;
+    status->capacity = capacity;
+    status->loops    = loops;
+
     return 0;
 }
 
@@ -2820,6 +4497,7 @@ struct board_fns const bladerf2_board_fns = {
     FIELD_INIT(.get_sample_rate, bladerf2_get_sample_rate),
     FIELD_INIT(.get_sample_rate_range, bladerf2_get_sample_rate_range),
     FIELD_INIT(.get_rational_sample_rate, bladerf2_get_rational_sample_rate),
+    FIELD_INIT(.switch_sample_rate, bladerf2_switch_sample_rate),
     FIELD_INIT(.set_bandwidth, bladerf2_set_bandwidth),
     FIELD_INIT(.get_bandwidth, bladerf2_get_bandwidth),
     FIELD_INIT(.get_bandwidth_range, bladerf2_get_bandwidth_range),
@@ -2830,16 +4508,27 @@ struct board_fns const bladerf2_board_fns = {
     FIELD_INIT(.set_rf_port, bladerf2_set_rf_port),
     FIELD_INIT(.get_rf_port, bladerf2_get_rf_port),
     FIELD_INIT(.get_rf_ports, bladerf2_get_rf_ports),
+    FIELD_INIT(.apply_config, bladerf2_apply_config),
     FIELD_INIT(.get_quick_tune, bladerf2_get_quick_tune),
     FIELD_INIT(.schedule_retune, bladerf2_schedule_retune),
     FIELD_INIT(.cancel_scheduled_retunes, bladerf2_cancel_scheduled_retunes),
+    FIELD_INIT(.cancel_scheduled_retune, bladerf2_cancel_scheduled_retune),
+    FIELD_INIT(.replace_scheduled_retune, bladerf2_replace_scheduled_retune),
+    FIELD_INIT(.schedule_retune_pair, bladerf2_schedule_retune_pair),
+    FIELD_INIT(.get_retune_stats, bladerf2_get_retune_stats),
+    FIELD_INIT(.schedule_gain, bladerf2_schedule_gain),
     FIELD_INIT(.get_correction, bladerf2_get_correction),
     FIELD_INIT(.set_correction, bladerf2_set_correction),
+    FIELD_INIT(.get_temperature, bladerf2_get_temperature),
+    FIELD_INIT(.read_telemetry, bladerf2_read_telemetry),
     FIELD_INIT(.trigger_init, bladerf2_trigger_init),
     FIELD_INIT(.trigger_arm, bladerf2_trigger_arm),
     FIELD_INIT(.trigger_fire, bladerf2_trigger_fire),
     FIELD_INIT(.trigger_state, bladerf2_trigger_state),
+    FIELD_INIT(.trigger_fire_at, bladerf2_trigger_fire_at),
+    FIELD_INIT(.trigger_fire_time, bladerf2_trigger_fire_time),
     FIELD_INIT(.enable_module, bladerf2_enable_module),
+    FIELD_INIT(.standby_module, bladerf2_standby_module),
     FIELD_INIT(.init_stream, bladerf2_init_stream),
     FIELD_INIT(.stream, bladerf2_stream),
     FIELD_INIT(.submit_stream_buffer, bladerf2_submit_stream_buffer),
@@ -2847,9 +4536,29 @@ struct board_fns const bladerf2_board_fns = {
     FIELD_INIT(.set_stream_timeout, bladerf2_set_stream_timeout),
     FIELD_INIT(.get_stream_timeout, bladerf2_get_stream_timeout),
     FIELD_INIT(.sync_config, bladerf2_sync_config),
+    FIELD_INIT(.sync_start, bladerf2_sync_start),
     FIELD_INIT(.sync_tx, bladerf2_sync_tx),
+    FIELD_INIT(.sync_tx_acquire, bladerf2_sync_tx_acquire),
+    FIELD_INIT(.sync_tx_commit, bladerf2_sync_tx_commit),
     FIELD_INIT(.sync_rx, bladerf2_sync_rx),
+    FIELD_INIT(.sync_rx_planar, bladerf2_sync_rx_planar),
+    FIELD_INIT(.sync_rx_channel, bladerf2_sync_rx_channel),
+    FIELD_INIT(.sync_rx_acquire, bladerf2_sync_rx_acquire),
+    FIELD_INIT(.sync_rx_release, bladerf2_sync_rx_release),
+    FIELD_INIT(.rx_tap_acquire, bladerf2_rx_tap_acquire),
+    FIELD_INIT(.rx_tap_release, bladerf2_rx_tap_release),
+    FIELD_INIT(.sync_rx_deadline, bladerf2_sync_rx_deadline),
+    FIELD_INIT(.sync_tx_deadline, bladerf2_sync_tx_deadline),
+    FIELD_INIT(.sync_rxv, bladerf2_sync_rxv),
+    FIELD_INIT(.sync_txv, bladerf2_sync_txv),
+    FIELD_INIT(.sync_rxtx, bladerf2_sync_rxtx),
+    FIELD_INIT(.get_sync_stats, bladerf2_get_sync_stats),
+    FIELD_INIT(.get_sync_latency, bladerf2_get_sync_latency),
+    FIELD_INIT(.get_sync_poll_handle, bladerf2_get_sync_poll_handle),
+    FIELD_INIT(.read_rx_capture, bladerf2_read_rx_capture),
+    FIELD_INIT(.get_rx_capture_range, bladerf2_get_rx_capture_range),
     FIELD_INIT(.get_timestamp, bladerf2_get_timestamp),
+    FIELD_INIT(.get_timestamp_latch, bladerf2_get_timestamp_latch),
     FIELD_INIT(.load_fpga, bladerf2_load_fpga),
     FIELD_INIT(.flash_fpga, bladerf2_flash_fpga),
     FIELD_INIT(.erase_stored_fpga, bladerf2_erase_stored_fpga),
@@ -2862,6 +4571,20 @@ struct board_fns const bladerf2_board_fns = {
     FIELD_INIT(.get_loopback, bladerf2_get_loopback),
     FIELD_INIT(.get_rx_mux, bladerf2_get_rx_mux),
     FIELD_INIT(.set_rx_mux, bladerf2_set_rx_mux),
+    FIELD_INIT(.set_rx_ddc, bladerf2_set_rx_ddc),
+    FIELD_INIT(.get_rx_ddc, bladerf2_get_rx_ddc),
+    FIELD_INIT(.set_tx_duc, bladerf2_set_tx_duc),
+    FIELD_INIT(.get_tx_duc, bladerf2_get_tx_duc),
+    FIELD_INIT(.set_rx_power_detector, bladerf2_set_rx_power_detector),
+    FIELD_INIT(.get_rx_power_detector, bladerf2_get_rx_power_detector),
+    FIELD_INIT(.get_rx_power, bladerf2_get_rx_power),
+    FIELD_INIT(.set_rx_burst_gate, bladerf2_set_rx_burst_gate),
+    FIELD_INIT(.get_rx_burst_gate, bladerf2_get_rx_burst_gate),
+    FIELD_INIT(.get_fifo_levels, bladerf2_get_fifo_levels),
+    FIELD_INIT(.tx_loop_load, bladerf2_tx_loop_load),
+    FIELD_INIT(.tx_loop_start, bladerf2_tx_loop_start),
+    FIELD_INIT(.tx_loop_stop, bladerf2_tx_loop_stop),
+    FIELD_INIT(.get_tx_loop_status, bladerf2_get_tx_loop_status),
     FIELD_INIT(.set_vctcxo_tamer_mode, bladerf2_set_vctcxo_tamer_mode),
     FIELD_INIT(.get_vctcxo_tamer_mode, bladerf2_get_vctcxo_tamer_mode),
     FIELD_INIT(.get_vctcxo_trim, bladerf2_get_vctcxo_trim),
@@ -2945,6 +4668,286 @@ int bladerf_set_bias_tee(struct bladerf *dev, bladerf_channel ch, bool enable)
 }
 
 
+/******************************************************************************/
+/* Quick tune cache */
+/******************************************************************************/
+
+int bladerf_get_cached_quick_tune(struct bladerf *dev,
+                                  bladerf_channel ch,
+                                  bladerf_frequency frequency,
+                                  struct bladerf_quick_tune *quick_tune)
+{
+    CHECK_BOARD_IS_BLADERF2(dev);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(quick_tune);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_RX(1) &&
+        ch != BLADERF_CHANNEL_TX(0) && ch != BLADERF_CHANNEL_TX(1)) {
+        RETURN_INVAL_ARG("channel", ch, "is not valid");
+    }
+
+    WITH_MUTEX(&dev->lock, {
+        if (board_data->fastlock_cache == NULL) {
+            MUTEX_UNLOCK(&dev->lock);
+            return BLADERF_ERR_UNSUPPORTED;
+        }
+
+        if (!fastlock_cache_lookup(dev, ch, frequency, quick_tune)) {
+            MUTEX_UNLOCK(&dev->lock);
+            return BLADERF_ERR_RANGE;
+        }
+
+        board_data->rfic_reset_on_close = true;
+    });
+
+    return 0;
+}
+
+
+/******************************************************************************/
+/* Correction tables */
+/******************************************************************************/
+
+int bladerf_load_correction_table(struct bladerf *dev,
+                                  bladerf_direction dir,
+                                  const char *filename)
+{
+    CHECK_BOARD_IS_BLADERF2(dev);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    int status;
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        RETURN_INVAL_ARG("direction", dir, "is not valid");
+    }
+
+    WITH_MUTEX(&dev->lock, { status = corr_tbl_load(dev, dir, filename); });
+
+    return status;
+}
+
+
+/******************************************************************************/
+/* Scheduled parameter changes */
+/******************************************************************************/
+
+static int _schedule_param(struct bladerf *dev,
+                           bladerf_channel ch,
+                           bladerf_timestamp timestamp,
+                           uint8_t type,
+                           uint8_t cmd,
+                           uint32_t value)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!have_cap(board_data->capabilities,
+                  BLADERF_CAP_FPGA_SCHEDULED_PARAMS)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "scheduled parameter changes.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (timestamp == NIOS_PKT_RETUNE2_CLEAR_QUEUE) {
+        RETURN_INVAL("timestamp", "is reserved");
+    }
+
+    return dev->backend->retune2_param(dev, ch, timestamp, type, cmd, value);
+}
+
+/* RFIC commands are executed by the Nios, which requires it to be in
+ * control of the RFIC */
+#define CHECK_SCHEDULED_RFIC_CMD(_dev)                                   \
+    IF_COMMAND_MODE(_dev, RFIC_COMMAND_HOST, {                           \
+        log_debug("%s: host command mode not supported\n", __FUNCTION__); \
+        return BLADERF_ERR_UNSUPPORTED;                                  \
+    })
+
+int bladerf_schedule_bandwidth(struct bladerf *dev,
+                               bladerf_channel ch,
+                               bladerf_timestamp timestamp,
+                               bladerf_bandwidth bandwidth)
+{
+    CHECK_BOARD_IS_BLADERF2(dev);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    CHECK_SCHEDULED_RFIC_CMD(dev);
+
+    struct bladerf_range const *range = NULL;
+    int status;
+
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_RX(1) &&
+        ch != BLADERF_CHANNEL_TX(0) && ch != BLADERF_CHANNEL_TX(1)) {
+        RETURN_INVAL_ARG("channel", ch, "is not valid");
+    }
+
+    WITH_MUTEX(&dev->lock, {
+        CHECK_STATUS_LOCKED(dev->board->get_bandwidth_range(dev, ch, &range));
+
+        if (!is_within_range(range, bandwidth)) {
+            MUTEX_UNLOCK(&dev->lock);
+            return BLADERF_ERR_RANGE;
+        }
+
+        status = _schedule_param(dev, ch, timestamp,
+                                 NIOS_PKT_RETUNE2_TYPE_RFIC_CMD,
+                                 BLADERF_RFIC_COMMAND_BANDWIDTH, bandwidth);
+    });
+
+    return status;
+}
+
+int bladerf_schedule_txmute(struct bladerf *dev,
+                            bladerf_channel ch,
+                            bladerf_timestamp timestamp,
+                            bool state)
+{
+    CHECK_BOARD_IS_BLADERF2(dev);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    CHECK_SCHEDULED_RFIC_CMD(dev);
+
+    int status;
+
+    if (ch != BLADERF_CHANNEL_TX(0) && ch != BLADERF_CHANNEL_TX(1)) {
+        RETURN_INVAL_ARG("channel", ch, "is not a TX channel");
+    }
+
+    WITH_MUTEX(&dev->lock, {
+        status = _schedule_param(dev, ch, timestamp,
+                                 NIOS_PKT_RETUNE2_TYPE_RFIC_CMD,
+                                 BLADERF_RFIC_COMMAND_TXMUTE, state ? 1 : 0);
+    });
+
+    return status;
+}
+
+int bladerf_schedule_rf_port(struct bladerf *dev,
+                             bladerf_channel ch,
+                             bladerf_timestamp timestamp,
+                             const char *port)
+{
+    CHECK_BOARD_IS_BLADERF2(dev);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(port);
+
+    struct bladerf_rfic_port_name_map const *pm = NULL;
+    struct band_port_map const *bpm             = NULL;
+    unsigned int pm_len                         = 0;
+    unsigned int bpm_len                        = 0;
+    uint32_t port_id                            = UINT32_MAX;
+    uint32_t value;
+    int status;
+    size_t i;
+
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_RX(1) &&
+        ch != BLADERF_CHANNEL_TX(0) && ch != BLADERF_CHANNEL_TX(1)) {
+        RETURN_INVAL_ARG("channel", ch, "is not valid");
+    }
+
+    if (BLADERF_CHANNEL_IS_TX(ch)) {
+        pm      = bladerf2_tx_port_map;
+        pm_len  = ARRAY_SIZE(bladerf2_tx_port_map);
+        bpm     = bladerf2_tx_band_port_map;
+        bpm_len = ARRAY_SIZE(bladerf2_tx_band_port_map);
+    } else {
+        pm      = bladerf2_rx_port_map;
+        pm_len  = ARRAY_SIZE(bladerf2_rx_port_map);
+        bpm     = bladerf2_rx_band_port_map;
+        bpm_len = ARRAY_SIZE(bladerf2_rx_band_port_map);
+    }
+
+    for (i = 0; i < pm_len; i++) {
+        if (strcmp(pm[i].name, port) == 0) {
+            port_id = pm[i].id;
+            break;
+        }
+    }
+
+    if (UINT32_MAX == port_id) {
+        RETURN_INVAL("port", "is not valid");
+    }
+
+    /* Encode the port as in a quick tune's port field */
+    if (BLADERF_CHANNEL_IS_TX(ch)) {
+        value = (port_id << 6);
+    } else if (port_id < AD936X_A_N) {
+        value = NIOS_PKT_RETUNE2_PORT_IS_RX_MASK | (3 << (port_id << 1));
+    } else if (port_id <= AD936X_C_P) {
+        value = NIOS_PKT_RETUNE2_PORT_IS_RX_MASK | (1 << (port_id - 3));
+    } else {
+        RETURN_INVAL("port", "cannot be scheduled");
+    }
+
+    /* Follow the port with the RF switches, if it is used by a band */
+    for (i = 0; i < bpm_len; i++) {
+        if (bpm[i].band != BAND_SHUTDOWN && bpm[i].rfic_port == port_id) {
+            uint32_t spdt = BLADERF_CHANNEL_IS_TX(ch)
+                                ? (bpm[i].spdt << 6) | (bpm[i].spdt << 4)
+                                : (bpm[i].spdt << 2) | (bpm[i].spdt);
+
+            value |= (spdt << NIOS_PKT_RETUNE2_RFPORT_SPDT_SHIFT) |
+                     NIOS_PKT_RETUNE2_RFPORT_SPDT_VALID;
+            break;
+        }
+    }
+
+    WITH_MUTEX(&dev->lock, {
+        status = _schedule_param(dev, ch, timestamp,
+                                 NIOS_PKT_RETUNE2_TYPE_RFPORT, 0, value);
+    });
+
+    return status;
+}
+
+int bladerf_schedule_rffe_control(struct bladerf *dev,
+                                  bladerf_channel ch,
+                                  bladerf_timestamp timestamp,
+                                  uint32_t mask,
+                                  uint32_t value)
+{
+    CHECK_BOARD_IS_BLADERF2(dev);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    uint32_t const valid = BLADERF_RFFE_CONTROL_ENABLE |
+                           BLADERF_RFFE_CONTROL_TXNRX |
+                           BLADERF_RFFE_CONTROL_RX_BIAS_EN |
+                           BLADERF_RFFE_CONTROL_TX_BIAS_EN;
+    int status;
+
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_RX(1) &&
+        ch != BLADERF_CHANNEL_TX(0) && ch != BLADERF_CHANNEL_TX(1)) {
+        RETURN_INVAL_ARG("channel", ch, "is not valid");
+    }
+
+    if (0 == mask || (mask & ~valid) != 0) {
+        RETURN_INVAL("mask", "contains bits that may not be scheduled");
+    }
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_SCHEDULED_RFFE)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "scheduled RFFE control changes.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    WITH_MUTEX(&dev->lock, {
+        status = _schedule_param(
+            dev, ch, timestamp, NIOS_PKT_RETUNE2_TYPE_RFFE, 0,
+            (mask << NIOS_PKT_RETUNE2_RFFE_MASK_SHIFT) | (value & mask));
+    });
+
+    return status;
+}
+
+
 /******************************************************************************/
 /* Low level RFIC Accessors */
 /******************************************************************************/
@@ -2978,6 +4981,8 @@ int bladerf_set_rfic_register(struct bladerf *dev,
     CHECK_BOARD_STATE(STATE_FPGA_LOADED);
 
     WITH_MUTEX(&dev->lock, {
+        state_cache_flush(&dev->state_cache);
+
         uint64_t data = (((uint64_t)val) << 56);
 
         address |= (AD936X_WRITE | AD936X_CNT(1));
@@ -2994,17 +4999,11 @@ int bladerf_get_rfic_temperature(struct bladerf *dev, float *val)
     CHECK_BOARD_STATE(STATE_FPGA_LOADED);
     NULL_CHECK(val);
 
-    struct bladerf2_board_data *board_data = dev->board_data;
-    struct ad9361_rf_phy *phy              = board_data->phy;
-
-    IF_COMMAND_MODE(dev, RFIC_COMMAND_FPGA, {
-        log_debug("%s: FPGA command mode not supported\n", __FUNCTION__);
-        return BLADERF_ERR_UNSUPPORTED;
-    });
+    int status;
 
-    WITH_MUTEX(&dev->lock, { *val = ad9361_get_temp(phy) / 1000.0F; });
+    WITH_MUTEX(&dev->lock, { status = bladerf2_get_temperature(dev, val); });
 
-    return 0;
+    return status;
 }
 
 int bladerf_get_rfic_rssi(struct bladerf *dev,
@@ -3073,6 +5072,8 @@ int bladerf_set_rfic_rx_fir(struct bladerf *dev, bladerf_rfic_rxfir rxfir)
     bladerf_channel const ch               = BLADERF_CHANNEL_RX(0);
 
     WITH_MUTEX(&dev->lock, {
+        state_cache_flush(&dev->state_cache);
+
         /* Verify that sample rate is not too low */
         if (rxfir != BLADERF_RFIC_RXFIR_DEC4) {
             bladerf_sample_rate sr;
@@ -3121,6 +5122,8 @@ int bladerf_set_rfic_tx_fir(struct bladerf *dev, bladerf_rfic_txfir txfir)
     bladerf_channel const ch               = BLADERF_CHANNEL_TX(0);
 
     WITH_MUTEX(&dev->lock, {
+        state_cache_flush(&dev->state_cache);
+
         /* Verify that sample rate is not too low */
         if (txfir != BLADERF_RFIC_TXFIR_INT4) {
             bladerf_sample_rate sr;
@@ -58,6 +58,16 @@ uint64_t bladerf2_get_fw_capabilities(const struct bladerf_version *fw_version)
         capabilities |= BLADERF_CAP_FW_SHORT_PACKET;
     }
 
+    if (version_fields_greater_or_equal(fw_version, 2, 5, 0)) {
+        capabilities |= BLADERF_CAP_FW_FLASH_BULK;
+        capabilities |= BLADERF_CAP_FW_FLASH_HASH;
+        capabilities |= BLADERF_CAP_FW_FPGA_COMPRESSED;
+        capabilities |= BLADERF_CAP_FW_FPGA_CONF_WAIT;
+        capabilities |= BLADERF_CAP_FW_FPGA_HASH;
+        capabilities |= BLADERF_CAP_FW_SAMPLE_DMA;
+        capabilities |= BLADERF_CAP_FW_STATS;
+    }
+
     return capabilities;
 }
 
@@ -98,5 +108,25 @@ uint64_t bladerf2_get_fpga_capabilities(
         capabilities |= BLADERF_CAP_FPGA_PACKET_META;
     }
 
+    if (version_fields_greater_or_equal(fpga_version, 0, 13, 0)) {
+        capabilities |= BLADERF_CAP_FPGA_8BIT_SAMPLES;
+        capabilities |= BLADERF_CAP_FPGA_RFIC_WAIT;
+        capabilities |= BLADERF_CAP_FPGA_FASTLOCK_ACCESS;
+        capabilities |= BLADERF_CAP_FPGA_SCHEDULED_PARAMS;
+        capabilities |= BLADERF_CAP_FPGA_RETUNE_STATS;
+        capabilities |= BLADERF_CAP_FPGA_RETUNE_EDIT;
+        capabilities |= BLADERF_CAP_FPGA_RETUNE_PAIR;
+        capabilities |= BLADERF_CAP_FPGA_TS_LATCH;
+        capabilities |= BLADERF_CAP_FPGA_RX_DDC;
+        capabilities |= BLADERF_CAP_FPGA_TX_DUC;
+        capabilities |= BLADERF_CAP_FPGA_RX_POWER;
+        capabilities |= BLADERF_CAP_FPGA_RX_BURST_GATE;
+        capabilities |= BLADERF_CAP_FPGA_FIFO_LEVEL;
+        capabilities |= BLADERF_CAP_FPGA_16x8_BATCH;
+        capabilities |= BLADERF_CAP_FPGA_SCHEDULED_RFFE;
+        capabilities |= BLADERF_CAP_FPGA_TX_LOOP;
+        capabilities |= BLADERF_CAP_FPGA_TRIGGER_TIME;
+    }
+
     return capabilities;
 }
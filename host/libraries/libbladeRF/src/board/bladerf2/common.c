@@ -48,10 +48,14 @@ static inline int requires_timestamps(bladerf_format format, bool *required)
     switch (format) {
         case BLADERF_FORMAT_SC16_Q11_META:
         case BLADERF_FORMAT_PACKET_META:
+        case BLADERF_FORMAT_CF32_META:
+        case BLADERF_FORMAT_SC8_Q7_META:
             *required = true;
             break;
 
         case BLADERF_FORMAT_SC16_Q11:
+        case BLADERF_FORMAT_CF32:
+        case BLADERF_FORMAT_SC8_Q7:
             *required = false;
             break;
 
@@ -62,6 +66,12 @@ static inline int requires_timestamps(bladerf_format format, bool *required)
     return 0;
 }
 
+static inline bool is_8bit_format(bladerf_format format)
+{
+    return (format == BLADERF_FORMAT_SC8_Q7 ||
+            format == BLADERF_FORMAT_SC8_Q7_META);
+}
+
 int perform_format_config(struct bladerf *dev,
                           bladerf_direction dir,
                           bladerf_format format)
@@ -101,6 +111,24 @@ int perform_format_config(struct bladerf *dev,
         return BLADERF_ERR_INVAL;
     }
 
+    if (is_8bit_format(format)) {
+        if (!have_cap(board_data->capabilities,
+                      BLADERF_CAP_FPGA_8BIT_SAMPLES)) {
+            log_error("8-bit sample formats require FPGA v0.13.0 or later.\n");
+            return BLADERF_ERR_UPDATE_FPGA;
+        }
+    }
+
+    /* The FPGA's sample width is shared by both directions */
+    if ((status == 0) &&
+        (is_8bit_format(board_data->module_format[other]) !=
+         is_8bit_format(format))) {
+        log_debug("Sample width conflict detected: RX=%d, TX=%d\n",
+                  board_data->module_format[BLADERF_RX],
+                  board_data->module_format[BLADERF_TX]);
+        return BLADERF_ERR_INVAL;
+    }
+
     CHECK_STATUS(dev->backend->config_gpio_read(dev, &gpio_val));
 
     if (use_timestamps) {
@@ -115,6 +143,12 @@ int perform_format_config(struct bladerf *dev,
        gpio_val &= ~BLADERF_GPIO_PACKET;
     }
 
+    if (is_8bit_format(format)) {
+        gpio_val |= BLADERF_GPIO_8BIT_MODE;
+    } else {
+        gpio_val &= ~BLADERF_GPIO_8BIT_MODE;
+    }
+
     CHECK_STATUS(dev->backend->config_gpio_write(dev, gpio_val));
 
     board_data->module_format[dir] = format;
@@ -374,8 +408,20 @@ int get_gain_offset(struct bladerf *dev, bladerf_channel ch, float *offset)
     CHECK_BOARD_STATE(STATE_INITIALIZED);
     NULL_CHECK(offset);
 
+    bladerf_frequency frequency = 0;
+
+    CHECK_STATUS(dev->board->get_frequency(dev, ch, &frequency));
+
+    return get_gain_offset_at(ch, frequency, offset);
+}
+
+int get_gain_offset_at(bladerf_channel ch,
+                       bladerf_frequency frequency,
+                       float *offset)
+{
+    NULL_CHECK(offset);
+
     struct bladerf_gain_range const *ranges = NULL;
-    bladerf_frequency frequency             = 0;
     size_t i, ranges_len;
 
     if (BLADERF_CHANNEL_IS_TX(ch)) {
@@ -386,8 +432,6 @@ int get_gain_offset(struct bladerf *dev, bladerf_channel ch, float *offset)
         ranges_len = ARRAY_SIZE(bladerf2_rx_gain_ranges);
     }
 
-    CHECK_STATUS(dev->board->get_frequency(dev, ch, &frequency));
-
     for (i = 0; i < ranges_len; ++i) {
         struct bladerf_gain_range const *r = &(ranges[i]);
         struct bladerf_range const *rfreq  = &(r->frequency);
@@ -30,6 +30,8 @@
 #include "helpers/version.h"
 #include "streaming/sync.h"
 
+#include "rfic_spi_batch.h"
+
 
 /******************************************************************************/
 /* Types */
@@ -124,6 +126,11 @@ struct controller_fns {
                                   bladerf_channel ch,
                                   uint32_t profile);
 
+    /* Between batch_begin() and batch_end(), commands may be queued without
+     * waiting for each to complete. batch_end() waits for all of them. */
+    int (*batch_begin)(struct bladerf *dev);
+    int (*batch_end)(struct bladerf *dev);
+
     enum bladerf2_rfic_command_mode const command_mode;
 };
 
@@ -174,13 +181,46 @@ struct bladerf2_board_data {
     uint16_t quick_tune_tx_profile;
     uint16_t quick_tune_rx_profile;
 
+    /* Quick tune profiles persisted across sessions (see fastlock_cache.h) */
+    struct fastlock_cache *fastlock_cache;
+
+    /* RFIC snapshot being replayed by ad9361_init() (see rfic_snapshot.h) */
+    struct rfic_snapshot *rfic_snapshot;
+
+    /* AD9361 SPI writes queued by a host-controlled RFIC
+     * (see rfic_spi_batch.h) */
+    struct rfic_spi_batch rfic_spi_batch;
+
+    /* DC offset and quadrature correction tables, per direction
+     * (see corr_tbl.h) */
+    struct corr_tbl *corr_tbl[2];
+
+    /* Nios profile held in each RFFE fast lock slot, per direction */
+    struct bladerf2_fastlock_slots {
+        uint16_t owner[NUM_RFFE_FASTLOCK_PROFILES];
+        bool loaded[NUM_RFFE_FASTLOCK_PROFILES];
+        uint64_t last_use[NUM_RFFE_FASTLOCK_PROFILES];
+        uint64_t uses;
+    } fastlock_slots[2];
+
     /* RFIC backend command handling */
     struct controller_fns const *rfic;
 
+    /* Channels in warm standby (see bladerf_standby_module()), as a bitmask
+     * of (1 << channel), and whether each direction's data path is stopped
+     * because all of its enabled channels are in standby */
+    uint32_t standby;
+    bool standby_gated[2];
+
     /* RFIC FIR Filter status */
     bladerf_rfic_rxfir rxfir;
     bladerf_rfic_txfir txfir;
 
+    /* RFIC command batching state */
+    bool rfic_batch;
+    unsigned int rfic_batch_pending;
+    unsigned int rfic_queue_max;
+
     /* If true, RFIC control will be fully de-initialized on close, instead of
      * just put into a standby state. */
     bool rfic_reset_on_close;
@@ -189,6 +229,8 @@ struct bladerf2_board_data {
 struct bladerf_rfic_status_register {
     bool rfic_initialized;
     size_t write_queue_length;
+    size_t write_queue_max;        /* 0 if not reported by the FPGA */
+    size_t write_queue_high_water;
 };
 
 
@@ -469,4 +511,8 @@ bool does_rffe_dir_have_enabled_ch(uint32_t reg, bladerf_direction dir);
 
 int get_gain_offset(struct bladerf *dev, bladerf_channel ch, float *offset);
 
+int get_gain_offset_at(bladerf_channel ch,
+                       bladerf_frequency frequency,
+                       float *offset);
+
 #endif  // BLADERF2_COMMON_H_
@@ -0,0 +1,347 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_config.h"
+#include "log.h"
+
+#include "ad936x.h"
+#include "board/board.h"
+#include "helpers/file.h"
+
+#include "common.h"
+#include "corr_tbl.h"
+
+struct corr_tbl_entry {
+    bladerf_frequency freq;
+    int16_t corr[CORR_TBL_NUM_CHANNELS][CORR_TBL_NUM_CORR];
+};
+
+struct corr_tbl {
+    uint32_t n_entries;
+    struct corr_tbl_entry *entries; /* Sorted (increasing) by freq */
+};
+
+static struct corr_tbl *parse_tbl(const uint8_t *buf, size_t buf_len)
+{
+    struct corr_tbl *tbl;
+    uint16_t magic;
+    uint32_t version, n_entries;
+    uint64_t freq;
+    int16_t value;
+    uint32_t i;
+    size_t c, v;
+
+    if (buf_len < CORR_TBL_HEADER_SIZE) {
+        return NULL;
+    }
+
+    memcpy(&magic, buf, sizeof(magic));
+    memcpy(&version, buf + 6, sizeof(version));
+    memcpy(&n_entries, buf + 10, sizeof(n_entries));
+
+    magic     = LE16_TO_HOST(magic);
+    version   = LE32_TO_HOST(version);
+    n_entries = LE32_TO_HOST(n_entries);
+
+    if (magic != CORR_TBL_MAGIC) {
+        log_debug("Invalid magic value in correction table: 0x%04x\n", magic);
+        return NULL;
+    }
+
+    if (version != CORR_TBL_VERSION) {
+        log_debug("Unsupported correction table version: %u\n", version);
+        return NULL;
+    }
+
+    if (n_entries == 0 || (buf_len - CORR_TBL_HEADER_SIZE) /
+                                  CORR_TBL_ENTRY_SIZE < n_entries) {
+        log_debug("Invalid correction table length\n");
+        return NULL;
+    }
+
+    tbl = calloc(1, sizeof(tbl[0]));
+    if (tbl == NULL) {
+        return NULL;
+    }
+
+    tbl->entries = calloc(n_entries, sizeof(tbl->entries[0]));
+    if (tbl->entries == NULL) {
+        free(tbl);
+        return NULL;
+    }
+
+    tbl->n_entries = n_entries;
+    buf += CORR_TBL_HEADER_SIZE;
+
+    for (i = 0; i < n_entries; i++) {
+        memcpy(&freq, buf, sizeof(freq));
+        buf += sizeof(freq);
+
+        tbl->entries[i].freq = LE64_TO_HOST(freq);
+
+        for (c = 0; c < CORR_TBL_NUM_CHANNELS; c++) {
+            for (v = 0; v < CORR_TBL_NUM_CORR; v++) {
+                memcpy(&value, buf, sizeof(value));
+                buf += sizeof(value);
+
+                tbl->entries[i].corr[c][v] = (int16_t)LE16_TO_HOST(value);
+            }
+        }
+
+        if (i > 0 && tbl->entries[i].freq <= tbl->entries[i - 1].freq) {
+            log_debug("Correction table entries are not sorted\n");
+            free(tbl->entries);
+            free(tbl);
+            return NULL;
+        }
+    }
+
+    return tbl;
+}
+
+static void free_tbl(struct corr_tbl **tbl)
+{
+    if (*tbl != NULL) {
+        free((*tbl)->entries);
+        free(*tbl);
+        *tbl = NULL;
+    }
+}
+
+static int read_tbl(struct bladerf *dev,
+                    bladerf_direction dir,
+                    const char *filename,
+                    struct corr_tbl **tbl)
+{
+    const bladerf_image_type type = (dir == BLADERF_TX)
+                                        ? BLADERF_IMAGE_TYPE_TX_IQ_CAL
+                                        : BLADERF_IMAGE_TYPE_RX_IQ_CAL;
+    struct bladerf_image *img;
+    int status;
+
+    img = bladerf_alloc_image(dev, BLADERF_IMAGE_TYPE_INVALID, 0, 0);
+    if (img == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    status = bladerf_image_read(img, filename);
+    if (status == 0) {
+        if (img->type != type) {
+            log_debug("%s is not a %s correction table\n", filename,
+                      (dir == BLADERF_TX) ? "TX" : "RX");
+            status = BLADERF_ERR_INVAL;
+        } else {
+            *tbl   = parse_tbl(img->data, img->length);
+            status = (*tbl == NULL) ? BLADERF_ERR_INVAL : 0;
+        }
+    }
+
+    bladerf_free_image(img);
+
+    return status;
+}
+
+static int set_rx_tracking(struct ad9361_rf_phy *phy, bool enable)
+{
+    const uint8_t en_dis = enable ? 1 : 0;
+
+    CHECK_AD936X(ad9361_set_rx_rfdc_track_en_dis(phy, en_dis));
+    CHECK_AD936X(ad9361_set_rx_bbdc_track_en_dis(phy, en_dis));
+    CHECK_AD936X(ad9361_set_rx_quad_track_en_dis(phy, en_dis));
+
+    return 0;
+}
+
+/* Hand control of the correction words back to the AD9361's calibrations */
+static int release_corrections(struct bladerf *dev, bladerf_direction dir)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct ad9361_rf_phy *phy              = board_data->phy;
+    const uint32_t reg = (dir == BLADERF_TX) ? AD936X_REG_TX_FORCE_BITS
+                                              : AD936X_REG_FORCE_BITS;
+
+    CHECK_AD936X(ad9361_spi_write(phy->spi, reg, 0x00));
+
+    if (dir == BLADERF_RX) {
+        CHECK_STATUS(set_rx_tracking(phy, true));
+    }
+
+    return 0;
+}
+
+static int install_tbl(struct bladerf *dev,
+                       bladerf_direction dir,
+                       struct corr_tbl *tbl)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    bool const had_tbl = (board_data->corr_tbl[dir] != NULL);
+
+    free_tbl(&board_data->corr_tbl[dir]);
+    board_data->corr_tbl[dir] = tbl;
+
+    IF_COMMAND_MODE(dev, RFIC_COMMAND_FPGA, {
+        if (tbl != NULL) {
+            log_warning("Correction tables are not applied in FPGA command "
+                        "mode.\n");
+        }
+        return 0;
+    });
+
+    if (tbl == NULL) {
+        return had_tbl ? release_corrections(dev, dir) : 0;
+    }
+
+    if (dir == BLADERF_RX) {
+        CHECK_STATUS(set_rx_tracking(board_data->phy, false));
+    }
+
+    return 0;
+}
+
+void corr_tbl_init(struct bladerf *dev)
+{
+    static const char *const suffix[] = {
+        [BLADERF_RX] = "_iq_rx.tbl",
+        [BLADERF_TX] = "_iq_tx.tbl",
+    };
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    char filename[64];
+    char *full_path;
+    struct corr_tbl *tbl;
+    bladerf_direction dir;
+    int status;
+
+    for (dir = BLADERF_RX; dir <= BLADERF_TX; dir++) {
+        /* The RFIC was just initialized, so nothing is forced or disabled */
+        free_tbl(&board_data->corr_tbl[dir]);
+
+        snprintf(filename, sizeof(filename), "%s%s", dev->ident.serial,
+                 suffix[dir]);
+
+        full_path = file_find(filename);
+        if (full_path == NULL) {
+            continue;
+        }
+
+        log_debug("Loading correction table %s\n", full_path);
+
+        tbl    = NULL;
+        status = read_tbl(dev, dir, full_path, &tbl);
+        if (status == 0) {
+            status = install_tbl(dev, dir, tbl);
+        }
+
+        if (status != 0) {
+            log_warning("Failed to load correction table %s: %s\n",
+                        full_path, bladerf_strerror(status));
+        }
+
+        free(full_path);
+    }
+}
+
+int corr_tbl_load(struct bladerf *dev,
+                  bladerf_direction dir,
+                  const char *filename)
+{
+    struct corr_tbl *tbl = NULL;
+
+    if (filename != NULL) {
+        CHECK_STATUS(read_tbl(dev, dir, filename, &tbl));
+    }
+
+    return install_tbl(dev, dir, tbl);
+}
+
+int corr_tbl_apply(struct bladerf *dev,
+                   bladerf_channel ch,
+                   bladerf_frequency frequency)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    const struct corr_tbl *tbl =
+        board_data->corr_tbl[BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_TX
+                                                       : BLADERF_RX];
+    const size_t c = ch >> 1;
+    const struct corr_tbl_entry *lo, *hi;
+    uint32_t low, high, mid;
+    int16_t value;
+    size_t v;
+
+    if (tbl == NULL || c >= CORR_TBL_NUM_CHANNELS) {
+        return 0;
+    }
+
+    IF_COMMAND_MODE(dev, RFIC_COMMAND_FPGA, { return 0; });
+
+    /* Clamp to the ends of the table, and otherwise find the pair of entries
+     * surrounding the frequency */
+    if (frequency <= tbl->entries[0].freq) {
+        lo = hi = &tbl->entries[0];
+    } else if (frequency >= tbl->entries[tbl->n_entries - 1].freq) {
+        lo = hi = &tbl->entries[tbl->n_entries - 1];
+    } else {
+        low  = 0;
+        high = tbl->n_entries - 1;
+
+        while (high - low > 1) {
+            mid = low + (high - low) / 2;
+
+            if (tbl->entries[mid].freq <= frequency) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+
+        lo = &tbl->entries[low];
+        hi = &tbl->entries[high];
+    }
+
+    for (v = 0; v < CORR_TBL_NUM_CORR; v++) {
+        value = lo->corr[c][v];
+
+        if (hi != lo) {
+            const int64_t dv = (int64_t)hi->corr[c][v] - lo->corr[c][v];
+
+            value = (int16_t)(lo->corr[c][v] +
+                              dv * (int64_t)(frequency - lo->freq) /
+                                  (int64_t)(hi->freq - lo->freq));
+        }
+
+        CHECK_STATUS(dev->board->set_correction(dev, ch,
+                                                (bladerf_correction)v, value));
+    }
+
+    return 0;
+}
+
+void corr_tbl_deinit(struct bladerf *dev)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    free_tbl(&board_data->corr_tbl[BLADERF_RX]);
+    free_tbl(&board_data->corr_tbl[BLADERF_TX]);
+}
@@ -0,0 +1,125 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef BLADERF2_CORR_TBL_H_
+#define BLADERF2_CORR_TBL_H_
+
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+/**
+ * AD9361 DC offset and quadrature correction tables
+ *
+ * A table holds the DC offset, phase, and gain correction values
+ * (see ::bladerf_correction) of both channels in one direction, at a set of
+ * frequencies. While a table is loaded, the values for a channel are
+ * interpolated and written to the AD9361 each time the channel is tuned, and
+ * the AD9361 is forced to use them. For RX, the AD9361's RF DC, baseband DC,
+ * and quadrature tracking loops are disabled while a table is loaded, so
+ * that samples are usable without waiting for the loops to converge after a
+ * retune.
+ *
+ * Tables are stored in a bladerf_image of type ::BLADERF_IMAGE_TYPE_RX_IQ_CAL
+ * or ::BLADERF_IMAGE_TYPE_TX_IQ_CAL. The image data is formatted as follows,
+ * with all values little-endian:
+ *
+ *  Offset  Length  Description
+ *  0       2       Magic value (0x2ab2)
+ *  2       4       Reserved
+ *  6       4       Table format version (1)
+ *  10      4       Number of entries
+ *  14      24*n    Entries, sorted by increasing frequency
+ *
+ * Each entry consists of a uint64_t frequency in Hz, followed by the int16_t
+ * DC I, DC Q, phase, and gain correction values of channel 0, and then those
+ * of channel 1.
+ *
+ * Corrections may only be written in host command mode. Tables are loaded
+ * but not applied in FPGA command mode.
+ */
+
+#define CORR_TBL_MAGIC 0x2ab2
+#define CORR_TBL_VERSION 1
+
+#define CORR_TBL_HEADER_SIZE 14
+#define CORR_TBL_ENTRY_SIZE 24
+
+/* Value order within an entry, matching ::bladerf_correction */
+#define CORR_TBL_NUM_CORR 4
+
+#define CORR_TBL_NUM_CHANNELS 2
+
+/**
+ * Load the correction tables for the device's serial number, if available
+ *
+ * The tables are named `<serial>_iq_rx.tbl` and `<serial>_iq_tx.tbl`, and
+ * are located in the same manner as bladeRF1 DC calibration tables. This must
+ * be called once the RFIC has been (re)initialized, as it disables the RX
+ * tracking loops if an RX table is loaded. Failures are logged and are
+ * non-fatal.
+ *
+ * @param       dev         Device handle
+ */
+void corr_tbl_init(struct bladerf *dev);
+
+/**
+ * Load a correction table from a file, or unload the current one
+ *
+ * Unloading a table releases the forced correction values and, for RX,
+ * re-enables the tracking loops.
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Direction of the table
+ * @param[in]   filename    Table file, or NULL to unload the current table
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int corr_tbl_load(struct bladerf *dev,
+                  bladerf_direction dir,
+                  const char *filename);
+
+/**
+ * Apply the correction values for a channel's frequency, if a table is
+ * loaded for its direction
+ *
+ * This must be called after the channel is tuned, as the AD9361 correction
+ * registers in use depend upon the band selected for the frequency.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   frequency   Frequency the channel was tuned to
+ *
+ * @return 0 on success or if no table is loaded, value from \ref RETCODES
+ *         list on failure
+ */
+int corr_tbl_apply(struct bladerf *dev,
+                   bladerf_channel ch,
+                   bladerf_frequency frequency);
+
+/**
+ * Free any loaded tables
+ *
+ * @param       dev         Device handle
+ */
+void corr_tbl_deinit(struct bladerf *dev);
+
+#endif
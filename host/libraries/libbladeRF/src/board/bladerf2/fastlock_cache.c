@@ -0,0 +1,343 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+
+#include "backend/backend.h"
+#include "board/board.h"
+#include "helpers/file.h"
+#include "helpers/have_cap.h"
+#include "nios_pkt_16x64.h"
+
+#include "common.h"
+#include "fastlock_cache.h"
+
+/* Increment when the cache file format changes */
+#define FASTLOCK_CACHE_FORMAT 1
+
+struct fastlock_record {
+    bool valid;
+    bladerf_frequency frequency;
+    uint8_t port;
+    uint8_t spdt;
+    uint8_t data[NIOS_PKT_16x64_FASTLOCK_PROFILE_LEN];
+};
+
+struct fastlock_cache {
+    char *path;
+    char const *refclk;
+    bool dirty;
+
+    /* Indexed by Nios profile number */
+    struct fastlock_record rx[NUM_BBP_FASTLOCK_PROFILES];
+    struct fastlock_record tx[NUM_BBP_FASTLOCK_PROFILES];
+};
+
+static struct fastlock_record *records(struct fastlock_cache *cache,
+                                       bool is_tx)
+{
+    return is_tx ? cache->tx : cache->rx;
+}
+
+static uint8_t rffe_profile(uint16_t nios_profile)
+{
+    return nios_profile % NUM_RFFE_FASTLOCK_PROFILES;
+}
+
+static void cache_load(struct fastlock_cache *cache)
+{
+    FILE *f;
+    char line[128];
+    char dir[3], hex[2 * NIOS_PKT_16x64_FASTLOCK_PROFILE_LEN + 1];
+    char refclk[16];
+    unsigned int format, profile, port, spdt, byte;
+    uint64_t frequency;
+    struct fastlock_record *r;
+    size_t i;
+
+    f = fopen(cache->path, "r");
+    if (f == NULL) {
+        return;
+    }
+
+    if (fscanf(f, "format=%u\nrefclk=%15s\n", &format, refclk) != 2 ||
+        format != FASTLOCK_CACHE_FORMAT || strcmp(refclk, cache->refclk)) {
+        log_debug("Ignoring stale quick tune cache %s\n", cache->path);
+        goto out;
+    }
+
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (sscanf(line, "%2s %u %" SCNu64 " %x %x %32s", dir, &profile,
+                   &frequency, &port, &spdt, hex) != 6 ||
+            profile >= NUM_BBP_FASTLOCK_PROFILES || port > 0xff ||
+            spdt > 0xff || strlen(hex) != sizeof(hex) - 1 ||
+            (strcmp(dir, "rx") && strcmp(dir, "tx"))) {
+            log_debug("Ignoring malformed quick tune cache entry\n");
+            continue;
+        }
+
+        r = &records(cache, dir[0] == 't')[profile];
+
+        for (i = 0; i < sizeof(r->data); i++) {
+            if (sscanf(&hex[2 * i], "%2x", &byte) != 1) {
+                break;
+            }
+
+            r->data[i] = (uint8_t)byte;
+        }
+
+        if (i == sizeof(r->data)) {
+            r->valid     = true;
+            r->frequency = frequency;
+            r->port      = (uint8_t)port;
+            r->spdt      = (uint8_t)spdt;
+        }
+    }
+
+out:
+    fclose(f);
+}
+
+static void cache_store(struct fastlock_cache const *cache)
+{
+    FILE *f;
+    size_t n, i, j;
+
+    f = fopen(cache->path, "w");
+    if (f == NULL) {
+        log_debug("Unable to write quick tune cache %s\n", cache->path);
+        return;
+    }
+
+    fprintf(f, "format=%u\nrefclk=%s\n", FASTLOCK_CACHE_FORMAT,
+            cache->refclk);
+
+    for (n = 0; n < 2; n++) {
+        struct fastlock_record const *r = (n == 0) ? cache->rx : cache->tx;
+
+        for (i = 0; i < NUM_BBP_FASTLOCK_PROFILES; i++) {
+            if (!r[i].valid) {
+                continue;
+            }
+
+            fprintf(f, "%s %u %" PRIu64 " %02x %02x ", (n == 0) ? "rx" : "tx",
+                    (unsigned int)i, r[i].frequency, r[i].port, r[i].spdt);
+
+            for (j = 0; j < sizeof(r[i].data); j++) {
+                fprintf(f, "%02x", r[i].data[j]);
+            }
+
+            fprintf(f, "\n");
+        }
+    }
+
+    if (fclose(f) != 0) {
+        log_debug("Failed to write quick tune cache %s\n", cache->path);
+        remove(cache->path);
+    }
+}
+
+/* Write the loaded profiles to the Nios, and return one past the highest
+ * profile number restored. Profiles that fail to restore are dropped. */
+static uint16_t cache_restore(struct bladerf *dev,
+                              struct fastlock_cache *cache,
+                              bool is_tx)
+{
+    struct fastlock_record *r = records(cache, is_tx);
+    uint16_t next             = 0;
+    unsigned int count        = 0;
+    uint16_t i;
+    int status;
+
+    for (i = 0; i < NUM_BBP_FASTLOCK_PROFILES; i++) {
+        if (!r[i].valid) {
+            continue;
+        }
+
+        status = dev->backend->rffe_fastlock_write(
+            dev, is_tx, rffe_profile(i), (uint8_t)i, r[i].data);
+        if (status != 0) {
+            log_debug("Failed to restore %s fast lock profile %u: %s\n",
+                      is_tx ? "TX" : "RX", i, bladerf_strerror(status));
+            r[i].valid   = false;
+            cache->dirty = true;
+            continue;
+        }
+
+        next = i + 1;
+        count++;
+    }
+
+    if (count > 0) {
+        log_verbose("Restored %u %s quick tune profiles\n", count,
+                    is_tx ? "TX" : "RX");
+    }
+
+    return next;
+}
+
+void fastlock_cache_init(struct bladerf *dev)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct fastlock_cache *cache;
+    uint32_t gpio;
+
+    fastlock_cache_deinit(dev);
+
+    if (getenv("BLADERF_DISABLE_QUICK_TUNE_CACHE") ||
+        !have_cap(board_data->capabilities,
+                  BLADERF_CAP_FPGA_FASTLOCK_ACCESS) ||
+        !file_serial_is_valid(dev->ident.serial)) {
+        return;
+    }
+
+    if (dev->backend->config_gpio_read(dev, &gpio) != 0) {
+        return;
+    }
+
+    cache = calloc(1, sizeof(*cache));
+    if (cache == NULL) {
+        return;
+    }
+
+    cache->path = file_device_path("quick-tune", dev->ident.serial, ".cache");
+    if (cache->path == NULL) {
+        free(cache);
+        return;
+    }
+
+    /* Profiles hold PLL settings derived from the RFIC's reference clock */
+    cache->refclk = (gpio & (1 << CFG_GPIO_CLOCK_SELECT)) ? "external"
+                                                          : "onboard";
+
+    cache_load(cache);
+
+    board_data->quick_tune_rx_profile = cache_restore(dev, cache, false);
+    board_data->quick_tune_tx_profile = cache_restore(dev, cache, true);
+
+    /* Restored profiles are loaded into the RFIC via direct SPI writes */
+    if (board_data->quick_tune_rx_profile > 0 ||
+        board_data->quick_tune_tx_profile > 0) {
+        board_data->rfic_reset_on_close = true;
+    }
+
+    board_data->fastlock_cache = cache;
+}
+
+void fastlock_cache_record(struct bladerf *dev,
+                           bladerf_channel ch,
+                           bladerf_frequency frequency,
+                           struct bladerf_quick_tune const *quick_tune)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct fastlock_cache *cache           = board_data->fastlock_cache;
+    bool const is_tx                       = BLADERF_CHANNEL_IS_TX(ch);
+    struct fastlock_record *r;
+    int status;
+
+    if (cache == NULL || quick_tune->nios_profile >= NUM_BBP_FASTLOCK_PROFILES) {
+        return;
+    }
+
+    r = &records(cache, is_tx)[quick_tune->nios_profile];
+
+    status = dev->backend->rffe_fastlock_read(
+        dev, is_tx, (uint8_t)quick_tune->nios_profile, r->data);
+    if (status != 0) {
+        log_debug("Failed to read back fast lock profile: %s\n",
+                  bladerf_strerror(status));
+        r->valid = false;
+        return;
+    }
+
+    r->valid     = true;
+    r->frequency = frequency;
+    r->port      = quick_tune->port;
+    r->spdt      = quick_tune->spdt;
+    cache->dirty = true;
+}
+
+bool fastlock_cache_lookup(struct bladerf *dev,
+                           bladerf_channel ch,
+                           bladerf_frequency frequency,
+                           struct bladerf_quick_tune *quick_tune)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct fastlock_cache *cache           = board_data->fastlock_cache;
+    struct fastlock_record const *r;
+    bladerf_frequency best_diff = FASTLOCK_CACHE_MATCH_HZ + 1;
+    bladerf_frequency diff;
+    uint16_t i, best = 0;
+
+    if (cache == NULL) {
+        return false;
+    }
+
+    r = records(cache, BLADERF_CHANNEL_IS_TX(ch));
+
+    for (i = 0; i < NUM_BBP_FASTLOCK_PROFILES; i++) {
+        if (!r[i].valid) {
+            continue;
+        }
+
+        diff = (r[i].frequency > frequency) ? r[i].frequency - frequency
+                                            : frequency - r[i].frequency;
+
+        if (diff < best_diff) {
+            best_diff = diff;
+            best      = i;
+        }
+    }
+
+    if (best_diff > FASTLOCK_CACHE_MATCH_HZ) {
+        return false;
+    }
+
+    quick_tune->nios_profile = best;
+    quick_tune->rffe_profile = rffe_profile(best);
+    quick_tune->port         = r[best].port;
+    quick_tune->spdt         = r[best].spdt;
+
+    return true;
+}
+
+void fastlock_cache_deinit(struct bladerf *dev)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct fastlock_cache *cache           = board_data->fastlock_cache;
+
+    if (cache == NULL) {
+        return;
+    }
+
+    if (cache->dirty) {
+        cache_store(cache);
+    }
+
+    free(cache->path);
+    free(cache);
+    board_data->fastlock_cache = NULL;
+}
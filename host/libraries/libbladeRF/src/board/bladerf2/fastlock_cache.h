@@ -0,0 +1,94 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef BLADERF2_FASTLOCK_CACHE_H_
+#define BLADERF2_FASTLOCK_CACHE_H_
+
+#include <stdbool.h>
+
+#include <libbladeRF.h>
+
+/**
+ * Persistent cache of quick tune parameters and their fast lock profiles
+ *
+ * Each quick tune created via bladerf_get_quick_tune() is recorded, along
+ * with the AD9361 fast lock profile data stored for it in the Nios. On close,
+ * the records are written to the user's bladeRF config directory, keyed by
+ * the device serial and reference clock source. On the next open, the
+ * profiles are written back to the Nios so that the corresponding quick tune
+ * parameters are usable without retuning.
+ *
+ * The cache is only active when the FPGA supports fast lock profile access
+ * (::BLADERF_CAP_FPGA_FASTLOCK_ACCESS), and may be disabled by defining
+ * BLADERF_DISABLE_QUICK_TUNE_CACHE in the environment.
+ */
+
+/**
+ * Load the cache and restore its profiles to the Nios
+ *
+ * This must be called once the RFIC has been initialized. On return, the
+ * board's next quick tune profile numbers follow the restored profiles.
+ * Failures are logged and are non-fatal.
+ *
+ * @param       dev         Device handle
+ */
+void fastlock_cache_init(struct bladerf *dev);
+
+/**
+ * Record a newly created quick tune
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel the quick tune was created for
+ * @param[in]   frequency   Frequency the channel was tuned to
+ * @param[in]   quick_tune  Quick tune parameters. The fast lock profile must
+ *                          already be saved in the Nios.
+ */
+void fastlock_cache_record(struct bladerf *dev,
+                           bladerf_channel ch,
+                           bladerf_frequency frequency,
+                           struct bladerf_quick_tune const *quick_tune);
+
+/**
+ * Find a recorded quick tune for a frequency
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   frequency   Frequency, in Hz
+ * @param[out]  quick_tune  Quick tune parameters, if found
+ *
+ * @return true if a profile within FASTLOCK_CACHE_MATCH_HZ was found
+ */
+bool fastlock_cache_lookup(struct bladerf *dev,
+                           bladerf_channel ch,
+                           bladerf_frequency frequency,
+                           struct bladerf_quick_tune *quick_tune);
+
+/**
+ * Write back any new records and release the cache
+ *
+ * @param       dev         Device handle
+ */
+void fastlock_cache_deinit(struct bladerf *dev);
+
+/* Tolerance when matching a requested frequency against a record */
+#define FASTLOCK_CACHE_MATCH_HZ 1000
+
+#endif
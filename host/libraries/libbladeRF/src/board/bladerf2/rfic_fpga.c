@@ -24,6 +24,7 @@
 #include "board/board.h"
 #include "common.h"
 #include "conversions.h"
+#include "helpers/have_cap.h"
 #include "iterators.h"
 #include "log.h"
 
@@ -81,6 +82,14 @@ static int _rfic_cmd_write(struct bladerf *dev,
 /* Build RFIC address from bladerf_rfic_command and bladerf_channel */
 #define RFIC_ADDRESS(cmd, ch) ((cmd & 0xFF) + ((ch & 0xF) << 8))
 
+/* Depth of the NIOS II RFIC write queue (COMMAND_QUEUE_MAX), assumed for
+ * FPGA versions that do not report it in the status register */
+#define RFIC_WRITE_QUEUE_MAX 16
+
+/* Time allowed for the NIOS II to drain a full write queue in response to
+ * BLADERF_RFIC_COMMAND_WAIT */
+#define RFIC_WAIT_TIMEOUT_MS 2500
+
 static int _rfic_fpga_get_status(
     struct bladerf *dev, struct bladerf_rfic_status_register *rfic_status)
 {
@@ -93,6 +102,13 @@ static int _rfic_fpga_get_status(
     rfic_status->rfic_initialized   = ((sreg >> 0) & 0x1);
     rfic_status->write_queue_length = ((sreg >> 8) & 0xFF);
 
+    rfic_status->write_queue_max = (sreg >> BLADERF_RFIC_STATUS_WQMAX_SHIFT) &
+                                   BLADERF_RFIC_STATUS_WQMAX_MASK;
+
+    rfic_status->write_queue_high_water =
+        (sreg >> BLADERF_RFIC_STATUS_WQHWM_SHIFT) &
+        BLADERF_RFIC_STATUS_WQHWM_MASK;
+
     return status;
 }
 
@@ -116,16 +132,51 @@ static int _rfic_fpga_get_status_wqlen(struct bladerf *dev)
     return (int)rfic_status.write_queue_length;
 }
 
+/* Wait for the write queue to drain with a single long-polled request */
+static int _rfic_fpga_wait(struct bladerf *dev)
+{
+    uint64_t sreg = 0;
+    size_t jobs;
+
+    CHECK_STATUS(dev->backend->rfic_command_wait(
+        dev, RFIC_ADDRESS(BLADERF_RFIC_COMMAND_WAIT, BLADERF_CHANNEL_INVALID),
+        RFIC_WAIT_TIMEOUT_MS, &sreg));
+
+    jobs = (sreg >> BLADERF_RFIC_STATUS_WQLEN_SHIFT) &
+           BLADERF_RFIC_STATUS_WQLEN_MASK;
+
+    if (jobs > 0) {
+        log_debug("%s: %zu jobs still queued\n", __FUNCTION__, jobs);
+        return BLADERF_ERR_TIMEOUT;
+    }
+
+    return 0;
+}
+
 static int _rfic_fpga_spinwait(struct bladerf *dev)
 {
+    struct bladerf2_board_data *board_data = dev->board_data;
     size_t const TRIES       = 30;
     unsigned int const DELAY = 100;
     size_t count             = 0;
+    int last                 = -1;
     int jobs;
 
-    /* Poll the CPU and spin until the job has been completed. */
+    if (have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RFIC_WAIT)) {
+        return _rfic_fpga_wait(dev);
+    }
+
+    /* Poll the CPU and spin until the queue has drained. The timeout
+     * restarts whenever a job completes, since a batch of jobs may take
+     * several times longer than one. */
     do {
         jobs = _rfic_fpga_get_status_wqlen(dev);
+        if (jobs > 0 && (last < 0 || jobs < last)) {
+            count = 0;
+        }
+
+        last = jobs;
+
         if (0 != jobs) {
             usleep(DELAY);
         }
@@ -145,11 +196,31 @@ static int _rfic_fpga_spinwait(struct bladerf *dev)
 /* Low level RFIC Accessors */
 /******************************************************************************/
 
+/* Wait for any batched commands to complete */
+static int _rfic_fpga_flush(struct bladerf *dev)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (0 == board_data->rfic_batch_pending) {
+        return 0;
+    }
+
+    board_data->rfic_batch_pending = 0;
+
+    return _rfic_fpga_spinwait(dev);
+}
+
 static int _rfic_cmd_read(struct bladerf *dev,
                           bladerf_channel ch,
                           bladerf_rfic_command cmd,
                           uint64_t *data)
 {
+    /* Reads are not queued, so they must not overtake pending writes. The
+     * status register reports on the queue itself and is exempt. */
+    if (BLADERF_RFIC_COMMAND_STATUS != cmd) {
+        CHECK_STATUS(_rfic_fpga_flush(dev));
+    }
+
     return dev->backend->rfic_command_read(dev, RFIC_ADDRESS(cmd, ch), data);
 }
 
@@ -158,10 +229,22 @@ static int _rfic_cmd_write(struct bladerf *dev,
                            bladerf_rfic_command cmd,
                            uint64_t data)
 {
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    /* Make room in the queue if a batch would overflow it */
+    if (board_data->rfic_batch_pending >= board_data->rfic_queue_max) {
+        CHECK_STATUS(_rfic_fpga_flush(dev));
+    }
+
     /* Perform the write command. */
     CHECK_STATUS(
         dev->backend->rfic_command_write(dev, RFIC_ADDRESS(cmd, ch), data));
 
+    if (board_data->rfic_batch) {
+        board_data->rfic_batch_pending++;
+        return 0;
+    }
+
     /* Block until the job has been completed. */
     return _rfic_fpga_spinwait(dev);
 }
@@ -718,6 +801,54 @@ static int _rfic_fpga_store_fastlock_profile(struct bladerf *dev,
 }
 
 
+/******************************************************************************/
+/* Batching */
+/******************************************************************************/
+
+static int _rfic_fpga_batch_begin(struct bladerf *dev)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct bladerf_rfic_status_register rfic_status;
+
+    /* Size batches to the write queue the FPGA actually has */
+    if (0 == board_data->rfic_queue_max) {
+        CHECK_STATUS(_rfic_fpga_get_status(dev, &rfic_status));
+
+        board_data->rfic_queue_max = rfic_status.write_queue_max;
+        if (0 == board_data->rfic_queue_max) {
+            board_data->rfic_queue_max = RFIC_WRITE_QUEUE_MAX;
+        }
+
+        log_verbose("%s: write queue holds %u commands\n", __FUNCTION__,
+                    board_data->rfic_queue_max);
+    }
+
+    board_data->rfic_batch = true;
+
+    return 0;
+}
+
+static int _rfic_fpga_batch_end(struct bladerf *dev)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct bladerf_rfic_status_register rfic_status;
+
+    board_data->rfic_batch = false;
+
+    CHECK_STATUS(_rfic_fpga_flush(dev));
+
+    if (log_get_verbosity() <= BLADERF_LOG_LEVEL_VERBOSE &&
+        _rfic_fpga_get_status(dev, &rfic_status) == 0 &&
+        rfic_status.write_queue_max > 0) {
+        log_verbose("%s: write queue high-water mark is %zu of %zu\n",
+                    __FUNCTION__, rfic_status.write_queue_high_water,
+                    rfic_status.write_queue_max);
+    }
+
+    return 0;
+}
+
+
 /******************************************************************************/
 /* Function pointers */
 /******************************************************************************/
@@ -763,5 +894,8 @@ struct controller_fns const rfic_fpga_control = {
 
     FIELD_INIT(.store_fastlock_profile, _rfic_fpga_store_fastlock_profile),
 
+    FIELD_INIT(.batch_begin, _rfic_fpga_batch_begin),
+    FIELD_INIT(.batch_end, _rfic_fpga_batch_end),
+
     FIELD_INIT(.command_mode, RFIC_COMMAND_FPGA),
 };
@@ -24,6 +24,7 @@
 #include <libbladeRF.h>
 
 #include "ad936x_helpers.h"
+#include "ad936x_profiles.h"
 #include "bladerf2_common.h"
 #include "board/board.h"
 #include "common.h"
@@ -31,6 +32,9 @@
 #include "iterators.h"
 #include "log.h"
 
+#include "rfic_snapshot.h"
+#include "rfic_spi_batch.h"
+
 // #define BLADERF_HOSTED_C_DEBUG
 
 
@@ -81,6 +85,9 @@ static int _rfic_host_initialize(struct bladerf *dev)
     bladerf_channel ch;
     size_t i;
     uint32_t config_gpio;
+    char const *params;
+    bool warm = false;
+    int status;
 
     log_debug("%s: initializating\n", __FUNCTION__);
 
@@ -95,12 +102,34 @@ static int _rfic_host_initialize(struct bladerf *dev)
                 (void *)&bladerf2_rfic_init_params_fastagc_burst :
                 (void *)&bladerf2_rfic_init_params;
 
+    params = (config_gpio & BLADERF_GPIO_PACKET_CORE_PRESENT) ? "fastagc_burst"
+                                                               : "default";
+
+    /* Warm initialization from a snapshot of a previous cold one */
+    if (rfic_snapshot_begin(dev, params)) {
+        status = ad9361_init(&phy, (AD9361_InitParam *)board_data->rfic_init_params, dev);
+        if (status < 0 || NULL == phy || NULL == phy->pdata) {
+            phy = NULL;
+        }
+
+        if (rfic_snapshot_finish(dev, phy) == 0) {
+            warm = true;
+        } else if (NULL != phy) {
+            ad9361_deinit(phy);
+            phy = NULL;
+        }
+    }
+
     /* Initialize AD9361 */
-    CHECK_AD936X(ad9361_init(&phy, (AD9361_InitParam *)board_data->rfic_init_params, dev));
+    if (!warm) {
+        CHECK_AD936X(ad9361_init(&phy, (AD9361_InitParam *)board_data->rfic_init_params, dev));
 
-    if (NULL == phy || NULL == phy->pdata) {
-        RETURN_ERROR_STATUS("ad9361_init struct initialization",
-                            BLADERF_ERR_UNEXPECTED);
+        if (NULL == phy || NULL == phy->pdata) {
+            RETURN_ERROR_STATUS("ad9361_init struct initialization",
+                                BLADERF_ERR_UNEXPECTED);
+        }
+
+        rfic_snapshot_capture(dev, phy, params);
     }
 
     log_verbose("%s: ad9361 initialized @ %p\n", __FUNCTION__, phy);
@@ -356,19 +385,57 @@ static int _rfic_host_get_sample_rate(struct bladerf *dev,
     return 0;
 }
 
+/* A precomputed clock chain is only valid if both FIRs are configured as it
+ * assumes, and if the driver would have chosen the same dividers */
+static struct ad936x_profile const *_rfic_host_find_profile(
+    struct ad9361_rf_phy *phy, bladerf_sample_rate rate)
+{
+    uint32_t const rx_ratio = phy->bypass_rx_fir ? 1 : phy->rx_fir_dec;
+    uint32_t const tx_ratio = phy->bypass_tx_fir ? 1 : phy->tx_fir_int;
+
+    if (rx_ratio != tx_ratio || phy->rate_governor != 0) {
+        return NULL;
+    }
+
+    return ad936x_profile_find(rate, rx_ratio);
+}
+
 static int _rfic_host_set_sample_rate(struct bladerf *dev,
                                       bladerf_channel ch,
                                       bladerf_sample_rate rate)
 {
     struct bladerf2_board_data *board_data = dev->board_data;
     struct ad9361_rf_phy *phy              = board_data->phy;
+    struct ad936x_profile const *profile;
+    uint32_t rx_path_clks[AD936X_PROFILE_CLKS];
+    uint32_t tx_path_clks[AD936X_PROFILE_CLKS];
+    int status;
 
-    if (BLADERF_CHANNEL_IS_TX(ch)) {
-        CHECK_AD936X(ad9361_set_tx_sampling_freq(phy, rate));
+    profile = _rfic_host_find_profile(phy, rate);
+
+    rfic_spi_batch_begin(dev);
+
+    if (profile != NULL) {
+        log_verbose("%s: loading precomputed clock chain for %u sps\n",
+                    __FUNCTION__, rate);
+
+        memcpy(rx_path_clks, profile->rx_path_clks, sizeof(rx_path_clks));
+        memcpy(tx_path_clks, profile->tx_path_clks, sizeof(tx_path_clks));
+
+        status = ad9361_set_trx_path_clks(phy, rx_path_clks, tx_path_clks);
+    } else if (BLADERF_CHANNEL_IS_TX(ch)) {
+        status = ad9361_set_tx_sampling_freq(phy, rate);
     } else {
-        CHECK_AD936X(ad9361_set_rx_sampling_freq(phy, rate));
+        status = ad9361_set_rx_sampling_freq(phy, rate);
     }
 
+    if (status < 0) {
+        rfic_spi_batch_end(dev);
+        RETURN_ERROR_AD9361("set sample rate", status);
+    }
+
+    CHECK_STATUS(rfic_spi_batch_end(dev));
+
     return 0;
 }
 
@@ -823,6 +890,7 @@ static int _rfic_host_set_filter(struct bladerf *dev,
 {
     struct bladerf2_board_data *board_data = dev->board_data;
     struct ad9361_rf_phy *phy              = board_data->phy;
+    int status;
 
     if (BLADERF_CHANNEL_IS_TX(ch)) {
         AD9361_TXFIRConfig *fir_config = NULL;
@@ -856,7 +924,15 @@ static int _rfic_host_set_filter(struct bladerf *dev,
                 return BLADERF_ERR_UNEXPECTED;
         }
 
-        CHECK_AD936X(ad9361_set_tx_fir_config(phy, *fir_config));
+        /* The coefficients are loaded with a long run of register writes */
+        rfic_spi_batch_begin(dev);
+        status = ad9361_set_tx_fir_config(phy, *fir_config);
+        if (status < 0) {
+            rfic_spi_batch_end(dev);
+            RETURN_ERROR_AD9361("ad9361_set_tx_fir_config", status);
+        }
+        CHECK_STATUS(rfic_spi_batch_end(dev));
+
         CHECK_AD936X(ad9361_set_tx_fir_en_dis(phy, enable));
 
         board_data->txfir = txfir;
@@ -892,7 +968,15 @@ static int _rfic_host_set_filter(struct bladerf *dev,
                 return BLADERF_ERR_UNEXPECTED;
         }
 
-        CHECK_AD936X(ad9361_set_rx_fir_config(phy, *fir_config));
+        /* The coefficients are loaded with a long run of register writes */
+        rfic_spi_batch_begin(dev);
+        status = ad9361_set_rx_fir_config(phy, *fir_config);
+        if (status < 0) {
+            rfic_spi_batch_end(dev);
+            RETURN_ERROR_AD9361("ad9361_set_rx_fir_config", status);
+        }
+        CHECK_STATUS(rfic_spi_batch_end(dev));
+
         CHECK_AD936X(ad9361_set_rx_fir_en_dis(phy, enable));
 
         board_data->rxfir = rxfir;
@@ -956,6 +1040,22 @@ static int _rfic_host_store_fastlock_profile(struct bladerf *dev,
 }
 
 
+/******************************************************************************/
+/* Batching */
+/******************************************************************************/
+
+static int _rfic_host_batch_begin(struct bladerf *dev)
+{
+    // Commands are executed synchronously over SPI; nothing to batch.
+    return 0;
+}
+
+static int _rfic_host_batch_end(struct bladerf *dev)
+{
+    return 0;
+}
+
+
 /******************************************************************************/
 /* Function pointers */
 /******************************************************************************/
@@ -1001,5 +1101,8 @@ struct controller_fns const rfic_host_control = {
 
     FIELD_INIT(.store_fastlock_profile, _rfic_host_store_fastlock_profile),
 
+    FIELD_INIT(.batch_begin, _rfic_host_batch_begin),
+    FIELD_INIT(.batch_end, _rfic_host_batch_end),
+
     FIELD_INIT(.command_mode, RFIC_COMMAND_HOST),
 };
@@ -0,0 +1,496 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+
+#include "backend/backend.h"
+#include "board/board.h"
+#include "helpers/file.h"
+#include "helpers/reg_shadow.h"
+
+#include "common.h"
+#include "rfic_snapshot.h"
+
+/* Increment when the snapshot file format changes */
+#define RFIC_SNAPSHOT_FORMAT 1
+
+/* The AD9361's 10-bit register address space */
+#define NUM_REGS 1024
+
+/* Registers per SPI burst, and per line of the snapshot file */
+#define BURST_LEN 8
+#define LINE_LEN 16
+
+#define REG_SPI_CONF 0x000
+#define REG_TEMPERATURE 0x00E
+#define REG_ENSM_CONFIG_1 0x014
+#define REG_ENSM_CONFIG_2 0x015
+#define REG_CALIBRATION_CTRL 0x016
+#define REG_STATE 0x017
+#define REG_PRODUCT_ID 0x037
+#define REG_CH_1_OVERFLOW 0x05E
+#define REG_RX_CAL_STATUS 0x244
+#define REG_RX_CP_OVERRANGE_VCO_LOCK 0x247
+#define REG_TX_CAL_STATUS 0x284
+#define REG_TX_CP_OVERRANGE_VCO_LOCK 0x287
+
+#define BBPLL_LOCK (1 << 7)
+
+struct rfic_snapshot {
+    int32_t temp;           /* Temperature at capture, in m°C */
+    uint8_t reg[NUM_REGS];  /* Register map at capture */
+
+    /* Register map as seen by ad9361_init() during replay. Entries are
+     * valid for the registers it wrote. */
+    struct reg_shadow replay;
+};
+
+/* Registers whose state belongs to the device rather than the driver: the
+ * PLL lock and calibration status, ENSM state and temperature. These are
+ * always read from the device. */
+static bool is_volatile(uint16_t addr)
+{
+    return addr == REG_TEMPERATURE || addr == REG_STATE ||
+           addr == REG_CH_1_OVERFLOW || addr == REG_RX_CAL_STATUS ||
+           addr == REG_RX_CP_OVERRANGE_VCO_LOCK || addr == REG_TX_CAL_STATUS ||
+           addr == REG_TX_CP_OVERRANGE_VCO_LOCK;
+}
+
+/* Registers that are never restored: the soft reset, ENSM control and
+ * calibration triggers */
+static bool is_control(uint16_t addr)
+{
+    return addr == REG_SPI_CONF || addr == REG_ENSM_CONFIG_1 ||
+           addr == REG_ENSM_CONFIG_2 || addr == REG_CALIBRATION_CTRL;
+}
+
+static bool snapshot_enabled(struct bladerf *dev)
+{
+    return getenv("BLADERF_DISABLE_RFIC_SNAPSHOT") == NULL &&
+           file_serial_is_valid(dev->ident.serial);
+}
+
+static char *snapshot_path(struct bladerf *dev)
+{
+    return file_device_path("rfic", dev->ident.serial, ".snapshot");
+}
+
+/* The key that a snapshot must match to be used. Register values derived
+ * from the reference clock, and the sequence in which ad9361_init() writes
+ * them, depend upon each of these. */
+static int snapshot_key(struct bladerf *dev,
+                        char const *params,
+                        char *key,
+                        size_t len)
+{
+    struct bladerf_version version;
+    uint32_t gpio;
+
+    CHECK_STATUS(dev->backend->config_gpio_read(dev, &gpio));
+
+    bladerf_version(&version);
+
+    snprintf(key, len, "params=%s\nrefclk=%s\nversion=%s\n", params,
+             (gpio & (1 << CFG_GPIO_CLOCK_SELECT)) ? "external" : "onboard",
+             version.describe);
+
+    return 0;
+}
+
+/* Read or write the registers [addr, addr + n), with n <= BURST_LEN. Bursts
+ * proceed in descending address order, with the first byte in the MSB. */
+static int burst_read(struct bladerf *dev, uint16_t addr, size_t n,
+                      uint8_t *buf)
+{
+    uint16_t const top = addr + n - 1;
+    uint64_t data      = 0;
+    size_t i;
+
+    CHECK_STATUS(dev->backend->ad9361_spi_read(
+        dev, AD936X_READ | AD936X_CNT(n) | AD936X_ADDR(top), &data));
+
+    for (i = 0; i < n; i++) {
+        buf[n - 1 - i] = (data >> (56 - 8 * i)) & 0xff;
+    }
+
+    return 0;
+}
+
+static int burst_write(struct bladerf *dev, uint16_t addr, size_t n,
+                       uint8_t const *buf)
+{
+    uint16_t const top = addr + n - 1;
+    uint64_t data      = 0;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        data |= ((uint64_t)buf[n - 1 - i]) << (56 - 8 * i);
+    }
+
+    return dev->backend->ad9361_spi_write(
+        dev, AD936X_WRITE | AD936X_CNT(n) | AD936X_ADDR(top), data);
+}
+
+static int read_map(struct bladerf *dev, uint8_t *map)
+{
+    uint16_t addr;
+
+    for (addr = 0; addr < NUM_REGS; addr += BURST_LEN) {
+        CHECK_STATUS(burst_read(dev, addr, BURST_LEN, &map[addr]));
+    }
+
+    return 0;
+}
+
+static bool snapshot_load(struct rfic_snapshot *s,
+                          char const *path,
+                          char const *key)
+{
+    FILE *f;
+    char header[256];
+    char line[64];
+    unsigned int format, addr, byte;
+    long temp;
+    size_t len = strlen(key);
+    size_t lines = 0;
+    size_t i;
+    bool ok = false;
+
+    f = fopen(path, "r");
+    if (f == NULL) {
+        return false;
+    }
+
+    if (fscanf(f, "format=%u\n", &format) != 1 ||
+        format != RFIC_SNAPSHOT_FORMAT || len >= sizeof(header) ||
+        fread(header, 1, len, f) != len || memcmp(header, key, len) ||
+        fscanf(f, "temp=%ld\n", &temp) != 1) {
+        log_debug("Ignoring stale RFIC snapshot %s\n", path);
+        goto out;
+    }
+
+    s->temp = (int32_t)temp;
+
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (sscanf(line, "%3x ", &addr) != 1 || addr % LINE_LEN != 0 ||
+            addr >= NUM_REGS || strlen(line) < 4 + 2 * LINE_LEN) {
+            log_debug("Ignoring malformed RFIC snapshot %s\n", path);
+            goto out;
+        }
+
+        for (i = 0; i < LINE_LEN; i++) {
+            if (sscanf(&line[4 + 2 * i], "%2x", &byte) != 1) {
+                log_debug("Ignoring malformed RFIC snapshot %s\n", path);
+                goto out;
+            }
+
+            s->reg[addr + i] = (uint8_t)byte;
+        }
+
+        lines++;
+    }
+
+    /* Every line must be present, once */
+    ok = (lines == NUM_REGS / LINE_LEN);
+
+out:
+    fclose(f);
+    return ok;
+}
+
+static void snapshot_store(struct rfic_snapshot const *s,
+                           char const *path,
+                           char const *key)
+{
+    FILE *f;
+    size_t addr, i;
+
+    f = fopen(path, "w");
+    if (f == NULL) {
+        log_debug("Unable to write RFIC snapshot %s\n", path);
+        return;
+    }
+
+    fprintf(f, "format=%u\n%stemp=%" PRId32 "\n", RFIC_SNAPSHOT_FORMAT, key,
+            s->temp);
+
+    for (addr = 0; addr < NUM_REGS; addr += LINE_LEN) {
+        fprintf(f, "%03x ", (unsigned int)addr);
+
+        for (i = 0; i < LINE_LEN; i++) {
+            fprintf(f, "%02x", s->reg[addr + i]);
+        }
+
+        fprintf(f, "\n");
+    }
+
+    if (fclose(f) != 0) {
+        log_debug("Failed to write RFIC snapshot %s\n", path);
+        remove(path);
+    }
+}
+
+bool rfic_snapshot_begin(struct bladerf *dev, char const *params)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct rfic_snapshot *s;
+    char key[128];
+    char *path;
+    bool loaded;
+
+    board_data->rfic_snapshot = NULL;
+
+    if (!snapshot_enabled(dev) ||
+        snapshot_key(dev, params, key, sizeof(key)) != 0) {
+        return false;
+    }
+
+    path = snapshot_path(dev);
+    if (path == NULL) {
+        return false;
+    }
+
+    s = calloc(1, sizeof(*s));
+    if (s == NULL) {
+        free(path);
+        return false;
+    }
+
+    loaded = snapshot_load(s, path, key);
+    free(path);
+
+    if (!loaded) {
+        free(s);
+        return false;
+    }
+
+    log_debug("%s: warm initialization from RFIC snapshot\n", __FUNCTION__);
+
+    board_data->rfic_snapshot = s;
+    return true;
+}
+
+/* Write back the snapshot's values of the registers that differ on the
+ * device, in bursts of consecutive registers */
+static int restore(struct bladerf *dev, struct rfic_snapshot const *s)
+{
+    uint8_t map[NUM_REGS];
+    unsigned int count = 0;
+    uint16_t addr, start;
+
+    CHECK_STATUS(read_map(dev, map));
+
+    for (addr = 0; addr < NUM_REGS;) {
+        if (is_control(addr) || is_volatile(addr) || map[addr] == s->reg[addr]) {
+            addr++;
+            continue;
+        }
+
+        start = addr;
+        while (addr < NUM_REGS && addr - start < BURST_LEN &&
+               !is_control(addr) && !is_volatile(addr) &&
+               map[addr] != s->reg[addr]) {
+            addr++;
+        }
+
+        CHECK_STATUS(burst_write(dev, start, addr - start, &s->reg[start]));
+        count += addr - start;
+    }
+
+    log_verbose("%s: restored %u registers\n", __FUNCTION__, count);
+
+    return 0;
+}
+
+static int validate(struct bladerf *dev,
+                    struct ad9361_rf_phy *phy,
+                    struct rfic_snapshot const *s)
+{
+    uint8_t product_id, bbpll;
+    int32_t delta;
+
+    CHECK_STATUS(burst_read(dev, REG_PRODUCT_ID, 1, &product_id));
+    if (product_id != s->reg[REG_PRODUCT_ID]) {
+        log_debug("%s: product ID 0x%02x does not match snapshot's 0x%02x\n",
+                  __FUNCTION__, product_id, s->reg[REG_PRODUCT_ID]);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    CHECK_STATUS(burst_read(dev, REG_CH_1_OVERFLOW, 1, &bbpll));
+    if ((bbpll & BBPLL_LOCK) == 0) {
+        log_debug("%s: BBPLL is not locked\n", __FUNCTION__);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    /* Calibration results depend upon temperature */
+    delta = ad9361_get_temp(phy) - s->temp;
+    if (delta < 0) {
+        delta = -delta;
+    }
+
+    if (delta > RFIC_SNAPSHOT_MAX_TEMP_DELTA * 1000) {
+        log_debug("%s: temperature differs from snapshot's by %.1f C\n",
+                  __FUNCTION__, delta / 1000.0);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    return 0;
+}
+
+int rfic_snapshot_finish(struct bladerf *dev, struct ad9361_rf_phy *phy)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct rfic_snapshot *s                = board_data->rfic_snapshot;
+    int status;
+
+    if (s == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    board_data->rfic_snapshot = NULL;
+
+    if (phy == NULL) {
+        free(s);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    status = restore(dev, s);
+    if (status == 0) {
+        status = validate(dev, phy, s);
+    }
+
+    if (status != 0) {
+        log_debug("%s: RFIC snapshot not usable: %s\n", __FUNCTION__,
+                  bladerf_strerror(status));
+    }
+
+    free(s);
+    return status;
+}
+
+void rfic_snapshot_capture(struct bladerf *dev,
+                           struct ad9361_rf_phy *phy,
+                           char const *params)
+{
+    struct rfic_snapshot *s;
+    char key[128];
+    char *path;
+    int status;
+
+    if (!snapshot_enabled(dev) ||
+        snapshot_key(dev, params, key, sizeof(key)) != 0) {
+        return;
+    }
+
+    s = calloc(1, sizeof(*s));
+    if (s == NULL) {
+        return;
+    }
+
+    status = read_map(dev, s->reg);
+    if (status != 0) {
+        log_debug("%s: failed to read register map: %s\n", __FUNCTION__,
+                  bladerf_strerror(status));
+        free(s);
+        return;
+    }
+
+    s->temp = ad9361_get_temp(phy);
+
+    path = snapshot_path(dev);
+    if (path != NULL) {
+        snapshot_store(s, path, key);
+        free(path);
+    }
+
+    free(s);
+}
+
+bool rfic_snapshot_spi_read(struct bladerf *dev, uint16_t cmd, uint64_t *data)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct rfic_snapshot *s;
+    uint16_t const addr  = AD936X_ADDR(cmd);
+    unsigned int const n = ((cmd >> 12) & 0x7) + 1;
+    unsigned int i;
+
+    if (board_data == NULL || board_data->rfic_snapshot == NULL) {
+        return false;
+    }
+
+    s = board_data->rfic_snapshot;
+
+    for (i = 0; i < n && i <= addr; i++) {
+        if (is_volatile(addr - i)) {
+            return false;
+        }
+    }
+
+    *data = 0;
+    for (i = 0; i < n && i <= addr; i++) {
+        uint8_t byte;
+
+        if (!reg_shadow_get(&s->replay, addr - i, &byte)) {
+            byte = s->reg[addr - i];
+        }
+
+        *data |= ((uint64_t)byte) << (56 - 8 * i);
+    }
+
+    return true;
+}
+
+bool rfic_snapshot_spi_write(struct bladerf *dev, uint16_t cmd, uint64_t data)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct rfic_snapshot *s;
+    uint16_t const addr  = AD936X_ADDR(cmd);
+    unsigned int const n = ((cmd >> 12) & 0x7) + 1;
+    bool suppress        = false;
+    unsigned int i;
+
+    if (board_data == NULL || board_data->rfic_snapshot == NULL) {
+        return false;
+    }
+
+    s = board_data->rfic_snapshot;
+
+    for (i = 0; i < n && i <= addr; i++) {
+        uint16_t const byte_addr = addr - i;
+
+        /* Calibrations are not run; their results are restored instead.
+         * Leaving the trigger bits clear in the replayed map also lets the
+         * driver see them as complete. */
+        if (byte_addr == REG_CALIBRATION_CTRL) {
+            suppress = true;
+            continue;
+        }
+
+        reg_shadow_set(&s->replay, byte_addr, (data >> (56 - 8 * i)) & 0xff);
+    }
+
+    return suppress;
+}
@@ -0,0 +1,124 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef BLADERF2_RFIC_SNAPSHOT_H_
+#define BLADERF2_RFIC_SNAPSHOT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+/**
+ * AD9361 register snapshots, for warm initialization of a host-controlled
+ * RFIC
+ *
+ * After a cold initialization, the AD9361's register map is read back with
+ * 8-register SPI bursts and written to the user's bladeRF config directory,
+ * keyed by the device serial, the init parameters in use, the reference
+ * clock source and the library version. The temperature at the time is
+ * recorded along with it.
+ *
+ * On a later open, ad9361_init() is run in replay mode: its register writes
+ * are passed to the device as usual, except for those that start the
+ * baseband, quadrature and DC offset calibrations, while its register reads
+ * are served from the snapshot. Only the PLL lock, ENSM state and
+ * temperature registers are read from the device, so that the clocks and
+ * synthesizers are genuinely brought up. Once ad9361_init() returns, the
+ * registers whose values differ from the snapshot, which include the
+ * calibration results, are restored with SPI bursts.
+ *
+ * The restored state is then validated: the product ID must match, the
+ * BBPLL must be locked and the temperature must be within
+ * RFIC_SNAPSHOT_MAX_TEMP_DELTA of that at capture. Otherwise, the caller
+ * performs a cold initialization, which captures a new snapshot.
+ *
+ * Snapshots may be disabled by defining BLADERF_DISABLE_RFIC_SNAPSHOT in
+ * the environment.
+ */
+
+struct ad9361_rf_phy;
+
+/* Largest temperature change, in degrees C, over which a snapshot's
+ * calibration results are reused */
+#define RFIC_SNAPSHOT_MAX_TEMP_DELTA 10
+
+/**
+ * Load a snapshot for the device and, if one is found, enter replay mode
+ *
+ * @param       dev         Device handle
+ * @param[in]   params      Name of the init parameters about to be used
+ *
+ * @return true if replay mode was entered, false if a cold initialization
+ *         is required
+ */
+bool rfic_snapshot_begin(struct bladerf *dev, char const *params);
+
+/**
+ * Leave replay mode, restore the snapshot's register values and validate
+ * the result
+ *
+ * If ad9361_init() failed in replay mode, this must still be called to
+ * leave replay mode, with `phy` set to NULL.
+ *
+ * @param       dev         Device handle
+ * @param       phy         PHY handle returned by ad9361_init(), or NULL
+ *
+ * @return 0 on success, or a value from \ref RETCODES list if the snapshot
+ *         could not be used and a cold initialization is required
+ */
+int rfic_snapshot_finish(struct bladerf *dev, struct ad9361_rf_phy *phy);
+
+/**
+ * Capture and store a snapshot following a cold initialization. Failures
+ * are logged and are non-fatal.
+ *
+ * @param       dev         Device handle
+ * @param       phy         PHY handle returned by ad9361_init()
+ * @param[in]   params      Name of the init parameters used
+ */
+void rfic_snapshot_capture(struct bladerf *dev,
+                           struct ad9361_rf_phy *phy,
+                           char const *params);
+
+/**
+ * Serve an AD9361 SPI read in replay mode
+ *
+ * @param       dev         Device handle
+ * @param[in]   cmd         SPI command word
+ * @param[out]  data        Read data, with the first byte in the MSB
+ *
+ * @return true if the read was served, false if it must go to the device
+ */
+bool rfic_snapshot_spi_read(struct bladerf *dev, uint16_t cmd, uint64_t *data);
+
+/**
+ * Record an AD9361 SPI write in replay mode
+ *
+ * @param       dev         Device handle
+ * @param[in]   cmd         SPI command word
+ * @param[in]   data        Write data, with the first byte in the MSB
+ *
+ * @return true if the write must not be passed to the device
+ */
+bool rfic_snapshot_spi_write(struct bladerf *dev, uint16_t cmd, uint64_t data);
+
+#endif
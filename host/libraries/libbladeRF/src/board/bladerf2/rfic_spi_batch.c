@@ -0,0 +1,117 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "log.h"
+
+#include "backend/backend.h"
+#include "board/board.h"
+
+#include "common.h"
+#include "rfic_spi_batch.h"
+
+static struct rfic_spi_batch *get_batch(struct bladerf *dev)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (board_data == NULL) {
+        return NULL;
+    }
+
+    return &board_data->rfic_spi_batch;
+}
+
+void rfic_spi_batch_begin(struct bladerf *dev)
+{
+    struct rfic_spi_batch *b = get_batch(dev);
+
+    if (b != NULL) {
+        b->active = true;
+    }
+}
+
+int rfic_spi_batch_end(struct bladerf *dev)
+{
+    struct rfic_spi_batch *b = get_batch(dev);
+
+    if (b != NULL) {
+        b->active = false;
+    }
+
+    return rfic_spi_batch_flush(dev);
+}
+
+bool rfic_spi_batch_write(struct bladerf *dev,
+                          uint16_t cmd,
+                          uint64_t data,
+                          int *status)
+{
+    struct rfic_spi_batch *b = get_batch(dev);
+    struct backend_ad9361_op *op;
+
+    *status = 0;
+
+    if (b == NULL || !b->active || AD936X_CNT(1) != (cmd & AD936X_CNT(8))) {
+        return false;
+    }
+
+    if (b->count == RFIC_SPI_BATCH_LEN) {
+        *status = rfic_spi_batch_flush(dev);
+    }
+
+    op        = &b->ops[b->count++];
+    op->addr  = AD936X_ADDR(cmd);
+    op->data  = (data >> 56) & 0xff;
+    op->write = true;
+
+    return true;
+}
+
+int rfic_spi_batch_flush(struct bladerf *dev)
+{
+    struct rfic_spi_batch *b = get_batch(dev);
+    unsigned int count;
+    unsigned int i;
+    int status = 0;
+
+    if (b == NULL || b->count == 0) {
+        return 0;
+    }
+
+    count    = b->count;
+    b->count = 0;
+
+    if (dev->backend->ad9361_spi_batch != NULL) {
+        status = dev->backend->ad9361_spi_batch(dev, b->ops, count);
+    } else {
+        for (i = 0; i < count && status == 0; i++) {
+            status = dev->backend->ad9361_spi_write(
+                dev, AD936X_WRITE | b->ops[i].addr,
+                ((uint64_t)b->ops[i].data) << 56);
+        }
+    }
+
+    if (status != 0) {
+        log_debug("%s: %u queued writes failed: %s\n", __FUNCTION__, count,
+                  bladerf_strerror(status));
+    }
+
+    return status;
+}
@@ -0,0 +1,102 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef BLADERF2_RFIC_SPI_BATCH_H_
+#define BLADERF2_RFIC_SPI_BATCH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+#include "backend/backend.h"
+
+/**
+ * Batching of AD9361 SPI writes, for a host-controlled RFIC
+ *
+ * Between rfic_spi_batch_begin() and rfic_spi_batch_end(), single-byte
+ * register writes issued by the AD9361 driver are queued rather than
+ * performed one request at a time. The queue is passed to the backend's
+ * ad9361_spi_batch function, which carries several accesses in each request
+ * when the FPGA supports it, before any read or multi-byte access, when it
+ * fills, and when the batch ends. The device therefore sees the same
+ * sequence of accesses, and any register the driver polls reflects the
+ * writes preceding it.
+ *
+ * Delays requested by the driver do not flush the queue, so a batch should
+ * only enclose driver calls whose writes are not timed against each other,
+ * such as FIR coefficient and clock chain loads.
+ */
+
+/* Writes held before the queue is flushed. A multiple of
+ * NIOS_PKT_16x8_BATCH_MAX, so that full requests are sent. */
+#define RFIC_SPI_BATCH_LEN 32
+
+struct rfic_spi_batch {
+    bool active;
+    unsigned int count;
+    struct backend_ad9361_op ops[RFIC_SPI_BATCH_LEN];
+};
+
+/**
+ * Start queueing single-byte AD9361 register writes
+ *
+ * @param       dev         Device handle
+ */
+void rfic_spi_batch_begin(struct bladerf *dev);
+
+/**
+ * Perform any queued writes and stop queueing
+ *
+ * @param       dev         Device handle
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int rfic_spi_batch_end(struct bladerf *dev);
+
+/**
+ * Queue an AD9361 SPI write, if a batch is active and the write is a
+ * single-byte one
+ *
+ * @param       dev         Device handle
+ * @param[in]   cmd         SPI command word
+ * @param[in]   data        Write data, with the first byte in the MSB
+ * @param[out]  status      Set to the status of any flush performed to make
+ *                          room for the write
+ *
+ * @return true if the write was queued, false if it must be performed now,
+ *         after calling rfic_spi_batch_flush()
+ */
+bool rfic_spi_batch_write(struct bladerf *dev,
+                          uint16_t cmd,
+                          uint64_t data,
+                          int *status);
+
+/**
+ * Perform any queued writes
+ *
+ * @param       dev         Device handle
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int rfic_spi_batch_flush(struct bladerf *dev);
+
+#endif
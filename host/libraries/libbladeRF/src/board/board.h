@@ -30,6 +30,8 @@
 #include "thread.h"
 
 #include "backend/backend.h"
+#include "helpers/state_cache.h"
+#include "helpers/stream_mem.h"
 
 /* Device capabilities are stored in a 64-bit mask.
  *
@@ -115,6 +117,123 @@
  */
 #define BLADERF_CAP_FPGA_PACKET_META (1 << 12)
 
+/**
+ * FPGA v0.13.0 on the bladeRF 2 introduces 8-bit sample packing, for the
+ * SC8 Q7 sample formats.
+ */
+#define BLADERF_CAP_FPGA_8BIT_SAMPLES (1 << 13)
+
+/**
+ * FPGA v0.13.0 on the bladeRF 1 introduces the 8x8 batch packet format, which
+ * carries multiple LMS6002D or Si5338 register accesses in a single request.
+ */
+#define BLADERF_CAP_FPGA_8x8_BATCH (1 << 14)
+
+/**
+ * FPGA v0.13.0 on the bladeRF 1 introduces the 8x8 block packet format, which
+ * reads or writes a range of consecutive LMS6002D or Si5338 registers in a
+ * single request.
+ */
+#define BLADERF_CAP_FPGA_8x8_BLOCK (1 << 15)
+
+/**
+ * FPGA v0.13.0 on the bladeRF 2.0 Micro introduces the RFIC WAIT command,
+ * which allows the host to wait upon queued RFIC commands with a single
+ * request.
+ */
+#define BLADERF_CAP_FPGA_RFIC_WAIT (1 << 16)
+
+/**
+ * FPGA v0.13.0 on the bladeRF 2.0 Micro allows the host to read and write
+ * the fast lock profiles stored in NIOS II memory.
+ */
+#define BLADERF_CAP_FPGA_FASTLOCK_ACCESS (1 << 17)
+
+/**
+ * FPGA v0.13.0 on the bladeRF 2.0 Micro accepts gain, RF port, bandwidth, and
+ * TX mute changes in the scheduled retune queue.
+ */
+#define BLADERF_CAP_FPGA_SCHEDULED_PARAMS (1 << 18)
+
+/**
+ * FPGA v0.13.0 records the start, completion, and PLL lock status of the
+ * most recent retune of each module.
+ */
+#define BLADERF_CAP_FPGA_RETUNE_STATS (1 << 19)
+
+/**
+ * FPGA v0.13.0 on the bladeRF x40/x115 can perform the LMS6002D VCOCAP search
+ * on the NIOS II, using a single 8x16 request.
+ */
+#define BLADERF_CAP_FPGA_VCOCAP_SEARCH (1 << 20)
+
+/**
+ * FPGA v0.13.0 on the bladeRF 2.0 Micro can schedule an RX and a TX retune as
+ * a single queue entry, applied together at one RX timestamp.
+ */
+#define BLADERF_CAP_FPGA_RETUNE_PAIR (1 << 21)
+
+/**
+ * FPGA v0.13.0 can cancel or replace an individual entry of the scheduled
+ * retune queue, identified by its timestamp.
+ */
+#define BLADERF_CAP_FPGA_RETUNE_EDIT (1 << 22)
+
+/**
+ * FPGA v0.13.0 on the bladeRF x40/x115 can apply DC offset and IQ balance
+ * corrections along with a scheduled retune.
+ */
+#define BLADERF_CAP_FPGA_RETUNE_CORR (1 << 23)
+
+/**
+ * FPGA v0.13.0 on the bladeRF x40/x115 can run an LMS6002D DC calibration
+ * loop, or load a DC calibration value, on the NIOS II using a single 8x16
+ * request.
+ */
+#define BLADERF_CAP_FPGA_LMS_DC_CAL (1 << 24)
+
+/**
+ * FPGA v0.13.0 introduces the timestamp latch packet format, which latches a
+ * timestamp as the request arrives and reports the time spent responding.
+ */
+#define BLADERF_CAP_FPGA_TS_LATCH (1 << 25)
+
+/**
+ * FPGA v0.13.0 on the bladeRF 2.0 micro adds an RX digital downconverter,
+ * which mixes and decimates received samples.
+ */
+#define BLADERF_CAP_FPGA_RX_DDC (1 << 26)
+
+/**
+ * FPGA v0.13.0 on the bladeRF 2.0 micro adds a TX digital upconverter, which
+ * interpolates and mixes transmitted samples.
+ */
+#define BLADERF_CAP_FPGA_TX_DUC (1 << 27)
+
+/**
+ * FPGA v0.13.0 on the bladeRF 2.0 micro adds an RX power detector, which
+ * reports per-block mean and peak power.
+ */
+#define BLADERF_CAP_FPGA_RX_POWER (1 << 28)
+
+/**
+ * FPGA v0.13.0 on the bladeRF 2.0 micro adds an RX burst gate, which emits
+ * timestamped packets only while a channel's power exceeds a threshold.
+ */
+#define BLADERF_CAP_FPGA_RX_BURST_GATE (1 << 29)
+
+/**
+ * FPGA v0.13.0 on the bladeRF 2.0 micro reports the sample FIFO fill levels
+ * and high-water marks.
+ */
+#define BLADERF_CAP_FPGA_FIFO_LEVEL (1 << 30)
+
+/**
+ * FPGA v0.13.0 on the bladeRF x40/x115 allows LMS6002D gain stage settings to
+ * be scheduled in the retune queue.
+ */
+#define BLADERF_CAP_FPGA_RETUNE_GAIN (((uint64_t)1) << 31)
+
 /**
  * Firmware 1.7.1 introduced firmware-based loopback
  */
@@ -156,6 +275,100 @@
  */
 #define BLADERF_CAP_FW_SHORT_PACKET (((uint64_t)1) << 38)
 
+/**
+ * FX3 firmware v2.5.0 introduced multi-page flash reads and writes over the
+ * SPI flash interface's bulk endpoints.
+ */
+#define BLADERF_CAP_FW_FLASH_BULK (((uint64_t)1) << 39)
+
+/**
+ * FX3 firmware v2.5.0 introduced on-device SHA-256 digests of flash pages.
+ */
+#define BLADERF_CAP_FW_FLASH_HASH (((uint64_t)1) << 40)
+
+/**
+ * FX3 firmware v2.5.0 introduced loading of compressed FPGA bitstreams.
+ */
+#define BLADERF_CAP_FW_FPGA_COMPRESSED (((uint64_t)1) << 41)
+
+/**
+ * FX3 firmware v2.5.0 introduced a request that waits for the FPGA to report
+ * that it has been configured.
+ */
+#define BLADERF_CAP_FW_FPGA_CONF_WAIT (((uint64_t)1) << 42)
+
+/**
+ * FX3 firmware v2.5.0 introduced recording a digest of the FPGA image loaded
+ * by the host.
+ */
+#define BLADERF_CAP_FW_FPGA_HASH (((uint64_t)1) << 43)
+
+/**
+ * FX3 firmware v2.5.0 introduced configurable DMA buffering of the sample
+ * endpoints.
+ */
+#define BLADERF_CAP_FW_SAMPLE_DMA (((uint64_t)1) << 44)
+
+/**
+ * FX3 firmware v2.5.0 introduced counters of the sample paths.
+ */
+#define BLADERF_CAP_FW_STATS (((uint64_t)1) << 45)
+
+/**
+ * FPGA v0.13.0 on the bladeRF 2.0 micro allows several single-byte AD9361
+ * register accesses to be carried in a single NIOS II request.
+ */
+#define BLADERF_CAP_FPGA_16x8_BATCH (((uint64_t)1) << 46)
+
+/**
+ * FPGA v0.13.0 on the bladeRF 2.0 micro allows RFFE control changes to be
+ * scheduled in the retune queue.
+ */
+#define BLADERF_CAP_FPGA_SCHEDULED_RFFE (((uint64_t)1) << 47)
+
+/**
+ * FPGA v0.13.0 on the bladeRF 2.0 micro can capture a TX waveform into
+ * block RAM and play it repeatedly.
+ */
+#define BLADERF_CAP_FPGA_TX_LOOP (((uint64_t)1) << 48)
+
+/**
+ * FPGA v0.13.0 on the bladeRF 2.0 micro can fire a trigger at a scheduled
+ * timestamp, and records the timestamp at which a trigger fired.
+ */
+#define BLADERF_CAP_FPGA_TRIGGER_TIME (((uint64_t)1) << 49)
+
+/**
+ * FPGA v0.13.0 on the bladeRF x40/x115 reports the VCTCXO tamer's trim and
+ * slope, and can start disciplining from a trim and slope saved earlier.
+ */
+#define BLADERF_CAP_FPGA_TAMER_SEED (((uint64_t)1) << 50)
+
+struct bladerf_sync;
+struct sync_duplex;
+struct ctrl_queue;
+struct ctrl_trace;
+struct timeline;
+struct time_sync;
+struct telemetry;
+struct shm_server;
+
+/* Number of channels for which hop tables may be loaded */
+#define HOP_TABLE_CHANNELS 4
+
+/* Automatic sizing of the synchronous interface's stream */
+struct sync_auto {
+    bool enabled;                  /* Last sync config was sized automatically */
+    unsigned int latency_us;       /* Target latency. 0 selects the default. */
+    unsigned int num_buffers;      /* Sizing to use instead of deriving it */
+    unsigned int buffer_size;      /* from the latency. 0 if unset. */
+    unsigned int num_transfers;
+    bladerf_channel_layout layout; /* Configuration to reapply when resizing */
+    bladerf_format format;
+    unsigned int stream_timeout;
+    struct bladerf_sync *sync;     /* The board's sync handle */
+};
+
 struct bladerf {
     /* Handle lock - to ensure atomic access to control and configuration
      * operations */
@@ -176,6 +389,11 @@ struct bladerf {
     /* Flash architecture */
     struct bladerf_flash_arch *flash_arch;
 
+    /* Method used to write firmware and FPGA images to flash, and the
+     * results of the most recent such write */
+    bladerf_flash_write_mode flash_write_mode;
+    struct bladerf_flash_write_stats flash_write_stats;
+
     /* Board's private data */
     void *board_data;
 
@@ -184,6 +402,89 @@ struct bladerf {
 
     /* XB's private data */
     void *xb_data;
+
+    /* Scheduling attributes for stream threads, indexed by direction */
+    struct bladerf_stream_thread_attrs stream_thread_attrs[2];
+
+    /* BLADERF_STREAM_MEM_* flags for stream buffer allocation */
+    uint32_t stream_mem_flags;
+
+    /* Stream buffer regions retained across stream teardown, regions
+     * registered by the application, and their lock */
+    MUTEX stream_mem_lock;
+    struct stream_mem stream_mem_pool[STREAM_MEM_POOL_SIZE];
+    struct stream_mem_region stream_mem_user[STREAM_MEM_USER_REGIONS];
+
+    /* Sync worker threads retained across sync_init() calls. Created by the
+     * first sync_init(). */
+    struct sync_worker_pool *sync_worker_pool;
+
+    /* Automatic sync interface sizing, indexed by direction */
+    struct sync_auto sync_auto[2];
+
+    /* Low-latency sync profile, indexed by direction. Applied by the next
+     * sync_init(). */
+    bool sync_low_latency[2];
+
+    /* Non-blocking sync interface calls, indexed by direction. Takes effect
+     * immediately. */
+    bool sync_nonblock[2];
+
+    /* Duration of the RX sync interface's timestamp-indexed capture, in ms.
+     * Applied by the next sync_init(). */
+    unsigned int rx_capture_ms;
+
+    /* Deinterleave BLADERF_RX_X2 sync streams into per-channel queues.
+     * Applied by the next sync_init(). */
+    bool rx_channel_queues;
+
+    /* Number of RX taps, and the policy of each. Applied by the next
+     * sync_init(). */
+    unsigned int rx_taps;
+    bladerf_rx_tap_policy rx_tap_policy[BLADERF_RX_TAPS_MAX];
+
+    /* Output rate of the RX resampler, or 0 if disabled. Applied by the next
+     * sync_init(). */
+    struct bladerf_rational_rate rx_resample_rate;
+
+    /* Wakeup shared by the RX and TX sync interfaces for
+     * bladerf_sync_rxtx(). Created upon the first call. */
+    struct sync_duplex *sync_duplex;
+
+    /* Queue of asynchronous control operations. Created upon the first
+     * submission. */
+    struct ctrl_queue *ctrl_queue;
+
+    /* Control-path trace. Created when tracing is first enabled. */
+    struct ctrl_trace *ctrl_trace;
+
+    /* Stream timeline. Created when it is first enabled. */
+    struct timeline *timeline;
+
+    /* Calibration cache. Created when it is first enabled for a channel. */
+    struct cal_cache *cal_cache;
+
+    /* RX sample calibration tables. Created when a table is first loaded. */
+    struct sample_cal *sample_cal;
+
+    /* Host-side RX AGC. Created when it is first enabled for a channel. */
+    struct rx_agc *rx_agc;
+
+    /* Host and device clock correlation. Created when it is first enabled. */
+    struct time_sync *time_sync;
+
+    /* Telemetry sampler. Created when it is first enabled. */
+    struct telemetry *telemetry;
+
+    /* Shared-memory device server. Created by bladerf_shm_server_start(). */
+    struct shm_server *shm_server;
+
+    /* Hop tables loaded via bladerf_set_hop_table(), indexed by channel */
+    struct bladerf_quick_tune *hop_table[HOP_TABLE_CHANNELS];
+    unsigned int hop_table_len[HOP_TABLE_CHANNELS];
+
+    /* Device state returned by the getters */
+    struct state_cache state_cache;
 };
 
 struct board_fns {
@@ -262,6 +563,10 @@ struct board_fns {
     int (*get_rational_sample_rate)(struct bladerf *dev,
                                     bladerf_channel ch,
                                     struct bladerf_rational_rate *rate);
+    int (*switch_sample_rate)(struct bladerf *dev,
+                              bladerf_channel ch,
+                              bladerf_sample_rate rate,
+                              bladerf_sample_rate *actual);
 
     /* Bandwidth */
     int (*set_bandwidth)(struct bladerf *dev,
@@ -301,6 +606,11 @@ struct board_fns {
                         const char **ports,
                         unsigned int count);
 
+    /* Channel configuration */
+    int (*apply_config)(struct bladerf *dev,
+                        bladerf_channel ch,
+                        const struct bladerf_channel_config *config);
+
     /* Scheduled Tuning */
     int (*get_quick_tune)(struct bladerf *dev,
                           bladerf_channel ch,
@@ -311,6 +621,25 @@ struct board_fns {
                            bladerf_frequency frequency,
                            struct bladerf_quick_tune *quick_tune);
     int (*cancel_scheduled_retunes)(struct bladerf *dev, bladerf_channel ch);
+    int (*cancel_scheduled_retune)(struct bladerf *dev,
+                                   bladerf_channel ch,
+                                   bladerf_timestamp timestamp);
+    int (*replace_scheduled_retune)(struct bladerf *dev,
+                                    bladerf_channel ch,
+                                    bladerf_timestamp timestamp,
+                                    bladerf_frequency frequency,
+                                    struct bladerf_quick_tune *quick_tune);
+    int (*schedule_retune_pair)(struct bladerf *dev,
+                                bladerf_timestamp timestamp,
+                                const struct bladerf_quick_tune *rx,
+                                const struct bladerf_quick_tune *tx);
+    int (*get_retune_stats)(struct bladerf *dev,
+                            bladerf_channel ch,
+                            struct bladerf_retune_stats *stats);
+    int (*schedule_gain)(struct bladerf *dev,
+                         bladerf_channel ch,
+                         bladerf_timestamp timestamp,
+                         int gain);
 
     /* DC/Phase/Gain Correction */
     int (*get_correction)(struct bladerf *dev,
@@ -322,6 +651,15 @@ struct board_fns {
                           bladerf_correction corr,
                           int16_t value);
 
+    /* Transceiver temperature, in degrees C */
+    int (*get_temperature)(struct bladerf *dev, float *val);
+
+    /* Read a set of BLADERF_TELEMETRY_* items, with the handle lock held.
+     * Fails only if none of the items could be read. */
+    int (*read_telemetry)(struct bladerf *dev,
+                          uint32_t items,
+                          struct bladerf_telemetry *t);
+
     /* Trigger */
     int (*trigger_init)(struct bladerf *dev,
                         bladerf_channel ch,
@@ -341,9 +679,17 @@ struct board_fns {
                          bool *fire_requested,
                          uint64_t *resv1,
                          uint64_t *resv2);
+    int (*trigger_fire_at)(struct bladerf *dev,
+                           const struct bladerf_trigger *trigger,
+                           uint64_t timestamp);
+    int (*trigger_fire_time)(struct bladerf *dev,
+                             const struct bladerf_trigger *trigger,
+                             bool *has_fired,
+                             uint64_t *timestamp);
 
     /* Streaming */
     int (*enable_module)(struct bladerf *dev, bladerf_channel ch, bool enable);
+    int (*standby_module)(struct bladerf *dev, bladerf_channel ch);
     int (*init_stream)(struct bladerf_stream **stream,
                        struct bladerf *dev,
                        bladerf_stream_cb callback,
@@ -372,19 +718,102 @@ struct board_fns {
                        unsigned int buffer_size,
                        unsigned int num_transfers,
                        unsigned int stream_timeout);
+    int (*sync_start)(struct bladerf *dev, bladerf_direction dir);
     int (*sync_tx)(struct bladerf *dev,
                    const void *samples,
                    unsigned int num_samples,
                    struct bladerf_metadata *metadata,
                    unsigned int timeout_ms);
+    int (*sync_tx_acquire)(struct bladerf *dev,
+                           void **samples,
+                           unsigned int *num_samples,
+                           unsigned int timeout_ms);
+    int (*sync_tx_commit)(struct bladerf *dev,
+                          const void *samples,
+                          unsigned int num_samples);
     int (*sync_rx)(struct bladerf *dev,
                    void *samples,
                    unsigned int num_samples,
                    struct bladerf_metadata *metadata,
                    unsigned int timeout_ms);
+    int (*sync_rx_planar)(struct bladerf *dev,
+                          void *const samples[],
+                          unsigned int num_samples,
+                          struct bladerf_metadata *metadata,
+                          unsigned int timeout_ms);
+    int (*sync_rx_channel)(struct bladerf *dev,
+                           bladerf_channel ch,
+                           void *samples,
+                           unsigned int num_samples,
+                           struct bladerf_metadata *metadata,
+                           unsigned int timeout_ms);
+    int (*sync_rx_acquire)(struct bladerf *dev,
+                           void **samples,
+                           unsigned int *num_samples,
+                           struct bladerf_metadata *metadata,
+                           unsigned int timeout_ms);
+    int (*sync_rx_release)(struct bladerf *dev, const void *samples);
+    int (*rx_tap_acquire)(struct bladerf *dev,
+                          unsigned int tap,
+                          const void **samples,
+                          unsigned int *num_samples,
+                          struct bladerf_metadata *metadata,
+                          unsigned int timeout_ms);
+    int (*rx_tap_release)(struct bladerf *dev,
+                          unsigned int tap,
+                          const void *samples);
+    int (*sync_rx_deadline)(struct bladerf *dev,
+                            void *samples,
+                            unsigned int num_samples,
+                            struct bladerf_metadata *metadata,
+                            uint64_t deadline_ns);
+    int (*sync_tx_deadline)(struct bladerf *dev,
+                            const void *samples,
+                            unsigned int num_samples,
+                            struct bladerf_metadata *metadata,
+                            uint64_t deadline_ns);
+    int (*sync_rxv)(struct bladerf *dev,
+                    const struct bladerf_sync_iov *iov,
+                    unsigned int iovcnt,
+                    unsigned int *completed,
+                    unsigned int timeout_ms);
+    int (*sync_txv)(struct bladerf *dev,
+                    const struct bladerf_sync_iov *iov,
+                    unsigned int iovcnt,
+                    unsigned int *completed,
+                    unsigned int timeout_ms);
+    int (*sync_rxtx)(struct bladerf *dev,
+                     void *rx_samples,
+                     unsigned int rx_num_samples,
+                     struct bladerf_metadata *rx_metadata,
+                     const void *tx_samples,
+                     unsigned int tx_num_samples,
+                     struct bladerf_metadata *tx_metadata,
+                     uint64_t tx_offset,
+                     unsigned int timeout_ms);
+    int (*get_sync_stats)(struct bladerf *dev,
+                          bladerf_direction dir,
+                          struct bladerf_stream_stats *stats);
+    int (*get_sync_latency)(struct bladerf *dev,
+                            bladerf_direction dir,
+                            struct bladerf_sync_latency *latency);
+    int (*get_sync_poll_handle)(struct bladerf *dev,
+                                bladerf_direction dir,
+                                bladerf_poll_handle *handle);
+    int (*read_rx_capture)(struct bladerf *dev,
+                           void *samples,
+                           unsigned int num_samples,
+                           struct bladerf_metadata *metadata);
+    int (*get_rx_capture_range)(struct bladerf *dev,
+                                bladerf_timestamp *oldest,
+                                bladerf_timestamp *newest);
     int (*get_timestamp)(struct bladerf *dev,
                          bladerf_direction dir,
                          bladerf_timestamp *timestamp);
+    int (*get_timestamp_latch)(struct bladerf *dev,
+                               bladerf_direction dir,
+                               bladerf_timestamp *timestamp,
+                               uint32_t *hold);
 
     /* FPGA/Firmware Loading/Flashing */
     int (*load_fpga)(struct bladerf *dev, const uint8_t *buf, size_t length);
@@ -409,6 +838,49 @@ struct board_fns {
     int (*get_rx_mux)(struct bladerf *dev, bladerf_rx_mux *mode);
     int (*set_rx_mux)(struct bladerf *dev, bladerf_rx_mux mode);
 
+    /* RX digital downconverter */
+    int (*set_rx_ddc)(struct bladerf *dev,
+                      int64_t offset,
+                      unsigned int decimation);
+    int (*get_rx_ddc)(struct bladerf *dev,
+                      int64_t *offset,
+                      unsigned int *decimation);
+
+    /* TX digital upconverter */
+    int (*set_tx_duc)(struct bladerf *dev,
+                      int64_t offset,
+                      unsigned int interpolation);
+    int (*get_tx_duc)(struct bladerf *dev,
+                      int64_t *offset,
+                      unsigned int *interpolation);
+
+    /* RX power detector */
+    int (*set_rx_power_detector)(struct bladerf *dev,
+                                 unsigned int block_length);
+    int (*get_rx_power_detector)(struct bladerf *dev,
+                                 unsigned int *block_length);
+    int (*get_rx_power)(struct bladerf *dev,
+                        bladerf_channel ch,
+                        struct bladerf_rx_power *power);
+
+    /* RX burst gate */
+    int (*set_rx_burst_gate)(struct bladerf *dev,
+                             const struct bladerf_rx_burst_gate *gate);
+    int (*get_rx_burst_gate)(struct bladerf *dev,
+                             struct bladerf_rx_burst_gate *gate);
+
+    /* Sample FIFO levels */
+    int (*get_fifo_levels)(struct bladerf *dev,
+                           struct bladerf_fifo_levels *levels,
+                           bool reset_high_water);
+
+    /* TX waveform loop */
+    int (*tx_loop_load)(struct bladerf *dev, unsigned int num_samples);
+    int (*tx_loop_start)(struct bladerf *dev, uint64_t start, uint64_t stop);
+    int (*tx_loop_stop)(struct bladerf *dev, uint64_t timestamp);
+    int (*get_tx_loop_status)(struct bladerf *dev,
+                              struct bladerf_tx_loop_status *status);
+
     /* Low-level VCTCXO Tamer Mode */
     int (*set_vctcxo_tamer_mode)(struct bladerf *dev,
                                  bladerf_vctcxo_tamer_mode mode);
@@ -455,6 +927,21 @@ struct board_fns {
     const char *name;
 };
 
+/* Fields decoded from the calibration and OTP regions. Each region is
+ * decoded in a single pass on first use, and the decoded values are
+ * discarded along with the in-memory copy of the calibration region. */
+struct bladerf_flash_fields {
+    bool cal_decoded;   /**< Calibration fields below are valid */
+    int dac_status;     /**< Result of decoding the "DAC" field */
+    char dac[7];        /**< VCTCXO DAC trim */
+    int size_status;    /**< Result of decoding the "B" field */
+    char size[7];       /**< FPGA size */
+
+    bool otp_decoded;   /**< OTP fields below are valid */
+    int serial_status;  /**< Result of decoding the "S" field */
+    char serial[BLADERF_SERIAL_LENGTH]; /**< Serial number */
+};
+
 /* Information about the (SPI) flash architecture */
 struct bladerf_flash_arch {
     enum { STATUS_FLASH_UNINITIALIZED, STATUS_SUCCESS, STATUS_ASSUMED } status;
@@ -466,6 +953,12 @@ struct bladerf_flash_arch {
     uint32_t ebsize_bytes;   /**< Flash erase block size, in bytes */
     uint32_t num_pages;      /**< Size of flash, in pages */
     uint32_t num_ebs;        /**< Size of flash, in erase blocks */
+
+    char *cal; /**< Copy of the calibration region, or NULL if unavailable.
+                *   See probe_cache_read(). */
+
+    struct bladerf_flash_fields fields; /**< Decoded calibration and OTP
+                                         *   fields. See flash.c. */
 };
 
 /* Boards */
@@ -68,6 +68,11 @@ void bladerf_free_device_list(struct bladerf_devinfo *devices)
     free(devices);
 }
 
+int bladerf_set_device_monitor(bool enable)
+{
+    return backend_set_device_monitor(enable);
+}
+
 /******************************************************************************/
 /* Device Information Helpers */
 /******************************************************************************/
@@ -194,3 +194,38 @@ int fpga_trigger_state(struct bladerf *dev, const struct bladerf_trigger *trigge
     return status;
 }
 
+int fpga_trigger_fire_at(struct bladerf *dev,
+                         const struct bladerf_trigger *trigger,
+                         uint64_t timestamp)
+{
+    if (trigger->role != BLADERF_TRIGGER_ROLE_MASTER) {
+        log_debug("Only a trigger master may schedule a fire.\n");
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (trigger->channel != BLADERF_CHANNEL_RX(0) &&
+        trigger->channel != BLADERF_CHANNEL_TX(0))
+        return BLADERF_ERR_INVAL;
+
+    if (!is_valid_signal(trigger->signal))
+        return BLADERF_ERR_INVAL;
+
+    return dev->backend->trigger_fire_at(dev, trigger->channel,
+                                         trigger->signal, timestamp);
+}
+
+int fpga_trigger_fire_time(struct bladerf *dev,
+                           const struct bladerf_trigger *trigger,
+                           bool *fired,
+                           uint64_t *timestamp)
+{
+    if (trigger->channel != BLADERF_CHANNEL_RX(0) &&
+        trigger->channel != BLADERF_CHANNEL_TX(0))
+        return BLADERF_ERR_INVAL;
+
+    if (!is_valid_signal(trigger->signal))
+        return BLADERF_ERR_INVAL;
+
+    return dev->backend->trigger_fire_time(dev, trigger->channel,
+                                           trigger->signal, fired, timestamp);
+}
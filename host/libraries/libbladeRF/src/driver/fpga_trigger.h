@@ -125,4 +125,34 @@ int fpga_trigger_state(struct bladerf *dev,
                        bool *has_fired,
                        bool *fire_requested);
 
+/**
+ * Schedule a master trigger to fire at a timestamp
+ *
+ * @param       dev         Device handle
+ * @param[in]   trigger     Armed master trigger to fire
+ * @param[in]   timestamp   Time to fire at, in the units of the trigger
+ *                          channel's timestamp counter
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int fpga_trigger_fire_at(struct bladerf *dev,
+                         const struct bladerf_trigger *trigger,
+                         uint64_t timestamp);
+
+/**
+ * Query the timestamp at which a trigger fired
+ *
+ * @param       dev         Device handle
+ * @param[in]   trigger     Trigger to query
+ * @param[out]  fired       Set to true if the trigger has fired since it was
+ *                          armed
+ * @param[out]  timestamp   If so, set to the time at which it fired
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int fpga_trigger_fire_time(struct bladerf *dev,
+                           const struct bladerf_trigger *trigger,
+                           bool *fired,
+                           uint64_t *timestamp);
+
 #endif
@@ -55,6 +55,7 @@ struct fx3_firmware {
     uint32_t data_len;
 
     uint32_t entry_addr;
+    uint32_t checksum;
 
     uint32_t num_sections;
     uint32_t curr_section;
@@ -215,6 +216,7 @@ static int scan_fw_sections(struct fx3_firmware *fw)
             status = BLADERF_ERR_INVAL;
         } else {
             log_verbose("Firmware checksum OK.\n");
+            fw->checksum = checksum;
             fw->section_offset = FX3_HDR_IMAGE_LEN0_IDX;
         }
     }
@@ -336,6 +338,19 @@ bool fx3_fw_next_section(struct fx3_firmware *fw, uint32_t *section_addr,
     return true;
 }
 
+void fx3_fw_rewind(struct fx3_firmware *fw)
+{
+    assert(fw != NULL);
+    fw->curr_section = 0;
+    fw->section_offset = FX3_HDR_IMAGE_LEN0_IDX;
+}
+
+uint32_t fx3_fw_checksum(const struct fx3_firmware *fw)
+{
+    assert(fw != NULL);
+    return fw->checksum;
+}
+
 uint32_t fx3_fw_entry_point(const struct fx3_firmware *fw)
 {
     assert(fw != NULL);
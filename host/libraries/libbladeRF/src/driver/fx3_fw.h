@@ -69,6 +69,22 @@ bool fx3_fw_next_section(struct fx3_firmware *fw,
                          uint8_t **section_data,
                          uint32_t *section_len);
 
+/**
+ * Reset section iteration, such that the next call to fx3_fw_next_section()
+ * returns the first section again.
+ *
+ * @param[inout]    fw  Handle FX3 firmware data
+ */
+void fx3_fw_rewind(struct fx3_firmware *fw);
+
+/**
+ * @param[in]   fw              Handle FX3 firmware data
+ *
+ * @return The image checksum: the sum of all section data, taken as 32-bit
+ * little-endian words.
+ */
+uint32_t fx3_fw_checksum(const struct fx3_firmware *fw);
+
 /**
  * @param[in]   fw              Handle FX3 firmware data
  *
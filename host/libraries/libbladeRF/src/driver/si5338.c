@@ -219,37 +219,50 @@ static void si5338_pack_regs(struct si5338_multisynth *ms)
     return ;
 }
 
+/* Shadow copy of a sample clock multisynth's registers, if kept */
+static inline bool si5338_has_shadow(struct si5338_cache *cache,
+                                     const struct si5338_multisynth *ms)
+{
+    return cache != NULL && (ms->index == 1 || ms->index == 2);
+}
+
+void si5338_cache_invalidate(struct si5338_cache *cache)
+{
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(cache->shadow); i++) {
+        cache->shadow[i].valid = false;
+    }
+}
+
 static int si5338_write_multisynth(struct bladerf *dev,
+                                   struct si5338_cache *cache,
                                    struct si5338_multisynth *ms)
 {
     int i, status;
-    uint8_t r_power, r_count, val;
+    uint8_t r_power, r_count, enable, r_val;
+    struct backend_reg_op ops[12];
+    unsigned int n = 0;
+    bool have_shadow = false;
 
     log_verbose("Writing MS%d\n", ms->index);
 
-    /* Write out the enables */
-    status = dev->backend->si5338_read(dev, 36 + ms->index, &val);
-    if (status < 0) {
-        si5338_log_read_error(status, bladerf_strerror(status));
-        return status;
-    }
-    val |= ms->enable;
-    log_verbose("Wrote enable register: 0x%2.2x\n", val);
-    status = dev->backend->si5338_write(dev, 36 + ms->index, val);
-    if (status < 0) {
-        si5338_log_write_error(status, bladerf_strerror(status));
-        return status;
+    if (si5338_has_shadow(cache, ms)) {
+        have_shadow = cache->shadow[ms->index].valid;
     }
 
-    /* Write out the registers */
-    for (i = 0 ; i < 10 ; i++) {
-        status = dev->backend->si5338_write(dev, ms->base + i, *(ms->regs+i));
+    /* The enables, registers, and r value are written out in a single
+     * batch, in that order */
+    if (have_shadow) {
+        enable = cache->shadow[ms->index].enable;
+    } else {
+        status = dev->backend->si5338_read(dev, 36 + ms->index, &enable);
         if (status < 0) {
-            si5338_log_write_error(status, bladerf_strerror(status));
+            si5338_log_read_error(status, bladerf_strerror(status));
             return status;
         }
-        log_verbose("Wrote regs[%d]: 0x%2.2x\n", i, *(ms->regs+i));
     }
+    enable |= ms->enable;
 
     /* Calculate r_power from c_count */
     r_power = 0;
@@ -260,52 +273,116 @@ static int si5338_write_multisynth(struct bladerf *dev,
     }
 
     /* Set the r value to the log2(r_count) to match Figure 18 */
-    val = 0xc0;
-    val |= (r_power<<2);
+    r_val = 0xc0;
+    r_val |= (r_power<<2);
 
-    log_verbose("Wrote r register: 0x%2.2x\n", val);
+    /* When the current register values are known, only those that differ
+     * are written */
+    if (!have_shadow || enable != cache->shadow[ms->index].enable) {
+        log_verbose("Writing enable register: 0x%2.2x\n", enable);
+        ops[n].addr  = 36 + ms->index;
+        ops[n].data  = enable;
+        ops[n].write = true;
+        n++;
+    }
 
-    status = dev->backend->si5338_write(dev, 31 + ms->index, val);
+    for (i = 0 ; i < 10 ; i++) {
+        if (!have_shadow || ms->regs[i] != cache->shadow[ms->index].regs[i]) {
+            log_verbose("Writing regs[%d]: 0x%2.2x\n", i, ms->regs[i]);
+            ops[n].addr  = ms->base + i;
+            ops[n].data  = ms->regs[i];
+            ops[n].write = true;
+            n++;
+        }
+    }
+
+    if (!have_shadow || r_val != cache->shadow[ms->index].r) {
+        log_verbose("Writing r register: 0x%2.2x\n", r_val);
+        ops[n].addr  = 31 + ms->index;
+        ops[n].data  = r_val;
+        ops[n].write = true;
+        n++;
+    }
+
+    if (n == 0) {
+        log_verbose("MS%d is already configured\n", ms->index);
+        return 0;
+    }
+
+    status = dev->backend->si5338_batch(dev, ops, n);
     if (status < 0) {
         si5338_log_write_error(status, bladerf_strerror(status));
     }
 
+    if (si5338_has_shadow(cache, ms)) {
+        /* After a failure, the state of the part is unknown */
+        cache->shadow[ms->index].valid = (status >= 0);
+        cache->shadow[ms->index].enable = enable;
+        memcpy(cache->shadow[ms->index].regs, ms->regs, sizeof(ms->regs));
+        cache->shadow[ms->index].r = r_val;
+    }
+
     return status ;
 }
 
 static int si5338_read_multisynth(struct bladerf *dev,
+                                  struct si5338_cache *cache,
                                   struct si5338_multisynth *ms)
 {
     int i, status;
     uint8_t val;
+    struct backend_reg_op ops[12];
 
     log_verbose("Reading MS%d\n", ms->index);
 
-    /* Read the enable bits */
-    status = dev->backend->si5338_read(dev, 36 + ms->index, &val);
-    if (status < 0) {
-        si5338_log_read_error(status, bladerf_strerror(status));
-        return status ;
-    }
-    ms->enable = val&7;
-    log_verbose("Read enable register: 0x%2.2x\n", val);
+    if (si5338_has_shadow(cache, ms) && cache->shadow[ms->index].valid) {
+        /* The registers hold what was last written or read */
+        ops[0].data = cache->shadow[ms->index].enable;
+        for (i = 0; i < 10; i++) {
+            ops[i + 1].data = cache->shadow[ms->index].regs[i];
+        }
+        ops[11].data = cache->shadow[ms->index].r;
+    } else {
+        /* Read the enable bits, all of the multisynth registers, and the
+         * RxDIV register in a single batch */
+        ops[0].addr = 36 + ms->index;
+        for (i = 0; i < 10; i++) {
+            ops[i + 1].addr = ms->base + i;
+        }
+        ops[11].addr = 31 + ms->index;
 
-    /* Read all of the multisynth registers */
-    for (i = 0; i < 10; i++) {
-        status = dev->backend->si5338_read(dev, ms->base + i, ms->regs+i);
+        for (i = 0; i < (int) ARRAY_SIZE(ops); i++) {
+            ops[i].data  = 0;
+            ops[i].write = false;
+        }
+
+        status = dev->backend->si5338_batch(dev, ops, ARRAY_SIZE(ops));
         if (status < 0) {
             si5338_log_read_error(status, bladerf_strerror(status));
             return status;
         }
-        log_verbose("Read regs[%d]: 0x%2.2x\n", i, *(ms->regs+i));
+
+        if (si5338_has_shadow(cache, ms)) {
+            cache->shadow[ms->index].valid = true;
+            cache->shadow[ms->index].enable = ops[0].data;
+            for (i = 0; i < 10; i++) {
+                cache->shadow[ms->index].regs[i] = ops[i + 1].data;
+            }
+            cache->shadow[ms->index].r = ops[11].data;
+        }
     }
 
-    /* Populate the RxDIV value from the register */
-    status = dev->backend->si5338_read(dev, 31 + ms->index, &val);
-    if (status < 0) {
-        si5338_log_read_error(status, bladerf_strerror(status));
-        return status;
+    val = ops[0].data;
+    ms->enable = val&7;
+    log_verbose("Read enable register: 0x%2.2x\n", val);
+
+    for (i = 0; i < 10; i++) {
+        ms->regs[i] = ops[i + 1].data;
+        log_verbose("Read regs[%d]: 0x%2.2x\n", i, ms->regs[i]);
     }
+
+    /* Populate the RxDIV value from the register */
+    val = ops[11].data;
     /* RxDIV is stored as a power of 2, so restore it on readback */
     log_verbose("Read r register: 0x%2.2x\n", val);
     val = (val>>2)&7;
@@ -430,15 +507,60 @@ static int si5338_calculate_multisynth(struct si5338_multisynth *ms,
     return 0;
 }
 
+static inline bool si5338_rate_equal(const struct bladerf_rational_rate *a,
+                                     const struct bladerf_rational_rate *b)
+{
+    return a->integer == b->integer && a->num == b->num && a->den == b->den;
+}
+
+/* Find a previously computed configuration of the multisynth for the
+ * (reduced) requested rate */
+static const struct si5338_cache_entry *
+si5338_cache_lookup(const struct si5338_cache *cache, uint8_t index,
+                    const struct bladerf_rational_rate *rate)
+{
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(cache->entries); i++) {
+        const struct si5338_cache_entry *e = &cache->entries[i];
+
+        if (e->valid && e->index == index &&
+            si5338_rate_equal(&e->requested, rate)) {
+            return e;
+        }
+    }
+
+    return NULL;
+}
+
+static void si5338_cache_store(struct si5338_cache *cache,
+                               const struct si5338_multisynth *ms,
+                               const struct bladerf_rational_rate *rate,
+                               const struct bladerf_rational_rate *actual)
+{
+    struct si5338_cache_entry *e = &cache->entries[cache->next];
+
+    e->valid     = true;
+    e->index     = ms->index;
+    e->requested = *rate;
+    e->actual    = *actual;
+    e->r         = ms->r;
+    memcpy(e->regs, ms->regs, sizeof(e->regs));
+
+    cache->next = (cache->next + 1) % ARRAY_SIZE(cache->entries);
+}
+
 /**
  * Configure a multisynth for either the RX/TX sample clocks (index=1 or 2)
  * or for the SMB output (index=3).
  */
 static int si5338_set_rational_multisynth(struct bladerf *dev,
+                                          struct si5338_cache *cache,
                                           uint8_t index, uint8_t channel,
                                           struct bladerf_rational_rate *rate,
                                           struct bladerf_rational_rate *actual_ret)
 {
+    const struct si5338_cache_entry *entry = NULL;
     struct si5338_multisynth ms;
     struct bladerf_rational_rate req;
     struct bladerf_rational_rate actual;
@@ -456,27 +578,45 @@ static int si5338_set_rational_multisynth(struct bladerf *dev,
     /* Update the base address register */
     si5338_update_base(&ms);
 
-    /* Calculate multisynth values */
-    status = si5338_calculate_multisynth(&ms, &req);
-    if(status != 0) {
-        return status;
+    if (cache != NULL) {
+        entry = si5338_cache_lookup(cache, index, &req);
+    }
+
+    if (entry != NULL) {
+        log_verbose("Using cached MS%d configuration\n", index);
+        ms.r = entry->r;
+        memcpy(ms.regs, entry->regs, sizeof(ms.regs));
+        actual = entry->actual;
+    } else {
+        /* Calculate multisynth values */
+        status = si5338_calculate_multisynth(&ms, &req);
+        if(status != 0) {
+            return status;
+        }
+
+        /* Get the actual rate */
+        si5338_calculate_ms_freq(&ms, &actual);
+
+        if (cache != NULL) {
+            si5338_cache_store(cache, &ms, &req, &actual);
+        }
     }
 
-    /* Get the actual rate */
-    si5338_calculate_ms_freq(&ms, &actual);
     if (actual_ret) {
         memcpy(actual_ret, &actual, sizeof(*actual_ret));
     }
 
     /* Program it to the part */
-    status = si5338_write_multisynth(dev, &ms);
+    status = si5338_write_multisynth(dev, cache, &ms);
 
     /* Done */
     return status ;
 }
 
 
-int si5338_set_rational_sample_rate(struct bladerf *dev, bladerf_channel ch,
+int si5338_set_rational_sample_rate(struct bladerf *dev,
+                                    struct si5338_cache *cache,
+                                    bladerf_channel ch,
                                     const struct bladerf_rational_rate *rate,
                                     struct bladerf_rational_rate *actual)
 {
@@ -495,10 +635,12 @@ int si5338_set_rational_sample_rate(struct bladerf *dev, bladerf_channel ch,
         channel |= SI5338_EN_B;
     }
 
-    return si5338_set_rational_multisynth(dev, index, channel, &rate_reduced, actual);
+    return si5338_set_rational_multisynth(dev, cache, index, channel,
+                                          &rate_reduced, actual);
 }
 
 int si5338_set_rational_smb_freq(struct bladerf *dev,
+                                 struct si5338_cache *cache,
                                  const struct bladerf_rational_rate *rate,
                                  struct bladerf_rational_rate *actual)
 {
@@ -515,11 +657,15 @@ int si5338_set_rational_smb_freq(struct bladerf *dev,
         return BLADERF_ERR_INVAL;
     }
 
-    return si5338_set_rational_multisynth(dev, 3, SI5338_EN_A, &rate_reduced, actual);
+    return si5338_set_rational_multisynth(dev, cache, 3, SI5338_EN_A,
+                                          &rate_reduced, actual);
 }
 
-int si5338_set_sample_rate(struct bladerf *dev, bladerf_channel ch,
-                           uint32_t rate, uint32_t *actual)
+int si5338_set_sample_rate(struct bladerf *dev,
+                           struct si5338_cache *cache,
+                           bladerf_channel ch,
+                           uint32_t rate,
+                           uint32_t *actual)
 {
     struct bladerf_rational_rate req, act;
     int status;
@@ -530,7 +676,7 @@ int si5338_set_sample_rate(struct bladerf *dev, bladerf_channel ch,
     req.num = 0;
     req.den = 1;
 
-    status = si5338_set_rational_sample_rate(dev, ch, &req, &act);
+    status = si5338_set_rational_sample_rate(dev, cache, ch, &req, &act);
 
     if (status == 0 && act.num != 0) {
         log_info("Non-integer sample rate set from integer sample rate, "
@@ -547,7 +693,10 @@ int si5338_set_sample_rate(struct bladerf *dev, bladerf_channel ch,
     return status ;
 }
 
-int si5338_set_smb_freq(struct bladerf *dev, uint32_t rate, uint32_t *actual)
+int si5338_set_smb_freq(struct bladerf *dev,
+                        struct si5338_cache *cache,
+                        uint32_t rate,
+                        uint32_t *actual)
 {
     struct bladerf_rational_rate req, act;
     int status;
@@ -558,7 +707,7 @@ int si5338_set_smb_freq(struct bladerf *dev, uint32_t rate, uint32_t *actual)
     req.num = 0;
     req.den = 1;
 
-    status = si5338_set_rational_smb_freq(dev, &req, &act);
+    status = si5338_set_rational_smb_freq(dev, cache, &req, &act);
 
     if (status == 0 && act.num != 0) {
         log_info("Non-integer SMB frequency set from integer frequency, "
@@ -575,7 +724,9 @@ int si5338_set_smb_freq(struct bladerf *dev, uint32_t rate, uint32_t *actual)
     return status;
 }
 
-int si5338_get_rational_sample_rate(struct bladerf *dev, bladerf_channel ch,
+int si5338_get_rational_sample_rate(struct bladerf *dev,
+                                    struct si5338_cache *cache,
+                                    bladerf_channel ch,
                                     struct bladerf_rational_rate *rate)
 {
 
@@ -589,7 +740,7 @@ int si5338_get_rational_sample_rate(struct bladerf *dev, bladerf_channel ch,
     si5338_update_base(&ms);
 
     /* Readback */
-    status = si5338_read_multisynth(dev, &ms);
+    status = si5338_read_multisynth(dev, cache, &ms);
 
     if (status) {
         si5338_log_read_error(status, bladerf_strerror(status));
@@ -602,6 +753,7 @@ int si5338_get_rational_sample_rate(struct bladerf *dev, bladerf_channel ch,
 }
 
 int si5338_get_rational_smb_freq(struct bladerf *dev,
+                                 struct si5338_cache *cache,
                                  struct bladerf_rational_rate *rate)
 {
     struct si5338_multisynth ms;
@@ -611,7 +763,7 @@ int si5338_get_rational_smb_freq(struct bladerf *dev,
     ms.index = 3;
     si5338_update_base(&ms);
 
-    status = si5338_read_multisynth(dev, &ms);
+    status = si5338_read_multisynth(dev, cache, &ms);
 
     if (status) {
         si5338_log_read_error(status, bladerf_strerror(status));
@@ -623,13 +775,15 @@ int si5338_get_rational_smb_freq(struct bladerf *dev,
     return 0;
 }
 
-int si5338_get_sample_rate(struct bladerf *dev, bladerf_channel ch,
+int si5338_get_sample_rate(struct bladerf *dev,
+                           struct si5338_cache *cache,
+                           bladerf_channel ch,
                            unsigned int *rate)
 {
     struct bladerf_rational_rate actual;
     int status;
 
-    status = si5338_get_rational_sample_rate(dev, ch, &actual);
+    status = si5338_get_rational_sample_rate(dev, cache, ch, &actual);
 
     if (status) {
         si5338_log_read_error(status, bladerf_strerror(status));
@@ -647,12 +801,14 @@ int si5338_get_sample_rate(struct bladerf *dev, bladerf_channel ch,
     return 0;
 }
 
-int si5338_get_smb_freq(struct bladerf *dev, unsigned int *rate)
+int si5338_get_smb_freq(struct bladerf *dev,
+                        struct si5338_cache *cache,
+                        unsigned int *rate)
 {
     struct bladerf_rational_rate actual;
     int status;
 
-    status = si5338_get_rational_smb_freq(dev, &actual);
+    status = si5338_get_rational_smb_freq(dev, cache, &actual);
 
     if (status) {
         si5338_log_read_error(status, bladerf_strerror(status));
@@ -30,10 +30,56 @@
 
 #include "board/board.h"
 
+/** Number of computed multisynth configurations retained per device */
+#define SI5338_CACHE_ENTRIES 16
+
+/** A previously computed multisynth configuration */
+struct si5338_cache_entry {
+    bool valid;
+    uint8_t index;                          /**< Multisynth (0-3) */
+    struct bladerf_rational_rate requested; /**< Reduced requested rate */
+    struct bladerf_rational_rate actual;    /**< Resulting actual rate */
+    uint32_t r;                             /**< Output divider */
+    uint8_t regs[10];                       /**< Packed (p1, p2, p3) */
+};
+
+/**
+ * Per-device Si5338 state, used to avoid recomputing configurations for
+ * previously requested rates, and to write only the multisynth registers
+ * that change.
+ *
+ * The shadow copies are only kept for the RX and TX sample clock
+ * multisynths (1 and 2). The SMB clock multisynth (3) is also configured
+ * by the SMB clock mode and XB-200 code.
+ *
+ * Zero-initialization yields an empty cache.
+ */
+struct si5338_cache {
+    struct si5338_cache_entry entries[SI5338_CACHE_ENTRIES];
+    unsigned int next; /**< Next entry to replace */
+
+    /** Register values last written to, or read from, each multisynth */
+    struct {
+        bool valid;
+        uint8_t enable;   /**< Output enable register (36 + index) */
+        uint8_t regs[10]; /**< Parameter registers (53 + 11 * index) */
+        uint8_t r;        /**< R divider register (31 + index) */
+    } shadow[4];
+};
+
+/**
+ * Invalidate the shadow copies of the multisynth registers. This must be
+ * called when the Si5338 is accessed other than through this driver.
+ *
+ * @param   cache   Cache to update
+ */
+void si5338_cache_invalidate(struct si5338_cache *cache);
+
 /**
  * Set the rational sample rate of the specified channel.
  *
  * @param       dev     Device handle
+ * @param       cache   Per-device Si5338 state, or NULL
  * @param[in]   ch      Channel
  * @param[in]   rate    Rational rate requested
  * @param[out]  actual  Rational rate actually set
@@ -41,6 +87,7 @@
  * @return 0 on success, BLADERF_ERR_* value on failure
  */
 int si5338_set_rational_sample_rate(struct bladerf *dev,
+                                    struct si5338_cache *cache,
                                     bladerf_channel ch,
                                     const struct bladerf_rational_rate *rate,
                                     struct bladerf_rational_rate *actual);
@@ -49,12 +96,14 @@ int si5338_set_rational_sample_rate(struct bladerf *dev,
  * Get the rational sample rate of the specified channel.
  *
  * @param       dev     Device handle
+ * @param       cache   Per-device Si5338 state, or NULL
  * @param[in]   ch      Channel
  * @param[out]  rate    Rational rate
  *
  * @return 0 on success, BLADERF_ERR_* value on failure
  */
 int si5338_get_rational_sample_rate(struct bladerf *dev,
+                                    struct si5338_cache *cache,
                                     bladerf_channel ch,
                                     struct bladerf_rational_rate *rate);
 
@@ -62,6 +111,7 @@ int si5338_get_rational_sample_rate(struct bladerf *dev,
  * Set the integral sample rate of the specified channel.
  *
  * @param       dev     Device handle
+ * @param       cache   Per-device Si5338 state, or NULL
  * @param[in]   ch      Channel
  * @param[in]   rate    Integral rate requested
  * @param[out]  actual  Integral rate actually set
@@ -69,6 +119,7 @@ int si5338_get_rational_sample_rate(struct bladerf *dev,
  * @return 0 on success, BLADERF_ERR_* value on failure
  */
 int si5338_set_sample_rate(struct bladerf *dev,
+                           struct si5338_cache *cache,
                            bladerf_channel ch,
                            uint32_t rate,
                            uint32_t *actual);
@@ -77,12 +128,14 @@ int si5338_set_sample_rate(struct bladerf *dev,
  * Get the integral sample rate of the specified channel.
  *
  * @param       dev     Device handle
+ * @param       cache   Per-device Si5338 state, or NULL
  * @param[in]   ch      Channel
  * @param[out]  rate    Integral rate
  *
  * @return 0 on success, BLADERF_ERR_* value on failure
  */
 int si5338_get_sample_rate(struct bladerf *dev,
+                           struct si5338_cache *cache,
                            bladerf_channel ch,
                            unsigned int *rate);
 
@@ -90,12 +143,14 @@ int si5338_get_sample_rate(struct bladerf *dev,
  * Set the rational frequency of the external SMB port.
  *
  * @param       dev     Device handle
+ * @param       cache   Per-device Si5338 state, or NULL
  * @param[in]   rate    Rational rate requested
  * @param[out]  actual  Rational rate actually set
  *
  * @return 0 on success, BLADERF_ERR_* value on failure
  */
 int si5338_set_rational_smb_freq(struct bladerf *dev,
+                                 struct si5338_cache *cache,
                                  const struct bladerf_rational_rate *rate,
                                  struct bladerf_rational_rate *actual);
 
@@ -103,32 +158,41 @@ int si5338_set_rational_smb_freq(struct bladerf *dev,
  * Get the rational sample rate of the external SMB port.
  *
  * @param       dev     Device handle
+ * @param       cache   Per-device Si5338 state, or NULL
  * @param[out]  rate    Rational rate
  *
  * @return 0 on success, BLADERF_ERR_* value on failure
  */
 int si5338_get_rational_smb_freq(struct bladerf *dev,
+                                 struct si5338_cache *cache,
                                  struct bladerf_rational_rate *rate);
 
 /**
  * Set the integral sample rate of the external SMB port.
  *
  * @param       dev     Device handle
+ * @param       cache   Per-device Si5338 state, or NULL
  * @param[in]   rate    Integral rate requested
  * @param[out]  actual  Integral rate actually set
  *
  * @return 0 on success, BLADERF_ERR_* value on failure
  */
-int si5338_set_smb_freq(struct bladerf *dev, uint32_t rate, uint32_t *actual);
+int si5338_set_smb_freq(struct bladerf *dev,
+                        struct si5338_cache *cache,
+                        uint32_t rate,
+                        uint32_t *actual);
 
 /**
   Get the integral sample rate of the external SMB port.
  *
  * @param       dev     Device handle
+ * @param       cache   Per-device Si5338 state, or NULL
  * @param[out]  rate    Integral rate
  *
  * @return 0 on success, BLADERF_ERR_* value on failure
  */
-int si5338_get_smb_freq(struct bladerf *dev, unsigned int *rate);
+int si5338_get_smb_freq(struct bladerf *dev,
+                        struct si5338_cache *cache,
+                        unsigned int *rate);
 
 #endif
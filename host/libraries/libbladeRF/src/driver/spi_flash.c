@@ -21,6 +21,7 @@
  */
 
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
@@ -28,10 +29,14 @@
 
 #include "rel_assert.h"
 #include "log.h"
+#include "minmax.h"
+#include "sha256.h"
 
 #include "spi_flash.h"
 #include "board/board.h"
 
+#include "bladeRF.h"
+
 static inline int check_eb_access(struct bladerf *dev,
                                   uint32_t erase_block, uint32_t count)
 {
@@ -103,6 +108,42 @@ int spi_flash_write(struct bladerf *dev, const uint8_t *buf,
     return status;
 }
 
+int spi_flash_compare(struct bladerf *dev, const uint8_t *expected_buf,
+                      uint32_t page, uint32_t count)
+{
+    const uint32_t psize = dev->flash_arch->psize_bytes;
+    int status = check_page_access(dev, page, count);
+    uint8_t expected[SHA256_DIGEST_SIZE];
+    uint8_t actual[SHA256_DIGEST_SIZE];
+    SHA256_CTX ctx;
+    uint32_t n;
+
+    while (status == 0 && count > 0) {
+        n = u32_min(count, BLADE_FLASH_HASH_MAX_PAGES);
+
+        status = dev->backend->hash_flash_pages(dev, page, n, actual);
+        if (status != 0) {
+            break;
+        }
+
+        SHA256_Init(&ctx);
+        SHA256_Update(&ctx, expected_buf, (size_t)n * psize);
+        SHA256_Final(expected, &ctx);
+
+        if (memcmp(expected, actual, sizeof(expected)) != 0) {
+            log_debug("Flash contents differ within pages %u-%u\n", page,
+                      page + n - 1);
+            return 1;
+        }
+
+        expected_buf += (size_t)n * psize;
+        page += n;
+        count -= n;
+    }
+
+    return status;
+}
+
 int spi_flash_verify(struct bladerf *dev, uint8_t *readback_buf,
                      const uint8_t *expected_buf, uint32_t page,
                      uint32_t count)
@@ -112,6 +153,17 @@ int spi_flash_verify(struct bladerf *dev, uint8_t *readback_buf,
     const size_t len = count * dev->flash_arch->psize_bytes;
 
     log_info("Verifying %u pages, starting at page %u\n", count, page);
+
+    status = spi_flash_compare(dev, expected_buf, page, count);
+    if (status == 0) {
+        return 0;
+    } else if (status < 0 && status != BLADERF_ERR_UNSUPPORTED) {
+        log_debug("Failed to compare flash contents: %s\n",
+                  bladerf_strerror(status));
+        return status;
+    }
+
+    /* Read the data back, which also locates any mismatch */
     status = spi_flash_read(dev, readback_buf, page, count);
 
     if (status < 0) {
@@ -132,3 +184,112 @@ int spi_flash_verify(struct bladerf *dev, uint8_t *readback_buf,
     return status;
 }
 
+static inline bool page_is_blank(const uint8_t *page, uint32_t len)
+{
+    uint32_t i;
+
+    for (i = 0; i < len; i++) {
+        if (page[i] != 0xff) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int spi_flash_update(struct bladerf *dev, const uint8_t *buf,
+                     uint32_t erase_block, uint32_t count,
+                     struct bladerf_flash_write_stats *stats)
+{
+    const uint32_t psize = dev->flash_arch->psize_bytes;
+    const uint32_t ebsize = dev->flash_arch->ebsize_bytes;
+    const uint32_t pages_per_eb = ebsize / psize;
+    int status = check_eb_access(dev, erase_block, count);
+    uint32_t i, p, run, updated = 0;
+    uint64_t written = 0;
+    uint8_t *readback;
+
+    if (status != 0) {
+        return status;
+    }
+
+    readback = malloc(ebsize);
+    if (readback == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    for (i = 0; i < count; i++) {
+        const uint8_t *expected = buf + (size_t)i * ebsize;
+        const uint32_t eb = erase_block + i;
+        const uint32_t page = eb * pages_per_eb;
+
+        status = spi_flash_compare(dev, expected, page, pages_per_eb);
+        if (status == BLADERF_ERR_UNSUPPORTED) {
+            status = spi_flash_read(dev, readback, page, pages_per_eb);
+            if (status == 0) {
+                status = (memcmp(readback, expected, ebsize) == 0) ? 0 : 1;
+            }
+        }
+
+        if (status < 0) {
+            log_debug("Failed to read erase block %u: %s\n", eb,
+                      bladerf_strerror(status));
+            goto out;
+        } else if (status == 0) {
+            log_verbose("Erase block %u is unchanged\n", eb);
+            continue;
+        }
+
+        status = spi_flash_erase(dev, eb, 1);
+        if (status != 0) {
+            log_debug("Failed to erase block %u: %s\n", eb,
+                      bladerf_strerror(status));
+            goto out;
+        }
+
+        /* Write each run of pages containing data */
+        for (p = 0; p < pages_per_eb; p += run) {
+            if (page_is_blank(expected + (size_t)p * psize, psize)) {
+                run = 1;
+                continue;
+            }
+
+            for (run = 1; p + run < pages_per_eb; run++) {
+                if (page_is_blank(expected + (size_t)(p + run) * psize,
+                                  psize)) {
+                    break;
+                }
+            }
+
+            status = spi_flash_write(dev, expected + (size_t)p * psize,
+                                     page + p, run);
+            if (status != 0) {
+                log_debug("Failed to write erase block %u: %s\n", eb,
+                          bladerf_strerror(status));
+                goto out;
+            }
+
+            written += (uint64_t)run * psize;
+        }
+
+        status = spi_flash_verify(dev, readback, expected, page, pages_per_eb);
+        if (status != 0) {
+            goto out;
+        }
+
+        updated++;
+    }
+
+    log_info("Updated %u of %u erase blocks (%llu bytes written)\n", updated,
+             count, (unsigned long long)written);
+
+out:
+    if (stats != NULL) {
+        stats->blocks_total   = count;
+        stats->blocks_updated = updated;
+        stats->bytes_written  = written;
+    }
+
+    free(readback);
+    return status;
+}
@@ -61,9 +61,30 @@ int spi_flash_read(struct bladerf *dev,
                    uint32_t page,
                    uint32_t count);
 
+/**
+ * Compare data in flash against its expected contents, using SHA-256 digests
+ * computed by the device, rather than reading the data back
+ *
+ * @param       dev             Device handle
+ * @param[in]   expected_buf    Expected contents of flash
+ * @param[in]   page            Page to begin comparing at
+ * @param[in]   count           Number of pages to compare
+ *
+ * @return 0 if the contents match, 1 if they differ, BLADERF_ERR_UNSUPPORTED
+ * if the device cannot compute digests of its flash, or a value from
+ * \ref RETCODES list on other failures.
+ */
+int spi_flash_compare(struct bladerf *dev,
+                      const uint8_t *expected_buf,
+                      uint32_t page,
+                      uint32_t count);
+
 /**
  * Verify data in flash
  *
+ * When the device supports it, this first compares digests of the data with
+ * spi_flash_compare(), and only reads the data back to identify a mismatch.
+ *
  * @param       dev             Device handle
  * @param[out]  readback_buf    Buffer to read data into. Must be `count` *
  *                              flash-page-size bytes or larger.
@@ -96,4 +117,29 @@ int spi_flash_write(struct bladerf *dev,
                     uint32_t page,
                     uint32_t count);
 
+/**
+ * Differentially update a range of erase blocks
+ *
+ * Each erase block is read back and compared with the provided data. Only
+ * the blocks that differ are erased, written, and verified. Pages that are
+ * entirely 0xff are not written, as the erase leaves them in that state.
+ *
+ * @param       dev         Device handle
+ * @param[in]   buf         Data for the entire range, `count` erase blocks
+ *                          in length
+ * @param[in]   erase_block First erase block to update
+ * @param[in]   count       Number of erase blocks to update
+ * @param[out]  stats       Updated with the number of blocks updated and
+ *                          bytes written. May be NULL.
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL on an invalid `erase_block` or
+ * `count` value, BLADERF_ERR_UNEXPECTED if verification of an updated block
+ * fails, or a value from \ref RETCODES list on other failures.
+ */
+int spi_flash_update(struct bladerf *dev,
+                     const uint8_t *buf,
+                     uint32_t erase_block,
+                     uint32_t count,
+                     struct bladerf_flash_write_stats *stats);
+
 #endif
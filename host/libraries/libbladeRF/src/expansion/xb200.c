@@ -54,8 +54,81 @@
 struct xb200_xb_data {
     /* Track filterbank selection for RX and TX auto-selection */
     bladerf_xb200_filter auto_filter[2];
+
+    /* Shadow of the expansion GPIO. It is not used while scheduled retunes
+     * that reconfigure the XB-200 may be pending, as the NIOS II applies
+     * those at their timestamps. */
+    uint32_t gpio;
+    bool gpio_valid;
+    bool gpio_scheduled[2];
 };
 
+/* Read the expansion GPIO, from the shadow copy when it is known */
+static int xb200_gpio_read(struct bladerf *dev, uint32_t *val)
+{
+    struct xb200_xb_data *xb_data = dev->xb_data;
+    int status;
+
+    if (xb_data != NULL && xb_data->gpio_valid) {
+        *val = xb_data->gpio;
+        return 0;
+    }
+
+    status = dev->backend->expansion_gpio_read(dev, val);
+    if (status == 0 && xb_data != NULL &&
+        !xb_data->gpio_scheduled[BLADERF_CHANNEL_RX(0)] &&
+        !xb_data->gpio_scheduled[BLADERF_CHANNEL_TX(0)]) {
+        xb_data->gpio       = *val;
+        xb_data->gpio_valid = true;
+    }
+
+    return status;
+}
+
+static int xb200_gpio_write(struct bladerf *dev, uint32_t val)
+{
+    struct xb200_xb_data *xb_data = dev->xb_data;
+    int status;
+
+    status = dev->backend->expansion_gpio_write(dev, 0xffffffff, val);
+
+    if (xb_data != NULL) {
+        xb_data->gpio       = val;
+        xb_data->gpio_valid = (status == 0) &&
+                              !xb_data->gpio_scheduled[BLADERF_CHANNEL_RX(0)] &&
+                              !xb_data->gpio_scheduled[BLADERF_CHANNEL_TX(0)];
+    }
+
+    return status;
+}
+
+void xb200_gpio_invalidate(struct bladerf *dev)
+{
+    struct xb200_xb_data *xb_data = dev->xb_data;
+
+    if (dev->xb == BLADERF_XB_200 && xb_data != NULL) {
+        xb_data->gpio_valid = false;
+    }
+}
+
+void xb200_retune_scheduled(struct bladerf *dev,
+                            bladerf_channel ch,
+                            bool pending)
+{
+    struct xb200_xb_data *xb_data = dev->xb_data;
+
+    if (dev->xb != BLADERF_XB_200 || xb_data == NULL) {
+        return;
+    }
+
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_TX(0)) {
+        return;
+    }
+
+    xb_data->gpio_scheduled[ch] = pending;
+    xb_data->gpio_valid         = false;
+}
+
 int xb200_attach(struct bladerf *dev)
 {
     struct xb200_xb_data *xb_data;
@@ -72,15 +145,23 @@ int xb200_attach(struct bladerf *dev)
                               "DIGITAL LOCK DETECT",
                               "RESERVED" };
 
-    xb_data = calloc(1, sizeof(struct xb200_xb_data));
-    if (xb_data == NULL) {
-        return BLADERF_ERR_MEM;
-    }
+    if (dev->xb_data != NULL) {
+        /* Re-attaching after the board was powered off keeps the filter
+         * selection modes */
+        xb_data = dev->xb_data;
+    } else {
+        xb_data = calloc(1, sizeof(struct xb200_xb_data));
+        if (xb_data == NULL) {
+            return BLADERF_ERR_MEM;
+        }
 
-    xb_data->auto_filter[BLADERF_CHANNEL_RX(0)] = -1;
-    xb_data->auto_filter[BLADERF_CHANNEL_TX(0)] = -1;
+        xb_data->auto_filter[BLADERF_CHANNEL_RX(0)] = -1;
+        xb_data->auto_filter[BLADERF_CHANNEL_TX(0)] = -1;
 
-    dev->xb_data = xb_data;
+        dev->xb_data = xb_data;
+    }
+
+    xb_data->gpio_valid = false;
 
     log_debug("  Attaching transverter board\n");
     status = dev->backend->si5338_read(dev, 39, &val8);
@@ -146,8 +227,7 @@ int xb200_attach(struct bladerf *dev)
     else {
         log_debug("  MUXOUT Bit not set: FAIL\n");
     }
-    if ((status =
-             dev->backend->expansion_gpio_write(dev, 0xffffffff, 0x3C000800))) {
+    if ((status = xb200_gpio_write(dev, 0x3C000800))) {
         goto error;
     }
 
@@ -172,7 +252,7 @@ int xb200_enable(struct bladerf *dev, bool enable)
     int status;
     uint32_t val, orig;
 
-    status = dev->backend->expansion_gpio_read(dev, &orig);
+    status = xb200_gpio_read(dev, &orig);
     if (status)
         return status;
 
@@ -185,7 +265,7 @@ int xb200_enable(struct bladerf *dev, bool enable)
     if (status || (val == orig))
         return status;
 
-    return dev->backend->expansion_gpio_write(dev, 0xffffffff, val);
+    return xb200_gpio_write(dev, val);
 }
 
 int xb200_init(struct bladerf *dev)
@@ -283,7 +363,7 @@ int xb200_get_filterbank(struct bladerf *dev, bladerf_channel ch,
     if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_TX(0))
         return BLADERF_ERR_INVAL;
 
-    status = dev->backend->expansion_gpio_read(dev, &val);
+    status = xb200_gpio_read(dev, &val);
     if (status != 0) {
         return status;
     }
@@ -323,7 +403,7 @@ static int set_filterbank_mux(struct bladerf *dev, bladerf_channel ch, bladerf_x
         shift = BLADERF_XB_TX_SHIFT;
     }
 
-    status = dev->backend->expansion_gpio_read(dev, &orig);
+    status = xb200_gpio_read(dev, &orig);
     if (status != 0) {
         return status;
     }
@@ -335,7 +415,7 @@ static int set_filterbank_mux(struct bladerf *dev, bladerf_channel ch, bladerf_x
         log_debug("Engaging %s band XB-200 %s filter\n", filters[filter],
             mask == BLADERF_XB_TX_MASK ? "TX" : "RX");
 
-        status = dev->backend->expansion_gpio_write(dev, 0xffffffff, val);
+        status = xb200_gpio_write(dev, val);
         if (status != 0) {
             return status;
         }
@@ -387,6 +467,46 @@ int xb200_set_filterbank(struct bladerf *dev,
     return status;
 }
 
+/**
+ * Look up the filterbank for a frequency in an auto selection mode
+ *
+ * @param[in]   mode        BLADERF_XB200_AUTO_1DB or BLADERF_XB200_AUTO_3DB
+ * @param[in]   frequency   Frequency
+ * @param[out]  filter      Selected filterbank
+ *
+ * @return true if `mode` is an auto selection mode, false otherwise
+ */
+static bool auto_filter_lookup(bladerf_xb200_filter mode,
+                               uint64_t frequency,
+                               bladerf_xb200_filter *filter)
+{
+    if (mode == BLADERF_XB200_AUTO_1DB) {
+        if (37774405 <= frequency && frequency <= 59535436) {
+            *filter = BLADERF_XB200_50M;
+        } else if (128326173 <= frequency && frequency <= 166711171) {
+            *filter = BLADERF_XB200_144M;
+        } else if (187593160 <= frequency && frequency <= 245346403) {
+            *filter = BLADERF_XB200_222M;
+        } else {
+            *filter = BLADERF_XB200_CUSTOM;
+        }
+    } else if (mode == BLADERF_XB200_AUTO_3DB) {
+        if (34782924 <= frequency && frequency <= 61899260) {
+            *filter = BLADERF_XB200_50M;
+        } else if (121956957 <= frequency && frequency <= 178444099) {
+            *filter = BLADERF_XB200_144M;
+        } else if (177522675 <= frequency && frequency <= 260140935) {
+            *filter = BLADERF_XB200_222M;
+        } else {
+            *filter = BLADERF_XB200_CUSTOM;
+        }
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
 int xb200_auto_filter_selection(struct bladerf *dev,
                                 bladerf_channel ch,
                                 uint64_t frequency)
@@ -409,33 +529,65 @@ int xb200_auto_filter_selection(struct bladerf *dev,
         return BLADERF_ERR_INVAL;
     }
 
-    if (xb_data->auto_filter[ch] == BLADERF_XB200_AUTO_1DB) {
-        if (37774405 <= frequency && frequency <= 59535436) {
-            filter = BLADERF_XB200_50M;
-        } else if (128326173 <= frequency && frequency <= 166711171) {
-            filter = BLADERF_XB200_144M;
-        } else if (187593160 <= frequency && frequency <= 245346403) {
-            filter = BLADERF_XB200_222M;
-        } else {
-            filter = BLADERF_XB200_CUSTOM;
-        }
-
+    if (auto_filter_lookup(xb_data->auto_filter[ch], frequency, &filter)) {
         status = set_filterbank_mux(dev, ch, filter);
-    } else if (xb_data->auto_filter[ch] == BLADERF_XB200_AUTO_3DB) {
-        if (34782924 <= frequency && frequency <= 61899260) {
-            filter = BLADERF_XB200_50M;
-        } else if (121956957 <= frequency && frequency <= 178444099) {
-            filter = BLADERF_XB200_144M;
-        } else if (177522675 <= frequency && frequency <= 260140935) {
-            filter = BLADERF_XB200_222M;
-        } else {
-            filter = BLADERF_XB200_CUSTOM;
+    }
+
+    return status;
+}
+
+int xb200_retune_params(struct bladerf *dev,
+                        bladerf_channel ch,
+                        uint64_t frequency,
+                        uint64_t *lms_frequency,
+                        uint8_t *xb_gpio)
+{
+    struct xb200_xb_data *xb_data = dev->xb_data;
+    bladerf_xb200_filter filter;
+    const bool mix = (frequency < BLADERF_FREQUENCY_MIN);
+    uint32_t val;
+    unsigned int shift;
+    int status;
+
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_TX(0)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (NULL == xb_data) {
+        log_error("xb_data is null (do you need to xb200_attach?)\n");
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* Filterbank selection follows xb200_auto_filter_selection(), which
+     * leaves the current selection in place above 300 MHz */
+    if (frequency >= 300000000u ||
+        !auto_filter_lookup(xb_data->auto_filter[ch], frequency, &filter)) {
+        status = xb200_gpio_read(dev, &val);
+        if (status != 0) {
+            return status;
         }
 
-        status = set_filterbank_mux(dev, ch, filter);
+        shift  = (ch == BLADERF_CHANNEL_RX(0)) ? BLADERF_XB_RX_SHIFT
+                                               : BLADERF_XB_TX_SHIFT;
+        filter = (val >> shift) & 3;
     }
 
-    return status;
+    *xb_gpio = LMS_FREQ_XB_200_ENABLE;
+
+    if (ch == BLADERF_CHANNEL_RX(0)) {
+        *xb_gpio |= LMS_FREQ_XB_200_MODULE_RX;
+    }
+
+    *xb_gpio |= ((uint8_t)filter << LMS_FREQ_XB_200_FILTER_SW_SHIFT) &
+                LMS_FREQ_XB_200_FILTER_SW;
+
+    /* The path field holds the BLADERF_XB_CONFIG_*_PATH_* bits */
+    *xb_gpio |= (mix ? 1 : 2) << LMS_FREQ_XB_200_PATH_SHIFT;
+
+    /* The mixer LO is set to 1248 MHz by xb200_attach() */
+    *lms_frequency = mix ? (1248000000 - frequency) : frequency;
+
+    return 0;
 }
 
 #define LMS_RX_SWAP 0x40
@@ -474,12 +626,7 @@ int xb200_set_path(struct bladerf *dev,
         return status;
     }
 
-    status = dev->backend->expansion_gpio_read(dev, &val);
-    if (status != 0) {
-        return status;
-    }
-
-    status = dev->backend->expansion_gpio_read(dev, &val);
+    status = xb200_gpio_read(dev, &val);
     if (status != 0) {
         return status;
     }
@@ -489,6 +636,11 @@ int xb200_set_path(struct bladerf *dev,
         if (status != 0) {
             return status;
         }
+
+        status = xb200_gpio_read(dev, &val);
+        if (status != 0) {
+            return status;
+        }
     }
 
     if (ch == BLADERF_CHANNEL_RX(0)) {
@@ -514,7 +666,7 @@ int xb200_set_path(struct bladerf *dev,
         }
     }
 
-    return dev->backend->expansion_gpio_write(dev, 0xffffffff, val);
+    return xb200_gpio_write(dev, val);
 }
 
 int xb200_get_path(struct bladerf *dev,
@@ -525,7 +677,7 @@ int xb200_get_path(struct bladerf *dev,
     if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_TX(0))
         return BLADERF_ERR_INVAL;
 
-    status = dev->backend->expansion_gpio_read(dev, &val);
+    status = xb200_gpio_read(dev, &val);
     if (status != 0) {
         return status;
     }
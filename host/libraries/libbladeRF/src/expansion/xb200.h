@@ -102,4 +102,47 @@ int xb200_get_path(struct bladerf *dev,
                    bladerf_channel ch,
                    bladerf_xb200_path *path);
 
+/**
+ * Compute the path and filterbank settings for a retune, to be applied by the
+ * FPGA along with it
+ *
+ * The path and filterbank are selected as bladerf_set_frequency() would, from
+ * the filterbank selection mode configured for the channel.
+ *
+ * @param       dev             Device handle
+ * @param[in]   ch              Channel
+ * @param[in]   frequency       Desired frequency
+ * @param[out]  lms_frequency   Frequency to tune the LMS6002D to
+ * @param[out]  xb_gpio         XB-200 configuration for
+ *                              bladerf_quick_tune.xb_gpio
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int xb200_retune_params(struct bladerf *dev,
+                        bladerf_channel ch,
+                        uint64_t frequency,
+                        uint64_t *lms_frequency,
+                        uint8_t *xb_gpio);
+
+/**
+ * Note whether retunes that reconfigure the XB-200 may be pending for a
+ * channel. While any are, the expansion GPIO is always read back rather than
+ * taken from the host-side shadow copy.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   pending     Whether such retunes have been scheduled
+ */
+void xb200_retune_scheduled(struct bladerf *dev,
+                            bladerf_channel ch,
+                            bool pending);
+
+/**
+ * Discard the host-side shadow copy of the expansion GPIO, after it has been
+ * written by other means. This is a no-op if no XB-200 is attached.
+ *
+ * @param       dev         Device handle
+ */
+void xb200_gpio_invalidate(struct bladerf *dev);
+
 #endif
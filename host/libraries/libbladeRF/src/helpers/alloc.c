@@ -0,0 +1,93 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "helpers/alloc.h"
+
+static void *default_alloc(size_t size, void *user_data)
+{
+    return malloc(size);
+}
+
+static void default_free(void *ptr, void *user_data)
+{
+    free(ptr);
+}
+
+static const struct bladerf_allocator default_allocator = {
+    default_alloc,
+    default_free,
+    NULL,
+};
+
+/* Only changed while no device is open, per bladerf_set_allocator() */
+static struct bladerf_allocator allocator = {
+    default_alloc,
+    default_free,
+    NULL,
+};
+
+int alloc_set(const struct bladerf_allocator *a)
+{
+    if (a == NULL) {
+        allocator = default_allocator;
+        return 0;
+    }
+
+    if (a->alloc == NULL || a->free == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    allocator = *a;
+    return 0;
+}
+
+void *alloc_malloc(size_t size)
+{
+    /* Keep malloc(0)'s guarantee of a unique pointer */
+    return allocator.alloc(size == 0 ? 1 : size, allocator.user_data);
+}
+
+void *alloc_calloc(size_t nmemb, size_t size)
+{
+    void *ptr;
+
+    if (size != 0 && nmemb > SIZE_MAX / size) {
+        return NULL;
+    }
+
+    ptr = alloc_malloc(nmemb * size);
+    if (ptr != NULL) {
+        memset(ptr, 0, nmemb * size);
+    }
+
+    return ptr;
+}
+
+void alloc_free(void *ptr)
+{
+    if (ptr != NULL) {
+        allocator.free(ptr, allocator.user_data);
+    }
+}
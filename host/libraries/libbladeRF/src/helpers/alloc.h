@@ -0,0 +1,66 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+#ifndef HELPERS_ALLOC_H_
+#define HELPERS_ALLOC_H_
+
+#include <stddef.h>
+
+#include <libbladeRF.h>
+
+/**
+ * Install the allocator used by the functions below, as described by
+ * bladerf_set_allocator()
+ *
+ * @param[in]   allocator   Allocator, or NULL for the default
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if a callback is missing
+ */
+int alloc_set(const struct bladerf_allocator *allocator);
+
+/**
+ * Allocate memory with the installed allocator
+ *
+ * @param[in]   size    Number of bytes
+ *
+ * @return pointer to the memory, or NULL on failure
+ */
+void *alloc_malloc(size_t size);
+
+/**
+ * Allocate zeroed memory for an array with the installed allocator
+ *
+ * @param[in]   nmemb   Number of elements
+ * @param[in]   size    Size of each element, in bytes
+ *
+ * @return pointer to the memory, or NULL on failure or overflow
+ */
+void *alloc_calloc(size_t nmemb, size_t size);
+
+/**
+ * Free memory from alloc_malloc() or alloc_calloc()
+ *
+ * @param       ptr     Memory to free. NULL is ignored.
+ */
+void alloc_free(void *ptr);
+
+#endif
@@ -0,0 +1,580 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+
+#include "board/board.h"
+#include "helpers/cal_cache.h"
+#include "helpers/timeout.h"
+#include "helpers/wallclock.h"
+
+/* Indexed by channel */
+#define CAL_CACHE_CHANNELS 4
+
+/* Indexed by ::bladerf_correction */
+#define CAL_CACHE_NUM_CORR 4
+
+struct cal_cache_entry {
+    bool valid;
+    bladerf_frequency frequency;
+    int gain;
+    int bucket;
+    uint64_t updated_ns;
+    uint8_t have; /* Corrections recorded, as (1 << bladerf_correction) */
+    int16_t values[CAL_CACHE_NUM_CORR];
+};
+
+struct cal_cache_channel {
+    bool enabled;
+    struct bladerf_cal_cache_config config;
+    struct cal_cache_entry entries[BLADERF_CAL_CACHE_MAX_ENTRIES];
+
+    /* Entry whose values are in effect, and its update time when applied,
+     * or -1 if unknown */
+    int applied;
+    uint64_t applied_ns;
+};
+
+struct cal_cache {
+    struct bladerf *dev;
+
+    /* Protected by the device's handle lock */
+    struct cal_cache_channel ch[CAL_CACHE_CHANNELS];
+
+    bool have_temp;
+    float temp;
+    uint64_t temp_ns;
+
+    uint64_t tx_transfers;
+    uint64_t tx_active_ns;
+
+    /* Refresh thread */
+    bool thread_running;
+    pthread_t thread;
+    MUTEX thread_lock;
+    pthread_cond_t wake;
+    bool shutdown;
+};
+
+static inline uint64_t ms_to_ns(unsigned int ms)
+{
+    return (uint64_t)ms * 1000000;
+}
+
+static void read_temp(struct cal_cache *c, uint64_t now)
+{
+    float temp;
+
+    if (c->temp_ns != 0 &&
+        now - c->temp_ns < ms_to_ns(CAL_CACHE_TEMP_INTERVAL_MS)) {
+        return;
+    }
+
+    c->temp_ns   = now;
+    c->have_temp = (c->dev->board->get_temperature(c->dev, &temp) == 0);
+
+    if (c->have_temp) {
+        c->temp = temp;
+    }
+}
+
+static int current_bucket(const struct cal_cache *c,
+                          const struct bladerf_cal_cache_config *config)
+{
+    const unsigned int width = (config->temp_bucket_c != 0)
+                                   ? config->temp_bucket_c
+                                   : BLADERF_CAL_CACHE_TEMP_BUCKET_DEFAULT;
+
+    if (!c->have_temp) {
+        return 0;
+    }
+
+    return (int)floorf(c->temp / (float)width);
+}
+
+/* Obtain the channel's current operating point */
+static int operating_point(struct cal_cache *c,
+                           bladerf_channel ch,
+                           bladerf_frequency *frequency,
+                           int *gain,
+                           int *bucket)
+{
+    struct bladerf *dev = c->dev;
+    int status;
+
+    status = dev->board->get_frequency(dev, ch, frequency);
+    if (status != 0) {
+        return status;
+    }
+
+    status = dev->board->get_gain(dev, ch, gain);
+    if (status != 0) {
+        return status;
+    }
+
+    read_temp(c, wallclock_get_current_nsec());
+    *bucket = current_bucket(c, &c->ch[ch].config);
+
+    return 0;
+}
+
+static inline uint64_t distance(uint64_t a, uint64_t b)
+{
+    return (a > b) ? (a - b) : (b - a);
+}
+
+static int find_exact(const struct cal_cache_channel *chan,
+                      bladerf_frequency frequency,
+                      int gain,
+                      int bucket)
+{
+    const struct cal_cache_entry *e;
+    int i;
+
+    for (i = 0; i < BLADERF_CAL_CACHE_MAX_ENTRIES; i++) {
+        e = &chan->entries[i];
+
+        if (e->valid && e->gain == gain && e->bucket == bucket &&
+            distance(e->frequency, frequency) <= CAL_CACHE_MATCH_HZ) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/* Prefer the nearest temperature bucket, then frequency, then gain */
+static int find_nearest(const struct cal_cache_channel *chan,
+                        bladerf_frequency frequency,
+                        int gain,
+                        int bucket)
+{
+    const bladerf_frequency max_delta = chan->config.max_freq_delta;
+    const struct cal_cache_entry *e;
+    uint64_t d_bucket, d_freq, d_gain;
+    uint64_t best_bucket = UINT64_MAX, best_freq = 0, best_gain = 0;
+    int i, best = -1;
+
+    for (i = 0; i < BLADERF_CAL_CACHE_MAX_ENTRIES; i++) {
+        e = &chan->entries[i];
+
+        if (!e->valid) {
+            continue;
+        }
+
+        d_bucket = distance((uint64_t)(int64_t)e->bucket,
+                            (uint64_t)(int64_t)bucket);
+        d_freq   = distance(e->frequency, frequency);
+        d_gain   = distance((uint64_t)(int64_t)e->gain,
+                            (uint64_t)(int64_t)gain);
+
+        if (max_delta != 0 && d_freq > max_delta) {
+            continue;
+        }
+
+        if (best < 0 || d_bucket < best_bucket ||
+            (d_bucket == best_bucket &&
+             (d_freq < best_freq ||
+              (d_freq == best_freq && d_gain < best_gain)))) {
+            best        = i;
+            best_bucket = d_bucket;
+            best_freq   = d_freq;
+            best_gain   = d_gain;
+        }
+    }
+
+    return best;
+}
+
+/* Find the entry for an operating point, replacing the least recently
+ * updated one if it is not present */
+static struct cal_cache_entry *get_entry(struct cal_cache_channel *chan,
+                                         bladerf_frequency frequency,
+                                         int gain,
+                                         int bucket,
+                                         int *index)
+{
+    struct cal_cache_entry *e;
+    int i, oldest = 0;
+
+    i = find_exact(chan, frequency, gain, bucket);
+
+    if (i < 0) {
+        for (i = 0; i < BLADERF_CAL_CACHE_MAX_ENTRIES; i++) {
+            if (!chan->entries[i].valid) {
+                break;
+            } else if (chan->entries[i].updated_ns <
+                       chan->entries[oldest].updated_ns) {
+                oldest = i;
+            }
+        }
+
+        if (i == BLADERF_CAL_CACHE_MAX_ENTRIES) {
+            i = oldest;
+        }
+
+        e = &chan->entries[i];
+        memset(e, 0, sizeof(*e));
+
+        e->valid     = true;
+        e->frequency = frequency;
+        e->gain      = gain;
+        e->bucket    = bucket;
+    }
+
+    *index = i;
+    return &chan->entries[i];
+}
+
+static struct cal_cache_channel *enabled_channel(struct bladerf *dev,
+                                                 bladerf_channel ch)
+{
+    struct cal_cache *c = dev->cal_cache;
+
+    if (c == NULL || ch < 0 || ch >= CAL_CACHE_CHANNELS ||
+        !c->ch[ch].enabled) {
+        return NULL;
+    }
+
+    return &c->ch[ch];
+}
+
+static int record_values(struct bladerf *dev,
+                         bladerf_channel ch,
+                         uint8_t mask,
+                         const int16_t *values)
+{
+    struct cal_cache *c             = dev->cal_cache;
+    struct cal_cache_channel *chan  = &c->ch[ch];
+    struct cal_cache_entry *e;
+    bladerf_frequency frequency;
+    int gain, bucket, index, status;
+    size_t i;
+
+    status = operating_point(c, ch, &frequency, &gain, &bucket);
+    if (status != 0) {
+        return status;
+    }
+
+    e = get_entry(chan, frequency, gain, bucket, &index);
+
+    for (i = 0; i < CAL_CACHE_NUM_CORR; i++) {
+        if (mask & (1 << i)) {
+            e->values[i] = values[i];
+        }
+    }
+
+    e->have |= mask;
+    e->updated_ns = wallclock_get_current_nsec();
+
+    /* These values are the ones now in effect */
+    chan->applied    = index;
+    chan->applied_ns = e->updated_ns;
+
+    return 0;
+}
+
+void cal_cache_record_value(struct bladerf *dev,
+                            bladerf_channel ch,
+                            bladerf_correction corr,
+                            int16_t value)
+{
+    int16_t values[CAL_CACHE_NUM_CORR] = { 0 };
+    int status;
+
+    if (enabled_channel(dev, ch) == NULL || corr < 0 ||
+        corr >= CAL_CACHE_NUM_CORR) {
+        return;
+    }
+
+    values[corr] = value;
+
+    status = record_values(dev, ch, (uint8_t)(1 << corr), values);
+    if (status != 0) {
+        log_debug("%s: Failed to record correction: %s\n", __FUNCTION__,
+                  bladerf_strerror(status));
+    }
+}
+
+int cal_cache_record(struct bladerf *dev, bladerf_channel ch)
+{
+    int16_t values[CAL_CACHE_NUM_CORR];
+    size_t i;
+    int status;
+
+    if (enabled_channel(dev, ch) == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    for (i = 0; i < CAL_CACHE_NUM_CORR; i++) {
+        status = dev->board->get_correction(dev, ch, (bladerf_correction)i,
+                                            &values[i]);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    return record_values(dev, ch, (1 << CAL_CACHE_NUM_CORR) - 1, values);
+}
+
+int cal_cache_update(struct bladerf *dev, bladerf_channel ch)
+{
+    struct cal_cache_channel *chan = enabled_channel(dev, ch);
+    const struct cal_cache_entry *e;
+    bladerf_frequency frequency;
+    int gain, bucket, index, status;
+    size_t i;
+
+    if (chan == NULL) {
+        return 0;
+    }
+
+    status = operating_point(dev->cal_cache, ch, &frequency, &gain, &bucket);
+    if (status != 0) {
+        return status;
+    }
+
+    index = find_nearest(chan, frequency, gain, bucket);
+    if (index < 0) {
+        return 0;
+    }
+
+    e = &chan->entries[index];
+
+    if (index == chan->applied && e->updated_ns == chan->applied_ns) {
+        return 0;
+    }
+
+    for (i = 0; i < CAL_CACHE_NUM_CORR; i++) {
+        if (e->have & (1 << i)) {
+            status = dev->board->set_correction(dev, ch, (bladerf_correction)i,
+                                                e->values[i]);
+            if (status != 0) {
+                chan->applied = -1;
+                return status;
+            }
+        }
+    }
+
+    chan->applied    = index;
+    chan->applied_ns = e->updated_ns;
+
+    return 0;
+}
+
+/* Determine whether TX has been idle for the specified time */
+static bool tx_idle(struct cal_cache *c, uint64_t now, unsigned int idle_ms)
+{
+    struct bladerf_stream_stats stats;
+
+    /* An unconfigured TX interface is idle */
+    if (c->dev->board->get_sync_stats(c->dev, BLADERF_TX, &stats) == 0 &&
+        stats.transfers != c->tx_transfers) {
+        c->tx_transfers = stats.transfers;
+        c->tx_active_ns = now;
+    }
+
+    return now - c->tx_active_ns >= ms_to_ns(idle_ms);
+}
+
+/* Determine whether a channel's current operating point requires a refresh.
+ * The nearest entry is applied first, in case the temperature has moved
+ * into a different bucket. */
+static bool needs_refresh(struct cal_cache *c, bladerf_channel ch, uint64_t now)
+{
+    struct cal_cache_channel *chan = &c->ch[ch];
+    bladerf_frequency frequency;
+    int gain, bucket, index, status;
+
+    status = cal_cache_update(c->dev, ch);
+    if (status == 0) {
+        status = operating_point(c, ch, &frequency, &gain, &bucket);
+    }
+
+    if (status != 0) {
+        log_debug("%s: Failed to check channel %d: %s\n", __FUNCTION__, ch,
+                  bladerf_strerror(status));
+        return false;
+    }
+
+    index = find_exact(chan, frequency, gain, bucket);
+
+    return index < 0 ||
+           (chan->config.max_age_ms != 0 &&
+            now - chan->entries[index].updated_ns >=
+                ms_to_ns(chan->config.max_age_ms));
+}
+
+static void *refresh_worker(void *arg)
+{
+    struct cal_cache *c = arg;
+    struct bladerf *dev = c->dev;
+    bladerf_cal_refresh_cb refresh[CAL_CACHE_CHANNELS];
+    void *user_data[CAL_CACHE_CHANNELS];
+    struct timespec deadline;
+    uint64_t now;
+    bladerf_channel ch;
+    int status;
+
+    MUTEX_LOCK(&c->thread_lock);
+
+    while (!c->shutdown) {
+        if (populate_abs_timeout(&deadline, CAL_CACHE_POLL_MS) != 0) {
+            break;
+        }
+
+        pthread_cond_timedwait(&c->wake, &c->thread_lock, &deadline);
+        if (c->shutdown) {
+            break;
+        }
+
+        MUTEX_UNLOCK(&c->thread_lock);
+
+        MUTEX_LOCK(&dev->lock);
+
+        now = wallclock_get_current_nsec();
+
+        for (ch = 0; ch < CAL_CACHE_CHANNELS; ch++) {
+            const struct cal_cache_channel *chan = &c->ch[ch];
+
+            refresh[ch] = NULL;
+
+            if (chan->enabled && chan->config.refresh != NULL &&
+                tx_idle(c, now, chan->config.tx_idle_ms) &&
+                needs_refresh(c, ch, now)) {
+                refresh[ch]   = chan->config.refresh;
+                user_data[ch] = chan->config.user_data;
+            }
+        }
+
+        MUTEX_UNLOCK(&dev->lock);
+
+        /* The callbacks use the public API, which takes the handle lock */
+        for (ch = 0; ch < CAL_CACHE_CHANNELS; ch++) {
+            if (refresh[ch] != NULL) {
+                status = refresh[ch](dev, ch, user_data[ch]);
+                if (status != 0) {
+                    log_debug("Calibration refresh of channel %d failed: "
+                              "%s\n", ch, bladerf_strerror(status));
+                }
+            }
+        }
+
+        MUTEX_LOCK(&c->thread_lock);
+    }
+
+    MUTEX_UNLOCK(&c->thread_lock);
+
+    return NULL;
+}
+
+int cal_cache_configure(struct bladerf *dev,
+                        bladerf_channel ch,
+                        const struct bladerf_cal_cache_config *config)
+{
+    struct cal_cache *c;
+    struct cal_cache_channel *chan;
+    int status;
+
+    if (ch < 0 || ch >= CAL_CACHE_CHANNELS ||
+        (size_t)(ch >> 1) >=
+            dev->board->get_channel_count(dev, ch & BLADERF_DIRECTION_MASK)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (dev->cal_cache == NULL) {
+        if (config == NULL) {
+            return 0;
+        }
+
+        c = calloc(1, sizeof(*c));
+        if (c == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+
+        c->dev          = dev;
+        c->tx_active_ns = wallclock_get_current_nsec();
+
+        MUTEX_INIT(&c->thread_lock);
+        timeout_cond_init(&c->wake);
+
+        dev->cal_cache = c;
+    }
+
+    c    = dev->cal_cache;
+    chan = &c->ch[ch];
+
+    if (config == NULL) {
+        memset(chan, 0, sizeof(*chan));
+        return 0;
+    }
+
+    if (!chan->enabled) {
+        memset(chan->entries, 0, sizeof(chan->entries));
+        chan->enabled = true;
+        chan->applied = -1;
+    }
+
+    chan->config = *config;
+
+    if (config->refresh != NULL && !c->thread_running) {
+        status = pthread_create(&c->thread, NULL, refresh_worker, c);
+        if (status != 0) {
+            log_debug("Failed to start calibration refresh thread: %s\n",
+                      strerror(status));
+            chan->config.refresh = NULL;
+            return BLADERF_ERR_MEM;
+        }
+
+        c->thread_running = true;
+    }
+
+    return 0;
+}
+
+void cal_cache_deinit(struct bladerf *dev)
+{
+    struct cal_cache *c = dev->cal_cache;
+
+    if (c == NULL) {
+        return;
+    }
+
+    if (c->thread_running) {
+        MUTEX_LOCK(&c->thread_lock);
+        c->shutdown = true;
+        pthread_cond_signal(&c->wake);
+        MUTEX_UNLOCK(&c->thread_lock);
+
+        pthread_join(c->thread, NULL);
+    }
+
+    pthread_cond_destroy(&c->wake);
+    MUTEX_DESTROY(&c->thread_lock);
+
+    free(c);
+    dev->cal_cache = NULL;
+}
@@ -0,0 +1,103 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_CAL_CACHE_H_
+#define HELPERS_CAL_CACHE_H_
+
+#include <libbladeRF.h>
+
+/* Tolerance when matching a frequency against an entry's */
+#define CAL_CACHE_MATCH_HZ 1000
+
+/* Minimum interval between temperature readings */
+#define CAL_CACHE_TEMP_INTERVAL_MS 1000
+
+/* Interval at which the refresh thread checks for stale entries */
+#define CAL_CACHE_POLL_MS 1000
+
+/**
+ * Enable, reconfigure, or disable the calibration cache for a channel. Must
+ * be called with the device's handle lock held.
+ *
+ * The refresh thread is started when a refresh callback is first
+ * configured.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   config      Configuration, or NULL to disable the cache
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int cal_cache_configure(struct bladerf *dev,
+                        bladerf_channel ch,
+                        const struct bladerf_cal_cache_config *config);
+
+/**
+ * Record a correction value written to a channel. Must be called with the
+ * device's handle lock held.
+ *
+ * This is a no-op if the cache is not enabled for the channel.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   corr        Correction type
+ * @param[in]   value       Value written
+ */
+void cal_cache_record_value(struct bladerf *dev,
+                            bladerf_channel ch,
+                            bladerf_correction corr,
+                            int16_t value);
+
+/**
+ * Record all of a channel's current correction values. Must be called with
+ * the device's handle lock held.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if the cache is not enabled for
+ *         the channel, or a value from \ref RETCODES list on other failures
+ */
+int cal_cache_record(struct bladerf *dev, bladerf_channel ch);
+
+/**
+ * Apply the nearest entry for a channel's current operating point, following
+ * a change to it. Must be called with the device's handle lock held.
+ *
+ * This is a no-op if the cache is not enabled for the channel.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int cal_cache_update(struct bladerf *dev, bladerf_channel ch);
+
+/**
+ * Stop the refresh thread and free the cache
+ *
+ * This must be called without the device's handle lock held.
+ *
+ * @param       dev         Device handle
+ */
+void cal_cache_deinit(struct bladerf *dev);
+
+#endif
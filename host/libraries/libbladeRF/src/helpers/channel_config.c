@@ -0,0 +1,245 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "conversions.h"
+#include "log.h"
+#include "range.h"
+
+#include "board/board.h"
+#include "helpers/channel_config.h"
+
+int channel_config_check(struct bladerf *dev,
+                         bladerf_channel ch,
+                         const struct bladerf_channel_config *config)
+{
+    const struct bladerf_range *range = NULL;
+    const uint32_t fields             = config->fields;
+    int status;
+
+    if ((fields & ~BLADERF_CHANNEL_CONFIG_ALL) != 0) {
+        log_debug("%s: unknown fields 0x%x\n", __FUNCTION__, fields);
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (fields & BLADERF_CHANNEL_CONFIG_SAMPLE_RATE) {
+        status = dev->board->get_sample_rate_range(dev, ch, &range);
+        if (status != 0) {
+            return status;
+        }
+
+        if (!is_within_range(range, config->sample_rate)) {
+            log_debug("%s: sample rate %u out of range\n", __FUNCTION__,
+                      config->sample_rate);
+            return BLADERF_ERR_RANGE;
+        }
+    }
+
+    if (fields & BLADERF_CHANNEL_CONFIG_BANDWIDTH) {
+        status = dev->board->get_bandwidth_range(dev, ch, &range);
+        if (status != 0) {
+            return status;
+        }
+
+        if (!is_within_range(range, config->bandwidth)) {
+            log_debug("%s: bandwidth %u out of range\n", __FUNCTION__,
+                      config->bandwidth);
+            return BLADERF_ERR_RANGE;
+        }
+    }
+
+    if (fields & BLADERF_CHANNEL_CONFIG_FREQUENCY) {
+        status = dev->board->get_frequency_range(dev, ch, &range);
+        if (status != 0) {
+            return status;
+        }
+
+        if (!is_within_range(range, config->frequency)) {
+            log_debug("%s: frequency %" PRIu64 " out of range\n",
+                      __FUNCTION__, config->frequency);
+            return BLADERF_ERR_RANGE;
+        }
+    }
+
+    if ((fields & BLADERF_CHANNEL_CONFIG_RF_PORT) && config->rf_port == NULL) {
+        log_debug("%s: RF port selected but not provided\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    return 0;
+}
+
+int channel_config_changes(struct bladerf *dev,
+                           bladerf_channel ch,
+                           const struct bladerf_channel_config *config,
+                           uint32_t *changes)
+{
+    const uint32_t fields = config->fields;
+    int status;
+
+    *changes = 0;
+
+    if (fields & BLADERF_CHANNEL_CONFIG_SAMPLE_RATE) {
+        bladerf_sample_rate rate;
+
+        status = dev->board->get_sample_rate(dev, ch, &rate);
+        if (status != 0) {
+            return status;
+        }
+
+        if (rate != config->sample_rate) {
+            *changes |= BLADERF_CHANNEL_CONFIG_SAMPLE_RATE;
+        }
+    }
+
+    if (fields & BLADERF_CHANNEL_CONFIG_BANDWIDTH) {
+        bladerf_bandwidth bandwidth;
+
+        status = dev->board->get_bandwidth(dev, ch, &bandwidth);
+        if (status != 0) {
+            return status;
+        }
+
+        if (bandwidth != config->bandwidth) {
+            *changes |= BLADERF_CHANNEL_CONFIG_BANDWIDTH;
+        }
+    }
+
+    if (fields & BLADERF_CHANNEL_CONFIG_FREQUENCY) {
+        bladerf_frequency frequency;
+
+        status = dev->board->get_frequency(dev, ch, &frequency);
+        if (status != 0) {
+            return status;
+        }
+
+        if (frequency != config->frequency) {
+            *changes |= BLADERF_CHANNEL_CONFIG_FREQUENCY;
+        }
+    }
+
+    if (fields & BLADERF_CHANNEL_CONFIG_RF_PORT) {
+        const char *port;
+
+        status = dev->board->get_rf_port(dev, ch, &port);
+        if (status != 0) {
+            return status;
+        }
+
+        if (strcmp(port, config->rf_port) != 0) {
+            *changes |= BLADERF_CHANNEL_CONFIG_RF_PORT;
+        }
+    }
+
+    /* Gain modes only apply to RX channels */
+    if ((fields & BLADERF_CHANNEL_CONFIG_GAIN_MODE) &&
+        !BLADERF_CHANNEL_IS_TX(ch)) {
+        bladerf_gain_mode mode;
+
+        status = dev->board->get_gain_mode(dev, ch, &mode);
+        if (status != 0) {
+            return status;
+        }
+
+        if (mode != config->gain_mode) {
+            *changes |= BLADERF_CHANNEL_CONFIG_GAIN_MODE;
+        }
+    }
+
+    if (fields & BLADERF_CHANNEL_CONFIG_GAIN) {
+        bladerf_gain gain;
+
+        status = dev->board->get_gain(dev, ch, &gain);
+        if (status != 0) {
+            return status;
+        }
+
+        /* The gain offset depends upon the frequency, so a gain that
+         * matches now may not match after retuning */
+        if (gain != config->gain ||
+            (*changes & BLADERF_CHANNEL_CONFIG_FREQUENCY)) {
+            *changes |= BLADERF_CHANNEL_CONFIG_GAIN;
+        }
+    }
+
+    log_verbose("%s: %s fields 0x%02x, changes 0x%02x\n", __FUNCTION__,
+                channel2str(ch), fields, *changes);
+
+    return 0;
+}
+
+int channel_config_apply(struct bladerf *dev,
+                         bladerf_channel ch,
+                         const struct bladerf_channel_config *config,
+                         uint32_t changes)
+{
+    int status;
+
+    if (changes & BLADERF_CHANNEL_CONFIG_SAMPLE_RATE) {
+        status = dev->board->set_sample_rate(dev, ch, config->sample_rate,
+                                             NULL);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    if (changes & BLADERF_CHANNEL_CONFIG_BANDWIDTH) {
+        status = dev->board->set_bandwidth(dev, ch, config->bandwidth, NULL);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    if (changes & BLADERF_CHANNEL_CONFIG_FREQUENCY) {
+        status = dev->board->set_frequency(dev, ch, config->frequency);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    /* Tuning may select an RF port automatically, so an explicit port
+     * selection must follow it */
+    if (changes & BLADERF_CHANNEL_CONFIG_RF_PORT) {
+        status = dev->board->set_rf_port(dev, ch, config->rf_port);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    if (changes & BLADERF_CHANNEL_CONFIG_GAIN_MODE) {
+        status = dev->board->set_gain_mode(dev, ch, config->gain_mode);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    if (changes & BLADERF_CHANNEL_CONFIG_GAIN) {
+        status = dev->board->set_gain(dev, ch, config->gain);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file channel_config.h
+ *
+ * @brief Shared support for bladerf_apply_config()
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_CHANNEL_CONFIG_H_
+#define HELPERS_CHANNEL_CONFIG_H_
+
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+/**
+ * Validate the fields selected by a channel configuration
+ *
+ * Must be called with the device's handle lock held.
+ *
+ * @param       dev     Device handle
+ * @param[in]   ch      Channel
+ * @param[in]   config  Configuration to check
+ *
+ * @return 0 if all selected fields are valid, BLADERF_ERR_INVAL or
+ *         BLADERF_ERR_RANGE otherwise
+ */
+int channel_config_check(struct bladerf *dev,
+                         bladerf_channel ch,
+                         const struct bladerf_channel_config *config);
+
+/**
+ * Determine which selected fields differ from the channel's current state
+ *
+ * Must be called with the device's handle lock held.
+ *
+ * @param       dev     Device handle
+ * @param[in]   ch      Channel
+ * @param[in]   config  Configuration to compare against
+ * @param[out]  changes Bitwise OR of BLADERF_CHANNEL_CONFIG flags for the
+ *                      fields that must be written
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int channel_config_changes(struct bladerf *dev,
+                           bladerf_channel ch,
+                           const struct bladerf_channel_config *config,
+                           uint32_t *changes);
+
+/**
+ * Write the specified fields through the board's individual setters, in
+ * the order documented for bladerf_apply_config()
+ *
+ * Must be called with the device's handle lock held.
+ *
+ * @param       dev     Device handle
+ * @param[in]   ch      Channel
+ * @param[in]   config  Configuration to apply
+ * @param[in]   changes Fields to write, from channel_config_changes()
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int channel_config_apply(struct bladerf *dev,
+                         bladerf_channel ch,
+                         const struct bladerf_channel_config *config,
+                         uint32_t changes);
+
+#endif
@@ -19,6 +19,9 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <stdio.h>
+#include <stdlib.h>
+
 #include <libbladeRF.h>
 
 #include "conversions.h"
@@ -40,6 +43,28 @@ const struct numeric_suffix freq_suffixes[] = { { "G", 1000 * 1000 * 1000 },
 #define MAX(a, b) (a > b ? a : b)
 #define MIN(a, b) (a < b ? a : b)
 
+/* Match a per-direction key, of the form <base>_rx or <base>_tx */
+static bool match_dir_key(const char *key,
+                          const char *base,
+                          bladerf_direction *dir)
+{
+    const size_t len = strlen(base);
+
+    if (strncasecmp(key, base, len) != 0) {
+        return false;
+    }
+
+    if (!strcasecmp(key + len, "_rx")) {
+        *dir = BLADERF_RX;
+        return true;
+    } else if (!strcasecmp(key + len, "_tx")) {
+        *dir = BLADERF_TX;
+        return true;
+    }
+
+    return false;
+}
+
 static int apply_config_options(struct bladerf *dev, struct config_options opt)
 {
     int status;
@@ -54,6 +79,7 @@ static int apply_config_options(struct bladerf *dev, struct config_options opt)
     bladerf_vctcxo_tamer_mode tamer_mode = BLADERF_VCTCXO_TAMER_INVALID;
 
     struct bladerf_rational_rate rate, actual;
+    bladerf_direction dir;
 
     status = BLADERF_ERR_INVAL;
 
@@ -88,6 +114,47 @@ static int apply_config_options(struct bladerf *dev, struct config_options opt)
                         opt.lineno, opt.value);
         }
         return status;
+    } else if (!strcasecmp(opt.key, "profile")) {
+        status = bladerf_load_profile(dev, strcasecmp(opt.value, "default")
+                                               ? opt.value
+                                               : NULL);
+        if (status < 0) {
+            log_warning("Config line %d: could not restore profile `%s'\n",
+                        opt.lineno, opt.value);
+        }
+        return status;
+    } else if (match_dir_key(opt.key, "sync_sizing", &dir)) {
+        unsigned int num_buffers, buffer_size, num_transfers;
+        char extra;
+
+        if (!strcasecmp(opt.value, "auto")) {
+            num_buffers = buffer_size = num_transfers = 0;
+        } else if (sscanf(opt.value, "%u,%u,%u%c", &num_buffers,
+                          &buffer_size, &num_transfers, &extra) != 3) {
+            return BLADERF_ERR_INVAL;
+        }
+
+        status = bladerf_set_sync_auto_sizing(dev, dir, num_buffers,
+                                              buffer_size, num_transfers);
+    } else if (match_dir_key(opt.key, "sync_low_latency", &dir)) {
+        bool enable = false;
+
+        status = str2bool(opt.value, &enable);
+        if (status < 0) {
+            return BLADERF_ERR_INVAL;
+        }
+
+        status = bladerf_set_sync_low_latency(dev, dir, enable);
+    } else if (match_dir_key(opt.key, "stream_cpu_mask", &dir)) {
+        struct bladerf_stream_thread_attrs attrs = { 0, 0 };
+        char *end;
+
+        attrs.cpu_mask = strtoull(opt.value, &end, 0);
+        if (end == opt.value || *end != '\0') {
+            return BLADERF_ERR_INVAL;
+        }
+
+        status = bladerf_set_stream_thread_attrs(dev, dir, &attrs);
     } else if (!strcasecmp(opt.key, "frequency")) {
         status =
             bladerf_get_frequency_range(dev, BLADERF_CHANNEL_RX(0), &rx_range);
@@ -0,0 +1,297 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+
+#include "board/board.h"
+#include "helpers/ctrl_queue.h"
+#include "helpers/timeout.h"
+
+struct ctrl_entry {
+    struct ctrl_op op;
+    bladerf_ctrl_ticket ticket;
+    bool done;
+    int status;
+};
+
+struct ctrl_queue {
+    struct bladerf *dev;
+
+    pthread_t thread;
+    MUTEX lock;
+    pthread_cond_t submitted; /* Signaled when an operation is enqueued */
+    pthread_cond_t completed; /* Signaled when an operation completes */
+    bool shutdown;
+
+    /* Entries are indexed by ticket % CTRL_QUEUE_LEN. Tickets in
+     * [next_exec, next_ticket) are pending. */
+    struct ctrl_entry entries[CTRL_QUEUE_LEN];
+    bladerf_ctrl_ticket next_ticket;
+    bladerf_ctrl_ticket next_exec;
+};
+
+static int perform(struct bladerf *dev, const struct ctrl_op *op)
+{
+    switch (op->type) {
+        case CTRL_OP_SET_GAIN:
+            return bladerf_set_gain(dev, op->ch, op->params.gain);
+
+        case CTRL_OP_SET_FREQUENCY:
+            return bladerf_set_frequency(dev, op->ch, op->params.frequency);
+
+        case CTRL_OP_SET_BANDWIDTH:
+            return bladerf_set_bandwidth(dev, op->ch, op->params.bw.bandwidth,
+                                         op->params.bw.actual);
+
+        case CTRL_OP_SCHEDULE_GAIN:
+            return bladerf_schedule_gain(dev, op->ch,
+                                         op->params.sched_gain.timestamp,
+                                         op->params.sched_gain.gain);
+
+        default:
+            return BLADERF_ERR_INVAL;
+    }
+}
+
+static void *ctrl_worker(void *arg)
+{
+    struct ctrl_queue *q = arg;
+    struct ctrl_entry *e;
+    struct ctrl_op op;
+    bladerf_ctrl_ticket ticket;
+    int status;
+
+    MUTEX_LOCK(&q->lock);
+
+    while (true) {
+        while (q->next_exec == q->next_ticket && !q->shutdown) {
+            pthread_cond_wait(&q->submitted, &q->lock);
+        }
+
+        /* Pending operations are performed prior to shutting down */
+        if (q->next_exec == q->next_ticket) {
+            break;
+        }
+
+        ticket = q->next_exec;
+        op     = q->entries[ticket % CTRL_QUEUE_LEN].op;
+
+        MUTEX_UNLOCK(&q->lock);
+
+        status = perform(q->dev, &op);
+        if (op.cb != NULL) {
+            op.cb(q->dev, ticket, status, op.user_data);
+        }
+
+        MUTEX_LOCK(&q->lock);
+
+        e         = &q->entries[ticket % CTRL_QUEUE_LEN];
+        e->status = status;
+        e->done   = true;
+        q->next_exec++;
+
+        pthread_cond_broadcast(&q->completed);
+    }
+
+    MUTEX_UNLOCK(&q->lock);
+
+    return NULL;
+}
+
+static int ctrl_queue_init(struct bladerf *dev, struct ctrl_queue **out)
+{
+    struct ctrl_queue *q;
+    int status;
+
+    q = calloc(1, sizeof(*q));
+    if (q == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    q->dev         = dev;
+    q->next_ticket = 1;
+    q->next_exec   = 1;
+
+    MUTEX_INIT(&q->lock);
+    pthread_cond_init(&q->submitted, NULL);
+    timeout_cond_init(&q->completed);
+
+    status = pthread_create(&q->thread, NULL, ctrl_worker, q);
+    if (status != 0) {
+        log_debug("Failed to start control worker: %s\n", strerror(status));
+        pthread_cond_destroy(&q->submitted);
+        pthread_cond_destroy(&q->completed);
+        free(q);
+        return BLADERF_ERR_MEM;
+    }
+
+    *out = q;
+    return 0;
+}
+
+int ctrl_queue_submit(struct bladerf *dev,
+                      const struct ctrl_op *op,
+                      bladerf_ctrl_ticket *ticket)
+{
+    struct ctrl_queue *q;
+    struct ctrl_entry *e;
+    int status = 0;
+
+    MUTEX_LOCK(&dev->lock);
+    if (dev->ctrl_queue == NULL) {
+        status = ctrl_queue_init(dev, &dev->ctrl_queue);
+    }
+    q = dev->ctrl_queue;
+    MUTEX_UNLOCK(&dev->lock);
+
+    if (status != 0) {
+        return status;
+    }
+
+    MUTEX_LOCK(&q->lock);
+
+    if (q->shutdown) {
+        MUTEX_UNLOCK(&q->lock);
+        log_debug("%s: Device is being closed.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (q->next_ticket - q->next_exec >= CTRL_QUEUE_LEN) {
+        MUTEX_UNLOCK(&q->lock);
+        return BLADERF_ERR_QUEUE_FULL;
+    }
+
+    e         = &q->entries[q->next_ticket % CTRL_QUEUE_LEN];
+    e->op     = *op;
+    e->ticket = q->next_ticket;
+    e->done   = false;
+    e->status = 0;
+
+    if (ticket != NULL) {
+        *ticket = q->next_ticket;
+    }
+
+    q->next_ticket++;
+
+    pthread_cond_signal(&q->submitted);
+    MUTEX_UNLOCK(&q->lock);
+
+    return 0;
+}
+
+int ctrl_queue_wait(struct bladerf *dev,
+                    bladerf_ctrl_ticket ticket,
+                    bool block,
+                    unsigned int timeout_ms,
+                    int *status)
+{
+    struct ctrl_queue *q;
+    struct ctrl_entry *e;
+    struct timespec timeout_abs;
+    int wait_status = 0;
+
+    MUTEX_LOCK(&dev->lock);
+    q = dev->ctrl_queue;
+    MUTEX_UNLOCK(&dev->lock);
+
+    if (q == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (block && timeout_ms != 0) {
+        if (populate_abs_timeout(&timeout_abs, timeout_ms) != 0) {
+            return BLADERF_ERR_UNEXPECTED;
+        }
+    }
+
+    MUTEX_LOCK(&q->lock);
+
+    if (ticket == 0 || ticket >= q->next_ticket) {
+        MUTEX_UNLOCK(&q->lock);
+        return BLADERF_ERR_INVAL;
+    }
+
+    e = &q->entries[ticket % CTRL_QUEUE_LEN];
+
+    while (wait_status == 0 && e->ticket == ticket && !e->done) {
+        if (!block) {
+            MUTEX_UNLOCK(&q->lock);
+            return BLADERF_ERR_WOULD_BLOCK;
+        } else if (timeout_ms == 0) {
+            wait_status = pthread_cond_wait(&q->completed, &q->lock);
+        } else {
+            wait_status = pthread_cond_timedwait(&q->completed, &q->lock,
+                                                 &timeout_abs);
+        }
+    }
+
+    if (e->ticket != ticket) {
+        MUTEX_UNLOCK(&q->lock);
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!e->done) {
+        MUTEX_UNLOCK(&q->lock);
+        return (wait_status == ETIMEDOUT) ? BLADERF_ERR_TIMEOUT
+                                          : BLADERF_ERR_UNEXPECTED;
+    }
+
+    if (status != NULL) {
+        *status = e->status;
+    }
+
+    MUTEX_UNLOCK(&q->lock);
+
+    return 0;
+}
+
+void ctrl_queue_deinit(struct bladerf *dev)
+{
+    struct ctrl_queue *q;
+
+    MUTEX_LOCK(&dev->lock);
+    q = dev->ctrl_queue;
+    MUTEX_UNLOCK(&dev->lock);
+
+    if (q == NULL) {
+        return;
+    }
+
+    MUTEX_LOCK(&q->lock);
+    q->shutdown = true;
+    pthread_cond_signal(&q->submitted);
+    MUTEX_UNLOCK(&q->lock);
+
+    pthread_join(q->thread, NULL);
+
+    MUTEX_LOCK(&dev->lock);
+    dev->ctrl_queue = NULL;
+    MUTEX_UNLOCK(&dev->lock);
+
+    pthread_cond_destroy(&q->submitted);
+    pthread_cond_destroy(&q->completed);
+    free(q);
+}
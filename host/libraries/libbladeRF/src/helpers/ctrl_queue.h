@@ -0,0 +1,117 @@
+/**
+ * @file ctrl_queue.h
+ *
+ * @brief Per-device queue of asynchronous control operations
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+#ifndef HELPERS_CTRL_QUEUE_H_
+#define HELPERS_CTRL_QUEUE_H_
+
+#include <libbladeRF.h>
+
+/* Maximum number of pending operations, and the number of completed
+ * operations whose status remains available via ctrl_queue_poll() */
+#define CTRL_QUEUE_LEN BLADERF_CTRL_QUEUE_LEN
+
+typedef enum {
+    CTRL_OP_SET_GAIN,
+    CTRL_OP_SET_FREQUENCY,
+    CTRL_OP_SET_BANDWIDTH,
+    CTRL_OP_SCHEDULE_GAIN,
+} ctrl_op_type;
+
+/**
+ * A control operation to be performed by the device's control worker
+ */
+struct ctrl_op {
+    ctrl_op_type type;
+    bladerf_channel ch;
+
+    union {
+        bladerf_gain gain;
+        bladerf_frequency frequency;
+        struct {
+            bladerf_bandwidth bandwidth;
+            bladerf_bandwidth *actual;
+        } bw;
+        struct {
+            bladerf_timestamp timestamp;
+            bladerf_gain gain;
+        } sched_gain;
+    } params;
+
+    bladerf_ctrl_cb cb;
+    void *user_data;
+};
+
+/**
+ * Enqueue an operation, starting the device's control worker if needed
+ *
+ * Operations are performed in the order they are submitted.
+ *
+ * @param       dev     Device handle
+ * @param[in]   op      Operation to perform. Copied.
+ * @param[out]  ticket  Updated with the operation's ticket. May be NULL.
+ *
+ * @return 0 on success, BLADERF_ERR_QUEUE_FULL if CTRL_QUEUE_LEN operations
+ *         are already pending, or BLADERF_ERR_MEM if the worker could not be
+ *         started
+ */
+int ctrl_queue_submit(struct bladerf *dev,
+                      const struct ctrl_op *op,
+                      bladerf_ctrl_ticket *ticket);
+
+/**
+ * Check for, or wait upon, the completion of an operation
+ *
+ * @param       dev         Device handle
+ * @param[in]   ticket      Ticket returned by ctrl_queue_submit()
+ * @param[in]   block       Wait for the operation to complete
+ * @param[in]   timeout_ms  Timeout, in ms, if blocking. 0 implies an
+ *                          infinite wait.
+ * @param[out]  status      Updated with the operation's status. May be NULL.
+ *
+ * @return 0 if the operation completed, BLADERF_ERR_WOULD_BLOCK if it is
+ *         pending and `block` is false, BLADERF_ERR_TIMEOUT if it did not
+ *         complete in time, or BLADERF_ERR_INVAL if the ticket is unknown or
+ *         its status is no longer available
+ */
+int ctrl_queue_wait(struct bladerf *dev,
+                    bladerf_ctrl_ticket ticket,
+                    bool block,
+                    unsigned int timeout_ms,
+                    int *status);
+
+/**
+ * Perform all pending operations and stop the device's control worker
+ *
+ * This must be called without the device's handle lock held.
+ *
+ * @param       dev     Device handle
+ */
+void ctrl_queue_deinit(struct bladerf *dev);
+
+#endif
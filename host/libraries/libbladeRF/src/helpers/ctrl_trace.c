@@ -0,0 +1,262 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "thread.h"
+
+#include "board/board.h"
+
+#include "helpers/ctrl_trace.h"
+#include "helpers/timeline.h"
+#include "helpers/wallclock.h"
+
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && \
+    !defined(__STDC_NO_ATOMICS__)
+#   include <stdatomic.h>
+#   define CTRL_TRACE_HAVE_ATOMICS 1
+#else
+#   define CTRL_TRACE_HAVE_ATOMICS 0
+#endif
+
+#if CTRL_TRACE_HAVE_ATOMICS
+
+/* Entries are claimed by atomically incrementing the ring's head, allowing
+ * any number of threads to record without locking.
+ *
+ * Each slot's sequence number is odd while the slot is being written, and
+ * is set to 2 * (index + 1) once entry `index` has been published. The
+ * reader uses this to detect entries that have yet to be published, and
+ * entries overwritten while being copied out. */
+struct ctrl_trace_slot {
+    atomic_uint_fast64_t seq;
+    struct bladerf_ctrl_trace_entry entry;
+};
+
+struct ctrl_trace {
+    atomic_bool enabled;
+    atomic_uint_fast64_t head;
+
+    /* Reader state, protected by read_lock */
+    MUTEX read_lock;
+    uint64_t tail;
+    uint64_t dropped;
+
+    struct ctrl_trace_slot slots[BLADERF_CTRL_TRACE_LEN];
+};
+
+uint64_t ctrl_trace_begin(struct bladerf *dev)
+{
+    struct ctrl_trace *t = dev->ctrl_trace;
+
+    if (t == NULL ||
+        !atomic_load_explicit(&t->enabled, memory_order_relaxed)) {
+        /* The transaction may still be wanted for the stream timeline */
+        return timeline_begin(dev);
+    }
+
+    return wallclock_get_current_nsec();
+}
+
+void ctrl_trace_end(struct bladerf *dev,
+                    uint64_t start,
+                    bladerf_ctrl_trace_kind kind,
+                    uint8_t opcode,
+                    uint8_t target,
+                    bool write,
+                    int status)
+{
+    struct ctrl_trace *t = dev->ctrl_trace;
+    struct ctrl_trace_slot *slot;
+    uint64_t idx, end;
+
+    if (start == 0) {
+        return;
+    }
+
+    end = wallclock_get_current_nsec();
+
+    timeline_ctrl(dev, start, end, kind, opcode, target, write, status);
+
+    if (t == NULL ||
+        !atomic_load_explicit(&t->enabled, memory_order_relaxed)) {
+        return;
+    }
+
+    idx  = atomic_fetch_add_explicit(&t->head, 1, memory_order_relaxed);
+    slot = &t->slots[idx % BLADERF_CTRL_TRACE_LEN];
+
+    atomic_store_explicit(&slot->seq, 2 * idx + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    slot->entry.timestamp = start;
+    slot->entry.duration  = (end > start) ? (end - start) : 0;
+    slot->entry.kind      = kind;
+    slot->entry.opcode    = opcode;
+    slot->entry.target    = target;
+    slot->entry.write     = write;
+    slot->entry.status    = status;
+
+    atomic_store_explicit(&slot->seq, 2 * idx + 2, memory_order_release);
+}
+
+int ctrl_trace_enable(struct bladerf *dev, bool enable)
+{
+    struct ctrl_trace *t = dev->ctrl_trace;
+
+    if (t == NULL) {
+        if (!enable) {
+            return 0;
+        }
+
+        t = calloc(1, sizeof(*t));
+        if (t == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+
+        MUTEX_INIT(&t->read_lock);
+        atomic_init(&t->enabled, false);
+        atomic_init(&t->head, 0);
+
+        /* Publish the initialized ring to threads recording without the
+         * handle lock */
+        atomic_thread_fence(memory_order_release);
+        dev->ctrl_trace = t;
+    }
+
+    atomic_store_explicit(&t->enabled, enable, memory_order_relaxed);
+    log_debug("Control-path tracing %s.\n", enable ? "enabled" : "disabled");
+
+    return 0;
+}
+
+int ctrl_trace_read(struct bladerf *dev,
+                    struct bladerf_ctrl_trace_entry *entries,
+                    unsigned int max_entries,
+                    unsigned int *num_read,
+                    uint64_t *dropped)
+{
+    struct ctrl_trace *t = dev->ctrl_trace;
+    unsigned int n = 0;
+    uint64_t head;
+
+    if (t == NULL) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    MUTEX_LOCK(&t->read_lock);
+
+    head = atomic_load_explicit(&t->head, memory_order_relaxed);
+
+    /* Skip over entries that have already been overwritten */
+    if (head - t->tail > BLADERF_CTRL_TRACE_LEN) {
+        t->dropped += head - t->tail - BLADERF_CTRL_TRACE_LEN;
+        t->tail = head - BLADERF_CTRL_TRACE_LEN;
+    }
+
+    while (n < max_entries && t->tail != head) {
+        struct ctrl_trace_slot *slot =
+            &t->slots[t->tail % BLADERF_CTRL_TRACE_LEN];
+        const uint64_t published = 2 * t->tail + 2;
+        uint64_t seq;
+
+        seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (seq < published) {
+            /* Claimed but not yet published. Leave it for the next read. */
+            break;
+        }
+
+        if (seq == published) {
+            entries[n] = slot->entry;
+            atomic_thread_fence(memory_order_acquire);
+            seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+        }
+
+        if (seq == published) {
+            n++;
+        } else {
+            t->dropped++;
+        }
+
+        t->tail++;
+    }
+
+    if (dropped != NULL) {
+        *dropped   = t->dropped;
+        t->dropped = 0;
+    }
+
+    MUTEX_UNLOCK(&t->read_lock);
+
+    *num_read = n;
+    return 0;
+}
+
+void ctrl_trace_deinit(struct bladerf *dev)
+{
+    struct ctrl_trace *t = dev->ctrl_trace;
+
+    if (t != NULL) {
+        MUTEX_DESTROY(&t->read_lock);
+        free(t);
+        dev->ctrl_trace = NULL;
+    }
+}
+
+#else
+
+uint64_t ctrl_trace_begin(struct bladerf *dev)
+{
+    return timeline_begin(dev);
+}
+
+void ctrl_trace_end(struct bladerf *dev,
+                    uint64_t start,
+                    bladerf_ctrl_trace_kind kind,
+                    uint8_t opcode,
+                    uint8_t target,
+                    bool write,
+                    int status)
+{
+}
+
+int ctrl_trace_enable(struct bladerf *dev, bool enable)
+{
+    log_debug("Control-path tracing requires C11 atomics.\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int ctrl_trace_read(struct bladerf *dev,
+                    struct bladerf_ctrl_trace_entry *entries,
+                    unsigned int max_entries,
+                    unsigned int *num_read,
+                    uint64_t *dropped)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+void ctrl_trace_deinit(struct bladerf *dev)
+{
+}
+
+#endif
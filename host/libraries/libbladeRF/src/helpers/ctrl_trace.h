@@ -0,0 +1,97 @@
+/**
+ * @file ctrl_trace.h
+ *
+ * @brief Control-path transaction tracing
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_CTRL_TRACE_H_
+#define HELPERS_CTRL_TRACE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+/**
+ * Begin tracing a control transaction
+ *
+ * @param       dev     Device handle
+ *
+ * @return The transaction's start time, to be passed to ctrl_trace_end(), or
+ *         0 if tracing is disabled
+ */
+uint64_t ctrl_trace_begin(struct bladerf *dev);
+
+/**
+ * Record a completed control transaction
+ *
+ * This is a no-op if `start` is 0.
+ *
+ * @param       dev     Device handle
+ * @param[in]   start   Value returned by ctrl_trace_begin()
+ * @param[in]   kind    Transaction type
+ * @param[in]   opcode  NIOS II packet magic or vendor request
+ * @param[in]   target  NIOS II packet target ID, or 0
+ * @param[in]   write   Transaction writes to the device
+ * @param[in]   status  Transaction status
+ */
+void ctrl_trace_end(struct bladerf *dev,
+                    uint64_t start,
+                    bladerf_ctrl_trace_kind kind,
+                    uint8_t opcode,
+                    uint8_t target,
+                    bool write,
+                    int status);
+
+/**
+ * Enable or disable tracing. Must be called with the device's handle lock
+ * held.
+ *
+ * @param       dev     Device handle
+ * @param[in]   enable  Enable tracing
+ *
+ * @return 0 on success, BLADERF_ERR_MEM or BLADERF_ERR_UNSUPPORTED on failure
+ */
+int ctrl_trace_enable(struct bladerf *dev, bool enable);
+
+/**
+ * Read and remove recorded transactions, oldest first
+ *
+ * @see bladerf_read_ctrl_trace()
+ */
+int ctrl_trace_read(struct bladerf *dev,
+                    struct bladerf_ctrl_trace_entry *entries,
+                    unsigned int max_entries,
+                    unsigned int *num_read,
+                    uint64_t *dropped);
+
+/**
+ * Free the device's trace. The backend must no longer be in use.
+ *
+ * @param       dev     Device handle
+ */
+void ctrl_trace_deinit(struct bladerf *dev);
+
+#endif
@@ -37,6 +37,12 @@
 
 #include "helpers/file.h"
 
+#if !BLADERF_OS_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 /* Paths to search for bladeRF files */
 struct search_path_entries {
     bool prepend_home;
@@ -164,6 +170,123 @@ out:
     return status;
 }
 
+#if BLADERF_OS_WINDOWS
+
+/* Files are read into a heap buffer, which is used the same way */
+int file_map(const char *filename, const uint8_t **buf, size_t *size)
+{
+    uint8_t *data;
+    int status;
+
+    status = file_read_buffer(filename, &data, size);
+    if (status == 0) {
+        *buf = data;
+    }
+
+    return status;
+}
+
+void file_unmap(const uint8_t *buf, size_t size)
+{
+    free((void *)buf);
+}
+
+#else
+
+#ifndef MAP_ANONYMOUS
+#   define MAP_ANONYMOUS MAP_ANON
+#endif
+
+/* For files that cannot be mapped, read the contents into an anonymous
+ * mapping, so that file_unmap() need not know which was used */
+static void *read_to_anon_mapping(int fd, size_t size)
+{
+    uint8_t *data;
+    size_t count = 0;
+    ssize_t n;
+
+    data = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+        log_debug("%s: mmap failed: %s\n", __FUNCTION__, strerror(errno));
+        return MAP_FAILED;
+    }
+
+    while (count < size) {
+        n = read(fd, &data[count], size - count);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n <= 0) {
+            log_debug("%s: read failed: %s\n", __FUNCTION__,
+                      (n < 0) ? strerror(errno) : "unexpected end of file");
+            munmap(data, size);
+            return MAP_FAILED;
+        }
+
+        count += (size_t)n;
+    }
+
+    if (mprotect(data, size, PROT_READ) != 0) {
+        log_debug("%s: mprotect failed: %s\n", __FUNCTION__, strerror(errno));
+    }
+
+    return data;
+}
+
+int file_map(const char *filename, const uint8_t **buf, size_t *size)
+{
+    struct stat st;
+    void *data;
+    int fd;
+
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        log_error("%s: could not open %s: %s\n", __FUNCTION__, filename,
+                  strerror(errno));
+        switch (errno) {
+            case ENOENT:
+                return BLADERF_ERR_NO_FILE;
+
+            case EACCES:
+                return BLADERF_ERR_PERMISSION;
+
+            default:
+                return BLADERF_ERR_IO;
+        }
+    }
+
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return BLADERF_ERR_IO;
+    }
+
+    data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        log_debug("%s: mmap failed, reading file instead: %s\n",
+                  __FUNCTION__, strerror(errno));
+
+        data = read_to_anon_mapping(fd, (size_t)st.st_size);
+    }
+
+    /* The mapping remains valid once the descriptor is closed */
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        return BLADERF_ERR_IO;
+    }
+
+    *buf  = data;
+    *size = (size_t)st.st_size;
+    return 0;
+}
+
+void file_unmap(const uint8_t *buf, size_t size)
+{
+    munmap((void *)buf, size);
+}
+
+#endif
+
 /* Remove the last entry in a path. This is used to strip the executable name
 * from a path to get the directory that the executable resides in. */
 static size_t strip_last_path_entry(char *buf, char dir_delim)
@@ -509,3 +632,86 @@ char *file_find(const char *filename)
     free(full_path);
     return NULL;
 }
+
+char *file_user_path(const char *filename)
+{
+    size_t i, len;
+    char *full_path;
+
+    for (i = 0; i < ARRAY_SIZE(search_paths); i++) {
+        if (search_paths[i].prepend_home) {
+            break;
+        }
+    }
+
+    if (i == ARRAY_SIZE(search_paths)) {
+        return NULL;
+    }
+
+    full_path = calloc(PATH_MAX_LEN + 1, 1);
+    if (full_path == NULL) {
+        return NULL;
+    }
+
+    len = get_home_dir(full_path, PATH_MAX_LEN);
+    if (len == 0 || (PATH_MAX_LEN - len) <= (strlen(search_paths[i].path) +
+                                             strlen(filename))) {
+        free(full_path);
+        return NULL;
+    }
+
+    /* Create each missing directory along the way */
+    strcat(full_path, search_paths[i].path);
+    for (i = len + 1; full_path[i] != '\0'; i++) {
+        if (full_path[i] == '/') {
+            full_path[i] = '\0';
+            if (mkdir(full_path, S_IRWXU) != 0 && errno != EEXIST) {
+                log_debug("Failed to create %s: %s\n", full_path,
+                          strerror(errno));
+                free(full_path);
+                return NULL;
+            }
+            full_path[i] = '/';
+        }
+    }
+
+    strcat(full_path, filename);
+    return full_path;
+}
+
+bool file_serial_is_valid(const char *serial)
+{
+    size_t i;
+
+    for (i = 0; serial[i] != '\0'; i++) {
+        if (serial[i] != '0') {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+char *file_device_path(const char *prefix,
+                       const char *serial,
+                       const char *suffix)
+{
+    const size_t len = strlen(prefix) + strlen(serial) + strlen(suffix) + 2;
+    char *filename, *full_path;
+
+    if (!file_serial_is_valid(serial)) {
+        return NULL;
+    }
+
+    filename = malloc(len);
+    if (filename == NULL) {
+        return NULL;
+    }
+
+    snprintf(filename, len, "%s-%s%s", prefix, serial, suffix);
+
+    full_path = file_user_path(filename);
+    free(filename);
+
+    return full_path;
+}
@@ -30,6 +30,7 @@
 #ifndef HELPERS_FILE_H_
 #define HELPERS_FILE_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 
@@ -49,6 +50,30 @@
  */
 int file_read_buffer(const char *filename, uint8_t **buf, size_t *size);
 
+/**
+ * Map a file's contents, read-only, into memory
+ *
+ * Where memory mapping is unavailable, or the file cannot be mapped, the file
+ * is read into memory instead. Either way, the contents must be released with
+ * file_unmap().
+ *
+ * @param[in]   filename    File to map
+ * @param[out]  buf         Upon success, this will point to the contents
+ * @param[out]  size        Upon success, this will be updated to reflect the
+ *                          size of the file
+ *
+ * @return 0 on success, negative BLADERF_ERR_* value on failure
+ */
+int file_map(const char *filename, const uint8_t **buf, size_t *size);
+
+/**
+ * Release file contents obtained with file_map()
+ *
+ * @param[in]   buf         Contents returned by file_map()
+ * @param[in]   size        Size returned by file_map()
+ */
+void file_unmap(const uint8_t *buf, size_t size);
+
 /**
  * Write to an open file stream.
  *
@@ -94,4 +119,41 @@ ssize_t file_size(FILE *f);
  */
 char *file_find(const char *filename);
 
+/**
+ * Get the path of a file in the user's bladeRF config directory (e.g.,
+ * ~/.config/Nuand/bladeRF/ on Linux), creating the directory if needed.
+ * The file itself need not exist. The caller is responsible for freeing the
+ * returned path.
+ * @param[in]   filename    File name
+ * @return Full path on success, NULL otherwise.
+ */
+char *file_user_path(const char *filename);
+
+/**
+ * Determine whether a device's serial number may be used to name files that
+ * belong to it. An all-zero serial is used when the real one could not be
+ * read, and would be shared by every such device.
+ *
+ * @param[in]   serial      Serial number string
+ *
+ * @return true if the serial identifies the device, false otherwise
+ */
+bool file_serial_is_valid(const char *serial);
+
+/**
+ * Get the path of a per-device file, named `<prefix>-<serial><suffix>`, in
+ * the user's bladeRF config directory. See file_user_path(). The caller is
+ * responsible for freeing the returned path.
+ *
+ * @param[in]   prefix      File name prefix (e.g., "probe")
+ * @param[in]   serial      Device serial number
+ * @param[in]   suffix      File name suffix, including any extension
+ *
+ * @return Full path on success, NULL if the serial is not valid (see
+ *         file_serial_is_valid()) or on failure.
+ */
+char *file_device_path(const char *prefix,
+                       const char *serial,
+                       const char *suffix);
+
 #endif
@@ -0,0 +1,149 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <libbladeRF.h>
+
+#include "minmax.h"
+
+#include "bladeRF.h"
+#include "helpers/fpga_compress.h"
+
+/* Bytes of tokens that fit within a block, following its length */
+#define BLOCK_TOKEN_SPACE (BLADE_FPGA_CBLOCK_SIZE - 2)
+
+/* Maximum literal and run lengths */
+#define LITERAL_MAX 128
+#define RUN_MAX 0x8000
+
+/* Shortest run worth encoding as such, rather than as part of a literal */
+#define RUN_MIN 3
+
+struct encoder {
+    uint8_t *buf;
+    size_t block;   /* Offset of the current block */
+    size_t used;    /* Token bytes in the current block */
+    size_t raw;     /* Decoded length of the current block */
+};
+
+static void finish_block(struct encoder *enc, bool pad)
+{
+    uint8_t *block = &enc->buf[enc->block];
+
+    block[0] = (uint8_t)(enc->used & 0xff);
+    block[1] = (uint8_t)(enc->used >> 8);
+
+    if (pad) {
+        memset(&block[2 + enc->used], 0, BLOCK_TOKEN_SPACE - enc->used);
+        enc->block += BLADE_FPGA_CBLOCK_SIZE;
+        enc->used = 0;
+        enc->raw  = 0;
+    }
+}
+
+static inline bool starts_run(const uint8_t *image, size_t len, size_t i)
+{
+    return (len - i) >= RUN_MIN && image[i] == image[i + 1] &&
+           image[i] == image[i + 2];
+}
+
+static inline size_t run_length(const uint8_t *image, size_t len, size_t i)
+{
+    const size_t max = min_sz(len - i, BLADE_FPGA_CBLOCK_MAX_RAW);
+    size_t n = 1;
+
+    while (n < max && image[i + n] == image[i]) {
+        n++;
+    }
+
+    return n;
+}
+
+int fpga_compress(const uint8_t *image, size_t len,
+                  uint8_t **out, size_t *out_len)
+{
+    struct encoder enc;
+    size_t i, n, max, space, budget;
+    uint8_t *tokens;
+
+    /* Every block other than the last is filled with tokens, which encode
+     * at least one byte of the bitstream per two bytes of tokens */
+    const size_t max_blocks = len / (BLOCK_TOKEN_SPACE / 2 - 1) + 1;
+
+    enc.buf = malloc(max_blocks * BLADE_FPGA_CBLOCK_SIZE);
+    if (enc.buf == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    enc.block = 0;
+    enc.used  = 0;
+    enc.raw   = 0;
+
+    i = 0;
+    while (i < len) {
+        tokens = &enc.buf[enc.block + 2 + enc.used];
+        space  = BLOCK_TOKEN_SPACE - enc.used;
+        budget = BLADE_FPGA_CBLOCK_MAX_RAW - enc.raw;
+
+        if (starts_run(image, len, i)) {
+            n = run_length(image, len, i);
+
+            if (space < 3 || budget < RUN_MIN) {
+                finish_block(&enc, true);
+                continue;
+            }
+
+            n = min_sz(min_sz(n, budget), RUN_MAX);
+
+            tokens[0] = (uint8_t)(0x80 | ((n - 1) >> 8));
+            tokens[1] = (uint8_t)((n - 1) & 0xff);
+            tokens[2] = image[i];
+            enc.used += 3;
+        } else {
+            if (space < 2 || budget == 0) {
+                finish_block(&enc, true);
+                continue;
+            }
+
+            /* Extend the literal up to the start of the next run */
+            max = min_sz(min_sz(LITERAL_MAX, space - 1),
+                         min_sz(budget, len - i));
+
+            for (n = 1; n < max && !starts_run(image, len, i + n); n++);
+
+            tokens[0] = (uint8_t)(n - 1);
+            memcpy(&tokens[1], &image[i], n);
+            enc.used += n + 1;
+        }
+
+        enc.raw += n;
+        i += n;
+    }
+
+    finish_block(&enc, false);
+
+    *out     = enc.buf;
+    *out_len = enc.block + 2 + enc.used;
+
+    return 0;
+}
@@ -0,0 +1,46 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_FPGA_COMPRESS_H_
+#define HELPERS_FPGA_COMPRESS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Compress an FPGA bitstream into the block format accepted by the FX3
+ * firmware when BLADE_FPGA_PROG_COMPRESSED is passed to
+ * BLADE_USB_CMD_BEGIN_PROG. See firmware_common/bladeRF.h for a description
+ * of the format.
+ *
+ * @param[in]   image       Bitstream
+ * @param[in]   len         Length of bitstream, in bytes
+ * @param[out]  out         On success, set to a heap-allocated buffer
+ *                          containing the compressed bitstream. The caller
+ *                          must free() this.
+ * @param[out]  out_len     On success, set to the length of `out`, in bytes
+ *
+ * @return 0 on success, BLADERF_ERR_MEM on allocation failure
+ */
+int fpga_compress(const uint8_t *image, size_t len,
+                  uint8_t **out, size_t *out_len);
+
+#endif
@@ -0,0 +1,227 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+
+#include "helpers/fw_loopback_bench.h"
+#include "helpers/wallclock.h"
+
+/* Time allowed for each buffer to be accepted or returned */
+#define BENCH_TIMEOUT_MS 3000
+
+/* Each buffer starts with its sequence number and the time at which it was
+ * submitted for transmission. The FX3 returns it unmodified. */
+struct bench_stamp {
+    uint64_t seq;
+    uint64_t sent_ns;
+};
+
+struct bench {
+    struct bladerf *dev;
+    const struct bladerf_fw_loopback_bench_config *config;
+    int16_t *buf;
+    int status;
+};
+
+static void *tx_task(void *arg)
+{
+    struct bench *b = arg;
+    struct bench_stamp stamp;
+    unsigned int i;
+
+    for (i = 0; i < b->config->count && b->status == 0; i++) {
+        stamp.seq     = i;
+        stamp.sent_ns = wallclock_get_current_nsec();
+        memcpy(b->buf, &stamp, sizeof(stamp));
+
+        b->status = bladerf_sync_tx(b->dev, b->buf, b->config->buffer_size,
+                                    NULL, BENCH_TIMEOUT_MS);
+    }
+
+    return NULL;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+    const uint64_t x = *(const uint64_t *)a;
+    const uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static double percentile_us(const uint64_t *sorted, size_t n, unsigned int p)
+{
+    return sorted[((n - 1) * p) / 100] / 1e3;
+}
+
+static int configure(struct bladerf *dev,
+                     const struct bladerf_fw_loopback_bench_config *config)
+{
+    int status;
+
+    status = bladerf_set_loopback(dev, BLADERF_LB_FIRMWARE);
+    if (status != 0) {
+        return status;
+    }
+
+    status = bladerf_sync_config(dev, BLADERF_TX_X1, BLADERF_FORMAT_SC16_Q11,
+                                 config->num_buffers, config->buffer_size,
+                                 config->num_transfers, BENCH_TIMEOUT_MS);
+    if (status != 0) {
+        return status;
+    }
+
+    status = bladerf_sync_config(dev, BLADERF_RX_X1, BLADERF_FORMAT_SC16_Q11,
+                                 config->num_buffers, config->buffer_size,
+                                 config->num_transfers, BENCH_TIMEOUT_MS);
+    if (status != 0) {
+        return status;
+    }
+
+    status = bladerf_enable_module(dev, BLADERF_CHANNEL_RX(0), true);
+    if (status != 0) {
+        return status;
+    }
+
+    return bladerf_enable_module(dev, BLADERF_CHANNEL_TX(0), true);
+}
+
+int fw_loopback_bench(struct bladerf *dev,
+                      const struct bladerf_fw_loopback_bench_config *config,
+                      struct bladerf_fw_loopback_bench_results *results)
+{
+    struct bench b;
+    struct bench_stamp stamp;
+    bladerf_loopback prev_lb;
+    pthread_t tx_thread;
+    bool tx_running = false;
+    uint64_t *latency = NULL;
+    int16_t *rx_buf   = NULL;
+    uint64_t start, now = 0;
+    unsigned int i;
+    int status, s;
+
+    if (config->count == 0 || config->buffer_size == 0 ||
+        (config->buffer_size % 1024) != 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    memset(&b, 0, sizeof(b));
+    memset(results, 0, sizeof(*results));
+
+    b.dev    = dev;
+    b.config = config;
+
+    status = bladerf_get_loopback(dev, &prev_lb);
+    if (status != 0) {
+        return status;
+    }
+
+    /* Both buffers hold SC16 Q11 samples: 2 x int16_t per sample */
+    b.buf   = calloc(config->buffer_size, 2 * sizeof(int16_t));
+    rx_buf  = calloc(config->buffer_size, 2 * sizeof(int16_t));
+    latency = calloc(config->count, sizeof(latency[0]));
+    if (b.buf == NULL || rx_buf == NULL || latency == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto out;
+    }
+
+    status = configure(dev, config);
+    if (status != 0) {
+        goto out;
+    }
+
+    start = wallclock_get_current_nsec();
+
+    if (pthread_create(&tx_thread, NULL, tx_task, &b) != 0) {
+        status = BLADERF_ERR_UNEXPECTED;
+        goto out;
+    }
+
+    tx_running = true;
+
+    for (i = 0; i < config->count; i++) {
+        status = bladerf_sync_rx(dev, rx_buf, config->buffer_size, NULL,
+                                 BENCH_TIMEOUT_MS);
+        if (status != 0) {
+            log_debug("Loopback RX failed after %u buffers: %s\n", i,
+                      bladerf_strerror(status));
+            goto out;
+        }
+
+        now = wallclock_get_current_nsec();
+        memcpy(&stamp, rx_buf, sizeof(stamp));
+
+        if (stamp.seq != i) {
+            results->errors++;
+        }
+
+        latency[i] = (now > stamp.sent_ns) ? (now - stamp.sent_ns) : 0;
+    }
+
+    results->bytes = (uint64_t)config->count * config->buffer_size *
+                     2 * sizeof(int16_t);
+
+    if (now > start) {
+        results->throughput = results->bytes / ((now - start) / 1e9);
+    }
+
+    qsort(latency, config->count, sizeof(latency[0]), cmp_u64);
+
+    results->latency_min = latency[0] / 1e3;
+    results->latency_p50 = percentile_us(latency, config->count, 50);
+    results->latency_p90 = percentile_us(latency, config->count, 90);
+    results->latency_p99 = percentile_us(latency, config->count, 99);
+    results->latency_max = latency[config->count - 1] / 1e3;
+
+out:
+    if (tx_running) {
+        pthread_join(tx_thread, NULL);
+        if (status == 0) {
+            status = b.status;
+        }
+    }
+
+    s = bladerf_enable_module(dev, BLADERF_CHANNEL_TX(0), false);
+    if (status == 0) {
+        status = s;
+    }
+
+    s = bladerf_enable_module(dev, BLADERF_CHANNEL_RX(0), false);
+    if (status == 0) {
+        status = s;
+    }
+
+    s = bladerf_set_loopback(dev, prev_lb);
+    if (status == 0) {
+        status = s;
+    }
+
+    free(latency);
+    free(rx_buf);
+    free(b.buf);
+
+    return status;
+}
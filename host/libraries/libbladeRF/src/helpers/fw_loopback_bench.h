@@ -0,0 +1,50 @@
+/**
+ * @file fw_loopback_bench.h
+ *
+ * @brief FX3 firmware loopback benchmark
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_FW_LOOPBACK_BENCH_H_
+#define HELPERS_FW_LOOPBACK_BENCH_H_
+
+#include <libbladeRF.h>
+
+/**
+ * Run a firmware loopback benchmark, as described by
+ * bladerf_fw_loopback_bench()
+ *
+ * The caller must not hold the device's lock.
+ *
+ * @param       dev         Device handle
+ * @param[in]   config      Benchmark configuration
+ * @param[out]  results     Updated with the benchmark results on success
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int fw_loopback_bench(struct bladerf *dev,
+                      const struct bladerf_fw_loopback_bench_config *config,
+                      struct bladerf_fw_loopback_bench_results *results);
+
+#endif
@@ -0,0 +1,615 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "thread.h"
+
+#include "helpers/group.h"
+#include "helpers/interleave.h"
+#include "helpers/thread_attrs.h"
+#include "helpers/timeout.h"
+
+struct group_block {
+    void *samples;
+    uint64_t num;                /* Block number, counted from the trigger */
+    bladerf_timestamp timestamp; /* Device timestamp of the first sample */
+};
+
+struct group_member {
+    struct bladerf_group *group;
+    unsigned int index;
+    struct bladerf *dev;
+    struct bladerf_trigger trigger;
+    bool armed;
+    bool enabled;
+    bool attrs_set;
+
+    pthread_t thread;
+    bool running;
+    bool done;  /* Reading thread has exited */
+    int status; /* Failure that ended the reading thread */
+
+    /* Ring of blocks read from the device and awaiting delivery */
+    struct group_block *blocks;
+    unsigned int head;
+    unsigned int count;
+
+    struct bladerf_group_stats stats;
+};
+
+struct bladerf_group {
+    struct bladerf_group_config config;
+    struct bladerf_stream_thread_attrs
+        thread_attrs[BLADERF_GROUP_MAX_DEVICES];
+    unsigned int num_members;
+    struct group_member members[BLADERF_GROUP_MAX_DEVICES];
+
+    unsigned int num_channels;
+    size_t block_bytes;
+    void *mem; /* Backs every member's blocks */
+
+    MUTEX lock;
+    pthread_cond_t block_ready; /* A member queued a block, or exited */
+    pthread_cond_t space_ready; /* Blocks were delivered or discarded */
+    bool started;
+    bool stop;
+};
+
+static bool is_meta_format(bladerf_format format)
+{
+    switch (format) {
+        case BLADERF_FORMAT_SC16_Q11_META:
+        case BLADERF_FORMAT_SC8_Q7_META:
+        case BLADERF_FORMAT_CF32_META:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+static inline struct group_block *member_block(struct group_member *m,
+                                               unsigned int i)
+{
+    return &m->blocks[(m->head + i) % m->group->config.queue_blocks];
+}
+
+/* Drop the oldest queued block. Called with the group lock held. */
+static inline void member_pop(struct group_member *m)
+{
+    m->head = (m->head + 1) % m->group->config.queue_blocks;
+    m->count--;
+}
+
+static void *group_reader(void *arg)
+{
+    struct group_member *m = arg;
+    struct bladerf_group *g = m->group;
+    const uint64_t n = g->config.block_samples;
+    struct thread_attrs_saved saved;
+    struct bladerf_metadata meta;
+    struct group_block *block;
+    bladerf_timestamp t0 = 0, now;
+    uint64_t num = 0, next;
+    bool have_t0 = false;
+    int status = 0;
+
+    if (m->attrs_set) {
+        thread_attrs_apply(&g->thread_attrs[m->index], &saved);
+    }
+
+    while (true) {
+        MUTEX_LOCK(&g->lock);
+        while (!g->stop && m->count == g->config.queue_blocks) {
+            pthread_cond_wait(&g->space_ready, &g->lock);
+        }
+
+        if (g->stop) {
+            MUTEX_UNLOCK(&g->lock);
+            break;
+        }
+
+        /* Only this thread fills the slot after the last queued block */
+        block = member_block(m, m->count);
+        MUTEX_UNLOCK(&g->lock);
+
+        /* The first block starts wherever the trigger started the stream.
+         * Every later block is read at its own timestamp. */
+        memset(&meta, 0, sizeof(meta));
+        if (have_t0) {
+            meta.timestamp = t0 + num * n;
+        } else {
+            meta.flags = BLADERF_META_FLAG_RX_NOW;
+        }
+
+        status = bladerf_sync_rx(m->dev, block->samples,
+                                 (unsigned int)(n * g->num_channels), &meta,
+                                 g->config.stream_timeout);
+
+        if (status == BLADERF_ERR_TIME_PAST && have_t0) {
+            /* Fell behind: resume at the first block yet to be received */
+            status = bladerf_get_timestamp(m->dev, BLADERF_RX, &now);
+            if (status != 0) {
+                break;
+            }
+
+            next = (now > t0) ? (now - t0) / n + 1 : num + 1;
+            if (next <= num) {
+                next = num + 1;
+            }
+
+            log_debug("%s: member %u skipping blocks %" PRIu64 "-%" PRIu64
+                      "\n", __FUNCTION__, m->index, num, next - 1);
+
+            MUTEX_LOCK(&g->lock);
+            m->stats.skipped += next - num;
+            MUTEX_UNLOCK(&g->lock);
+
+            num = next;
+            continue;
+        } else if (status == BLADERF_ERR_TIMEOUT && g->stop) {
+            status = 0;
+            break;
+        } else if (status != 0) {
+            break;
+        }
+
+        if (!have_t0) {
+            t0      = meta.timestamp;
+            have_t0 = true;
+        }
+
+        block->num       = num++;
+        block->timestamp = meta.timestamp;
+
+        MUTEX_LOCK(&g->lock);
+        m->stats.blocks++;
+        if (meta.status & BLADERF_META_STATUS_OVERRUN) {
+            m->stats.overruns++;
+        }
+        m->count++;
+        pthread_cond_broadcast(&g->block_ready);
+        MUTEX_UNLOCK(&g->lock);
+    }
+
+    if (status != 0) {
+        log_debug("%s: member %u failed: %s\n", __FUNCTION__, m->index,
+                  bladerf_strerror(status));
+    }
+
+    MUTEX_LOCK(&g->lock);
+    m->status = status;
+    m->done   = true;
+    pthread_cond_broadcast(&g->block_ready);
+    MUTEX_UNLOCK(&g->lock);
+
+    if (m->attrs_set) {
+        thread_attrs_restore(&saved);
+    }
+
+    return NULL;
+}
+
+int group_open(struct bladerf_group **group,
+               struct bladerf *const *devices,
+               unsigned int num_devices,
+               const struct bladerf_group_config *config)
+{
+    struct bladerf_group *g;
+    unsigned int i, j;
+
+    *group = NULL;
+
+    if (num_devices == 0 || num_devices > BLADERF_GROUP_MAX_DEVICES ||
+        config->master >= num_devices || config->block_samples == 0 ||
+        !is_meta_format(config->format) ||
+        (config->layout != BLADERF_RX_X1 && config->layout != BLADERF_RX_X2)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    g = calloc(1, sizeof(*g));
+    if (g == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    g->config      = *config;
+    g->num_members = num_devices;
+
+    if (g->config.queue_blocks == 0) {
+        g->config.queue_blocks = BLADERF_GROUP_QUEUE_DEFAULT;
+    }
+
+    if (config->thread_attrs != NULL) {
+        memcpy(g->thread_attrs, config->thread_attrs,
+               num_devices * sizeof(g->thread_attrs[0]));
+        g->config.thread_attrs = g->thread_attrs;
+    }
+
+    g->num_channels =
+        (unsigned int)_interleave_calc_num_channels(config->layout);
+    g->block_bytes  = (size_t)config->block_samples * g->num_channels *
+                     _interleave_calc_bytes_per_sample(config->format);
+
+    g->mem = malloc((size_t)num_devices * g->config.queue_blocks *
+                        (g->block_bytes + sizeof(struct group_block)));
+    if (g->mem == NULL) {
+        free(g);
+        return BLADERF_ERR_MEM;
+    }
+
+    for (i = 0; i < num_devices; i++) {
+        struct group_member *m = &g->members[i];
+        uint8_t *samples;
+
+        if (devices[i] == NULL) {
+            free(g->mem);
+            free(g);
+            return BLADERF_ERR_INVAL;
+        }
+
+        m->group  = g;
+        m->index  = i;
+        m->dev    = devices[i];
+        m->blocks = (struct group_block *)g->mem + i * g->config.queue_blocks;
+
+        samples = (uint8_t *)g->mem + (size_t)num_devices *
+                                          g->config.queue_blocks *
+                                          sizeof(struct group_block);
+        samples += (size_t)i * g->config.queue_blocks * g->block_bytes;
+
+        for (j = 0; j < g->config.queue_blocks; j++) {
+            m->blocks[j].samples = samples + (size_t)j * g->block_bytes;
+        }
+    }
+
+    MUTEX_INIT(&g->lock);
+    timeout_cond_init(&g->block_ready);
+    pthread_cond_init(&g->space_ready, NULL);
+
+    *group = g;
+    return 0;
+}
+
+/* Undo whatever group_start() did to each member. The reading threads are
+ * stopped after the triggers are disarmed, as a stream still gated by an
+ * armed trigger would only return at its timeout. */
+static int group_teardown(struct bladerf_group *g)
+{
+    const bladerf_channel ch0 = BLADERF_CHANNEL_RX(0);
+    unsigned int i;
+    int status = 0, s;
+
+    MUTEX_LOCK(&g->lock);
+    g->stop = true;
+    pthread_cond_broadcast(&g->space_ready);
+    MUTEX_UNLOCK(&g->lock);
+
+    for (i = 0; i < g->num_members; i++) {
+        struct group_member *m = &g->members[i];
+
+        if (m->armed) {
+            m->trigger.role = BLADERF_TRIGGER_ROLE_DISABLED;
+            s = bladerf_trigger_arm(m->dev, &m->trigger, false, 0, 0);
+            if (s != 0 && status == 0) {
+                status = s;
+            }
+            m->armed = false;
+        }
+    }
+
+    for (i = 0; i < g->num_members; i++) {
+        struct group_member *m = &g->members[i];
+
+        if (m->running) {
+            pthread_join(m->thread, NULL);
+            m->running = false;
+        }
+    }
+
+    for (i = 0; i < g->num_members; i++) {
+        struct group_member *m = &g->members[i];
+
+        if (m->enabled) {
+            s = bladerf_enable_module(m->dev, ch0, false);
+            if (g->num_channels == 2) {
+                int s2 = bladerf_enable_module(m->dev, BLADERF_CHANNEL_RX(1),
+                                               false);
+                if (s == 0) {
+                    s = s2;
+                }
+            }
+            if (s != 0 && status == 0) {
+                status = s;
+            }
+            m->enabled = false;
+        }
+
+        if (m->attrs_set) {
+            bladerf_set_stream_thread_attrs(m->dev, BLADERF_RX, NULL);
+            m->attrs_set = false;
+        }
+    }
+
+    g->started = false;
+    return status;
+}
+
+static int arm_member(struct group_member *m)
+{
+    int status = bladerf_trigger_arm(m->dev, &m->trigger, true, 0, 0);
+
+    if (status == 0) {
+        m->armed = true;
+    }
+
+    return status;
+}
+
+int group_start(struct bladerf_group *g)
+{
+    const struct bladerf_group_config *c = &g->config;
+    unsigned int i;
+    int status = 0;
+
+    if (g->started) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    g->stop    = false;
+    g->started = true;
+
+    for (i = 0; i < g->num_members; i++) {
+        struct group_member *m = &g->members[i];
+
+        m->head   = 0;
+        m->count  = 0;
+        m->done   = false;
+        m->status = 0;
+        memset(&m->stats, 0, sizeof(m->stats));
+    }
+
+    for (i = 0; i < g->num_members; i++) {
+        struct group_member *m = &g->members[i];
+
+        status = bladerf_trigger_init(m->dev, BLADERF_CHANNEL_RX(0),
+                                      c->trigger, &m->trigger);
+        if (status != 0) {
+            goto error;
+        }
+
+        m->trigger.role = (i == c->master) ? BLADERF_TRIGGER_ROLE_MASTER
+                                           : BLADERF_TRIGGER_ROLE_SLAVE;
+    }
+
+    /* Arm the slaves before the master, so none can miss the trigger */
+
+    for (i = 0; i < g->num_members; i++) {
+        if (i != c->master) {
+            status = arm_member(&g->members[i]);
+            if (status != 0) {
+                goto error;
+            }
+        }
+    }
+
+    i      = c->master;
+    status = arm_member(&g->members[i]);
+    if (status != 0) {
+        goto error;
+    }
+
+    /* Start every stream. Samples stay gated until the trigger fires. */
+    for (i = 0; i < g->num_members; i++) {
+        struct group_member *m = &g->members[i];
+
+        if (c->thread_attrs != NULL) {
+            status = bladerf_set_stream_thread_attrs(m->dev, BLADERF_RX,
+                                                     &c->thread_attrs[i]);
+            if (status != 0) {
+                goto error;
+            }
+            m->attrs_set = true;
+        }
+
+        status = bladerf_sync_config(m->dev, c->layout, c->format,
+                                     c->num_buffers, c->buffer_size,
+                                     c->num_transfers, c->stream_timeout);
+        if (status != 0) {
+            goto error;
+        }
+
+        m->enabled = true;
+        status = bladerf_enable_module(m->dev, BLADERF_CHANNEL_RX(0), true);
+        if (status == 0 && g->num_channels == 2) {
+            status = bladerf_enable_module(m->dev, BLADERF_CHANNEL_RX(1), true);
+        }
+        if (status != 0) {
+            goto error;
+        }
+
+        status = pthread_create(&m->thread, NULL, group_reader, m);
+        if (status != 0) {
+            status = BLADERF_ERR_UNEXPECTED;
+            goto error;
+        }
+        m->running = true;
+    }
+
+    status = bladerf_trigger_fire(g->members[c->master].dev,
+                                  &g->members[c->master].trigger);
+    if (status != 0) {
+        goto error;
+    }
+
+    return 0;
+
+error:
+    log_debug("%s: failed to start member %u: %s\n", __FUNCTION__, i,
+              bladerf_strerror(status));
+    group_teardown(g);
+    return status;
+}
+
+int group_rx(struct bladerf_group *g,
+             void *const *samples,
+             uint64_t *block,
+             bladerf_timestamp *timestamps,
+             unsigned int timeout_ms)
+{
+    struct timespec deadline;
+    uint64_t newest;
+    unsigned int i;
+    bool aligned;
+    int status = 0;
+
+    if (timeout_ms != 0 && populate_abs_timeout(&deadline, timeout_ms) != 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    MUTEX_LOCK(&g->lock);
+
+    if (!g->started) {
+        MUTEX_UNLOCK(&g->lock);
+        return BLADERF_ERR_INVAL;
+    }
+
+    while (true) {
+        /* Wait for every member to have a block queued */
+        for (i = 0; i < g->num_members && status == 0; i++) {
+            struct group_member *m = &g->members[i];
+
+            while (m->count == 0 && status == 0) {
+                if (m->done) {
+                    status = (m->status != 0) ? m->status : BLADERF_ERR_IO;
+                } else if (timeout_ms == 0) {
+                    pthread_cond_wait(&g->block_ready, &g->lock);
+                } else if (pthread_cond_timedwait(&g->block_ready, &g->lock,
+                                                  &deadline) == ETIMEDOUT) {
+                    status = BLADERF_ERR_TIMEOUT;
+                }
+            }
+        }
+
+        if (status != 0) {
+            break;
+        }
+
+        /* Discard blocks that a member skipped, up to the newest block at
+         * the front of any member's queue */
+        newest = 0;
+        for (i = 0; i < g->num_members; i++) {
+            const uint64_t num = member_block(&g->members[i], 0)->num;
+            if (num > newest) {
+                newest = num;
+            }
+        }
+
+        aligned = true;
+        for (i = 0; i < g->num_members; i++) {
+            struct group_member *m = &g->members[i];
+
+            while (m->count > 0 && member_block(m, 0)->num < newest) {
+                member_pop(m);
+                m->stats.discarded++;
+                pthread_cond_broadcast(&g->space_ready);
+            }
+
+            if (m->count == 0) {
+                aligned = false;
+            }
+        }
+
+        if (aligned) {
+            break;
+        }
+    }
+
+    MUTEX_UNLOCK(&g->lock);
+
+    if (status != 0) {
+        return status;
+    }
+
+    /* The readers never touch queued blocks, so these can be copied
+     * without holding the lock */
+    for (i = 0; i < g->num_members; i++) {
+        struct group_block *b = member_block(&g->members[i], 0);
+
+        memcpy(samples[i], b->samples, g->block_bytes);
+        if (timestamps != NULL) {
+            timestamps[i] = b->timestamp;
+        }
+    }
+
+    if (block != NULL) {
+        *block = newest;
+    }
+
+    MUTEX_LOCK(&g->lock);
+    for (i = 0; i < g->num_members; i++) {
+        member_pop(&g->members[i]);
+    }
+    pthread_cond_broadcast(&g->space_ready);
+    MUTEX_UNLOCK(&g->lock);
+
+    return 0;
+}
+
+int group_get_stats(struct bladerf_group *g,
+                    unsigned int member,
+                    struct bladerf_group_stats *stats)
+{
+    if (member >= g->num_members) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&g->lock);
+    *stats = g->members[member].stats;
+    MUTEX_UNLOCK(&g->lock);
+
+    return 0;
+}
+
+int group_stop(struct bladerf_group *g)
+{
+    if (!g->started) {
+        return 0;
+    }
+
+    return group_teardown(g);
+}
+
+void group_close(struct bladerf_group *g)
+{
+    group_stop(g);
+
+    pthread_cond_destroy(&g->space_ready);
+    pthread_cond_destroy(&g->block_ready);
+    MUTEX_DESTROY(&g->lock);
+    free(g->mem);
+    free(g);
+}
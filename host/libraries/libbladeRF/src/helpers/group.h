@@ -0,0 +1,106 @@
+/**
+ * @file group.h
+ *
+ * @brief Synchronized multi-device RX groups
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_GROUP_H_
+#define HELPERS_GROUP_H_
+
+#include <libbladeRF.h>
+
+/**
+ * Create a device group, as described by bladerf_group_open()
+ *
+ * @param[out]  group       Updated with the group handle on success
+ * @param[in]   devices     Member device handles
+ * @param[in]   num_devices Number of members
+ * @param[in]   config      Group configuration
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int group_open(struct bladerf_group **group,
+               struct bladerf *const *devices,
+               unsigned int num_devices,
+               const struct bladerf_group_config *config);
+
+/**
+ * Arm triggers, start streams and reading threads, and fire the trigger
+ *
+ * The caller must not hold any member's lock.
+ *
+ * @param       group   Group handle
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int group_start(struct bladerf_group *group);
+
+/**
+ * Receive an aligned block from every member
+ *
+ * @param       group       Group handle
+ * @param[out]  samples     One buffer per member
+ * @param[out]  block       Block number. May be NULL.
+ * @param[out]  timestamps  One timestamp per member. May be NULL.
+ * @param[in]   timeout_ms  Timeout, or 0 to wait indefinitely
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int group_rx(struct bladerf_group *group,
+             void *const *samples,
+             uint64_t *block,
+             bladerf_timestamp *timestamps,
+             unsigned int timeout_ms);
+
+/**
+ * Get a member's statistics
+ *
+ * @param       group   Group handle
+ * @param[in]   member  Member index
+ * @param[out]  stats   Statistics
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if `member` is out of range
+ */
+int group_get_stats(struct bladerf_group *group,
+                    unsigned int member,
+                    struct bladerf_group_stats *stats);
+
+/**
+ * Disarm triggers, then stop the reading threads and streams
+ *
+ * @param       group   Group handle
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int group_stop(struct bladerf_group *group);
+
+/**
+ * Stop the group if needed, and free it
+ *
+ * @param       group   Group handle
+ */
+void group_close(struct bladerf_group *group);
+
+#endif
@@ -19,11 +19,27 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include <libbladeRF.h>
 
 #include "helpers/interleave.h"
+#include "simd.h"
+
+/* Number of sample pairs handled per base case of the in-place algorithms,
+ * using a stack scratch buffer */
+#define INTERLEAVE_SCRATCH_PAIRS 1024
+
+typedef void (*deinterleave2_fn)(uint32_t const *src,
+                                 uint32_t *dst0,
+                                 uint32_t *dst1,
+                                 size_t n);
+
+typedef void (*interleave2_fn)(uint32_t const *src0,
+                               uint32_t const *src1,
+                               uint32_t *dst,
+                               size_t n);
 
 size_t _interleave_calc_num_channels(bladerf_channel_layout layout)
 {
@@ -46,6 +62,12 @@ size_t _interleave_calc_bytes_per_sample(bladerf_format format)
         case BLADERF_FORMAT_SC16_Q11_META:
         case BLADERF_FORMAT_PACKET_META:
             return 4;
+        case BLADERF_FORMAT_CF32:
+        case BLADERF_FORMAT_CF32_META:
+            return 2 * sizeof(float);
+        case BLADERF_FORMAT_SC8_Q7:
+        case BLADERF_FORMAT_SC8_Q7_META:
+            return 2;
     }
 
     return 0;
@@ -56,66 +78,402 @@ size_t _interleave_calc_metadata_bytes(bladerf_format format)
     switch (format) {
         case BLADERF_FORMAT_SC16_Q11_META:
         case BLADERF_FORMAT_PACKET_META:
+        case BLADERF_FORMAT_CF32_META:
+        case BLADERF_FORMAT_SC8_Q7_META:
             return 0x10;
         case BLADERF_FORMAT_SC16_Q11:
+        case BLADERF_FORMAT_CF32:
+        case BLADERF_FORMAT_SC8_Q7:
             return 0;
     }
 
     return 0;
 }
 
+/******************************************************************************
+ * 2-channel kernels, operating on 32-bit (SC16Q11) samples
+ ******************************************************************************/
+
+static void deinterleave2_scalar(uint32_t const *src,
+                                 uint32_t *dst0,
+                                 uint32_t *dst1,
+                                 size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        dst0[i] = src[2 * i];
+        dst1[i] = src[2 * i + 1];
+    }
+}
+
+static void interleave2_scalar(uint32_t const *src0,
+                               uint32_t const *src1,
+                               uint32_t *dst,
+                               size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        dst[2 * i]     = src0[i];
+        dst[2 * i + 1] = src1[i];
+    }
+}
+
+#ifdef SIMD_HAVE_SSE2
+static void deinterleave2_sse2(uint32_t const *src,
+                               uint32_t *dst0,
+                               uint32_t *dst1,
+                               size_t n)
+{
+    size_t i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        /* a0 b0 a1 b1, a2 b2 a3 b3 -> a0 a1 b0 b1, a2 a3 b2 b3 */
+        __m128i x = _mm_loadu_si128((__m128i const *)(src + 2 * i));
+        __m128i y = _mm_loadu_si128((__m128i const *)(src + 2 * i + 4));
+        x = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 1, 2, 0));
+        y = _mm_shuffle_epi32(y, _MM_SHUFFLE(3, 1, 2, 0));
+
+        _mm_storeu_si128((__m128i *)(dst0 + i), _mm_unpacklo_epi64(x, y));
+        _mm_storeu_si128((__m128i *)(dst1 + i), _mm_unpackhi_epi64(x, y));
+    }
+
+    deinterleave2_scalar(src + 2 * i, dst0 + i, dst1 + i, n - i);
+}
+
+static void interleave2_sse2(uint32_t const *src0,
+                             uint32_t const *src1,
+                             uint32_t *dst,
+                             size_t n)
+{
+    size_t i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128i a = _mm_loadu_si128((__m128i const *)(src0 + i));
+        __m128i b = _mm_loadu_si128((__m128i const *)(src1 + i));
+
+        _mm_storeu_si128((__m128i *)(dst + 2 * i), _mm_unpacklo_epi32(a, b));
+        _mm_storeu_si128((__m128i *)(dst + 2 * i + 4),
+                         _mm_unpackhi_epi32(a, b));
+    }
+
+    interleave2_scalar(src0 + i, src1 + i, dst + 2 * i, n - i);
+}
+#endif
+
+#ifdef SIMD_HAVE_AVX2
+SIMD_TARGET_AVX2
+static void deinterleave2_avx2(uint32_t const *src,
+                               uint32_t *dst0,
+                               uint32_t *dst1,
+                               size_t n)
+{
+    const __m256i idx = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    size_t i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        /* Within each register: a0..a3 b0..b3 */
+        __m256i x = _mm256_loadu_si256((__m256i const *)(src + 2 * i));
+        __m256i y = _mm256_loadu_si256((__m256i const *)(src + 2 * i + 8));
+        x = _mm256_permutevar8x32_epi32(x, idx);
+        y = _mm256_permutevar8x32_epi32(y, idx);
+
+        _mm256_storeu_si256((__m256i *)(dst0 + i),
+                            _mm256_permute2x128_si256(x, y, 0x20));
+        _mm256_storeu_si256((__m256i *)(dst1 + i),
+                            _mm256_permute2x128_si256(x, y, 0x31));
+    }
+
+    deinterleave2_sse2(src + 2 * i, dst0 + i, dst1 + i, n - i);
+}
+
+SIMD_TARGET_AVX2
+static void interleave2_avx2(uint32_t const *src0,
+                             uint32_t const *src1,
+                             uint32_t *dst,
+                             size_t n)
+{
+    size_t i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m256i a  = _mm256_loadu_si256((__m256i const *)(src0 + i));
+        __m256i b  = _mm256_loadu_si256((__m256i const *)(src1 + i));
+        __m256i lo = _mm256_unpacklo_epi32(a, b);
+        __m256i hi = _mm256_unpackhi_epi32(a, b);
+
+        _mm256_storeu_si256((__m256i *)(dst + 2 * i),
+                            _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i *)(dst + 2 * i + 8),
+                            _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+
+    interleave2_sse2(src0 + i, src1 + i, dst + 2 * i, n - i);
+}
+#endif
+
+#ifdef SIMD_HAVE_NEON
+static void deinterleave2_neon(uint32_t const *src,
+                               uint32_t *dst0,
+                               uint32_t *dst1,
+                               size_t n)
+{
+    size_t i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        uint32x4x2_t v = vld2q_u32(src + 2 * i);
+        vst1q_u32(dst0 + i, v.val[0]);
+        vst1q_u32(dst1 + i, v.val[1]);
+    }
+
+    deinterleave2_scalar(src + 2 * i, dst0 + i, dst1 + i, n - i);
+}
+
+static void interleave2_neon(uint32_t const *src0,
+                             uint32_t const *src1,
+                             uint32_t *dst,
+                             size_t n)
+{
+    size_t i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        uint32x4x2_t v;
+        v.val[0] = vld1q_u32(src0 + i);
+        v.val[1] = vld1q_u32(src1 + i);
+        vst2q_u32(dst + 2 * i, v);
+    }
+
+    interleave2_scalar(src0 + i, src1 + i, dst + 2 * i, n - i);
+}
+#endif
+
+static deinterleave2_fn deinterleave2_impl = NULL;
+static interleave2_fn interleave2_impl     = NULL;
+
+/* Select the best available kernels for this CPU. Concurrent first calls
+ * may race to perform this, but will arrive at the same result. */
+static void select_kernels(void)
+{
+    deinterleave2_fn deint = deinterleave2_scalar;
+    interleave2_fn inter   = interleave2_scalar;
+
+#if defined(SIMD_HAVE_NEON)
+    deint = deinterleave2_neon;
+    inter = interleave2_neon;
+#elif defined(SIMD_HAVE_SSE2)
+    deint = deinterleave2_sse2;
+    inter = interleave2_sse2;
+#   ifdef SIMD_HAVE_AVX2
+    if (simd_have_avx2()) {
+        deint = deinterleave2_avx2;
+        inter = interleave2_avx2;
+    }
+#   endif
+#endif
+
+    deinterleave2_impl = deint;
+    interleave2_impl   = inter;
+}
+
+void _interleave_deinterleave2(void const *src,
+                               void *dst0,
+                               void *dst1,
+                               size_t samples_per_ch)
+{
+    if (deinterleave2_impl == NULL) {
+        select_kernels();
+    }
+
+    deinterleave2_impl(src, dst0, dst1, samples_per_ch);
+}
+
+void _interleave_interleave2(void const *src0,
+                             void const *src1,
+                             void *dst,
+                             size_t samples_per_ch)
+{
+    if (interleave2_impl == NULL) {
+        select_kernels();
+    }
+
+    interleave2_impl(src0, src1, dst, samples_per_ch);
+}
+
+/******************************************************************************
+ * In-place buffer (de)interleaving
+ *
+ * These operate by recursively splitting the buffer in half until each piece
+ * fits in a small stack scratch buffer, and then swapping the middle two
+ * quarters to join adjacent pieces. No heap allocation is required.
+ ******************************************************************************/
+
+static inline void reverse32(uint32_t *p, size_t n)
+{
+    size_t i, j;
+
+    for (i = 0, j = n; i + 1 < j; i++, j--) {
+        uint32_t tmp = p[i];
+        p[i]         = p[j - 1];
+        p[j - 1]     = tmp;
+    }
+}
+
+/* Rotate the n elements at p left by k */
+static void rotate32(uint32_t *p, size_t n, size_t k)
+{
+    if (k == 0 || k == n) {
+        return;
+    }
+
+    if (2 * k == n) {
+        uint32_t tmp[2 * INTERLEAVE_SCRATCH_PAIRS];
+        size_t off, len;
+
+        for (off = 0; off < k; off += len) {
+            len = k - off;
+            if (len > 2 * INTERLEAVE_SCRATCH_PAIRS) {
+                len = 2 * INTERLEAVE_SCRATCH_PAIRS;
+            }
+
+            memcpy(tmp, p + off, len * sizeof(uint32_t));
+            memcpy(p + off, p + k + off, len * sizeof(uint32_t));
+            memcpy(p + k + off, tmp, len * sizeof(uint32_t));
+        }
+    } else {
+        reverse32(p, k);
+        reverse32(p + k, n - k);
+        reverse32(p, n);
+    }
+}
+
+/* [a0 b0 a1 b1 ...] (n pairs) -> [a0 a1 ... b0 b1 ...] */
+static void deinterleave2_inplace(uint32_t *buf, size_t n)
+{
+    if (n <= INTERLEAVE_SCRATCH_PAIRS) {
+        uint32_t tmp[2 * INTERLEAVE_SCRATCH_PAIRS];
+        _interleave_deinterleave2(buf, tmp, tmp + n, n);
+        memcpy(buf, tmp, 2 * n * sizeof(uint32_t));
+    } else {
+        const size_t n0 = (n + 1) / 2;
+        const size_t n1 = n - n0;
+
+        /* -> [A0 B0 A1 B1] */
+        deinterleave2_inplace(buf, n0);
+        deinterleave2_inplace(buf + 2 * n0, n1);
+
+        /* -> [A0 A1 B0 B1] */
+        rotate32(buf + n0, n0 + n1, n0);
+    }
+}
+
+/* [a0 a1 ... b0 b1 ...] (n pairs) -> [a0 b0 a1 b1 ...] */
+static void interleave2_inplace(uint32_t *buf, size_t n)
+{
+    if (n <= INTERLEAVE_SCRATCH_PAIRS) {
+        uint32_t tmp[2 * INTERLEAVE_SCRATCH_PAIRS];
+        _interleave_interleave2(buf, buf + n, tmp, n);
+        memcpy(buf, tmp, 2 * n * sizeof(uint32_t));
+    } else {
+        const size_t n0 = (n + 1) / 2;
+        const size_t n1 = n - n0;
+
+        /* [A0 A1 B0 B1] -> [A0 B0 A1 B1] */
+        rotate32(buf + n0, n1 + n0, n1);
+
+        interleave2_inplace(buf, n0);
+        interleave2_inplace(buf + 2 * n0, n1);
+    }
+}
+
+/* Generic, out-of-place forms for any sample size and channel count */
+static int interleave_generic(uint8_t *samples,
+                              size_t buffer_size,
+                              size_t num_channels,
+                              size_t samp_size,
+                              size_t samps_per_ch)
+{
+    uint8_t *buf = malloc(samp_size * buffer_size);
+    size_t srcidx, dstidx, samp, ch;
+
+    if (NULL == buf) {
+        return BLADERF_ERR_MEM;
+    }
+
+    for (ch = 0; ch < num_channels; ++ch) {
+        srcidx = samps_per_ch * ch;
+        for (samp = 0; samp < samps_per_ch; ++samp) {
+            dstidx = (samp * num_channels) + ch;
+            memcpy(buf + (dstidx * samp_size),
+                   samples + ((srcidx + samp) * samp_size), samp_size);
+        }
+    }
+
+    memcpy(samples, buf, samps_per_ch * num_channels * samp_size);
+    free(buf);
+
+    return 0;
+}
+
+static int deinterleave_generic(uint8_t *samples,
+                                size_t buffer_size,
+                                size_t num_channels,
+                                size_t samp_size,
+                                size_t samps_per_ch)
+{
+    uint8_t *buf = malloc(samp_size * buffer_size);
+    size_t srcidx, dstidx, samp, ch;
+
+    if (NULL == buf) {
+        return BLADERF_ERR_MEM;
+    }
+
+    for (samp = 0; samp < samps_per_ch; ++samp) {
+        srcidx = num_channels * samp;
+        for (ch = 0; ch < num_channels; ++ch) {
+            dstidx = (samps_per_ch * ch) + samp;
+            memcpy(buf + (dstidx * samp_size),
+                   samples + ((srcidx + ch) * samp_size), samp_size);
+        }
+    }
+
+    memcpy(samples, buf, samps_per_ch * num_channels * samp_size);
+    free(buf);
+
+    return 0;
+}
+
 int _interleave_interleave_buf(bladerf_channel_layout layout,
                                bladerf_format format,
                                unsigned int buffer_size,
                                void *samples)
 {
-    void *buf;
-    uint8_t *srcptr, *dstptr;
+    uint8_t *ptr;
     size_t num_channels = _interleave_calc_num_channels(layout);
     size_t samp_size, meta_size, samps_per_ch;
-    size_t srcidx, dstidx, samp, ch;
 
     // Easy:
     if (num_channels < 2) {
         return 0;
     }
 
-    // Placeholder for an actually efficient algorithm
     samp_size    = _interleave_calc_bytes_per_sample(format);
     meta_size    = _interleave_calc_metadata_bytes(format);
     samps_per_ch = buffer_size / num_channels;
-    buf          = malloc(samp_size * buffer_size);
-    srcptr       = samples;
-    dstptr       = buf;
-
-    if (NULL == buf) {
-        return BLADERF_ERR_MEM;
-    }
+    ptr          = samples;
 
-    // Copy metadata if applicable
+    // Skip metadata if applicable
     if (meta_size > 0) {
-        memcpy(dstptr, srcptr, meta_size);
-        srcptr += meta_size;
-        dstptr += meta_size;
+        ptr += meta_size;
         samps_per_ch -= (meta_size / samp_size / num_channels);
     }
 
-    // Iterate...
-    for (ch = 0; ch < num_channels; ++ch) {
-        srcidx = samps_per_ch * ch;
-        for (samp = 0; samp < samps_per_ch; ++samp) {
-            dstidx = (samp * num_channels) + ch;
-            memcpy(dstptr + (dstidx * samp_size),
-                   srcptr + ((srcidx + samp) * samp_size),
-                   samp_size);
-        }
+    // Fast path for 2 channels of SC16 Q11
+    if (samp_size != sizeof(uint32_t) || num_channels != 2) {
+        return interleave_generic(ptr, buffer_size, num_channels, samp_size,
+                                  samps_per_ch);
     }
 
-    // Copy back...
-    memcpy(samples, buf, buffer_size * samp_size);
-
-    // Done
-    free(buf);
+    interleave2_inplace((uint32_t *)ptr, samps_per_ch);
 
     return 0;
 }
@@ -125,52 +483,33 @@ int _interleave_deinterleave_buf(bladerf_channel_layout layout,
                                  unsigned int buffer_size,
                                  void *samples)
 {
-    void *buf;
-    uint8_t *srcptr, *dstptr;
+    uint8_t *ptr;
     size_t num_channels = _interleave_calc_num_channels(layout);
     size_t samp_size, meta_size, samps_per_ch;
-    size_t srcidx, dstidx, samp, ch;
 
     // Easy:
     if (num_channels < 2) {
         return 0;
     }
 
-    // Placeholder for an actually efficient algorithm
     samp_size    = _interleave_calc_bytes_per_sample(format);
     meta_size    = _interleave_calc_metadata_bytes(format);
     samps_per_ch = buffer_size / num_channels;
-    buf          = malloc(samp_size * buffer_size);
-    srcptr       = samples;
-    dstptr       = buf;
-
-    if (NULL == buf) {
-        return BLADERF_ERR_MEM;
-    }
+    ptr          = samples;
 
-    // Copy metadata if applicable
+    // Skip metadata if applicable
     if (meta_size > 0) {
-        memcpy(dstptr, srcptr, meta_size);
-        srcptr += meta_size;
-        dstptr += meta_size;
+        ptr += meta_size;
         samps_per_ch -= (meta_size / samp_size / num_channels);
     }
 
-    // Iterate...
-    for (samp = 0; samp < samps_per_ch; ++samp) {
-        srcidx = num_channels * samp;
-        for (ch = 0; ch < num_channels; ++ch) {
-            dstidx = (samps_per_ch * ch) + samp;
-            memcpy(dstptr + (dstidx * samp_size),
-                   srcptr + ((srcidx + ch) * samp_size), samp_size);
-        }
+    // Fast path for 2 channels of SC16 Q11
+    if (samp_size != sizeof(uint32_t) || num_channels != 2) {
+        return deinterleave_generic(ptr, buffer_size, num_channels,
+                                    samp_size, samps_per_ch);
     }
 
-    // Copy back...
-    memcpy(samples, buf, buffer_size * samp_size);
-
-    // Done
-    free(buf);
+    deinterleave2_inplace((uint32_t *)ptr, samps_per_ch);
 
     return 0;
 }
@@ -31,6 +31,34 @@ size_t _interleave_calc_bytes_per_sample(bladerf_format format);
 size_t _interleave_calc_metadata_bytes(bladerf_format format);
 size_t _interleave_calc_num_channels(bladerf_channel_layout layout);
 
+/**
+ * Deinterleave 2-channel SC16Q11 samples, writing each channel's samples to
+ * a separate destination. The destinations must not overlap the source.
+ *
+ * @param[in]   src             Interleaved samples (2 * samples_per_ch)
+ * @param[out]  dst0            Channel 0 samples
+ * @param[out]  dst1            Channel 1 samples
+ * @param[in]   samples_per_ch  Number of samples per channel
+ */
+void _interleave_deinterleave2(void const *src,
+                               void *dst0,
+                               void *dst1,
+                               size_t samples_per_ch);
+
+/**
+ * Interleave two channels of SC16Q11 samples into a single destination, which
+ * must not overlap either source.
+ *
+ * @param[in]   src0            Channel 0 samples
+ * @param[in]   src1            Channel 1 samples
+ * @param[out]  dst             Interleaved samples (2 * samples_per_ch)
+ * @param[in]   samples_per_ch  Number of samples per channel
+ */
+void _interleave_interleave2(void const *src0,
+                             void const *src1,
+                             void *dst,
+                             size_t samples_per_ch);
+
 int _interleave_interleave_buf(bladerf_channel_layout layout,
                                bladerf_format format,
                                unsigned int buffer_size,
@@ -0,0 +1,174 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "host_config.h"
+
+#if BLADERF_OS_WINDOWS
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if BLADERF_OS_LINUX
+#include <sys/eventfd.h>
+#endif
+
+#include "log.h"
+
+#include "helpers/poll_event.h"
+
+#if BLADERF_OS_WINDOWS
+
+int poll_event_init(struct poll_event *e)
+{
+    memset(e, 0, sizeof(*e));
+
+    e->handle = CreateEvent(NULL, TRUE, FALSE, NULL);
+    if (e->handle == NULL) {
+        log_debug("Failed to create event: %lu\n",
+                  (unsigned long)GetLastError());
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    e->valid = true;
+    return 0;
+}
+
+void poll_event_deinit(struct poll_event *e)
+{
+    if (e->valid) {
+        CloseHandle(e->handle);
+        e->valid = false;
+    }
+}
+
+void poll_event_update(struct poll_event *e, bool set)
+{
+    if (!e->valid || e->set == set) {
+        return;
+    }
+
+    if (set) {
+        SetEvent(e->handle);
+    } else {
+        ResetEvent(e->handle);
+    }
+
+    e->set = set;
+}
+
+bladerf_poll_handle poll_event_handle(const struct poll_event *e)
+{
+    return e->handle;
+}
+
+#else
+
+int poll_event_init(struct poll_event *e)
+{
+    memset(e, 0, sizeof(*e));
+
+#if BLADERF_OS_LINUX
+    e->fds[0] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (e->fds[0] < 0) {
+        log_debug("Failed to create eventfd: %s\n", strerror(errno));
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    e->fds[1] = e->fds[0];
+#else
+    {
+        int i;
+
+        if (pipe(e->fds) != 0) {
+            log_debug("Failed to create pipe: %s\n", strerror(errno));
+            return BLADERF_ERR_UNEXPECTED;
+        }
+
+        for (i = 0; i < 2; i++) {
+            fcntl(e->fds[i], F_SETFL, fcntl(e->fds[i], F_GETFL) | O_NONBLOCK);
+            fcntl(e->fds[i], F_SETFD, FD_CLOEXEC);
+        }
+    }
+#endif
+
+    e->valid = true;
+    return 0;
+}
+
+void poll_event_deinit(struct poll_event *e)
+{
+    if (!e->valid) {
+        return;
+    }
+
+    close(e->fds[0]);
+    if (e->fds[1] != e->fds[0]) {
+        close(e->fds[1]);
+    }
+
+    e->valid = false;
+}
+
+void poll_event_update(struct poll_event *e, bool set)
+{
+    ssize_t n;
+
+    if (!e->valid || e->set == set) {
+        return;
+    }
+
+    /* An eventfd is readable while its counter is non-zero, and reading
+     * resets it. A single byte is kept in the pipe otherwise. */
+#if BLADERF_OS_LINUX
+    {
+        uint64_t val = 1;
+        n = set ? write(e->fds[1], &val, sizeof(val))
+                : read(e->fds[0], &val, sizeof(val));
+    }
+#else
+    {
+        uint8_t val = 0;
+        n = set ? write(e->fds[1], &val, sizeof(val))
+                : read(e->fds[0], &val, sizeof(val));
+    }
+#endif
+
+    if (n < 0 && errno != EAGAIN) {
+        log_debug("Failed to %s poll event: %s\n", set ? "set" : "clear",
+                  strerror(errno));
+        return;
+    }
+
+    e->set = set;
+}
+
+bladerf_poll_handle poll_event_handle(const struct poll_event *e)
+{
+    return e->fds[0];
+}
+
+#endif
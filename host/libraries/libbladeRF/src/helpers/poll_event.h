@@ -0,0 +1,74 @@
+/**
+ * @file poll_event.h
+ *
+ * @brief Level-triggered readiness indication via a pollable OS handle
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_POLL_EVENT_H_
+#define HELPERS_POLL_EVENT_H_
+
+#include <stdbool.h>
+
+#include <libbladeRF.h>
+
+/**
+ * A handle that is readable (POSIX) or signaled (Windows) while set.
+ *
+ * This is backed by an eventfd on Linux, a non-blocking pipe on other POSIX
+ * systems, and a manual-reset event on Windows. The handle is only written
+ * when its state changes.
+ */
+struct poll_event {
+    bool valid;     /* Initialized */
+    bool set;       /* Currently set */
+    void *handle;   /* Windows event HANDLE */
+    int fds[2];     /* Read and write ends. These are the same eventfd on
+                     * Linux. */
+};
+
+/**
+ * Create the underlying handle, which is initially cleared
+ *
+ * @return 0 on success, BLADERF_ERR_UNEXPECTED on failure
+ */
+int poll_event_init(struct poll_event *e);
+
+/**
+ * Close the underlying handle. This is a no-op for an event that was never
+ * initialized.
+ */
+void poll_event_deinit(struct poll_event *e);
+
+/**
+ * Set or clear the event. Callers are responsible for serializing calls.
+ */
+void poll_event_update(struct poll_event *e, bool set);
+
+/**
+ * @return The handle for callers to poll on
+ */
+bladerf_poll_handle poll_event_handle(const struct poll_event *e);
+
+#endif
@@ -0,0 +1,200 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bladeRF.h"
+#include "log.h"
+
+#include "backend/backend.h"
+#include "board/board.h"
+
+#include "helpers/file.h"
+#include "helpers/probe_cache.h"
+
+/* Increment when the cache file format changes */
+#define PROBE_CACHE_FORMAT 1
+
+static char *cache_path(struct bladerf *dev)
+{
+    if (getenv("BLADERF_DISABLE_PROBE_CACHE")) {
+        return NULL;
+    }
+
+    return file_device_path("probe", dev->ident.serial, ".cache");
+}
+
+static int cache_load(const char *path,
+                      const struct bladerf_version *fw_version,
+                      bool read_flash_id,
+                      uint8_t *mid,
+                      uint8_t *did,
+                      char *cal)
+{
+    FILE *f;
+    unsigned int format, major, minor, patch, has_id, m, d, byte;
+    size_t i;
+    int status = BLADERF_ERR_INVAL;
+
+    f = fopen(path, "r");
+    if (f == NULL) {
+        return BLADERF_ERR_NO_FILE;
+    }
+
+    if (fscanf(f, "format=%u\nfw=%u.%u.%u\nflash_id=%u:%x:%x\ncal=", &format,
+               &major, &minor, &patch, &has_id, &m, &d) != 7) {
+        goto out;
+    }
+
+    /* The cache is only valid for the firmware that produced it */
+    if (format != PROBE_CACHE_FORMAT || major != fw_version->major ||
+        minor != fw_version->minor || patch != fw_version->patch ||
+        (has_id != 0) != read_flash_id || m > 0xff || d > 0xff) {
+        goto out;
+    }
+
+    for (i = 0; i < CAL_BUFFER_SIZE; i++) {
+        if (fscanf(f, "%2x", &byte) != 1) {
+            goto out;
+        }
+
+        cal[i] = (char)byte;
+    }
+
+    *mid   = (uint8_t)m;
+    *did   = (uint8_t)d;
+    status = 0;
+
+out:
+    fclose(f);
+    return status;
+}
+
+static void cache_store(const char *path,
+                        const struct bladerf_version *fw_version,
+                        bool read_flash_id,
+                        uint8_t mid,
+                        uint8_t did,
+                        const char *cal)
+{
+    FILE *f;
+    size_t i;
+
+    f = fopen(path, "w");
+    if (f == NULL) {
+        log_debug("Unable to write probe cache %s\n", path);
+        return;
+    }
+
+    fprintf(f, "format=%u\nfw=%u.%u.%u\nflash_id=%u:%02x:%02x\ncal=",
+            PROBE_CACHE_FORMAT, fw_version->major, fw_version->minor,
+            fw_version->patch, read_flash_id ? 1 : 0, mid, did);
+
+    for (i = 0; i < CAL_BUFFER_SIZE; i++) {
+        fprintf(f, "%02x", (uint8_t)cal[i]);
+    }
+
+    fprintf(f, "\n");
+
+    if (fclose(f) != 0) {
+        log_debug("Failed to write probe cache %s\n", path);
+        remove(path);
+    }
+}
+
+void probe_cache_read(struct bladerf *dev,
+                      const struct bladerf_version *fw_version,
+                      bool read_flash_id)
+{
+    struct bladerf_flash_arch *flash_arch = dev->flash_arch;
+    char *path;
+    int status;
+    bool id_ok = true;
+
+    probe_cache_deinit(dev);
+
+    flash_arch->cal = calloc(CAL_BUFFER_SIZE, 1);
+    if (flash_arch->cal == NULL) {
+        return;
+    }
+
+    path = cache_path(dev);
+
+    if (path != NULL) {
+        status = cache_load(path, fw_version, read_flash_id,
+                            &flash_arch->manufacturer_id,
+                            &flash_arch->device_id, flash_arch->cal);
+        if (status == 0) {
+            log_verbose("Using cached flash ID and calibration data from %s\n",
+                        path);
+            free(path);
+            return;
+        }
+    }
+
+    if (read_flash_id) {
+        status = dev->backend->get_flash_id(dev, &flash_arch->manufacturer_id,
+                                            &flash_arch->device_id);
+        if (status < 0) {
+            log_error("Failed to probe SPI flash ID information.\n");
+            id_ok = false;
+        }
+    }
+
+    status = dev->backend->get_cal(dev, flash_arch->cal);
+    if (status < 0) {
+        log_debug("Failed to read calibration region: %s\n",
+                  bladerf_strerror(status));
+        probe_cache_deinit(dev);
+    } else if (path != NULL && id_ok) {
+        cache_store(path, fw_version, read_flash_id,
+                    flash_arch->manufacturer_id, flash_arch->device_id,
+                    flash_arch->cal);
+    }
+
+    free(path);
+}
+
+void probe_cache_invalidate(struct bladerf *dev)
+{
+    char *path;
+
+    probe_cache_deinit(dev);
+
+    path = cache_path(dev);
+    if (path != NULL) {
+        remove(path);
+        free(path);
+    }
+}
+
+void probe_cache_deinit(struct bladerf *dev)
+{
+    if (dev->flash_arch != NULL) {
+        free(dev->flash_arch->cal);
+        dev->flash_arch->cal = NULL;
+
+        /* Fields decoded from it are stale too */
+        dev->flash_arch->fields.cal_decoded = false;
+    }
+}
@@ -0,0 +1,73 @@
+/**
+ * @file probe_cache.h
+ *
+ * @brief Cache of device information probed at open time
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_PROBE_CACHE_H_
+#define HELPERS_PROBE_CACHE_H_
+
+#include <stdbool.h>
+
+#include <libbladeRF.h>
+
+/**
+ * Probe the SPI flash ID and calibration region
+ *
+ * These are read once per device and firmware version, and cached in the
+ * user's bladeRF config directory. Subsequent opens of the same device with
+ * the same firmware use the cached copy instead of reading them from the
+ * device. Define BLADERF_DISABLE_PROBE_CACHE in the environment to bypass
+ * the cache.
+ *
+ * On return, dev->flash_arch->manufacturer_id and device_id are populated
+ * (if `read_flash_id` is set), and dev->flash_arch->cal holds a copy of the
+ * calibration region if it could be read. Failures are logged and are
+ * non-fatal.
+ *
+ * @param       dev             Device handle
+ * @param[in]   fw_version      FX3 firmware version
+ * @param[in]   read_flash_id   Firmware supports reading the SPI flash ID
+ */
+void probe_cache_read(struct bladerf *dev,
+                      const struct bladerf_version *fw_version,
+                      bool read_flash_id);
+
+/**
+ * Discard the cached and in-memory copies of the calibration region. This
+ * must be called after modifying the device's flash.
+ *
+ * @param       dev             Device handle
+ */
+void probe_cache_invalidate(struct bladerf *dev);
+
+/**
+ * Free the in-memory copy of the calibration region
+ *
+ * @param       dev             Device handle
+ */
+void probe_cache_deinit(struct bladerf *dev);
+
+#endif
@@ -0,0 +1,72 @@
+/**
+ * @file probes.h
+ *
+ * @brief Static tracepoints (USDT probes) for the streaming and control paths
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_PROBES_H_
+#define HELPERS_PROBES_H_
+
+/* Probes are placed in the "libbladeRF" provider. With the SystemTap SDT
+ * header, each compiles to a single nop, which a tracer (e.g., bpftrace,
+ * perf, or SystemTap) replaces with a breakpoint only while attached. The
+ * arguments' locations are recorded in an ELF note, so they are not
+ * evaluated into any extra storage.
+ *
+ * The probes and their arguments are:
+ *
+ *  sync_state          dir, old state, new state
+ *  sync_wait_start     dir, buffer index
+ *  sync_wait_done      dir, buffer index, status
+ *  sync_buf            dir, buffer index, new buffer status
+ *  sync_worker_state   dir, new worker state
+ *  transfer_submit     dir, transfer index, length
+ *  transfer_done       dir, transfer index, libusb status, actual length
+ *  nios_start          packet magic
+ *  nios_done           packet magic, status
+ *
+ * States and buffer statuses are the values of the corresponding enums in
+ * streaming/sync.h and streaming/sync_worker.h, and other statuses are
+ * BLADERF_ERR_* values, except that of transfer_done, which is a
+ * libusb_transfer_status. Directions are 0 for RX and 1 for TX.
+ *
+ * See host/misc/bpftrace for example scripts.
+ */
+
+#ifdef ENABLE_LIBBLADERF_USDT
+#   include <sys/sdt.h>
+#   define PROBE1(name, a) DTRACE_PROBE1(libbladeRF, name, a)
+#   define PROBE2(name, a, b) DTRACE_PROBE2(libbladeRF, name, a, b)
+#   define PROBE3(name, a, b, c) DTRACE_PROBE3(libbladeRF, name, a, b, c)
+#   define PROBE4(name, a, b, c, d) \
+        DTRACE_PROBE4(libbladeRF, name, a, b, c, d)
+#else
+#   define PROBE1(name, a) do {} while (0)
+#   define PROBE2(name, a, b) do {} while (0)
+#   define PROBE3(name, a, b, c) do {} while (0)
+#   define PROBE4(name, a, b, c, d) do {} while (0)
+#endif
+
+#endif
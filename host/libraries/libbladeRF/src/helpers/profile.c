@@ -0,0 +1,559 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "conversions.h"
+#include "host_config.h"
+#include "log.h"
+#include "sha256.h"
+
+#include "board/board.h"
+#include "helpers/cal_cache.h"
+#include "helpers/channel_config.h"
+#include "helpers/file.h"
+#include "helpers/profile.h"
+
+/* Increment when the profile format changes */
+#define PROFILE_FORMAT 1
+
+#define PROFILE_MAGIC "bladeRFp"
+#define PROFILE_MAGIC_LEN 8
+
+/* Two channels in each direction */
+#define PROFILE_MAX_CHANNELS 4
+
+#define PROFILE_BOARD_LEN 16
+#define PROFILE_PORT_LEN 24
+
+#define PROFILE_HEADER_LEN \
+    (PROFILE_MAGIC_LEN + 4 + PROFILE_BOARD_LEN + BLADERF_SERIAL_LENGTH + 4)
+
+#define PROFILE_CHANNEL_LEN \
+    (4 + 4 + 4 + 4 + 8 + PROFILE_PORT_LEN + 4 + 4 + 4 + 4 * 2 + 1 + 4 + 2 + \
+     4 + 4 * 2)
+
+#define PROFILE_MAX_LEN                                            \
+    (PROFILE_HEADER_LEN + PROFILE_MAX_CHANNELS * PROFILE_CHANNEL_LEN + \
+     SHA256_DIGEST_SIZE)
+
+#define NUM_CORRECTIONS 4
+
+static const bladerf_correction corrections[NUM_CORRECTIONS] = {
+    BLADERF_CORR_DCOFF_I,
+    BLADERF_CORR_DCOFF_Q,
+    BLADERF_CORR_PHASE,
+    BLADERF_CORR_GAIN,
+};
+
+struct profile_channel {
+    bladerf_channel ch;
+    struct bladerf_channel_config config;
+    char port[PROFILE_PORT_LEN];
+
+    uint32_t corr_valid;    /* Bit i set if corr[i] was read */
+    int16_t corr[NUM_CORRECTIONS];
+
+    bool have_quick_tune;
+    struct bladerf_quick_tune quick_tune;
+};
+
+struct pbuf {
+    uint8_t *data;
+    size_t len;
+    size_t pos;
+};
+
+static void put(struct pbuf *b, const void *p, size_t n)
+{
+    memcpy(b->data + b->len, p, n);
+    b->len += n;
+}
+
+static void put_u8(struct pbuf *b, uint8_t v)
+{
+    put(b, &v, sizeof(v));
+}
+
+static void put_u16(struct pbuf *b, uint16_t v)
+{
+    v = HOST_TO_LE16(v);
+    put(b, &v, sizeof(v));
+}
+
+static void put_u32(struct pbuf *b, uint32_t v)
+{
+    v = HOST_TO_LE32(v);
+    put(b, &v, sizeof(v));
+}
+
+static void put_u64(struct pbuf *b, uint64_t v)
+{
+    v = HOST_TO_LE64(v);
+    put(b, &v, sizeof(v));
+}
+
+static void get(struct pbuf *b, void *p, size_t n)
+{
+    memcpy(p, b->data + b->pos, n);
+    b->pos += n;
+}
+
+static uint8_t get_u8(struct pbuf *b)
+{
+    uint8_t v;
+    get(b, &v, sizeof(v));
+    return v;
+}
+
+static uint16_t get_u16(struct pbuf *b)
+{
+    uint16_t v;
+    get(b, &v, sizeof(v));
+    return LE16_TO_HOST(v);
+}
+
+static uint32_t get_u32(struct pbuf *b)
+{
+    uint32_t v;
+    get(b, &v, sizeof(v));
+    return LE32_TO_HOST(v);
+}
+
+static uint64_t get_u64(struct pbuf *b)
+{
+    uint64_t v;
+    get(b, &v, sizeof(v));
+    return LE64_TO_HOST(v);
+}
+
+static void digest(const uint8_t *buf, size_t len,
+                   uint8_t out[SHA256_DIGEST_SIZE])
+{
+    SHA256_CTX ctx;
+
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, buf, len);
+    SHA256_Final(out, &ctx);
+}
+
+static char *default_path(struct bladerf *dev)
+{
+    if (!file_serial_is_valid(dev->ident.serial)) {
+        log_debug("%s: No serial number to name the profile by.\n",
+                  __FUNCTION__);
+        return NULL;
+    }
+
+    return file_device_path("profile", dev->ident.serial, ".bin");
+}
+
+/* Quick tune parameters are self-contained only on the bladeRF x40/x115.
+ * The bladeRF 2.0 micro's refer to profiles held in the FPGA's memory,
+ * which do not outlive the FPGA image. */
+static bool quick_tune_persists(struct bladerf *dev)
+{
+    return strcmp(dev->board->name, "bladerf1") == 0;
+}
+
+static void capture_channel(struct bladerf *dev,
+                            bladerf_channel ch,
+                            struct profile_channel *p)
+{
+    struct bladerf_channel_config *c = &p->config;
+    bool mgc = true;
+    const char *port;
+    size_t i;
+
+    memset(p, 0, sizeof(*p));
+    p->ch = ch;
+
+    if (dev->board->get_sample_rate(dev, ch, &c->sample_rate) == 0) {
+        c->fields |= BLADERF_CHANNEL_CONFIG_SAMPLE_RATE;
+    }
+
+    if (dev->board->get_bandwidth(dev, ch, &c->bandwidth) == 0) {
+        c->fields |= BLADERF_CHANNEL_CONFIG_BANDWIDTH;
+    }
+
+    if (dev->board->get_frequency(dev, ch, &c->frequency) == 0) {
+        c->fields |= BLADERF_CHANNEL_CONFIG_FREQUENCY;
+    }
+
+    if (dev->board->get_rf_port(dev, ch, &port) == 0 &&
+        strlen(port) < PROFILE_PORT_LEN) {
+        strcpy(p->port, port);
+        c->fields |= BLADERF_CHANNEL_CONFIG_RF_PORT;
+    }
+
+    if (!BLADERF_CHANNEL_IS_TX(ch) &&
+        dev->board->get_gain_mode(dev, ch, &c->gain_mode) == 0) {
+        c->fields |= BLADERF_CHANNEL_CONFIG_GAIN_MODE;
+        mgc = (c->gain_mode == BLADERF_GAIN_MGC);
+    }
+
+    /* An AGC's gain of the moment is not part of the operating point */
+    if (mgc && dev->board->get_gain(dev, ch, &c->gain) == 0) {
+        c->fields |= BLADERF_CHANNEL_CONFIG_GAIN;
+    }
+
+    for (i = 0; i < NUM_CORRECTIONS; i++) {
+        if (dev->board->get_correction(dev, ch, corrections[i],
+                                       &p->corr[i]) == 0) {
+            p->corr_valid |= 1 << i;
+        }
+    }
+
+    if (quick_tune_persists(dev) &&
+        (c->fields & BLADERF_CHANNEL_CONFIG_FREQUENCY) &&
+        dev->board->get_quick_tune(dev, ch, &p->quick_tune) == 0) {
+        p->have_quick_tune = true;
+    }
+
+    log_verbose("%s: %s fields 0x%02x, corrections 0x%x%s\n", __FUNCTION__,
+                channel2str(ch), c->fields, p->corr_valid,
+                p->have_quick_tune ? ", quick tune" : "");
+}
+
+static void pack_channel(struct pbuf *b, const struct profile_channel *p)
+{
+    const struct bladerf_channel_config *c = &p->config;
+    const struct bladerf_quick_tune *q     = &p->quick_tune;
+    size_t i;
+
+    put_u32(b, (uint32_t)p->ch);
+    put_u32(b, c->fields);
+    put_u32(b, c->sample_rate);
+    put_u32(b, c->bandwidth);
+    put_u64(b, c->frequency);
+    put(b, p->port, PROFILE_PORT_LEN);
+    put_u32(b, (uint32_t)c->gain_mode);
+    put_u32(b, (uint32_t)c->gain);
+
+    put_u32(b, p->corr_valid);
+    for (i = 0; i < NUM_CORRECTIONS; i++) {
+        put_u16(b, (uint16_t)p->corr[i]);
+    }
+
+    put_u8(b, p->have_quick_tune ? 1 : 0);
+    put_u8(b, q->freqsel);
+    put_u8(b, q->vcocap);
+    put_u8(b, q->flags);
+    put_u8(b, q->xb_gpio);
+    put_u16(b, q->nint);
+    put_u32(b, q->nfrac);
+    put_u16(b, (uint16_t)q->dc_i);
+    put_u16(b, (uint16_t)q->dc_q);
+    put_u16(b, (uint16_t)q->iq_gain);
+    put_u16(b, (uint16_t)q->iq_phase);
+}
+
+static void unpack_channel(struct pbuf *b, struct profile_channel *p)
+{
+    struct bladerf_channel_config *c = &p->config;
+    struct bladerf_quick_tune *q     = &p->quick_tune;
+    size_t i;
+
+    memset(p, 0, sizeof(*p));
+
+    p->ch          = (bladerf_channel)get_u32(b);
+    c->fields      = get_u32(b);
+    c->sample_rate = get_u32(b);
+    c->bandwidth   = get_u32(b);
+    c->frequency   = get_u64(b);
+    get(b, p->port, PROFILE_PORT_LEN);
+    p->port[PROFILE_PORT_LEN - 1] = '\0';
+    c->rf_port     = p->port;
+    c->gain_mode   = (bladerf_gain_mode)get_u32(b);
+    c->gain        = (bladerf_gain)get_u32(b);
+
+    p->corr_valid = get_u32(b);
+    for (i = 0; i < NUM_CORRECTIONS; i++) {
+        p->corr[i] = (int16_t)get_u16(b);
+    }
+
+    p->have_quick_tune = get_u8(b) != 0;
+    q->freqsel         = get_u8(b);
+    q->vcocap          = get_u8(b);
+    q->flags           = get_u8(b);
+    q->xb_gpio         = get_u8(b);
+    q->nint            = get_u16(b);
+    q->nfrac           = get_u32(b);
+    q->dc_i            = (int16_t)get_u16(b);
+    q->dc_q            = (int16_t)get_u16(b);
+    q->iq_gain         = (int16_t)get_u16(b);
+    q->iq_phase        = (int16_t)get_u16(b);
+}
+
+int profile_save(struct bladerf *dev, const char *filename)
+{
+    uint8_t data[PROFILE_MAX_LEN];
+    struct pbuf b = { data, 0, 0 };
+    struct profile_channel p;
+    char board[PROFILE_BOARD_LEN] = { 0 };
+    uint8_t sum[SHA256_DIGEST_SIZE];
+    char *path = NULL;
+    uint32_t count = 0;
+    size_t count_pos;
+    unsigned int d;
+    size_t i;
+    FILE *f;
+    int status;
+
+    if (filename == NULL) {
+        path = default_path(dev);
+        if (path == NULL) {
+            return BLADERF_ERR_UNSUPPORTED;
+        }
+        filename = path;
+    }
+
+    strncpy(board, dev->board->name, sizeof(board) - 1);
+
+    put(&b, PROFILE_MAGIC, PROFILE_MAGIC_LEN);
+    put_u32(&b, PROFILE_FORMAT);
+    put(&b, board, sizeof(board));
+    put(&b, dev->ident.serial, BLADERF_SERIAL_LENGTH);
+    count_pos = b.len;
+    put_u32(&b, 0);
+
+    for (d = 0; d < 2; d++) {
+        const bladerf_direction dir = (d == 0) ? BLADERF_RX : BLADERF_TX;
+        const size_t n = dev->board->get_channel_count(dev, dir);
+
+        for (i = 0; i < n && count < PROFILE_MAX_CHANNELS; i++, count++) {
+            const bladerf_channel ch = (dir == BLADERF_RX)
+                                           ? BLADERF_CHANNEL_RX(i)
+                                           : BLADERF_CHANNEL_TX(i);
+
+            capture_channel(dev, ch, &p);
+            pack_channel(&b, &p);
+        }
+    }
+
+    count = HOST_TO_LE32(count);
+    memcpy(data + count_pos, &count, sizeof(count));
+
+    digest(data, b.len, sum);
+    put(&b, sum, sizeof(sum));
+
+    f = fopen(filename, "wb");
+    if (f == NULL) {
+        log_debug("%s: Unable to open %s\n", __FUNCTION__, filename);
+        status = BLADERF_ERR_IO;
+        goto out;
+    }
+
+    status = file_write(f, data, b.len);
+    if (fclose(f) != 0 && status == 0) {
+        status = BLADERF_ERR_IO;
+    }
+
+    if (status != 0) {
+        log_debug("%s: Failed to write %s\n", __FUNCTION__, filename);
+        remove(filename);
+    } else {
+        log_verbose("%s: Saved %s\n", __FUNCTION__, filename);
+    }
+
+out:
+    free(path);
+    return status;
+}
+
+/* Parse and authenticate a profile, filling p[] with count channels */
+static int parse(struct bladerf *dev, uint8_t *data, size_t len,
+                 struct profile_channel p[PROFILE_MAX_CHANNELS],
+                 uint32_t *count)
+{
+    struct pbuf b = { data, len, 0 };
+    uint8_t sum[SHA256_DIGEST_SIZE];
+    char magic[PROFILE_MAGIC_LEN];
+    char board[PROFILE_BOARD_LEN];
+    char serial[BLADERF_SERIAL_LENGTH];
+    uint32_t format, i;
+
+    if (len < PROFILE_HEADER_LEN + SHA256_DIGEST_SIZE) {
+        log_debug("%s: Truncated profile.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    digest(data, len - SHA256_DIGEST_SIZE, sum);
+    if (memcmp(sum, data + len - SHA256_DIGEST_SIZE, sizeof(sum)) != 0) {
+        log_debug("%s: Profile checksum mismatch.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    get(&b, magic, sizeof(magic));
+    format = get_u32(&b);
+    if (memcmp(magic, PROFILE_MAGIC, PROFILE_MAGIC_LEN) != 0 ||
+        format != PROFILE_FORMAT) {
+        log_debug("%s: Not a format %u profile.\n", __FUNCTION__,
+                  PROFILE_FORMAT);
+        return BLADERF_ERR_INVAL;
+    }
+
+    get(&b, board, sizeof(board));
+    get(&b, serial, sizeof(serial));
+    board[sizeof(board) - 1]   = '\0';
+    serial[sizeof(serial) - 1] = '\0';
+
+    if (strcmp(board, dev->board->name) != 0 ||
+        strcmp(serial, dev->ident.serial) != 0) {
+        log_warning("Profile was saved from %s %s, not this device.\n", board,
+                    serial);
+        return BLADERF_ERR_INVAL;
+    }
+
+    *count = get_u32(&b);
+    if (*count > PROFILE_MAX_CHANNELS ||
+        len != PROFILE_HEADER_LEN + *count * PROFILE_CHANNEL_LEN +
+                   SHA256_DIGEST_SIZE) {
+        log_debug("%s: Malformed profile.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    for (i = 0; i < *count; i++) {
+        unpack_channel(&b, &p[i]);
+    }
+
+    return 0;
+}
+
+/* Validate a channel's saved state against the device */
+static int check_channel(struct bladerf *dev, const struct profile_channel *p)
+{
+    const bladerf_direction dir =
+        BLADERF_CHANNEL_IS_TX(p->ch) ? BLADERF_TX : BLADERF_RX;
+
+    if ((size_t)(p->ch >> 1) >= dev->board->get_channel_count(dev, dir)) {
+        log_debug("%s: Channel %d is not present.\n", __FUNCTION__, p->ch);
+        return BLADERF_ERR_INVAL;
+    }
+
+    return channel_config_check(dev, p->ch, &p->config);
+}
+
+static int restore_channel(struct bladerf *dev, struct profile_channel *p)
+{
+    struct bladerf_channel_config c = p->config;
+    const uint32_t pre = BLADERF_CHANNEL_CONFIG_SAMPLE_RATE |
+                         BLADERF_CHANNEL_CONFIG_BANDWIDTH;
+    size_t i;
+    int status;
+
+    /* Reach the saved frequency using the saved tuning words, in place of
+     * the tuning step of bladerf_apply_config(). Those steps that precede
+     * it are applied first, and those that follow it afterwards. */
+    if (p->have_quick_tune) {
+        c.fields = p->config.fields & pre;
+        status   = dev->board->apply_config(dev, p->ch, &c);
+        if (status != 0) {
+            return status;
+        }
+
+        status = dev->board->schedule_retune(dev, p->ch, BLADERF_RETUNE_NOW,
+                                             p->config.frequency,
+                                             &p->quick_tune);
+        if (status == 0) {
+            c.fields = p->config.fields & ~(pre |
+                                            BLADERF_CHANNEL_CONFIG_FREQUENCY);
+        } else {
+            log_debug("%s: %s quick tune failed: %s\n", __FUNCTION__,
+                      channel2str(p->ch), bladerf_strerror(status));
+            c.fields = p->config.fields & ~pre;
+        }
+    }
+
+    status = dev->board->apply_config(dev, p->ch, &c);
+    if (status != 0) {
+        return status;
+    }
+
+    for (i = 0; i < NUM_CORRECTIONS; i++) {
+        if (!(p->corr_valid & (1 << i))) {
+            continue;
+        }
+
+        status = dev->board->set_correction(dev, p->ch, corrections[i],
+                                            p->corr[i]);
+        if (status != 0) {
+            return status;
+        }
+
+        cal_cache_record_value(dev, p->ch, corrections[i], p->corr[i]);
+    }
+
+    return 0;
+}
+
+int profile_load(struct bladerf *dev, const char *filename)
+{
+    struct profile_channel p[PROFILE_MAX_CHANNELS];
+    uint8_t *data = NULL;
+    size_t len;
+    char *path = NULL;
+    uint32_t count, i;
+    int status;
+
+    if (filename == NULL) {
+        path = default_path(dev);
+        if (path == NULL) {
+            return BLADERF_ERR_UNSUPPORTED;
+        }
+        filename = path;
+    }
+
+    status = file_read_buffer(filename, &data, &len);
+    if (status != 0) {
+        log_debug("%s: Unable to read %s\n", __FUNCTION__, filename);
+        goto out;
+    }
+
+    status = parse(dev, data, len, p, &count);
+    if (status != 0) {
+        goto out;
+    }
+
+    for (i = 0; i < count; i++) {
+        status = check_channel(dev, &p[i]);
+        if (status != 0) {
+            log_debug("%s: %s: %s\n", __FUNCTION__, channel2str(p[i].ch),
+                      bladerf_strerror(status));
+            goto out;
+        }
+    }
+
+    for (i = 0; i < count && status == 0; i++) {
+        status = restore_channel(dev, &p[i]);
+    }
+
+    if (status == 0) {
+        log_verbose("%s: Restored %s\n", __FUNCTION__, filename);
+    }
+
+out:
+    free(data);
+    free(path);
+    return status;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file profile.h
+ *
+ * @brief Binary snapshots of a device's operating point
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_PROFILE_H_
+#define HELPERS_PROFILE_H_
+
+#include <libbladeRF.h>
+
+/* A profile holds, for each channel, the bladerf_channel_config fields that
+ * could be read back, the channel's corrections, and on the bladeRF x40/x115
+ * the LMS6002D tuning words of its frequency. It is tied to the board type
+ * and serial number it was saved from, and is protected by a SHA-256 digest.
+ *
+ * Profiles are saved to the user's bladeRF config directory as
+ * profile-<serial>.bin unless a filename is given. */
+
+/**
+ * Save a device's current operating point. Must be called with the device's
+ * handle lock held.
+ *
+ * @param       dev         Device handle
+ * @param[in]   filename    Profile path, or NULL for the device's default
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int profile_save(struct bladerf *dev, const char *filename);
+
+/**
+ * Restore an operating point saved by profile_save(). Must be called with
+ * the device's handle lock held.
+ *
+ * Every channel's configuration is validated before anything is written.
+ *
+ * @param       dev         Device handle
+ * @param[in]   filename    Profile path, or NULL for the device's default
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if the profile is malformed or
+ *         belongs to another device, or a value from \ref RETCODES list on
+ *         other failures
+ */
+int profile_load(struct bladerf *dev, const char *filename);
+
+#endif
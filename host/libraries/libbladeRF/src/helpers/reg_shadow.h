@@ -0,0 +1,114 @@
+/**
+ * @file reg_shadow.h
+ *
+ * @brief Host-side shadow copies of device registers
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+#ifndef HELPERS_REG_SHADOW_H_
+#define HELPERS_REG_SHADOW_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Largest address space supported: the AD9361's 10-bit SPI addresses */
+#define REG_SHADOW_MAX_REGS 1024
+
+/**
+ * Write-through shadow of a device's 8-bit registers
+ *
+ * Entries are populated by accesses to registers that do not change without
+ * the host's involvement. Which registers those are is up to the user of
+ * this structure. A zero-initialized shadow contains no valid entries.
+ */
+struct reg_shadow {
+    uint8_t value[REG_SHADOW_MAX_REGS];
+    uint8_t valid[REG_SHADOW_MAX_REGS / 8];
+};
+
+/**
+ * Fetch a register's value from the shadow
+ *
+ * @param[in]   s       Register shadow
+ * @param[in]   addr    Register address
+ * @param[out]  data    Updated with the register's value, if valid
+ *
+ * @return true if the entry was valid, false otherwise
+ */
+static inline bool reg_shadow_get(const struct reg_shadow *s,
+                                  uint16_t addr,
+                                  uint8_t *data)
+{
+    if (addr >= REG_SHADOW_MAX_REGS ||
+        (s->valid[addr / 8] & (1 << (addr % 8))) == 0) {
+        return false;
+    }
+
+    *data = s->value[addr];
+    return true;
+}
+
+/**
+ * Record a register's value
+ *
+ * @param       s       Register shadow
+ * @param[in]   addr    Register address
+ * @param[in]   data    Value written to or read from the register
+ */
+static inline void reg_shadow_set(struct reg_shadow *s,
+                                  uint16_t addr,
+                                  uint8_t data)
+{
+    if (addr < REG_SHADOW_MAX_REGS) {
+        s->value[addr] = data;
+        s->valid[addr / 8] |= (1 << (addr % 8));
+    }
+}
+
+/**
+ * Discard a single entry
+ *
+ * @param       s       Register shadow
+ * @param[in]   addr    Register address
+ */
+static inline void reg_shadow_invalidate(struct reg_shadow *s, uint16_t addr)
+{
+    if (addr < REG_SHADOW_MAX_REGS) {
+        s->valid[addr / 8] &= ~(1 << (addr % 8));
+    }
+}
+
+/**
+ * Discard all entries
+ *
+ * @param       s       Register shadow
+ */
+static inline void reg_shadow_invalidate_all(struct reg_shadow *s)
+{
+    memset(s->valid, 0, sizeof(s->valid));
+}
+
+#endif
@@ -0,0 +1,472 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "rel_assert.h"
+#include "thread.h"
+
+#include "backend/usb/usb.h"
+#include "board/board.h"
+#include "streaming/async.h"
+#include "streaming/metadata.h"
+
+#include "helpers/repeater.h"
+#include "helpers/timeout.h"
+
+/* Time allowed for the TX stream to start, and for a buffer handed to it by
+ * the RX callback to be accepted */
+#define REPEATER_SUBMIT_TIMEOUT_MS 100
+
+/* Buffers are handed between the two streams by pointer. Every buffer of
+ * both streams belongs to one pool: each is either in flight on the RX
+ * stream, queued for TX, in flight on the TX stream, or free. */
+struct bladerf_repeater {
+    struct bladerf_repeater_config config;
+    struct bladerf *rx_dev;
+    struct bladerf *tx_dev;
+
+    struct bladerf_stream *rx_stream;
+    struct bladerf_stream *tx_stream;
+    void **rx_buffers;
+    void **tx_buffers;
+    size_t msg_size;
+
+    MUTEX lock;
+    pthread_cond_t tx_started;
+
+    void **free;            /* Stack of free buffers */
+    unsigned int num_free;
+    void **ready;           /* Ring of received buffers queued for TX */
+    unsigned int ready_head;
+    unsigned int ready_count;
+    unsigned int tx_idle;   /* TX transfers awaiting a buffer */
+    bool tx_running;        /* TX stream has requested its first buffers */
+    bool stop;
+
+    pthread_t rx_thread;
+    pthread_t tx_thread;
+    bool rx_thread_running;
+    bool tx_thread_running;
+    bool rx_enabled;
+    bool tx_enabled;
+    int rx_status;
+    int tx_status;
+
+    /* Accessed only by the RX callback */
+    bool have_rx_ts;
+    uint64_t next_rx_ts;
+
+    struct bladerf_repeater_stats stats;
+};
+
+static inline void push_ready(struct bladerf_repeater *r, void *buf)
+{
+    const unsigned int n = r->config.num_buffers;
+
+    assert(r->ready_count < n);
+    r->ready[(r->ready_head + r->ready_count) % n] = buf;
+    r->ready_count++;
+}
+
+static inline void *pop_ready(struct bladerf_repeater *r)
+{
+    void *buf = r->ready[r->ready_head];
+
+    assert(r->ready_count > 0);
+    r->ready_head = (r->ready_head + 1) % r->config.num_buffers;
+    r->ready_count--;
+
+    return buf;
+}
+
+/* Shift the timestamp of each message of a received buffer to its TX time,
+ * clearing the RX status flags that the FPGA reported in its header.
+ * Returns the number of discontinuities preceding the messages. */
+static unsigned int retime_buffer(struct bladerf_repeater *r, uint8_t *buf)
+{
+    const size_t len = r->config.buffer_size * sizeof(int16_t) * 2;
+    const uint64_t spm =
+        (r->msg_size - METADATA_HEADER_SIZE) / (sizeof(int16_t) * 2);
+    unsigned int gaps = 0;
+    size_t off;
+
+    for (off = 0; off + r->msg_size <= len; off += r->msg_size) {
+        const uint64_t ts = metadata_get_timestamp(buf + off);
+
+        if (r->have_rx_ts && ts != r->next_rx_ts) {
+            gaps++;
+        }
+
+        r->have_rx_ts = true;
+        r->next_rx_ts = ts + spm;
+
+        metadata_set(buf + off, ts + r->config.delay, 0);
+    }
+
+    return gaps;
+}
+
+static void *rx_callback(struct bladerf *dev,
+                         struct bladerf_stream *stream,
+                         struct bladerf_metadata *meta,
+                         void *samples,
+                         size_t num_samples,
+                         void *user_data)
+{
+    struct bladerf_repeater *r = user_data;
+    bool submit = false;
+    unsigned int gaps;
+    void *next;
+    int status;
+
+    gaps = retime_buffer(r, samples);
+
+    MUTEX_LOCK(&r->lock);
+
+    r->stats.discontinuities += gaps;
+
+    if (r->stop) {
+        MUTEX_UNLOCK(&r->lock);
+        return BLADERF_STREAM_SHUTDOWN;
+    }
+
+    /* An idle TX transfer takes the buffer immediately. Otherwise it is
+     * queued for the next TX transfer to complete. */
+    if (r->ready_count == 0 && r->tx_idle > 0) {
+        r->tx_idle--;
+        submit = true;
+    } else {
+        push_ready(r, samples);
+    }
+
+    if (r->num_free > 0) {
+        next = r->free[--r->num_free];
+    } else {
+        /* TX has fallen behind. Drop the oldest queued buffer, so that
+         * the delay stays fixed. */
+        next = pop_ready(r);
+        r->stats.dropped++;
+    }
+
+    MUTEX_UNLOCK(&r->lock);
+
+    if (submit) {
+        status = r->tx_dev->board->submit_stream_buffer(
+            r->tx_stream, samples, REPEATER_SUBMIT_TIMEOUT_MS, true);
+
+        if (status != 0) {
+            log_debug("%s: TX submission failed: %s\n", __FUNCTION__,
+                      bladerf_strerror(status));
+
+            MUTEX_LOCK(&r->lock);
+            r->tx_idle++;
+            push_ready(r, samples);
+            MUTEX_UNLOCK(&r->lock);
+        }
+    }
+
+    return next;
+}
+
+static void *tx_callback(struct bladerf *dev,
+                         struct bladerf_stream *stream,
+                         struct bladerf_metadata *meta,
+                         void *samples,
+                         size_t num_samples,
+                         void *user_data)
+{
+    struct bladerf_repeater *r = user_data;
+    void *next = BLADERF_STREAM_NO_DATA;
+
+    MUTEX_LOCK(&r->lock);
+
+    if (samples != NULL) {
+        r->free[r->num_free++] = samples;
+        r->stats.relayed++;
+    } else if (!r->tx_running) {
+        r->tx_running = true;
+        pthread_cond_broadcast(&r->tx_started);
+    }
+
+    if (r->stop) {
+        next = BLADERF_STREAM_SHUTDOWN;
+    } else if (r->ready_count > 0) {
+        next = pop_ready(r);
+    } else {
+        r->tx_idle++;
+
+        if (samples != NULL && r->tx_idle == r->config.num_transfers) {
+            r->stats.underruns++;
+        }
+    }
+
+    MUTEX_UNLOCK(&r->lock);
+
+    return next;
+}
+
+static void *rx_task(void *arg)
+{
+    struct bladerf_repeater *r = arg;
+    int status = bladerf_stream(r->rx_stream, BLADERF_RX_X1);
+
+    MUTEX_LOCK(&r->lock);
+    r->rx_status = status;
+    MUTEX_UNLOCK(&r->lock);
+
+    return NULL;
+}
+
+static void *tx_task(void *arg)
+{
+    struct bladerf_repeater *r = arg;
+    int status = bladerf_stream(r->tx_stream, BLADERF_TX_X1);
+
+    MUTEX_LOCK(&r->lock);
+    r->tx_status = status;
+    r->tx_running = true;
+    pthread_cond_broadcast(&r->tx_started);
+    MUTEX_UNLOCK(&r->lock);
+
+    return NULL;
+}
+
+static int wait_tx_started(struct bladerf_repeater *r)
+{
+    struct timespec deadline;
+    int status = populate_abs_timeout(&deadline, REPEATER_SUBMIT_TIMEOUT_MS);
+
+    if (status != 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    MUTEX_LOCK(&r->lock);
+
+    while (!r->tx_running && status == 0) {
+        status = pthread_cond_timedwait(&r->tx_started, &r->lock, &deadline);
+    }
+
+    if (r->tx_status != 0) {
+        status = r->tx_status;
+    } else if (status == ETIMEDOUT) {
+        status = BLADERF_ERR_TIMEOUT;
+    } else if (status != 0) {
+        status = BLADERF_ERR_UNEXPECTED;
+    }
+
+    MUTEX_UNLOCK(&r->lock);
+
+    return status;
+}
+
+static int repeater_teardown(struct bladerf_repeater *r)
+{
+    int status = 0, s;
+
+    MUTEX_LOCK(&r->lock);
+    r->stop = true;
+    MUTEX_UNLOCK(&r->lock);
+
+    /* Shut down any stream that is not receiving callbacks */
+    if (r->rx_thread_running) {
+        bladerf_submit_stream_buffer_nb(r->rx_stream, BLADERF_STREAM_SHUTDOWN);
+        pthread_join(r->rx_thread, NULL);
+        r->rx_thread_running = false;
+    }
+
+    if (r->tx_thread_running) {
+        bladerf_submit_stream_buffer_nb(r->tx_stream, BLADERF_STREAM_SHUTDOWN);
+        pthread_join(r->tx_thread, NULL);
+        r->tx_thread_running = false;
+    }
+
+    if (r->rx_enabled) {
+        s = bladerf_enable_module(r->rx_dev, r->config.rx_channel, false);
+        if (s != 0 && status == 0) {
+            status = s;
+        }
+    }
+
+    if (r->tx_enabled) {
+        s = bladerf_enable_module(r->tx_dev, r->config.tx_channel, false);
+        if (s != 0 && status == 0) {
+            status = s;
+        }
+    }
+
+    bladerf_deinit_stream(r->rx_stream);
+    bladerf_deinit_stream(r->tx_stream);
+
+    if (status == 0) {
+        status = (r->rx_status != 0) ? r->rx_status : r->tx_status;
+    }
+
+    pthread_cond_destroy(&r->tx_started);
+    MUTEX_DESTROY(&r->lock);
+    free(r->free);
+    free(r->ready);
+    free(r);
+
+    return status;
+}
+
+static size_t msg_size(struct bladerf *dev)
+{
+    return (bladerf_device_speed(dev) == BLADERF_DEVICE_SPEED_SUPER)
+               ? USB_MSG_SIZE_SS
+               : USB_MSG_SIZE_HS;
+}
+
+int repeater_start(struct bladerf_repeater **rep,
+                   struct bladerf *rx_dev,
+                   struct bladerf *tx_dev,
+                   const struct bladerf_repeater_config *config)
+{
+    const unsigned int xfers = config->num_transfers;
+    struct bladerf_repeater *r;
+    unsigned int i;
+    int status;
+
+    *rep = NULL;
+
+    /* Both streams keep num_transfers buffers in flight, and at least one
+     * more is needed to hand off */
+    if (!BLADERF_CHANNEL_IS_TX(config->tx_channel) ||
+        BLADERF_CHANNEL_IS_TX(config->rx_channel) || xfers == 0 ||
+        config->num_buffers <= 2 * xfers || config->buffer_size == 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    r = calloc(1, sizeof(*r));
+    if (r == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    r->config   = *config;
+    r->rx_dev   = rx_dev;
+    r->tx_dev   = tx_dev;
+    r->msg_size = msg_size(rx_dev);
+
+    if (r->msg_size != msg_size(tx_dev) ||
+        (config->buffer_size * sizeof(int16_t) * 2) % r->msg_size != 0) {
+        free(r);
+        return BLADERF_ERR_INVAL;
+    }
+
+    r->free  = calloc(config->num_buffers, sizeof(r->free[0]));
+    r->ready = calloc(config->num_buffers, sizeof(r->ready[0]));
+    if (r->free == NULL || r->ready == NULL) {
+        free(r->free);
+        free(r->ready);
+        free(r);
+        return BLADERF_ERR_MEM;
+    }
+
+    MUTEX_INIT(&r->lock);
+    timeout_cond_init(&r->tx_started);
+
+    /* The TX stream's buffers join the pool, and are first filled by RX */
+    status = bladerf_init_stream(&r->rx_stream, rx_dev, rx_callback,
+                                 &r->rx_buffers, config->num_buffers - xfers,
+                                 BLADERF_FORMAT_SC16_Q11_META,
+                                 config->buffer_size, xfers, r);
+    if (status != 0) {
+        goto error;
+    }
+
+    status = bladerf_init_stream(&r->tx_stream, tx_dev, tx_callback,
+                                 &r->tx_buffers, xfers,
+                                 BLADERF_FORMAT_SC16_Q11_META,
+                                 config->buffer_size, xfers, r);
+    if (status != 0) {
+        goto error;
+    }
+
+    for (i = xfers; i < config->num_buffers - xfers; i++) {
+        r->free[r->num_free++] = r->rx_buffers[i];
+    }
+
+    for (i = 0; i < xfers; i++) {
+        r->free[r->num_free++] = r->tx_buffers[i];
+    }
+
+    /* TX is started first, so that it is ready for the first buffer */
+    status = bladerf_enable_module(tx_dev, config->tx_channel, true);
+    if (status != 0) {
+        goto error;
+    }
+    r->tx_enabled = true;
+
+    if (pthread_create(&r->tx_thread, NULL, tx_task, r) != 0) {
+        status = BLADERF_ERR_UNEXPECTED;
+        goto error;
+    }
+    r->tx_thread_running = true;
+
+    status = wait_tx_started(r);
+    if (status != 0) {
+        goto error;
+    }
+
+    status = bladerf_enable_module(rx_dev, config->rx_channel, true);
+    if (status != 0) {
+        goto error;
+    }
+    r->rx_enabled = true;
+
+    if (pthread_create(&r->rx_thread, NULL, rx_task, r) != 0) {
+        status = BLADERF_ERR_UNEXPECTED;
+        goto error;
+    }
+    r->rx_thread_running = true;
+
+    *rep = r;
+    return 0;
+
+error:
+    log_debug("%s: failed to start: %s\n", __FUNCTION__,
+              bladerf_strerror(status));
+    repeater_teardown(r);
+    return status;
+}
+
+int repeater_get_stats(struct bladerf_repeater *r,
+                       struct bladerf_repeater_stats *stats)
+{
+    int status;
+
+    MUTEX_LOCK(&r->lock);
+    *stats = r->stats;
+    status = (r->rx_status != 0) ? r->rx_status : r->tx_status;
+    MUTEX_UNLOCK(&r->lock);
+
+    return status;
+}
+
+int repeater_stop(struct bladerf_repeater *r)
+{
+    return repeater_teardown(r);
+}
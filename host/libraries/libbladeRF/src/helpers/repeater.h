@@ -0,0 +1,71 @@
+/**
+ * @file repeater.h
+ *
+ * @brief RX to TX repeater
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_REPEATER_H_
+#define HELPERS_REPEATER_H_
+
+#include <libbladeRF.h>
+
+/**
+ * Start a repeater, as described by bladerf_repeater_start()
+ *
+ * The caller must not hold either device's lock.
+ *
+ * @param[out]  rep     Updated with the repeater handle on success
+ * @param       rx_dev  Device to receive from
+ * @param       tx_dev  Device to transmit from. May be the same as rx_dev.
+ * @param[in]   config  Repeater configuration
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int repeater_start(struct bladerf_repeater **rep,
+                   struct bladerf *rx_dev,
+                   struct bladerf *tx_dev,
+                   const struct bladerf_repeater_config *config);
+
+/**
+ * Get a repeater's statistics
+ *
+ * @param       rep     Repeater handle
+ * @param[out]  stats   Updated with the repeater's statistics
+ *
+ * @return 0 on success, or the status of a stream that failed
+ */
+int repeater_get_stats(struct bladerf_repeater *rep,
+                       struct bladerf_repeater_stats *stats);
+
+/**
+ * Stop a repeater's streams and free it
+ *
+ * @param       rep     Repeater handle
+ *
+ * @return 0 on success, or the first failure encountered
+ */
+int repeater_stop(struct bladerf_repeater *rep);
+
+#endif
@@ -0,0 +1,536 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <inttypes.h>
+#include <math.h>
+#include <string.h>
+
+#include "log.h"
+#include "simd.h"
+
+#include "helpers/alloc.h"
+#include "helpers/resample.h"
+
+/* Filter taps at unity ratio or when interpolating. Decimation widens the
+ * filter by the decimation factor. This must be a multiple of 8, for the
+ * vector kernels. */
+#define RESAMPLE_TAPS 48
+
+/* Kaiser window shape, for about 68 dB of stopband attenuation */
+#define RESAMPLE_KAISER_BETA 6.8
+
+/* Transition band of the filter, in cycles per sample at the lower of the
+ * two rates. The stopband starts at that rate's Nyquist frequency. */
+#define RESAMPLE_TRANSITION (0.09 * 48 / RESAMPLE_TAPS)
+
+/* Largest denominator of the ratio, so that positions can't overflow */
+#define RESAMPLE_DEN_MAX (UINT64_C(1) << 62)
+
+/* Sums x * c0 and x * c1 over n floats of interleaved I/Q samples. The
+ * coefficients are duplicated for I and Q. out receives the I and Q sums
+ * against c0, followed by those against c1. */
+typedef void (*dot_fn)(const float *x, const float *c0, const float *c1,
+                       unsigned int n, float out[4]);
+
+struct resampler {
+    unsigned int channels;
+    unsigned int taps;
+    bool exact;
+
+    /* Input samples advanced per output sample: step_int + step_rem / den */
+    uint64_t step_int;
+    uint64_t step_rem;
+    uint64_t den;
+    double phase_scale;     /* RESAMPLE_PHASES / den */
+
+    /* Position of the next output sample: pos + acc / den. The filter
+     * applied to it spans history frames pos to pos + taps - 1, as history
+     * frame h holds input sample h - (taps / 2 - 1). */
+    uint64_t pos;
+    uint64_t acc;
+
+    /* RESAMPLE_PHASES + 1 rows of 2 * taps duplicated coefficients */
+    float *coeffs;
+
+    /* Per-channel interleaved I/Q history, holding frames base to
+     * base + len - 1 */
+    float *hist[2];
+    size_t cap;
+    size_t max_push;
+    uint64_t base;
+    size_t len;
+
+    dot_fn dot;
+};
+
+static void dot_scalar(const float *x, const float *c0, const float *c1,
+                       unsigned int n, float out[4])
+{
+    float a[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    unsigned int i;
+
+    for (i = 0; i < n; i += 2) {
+        a[0] += x[i] * c0[i];
+        a[1] += x[i + 1] * c0[i + 1];
+        a[2] += x[i] * c1[i];
+        a[3] += x[i + 1] * c1[i + 1];
+    }
+
+    memcpy(out, a, sizeof(a));
+}
+
+#ifdef SIMD_HAVE_SSE2
+static void dot_sse2(const float *x, const float *c0, const float *c1,
+                     unsigned int n, float out[4])
+{
+    __m128 a0 = _mm_setzero_ps();
+    __m128 a1 = _mm_setzero_ps();
+    unsigned int i;
+
+    /* 2 samples per iteration. Lanes 0 and 2 accumulate I, 1 and 3 Q. */
+    for (i = 0; i < n; i += 4) {
+        const __m128 v = _mm_loadu_ps(x + i);
+
+        a0 = _mm_add_ps(a0, _mm_mul_ps(v, _mm_loadu_ps(c0 + i)));
+        a1 = _mm_add_ps(a1, _mm_mul_ps(v, _mm_loadu_ps(c1 + i)));
+    }
+
+    a0 = _mm_add_ps(a0, _mm_movehl_ps(a0, a0));
+    a1 = _mm_add_ps(a1, _mm_movehl_ps(a1, a1));
+    _mm_storeu_ps(out, _mm_movelh_ps(a0, a1));
+}
+#endif
+
+#ifdef SIMD_HAVE_AVX2
+static SIMD_TARGET_AVX2 void dot_avx2(const float *x,
+                                      const float *c0,
+                                      const float *c1,
+                                      unsigned int n,
+                                      float out[4])
+{
+    __m256 a0 = _mm256_setzero_ps();
+    __m256 a1 = _mm256_setzero_ps();
+    __m128 s0, s1;
+    unsigned int i;
+
+    /* 4 samples per iteration */
+    for (i = 0; i < n; i += 8) {
+        const __m256 v = _mm256_loadu_ps(x + i);
+
+        a0 = _mm256_add_ps(a0, _mm256_mul_ps(v, _mm256_loadu_ps(c0 + i)));
+        a1 = _mm256_add_ps(a1, _mm256_mul_ps(v, _mm256_loadu_ps(c1 + i)));
+    }
+
+    s0 = _mm_add_ps(_mm256_castps256_ps128(a0), _mm256_extractf128_ps(a0, 1));
+    s1 = _mm_add_ps(_mm256_castps256_ps128(a1), _mm256_extractf128_ps(a1, 1));
+    s0 = _mm_add_ps(s0, _mm_movehl_ps(s0, s0));
+    s1 = _mm_add_ps(s1, _mm_movehl_ps(s1, s1));
+    _mm_storeu_ps(out, _mm_movelh_ps(s0, s1));
+}
+#endif
+
+#ifdef SIMD_HAVE_NEON
+static void dot_neon(const float *x, const float *c0, const float *c1,
+                     unsigned int n, float out[4])
+{
+    float32x4_t a0 = vdupq_n_f32(0.0f);
+    float32x4_t a1 = vdupq_n_f32(0.0f);
+    unsigned int i;
+
+    for (i = 0; i < n; i += 4) {
+        const float32x4_t v = vld1q_f32(x + i);
+
+        a0 = vmlaq_f32(a0, v, vld1q_f32(c0 + i));
+        a1 = vmlaq_f32(a1, v, vld1q_f32(c1 + i));
+    }
+
+    vst1q_f32(out, vcombine_f32(vadd_f32(vget_low_f32(a0), vget_high_f32(a0)),
+                                vadd_f32(vget_low_f32(a1), vget_high_f32(a1))));
+}
+#endif
+
+static dot_fn select_dot(void)
+{
+    dot_fn dot = dot_scalar;
+
+#if defined(SIMD_HAVE_NEON)
+    dot = dot_neon;
+#elif defined(SIMD_HAVE_SSE2)
+    dot = dot_sse2;
+#   ifdef SIMD_HAVE_AVX2
+    if (simd_have_avx2()) {
+        dot = dot_avx2;
+    }
+#   endif
+#endif
+
+    return dot;
+}
+
+static uint64_t gcd64(uint64_t a, uint64_t b)
+{
+    while (b != 0) {
+        const uint64_t t = a % b;
+        a = b;
+        b = t;
+    }
+
+    return a;
+}
+
+/* Set num / den to the closest fraction to x with den <= RESAMPLE_DEN_MAX,
+ * via its continued fraction expansion */
+static void approximate(long double x, uint64_t *num, uint64_t *den)
+{
+    uint64_t p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+    long double v = x;
+    unsigned int i;
+
+    for (i = 0; i < 64; i++) {
+        const uint64_t a = (uint64_t)v;
+        uint64_t p2, q2;
+
+        if (q1 != 0 && a > (RESAMPLE_DEN_MAX - q0) / q1) {
+            break;
+        }
+
+        p2 = a * p1 + p0;
+        q2 = a * q1 + q0;
+        p0 = p1; q0 = q1;
+        p1 = p2; q1 = q2;
+
+        if (v - a < 1e-18L) {
+            break;
+        }
+        v = 1.0L / (v - a);
+    }
+
+    *num = p1;
+    *den = q1;
+}
+
+/* Reduce (in_num / in_den) / (out_num / out_den) to num / den. Returns
+ * false if this had to be approximated. */
+static bool reduce_step(uint64_t in_num, uint64_t in_den, uint64_t out_num,
+                        uint64_t out_den, uint64_t *num, uint64_t *den)
+{
+    const uint64_t g1 = gcd64(in_num, out_num);
+    const uint64_t g2 = gcd64(in_den, out_den);
+    const uint64_t a  = in_num / g1;
+    const uint64_t b  = out_den / g2;
+    const uint64_t c  = in_den / g2;
+    const uint64_t d  = out_num / g1;
+
+    if ((b == 0 || a <= UINT64_MAX / b) && (d == 0 || c <= UINT64_MAX / d) &&
+        c * d <= RESAMPLE_DEN_MAX) {
+        *num = a * b;
+        *den = c * d;
+        return true;
+    }
+
+    approximate(((long double)a / c) * ((long double)b / d), num, den);
+    return false;
+}
+
+static double bessel_i0(double x)
+{
+    double sum  = 1.0;
+    double term = 1.0;
+    unsigned int k;
+
+    for (k = 1; k < 64 && term > 1e-12 * sum; k++) {
+        const double t = x / (2.0 * k);
+        term *= t * t;
+        sum += term;
+    }
+
+    return sum;
+}
+
+/* Compute the filter phases. Phase p is centered p / RESAMPLE_PHASES of an
+ * input sample past the filter's center tap. Each is normalized to unity
+ * gain at DC, so that the interpolation between phases is gain-neutral. */
+static void design(struct resampler *r, double cutoff)
+{
+    const double half   = r->taps / 2.0;
+    const double i0beta = bessel_i0(RESAMPLE_KAISER_BETA);
+    unsigned int p, k;
+
+    for (p = 0; p <= RESAMPLE_PHASES; p++) {
+        float *row = r->coeffs + (size_t)p * 2 * r->taps;
+        double sum = 0.0;
+
+        for (k = 0; k < r->taps; k++) {
+            /* Distance from input sample k of the window to the output */
+            const double t = (double)p / RESAMPLE_PHASES + half - 1.0 - k;
+            const double x = t / half;
+            const double w =
+                (x >= 1.0 || x <= -1.0)
+                    ? 0.0
+                    : bessel_i0(RESAMPLE_KAISER_BETA * sqrt(1.0 - x * x)) /
+                          i0beta;
+            const double arg = 2.0 * M_PI * cutoff * t;
+            const double h = (t == 0.0) ? 2.0 * cutoff
+                                        : sin(arg) / (M_PI * t);
+
+            row[2 * k] = (float)(h * w);
+            sum += h * w;
+        }
+
+        for (k = 0; k < r->taps; k++) {
+            row[2 * k]     = (float)(row[2 * k] / sum);
+            row[2 * k + 1] = row[2 * k];
+        }
+    }
+}
+
+struct resampler *resampler_create(uint64_t in_num,
+                                   uint64_t in_den,
+                                   uint64_t out_num,
+                                   uint64_t out_den,
+                                   unsigned int channels,
+                                   size_t max_push)
+{
+    struct resampler *r;
+    uint64_t num, den;
+    double ratio;
+    unsigned int i;
+
+    if (in_num == 0 || in_den == 0 || out_num == 0 || out_den == 0 ||
+        channels == 0 || channels > 2 || max_push == 0) {
+        return NULL;
+    }
+
+    r = alloc_calloc(1, sizeof(*r));
+    if (r == NULL) {
+        return NULL;
+    }
+
+    r->exact = reduce_step(in_num, in_den, out_num, out_den, &num, &den);
+    if (!r->exact) {
+        log_debug("%s: Ratio approximated as %" PRIu64 "/%" PRIu64 "\n",
+                  __FUNCTION__, num, den);
+    }
+
+    /* Output samples per input sample */
+    ratio = (double)den / (double)num;
+    if (ratio * RESAMPLE_DECIMATION_MAX < 1.0) {
+        log_debug("%s: Decimation by more than %u is not supported\n",
+                  __FUNCTION__, RESAMPLE_DECIMATION_MAX);
+        alloc_free(r);
+        return NULL;
+    }
+
+    r->channels    = channels;
+    r->step_int    = num / den;
+    r->step_rem    = num % den;
+    r->den         = den;
+    r->phase_scale = (double)RESAMPLE_PHASES / (double)den;
+    r->max_push    = max_push;
+
+    /* Widen the filter in proportion to any decimation, rounded up to a
+     * multiple of 8 taps */
+    r->taps = RESAMPLE_TAPS;
+    if (ratio < 1.0) {
+        r->taps = ((unsigned int)ceil(RESAMPLE_TAPS / ratio) + 7) & ~7u;
+    }
+
+    r->coeffs = alloc_calloc((size_t)(RESAMPLE_PHASES + 1) * 2 * r->taps,
+                             sizeof(float));
+    r->cap    = r->taps + max_push;
+
+    for (i = 0; i < channels; i++) {
+        r->hist[i] = alloc_calloc(2 * r->cap, sizeof(float));
+    }
+
+    if (r->coeffs == NULL || r->hist[0] == NULL ||
+        (channels == 2 && r->hist[1] == NULL)) {
+        resampler_destroy(r);
+        return NULL;
+    }
+
+    design(r, (ratio < 1.0 ? ratio : 1.0) * (0.5 - RESAMPLE_TRANSITION / 2));
+    r->dot = select_dot();
+    resampler_reset(r);
+
+    log_verbose("%s: step %" PRIu64 "/%" PRIu64 ", %u taps\n", __FUNCTION__,
+                num, den, r->taps);
+
+    return r;
+}
+
+void resampler_destroy(struct resampler *r)
+{
+    if (r != NULL) {
+        alloc_free(r->hist[0]);
+        alloc_free(r->hist[1]);
+        alloc_free(r->coeffs);
+        alloc_free(r);
+    }
+}
+
+void resampler_reset(struct resampler *r)
+{
+    unsigned int i;
+
+    /* Zeros precede input sample 0, up to the center of the filter */
+    r->pos  = 0;
+    r->acc  = 0;
+    r->base = 0;
+    r->len  = r->taps / 2 - 1;
+
+    for (i = 0; i < r->channels; i++) {
+        memset(r->hist[i], 0, 2 * r->len * sizeof(float));
+    }
+}
+
+bool resampler_is_exact(const struct resampler *r)
+{
+    return r->exact;
+}
+
+/* Discard the history frames that no output sample still needs */
+static void compact(struct resampler *r)
+{
+    const size_t drop = (size_t)(r->pos - r->base);
+    unsigned int i;
+
+    if (drop == 0) {
+        return;
+    }
+
+    if (drop >= r->len) {
+        r->base += r->len;
+        r->len = 0;
+        return;
+    }
+
+    for (i = 0; i < r->channels; i++) {
+        memmove(r->hist[i], r->hist[i] + 2 * drop,
+                2 * (r->len - drop) * sizeof(float));
+    }
+
+    r->base += drop;
+    r->len -= drop;
+}
+
+size_t resampler_space(struct resampler *r)
+{
+    size_t space;
+
+    if (r->cap - r->len < r->max_push) {
+        compact(r);
+    }
+
+    space = r->cap - r->len;
+    return (space < r->max_push) ? space : r->max_push;
+}
+
+size_t resampler_needed(const struct resampler *r, size_t n)
+{
+    const uint64_t end = r->base + r->len;
+    double last;
+    uint64_t need;
+
+    if (n == 0) {
+        return 0;
+    }
+
+    /* Position of the last output frame wanted, rounded up */
+    last = (double)(n - 1) *
+               ((double)r->step_int + (double)r->step_rem / (double)r->den) +
+           (double)r->acc / (double)r->den;
+    need = r->pos + (uint64_t)ceil(last) + r->taps;
+
+    return (need > end) ? (size_t)(need - end) : 0;
+}
+
+void resampler_push(struct resampler *r, const float *in, size_t n)
+{
+    size_t i;
+
+    if (r->channels == 1) {
+        memcpy(r->hist[0] + 2 * r->len, in, 2 * n * sizeof(float));
+    } else {
+        float *h0 = r->hist[0] + 2 * r->len;
+        float *h1 = r->hist[1] + 2 * r->len;
+
+        for (i = 0; i < n; i++) {
+            h0[2 * i]     = in[4 * i];
+            h0[2 * i + 1] = in[4 * i + 1];
+            h1[2 * i]     = in[4 * i + 2];
+            h1[2 * i + 1] = in[4 * i + 3];
+        }
+    }
+
+    r->len += n;
+}
+
+size_t resampler_pull(struct resampler *r, float *out, size_t n)
+{
+    const unsigned int len = 2 * r->taps;
+    const uint64_t end     = r->base + r->len;
+    size_t produced;
+    unsigned int i;
+
+    for (produced = 0; produced < n && r->pos + r->taps <= end; produced++) {
+        const double phase = (double)r->acc * r->phase_scale;
+        unsigned int p     = (unsigned int)phase;
+        const float *c0, *c1;
+        float mu;
+
+        if (p >= RESAMPLE_PHASES) {
+            p = RESAMPLE_PHASES - 1;
+        }
+
+        mu = (float)(phase - p);
+        c0 = r->coeffs + (size_t)p * len;
+        c1 = c0 + len;
+
+        for (i = 0; i < r->channels; i++) {
+            const float *x = r->hist[i] + 2 * (size_t)(r->pos - r->base);
+            float *y       = out + 2 * (produced * r->channels + i);
+            float s[4];
+
+            r->dot(x, c0, c1, len, s);
+            y[0] = s[0] + mu * (s[2] - s[0]);
+            y[1] = s[1] + mu * (s[3] - s[1]);
+        }
+
+        r->pos += r->step_int;
+        r->acc += r->step_rem;
+        if (r->acc >= r->den) {
+            r->acc -= r->den;
+            r->pos++;
+        }
+    }
+
+    return produced;
+}
+
+uint64_t resampler_position(const struct resampler *r, double *frac)
+{
+    if (frac != NULL) {
+        *frac = (double)r->acc / (double)r->den;
+    }
+
+    return r->pos;
+}
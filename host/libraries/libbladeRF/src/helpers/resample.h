@@ -0,0 +1,142 @@
+/**
+ * @file resample.h
+ *
+ * @brief Rational-rate polyphase resampler
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_RESAMPLE_H_
+#define HELPERS_RESAMPLE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Resamples complex float samples by an exact rational ratio.
+ *
+ * The position of each output sample in the input is tracked exactly, as an
+ * input index and a fraction of a common denominator, so the output rate
+ * does not drift. Each output sample is computed with a windowed-sinc filter
+ * centered upon that position, interpolated between the nearest two of
+ * RESAMPLE_PHASES precomputed filter phases.
+ *
+ * Output sample k after a reset is at input position k * in / out, where
+ * input sample 0 is the first pushed after that reset. Samples preceding
+ * input sample 0 are taken to be zero. */
+
+/* Filter phases per input sample */
+#define RESAMPLE_PHASES 128
+
+/* Decimation beyond this factor is not supported */
+#define RESAMPLE_DECIMATION_MAX 16
+
+struct resampler;
+
+/**
+ * Create a resampler
+ *
+ * @param[in]   in_num      Input rate numerator
+ * @param[in]   in_den      Input rate denominator
+ * @param[in]   out_num     Output rate numerator
+ * @param[in]   out_den     Output rate denominator
+ * @param[in]   channels    Channels interleaved in each frame, 1 or 2
+ * @param[in]   max_push    Largest number of frames pushed at once
+ *
+ * @return resampler on success, NULL on invalid parameters or allocation
+ *         failure
+ */
+struct resampler *resampler_create(uint64_t in_num,
+                                   uint64_t in_den,
+                                   uint64_t out_num,
+                                   uint64_t out_den,
+                                   unsigned int channels,
+                                   size_t max_push);
+
+/**
+ * Free a resampler
+ *
+ * @param       r       Resampler. NULL is ignored.
+ */
+void resampler_destroy(struct resampler *r);
+
+/**
+ * Discard all input, such that the next frame pushed is input sample 0
+ *
+ * @param       r       Resampler
+ */
+void resampler_reset(struct resampler *r);
+
+/**
+ * @return true if the ratio is exact, or false if it could not be
+ *         represented in 64 bits and is approximated
+ */
+bool resampler_is_exact(const struct resampler *r);
+
+/**
+ * @return the number of frames that may be pushed now, up to max_push
+ */
+size_t resampler_space(struct resampler *r);
+
+/**
+ * Estimate the input frames that must still be pushed to pull `n' frames
+ *
+ * @param       r       Resampler
+ * @param[in]   n       Output frames wanted
+ *
+ * @return input frames, which may exceed resampler_space()
+ */
+size_t resampler_needed(const struct resampler *r, size_t n);
+
+/**
+ * Append input frames
+ *
+ * @param       r       Resampler
+ * @param[in]   in      Interleaved I/Q frames
+ * @param[in]   n       Number of frames, no more than resampler_space()
+ */
+void resampler_push(struct resampler *r, const float *in, size_t n);
+
+/**
+ * Produce as many output frames as the input pushed allows
+ *
+ * @param       r       Resampler
+ * @param[out]  out     Interleaved I/Q frames
+ * @param[in]   n       Maximum number of frames
+ *
+ * @return number of frames produced
+ */
+size_t resampler_pull(struct resampler *r, float *out, size_t n);
+
+/**
+ * Position of the next output frame in the input
+ *
+ * @param       r       Resampler
+ * @param[out]  frac    Fraction of an input sample beyond the returned index.
+ *                      May be NULL.
+ *
+ * @return index of the input sample at or before the next output frame
+ */
+uint64_t resampler_position(const struct resampler *r, double *frac);
+
+#endif
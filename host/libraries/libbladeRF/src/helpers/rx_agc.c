@@ -0,0 +1,507 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "thread.h"
+
+#include "board/board.h"
+
+#include "helpers/ctrl_queue.h"
+#include "helpers/have_cap.h"
+#include "helpers/rx_agc.h"
+
+#define RX_AGC_CHANNELS 2
+
+/* Full-scale magnitude of an SC16 Q11 sample */
+#define RX_AGC_FULL_SCALE 2048.0
+
+typedef enum {
+    RX_AGC_IDLE,      /* Measuring */
+    RX_AGC_PENDING,   /* Change submitted to the control worker */
+    RX_AGC_SCHEDULED, /* Change queued by the device, for change_ts */
+} rx_agc_state;
+
+struct rx_agc;
+
+struct rx_agc_channel {
+    struct rx_agc *agc;
+    bladerf_channel ch;
+
+    bool enabled;
+    struct bladerf_rx_agc_config config;
+
+    /* Gain range, in dB */
+    float min_db;
+    float max_db;
+
+    /* Gain in effect */
+    bladerf_gain gain;
+
+    /* Change in flight, if any */
+    rx_agc_state state;
+    bladerf_gain next;
+    bool sched_op;
+    uint64_t change_ts;
+
+    /* An immediate change has been applied, and is yet to be reported */
+    bool applied;
+
+    /* Measurement of the current block */
+    uint64_t energy;
+    uint64_t count;
+    uint64_t settle_left;
+};
+
+struct rx_agc {
+    MUTEX lock;
+
+    /* Gain changes may be scheduled at a sample timestamp */
+    bool scheduled;
+
+    struct rx_agc_channel ch[RX_AGC_CHANNELS];
+};
+
+static inline size_t chan_idx(bladerf_channel ch)
+{
+    return (ch >> 1);
+}
+
+static bool valid_config(const struct bladerf_rx_agc_config *config)
+{
+    return isfinite(config->target_dbfs) && isfinite(config->deadband_db) &&
+           config->deadband_db >= 0.0f && isfinite(config->max_step_db) &&
+           config->max_step_db > 0.0f;
+}
+
+static void restart_block(struct rx_agc_channel *chan)
+{
+    chan->energy = 0;
+    chan->count  = 0;
+}
+
+/* Called on the control worker thread once a change has been performed */
+static void change_done(struct bladerf *dev,
+                        bladerf_ctrl_ticket ticket,
+                        int status,
+                        void *user_data)
+{
+    struct rx_agc_channel *chan = user_data;
+    struct rx_agc *agc          = chan->agc;
+
+    MUTEX_LOCK(&agc->lock);
+
+    if (chan->state != RX_AGC_PENDING) {
+        MUTEX_UNLOCK(&agc->lock);
+        return;
+    }
+
+    if (status != 0) {
+        log_debug("RX AGC gain change on channel %d failed: %s\n", chan->ch,
+                  bladerf_strerror(status));
+
+        /* Fall back to immediate changes, e.g. for an FPGA image or tuning
+         * mode that does not support scheduling them */
+        if (chan->sched_op && status == BLADERF_ERR_UNSUPPORTED) {
+            agc->scheduled = false;
+        }
+
+        chan->state = RX_AGC_IDLE;
+        restart_block(chan);
+    } else if (chan->sched_op) {
+        chan->state = RX_AGC_SCHEDULED;
+    } else {
+        chan->gain        = chan->next;
+        chan->applied     = true;
+        chan->settle_left = chan->config.settle_samples;
+        chan->state       = RX_AGC_IDLE;
+        restart_block(chan);
+    }
+
+    MUTEX_UNLOCK(&agc->lock);
+}
+
+int rx_agc_configure(struct bladerf *dev,
+                     bladerf_channel ch,
+                     const struct bladerf_rx_agc_config *config)
+{
+    struct bladerf_range const *range = NULL;
+    struct rx_agc_channel *chan;
+    struct rx_agc *agc;
+    bladerf_gain gain;
+    uint64_t caps;
+    int status;
+
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_RX(1)) {
+        log_debug("%s: Invalid channel: %d\n", __FUNCTION__, ch);
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (config == NULL) {
+        agc = dev->rx_agc;
+        if (agc != NULL) {
+            MUTEX_LOCK(&agc->lock);
+            agc->ch[chan_idx(ch)].enabled = false;
+            MUTEX_UNLOCK(&agc->lock);
+        }
+
+        return 0;
+    }
+
+    if (!valid_config(config)) {
+        log_debug("%s: Invalid AGC configuration\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    status = bladerf_get_gain_range(dev, ch, &range);
+    if (status != 0) {
+        return status;
+    }
+
+    status = bladerf_set_gain_mode(dev, ch, BLADERF_GAIN_MGC);
+    if (status != 0) {
+        return status;
+    }
+
+    status = bladerf_get_gain(dev, ch, &gain);
+    if (status != 0) {
+        return status;
+    }
+
+    /* The state persists until the device is closed, as it is read by the
+     * sync interfaces */
+    MUTEX_LOCK(&dev->lock);
+
+    if (dev->rx_agc == NULL) {
+        size_t i;
+
+        agc = calloc(1, sizeof(*agc));
+        if (agc == NULL) {
+            MUTEX_UNLOCK(&dev->lock);
+            return BLADERF_ERR_MEM;
+        }
+
+        MUTEX_INIT(&agc->lock);
+
+        for (i = 0; i < RX_AGC_CHANNELS; i++) {
+            agc->ch[i].agc = agc;
+            agc->ch[i].ch  = BLADERF_CHANNEL_RX(i);
+        }
+
+        dev->rx_agc = agc;
+    }
+
+    agc  = dev->rx_agc;
+    caps = dev->board->get_capabilities(dev);
+
+    MUTEX_UNLOCK(&dev->lock);
+
+    chan = &agc->ch[chan_idx(ch)];
+
+    MUTEX_LOCK(&agc->lock);
+
+    agc->scheduled = have_cap(caps, BLADERF_CAP_FPGA_SCHEDULED_PARAMS) ||
+                     have_cap(caps, BLADERF_CAP_FPGA_RETUNE_GAIN);
+
+    chan->config = *config;
+    if (chan->config.block_samples == 0) {
+        chan->config.block_samples = BLADERF_RX_AGC_BLOCK_DEFAULT;
+    }
+    if (chan->config.lead_samples == 0) {
+        chan->config.lead_samples = BLADERF_RX_AGC_LEAD_DEFAULT;
+    }
+
+    chan->min_db = range->min * range->scale;
+    chan->max_db = range->max * range->scale;
+
+    /* A change already in flight is accounted for when it completes */
+    if (chan->state == RX_AGC_IDLE) {
+        chan->gain = gain;
+    }
+
+    chan->applied     = false;
+    chan->settle_left = 0;
+    restart_block(chan);
+
+    chan->enabled = true;
+
+    MUTEX_UNLOCK(&agc->lock);
+
+    return 0;
+}
+
+/* Channels regulated via each position within a stream. Must be called
+ * with the AGC lock held. */
+static size_t stream_channels(struct rx_agc *agc,
+                              bladerf_channel_layout layout,
+                              struct rx_agc_channel *chans[2])
+{
+    size_t i;
+
+    chans[0] = NULL;
+    chans[1] = NULL;
+
+    if (layout == BLADERF_RX_X2) {
+        for (i = 0; i < RX_AGC_CHANNELS; i++) {
+            if (agc->ch[i].enabled) {
+                chans[i] = &agc->ch[i];
+            }
+        }
+
+        return 2;
+    }
+
+    for (i = 0; i < RX_AGC_CHANNELS; i++) {
+        if (agc->ch[i].enabled) {
+            chans[0] = &agc->ch[i];
+            break;
+        }
+    }
+
+    return 1;
+}
+
+bool rx_agc_get_rx(struct bladerf *dev, bladerf_channel_layout layout)
+{
+    struct rx_agc *agc = dev->rx_agc;
+    struct rx_agc_channel *chans[2];
+    bool enabled;
+
+    if (agc == NULL || (layout & BLADERF_DIRECTION_MASK) != BLADERF_RX) {
+        return false;
+    }
+
+    MUTEX_LOCK(&agc->lock);
+    stream_channels(agc, layout, chans);
+    enabled = (chans[0] != NULL || chans[1] != NULL);
+    MUTEX_UNLOCK(&agc->lock);
+
+    return enabled;
+}
+
+/* Account for the completion of a scheduled change, returning the gain in
+ * effect for the first sample provided. Returns true if the samples
+ * provided are not to be measured. */
+static bool check_scheduled(struct rx_agc_channel *chan,
+                            uint64_t timestamp,
+                            uint64_t span,
+                            bladerf_gain *reported,
+                            bool *changed)
+{
+    uint64_t elapsed;
+
+    *reported = chan->gain;
+
+    if (chan->state != RX_AGC_SCHEDULED) {
+        return chan->state != RX_AGC_IDLE;
+    }
+
+    if (timestamp != 0 && chan->change_ts >= timestamp + span) {
+        /* Not yet reached */
+        return true;
+    }
+
+    if (timestamp == 0 || chan->change_ts <= timestamp) {
+        /* Took effect before the first sample */
+        *reported         = chan->next;
+        chan->settle_left = chan->config.settle_samples;
+        elapsed           = 0;
+    } else {
+        elapsed = timestamp + span - chan->change_ts;
+    }
+
+    *changed    = true;
+    chan->gain  = chan->next;
+    chan->state = RX_AGC_IDLE;
+    restart_block(chan);
+
+    if (elapsed == 0) {
+        return false;
+    }
+
+    /* The samples straddle the change */
+    chan->settle_left = (chan->config.settle_samples > elapsed)
+                            ? chan->config.settle_samples - elapsed
+                            : 0;
+    return true;
+}
+
+/* Compute the change for a completed block, if any. Returns true if op has
+ * been filled in. */
+static bool compute_change(struct rx_agc *agc,
+                           struct rx_agc_channel *chan,
+                           uint64_t timestamp,
+                           uint64_t span,
+                           struct ctrl_op *op)
+{
+    const struct bladerf_rx_agc_config *cfg = &chan->config;
+    double mean, level, error, step, target;
+    bladerf_gain next;
+
+    mean = (double)chan->energy / (double)chan->count;
+    restart_block(chan);
+
+    if (mean > 0.0) {
+        level = 10.0 * log10(mean / (RX_AGC_FULL_SCALE * RX_AGC_FULL_SCALE));
+        error = cfg->target_dbfs - level;
+    } else {
+        error = cfg->max_step_db;
+    }
+
+    if (fabs(error) <= cfg->deadband_db) {
+        return false;
+    }
+
+    step   = fmax(-cfg->max_step_db, fmin(cfg->max_step_db, error));
+    target = fmax(chan->min_db, fmin(chan->max_db, chan->gain + step));
+    next   = (bladerf_gain)lround(target);
+
+    if (next == chan->gain) {
+        return false;
+    }
+
+    memset(op, 0, sizeof(*op));
+    op->ch        = chan->ch;
+    op->cb        = change_done;
+    op->user_data = chan;
+
+    if (agc->scheduled && timestamp != 0) {
+        op->type = CTRL_OP_SCHEDULE_GAIN;
+        op->params.sched_gain.timestamp = timestamp + span + cfg->lead_samples;
+        op->params.sched_gain.gain      = next;
+
+        chan->change_ts = op->params.sched_gain.timestamp;
+        chan->sched_op  = true;
+    } else {
+        op->type        = CTRL_OP_SET_GAIN;
+        op->params.gain = next;
+        chan->sched_op  = false;
+    }
+
+    chan->next  = next;
+    chan->state = RX_AGC_PENDING;
+
+    return true;
+}
+
+void rx_agc_update(struct bladerf *dev,
+                   bladerf_channel_layout layout,
+                   const uint64_t energy[2],
+                   const uint64_t count[2],
+                   uint64_t timestamp,
+                   uint64_t span,
+                   struct bladerf_metadata *meta)
+{
+    struct rx_agc *agc = dev->rx_agc;
+    struct rx_agc_channel *chans[2];
+    struct ctrl_op ops[2];
+    bool submit[2] = { false, false };
+    size_t n, i;
+    int status;
+
+    if (agc == NULL) {
+        return;
+    }
+
+    MUTEX_LOCK(&agc->lock);
+
+    n = stream_channels(agc, layout, chans);
+
+    for (i = 0; i < n; i++) {
+        struct rx_agc_channel *chan = chans[i];
+        bladerf_gain reported;
+        bool changed = false;
+        bool skip;
+
+        if (chan == NULL) {
+            continue;
+        }
+
+        skip = check_scheduled(chan, timestamp, span, &reported, &changed);
+
+        if (chan->applied) {
+            chan->applied = false;
+            changed       = true;
+        }
+
+        if (meta != NULL) {
+            meta->rx_gain[i] = reported;
+            if (changed) {
+                meta->status |= BLADERF_META_STATUS_GAIN_CHANGE;
+            }
+        }
+
+        if (skip || count[i] == 0) {
+            continue;
+        }
+
+        /* Measurement resumes once the change has settled */
+        if (chan->settle_left > 0) {
+            chan->settle_left -= (chan->settle_left < count[i])
+                                     ? chan->settle_left
+                                     : count[i];
+            continue;
+        }
+
+        chan->energy += energy[i];
+        chan->count += count[i];
+
+        if (chan->count >= chan->config.block_samples) {
+            submit[i] = compute_change(agc, chan, timestamp, span, &ops[i]);
+        }
+    }
+
+    MUTEX_UNLOCK(&agc->lock);
+
+    /* Submitted without the AGC lock held, which the completion callback
+     * takes */
+    for (i = 0; i < n; i++) {
+        if (!submit[i]) {
+            continue;
+        }
+
+        status = ctrl_queue_submit(dev, &ops[i], NULL);
+        if (status != 0) {
+            log_debug("Failed to submit RX AGC gain change: %s\n",
+                      bladerf_strerror(status));
+
+            MUTEX_LOCK(&agc->lock);
+            chans[i]->state = RX_AGC_IDLE;
+            MUTEX_UNLOCK(&agc->lock);
+        }
+    }
+}
+
+void rx_agc_deinit(struct bladerf *dev)
+{
+    struct rx_agc *agc = dev->rx_agc;
+
+    if (agc == NULL) {
+        return;
+    }
+
+    MUTEX_DESTROY(&agc->lock);
+    free(agc);
+    dev->rx_agc = NULL;
+}
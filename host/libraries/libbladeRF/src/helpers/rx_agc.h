@@ -0,0 +1,94 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_RX_AGC_H_
+#define HELPERS_RX_AGC_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+/**
+ * Enable, reconfigure, or disable the host-side AGC for an RX channel, as
+ * described by bladerf_set_rx_agc(). The caller must not hold the device's
+ * handle lock.
+ *
+ * @param       dev     Device handle
+ * @param[in]   ch      RX channel
+ * @param[in]   config  Configuration, or NULL to disable the AGC
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int rx_agc_configure(struct bladerf *dev,
+                     bladerf_channel ch,
+                     const struct bladerf_rx_agc_config *config);
+
+/**
+ * Check whether any of an RX stream's channels have the AGC enabled, at the
+ * start of an RX call. This may be called without the device's handle lock
+ * held.
+ *
+ * @param       dev         Device handle
+ * @param[in]   layout      Stream layout
+ *
+ * @return true if the samples provided by the call are to be measured
+ */
+bool rx_agc_get_rx(struct bladerf *dev, bladerf_channel_layout layout);
+
+/**
+ * Account for the samples provided by an RX call, submitting a gain change
+ * once enough have been measured, and report the gain in effect to the
+ * caller. This may be called without the device's handle lock held.
+ *
+ * @param       dev         Device handle
+ * @param[in]   layout      Stream layout
+ * @param[in]   energy      Sum of I^2 + Q^2 of the samples measured,
+ *                          indexed by the position of a channel's samples
+ *                          within the stream
+ * @param[in]   count       Number of samples measured, indexed likewise
+ * @param[in]   timestamp   Timestamp of the first sample provided, or 0 if
+ *                          the stream does not carry timestamps
+ * @param[in]   span        Number of timestamp ticks the provided samples
+ *                          cover
+ * @param[inout] meta       Caller's metadata, or NULL. Its rx_gain and
+ *                          status fields are updated.
+ */
+void rx_agc_update(struct bladerf *dev,
+                   bladerf_channel_layout layout,
+                   const uint64_t energy[2],
+                   const uint64_t count[2],
+                   uint64_t timestamp,
+                   uint64_t span,
+                   struct bladerf_metadata *meta);
+
+/**
+ * Free the AGC state
+ *
+ * This must be called after the control worker has been stopped, as
+ * changes in flight refer to this state, and after the sync interfaces have
+ * been deinitialized.
+ *
+ * @param       dev         Device handle
+ */
+void rx_agc_deinit(struct bladerf *dev);
+
+#endif
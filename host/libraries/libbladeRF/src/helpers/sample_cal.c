@@ -0,0 +1,307 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "sample_convert.h"
+
+#include "board/board.h"
+#include "helpers/sample_cal.h"
+
+#define DEG_TO_RAD (3.14159265358979f / 180.0f)
+
+/* Indexed by RX channel number */
+#define SAMPLE_CAL_CHANNELS 2
+
+struct sample_cal_channel {
+    /* Protected by the device's handle lock */
+    struct bladerf_rx_sample_cal_entry *entries;
+    unsigned int num_entries;
+
+    /* Protected by sample_cal.lock, as these are read by the RX sync
+     * interface */
+    bool enabled;
+    float coeffs[4];
+};
+
+struct sample_cal {
+    MUTEX lock;
+    struct sample_cal_channel ch[SAMPLE_CAL_CHANNELS];
+};
+
+static const float identity[4] = {
+    1.0f / SC16Q11_SCALE, 0.0f, 0.0f, 1.0f / SC16Q11_SCALE
+};
+
+static bool valid_tbl(const struct bladerf_rx_sample_cal_entry *entries,
+                      unsigned int num_entries)
+{
+    unsigned int i;
+
+    if (num_entries == 0 || num_entries > BLADERF_RX_SAMPLE_CAL_MAX_ENTRIES) {
+        log_debug("Invalid RX sample calibration table length: %u\n",
+                  num_entries);
+        return false;
+    }
+
+    for (i = 0; i < num_entries; i++) {
+        if (!(entries[i].iq_gain > 0.0f) ||
+            !(fabsf(entries[i].iq_phase) < 90.0f) ||
+            !isfinite(entries[i].gain_db)) {
+            log_debug("Invalid RX sample calibration entry %u\n", i);
+            return false;
+        }
+
+        if (i > 0 && entries[i].frequency <= entries[i - 1].frequency) {
+            log_debug("RX sample calibration entries are not sorted\n");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Interpolate the table's values at the specified frequency */
+static void lookup(const struct sample_cal_channel *chan,
+                   bladerf_frequency frequency,
+                   struct bladerf_rx_sample_cal_entry *out)
+{
+    const struct bladerf_rx_sample_cal_entry *lo, *hi;
+    unsigned int low, high, mid;
+    float t;
+
+    if (frequency <= chan->entries[0].frequency) {
+        *out = chan->entries[0];
+        return;
+    }
+
+    if (frequency >= chan->entries[chan->num_entries - 1].frequency) {
+        *out = chan->entries[chan->num_entries - 1];
+        return;
+    }
+
+    low  = 0;
+    high = chan->num_entries - 1;
+
+    while (high - low > 1) {
+        mid = low + (high - low) / 2;
+
+        if (chan->entries[mid].frequency <= frequency) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    lo = &chan->entries[low];
+    hi = &chan->entries[high];
+    t  = (float)(frequency - lo->frequency) /
+        (float)(hi->frequency - lo->frequency);
+
+    out->frequency = frequency;
+    out->gain_db   = lo->gain_db + t * (hi->gain_db - lo->gain_db);
+    out->iq_gain   = lo->iq_gain + t * (hi->iq_gain - lo->iq_gain);
+    out->iq_phase  = lo->iq_phase + t * (hi->iq_phase - lo->iq_phase);
+}
+
+/* The received Q is modeled as iq_gain * (Q cos(phase) + I sin(phase)).
+ * Invert that, and scale by the inverse of the gain. */
+static void compute_coeffs(const struct bladerf_rx_sample_cal_entry *e,
+                           int gain,
+                           float coeffs[4])
+{
+    const float phase = e->iq_phase * DEG_TO_RAD;
+    const float scale = powf(10.0f, -((float)gain + e->gain_db) / 20.0f) /
+                        SC16Q11_SCALE;
+
+    coeffs[0] = scale;
+    coeffs[1] = 0.0f;
+    coeffs[2] = -scale * tanf(phase);
+    coeffs[3] = scale / (e->iq_gain * cosf(phase));
+}
+
+int sample_cal_set(struct bladerf *dev,
+                   bladerf_channel ch,
+                   const struct bladerf_rx_sample_cal_entry *entries,
+                   unsigned int num_entries)
+{
+    struct sample_cal *c = dev->sample_cal;
+    struct bladerf_rx_sample_cal_entry *copy = NULL;
+    struct sample_cal_channel *chan;
+    int status;
+
+    if (BLADERF_CHANNEL_IS_TX(ch) || (ch >> 1) >= SAMPLE_CAL_CHANNELS) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (entries != NULL) {
+        if (!valid_tbl(entries, num_entries)) {
+            return BLADERF_ERR_INVAL;
+        }
+
+        copy = malloc(num_entries * sizeof(copy[0]));
+        if (copy == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+
+        memcpy(copy, entries, num_entries * sizeof(copy[0]));
+    }
+
+    if (c == NULL) {
+        if (copy == NULL) {
+            return 0;
+        }
+
+        c = calloc(1, sizeof(*c));
+        if (c == NULL) {
+            free(copy);
+            return BLADERF_ERR_MEM;
+        }
+
+        MUTEX_INIT(&c->lock);
+        dev->sample_cal = c;
+    }
+
+    chan = &c->ch[ch >> 1];
+
+    MUTEX_LOCK(&c->lock);
+    chan->enabled = false;
+    MUTEX_UNLOCK(&c->lock);
+
+    free(chan->entries);
+    chan->entries     = copy;
+    chan->num_entries = (copy != NULL) ? num_entries : 0;
+
+    status = sample_cal_update(dev, ch);
+    if (status != 0) {
+        free(chan->entries);
+        chan->entries     = NULL;
+        chan->num_entries = 0;
+    }
+
+    return status;
+}
+
+int sample_cal_update(struct bladerf *dev, bladerf_channel ch)
+{
+    struct sample_cal *c = dev->sample_cal;
+    struct sample_cal_channel *chan;
+    struct bladerf_rx_sample_cal_entry e;
+    bladerf_frequency frequency;
+    float coeffs[4];
+    int gain;
+    int status;
+
+    if (c == NULL || BLADERF_CHANNEL_IS_TX(ch) ||
+        (ch >> 1) >= SAMPLE_CAL_CHANNELS) {
+        return 0;
+    }
+
+    chan = &c->ch[ch >> 1];
+    if (chan->entries == NULL) {
+        return 0;
+    }
+
+    status = dev->board->get_frequency(dev, ch, &frequency);
+    if (status != 0) {
+        return status;
+    }
+
+    status = dev->board->get_gain(dev, ch, &gain);
+    if (status != 0) {
+        return status;
+    }
+
+    lookup(chan, frequency, &e);
+    compute_coeffs(&e, gain, coeffs);
+
+    log_verbose("%s: ch %d: %" PRIu64 " Hz, gain %d dB + %.2f dB, "
+                "iq_gain %.4f, iq_phase %.3f\n", __FUNCTION__, ch, frequency,
+                gain, e.gain_db, e.iq_gain, e.iq_phase);
+
+    MUTEX_LOCK(&c->lock);
+    memcpy(chan->coeffs, coeffs, sizeof(coeffs));
+    chan->enabled = true;
+    MUTEX_UNLOCK(&c->lock);
+
+    return 0;
+}
+
+bool sample_cal_get_rx(struct bladerf *dev,
+                       bladerf_channel_layout layout,
+                       float coeffs[2][4])
+{
+    struct sample_cal *c = dev->sample_cal;
+    bool enabled = false;
+    size_t i;
+
+    if (c == NULL || (layout & BLADERF_DIRECTION_MASK) != BLADERF_RX) {
+        return false;
+    }
+
+    MUTEX_LOCK(&c->lock);
+
+    if (layout == BLADERF_RX_X2) {
+        for (i = 0; i < SAMPLE_CAL_CHANNELS; i++) {
+            const struct sample_cal_channel *chan = &c->ch[i];
+
+            memcpy(coeffs[i], chan->enabled ? chan->coeffs : identity,
+                   sizeof(coeffs[i]));
+            enabled = enabled || chan->enabled;
+        }
+    } else {
+        for (i = 0; i < SAMPLE_CAL_CHANNELS && !enabled; i++) {
+            if (c->ch[i].enabled) {
+                memcpy(coeffs[0], c->ch[i].coeffs, sizeof(coeffs[0]));
+                memcpy(coeffs[1], c->ch[i].coeffs, sizeof(coeffs[1]));
+                enabled = true;
+            }
+        }
+    }
+
+    MUTEX_UNLOCK(&c->lock);
+
+    return enabled;
+}
+
+void sample_cal_deinit(struct bladerf *dev)
+{
+    struct sample_cal *c = dev->sample_cal;
+    size_t i;
+
+    if (c == NULL) {
+        return;
+    }
+
+    for (i = 0; i < SAMPLE_CAL_CHANNELS; i++) {
+        free(c->ch[i].entries);
+    }
+
+    MUTEX_DESTROY(&c->lock);
+
+    free(c);
+    dev->sample_cal = NULL;
+}
@@ -0,0 +1,85 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+#ifndef HELPERS_SAMPLE_CAL_H_
+#define HELPERS_SAMPLE_CAL_H_
+
+#include <stdbool.h>
+
+#include <libbladeRF.h>
+
+/**
+ * Load or unload a channel's RX sample calibration table. Must be called
+ * with the device's handle lock held.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          RX channel
+ * @param[in]   entries     Table entries, or NULL to unload the table
+ * @param[in]   num_entries Number of entries
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int sample_cal_set(struct bladerf *dev,
+                   bladerf_channel ch,
+                   const struct bladerf_rx_sample_cal_entry *entries,
+                   unsigned int num_entries);
+
+/**
+ * Recompute a channel's correction for its current frequency and gain,
+ * following a change to either. Must be called with the device's handle lock
+ * held.
+ *
+ * This is a no-op if no table is loaded for the channel.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int sample_cal_update(struct bladerf *dev, bladerf_channel ch);
+
+/**
+ * Obtain the correction coefficients for an RX stream, in the form used by
+ * sc16q11_to_float_corr(). This may be called without the device's
+ * handle lock held.
+ *
+ * @param       dev         Device handle
+ * @param[in]   layout      Stream layout
+ * @param[out]  coeffs      Coefficients of each of the stream's channels,
+ *                          in the order in which their samples are
+ *                          interleaved. Both are those of the single
+ *                          channel of a ::BLADERF_RX_X1 stream.
+ *
+ * @return true if a correction is to be applied, false otherwise
+ */
+bool sample_cal_get_rx(struct bladerf *dev,
+                       bladerf_channel_layout layout,
+                       float coeffs[2][4]);
+
+/**
+ * Free any loaded tables
+ *
+ * @param       dev         Device handle
+ */
+void sample_cal_deinit(struct bladerf *dev);
+
+#endif
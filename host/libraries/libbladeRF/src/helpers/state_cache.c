@@ -0,0 +1,181 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <string.h>
+
+#include "helpers/state_cache.h"
+
+#define ITEM_BIT(item_) (((uint32_t)1) << (item_))
+
+/* Items that a retune changes */
+#define RETUNE_ITEMS \
+    (ITEM_BIT(STATE_CACHE_FREQUENCY) | ITEM_BIT(STATE_CACHE_GAIN))
+
+static inline bool channel_valid(bladerf_channel ch)
+{
+    return ch >= 0 && ch < STATE_CACHE_CHANNELS;
+}
+
+/* Channels sharing a direction share an LO, a retune queue and an analog
+ * filter */
+static void invalidate_direction(struct state_cache *cache,
+                                 bladerf_channel ch,
+                                 uint32_t items)
+{
+    bladerf_channel i;
+
+    for (i = (ch & BLADERF_DIRECTION_MASK); i < STATE_CACHE_CHANNELS; i += 2) {
+        cache->entry[i].valid &= ~items;
+    }
+}
+
+static void invalidate_all(struct state_cache *cache, uint32_t items)
+{
+    size_t i;
+
+    for (i = 0; i < STATE_CACHE_CHANNELS; i++) {
+        cache->entry[i].valid &= ~items;
+    }
+}
+
+bool state_cache_lookup(const struct state_cache *cache,
+                        bladerf_channel ch,
+                        enum state_cache_item item,
+                        int64_t *value)
+{
+    const struct state_cache_entry *e;
+
+    if (cache->disabled || !channel_valid(ch)) {
+        return false;
+    }
+
+    e = &cache->entry[ch];
+    if ((e->valid & ITEM_BIT(item)) == 0) {
+        return false;
+    }
+
+    *value = e->value[item];
+    return true;
+}
+
+void state_cache_fill(struct state_cache *cache,
+                      bladerf_channel ch,
+                      enum state_cache_item item,
+                      int64_t value)
+{
+    struct state_cache_entry *e;
+
+    if (cache->disabled || !channel_valid(ch)) {
+        return;
+    }
+
+    e = &cache->entry[ch];
+    if (e->retune_pending && (ITEM_BIT(item) & RETUNE_ITEMS) != 0) {
+        return;
+    }
+
+    e->value[item] = value;
+    e->valid |= ITEM_BIT(item);
+}
+
+void state_cache_invalidate(struct state_cache *cache,
+                            bladerf_channel ch,
+                            enum state_cache_item item)
+{
+    if (!channel_valid(ch)) {
+        state_cache_flush(cache);
+        return;
+    }
+
+    switch (item) {
+        case STATE_CACHE_FREQUENCY:
+            /* Gain tables are frequency-dependent */
+            invalidate_direction(cache, ch, RETUNE_ITEMS);
+            break;
+
+        case STATE_CACHE_GAIN:
+            cache->entry[ch].valid &= ~ITEM_BIT(STATE_CACHE_GAIN);
+            break;
+
+        case STATE_CACHE_GAIN_MODE:
+            cache->entry[ch].valid &= ~(ITEM_BIT(STATE_CACHE_GAIN_MODE) |
+                                        ITEM_BIT(STATE_CACHE_GAIN));
+            break;
+
+        case STATE_CACHE_SAMPLE_RATE:
+            /* RX and TX rates may be coupled, and the rate may constrain
+             * the bandwidth */
+            invalidate_all(cache, ITEM_BIT(STATE_CACHE_SAMPLE_RATE) |
+                                      ITEM_BIT(STATE_CACHE_BANDWIDTH));
+            break;
+
+        case STATE_CACHE_BANDWIDTH:
+            invalidate_direction(cache, ch, ITEM_BIT(STATE_CACHE_BANDWIDTH));
+            break;
+
+        default:
+            state_cache_flush(cache);
+            break;
+    }
+}
+
+void state_cache_retune_scheduled(struct state_cache *cache,
+                                  bladerf_channel ch)
+{
+    bladerf_channel i;
+
+    if (!channel_valid(ch)) {
+        state_cache_flush(cache);
+        return;
+    }
+
+    for (i = (ch & BLADERF_DIRECTION_MASK); i < STATE_CACHE_CHANNELS; i += 2) {
+        cache->entry[i].valid &= ~RETUNE_ITEMS;
+        cache->entry[i].retune_pending = true;
+    }
+}
+
+void state_cache_retunes_cancelled(struct state_cache *cache,
+                                   bladerf_channel ch)
+{
+    bladerf_channel i;
+
+    if (!channel_valid(ch)) {
+        return;
+    }
+
+    for (i = (ch & BLADERF_DIRECTION_MASK); i < STATE_CACHE_CHANNELS; i += 2) {
+        cache->entry[i].retune_pending = false;
+    }
+}
+
+void state_cache_flush(struct state_cache *cache)
+{
+    invalidate_all(cache, ~((uint32_t)0));
+}
+
+void state_cache_reset(struct state_cache *cache)
+{
+    const bool disabled = cache->disabled;
+
+    memset(cache, 0, sizeof(*cache));
+    cache->disabled = disabled;
+}
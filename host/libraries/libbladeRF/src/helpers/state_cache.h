@@ -0,0 +1,152 @@
+/**
+ * @file state_cache.h
+ *
+ * @brief Host-side cache of device state returned by the getters
+ *
+ * Frequency, gain, gain mode, sample rate and bandwidth are cached per
+ * channel so that repeated getter calls need not go to the device. Entries
+ * are filled from the values the board reports, and are invalidated by any
+ * operation that may change them.
+ *
+ * Frequency and gain are never cached for a channel with scheduled retunes
+ * outstanding, as the host is not told when these complete.
+ *
+ * All functions must be called with the device's handle lock held.
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_STATE_CACHE_H_
+#define HELPERS_STATE_CACHE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+/* Number of channels for which state is cached */
+#define STATE_CACHE_CHANNELS 4
+
+enum state_cache_item {
+    STATE_CACHE_FREQUENCY = 0,
+    STATE_CACHE_GAIN,
+    STATE_CACHE_GAIN_MODE,
+    STATE_CACHE_SAMPLE_RATE,
+    STATE_CACHE_BANDWIDTH,
+    STATE_CACHE_NUM_ITEMS,
+};
+
+struct state_cache_entry {
+    uint32_t valid; /* Bitmask of (1 << state_cache_item) */
+    int64_t value[STATE_CACHE_NUM_ITEMS];
+
+    /* Scheduled retunes may be outstanding */
+    bool retune_pending;
+};
+
+/* Zero-initialized state is an empty, enabled cache */
+struct state_cache {
+    bool disabled;
+    struct state_cache_entry entry[STATE_CACHE_CHANNELS];
+};
+
+/**
+ * Look up a cached value
+ *
+ * @param       cache   Cache
+ * @param[in]   ch      Channel
+ * @param[in]   item    Item to look up
+ * @param[out]  value   Cached value
+ *
+ * @return true if the value was cached, false otherwise
+ */
+bool state_cache_lookup(const struct state_cache *cache,
+                        bladerf_channel ch,
+                        enum state_cache_item item,
+                        int64_t *value);
+
+/**
+ * Record a value read from, or applied to, the device. This is a no-op if
+ * the cache is disabled or the item cannot currently be cached.
+ *
+ * @param       cache   Cache
+ * @param[in]   ch      Channel
+ * @param[in]   item    Item to record
+ * @param[in]   value   Value
+ */
+void state_cache_fill(struct state_cache *cache,
+                      bladerf_channel ch,
+                      enum state_cache_item item,
+                      int64_t value);
+
+/**
+ * Invalidate an item, along with any items a change to it may affect. For
+ * example, a sample rate change invalidates the sample rate and bandwidth of
+ * every channel, as the RX and TX rates may be coupled.
+ *
+ * @param       cache   Cache
+ * @param[in]   ch      Channel
+ * @param[in]   item    Item that is changing
+ */
+void state_cache_invalidate(struct state_cache *cache,
+                            bladerf_channel ch,
+                            enum state_cache_item item);
+
+/**
+ * Note that retunes have been scheduled for a channel. This invalidates the
+ * frequency and gain of each channel in its direction, and stops them being
+ * cached until state_cache_retunes_cancelled() or state_cache_reset().
+ *
+ * @param       cache   Cache
+ * @param[in]   ch      Channel
+ */
+void state_cache_retune_scheduled(struct state_cache *cache,
+                                  bladerf_channel ch);
+
+/**
+ * Note that all scheduled retunes for a channel's direction have been
+ * cancelled
+ *
+ * @param       cache   Cache
+ * @param[in]   ch      Channel
+ */
+void state_cache_retunes_cancelled(struct state_cache *cache,
+                                   bladerf_channel ch);
+
+/**
+ * Invalidate all cached values. Outstanding scheduled retunes are still
+ * accounted for.
+ *
+ * @param       cache   Cache
+ */
+void state_cache_flush(struct state_cache *cache);
+
+/**
+ * Invalidate all cached values and forget any scheduled retunes, following
+ * a device reset or FPGA load
+ *
+ * @param       cache   Cache
+ */
+void state_cache_reset(struct state_cache *cache);
+
+#endif
@@ -0,0 +1,512 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Required for MAP_HUGETLB, MADV_HUGEPAGE and realpath() */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_config.h"
+
+#if BLADERF_OS_WINDOWS
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if BLADERF_OS_LINUX
+#include <sys/syscall.h>
+#endif
+
+#include "log.h"
+
+#include "backend/backend.h"
+#include "board/board.h"
+
+#include "helpers/alloc.h"
+#include "helpers/stream_mem.h"
+
+static inline size_t round_up(size_t len, size_t align)
+{
+    return ((len + align - 1) / align) * align;
+}
+
+#if BLADERF_OS_WINDOWS
+
+static void *map_region(size_t len, bool hugepages, size_t *map_len)
+{
+    void *ptr = NULL;
+
+    if (hugepages) {
+        const SIZE_T large = GetLargePageMinimum();
+
+        if (large != 0) {
+            *map_len = round_up(len, large);
+            ptr = VirtualAlloc(NULL, *map_len,
+                               MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                               PAGE_READWRITE);
+        }
+
+        if (ptr == NULL) {
+            log_debug("Large pages unavailable (error %lu). Falling back "
+                      "to normal pages.\n", (unsigned long)GetLastError());
+        }
+    }
+
+    if (ptr == NULL) {
+        *map_len = len;
+        ptr = VirtualAlloc(NULL, len, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    }
+
+    return ptr;
+}
+
+static void unmap_region(void *ptr, size_t map_len)
+{
+    VirtualFree(ptr, 0, MEM_RELEASE);
+}
+
+#else
+
+static void *map_region(size_t len, bool hugepages, size_t *map_len)
+{
+    const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    void *ptr = MAP_FAILED;
+
+#if defined(MAP_HUGETLB)
+    if (hugepages) {
+        /* Assume the common 2 MiB default huge page size. If the system's
+         * default differs, the mapping fails and we fall back below. */
+        *map_len = round_up(len, 2 * 1024 * 1024);
+        ptr = mmap(NULL, *map_len, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+        if (ptr == MAP_FAILED) {
+            log_debug("MAP_HUGETLB mapping failed. Falling back to "
+                      "transparent huge pages.\n");
+        }
+    }
+#endif
+
+    if (ptr == MAP_FAILED) {
+        *map_len = round_up(len, page_size);
+        ptr = mmap(NULL, *map_len, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (ptr == MAP_FAILED) {
+            return NULL;
+        }
+
+#if defined(MADV_HUGEPAGE)
+        if (hugepages) {
+            madvise(ptr, *map_len, MADV_HUGEPAGE);
+        }
+#endif
+    }
+
+    return ptr;
+}
+
+static void unmap_region(void *ptr, size_t map_len)
+{
+    munmap(ptr, map_len);
+}
+
+#endif
+
+#if BLADERF_OS_LINUX
+
+#define MPOL_PREFERRED_ 1
+
+/* Determine the NUMA node of the host controller for the specified bus, from
+ * sysfs. Returns -1 if unknown. */
+static int usb_bus_numa_node(uint8_t bus)
+{
+    char path[PATH_MAX];
+    char real[PATH_MAX];
+    char *sep;
+    FILE *f;
+    int node = -1;
+
+    snprintf(path, sizeof(path), "/sys/bus/usb/devices/usb%u", bus);
+    if (realpath(path, real) == NULL) {
+        return -1;
+    }
+
+    /* The root hub's parent is the host controller */
+    sep = strrchr(real, '/');
+    if (sep == NULL) {
+        return -1;
+    }
+    *sep = '\0';
+
+    if ((size_t)snprintf(path, sizeof(path), "%s/numa_node", real) >=
+        sizeof(path)) {
+        return -1;
+    }
+
+    f = fopen(path, "r");
+    if (f == NULL) {
+        return -1;
+    }
+
+    if (fscanf(f, "%d", &node) != 1) {
+        node = -1;
+    }
+
+    fclose(f);
+    return node;
+}
+
+static void bind_numa_local(struct bladerf *dev, void *ptr, size_t len)
+{
+    unsigned long mask[16];
+    const int node = usb_bus_numa_node(dev->ident.usb_bus);
+    const unsigned int bits = sizeof(mask[0]) * 8;
+    long status;
+
+    if (node < 0 || (unsigned int)node >= ARRAY_SIZE(mask) * bits) {
+        log_debug("NUMA node of USB bus %u is unknown. Not binding stream "
+                  "buffers.\n", dev->ident.usb_bus);
+        return;
+    }
+
+    memset(mask, 0, sizeof(mask));
+    mask[node / bits] = 1ul << (node % bits);
+
+    /* Issued directly, to avoid a dependency upon libnuma */
+    status = syscall(SYS_mbind, ptr, len, MPOL_PREFERRED_, mask,
+                     ARRAY_SIZE(mask) * bits, 0);
+    if (status != 0) {
+        log_debug("Failed to bind stream buffers to NUMA node %d.\n", node);
+    } else {
+        log_verbose("Stream buffers bound to NUMA node %d.\n", node);
+    }
+}
+
+#else
+
+static void bind_numa_local(struct bladerf *dev, void *ptr, size_t len)
+{
+    log_debug("NUMA-local stream buffers are not supported on this "
+              "platform.\n");
+}
+
+#endif
+
+/* Take a matching region from the device's pool. Returns true on success. */
+static bool pool_take(struct bladerf *dev,
+                      uint32_t flags,
+                      size_t len,
+                      struct stream_mem *mem)
+{
+    bool found = false;
+    size_t i;
+
+    MUTEX_LOCK(&dev->stream_mem_lock);
+
+    for (i = 0; i < STREAM_MEM_POOL_SIZE; i++) {
+        struct stream_mem *entry = &dev->stream_mem_pool[i];
+
+        if (entry->ptr != NULL && entry->len == len && entry->flags == flags) {
+            *mem = *entry;
+            memset(entry, 0, sizeof(*entry));
+            found = true;
+            break;
+        }
+    }
+
+    MUTEX_UNLOCK(&dev->stream_mem_lock);
+
+    return found;
+}
+
+/* Take the smallest unused registered region that holds `len` bytes.
+ * Returns true on success. */
+static bool user_take(struct bladerf *dev, size_t len, struct stream_mem *mem)
+{
+    struct stream_mem_region *best = NULL;
+    size_t i;
+
+    MUTEX_LOCK(&dev->stream_mem_lock);
+
+    for (i = 0; i < STREAM_MEM_USER_REGIONS; i++) {
+        struct stream_mem_region *r = &dev->stream_mem_user[i];
+
+        if (r->ptr != NULL && !r->in_use && r->len >= len &&
+            (best == NULL || r->len < best->len)) {
+            best = r;
+        }
+    }
+
+    if (best != NULL) {
+        best->in_use = true;
+        mem->ptr     = best->ptr;
+    }
+
+    MUTEX_UNLOCK(&dev->stream_mem_lock);
+
+    return best != NULL;
+}
+
+/* Mark the registered region at `ptr` as unused */
+static void user_put(struct bladerf *dev, void *ptr)
+{
+    size_t i;
+
+    MUTEX_LOCK(&dev->stream_mem_lock);
+
+    for (i = 0; i < STREAM_MEM_USER_REGIONS; i++) {
+        if (dev->stream_mem_user[i].ptr == ptr) {
+            dev->stream_mem_user[i].in_use = false;
+            break;
+        }
+    }
+
+    MUTEX_UNLOCK(&dev->stream_mem_lock);
+}
+
+int stream_mem_alloc(struct bladerf *dev,
+                     uint32_t flags,
+                     size_t len,
+                     struct stream_mem *mem)
+{
+    memset(mem, 0, sizeof(*mem));
+    if (user_take(dev, len, mem)) {
+        mem->len   = len;
+        mem->flags = flags;
+        mem->type  = STREAM_MEM_USER;
+        memset(mem->ptr, 0, len);
+        log_verbose("Using %u bytes of registered stream memory.\n",
+                    (unsigned int)len);
+        return 0;
+    }
+
+    if (pool_take(dev, flags, len, mem)) {
+        log_verbose("Reusing %u bytes of retained stream memory.\n",
+                    (unsigned int)len);
+        memset(mem->ptr, 0, len);
+        return 0;
+    }
+
+    memset(mem, 0, sizeof(*mem));
+    mem->len   = len;
+    mem->flags = flags;
+
+    if ((flags & BLADERF_STREAM_MEM_DEVICE) &&
+        dev->backend->alloc_stream_mem != NULL) {
+        mem->ptr = dev->backend->alloc_stream_mem(dev, len);
+        if (mem->ptr != NULL) {
+            memset(mem->ptr, 0, len);
+            mem->type = STREAM_MEM_DEVICE;
+            log_verbose("Allocated %u bytes of device stream memory.\n",
+                        (unsigned int)len);
+            return 0;
+        }
+
+        log_debug("Device stream memory unavailable. Falling back.\n");
+    }
+
+    if (flags & (BLADERF_STREAM_MEM_PAGE_ALIGNED | BLADERF_STREAM_MEM_HUGEPAGES |
+                 BLADERF_STREAM_MEM_NUMA_LOCAL)) {
+        const bool hugepages = (flags & BLADERF_STREAM_MEM_HUGEPAGES) != 0;
+
+        mem->ptr = map_region(len, hugepages, &mem->map_len);
+        if (mem->ptr != NULL) {
+            mem->type = STREAM_MEM_MAPPED;
+
+            /* Must precede the first access to the pages */
+            if (flags & BLADERF_STREAM_MEM_NUMA_LOCAL) {
+                bind_numa_local(dev, mem->ptr, mem->map_len);
+            }
+
+            return 0;
+        }
+
+        log_debug("Failed to map stream memory. Falling back to the heap.\n");
+    }
+
+    mem->ptr = alloc_calloc(1, len);
+    if (mem->ptr == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    mem->type = STREAM_MEM_HEAP;
+    return 0;
+}
+
+void stream_mem_free(struct bladerf *dev, struct stream_mem *mem)
+{
+    if (mem->ptr == NULL) {
+        return;
+    }
+
+    switch (mem->type) {
+        case STREAM_MEM_USER:
+            user_put(dev, mem->ptr);
+            break;
+
+        case STREAM_MEM_DEVICE:
+            dev->backend->free_stream_mem(dev, mem->ptr, mem->len);
+            break;
+
+        case STREAM_MEM_MAPPED:
+            unmap_region(mem->ptr, mem->map_len);
+            break;
+
+        case STREAM_MEM_HEAP:
+        default:
+            alloc_free(mem->ptr);
+            break;
+    }
+
+    mem->ptr = NULL;
+}
+
+void stream_mem_release(struct bladerf *dev, struct stream_mem *mem)
+{
+    struct stream_mem evicted;
+    size_t i;
+
+    if (mem->ptr == NULL) {
+        return;
+    }
+
+    /* Registered regions are returned to the application's set instead */
+    if (mem->type == STREAM_MEM_USER) {
+        stream_mem_free(dev, mem);
+        memset(mem, 0, sizeof(*mem));
+        return;
+    }
+
+    memset(&evicted, 0, sizeof(evicted));
+
+    MUTEX_LOCK(&dev->stream_mem_lock);
+
+    for (i = 0; i < STREAM_MEM_POOL_SIZE; i++) {
+        if (dev->stream_mem_pool[i].ptr == NULL) {
+            break;
+        }
+    }
+
+    if (i == STREAM_MEM_POOL_SIZE) {
+        evicted = dev->stream_mem_pool[0];
+        memmove(&dev->stream_mem_pool[0], &dev->stream_mem_pool[1],
+                (STREAM_MEM_POOL_SIZE - 1) * sizeof(dev->stream_mem_pool[0]));
+        i = STREAM_MEM_POOL_SIZE - 1;
+    }
+
+    dev->stream_mem_pool[i] = *mem;
+
+    MUTEX_UNLOCK(&dev->stream_mem_lock);
+
+    memset(mem, 0, sizeof(*mem));
+    stream_mem_free(dev, &evicted);
+}
+
+void stream_mem_pool_flush(struct bladerf *dev)
+{
+    size_t i;
+
+    MUTEX_LOCK(&dev->stream_mem_lock);
+
+    for (i = 0; i < STREAM_MEM_POOL_SIZE; i++) {
+        stream_mem_free(dev, &dev->stream_mem_pool[i]);
+    }
+
+    MUTEX_UNLOCK(&dev->stream_mem_lock);
+}
+
+int stream_mem_register(struct bladerf *dev, void *ptr, size_t len)
+{
+    uint8_t *const start = ptr;
+    struct stream_mem_region *slot = NULL;
+    int status = 0;
+    size_t i;
+
+    if (ptr == NULL || len == 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->stream_mem_lock);
+
+    for (i = 0; i < STREAM_MEM_USER_REGIONS; i++) {
+        struct stream_mem_region *r = &dev->stream_mem_user[i];
+        uint8_t *const r_start      = r->ptr;
+
+        if (r->ptr == NULL) {
+            if (slot == NULL) {
+                slot = r;
+            }
+        } else if (start < r_start + r->len && r_start < start + len) {
+            log_debug("Stream memory %p overlaps registered region %p.\n",
+                      ptr, r->ptr);
+            status = BLADERF_ERR_INVAL;
+            break;
+        }
+    }
+
+    if (status == 0 && slot == NULL) {
+        status = BLADERF_ERR_MEM;
+    }
+
+    if (status == 0) {
+        slot->ptr    = ptr;
+        slot->len    = len;
+        slot->in_use = false;
+    }
+
+    MUTEX_UNLOCK(&dev->stream_mem_lock);
+
+    return status;
+}
+
+int stream_mem_unregister(struct bladerf *dev, void *ptr)
+{
+    int status = BLADERF_ERR_INVAL;
+    size_t i;
+
+    MUTEX_LOCK(&dev->stream_mem_lock);
+
+    for (i = 0; i < STREAM_MEM_USER_REGIONS; i++) {
+        struct stream_mem_region *r = &dev->stream_mem_user[i];
+
+        if (ptr != NULL && r->ptr == ptr) {
+            if (r->in_use) {
+                log_debug("Stream memory %p is in use.\n", ptr);
+            } else {
+                memset(r, 0, sizeof(*r));
+                status = 0;
+            }
+            break;
+        }
+    }
+
+    MUTEX_UNLOCK(&dev->stream_mem_lock);
+
+    return status;
+}
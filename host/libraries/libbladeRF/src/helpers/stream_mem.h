@@ -0,0 +1,150 @@
+/**
+ * @file stream_mem.h
+ *
+ * @brief Stream buffer allocation policies
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_STREAM_MEM_H_
+#define HELPERS_STREAM_MEM_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+#define STREAM_MEM_FLAGS_ALL                                          \
+    (BLADERF_STREAM_MEM_PAGE_ALIGNED | BLADERF_STREAM_MEM_HUGEPAGES | \
+     BLADERF_STREAM_MEM_NUMA_LOCAL | BLADERF_STREAM_MEM_DEVICE)
+
+/* Number of released regions retained per device, for reuse by subsequent
+ * streams. This covers one RX and one TX stream being repeatedly restarted. */
+#define STREAM_MEM_POOL_SIZE 2
+
+/* Number of application-provided regions that may be registered per device,
+ * via bladerf_register_stream_mem() */
+#define STREAM_MEM_USER_REGIONS 8
+
+typedef enum {
+    STREAM_MEM_HEAP,    /* calloc() */
+    STREAM_MEM_MAPPED,  /* Anonymous mapping (mmap/VirtualAlloc) */
+    STREAM_MEM_DEVICE,  /* Backend-provided memory */
+    STREAM_MEM_USER,    /* Registered by the application */
+} stream_mem_type;
+
+/**
+ * A region of application memory registered for stream buffers
+ */
+struct stream_mem_region {
+    void *ptr;
+    size_t len;
+    bool in_use;    /* Backing a stream */
+};
+
+/**
+ * A region of stream buffer memory
+ */
+struct stream_mem {
+    void *ptr;
+    size_t len;      /* Length requested */
+    size_t map_len;  /* Length actually mapped, for STREAM_MEM_MAPPED */
+    uint32_t flags;  /* Flags the region was requested with */
+    stream_mem_type type;
+};
+
+/**
+ * Allocate a zero-initialized region for stream buffers
+ *
+ * The smallest unused registered region that is large enough is taken in
+ * preference to any other memory. Otherwise, a region previously returned
+ * via stream_mem_release() is reused if its length and flags match the
+ * request.
+ *
+ * @param       dev     Device handle
+ * @param[in]   flags   BLADERF_STREAM_MEM_* flags
+ * @param[in]   len     Length of the region, in bytes
+ * @param[out]  mem     Populated with the allocated region
+ *
+ * @return 0 on success, BLADERF_ERR_MEM if no memory could be allocated
+ */
+int stream_mem_alloc(struct bladerf *dev,
+                     uint32_t flags,
+                     size_t len,
+                     struct stream_mem *mem);
+
+/**
+ * Free a region allocated by stream_mem_alloc()
+ *
+ * @param       dev     Device handle
+ * @param       mem     Region to free
+ */
+void stream_mem_free(struct bladerf *dev, struct stream_mem *mem);
+
+/**
+ * Return a region to the device's pool, such that a subsequent
+ * stream_mem_alloc() with the same length and flags may reuse it
+ *
+ * If the pool is full, its oldest region is freed.
+ *
+ * @param       dev     Device handle
+ * @param       mem     Region to release. Cleared upon return.
+ */
+void stream_mem_release(struct bladerf *dev, struct stream_mem *mem);
+
+/**
+ * Free all regions retained in the device's pool
+ *
+ * This must be called before the device's backend is closed, as regions may
+ * be backed by device memory.
+ *
+ * @param       dev     Device handle
+ */
+void stream_mem_pool_flush(struct bladerf *dev);
+
+/**
+ * Register application memory for use as stream buffers
+ *
+ * @param       dev     Device handle
+ * @param[in]   ptr     Start of the region
+ * @param[in]   len     Length of the region, in bytes
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if the region is empty or overlaps
+ *         one already registered, or BLADERF_ERR_MEM if
+ *         STREAM_MEM_USER_REGIONS regions are already registered
+ */
+int stream_mem_register(struct bladerf *dev, void *ptr, size_t len);
+
+/**
+ * Remove a region registered via stream_mem_register()
+ *
+ * @param       dev     Device handle
+ * @param[in]   ptr     Start of the region
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if the region is not registered or
+ *         is backing a stream
+ */
+int stream_mem_unregister(struct bladerf *dev, void *ptr);
+
+#endif
@@ -0,0 +1,269 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "log.h"
+
+#include "helpers/sweep.h"
+
+/* Time between reading the current timestamp and the first scheduled
+ * retune, which must cover the latency of scheduling it. */
+#define SWEEP_LEAD_US 10000
+
+struct sweep {
+    struct bladerf *dev;
+    bladerf_channel ch;
+    const struct bladerf_sweep_config *config;
+
+    unsigned int num_steps;
+    struct bladerf_quick_tune *quick_tunes;
+
+    /* Steps are numbered consecutively across sweeps. The retune for step
+     * `n` occurs at anchor + (n - anchor_step) * dwell. */
+    uint64_t dwell;
+    uint64_t lead;
+    bladerf_timestamp anchor;
+    uint64_t anchor_step;
+
+    uint64_t next_scheduled;  /* Next step whose retune is to be scheduled */
+    uint64_t total_steps;     /* UINT64_MAX to run until stopped */
+};
+
+static size_t sample_size(bladerf_format format)
+{
+    switch (format) {
+        case BLADERF_FORMAT_SC16_Q11_META:
+            return 2 * sizeof(int16_t);
+
+        case BLADERF_FORMAT_SC8_Q7_META:
+            return 2 * sizeof(int8_t);
+
+        case BLADERF_FORMAT_CF32_META:
+            return 2 * sizeof(float);
+
+        default:
+            return 0;
+    }
+}
+
+static inline bladerf_timestamp retune_time(const struct sweep *s,
+                                            uint64_t step)
+{
+    return s->anchor + (step - s->anchor_step) * s->dwell;
+}
+
+static inline bladerf_frequency step_frequency(const struct sweep *s,
+                                               unsigned int step)
+{
+    return s->config->start + (bladerf_frequency)step * s->config->step;
+}
+
+/* Obtain the quick tune parameters for every step of the sweep */
+static int build_quick_tunes(struct sweep *s)
+{
+    unsigned int i;
+    int status;
+
+    for (i = 0; i < s->num_steps; i++) {
+        status = bladerf_set_frequency(s->dev, s->ch, step_frequency(s, i));
+        if (status != 0) {
+            return status;
+        }
+
+        status = bladerf_get_quick_tune(s->dev, s->ch, &s->quick_tunes[i]);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    return 0;
+}
+
+/* (Re)start the schedule at the specified step, a short time from now */
+static int anchor_schedule(struct sweep *s, uint64_t step)
+{
+    bladerf_timestamp now;
+    int status;
+
+    status = bladerf_get_timestamp(s->dev, BLADERF_RX, &now);
+    if (status != 0) {
+        return status;
+    }
+
+    s->anchor         = now + s->lead;
+    s->anchor_step    = step;
+    s->next_scheduled = step;
+
+    return 0;
+}
+
+/* Keep the retunes through `step + lookahead` scheduled */
+static int schedule_ahead(struct sweep *s, uint64_t step)
+{
+    const uint64_t last = step + s->config->lookahead;
+    int status;
+
+    while (s->next_scheduled <= last && s->next_scheduled < s->total_steps) {
+        const uint64_t n = s->next_scheduled;
+
+        status = bladerf_schedule_retune(s->dev, s->ch, retune_time(s, n), 0,
+                                         &s->quick_tunes[n % s->num_steps]);
+
+        if (status == BLADERF_ERR_QUEUE_FULL && n > step) {
+            /* Try again after the next capture, once earlier retunes
+             * have occurred */
+            break;
+        } else if (status != 0) {
+            return status;
+        }
+
+        s->next_scheduled++;
+    }
+
+    return 0;
+}
+
+int sweep_run(struct bladerf *dev,
+              bladerf_channel ch,
+              const struct bladerf_sweep_config *config,
+              bladerf_format format,
+              bladerf_channel_layout layout,
+              unsigned int num_sweeps,
+              bladerf_sweep_cb cb,
+              void *user_data)
+{
+    struct sweep s;
+    struct bladerf_sweep_config cfg;
+    struct bladerf_sweep_block block;
+    struct bladerf_metadata meta;
+    bladerf_sample_rate rate;
+    const size_t size = sample_size(format);
+    const unsigned int num_channels = (layout == BLADERF_RX_X2) ? 2 : 1;
+    void *samples = NULL;
+    uint64_t n;
+    int status, cancel_status;
+
+    if (size == 0) {
+        log_debug("Sweeps require a metadata format.\n");
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (config->step == 0 || config->stop < config->start ||
+        config->samples_per_step == 0 ||
+        (config->stop - config->start) / config->step >= UINT32_MAX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    memset(&s, 0, sizeof(s));
+
+    cfg = *config;
+    if (cfg.lookahead == 0) {
+        cfg.lookahead = BLADERF_SWEEP_LOOKAHEAD_DEFAULT;
+    }
+
+    s.dev         = dev;
+    s.ch          = ch;
+    s.config      = &cfg;
+    s.num_steps   = (unsigned int)((cfg.stop - cfg.start) / cfg.step) + 1;
+    s.dwell       = (uint64_t)cfg.settle_samples + cfg.samples_per_step;
+    s.total_steps = (num_sweeps == 0) ?
+                        UINT64_MAX : (uint64_t)num_sweeps * s.num_steps;
+
+    status = bladerf_get_sample_rate(dev, ch, &rate);
+    if (status != 0) {
+        return status;
+    }
+
+    s.lead = (uint64_t)rate * SWEEP_LEAD_US / 1000000;
+
+    s.quick_tunes = calloc(s.num_steps, sizeof(s.quick_tunes[0]));
+    samples       = calloc(cfg.samples_per_step, size * num_channels);
+    if (s.quick_tunes == NULL || samples == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto out;
+    }
+
+    status = build_quick_tunes(&s);
+    if (status != 0) {
+        log_debug("Failed to obtain quick tune parameters: %s\n",
+                  bladerf_strerror(status));
+        goto out;
+    }
+
+    status = anchor_schedule(&s, 0);
+
+    for (n = 0; n < s.total_steps && status == 0; ) {
+        status = schedule_ahead(&s, n);
+        if (status != 0) {
+            break;
+        }
+
+        memset(&meta, 0, sizeof(meta));
+        meta.timestamp = retune_time(&s, n) + cfg.settle_samples;
+
+        /* The samples up to the requested timestamp, which include those
+         * received while settling, are discarded by bladerf_sync_rx() */
+        status = bladerf_sync_rx(dev, samples, cfg.samples_per_step, &meta,
+                                 cfg.timeout_ms);
+
+        if (status == BLADERF_ERR_TIME_PAST) {
+            log_debug("Sweep fell behind at step %" PRIu64 ". "
+                      "Restarting schedule.\n", n);
+
+            status = bladerf_cancel_scheduled_retunes(dev, ch);
+            if (status == 0) {
+                status = anchor_schedule(&s, n);
+            }
+
+            continue;
+        } else if (status != 0) {
+            break;
+        }
+
+        block.sweep       = (unsigned int)(n / s.num_steps);
+        block.step        = (unsigned int)(n % s.num_steps);
+        block.frequency   = step_frequency(&s, block.step);
+        block.timestamp   = meta.timestamp;
+        block.samples     = samples;
+        block.num_samples = meta.actual_count;
+        block.status      = meta.status;
+
+        n++;
+
+        if (cb(dev, &block, user_data) != 0) {
+            break;
+        }
+    }
+
+    /* Don't leave retunes for steps that will not be captured */
+    cancel_status = bladerf_cancel_scheduled_retunes(dev, ch);
+    if (status == 0) {
+        status = cancel_status;
+    }
+
+out:
+    free(samples);
+    free(s.quick_tunes);
+    return status;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file sweep.h
+ *
+ * @brief Frequency sweep engine
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_SWEEP_H_
+#define HELPERS_SWEEP_H_
+
+#include <libbladeRF.h>
+
+/**
+ * Run a sweep, as described by bladerf_sweep()
+ *
+ * The caller must not hold the device's lock, as this is acquired by the
+ * control calls made while sweeping.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          RX channel
+ * @param[in]   config      Sweep configuration
+ * @param[in]   format      Format of the RX synchronous interface
+ * @param[in]   layout      Channel layout of the RX synchronous interface
+ * @param[in]   num_sweeps  Number of sweeps, or 0 to run until stopped
+ * @param[in]   cb          Block callback
+ * @param       user_data   Passed to `cb`
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int sweep_run(struct bladerf *dev,
+              bladerf_channel ch,
+              const struct bladerf_sweep_config *config,
+              bladerf_format format,
+              bladerf_channel_layout layout,
+              unsigned int num_sweeps,
+              bladerf_sweep_cb cb,
+              void *user_data);
+
+#endif
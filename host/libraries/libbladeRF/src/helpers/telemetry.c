@@ -0,0 +1,338 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "thread.h"
+
+#include "board/board.h"
+
+#include "helpers/telemetry.h"
+#include "helpers/timeout.h"
+#include "helpers/wallclock.h"
+
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && \
+    !defined(__STDC_NO_ATOMICS__)
+#   include <stdatomic.h>
+#   define TELEMETRY_HAVE_ATOMICS 1
+#else
+#   define TELEMETRY_HAVE_ATOMICS 0
+#endif
+
+#if TELEMETRY_HAVE_ATOMICS
+
+/* The snapshot is published with a sequence lock. The sequence number is
+ * odd while the snapshot is being written, and readers retry until they
+ * copy it out under the same even sequence number.
+ *
+ * Snapshots are only written with the handle lock held, which serializes
+ * the writers. */
+struct telemetry {
+    struct bladerf *dev;
+
+    /* Protects the thread state and configuration. Never held while taking
+     * dev->lock. */
+    MUTEX lock;
+    pthread_cond_t wake;
+    pthread_t thread;
+    bool thread_running;
+    bool shutdown;
+
+    /* Items sampled, or 0 while disabled */
+    struct bladerf_telemetry_config config;
+    uint64_t next_ns;
+
+    /* Published state */
+    atomic_bool enabled;
+    atomic_uint_fast64_t seq;
+    uint64_t samples;
+    struct bladerf_telemetry snapshot;
+};
+
+static inline uint64_t ms_to_ns(unsigned int ms)
+{
+    return (uint64_t)ms * 1000000;
+}
+
+static void publish(struct telemetry *t, const struct bladerf_telemetry *snap)
+{
+    uint64_t seq = atomic_load_explicit(&t->seq, memory_order_relaxed);
+
+    atomic_store_explicit(&t->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    t->snapshot = *snap;
+
+    atomic_store_explicit(&t->seq, seq + 2, memory_order_release);
+}
+
+/* Must be called with the device's handle lock held */
+static int take_sample(struct telemetry *t, uint32_t items)
+{
+    struct bladerf *dev = t->dev;
+    struct bladerf_telemetry snap;
+    int status;
+
+    memset(&snap, 0, sizeof(snap));
+
+    status = dev->board->read_telemetry(dev, items, &snap);
+    if (status != 0) {
+        return status;
+    }
+
+    snap.samples = ++t->samples;
+    snap.host_ns = wallclock_get_current_nsec();
+
+    publish(t, &snap);
+
+    return 0;
+}
+
+static void *sample_worker(void *arg)
+{
+    struct telemetry *t = arg;
+    struct bladerf *dev = t->dev;
+    struct timespec deadline;
+    uint64_t now, wait_ns;
+    uint32_t items;
+    int status;
+
+    MUTEX_LOCK(&t->lock);
+
+    while (!t->shutdown) {
+        if (t->config.items == 0) {
+            pthread_cond_wait(&t->wake, &t->lock);
+            continue;
+        }
+
+        now = wallclock_get_current_nsec();
+
+        if (now >= t->next_ns) {
+            items      = t->config.items;
+            t->next_ns = now + ms_to_ns(t->config.interval_ms);
+
+            MUTEX_UNLOCK(&t->lock);
+
+            MUTEX_LOCK(&dev->lock);
+            status = take_sample(t, items);
+            MUTEX_UNLOCK(&dev->lock);
+
+            if (status != 0) {
+                log_debug("Telemetry sample failed: %s\n",
+                          bladerf_strerror(status));
+            }
+
+            MUTEX_LOCK(&t->lock);
+            continue;
+        }
+
+        wait_ns = t->next_ns - now;
+
+        /* Round up, so as not to wake just short of the deadline */
+        if (populate_abs_timeout(&deadline,
+                                 (unsigned int)((wait_ns + 999999) /
+                                                1000000)) != 0) {
+            break;
+        }
+
+        pthread_cond_timedwait(&t->wake, &t->lock, &deadline);
+    }
+
+    MUTEX_UNLOCK(&t->lock);
+    return NULL;
+}
+
+static void disable(struct telemetry *t)
+{
+    atomic_store_explicit(&t->enabled, false, memory_order_relaxed);
+
+    MUTEX_LOCK(&t->lock);
+    t->config.items = 0;
+    MUTEX_UNLOCK(&t->lock);
+}
+
+int telemetry_configure(struct bladerf *dev,
+                        const struct bladerf_telemetry_config *config)
+{
+    struct telemetry *t;
+    int status = 0;
+
+    if (config != NULL &&
+        (config->items == 0 || (config->items & ~BLADERF_TELEMETRY_ALL) != 0 ||
+         (config->interval_ms != 0 &&
+          config->interval_ms < BLADERF_TELEMETRY_INTERVAL_MIN_MS))) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* The state is created once, and persists until the device is closed,
+     * as the snapshot is read without locking */
+    MUTEX_LOCK(&dev->lock);
+
+    if (dev->telemetry == NULL && config != NULL) {
+        t = calloc(1, sizeof(*t));
+        if (t == NULL) {
+            MUTEX_UNLOCK(&dev->lock);
+            return BLADERF_ERR_MEM;
+        }
+
+        t->dev = dev;
+
+        MUTEX_INIT(&t->lock);
+        timeout_cond_init(&t->wake);
+        atomic_init(&t->enabled, false);
+        atomic_init(&t->seq, 0);
+
+        /* Publish the initialized state to threads reading snapshots
+         * without the handle lock */
+        atomic_thread_fence(memory_order_release);
+        dev->telemetry = t;
+    }
+
+    t = dev->telemetry;
+
+    if (t != NULL && config != NULL) {
+        /* Take the first sample */
+        atomic_store_explicit(&t->enabled, false, memory_order_relaxed);
+        t->samples = 0;
+
+        status = take_sample(t, config->items);
+        if (status == 0) {
+            atomic_store_explicit(&t->enabled, true, memory_order_release);
+        }
+    }
+
+    MUTEX_UNLOCK(&dev->lock);
+
+    if (t == NULL) {
+        return 0;
+    }
+
+    if (config == NULL) {
+        disable(t);
+        return 0;
+    }
+
+    if (status != 0) {
+        disable(t);
+        return status;
+    }
+
+    MUTEX_LOCK(&t->lock);
+
+    t->config = *config;
+    if (t->config.interval_ms == 0) {
+        t->config.interval_ms = BLADERF_TELEMETRY_INTERVAL_DEFAULT_MS;
+    }
+
+    t->next_ns =
+        wallclock_get_current_nsec() + ms_to_ns(t->config.interval_ms);
+
+    if (!t->thread_running) {
+        status = pthread_create(&t->thread, NULL, sample_worker, t);
+        if (status != 0) {
+            log_debug("Failed to start telemetry thread: %s\n",
+                      strerror(status));
+            MUTEX_UNLOCK(&t->lock);
+            disable(t);
+            return BLADERF_ERR_MEM;
+        }
+
+        t->thread_running = true;
+    }
+
+    pthread_cond_signal(&t->wake);
+    MUTEX_UNLOCK(&t->lock);
+
+    return 0;
+}
+
+int telemetry_get(struct bladerf *dev, struct bladerf_telemetry *snapshot)
+{
+    struct telemetry *t = dev->telemetry;
+    uint64_t seq;
+
+    if (t == NULL ||
+        !atomic_load_explicit(&t->enabled, memory_order_acquire)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    for (;;) {
+        seq = atomic_load_explicit(&t->seq, memory_order_acquire);
+        if ((seq & 1) != 0) {
+            /* Being written */
+            continue;
+        }
+
+        *snapshot = t->snapshot;
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&t->seq, memory_order_relaxed) == seq) {
+            return 0;
+        }
+    }
+}
+
+void telemetry_deinit(struct bladerf *dev)
+{
+    struct telemetry *t = dev->telemetry;
+
+    if (t == NULL) {
+        return;
+    }
+
+    if (t->thread_running) {
+        MUTEX_LOCK(&t->lock);
+        t->shutdown = true;
+        pthread_cond_signal(&t->wake);
+        MUTEX_UNLOCK(&t->lock);
+
+        pthread_join(t->thread, NULL);
+    }
+
+    pthread_cond_destroy(&t->wake);
+    MUTEX_DESTROY(&t->lock);
+
+    free(t);
+    dev->telemetry = NULL;
+}
+
+#else
+
+int telemetry_configure(struct bladerf *dev,
+                        const struct bladerf_telemetry_config *config)
+{
+    log_debug("The telemetry sampler requires C11 atomics.\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int telemetry_get(struct bladerf *dev, struct bladerf_telemetry *snapshot)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+void telemetry_deinit(struct bladerf *dev)
+{
+}
+
+#endif
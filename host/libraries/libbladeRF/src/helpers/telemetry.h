@@ -0,0 +1,59 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_TELEMETRY_H_
+#define HELPERS_TELEMETRY_H_
+
+#include <libbladeRF.h>
+
+/**
+ * Enable, reconfigure, or disable the telemetry sampler, as described by
+ * bladerf_telemetry_configure(). The caller must not hold the device's
+ * handle lock.
+ *
+ * @param       dev     Device handle
+ * @param[in]   config  Configuration, or NULL to disable the sampler
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int telemetry_configure(struct bladerf *dev,
+                        const struct bladerf_telemetry_config *config);
+
+/**
+ * Copy out the most recent snapshot, without locking
+ *
+ * @param       dev         Device handle
+ * @param[out]  snapshot    Updated with the most recent sample
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if the sampler is not enabled
+ */
+int telemetry_get(struct bladerf *dev, struct bladerf_telemetry *snapshot);
+
+/**
+ * Stop the sampler thread and free its state
+ *
+ * This must be called without the device's handle lock held.
+ *
+ * @param       dev         Device handle
+ */
+void telemetry_deinit(struct bladerf *dev);
+
+#endif
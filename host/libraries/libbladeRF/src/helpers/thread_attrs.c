@@ -0,0 +1,209 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Required for pthread_setaffinity_np() and the CPU_* macros */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_config.h"
+
+#if BLADERF_OS_WINDOWS
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "log.h"
+
+#include "helpers/thread_attrs.h"
+
+int thread_attrs_check(const struct bladerf_stream_thread_attrs *attrs)
+{
+#if !(BLADERF_OS_LINUX || BLADERF_OS_WINDOWS)
+    if (attrs->cpu_mask != 0) {
+        log_debug("Stream thread CPU affinity is not supported on this "
+                  "platform.\n");
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+#endif
+
+    if (attrs->priority < 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return 0;
+}
+
+#if BLADERF_OS_WINDOWS
+
+void thread_attrs_apply(const struct bladerf_stream_thread_attrs *attrs,
+                        struct thread_attrs_saved *saved)
+{
+    HANDLE thread = GetCurrentThread();
+
+    memset(saved, 0, sizeof(*saved));
+
+    if (attrs->cpu_mask != 0) {
+        DWORD_PTR prev = SetThreadAffinityMask(thread,
+                                               (DWORD_PTR)attrs->cpu_mask);
+        if (prev == 0) {
+            log_warning("Failed to set stream thread affinity to 0x%llx: "
+                        "error %lu\n", (unsigned long long)attrs->cpu_mask,
+                        (unsigned long)GetLastError());
+        } else {
+            saved->affinity_valid = true;
+            saved->cpu_mask       = (uint64_t)prev;
+        }
+    }
+
+    if (attrs->priority != 0) {
+        const int prev = GetThreadPriority(thread);
+
+        if (!SetThreadPriority(thread, THREAD_PRIORITY_TIME_CRITICAL)) {
+            log_warning("Failed to raise stream thread priority: error %lu\n",
+                        (unsigned long)GetLastError());
+        } else {
+            saved->sched_valid = true;
+            saved->priority    = prev;
+        }
+    }
+}
+
+void thread_attrs_restore(struct thread_attrs_saved *saved)
+{
+    HANDLE thread = GetCurrentThread();
+
+    if (saved->affinity_valid) {
+        SetThreadAffinityMask(thread, (DWORD_PTR)saved->cpu_mask);
+    }
+
+    if (saved->sched_valid) {
+        SetThreadPriority(thread, saved->priority);
+    }
+}
+
+#else
+
+void thread_attrs_apply(const struct bladerf_stream_thread_attrs *attrs,
+                        struct thread_attrs_saved *saved)
+{
+    pthread_t thread = pthread_self();
+    int status;
+
+    memset(saved, 0, sizeof(*saved));
+
+#if BLADERF_OS_LINUX
+    if (attrs->cpu_mask != 0) {
+        cpu_set_t *prev = malloc(sizeof(*prev));
+        cpu_set_t cpus;
+        unsigned int i;
+
+        CPU_ZERO(&cpus);
+        for (i = 0; i < 64 && i < CPU_SETSIZE; i++) {
+            if (attrs->cpu_mask & (UINT64_C(1) << i)) {
+                CPU_SET(i, &cpus);
+            }
+        }
+
+        if (prev == NULL) {
+            status = ENOMEM;
+        } else {
+            status = pthread_getaffinity_np(thread, sizeof(*prev), prev);
+        }
+
+        if (status == 0) {
+            status = pthread_setaffinity_np(thread, sizeof(cpus), &cpus);
+        }
+
+        if (status != 0) {
+            log_warning("Failed to set stream thread affinity to 0x%llx: %s\n",
+                        (unsigned long long)attrs->cpu_mask,
+                        strerror(status));
+            free(prev);
+        } else {
+            saved->affinity_valid = true;
+            saved->cpuset         = prev;
+        }
+    }
+#endif
+
+    if (attrs->priority != 0) {
+        struct sched_param prev_param, param;
+        int prev_policy;
+        int priority = attrs->priority;
+
+        const int min = sched_get_priority_min(SCHED_FIFO);
+        const int max = sched_get_priority_max(SCHED_FIFO);
+
+        if (priority < min) {
+            priority = min;
+        } else if (priority > max) {
+            priority = max;
+        }
+
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = priority;
+
+        status = pthread_getschedparam(thread, &prev_policy, &prev_param);
+        if (status == 0) {
+            status = pthread_setschedparam(thread, SCHED_FIFO, &param);
+        }
+
+        if (status != 0) {
+            log_warning("Failed to set SCHED_FIFO priority %d for stream "
+                        "thread: %s\n", priority, strerror(status));
+        } else {
+            saved->sched_valid = true;
+            saved->policy      = prev_policy;
+            saved->priority    = prev_param.sched_priority;
+        }
+    }
+}
+
+void thread_attrs_restore(struct thread_attrs_saved *saved)
+{
+    pthread_t thread = pthread_self();
+
+#if BLADERF_OS_LINUX
+    if (saved->affinity_valid) {
+        pthread_setaffinity_np(thread, sizeof(cpu_set_t), saved->cpuset);
+        free(saved->cpuset);
+        saved->cpuset         = NULL;
+        saved->affinity_valid = false;
+    }
+#endif
+
+    if (saved->sched_valid) {
+        struct sched_param param;
+
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = saved->priority;
+        pthread_setschedparam(thread, saved->policy, &param);
+    }
+}
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * @file thread_attrs.h
+ *
+ * @brief Apply and restore stream thread scheduling attributes
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_THREAD_ATTRS_H_
+#define HELPERS_THREAD_ATTRS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+/**
+ * Opaque record of a thread's prior scheduling state
+ */
+struct thread_attrs_saved {
+    bool affinity_valid;
+    bool sched_valid;
+    uint64_t cpu_mask; /* Windows */
+    void *cpuset;      /* Linux: heap-allocated cpu_set_t */
+    int policy;
+    int priority;
+};
+
+/**
+ * Check whether the provided attributes can be honored on this platform
+ *
+ * @param[in]   attrs   Attributes to check
+ *
+ * @return 0 if supported, BLADERF_ERR_UNSUPPORTED otherwise
+ */
+int thread_attrs_check(const struct bladerf_stream_thread_attrs *attrs);
+
+/**
+ * Apply the provided attributes to the calling thread
+ *
+ * Failures are logged and reflected in `saved`, such that
+ * thread_attrs_restore() only reverts what was changed.
+ *
+ * @param[in]   attrs   Attributes to apply
+ * @param[out]  saved   Updated with the thread's prior state
+ */
+void thread_attrs_apply(const struct bladerf_stream_thread_attrs *attrs,
+                        struct thread_attrs_saved *saved);
+
+/**
+ * Restore the calling thread's scheduling state, as recorded by
+ * thread_attrs_apply(), and release any resources held by `saved`
+ *
+ * @param[in]   saved   Prior state
+ */
+void thread_attrs_restore(struct thread_attrs_saved *saved);
+
+#endif
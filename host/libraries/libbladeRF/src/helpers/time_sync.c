@@ -0,0 +1,605 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+
+#include "board/board.h"
+#include "helpers/time_sync.h"
+#include "helpers/timeout.h"
+#include "helpers/wallclock.h"
+
+/* Tolerance assumed of the device clock's rate relative to the host clock,
+ * in ppm. This weights the nominal sample rate against the fitted rate, so
+ * that measurements taken close together do not yield a wild estimate. */
+#define TIME_SYNC_PRIOR_PPM 100.0
+
+/* Longest the measurement thread sleeps between checks, in ms */
+#define TIME_SYNC_IDLE_MS 1000
+
+struct time_sync_point {
+    uint64_t host_ns;       /* Estimated host time of the read */
+    bladerf_timestamp ts;   /* Device timestamp read */
+    double weight;          /* Inverse variance of host_ns, in ns^-2 */
+};
+
+struct time_sync_dir {
+    bool enabled;
+    struct bladerf_time_sync_config config;
+    uint64_t next_ns;       /* Host time of the thread's next measurement */
+
+    /* Recent measurements, oldest first from `head' */
+    struct time_sync_point points[BLADERF_TIME_SYNC_WINDOW];
+    unsigned int num_points;
+    unsigned int head;
+
+    bladerf_sample_rate nominal;
+    uint64_t measurements;
+    uint64_t uncertainty_ns; /* Of the latest read */
+
+    /* Timestamp at host time h is:
+     *   ref_ts + offset + slope * (h - ref_host) */
+    uint64_t ref_host;
+    bladerf_timestamp ref_ts;
+    double offset;          /* Ticks */
+    double slope;           /* Ticks per ns */
+    double residual_ns;
+};
+
+struct time_sync {
+    struct bladerf *dev;
+
+    /* Protects everything below. Never held while taking dev->lock. */
+    MUTEX lock;
+    pthread_cond_t wake;
+    pthread_t thread;
+    bool thread_running;
+    bool shutdown;
+
+    /* Indexed by direction */
+    struct time_sync_dir dir[2];
+};
+
+static void reset_fit(struct time_sync_dir *d)
+{
+    d->num_points   = 0;
+    d->head         = 0;
+    d->measurements = 0;
+    d->residual_ns  = 0;
+}
+
+/* Fit the window's measurements, relative to the newest one */
+static void update_fit(struct time_sync_dir *d)
+{
+    const struct time_sync_point *ref;
+    double nominal = d->nominal / 1e9;
+    double sw = 0, sx = 0, sy = 0, sxx = 0, sxy = 0, sr = 0;
+    double xbar, ybar, var_fit, var_prior, fit;
+    unsigned int i, n = d->num_points;
+
+    ref = &d->points[(d->head + n - 1) % BLADERF_TIME_SYNC_WINDOW];
+
+    for (i = 0; i < n; i++) {
+        const struct time_sync_point *p =
+            &d->points[(d->head + i) % BLADERF_TIME_SYNC_WINDOW];
+        double x = (double)(int64_t)(p->host_ns - ref->host_ns);
+        double y = (double)(int64_t)(p->ts - ref->ts);
+
+        sw += p->weight;
+        sx += p->weight * x;
+        sy += p->weight * y;
+    }
+
+    xbar = sx / sw;
+    ybar = sy / sw;
+
+    for (i = 0; i < n; i++) {
+        const struct time_sync_point *p =
+            &d->points[(d->head + i) % BLADERF_TIME_SYNC_WINDOW];
+        double x = (double)(int64_t)(p->host_ns - ref->host_ns) - xbar;
+        double y = (double)(int64_t)(p->ts - ref->ts) - ybar;
+
+        sxx += p->weight * x * x;
+        sxy += p->weight * x * y;
+    }
+
+    /* Combine the fitted rate with the nominal rate, each weighted by its
+     * relative variance. The fit's is 1/sxx, as the weights are the inverse
+     * variances of the host times. */
+    d->slope = nominal;
+    if (n > 1 && sxx > 0) {
+        fit       = sxy / sxx;
+        var_fit   = 1.0 / sxx;
+        var_prior = TIME_SYNC_PRIOR_PPM * 1e-6 * TIME_SYNC_PRIOR_PPM * 1e-6;
+        d->slope  = (fit / var_fit + nominal / var_prior) /
+                    (1.0 / var_fit + 1.0 / var_prior);
+    }
+
+    d->ref_host = ref->host_ns;
+    d->ref_ts   = ref->ts;
+    d->offset   = ybar - d->slope * xbar;
+
+    for (i = 0; i < n; i++) {
+        const struct time_sync_point *p =
+            &d->points[(d->head + i) % BLADERF_TIME_SYNC_WINDOW];
+        double x = (double)(int64_t)(p->host_ns - ref->host_ns);
+        double y = (double)(int64_t)(p->ts - ref->ts);
+        double r = (y - d->offset - d->slope * x) / d->slope;
+
+        sr += p->weight * r * r;
+    }
+
+    d->residual_ns = sqrt(sr / sw);
+}
+
+/* Predicted timestamp, relative to ref_ts, at host time h */
+static double predict(const struct time_sync_dir *d, uint64_t host_ns)
+{
+    return d->offset + d->slope * (double)(int64_t)(host_ns - d->ref_host);
+}
+
+static void add_point(struct time_sync_dir *d,
+                      uint64_t host_ns,
+                      bladerf_timestamp ts,
+                      uint64_t uncertainty_ns,
+                      bladerf_sample_rate nominal)
+{
+    struct time_sync_point *p;
+    double sigma, err_ns;
+
+    if (nominal != d->nominal) {
+        reset_fit(d);
+        d->nominal = nominal;
+    }
+
+    if (d->num_points > 0) {
+        err_ns = ((double)(int64_t)(ts - d->ref_ts) - predict(d, host_ns)) /
+                 d->slope;
+
+        if (fabs(err_ns) > TIME_SYNC_RESET_NS) {
+            log_debug("%s: timestamp is %.0f ns from fit; resetting\n",
+                      __FUNCTION__, err_ns);
+            reset_fit(d);
+        }
+    }
+
+    if (d->num_points == BLADERF_TIME_SYNC_WINDOW) {
+        d->head = (d->head + 1) % BLADERF_TIME_SYNC_WINDOW;
+        d->num_points--;
+    }
+
+    sigma = (uncertainty_ns > 1) ? (double)uncertainty_ns : 1.0;
+
+    p = &d->points[(d->head + d->num_points) % BLADERF_TIME_SYNC_WINDOW];
+    p->host_ns = host_ns;
+    p->ts      = ts;
+    p->weight  = 1.0 / (sigma * sigma);
+
+    d->num_points++;
+    d->measurements++;
+    d->uncertainty_ns = uncertainty_ns;
+
+    update_fit(d);
+}
+
+static struct time_sync_dir *get_dir(struct bladerf *dev,
+                                     bladerf_direction dir)
+{
+    if (dev->time_sync == NULL || (dir != BLADERF_RX && dir != BLADERF_TX)) {
+        return NULL;
+    }
+
+    return &dev->time_sync->dir[dir];
+}
+
+/* Must be called with dev->lock held */
+static int estimate(struct bladerf *dev,
+                    bladerf_direction dir,
+                    unsigned int samples,
+                    struct bladerf_timestamp_estimate *est,
+                    bladerf_sample_rate *nominal)
+{
+    bladerf_channel ch;
+    bladerf_timestamp ts;
+    uint64_t t1, t2, window, hold_ns, best = UINT64_MAX;
+    uint32_t hold  = 0;
+    bool latched   = true;
+    unsigned int i;
+    int status;
+
+    ch = (dir == BLADERF_RX) ? BLADERF_CHANNEL_RX(0) : BLADERF_CHANNEL_TX(0);
+
+    status = dev->board->get_sample_rate(dev, ch, nominal);
+    if (status != 0) {
+        return status;
+    }
+
+    if (*nominal == 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    for (i = 0; i < samples; i++) {
+        t1 = wallclock_get_current_nsec();
+
+        if (latched) {
+            status = dev->board->get_timestamp_latch(dev, dir, &ts, &hold);
+            if (status == BLADERF_ERR_UNSUPPORTED) {
+                latched = false;
+                t1      = wallclock_get_current_nsec();
+            }
+        }
+
+        if (!latched) {
+            status = dev->board->get_timestamp(dev, dir, &ts);
+        }
+
+        t2 = wallclock_get_current_nsec();
+
+        if (status != 0) {
+            return status;
+        }
+
+        /* The timestamp was sampled within the round trip, less the time
+         * the device reports having held the request */
+        hold_ns = (uint64_t)hold * 1000000000 / *nominal;
+        window  = t2 - t1;
+        window -= (hold_ns < window) ? hold_ns : window;
+
+        /* Keep the read that is bounded most tightly, as it is the one
+         * least delayed by USB scheduling and the host */
+        if (window < best) {
+            best                = window;
+            est->timestamp      = ts;
+            est->host_ns        = t1 + window / 2;
+            est->uncertainty_ns = (window + 1) / 2;
+            est->hold_ns        = hold_ns;
+            est->latched        = latched;
+        }
+    }
+
+    return 0;
+}
+
+int time_sync_estimate(struct bladerf *dev,
+                       bladerf_direction dir,
+                       unsigned int samples,
+                       struct bladerf_timestamp_estimate *est)
+{
+    bladerf_sample_rate nominal;
+    int status;
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (samples == 0) {
+        samples = BLADERF_TIME_SYNC_PROBES_DEFAULT;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+    status = estimate(dev, dir, samples, est, &nominal);
+    MUTEX_UNLOCK(&dev->lock);
+
+    return status;
+}
+
+int time_sync_measure(struct bladerf *dev, bladerf_direction dir)
+{
+    struct time_sync *s = dev->time_sync;
+    struct time_sync_dir *d = get_dir(dev, dir);
+    struct bladerf_timestamp_estimate est;
+    bladerf_sample_rate nominal;
+    unsigned int probes;
+    int status;
+
+    if (d == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&s->lock);
+    probes = d->enabled ? d->config.probes : 0;
+    MUTEX_UNLOCK(&s->lock);
+
+    if (probes == 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+    status = estimate(dev, dir, probes, &est, &nominal);
+    MUTEX_UNLOCK(&dev->lock);
+
+    if (status != 0) {
+        return status;
+    }
+
+    MUTEX_LOCK(&s->lock);
+
+    /* The service may have been disabled meanwhile */
+    if (d->enabled) {
+        add_point(d, est.host_ns, est.timestamp, est.uncertainty_ns, nominal);
+    }
+
+    MUTEX_UNLOCK(&s->lock);
+
+    return 0;
+}
+
+static void *measure_worker(void *arg)
+{
+    struct time_sync *s = arg;
+    struct timespec deadline;
+    bool due[2];
+    uint64_t now, wait_ns;
+    unsigned int i;
+    int status;
+
+    MUTEX_LOCK(&s->lock);
+
+    while (!s->shutdown) {
+        now     = wallclock_get_current_nsec();
+        wait_ns = (uint64_t)TIME_SYNC_IDLE_MS * 1000000;
+
+        for (i = 0; i < 2; i++) {
+            struct time_sync_dir *d = &s->dir[i];
+
+            due[i] = false;
+
+            if (!d->enabled || d->config.interval_ms == 0) {
+                continue;
+            }
+
+            if ((int64_t)(d->next_ns - now) <= 0) {
+                d->next_ns = now + (uint64_t)d->config.interval_ms * 1000000;
+                due[i]     = true;
+            } else if (d->next_ns - now < wait_ns) {
+                wait_ns = d->next_ns - now;
+            }
+        }
+
+        if (due[BLADERF_RX] || due[BLADERF_TX]) {
+            MUTEX_UNLOCK(&s->lock);
+
+            for (i = 0; i < 2; i++) {
+                if (due[i]) {
+                    status = time_sync_measure(s->dev, (bladerf_direction)i);
+                    if (status != 0) {
+                        log_debug("Time sync measurement failed: %s\n",
+                                  bladerf_strerror(status));
+                    }
+                }
+            }
+
+            MUTEX_LOCK(&s->lock);
+            continue;
+        }
+
+        /* Round up, so as not to wake just short of the deadline */
+        if (populate_abs_timeout(&deadline,
+                                 (unsigned int)((wait_ns + 999999) /
+                                                1000000)) != 0) {
+            break;
+        }
+
+        pthread_cond_timedwait(&s->wake, &s->lock, &deadline);
+    }
+
+    MUTEX_UNLOCK(&s->lock);
+    return NULL;
+}
+
+int time_sync_configure(struct bladerf *dev,
+                        bladerf_direction dir,
+                        const struct bladerf_time_sync_config *config)
+{
+    struct time_sync *s;
+    struct time_sync_dir *d;
+    int status;
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* The state is created once, and persists until the device is closed */
+    MUTEX_LOCK(&dev->lock);
+
+    if (dev->time_sync == NULL && config != NULL) {
+        s = calloc(1, sizeof(*s));
+        if (s == NULL) {
+            MUTEX_UNLOCK(&dev->lock);
+            return BLADERF_ERR_MEM;
+        }
+
+        s->dev = dev;
+
+        MUTEX_INIT(&s->lock);
+        timeout_cond_init(&s->wake);
+
+        dev->time_sync = s;
+    }
+
+    s = dev->time_sync;
+
+    MUTEX_UNLOCK(&dev->lock);
+
+    if (s == NULL) {
+        return 0;
+    }
+
+    d = &s->dir[dir];
+
+    MUTEX_LOCK(&s->lock);
+
+    if (config == NULL) {
+        d->enabled = false;
+        MUTEX_UNLOCK(&s->lock);
+        return 0;
+    }
+
+    d->config = *config;
+    if (d->config.probes == 0) {
+        d->config.probes = BLADERF_TIME_SYNC_PROBES_DEFAULT;
+    }
+
+    reset_fit(d);
+    d->enabled = true;
+    d->next_ns = wallclock_get_current_nsec() +
+                 (uint64_t)d->config.interval_ms * 1000000;
+
+    if (d->config.interval_ms != 0 && !s->thread_running) {
+        status = pthread_create(&s->thread, NULL, measure_worker, s);
+        if (status != 0) {
+            log_debug("Failed to start time sync thread: %s\n",
+                      strerror(status));
+            d->enabled = false;
+            MUTEX_UNLOCK(&s->lock);
+            return BLADERF_ERR_MEM;
+        }
+
+        s->thread_running = true;
+    }
+
+    pthread_cond_signal(&s->wake);
+    MUTEX_UNLOCK(&s->lock);
+
+    status = time_sync_measure(dev, dir);
+    if (status != 0) {
+        MUTEX_LOCK(&s->lock);
+        d->enabled = false;
+        MUTEX_UNLOCK(&s->lock);
+    }
+
+    return status;
+}
+
+int time_sync_host_to_device(struct bladerf *dev,
+                             bladerf_direction dir,
+                             uint64_t host_ns,
+                             bladerf_timestamp *timestamp)
+{
+    struct time_sync_dir *d = get_dir(dev, dir);
+    double delta;
+    int status = 0;
+
+    if (d == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->time_sync->lock);
+
+    if (!d->enabled || d->num_points == 0) {
+        status = BLADERF_ERR_INVAL;
+    } else {
+        delta = floor(predict(d, host_ns) + 0.5);
+
+        if (delta < 0 && -delta > (double)d->ref_ts) {
+            status = BLADERF_ERR_RANGE;
+        } else {
+            *timestamp = d->ref_ts + (uint64_t)(int64_t)delta;
+        }
+    }
+
+    MUTEX_UNLOCK(&dev->time_sync->lock);
+    return status;
+}
+
+int time_sync_device_to_host(struct bladerf *dev,
+                             bladerf_direction dir,
+                             bladerf_timestamp timestamp,
+                             uint64_t *host_ns)
+{
+    struct time_sync_dir *d = get_dir(dev, dir);
+    double delta;
+    int status = 0;
+
+    if (d == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->time_sync->lock);
+
+    if (!d->enabled || d->num_points == 0) {
+        status = BLADERF_ERR_INVAL;
+    } else {
+        delta = ((double)(int64_t)(timestamp - d->ref_ts) - d->offset) /
+                d->slope;
+        *host_ns = d->ref_host + (uint64_t)(int64_t)floor(delta + 0.5);
+    }
+
+    MUTEX_UNLOCK(&dev->time_sync->lock);
+    return status;
+}
+
+int time_sync_get_stats(struct bladerf *dev,
+                        bladerf_direction dir,
+                        struct bladerf_time_sync_stats *stats)
+{
+    struct time_sync_dir *d = get_dir(dev, dir);
+    int status = 0;
+
+    if (d == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->time_sync->lock);
+
+    if (!d->enabled || d->num_points == 0) {
+        status = BLADERF_ERR_INVAL;
+    } else {
+        stats->measurements        = d->measurements;
+        stats->fit_points          = d->num_points;
+        stats->rate                = d->slope * 1e9;
+        stats->drift_ppm           = (stats->rate / d->nominal - 1.0) * 1e6;
+        stats->residual_ns         = d->residual_ns;
+        stats->read_uncertainty_ns = d->uncertainty_ns;
+        stats->uncertainty_ns      = d->uncertainty_ns + d->residual_ns;
+    }
+
+    MUTEX_UNLOCK(&dev->time_sync->lock);
+    return status;
+}
+
+void time_sync_deinit(struct bladerf *dev)
+{
+    struct time_sync *s = dev->time_sync;
+
+    if (s == NULL) {
+        return;
+    }
+
+    if (s->thread_running) {
+        MUTEX_LOCK(&s->lock);
+        s->shutdown = true;
+        pthread_cond_signal(&s->wake);
+        MUTEX_UNLOCK(&s->lock);
+
+        pthread_join(s->thread, NULL);
+    }
+
+    pthread_cond_destroy(&s->wake);
+    MUTEX_DESTROY(&s->lock);
+
+    free(s);
+    dev->time_sync = NULL;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file time_sync.h
+ *
+ * @brief Host and device clock correlation
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_TIME_SYNC_H_
+#define HELPERS_TIME_SYNC_H_
+
+#include <libbladeRF.h>
+
+/* Deviation from the fit beyond which a measurement resets it, in ns */
+#define TIME_SYNC_RESET_NS 1000000
+
+/**
+ * Estimate when a device timestamp was sampled, in host time, as described
+ * by bladerf_get_timestamp_estimate(). The caller must not hold the device's
+ * handle lock.
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Direction
+ * @param[in]   samples     Number of reads. 0 selects the default.
+ * @param[out]  est         Updated with the best estimate
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int time_sync_estimate(struct bladerf *dev,
+                       bladerf_direction dir,
+                       unsigned int samples,
+                       struct bladerf_timestamp_estimate *est);
+
+/**
+ * Enable, reconfigure, or disable the time sync service for a direction,
+ * as described by bladerf_time_sync_configure(). The caller must not hold
+ * the device's handle lock.
+ *
+ * @param       dev     Device handle
+ * @param[in]   dir     Direction
+ * @param[in]   config  Configuration, or NULL to disable the service
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int time_sync_configure(struct bladerf *dev,
+                        bladerf_direction dir,
+                        const struct bladerf_time_sync_config *config);
+
+/**
+ * Take a measurement, and update the fit. The caller must not hold the
+ * device's handle lock.
+ *
+ * @param       dev     Device handle
+ * @param[in]   dir     Direction
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int time_sync_measure(struct bladerf *dev, bladerf_direction dir);
+
+/**
+ * Map a host time to a device timestamp
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Direction
+ * @param[in]   host_ns     Host time, in ns
+ * @param[out]  timestamp   Device timestamp
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int time_sync_host_to_device(struct bladerf *dev,
+                             bladerf_direction dir,
+                             uint64_t host_ns,
+                             bladerf_timestamp *timestamp);
+
+/**
+ * Map a device timestamp to a host time
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Direction
+ * @param[in]   timestamp   Device timestamp
+ * @param[out]  host_ns     Host time, in ns
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int time_sync_device_to_host(struct bladerf *dev,
+                             bladerf_direction dir,
+                             bladerf_timestamp timestamp,
+                             uint64_t *host_ns);
+
+/**
+ * Get the state of the time sync service
+ *
+ * @param       dev     Device handle
+ * @param[in]   dir     Direction
+ * @param[out]  stats   Service state
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int time_sync_get_stats(struct bladerf *dev,
+                        bladerf_direction dir,
+                        struct bladerf_time_sync_stats *stats);
+
+/**
+ * Stop the measurement thread and free the service's state. Must be called
+ * without the device's handle lock held, as the thread takes it.
+ *
+ * @param       dev         Device handle
+ */
+void time_sync_deinit(struct bladerf *dev);
+
+#endif
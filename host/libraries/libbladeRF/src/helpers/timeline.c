@@ -0,0 +1,842 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "thread.h"
+
+#include "board/board.h"
+#include "streaming/sync.h"
+#include "streaming/sync_worker.h"
+
+#include "helpers/timeline.h"
+#include "helpers/wallclock.h"
+
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && \
+    !defined(__STDC_NO_ATOMICS__)
+#   include <stdatomic.h>
+#   define TIMELINE_HAVE_ATOMICS 1
+#else
+#   define TIMELINE_HAVE_ATOMICS 0
+#endif
+
+#if TIMELINE_HAVE_ATOMICS
+
+typedef enum {
+    TL_SYNC_STATE,   /* a: sync_state */
+    TL_SYNC_BUF,     /* idx: buffer, a: sync_buffer_status */
+    TL_WORKER_STATE, /* a: sync_worker_state */
+    TL_CALLBACK,     /* dur */
+    TL_CTRL,         /* dur, a: kind, b: opcode, idx: target | write << 8,
+                      * status */
+    TL_RETUNE,       /* idx: channel, v0: timestamp, v1: frequency, status */
+    TL_ERROR,        /* idx: metadata status, status */
+} timeline_event_type;
+
+struct timeline_event {
+    uint64_t ts;  /* Host time at which the event began, in ns */
+    uint64_t dur; /* Duration, in ns */
+    uint64_t v0;
+    uint64_t v1;
+    int32_t status;
+    uint32_t idx;
+    uint8_t type;
+    uint8_t dir;
+    uint8_t a;
+    uint8_t b;
+};
+
+/* Events are published as in the control-path trace: slots are claimed by
+ * atomically incrementing the ring's head, and each slot's sequence number
+ * is odd while it is being written, and 2 * (index + 1) once event `index`
+ * has been published. */
+struct timeline_slot {
+    atomic_uint_fast64_t seq;
+    struct timeline_event ev;
+};
+
+struct timeline {
+    atomic_bool enabled;
+    atomic_uint_fast64_t head;
+
+    /* Pending error dump. dump_path is protected by dump_lock. */
+    atomic_bool dump_armed;
+    MUTEX dump_lock;
+    char *dump_path;
+
+    struct timeline_slot slots[BLADERF_TIMELINE_LEN];
+};
+
+static inline struct timeline *get_enabled(struct bladerf *dev)
+{
+    struct timeline *t = dev->timeline;
+
+    if (t == NULL ||
+        !atomic_load_explicit(&t->enabled, memory_order_relaxed)) {
+        return NULL;
+    }
+
+    return t;
+}
+
+static void record(struct timeline *t, const struct timeline_event *ev)
+{
+    const uint64_t idx =
+        atomic_fetch_add_explicit(&t->head, 1, memory_order_relaxed);
+    struct timeline_slot *slot = &t->slots[idx % BLADERF_TIMELINE_LEN];
+
+    atomic_store_explicit(&slot->seq, 2 * idx + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    slot->ev = *ev;
+
+    atomic_store_explicit(&slot->seq, 2 * idx + 2, memory_order_release);
+}
+
+static void record_now(struct timeline *t,
+                       timeline_event_type type,
+                       bladerf_direction dir,
+                       unsigned int idx,
+                       unsigned int a)
+{
+    struct timeline_event ev;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.ts   = wallclock_get_current_nsec();
+    ev.type = (uint8_t)type;
+    ev.dir  = (uint8_t)dir;
+    ev.idx  = idx;
+    ev.a    = (uint8_t)a;
+
+    record(t, &ev);
+}
+
+uint64_t timeline_begin(struct bladerf *dev)
+{
+    return get_enabled(dev) ? wallclock_get_current_nsec() : 0;
+}
+
+void timeline_sync_state(struct bladerf *dev,
+                         bladerf_direction dir,
+                         unsigned int state)
+{
+    struct timeline *t = get_enabled(dev);
+
+    if (t != NULL) {
+        record_now(t, TL_SYNC_STATE, dir, 0, state);
+    }
+}
+
+void timeline_sync_buf(struct bladerf *dev,
+                       bladerf_direction dir,
+                       unsigned int idx,
+                       unsigned int status)
+{
+    struct timeline *t = get_enabled(dev);
+
+    if (t != NULL) {
+        record_now(t, TL_SYNC_BUF, dir, idx, status);
+    }
+}
+
+void timeline_worker_state(struct bladerf *dev,
+                           bladerf_direction dir,
+                           unsigned int state)
+{
+    struct timeline *t = get_enabled(dev);
+
+    if (t != NULL) {
+        record_now(t, TL_WORKER_STATE, dir, 0, state);
+    }
+}
+
+void timeline_callback(struct bladerf *dev,
+                       bladerf_direction dir,
+                       uint64_t start)
+{
+    struct timeline *t = dev->timeline;
+    struct timeline_event ev;
+
+    if (start == 0 || t == NULL) {
+        return;
+    }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.ts   = start;
+    ev.dur  = wallclock_get_current_nsec() - start;
+    ev.type = TL_CALLBACK;
+    ev.dir  = (uint8_t)dir;
+
+    record(t, &ev);
+}
+
+void timeline_ctrl(struct bladerf *dev,
+                   uint64_t start,
+                   uint64_t end,
+                   bladerf_ctrl_trace_kind kind,
+                   uint8_t opcode,
+                   uint8_t target,
+                   bool write,
+                   int status)
+{
+    struct timeline *t = get_enabled(dev);
+    struct timeline_event ev;
+
+    if (t == NULL) {
+        return;
+    }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.ts     = start;
+    ev.dur    = (end > start) ? (end - start) : 0;
+    ev.type   = TL_CTRL;
+    ev.a      = (uint8_t)kind;
+    ev.b      = opcode;
+    ev.idx    = target | (write ? (1 << 8) : 0);
+    ev.status = status;
+
+    record(t, &ev);
+}
+
+void timeline_retune(struct bladerf *dev,
+                     bladerf_channel ch,
+                     bladerf_timestamp timestamp,
+                     bladerf_frequency frequency,
+                     int status)
+{
+    struct timeline *t = get_enabled(dev);
+    struct timeline_event ev;
+
+    if (t == NULL) {
+        return;
+    }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.ts     = wallclock_get_current_nsec();
+    ev.type   = TL_RETUNE;
+    ev.idx    = (uint32_t)ch;
+    ev.v0     = timestamp;
+    ev.v1     = frequency;
+    ev.status = status;
+
+    record(t, &ev);
+}
+
+/******************************************************************************
+ * Chrome JSON trace export
+ *
+ * Each source of events is displayed as a "thread" of a single process. The
+ * state machines and buffer statuses are recorded as transitions, and are
+ * written as slices spanning from one transition to the next.
+ ******************************************************************************/
+
+#define TRACK_SYNC      1       /* + direction */
+#define TRACK_WORKER    3       /* + direction */
+#define TRACK_CALLBACK  5       /* + direction */
+#define TRACK_CTRL      7
+#define TRACK_RETUNE    8
+#define TRACK_BUF(dir)  (100000 * ((dir) + 1))  /* + buffer index */
+
+static const char *sync_state_names[] = {
+    [SYNC_STATE_CHECK_WORKER]      = "CHECK_WORKER",
+    [SYNC_STATE_RESET_BUF_MGMT]    = "RESET_BUF_MGMT",
+    [SYNC_STATE_START_WORKER]      = "START_WORKER",
+    [SYNC_STATE_WAIT_FOR_BUFFER]   = "WAIT_FOR_BUFFER",
+    [SYNC_STATE_BUFFER_READY]      = "BUFFER_READY",
+    [SYNC_STATE_USING_BUFFER]      = "USING_BUFFER",
+    [SYNC_STATE_USING_PACKET_META] = "USING_PACKET_META",
+    [SYNC_STATE_USING_BUFFER_META] = "USING_BUFFER_META",
+};
+
+static const char *buf_status_names[] = {
+    [SYNC_BUFFER_EMPTY]     = "EMPTY",
+    [SYNC_BUFFER_PARTIAL]   = "PARTIAL",
+    [SYNC_BUFFER_FULL]      = "FULL",
+    [SYNC_BUFFER_IN_FLIGHT] = "IN_FLIGHT",
+};
+
+static const char *worker_state_names[] = {
+    [SYNC_WORKER_STATE_STARTUP]       = "STARTUP",
+    [SYNC_WORKER_STATE_IDLE]          = "IDLE",
+    [SYNC_WORKER_STATE_RUNNING]       = "RUNNING",
+    [SYNC_WORKER_STATE_SHUTTING_DOWN] = "SHUTTING_DOWN",
+    [SYNC_WORKER_STATE_STOPPED]       = "STOPPED",
+};
+
+#define NAME(names, i) \
+    (((size_t)(i) < sizeof(names) / sizeof(names[0]) && names[i] != NULL) \
+         ? names[i]                                                       \
+         : "UNKNOWN")
+
+/* A state that has yet to be written out as a slice */
+struct open_slice {
+    bool valid;
+    uint8_t state;
+    uint64_t ts;
+};
+
+struct exporter {
+    FILE *f;
+    bool first;
+    uint64_t origin;
+};
+
+static inline const char *dir2str(unsigned int dir)
+{
+    return (dir == BLADERF_RX) ? "RX" : "TX";
+}
+
+/* Timestamps are in microseconds, relative to the oldest event */
+static void put_ts(struct exporter *x, const char *key, uint64_t ns)
+{
+    fprintf(x->f, ",\"%s\":%" PRIu64 ".%03u", key, ns / 1000,
+            (unsigned int)(ns % 1000));
+}
+
+static void begin_event(struct exporter *x, const char *ph, unsigned int tid)
+{
+    fprintf(x->f, "%s\n{\"ph\":\"%s\",\"pid\":1,\"tid\":%u",
+            x->first ? "" : ",", ph, tid);
+    x->first = false;
+}
+
+static void put_track_name(struct exporter *x, unsigned int tid,
+                           const char *fmt, unsigned int arg)
+{
+    begin_event(x, "M", tid);
+    fprintf(x->f, ",\"name\":\"thread_name\",\"args\":{\"name\":\"");
+    fprintf(x->f, fmt, arg);
+    fprintf(x->f, "\"}}");
+
+    begin_event(x, "M", tid);
+    fprintf(x->f, ",\"name\":\"thread_sort_index\","
+                  "\"args\":{\"sort_index\":%u}}", tid);
+}
+
+static void put_slice(struct exporter *x, unsigned int tid, const char *name,
+                      uint64_t ts, uint64_t end)
+{
+    begin_event(x, "X", tid);
+    fprintf(x->f, ",\"name\":\"%s\"", name);
+    put_ts(x, "ts", ts - x->origin);
+    put_ts(x, "dur", (end > ts) ? (end - ts) : 0);
+    fprintf(x->f, "}");
+}
+
+/* Close the slice of the state preceding a transition at `ts`, if any, and
+ * open one for the new state */
+static void transition(struct exporter *x, struct open_slice *s,
+                       unsigned int tid, const char *name, uint8_t state,
+                       uint64_t ts)
+{
+    if (s->valid) {
+        put_slice(x, tid, name, s->ts, ts);
+    }
+
+    s->valid = true;
+    s->state = state;
+    s->ts    = ts;
+}
+
+static void put_event(struct exporter *x,
+                      const struct timeline_event *ev,
+                      struct open_slice sync[2],
+                      struct open_slice worker[2],
+                      struct open_slice *bufs[2])
+{
+    const unsigned int dir = ev->dir & 1;
+
+    switch (ev->type) {
+        case TL_SYNC_STATE:
+            transition(x, &sync[dir], TRACK_SYNC + dir,
+                       NAME(sync_state_names, sync[dir].state), ev->a, ev->ts);
+            break;
+
+        case TL_SYNC_BUF: {
+            struct open_slice *s = &bufs[dir][ev->idx];
+
+            if (!s->valid) {
+                put_track_name(x, TRACK_BUF(dir) + ev->idx,
+                               dir == BLADERF_RX ? "RX buffer %u"
+                                                 : "TX buffer %u",
+                               ev->idx);
+            }
+
+            transition(x, s, TRACK_BUF(dir) + ev->idx,
+                       NAME(buf_status_names, s->state), ev->a, ev->ts);
+            break;
+        }
+
+        case TL_WORKER_STATE:
+            transition(x, &worker[dir], TRACK_WORKER + dir,
+                       NAME(worker_state_names, worker[dir].state), ev->a,
+                       ev->ts);
+            break;
+
+        case TL_CALLBACK:
+            put_slice(x, TRACK_CALLBACK + dir, "callback", ev->ts,
+                      ev->ts + ev->dur);
+            break;
+
+        case TL_CTRL:
+            begin_event(x, "X", TRACK_CTRL);
+            if (ev->a == BLADERF_CTRL_TRACE_NIOS) {
+                fprintf(x->f, ",\"name\":\"NIOS '%c'\"",
+                        (ev->b >= 0x20 && ev->b < 0x7f && ev->b != '"' &&
+                         ev->b != '\\')
+                            ? ev->b
+                            : '?');
+            } else {
+                fprintf(x->f, ",\"name\":\"Vendor 0x%02x\"", ev->b);
+            }
+            put_ts(x, "ts", ev->ts - x->origin);
+            put_ts(x, "dur", ev->dur);
+            fprintf(x->f,
+                    ",\"args\":{\"opcode\":%u,\"target\":%u,\"write\":%s,"
+                    "\"status\":%d}}",
+                    ev->b, ev->idx & 0xff, (ev->idx >> 8) ? "true" : "false",
+                    ev->status);
+            break;
+
+        case TL_RETUNE:
+            begin_event(x, "i", TRACK_RETUNE);
+            if ((bladerf_channel)ev->idx == BLADERF_CHANNEL_INVALID) {
+                fprintf(x->f, ",\"name\":\"Retune (RX/TX pair)\"");
+            } else {
+                fprintf(x->f, ",\"name\":\"Retune %s%u\"",
+                        dir2str(BLADERF_CHANNEL_IS_TX(ev->idx) ? BLADERF_TX
+                                                               : BLADERF_RX),
+                        (ev->idx >> 1) + 1);
+            }
+            put_ts(x, "ts", ev->ts - x->origin);
+            fprintf(x->f,
+                    ",\"s\":\"t\",\"args\":{\"timestamp\":%" PRIu64
+                    ",\"frequency\":%" PRIu64 ",\"status\":%d}}",
+                    ev->v0, ev->v1, ev->status);
+            break;
+
+        case TL_ERROR:
+            begin_event(x, "i", TRACK_SYNC + dir);
+            if (ev->status != 0) {
+                fprintf(x->f, ",\"name\":\"%s error: %s\"", dir2str(dir),
+                        bladerf_strerror(ev->status));
+            } else {
+                fprintf(x->f, ",\"name\":\"%s overrun\"", dir2str(dir));
+            }
+            put_ts(x, "ts", ev->ts - x->origin);
+            fprintf(x->f,
+                    ",\"s\":\"g\",\"args\":{\"status\":%d,"
+                    "\"meta_status\":%u}}",
+                    ev->status, ev->idx);
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void close_slice(struct exporter *x, struct open_slice *s,
+                        unsigned int tid, const char *name, uint64_t end)
+{
+    if (s->valid) {
+        put_slice(x, tid, name, s->ts, end);
+    }
+}
+
+static int export_events(FILE *f, const struct timeline_event *events,
+                         size_t n)
+{
+    struct exporter x;
+    struct open_slice sync[2], worker[2];
+    struct open_slice *bufs[2] = { NULL, NULL };
+    size_t num_bufs[2] = { 0, 0 };
+    uint64_t end = 0;
+    unsigned int dir;
+    size_t i;
+    int status = 0;
+
+    memset(sync, 0, sizeof(sync));
+    memset(worker, 0, sizeof(worker));
+
+    x.f      = f;
+    x.first  = true;
+    x.origin = (n != 0) ? events[0].ts : 0;
+
+    for (i = 0; i < n; i++) {
+        const uint64_t ev_end = events[i].ts + events[i].dur;
+
+        if (events[i].ts < x.origin) {
+            x.origin = events[i].ts;
+        }
+
+        if (ev_end > end) {
+            end = ev_end;
+        }
+
+        if (events[i].type == TL_SYNC_BUF &&
+            events[i].idx >= num_bufs[events[i].dir & 1]) {
+            num_bufs[events[i].dir & 1] = (size_t)events[i].idx + 1;
+        }
+    }
+
+    for (dir = 0; dir < 2; dir++) {
+        if (num_bufs[dir] != 0) {
+            bufs[dir] = calloc(num_bufs[dir], sizeof(bufs[dir][0]));
+            if (bufs[dir] == NULL) {
+                status = BLADERF_ERR_MEM;
+                goto out;
+            }
+        }
+    }
+
+    fprintf(f, "{\"displayTimeUnit\":\"ns\",");
+    fprintf(f, "\"otherData\":{\"origin_host_ns\":%" PRIu64 "},", x.origin);
+    fprintf(f, "\"traceEvents\":[");
+
+    begin_event(&x, "M", 0);
+    fprintf(f, ",\"name\":\"process_name\",\"args\":{\"name\":\"bladeRF\"}}");
+
+    for (dir = 0; dir < 2; dir++) {
+        const char *fmt_sync   = dir == BLADERF_RX ? "RX sync" : "TX sync";
+        const char *fmt_worker = dir == BLADERF_RX ? "RX worker" : "TX worker";
+        const char *fmt_cb =
+            dir == BLADERF_RX ? "RX callbacks" : "TX callbacks";
+
+        put_track_name(&x, TRACK_SYNC + dir, fmt_sync, 0);
+        put_track_name(&x, TRACK_WORKER + dir, fmt_worker, 0);
+        put_track_name(&x, TRACK_CALLBACK + dir, fmt_cb, 0);
+    }
+
+    put_track_name(&x, TRACK_CTRL, "Control", 0);
+    put_track_name(&x, TRACK_RETUNE, "Scheduled retunes", 0);
+
+    for (i = 0; i < n; i++) {
+        put_event(&x, &events[i], sync, worker, bufs);
+    }
+
+    for (dir = 0; dir < 2; dir++) {
+        close_slice(&x, &sync[dir], TRACK_SYNC + dir,
+                    NAME(sync_state_names, sync[dir].state), end);
+        close_slice(&x, &worker[dir], TRACK_WORKER + dir,
+                    NAME(worker_state_names, worker[dir].state), end);
+
+        for (i = 0; i < num_bufs[dir]; i++) {
+            close_slice(&x, &bufs[dir][i], TRACK_BUF(dir) + (unsigned int)i,
+                        NAME(buf_status_names, bufs[dir][i].state), end);
+        }
+    }
+
+    fprintf(f, "\n]}\n");
+
+out:
+    free(bufs[0]);
+    free(bufs[1]);
+    return status;
+}
+
+/* Copy out the retained events, oldest first, without removing them */
+static size_t snapshot(struct timeline *t, struct timeline_event *events)
+{
+    const uint64_t head =
+        atomic_load_explicit(&t->head, memory_order_acquire);
+    uint64_t idx = (head > BLADERF_TIMELINE_LEN) ? head - BLADERF_TIMELINE_LEN
+                                                 : 0;
+    size_t n = 0;
+
+    for (; idx != head; idx++) {
+        struct timeline_slot *slot = &t->slots[idx % BLADERF_TIMELINE_LEN];
+        const uint64_t published = 2 * idx + 2;
+
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) !=
+            published) {
+            /* Not yet published, or already overwritten */
+            continue;
+        }
+
+        events[n] = slot->ev;
+        atomic_thread_fence(memory_order_acquire);
+
+        if (atomic_load_explicit(&slot->seq, memory_order_relaxed) ==
+            published) {
+            n++;
+        }
+    }
+
+    return n;
+}
+
+static int dump(struct timeline *t, const char *path)
+{
+    struct timeline_event *events;
+    FILE *f;
+    size_t n;
+    int status;
+
+    events = malloc(BLADERF_TIMELINE_LEN * sizeof(events[0]));
+    if (events == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    n = snapshot(t, events);
+
+    f = fopen(path, "w");
+    if (f == NULL) {
+        log_debug("Failed to open %s: %s\n", path, strerror(errno));
+        free(events);
+        return BLADERF_ERR_IO;
+    }
+
+    status = export_events(f, events, n);
+
+    if (ferror(f)) {
+        status = BLADERF_ERR_IO;
+    }
+
+    if (fclose(f) != 0 && status == 0) {
+        status = BLADERF_ERR_IO;
+    }
+
+    free(events);
+
+    if (status == 0) {
+        log_debug("Wrote %zu timeline events to %s\n", n, path);
+    }
+
+    return status;
+}
+
+void timeline_sync_result(struct bladerf *dev,
+                          bladerf_direction dir,
+                          int status,
+                          uint32_t meta_status)
+{
+    struct timeline *t;
+    struct timeline_event ev;
+    char *path;
+
+    if ((status == 0 || status == BLADERF_ERR_WOULD_BLOCK ||
+         status == BLADERF_ERR_TIMEOUT) &&
+        (meta_status & (BLADERF_META_STATUS_OVERRUN |
+                        BLADERF_META_STATUS_UNDERRUN)) == 0) {
+        return;
+    }
+
+    t = get_enabled(dev);
+    if (t == NULL) {
+        return;
+    }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.ts     = wallclock_get_current_nsec();
+    ev.type   = TL_ERROR;
+    ev.dir    = (uint8_t)dir;
+    ev.idx    = meta_status;
+    ev.status = status;
+
+    record(t, &ev);
+
+    if (!atomic_exchange_explicit(&t->dump_armed, false,
+                                  memory_order_acquire)) {
+        return;
+    }
+
+    MUTEX_LOCK(&t->dump_lock);
+    path         = t->dump_path;
+    t->dump_path = NULL;
+    MUTEX_UNLOCK(&t->dump_lock);
+
+    if (path != NULL) {
+        status = dump(t, path);
+        if (status != 0) {
+            log_warning("Failed to write timeline to %s: %s\n", path,
+                        bladerf_strerror(status));
+        } else {
+            log_info("Wrote timeline to %s\n", path);
+        }
+
+        free(path);
+    }
+}
+
+int timeline_enable(struct bladerf *dev, bool enable)
+{
+    struct timeline *t = dev->timeline;
+
+    if (t == NULL) {
+        if (!enable) {
+            return 0;
+        }
+
+        t = calloc(1, sizeof(*t));
+        if (t == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+
+        MUTEX_INIT(&t->dump_lock);
+        atomic_init(&t->enabled, false);
+        atomic_init(&t->head, 0);
+        atomic_init(&t->dump_armed, false);
+
+        /* Publish the initialized ring to threads recording without the
+         * handle lock */
+        atomic_thread_fence(memory_order_release);
+        dev->timeline = t;
+    }
+
+    atomic_store_explicit(&t->enabled, enable, memory_order_relaxed);
+    log_debug("Stream timeline %s.\n", enable ? "enabled" : "disabled");
+
+    return 0;
+}
+
+int timeline_dump(struct bladerf *dev, const char *path)
+{
+    struct timeline *t = dev->timeline;
+
+    if (t == NULL) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return dump(t, path);
+}
+
+int timeline_set_error_dump(struct bladerf *dev, const char *path)
+{
+    struct timeline *t = dev->timeline;
+    char *copy = NULL;
+
+    if (t == NULL) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (path != NULL) {
+        copy = strdup(path);
+        if (copy == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+    }
+
+    MUTEX_LOCK(&t->dump_lock);
+    free(t->dump_path);
+    t->dump_path = copy;
+    atomic_store_explicit(&t->dump_armed, copy != NULL,
+                          memory_order_release);
+    MUTEX_UNLOCK(&t->dump_lock);
+
+    return 0;
+}
+
+void timeline_deinit(struct bladerf *dev)
+{
+    struct timeline *t = dev->timeline;
+
+    if (t != NULL) {
+        free(t->dump_path);
+        MUTEX_DESTROY(&t->dump_lock);
+        free(t);
+        dev->timeline = NULL;
+    }
+}
+
+#else
+
+uint64_t timeline_begin(struct bladerf *dev)
+{
+    return 0;
+}
+
+void timeline_sync_state(struct bladerf *dev,
+                         bladerf_direction dir,
+                         unsigned int state)
+{
+}
+
+void timeline_sync_buf(struct bladerf *dev,
+                       bladerf_direction dir,
+                       unsigned int idx,
+                       unsigned int status)
+{
+}
+
+void timeline_worker_state(struct bladerf *dev,
+                           bladerf_direction dir,
+                           unsigned int state)
+{
+}
+
+void timeline_callback(struct bladerf *dev,
+                       bladerf_direction dir,
+                       uint64_t start)
+{
+}
+
+void timeline_ctrl(struct bladerf *dev,
+                   uint64_t start,
+                   uint64_t end,
+                   bladerf_ctrl_trace_kind kind,
+                   uint8_t opcode,
+                   uint8_t target,
+                   bool write,
+                   int status)
+{
+}
+
+void timeline_retune(struct bladerf *dev,
+                     bladerf_channel ch,
+                     bladerf_timestamp timestamp,
+                     bladerf_frequency frequency,
+                     int status)
+{
+}
+
+void timeline_sync_result(struct bladerf *dev,
+                          bladerf_direction dir,
+                          int status,
+                          uint32_t meta_status)
+{
+}
+
+int timeline_enable(struct bladerf *dev, bool enable)
+{
+    log_debug("The stream timeline requires C11 atomics.\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int timeline_dump(struct bladerf *dev, const char *path)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int timeline_set_error_dump(struct bladerf *dev, const char *path)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+void timeline_deinit(struct bladerf *dev)
+{
+}
+
+#endif
@@ -0,0 +1,178 @@
+/**
+ * @file timeline.h
+ *
+ * @brief Stream timeline recorder
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_TIMELINE_H_
+#define HELPERS_TIMELINE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+/* The recording functions below are no-ops while the timeline is disabled,
+ * and may be called from any thread without the device's handle lock. */
+
+/**
+ * Begin timing an event
+ *
+ * @param       dev     Device handle
+ *
+ * @return The event's start time, or 0 if the timeline is disabled
+ */
+uint64_t timeline_begin(struct bladerf *dev);
+
+/**
+ * Record a transition of the sync interface's state machine
+ *
+ * @param       dev     Device handle
+ * @param[in]   dir     Direction of the sync interface
+ * @param[in]   state   New state, a sync_state value
+ */
+void timeline_sync_state(struct bladerf *dev,
+                         bladerf_direction dir,
+                         unsigned int state);
+
+/**
+ * Record a sync buffer's status change
+ *
+ * @param       dev     Device handle
+ * @param[in]   dir     Direction of the sync interface
+ * @param[in]   idx     Buffer index
+ * @param[in]   status  New status, a sync_buffer_status value
+ */
+void timeline_sync_buf(struct bladerf *dev,
+                       bladerf_direction dir,
+                       unsigned int idx,
+                       unsigned int status);
+
+/**
+ * Record a sync worker state change
+ *
+ * @param       dev     Device handle
+ * @param[in]   dir     Direction of the sync interface
+ * @param[in]   state   New state, a sync_worker_state value
+ */
+void timeline_worker_state(struct bladerf *dev,
+                           bladerf_direction dir,
+                           unsigned int state);
+
+/**
+ * Record a stream callback's execution. This is a no-op if `start` is 0.
+ *
+ * @param       dev     Device handle
+ * @param[in]   dir     Direction of the stream
+ * @param[in]   start   Value returned by timeline_begin() upon entry
+ */
+void timeline_callback(struct bladerf *dev,
+                       bladerf_direction dir,
+                       uint64_t start);
+
+/**
+ * Record a control transaction
+ *
+ * @param       dev     Device handle
+ * @param[in]   start   Time at which the transaction began
+ * @param[in]   end     Time at which the transaction completed
+ * @param[in]   kind    Transaction type
+ * @param[in]   opcode  NIOS II packet magic or vendor request
+ * @param[in]   target  NIOS II packet target ID, or 0
+ * @param[in]   write   Transaction writes to the device
+ * @param[in]   status  Transaction status
+ */
+void timeline_ctrl(struct bladerf *dev,
+                   uint64_t start,
+                   uint64_t end,
+                   bladerf_ctrl_trace_kind kind,
+                   uint8_t opcode,
+                   uint8_t target,
+                   bool write,
+                   int status);
+
+/**
+ * Record a scheduled retune
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel, or BLADERF_CHANNEL_INVALID for a pair
+ * @param[in]   timestamp   Device time at which the retune occurs
+ * @param[in]   frequency   Frequency, or 0 if given as a quick tune
+ * @param[in]   status      Scheduling status
+ */
+void timeline_retune(struct bladerf *dev,
+                     bladerf_channel ch,
+                     bladerf_timestamp timestamp,
+                     bladerf_frequency frequency,
+                     int status);
+
+/**
+ * Note the result of a sync call, recording an error and writing out a
+ * pending error dump if the call failed or reported an overrun
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Direction of the sync interface
+ * @param[in]   status      Call status
+ * @param[in]   meta_status Caller's metadata status flags, or 0
+ */
+void timeline_sync_result(struct bladerf *dev,
+                          bladerf_direction dir,
+                          int status,
+                          uint32_t meta_status);
+
+/**
+ * Enable or disable the timeline. Must be called with the device's handle
+ * lock held.
+ *
+ * @param       dev     Device handle
+ * @param[in]   enable  Enable the timeline
+ *
+ * @return 0 on success, BLADERF_ERR_MEM or BLADERF_ERR_UNSUPPORTED on failure
+ */
+int timeline_enable(struct bladerf *dev, bool enable);
+
+/**
+ * Write the retained events to a file
+ *
+ * @see bladerf_dump_timeline()
+ */
+int timeline_dump(struct bladerf *dev, const char *path);
+
+/**
+ * Arm or cancel the dump upon the next error
+ *
+ * @see bladerf_set_timeline_error_dump()
+ */
+int timeline_set_error_dump(struct bladerf *dev, const char *path);
+
+/**
+ * Free the device's timeline. The backend and sync interfaces must no longer
+ * be in use.
+ *
+ * @param       dev     Device handle
+ */
+void timeline_deinit(struct bladerf *dev);
+
+#endif
@@ -29,13 +29,61 @@
 
 #include <libbladeRF.h>
 
+#include "helpers/timeout.h"
+
+#if HAVE_PTHREAD_CONDATTR_SETCLOCK && defined(CLOCK_MONOTONIC)
+#   define TIMEOUT_CLOCK CLOCK_MONOTONIC
+#else
+#   define TIMEOUT_CLOCK CLOCK_REALTIME
+#endif
+
+int timeout_cond_init(pthread_cond_t *cond)
+{
+#if HAVE_PTHREAD_CONDATTR_SETCLOCK && defined(CLOCK_MONOTONIC)
+    pthread_condattr_t attr;
+    int status;
+
+    status = pthread_condattr_init(&attr);
+    if (status != 0) {
+        return status;
+    }
+
+    status = pthread_condattr_setclock(&attr, TIMEOUT_CLOCK);
+    if (status == 0) {
+        status = pthread_cond_init(cond, &attr);
+    }
+
+    pthread_condattr_destroy(&attr);
+    return status;
+#else
+    return pthread_cond_init(cond, NULL);
+#endif
+}
+
+uint64_t timeout_clock_get_nsec(void)
+{
+    struct timespec t;
+
+    if (clock_gettime(TIMEOUT_CLOCK, &t) != 0) {
+        return 0;
+    }
+
+    return (uint64_t)t.tv_sec * 1000000000ull + (uint64_t)t.tv_nsec;
+}
+
+void populate_abs_deadline(struct timespec *t, uint64_t deadline_ns)
+{
+    t->tv_sec  = (time_t)(deadline_ns / 1000000000ull);
+    t->tv_nsec = (long)(deadline_ns % 1000000000ull);
+}
+
 int populate_abs_timeout(struct timespec *t, unsigned int timeout_ms)
 {
     static const int nsec_per_sec = 1000 * 1000 * 1000;
     const unsigned int timeout_sec = timeout_ms / 1000;
     int status;
 
-    status = clock_gettime(CLOCK_REALTIME, t);
+    status = clock_gettime(TIMEOUT_CLOCK, t);
     if (status != 0) {
         return BLADERF_ERR_UNEXPECTED;
     } else {
@@ -27,8 +27,31 @@
 #ifndef HELPERS_TIMEOUT_H_
 #define HELPERS_TIMEOUT_H_
 
+#include <stdint.h>
+#include <pthread.h>
+
+/* Absolute timeouts are expressed against CLOCK_MONOTONIC where
+ * pthread_condattr_setclock() is available, so that they are unaffected by
+ * steps in the wall clock (e.g., by NTP). Elsewhere, CLOCK_REALTIME is
+ * used. */
+
 /**
- * Populate the provided timeval structure for the specified timeout
+ * Initialize a condition variable that is waited upon with absolute
+ * timeouts from this file
+ *
+ * @param[out]  cond        Condition variable to initialize
+ *
+ * @return 0 on success, or a pthread_cond_init() error code
+ */
+int timeout_cond_init(pthread_cond_t *cond);
+
+/**
+ * @return Current time of the timeout clock, in nanoseconds, or 0 on failure
+ */
+uint64_t timeout_clock_get_nsec(void);
+
+/**
+ * Populate the provided timespec structure for the specified timeout
  *
  * @param[out]  t_abs       Absolute timeout structure to populate
  * @param[in]   timeout_ms  Desired timeout in ms.
@@ -37,4 +60,12 @@
  */
 int populate_abs_timeout(struct timespec *t_abs, unsigned int timeout_ms);
 
+/**
+ * Populate the provided timespec structure for a deadline
+ *
+ * @param[out]  t_abs       Absolute timeout structure to populate
+ * @param[in]   deadline_ns Deadline, in nanoseconds of the timeout clock
+ */
+void populate_abs_deadline(struct timespec *t_abs, uint64_t deadline_ns);
+
 #endif
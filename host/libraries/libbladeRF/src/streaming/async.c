@@ -22,15 +22,20 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <string.h>
 
 #include "log.h"
+#include "rel_assert.h"
 
 #include "backend/usb/usb.h"
 
 #include "async.h"
+#include "metadata.h"
 #include "board/board.h"
+#include "helpers/alloc.h"
 #include "helpers/timeout.h"
 #include "helpers/have_cap.h"
+#include "helpers/thread_attrs.h"
 
 int async_init_stream(struct bladerf_stream **stream,
                       struct bladerf *dev,
@@ -39,11 +44,13 @@ int async_init_stream(struct bladerf_stream **stream,
                       size_t num_buffers,
                       bladerf_format format,
                       size_t samples_per_buffer,
+                      size_t granularity,
                       size_t num_transfers,
                       void *user_data)
 {
     struct bladerf_stream *lstream;
     size_t buffer_size_bytes;
+    bladerf_dev_speed speed;
     size_t i;
     int status = 0;
 
@@ -52,13 +59,15 @@ int async_init_stream(struct bladerf_stream **stream,
         return BLADERF_ERR_INVAL;
     }
 
-    if (samples_per_buffer < 1024 || samples_per_buffer % 1024 != 0) {
-        log_debug("samples_per_buffer must be multiples of 1024\n");
+    if (granularity == 0 || samples_per_buffer < granularity ||
+        samples_per_buffer % granularity != 0) {
+        log_debug("samples_per_buffer must be multiples of %u\n",
+                  (unsigned int)granularity);
         return BLADERF_ERR_INVAL;
     }
 
     /* Create a stream and populate it with the appropriate information */
-    lstream = malloc(sizeof(struct bladerf_stream));
+    lstream = alloc_malloc(sizeof(struct bladerf_stream));
 
     if (!lstream) {
         return BLADERF_ERR_MEM;
@@ -66,13 +75,13 @@ int async_init_stream(struct bladerf_stream **stream,
 
     MUTEX_INIT(&lstream->lock);
 
-    if (pthread_cond_init(&lstream->can_submit_buffer, NULL) != 0) {
-        free(lstream);
+    if (timeout_cond_init(&lstream->can_submit_buffer) != 0) {
+        alloc_free(lstream);
         return BLADERF_ERR_UNEXPECTED;
     }
 
-    if (pthread_cond_init(&lstream->stream_started, NULL) != 0) {
-        free(lstream);
+    if (timeout_cond_init(&lstream->stream_started) != 0) {
+        alloc_free(lstream);
         return BLADERF_ERR_UNEXPECTED;
     }
 
@@ -86,6 +95,22 @@ int async_init_stream(struct bladerf_stream **stream,
     lstream->cb = callback;
     lstream->user_data = user_data;
     lstream->buffers = NULL;
+    lstream->batch_cb = NULL;
+    lstream->batch_size = 1;
+    lstream->unbatched_cb = NULL;
+    lstream->rx_ts_valid = false;
+    lstream->rx_next_ts = 0;
+    memset(&lstream->stats, 0, sizeof(lstream->stats));
+    memcpy(lstream->thread_attrs, dev->stream_thread_attrs,
+           sizeof(lstream->thread_attrs));
+
+    if (dev->backend->get_device_speed(dev, &speed) != 0) {
+        speed = BLADERF_DEVICE_SPEED_HIGH;
+    }
+
+    lstream->msg_size = (speed == BLADERF_DEVICE_SPEED_SUPER)
+                            ? USB_MSG_SIZE_SS
+                            : USB_MSG_SIZE_HS;
 
     if (format == BLADERF_FORMAT_PACKET_META) {
         if (!have_cap_dev(dev, BLADERF_CAP_FW_SHORT_PACKET)) {
@@ -107,6 +132,11 @@ int async_init_stream(struct bladerf_stream **stream,
             buffer_size_bytes = sc16q11_to_bytes(samples_per_buffer);
             break;
 
+        case BLADERF_FORMAT_SC8_Q7:
+        case BLADERF_FORMAT_SC8_Q7_META:
+            buffer_size_bytes = sc8q7_to_bytes(samples_per_buffer);
+            break;
+
         case BLADERF_FORMAT_PACKET_META:
             buffer_size_bytes = samples_per_buffer;
             break;
@@ -116,13 +146,22 @@ int async_init_stream(struct bladerf_stream **stream,
             break;
     }
 
+    /* The buffers are allocated as a single contiguous region, such that a
+     * buffer's index may be computed from its address. The device's
+     * allocation policy determines what backs the region. */
+    memset(&lstream->mem, 0, sizeof(lstream->mem));
+
     if (!status) {
-        lstream->buffers = calloc(num_buffers, sizeof(lstream->buffers[0]));
+        lstream->buffers =
+            alloc_calloc(num_buffers, sizeof(lstream->buffers[0]));
         if (lstream->buffers) {
-            for (i = 0; i < num_buffers && !status; i++) {
-                lstream->buffers[i] = calloc(1, buffer_size_bytes);
-                if (!lstream->buffers[i]) {
-                    status = BLADERF_ERR_MEM;
+            status = stream_mem_alloc(dev, dev->stream_mem_flags,
+                                      num_buffers * buffer_size_bytes,
+                                      &lstream->mem);
+            if (!status) {
+                uint8_t *mem = lstream->mem.ptr;
+                for (i = 0; i < num_buffers; i++) {
+                    lstream->buffers[i] = mem + i * buffer_size_bytes;
                 }
             }
         } else {
@@ -132,16 +171,9 @@ int async_init_stream(struct bladerf_stream **stream,
 
     /* Clean up everything we've allocated if we hit any errors */
     if (status) {
-
-        if (lstream->buffers) {
-            for (i = 0; i < num_buffers; i++) {
-                free(lstream->buffers[i]);
-            }
-
-            free(lstream->buffers);
-        }
-
-        free(lstream);
+        stream_mem_free(dev, &lstream->mem);
+        alloc_free(lstream->buffers);
+        alloc_free(lstream);
     } else {
         /* Perform any backend-specific stream initialization */
         status = dev->backend->init_stream(lstream, num_transfers);
@@ -182,19 +214,203 @@ int async_get_transfer_timeout(struct bladerf_stream *stream,
     return 0;
 }
 
+int async_get_stats(struct bladerf_stream *stream,
+                    struct bladerf_stream_stats *stats)
+{
+    MUTEX_LOCK(&stream->lock);
+    *stats = stream->stats;
+    MUTEX_UNLOCK(&stream->lock);
+
+    return 0;
+}
+
+/* Deliver a single buffer to a batch callback, for backends (and stream
+ * phases) that do not accumulate completions */
+static void *batch_adapter(struct bladerf *dev,
+                           struct bladerf_stream *stream,
+                           struct bladerf_metadata *meta,
+                           void *samples,
+                           size_t num_samples,
+                           void *user_data)
+{
+    void *buffer = samples;
+
+    stream->batch_cb(dev, stream, meta, &buffer, 1, num_samples, user_data);
+
+    return buffer;
+}
+
+/* Number of bytes in each sample of a metadata format, or 0 for formats
+ * whose buffers are not divided into messages with sample headers */
+static inline size_t meta_bytes_per_sample(bladerf_format format)
+{
+    switch (format) {
+        case BLADERF_FORMAT_SC16_Q11_META:
+            return 2 * sizeof(int16_t);
+
+        case BLADERF_FORMAT_SC8_Q7_META:
+            return 2 * sizeof(int8_t);
+
+        default:
+            return 0;
+    }
+}
+
+void async_rx_metadata(struct bladerf_stream *stream,
+                       const void *buffer,
+                       size_t num_samples,
+                       struct bladerf_metadata *meta)
+{
+    const size_t bps      = meta_bytes_per_sample(stream->format);
+    const size_t msg_size = stream->msg_size;
+    const uint8_t *buf    = buffer;
+    size_t num_msgs, spm, i;
+    uint64_t ts_inc, ts;
+
+    memset(meta, 0, sizeof(*meta));
+
+    if ((stream->layout & BLADERF_DIRECTION_MASK) != BLADERF_RX || bps == 0 ||
+        buffer == NULL) {
+        return;
+    }
+
+    num_msgs = (num_samples * bps) / msg_size;
+    if (num_msgs == 0) {
+        return;
+    }
+
+    /* Timestamps advance once per sample pair when two channels are
+     * interleaved */
+    spm    = (msg_size - METADATA_HEADER_SIZE) / bps;
+    ts_inc = (stream->layout == BLADERF_RX_X2) ? spm / 2 : spm;
+
+    ts              = metadata_get_timestamp(buf);
+    meta->timestamp = ts;
+    meta->flags     = metadata_get_flags(buf);
+
+    if (stream->rx_ts_valid && ts > stream->rx_next_ts) {
+        meta->gap = ts - stream->rx_next_ts;
+    }
+
+    /* Only the samples that are contiguous with the first message's are
+     * reported, as with bladerf_sync_rx() */
+    for (i = 1; i < num_msgs; i++) {
+        const uint64_t msg_ts = metadata_get_timestamp(buf + i * msg_size);
+
+        if (msg_ts != ts + ts_inc) {
+            meta->status |= BLADERF_META_STATUS_OVERRUN;
+            break;
+        }
+
+        ts = msg_ts;
+    }
+
+    meta->actual_count = (unsigned int)(i * spm);
+
+    /* Track from the buffer's last message, such that a discontinuity
+     * within this buffer is not reported again as a gap by the next one */
+    ts = metadata_get_timestamp(buf + (num_msgs - 1) * msg_size);
+    stream->rx_next_ts  = ts + ts_inc;
+    stream->rx_ts_valid = true;
+}
+
+int async_get_msgs(struct bladerf_stream *stream,
+                   void *buffer,
+                   size_t num_samples,
+                   struct bladerf_stream_msg *msgs,
+                   size_t max_msgs)
+{
+    const size_t bps      = meta_bytes_per_sample(stream->format);
+    const size_t msg_size = stream->msg_size;
+    uint8_t *buf          = buffer;
+    size_t num_msgs, spm, i;
+
+    if (bps == 0) {
+        log_debug("Stream format does not carry message metadata.\n");
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    num_msgs = (num_samples * bps) / msg_size;
+    spm      = (msg_size - METADATA_HEADER_SIZE) / bps;
+
+    if (num_msgs > max_msgs) {
+        num_msgs = max_msgs;
+    }
+
+    for (i = 0; i < num_msgs; i++) {
+        uint8_t *msg = buf + i * msg_size;
+
+        msgs[i].timestamp   = metadata_get_timestamp(msg);
+        msgs[i].flags       = metadata_get_flags(msg);
+        msgs[i].samples     = msg + METADATA_HEADER_SIZE;
+        msgs[i].num_samples = (unsigned int)spm;
+    }
+
+    return (int)num_msgs;
+}
+
+int async_set_batch(struct bladerf_stream *stream,
+                    bladerf_stream_batch_cb callback,
+                    size_t max_batch)
+{
+    int status = 0;
+
+    if (callback != NULL && max_batch == 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (callback != NULL && stream->format == BLADERF_FORMAT_PACKET_META) {
+        log_debug("Batched callbacks are not supported for the packet meta "
+                  "format.\n");
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    MUTEX_LOCK(&stream->lock);
+
+    if (stream->state == STREAM_RUNNING ||
+        stream->state == STREAM_SHUTTING_DOWN) {
+        log_debug("Stream batching cannot be changed while running.\n");
+        status = BLADERF_ERR_INVAL;
+    } else if (callback != NULL) {
+        if (stream->batch_cb == NULL) {
+            stream->unbatched_cb = stream->cb;
+        }
+
+        stream->batch_cb   = callback;
+        stream->batch_size = max_batch;
+        stream->cb         = batch_adapter;
+    } else if (stream->batch_cb != NULL) {
+        stream->cb           = stream->unbatched_cb;
+        stream->batch_cb     = NULL;
+        stream->batch_size   = 1;
+        stream->unbatched_cb = NULL;
+    }
+
+    MUTEX_UNLOCK(&stream->lock);
+    return status;
+}
+
 int async_run_stream(struct bladerf_stream *stream, bladerf_channel_layout layout)
 {
     int status;
     struct bladerf *dev = stream->dev;
+    const bladerf_direction dir = layout & BLADERF_DIRECTION_MASK;
+    struct thread_attrs_saved saved_attrs;
+
+    /* The backend services the stream from this thread */
+    thread_attrs_apply(&stream->thread_attrs[dir], &saved_attrs);
 
     MUTEX_LOCK(&stream->lock);
     stream->layout = layout;
+    stream->rx_ts_valid = false;
     stream->state = STREAM_RUNNING;
     pthread_cond_signal(&stream->stream_started);
     MUTEX_UNLOCK(&stream->lock);
 
     status = dev->backend->stream(stream, layout);
 
+    thread_attrs_restore(&saved_attrs);
+
     /* Backend return value takes precedence over stream error status */
     return status == 0 ? stream->error_code : status;
 }
@@ -252,8 +468,6 @@ error:
 
 void async_deinit_stream(struct bladerf_stream *stream)
 {
-    size_t i;
-
     if (!stream) {
         log_debug("%s called with NULL stream\n", __FUNCTION__);
         return;
@@ -267,15 +481,14 @@ void async_deinit_stream(struct bladerf_stream *stream)
     /* Free up the backend data */
     stream->dev->backend->deinit_stream(stream);
 
-    /* Free up the buffers */
-    for (i = 0; i < stream->num_buffers; i++) {
-        free(stream->buffers[i]);
-    }
+    /* Return the buffers, which were allocated as a single region, to the
+     * device for reuse by a subsequent stream */
+    stream_mem_release(stream->dev, &stream->mem);
 
     /* Free up the pointer to the buffers */
-    free(stream->buffers);
+    alloc_free(stream->buffers);
 
     /* Free up the stream itself */
-    free(stream);
+    alloc_free(stream);
 }
 
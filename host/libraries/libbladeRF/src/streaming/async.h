@@ -29,6 +29,8 @@
 #include "thread.h"
 
 #include "format.h"
+#include "helpers/stream_mem.h"
+#include "helpers/wallclock.h"
 
 typedef enum {
     STREAM_IDLE,          /* Idle and initialized */
@@ -53,6 +55,9 @@ struct bladerf_stream {
     size_t num_buffers;
     void **buffers;
 
+    /* Region backing all of the buffers */
+    struct stream_mem mem;
+
     MUTEX lock;
 
     /* The following items must be accessed atomically */
@@ -61,8 +66,63 @@ struct bladerf_stream {
     pthread_cond_t can_submit_buffer;
     pthread_cond_t stream_started;
     void *backend_data;
+
+    /* Throughput and health counters. Backends update these in their
+     * callbacks, with stream->lock held. */
+    struct bladerf_stream_stats stats;
+
+    /* Thread attributes applied when the stream runs, indexed by direction.
+     * Captured from the device handle in async_init_stream(). */
+    struct bladerf_stream_thread_attrs thread_attrs[2];
+
+    /* Batched completion delivery, configured prior to running the stream.
+     * While batch_cb is set, `cb` adapts it for single-buffer delivery, and
+     * the caller's original callback is retained in `unbatched_cb`. */
+    bladerf_stream_batch_cb batch_cb;
+    size_t batch_size;
+    bladerf_stream_cb unbatched_cb;
+
+    /* Size of a metadata message, per the device speed. RX message headers
+     * are parsed to populate callback metadata, and rx_next_ts tracks the
+     * timestamp expected to follow the last buffer (while rx_ts_valid). */
+    size_t msg_size;
+    bool rx_ts_valid;
+    uint64_t rx_next_ts;
 };
 
+/* Record the completion of a transfer. Assumes stream->lock is held. */
+static inline void async_stats_transfer(struct bladerf_stream *s,
+                                        size_t requested,
+                                        size_t actual)
+{
+    s->stats.bytes += actual;
+    s->stats.transfers++;
+
+    if (actual != requested) {
+        s->stats.short_transfers++;
+    }
+}
+
+/* Record the time spent in a stream callback that was entered at
+ * start_ns (per wallclock_get_current_nsec). Assumes stream->lock is held. */
+static inline void async_stats_callback(struct bladerf_stream *s,
+                                        uint64_t start_ns)
+{
+    const uint64_t us = (wallclock_get_current_nsec() - start_ns) / 1000;
+    unsigned int bin = 0;
+
+    while (bin < (BLADERF_STREAM_STATS_LATENCY_BINS - 1) &&
+           (us >> bin) != 0) {
+        bin++;
+    }
+
+    s->stats.callback_latency[bin]++;
+
+    if (us > s->stats.callback_max_us) {
+        s->stats.callback_max_us = us;
+    }
+}
+
 /* Get the number of bytes per stream buffer */
 static inline size_t async_stream_buf_bytes(struct bladerf_stream *s)
 {
@@ -71,6 +131,12 @@ static inline size_t async_stream_buf_bytes(struct bladerf_stream *s)
     return samples_to_bytes(s->format, s->samples_per_buffer);
 }
 
+/* Buffers must ordinarily be a multiple of this many samples */
+#define ASYNC_BUFFER_GRANULARITY 1024
+
+/* The granularity argument is the multiple of samples that buffer_size must
+ * be. Callers other than those honoring a low-latency profile should pass
+ * ASYNC_BUFFER_GRANULARITY. */
 int async_init_stream(struct bladerf_stream **stream,
                       struct bladerf *dev,
                       bladerf_stream_cb callback,
@@ -78,6 +144,7 @@ int async_init_stream(struct bladerf_stream **stream,
                       size_t num_buffers,
                       bladerf_format format,
                       size_t buffer_size,
+                      size_t granularity,
                       size_t num_transfers,
                       void *user_data);
 
@@ -106,6 +173,32 @@ int async_submit_stream_buffer(struct bladerf_stream *stream,
                                bool nonblock);
 
 
+/* Snapshot the stream's counters. This acquires stream->lock. */
+int async_get_stats(struct bladerf_stream *stream,
+                    struct bladerf_stream_stats *stats);
+
+/* Select batched completion delivery. See bladerf_set_stream_batch(). */
+int async_set_batch(struct bladerf_stream *stream,
+                    bladerf_stream_batch_cb callback,
+                    size_t max_batch);
+
+/* Fill in the metadata for an RX stream's callback from the message headers
+ * of a completed buffer of num_samples (per bytes_to_samples()) samples.
+ * The metadata is zeroed for TX streams and formats without metadata.
+ * Assumes stream->lock is held, and that buffers are provided in the order
+ * they completed. */
+void async_rx_metadata(struct bladerf_stream *stream,
+                       const void *buffer,
+                       size_t num_samples,
+                       struct bladerf_metadata *meta);
+
+/* Index the messages of an RX buffer. See bladerf_get_stream_msgs(). */
+int async_get_msgs(struct bladerf_stream *stream,
+                   void *buffer,
+                   size_t num_samples,
+                   struct bladerf_stream_msg *msgs,
+                   size_t max_msgs);
+
 void async_deinit_stream(struct bladerf_stream *stream);
 
 #endif
@@ -44,6 +44,26 @@ static inline size_t bytes_to_sc16q11(size_t n_bytes)
     return n_bytes / sample_size;
 }
 
+/*
+ * Convert SC8Q7 samples to bytes
+ */
+static inline size_t sc8q7_to_bytes(size_t n_samples)
+{
+    const size_t sample_size = 2 * sizeof(int8_t);
+    assert(n_samples <= (SIZE_MAX / sample_size));
+    return n_samples * sample_size;
+}
+
+/*
+ * Convert bytes to SC8Q7 samples
+ */
+static inline size_t bytes_to_sc8q7(size_t n_bytes)
+{
+    const size_t sample_size = 2 * sizeof(int8_t);
+    assert((n_bytes % sample_size) == 0);
+    return n_bytes / sample_size;
+}
+
 /* Covert samples to bytes based upon the provided format */
 static inline size_t samples_to_bytes(bladerf_format format, size_t n)
 {
@@ -52,6 +72,10 @@ static inline size_t samples_to_bytes(bladerf_format format, size_t n)
         case BLADERF_FORMAT_SC16_Q11_META:
             return sc16q11_to_bytes(n);
 
+        case BLADERF_FORMAT_SC8_Q7:
+        case BLADERF_FORMAT_SC8_Q7_META:
+            return sc8q7_to_bytes(n);
+
         case BLADERF_FORMAT_PACKET_META:
             return n*4;
 
@@ -69,6 +93,10 @@ static inline size_t bytes_to_samples(bladerf_format format, size_t n)
         case BLADERF_FORMAT_SC16_Q11_META:
             return bytes_to_sc16q11(n);
 
+        case BLADERF_FORMAT_SC8_Q7:
+        case BLADERF_FORMAT_SC8_Q7_META:
+            return bytes_to_sc8q7(n);
+
         case BLADERF_FORMAT_PACKET_META:
             return (n+3)/4;
 
@@ -99,6 +99,12 @@
 
 #define METADATA_HEADER_SIZE (METADATA_FLAGS_OFFSET + METADATA_FLAGS_SIZE)
 
+/* Packets generated by the FPGA's RX burst gate */
+#define METADATA_PACKET_CORE_RX_BURST 0x01
+#define METADATA_PACKET_FLAG_BURST_START (1 << 0)
+#define METADATA_PACKET_FLAG_BURST_END (1 << 1)
+#define METADATA_PACKET_FLAG_DROPPED (1 << 2)
+
 static inline uint64_t metadata_get_timestamp(const uint8_t *header)
 {
     uint64_t ret;
@@ -170,6 +176,15 @@ static inline void metadata_set_packet(uint8_t *header,
     memcpy(&header[METADATA_FLAGS_OFFSET], &flags, METADATA_FLAGS_SIZE);
 }
 
+/* Update only the timestamp of a header previously filled in by
+ * metadata_set() or copied from one */
+static inline void metadata_set_timestamp(uint8_t *header, uint64_t timestamp)
+{
+    timestamp = HOST_TO_LE64(timestamp);
+    memcpy(&header[METADATA_TIMESTAMP_OFFSET], &timestamp,
+           METADATA_TIMESTAMP_SIZE);
+}
+
 static inline void metadata_set(uint8_t *header,
                                 uint64_t timestamp,
                                 uint32_t flags)
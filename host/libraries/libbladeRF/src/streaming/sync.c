@@ -30,15 +30,25 @@
 #endif
 #include "minmax.h"
 #include "rel_assert.h"
+#include "sample_convert.h"
 
 #include "async.h"
 #include "sync.h"
+#include "sync_resample.h"
+#include "sync_split.h"
+#include "sync_tap.h"
 #include "sync_worker.h"
 #include "metadata.h"
 
+#include "backend/usb/usb.h"
 #include "board/board.h"
 #include "helpers/timeout.h"
+#include "helpers/alloc.h"
 #include "helpers/have_cap.h"
+#include "helpers/interleave.h"
+#include "helpers/probes.h"
+#include "helpers/rx_agc.h"
+#include "helpers/sample_cal.h"
 
 #ifdef ENABLE_LIBBLADERF_SYNC_LOG_VERBOSE
 static inline void dump_buf_states(struct bladerf_sync *s)
@@ -112,6 +122,16 @@ static inline size_t samples2bytes(struct bladerf_sync *s, size_t n) {
     return s->stream_config.bytes_per_sample * n;
 }
 
+static inline size_t user_samples2bytes(struct bladerf_sync *s, size_t n) {
+    return s->stream_config.user_bytes_per_sample * n;
+}
+
+/* Sample formats carried in messages with a metadata header */
+static inline bool uses_sample_meta(struct bladerf_sync *s) {
+    return s->stream_config.format == BLADERF_FORMAT_SC16_Q11_META ||
+           s->stream_config.format == BLADERF_FORMAT_SC8_Q7_META;
+}
+
 static inline unsigned int msg_per_buf(size_t msg_size, size_t buf_size,
                                        size_t bytes_per_sample)
 {
@@ -140,7 +160,8 @@ int sync_init(struct bladerf_sync *sync,
 
 {
     int status = 0;
-    size_t i, bytes_per_sample;
+    size_t i, bytes_per_sample, granularity;
+    bool convert_cf32 = false;
 
     if (num_transfers >= num_buffers) {
         return BLADERF_ERR_INVAL;
@@ -167,14 +188,44 @@ int sync_init(struct bladerf_sync *sync,
             bytes_per_sample = 4;
             break;
 
+        case BLADERF_FORMAT_SC8_Q7:
+        case BLADERF_FORMAT_SC8_Q7_META:
+            bytes_per_sample = 2;
+            break;
+
+        /* CF32 is converted to/from SC16Q11 on the host */
+        case BLADERF_FORMAT_CF32:
+            format           = BLADERF_FORMAT_SC16_Q11;
+            bytes_per_sample = 4;
+            convert_cf32     = true;
+            break;
+
+        case BLADERF_FORMAT_CF32_META:
+            format           = BLADERF_FORMAT_SC16_Q11_META;
+            bytes_per_sample = 4;
+            convert_cf32     = true;
+            break;
+
         default:
             log_debug("Invalid format value: %d\n", format);
             return BLADERF_ERR_INVAL;
     }
 
-    /* bladeRF GPIF DMA requirement */
-    if ((bytes_per_sample * buffer_size) % 4096 != 0) {
-        return BLADERF_ERR_INVAL;
+    /* bladeRF GPIF DMA requirement. The low-latency profile relaxes this to
+     * the FX3's DMA buffer size, which is one USB message. */
+    if (dev->sync_low_latency[layout & BLADERF_DIRECTION_MASK]) {
+        if (msg_size == 0 || msg_size % bytes_per_sample != 0 ||
+            buffer_size == 0 || (bytes_per_sample * buffer_size) % msg_size) {
+            return BLADERF_ERR_INVAL;
+        }
+
+        granularity = msg_size / bytes_per_sample;
+    } else {
+        if ((bytes_per_sample * buffer_size) % 4096 != 0) {
+            return BLADERF_ERR_INVAL;
+        }
+
+        granularity = ASYNC_BUFFER_GRANULARITY;
     }
 
     /* Deinitialize sync handle if it's initialized */
@@ -182,6 +233,11 @@ int sync_init(struct bladerf_sync *sync,
 
     MUTEX_INIT(&sync->lock);
 
+    sync->buf_mgmt.dir = layout & BLADERF_DIRECTION_MASK;
+    sync->buf_mgmt.dev = dev;
+    sync->buf_mgmt.duplex = NULL;
+    memset(&sync->buf_mgmt.poll, 0, sizeof(sync->buf_mgmt.poll));
+
     switch (layout & BLADERF_DIRECTION_MASK) {
         case BLADERF_TX:
             sync->buf_mgmt.submitter = SYNC_TX_SUBMITTER_FN;
@@ -192,6 +248,7 @@ int sync_init(struct bladerf_sync *sync,
     }
 
     sync->dev = dev;
+    dev->sync_auto[layout & BLADERF_DIRECTION_MASK].sync = sync;
     sync->state = SYNC_STATE_CHECK_WORKER;
 
     sync->buf_mgmt.num_buffers = num_buffers;
@@ -202,13 +259,30 @@ int sync_init(struct bladerf_sync *sync,
     sync->stream_config.samples_per_buffer = (unsigned int)buffer_size;
     sync->stream_config.num_xfers = num_transfers;
     sync->stream_config.timeout_ms = stream_timeout;
+    sync->stream_config.granularity = (unsigned int)granularity;
     sync->stream_config.bytes_per_sample = bytes_per_sample;
+    sync->stream_config.convert_cf32 = convert_cf32;
+    sync->stream_config.user_bytes_per_sample =
+        convert_cf32 ? 2 * sizeof(float) : bytes_per_sample;
 
     sync->meta.state = SYNC_META_STATE_HEADER;
+    sync->meta.ts_valid = false;
+    sync->meta.pending_gap = 0;
+    sync->meta.rate_change_ts = UINT64_MAX;
+    sync->meta.rate_change_rate = 0;
+    sync->meta.rate_change_due = 0;
     sync->meta.msg_size = msg_size;
     sync->meta.msg_per_buf = msg_per_buf(msg_size, buffer_size, bytes_per_sample);
     sync->meta.samples_per_msg = samples_per_msg(msg_size, bytes_per_sample);
 
+    assert(sizeof(sync->meta.tx_header) == METADATA_HEADER_SIZE);
+    metadata_set(sync->meta.tx_header, 0, 0);
+
+    sync->lease.active = false;
+    sync->lease.samples = NULL;
+    sync->lease.num_samples = 0;
+    sync->lease.have_timestamp = false;
+
     log_verbose("%s: Buffer size (in bytes): %u\n",
                 __FUNCTION__, buffer_size * bytes_per_sample);
 
@@ -222,20 +296,37 @@ int sync_init(struct bladerf_sync *sync,
                 __FUNCTION__, sync->meta.samples_per_msg);
 
     MUTEX_INIT(&sync->buf_mgmt.lock);
-    pthread_cond_init(&sync->buf_mgmt.buf_ready, NULL);
+    timeout_cond_init(&sync->buf_mgmt.buf_ready);
+#if SYNC_HAVE_ATOMICS
+    atomic_init(&sync->buf_mgmt.signal_count, 0);
+#endif
 
-    sync->buf_mgmt.status = (sync_buffer_status*) malloc(num_buffers * sizeof(sync_buffer_status));
+    sync->buf_mgmt.status = (sync_buffer_status*) alloc_malloc(num_buffers * sizeof(sync_buffer_status));
     if (sync->buf_mgmt.status == NULL) {
         status = BLADERF_ERR_MEM;
         goto error;
     }
 
-    sync->buf_mgmt.actual_lengths = (size_t *) malloc(num_buffers * sizeof(size_t));
+    sync->buf_mgmt.actual_lengths = (size_t *) alloc_malloc(num_buffers * sizeof(size_t));
     if (sync->buf_mgmt.actual_lengths == NULL) {
         status = BLADERF_ERR_MEM;
         goto error;
     }
 
+    sync->buf_mgmt.full_since = (uint64_t *) alloc_calloc(num_buffers, sizeof(uint64_t));
+    if (sync->buf_mgmt.full_since == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto error;
+    }
+
+    sync->buf_mgmt.last_full     = 0;
+    sync->buf_mgmt.full_interval = 0;
+    sync->buf_mgmt.last_wait     = 0;
+
+    memset(&sync->stats, 0, sizeof(sync->stats));
+
+    sync->deadline_ns = 0;
+
     switch (layout & BLADERF_DIRECTION_MASK) {
         case BLADERF_RX:
             /* When starting up an RX stream, the first 'num_transfers'
@@ -246,15 +337,28 @@ int sync_init(struct bladerf_sync *sync,
 
             for (i = 0; i < num_buffers; i++) {
                 if (i < num_transfers) {
-                    sync->buf_mgmt.status[i] = SYNC_BUFFER_IN_FLIGHT;
+                    sync_buf_set_status(&sync->buf_mgmt, i,
+                                        SYNC_BUFFER_IN_FLIGHT);
                 } else {
-                    sync->buf_mgmt.status[i] = SYNC_BUFFER_EMPTY;
+                    sync_buf_set_status(&sync->buf_mgmt, i, SYNC_BUFFER_EMPTY);
                 }
             }
 
             sync->meta.msg_timestamp = 0;
             sync->meta.msg_flags = 0;
 
+            if (uses_sample_meta(sync) && sync->meta.msg_per_buf != 0) {
+                sync->meta.rx_index = (struct sync_msg_info *)
+                    alloc_calloc(sync->meta.msg_per_buf, sizeof(sync->meta.rx_index[0]));
+
+                if (sync->meta.rx_index == NULL) {
+                    status = BLADERF_ERR_MEM;
+                    goto error;
+                }
+            } else {
+                sync->meta.rx_index = NULL;
+            }
+
             break;
 
         case BLADERF_TX:
@@ -263,11 +367,12 @@ int sync_init(struct bladerf_sync *sync,
             sync->buf_mgmt.partial_off = 0;
 
             for (i = 0; i < num_buffers; i++) {
-                sync->buf_mgmt.status[i] = SYNC_BUFFER_EMPTY;
+                sync_buf_set_status(&sync->buf_mgmt, i, SYNC_BUFFER_EMPTY);
             }
 
             sync->meta.in_burst = false;
             sync->meta.now = false;
+            sync->meta.rx_index = NULL;
             break;
     }
 
@@ -276,8 +381,25 @@ int sync_init(struct bladerf_sync *sync,
         goto error;
     }
 
+    sync_capture_init(sync);
+
     sync->initialized = true;
 
+    status = sync_split_init(sync);
+    if (status != 0) {
+        goto error;
+    }
+
+    status = sync_tap_init(sync);
+    if (status != 0) {
+        goto error;
+    }
+
+    status = sync_resample_init(sync);
+    if (status != 0) {
+        goto error;
+    }
+
     return 0;
 
 error:
@@ -288,6 +410,9 @@ error:
 void sync_deinit(struct bladerf_sync *sync)
 {
     if (sync->initialized) {
+        /* Stop the per-channel queues' worker before its stream */
+        sync_split_deinit(sync);
+
         if ((sync->stream_config.layout & BLADERF_DIRECTION_MASK) == BLADERF_TX) {
             async_submit_stream_buffer(sync->worker->stream,
                                        BLADERF_STREAM_SHUTDOWN, NULL, 0, false);
@@ -296,43 +421,301 @@ void sync_deinit(struct bladerf_sync *sync)
         sync_worker_deinit(sync->worker, &sync->buf_mgmt.lock,
                            &sync->buf_mgmt.buf_ready);
 
+        sync_tap_deinit(sync);
+        sync_resample_deinit(sync);
+
         if (sync->buf_mgmt.actual_lengths) {
-            free(sync->buf_mgmt.actual_lengths);
+            alloc_free(sync->buf_mgmt.actual_lengths);
         }
+        alloc_free(sync->buf_mgmt.full_since);
+        alloc_free(sync->meta.rx_index);
         /* De-allocate our buffer management resources */
         if (sync->buf_mgmt.status) {
             MUTEX_DESTROY(&sync->buf_mgmt.lock);
-            free(sync->buf_mgmt.status);
+            alloc_free(sync->buf_mgmt.status);
         }
 
+        sync_capture_deinit(sync);
+        poll_event_deinit(&sync->buf_mgmt.poll);
+
         MUTEX_DESTROY(&sync->lock);
 
         sync->initialized = false;
     }
 }
 
+/* Default target for the time spanned by in-flight transfers */
+#define SYNC_AUTO_DEFAULT_LATENCY_US 10000
+
+/* Preferred number of transfers, and the limits upon it */
+#define SYNC_AUTO_XFERS     8
+#define SYNC_AUTO_XFERS_MIN 4
+#define SYNC_AUTO_XFERS_MAX 32
+
+/* The low-latency profile pipelines many single-message transfers */
+#define SYNC_AUTO_LL_XFERS     32
+#define SYNC_AUTO_LL_XFERS_MAX 64
+#define SYNC_AUTO_LL_MSGS_MAX  8
+
+int sync_auto_config(struct bladerf *dev,
+                     bladerf_channel_layout layout,
+                     bladerf_format format,
+                     unsigned int latency_us,
+                     unsigned int *num_buffers,
+                     unsigned int *buffer_size,
+                     unsigned int *num_transfers)
+{
+    const bladerf_direction dir = layout & BLADERF_DIRECTION_MASK;
+    const bladerf_channel ch =
+        (dir == BLADERF_TX) ? BLADERF_CHANNEL_TX(0) : BLADERF_CHANNEL_RX(0);
+    const unsigned int num_channels =
+        (layout == BLADERF_RX_X2 || layout == BLADERF_TX_X2) ? 2 : 1;
+    bladerf_sample_rate rate;
+    bladerf_dev_speed speed;
+    size_t bytes_per_sample;
+    uint64_t in_flight, buf, xfers;
+    unsigned int granularity, max_buf, pref_xfers, max_xfers;
+    int status;
+
+    switch (format) {
+        case BLADERF_FORMAT_SC16_Q11:
+        case BLADERF_FORMAT_SC16_Q11_META:
+        case BLADERF_FORMAT_CF32:
+        case BLADERF_FORMAT_CF32_META:
+            bytes_per_sample = 4;
+            break;
+
+        case BLADERF_FORMAT_SC8_Q7:
+        case BLADERF_FORMAT_SC8_Q7_META:
+            bytes_per_sample = 2;
+            break;
+
+        default:
+            log_debug("Automatic sync sizing is not supported for format "
+                      "%d.\n", format);
+            return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (dev->sync_auto[dir].num_buffers != 0) {
+        *num_buffers   = dev->sync_auto[dir].num_buffers;
+        *buffer_size   = dev->sync_auto[dir].buffer_size;
+        *num_transfers = dev->sync_auto[dir].num_transfers;
+
+        log_debug("%s: using preset sizing: %u buffers, %u samples, "
+                  "%u transfers\n", __FUNCTION__, *num_buffers,
+                  *buffer_size, *num_transfers);
+        return 0;
+    }
+
+    status = dev->board->get_sample_rate(dev, ch, &rate);
+    if (status != 0) {
+        return status;
+    }
+
+    status = dev->backend->get_device_speed(dev, &speed);
+    if (status != 0) {
+        speed = BLADERF_DEVICE_SPEED_HIGH;
+    }
+
+    if (latency_us == 0) {
+        latency_us = SYNC_AUTO_DEFAULT_LATENCY_US;
+    }
+
+    if (dev->sync_low_latency[dir]) {
+        /* Buffers need only be a multiple of the USB message size, and are
+         * capped at a few messages so that many may be in flight. */
+        const size_t msg_size = (speed == BLADERF_DEVICE_SPEED_SUPER)
+                                    ? USB_MSG_SIZE_SS
+                                    : USB_MSG_SIZE_HS;
+
+        granularity = (unsigned int)(msg_size / bytes_per_sample);
+        max_buf     = granularity * SYNC_AUTO_LL_MSGS_MAX;
+        pref_xfers  = SYNC_AUTO_LL_XFERS;
+        max_xfers   = SYNC_AUTO_LL_XFERS_MAX;
+    } else {
+        /* Buffers must be a multiple of 1024 samples, and of the GPIF DMA
+         * transfer size. Smaller transfers suit USB 2.0's lower bandwidth. */
+        granularity = (unsigned int)(4096 / bytes_per_sample);
+        if (granularity < ASYNC_BUFFER_GRANULARITY) {
+            granularity = ASYNC_BUFFER_GRANULARITY;
+        }
+
+        max_buf    = (speed == BLADERF_DEVICE_SPEED_SUPER) ? 32768 : 8192;
+        pref_xfers = SYNC_AUTO_XFERS;
+        max_xfers  = SYNC_AUTO_XFERS_MAX;
+    }
+
+    /* Samples spanned by the target latency, spread over the preferred
+     * number of transfers */
+    in_flight = (uint64_t)rate * num_channels * latency_us / 1000000;
+
+    buf = (in_flight / pref_xfers + granularity - 1) / granularity;
+    buf *= granularity;
+    buf = u64_max(u64_min(buf, max_buf), granularity);
+
+    xfers = (in_flight + buf / 2) / buf;
+    xfers = u64_max(u64_min(xfers, max_xfers), SYNC_AUTO_XFERS_MIN);
+
+    *buffer_size   = (unsigned int)buf;
+    *num_transfers = (unsigned int)xfers;
+    *num_buffers   = (unsigned int)(2 * xfers);
+
+    log_debug("%s: %u Hz x%u, %u us target: %u buffers, %u samples, "
+              "%u transfers\n", __FUNCTION__, rate, num_channels,
+              latency_us, *num_buffers, *buffer_size, *num_transfers);
+
+    return 0;
+}
+
+void sync_auto_retune(struct bladerf *dev, bladerf_direction dir)
+{
+    struct sync_auto *a = &dev->sync_auto[dir];
+    struct bladerf_sync *sync = a->sync;
+    unsigned int num_buffers, buffer_size, num_transfers;
+    int status;
+
+    if (!a->enabled || sync == NULL || !sync->initialized) {
+        return;
+    }
+
+    if (sync_worker_get_state(sync->worker, NULL) != SYNC_WORKER_STATE_IDLE) {
+        log_debug("%s: stream is active; keeping its current sizing.\n",
+                  __FUNCTION__);
+        return;
+    }
+
+    status = sync_auto_config(dev, a->layout, a->format, a->latency_us,
+                              &num_buffers, &buffer_size, &num_transfers);
+    if (status != 0) {
+        return;
+    }
+
+    if (num_buffers == sync->buf_mgmt.num_buffers &&
+        buffer_size == sync->stream_config.samples_per_buffer &&
+        num_transfers == sync->stream_config.num_xfers) {
+        return;
+    }
+
+    status = dev->board->sync_config(dev, a->layout, a->format, num_buffers,
+                                     buffer_size, num_transfers,
+                                     a->stream_timeout);
+    if (status != 0) {
+        log_warning("Failed to resize sync interface: %s\n",
+                    bladerf_strerror(status));
+        a->enabled = false;
+    }
+}
+
+void sync_rate_change(struct bladerf_sync *sync,
+                      uint64_t timestamp,
+                      bladerf_sample_rate rate)
+{
+    if (!sync->initialized || !uses_sample_meta(sync)) {
+        return;
+    }
+
+    MUTEX_LOCK(&sync->buf_mgmt.lock);
+    sync->meta.rate_change_ts = timestamp;
+    sync->meta.rate_change_rate = rate;
+    MUTEX_UNLOCK(&sync->buf_mgmt.lock);
+}
+
+#ifndef SYNC_SPIN_WAIT_US
+#   define SYNC_SPIN_WAIT_US 0
+#endif
+
+#if SYNC_HAVE_ATOMICS && (SYNC_SPIN_WAIT_US > 0)
+/* Busy-wait (with the buffer lock dropped) for up to SYNC_SPIN_WAIT_US, but
+ * not beyond deadline_ns if non-zero, for the worker to signal buf_ready.
+ * This avoids the sleep/wakeup latency of the condition variable when buffers
+ * are being handed off at a high rate.
+ *
+ * Assumes the buffer lock is held. Returns true if a signal occurred,
+ * including one that raced with re-acquiring the lock. */
+static bool spin_for_buffer(struct buffer_mgmt *b, uint64_t deadline_ns)
+{
+    const unsigned int count =
+        atomic_load_explicit(&b->signal_count, memory_order_relaxed);
+    uint64_t spin_until =
+        timeout_clock_get_nsec() + (uint64_t)SYNC_SPIN_WAIT_US * 1000;
+    bool signaled = false;
+    unsigned int i = 0;
+
+    if (deadline_ns != 0 && deadline_ns < spin_until) {
+        spin_until = deadline_ns;
+    }
+
+    MUTEX_UNLOCK(&b->lock);
+
+    do {
+        signaled = atomic_load_explicit(&b->signal_count,
+                                        memory_order_acquire) != count;
+
+        /* Only consult the clock periodically */
+    } while (!signaled &&
+             ((++i & 0x3f) != 0 || timeout_clock_get_nsec() < spin_until));
+
+    MUTEX_LOCK(&b->lock);
+
+    /* Signals are issued with the lock held, so any that landed after the
+     * last poll are visible now, and any later one will wake buf_ready */
+    return signaled || atomic_load_explicit(&b->signal_count,
+                                            memory_order_relaxed) != count;
+}
+#endif
+
+/* Wait for buf_ready until deadline_ns, if non-zero, or otherwise for up to
+ * timeout_ms (0 = forever). Assumes the buffer lock is held. */
 static int wait_for_buffer(struct buffer_mgmt *b,
                            unsigned int timeout_ms,
+                           uint64_t deadline_ns,
                            const char *dbg_name,
                            unsigned int dbg_idx)
 {
     int status;
     struct timespec timeout;
+    uint64_t until_ns = deadline_ns;
+
+    PROBE2(sync_wait_start, b->dir, dbg_idx);
+
+    /* Fix the end of the wait before spinning, so that time spent spinning
+     * counts against the timeout */
+    if (until_ns == 0 && timeout_ms != 0) {
+        until_ns = timeout_clock_get_nsec() + (uint64_t)timeout_ms * 1000000;
+    }
+
+#if SYNC_HAVE_ATOMICS && (SYNC_SPIN_WAIT_US > 0)
+    /* Callers re-check the buffer status upon a successful return, so
+     * treat a signal observed while spinning as a wakeup. */
+    if (spin_for_buffer(b, until_ns)) {
+        PROBE3(sync_wait_done, b->dir, dbg_idx, 0);
+        return 0;
+    }
+#endif
 
-    if (timeout_ms == 0) {
+    if (until_ns == 0) {
         log_verbose("%s: Infinite wait for buffer[%d] (status: %d).\n",
                     dbg_name, dbg_idx, b->status[dbg_idx]);
         status = pthread_cond_wait(&b->buf_ready, &b->lock);
     } else {
-        log_verbose("%s: Timed wait for buffer[%d] (status: %d).\n", dbg_name,
-                    dbg_idx, b->status[dbg_idx]);
-        status = populate_abs_timeout(&timeout, timeout_ms);
-        if (status == 0) {
-            status = pthread_cond_timedwait(&b->buf_ready, &b->lock, &timeout);
+        if (deadline_ns != 0) {
+            log_verbose("%s: Wait for buffer[%d] until deadline "
+                        "(status: %d).\n", dbg_name, dbg_idx,
+                        b->status[dbg_idx]);
+        } else {
+            log_verbose("%s: Timed wait for buffer[%d] (status: %d).\n",
+                        dbg_name, dbg_idx, b->status[dbg_idx]);
         }
+
+        populate_abs_deadline(&timeout, until_ns);
+        status = pthread_cond_timedwait(&b->buf_ready, &b->lock, &timeout);
     }
 
-    if (status == ETIMEDOUT) {
+    if (status == ETIMEDOUT && deadline_ns != 0) {
+        log_debug("%s: Deadline passed waiting for buf_ready\n",
+                  __FUNCTION__);
+        status = BLADERF_ERR_TIMEOUT;
+    } else if (status == ETIMEDOUT) {
         log_error("%s: Timed out waiting for buf_ready after %d ms\n",
                   __FUNCTION__, timeout_ms);
         status = BLADERF_ERR_TIMEOUT;
@@ -340,6 +723,127 @@ static int wait_for_buffer(struct buffer_mgmt *b,
         status = BLADERF_ERR_UNEXPECTED;
     }
 
+    PROBE3(sync_wait_done, b->dir, dbg_idx, status);
+    return status;
+}
+
+/* Transition the API-side state machine. Assumes the sync handle lock is
+ * held. */
+static inline void set_state(struct bladerf_sync *s, sync_state state)
+{
+    PROBE3(sync_state, s->buf_mgmt.dir, s->state, state);
+    timeline_sync_state(s->dev, s->buf_mgmt.dir, state);
+    s->state = state;
+}
+
+/* Whether the caller has requested non-blocking operation. See
+ * bladerf_set_sync_nonblocking(). */
+static inline bool nonblocking(struct bladerf_sync *s)
+{
+    return s->dev->sync_nonblock[s->buf_mgmt.dir];
+}
+
+/* Update the readiness handle upon the API side changing buffer states.
+ * Assumes sync->lock is held, which serializes creation of the handle. */
+static inline void api_poll_update(struct bladerf_sync *s)
+{
+    if (s->buf_mgmt.poll.valid) {
+        MUTEX_LOCK(&s->buf_mgmt.lock);
+        sync_buf_poll_update(&s->buf_mgmt);
+        MUTEX_UNLOCK(&s->buf_mgmt.lock);
+    }
+}
+
+/* Number of samples, as provided to the caller, held by one buffer */
+static inline unsigned int buffer_user_samples(struct bladerf_sync *s)
+{
+    if (uses_sample_meta(s)) {
+        return s->meta.msg_per_buf * s->meta.samples_per_msg;
+    }
+
+    return s->stream_config.samples_per_buffer;
+}
+
+/* Check, for non-blocking operation, that `needed` contiguous samples may be
+ * received (RX) or transmitted (TX) using the buffers presently available to
+ * the API side. Not applicable to BLADERF_FORMAT_PACKET_META.
+ *
+ * Assumes sync->lock is held, and that the stream is running.
+ *
+ * Returns 0 if so, BLADERF_ERR_WOULD_BLOCK if buffers must be waited upon,
+ * or BLADERF_ERR_INVAL if all of the buffers would not suffice. */
+static int check_ready(struct bladerf_sync *s, uint64_t needed)
+{
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    const unsigned int per_buf = buffer_user_samples(s);
+    const sync_buffer_status ready =
+        (b->dir == BLADERF_RX) ? SYNC_BUFFER_FULL : SYNC_BUFFER_EMPTY;
+    uint64_t avail   = 0;
+    unsigned int idx = (b->dir == BLADERF_RX) ? b->cons_i : b->prod_i;
+    unsigned int i;
+
+    if (needed > (uint64_t)per_buf * b->num_buffers) {
+        log_debug("%s: %" PRIu64 " samples exceed the buffered capacity.\n",
+                  __FUNCTION__, needed);
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&b->lock);
+
+    /* Remainder of the buffer in use */
+    if (s->state == SYNC_STATE_USING_BUFFER) {
+        avail = s->stream_config.samples_per_buffer - b->partial_off;
+        idx   = (idx + 1) % b->num_buffers;
+    } else if (s->state == SYNC_STATE_USING_BUFFER_META) {
+        avail = (uint64_t)(s->meta.msg_per_buf - s->meta.msg_num) *
+                s->meta.samples_per_msg;
+
+        if (s->meta.state == SYNC_META_STATE_SAMPLES) {
+            avail -= s->meta.curr_msg_off;
+        }
+
+        idx = (idx + 1) % b->num_buffers;
+    }
+
+    for (i = 0; avail < needed && i < b->num_buffers &&
+                b->status[idx] == ready; i++) {
+        avail += per_buf;
+        idx = (idx + 1) % b->num_buffers;
+    }
+
+    MUTEX_UNLOCK(&b->lock);
+
+    return (avail >= needed) ? 0 : BLADERF_ERR_WOULD_BLOCK;
+}
+
+int sync_get_poll_handle(struct bladerf_sync *s, bladerf_poll_handle *handle)
+{
+    int status = 0;
+
+    if (s->split != NULL) {
+        log_debug("%s: Per-channel queues are in use.\n", __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    } else if (s->tap != NULL) {
+        log_debug("%s: RX taps are in use.\n", __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    } else if (s->resample != NULL) {
+        log_debug("%s: The RX resampler is in use.\n", __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    MUTEX_LOCK(&s->lock);
+
+    if (!s->buf_mgmt.poll.valid) {
+        status = poll_event_init(&s->buf_mgmt.poll);
+    }
+
+    if (status == 0) {
+        api_poll_update(s);
+        *handle = poll_event_handle(&s->buf_mgmt.poll);
+    }
+
+    MUTEX_UNLOCK(&s->lock);
+
     return status;
 }
 
@@ -356,11 +860,35 @@ static inline unsigned int left_in_msg(struct bladerf_sync *s)
     return (unsigned int) ret;
 }
 
+/* Check whether the current RX message is the first at a new sample rate.
+ * Assumes the buffer lock is held. */
+static inline bool rx_rate_change_reached(struct bladerf_sync *s)
+{
+    if (s->meta.msg_timestamp < s->meta.rate_change_ts) {
+        return false;
+    }
+
+    s->meta.rate_change_ts = UINT64_MAX;
+    s->meta.rate_change_due = s->meta.rate_change_rate;
+    return true;
+}
+
+/* Report a rate change that has been reached to the caller */
+static inline void rx_report_rate_change(struct bladerf_sync *s,
+                                         struct bladerf_metadata *user_meta)
+{
+    if (s->meta.rate_change_due != 0) {
+        user_meta->status |= BLADERF_META_STATUS_RATE_CHANGE;
+        user_meta->sample_rate = s->meta.rate_change_due;
+        s->meta.rate_change_due = 0;
+    }
+}
+
 static inline void advance_rx_buffer(struct buffer_mgmt *b)
 {
     log_verbose("%s: Marking buf[%u] empty.\n", __FUNCTION__, b->cons_i);
 
-    b->status[b->cons_i] = SYNC_BUFFER_EMPTY;
+    sync_buf_set_status(b, b->cons_i, SYNC_BUFFER_EMPTY);
     b->cons_i = (b->cons_i + 1) % b->num_buffers;
 }
 
@@ -371,161 +899,664 @@ static inline unsigned int timestamp_to_msg(struct bladerf_sync *s, uint64_t t)
     return (unsigned int) m;
 }
 
-int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
-            struct bladerf_metadata *user_meta, unsigned int timeout_ms)
+/* Capture slot holding the message with timestamp t. This follows
+ * timestamp_to_msg(), but in 64 bits, as absolute timestamps exceed its
+ * range after several hours of streaming. */
+static inline unsigned int capture_slot(struct bladerf_sync *s, uint64_t t)
 {
-    struct buffer_mgmt *b;
+    return (unsigned int)((t / s->meta.samples_per_msg) %
+                          s->capture.num_msgs);
+}
 
-    int status = 0;
-    bool exit_early = false;
-    bool copied_data = false;
-    unsigned int samples_returned = 0;
-    uint8_t *samples_dest = (uint8_t*)samples;
-    uint8_t *buf_src = NULL;
-    unsigned int samples_to_copy = 0;
-    unsigned int samples_per_buffer = 0;
-    uint64_t target_timestamp = UINT64_MAX;
-    unsigned int pkt_len_dwords = 0;
+/* Timestamp of the oldest message that may still be held in the capture */
+static inline uint64_t capture_oldest(struct bladerf_sync *s)
+{
+    const struct sync_capture *c = &s->capture;
+    const uint64_t span =
+        (uint64_t)(c->num_msgs - 1) * s->meta.samples_per_msg;
 
-    if (s == NULL || samples == NULL) {
-        log_debug("NULL pointer passed to %s\n", __FUNCTION__);
-        return BLADERF_ERR_INVAL;
-    } else if (!s->initialized) {
-        return BLADERF_ERR_INVAL;
+    if (c->newest - c->first >= span) {
+        return c->newest - span;
     }
 
-    MUTEX_LOCK(&s->lock);
+    return c->first;
+}
 
-    if (s->stream_config.format == BLADERF_FORMAT_SC16_Q11_META ||
-          s->stream_config.format == BLADERF_FORMAT_PACKET_META) {
-        if (user_meta == NULL) {
-            log_debug("NULL metadata pointer passed to %s\n", __FUNCTION__);
-            status = BLADERF_ERR_INVAL;
-            goto out;
-        } else {
-            user_meta->status = 0;
-            target_timestamp = user_meta->timestamp;
-        }
+void sync_capture_init(struct bladerf_sync *s)
+{
+    struct sync_capture *c = &s->capture;
+    struct bladerf *dev    = s->dev;
+    bladerf_sample_rate rate;
+    uint64_t num_msgs;
+    int status;
+
+    memset(c, 0, sizeof(*c));
+    MUTEX_INIT(&c->lock);
+
+    if ((s->stream_config.layout & BLADERF_DIRECTION_MASK) != BLADERF_RX ||
+        dev->rx_capture_ms == 0) {
+        return;
     }
 
-    b = &s->buf_mgmt;
-    samples_per_buffer = s->stream_config.samples_per_buffer;
+    if (s->stream_config.layout != BLADERF_RX_X1 ||
+        s->stream_config.format != BLADERF_FORMAT_SC16_Q11_META ||
+        s->stream_config.convert_cf32) {
+        log_warning("The RX capture requires the SC16 Q11 metadata format "
+                    "on a single channel. Not capturing.\n");
+        return;
+    }
 
-    log_verbose("%s: Requests %u samples.\n", __FUNCTION__, num_samples);
+    status = dev->board->get_sample_rate(dev, BLADERF_CHANNEL_RX(0), &rate);
+    if (status != 0) {
+        log_warning("Failed to get sample rate for RX capture: %s\n",
+                    bladerf_strerror(status));
+        return;
+    }
 
-    while (!exit_early && samples_returned < num_samples && status == 0) {
-        dump_buf_states(s);
+    num_msgs = (uint64_t)rate * dev->rx_capture_ms / 1000;
+    num_msgs = (num_msgs + s->meta.samples_per_msg - 1) /
+               s->meta.samples_per_msg;
+    num_msgs = u64_max(num_msgs, s->meta.msg_per_buf);
 
-        switch (s->state) {
-            case SYNC_STATE_CHECK_WORKER: {
-                int stream_error;
-                sync_worker_state worker_state =
-                    sync_worker_get_state(s->worker, &stream_error);
-
-                /* Propagate stream error back to the caller.
-                 * They can call this function again to restart the stream and
-                 * try again.
-                 */
-                if (stream_error != 0) {
-                    status = stream_error;
-                } else {
-                    if (worker_state == SYNC_WORKER_STATE_IDLE) {
-                        log_debug("%s: Worker is idle. Going to reset buf "
-                                  "mgmt.\n", __FUNCTION__);
-                        s->state = SYNC_STATE_RESET_BUF_MGMT;
-                    } else if (worker_state == SYNC_WORKER_STATE_RUNNING) {
-                        s->state = SYNC_STATE_WAIT_FOR_BUFFER;
-                    } else {
-                        status = BLADERF_ERR_UNEXPECTED;
-                        log_debug("%s: Unexpected worker state=%d\n",
-                                __FUNCTION__, worker_state);
-                    }
-                }
+    if (num_msgs > UINT_MAX || num_msgs > SIZE_MAX / s->meta.msg_size) {
+        log_warning("RX capture of %u ms is too large.\n",
+                    dev->rx_capture_ms);
+        return;
+    }
 
-                break;
-            }
+    c->msgs  = alloc_malloc((size_t)num_msgs * s->meta.msg_size);
+    c->valid = alloc_calloc((size_t)num_msgs, sizeof(c->valid[0]));
 
-            case SYNC_STATE_RESET_BUF_MGMT:
-                MUTEX_LOCK(&b->lock);
-                /* When the RX stream starts up, it will submit the first T
-                 * transfers, so the consumer index must be reset to 0 */
-                b->cons_i = 0;
-                MUTEX_UNLOCK(&b->lock);
-                log_debug("%s: Reset buf_mgmt consumer index\n", __FUNCTION__);
-                s->state = SYNC_STATE_START_WORKER;
+    if (c->msgs == NULL || c->valid == NULL) {
+        log_warning("Failed to allocate RX capture of %u ms.\n",
+                    dev->rx_capture_ms);
+        alloc_free(c->msgs);
+        alloc_free(c->valid);
+        c->msgs  = NULL;
+        c->valid = NULL;
+        return;
+    }
+
+    c->num_msgs = (unsigned int)num_msgs;
+    c->enabled  = true;
+
+    log_debug("%s: Capturing %u ms in %u messages.\n", __FUNCTION__,
+              dev->rx_capture_ms, c->num_msgs);
+}
+
+void sync_capture_deinit(struct bladerf_sync *s)
+{
+    struct sync_capture *c = &s->capture;
+
+    alloc_free(c->msgs);
+    alloc_free(c->valid);
+    c->msgs    = NULL;
+    c->valid   = NULL;
+    c->enabled = false;
+
+    MUTEX_DESTROY(&c->lock);
+}
+
+void sync_capture_store(struct bladerf_sync *s,
+                        const uint8_t *buf,
+                        size_t num_samples)
+{
+    struct sync_capture *c = &s->capture;
+    const size_t msg_size  = s->meta.msg_size;
+    const unsigned int spm = s->meta.samples_per_msg;
+    size_t i, num_msgs;
+
+    if (!c->enabled || buf == NULL) {
+        return;
+    }
+
+    num_msgs = samples2bytes(s, num_samples) / msg_size;
+
+    MUTEX_LOCK(&c->lock);
+
+    for (i = 0; i < num_msgs; i++) {
+        const uint8_t *msg = buf + i * msg_size;
+        const uint64_t t   = metadata_get_timestamp(msg);
+        unsigned int slot;
+
+        /* Messages are contiguous in time, so a timestamp that does not
+         * advance, or that is misaligned with those before it, indicates
+         * that the timestamp counter was reset. */
+        if (!c->have_msgs || t <= c->newest || (t % spm) != c->phase) {
+            if (c->have_msgs) {
+                log_debug("%s: Timestamp discontinuity at %" PRIu64
+                          ". Resetting capture.\n", __FUNCTION__, t);
+            }
+
+            memset(c->valid, 0, c->num_msgs * sizeof(c->valid[0]));
+            c->phase     = t % spm;
+            c->first     = t;
+            c->have_msgs = true;
+        }
+
+        slot = capture_slot(s, t);
+        memcpy(c->msgs + (size_t)slot * msg_size, msg, msg_size);
+        c->valid[slot] = true;
+        c->newest      = t;
+    }
+
+    MUTEX_UNLOCK(&c->lock);
+}
+
+int sync_capture_read(struct bladerf_sync *s,
+                      void *samples,
+                      unsigned int num_samples,
+                      struct bladerf_metadata *metadata)
+{
+    struct sync_capture *c       = &s->capture;
+    const size_t msg_size        = s->meta.msg_size;
+    const size_t bps             = s->stream_config.bytes_per_sample;
+    const unsigned int spm       = s->meta.samples_per_msg;
+    uint8_t *out                 = samples;
+    unsigned int copied          = 0;
+    int status                   = 0;
+    uint64_t t, msg_t;
+    size_t off;
+
+    if (metadata == NULL || (samples == NULL && num_samples != 0)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!c->enabled) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    t = metadata->timestamp;
+    metadata->actual_count = 0;
+    metadata->status       = 0;
+
+    MUTEX_LOCK(&c->lock);
+
+    if (!c->have_msgs || t > c->newest + spm - 1) {
+        status = BLADERF_ERR_RANGE;
+    } else if (t < capture_oldest(s)) {
+        status = BLADERF_ERR_TIME_PAST;
+    } else {
+        /* Seek directly to the message containing t */
+        off   = (size_t)((t - c->phase) % spm);
+        msg_t = t - off;
+
+        while (copied < num_samples && msg_t <= c->newest) {
+            const unsigned int slot = capture_slot(s, msg_t);
+            const uint8_t *msg      = c->msgs + (size_t)slot * msg_size;
+            const unsigned int n    = uint_min((unsigned int)(spm - off),
+                                               num_samples - copied);
+
+            if (!c->valid[slot] || metadata_get_timestamp(msg) != msg_t) {
+                /* These samples were dropped before reaching the host */
+                metadata->status |= BLADERF_META_STATUS_OVERRUN;
                 break;
+            }
 
+            memcpy(out + copied * bps, msg + METADATA_HEADER_SIZE + off * bps,
+                   n * bps);
 
-            case SYNC_STATE_START_WORKER:
-                sync_worker_submit_request(s->worker, SYNC_WORKER_START);
+            copied += n;
+            off     = 0;
+            msg_t  += spm;
+        }
+    }
 
-                status = sync_worker_wait_for_state(
-                                                s->worker,
-                                                SYNC_WORKER_STATE_RUNNING,
-                                                SYNC_WORKER_START_TIMEOUT_MS);
+    MUTEX_UNLOCK(&c->lock);
 
-                if (status == 0) {
-                    s->state = SYNC_STATE_WAIT_FOR_BUFFER;
-                    log_debug("%s: Worker is now running.\n", __FUNCTION__);
+    metadata->actual_count = copied;
+    return status;
+}
+
+int sync_capture_range(struct bladerf_sync *s,
+                       uint64_t *oldest,
+                       uint64_t *newest)
+{
+    struct sync_capture *c = &s->capture;
+    int status = 0;
+
+    if (oldest == NULL || newest == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!c->enabled) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    MUTEX_LOCK(&c->lock);
+
+    if (!c->have_msgs) {
+        status = BLADERF_ERR_RANGE;
+    } else {
+        *oldest = capture_oldest(s);
+        *newest = c->newest + s->meta.samples_per_msg - 1;
+    }
+
+    MUTEX_UNLOCK(&c->lock);
+    return status;
+}
+
+/* Message header flags that are reported via bladerf_metadata::status */
+#define RX_MSG_STATUS_FLAGS (BLADERF_META_FLAG_RX_HW_UNDERFLOW | \
+                             BLADERF_META_FLAG_RX_HW_MINIEXP1 | \
+                             BLADERF_META_FLAG_RX_HW_MINIEXP2)
+
+/* Timestamp increment across one message's worth of samples */
+static inline uint64_t rx_msg_ts_inc(struct bladerf_sync *s)
+{
+    if (s->stream_config.layout == BLADERF_RX_X2) {
+        return s->meta.samples_per_msg / 2;
+    } else {
+        return s->meta.samples_per_msg;
+    }
+}
+
+/* Read all of a newly available buffer's message headers in one pass,
+ * noting where the timestamps are contiguous. This spares the copy-out path
+ * from parsing headers between messages. */
+static void rx_index_buffer(struct bladerf_sync *s, const uint8_t *buf)
+{
+    struct sync_msg_info *idx = s->meta.rx_index;
+    const uint64_t ts_inc     = rx_msg_ts_inc(s);
+    const size_t msg_size     = s->meta.msg_size;
+    unsigned int i;
+
+    for (i = 0; i < s->meta.msg_per_buf; i++) {
+        const uint8_t *msg = buf + msg_size * i;
+
+        idx[i].timestamp = metadata_get_timestamp(msg);
+        idx[i].flags     = metadata_get_flags(msg);
+    }
+
+    idx[0].contiguous = false;
+    for (i = 1; i < s->meta.msg_per_buf; i++) {
+        idx[i].contiguous = (idx[i].timestamp == idx[i - 1].timestamp + ts_inc);
+    }
+}
+
+/* Performs a single state transition of the RX state machine, for the states
+ * leading up to a buffer becoming available for consumption
+ * (CHECK_WORKER through BUFFER_READY). Assumes the sync handle lock is held. */
+static int rx_buffer_step(struct bladerf_sync *s, unsigned int timeout_ms)
+{
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    int status = 0;
+
+    switch (s->state) {
+        case SYNC_STATE_CHECK_WORKER: {
+            int stream_error;
+            sync_worker_state worker_state =
+                sync_worker_get_state(s->worker, &stream_error);
+
+            /* Propagate stream error back to the caller.
+             * They can call this function again to restart the stream and
+             * try again.
+             */
+            if (stream_error != 0) {
+                status = stream_error;
+            } else {
+                if (worker_state == SYNC_WORKER_STATE_IDLE) {
+                    log_debug("%s: Worker is idle. Going to reset buf "
+                              "mgmt.\n", __FUNCTION__);
+                    set_state(s, SYNC_STATE_RESET_BUF_MGMT);
+                } else if (worker_state == SYNC_WORKER_STATE_RUNNING) {
+                    set_state(s, SYNC_STATE_WAIT_FOR_BUFFER);
                 } else {
-                    log_debug("%s: Failed to start worker, (%d)\n",
-                              __FUNCTION__, status);
+                    status = BLADERF_ERR_UNEXPECTED;
+                    log_debug("%s: Unexpected worker state=%d\n",
+                            __FUNCTION__, worker_state);
                 }
-                break;
+            }
 
-            case SYNC_STATE_WAIT_FOR_BUFFER:
-                MUTEX_LOCK(&b->lock);
+            break;
+        }
 
-                /* Check the buffer state, as the worker may have produced one
-                 * since we last queried the status */
-                if (b->status[b->cons_i] == SYNC_BUFFER_FULL) {
-                    s->state = SYNC_STATE_BUFFER_READY;
-                    log_verbose("%s: buffer %u is ready to consume\n",
-                                __FUNCTION__, b->cons_i);
-                } else {
-                    status = wait_for_buffer(b, timeout_ms,
-                                             __FUNCTION__, b->cons_i);
+        case SYNC_STATE_RESET_BUF_MGMT:
+            MUTEX_LOCK(&b->lock);
+            /* When the RX stream starts up, it will submit the first T
+             * transfers, so the consumer index must be reset to 0 */
+            b->cons_i = 0;
+
+            /* Don't count the time the stream was stopped as a buffer
+             * interval */
+            b->last_full = 0;
+            MUTEX_UNLOCK(&b->lock);
+
+            /* Timestamps do not carry over from a previous run */
+            s->meta.ts_valid    = false;
+            s->meta.pending_gap = 0;
+            log_debug("%s: Reset buf_mgmt consumer index\n", __FUNCTION__);
+            set_state(s, SYNC_STATE_START_WORKER);
+            break;
 
-                    if (status == 0) {
-                        if (b->status[b->cons_i] != SYNC_BUFFER_FULL) {
-                            s->state = SYNC_STATE_CHECK_WORKER;
-                        } else {
-                            s->state = SYNC_STATE_BUFFER_READY;
-                            log_verbose("%s: buffer %u is ready to consume\n",
-                                        __FUNCTION__, b->cons_i);
-                        }
+
+        case SYNC_STATE_START_WORKER:
+            sync_worker_submit_request(s->worker, SYNC_WORKER_START);
+
+            status = sync_worker_wait_for_state(
+                                            s->worker,
+                                            SYNC_WORKER_STATE_RUNNING,
+                                            SYNC_WORKER_START_TIMEOUT_MS);
+
+            if (status == 0) {
+                set_state(s, SYNC_STATE_WAIT_FOR_BUFFER);
+                log_debug("%s: Worker is now running.\n", __FUNCTION__);
+            } else {
+                log_debug("%s: Failed to start worker, (%d)\n",
+                          __FUNCTION__, status);
+            }
+            break;
+
+        case SYNC_STATE_WAIT_FOR_BUFFER:
+            MUTEX_LOCK(&b->lock);
+
+            /* Check the buffer state, as the worker may have produced one
+             * since we last queried the status */
+            if (b->status[b->cons_i] == SYNC_BUFFER_FULL) {
+                set_state(s, SYNC_STATE_BUFFER_READY);
+                log_verbose("%s: buffer %u is ready to consume\n",
+                            __FUNCTION__, b->cons_i);
+            } else if (sync_worker_get_state(s->worker, NULL) ==
+                       SYNC_WORKER_STATE_IDLE) {
+                /* The stream ended while we were consuming earlier buffers,
+                 * so its wakeup has already come and gone. */
+                set_state(s, SYNC_STATE_CHECK_WORKER);
+            } else if (nonblocking(s)) {
+                status = BLADERF_ERR_WOULD_BLOCK;
+            } else {
+                status = wait_for_buffer(b, timeout_ms, s->deadline_ns,
+                                         __FUNCTION__, b->cons_i);
+
+                if (status == 0) {
+                    if (b->status[b->cons_i] != SYNC_BUFFER_FULL) {
+                        set_state(s, SYNC_STATE_CHECK_WORKER);
+                    } else {
+                        set_state(s, SYNC_STATE_BUFFER_READY);
+                        log_verbose("%s: buffer %u is ready to consume\n",
+                                    __FUNCTION__, b->cons_i);
                     }
                 }
+            }
 
-                MUTEX_UNLOCK(&b->lock);
-                break;
+            MUTEX_UNLOCK(&b->lock);
+            break;
 
-            case SYNC_STATE_BUFFER_READY:
-                MUTEX_LOCK(&b->lock);
-                b->status[b->cons_i] = SYNC_BUFFER_PARTIAL;
-                b->partial_off = 0;
+        case SYNC_STATE_BUFFER_READY:
+            MUTEX_LOCK(&b->lock);
+            sync_buf_full_done(b, &s->stats, b->cons_i);
+            sync_buf_set_status(b, b->cons_i, SYNC_BUFFER_PARTIAL);
+            b->partial_off = 0;
+
+            switch (s->stream_config.format) {
+                case BLADERF_FORMAT_SC16_Q11:
+                case BLADERF_FORMAT_SC8_Q7:
+                    set_state(s, SYNC_STATE_USING_BUFFER);
+                    break;
+
+                case BLADERF_FORMAT_SC16_Q11_META:
+                case BLADERF_FORMAT_SC8_Q7_META:
+                    set_state(s, SYNC_STATE_USING_BUFFER_META);
+                    s->meta.curr_msg_off = 0;
+                    s->meta.msg_num = 0;
+                    rx_index_buffer(s, (const uint8_t *)b->buffers[b->cons_i]);
+                    break;
+
+                case BLADERF_FORMAT_PACKET_META:
+                    set_state(s, SYNC_STATE_USING_PACKET_META);
+                    break;
+
+                default:
+                    assert(!"Invalid stream format");
+                    status = BLADERF_ERR_UNEXPECTED;
+            }
 
-                switch (s->stream_config.format) {
-                    case BLADERF_FORMAT_SC16_Q11:
-                        s->state = SYNC_STATE_USING_BUFFER;
-                        break;
+            MUTEX_UNLOCK(&b->lock);
+            break;
 
-                    case BLADERF_FORMAT_SC16_Q11_META:
-                        s->state = SYNC_STATE_USING_BUFFER_META;
-                        s->meta.curr_msg_off = 0;
-                        s->meta.msg_num = 0;
-                        break;
+        default:
+            assert(!"Invalid state");
+            status = BLADERF_ERR_UNEXPECTED;
+    }
 
-                    case BLADERF_FORMAT_PACKET_META:
-                        s->state = SYNC_STATE_USING_PACKET_META;
-                        break;
+    return status;
+}
 
-                    default:
-                        assert(!"Invalid stream format");
-                        status = BLADERF_ERR_UNEXPECTED;
-                }
+/* Destination of samples copied out by sync_rx() */
+struct rx_dest {
+    uint8_t *ptr[2]; /* Channel destinations. Only ptr[0] is used when the
+                      * samples are provided in their interleaved form */
+    bool planar;     /* Deinterleave samples into per-channel destinations */
+};
 
-                MUTEX_UNLOCK(&b->lock);
+/* Copy n samples from a sync buffer to dst, converting them to the
+ * caller's format if needed. ch is the position of the first sample's channel
+ * within the stream, and interleaved indicates that the samples alternate
+ * between the stream's two channels. */
+static inline void copy_out(struct bladerf_sync *s,
+                            uint8_t *dst,
+                            const uint8_t *src,
+                            unsigned int n,
+                            unsigned int ch,
+                            bool interleaved)
+{
+    if (s->stream_config.convert_cf32 && s->rx_corr) {
+        sc16q11_to_float_corr((const int16_t *)src, (float *)dst, n,
+                                      s->rx_corr_coeffs[ch],
+                                      s->rx_corr_coeffs[interleaved ? ch ^ 1
+                                                                    : ch]);
+    } else if (s->stream_config.convert_cf32) {
+        sc16q11_to_float((const int16_t *)src, (float *)dst, n);
+    } else {
+        memcpy(dst, src, samples2bytes(s, n));
+    }
+}
+
+/* Translate the core-specific flags of a packet's header into metadata
+ * status flags */
+static inline unsigned int packet_status(const uint8_t *header)
+{
+    const uint8_t flags = metadata_get_packet_flags(header);
+    unsigned int status = 0;
+
+    if (metadata_get_packet_core(header) != METADATA_PACKET_CORE_RX_BURST) {
+        return 0;
+    }
+
+    if (flags & METADATA_PACKET_FLAG_BURST_START) {
+        status |= BLADERF_META_FLAG_RX_HW_BURST_START;
+    }
+
+    if (flags & METADATA_PACKET_FLAG_BURST_END) {
+        status |= BLADERF_META_FLAG_RX_HW_BURST_END;
+    }
+
+    if (flags & METADATA_PACKET_FLAG_DROPPED) {
+        status |= BLADERF_META_STATUS_OVERRUN;
+    }
+
+    return status;
+}
+
+/* Accumulate the energy of n SC16 Q11 samples for the host-side AGC, where
+ * off is the number of (interleaved) samples already provided to the caller */
+static inline void measure_agc(struct bladerf_sync *s,
+                               unsigned int off,
+                               const uint8_t *src,
+                               unsigned int n)
+{
+    uint64_t energy[2] = { 0, 0 };
+
+    sc16q11_energy((const int16_t *)src, n, energy);
+
+    if (s->stream_config.layout == BLADERF_RX_X2) {
+        const unsigned int ch = off % 2;
+
+        s->agc_energy[ch] += energy[0];
+        s->agc_energy[ch ^ 1] += energy[1];
+        s->agc_count[ch] += (n + 1) / 2;
+        s->agc_count[ch ^ 1] += n / 2;
+    } else {
+        s->agc_energy[0] += energy[0] + energy[1];
+        s->agc_count[0] += n;
+    }
+}
+
+/* Number of channel pairs deinterleaved at a time when a conversion is
+ * also required */
+#define PLANAR_CONV_CHUNK 512
+
+/* Copy n samples from a sync buffer to the destination, where off is the
+ * number of (interleaved) samples already provided to the caller */
+static inline void copy_to_dest(struct bladerf_sync *s,
+                                const struct rx_dest *dest,
+                                unsigned int off,
+                                const uint8_t *src,
+                                unsigned int n)
+{
+    if (s->rx_agc) {
+        measure_agc(s, off, src, n);
+    }
+
+    if (!dest->planar) {
+        const bool x2 = (s->stream_config.layout == BLADERF_RX_X2);
+
+        copy_out(s, dest->ptr[0] + user_samples2bytes(s, off), src, n,
+                 x2 ? off % 2 : 0, x2);
+    } else if (s->stream_config.bytes_per_sample != 4) {
+        /* The deinterleaving kernels operate on 32-bit samples */
+        unsigned int i;
+        for (i = 0; i < n; i++) {
+            const unsigned int idx = off + i;
+            memcpy(dest->ptr[idx % 2] + samples2bytes(s, idx / 2),
+                   src + samples2bytes(s, i), samples2bytes(s, 1));
+        }
+    } else if ((off % 2) == 0 && (n % 2) == 0 &&
+               !s->stream_config.convert_cf32) {
+        _interleave_deinterleave2(src,
+                                  dest->ptr[0] + samples2bytes(s, off / 2),
+                                  dest->ptr[1] + samples2bytes(s, off / 2),
+                                  n / 2);
+    } else if ((off % 2) == 0 && (n % 2) == 0) {
+        /* Deinterleave into scratch space, then convert each channel */
+        uint32_t ch0[PLANAR_CONV_CHUNK], ch1[PLANAR_CONV_CHUNK];
+        unsigned int done = 0;
+
+        while (done < n / 2) {
+            const unsigned int pairs =
+                uint_min(n / 2 - done, PLANAR_CONV_CHUNK);
+            const size_t dst_off = user_samples2bytes(s, off / 2 + done);
+
+            _interleave_deinterleave2(src + samples2bytes(s, 2 * done),
+                                      ch0, ch1, pairs);
+
+            copy_out(s, dest->ptr[0] + dst_off, (const uint8_t *)ch0, pairs,
+                     0, false);
+            copy_out(s, dest->ptr[1] + dst_off, (const uint8_t *)ch1, pairs,
+                     1, false);
+
+            done += pairs;
+        }
+    } else {
+        /* Not aligned to a channel pair boundary. Shouldn't generally occur,
+         * but handle it sample-by-sample. */
+        unsigned int i;
+        for (i = 0; i < n; i++) {
+            const unsigned int idx = off + i;
+            copy_out(s, dest->ptr[idx % 2] + user_samples2bytes(s, idx / 2),
+                     src + samples2bytes(s, i), 1, idx % 2, false);
+        }
+    }
+}
+
+/* Assumes the sync handle lock is held */
+static int sync_rx_to_dest_locked(struct bladerf_sync *s,
+                                  const struct rx_dest *dest,
+                                  unsigned num_samples,
+                                  struct bladerf_metadata *user_meta,
+                                  unsigned int timeout_ms)
+{
+    struct buffer_mgmt *b;
+
+    int status = 0;
+    bool exit_early = false;
+    bool copied_data = false;
+    bool resync = false;
+    unsigned int samples_returned = 0;
+    uint8_t *buf_src = NULL;
+    unsigned int samples_to_copy = 0;
+    unsigned int samples_per_buffer = 0;
+    uint64_t target_timestamp = UINT64_MAX;
+    unsigned int pkt_len_dwords = 0;
+
+    if (s->lease.active) {
+        log_debug("%s: Buffer region from sync_rx_acquire() not yet "
+                  "released.\n", __FUNCTION__);
+        status = BLADERF_ERR_INVAL;
+        goto out;
+    }
+
+    if (s->stream_config.convert_cf32) {
+        s->rx_corr = sample_cal_get_rx(s->dev, s->stream_config.layout,
+                                       s->rx_corr_coeffs);
+    }
+
+    /* Only SC16 Q11 samples are measured */
+    s->rx_agc = s->stream_config.bytes_per_sample == 4 &&
+                s->stream_config.format != BLADERF_FORMAT_PACKET_META &&
+                rx_agc_get_rx(s->dev, s->stream_config.layout);
+    if (s->rx_agc) {
+        memset(s->agc_energy, 0, sizeof(s->agc_energy));
+        memset(s->agc_count, 0, sizeof(s->agc_count));
+    }
+
+    if (uses_sample_meta(s) ||
+          s->stream_config.format == BLADERF_FORMAT_PACKET_META) {
+        if (user_meta == NULL) {
+            log_debug("NULL metadata pointer passed to %s\n", __FUNCTION__);
+            status = BLADERF_ERR_INVAL;
+            goto out;
+        } else {
+            user_meta->status = 0;
+            user_meta->gap = 0;
+            user_meta->sample_rate = 0;
+            user_meta->rx_gain[0] = 0;
+            user_meta->rx_gain[1] = 0;
+            target_timestamp = user_meta->timestamp;
+
+            /* Report a rate change reached by a previous call */
+            rx_report_rate_change(s, user_meta);
+        }
+    }
+
+    b = &s->buf_mgmt;
+    samples_per_buffer = s->stream_config.samples_per_buffer;
+
+    log_verbose("%s: Requests %u samples.\n", __FUNCTION__, num_samples);
+
+    if (nonblocking(s) &&
+        s->stream_config.format != BLADERF_FORMAT_PACKET_META) {
+        /* Start the stream, if needed, such that buffers become ready */
+        while (status == 0 && (s->state == SYNC_STATE_CHECK_WORKER ||
+                               s->state == SYNC_STATE_RESET_BUF_MGMT ||
+                               s->state == SYNC_STATE_START_WORKER)) {
+            status = rx_buffer_step(s, timeout_ms);
+        }
+
+        if (status == 0) {
+            status = check_ready(s, num_samples);
+        }
+    }
+
+    while (!exit_early && samples_returned < num_samples && status == 0) {
+        dump_buf_states(s);
+
+        switch (s->state) {
+            case SYNC_STATE_CHECK_WORKER:
+            case SYNC_STATE_RESET_BUF_MGMT:
+            case SYNC_STATE_START_WORKER:
+            case SYNC_STATE_WAIT_FOR_BUFFER:
+            case SYNC_STATE_BUFFER_READY:
+                status = rx_buffer_step(s, timeout_ms);
                 break;
 
             case SYNC_STATE_USING_BUFFER: /* SC16Q11 buffers w/o metadata */
@@ -536,9 +1567,9 @@ int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
                 samples_to_copy = uint_min(num_samples - samples_returned,
                                            samples_per_buffer - b->partial_off);
 
-                memcpy(samples_dest + samples2bytes(s, samples_returned),
-                       buf_src + samples2bytes(s, b->partial_off),
-                       samples2bytes(s, samples_to_copy));
+                copy_to_dest(s, dest, samples_returned,
+                             buf_src + samples2bytes(s, b->partial_off),
+                             samples_to_copy);
 
                 b->partial_off += samples_to_copy;
                 samples_returned += samples_to_copy;
@@ -554,7 +1585,7 @@ int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
                     assert(b->partial_off == samples_per_buffer);
 
                     advance_rx_buffer(b);
-                    s->state = SYNC_STATE_WAIT_FOR_BUFFER;
+                    set_state(s, SYNC_STATE_WAIT_FOR_BUFFER);
                 }
 
                 MUTEX_UNLOCK(&b->lock);
@@ -575,26 +1606,45 @@ int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
                             buf_src + s->meta.msg_size * s->meta.msg_num;
 
                         s->meta.msg_timestamp =
-                            metadata_get_timestamp(s->meta.curr_msg);
+                            s->meta.rx_index[s->meta.msg_num].timestamp;
 
                         s->meta.msg_flags =
-                            metadata_get_flags(s->meta.curr_msg);
+                            s->meta.rx_index[s->meta.msg_num].flags;
 
                         user_meta->status |= s->meta.msg_flags &
-                           (BLADERF_META_FLAG_RX_HW_UNDERFLOW |
-                              BLADERF_META_FLAG_RX_HW_MINIEXP1 |
-                              BLADERF_META_FLAG_RX_HW_MINIEXP2);
+                                             RX_MSG_STATUS_FLAGS;
 
                         s->meta.curr_msg_off = 0;
 
+                        /* Hold on to the size of a gap, for the call that
+                         * returns the samples following it */
+                        if (s->meta.ts_valid &&
+                            s->meta.msg_timestamp > s->meta.curr_timestamp) {
+                            s->meta.pending_gap += s->meta.msg_timestamp -
+                                                   s->meta.curr_timestamp;
+                        }
+                        s->meta.ts_valid = true;
+
+                        /* Samples at a new rate are returned by a call of
+                         * their own, which reports the change */
+                        if (rx_rate_change_reached(s)) {
+                            if (copied_data) {
+                                exit_early = true;
+                            } else {
+                                rx_report_rate_change(s, user_meta);
+                            }
+                        }
+
                         /* We've encountered a discontinuity and need to return
                          * what we have so far, setting the status flags */
                         if (copied_data &&
                             s->meta.msg_timestamp != s->meta.curr_timestamp) {
 
                             user_meta->status |= BLADERF_META_STATUS_OVERRUN;
+                            s->stats.overruns++;
                             exit_early = true;
-                            log_debug("Sample discontinuity detected @ "
+                            log_debug_ratelimited(LOG_SUBSYS_SYNC,
+                                      "Sample discontinuity detected @ "
                                       "buffer %u, message %u: Expected t=%llu, "
                                       "got t=%llu\n",
                                       b->cons_i, s->meta.msg_num,
@@ -615,6 +1665,24 @@ int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
 
                     case SYNC_META_STATE_SAMPLES:
                         if (!copied_data &&
+                            (user_meta->flags & BLADERF_META_FLAG_RX_NOW) == 0 &&
+                            (user_meta->flags & BLADERF_META_FLAG_RX_RESYNC) &&
+                            target_timestamp < s->meta.curr_timestamp) {
+
+                            /* The requested samples are gone. Realign to the
+                             * oldest available one, rather than failing. */
+                            log_debug_ratelimited(LOG_SUBSYS_SYNC,
+                                      "%s: Resynchronizing from t=%llu "
+                                      "to t=%llu\n", __FUNCTION__,
+                                      (unsigned long long)target_timestamp,
+                                      (unsigned long long)s->meta.curr_timestamp);
+
+                            user_meta->status |= BLADERF_META_STATUS_OVERRUN;
+                            user_meta->gap =
+                                s->meta.curr_timestamp - target_timestamp;
+                            target_timestamp = s->meta.curr_timestamp;
+                            resync = true;
+                        } else if (!copied_data &&
                             (user_meta->flags & BLADERF_META_FLAG_RX_NOW) == 0 &&
                             target_timestamp < s->meta.curr_timestamp) {
 
@@ -634,27 +1702,38 @@ int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
                                 uint_min(num_samples - samples_returned,
                                          left_in_msg(s));
 
-                            memcpy(samples_dest + samples2bytes(s, samples_returned),
-                                   s->meta.curr_msg +
-                                        METADATA_HEADER_SIZE +
-                                        samples2bytes(s, s->meta.curr_msg_off),
-                                   samples2bytes(s, samples_to_copy));
+                            copy_to_dest(s, dest, samples_returned,
+                                         s->meta.curr_msg +
+                                            METADATA_HEADER_SIZE +
+                                            samples2bytes(s, s->meta.curr_msg_off),
+                                         samples_to_copy);
 
                             samples_returned += samples_to_copy;
                             s->meta.curr_msg_off += samples_to_copy;
 
                             if (!copied_data &&
-                                (user_meta->flags & BLADERF_META_FLAG_RX_NOW)) {
+                                ((user_meta->flags & BLADERF_META_FLAG_RX_NOW) ||
+                                 resync)) {
 
                                 /* Provide the user with the timestamp at the
                                  * first returned sample when the
-                                 * NOW flag has been provided */
+                                 * NOW flag has been provided, or when it
+                                 * differs from the one requested */
                                 user_meta->timestamp = s->meta.curr_timestamp;
                                 log_verbose("Updated user meta timestamp with: "
                                             "%llu\n", (unsigned long long)
                                             user_meta->timestamp);
                             }
 
+                            /* A gap the caller skipped over by requesting a
+                             * later timestamp (or, when resynchronizing,
+                             * already reported above) is not reported */
+                            if (!copied_data &&
+                                (user_meta->flags & BLADERF_META_FLAG_RX_NOW)) {
+                                user_meta->gap = s->meta.pending_gap;
+                            }
+                            s->meta.pending_gap = 0;
+
                             copied_data = true;
 
                             if (s->stream_config.layout == BLADERF_RX_X2)
@@ -675,11 +1754,44 @@ int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
                                 s->meta.state = SYNC_META_STATE_HEADER;
                                 s->meta.msg_num++;
 
+                                /* Copy out the following messages that the
+                                 * header index shows to be contiguous with
+                                 * this one, as long as they are wanted in
+                                 * full */
+                                buf_src = (uint8_t *)b->buffers[b->cons_i];
+
+                                while (s->meta.msg_num < s->meta.msg_per_buf &&
+                                       s->meta.rx_index[s->meta.msg_num].contiguous &&
+                                       num_samples - samples_returned >=
+                                           s->meta.samples_per_msg) {
+                                    const struct sync_msg_info *info =
+                                        &s->meta.rx_index[s->meta.msg_num];
+
+                                    copy_to_dest(s, dest, samples_returned,
+                                                 buf_src +
+                                                    s->meta.msg_size *
+                                                        s->meta.msg_num +
+                                                    METADATA_HEADER_SIZE,
+                                                 s->meta.samples_per_msg);
+
+                                    samples_returned += s->meta.samples_per_msg;
+                                    user_meta->status |= info->flags &
+                                                         RX_MSG_STATUS_FLAGS;
+
+                                    s->meta.msg_timestamp  = info->timestamp;
+                                    s->meta.msg_flags      = info->flags;
+                                    s->meta.curr_timestamp = info->timestamp +
+                                                             rx_msg_ts_inc(s);
+                                    s->meta.msg_num++;
+                                }
+
+                                target_timestamp = s->meta.curr_timestamp;
+
                                 if (s->meta.msg_num >= s->meta.msg_per_buf) {
                                     assert(s->meta.msg_num == s->meta.msg_per_buf);
                                     advance_rx_buffer(b);
                                     s->meta.msg_num = 0;
-                                    s->state = SYNC_STATE_WAIT_FOR_BUFFER;
+                                    set_state(s, SYNC_STATE_WAIT_FOR_BUFFER);
                                 }
                             }
 
@@ -697,7 +1809,7 @@ int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
                             if (time_delta >= left_in_buffer) {
                                 /* Discard the remainder of this buffer */
                                 advance_rx_buffer(b);
-                                s->state = SYNC_STATE_WAIT_FOR_BUFFER;
+                                set_state(s, SYNC_STATE_WAIT_FOR_BUFFER);
                                 s->meta.state = SYNC_META_STATE_HEADER;
 
                                 log_verbose("%s: Discarding rest of buffer.\n",
@@ -738,14 +1850,23 @@ int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
 
                 pkt_len_dwords = metadata_get_packet_len(buf_src);
 
+                if (pkt_len_dwords > num_samples) {
+                    log_debug("%s: Truncating %u-DWORD packet to %u.\n",
+                              __FUNCTION__, pkt_len_dwords, num_samples);
+                    pkt_len_dwords = num_samples;
+                }
+
+                user_meta->timestamp = metadata_get_timestamp(buf_src);
+                user_meta->status |= packet_status(buf_src);
+
                 if (pkt_len_dwords > 0) {
                    samples_returned += num_samples;
                    user_meta->actual_count = pkt_len_dwords;
-                   memcpy(samples_dest, buf_src + METADATA_HEADER_SIZE, samples2bytes(s, pkt_len_dwords));
+                   copy_to_dest(s, dest, 0, buf_src + METADATA_HEADER_SIZE, pkt_len_dwords);
                 }
 
                 advance_rx_buffer(b);
-                s->state = SYNC_STATE_WAIT_FOR_BUFFER;
+                set_state(s, SYNC_STATE_WAIT_FOR_BUFFER);
                 MUTEX_UNLOCK(&b->lock);
                 break;
 
@@ -753,27 +1874,534 @@ int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
         }
     }
 
+    /* Samples preceding a future timestamp may have exhausted the buffers
+     * available to a non-blocking call. Return those that followed. */
+    if (status == BLADERF_ERR_WOULD_BLOCK && samples_returned != 0 &&
+        uses_sample_meta(s)) {
+        status = 0;
+    }
+
     if (user_meta && s->stream_config.format != BLADERF_FORMAT_PACKET_META) {
         user_meta->actual_count = samples_returned;
     }
 
-out:
-    MUTEX_UNLOCK(&s->lock);
+    if (s->rx_agc) {
+        const bool x2 = (s->stream_config.layout == BLADERF_RX_X2);
 
+        rx_agc_update(s->dev, s->stream_config.layout, s->agc_energy,
+                      s->agc_count,
+                      (copied_data && uses_sample_meta(s)) ? user_meta->timestamp
+                                                           : 0,
+                      x2 ? samples_returned / 2 : samples_returned,
+                      uses_sample_meta(s) ? user_meta : NULL);
+    }
+
+out:
+    timeline_sync_result(s->dev, BLADERF_RX, status,
+                         (status == 0 && uses_sample_meta(s))
+                             ? user_meta->status
+                             : 0);
     return status;
 }
 
-/* Assumes buffer lock is held */
-static int advance_tx_buffer(struct bladerf_sync *s, struct buffer_mgmt *b)
+static int sync_rx_to_dest(struct bladerf_sync *s,
+                           const struct rx_dest *dest,
+                           unsigned num_samples,
+                           struct bladerf_metadata *user_meta,
+                           unsigned int timeout_ms)
 {
-    int status = 0;
-    const unsigned int idx = b->prod_i;
+    int status;
 
-    if (b->submitter == SYNC_TX_SUBMITTER_FN) {
-        /* Mark buffer in flight because we're going to send it out.
-         * This ensures that if the callback fires before this function
-         * completes, its state will be correct. */
-        b->status[idx] = SYNC_BUFFER_IN_FLIGHT;
+    if (!s->initialized) {
+        return BLADERF_ERR_INVAL;
+    } else if (s->split != NULL) {
+        log_debug("%s: Per-channel queues are in use.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (s->tap != NULL) {
+        log_debug("%s: RX taps are in use.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (s->resample != NULL && dest->planar) {
+        log_debug("%s: Not supported with the RX resampler.\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    MUTEX_LOCK(&s->lock);
+    if (s->resample != NULL) {
+        status = sync_resample_rx(s, dest->ptr[0], num_samples, user_meta,
+                                  timeout_ms);
+    } else {
+        status = sync_rx_to_dest_locked(s, dest, num_samples, user_meta,
+                                        timeout_ms);
+    }
+    api_poll_update(s);
+    MUTEX_UNLOCK(&s->lock);
+
+    return status;
+}
+
+int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
+            struct bladerf_metadata *user_meta, unsigned int timeout_ms)
+{
+    struct rx_dest dest;
+
+    if (s == NULL || samples == NULL) {
+        log_debug("NULL pointer passed to %s\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    dest.ptr[0] = (uint8_t *)samples;
+    dest.ptr[1] = NULL;
+    dest.planar = false;
+
+    return sync_rx_to_dest(s, &dest, num_samples, user_meta, timeout_ms);
+}
+
+int sync_rx_locked(struct bladerf_sync *s, void *samples,
+                   unsigned int num_samples,
+                   struct bladerf_metadata *user_meta,
+                   unsigned int timeout_ms)
+{
+    struct rx_dest dest;
+
+    dest.ptr[0] = (uint8_t *)samples;
+    dest.ptr[1] = NULL;
+    dest.planar = false;
+
+    return sync_rx_to_dest_locked(s, &dest, num_samples, user_meta,
+                                  timeout_ms);
+}
+
+int sync_rx_deadline(struct bladerf_sync *s, void *samples,
+                     unsigned num_samples, struct bladerf_metadata *user_meta,
+                     uint64_t deadline_ns)
+{
+    struct rx_dest dest;
+    int status;
+
+    if (s == NULL || samples == NULL || deadline_ns == 0) {
+        log_debug("Invalid argument passed to %s\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (!s->initialized) {
+        return BLADERF_ERR_INVAL;
+    } else if (s->split != NULL) {
+        log_debug("%s: Per-channel queues are in use.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (s->tap != NULL) {
+        log_debug("%s: RX taps are in use.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (s->resample != NULL) {
+        log_debug("%s: The RX resampler is in use.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    dest.ptr[0] = (uint8_t *)samples;
+    dest.ptr[1] = NULL;
+    dest.planar = false;
+
+    MUTEX_LOCK(&s->lock);
+    s->deadline_ns = deadline_ns;
+    status = sync_rx_to_dest_locked(s, &dest, num_samples, user_meta, 0);
+    s->deadline_ns = 0;
+    api_poll_update(s);
+    MUTEX_UNLOCK(&s->lock);
+
+    return status;
+}
+
+int sync_rxv(struct bladerf_sync *s,
+             const struct bladerf_sync_iov *iov,
+             unsigned int iovcnt,
+             unsigned int *completed,
+             unsigned int timeout_ms)
+{
+    struct rx_dest dest;
+    unsigned int i;
+    int status = 0;
+
+    if (completed != NULL) {
+        *completed = 0;
+    }
+
+    if (s == NULL || (iov == NULL && iovcnt != 0) || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    } else if (s->split != NULL) {
+        log_debug("%s: Per-channel queues are in use.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (s->tap != NULL) {
+        log_debug("%s: RX taps are in use.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (s->resample != NULL) {
+        log_debug("%s: The RX resampler is in use.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    dest.ptr[1] = NULL;
+    dest.planar = false;
+
+    MUTEX_LOCK(&s->lock);
+
+    for (i = 0; i < iovcnt; i++) {
+        if (iov[i].samples == NULL) {
+            log_debug("NULL pointer in block %u passed to %s\n", i,
+                      __FUNCTION__);
+            status = BLADERF_ERR_INVAL;
+            break;
+        }
+
+        dest.ptr[0] = (uint8_t *)iov[i].samples;
+
+        status = sync_rx_to_dest_locked(s, &dest, iov[i].num_samples,
+                                        iov[i].metadata, timeout_ms);
+        if (status != 0) {
+            break;
+        }
+
+        if (completed != NULL) {
+            (*completed)++;
+        }
+    }
+
+    api_poll_update(s);
+    MUTEX_UNLOCK(&s->lock);
+
+    return status;
+}
+
+int sync_rx_planar(struct bladerf_sync *s, void *const samples[],
+                   unsigned int num_samples, struct bladerf_metadata *user_meta,
+                   unsigned int timeout_ms)
+{
+    struct rx_dest dest;
+    int status;
+
+    if (s == NULL || samples == NULL || samples[0] == NULL) {
+        log_debug("NULL pointer passed to %s\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (!s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (s->stream_config.layout != BLADERF_RX_X2) {
+        /* Only one channel; there's nothing to deinterleave */
+        return sync_rx(s, samples[0], num_samples, user_meta, timeout_ms);
+    }
+
+    if (samples[1] == NULL) {
+        log_debug("NULL pointer passed to %s\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (num_samples > UINT_MAX / 2) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    dest.ptr[0] = (uint8_t *)samples[0];
+    dest.ptr[1] = (uint8_t *)samples[1];
+    dest.planar = true;
+
+    status = sync_rx_to_dest(s, &dest, 2 * num_samples, user_meta, timeout_ms);
+
+    /* Report the count on a per-channel basis */
+    if (status == 0 && user_meta != NULL) {
+        user_meta->actual_count /= 2;
+    }
+
+    return status;
+}
+
+int sync_rx_split_fill(struct bladerf_sync *s, void *const samples[2],
+                       unsigned int num_samples,
+                       struct bladerf_metadata *user_meta,
+                       unsigned int timeout_ms)
+{
+    struct rx_dest dest;
+    int status;
+
+    dest.ptr[0] = (uint8_t *)samples[0];
+    dest.ptr[1] = (uint8_t *)samples[1];
+    dest.planar = true;
+
+    MUTEX_LOCK(&s->lock);
+    status = sync_rx_to_dest_locked(s, &dest, 2 * num_samples, user_meta,
+                                    timeout_ms);
+    api_poll_update(s);
+    MUTEX_UNLOCK(&s->lock);
+
+    if (status == 0) {
+        user_meta->actual_count /= 2;
+    }
+
+    return status;
+}
+
+int sync_rx_start(struct bladerf_sync *s, unsigned int timeout_ms)
+{
+    int status = 0;
+
+    while (status == 0 && s->state != SYNC_STATE_WAIT_FOR_BUFFER) {
+        if (s->state == SYNC_STATE_RESET_BUF_MGMT) {
+            MUTEX_LOCK(&s->buf_mgmt.lock);
+            status = sync_tap_reset(s);
+            MUTEX_UNLOCK(&s->buf_mgmt.lock);
+
+            if (status != 0) {
+                break;
+            }
+        }
+
+        status = rx_buffer_step(s, timeout_ms);
+    }
+
+    return status;
+}
+
+int sync_rx_acquire(struct bladerf_sync *s, void **samples,
+                    unsigned int *num_samples,
+                    struct bladerf_metadata *user_meta,
+                    unsigned int timeout_ms)
+{
+    struct buffer_mgmt *b;
+    uint8_t *buf_src;
+    int status = 0;
+
+    if (s == NULL || samples == NULL || num_samples == NULL) {
+        log_debug("NULL pointer passed to %s\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (!s->initialized) {
+        return BLADERF_ERR_INVAL;
+    } else if (s->stream_config.convert_cf32) {
+        log_debug("%s: Not supported with host-converted sample formats.\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    } else if (s->split != NULL) {
+        log_debug("%s: Per-channel queues are in use.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (s->tap != NULL) {
+        log_debug("%s: RX taps are in use.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (s->resample != NULL) {
+        log_debug("%s: The RX resampler is in use.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&s->lock);
+
+    if (s->lease.active) {
+        log_debug("%s: Previously acquired buffer region not yet released.\n",
+                  __FUNCTION__);
+        status = BLADERF_ERR_INVAL;
+        goto out;
+    }
+
+    if (user_meta == NULL &&
+        (uses_sample_meta(s) ||
+         s->stream_config.format == BLADERF_FORMAT_PACKET_META)) {
+        log_debug("NULL metadata pointer passed to %s\n", __FUNCTION__);
+        status = BLADERF_ERR_INVAL;
+        goto out;
+    }
+
+    if (user_meta != NULL) {
+        user_meta->status = 0;
+        user_meta->gap = 0;
+        user_meta->sample_rate = 0;
+    }
+
+    b = &s->buf_mgmt;
+
+    while (status == 0 && s->state != SYNC_STATE_USING_BUFFER &&
+           s->state != SYNC_STATE_USING_BUFFER_META &&
+           s->state != SYNC_STATE_USING_PACKET_META) {
+        dump_buf_states(s);
+        status = rx_buffer_step(s, timeout_ms);
+    }
+
+    if (status != 0) {
+        goto out;
+    }
+
+    MUTEX_LOCK(&b->lock);
+
+    buf_src = (uint8_t*)b->buffers[b->cons_i];
+
+    switch (s->state) {
+        case SYNC_STATE_USING_BUFFER:
+            s->lease.samples = buf_src + samples2bytes(s, b->partial_off);
+            s->lease.num_samples =
+                s->stream_config.samples_per_buffer - b->partial_off;
+            break;
+
+        case SYNC_STATE_USING_BUFFER_META:
+            if (s->meta.state == SYNC_META_STATE_HEADER) {
+                assert(s->meta.msg_num < s->meta.msg_per_buf);
+
+                s->meta.curr_msg = buf_src + s->meta.msg_size * s->meta.msg_num;
+                s->meta.msg_timestamp =
+                    s->meta.rx_index[s->meta.msg_num].timestamp;
+                s->meta.msg_flags = s->meta.rx_index[s->meta.msg_num].flags;
+                s->meta.curr_msg_off = 0;
+
+                if (s->lease.have_timestamp &&
+                    s->meta.msg_timestamp != s->meta.curr_timestamp) {
+
+                    if (s->meta.msg_timestamp > s->meta.curr_timestamp) {
+                        user_meta->gap = s->meta.msg_timestamp -
+                                         s->meta.curr_timestamp;
+                    }
+
+                    user_meta->status |= BLADERF_META_STATUS_OVERRUN;
+                    s->stats.overruns++;
+                    log_debug("Sample discontinuity detected @ "
+                              "buffer %u, message %u: Expected t=%llu, "
+                              "got t=%llu\n",
+                              b->cons_i, s->meta.msg_num,
+                              (unsigned long long)s->meta.curr_timestamp,
+                              (unsigned long long)s->meta.msg_timestamp);
+                }
+
+                s->meta.curr_timestamp = s->meta.msg_timestamp;
+                s->meta.state = SYNC_META_STATE_SAMPLES;
+                s->meta.ts_valid = true;
+                s->meta.pending_gap = 0;
+
+                rx_rate_change_reached(s);
+            }
+
+            rx_report_rate_change(s, user_meta);
+
+            user_meta->status |= s->meta.msg_flags & RX_MSG_STATUS_FLAGS;
+
+            user_meta->timestamp = s->meta.curr_timestamp;
+
+            s->lease.samples = s->meta.curr_msg + METADATA_HEADER_SIZE +
+                               samples2bytes(s, s->meta.curr_msg_off);
+            s->lease.num_samples = left_in_msg(s);
+            break;
+
+        case SYNC_STATE_USING_PACKET_META:
+            s->lease.samples = buf_src + METADATA_HEADER_SIZE;
+            s->lease.num_samples = metadata_get_packet_len(buf_src);
+            user_meta->timestamp = metadata_get_timestamp(buf_src);
+            user_meta->status |= packet_status(buf_src);
+            break;
+
+        default:
+            assert(!"Invalid state");
+            status = BLADERF_ERR_UNEXPECTED;
+    }
+
+    MUTEX_UNLOCK(&b->lock);
+
+    if (status == 0) {
+        s->lease.active = true;
+        *samples = s->lease.samples;
+        *num_samples = s->lease.num_samples;
+
+        if (user_meta != NULL) {
+            user_meta->actual_count = s->lease.num_samples;
+        }
+
+        log_verbose("%s: Lent %u samples in buf[%u]\n", __FUNCTION__,
+                    s->lease.num_samples, b->cons_i);
+    }
+
+out:
+    timeline_sync_result(s->dev, BLADERF_RX, status, 0);
+    api_poll_update(s);
+    MUTEX_UNLOCK(&s->lock);
+    return status;
+}
+
+int sync_rx_release(struct bladerf_sync *s, const void *samples)
+{
+    struct buffer_mgmt *b;
+    unsigned int n;
+    int status = 0;
+
+    if (s == NULL || samples == NULL || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&s->lock);
+
+    if (!s->lease.active || samples != s->lease.samples) {
+        log_debug("%s: Pointer does not refer to an acquired buffer region.\n",
+                  __FUNCTION__);
+        status = BLADERF_ERR_INVAL;
+        goto out;
+    }
+
+    b = &s->buf_mgmt;
+    n = s->lease.num_samples;
+
+    MUTEX_LOCK(&b->lock);
+
+    switch (s->state) {
+        case SYNC_STATE_USING_BUFFER:
+            b->partial_off += n;
+            assert(b->partial_off == s->stream_config.samples_per_buffer);
+            advance_rx_buffer(b);
+            set_state(s, SYNC_STATE_WAIT_FOR_BUFFER);
+            break;
+
+        case SYNC_STATE_USING_BUFFER_META:
+            s->meta.curr_msg_off += n;
+
+            if (s->stream_config.layout == BLADERF_RX_X2) {
+                s->meta.curr_timestamp += n / 2;
+            } else {
+                s->meta.curr_timestamp += n;
+            }
+
+            s->lease.have_timestamp = true;
+
+            assert(left_in_msg(s) == 0);
+            s->meta.state = SYNC_META_STATE_HEADER;
+            s->meta.msg_num++;
+
+            if (s->meta.msg_num >= s->meta.msg_per_buf) {
+                assert(s->meta.msg_num == s->meta.msg_per_buf);
+                advance_rx_buffer(b);
+                s->meta.msg_num = 0;
+                set_state(s, SYNC_STATE_WAIT_FOR_BUFFER);
+            }
+            break;
+
+        case SYNC_STATE_USING_PACKET_META:
+            advance_rx_buffer(b);
+            set_state(s, SYNC_STATE_WAIT_FOR_BUFFER);
+            break;
+
+        default:
+            assert(!"Invalid state");
+            status = BLADERF_ERR_UNEXPECTED;
+    }
+
+    MUTEX_UNLOCK(&b->lock);
+
+    s->lease.active = false;
+    s->lease.samples = NULL;
+    s->lease.num_samples = 0;
+
+out:
+    timeline_sync_result(s->dev, BLADERF_RX, status, 0);
+    api_poll_update(s);
+    MUTEX_UNLOCK(&s->lock);
+    return status;
+}
+
+/* Assumes buffer lock is held */
+static int advance_tx_buffer(struct bladerf_sync *s, struct buffer_mgmt *b)
+{
+    int status = 0;
+    const unsigned int idx = b->prod_i;
+
+    if (b->submitter == SYNC_TX_SUBMITTER_FN) {
+        /* Mark buffer in flight because we're going to send it out.
+         * This ensures that if the callback fires before this function
+         * completes, its state will be correct. */
+        sync_buf_set_status(b, idx, SYNC_BUFFER_IN_FLIGHT);
 
         /* This call may block and it results in a per-stream lock being held,
          * so the buffer lock must be dropped.
@@ -804,7 +2432,7 @@ static int advance_tx_buffer(struct bladerf_sync *s, struct buffer_mgmt *b)
                         __FUNCTION__, idx);
 
             /* Mark this buffer as being full of data, but not in flight */
-            b->status[idx] = SYNC_BUFFER_FULL;
+            sync_buf_mark_full(b, idx);
 
             /* Assign callback the duty of submitting deferred buffers,
              * and use buffer_mgmt.cons_i to denote which it should submit
@@ -817,7 +2445,7 @@ static int advance_tx_buffer(struct bladerf_sync *s, struct buffer_mgmt *b)
             status = 0;
         } else {
             /* Unmark this as being in flight */
-            b->status[idx] = SYNC_BUFFER_FULL;
+            sync_buf_mark_full(b, idx);
 
             log_debug("%s: Failed to submit buf[%u].\n", __FUNCTION__, idx);
             return status;
@@ -825,7 +2453,7 @@ static int advance_tx_buffer(struct bladerf_sync *s, struct buffer_mgmt *b)
     } else {
         /* We are not submitting this buffer; this is deffered to the worker
          * call back. Just update its state to being full of samples. */
-        b->status[idx] = SYNC_BUFFER_FULL;
+        sync_buf_mark_full(b, idx);
     }
 
     /* Advance "producer" insertion index. */
@@ -835,11 +2463,11 @@ static int advance_tx_buffer(struct bladerf_sync *s, struct buffer_mgmt *b)
      * want to use. */
     if (b->status[b->prod_i] == SYNC_BUFFER_EMPTY) {
         /* Buffer is empty and ready for use */
-        s->state = SYNC_STATE_BUFFER_READY;
+        set_state(s, SYNC_STATE_BUFFER_READY);
     } else {
         /* We'll have to wait on this buffer to become ready. First, we'll
          * verify that the worker is running. */
-        s->state = SYNC_STATE_CHECK_WORKER;
+        set_state(s, SYNC_STATE_CHECK_WORKER);
     }
 
     return status;
@@ -861,13 +2489,19 @@ static inline bool timestamp_in_past(struct bladerf_metadata *user_meta,
 struct tx_options {
     bool flush;
     bool zero_pad;
+
+    /* Only flush through the end of the burst's last message */
+    bool coalesce;
+
+    /* Zero samples written by the flush thus far */
+    unsigned int flushed_zeros;
 };
 
 static inline int handle_tx_parameters(struct bladerf_metadata *user_meta,
                                        struct bladerf_sync *s,
                                        struct tx_options *options)
 {
-    if (s->stream_config.format == BLADERF_FORMAT_SC16_Q11_META) {
+    if (uses_sample_meta(s)) {
         if (user_meta == NULL) {
             log_debug("NULL metadata pointer passed to %s\n", __FUNCTION__);
             return BLADERF_ERR_INVAL;
@@ -913,6 +2547,8 @@ static inline int handle_tx_parameters(struct bladerf_metadata *user_meta,
         if (user_meta->flags & BLADERF_META_FLAG_TX_BURST_END) {
             if (s->meta.in_burst) {
                 options->flush = true;
+                options->coalesce =
+                    (user_meta->flags & BLADERF_META_FLAG_TX_COALESCE) != 0;
             } else {
                 log_debug("%s: BURST_END provided while not in a burst.\n",
                           __FUNCTION__);
@@ -926,11 +2562,143 @@ static inline int handle_tx_parameters(struct bladerf_metadata *user_meta,
     return 0;
 }
 
-int sync_tx(struct bladerf_sync *s,
-            void const *samples,
-            unsigned int num_samples,
-            struct bladerf_metadata *user_meta,
-            unsigned int timeout_ms)
+/* Performs a single state transition of the TX state machine, for the states
+ * leading up to an empty buffer becoming available to fill (CHECK_WORKER
+ * through BUFFER_READY). Assumes the sync handle lock is held. */
+static int tx_buffer_step(struct bladerf_sync *s, unsigned int timeout_ms)
+{
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    int status = 0;
+
+    switch (s->state) {
+        case SYNC_STATE_CHECK_WORKER: {
+            int stream_error;
+            sync_worker_state worker_state =
+                sync_worker_get_state(s->worker, &stream_error);
+
+            if (stream_error != 0) {
+                status = stream_error;
+            } else {
+                if (worker_state == SYNC_WORKER_STATE_IDLE) {
+                    /* No need to reset any buffer management for TX since
+                     * the TX stream does not submit an initial set of
+                     * buffers.  Therefore the RESET_BUF_MGMT state is
+                     * skipped here. */
+                    set_state(s, SYNC_STATE_START_WORKER);
+                } else {
+                    /* Worker is running - continue onto checking for and
+                     * potentially waiting for an available buffer */
+                    set_state(s, SYNC_STATE_WAIT_FOR_BUFFER);
+                }
+            }
+            break;
+        }
+
+        case SYNC_STATE_RESET_BUF_MGMT:
+            assert(!"Bug");
+            break;
+
+        case SYNC_STATE_START_WORKER:
+            sync_worker_submit_request(s->worker, SYNC_WORKER_START);
+
+            status = sync_worker_wait_for_state(
+                s->worker, SYNC_WORKER_STATE_RUNNING,
+                SYNC_WORKER_START_TIMEOUT_MS);
+
+            if (status == 0) {
+                set_state(s, SYNC_STATE_WAIT_FOR_BUFFER);
+                log_debug("%s: Worker is now running.\n", __FUNCTION__);
+            }
+            break;
+
+        case SYNC_STATE_WAIT_FOR_BUFFER:
+            MUTEX_LOCK(&b->lock);
+
+            /* Check the buffer state, as the worker may have consumed one
+             * since we last queried the status */
+            if (b->status[b->prod_i] == SYNC_BUFFER_EMPTY) {
+                set_state(s, SYNC_STATE_BUFFER_READY);
+            } else if (nonblocking(s)) {
+                status = BLADERF_ERR_WOULD_BLOCK;
+            } else {
+                status =
+                    wait_for_buffer(b, timeout_ms, s->deadline_ns,
+                                    __FUNCTION__, b->prod_i);
+            }
+
+            MUTEX_UNLOCK(&b->lock);
+            break;
+
+        case SYNC_STATE_BUFFER_READY:
+            MUTEX_LOCK(&b->lock);
+            sync_buf_set_status(b, b->prod_i, SYNC_BUFFER_PARTIAL);
+            b->partial_off       = 0;
+
+            switch (s->stream_config.format) {
+                case BLADERF_FORMAT_SC16_Q11:
+                case BLADERF_FORMAT_SC8_Q7:
+                    set_state(s, SYNC_STATE_USING_BUFFER);
+                    break;
+
+                case BLADERF_FORMAT_SC16_Q11_META:
+                case BLADERF_FORMAT_SC8_Q7_META:
+                    s->state             = SYNC_STATE_USING_BUFFER_META;
+                    s->meta.curr_msg_off = 0;
+                    s->meta.msg_num      = 0;
+                    break;
+
+                case BLADERF_FORMAT_PACKET_META:
+                    s->state             = SYNC_STATE_USING_PACKET_META;
+                    s->meta.curr_msg_off = 0;
+                    s->meta.msg_num      = 0;
+                    break;
+
+                default:
+                    assert(!"Invalid stream format");
+                    status = BLADERF_ERR_UNEXPECTED;
+            }
+
+            MUTEX_UNLOCK(&b->lock);
+            break;
+
+        default:
+            assert(!"Invalid state");
+            status = BLADERF_ERR_UNEXPECTED;
+    }
+
+    return status;
+}
+
+/* Copy n samples from the caller's buffer into a sync buffer, converting
+ * them from the caller's format if needed */
+static inline void copy_in(struct bladerf_sync *s,
+                           uint8_t *dst,
+                           const uint8_t *src,
+                           unsigned int n)
+{
+    if (s->stream_config.convert_cf32) {
+        float_to_sc16q11((const float *)src, (int16_t *)dst, n);
+    } else {
+        memcpy(dst, src, samples2bytes(s, n));
+    }
+}
+
+/* Fill in a TX message header from the template */
+static inline void tx_header_fill(struct bladerf_sync *s, uint8_t *msg)
+{
+    memcpy(msg, s->meta.tx_header, METADATA_HEADER_SIZE);
+
+    if (!s->meta.now) {
+        metadata_set_timestamp(msg, s->meta.curr_timestamp);
+    }
+}
+
+/* Assumes the sync handle lock is held */
+static int sync_tx_locked(struct bladerf_sync *s,
+                          void const *samples,
+                          unsigned int num_samples,
+                          struct bladerf_metadata *user_meta,
+                          unsigned int timeout_ms)
 {
     struct buffer_mgmt *b = NULL;
 
@@ -942,15 +2710,48 @@ int sync_tx(struct bladerf_sync *s,
     uint8_t *buf_dest               = NULL;
     struct tx_options op            = {
         FIELD_INIT(.flush, false), FIELD_INIT(.zero_pad, false),
+        FIELD_INIT(.coalesce, false), FIELD_INIT(.flushed_zeros, 0),
     };
 
     log_verbose("%s: called for %u samples.\n", __FUNCTION__, num_samples);
 
-    if (s == NULL || samples == NULL || !s->initialized) {
+    if (samples == NULL) {
         return BLADERF_ERR_INVAL;
     }
 
-    MUTEX_LOCK(&s->lock);
+    if (s->lease.active) {
+        log_debug("%s: Buffer region from sync_tx_acquire() not yet "
+                  "committed.\n", __FUNCTION__);
+        status = BLADERF_ERR_INVAL;
+        goto out;
+    }
+
+    /* In non-blocking operation, check for space before the burst state is
+     * updated. Padding and flushing may use up to two messages in addition
+     * to the caller's samples. */
+    if (nonblocking(s) &&
+        s->stream_config.format != BLADERF_FORMAT_PACKET_META) {
+        uint64_t needed = num_samples;
+
+        while (status == 0 && (s->state == SYNC_STATE_CHECK_WORKER ||
+                               s->state == SYNC_STATE_START_WORKER)) {
+            status = tx_buffer_step(s, timeout_ms);
+        }
+
+        if (uses_sample_meta(s) && user_meta != NULL &&
+            (user_meta->flags & (BLADERF_META_FLAG_TX_UPDATE_TIMESTAMP |
+                                 BLADERF_META_FLAG_TX_BURST_END))) {
+            needed += 2 * s->meta.samples_per_msg;
+        }
+
+        if (status == 0) {
+            status = check_ready(s, needed);
+        }
+
+        if (status != 0) {
+            goto out;
+        }
+    }
 
     status = handle_tx_parameters(user_meta, s, &op);
     if (status != 0) {
@@ -962,92 +2763,14 @@ int sync_tx(struct bladerf_sync *s,
 
     while (status == 0 && ((samples_written < num_samples) || op.flush)) {
         switch (s->state) {
-            case SYNC_STATE_CHECK_WORKER: {
-                int stream_error;
-                sync_worker_state worker_state =
-                    sync_worker_get_state(s->worker, &stream_error);
-
-                if (stream_error != 0) {
-                    status = stream_error;
-                } else {
-                    if (worker_state == SYNC_WORKER_STATE_IDLE) {
-                        /* No need to reset any buffer management for TX since
-                         * the TX stream does not submit an initial set of
-                         * buffers.  Therefore the RESET_BUF_MGMT state is
-                         * skipped here. */
-                        s->state = SYNC_STATE_START_WORKER;
-                    } else {
-                        /* Worker is running - continue onto checking for and
-                         * potentially waiting for an available buffer */
-                        s->state = SYNC_STATE_WAIT_FOR_BUFFER;
-                    }
-                }
-                break;
-            }
-
+            case SYNC_STATE_CHECK_WORKER:
             case SYNC_STATE_RESET_BUF_MGMT:
-                assert(!"Bug");
-                break;
-
             case SYNC_STATE_START_WORKER:
-                sync_worker_submit_request(s->worker, SYNC_WORKER_START);
-
-                status = sync_worker_wait_for_state(
-                    s->worker, SYNC_WORKER_STATE_RUNNING,
-                    SYNC_WORKER_START_TIMEOUT_MS);
-
-                if (status == 0) {
-                    s->state = SYNC_STATE_WAIT_FOR_BUFFER;
-                    log_debug("%s: Worker is now running.\n", __FUNCTION__);
-                }
-                break;
-
             case SYNC_STATE_WAIT_FOR_BUFFER:
-                MUTEX_LOCK(&b->lock);
-
-                /* Check the buffer state, as the worker may have consumed one
-                 * since we last queried the status */
-                if (b->status[b->prod_i] == SYNC_BUFFER_EMPTY) {
-                    s->state = SYNC_STATE_BUFFER_READY;
-                } else {
-                    status =
-                        wait_for_buffer(b, timeout_ms, __FUNCTION__, b->prod_i);
-                }
-
-                MUTEX_UNLOCK(&b->lock);
-                break;
-
             case SYNC_STATE_BUFFER_READY:
-                MUTEX_LOCK(&b->lock);
-                b->status[b->prod_i] = SYNC_BUFFER_PARTIAL;
-                b->partial_off       = 0;
-
-                switch (s->stream_config.format) {
-                    case BLADERF_FORMAT_SC16_Q11:
-                        s->state = SYNC_STATE_USING_BUFFER;
-                        break;
-
-                    case BLADERF_FORMAT_SC16_Q11_META:
-                        s->state             = SYNC_STATE_USING_BUFFER_META;
-                        s->meta.curr_msg_off = 0;
-                        s->meta.msg_num      = 0;
-                        break;
-
-                    case BLADERF_FORMAT_PACKET_META:
-                        s->state             = SYNC_STATE_USING_PACKET_META;
-                        s->meta.curr_msg_off = 0;
-                        s->meta.msg_num      = 0;
-                        break;
-
-                    default:
-                        assert(!"Invalid stream format");
-                        status = BLADERF_ERR_UNEXPECTED;
-                }
-
-                MUTEX_UNLOCK(&b->lock);
+                status = tx_buffer_step(s, timeout_ms);
                 break;
 
-
             case SYNC_STATE_USING_BUFFER:
                 MUTEX_LOCK(&b->lock);
 
@@ -1055,9 +2778,9 @@ int sync_tx(struct bladerf_sync *s,
                 samples_to_copy = uint_min(num_samples - samples_written,
                                            samples_per_buffer - b->partial_off);
 
-                memcpy(buf_dest + samples2bytes(s, b->partial_off),
-                       samples_src + samples2bytes(s, samples_written),
-                       samples2bytes(s, samples_to_copy));
+                copy_in(s, buf_dest + samples2bytes(s, b->partial_off),
+                        samples_src + user_samples2bytes(s, samples_written),
+                        samples_to_copy);
 
                 b->partial_off += samples_to_copy;
                 samples_written += samples_to_copy;
@@ -1083,6 +2806,34 @@ int sync_tx(struct bladerf_sync *s,
                     case SYNC_META_STATE_HEADER:
                         buf_dest = (uint8_t *)b->buffers[b->prod_i];
 
+                        /* Assemble messages that are entirely filled by the
+                         * caller's samples in one pass. The buffer's last
+                         * message is left to the SAMPLES state, which
+                         * handles its submission. */
+                        if (!op.zero_pad) {
+                            const unsigned int n = s->meta.samples_per_msg;
+                            const uint64_t ts_inc =
+                                (s->stream_config.layout == BLADERF_RX_X2)
+                                    ? n / 2 : n;
+
+                            while (s->meta.msg_num + 1 < s->meta.msg_per_buf &&
+                                   num_samples - samples_written >= n) {
+                                uint8_t *msg = buf_dest + s->meta.msg_size *
+                                                              s->meta.msg_num;
+
+                                tx_header_fill(s, msg);
+                                copy_in(s, msg + METADATA_HEADER_SIZE,
+                                        samples_src +
+                                            user_samples2bytes(s,
+                                                               samples_written),
+                                        n);
+
+                                s->meta.curr_timestamp += ts_inc;
+                                samples_written += n;
+                                s->meta.msg_num++;
+                            }
+                        }
+
                         s->meta.curr_msg =
                             buf_dest + s->meta.msg_size * s->meta.msg_num;
 
@@ -1091,12 +2842,7 @@ int sync_tx(struct bladerf_sync *s,
 
                         s->meta.curr_msg_off = 0;
 
-                        if (s->meta.now) {
-                            metadata_set(s->meta.curr_msg, 0, 0);
-                        } else {
-                            metadata_set(s->meta.curr_msg,
-                                         s->meta.curr_timestamp, 0);
-                        }
+                        tx_header_fill(s, s->meta.curr_msg);
 
                         s->meta.state = SYNC_META_STATE_SAMPLES;
 
@@ -1171,11 +2917,12 @@ int sync_tx(struct bladerf_sync *s,
                         if (samples_to_copy != 0) {
                             /* We have user data to copy into the current
                              * message within the buffer */
-                            memcpy(s->meta.curr_msg + METADATA_HEADER_SIZE +
-                                       samples2bytes(s, s->meta.curr_msg_off),
-                                   samples_src +
-                                       samples2bytes(s, samples_written),
-                                   samples2bytes(s, samples_to_copy));
+                            copy_in(s,
+                                    s->meta.curr_msg + METADATA_HEADER_SIZE +
+                                        samples2bytes(s, s->meta.curr_msg_off),
+                                    samples_src +
+                                        user_samples2bytes(s, samples_written),
+                                    samples_to_copy);
 
                             s->meta.curr_msg_off += samples_to_copy;
                             if (s->stream_config.layout == BLADERF_RX_X2)
@@ -1215,6 +2962,7 @@ int sync_tx(struct bladerf_sync *s,
 
                             s->meta.curr_msg_off += to_zero;
                             s->meta.curr_timestamp += to_zero;
+                            op.flushed_zeros += to_zero;
                         }
 
                         if (left_in_msg(s) == 0) {
@@ -1223,6 +2971,20 @@ int sync_tx(struct bladerf_sync *s,
 
                             log_verbose("%s: Advancing to next message (%u)\n",
                                         __FUNCTION__, s->meta.msg_num);
+
+                            /* When coalescing, the burst is complete once it
+                             * ends with the three zero samples required
+                             * before a discontinuity (see above). The next
+                             * burst starts in the next message, and the
+                             * buffer is left open for it. */
+                            if (op.flush && op.coalesce &&
+                                samples_written == num_samples &&
+                                op.flushed_zeros >= 3) {
+                                log_verbose("%s: Coalescing burst end at "
+                                            "msg %u\n", __FUNCTION__,
+                                            s->meta.msg_num);
+                                op.flush = false;
+                            }
                         }
 
                         if (s->meta.msg_num >= s->meta.msg_per_buf) {
@@ -1276,22 +3038,590 @@ int sync_tx(struct bladerf_sync *s,
     }
 
     if (status == 0 &&
-        s->stream_config.format == BLADERF_FORMAT_SC16_Q11_META &&
+        uses_sample_meta(s) &&
         (user_meta->flags & BLADERF_META_FLAG_TX_BURST_END)) {
         s->meta.in_burst = false;
         s->meta.now      = false;
     }
 
 out:
+    timeline_sync_result(s->dev, BLADERF_TX, status, 0);
+    return status;
+}
+
+int sync_tx(struct bladerf_sync *s,
+            void const *samples,
+            unsigned int num_samples,
+            struct bladerf_metadata *user_meta,
+            unsigned int timeout_ms)
+{
+    int status;
+
+    if (s == NULL || samples == NULL || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&s->lock);
+    status = sync_tx_locked(s, samples, num_samples, user_meta, timeout_ms);
+    api_poll_update(s);
+    MUTEX_UNLOCK(&s->lock);
+
+    return status;
+}
+
+int sync_tx_deadline(struct bladerf_sync *s,
+                     void const *samples,
+                     unsigned int num_samples,
+                     struct bladerf_metadata *user_meta,
+                     uint64_t deadline_ns)
+{
+    int status;
+
+    if (s == NULL || samples == NULL || !s->initialized ||
+        deadline_ns == 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&s->lock);
+    s->deadline_ns = deadline_ns;
+    status = sync_tx_locked(s, samples, num_samples, user_meta, 0);
+    s->deadline_ns = 0;
+    api_poll_update(s);
+    MUTEX_UNLOCK(&s->lock);
+
+    return status;
+}
+
+int sync_txv(struct bladerf_sync *s,
+             const struct bladerf_sync_iov *iov,
+             unsigned int iovcnt,
+             unsigned int *completed,
+             unsigned int timeout_ms)
+{
+    unsigned int i;
+    int status = 0;
+
+    if (completed != NULL) {
+        *completed = 0;
+    }
+
+    if (s == NULL || (iov == NULL && iovcnt != 0) || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&s->lock);
+
+    for (i = 0; i < iovcnt; i++) {
+        status = sync_tx_locked(s, iov[i].samples, iov[i].num_samples,
+                                iov[i].metadata, timeout_ms);
+        if (status != 0) {
+            break;
+        }
+
+        if (completed != NULL) {
+            (*completed)++;
+        }
+    }
+
+    api_poll_update(s);
+    MUTEX_UNLOCK(&s->lock);
+
+    return status;
+}
+
+/* Create the wakeup shared by the RX and TX buffer management, if needed,
+ * and attach it to both. Assumes both handles' sync->lock are held. */
+static int duplex_attach(struct bladerf_sync *rx, struct bladerf_sync *tx)
+{
+    struct bladerf *dev = rx->dev;
+    struct sync_duplex *d = dev->sync_duplex;
+    struct bladerf_sync *syncs[2] = { rx, tx };
+    size_t i;
+
+    if (d == NULL) {
+        d = alloc_calloc(1, sizeof(*d));
+        if (d == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+
+        MUTEX_INIT(&d->lock);
+        timeout_cond_init(&d->ready);
+        dev->sync_duplex = d;
+    }
+
+    for (i = 0; i < ARRAY_SIZE(syncs); i++) {
+        if (syncs[i]->buf_mgmt.duplex == NULL) {
+            MUTEX_LOCK(&syncs[i]->buf_mgmt.lock);
+            syncs[i]->buf_mgmt.duplex = d;
+            MUTEX_UNLOCK(&syncs[i]->buf_mgmt.lock);
+        }
+    }
+
+    return 0;
+}
+
+/* Wait until the RX side has `rx_needed` samples ready and the TX side has
+ * room for `tx_needed` samples, with a single wait upon the shared wakeup.
+ * Assumes both handles' sync->lock are held. */
+static int duplex_wait(struct bladerf_sync *rx,
+                       struct bladerf_sync *tx,
+                       uint64_t rx_needed,
+                       uint64_t tx_needed,
+                       unsigned int timeout_ms)
+{
+    struct sync_duplex *d = rx->dev->sync_duplex;
+    const bool nonblock = nonblocking(rx) || nonblocking(tx);
+    uint64_t deadline_ns = 0;
+    struct timespec deadline;
+    unsigned int signals;
+    int status = 0;
+
+    /* Start the streams, if needed, such that buffers become ready */
+    while (status == 0 && (rx->state == SYNC_STATE_CHECK_WORKER ||
+                           rx->state == SYNC_STATE_RESET_BUF_MGMT ||
+                           rx->state == SYNC_STATE_START_WORKER)) {
+        status = rx_buffer_step(rx, timeout_ms);
+    }
+
+    while (status == 0 && (tx->state == SYNC_STATE_CHECK_WORKER ||
+                           tx->state == SYNC_STATE_START_WORKER)) {
+        status = tx_buffer_step(tx, timeout_ms);
+    }
+
+    if (timeout_ms != 0) {
+        deadline_ns = timeout_clock_get_nsec() + (uint64_t)timeout_ms * 1000000;
+    }
+
+    while (status == 0) {
+        /* Sample the signal count before checking, so that a buffer becoming
+         * ready in between is not missed */
+        MUTEX_LOCK(&d->lock);
+        signals = d->signals;
+        MUTEX_UNLOCK(&d->lock);
+
+        status = check_ready(rx, rx_needed);
+        if (status == 0) {
+            status = check_ready(tx, tx_needed);
+        }
+
+        if (status != BLADERF_ERR_WOULD_BLOCK || nonblock) {
+            break;
+        }
+
+        status = 0;
+
+        PROBE2(sync_wait_start, BLADERF_RX, rx->buf_mgmt.cons_i);
+
+        MUTEX_LOCK(&d->lock);
+        while (status == 0 && d->signals == signals) {
+            if (deadline_ns == 0) {
+                status = pthread_cond_wait(&d->ready, &d->lock);
+            } else {
+                populate_abs_deadline(&deadline, deadline_ns);
+                status = pthread_cond_timedwait(&d->ready, &d->lock,
+                                                &deadline);
+            }
+        }
+        MUTEX_UNLOCK(&d->lock);
+
+        if (status == ETIMEDOUT) {
+            log_error("%s: Timed out waiting for buffers after %u ms\n",
+                      __FUNCTION__, timeout_ms);
+            status = BLADERF_ERR_TIMEOUT;
+        } else if (status != 0) {
+            status = BLADERF_ERR_UNEXPECTED;
+        }
+
+        PROBE3(sync_wait_done, BLADERF_RX, rx->buf_mgmt.cons_i, status);
+    }
+
+    return status;
+}
+
+int sync_rxtx(struct bladerf_sync *rx,
+              struct bladerf_sync *tx,
+              void *rx_samples,
+              unsigned int rx_num_samples,
+              struct bladerf_metadata *rx_meta,
+              void const *tx_samples,
+              unsigned int tx_num_samples,
+              struct bladerf_metadata *tx_meta,
+              uint64_t tx_offset,
+              unsigned int timeout_ms)
+{
+    struct rx_dest dest;
+    uint64_t tx_needed = tx_num_samples;
+    int status;
+
+    if (rx == NULL || tx == NULL || rx_samples == NULL ||
+        tx_samples == NULL || rx_meta == NULL || tx_meta == NULL) {
+        log_debug("NULL pointer passed to %s\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (!rx->initialized || !tx->initialized) {
+        return BLADERF_ERR_INVAL;
+    } else if (!uses_sample_meta(rx) || !uses_sample_meta(tx)) {
+        log_debug("%s: Both directions require a metadata format.\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (rx->split != NULL) {
+        log_debug("%s: Per-channel queues are in use.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (rx->tap != NULL) {
+        log_debug("%s: RX taps are in use.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (rx->resample != NULL) {
+        log_debug("%s: The RX resampler is in use.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (tx_offset != 0 &&
+               (tx_meta->flags & BLADERF_META_FLAG_TX_NOW) != 0) {
+        log_debug("%s: A TX offset requires a scheduled burst.\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* Padding and flushing may use up to two messages in addition to the
+     * caller's samples, as per sync_tx_locked() */
+    if (tx_meta->flags & (BLADERF_META_FLAG_TX_UPDATE_TIMESTAMP |
+                          BLADERF_META_FLAG_TX_BURST_END)) {
+        tx_needed += 2 * tx->meta.samples_per_msg;
+    }
+
+    dest.ptr[0] = (uint8_t *)rx_samples;
+    dest.ptr[1] = NULL;
+    dest.planar = false;
+
+    MUTEX_LOCK(&rx->lock);
+    MUTEX_LOCK(&tx->lock);
+
+    status = duplex_attach(rx, tx);
+    if (status == 0) {
+        status = duplex_wait(rx, tx, rx_num_samples, tx_needed, timeout_ms);
+    }
+
+    if (status == 0) {
+        status = sync_rx_to_dest_locked(rx, &dest, rx_num_samples, rx_meta,
+                                        timeout_ms);
+    }
+
+    if (status == 0) {
+        if (tx_offset != 0) {
+            tx_meta->timestamp = rx_meta->timestamp + tx_offset;
+        }
+
+        status = sync_tx_locked(tx, tx_samples, tx_num_samples, tx_meta,
+                                timeout_ms);
+    }
+
+    api_poll_update(tx);
+    api_poll_update(rx);
+
+    MUTEX_UNLOCK(&tx->lock);
+    MUTEX_UNLOCK(&rx->lock);
+
+    return status;
+}
+
+void sync_duplex_deinit(struct bladerf *dev)
+{
+    struct sync_duplex *d = dev->sync_duplex;
+
+    if (d == NULL) {
+        return;
+    }
+
+    pthread_cond_destroy(&d->ready);
+    MUTEX_DESTROY(&d->lock);
+    alloc_free(d);
+
+    dev->sync_duplex = NULL;
+}
+
+int sync_tx_acquire(struct bladerf_sync *s, void **samples,
+                    unsigned int *num_samples, unsigned int timeout_ms)
+{
+    struct buffer_mgmt *b;
+    uint8_t *buf_dest;
+    int status = 0;
+
+    if (s == NULL || samples == NULL || num_samples == NULL) {
+        log_debug("NULL pointer passed to %s\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (!s->initialized) {
+        return BLADERF_ERR_INVAL;
+    } else if (s->stream_config.convert_cf32) {
+        log_debug("%s: Not supported with host-converted sample formats.\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    MUTEX_LOCK(&s->lock);
+
+    if (s->lease.active) {
+        log_debug("%s: Previously acquired buffer region not yet committed.\n",
+                  __FUNCTION__);
+        status = BLADERF_ERR_INVAL;
+        goto out;
+    }
+
+    b = &s->buf_mgmt;
+
+    while (status == 0 && s->state != SYNC_STATE_USING_BUFFER &&
+           s->state != SYNC_STATE_USING_BUFFER_META &&
+           s->state != SYNC_STATE_USING_PACKET_META) {
+        status = tx_buffer_step(s, timeout_ms);
+    }
+
+    if (status != 0) {
+        goto out;
+    }
+
+    MUTEX_LOCK(&b->lock);
+
+    buf_dest = (uint8_t *)b->buffers[b->prod_i];
+
+    switch (s->state) {
+        case SYNC_STATE_USING_BUFFER:
+            s->lease.samples = buf_dest + samples2bytes(s, b->partial_off);
+            s->lease.num_samples =
+                s->stream_config.samples_per_buffer - b->partial_off;
+            break;
+
+        case SYNC_STATE_USING_BUFFER_META:
+            /* The caller fills in the message headers, so the entire buffer
+             * must be handed over. This cannot be done if sync_tx() has
+             * already partially filled it. */
+            if (s->meta.msg_num != 0 ||
+                s->meta.state != SYNC_META_STATE_HEADER) {
+                log_debug("%s: Current buffer partially filled by "
+                          "sync_tx().\n", __FUNCTION__);
+                status = BLADERF_ERR_INVAL;
+            } else {
+                s->lease.samples = buf_dest;
+                s->lease.num_samples = s->stream_config.samples_per_buffer;
+            }
+            break;
+
+        case SYNC_STATE_USING_PACKET_META:
+            s->lease.samples = buf_dest + METADATA_HEADER_SIZE;
+            s->lease.num_samples =
+                s->stream_config.samples_per_buffer -
+                (unsigned int)(METADATA_HEADER_SIZE /
+                               s->stream_config.bytes_per_sample);
+            break;
+
+        default:
+            assert(!"Invalid state");
+            status = BLADERF_ERR_UNEXPECTED;
+    }
+
+    MUTEX_UNLOCK(&b->lock);
+
+    if (status == 0) {
+        s->lease.active = true;
+        *samples = s->lease.samples;
+        *num_samples = s->lease.num_samples;
+
+        log_verbose("%s: Lent %u samples in buf[%u]\n", __FUNCTION__,
+                    s->lease.num_samples, b->prod_i);
+    }
+
+out:
+    timeline_sync_result(s->dev, BLADERF_TX, status, 0);
+    api_poll_update(s);
+    MUTEX_UNLOCK(&s->lock);
+    return status;
+}
+
+int sync_tx_commit(struct bladerf_sync *s, const void *samples,
+                   unsigned int num_samples)
+{
+    struct buffer_mgmt *b;
+    int status = 0;
+
+    if (s == NULL || samples == NULL || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&s->lock);
+
+    if (!s->lease.active || samples != s->lease.samples) {
+        log_debug("%s: Pointer does not refer to an acquired buffer region.\n",
+                  __FUNCTION__);
+        status = BLADERF_ERR_INVAL;
+        goto out;
+    }
+
+    if (num_samples > s->lease.num_samples ||
+        (s->state == SYNC_STATE_USING_BUFFER_META &&
+         num_samples != s->lease.num_samples)) {
+        log_debug("%s: Invalid sample count: %u\n", __FUNCTION__, num_samples);
+        status = BLADERF_ERR_INVAL;
+        goto out;
+    }
+
+    b = &s->buf_mgmt;
+
+    MUTEX_LOCK(&b->lock);
+
+    switch (s->state) {
+        case SYNC_STATE_USING_BUFFER:
+            b->partial_off += num_samples;
+            if (b->partial_off >= s->stream_config.samples_per_buffer) {
+                assert(b->partial_off == s->stream_config.samples_per_buffer);
+                status = advance_tx_buffer(s, b);
+            }
+            break;
+
+        case SYNC_STATE_USING_BUFFER_META:
+            status = advance_tx_buffer(s, b);
+            s->meta.msg_num = 0;
+            set_state(s, SYNC_STATE_WAIT_FOR_BUFFER);
+            break;
+
+        case SYNC_STATE_USING_PACKET_META: {
+            uint8_t *buf_dest = (uint8_t *)b->buffers[b->prod_i];
+
+            b->actual_lengths[b->prod_i] =
+                samples2bytes(s, num_samples) + METADATA_HEADER_SIZE;
+
+            metadata_set_packet(buf_dest, 0, 0, num_samples, 0, 0);
+
+            status = advance_tx_buffer(s, b);
+            s->meta.msg_num = 0;
+            set_state(s, SYNC_STATE_WAIT_FOR_BUFFER);
+            break;
+        }
+
+        default:
+            assert(!"Invalid state");
+            status = BLADERF_ERR_UNEXPECTED;
+    }
+
+    MUTEX_UNLOCK(&b->lock);
+
+    s->lease.active = false;
+    s->lease.samples = NULL;
+    s->lease.num_samples = 0;
+
+out:
+    timeline_sync_result(s->dev, BLADERF_TX, status, 0);
+    api_poll_update(s);
+    MUTEX_UNLOCK(&s->lock);
+    return status;
+}
+
+int sync_start(struct bladerf_sync *s)
+{
+    int status = 0;
+
+    MUTEX_LOCK(&s->lock);
+
+    s->deadline_ns = 0;
+
+    if (s->buf_mgmt.dir == BLADERF_RX) {
+        if (s->state == SYNC_STATE_CHECK_WORKER ||
+            s->state == SYNC_STATE_RESET_BUF_MGMT ||
+            s->state == SYNC_STATE_START_WORKER) {
+            status = sync_rx_start(s, s->stream_config.timeout_ms);
+        }
+    } else {
+        while (status == 0 && (s->state == SYNC_STATE_CHECK_WORKER ||
+                               s->state == SYNC_STATE_START_WORKER)) {
+            status = tx_buffer_step(s, s->stream_config.timeout_ms);
+        }
+    }
+
     MUTEX_UNLOCK(&s->lock);
 
     return status;
 }
 
+int sync_get_stats(struct bladerf_sync *s, struct bladerf_stream_stats *stats)
+{
+    struct bladerf_stream_stats stream_stats;
+    unsigned int i;
+    int status;
+
+    if (s == NULL || stats == NULL || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&s->buf_mgmt.lock);
+    *stats = s->stats;
+    MUTEX_UNLOCK(&s->buf_mgmt.lock);
+
+    if (s->worker == NULL || s->worker->stream == NULL) {
+        return 0;
+    }
+
+    status = async_get_stats(s->worker->stream, &stream_stats);
+    if (status != 0) {
+        return status;
+    }
+
+    /* Transfer-level counters come from the underlying stream, while
+     * buffer handoff statistics are tracked by the sync handle itself */
+    stats->bytes           = stream_stats.bytes;
+    stats->transfers       = stream_stats.transfers;
+    stats->short_transfers = stream_stats.short_transfers;
+    stats->timeouts        = stream_stats.timeouts;
+    stats->callback_max_us = stream_stats.callback_max_us;
+
+    for (i = 0; i < BLADERF_STREAM_STATS_LATENCY_BINS; i++) {
+        stats->callback_latency[i] = stream_stats.callback_latency[i];
+    }
+
+    return 0;
+}
+
+int sync_get_latency(struct bladerf_sync *s,
+                     struct bladerf_sync_latency *latency)
+{
+    struct buffer_mgmt *b;
+
+    if (s == NULL || latency == NULL || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    b = &s->buf_mgmt;
+    memset(latency, 0, sizeof(*latency));
+
+    MUTEX_LOCK(&b->lock);
+    latency->buffer_us   = b->full_interval / 1000;
+    latency->wait_us     = b->last_wait / 1000;
+    latency->wait_max_us = s->stats.max_buffer_full_us;
+    MUTEX_UNLOCK(&b->lock);
+
+    latency->pipeline_us = latency->buffer_us * s->stream_config.num_xfers;
+
+    /* RX: a buffer's first sample was captured one buffer duration before
+     * the buffer completed, and then waited to be consumed.
+     * TX: a buffer waits to be submitted, and then sits behind the
+     * transfers already in flight. */
+    if ((s->stream_config.layout & BLADERF_DIRECTION_MASK) == BLADERF_RX) {
+        latency->total_us = latency->buffer_us + latency->wait_us;
+    } else {
+        latency->total_us = latency->wait_us + latency->pipeline_us;
+    }
+
+    return 0;
+}
+
 unsigned int sync_buf2idx(struct buffer_mgmt *b, void *addr)
 {
     unsigned int i;
 
+    /* Stream buffers are allocated as a single contiguous region, so the
+     * index can be derived from the buffer's offset into that region. */
+    if (b->buf_stride != 0) {
+        const uintptr_t off = (uintptr_t)addr - (uintptr_t)b->buffers[0];
+        const size_t idx = off / b->buf_stride;
+
+        if (idx < b->num_buffers && b->buffers[idx] == addr) {
+            return (unsigned int) idx;
+        }
+    }
+
     for (i = 0; i < b->num_buffers; i++) {
         if (b->buffers[i] == addr) {
             return i;
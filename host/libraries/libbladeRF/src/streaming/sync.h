@@ -29,6 +29,21 @@
 
 #include "thread.h"
 
+#include "helpers/poll_event.h"
+#include "helpers/probes.h"
+#include "helpers/timeline.h"
+#include "helpers/wallclock.h"
+
+/* C11 atomics are used, where available, to allow the API side to poll for
+ * buffer hand-offs without holding the buffer management lock. */
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && \
+    !defined(__STDC_NO_ATOMICS__)
+#   include <stdatomic.h>
+#   define SYNC_HAVE_ATOMICS 1
+#else
+#   define SYNC_HAVE_ATOMICS 0
+#endif
+
 /* These parameters are only written during sync_init */
 struct stream_config {
     bladerf_format format;
@@ -38,7 +53,17 @@ struct stream_config {
     unsigned int num_xfers;
     unsigned int timeout_ms;
 
+    /* Buffers must be a multiple of this many samples. This is a full
+     * USB message under the low-latency profile, or ASYNC_BUFFER_GRANULARITY
+     * otherwise. */
+    unsigned int granularity;
+
     size_t bytes_per_sample;
+
+    /* Host-side sample conversion performed while copying to or from the
+     * caller's buffers. The format above is the on-the-wire format. */
+    bool convert_cf32;
+    size_t user_bytes_per_sample;
 };
 
 typedef enum {
@@ -66,12 +91,34 @@ typedef enum {
 
 #define BUFFER_MGMT_INVALID_INDEX (UINT_MAX)
 
+/* Wakeup shared by the RX and TX buffer management, allowing sync_rxtx() to
+ * wait upon both with a single condition variable. Created by the first
+ * sync_rxtx() call, and retained until the device is closed.
+ *
+ * Lock order: buffer_mgmt.lock, then sync_duplex.lock. */
+struct sync_duplex {
+    MUTEX lock;
+    pthread_cond_t ready;
+    unsigned int signals;   /**< Incremented on each signal */
+};
+
 struct buffer_mgmt {
     sync_buffer_status *status;
     size_t *actual_lengths;
+    uint64_t *full_since;     /**< Time (ns) at which each buffer became
+                               *   SYNC_BUFFER_FULL */
+    uint64_t last_full;       /**< Time (ns) at which a buffer most recently
+                               *   became SYNC_BUFFER_FULL, or 0 */
+    uint64_t full_interval;   /**< Smoothed interval (ns) between buffers
+                               *   becoming SYNC_BUFFER_FULL */
+    uint64_t last_wait;       /**< Time (ns) the most recently used full
+                               *   buffer waited */
 
     void **buffers;
     unsigned int num_buffers;
+    size_t buf_stride;        /**< Distance (bytes) between adjacent buffers,
+                               *   used to compute a buffer's index from
+                               *   its address */
 
     unsigned int prod_i;      /**< Producer index - next buffer to fill */
     unsigned int cons_i;      /**< Consumer index - next buffer to empty */
@@ -90,8 +137,138 @@ struct buffer_mgmt {
     MUTEX lock;
     pthread_cond_t buf_ready; /**< Buffer produced by RX callback, or
                                *   buffer emptied by TX callback */
+
+#if SYNC_HAVE_ATOMICS
+    /* Incremented on each buf_ready signal. The API side may spin on this,
+     * without holding the lock, before falling back to a wait on buf_ready.
+     *
+     * Only this notification is lock-free; `status` is not a
+     * single-producer/single-consumer ring. The worker also moves buffers
+     * the API side owns (discarding unread ones on overrun, reclaiming
+     * stale in-flight ones on restart), so both sides write it. */
+    atomic_uint signal_count;
+#endif
+
+    /* Readiness handle for the API side, created upon the first request for
+     * it. Set while the next buffer to consume (RX) or fill (TX) is ready,
+     * or the one after it when the API side has a buffer in use. */
+    bladerf_direction dir;
+    struct poll_event poll;
+
+    struct bladerf *dev;      /**< Device, for the stream timeline */
+
+    /* Also signaled by sync_buf_signal(), once sync_rxtx() is in use */
+    struct sync_duplex *duplex;
 };
 
+/**
+ * Update the readiness handle, if any, after buffer states have changed.
+ * Assumes the buffer management lock is held.
+ */
+static inline void sync_buf_poll_update(struct buffer_mgmt *b)
+{
+    sync_buffer_status ready;
+    unsigned int i;
+
+    if (!b->poll.valid) {
+        return;
+    }
+
+    if (b->dir == BLADERF_RX) {
+        ready = SYNC_BUFFER_FULL;
+        i     = b->cons_i;
+    } else {
+        ready = SYNC_BUFFER_EMPTY;
+        i     = b->prod_i;
+    }
+
+    if (b->status[i] == SYNC_BUFFER_PARTIAL) {
+        i = (i + 1) % b->num_buffers;
+    }
+
+    poll_event_update(&b->poll, b->status[i] == ready);
+}
+
+/**
+ * Notify the API side that a buffer has changed state.
+ * Assumes the buffer management lock is held.
+ */
+static inline void sync_buf_signal(struct buffer_mgmt *b)
+{
+#if SYNC_HAVE_ATOMICS
+    atomic_fetch_add_explicit(&b->signal_count, 1, memory_order_release);
+#endif
+    /* RX taps may have several consumers waiting */
+    pthread_cond_broadcast(&b->buf_ready);
+    sync_buf_poll_update(b);
+
+    if (b->duplex != NULL) {
+        MUTEX_LOCK(&b->duplex->lock);
+        b->duplex->signals++;
+        pthread_cond_broadcast(&b->duplex->ready);
+        MUTEX_UNLOCK(&b->duplex->lock);
+    }
+}
+
+/**
+ * Set a buffer's status, recording the change for tracing.
+ * Assumes the buffer management lock is held, or that the worker is stopped.
+ */
+static inline void sync_buf_set_status(struct buffer_mgmt *b,
+                                       unsigned int idx,
+                                       sync_buffer_status status)
+{
+    PROBE3(sync_buf, b->dir, idx, status);
+    timeline_sync_buf(b->dev, b->dir, idx, status);
+    b->status[idx] = status;
+}
+
+/**
+ * Mark a buffer full, noting when this occurred.
+ * Assumes the buffer management lock is held.
+ */
+static inline void sync_buf_mark_full(struct buffer_mgmt *b, unsigned int idx)
+{
+    const uint64_t now = wallclock_get_current_nsec();
+
+    /* While streaming, buffers fill at the sample rate, so this interval
+     * is the time spanned by one buffer. A 1/8 weighting smooths out
+     * scheduling jitter. */
+    if (b->last_full != 0) {
+        const uint64_t interval = now - b->last_full;
+
+        if (b->full_interval == 0) {
+            b->full_interval = interval;
+        } else {
+            b->full_interval = b->full_interval - b->full_interval / 8 +
+                               interval / 8;
+        }
+    }
+
+    sync_buf_set_status(b, idx, SYNC_BUFFER_FULL);
+
+    b->last_full       = now;
+    b->full_since[idx] = now;
+}
+
+/**
+ * Account for the time a full buffer waited before use.
+ * Assumes the buffer management lock is held.
+ */
+static inline void sync_buf_full_done(struct buffer_mgmt *b,
+                                      struct bladerf_stream_stats *stats,
+                                      unsigned int idx)
+{
+    const uint64_t wait = wallclock_get_current_nsec() - b->full_since[idx];
+    const uint64_t us   = wait / 1000;
+
+    b->last_wait = wait;
+
+    if (us > stats->max_buffer_full_us) {
+        stats->max_buffer_full_us = us;
+    }
+}
+
 /* State of API-side sync interface */
 typedef enum {
     SYNC_STATE_CHECK_WORKER,
@@ -104,6 +281,14 @@ typedef enum {
     SYNC_STATE_USING_BUFFER_META
 } sync_state;
 
+/* Summary of an RX message header, as indexed by the pass over a buffer's
+ * headers made when the buffer becomes available */
+struct sync_msg_info {
+    uint64_t timestamp;
+    uint32_t flags;
+    bool contiguous; /* Message directly follows the previous one */
+};
+
 struct sync_meta {
     sync_meta_state state; /* State of metadata processing */
 
@@ -133,8 +318,66 @@ struct sync_meta {
 
     uint64_t curr_timestamp; /* Timestamp at the sample we've
                               * consumed up to */
+
+    /* RX: Whether curr_timestamp follows the stream, i.e., a message header
+     * has been read since the stream was (re)started */
+    bool ts_valid;
+
+    /* RX: Samples lost at a discontinuity, yet to be reported to a caller
+     * via bladerf_metadata::gap */
+    uint64_t pending_gap;
+
+    /* RX: Timestamp of the first sample at a new rate, set by
+     * sync_rate_change(), or UINT64_MAX if none is outstanding. This and
+     * rate_change_rate are protected by buf_mgmt.lock. */
+    uint64_t rate_change_ts;
+    bladerf_sample_rate rate_change_rate;
+
+    /* RX: New rate of a change that has been reached, yet to be reported to
+     * a caller via BLADERF_META_STATUS_RATE_CHANGE, or 0 if none */
+    bladerf_sample_rate rate_change_due;
+
+    /* TX: Message header template, built at init. Only the timestamp
+     * differs between messages. */
+    uint8_t tx_header[16];
+
+    /* RX: Header index of the buffer being consumed, with msg_per_buf
+     * entries, or NULL when not using a metadata format */
+    struct sync_msg_info *rx_index;
 };
 
+/* Region of a sync buffer currently lent to the API user via
+ * sync_rx_acquire() or sync_tx_acquire(). */
+struct sync_lease {
+    bool active;              /* A region is currently lent out */
+    uint8_t *samples;         /* Start of the lent region */
+    unsigned int num_samples; /* Number of samples in the lent region */
+
+    /* Used to detect discontinuities between successive leases
+     * (SC16Q11 w/ metadata only) */
+    bool have_timestamp;
+};
+
+/* Timestamp-indexed copy of the most recently received RX messages
+ * (SC16 Q11 w/ metadata, single channel). The message with timestamp t is
+ * held in slot timestamp_to_msg(t) % num_msgs, such that a read from any
+ * timestamp locates its message directly. */
+struct sync_capture {
+    MUTEX lock;
+    bool enabled;
+    uint8_t *msgs;          /* num_msgs messages of meta.msg_size bytes */
+    bool *valid;            /* Slot holds a received message */
+    unsigned int num_msgs;
+    uint64_t phase;         /* Message timestamps modulo samples_per_msg */
+    bool have_msgs;         /* At least one message has been stored */
+    uint64_t first;         /* Timestamp of the first message stored */
+    uint64_t newest;        /* Timestamp of the newest message stored */
+};
+
+struct sync_resample;
+struct sync_split;
+struct sync_tap;
+
 struct bladerf_sync {
     MUTEX lock;
     struct bladerf *dev;
@@ -144,6 +387,41 @@ struct bladerf_sync {
     struct stream_config stream_config;
     struct sync_worker *worker;
     struct sync_meta meta;
+    struct sync_lease lease;
+    struct sync_capture capture;
+
+    /* Per-channel RX queues (BLADERF_RX_X2), or NULL. When present, samples
+     * are received only via sync_split_rx(). */
+    struct sync_split *split;
+
+    /* RX taps, or NULL. When present, samples are received only via
+     * sync_tap_acquire(). */
+    struct sync_tap *tap;
+
+    /* RX resampler, or NULL. When present, sync_rx() returns samples at the
+     * rate requested via bladerf_set_rx_resampler(). */
+    struct sync_resample *resample;
+
+    /* Counters maintained by the sync interface itself. Protected by
+     * buf_mgmt.lock. */
+    struct bladerf_stream_stats stats;
+
+    /* RX sample calibration applied while converting to CF32, indexed by
+     * the position of a channel's samples within the stream. Refreshed at
+     * the start of each RX call. */
+    bool rx_corr;
+    float rx_corr_coeffs[2][4];
+
+    /* Host-side AGC measurement of the RX call in progress, indexed likewise.
+     * Enabled at the start of each RX call. */
+    bool rx_agc;
+    uint64_t agc_energy[2];
+    uint64_t agc_count[2];
+
+    /* Absolute deadline of the RX or TX call in progress, in nanoseconds of
+     * the timeout clock (helpers/timeout.h), or 0 if the call's timeout_ms
+     * applies to each wait instead. Protected by lock. */
+    uint64_t deadline_ns;
 };
 
 /**
@@ -173,18 +451,352 @@ int sync_init(struct bladerf_sync *sync,
  */
 void sync_deinit(struct bladerf_sync *sync);
 
+/**
+ * Derive sync stream parameters from the current sample rate, channel layout,
+ * USB speed, and a target latency
+ *
+ * Under the direction's low-latency profile, buffers are sized down to a
+ * single USB message and more transfers are kept in flight.
+ *
+ * @param       dev             Device handle
+ * @param[in]   layout          Stream direction and layout
+ * @param[in]   format          Sample format
+ * @param[in]   latency_us      Target time spanned by the transfers in flight,
+ *                              in microseconds. 0 selects a default that
+ *                              favors robustness.
+ * @param[out]  num_buffers     Number of buffers
+ * @param[out]  buffer_size     Buffer size, in samples
+ * @param[out]  num_transfers   Number of transfers
+ *
+ * @return 0 on success, BLADERF_ERR_* on failure
+ */
+int sync_auto_config(struct bladerf *dev,
+                     bladerf_channel_layout layout,
+                     bladerf_format format,
+                     unsigned int latency_us,
+                     unsigned int *num_buffers,
+                     unsigned int *buffer_size,
+                     unsigned int *num_transfers);
+
+/**
+ * Re-derive and apply the stream parameters of an automatically sized sync
+ * configuration, if its stream is idle. Call with the device lock held,
+ * after changing the sample rate.
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Direction to update
+ */
+void sync_auto_retune(struct bladerf *dev, bladerf_direction dir);
+
+/**
+ * Note a change of sample rate on a running RX stream, to be reported via
+ * BLADERF_META_STATUS_RATE_CHANGE with the first sample at or after the
+ * specified timestamp. This has no effect if the sync interface is not
+ * initialized, or does not use a metadata format.
+ *
+ * @param       sync        Sync handle
+ * @param[in]   timestamp   Timestamp of the first sample at the new rate
+ * @param[in]   rate        New sample rate
+ */
+void sync_rate_change(struct bladerf_sync *sync,
+                      uint64_t timestamp,
+                      bladerf_sample_rate rate);
+
 int sync_rx(struct bladerf_sync *sync,
             void *samples,
             unsigned int num_samples,
             struct bladerf_metadata *metadata,
             unsigned int timeout_ms);
 
+/**
+ * Receive samples as per sync_rx(), failing with BLADERF_ERR_TIMEOUT if they
+ * are not available by an absolute deadline
+ *
+ * @param   deadline_ns     Deadline, in nanoseconds of the timeout clock
+ *                          (see timeout_clock_get_nsec()). Must be non-zero.
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_rx_deadline(struct bladerf_sync *sync,
+                     void *samples,
+                     unsigned int num_samples,
+                     struct bladerf_metadata *metadata,
+                     uint64_t deadline_ns);
+
+/**
+ * Receive samples, deinterleaving them into separate per-channel destinations
+ * as they are copied out of the sync buffers.
+ *
+ * For a single-channel layout, this is equivalent to sync_rx() into
+ * samples[0].
+ *
+ * @param   samples         Array of per-channel destinations
+ * @param   num_samples     Number of samples to receive per channel
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_rx_planar(struct bladerf_sync *sync,
+                   void *const samples[],
+                   unsigned int num_samples,
+                   struct bladerf_metadata *metadata,
+                   unsigned int timeout_ms);
+
+/**
+ * Receive into per-channel destinations on behalf of the per-channel RX
+ * queues' worker, bypassing the check that restricts the handle to
+ * sync_split_rx() while the queues are present.
+ *
+ * @param   samples         Per-channel destinations
+ * @param   num_samples     Number of samples to receive per channel
+ * @param   metadata        Sample metadata. `actual_count` is reported per
+ *                          channel.
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_rx_split_fill(struct bladerf_sync *sync,
+                       void *const samples[2],
+                       unsigned int num_samples,
+                       struct bladerf_metadata *metadata,
+                       unsigned int timeout_ms);
+
+/**
+ * Receive interleaved samples on behalf of the RX resampler, bypassing the
+ * check that directs sync_rx() to it. Assumes the sync handle's lock is held.
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_rx_locked(struct bladerf_sync *sync,
+                   void *samples,
+                   unsigned int num_samples,
+                   struct bladerf_metadata *metadata,
+                   unsigned int timeout_ms);
+
+/**
+ * Start the RX stream on behalf of the RX taps, if it is not already running,
+ * stepping the API-side state machine until buffers are awaited. The taps are
+ * reset along with the buffer management. Assumes the sync handle's lock is
+ * held.
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_rx_start(struct bladerf_sync *sync, unsigned int timeout_ms);
+
+/**
+ * Start the stream ahead of the first sync_rx() or sync_tx() call, as for
+ * bladerf_sync_start(). This is a no-op if the stream is already running.
+ *
+ * @param[in]   sync    Sync handle
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_start(struct bladerf_sync *sync);
+
+/**
+ * Obtain a pointer to received samples residing directly in the next available
+ * sync buffer, rather than copying them out.
+ *
+ * The region remains owned by the caller until sync_rx_release() is called.
+ * Only one region may be lent out at a time, and sync_rx() may not be used
+ * while a region is lent out.
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_rx_acquire(struct bladerf_sync *sync,
+                    void **samples,
+                    unsigned int *num_samples,
+                    struct bladerf_metadata *metadata,
+                    unsigned int timeout_ms);
+
+/**
+ * Return a region obtained via sync_rx_acquire(). Once the entirety of its
+ * underlying buffer has been released, the buffer is made available to the
+ * worker for reuse.
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_rx_release(struct bladerf_sync *sync, const void *samples);
+
+/**
+ * Receive into each of the provided blocks in turn, as per sync_rx(), under
+ * a single acquisition of sync->lock. Processing stops at the first block
+ * that fails.
+ *
+ * @param[out]  completed   If non-NULL, set to the number of blocks that
+ *                          were processed successfully
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_rxv(struct bladerf_sync *sync,
+             const struct bladerf_sync_iov *iov,
+             unsigned int iovcnt,
+             unsigned int *completed,
+             unsigned int timeout_ms);
+
 int sync_tx(struct bladerf_sync *sync,
             void const *samples,
             unsigned int num_samples,
             struct bladerf_metadata *metadata,
             unsigned int timeout_ms);
 
+/**
+ * Transmit samples as per sync_tx(), failing with BLADERF_ERR_TIMEOUT if
+ * buffer space is not available by an absolute deadline
+ *
+ * @param   deadline_ns     Deadline, in nanoseconds of the timeout clock
+ *                          (see timeout_clock_get_nsec()). Must be non-zero.
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_tx_deadline(struct bladerf_sync *sync,
+                     void const *samples,
+                     unsigned int num_samples,
+                     struct bladerf_metadata *metadata,
+                     uint64_t deadline_ns);
+
+/**
+ * Transmit each of the provided blocks in turn, as per sync_tx(), under a
+ * single acquisition of sync->lock. Processing stops at the first block that
+ * fails.
+ *
+ * @param[out]  completed   If non-NULL, set to the number of blocks that
+ *                          were processed successfully
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_txv(struct bladerf_sync *sync,
+             const struct bladerf_sync_iov *iov,
+             unsigned int iovcnt,
+             unsigned int *completed,
+             unsigned int timeout_ms);
+
+/**
+ * Receive one block and transmit one block, as per bladerf_sync_rxtx(),
+ * under a single acquisition of each handle's sync->lock. Both handles must
+ * use a format with per-sample metadata.
+ *
+ * rx->lock is taken before tx->lock.
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_rxtx(struct bladerf_sync *rx,
+              struct bladerf_sync *tx,
+              void *rx_samples,
+              unsigned int rx_num_samples,
+              struct bladerf_metadata *rx_meta,
+              void const *tx_samples,
+              unsigned int tx_num_samples,
+              struct bladerf_metadata *tx_meta,
+              uint64_t tx_offset,
+              unsigned int timeout_ms);
+
+/**
+ * Free the wakeup shared by sync_rxtx() calls, if one was created. This must
+ * be called once the sync interfaces have been deinitialized.
+ *
+ * @param       dev         Device handle
+ */
+void sync_duplex_deinit(struct bladerf *dev);
+
+/**
+ * Obtain a pointer to the next available TX sync buffer, such that samples
+ * may be written into it directly rather than copied in by sync_tx().
+ *
+ * For the SC16Q11 w/ metadata format, the entire buffer (including the space
+ * for each message's header) is provided and the caller is responsible for
+ * filling in the headers.
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_tx_acquire(struct bladerf_sync *sync,
+                    void **samples,
+                    unsigned int *num_samples,
+                    unsigned int timeout_ms);
+
+/**
+ * Commit the samples written to a region returned by sync_tx_acquire(),
+ * submitting the underlying buffer once it has been filled.
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_tx_commit(struct bladerf_sync *sync,
+                   const void *samples,
+                   unsigned int num_samples);
+
+/**
+ * Snapshot the throughput and health counters of a sync handle, including
+ * those of its underlying stream.
+ *
+ * This does not acquire sync->lock, and may be called while another
+ * thread is in sync_rx() or sync_tx().
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_get_stats(struct bladerf_sync *sync,
+                   struct bladerf_stream_stats *stats);
+
+/**
+ * Get the sync handle's readiness handle, creating it if needed.
+ * See bladerf_get_sync_poll_handle().
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_get_poll_handle(struct bladerf_sync *sync,
+                         bladerf_poll_handle *handle);
+
+/**
+ * Report the measured latency of a sync handle's buffer pipeline.
+ *
+ * Like sync_get_stats(), this does not acquire sync->lock.
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_get_latency(struct bladerf_sync *sync,
+                     struct bladerf_sync_latency *latency);
+
+/**
+ * Allocate the RX capture of a sync handle, spanning the device's configured
+ * capture duration at the current sample rate. Called by sync_init().
+ *
+ * The capture is left disabled if no duration is configured, or if the
+ * handle's format and layout are not supported.
+ */
+void sync_capture_init(struct bladerf_sync *sync);
+
+/**
+ * Free the RX capture of a sync handle. Called by sync_deinit().
+ */
+void sync_capture_deinit(struct bladerf_sync *sync);
+
+/**
+ * Copy the messages of a received buffer into the RX capture.
+ * Called by the RX worker for each completed transfer.
+ */
+void sync_capture_store(struct bladerf_sync *sync,
+                        const uint8_t *buf,
+                        size_t num_samples);
+
+/**
+ * Read samples from the RX capture, starting at metadata->timestamp.
+ *
+ * This does not acquire sync->lock, and may be called while another
+ * thread is in sync_rx().
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_capture_read(struct bladerf_sync *sync,
+                      void *samples,
+                      unsigned int num_samples,
+                      struct bladerf_metadata *metadata);
+
+/**
+ * Get the range of timestamps spanned by the RX capture.
+ *
+ * @return 0 or BLADERF_ERR_* value on failure
+ */
+int sync_capture_range(struct bladerf_sync *sync,
+                       uint64_t *oldest,
+                       uint64_t *newest);
+
 unsigned int sync_buf2idx(struct buffer_mgmt *b, void *addr);
 
 void *sync_idx2buf(struct buffer_mgmt *b, unsigned int idx);
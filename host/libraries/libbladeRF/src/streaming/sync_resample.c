@@ -0,0 +1,381 @@
+/*
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "log.h"
+#include "sample_convert.h"
+
+#include "board/board.h"
+#include "helpers/alloc.h"
+#include "helpers/resample.h"
+
+#include "sync.h"
+#include "sync_resample.h"
+
+struct sync_resample {
+    struct resampler *r;
+    unsigned int channels;
+    bool meta;                  /* Stream carries timestamps */
+    bool cf32;                  /* Samples are provided as floats */
+    size_t chunk;               /* Input frames read at once */
+
+    uint64_t out_num;           /* Output rate, in samples/second */
+    uint64_t out_den;
+
+    void *in;                   /* Input frames, in the stream's format */
+    float *in_f;                /* Input frames as floats, for SC16 Q11 */
+    float *out_f;               /* Output frames, before SC16 Q11 conversion */
+
+    /* Input read past a discontinuity, to be pushed by the next call */
+    size_t pending;
+    struct bladerf_metadata pending_meta;
+
+    bool running;               /* Input has been pushed since a restart */
+    uint64_t origin;            /* Timestamp of the first input frame pushed
+                                 * since the restart */
+    uint64_t next_ts;           /* Timestamp of the next input frame */
+};
+
+/* Express a rate as num / den samples/second */
+static bool rate_to_frac(const struct bladerf_rational_rate *rate,
+                         uint64_t *num, uint64_t *den)
+{
+    const uint64_t d = (rate->den == 0) ? 1 : rate->den;
+
+    if (rate->integer > (UINT64_MAX - rate->num) / d) {
+        return false;
+    }
+
+    *num = rate->integer * d + rate->num;
+    *den = d;
+    return *num != 0;
+}
+
+/* (Re)create the resampler for a device rate of in_num / in_den */
+static int create(struct sync_resample *rs, uint64_t in_num, uint64_t in_den)
+{
+    const long double in  = (long double)in_num / in_den;
+    const long double out = (long double)rs->out_num / rs->out_den;
+
+    resampler_destroy(rs->r);
+    rs->r = NULL;
+
+    if (in > out * RESAMPLE_DECIMATION_MAX) {
+        log_debug("%s: Decimation from %.0Lf to %.3Lf Hz exceeds a factor of "
+                  "%u.\n", __FUNCTION__, in, out, RESAMPLE_DECIMATION_MAX);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    rs->r = resampler_create(in_num, in_den, rs->out_num, rs->out_den,
+                             rs->channels, rs->chunk);
+    if (rs->r == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    log_verbose("%s: %.3Lf Hz to %.3Lf Hz\n", __FUNCTION__, in, out);
+    return 0;
+}
+
+int sync_resample_init(struct bladerf_sync *s)
+{
+    const struct stream_config *c = &s->stream_config;
+    struct sync_resample *rs;
+    struct bladerf_rational_rate rate;
+    uint64_t in_num, in_den;
+    size_t frame_bytes;
+    int status;
+
+    s->resample = NULL;
+
+    if ((c->layout & BLADERF_DIRECTION_MASK) != BLADERF_RX ||
+        (s->dev->rx_resample_rate.integer == 0 &&
+         s->dev->rx_resample_rate.num == 0)) {
+        return 0;
+    }
+
+    if (s->split != NULL || s->tap != NULL) {
+        log_debug("%s: The RX resampler cannot be combined with per-channel "
+                  "queues or RX taps.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    switch (c->format) {
+        case BLADERF_FORMAT_SC16_Q11:
+        case BLADERF_FORMAT_SC16_Q11_META:
+        case BLADERF_FORMAT_CF32:
+        case BLADERF_FORMAT_CF32_META:
+            break;
+
+        default:
+            log_debug("%s: The RX resampler requires an SC16 Q11 or CF32 "
+                      "format.\n", __FUNCTION__);
+            return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    status = s->dev->board->get_rational_sample_rate(s->dev,
+                                                     BLADERF_CHANNEL_RX(0),
+                                                     &rate);
+    if (status != 0) {
+        return status;
+    }
+
+    if (!rate_to_frac(&rate, &in_num, &in_den)) {
+        log_debug("%s: Unusable device sample rate.\n", __FUNCTION__);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    rs = alloc_calloc(1, sizeof(*rs));
+    if (rs == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    rs->channels = (c->layout == BLADERF_RX_X2) ? 2 : 1;
+    rs->meta     = (c->format == BLADERF_FORMAT_SC16_Q11_META ||
+                    c->format == BLADERF_FORMAT_CF32_META);
+    rs->cf32     = c->convert_cf32;
+    rs->chunk    = c->samples_per_buffer / rs->channels;
+
+    /* The output rate was validated by bladerf_set_rx_resampler() */
+    rate_to_frac(&s->dev->rx_resample_rate, &rs->out_num, &rs->out_den);
+
+    frame_bytes = rs->channels * (rs->cf32 ? 2 * sizeof(float)
+                                           : 2 * sizeof(int16_t));
+    rs->in = alloc_malloc(rs->chunk * frame_bytes);
+    if (rs->in == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto error;
+    }
+
+    if (!rs->cf32) {
+        rs->in_f  = alloc_malloc(rs->chunk * rs->channels * 2 * sizeof(float));
+        rs->out_f = alloc_malloc(rs->chunk * rs->channels * 2 * sizeof(float));
+        if (rs->in_f == NULL || rs->out_f == NULL) {
+            status = BLADERF_ERR_MEM;
+            goto error;
+        }
+    }
+
+    status = create(rs, in_num, in_den);
+    if (status != 0) {
+        goto error;
+    }
+
+    s->resample = rs;
+    return 0;
+
+error:
+    alloc_free(rs->in);
+    alloc_free(rs->in_f);
+    alloc_free(rs->out_f);
+    alloc_free(rs);
+    return status;
+}
+
+void sync_resample_deinit(struct bladerf_sync *s)
+{
+    struct sync_resample *rs = s->resample;
+
+    if (rs != NULL) {
+        resampler_destroy(rs->r);
+        alloc_free(rs->in);
+        alloc_free(rs->in_f);
+        alloc_free(rs->out_f);
+        alloc_free(rs);
+        s->resample = NULL;
+    }
+}
+
+/* Push the input frames held in rs->in, restarting the resampler first if
+ * they do not follow those pushed previously */
+static int push_input(struct sync_resample *rs,
+                      size_t frames,
+                      const struct bladerf_metadata *in_meta,
+                      struct bladerf_metadata *user_meta)
+{
+    const float *in = rs->cf32 ? (const float *)rs->in : rs->in_f;
+    int status;
+
+    if (rs->meta) {
+        if (in_meta->status & BLADERF_META_STATUS_RATE_CHANGE) {
+            status = create(rs, in_meta->sample_rate, 1);
+            if (status != 0) {
+                return status;
+            }
+
+            user_meta->status |= BLADERF_META_STATUS_RATE_CHANGE;
+            user_meta->sample_rate = in_meta->sample_rate;
+            rs->running = false;
+        } else if (rs->running && in_meta->timestamp != rs->next_ts) {
+            user_meta->gap = in_meta->timestamp - rs->next_ts;
+            resampler_reset(rs->r);
+            rs->running = false;
+        }
+
+        if (!rs->running) {
+            rs->origin  = in_meta->timestamp;
+            rs->running = true;
+        }
+
+        rs->next_ts = in_meta->timestamp + frames;
+    }
+
+    if (!rs->cf32) {
+        sc16q11_to_float(rs->in, rs->in_f, frames * rs->channels);
+    }
+
+    resampler_push(rs->r, in, frames);
+    return 0;
+}
+
+/* Whether input just read cannot be pushed until the output resampled from
+ * the preceding input has been returned */
+static bool discontinuous(const struct sync_resample *rs,
+                          const struct bladerf_metadata *in_meta)
+{
+    return rs->meta &&
+           ((in_meta->status & BLADERF_META_STATUS_RATE_CHANGE) ||
+            (rs->running && in_meta->timestamp != rs->next_ts));
+}
+
+int sync_resample_rx(struct bladerf_sync *s,
+                     void *samples,
+                     unsigned int num_samples,
+                     struct bladerf_metadata *user_meta,
+                     unsigned int timeout_ms)
+{
+    struct sync_resample *rs = s->resample;
+    const size_t frames      = num_samples / rs->channels;
+    size_t produced          = 0;
+    uint64_t first_pos       = 0;
+    int status               = 0;
+
+    if (rs->meta) {
+        if (user_meta == NULL) {
+            log_debug("NULL metadata pointer passed to %s\n", __FUNCTION__);
+            return BLADERF_ERR_INVAL;
+        } else if ((user_meta->flags & BLADERF_META_FLAG_RX_NOW) == 0) {
+            log_debug("%s: The RX resampler requires "
+                      "BLADERF_META_FLAG_RX_NOW.\n", __FUNCTION__);
+            return BLADERF_ERR_INVAL;
+        }
+
+        user_meta->status      = 0;
+        user_meta->gap         = 0;
+        user_meta->sample_rate = 0;
+        user_meta->rx_gain[0]  = 0;
+        user_meta->rx_gain[1]  = 0;
+    }
+
+    if (rs->pending != 0) {
+        status = push_input(rs, rs->pending, &rs->pending_meta, user_meta);
+        rs->pending = 0;
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    while (produced < frames) {
+        struct bladerf_metadata in_meta;
+        size_t want, n;
+
+        /* Output frames, converted in chunks if needed */
+        if (rs->cf32) {
+            float *out = (float *)samples + 2 * rs->channels * produced;
+
+            if (produced == 0) {
+                first_pos = resampler_position(rs->r, NULL);
+            }
+
+            n = resampler_pull(rs->r, out, frames - produced);
+        } else {
+            int16_t *out = (int16_t *)samples + 2 * rs->channels * produced;
+            const size_t max = frames - produced;
+
+            if (produced == 0) {
+                first_pos = resampler_position(rs->r, NULL);
+            }
+
+            n = resampler_pull(rs->r, rs->out_f,
+                               max < rs->chunk ? max : rs->chunk);
+            float_to_sc16q11(rs->out_f, out, 2 * rs->channels * n);
+        }
+
+        produced += n;
+        if (n != 0) {
+            continue;
+        }
+
+        want = resampler_needed(rs->r, frames - produced);
+        n    = resampler_space(rs->r);
+        if (want > n) {
+            want = n;
+        }
+        if (want == 0) {
+            want = 1;
+        }
+
+        memset(&in_meta, 0, sizeof(in_meta));
+        in_meta.flags = BLADERF_META_FLAG_RX_NOW;
+
+        status = sync_rx_locked(s, rs->in, (unsigned int)(want * rs->channels),
+                                &in_meta, timeout_ms);
+        if (status != 0) {
+            break;
+        }
+
+        n = in_meta.actual_count / rs->channels;
+
+        if (rs->meta) {
+            user_meta->status |= in_meta.status &
+                                 ~(BLADERF_META_STATUS_OVERRUN |
+                                   BLADERF_META_STATUS_RATE_CHANGE);
+
+            /* Return the output preceding a discontinuity on its own */
+            if (produced != 0 && discontinuous(rs, &in_meta)) {
+                if (!(in_meta.status & BLADERF_META_STATUS_RATE_CHANGE)) {
+                    user_meta->status |= BLADERF_META_STATUS_OVERRUN;
+                }
+
+                rs->pending      = n;
+                rs->pending_meta = in_meta;
+                break;
+            }
+
+            if (produced == 0) {
+                user_meta->rx_gain[0] = in_meta.rx_gain[0];
+                user_meta->rx_gain[1] = in_meta.rx_gain[1];
+            }
+        }
+
+        status = push_input(rs, n, &in_meta, user_meta);
+        if (status != 0) {
+            break;
+        }
+    }
+
+    if (status == 0 && rs->meta) {
+        user_meta->timestamp    = rs->origin + first_pos;
+        user_meta->actual_count = (unsigned int)(produced * rs->channels);
+    } else if (status == 0 && user_meta != NULL) {
+        user_meta->actual_count = (unsigned int)(produced * rs->channels);
+    }
+
+    return status;
+}
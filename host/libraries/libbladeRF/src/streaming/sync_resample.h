@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef STREAMING_SYNC_RESAMPLE_H_
+#define STREAMING_SYNC_RESAMPLE_H_
+
+#include <libbladeRF.h>
+
+#include "sync.h"
+
+/* Host-side RX resampling of a sync handle.
+ *
+ * Samples are read from the stream at the device's sample rate, in chunks of
+ * up to a buffer's worth, and resampled to the rate requested via
+ * bladerf_set_rx_resampler(). Each output sample's position is tracked
+ * exactly relative to the device sample that began the current run of
+ * contiguous input, from which the timestamps reported with metadata formats
+ * are derived.
+ *
+ * A discontinuity in the input restarts the resampler, as does a scheduled
+ * sample rate change, which is applied to the input rate. The samples that
+ * follow either are read only by the next call, once those preceding it have
+ * been returned.
+ *
+ * The resampler state is protected by the sync handle's lock. */
+
+/**
+ * Create the RX resampler of a sync handle, if one has been requested via
+ * bladerf_set_rx_resampler(). Called by sync_init().
+ *
+ * @return 0 on success, BLADERF_ERR_* on failure
+ */
+int sync_resample_init(struct bladerf_sync *sync);
+
+/**
+ * Free the RX resampler of a sync handle, if any. Called by sync_deinit().
+ */
+void sync_resample_deinit(struct bladerf_sync *sync);
+
+/**
+ * Receive resampled samples, as for sync_rx(). Assumes the sync handle's
+ * lock is held.
+ *
+ * @param       sync        Sync handle
+ * @param[out]  samples     Interleaved samples, in the stream's format
+ * @param[in]   num_samples Number of samples, counting those of both
+ *                          channels of a BLADERF_RX_X2 stream
+ * @param       metadata    Sample metadata. With a metadata format,
+ *                          BLADERF_META_FLAG_RX_NOW is required.
+ * @param[in]   timeout_ms  Timeout, in milliseconds, of each read from the
+ *                          stream
+ *
+ * @return 0 on success, BLADERF_ERR_* on failure
+ */
+int sync_resample_rx(struct bladerf_sync *sync,
+                     void *samples,
+                     unsigned int num_samples,
+                     struct bladerf_metadata *metadata,
+                     unsigned int timeout_ms);
+
+#endif
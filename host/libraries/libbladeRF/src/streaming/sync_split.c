@@ -0,0 +1,386 @@
+/*
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "minmax.h"
+#include "rel_assert.h"
+
+#include "board/board.h"
+#include "helpers/alloc.h"
+#include "helpers/timeout.h"
+
+#include "sync.h"
+#include "sync_split.h"
+
+/* Timeout used by the worker for each block, such that a request to stop is
+ * noticed promptly while the stream is idle */
+#define SPLIT_POLL_MS 250
+
+struct sync_split {
+    struct bladerf_sync *sync;
+
+    MUTEX lock;
+    pthread_cond_t cond;    /* A block was filled or consumed, or the worker
+                             * stopped */
+    pthread_t thread;
+    bool running;           /* Worker thread has been started */
+    bool stop;              /* Worker thread has been asked to stop */
+    int status;             /* Error that stopped the worker, or 0 */
+
+    bool meta;              /* Blocks carry timestamps */
+    unsigned int num_blocks;
+    unsigned int block_samples; /* Capacity of each block, per channel */
+    size_t block_bytes;
+
+    uint8_t *mem;           /* num_blocks pairs of per-channel blocks */
+    uint64_t *timestamps;   /* Timestamp of each block's first sample */
+    unsigned int *lengths;  /* Samples held in each block, per channel */
+    uint32_t *flags;        /* Metadata status reported with each block */
+
+    uint64_t filled;        /* Blocks filled since the worker started */
+    uint64_t consumed[2];   /* Blocks consumed by each channel */
+    unsigned int offset[2]; /* Samples consumed of each channel's current
+                             * block */
+};
+
+static inline uint8_t *block_ptr(struct sync_split *sp,
+                                 unsigned int slot,
+                                 unsigned int idx)
+{
+    return sp->mem + (2 * (size_t)slot + idx) * sp->block_bytes;
+}
+
+static inline uint64_t consumed_min(const struct sync_split *sp)
+{
+    return (sp->consumed[0] < sp->consumed[1]) ? sp->consumed[0]
+                                               : sp->consumed[1];
+}
+
+static void *split_worker(void *arg)
+{
+    struct sync_split *sp = arg;
+    struct bladerf_metadata meta;
+    void *dest[2];
+    unsigned int slot;
+    int status;
+
+    MUTEX_LOCK(&sp->lock);
+
+    while (!sp->stop) {
+        /* Wait for both channels to have consumed the next block */
+        if (sp->filled - consumed_min(sp) >= sp->num_blocks) {
+            pthread_cond_wait(&sp->cond, &sp->lock);
+            continue;
+        }
+
+        slot    = (unsigned int)(sp->filled % sp->num_blocks);
+        dest[0] = block_ptr(sp, slot, 0);
+        dest[1] = block_ptr(sp, slot, 1);
+
+        /* The block is not visible to consumers until it is counted as
+         * filled, so it may be written without holding the lock */
+        MUTEX_UNLOCK(&sp->lock);
+
+        memset(&meta, 0, sizeof(meta));
+        meta.flags = BLADERF_META_FLAG_RX_NOW;
+
+        status = sync_rx_split_fill(sp->sync, dest, sp->block_samples, &meta,
+                                    SPLIT_POLL_MS);
+
+        MUTEX_LOCK(&sp->lock);
+
+        if (status == BLADERF_ERR_TIMEOUT) {
+            continue;
+        } else if (status != 0) {
+            log_debug("%s: Stopping on error: %s\n", __FUNCTION__,
+                      bladerf_strerror(status));
+            sp->status = status;
+            break;
+        }
+
+        sp->timestamps[slot] = sp->meta ? meta.timestamp : 0;
+        sp->lengths[slot]    = meta.actual_count;
+        sp->flags[slot]      = meta.status;
+        sp->filled++;
+
+        pthread_cond_broadcast(&sp->cond);
+    }
+
+    pthread_cond_broadcast(&sp->cond);
+    MUTEX_UNLOCK(&sp->lock);
+
+    return NULL;
+}
+
+int sync_split_init(struct bladerf_sync *s)
+{
+    struct sync_split *sp;
+    unsigned int block_samples;
+
+    s->split = NULL;
+
+    if (s->stream_config.layout != BLADERF_RX_X2 ||
+        !s->dev->rx_channel_queues) {
+        return 0;
+    }
+
+    switch (s->stream_config.format) {
+        case BLADERF_FORMAT_SC16_Q11:
+        case BLADERF_FORMAT_SC8_Q7:
+            block_samples = s->stream_config.samples_per_buffer / 2;
+            break;
+
+        case BLADERF_FORMAT_SC16_Q11_META:
+        case BLADERF_FORMAT_SC8_Q7_META:
+            block_samples = s->meta.samples_per_msg * s->meta.msg_per_buf / 2;
+            break;
+
+        default:
+            log_debug("%s: Per-channel queues are not supported with "
+                      "this format.\n", __FUNCTION__);
+            return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    sp = alloc_calloc(1, sizeof(*sp));
+    if (sp == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    sp->sync          = s;
+    sp->meta          = (s->stream_config.format != BLADERF_FORMAT_SC16_Q11 &&
+                         s->stream_config.format != BLADERF_FORMAT_SC8_Q7);
+    sp->num_blocks    = uint_max(s->buf_mgmt.num_buffers, 2);
+    sp->block_samples = block_samples;
+    sp->block_bytes   = block_samples * s->stream_config.user_bytes_per_sample;
+
+    sp->mem        = alloc_malloc(2 * sp->num_blocks * sp->block_bytes);
+    sp->timestamps = alloc_calloc(sp->num_blocks, sizeof(sp->timestamps[0]));
+    sp->lengths    = alloc_calloc(sp->num_blocks, sizeof(sp->lengths[0]));
+    sp->flags      = alloc_calloc(sp->num_blocks, sizeof(sp->flags[0]));
+
+    if (sp->mem == NULL || sp->timestamps == NULL || sp->lengths == NULL ||
+        sp->flags == NULL) {
+        alloc_free(sp->mem);
+        alloc_free(sp->timestamps);
+        alloc_free(sp->lengths);
+        alloc_free(sp->flags);
+        alloc_free(sp);
+        return BLADERF_ERR_MEM;
+    }
+
+    MUTEX_INIT(&sp->lock);
+    timeout_cond_init(&sp->cond);
+
+    log_verbose("%s: %u blocks of %u samples per channel\n", __FUNCTION__,
+                sp->num_blocks, sp->block_samples);
+
+    s->split = sp;
+    return 0;
+}
+
+void sync_split_deinit(struct bladerf_sync *s)
+{
+    struct sync_split *sp = s->split;
+
+    if (sp == NULL) {
+        return;
+    }
+
+    MUTEX_LOCK(&sp->lock);
+    sp->stop = true;
+    pthread_cond_broadcast(&sp->cond);
+    MUTEX_UNLOCK(&sp->lock);
+
+    if (sp->running) {
+        pthread_join(sp->thread, NULL);
+    }
+
+    pthread_cond_destroy(&sp->cond);
+    MUTEX_DESTROY(&sp->lock);
+
+    alloc_free(sp->mem);
+    alloc_free(sp->timestamps);
+    alloc_free(sp->lengths);
+    alloc_free(sp->flags);
+    alloc_free(sp);
+
+    s->split = NULL;
+}
+
+/* Assumes the split lock is held */
+static int wait_for_block(struct sync_split *sp,
+                          unsigned int idx,
+                          const struct timespec *deadline)
+{
+    int status;
+
+    while (sp->consumed[idx] == sp->filled) {
+        if (sp->status != 0) {
+            return sp->status;
+        } else if (sp->stop) {
+            return BLADERF_ERR_INVAL;
+        }
+
+        if (deadline == NULL) {
+            status = pthread_cond_wait(&sp->cond, &sp->lock);
+        } else {
+            status = pthread_cond_timedwait(&sp->cond, &sp->lock, deadline);
+        }
+
+        if (status == ETIMEDOUT) {
+            return BLADERF_ERR_TIMEOUT;
+        } else if (status != 0) {
+            return BLADERF_ERR_UNEXPECTED;
+        }
+    }
+
+    return 0;
+}
+
+/* Assumes the split lock is held */
+static void consume(struct sync_split *sp, unsigned int idx, unsigned int n)
+{
+    const unsigned int slot =
+        (unsigned int)(sp->consumed[idx] % sp->num_blocks);
+
+    sp->offset[idx] += n;
+
+    if (sp->offset[idx] >= sp->lengths[slot]) {
+        sp->offset[idx] = 0;
+        sp->consumed[idx]++;
+        pthread_cond_broadcast(&sp->cond);
+    }
+}
+
+int sync_split_rx(struct bladerf_sync *s,
+                  unsigned int idx,
+                  void *samples,
+                  unsigned int num_samples,
+                  struct bladerf_metadata *user_meta,
+                  unsigned int timeout_ms)
+{
+    struct sync_split *sp = s->split;
+    const size_t sample_bytes = s->stream_config.user_bytes_per_sample;
+    struct timespec deadline;
+    unsigned int copied = 0;
+    unsigned int slot, to_copy;
+    uint64_t ts, target = 0, next_ts = 0;
+    uint32_t meta_status = 0;
+    bool now = true;
+    int status = 0;
+
+    if (sp == NULL || idx > 1 || samples == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (sp->meta) {
+        if (user_meta == NULL) {
+            log_debug("NULL metadata pointer passed to %s\n", __FUNCTION__);
+            return BLADERF_ERR_INVAL;
+        }
+
+        now    = (user_meta->flags & BLADERF_META_FLAG_RX_NOW) != 0;
+        target = user_meta->timestamp;
+    }
+
+    if (timeout_ms != 0) {
+        status = populate_abs_timeout(&deadline, timeout_ms);
+        if (status != 0) {
+            return BLADERF_ERR_UNEXPECTED;
+        }
+    }
+
+    MUTEX_LOCK(&sp->lock);
+
+    if (!sp->running && !sp->stop) {
+        if (pthread_create(&sp->thread, NULL, split_worker, sp) != 0) {
+            MUTEX_UNLOCK(&sp->lock);
+            return BLADERF_ERR_UNEXPECTED;
+        }
+
+        sp->running = true;
+    }
+
+    while (copied < num_samples) {
+        status = wait_for_block(sp, idx, (timeout_ms != 0) ? &deadline : NULL);
+        if (status != 0) {
+            break;
+        }
+
+        slot = (unsigned int)(sp->consumed[idx] % sp->num_blocks);
+        ts   = sp->timestamps[slot] + sp->offset[idx];
+
+        if (copied == 0 && !now) {
+            /* Seek to the requested timestamp */
+            const unsigned int left = sp->lengths[slot] - sp->offset[idx];
+
+            if (target < ts) {
+                status = BLADERF_ERR_TIME_PAST;
+                break;
+            } else if (target - ts >= left) {
+                consume(sp, idx, left);
+                continue;
+            } else if (target != ts) {
+                consume(sp, idx, (unsigned int)(target - ts));
+                continue;
+            }
+        }
+
+        if (copied != 0 && sp->meta && ts != next_ts) {
+            /* Return what we have so far at a discontinuity */
+            meta_status |= BLADERF_META_STATUS_OVERRUN;
+            break;
+        }
+
+        if (copied == 0 && sp->meta) {
+            user_meta->timestamp = ts;
+        }
+
+        if (sp->offset[idx] == 0) {
+            meta_status |= sp->flags[slot];
+        }
+
+        to_copy = uint_min(num_samples - copied,
+                           sp->lengths[slot] - sp->offset[idx]);
+
+        /* The worker does not write a block until both channels have
+         * consumed it, so it may be read without holding the lock */
+        MUTEX_UNLOCK(&sp->lock);
+        memcpy((uint8_t *)samples + copied * sample_bytes,
+               block_ptr(sp, slot, idx) + sp->offset[idx] * sample_bytes,
+               to_copy * sample_bytes);
+        MUTEX_LOCK(&sp->lock);
+
+        copied += to_copy;
+        next_ts = ts + to_copy;
+        consume(sp, idx, to_copy);
+    }
+
+    MUTEX_UNLOCK(&sp->lock);
+
+    if (user_meta != NULL) {
+        user_meta->status       = meta_status;
+        user_meta->actual_count = copied;
+    }
+
+    return status;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef STREAMING_SYNC_SPLIT_H_
+#define STREAMING_SYNC_SPLIT_H_
+
+#include <libbladeRF.h>
+
+#include "sync.h"
+
+/* Per-channel RX queues of a BLADERF_RX_X2 sync handle.
+ *
+ * A worker thread receives from the sync handle, deinterleaving (and
+ * converting) each buffer's worth of samples once into a ring of per-channel
+ * blocks. Each channel's blocks are then consumed independently via
+ * sync_split_rx(), allowing each channel to be serviced by its own thread.
+ * A block is recycled once both channels have consumed it, so the slower
+ * consumer paces the stream. */
+
+/**
+ * Create the per-channel queues of a sync handle, if they have been
+ * requested via bladerf_set_rx_channel_queues() and the handle is configured
+ * for BLADERF_RX_X2. Called by sync_init().
+ *
+ * The worker thread is started upon the first sync_split_rx() call.
+ *
+ * @return 0 on success, BLADERF_ERR_* on failure
+ */
+int sync_split_init(struct bladerf_sync *sync);
+
+/**
+ * Stop the worker thread and free the per-channel queues of a sync handle,
+ * if any. Called by sync_deinit().
+ */
+void sync_split_deinit(struct bladerf_sync *sync);
+
+/**
+ * Receive samples of a single channel from the per-channel queues.
+ *
+ * This follows the semantics of sync_rx() for a single channel. Only one
+ * thread may receive from a given channel at a time.
+ *
+ * @param       sync        Sync handle
+ * @param[in]   idx         Channel's position within the stream (0 or 1)
+ * @param[out]  samples     Destination, in the caller's sample format
+ * @param[in]   num_samples Number of samples to receive
+ * @param       metadata    Sample metadata. Required for formats with
+ *                          metadata.
+ * @param[in]   timeout_ms  Timeout, in milliseconds. 0 waits indefinitely.
+ *
+ * @return 0 on success, BLADERF_ERR_* on failure
+ */
+int sync_split_rx(struct bladerf_sync *sync,
+                  unsigned int idx,
+                  void *samples,
+                  unsigned int num_samples,
+                  struct bladerf_metadata *metadata,
+                  unsigned int timeout_ms);
+
+#endif
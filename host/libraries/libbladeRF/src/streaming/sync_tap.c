@@ -0,0 +1,354 @@
+/*
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "rel_assert.h"
+
+#include "board/board.h"
+#include "helpers/alloc.h"
+#include "helpers/timeout.h"
+
+#include "metadata.h"
+#include "sync.h"
+#include "sync_tap.h"
+
+struct tap_consumer {
+    bladerf_rx_tap_policy policy;
+    uint64_t next;          /* Sequence number of the next buffer to acquire */
+    bool held;              /* Buffer next - 1 is held */
+    bool dropped;           /* Buffers were discarded since the last acquire */
+};
+
+struct sync_tap {
+    bool meta;              /* Buffers carry message headers */
+    unsigned int num_taps;
+    uint64_t base;          /* Sequence number of the buffer at cons_i, since
+                             * the stream started */
+    unsigned int *refs;     /* Taps yet to release each full buffer */
+    struct tap_consumer taps[BLADERF_RX_TAPS_MAX];
+};
+
+/* Index of the buffer with sequence number seq */
+static inline unsigned int seq2idx(const struct sync_tap *t,
+                                   const struct buffer_mgmt *b,
+                                   uint64_t seq)
+{
+    return (unsigned int)((b->cons_i + (seq - t->base)) % b->num_buffers);
+}
+
+static inline bool buffer_ready(const struct sync_tap *t,
+                                const struct buffer_mgmt *b,
+                                const struct tap_consumer *c)
+{
+    return (c->next - t->base) < b->num_buffers &&
+           b->status[seq2idx(t, b, c->next)] == SYNC_BUFFER_FULL;
+}
+
+/* Return released buffers to the worker, in order */
+static void recycle(struct bladerf_sync *s)
+{
+    struct sync_tap *t    = s->tap;
+    struct buffer_mgmt *b = &s->buf_mgmt;
+
+    while (b->status[b->cons_i] == SYNC_BUFFER_FULL &&
+           t->refs[b->cons_i] == 0) {
+        sync_buf_full_done(b, &s->stats, b->cons_i);
+        b->status[b->cons_i] = SYNC_BUFFER_EMPTY;
+        b->cons_i = (b->cons_i + 1) % b->num_buffers;
+        t->base++;
+    }
+}
+
+int sync_tap_init(struct bladerf_sync *s)
+{
+    struct sync_tap *t;
+    unsigned int i;
+
+    s->tap = NULL;
+
+    if ((s->stream_config.layout & BLADERF_DIRECTION_MASK) != BLADERF_RX ||
+        s->dev->rx_taps == 0) {
+        return 0;
+    }
+
+    if (s->split != NULL) {
+        log_debug("%s: RX taps cannot be combined with per-channel "
+                  "queues.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (s->stream_config.convert_cf32) {
+        log_debug("%s: RX taps are not supported with host-converted "
+                  "sample formats.\n", __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    t = alloc_calloc(1, sizeof(*t));
+    if (t == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    t->refs = alloc_calloc(s->buf_mgmt.num_buffers, sizeof(t->refs[0]));
+    if (t->refs == NULL) {
+        alloc_free(t);
+        return BLADERF_ERR_MEM;
+    }
+
+    t->meta = (s->stream_config.format == BLADERF_FORMAT_SC16_Q11_META ||
+               s->stream_config.format == BLADERF_FORMAT_SC8_Q7_META);
+    t->num_taps = s->dev->rx_taps;
+
+    for (i = 0; i < t->num_taps; i++) {
+        t->taps[i].policy = s->dev->rx_tap_policy[i];
+    }
+
+    log_verbose("%s: %u taps\n", __FUNCTION__, t->num_taps);
+
+    s->tap = t;
+    return 0;
+}
+
+void sync_tap_deinit(struct bladerf_sync *s)
+{
+    if (s->tap == NULL) {
+        return;
+    }
+
+    alloc_free(s->tap->refs);
+    alloc_free(s->tap);
+    s->tap = NULL;
+}
+
+void sync_tap_filled(struct bladerf_sync *s, unsigned int idx)
+{
+    s->tap->refs[idx] = s->tap->num_taps;
+}
+
+void sync_tap_reclaim(struct bladerf_sync *s)
+{
+    struct sync_tap *t    = s->tap;
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    const unsigned int idx = b->cons_i;
+    struct tap_consumer *c;
+    unsigned int i;
+
+    if (b->prod_i != idx || b->status[idx] != SYNC_BUFFER_FULL) {
+        return;
+    }
+
+    for (i = 0; i < t->num_taps; i++) {
+        c = &t->taps[i];
+
+        if (c->held && c->next == t->base + 1) {
+            return;
+        } else if (c->next == t->base &&
+                   c->policy != BLADERF_RX_TAP_DROP) {
+            return;
+        }
+    }
+
+    for (i = 0; i < t->num_taps; i++) {
+        c = &t->taps[i];
+
+        if (c->next == t->base) {
+            log_verbose("%s: Dropping buf[%u] for tap %u\n", __FUNCTION__,
+                        idx, i);
+            c->next++;
+            c->dropped = true;
+            t->refs[idx]--;
+        }
+    }
+
+    assert(t->refs[idx] == 0);
+    recycle(s);
+}
+
+int sync_tap_reset(struct bladerf_sync *s)
+{
+    struct sync_tap *t    = s->tap;
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    unsigned int i;
+
+    if (t == NULL) {
+        return 0;
+    }
+
+    for (i = 0; i < t->num_taps; i++) {
+        if (t->taps[i].held) {
+            log_debug("%s: Tap %u must release its buffer before the "
+                      "stream restarts.\n", __FUNCTION__, i);
+            return BLADERF_ERR_INVAL;
+        }
+    }
+
+    for (i = 0; i < b->num_buffers; i++) {
+        if (b->status[i] == SYNC_BUFFER_FULL) {
+            b->status[i] = SYNC_BUFFER_EMPTY;
+        }
+    }
+
+    for (i = 0; i < t->num_taps; i++) {
+        t->taps[i].next    = 0;
+        t->taps[i].dropped = false;
+    }
+
+    t->base = 0;
+    return 0;
+}
+
+int sync_tap_acquire(struct bladerf_sync *s,
+                     unsigned int tap,
+                     const void **samples,
+                     unsigned int *num_samples,
+                     struct bladerf_metadata *user_meta,
+                     unsigned int timeout_ms)
+{
+    struct sync_tap *t    = s->tap;
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    struct tap_consumer *c;
+    struct timespec deadline;
+    unsigned int idx;
+    int status = 0;
+
+    if (t == NULL || tap >= t->num_taps) {
+        log_debug("%s: RX tap %u is not in use.\n", __FUNCTION__, tap);
+        return BLADERF_ERR_INVAL;
+    } else if (samples == NULL || num_samples == NULL) {
+        log_debug("NULL pointer passed to %s\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    c = &t->taps[tap];
+
+    /* Only this tap's caller and sync_tap_reset() modify this. The latter
+     * does not while a buffer is held. */
+    if (c->held) {
+        log_debug("%s: Previously acquired buffer not yet released.\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (timeout_ms != 0) {
+        status = populate_abs_timeout(&deadline, timeout_ms);
+        if (status != 0) {
+            return BLADERF_ERR_UNEXPECTED;
+        }
+    }
+
+    while (true) {
+        /* Start or restart the stream, as needed */
+        MUTEX_LOCK(&s->lock);
+        status = sync_rx_start(s, timeout_ms);
+        MUTEX_UNLOCK(&s->lock);
+
+        if (status != 0) {
+            return status;
+        }
+
+        MUTEX_LOCK(&b->lock);
+
+        if (!buffer_ready(t, b, c)) {
+            if (timeout_ms == 0) {
+                status = pthread_cond_wait(&b->buf_ready, &b->lock);
+            } else {
+                status = pthread_cond_timedwait(&b->buf_ready, &b->lock,
+                                                &deadline);
+            }
+
+            if (status == ETIMEDOUT) {
+                status = BLADERF_ERR_TIMEOUT;
+            } else if (status != 0) {
+                status = BLADERF_ERR_UNEXPECTED;
+            }
+        }
+
+        if (buffer_ready(t, b, c)) {
+            break;
+        }
+
+        MUTEX_UNLOCK(&b->lock);
+
+        if (status != 0) {
+            return status;
+        }
+
+        /* Woken without a buffer, as occurs when the stream ends. Have the
+         * next pass check on the worker. */
+        MUTEX_LOCK(&s->lock);
+        s->state = SYNC_STATE_CHECK_WORKER;
+        MUTEX_UNLOCK(&s->lock);
+    }
+
+    idx = seq2idx(t, b, c->next);
+    c->next++;
+    c->held = true;
+
+    *samples     = b->buffers[idx];
+    *num_samples = (unsigned int)b->actual_lengths[idx];
+
+    if (user_meta != NULL) {
+        user_meta->status       = c->dropped ? BLADERF_META_STATUS_OVERRUN : 0;
+        user_meta->actual_count = *num_samples;
+        user_meta->timestamp    =
+            t->meta ? metadata_get_timestamp((const uint8_t *)b->buffers[idx])
+                    : 0;
+    }
+
+    c->dropped = false;
+
+    MUTEX_UNLOCK(&b->lock);
+
+    return 0;
+}
+
+int sync_tap_release(struct bladerf_sync *s,
+                     unsigned int tap,
+                     const void *samples)
+{
+    struct sync_tap *t    = s->tap;
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    struct tap_consumer *c;
+    unsigned int idx;
+    int status = 0;
+
+    if (t == NULL || tap >= t->num_taps) {
+        log_debug("%s: RX tap %u is not in use.\n", __FUNCTION__, tap);
+        return BLADERF_ERR_INVAL;
+    }
+
+    c = &t->taps[tap];
+
+    MUTEX_LOCK(&b->lock);
+
+    idx = seq2idx(t, b, c->next - 1);
+
+    if (!c->held || b->buffers[idx] != samples) {
+        log_debug("%s: Buffer is not held by tap %u.\n", __FUNCTION__, tap);
+        status = BLADERF_ERR_INVAL;
+    } else {
+        c->held = false;
+        t->refs[idx]--;
+        recycle(s);
+    }
+
+    MUTEX_UNLOCK(&b->lock);
+
+    return status;
+}
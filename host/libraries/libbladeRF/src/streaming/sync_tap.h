@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef STREAMING_SYNC_TAP_H_
+#define STREAMING_SYNC_TAP_H_
+
+#include <libbladeRF.h>
+
+#include "sync.h"
+
+/* RX taps of a sync handle.
+ *
+ * Each tap is a consumer of the RX stream with its own position in it. The
+ * sync buffers themselves are lent to the taps, and each full buffer is
+ * reference-counted by the taps that have yet to release it. A buffer is
+ * returned to the worker once this count drops to zero, so the taps advance
+ * the sync interface's consumer index together.
+ *
+ * When the worker finds the ring full, the oldest buffer is discarded for
+ * taps with the BLADERF_RX_TAP_DROP policy that have not yet acquired it, as
+ * long as no other tap requires it to be retained.
+ *
+ * The tap state is protected by the buffer management lock. */
+
+/**
+ * Create the RX taps of a sync handle, if they have been requested via
+ * bladerf_set_rx_taps(). Called by sync_init().
+ *
+ * @return 0 on success, BLADERF_ERR_* on failure
+ */
+int sync_tap_init(struct bladerf_sync *sync);
+
+/**
+ * Free the RX taps of a sync handle, if any. Called by sync_deinit(), once
+ * the worker has stopped.
+ */
+void sync_tap_deinit(struct bladerf_sync *sync);
+
+/**
+ * Account for a buffer the worker has just marked full, which every tap
+ * must now release. Assumes the buffer management lock is held.
+ */
+void sync_tap_filled(struct bladerf_sync *sync, unsigned int idx);
+
+/**
+ * Free the buffer the worker is to submit next, if it is full and only
+ * taps with the BLADERF_RX_TAP_DROP policy have yet to acquire it. Assumes
+ * the buffer management lock is held.
+ */
+void sync_tap_reclaim(struct bladerf_sync *sync);
+
+/**
+ * Discard the buffers of a previous run, and rewind all taps to the start
+ * of the stream, as the buffer management is reset. Assumes the buffer
+ * management lock is held.
+ *
+ * @return 0 on success, or BLADERF_ERR_INVAL if a tap holds a buffer
+ */
+int sync_tap_reset(struct bladerf_sync *sync);
+
+/**
+ * Obtain the next buffer of a tap. Only one thread may use a given tap at a
+ * time.
+ *
+ * @param       sync        Sync handle
+ * @param[in]   tap         Tap index
+ * @param[out]  samples     Updated with the buffer
+ * @param[out]  num_samples Updated with the number of samples it holds
+ * @param       metadata    Buffer metadata. May be NULL.
+ * @param[in]   timeout_ms  Timeout, in milliseconds. 0 waits indefinitely.
+ *
+ * @return 0 on success, BLADERF_ERR_* on failure
+ */
+int sync_tap_acquire(struct bladerf_sync *sync,
+                     unsigned int tap,
+                     const void **samples,
+                     unsigned int *num_samples,
+                     struct bladerf_metadata *metadata,
+                     unsigned int timeout_ms);
+
+/**
+ * Release the buffer held by a tap.
+ *
+ * @return 0 on success, BLADERF_ERR_* on failure
+ */
+int sync_tap_release(struct bladerf_sync *sync,
+                     unsigned int tap,
+                     const void *samples);
+
+#endif
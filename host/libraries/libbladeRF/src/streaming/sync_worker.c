@@ -34,15 +34,45 @@
 
 #include "async.h"
 #include "sync.h"
+#include "sync_tap.h"
 #include "sync_worker.h"
 
 #include "board/board.h"
 #include "backend/usb/usb.h"
+#include "helpers/alloc.h"
+#include "helpers/probes.h"
+#include "helpers/timeline.h"
+#include "helpers/timeout.h"
 
 #define worker2str(s) (direction2str(s->stream_config.layout & BLADERF_DIRECTION_MASK))
 
 void *sync_worker_task(void *arg);
 
+/* Worker threads retained by the device. A thread whose sync interface is
+ * deinitialized parks here, and serves the next worker to be initialized,
+ * rather than exiting. */
+#define SYNC_WORKER_POOL_SIZE 4
+
+struct sync_worker_pool;
+
+struct sync_worker_thread {
+    struct sync_worker_pool *pool;
+    pthread_t thread;
+    bool running;
+
+    /* Sync handle being served, or NULL while parked */
+    struct bladerf_sync *job;
+};
+
+struct sync_worker_pool {
+    MUTEX lock;
+    pthread_cond_t wake;   /* Signals a job assignment, or shutdown */
+    pthread_cond_t parked; /* Signals a thread's return to the pool */
+    bool shutdown;
+
+    struct sync_worker_thread threads[SYNC_WORKER_POOL_SIZE];
+};
+
 static void *rx_callback(struct bladerf *dev,
                          struct bladerf_stream *stream,
                          struct bladerf_metadata *meta,
@@ -72,22 +102,34 @@ static void *rx_callback(struct bladerf *dev,
         return NULL;
     }
 
+    /* Retain these samples in the capture, whether or not they are
+     * consumed by sync_rx() */
+    sync_capture_store(s, samples, num_samples);
+
     MUTEX_LOCK(&b->lock);
 
     /* Get the index of the buffer that was just filled */
     samples_idx = sync_buf2idx(b, samples);
 
     if (b->resubmit_count == 0) {
+        if (s->tap != NULL) {
+            sync_tap_reclaim(s);
+        }
+
         if (b->status[b->prod_i] == SYNC_BUFFER_EMPTY) {
 
             /* This buffer is now ready for the consumer */
-            b->status[samples_idx] = SYNC_BUFFER_FULL;
+            sync_buf_mark_full(b, samples_idx);
             b->actual_lengths[samples_idx] = num_samples;
-            pthread_cond_signal(&b->buf_ready);
+
+            if (s->tap != NULL) {
+                sync_tap_filled(s, samples_idx);
+            }
+            sync_buf_signal(b);
 
             /* Update the state of the buffer being submitted next */
             next_idx = b->prod_i;
-            b->status[next_idx] = SYNC_BUFFER_IN_FLIGHT;
+            sync_buf_set_status(b, next_idx, SYNC_BUFFER_IN_FLIGHT);
             next_buf = b->buffers[next_idx];
 
             /* Advance to the next buffer for the next callback */
@@ -98,7 +140,9 @@ static void *rx_callback(struct bladerf *dev,
 
         } else {
             /* TODO propagate back the RX Overrun to the sync_rx() caller */
-            log_debug("RX overrun @ buffer %u\r\n", samples_idx);
+            log_debug_ratelimited(LOG_SUBSYS_SYNC,
+                                  "RX overrun @ buffer %u\r\n", samples_idx);
+            s->stats.overruns++;
 
             next_buf = samples;
             b->resubmit_count = s->stream_config.num_xfers - 1;
@@ -117,6 +161,19 @@ static void *rx_callback(struct bladerf *dev,
     return next_buf;
 }
 
+static bool any_in_flight(struct buffer_mgmt *b)
+{
+    unsigned int i;
+
+    for (i = 0; i < b->num_buffers; i++) {
+        if (b->status[i] == SYNC_BUFFER_IN_FLIGHT) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 static void *tx_callback(struct bladerf *dev,
                          struct bladerf_stream *stream,
                          struct bladerf_metadata *meta,
@@ -154,8 +211,8 @@ static void *tx_callback(struct bladerf *dev,
         /* Mark the completed buffer as being empty */
         completed_idx = sync_buf2idx(b, samples);
         assert(b->status[completed_idx] == SYNC_BUFFER_IN_FLIGHT);
-        b->status[completed_idx] = SYNC_BUFFER_EMPTY;
-        pthread_cond_signal(&b->buf_ready);
+        sync_buf_set_status(b, completed_idx, SYNC_BUFFER_EMPTY);
+        sync_buf_signal(b);
 
         /* If the callback is assigned to be the submitter, there are
          * buffers pending submission */
@@ -166,10 +223,12 @@ static void *tx_callback(struct bladerf *dev,
                 log_verbose("%s: Submitting deferred buf[%u]\n",
                             __FUNCTION__, b->cons_i);
 
+                sync_buf_full_done(b, &s->stats, b->cons_i);
+
                 ret = b->buffers[b->cons_i];
                 /* This is actually # of 32bit DWORDs for PACKET_META */
                 meta->actual_count = b->actual_lengths[b->cons_i];
-                b->status[b->cons_i] = SYNC_BUFFER_IN_FLIGHT;
+                sync_buf_set_status(b, b->cons_i, SYNC_BUFFER_IN_FLIGHT);
                 b->cons_i = (b->cons_i + 1) % b->num_buffers;
             } else {
                 log_verbose("%s: No deferred buffer available. "
@@ -180,6 +239,10 @@ static void *tx_callback(struct bladerf *dev,
             }
         }
 
+        if (ret == BLADERF_STREAM_NO_DATA && !any_in_flight(b)) {
+            s->stats.underruns++;
+        }
+
         MUTEX_UNLOCK(&b->lock);
 
         log_verbose("%s worker: Buffer %u emptied.\r\n",
@@ -189,10 +252,180 @@ static void *tx_callback(struct bladerf *dev,
     return ret;
 }
 
+static void *pool_thread(void *arg)
+{
+    struct sync_worker_thread *t  = arg;
+    struct sync_worker_pool *pool = t->pool;
+    struct bladerf_sync *s;
+
+    MUTEX_LOCK(&pool->lock);
+
+    while (true) {
+        while (t->job == NULL && !pool->shutdown) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+
+        if (t->job == NULL) {
+            break;
+        }
+
+        s = t->job;
+        MUTEX_UNLOCK(&pool->lock);
+
+        /* Returns once the worker has reached the STOPPED state, after which
+         * it is no longer accessed */
+        sync_worker_task(s);
+
+        MUTEX_LOCK(&pool->lock);
+        t->job = NULL;
+        pthread_cond_broadcast(&pool->parked);
+    }
+
+    MUTEX_UNLOCK(&pool->lock);
+
+    return NULL;
+}
+
+/* Assumes the device's handle lock is held */
+static struct sync_worker_pool *get_pool(struct bladerf *dev)
+{
+    struct sync_worker_pool *pool = dev->sync_worker_pool;
+    size_t i;
+
+    if (pool != NULL) {
+        return pool;
+    }
+
+    pool = alloc_calloc(1, sizeof(*pool));
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    MUTEX_INIT(&pool->lock);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->parked, NULL);
+
+    for (i = 0; i < SYNC_WORKER_POOL_SIZE; i++) {
+        pool->threads[i].pool = pool;
+    }
+
+    dev->sync_worker_pool = pool;
+    return pool;
+}
+
+/* Run the worker's task on a parked pool thread, starting one if none is
+ * parked. A dedicated thread is created if the pool is full. */
+static int start_thread(struct bladerf_sync *s)
+{
+    struct sync_worker_pool *pool = get_pool(s->dev);
+    struct sync_worker_thread *t  = NULL;
+    size_t i;
+    int status;
+
+    s->worker->pooled = NULL;
+
+    if (pool != NULL) {
+        MUTEX_LOCK(&pool->lock);
+
+        for (i = 0; i < SYNC_WORKER_POOL_SIZE && t == NULL; i++) {
+            if (pool->threads[i].running && pool->threads[i].job == NULL) {
+                t = &pool->threads[i];
+            }
+        }
+
+        for (i = 0; i < SYNC_WORKER_POOL_SIZE && t == NULL; i++) {
+            if (!pool->threads[i].running) {
+                status = pthread_create(&pool->threads[i].thread, NULL,
+                                        pool_thread, &pool->threads[i]);
+                if (status == 0) {
+                    pool->threads[i].running = true;
+                    t = &pool->threads[i];
+                }
+                break;
+            }
+        }
+
+        if (t != NULL) {
+            log_verbose("%s worker: Using pool thread %u\n", worker2str(s),
+                        (unsigned int)(t - pool->threads));
+
+            t->job            = s;
+            s->worker->pooled = t;
+            s->worker->thread = t->thread;
+            pthread_cond_broadcast(&pool->wake);
+        }
+
+        MUTEX_UNLOCK(&pool->lock);
+
+        if (t != NULL) {
+            return 0;
+        }
+    }
+
+    return pthread_create(&s->worker->thread, NULL, sync_worker_task, s);
+}
+
+void sync_worker_pool_deinit(struct bladerf *dev)
+{
+    struct sync_worker_pool *pool = dev->sync_worker_pool;
+    size_t i;
+
+    if (pool == NULL) {
+        return;
+    }
+
+    MUTEX_LOCK(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->wake);
+    MUTEX_UNLOCK(&pool->lock);
+
+    for (i = 0; i < SYNC_WORKER_POOL_SIZE; i++) {
+        if (pool->threads[i].running) {
+            pthread_join(pool->threads[i].thread, NULL);
+        }
+    }
+
+    pthread_cond_destroy(&pool->wake);
+    pthread_cond_destroy(&pool->parked);
+    MUTEX_DESTROY(&pool->lock);
+
+    alloc_free(pool);
+    dev->sync_worker_pool = NULL;
+}
+
+/* Time the callbacks for the stream timeline */
+static void *timed_rx_callback(struct bladerf *dev,
+                               struct bladerf_stream *stream,
+                               struct bladerf_metadata *meta,
+                               void *samples,
+                               size_t num_samples,
+                               void *user_data)
+{
+    const uint64_t start = timeline_begin(dev);
+    void *ret = rx_callback(dev, stream, meta, samples, num_samples, user_data);
+
+    timeline_callback(dev, BLADERF_RX, start);
+    return ret;
+}
+
+static void *timed_tx_callback(struct bladerf *dev,
+                               struct bladerf_stream *stream,
+                               struct bladerf_metadata *meta,
+                               void *samples,
+                               size_t num_samples,
+                               void *user_data)
+{
+    const uint64_t start = timeline_begin(dev);
+    void *ret = tx_callback(dev, stream, meta, samples, num_samples, user_data);
+
+    timeline_callback(dev, BLADERF_TX, start);
+    return ret;
+}
+
 int sync_worker_init(struct bladerf_sync *s)
 {
     int status = 0;
-    s->worker  = (struct sync_worker *)calloc(1, sizeof(*s->worker));
+    s->worker  = (struct sync_worker *)alloc_calloc(1, sizeof(*s->worker));
 
     if (s->worker == NULL) {
         status = BLADERF_ERR_MEM;
@@ -204,13 +437,14 @@ int sync_worker_init(struct bladerf_sync *s)
 
     s->worker->cb =
         (s->stream_config.layout & BLADERF_DIRECTION_MASK) == BLADERF_RX
-            ? rx_callback
-            : tx_callback;
+            ? timed_rx_callback
+            : timed_tx_callback;
 
     status = async_init_stream(
         &s->worker->stream, s->dev, s->worker->cb, &s->buf_mgmt.buffers,
         s->buf_mgmt.num_buffers, s->stream_config.format,
-        s->stream_config.samples_per_buffer, s->stream_config.num_xfers, s);
+        s->stream_config.samples_per_buffer, s->stream_config.granularity,
+        s->stream_config.num_xfers, s);
 
     if (status != 0) {
         log_debug("%s worker: Failed to init stream: %s\n", worker2str(s),
@@ -218,6 +452,13 @@ int sync_worker_init(struct bladerf_sync *s)
         goto worker_init_out;
     }
 
+    if (s->buf_mgmt.num_buffers > 1) {
+        s->buf_mgmt.buf_stride = (uint8_t *)s->buf_mgmt.buffers[1] -
+                                 (uint8_t *)s->buf_mgmt.buffers[0];
+    } else {
+        s->buf_mgmt.buf_stride = 0;
+    }
+
     status = async_set_transfer_timeout(
         s->worker->stream,
         uint_max(s->stream_config.timeout_ms, BULK_TIMEOUT_MS));
@@ -230,7 +471,7 @@ int sync_worker_init(struct bladerf_sync *s)
     MUTEX_INIT(&s->worker->state_lock);
     MUTEX_INIT(&s->worker->request_lock);
 
-    status = pthread_cond_init(&s->worker->state_changed, NULL);
+    status = timeout_cond_init(&s->worker->state_changed);
     if (status != 0) {
         log_debug("%s worker: pthread_cond_init(state_changed) failed: %d\n",
                   worker2str(s), status);
@@ -238,7 +479,7 @@ int sync_worker_init(struct bladerf_sync *s)
         goto worker_init_out;
     }
 
-    status = pthread_cond_init(&s->worker->requests_pending, NULL);
+    status = timeout_cond_init(&s->worker->requests_pending);
     if (status != 0) {
         log_debug("%s worker: pthread_cond_init(requests_pending) failed: %d\n",
                   worker2str(s), status);
@@ -246,7 +487,7 @@ int sync_worker_init(struct bladerf_sync *s)
         goto worker_init_out;
     }
 
-    status = pthread_create(&s->worker->thread, NULL, sync_worker_task, s);
+    status = start_thread(s);
     if (status != 0) {
         log_debug("%s worker: pthread_create failed: %d\n", worker2str(s),
                   status);
@@ -266,7 +507,7 @@ int sync_worker_init(struct bladerf_sync *s)
 
 worker_init_out:
     if (status != 0) {
-        free(s->worker);
+        alloc_free(s->worker);
         s->worker = NULL;
     }
 
@@ -300,12 +541,34 @@ void sync_worker_deinit(struct sync_worker *w,
         pthread_cancel(w->thread);
     }
 
-    pthread_join(w->thread, NULL);
-    log_verbose("%s: Worker joined.\n", __FUNCTION__);
+    if (w->pooled != NULL && status == 0) {
+        /* Wait for the thread to park, so that it is available to the next
+         * worker */
+        struct sync_worker_pool *pool = w->pooled->pool;
+
+        MUTEX_LOCK(&pool->lock);
+        while (w->pooled->job != NULL) {
+            pthread_cond_wait(&pool->parked, &pool->lock);
+        }
+        MUTEX_UNLOCK(&pool->lock);
+
+        log_verbose("%s: Worker thread parked.\n", __FUNCTION__);
+    } else {
+        pthread_join(w->thread, NULL);
+        log_verbose("%s: Worker joined.\n", __FUNCTION__);
+
+        if (w->pooled != NULL) {
+            /* The cancelled thread is not reused */
+            MUTEX_LOCK(&w->pooled->pool->lock);
+            w->pooled->job     = NULL;
+            w->pooled->running = false;
+            MUTEX_UNLOCK(&w->pooled->pool->lock);
+        }
+    }
 
     async_deinit_stream(w->stream);
 
-    free(w);
+    alloc_free(w);
 }
 
 void sync_worker_submit_request(struct sync_worker *w, unsigned int request)
@@ -321,22 +584,11 @@ int sync_worker_wait_for_state(struct sync_worker *w, sync_worker_state state,
 {
     int status = 0;
     struct timespec timeout_abs;
-    const int nsec_per_sec = 1000 * 1000 * 1000;
 
     if (timeout_ms != 0) {
-        const unsigned int timeout_sec = timeout_ms / 1000;
-
-        status = clock_gettime(CLOCK_REALTIME, &timeout_abs);
+        status = populate_abs_timeout(&timeout_abs, timeout_ms);
         if (status != 0) {
-            return BLADERF_ERR_UNEXPECTED;
-        }
-
-        timeout_abs.tv_sec += timeout_sec;
-        timeout_abs.tv_nsec += (timeout_ms % 1000) * 1000 * 1000;
-
-        if (timeout_abs.tv_nsec >= nsec_per_sec) {
-            timeout_abs.tv_sec += timeout_abs.tv_nsec / nsec_per_sec;
-            timeout_abs.tv_nsec %= nsec_per_sec;
+            return status;
         }
 
         MUTEX_LOCK(&w->state_lock);
@@ -388,8 +640,15 @@ sync_worker_state sync_worker_get_state(struct sync_worker *w,
     return ret;
 }
 
-static void set_state(struct sync_worker *w, sync_worker_state state)
+/* The stream's layout is not assigned until it is run, so the direction is
+ * taken from the sync handle */
+static void set_state(struct bladerf_sync *s, sync_worker_state state)
 {
+    struct sync_worker *w = s->worker;
+
+    PROBE2(sync_worker_state, s->buf_mgmt.dir, state);
+    timeline_worker_state(s->dev, s->buf_mgmt.dir, state);
+
     MUTEX_LOCK(&w->state_lock);
     w->state = state;
     pthread_cond_signal(&w->state_changed);
@@ -430,19 +689,19 @@ static sync_worker_state exec_idle_state(struct bladerf_sync *s)
             * stale buffers marked "in-flight" that have since been cancelled. */
             for (i = 0; i < s->buf_mgmt.num_buffers; i++) {
                 if (s->buf_mgmt.status[i] == SYNC_BUFFER_IN_FLIGHT) {
-                    s->buf_mgmt.status[i] = SYNC_BUFFER_EMPTY;
+                    sync_buf_set_status(&s->buf_mgmt, i, SYNC_BUFFER_EMPTY);
                 }
             }
 
-            pthread_cond_signal(&s->buf_mgmt.buf_ready);
+            sync_buf_signal(&s->buf_mgmt);
         } else {
             s->buf_mgmt.prod_i = s->stream_config.num_xfers;
 
             for (i = 0; i < s->buf_mgmt.num_buffers; i++) {
                 if (i < s->stream_config.num_xfers) {
-                    s->buf_mgmt.status[i] = SYNC_BUFFER_IN_FLIGHT;
+                    sync_buf_set_status(&s->buf_mgmt, i, SYNC_BUFFER_IN_FLIGHT);
                 } else if (s->buf_mgmt.status[i] == SYNC_BUFFER_IN_FLIGHT) {
-                    s->buf_mgmt.status[i] = SYNC_BUFFER_EMPTY;
+                    sync_buf_set_status(&s->buf_mgmt, i, SYNC_BUFFER_EMPTY);
                 }
             }
         }
@@ -468,16 +727,19 @@ static void exec_running_state(struct bladerf_sync *s)
                 worker2str(s), bladerf_strerror(status));
 
     /* Save off the result of running the stream so we can report what
-     * happened to the API caller */
+     * happened to the API caller. The worker is marked idle along with it,
+     * so that a caller that has consumed the error never finds the worker
+     * still "running" and waits on buffers that will not arrive. */
     MUTEX_LOCK(&s->worker->state_lock);
     s->worker->err_code = status;
+    s->worker->state    = SYNC_WORKER_STATE_IDLE;
     MUTEX_UNLOCK(&s->worker->state_lock);
 
     /* Wake the API-side if an error occurred, so that it can propagate
      * the stream error code back to the API caller */
     if (status != 0) {
         MUTEX_LOCK(&s->buf_mgmt.lock);
-        pthread_cond_signal(&s->buf_mgmt.buf_ready);
+        sync_buf_signal(&s->buf_mgmt);
         MUTEX_UNLOCK(&s->buf_mgmt.lock);
     }
 }
@@ -488,7 +750,7 @@ void *sync_worker_task(void *arg)
     struct bladerf_sync *s = (struct bladerf_sync *)arg;
 
     log_verbose("%s worker: task started\n", worker2str(s));
-    set_state(s->worker, state);
+    set_state(s, state);
     log_verbose("%s worker: task state set\n", worker2str(s));
 
     while (state != SYNC_WORKER_STATE_STOPPED) {
@@ -496,25 +758,25 @@ void *sync_worker_task(void *arg)
         switch (state) {
             case SYNC_WORKER_STATE_STARTUP:
                 assert(!"Worker in unexpected state, shutting down. (STARTUP)");
-                set_state(s->worker, SYNC_WORKER_STATE_SHUTTING_DOWN);
+                set_state(s, SYNC_WORKER_STATE_SHUTTING_DOWN);
                 break;
 
             case SYNC_WORKER_STATE_IDLE:
                 state = exec_idle_state(s);
-                set_state(s->worker, state);
+                set_state(s, state);
                 break;
 
             case SYNC_WORKER_STATE_RUNNING:
                 exec_running_state(s);
                 state = SYNC_WORKER_STATE_IDLE;
-                set_state(s->worker, state);
+                set_state(s, state);
                 break;
 
             case SYNC_WORKER_STATE_SHUTTING_DOWN:
                 log_verbose("%s worker: Shutting down...\n", worker2str(s));
 
                 state = SYNC_WORKER_STATE_STOPPED;
-                set_state(s->worker, state);
+                set_state(s, state);
                 break;
 
             case SYNC_WORKER_STATE_STOPPED:
@@ -523,7 +785,7 @@ void *sync_worker_task(void *arg)
 
             default:
                 assert(!"Worker in unexpected state, shutting down. (UNKNOWN)");
-                set_state(s->worker, SYNC_WORKER_STATE_SHUTTING_DOWN);
+                set_state(s, SYNC_WORKER_STATE_SHUTTING_DOWN);
                 break;
         }
     }
@@ -48,9 +48,15 @@ typedef enum {
     SYNC_WORKER_STATE_STOPPED
 } sync_worker_state;
 
+struct sync_worker_thread;
+
 struct sync_worker {
     pthread_t thread;
 
+    /* Pool thread running the worker, or NULL if it has a dedicated
+     * thread */
+    struct sync_worker_thread *pooled;
+
     struct bladerf_stream *stream;
     bladerf_stream_cb cb;
 
@@ -71,8 +77,9 @@ struct sync_worker {
 };
 
 /**
- * Create a launch a worker thread. It will enter the IDLE state upon
- * executing.
+ * Create a worker, and launch its thread or assign it a thread parked by a
+ * previous worker. It will enter the IDLE state upon executing. Assumes the
+ * device's handle lock is held.
  *
  * @param   s   Sync handle containing worker to initialize
  *
@@ -93,6 +100,14 @@ void sync_worker_deinit(struct sync_worker *w,
                         pthread_mutex_t *lock,
                         pthread_cond_t *cond);
 
+/**
+ * Stop and join the device's parked worker threads. This must be called
+ * after all of the device's sync interfaces have been deinitialized.
+ *
+ * @param       dev     Device handle
+ */
+void sync_worker_pool_deinit(struct bladerf *dev);
+
 /**
  * Wait for state change with optional timeout
  *
@@ -0,0 +1,928 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* This program measures the latency distributions of libbladeRF control
+ * operations: tuning, gain, sample rate and bandwidth changes, scheduled
+ * retunes, NIOS II peripheral accesses and flash reads. Results are emitted
+ * as JSON or CSV, along with the firmware, FPGA and library versions, so
+ * they may be compared across revisions of each.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <math.h>
+#include <string.h>
+#include <strings.h>
+#include <getopt.h>
+#include <time.h>
+#include <libbladeRF.h>
+
+#include "conversions.h"
+
+#define MAX_OPS             32
+#define FLASH_BUF_LEN       4096
+
+#define OPTSTR "hd:c:n:w:t:F:o:v:"
+
+enum bench_format {
+    FORMAT_CSV,
+    FORMAT_JSON,
+};
+
+struct bench_params {
+    char *device_str;
+    int channel;
+    bool rx;
+    bool tx;
+    unsigned int iterations;
+    unsigned int warmup;
+    enum bench_format format;
+    FILE *out;
+    bladerf_log_level verbosity;
+
+    /* Operations selected with --ops, or all if empty */
+    const char *ops[MAX_OPS];
+    unsigned int num_ops;
+};
+
+/* State shared by an operation's setup, iterations, and teardown */
+struct op_ctx {
+    struct bladerf *dev;
+    bladerf_channel ch;
+    bool bladerf2;
+
+    /* Values alternated between by "set" operations. vals[0] is the value
+     * in effect beforehand, and is restored by the teardown. */
+    int64_t vals[2];
+    bladerf_gain_mode gain_mode;
+    struct bladerf_quick_tune quick_tune;
+    uint8_t flash_buf[FLASH_BUF_LEN];
+};
+
+struct bench_op {
+    const char *name;
+    bool per_channel;
+    int (*setup)(struct op_ctx *ctx);
+    int (*run)(struct op_ctx *ctx, unsigned int i);
+    void (*teardown)(struct op_ctx *ctx);
+};
+
+struct bench_result {
+    int status;
+    unsigned int count;
+    double min_us;
+    double mean_us;
+    double stddev_us;
+    double p50_us;
+    double p90_us;
+    double p99_us;
+    double max_us;
+};
+
+static const struct option long_options[] = {
+    { "help",           no_argument,        0,  'h' },
+    { "device",         required_argument,  0,  'd' },
+    { "channel",        required_argument,  0,  'c' },
+    { "rx",             no_argument,        0,  0xa0 },
+    { "tx",             no_argument,        0,  0xa1 },
+    { "iterations",     required_argument,  0,  'n' },
+    { "warmup",         required_argument,  0,  'w' },
+    { "ops",            required_argument,  0,  't' },
+    { "format",         required_argument,  0,  'F' },
+    { "output",         required_argument,  0,  'o' },
+    { "verbosity",      required_argument,  0,  'v' },
+    { 0,                0,                  0,  0   },
+};
+
+/******************************************************************************
+ * Operations
+ ******************************************************************************/
+
+/* Choose a second value within [min, max] to alternate with `cur` */
+static int64_t alternate(int64_t cur, int64_t delta, int64_t min, int64_t max)
+{
+    if (cur + delta <= max) {
+        return cur + delta;
+    } else if (cur - delta >= min) {
+        return cur - delta;
+    } else {
+        return cur;
+    }
+}
+
+static inline int64_t range_min(const struct bladerf_range *r)
+{
+    return (int64_t)(r->min * r->scale);
+}
+
+static inline int64_t range_max(const struct bladerf_range *r)
+{
+    return (int64_t)(r->max * r->scale);
+}
+
+static int setup_frequency(struct op_ctx *ctx)
+{
+    const struct bladerf_range *range;
+    bladerf_frequency freq;
+    int status;
+
+    status = bladerf_get_frequency(ctx->dev, ctx->ch, &freq);
+    if (status == 0) {
+        status = bladerf_get_frequency_range(ctx->dev, ctx->ch, &range);
+    }
+
+    if (status == 0) {
+        ctx->vals[0] = (int64_t)freq;
+        ctx->vals[1] = alternate(ctx->vals[0], 10000000, range_min(range),
+                                 range_max(range));
+    }
+
+    return status;
+}
+
+static void restore_frequency(struct op_ctx *ctx)
+{
+    bladerf_set_frequency(ctx->dev, ctx->ch, (bladerf_frequency)ctx->vals[0]);
+}
+
+static int run_get_frequency(struct op_ctx *ctx, unsigned int i)
+{
+    bladerf_frequency freq;
+    return bladerf_get_frequency(ctx->dev, ctx->ch, &freq);
+}
+
+static int run_set_frequency(struct op_ctx *ctx, unsigned int i)
+{
+    return bladerf_set_frequency(ctx->dev, ctx->ch,
+                                 (bladerf_frequency)ctx->vals[(i + 1) & 1]);
+}
+
+static int setup_gain(struct op_ctx *ctx)
+{
+    const struct bladerf_range *range;
+    int gain;
+    int status;
+
+    /* Select manual gain control, so that the AGC does not contend with
+     * the changes being timed. The previous mode is restored afterwards. */
+    ctx->gain_mode = BLADERF_GAIN_MGC;
+
+    if (!BLADERF_CHANNEL_IS_TX(ctx->ch)) {
+        bladerf_gain_mode mode;
+
+        status = bladerf_get_gain_mode(ctx->dev, ctx->ch, &mode);
+        if (status == 0 && mode != BLADERF_GAIN_MGC &&
+            bladerf_set_gain_mode(ctx->dev, ctx->ch, BLADERF_GAIN_MGC) == 0) {
+            ctx->gain_mode = mode;
+        }
+    }
+
+    status = bladerf_get_gain(ctx->dev, ctx->ch, &gain);
+    if (status == 0) {
+        status = bladerf_get_gain_range(ctx->dev, ctx->ch, &range);
+    }
+
+    if (status == 0) {
+        ctx->vals[0] = gain;
+        ctx->vals[1] =
+            alternate(gain, 3, range_min(range), range_max(range));
+    }
+
+    return status;
+}
+
+static void restore_gain(struct op_ctx *ctx)
+{
+    bladerf_set_gain(ctx->dev, ctx->ch, (int)ctx->vals[0]);
+
+    if (ctx->gain_mode != BLADERF_GAIN_MGC) {
+        bladerf_set_gain_mode(ctx->dev, ctx->ch, ctx->gain_mode);
+    }
+}
+
+static int run_get_gain(struct op_ctx *ctx, unsigned int i)
+{
+    int gain;
+    return bladerf_get_gain(ctx->dev, ctx->ch, &gain);
+}
+
+static int run_set_gain(struct op_ctx *ctx, unsigned int i)
+{
+    return bladerf_set_gain(ctx->dev, ctx->ch, (int)ctx->vals[(i + 1) & 1]);
+}
+
+static int setup_sample_rate(struct op_ctx *ctx)
+{
+    const struct bladerf_range *range;
+    bladerf_sample_rate rate;
+    int status;
+
+    status = bladerf_get_sample_rate(ctx->dev, ctx->ch, &rate);
+    if (status == 0) {
+        status = bladerf_get_sample_rate_range(ctx->dev, ctx->ch, &range);
+    }
+
+    if (status == 0) {
+        ctx->vals[0] = rate;
+        ctx->vals[1] = alternate(rate, rate / 2 + 1, range_min(range),
+                                 range_max(range));
+    }
+
+    return status;
+}
+
+static void restore_sample_rate(struct op_ctx *ctx)
+{
+    bladerf_set_sample_rate(ctx->dev, ctx->ch,
+                            (bladerf_sample_rate)ctx->vals[0], NULL);
+}
+
+static int run_get_sample_rate(struct op_ctx *ctx, unsigned int i)
+{
+    bladerf_sample_rate rate;
+    return bladerf_get_sample_rate(ctx->dev, ctx->ch, &rate);
+}
+
+static int run_set_sample_rate(struct op_ctx *ctx, unsigned int i)
+{
+    return bladerf_set_sample_rate(
+        ctx->dev, ctx->ch, (bladerf_sample_rate)ctx->vals[(i + 1) & 1], NULL);
+}
+
+static int setup_bandwidth(struct op_ctx *ctx)
+{
+    const struct bladerf_range *range;
+    bladerf_bandwidth bw;
+    int status;
+
+    status = bladerf_get_bandwidth(ctx->dev, ctx->ch, &bw);
+    if (status == 0) {
+        status = bladerf_get_bandwidth_range(ctx->dev, ctx->ch, &range);
+    }
+
+    if (status == 0) {
+        ctx->vals[0] = bw;
+        ctx->vals[1] = alternate(bw, bw / 2 + 1, range_min(range),
+                                 range_max(range));
+    }
+
+    return status;
+}
+
+static void restore_bandwidth(struct op_ctx *ctx)
+{
+    bladerf_set_bandwidth(ctx->dev, ctx->ch, (bladerf_bandwidth)ctx->vals[0],
+                          NULL);
+}
+
+static int run_get_bandwidth(struct op_ctx *ctx, unsigned int i)
+{
+    bladerf_bandwidth bw;
+    return bladerf_get_bandwidth(ctx->dev, ctx->ch, &bw);
+}
+
+static int run_set_bandwidth(struct op_ctx *ctx, unsigned int i)
+{
+    return bladerf_set_bandwidth(
+        ctx->dev, ctx->ch, (bladerf_bandwidth)ctx->vals[(i + 1) & 1], NULL);
+}
+
+static int setup_quick_tune(struct op_ctx *ctx)
+{
+    int status = setup_frequency(ctx);
+
+    if (status == 0) {
+        status = bladerf_get_quick_tune(ctx->dev, ctx->ch, &ctx->quick_tune);
+    }
+
+    return status;
+}
+
+static void restore_retune(struct op_ctx *ctx)
+{
+    bladerf_cancel_scheduled_retunes(ctx->dev, ctx->ch);
+    restore_frequency(ctx);
+}
+
+static int run_quick_tune(struct op_ctx *ctx, unsigned int i)
+{
+    return bladerf_schedule_retune(ctx->dev, ctx->ch, BLADERF_RETUNE_NOW, 0,
+                                   &ctx->quick_tune);
+}
+
+static int run_schedule_retune(struct op_ctx *ctx, unsigned int i)
+{
+    return bladerf_schedule_retune(ctx->dev, ctx->ch, BLADERF_RETUNE_NOW,
+                                   (bladerf_frequency)ctx->vals[(i + 1) & 1],
+                                   NULL);
+}
+
+/* Trigger control registers are accessed with NIOS II 8x8 packets */
+static int run_nios_8x8_read(struct op_ctx *ctx, unsigned int i)
+{
+    const bladerf_trigger_signal signal =
+        ctx->bladerf2 ? BLADERF_TRIGGER_J51_1 : BLADERF_TRIGGER_J71_4;
+    uint8_t val;
+
+    return bladerf_read_trigger(ctx->dev, BLADERF_CHANNEL_RX(0), signal, &val);
+}
+
+/* The configuration GPIO is accessed with NIOS II 8x32 packets */
+static int run_nios_8x32_read(struct op_ctx *ctx, unsigned int i)
+{
+    uint32_t val;
+    return bladerf_config_gpio_read(ctx->dev, &val);
+}
+
+/* Timestamps are read with NIOS II 16x64 packets */
+static int run_nios_16x64_read(struct op_ctx *ctx, unsigned int i)
+{
+    bladerf_timestamp ts;
+    return bladerf_get_timestamp(ctx->dev, BLADERF_RX, &ts);
+}
+
+/* The expansion GPIOs are accessed with NIOS II 32x32 packets. They are
+ * only present on the bladeRF 1. */
+static int run_nios_32x32_read(struct op_ctx *ctx, unsigned int i)
+{
+    uint32_t val;
+
+    if (ctx->bladerf2) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return bladerf_expansion_gpio_read(ctx->dev, &val);
+}
+
+static int run_flash_page_read(struct op_ctx *ctx, unsigned int i)
+{
+    return bladerf_read_flash(ctx->dev, ctx->flash_buf, 0, 1);
+}
+
+static const struct bench_op ops[] = {
+    { "get_frequency",   true,  NULL, run_get_frequency, NULL },
+    { "set_frequency",   true,  setup_frequency, run_set_frequency,
+      restore_frequency },
+    { "get_gain",        true,  NULL, run_get_gain, NULL },
+    { "set_gain",        true,  setup_gain, run_set_gain, restore_gain },
+    { "get_sample_rate", true,  NULL, run_get_sample_rate, NULL },
+    { "set_sample_rate", true,  setup_sample_rate, run_set_sample_rate,
+      restore_sample_rate },
+    { "get_bandwidth",   true,  NULL, run_get_bandwidth, NULL },
+    { "set_bandwidth",   true,  setup_bandwidth, run_set_bandwidth,
+      restore_bandwidth },
+    { "quick_tune",      true,  setup_quick_tune, run_quick_tune,
+      restore_retune },
+    { "schedule_retune", true,  setup_frequency, run_schedule_retune,
+      restore_retune },
+    { "nios_8x8_read",   false, NULL, run_nios_8x8_read, NULL },
+    { "nios_8x32_read",  false, NULL, run_nios_8x32_read, NULL },
+    { "nios_16x64_read", false, NULL, run_nios_16x64_read, NULL },
+    { "nios_32x32_read", false, NULL, run_nios_32x32_read, NULL },
+    { "flash_page_read", false, NULL, run_flash_page_read, NULL },
+};
+
+#define NUM_OPS (sizeof(ops) / sizeof(ops[0]))
+
+/******************************************************************************
+ * Measurement
+ ******************************************************************************/
+
+static inline uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+    const uint64_t x = *(const uint64_t *)a;
+    const uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of sorted latencies, in microseconds */
+static double percentile_us(const uint64_t *sorted, unsigned int n, double pct)
+{
+    unsigned int rank = (unsigned int)ceil(pct / 100.0 * n);
+
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    return sorted[rank - 1] / 1000.0;
+}
+
+static void summarize(uint64_t *latencies, struct bench_result *r)
+{
+    const unsigned int n = r->count;
+    double sum = 0.0, sq = 0.0;
+    unsigned int i;
+
+    if (n == 0) {
+        return;
+    }
+
+    qsort(latencies, n, sizeof(latencies[0]), cmp_u64);
+
+    for (i = 0; i < n; i++) {
+        sum += latencies[i] / 1000.0;
+    }
+
+    r->mean_us = sum / n;
+
+    for (i = 0; i < n; i++) {
+        const double d = latencies[i] / 1000.0 - r->mean_us;
+        sq += d * d;
+    }
+
+    r->stddev_us = (n > 1) ? sqrt(sq / (n - 1)) : 0.0;
+    r->min_us    = latencies[0] / 1000.0;
+    r->max_us    = latencies[n - 1] / 1000.0;
+    r->p50_us    = percentile_us(latencies, n, 50.0);
+    r->p90_us    = percentile_us(latencies, n, 90.0);
+    r->p99_us    = percentile_us(latencies, n, 99.0);
+}
+
+static void run_op(const struct bench_params *p, const struct bench_op *op,
+                   struct op_ctx *ctx, uint64_t *latencies,
+                   struct bench_result *r)
+{
+    uint64_t start;
+    unsigned int i;
+    int status = 0;
+
+    memset(r, 0, sizeof(*r));
+
+    if (op->setup != NULL) {
+        status = op->setup(ctx);
+        if (status != 0) {
+            r->status = status;
+            return;
+        }
+    }
+
+    for (i = 0; i < p->warmup && status == 0; i++) {
+        status = op->run(ctx, i);
+    }
+
+    for (i = 0; i < p->iterations && status == 0; i++) {
+        start  = monotonic_ns();
+        status = op->run(ctx, p->warmup + i);
+
+        if (status == 0) {
+            latencies[r->count++] = monotonic_ns() - start;
+        }
+    }
+
+    if (op->teardown != NULL) {
+        op->teardown(ctx);
+    }
+
+    r->status = status;
+    summarize(latencies, r);
+}
+
+/******************************************************************************
+ * Output
+ ******************************************************************************/
+
+static void print_json_str(FILE *out, const char *str)
+{
+    fputc('"', out);
+
+    for (; *str != '\0'; str++) {
+        if (*str == '"' || *str == '\\') {
+            fprintf(out, "\\%c", *str);
+        } else if ((unsigned char)*str < 0x20) {
+            fprintf(out, "\\u%04x", (unsigned char)*str);
+        } else {
+            fputc(*str, out);
+        }
+    }
+
+    fputc('"', out);
+}
+
+static const char *fpga_size2str(bladerf_fpga_size size)
+{
+    switch (size) {
+        case BLADERF_FPGA_40KLE:
+            return "40";
+        case BLADERF_FPGA_115KLE:
+            return "115";
+        case BLADERF_FPGA_A4:
+            return "A4";
+        case BLADERF_FPGA_A9:
+            return "A9";
+        default:
+            return "unknown";
+    }
+}
+
+static void print_header(const struct bench_params *p, struct bladerf *dev)
+{
+    struct bladerf_version lib_ver, fw_ver, fpga_ver;
+    char serial[BLADERF_SERIAL_LENGTH];
+    bladerf_fpga_size fpga_size = BLADERF_FPGA_UNKNOWN;
+
+    if (p->format == FORMAT_CSV) {
+        fprintf(p->out,
+                "op,channel,status,iterations,min_us,mean_us,stddev_us,"
+                "p50_us,p90_us,p99_us,max_us\n");
+        return;
+    }
+
+    bladerf_version(&lib_ver);
+
+    if (bladerf_fw_version(dev, &fw_ver) != 0) {
+        fw_ver.describe = "unknown";
+    }
+
+    if (bladerf_fpga_version(dev, &fpga_ver) != 0) {
+        fpga_ver.describe = "unknown";
+    }
+
+    if (bladerf_get_serial(dev, serial) != 0) {
+        strcpy(serial, "unknown");
+    }
+
+    bladerf_get_fpga_size(dev, &fpga_size);
+
+    fprintf(p->out, "{\n  \"board\": ");
+    print_json_str(p->out, bladerf_get_board_name(dev));
+    fprintf(p->out, ",\n  \"serial\": ");
+    print_json_str(p->out, serial);
+    fprintf(p->out, ",\n  \"fpga_size\": \"%s\"", fpga_size2str(fpga_size));
+    fprintf(p->out, ",\n  \"library_version\": ");
+    print_json_str(p->out, lib_ver.describe);
+    fprintf(p->out, ",\n  \"firmware_version\": ");
+    print_json_str(p->out, fw_ver.describe);
+    fprintf(p->out, ",\n  \"fpga_version\": ");
+    print_json_str(p->out, fpga_ver.describe);
+    fprintf(p->out, ",\n  \"iterations\": %u", p->iterations);
+    fprintf(p->out, ",\n  \"warmup\": %u", p->warmup);
+    fprintf(p->out, ",\n  \"results\": [\n");
+}
+
+static void print_footer(const struct bench_params *p, bool any)
+{
+    if (p->format == FORMAT_JSON) {
+        fprintf(p->out, "%s  ]\n}\n", any ? "\n" : "");
+    }
+}
+
+static void print_result(const struct bench_params *p,
+                         const struct bench_op *op,
+                         bladerf_channel ch,
+                         const struct bench_result *r,
+                         bool first)
+{
+    char channel[16] = "";
+
+    /* Device-wide operations have no channel */
+    if (op->per_channel) {
+        snprintf(channel, sizeof(channel), "%s%d",
+                 BLADERF_CHANNEL_IS_TX(ch) ? "tx" : "rx", (ch >> 1) + 1);
+    }
+
+    if (p->format == FORMAT_CSV) {
+        fprintf(p->out, "%s,%s,%d,%u,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+                op->name, channel, r->status, r->count, r->min_us,
+                r->mean_us, r->stddev_us, r->p50_us, r->p90_us, r->p99_us,
+                r->max_us);
+    } else {
+        fprintf(p->out,
+                "%s    {\"op\": \"%s\", \"channel\": \"%s\", "
+                "\"status\": %d, \"iterations\": %u, "
+                "\"min_us\": %.3f, \"mean_us\": %.3f, "
+                "\"stddev_us\": %.3f, \"p50_us\": %.3f, "
+                "\"p90_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f}",
+                first ? "" : ",\n", op->name, channel, r->status, r->count,
+                r->min_us, r->mean_us, r->stddev_us, r->p50_us, r->p90_us,
+                r->p99_us, r->max_us);
+    }
+
+    fflush(p->out);
+}
+
+/******************************************************************************
+ * Main
+ ******************************************************************************/
+
+static void usage(const char *argv0)
+{
+    unsigned int i;
+
+    printf("Usage: %s [options]\n", argv0);
+    printf("Measure the latency of libbladeRF control operations.\n\n");
+    printf("Device options:\n");
+    printf("  -d, --device <str>         Device argument string.\n");
+    printf("  -c, --channel <n>          Channel index. Default: 0\n");
+    printf("  --rx                       Measure RX channel operations.\n");
+    printf("  --tx                       Measure TX channel operations.\n");
+    printf("                             Default: --rx --tx\n");
+    printf("\n");
+    printf("Measurement options:\n");
+    printf("  -n, --iterations <n>       Timed calls per operation.\n");
+    printf("                             Default: 1000\n");
+    printf("  -w, --warmup <n>           Untimed calls preceding them.\n");
+    printf("                             Default: 10\n");
+    printf("  -t, --ops <list>           Comma-separated operations to\n");
+    printf("                             measure. Default: all\n");
+    printf("\n");
+    printf("Output options:\n");
+    printf("  -F, --format <fmt>         json or csv. Default: json\n");
+    printf("  -o, --output <file>        Write results to a file instead of\n");
+    printf("                             stdout.\n");
+    printf("  -v, --verbosity <level>    libbladeRF log verbosity.\n");
+    printf("  -h, --help                 Show this text.\n");
+    printf("\n");
+    printf("Operations:\n");
+
+    for (i = 0; i < NUM_OPS; i++) {
+        printf("  %s\n", ops[i].name);
+    }
+
+    printf("\n");
+    printf("Operations that fail are reported with their status, and the\n");
+    printf("statistics of the calls that completed before the failure.\n");
+    printf("Settings changed by an operation are restored once it has\n");
+    printf("been measured.\n");
+}
+
+static const struct bench_op *find_op(const char *name)
+{
+    unsigned int i;
+
+    for (i = 0; i < NUM_OPS; i++) {
+        if (!strcasecmp(name, ops[i].name)) {
+            return &ops[i];
+        }
+    }
+
+    return NULL;
+}
+
+static int parse_ops(char *str, struct bench_params *p)
+{
+    char *tok, *saveptr = NULL;
+
+    p->num_ops = 0;
+
+    for (tok = strtok_r(str, ",", &saveptr); tok != NULL;
+         tok = strtok_r(NULL, ",", &saveptr)) {
+
+        if (find_op(tok) == NULL) {
+            fprintf(stderr, "Invalid operation: %s\n", tok);
+            return -1;
+        } else if (p->num_ops >= MAX_OPS) {
+            fprintf(stderr, "Too many operations (max %u).\n", MAX_OPS);
+            return -1;
+        }
+
+        p->ops[p->num_ops++] = tok;
+    }
+
+    return 0;
+}
+
+static int handle_args(int argc, char *argv[], struct bench_params *p)
+{
+    int c;
+    bool ok;
+
+    while ((c = getopt_long(argc, argv, OPTSTR, long_options, NULL)) != -1) {
+        switch (c) {
+            case 'd':
+                p->device_str = optarg;
+                break;
+
+            case 'c':
+                p->channel = str2int(optarg, 0, 1, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid channel: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 0xa0:
+                p->rx = true;
+                break;
+
+            case 0xa1:
+                p->tx = true;
+                break;
+
+            case 'n':
+                p->iterations = str2uint(optarg, 1, 10000000, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid iteration count: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'w':
+                p->warmup = str2uint(optarg, 0, 10000000, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid warmup count: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 't':
+                if (parse_ops(optarg, p) != 0) {
+                    return -1;
+                }
+                break;
+
+            case 'F':
+                if (!strcasecmp(optarg, "csv")) {
+                    p->format = FORMAT_CSV;
+                } else if (!strcasecmp(optarg, "json")) {
+                    p->format = FORMAT_JSON;
+                } else {
+                    fprintf(stderr, "Invalid format: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'o':
+                p->out = fopen(optarg, "w");
+                if (p->out == NULL) {
+                    perror(optarg);
+                    return -1;
+                }
+                break;
+
+            case 'v':
+                p->verbosity = str2loglevel(optarg, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid log level: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'h':
+                usage(argv[0]);
+                return 1;
+
+            default:
+                return -1;
+        }
+    }
+
+    if (!p->rx && !p->tx) {
+        p->rx = true;
+        p->tx = true;
+    }
+
+    return 0;
+}
+
+static bool op_selected(const struct bench_params *p, const struct bench_op *op)
+{
+    unsigned int i;
+
+    if (p->num_ops == 0) {
+        return true;
+    }
+
+    for (i = 0; i < p->num_ops; i++) {
+        if (find_op(p->ops[i]) == op) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static int run_all(struct bladerf *dev, const struct bench_params *p)
+{
+    const bladerf_channel channels[] = {
+        BLADERF_CHANNEL_RX(p->channel),
+        BLADERF_CHANNEL_TX(p->channel),
+    };
+
+    struct op_ctx *ctx;
+    struct bench_result r;
+    uint64_t *latencies;
+    unsigned int i, c;
+    bool first = true;
+    int status = 0;
+
+    ctx       = calloc(1, sizeof(*ctx));
+    latencies = malloc(p->iterations * sizeof(latencies[0]));
+    if (ctx == NULL || latencies == NULL) {
+        perror("malloc");
+        free(ctx);
+        free(latencies);
+        return -1;
+    }
+
+    ctx->dev      = dev;
+    ctx->bladerf2 = !strcmp(bladerf_get_board_name(dev), "bladerf2");
+
+    print_header(p, dev);
+
+    for (i = 0; i < NUM_OPS; i++) {
+        if (!op_selected(p, &ops[i])) {
+            continue;
+        }
+
+        for (c = 0; c < 2; c++) {
+            if (ops[i].per_channel) {
+                if ((c == 0 && !p->rx) || (c == 1 && !p->tx)) {
+                    continue;
+                }
+            } else if (c != 0) {
+                break;
+            }
+
+            ctx->ch = channels[c];
+            run_op(p, &ops[i], ctx, latencies, &r);
+            print_result(p, &ops[i], ctx->ch, &r, first);
+            first = false;
+
+            if (r.status == BLADERF_ERR_NODEV) {
+                status = r.status;
+                goto out;
+            }
+        }
+    }
+
+out:
+    print_footer(p, !first);
+    free(latencies);
+    free(ctx);
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    struct bench_params p;
+    struct bladerf *dev = NULL;
+    int status;
+
+    memset(&p, 0, sizeof(p));
+    p.iterations = 1000;
+    p.warmup     = 10;
+    p.format     = FORMAT_JSON;
+    p.out        = stdout;
+    p.verbosity  = BLADERF_LOG_LEVEL_WARNING;
+
+    status = handle_args(argc, argv, &p);
+    if (status != 0) {
+        return status < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    bladerf_log_set_verbosity(p.verbosity);
+
+    status = bladerf_open(&dev, p.device_str);
+    if (status != 0) {
+        fprintf(stderr, "Failed to open device: %s\n",
+                bladerf_strerror(status));
+        status = -1;
+        goto out;
+    }
+
+    status = run_all(dev, &p);
+
+out:
+    if (dev != NULL) {
+        bladerf_close(dev);
+    }
+
+    if (p.out != stdout) {
+        fclose(p.out);
+    }
+
+    return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
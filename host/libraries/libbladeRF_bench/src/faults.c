@@ -0,0 +1,724 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* This program stresses the synchronous RX path with faults injected by the
+ * dummy backend (see BLADERF_DUMMY_FAULTS in backend/dummy/dummy.c): short
+ * transfers, timeouts, stalls, late completions and out-of-order
+ * completions. Faults are scheduled by transfer count, so each run sees them
+ * at the same points in the stream.
+ *
+ * For each fault and interface (bladerf_sync_rx(), or the zero-copy
+ * bladerf_sync_rx_acquire()), the sustained throughput and the time taken
+ * to resume contiguous reception after each fault are reported, as CSV or
+ * JSON. Given thresholds, the exit status reports whether they were met.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <strings.h>
+#include <getopt.h>
+#include <limits.h>
+#include <time.h>
+#include <libbladeRF.h>
+
+#include "conversions.h"
+
+#define OPTSTR "hd:s:n:b:x:f:p:m:T:F:o:v:"
+
+/* Transfer timeout of the stream, which a "timeout" fault waits out. The
+ * sync interface does not use one below this. */
+#define STREAM_TIMEOUT_MS   1000
+
+/* Timeout of each read, which must outlast a stream timeout */
+#define RX_TIMEOUT_MS       (2 * STREAM_TIMEOUT_MS)
+
+/* Time allowed for a fault near the end of a run to be recovered from */
+#define RECOVERY_GRACE_MS   (2 * RX_TIMEOUT_MS)
+
+enum fault_mode {
+    MODE_SYNC     = (1 << 0),
+    MODE_ZEROCOPY = (1 << 1),
+};
+
+enum bench_format {
+    FORMAT_CSV,
+    FORMAT_JSON,
+};
+
+static const char *const fault_names[] = {
+    "none", "short", "timeout", "stall", "delay", "reorder",
+};
+
+#define NUM_FAULTS (sizeof(fault_names) / sizeof(fault_names[0]))
+
+struct bench_params {
+    char *device_str;
+    unsigned int samplerate;
+    unsigned int num_buffers;
+    unsigned int buffer_size;
+    unsigned int num_transfers;
+    unsigned int faults;        /* Bitmask of fault_names indices */
+    unsigned int period;
+    unsigned int modes;
+    double duration;
+    double max_recovery_ms;     /* 0 if not checked */
+    double min_throughput_pct;  /* 0 if not checked */
+    enum bench_format format;
+    FILE *out;
+    bladerf_log_level verbosity;
+};
+
+struct fault_result {
+    int status;
+    uint64_t samples;
+    double wall_time;
+
+    uint64_t errors;        /* Reads that returned an error */
+    uint64_t discontinuities;
+    uint64_t samples_lost;
+
+    /* Time from a read reporting a fault until the next clean read */
+    uint64_t recoveries;
+    double recovery_total_ms;
+    double recovery_max_ms;
+    bool unrecovered;
+
+    struct bladerf_stream_stats stats;
+    bool pass;
+};
+
+static const struct numeric_suffix rate_suffixes[] = {
+    { "k", 1000 },       { "K", 1000 },
+    { "m", 1000000 },    { "M", 1000000 },
+    { "g", 1000000000 }, { "G", 1000000000 },
+};
+
+static const struct option long_options[] = {
+    { "help",           no_argument,        0,  'h' },
+    { "device",         required_argument,  0,  'd' },
+    { "samplerate",     required_argument,  0,  's' },
+    { "num-buffers",    required_argument,  0,  'n' },
+    { "buffer-size",    required_argument,  0,  'b' },
+    { "num-xfers",      required_argument,  0,  'x' },
+    { "faults",         required_argument,  0,  'f' },
+    { "period",         required_argument,  0,  'p' },
+    { "mode",           required_argument,  0,  'm' },
+    { "duration",       required_argument,  0,  'T' },
+    { "max-recovery",   required_argument,  0,  0xa0 },
+    { "min-throughput", required_argument,  0,  0xa1 },
+    { "format",         required_argument,  0,  'F' },
+    { "output",         required_argument,  0,  'o' },
+    { "verbosity",      required_argument,  0,  'v' },
+    { 0,                0,                  0,  0   },
+};
+
+static void usage(const char *argv0)
+{
+    printf("Usage: %s [options]\n", argv0);
+    printf("Stress the sync RX path with faults injected by the dummy "
+           "backend.\n\n");
+    printf("Stream options:\n");
+    printf("  -d, --device <str>         Device argument string. Default: "
+           "dummy\n");
+    printf("  -s, --samplerate <rate>    Sample rate. k, M, G suffixes are\n");
+    printf("                             accepted. Default: 10M\n");
+    printf("  -n, --num-buffers <n>      Buffer count. Default: 16\n");
+    printf("  -b, --buffer-size <n>      Samples per buffer, a multiple of\n");
+    printf("                             1024. Default: 4096\n");
+    printf("  -x, --num-xfers <n>        Transfers in flight. Default: 8\n");
+    printf("\n");
+    printf("Fault options:\n");
+    printf("  -f, --faults <list>        Faults to inject, one per run: none,\n");
+    printf("                             short, timeout, stall, delay,\n");
+    printf("                             reorder. Default: all\n");
+    printf("  -p, --period <n>           Transfers between faults. "
+           "Default: 100\n");
+    printf("  -m, --mode <list>          Interfaces to measure: sync,\n");
+    printf("                             zerocopy. Default: sync,zerocopy\n");
+    printf("  -T, --duration <sec>       Time spent on each run. Default: 2\n");
+    printf("  --max-recovery <ms>        Fail runs that take longer than this\n");
+    printf("                             to recover from a fault.\n");
+    printf("  --min-throughput <pct>     Fail runs that sustain less than\n");
+    printf("                             this percentage of the sample rate.\n");
+    printf("\n");
+    printf("Output options:\n");
+    printf("  -F, --format <fmt>         csv or json. Default: csv\n");
+    printf("  -o, --output <file>        Write results to a file instead of\n");
+    printf("                             stdout.\n");
+    printf("  -v, --verbosity <level>    libbladeRF log verbosity.\n");
+    printf("  -h, --help                 Show this text.\n");
+    printf("\n");
+    printf("Faults are injected via BLADERF_DUMMY_FAULTS, which requires the\n");
+    printf("dummy backend (libbladeRF built with ENABLE_BACKEND_DUMMY). The\n");
+    printf("exit status is non-zero if a run failed or missed a threshold.\n");
+}
+
+static int parse_list(const char *str, const char *const *names,
+                      unsigned int num_names, const char *what,
+                      unsigned int *mask)
+{
+    char *copy, *tok, *saveptr = NULL;
+    unsigned int i;
+    int status = 0;
+
+    copy = strdup(str);
+    if (copy == NULL) {
+        perror("strdup");
+        return -1;
+    }
+
+    *mask = 0;
+
+    for (tok = strtok_r(copy, ",", &saveptr); tok != NULL;
+         tok = strtok_r(NULL, ",", &saveptr)) {
+        for (i = 0; i < num_names; i++) {
+            if (!strcasecmp(tok, names[i])) {
+                *mask |= (1u << i);
+                break;
+            }
+        }
+
+        if (i == num_names) {
+            fprintf(stderr, "Invalid %s: %s\n", what, tok);
+            status = -1;
+            break;
+        }
+    }
+
+    free(copy);
+    return (status == 0 && *mask == 0) ? -1 : status;
+}
+
+static int handle_args(int argc, char *argv[], struct bench_params *p)
+{
+    static const char *const mode_names[] = { "sync", "zerocopy" };
+    int c;
+    bool ok;
+
+    while ((c = getopt_long(argc, argv, OPTSTR, long_options, NULL)) != -1) {
+        switch (c) {
+            case 'd':
+                p->device_str = optarg;
+                break;
+
+            case 's':
+                p->samplerate = str2uint_suffix(
+                    optarg, 1, UINT_MAX, rate_suffixes,
+                    sizeof(rate_suffixes) / sizeof(rate_suffixes[0]), &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid sample rate: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'n':
+                p->num_buffers = str2uint(optarg, 2, UINT_MAX, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid buffer count: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'b':
+                p->buffer_size = str2uint(optarg, 1024, UINT_MAX, &ok);
+                if (!ok || (p->buffer_size % 1024) != 0) {
+                    fprintf(stderr, "Invalid buffer size: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'x':
+                p->num_transfers = str2uint(optarg, 1, UINT_MAX, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid transfer count: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'f':
+                if (parse_list(optarg, fault_names, NUM_FAULTS, "fault",
+                               &p->faults) != 0) {
+                    return -1;
+                }
+                break;
+
+            case 'p':
+                p->period = str2uint(optarg, 1, UINT_MAX, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid period: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'm':
+                if (parse_list(optarg, mode_names, 2, "mode",
+                               &p->modes) != 0) {
+                    return -1;
+                }
+                break;
+
+            case 'T':
+                p->duration = str2double(optarg, 0.01, 3600.0, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid duration: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 0xa0:
+                p->max_recovery_ms = str2double(optarg, 0.001, 1e6, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid recovery time: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 0xa1:
+                p->min_throughput_pct = str2double(optarg, 0.001, 100.0, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid throughput: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'F':
+                if (!strcasecmp(optarg, "csv")) {
+                    p->format = FORMAT_CSV;
+                } else if (!strcasecmp(optarg, "json")) {
+                    p->format = FORMAT_JSON;
+                } else {
+                    fprintf(stderr, "Invalid format: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'o':
+                p->out = fopen(optarg, "w");
+                if (p->out == NULL) {
+                    perror(optarg);
+                    return -1;
+                }
+                break;
+
+            case 'v':
+                p->verbosity = str2loglevel(optarg, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid log level: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'h':
+                usage(argv[0]);
+                return 1;
+
+            default:
+                return -1;
+        }
+    }
+
+    if (p->num_transfers >= p->num_buffers) {
+        fprintf(stderr, "The transfer count must be less than the buffer "
+                "count.\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+static inline uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/* Open the device with the specified fault injected */
+static int open_device(const struct bench_params *p, unsigned int fault,
+                       struct bladerf **dev)
+{
+    struct bladerf_devinfo info;
+    char faults[64];
+    int status;
+
+    if (fault == 0) {
+        unsetenv("BLADERF_DUMMY_FAULTS");
+    } else {
+        snprintf(faults, sizeof(faults), "%s:%u", fault_names[fault],
+                 p->period);
+        setenv("BLADERF_DUMMY_FAULTS", faults, 1);
+    }
+
+    status = bladerf_open(dev, p->device_str);
+    if (status != 0) {
+        fprintf(stderr, "Failed to open device: %s\n",
+                bladerf_strerror(status));
+        return status;
+    }
+
+    status = bladerf_get_devinfo(*dev, &info);
+    if (status == 0 && info.backend != BLADERF_BACKEND_DUMMY) {
+        fprintf(stderr, "Faults may only be injected with the dummy "
+                "backend.\n");
+        status = BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (status != 0) {
+        bladerf_close(*dev);
+        *dev = NULL;
+    }
+
+    return status;
+}
+
+/* Receive one block, via the interface being measured */
+static int receive(struct bladerf *dev, enum fault_mode mode, int16_t *buf,
+                   unsigned int count, struct bladerf_metadata *meta)
+{
+    int status;
+
+    memset(meta, 0, sizeof(*meta));
+
+    if (mode == MODE_SYNC) {
+        meta->flags = BLADERF_META_FLAG_RX_NOW;
+        return bladerf_sync_rx(dev, buf, count, meta, RX_TIMEOUT_MS);
+    } else {
+        void *samples;
+        unsigned int num_samples;
+
+        status = bladerf_sync_rx_acquire(dev, &samples, &num_samples, meta,
+                                         RX_TIMEOUT_MS);
+        if (status == 0) {
+            /* Touch the region, as a consumer would */
+            buf[0] = ((const int16_t *)samples)[0];
+            status = bladerf_sync_rx_release(dev, samples);
+        }
+
+        return status;
+    }
+}
+
+static int run_fault(struct bladerf *dev, const struct bench_params *p,
+                     enum fault_mode mode, struct fault_result *r)
+{
+    const uint64_t duration_ns = (uint64_t)(p->duration * 1e9);
+    const uint64_t grace_ns    = (uint64_t)RECOVERY_GRACE_MS * 1000000;
+    struct bladerf_metadata meta;
+    uint64_t start, now, fault_ns = 0, expected = 0;
+    bool in_fault = false, ts_valid = false;
+    int16_t *buf;
+    int status;
+
+    buf = calloc(p->buffer_size, 2 * sizeof(int16_t));
+    if (buf == NULL) {
+        perror("calloc");
+        return BLADERF_ERR_MEM;
+    }
+
+    status = bladerf_sync_config(dev, BLADERF_RX_X1,
+                                 BLADERF_FORMAT_SC16_Q11_META, p->num_buffers,
+                                 p->buffer_size, p->num_transfers,
+                                 STREAM_TIMEOUT_MS);
+    if (status != 0) {
+        fprintf(stderr, "Failed to configure sync interface: %s\n",
+                bladerf_strerror(status));
+        goto out;
+    }
+
+    status = bladerf_enable_module(dev, BLADERF_CHANNEL_RX(0), true);
+    if (status != 0) {
+        fprintf(stderr, "Failed to enable channel: %s\n",
+                bladerf_strerror(status));
+        goto out;
+    }
+
+    start = now = monotonic_ns();
+
+    /* Once the run's time is up, a fault still being recovered from is
+     * given a while longer */
+    while ((now - start) < duration_ns ||
+           (in_fault && (now - start) < duration_ns + grace_ns)) {
+        const bool counting = (now - start) < duration_ns;
+
+        status = receive(dev, mode, buf, p->buffer_size, &meta);
+        now    = monotonic_ns();
+
+        if (status == BLADERF_ERR_TIMEOUT || status == BLADERF_ERR_IO) {
+            /* The stream ended, and is restarted by the next read */
+            r->errors++;
+            ts_valid = false;
+            if (!in_fault) {
+                in_fault = true;
+                fault_ns = now;
+            }
+            continue;
+        } else if (status != 0) {
+            fprintf(stderr, "Sync RX failed: %s\n", bladerf_strerror(status));
+            break;
+        }
+
+        if ((meta.status & BLADERF_META_STATUS_OVERRUN) ||
+            (ts_valid && meta.timestamp != expected)) {
+            r->discontinuities++;
+            if (ts_valid && meta.timestamp > expected) {
+                r->samples_lost += meta.timestamp - expected;
+            }
+            if (!in_fault) {
+                in_fault = true;
+                fault_ns = now;
+            }
+        } else if (in_fault) {
+            const double ms = (now - fault_ns) / 1e6;
+
+            r->recoveries++;
+            r->recovery_total_ms += ms;
+            if (ms > r->recovery_max_ms) {
+                r->recovery_max_ms = ms;
+            }
+            in_fault = false;
+        }
+
+        if (counting) {
+            r->samples += meta.actual_count;
+        }
+
+        expected = meta.timestamp + meta.actual_count;
+        ts_valid = true;
+    }
+
+    r->unrecovered = in_fault;
+    r->wall_time   = (now - start < duration_ns ? now - start : duration_ns) *
+                   1e-9;
+
+    bladerf_get_sync_stats(dev, BLADERF_RX, &r->stats);
+    bladerf_enable_module(dev, BLADERF_CHANNEL_RX(0), false);
+
+out:
+    free(buf);
+    return status;
+}
+
+static void print_header(const struct bench_params *p)
+{
+    if (p->format == FORMAT_CSV) {
+        fprintf(p->out,
+                "mode,fault,period,samplerate,num_buffers,buffer_size,"
+                "num_transfers,status,duration_s,samples,msps,rate_pct,"
+                "errors,discontinuities,samples_lost,recoveries,"
+                "recovery_mean_ms,recovery_max_ms,unrecovered,timeouts,"
+                "short_transfers,overruns,max_buffer_full_us,pass\n");
+    } else {
+        fprintf(p->out, "[\n");
+    }
+}
+
+static void print_footer(const struct bench_params *p, bool any)
+{
+    if (p->format == FORMAT_JSON) {
+        fprintf(p->out, "%s]\n", any ? "\n" : "");
+    }
+}
+
+static void print_result(const struct bench_params *p, enum fault_mode mode,
+                         unsigned int fault, const struct fault_result *r,
+                         bool first)
+{
+    const char *mode_str = (mode == MODE_SYNC) ? "sync" : "zerocopy";
+    const unsigned int period = (fault == 0) ? 0 : p->period;
+    double msps = 0.0, rate_pct = 0.0, recovery_mean = 0.0;
+
+    if (r->wall_time > 0.0) {
+        msps     = r->samples / r->wall_time / 1e6;
+        rate_pct = 100.0 * r->samples / r->wall_time / p->samplerate;
+    }
+
+    if (r->recoveries != 0) {
+        recovery_mean = r->recovery_total_ms / r->recoveries;
+    }
+
+    if (p->format == FORMAT_CSV) {
+        fprintf(p->out,
+                "%s,%s,%u,%u,%u,%u,%u,%d,%.3f,%" PRIu64 ",%.3f,%.2f,"
+                "%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.3f,%.3f,"
+                "%d,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%d\n",
+                mode_str, fault_names[fault], period, p->samplerate,
+                p->num_buffers, p->buffer_size, p->num_transfers, r->status,
+                r->wall_time, r->samples, msps, rate_pct, r->errors,
+                r->discontinuities, r->samples_lost, r->recoveries,
+                recovery_mean, r->recovery_max_ms, r->unrecovered,
+                r->stats.timeouts, r->stats.short_transfers,
+                r->stats.overruns, r->stats.max_buffer_full_us, r->pass);
+    } else {
+        fprintf(p->out,
+                "%s  {\"mode\": \"%s\", \"fault\": \"%s\", \"period\": %u, "
+                "\"samplerate\": %u, \"num_buffers\": %u, "
+                "\"buffer_size\": %u, \"num_transfers\": %u, "
+                "\"status\": %d, \"duration_s\": %.3f, "
+                "\"samples\": %" PRIu64 ", \"msps\": %.3f, "
+                "\"rate_pct\": %.2f, \"errors\": %" PRIu64 ", "
+                "\"discontinuities\": %" PRIu64 ", "
+                "\"samples_lost\": %" PRIu64 ", "
+                "\"recoveries\": %" PRIu64 ", "
+                "\"recovery_mean_ms\": %.3f, \"recovery_max_ms\": %.3f, "
+                "\"unrecovered\": %s, \"timeouts\": %" PRIu64 ", "
+                "\"short_transfers\": %" PRIu64 ", "
+                "\"overruns\": %" PRIu64 ", "
+                "\"max_buffer_full_us\": %" PRIu64 ", \"pass\": %s}",
+                first ? "" : ",\n", mode_str, fault_names[fault], period,
+                p->samplerate, p->num_buffers, p->buffer_size,
+                p->num_transfers, r->status, r->wall_time, r->samples, msps,
+                rate_pct, r->errors, r->discontinuities, r->samples_lost,
+                r->recoveries, recovery_mean, r->recovery_max_ms,
+                r->unrecovered ? "true" : "false", r->stats.timeouts,
+                r->stats.short_transfers, r->stats.overruns,
+                r->stats.max_buffer_full_us, r->pass ? "true" : "false");
+    }
+
+    fflush(p->out);
+}
+
+/* Apply the thresholds to a run's results */
+static bool check_result(const struct bench_params *p,
+                         const struct fault_result *r)
+{
+    if (r->status != 0 || r->unrecovered || r->wall_time <= 0.0) {
+        return false;
+    }
+
+    if (p->max_recovery_ms != 0 && r->recovery_max_ms > p->max_recovery_ms) {
+        return false;
+    }
+
+    if (p->min_throughput_pct != 0 &&
+        100.0 * r->samples / r->wall_time / p->samplerate <
+            p->min_throughput_pct) {
+        return false;
+    }
+
+    return true;
+}
+
+static int run_all(const struct bench_params *p)
+{
+    static const enum fault_mode modes[] = { MODE_SYNC, MODE_ZEROCOPY };
+
+    struct bladerf *dev;
+    struct fault_result r;
+    bladerf_sample_rate actual;
+    unsigned int m, f;
+    bool first = true;
+    int status = 0;
+
+    print_header(p);
+
+    for (m = 0; m < 2; m++) {
+        if (!(p->modes & modes[m])) {
+            continue;
+        }
+
+        for (f = 0; f < NUM_FAULTS; f++) {
+            if (!(p->faults & (1u << f))) {
+                continue;
+            }
+
+            memset(&r, 0, sizeof(r));
+
+            r.status = open_device(p, f, &dev);
+            if (r.status == BLADERF_ERR_UNSUPPORTED) {
+                status = r.status;
+                goto out;
+            }
+
+            if (r.status == 0) {
+                r.status = bladerf_set_sample_rate(dev, BLADERF_CHANNEL_RX(0),
+                                                   p->samplerate, &actual);
+                if (r.status != 0) {
+                    fprintf(stderr, "Failed to set sample rate %u: %s\n",
+                            p->samplerate, bladerf_strerror(r.status));
+                }
+            }
+
+            if (r.status == 0) {
+                r.status = run_fault(dev, p, modes[m], &r);
+            }
+
+            if (dev != NULL) {
+                bladerf_close(dev);
+            }
+
+            r.pass = check_result(p, &r);
+            if (!r.pass) {
+                status = -1;
+            }
+
+            print_result(p, modes[m], f, &r, first);
+            first = false;
+        }
+    }
+
+out:
+    print_footer(p, !first);
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    struct bench_params p;
+    int status;
+
+    memset(&p, 0, sizeof(p));
+    p.device_str    = "dummy";
+    p.samplerate    = 10000000;
+    p.num_buffers   = 16;
+    p.buffer_size   = 4096;
+    p.num_transfers = 8;
+    p.faults        = (1u << NUM_FAULTS) - 1;
+    p.period        = 100;
+    p.modes         = MODE_SYNC | MODE_ZEROCOPY;
+    p.duration      = 2.0;
+    p.format        = FORMAT_CSV;
+    p.out           = stdout;
+    p.verbosity     = BLADERF_LOG_LEVEL_SILENT;
+
+    status = handle_args(argc, argv, &p);
+    if (status != 0) {
+        return status < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    /* Each injected fault is otherwise reported as an error */
+    bladerf_log_set_verbosity(p.verbosity);
+
+    status = run_all(&p);
+
+    if (p.out != stdout) {
+        fclose(p.out);
+    }
+
+    return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
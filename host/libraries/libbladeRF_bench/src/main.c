@@ -0,0 +1,852 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* This program measures sustained streaming throughput, CPU load, and
+ * per-buffer latency of the sync and async interfaces while sweeping
+ * sample rate and stream buffer configurations. Results are emitted as CSV
+ * or JSON so they may be compared across hosts and libbladeRF revisions.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <strings.h>
+#include <getopt.h>
+#include <limits.h>
+#include <time.h>
+#include <pthread.h>
+#include <libbladeRF.h>
+
+#include "conversions.h"
+
+#define MAX_SWEEP_VALUES    16
+#define NUM_LATENCY_BINS    32
+
+#define OPTSTR "hd:c:m:s:n:b:x:T:F:o:v:"
+
+enum bench_mode {
+    BENCH_SYNC  = (1 << 0),
+    BENCH_ASYNC = (1 << 1),
+};
+
+enum bench_format {
+    FORMAT_CSV,
+    FORMAT_JSON,
+};
+
+struct sweep {
+    unsigned int values[MAX_SWEEP_VALUES];
+    unsigned int count;
+};
+
+struct bench_params {
+    char *device_str;
+    int channel;
+    bool rx;
+    bool tx;
+    unsigned int modes;
+    enum bench_format format;
+    double duration;
+    FILE *out;
+    bladerf_log_level verbosity;
+
+    struct sweep samplerates;
+    struct sweep num_buffers;
+    struct sweep buffer_sizes;
+    struct sweep num_transfers;
+};
+
+/* Configuration of a single point in the sweep */
+struct bench_point {
+    enum bench_mode mode;
+    bladerf_direction dir;
+    unsigned int samplerate;
+    unsigned int num_buffers;
+    unsigned int buffer_size;
+    unsigned int num_transfers;
+};
+
+struct bench_result {
+    int status;
+    uint64_t samples;
+    double wall_time;
+    double cpu_time;
+
+    /* Per-buffer latency, in microseconds: the duration of each sync call,
+     * or the period between successive async callbacks. */
+    uint64_t latency_count;
+    uint64_t latency_max;
+    uint64_t latency_hist[NUM_LATENCY_BINS];
+
+    struct bladerf_stream_stats stats;
+};
+
+struct async_ctx {
+    pthread_mutex_t lock;
+    bool stop;
+
+    void **buffers;
+    unsigned int num_buffers;
+    unsigned int next;
+    uint64_t last_ns;
+
+    struct bench_result *result;
+};
+
+static const struct numeric_suffix rate_suffixes[] = {
+    { "k", 1000 },       { "K", 1000 },
+    { "m", 1000000 },    { "M", 1000000 },
+    { "g", 1000000000 }, { "G", 1000000000 },
+};
+
+static const struct option long_options[] = {
+    { "help",           no_argument,        0,  'h' },
+    { "device",         required_argument,  0,  'd' },
+    { "channel",        required_argument,  0,  'c' },
+    { "rx",             no_argument,        0,  0xa0 },
+    { "tx",             no_argument,        0,  0xa1 },
+    { "mode",           required_argument,  0,  'm' },
+    { "samplerates",    required_argument,  0,  's' },
+    { "num-buffers",    required_argument,  0,  'n' },
+    { "buffer-sizes",   required_argument,  0,  'b' },
+    { "num-xfers",      required_argument,  0,  'x' },
+    { "duration",       required_argument,  0,  'T' },
+    { "format",         required_argument,  0,  'F' },
+    { "output",         required_argument,  0,  'o' },
+    { "verbosity",      required_argument,  0,  'v' },
+    { 0,                0,                  0,  0   },
+};
+
+static void usage(const char *argv0)
+{
+    printf("Usage: %s [options]\n", argv0);
+    printf("Sweep stream configurations and report sustained throughput.\n\n");
+    printf("Device options:\n");
+    printf("  -d, --device <str>         Device argument string.\n");
+    printf("  -c, --channel <n>          Channel index. Default: 0\n");
+    printf("  --rx                       Benchmark the receive path.\n");
+    printf("  --tx                       Benchmark the transmit path.\n");
+    printf("                             Default: --rx\n");
+    printf("\n");
+    printf("Sweep options (comma-separated lists):\n");
+    printf("  -m, --mode <list>          Interfaces to measure: sync, async.\n");
+    printf("                             Default: sync,async\n");
+    printf("  -s, --samplerates <list>   Sample rates. k, M, G suffixes are\n");
+    printf("                             accepted. Default: 1M,10M,30.72M\n");
+    printf("  -n, --num-buffers <list>   Buffer counts. Default: 16,32\n");
+    printf("  -b, --buffer-sizes <list>  Samples per buffer, in multiples of\n");
+    printf("                             1024. Default: 4096,16384\n");
+    printf("  -x, --num-xfers <list>     Transfers in flight. Default: 8\n");
+    printf("\n");
+    printf("Output options:\n");
+    printf("  -T, --duration <sec>       Time spent at each point. Default: 2\n");
+    printf("  -F, --format <fmt>         csv or json. Default: csv\n");
+    printf("  -o, --output <file>        Write results to a file instead of\n");
+    printf("                             stdout.\n");
+    printf("  -v, --verbosity <level>    libbladeRF log verbosity.\n");
+    printf("  -h, --help                 Show this text.\n");
+    printf("\n");
+    printf("Points where the transfer count is not smaller than the buffer\n");
+    printf("count are skipped. Use '-d dummy' to measure the host-side\n");
+    printf("overhead of the stack with the dummy backend, when libbladeRF is\n");
+    printf("built with ENABLE_BACKEND_DUMMY.\n");
+}
+
+static int parse_sweep(const char *str, const char *name, struct sweep *s,
+                       unsigned int min, bool suffix)
+{
+    char *copy, *tok, *saveptr = NULL;
+    bool ok = true;
+    int status = 0;
+
+    copy = strdup(str);
+    if (copy == NULL) {
+        perror("strdup");
+        return -1;
+    }
+
+    s->count = 0;
+
+    for (tok = strtok_r(copy, ",", &saveptr); tok != NULL;
+         tok = strtok_r(NULL, ",", &saveptr)) {
+
+        if (s->count >= MAX_SWEEP_VALUES) {
+            fprintf(stderr, "Too many %s values (max %u).\n",
+                    name, MAX_SWEEP_VALUES);
+            status = -1;
+            break;
+        }
+
+        if (suffix) {
+            s->values[s->count] = str2uint_suffix(
+                tok, min, UINT_MAX, rate_suffixes,
+                sizeof(rate_suffixes) / sizeof(rate_suffixes[0]), &ok);
+        } else {
+            s->values[s->count] = str2uint(tok, min, UINT_MAX, &ok);
+        }
+
+        if (!ok) {
+            fprintf(stderr, "Invalid %s value: %s\n", name, tok);
+            status = -1;
+            break;
+        }
+
+        s->count++;
+    }
+
+    if (status == 0 && s->count == 0) {
+        fprintf(stderr, "No %s values provided.\n", name);
+        status = -1;
+    }
+
+    free(copy);
+    return status;
+}
+
+static int parse_modes(const char *str, unsigned int *modes)
+{
+    char *copy, *tok, *saveptr = NULL;
+    int status = 0;
+
+    copy = strdup(str);
+    if (copy == NULL) {
+        perror("strdup");
+        return -1;
+    }
+
+    *modes = 0;
+
+    for (tok = strtok_r(copy, ",", &saveptr); tok != NULL;
+         tok = strtok_r(NULL, ",", &saveptr)) {
+        if (!strcasecmp(tok, "sync")) {
+            *modes |= BENCH_SYNC;
+        } else if (!strcasecmp(tok, "async")) {
+            *modes |= BENCH_ASYNC;
+        } else {
+            fprintf(stderr, "Invalid mode: %s\n", tok);
+            status = -1;
+            break;
+        }
+    }
+
+    free(copy);
+    return (status == 0 && *modes == 0) ? -1 : status;
+}
+
+static int handle_args(int argc, char *argv[], struct bench_params *p)
+{
+    int c;
+    bool ok;
+
+    while ((c = getopt_long(argc, argv, OPTSTR, long_options, NULL)) != -1) {
+        switch (c) {
+            case 'd':
+                p->device_str = optarg;
+                break;
+
+            case 'c':
+                p->channel = str2int(optarg, 0, 1, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid channel: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 0xa0:
+                p->rx = true;
+                break;
+
+            case 0xa1:
+                p->tx = true;
+                break;
+
+            case 'm':
+                if (parse_modes(optarg, &p->modes) != 0) {
+                    return -1;
+                }
+                break;
+
+            case 's':
+                if (parse_sweep(optarg, "sample rate", &p->samplerates,
+                                1, true) != 0) {
+                    return -1;
+                }
+                break;
+
+            case 'n':
+                if (parse_sweep(optarg, "buffer count", &p->num_buffers,
+                                2, false) != 0) {
+                    return -1;
+                }
+                break;
+
+            case 'b':
+                if (parse_sweep(optarg, "buffer size", &p->buffer_sizes,
+                                1024, false) != 0) {
+                    return -1;
+                }
+                break;
+
+            case 'x':
+                if (parse_sweep(optarg, "transfer count", &p->num_transfers,
+                                1, false) != 0) {
+                    return -1;
+                }
+                break;
+
+            case 'T':
+                p->duration = str2double(optarg, 0.01, 3600.0, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid duration: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'F':
+                if (!strcasecmp(optarg, "csv")) {
+                    p->format = FORMAT_CSV;
+                } else if (!strcasecmp(optarg, "json")) {
+                    p->format = FORMAT_JSON;
+                } else {
+                    fprintf(stderr, "Invalid format: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'o':
+                p->out = fopen(optarg, "w");
+                if (p->out == NULL) {
+                    perror(optarg);
+                    return -1;
+                }
+                break;
+
+            case 'v':
+                p->verbosity = str2loglevel(optarg, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid log level: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'h':
+                usage(argv[0]);
+                return 1;
+
+            default:
+                return -1;
+        }
+    }
+
+    if (!p->rx && !p->tx) {
+        p->rx = true;
+    }
+
+    return 0;
+}
+
+static inline uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static inline double cpu_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static inline void record_latency(struct bench_result *r, uint64_t ns)
+{
+    uint64_t us = ns / 1000;
+    unsigned int bin = 0;
+
+    while (bin < (NUM_LATENCY_BINS - 1) && (us >> bin) != 0) {
+        bin++;
+    }
+
+    r->latency_hist[bin]++;
+    r->latency_count++;
+
+    if (us > r->latency_max) {
+        r->latency_max = us;
+    }
+}
+
+/* Upper bound, in microseconds, of the histogram bin containing the
+ * requested percentile */
+static uint64_t latency_percentile(const struct bench_result *r, double pct)
+{
+    uint64_t target, seen = 0;
+    unsigned int i;
+
+    if (r->latency_count == 0) {
+        return 0;
+    }
+
+    target = (uint64_t)(r->latency_count * pct / 100.0);
+    if (target == 0) {
+        target = 1;
+    }
+
+    for (i = 0; i < NUM_LATENCY_BINS; i++) {
+        seen += r->latency_hist[i];
+        if (seen >= target) {
+            return (i == 0) ? 1 : ((uint64_t)1 << i);
+        }
+    }
+
+    return r->latency_max;
+}
+
+static int run_sync(struct bladerf *dev, const struct bench_params *p,
+                    const struct bench_point *pt, struct bench_result *r)
+{
+    const bladerf_channel ch = (pt->dir == BLADERF_RX)
+                                   ? BLADERF_CHANNEL_RX(p->channel)
+                                   : BLADERF_CHANNEL_TX(p->channel);
+    const bladerf_channel_layout layout =
+        (pt->dir == BLADERF_RX) ? BLADERF_RX_X1 : BLADERF_TX_X1;
+    const unsigned int timeout_ms = 3500;
+
+    uint64_t start, end, t0, t1;
+    double cpu_start;
+    int16_t *samples;
+    int status;
+
+    samples = calloc(pt->buffer_size, 2 * sizeof(int16_t));
+    if (samples == NULL) {
+        perror("calloc");
+        return BLADERF_ERR_MEM;
+    }
+
+    status = bladerf_sync_config(dev, layout, BLADERF_FORMAT_SC16_Q11,
+                                 pt->num_buffers, pt->buffer_size,
+                                 pt->num_transfers, timeout_ms);
+    if (status != 0) {
+        fprintf(stderr, "Failed to configure sync interface: %s\n",
+                bladerf_strerror(status));
+        goto out;
+    }
+
+    status = bladerf_enable_module(dev, ch, true);
+    if (status != 0) {
+        fprintf(stderr, "Failed to enable channel: %s\n",
+                bladerf_strerror(status));
+        goto out;
+    }
+
+    cpu_start = cpu_seconds();
+    start = end = monotonic_ns();
+
+    while ((end - start) < (uint64_t)(p->duration * 1e9)) {
+        t0 = monotonic_ns();
+
+        if (pt->dir == BLADERF_RX) {
+            status = bladerf_sync_rx(dev, samples, pt->buffer_size, NULL,
+                                     timeout_ms);
+        } else {
+            status = bladerf_sync_tx(dev, samples, pt->buffer_size, NULL,
+                                     timeout_ms);
+        }
+
+        t1 = monotonic_ns();
+
+        if (status != 0) {
+            fprintf(stderr, "Sync %s failed: %s\n",
+                    direction2str(pt->dir), bladerf_strerror(status));
+            break;
+        }
+
+        r->samples += pt->buffer_size;
+        record_latency(r, t1 - t0);
+        end = t1;
+    }
+
+    r->wall_time = (end - start) * 1e-9;
+    r->cpu_time  = cpu_seconds() - cpu_start;
+
+    bladerf_get_sync_stats(dev, pt->dir, &r->stats);
+    bladerf_enable_module(dev, ch, false);
+
+out:
+    free(samples);
+    return status;
+}
+
+static void *async_cb(struct bladerf *dev,
+                      struct bladerf_stream *stream,
+                      struct bladerf_metadata *meta,
+                      void *samples,
+                      size_t num_samples,
+                      void *user_data)
+{
+    struct async_ctx *ctx = (struct async_ctx *)user_data;
+    uint64_t now = monotonic_ns();
+    void *next;
+    bool stop;
+
+    pthread_mutex_lock(&ctx->lock);
+    stop = ctx->stop;
+    pthread_mutex_unlock(&ctx->lock);
+
+    if (stop) {
+        return BLADERF_STREAM_SHUTDOWN;
+    }
+
+    /* The first callbacks merely request buffers to fill the pipeline */
+    if (samples != NULL) {
+        ctx->result->samples += num_samples;
+
+        if (ctx->last_ns != 0) {
+            record_latency(ctx->result, now - ctx->last_ns);
+        }
+
+        ctx->last_ns = now;
+    }
+
+    next = ctx->buffers[ctx->next];
+    ctx->next = (ctx->next + 1) % ctx->num_buffers;
+
+    return next;
+}
+
+struct stream_thread_data {
+    struct bladerf_stream *stream;
+    bladerf_channel_layout layout;
+    int status;
+};
+
+static void *stream_task(void *arg)
+{
+    struct stream_thread_data *data = (struct stream_thread_data *)arg;
+    data->status = bladerf_stream(data->stream, data->layout);
+    return NULL;
+}
+
+static int run_async(struct bladerf *dev, const struct bench_params *p,
+                     const struct bench_point *pt, struct bench_result *r)
+{
+    const bladerf_channel ch = (pt->dir == BLADERF_RX)
+                                   ? BLADERF_CHANNEL_RX(p->channel)
+                                   : BLADERF_CHANNEL_TX(p->channel);
+
+    struct async_ctx ctx;
+    struct stream_thread_data thread_data;
+    struct bladerf_stream *stream = NULL;
+    struct timespec poll_period = { 0, 10 * 1000 * 1000 };
+    pthread_t thread;
+    uint64_t start;
+    double cpu_start;
+    int status;
+
+    memset(&ctx, 0, sizeof(ctx));
+    pthread_mutex_init(&ctx.lock, NULL);
+    ctx.num_buffers = pt->num_buffers;
+    ctx.result      = r;
+
+    status = bladerf_init_stream(&stream, dev, async_cb, &ctx.buffers,
+                                 pt->num_buffers, BLADERF_FORMAT_SC16_Q11,
+                                 pt->buffer_size, pt->num_transfers, &ctx);
+    if (status != 0) {
+        fprintf(stderr, "Failed to initialize stream: %s\n",
+                bladerf_strerror(status));
+        goto out;
+    }
+
+    if (pt->dir == BLADERF_TX) {
+        unsigned int i;
+        for (i = 0; i < pt->num_buffers; i++) {
+            memset(ctx.buffers[i], 0, pt->buffer_size * 2 * sizeof(int16_t));
+        }
+    }
+
+    status = bladerf_enable_module(dev, ch, true);
+    if (status != 0) {
+        fprintf(stderr, "Failed to enable channel: %s\n",
+                bladerf_strerror(status));
+        goto out;
+    }
+
+    thread_data.stream = stream;
+    thread_data.layout =
+        (pt->dir == BLADERF_RX) ? BLADERF_RX_X1 : BLADERF_TX_X1;
+    thread_data.status = 0;
+
+    cpu_start = cpu_seconds();
+    start     = monotonic_ns();
+
+    status = pthread_create(&thread, NULL, stream_task, &thread_data);
+    if (status != 0) {
+        fprintf(stderr, "Failed to start stream thread.\n");
+        status = BLADERF_ERR_UNEXPECTED;
+        bladerf_enable_module(dev, ch, false);
+        goto out;
+    }
+
+    while ((monotonic_ns() - start) < (uint64_t)(p->duration * 1e9)) {
+        nanosleep(&poll_period, NULL);
+    }
+
+    pthread_mutex_lock(&ctx.lock);
+    ctx.stop = true;
+    pthread_mutex_unlock(&ctx.lock);
+
+    pthread_join(thread, NULL);
+
+    r->wall_time = (monotonic_ns() - start) * 1e-9;
+    r->cpu_time  = cpu_seconds() - cpu_start;
+
+    bladerf_get_stream_stats(stream, &r->stats);
+    bladerf_enable_module(dev, ch, false);
+
+    status = thread_data.status;
+    if (status != 0) {
+        fprintf(stderr, "Stream error: %s\n", bladerf_strerror(status));
+    }
+
+out:
+    bladerf_deinit_stream(stream);
+    pthread_mutex_destroy(&ctx.lock);
+    return status;
+}
+
+static void print_header(const struct bench_params *p)
+{
+    if (p->format == FORMAT_CSV) {
+        fprintf(p->out,
+                "mode,direction,samplerate,num_buffers,buffer_size,"
+                "num_transfers,status,duration_s,samples,msps,cpu_pct,"
+                "cpu_pct_per_msps,latency_p50_us,latency_p99_us,"
+                "latency_max_us,timeouts,short_transfers,overruns,"
+                "underruns,max_buffer_full_us,callback_max_us\n");
+    } else {
+        fprintf(p->out, "[\n");
+    }
+}
+
+static void print_footer(const struct bench_params *p, bool any)
+{
+    if (p->format == FORMAT_JSON) {
+        fprintf(p->out, "%s]\n", any ? "\n" : "");
+    }
+}
+
+static void print_result(const struct bench_params *p,
+                         const struct bench_point *pt,
+                         const struct bench_result *r,
+                         bool first)
+{
+    const char *mode = (pt->mode == BENCH_SYNC) ? "sync" : "async";
+    const char *dir  = (pt->dir == BLADERF_RX) ? "rx" : "tx";
+    double msps = 0.0, cpu_pct = 0.0, cpu_per_msps = 0.0;
+
+    if (r->wall_time > 0.0) {
+        msps    = r->samples / r->wall_time / 1e6;
+        cpu_pct = 100.0 * r->cpu_time / r->wall_time;
+    }
+
+    if (msps > 0.0) {
+        cpu_per_msps = cpu_pct / msps;
+    }
+
+    if (p->format == FORMAT_CSV) {
+        fprintf(p->out,
+                "%s,%s,%u,%u,%u,%u,%d,%.3f,%" PRIu64 ",%.3f,%.2f,%.4f,"
+                "%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
+                ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n",
+                mode, dir, pt->samplerate, pt->num_buffers, pt->buffer_size,
+                pt->num_transfers, r->status, r->wall_time, r->samples, msps,
+                cpu_pct, cpu_per_msps, latency_percentile(r, 50.0),
+                latency_percentile(r, 99.0), r->latency_max, r->stats.timeouts,
+                r->stats.short_transfers, r->stats.overruns,
+                r->stats.underruns, r->stats.max_buffer_full_us,
+                r->stats.callback_max_us);
+    } else {
+        fprintf(p->out,
+                "%s  {\"mode\": \"%s\", \"direction\": \"%s\", "
+                "\"samplerate\": %u, \"num_buffers\": %u, "
+                "\"buffer_size\": %u, \"num_transfers\": %u, "
+                "\"status\": %d, \"duration_s\": %.3f, "
+                "\"samples\": %" PRIu64 ", \"msps\": %.3f, "
+                "\"cpu_pct\": %.2f, \"cpu_pct_per_msps\": %.4f, "
+                "\"latency_p50_us\": %" PRIu64 ", "
+                "\"latency_p99_us\": %" PRIu64 ", "
+                "\"latency_max_us\": %" PRIu64 ", "
+                "\"timeouts\": %" PRIu64 ", "
+                "\"short_transfers\": %" PRIu64 ", "
+                "\"overruns\": %" PRIu64 ", \"underruns\": %" PRIu64 ", "
+                "\"max_buffer_full_us\": %" PRIu64 ", "
+                "\"callback_max_us\": %" PRIu64 "}",
+                first ? "" : ",\n", mode, dir, pt->samplerate,
+                pt->num_buffers, pt->buffer_size, pt->num_transfers,
+                r->status, r->wall_time, r->samples, msps, cpu_pct,
+                cpu_per_msps, latency_percentile(r, 50.0),
+                latency_percentile(r, 99.0), r->latency_max, r->stats.timeouts,
+                r->stats.short_transfers, r->stats.overruns,
+                r->stats.underruns, r->stats.max_buffer_full_us,
+                r->stats.callback_max_us);
+    }
+
+    fflush(p->out);
+}
+
+static int run_point(struct bladerf *dev, const struct bench_params *p,
+                     const struct bench_point *pt, struct bench_result *r)
+{
+    const bladerf_channel ch = (pt->dir == BLADERF_RX)
+                                   ? BLADERF_CHANNEL_RX(p->channel)
+                                   : BLADERF_CHANNEL_TX(p->channel);
+    bladerf_sample_rate actual;
+    int status;
+
+    memset(r, 0, sizeof(*r));
+
+    status = bladerf_set_sample_rate(dev, ch, pt->samplerate, &actual);
+    if (status != 0) {
+        fprintf(stderr, "Failed to set sample rate %u: %s\n",
+                pt->samplerate, bladerf_strerror(status));
+        return status;
+    }
+
+    if (pt->mode == BENCH_SYNC) {
+        return run_sync(dev, p, pt, r);
+    } else {
+        return run_async(dev, p, pt, r);
+    }
+}
+
+static int run_sweep(struct bladerf *dev, const struct bench_params *p)
+{
+    static const enum bench_mode modes[] = { BENCH_SYNC, BENCH_ASYNC };
+    static const bladerf_direction dirs[] = { BLADERF_RX, BLADERF_TX };
+
+    struct bench_point pt;
+    struct bench_result r;
+    unsigned int m, d, s, n, b, x;
+    bool first = true;
+    int status = 0;
+
+    print_header(p);
+
+    for (m = 0; m < 2; m++) {
+        if (!(p->modes & modes[m])) {
+            continue;
+        }
+
+        for (d = 0; d < 2; d++) {
+            if ((dirs[d] == BLADERF_RX && !p->rx) ||
+                (dirs[d] == BLADERF_TX && !p->tx)) {
+                continue;
+            }
+
+            for (s = 0; s < p->samplerates.count; s++) {
+            for (n = 0; n < p->num_buffers.count; n++) {
+            for (b = 0; b < p->buffer_sizes.count; b++) {
+            for (x = 0; x < p->num_transfers.count; x++) {
+                pt.mode          = modes[m];
+                pt.dir           = dirs[d];
+                pt.samplerate    = p->samplerates.values[s];
+                pt.num_buffers   = p->num_buffers.values[n];
+                pt.buffer_size   = p->buffer_sizes.values[b];
+                pt.num_transfers = p->num_transfers.values[x];
+
+                if (pt.num_transfers >= pt.num_buffers ||
+                    (pt.buffer_size % 1024) != 0) {
+                    continue;
+                }
+
+                r.status = run_point(dev, p, &pt, &r);
+                print_result(p, &pt, &r, first);
+                first = false;
+
+                if (r.status == BLADERF_ERR_NODEV) {
+                    status = r.status;
+                    goto out;
+                }
+            }
+            }
+            }
+            }
+        }
+    }
+
+out:
+    print_footer(p, !first);
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    struct bench_params p;
+    struct bladerf *dev = NULL;
+    int status;
+
+    memset(&p, 0, sizeof(p));
+    p.modes     = BENCH_SYNC | BENCH_ASYNC;
+    p.format    = FORMAT_CSV;
+    p.duration  = 2.0;
+    p.out       = stdout;
+    p.verbosity = BLADERF_LOG_LEVEL_WARNING;
+
+    parse_sweep("1M,10M,30.72M", "sample rate", &p.samplerates, 1, true);
+    parse_sweep("16,32", "buffer count", &p.num_buffers, 2, false);
+    parse_sweep("4096,16384", "buffer size", &p.buffer_sizes, 1024, false);
+    parse_sweep("8", "transfer count", &p.num_transfers, 1, false);
+
+    status = handle_args(argc, argv, &p);
+    if (status != 0) {
+        return status < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    bladerf_log_set_verbosity(p.verbosity);
+
+    status = bladerf_open(&dev, p.device_str);
+    if (status != 0) {
+        fprintf(stderr, "Failed to open device: %s\n",
+                bladerf_strerror(status));
+        status = -1;
+        goto out;
+    }
+
+    status = run_sweep(dev, &p);
+
+out:
+    if (dev != NULL) {
+        bladerf_close(dev);
+    }
+
+    if (p.out != stdout) {
+        fclose(p.out);
+    }
+
+    return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -42,6 +42,11 @@ get_device_list = _bladerf.get_device_list
 load_fw_from_bootloader = _bladerf.load_fw_from_bootloader
 set_verbosity = _bladerf.set_verbosity
 version = _bladerf.version
+sc16q11_to_cf32 = _bladerf.sc16q11_to_cf32
+
+ChannelLayout = _bladerf.ChannelLayout
+Format = _bladerf.Format
+Metadata = _bladerf.Metadata
 
 RX = _bladerf.RX
 TX = _bladerf.TX
@@ -51,5 +56,6 @@ CHANNEL_TX = _bladerf.CHANNEL_TX
 main = _tool.main
 
 __all__ = ['BladeRF', 'get_bootloader_list', 'get_device_list',
-           'load_fw_from_bootloader', 'set_verbosity', 'version', 'RX', 'TX',
-           'CHANNEL_RX', 'CHANNEL_TX', 'main']
+           'load_fw_from_bootloader', 'set_verbosity', 'version',
+           'sc16q11_to_cf32', 'ChannelLayout', 'Format', 'Metadata', 'RX',
+           'TX', 'CHANNEL_RX', 'CHANNEL_TX', 'main']
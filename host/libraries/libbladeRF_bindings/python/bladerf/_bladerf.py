@@ -24,6 +24,11 @@ import collections
 
 import cffi
 
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
 from ._cdef import header
 
 ffi = cffi.FFI()
@@ -93,6 +98,7 @@ class Backend(enum.Enum):
     Linux = libbladeRF.BLADERF_BACKEND_LINUX
     LibUSB = libbladeRF.BLADERF_BACKEND_LIBUSB
     Cypress = libbladeRF.BLADERF_BACKEND_CYPRESS
+    Shm = libbladeRF.BLADERF_BACKEND_SHM
     Dummy = libbladeRF.BLADERF_BACKEND_DUMMY
 
     def __str__(self):
@@ -199,6 +205,79 @@ class Format(enum.Enum):
     SC16_Q11 = libbladeRF.BLADERF_FORMAT_SC16_Q11
     SC16_Q11_META = libbladeRF.BLADERF_FORMAT_SC16_Q11_META
     PACKET_META = libbladeRF.BLADERF_FORMAT_PACKET_META
+    CF32 = libbladeRF.BLADERF_FORMAT_CF32
+    CF32_META = libbladeRF.BLADERF_FORMAT_CF32_META
+    SC8_Q7 = libbladeRF.BLADERF_FORMAT_SC8_Q7
+    SC8_Q7_META = libbladeRF.BLADERF_FORMAT_SC8_Q7_META
+
+    @property
+    def sample_size(self):
+        """Size of one sample, in bytes"""
+        if self in (Format.CF32, Format.CF32_META):
+            return 8
+        elif self in (Format.SC8_Q7, Format.SC8_Q7_META):
+            return 2
+        else:
+            return 4
+
+    @property
+    def dtype(self):
+        """NumPy dtype of the elements of a buffer of samples"""
+        if self in (Format.CF32, Format.CF32_META):
+            return 'complex64'
+        elif self in (Format.SC8_Q7, Format.SC8_Q7_META):
+            return 'int8'
+        elif self == Format.PACKET_META:
+            return 'uint32'
+        else:
+            return 'int16'
+
+
+class Metadata:
+    """Sample metadata, for use with the metadata formats (*_META)
+
+    Flags and status bits are provided as META_FLAG_* and META_STATUS_*."""
+
+    def __init__(self, timestamp=0, flags=0, struct=None):
+        if struct is None:
+            struct = ffi.new("struct bladerf_metadata *")
+            struct.timestamp = timestamp
+            struct.flags = flags
+        self.struct = struct
+
+    def __repr__(self):
+        return ('<Metadata(timestamp={}, flags={:#x}, status={:#x}, '
+                'actual_count={}, gap={})>').format(
+                    self.timestamp, self.flags, self.status,
+                    self.actual_count, self.gap)
+
+    @property
+    def timestamp(self):
+        return self.struct.timestamp
+
+    @timestamp.setter
+    def timestamp(self, value):
+        self.struct.timestamp = value
+
+    @property
+    def flags(self):
+        return self.struct.flags
+
+    @flags.setter
+    def flags(self, value):
+        self.struct.flags = value
+
+    @property
+    def status(self):
+        return self.struct.status
+
+    @property
+    def actual_count(self):
+        return self.struct.actual_count
+
+    @property
+    def gap(self):
+        return self.struct.gap
 
 
 class Loopback(enum.Enum):
@@ -439,6 +518,17 @@ RX = 0x0
 TX = 0x1
 
 
+META_STATUS_OVERRUN = libbladeRF.BLADERF_META_STATUS_OVERRUN
+META_STATUS_UNDERRUN = libbladeRF.BLADERF_META_STATUS_UNDERRUN
+META_FLAG_TX_BURST_START = libbladeRF.BLADERF_META_FLAG_TX_BURST_START
+META_FLAG_TX_BURST_END = libbladeRF.BLADERF_META_FLAG_TX_BURST_END
+META_FLAG_TX_NOW = libbladeRF.BLADERF_META_FLAG_TX_NOW
+META_FLAG_TX_UPDATE_TIMESTAMP = libbladeRF.BLADERF_META_FLAG_TX_UPDATE_TIMESTAMP
+META_FLAG_TX_COALESCE = libbladeRF.BLADERF_META_FLAG_TX_COALESCE
+META_FLAG_RX_NOW = libbladeRF.BLADERF_META_FLAG_RX_NOW
+META_FLAG_RX_RESYNC = libbladeRF.BLADERF_META_FLAG_RX_RESYNC
+
+
 def CHANNEL_RX(ch):
     return (ch << 1) | RX
 
@@ -457,6 +547,106 @@ BLADERF_SERIAL_LENGTH = 33
 ###############################################################################
 
 
+def _wrap_samples(ptr, num_samples, fmt):
+    """Wrap num_samples samples at ptr as a NumPy array, or as a memoryview
+    when NumPy is not available. The samples are not copied."""
+    buf = ffi.buffer(ptr, num_samples * fmt.sample_size)
+    if numpy is None:
+        return memoryview(buf)
+    return numpy.frombuffer(buf, dtype=fmt.dtype)
+
+
+def sc16q11_to_cf32(samples, out=None):
+    """Convert interleaved SC16 Q11 samples to complex64 values in the
+    range [-1.0, 1.0).
+
+    `out` may provide a complex64 array of at least len(samples) // 2
+    elements to convert into, which saves allocating one per call. The
+    converted part of it is returned. Requires NumPy."""
+    if numpy is None:
+        raise NotImplementedError("NumPy is required for this conversion.")
+
+    iq = numpy.asarray(samples, dtype=numpy.int16).reshape(-1, 2)
+    if out is None:
+        out = numpy.empty(len(iq), dtype=numpy.complex64)
+    out = out[:len(iq)]
+
+    numpy.multiply(iq, numpy.float32(1.0 / 2048.0),
+                   out=out.view(numpy.float32).reshape(-1, 2),
+                   casting='unsafe')
+    return out
+
+
+class RXRegion:
+    """Received samples, provided in place by BladeRF.sync_rx_acquire().
+
+    `samples` is an array over the synchronous interface's own buffer, and
+    must not be used once the region has been released. When used as a
+    context manager, the region is released upon leaving the block."""
+
+    def __init__(self, dev, ptr, num_samples, fmt, meta):
+        self.dev = dev
+        self.ptr = ptr
+        self.num_samples = num_samples
+        self.meta = meta
+        self.samples = _wrap_samples(ptr, num_samples, fmt)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.release()
+
+    def release(self):
+        if self.ptr is None:
+            return
+
+        ret = libbladeRF.bladerf_sync_rx_release(self.dev, self.ptr)
+        self.ptr = None
+        self.samples = None
+        _check_error(ret)
+
+
+class TXRegion:
+    """Space for samples to transmit, provided in place by
+    BladeRF.sync_tx_acquire().
+
+    `samples` is an array over the synchronous interface's own buffer, and
+    must not be used once the region has been committed. When used as a
+    context manager, the whole region is committed upon leaving the block,
+    unless commit() was called within it or an exception was raised, in
+    which case no samples are committed."""
+
+    def __init__(self, dev, ptr, num_samples, fmt):
+        self.dev = dev
+        self.ptr = ptr
+        self.num_samples = num_samples
+        self.samples = _wrap_samples(ptr, num_samples, fmt)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, *args):
+        if self.ptr is not None:
+            self.commit(self.num_samples if exc_type is None else 0)
+
+    def commit(self, num_samples=None):
+        if self.ptr is None:
+            raise InvalError("Region already committed")
+
+        if num_samples is None:
+            num_samples = self.num_samples
+
+        ret = libbladeRF.bladerf_sync_tx_commit(self.dev, self.ptr,
+                                                num_samples)
+        self.ptr = None
+        self.samples = None
+        _check_error(ret)
+
+
+###############################################################################
+
+
 class BladeRF:
     """Python class for interacting with bladeRF boards.
 
@@ -469,6 +659,7 @@ class BladeRF:
 
     def __init__(self, device_identifier=None, devinfo=None):
         self.dev = ffi.new("struct bladerf *[1]")
+        self._sync_formats = {}
         self.open(device_identifier, devinfo)
 
     def __repr__(self):
@@ -850,7 +1041,7 @@ class BladeRF:
 
     def sync_config(self, layout, fmt, num_buffers, buffer_size, num_transfers,
                     stream_timeout):
-        if fmt != Format.SC16_Q11:
+        if fmt == Format.PACKET_META:
             raise NotImplementedError("Format not supported by binding.")
 
         ret = libbladeRF.bladerf_sync_config(self.dev[0],
@@ -861,23 +1052,166 @@ class BladeRF:
                                              num_transfers,
                                              stream_timeout)
         _check_error(ret)
+        self._sync_formats[Direction(layout.value & TX)] = fmt
 
-    def sync_tx(self, buf, num_samples, timeout_ms=None):
+    def _sync_format(self, direction):
+        try:
+            return self._sync_formats[direction]
+        except KeyError:
+            raise InvalError("sync_config() has not been called")
+
+    def _sync_buffer(self, direction, buf, num_samples):
+        """Returns a pointer to buf and the number of samples to transfer,
+        after checking that buf holds that many."""
+        fmt = self._sync_format(direction)
+        ptr = ffi.from_buffer(buf)
+        capacity = len(ptr) // fmt.sample_size
+
+        if num_samples is None:
+            num_samples = capacity
+        elif num_samples > capacity:
+            raise ValueError("Buffer holds only {} samples".format(capacity))
+
+        return ptr, num_samples
+
+    def sync_tx(self, buf, num_samples=None, timeout_ms=None, meta=None):
+        """Transmit num_samples samples from buf, which may be any object
+        supporting the buffer protocol, such as a NumPy array. By default,
+        the whole of buf is transmitted. meta is required for the metadata
+        formats."""
+        ptr, num_samples = self._sync_buffer(Direction.TX, buf, num_samples)
         ret = libbladeRF.bladerf_sync_tx(self.dev[0],
-                                         ffi.from_buffer(buf),
+                                         ptr,
                                          num_samples,
-                                         ffi.NULL,
+                                         meta.struct if meta else ffi.NULL,
                                          timeout_ms or 0)
         _check_error(ret)
 
-    def sync_rx(self, buf, num_samples, timeout_ms=None):
+    def sync_rx(self, buf, num_samples=None, timeout_ms=None, meta=None):
+        """Receive num_samples samples directly into buf, which may be any
+        writable object supporting the buffer protocol, such as a NumPy
+        array. By default, buf is filled. meta is required for the metadata
+        formats.
+
+        With Format.CF32, samples are converted by libbladeRF, and a
+        complex64 NumPy array may be passed as buf."""
+        ptr, num_samples = self._sync_buffer(Direction.RX, buf, num_samples)
         ret = libbladeRF.bladerf_sync_rx(self.dev[0],
-                                         ffi.from_buffer(buf),
+                                         ptr,
                                          num_samples,
-                                         ffi.NULL,
+                                         meta.struct if meta else ffi.NULL,
                                          timeout_ms or 0)
         _check_error(ret)
 
+    def sync_rx_acquire(self, timeout_ms=None, meta=None):
+        """Receive samples without copying them. Returns an RXRegion over
+        the next received samples held by the synchronous interface, which
+        must be released before the next call.
+
+        Usage:
+        >>> with d.sync_rx_acquire() as region:
+        ...     process(region.samples)
+
+        The CF32 formats are not supported; see sc16q11_to_cf32()."""
+        fmt = self._sync_format(Direction.RX)
+        samples = ffi.new("void **")
+        num_samples = ffi.new("unsigned int *")
+        if fmt in (Format.SC16_Q11_META, Format.SC8_Q7_META) and meta is None:
+            meta = Metadata()
+
+        ret = libbladeRF.bladerf_sync_rx_acquire(
+            self.dev[0], samples, num_samples,
+            meta.struct if meta else ffi.NULL, timeout_ms or 0)
+        _check_error(ret)
+        return RXRegion(self.dev[0], samples[0], num_samples[0], fmt, meta)
+
+    def sync_tx_acquire(self, timeout_ms=None):
+        """Obtain space for samples to transmit, without copying them.
+        Returns a TXRegion over the synchronous interface's next buffer,
+        which must be committed before the next call.
+
+        Usage:
+        >>> with d.sync_tx_acquire() as region:
+        ...     region.samples[:] = waveform[:len(region.samples)]"""
+        fmt = self._sync_format(Direction.TX)
+        samples = ffi.new("void **")
+        num_samples = ffi.new("unsigned int *")
+
+        ret = libbladeRF.bladerf_sync_tx_acquire(self.dev[0], samples,
+                                                 num_samples, timeout_ms or 0)
+        _check_error(ret)
+        return TXRegion(self.dev[0], samples[0], num_samples[0], fmt)
+
+    def stream(self, layout, fmt, callback, num_buffers=16, buffer_size=8192,
+               num_transfers=8, timeout_ms=None):
+        """Run an asynchronous stream until callback returns False.
+
+        callback(samples, meta) is called with an array over one of the
+        stream's buffers: for RX, one holding received samples, and for TX,
+        one to fill with the next buffer_size samples to transmit. The
+        array is only valid until the callback returns. meta is a Metadata
+        for the buffer.
+
+        Callbacks run on libbladeRF's stream thread and must keep up with
+        the sample rate. The channels must be enabled via enable_module(),
+        and buffer_size must be a multiple of 1024. Exceptions raised by the
+        callback stop the stream and are raised from here."""
+        is_tx = (layout.value & TX) == TX
+        stream = ffi.new("struct bladerf_stream **")
+        buffers = ffi.new("void ***")
+        arrays = []
+        index = {}
+        state = {'next': 0 if is_tx else num_transfers % num_buffers,
+                 'error': None}
+
+        def _next_buffer():
+            i = state['next']
+            state['next'] = (i + 1) % num_buffers
+            return i
+
+        @ffi.callback("bladerf_stream_cb")
+        def _callback(dev, strm, meta, samples, num_samples, user_data):
+            try:
+                if is_tx:
+                    i = _next_buffer()
+                    keep_going = callback(arrays[i], Metadata(struct=meta))
+                    ret = buffers[0][i]
+                else:
+                    i = index[int(ffi.cast("uintptr_t", samples))]
+                    keep_going = callback(arrays[i], Metadata(struct=meta))
+                    ret = buffers[0][_next_buffer()]
+            except BaseException as e:
+                state['error'] = e
+                keep_going = False
+
+            return ret if keep_going is not False else ffi.NULL
+
+        ret = libbladeRF.bladerf_init_stream(stream, self.dev[0], _callback,
+                                             buffers, num_buffers, fmt.value,
+                                             buffer_size, num_transfers,
+                                             ffi.NULL)
+        _check_error(ret)
+
+        try:
+            for i in range(num_buffers):
+                arrays.append(_wrap_samples(buffers[0][i], buffer_size, fmt))
+                index[int(ffi.cast("uintptr_t", buffers[0][i]))] = i
+
+            if timeout_ms is not None:
+                direction = Direction.TX if is_tx else Direction.RX
+                ret = libbladeRF.bladerf_set_stream_timeout(
+                    self.dev[0], direction.value, timeout_ms)
+                _check_error(ret)
+
+            ret = libbladeRF.bladerf_stream(stream[0], layout.value)
+        finally:
+            arrays.clear()
+            libbladeRF.bladerf_deinit_stream(stream[0])
+
+        if state['error'] is not None:
+            raise state['error']
+        _check_error(ret)
+
     # FPGA/Firmware Loading/Flashing
 
     def load_fpga(self, image_path):
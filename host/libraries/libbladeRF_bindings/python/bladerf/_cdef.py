@@ -8,6 +8,7 @@ header = """
     BLADERF_BACKEND_LINUX,
     BLADERF_BACKEND_LIBUSB,
     BLADERF_BACKEND_CYPRESS,
+    BLADERF_BACKEND_SHM,
     BLADERF_BACKEND_DUMMY = 100
   } bladerf_backend;
   struct bladerf_devinfo
@@ -261,6 +262,11 @@ header = """
         uint16_t nint;
         uint32_t nfrac;
         uint8_t flags;
+        uint8_t xb_gpio;
+        int16_t dc_i;
+        int16_t dc_q;
+        int16_t iq_gain;
+        int16_t iq_phase;
       };
       struct
       {
@@ -276,6 +282,11 @@ header = """
     bladerf_quick_tune *quick_tune);
   int bladerf_cancel_scheduled_retunes(struct bladerf *dev,
     bladerf_channel ch);
+  int bladerf_cancel_scheduled_retune(struct bladerf *dev,
+    bladerf_channel ch, bladerf_timestamp timestamp);
+  int bladerf_replace_scheduled_retune(struct bladerf *dev,
+    bladerf_channel ch, bladerf_timestamp timestamp, bladerf_frequency
+    frequency, struct bladerf_quick_tune *quick_tune);
   int bladerf_get_quick_tune(struct bladerf *dev, bladerf_channel ch,
     struct bladerf_quick_tune *quick_tune);
   typedef int16_t bladerf_correction_value;
@@ -294,15 +305,29 @@ header = """
   {
     BLADERF_FORMAT_SC16_Q11,
     BLADERF_FORMAT_SC16_Q11_META,
-    BLADERF_FORMAT_PACKET_META
+    BLADERF_FORMAT_PACKET_META,
+    BLADERF_FORMAT_CF32,
+    BLADERF_FORMAT_CF32_META,
+    BLADERF_FORMAT_SC8_Q7,
+    BLADERF_FORMAT_SC8_Q7_META
   } bladerf_format;
+  #define BLADERF_META_STATUS_OVERRUN 0x1
+  #define BLADERF_META_STATUS_UNDERRUN 0x2
+  #define BLADERF_META_FLAG_TX_BURST_START 0x1
+  #define BLADERF_META_FLAG_TX_BURST_END 0x2
+  #define BLADERF_META_FLAG_TX_NOW 0x4
+  #define BLADERF_META_FLAG_TX_UPDATE_TIMESTAMP 0x8
+  #define BLADERF_META_FLAG_TX_COALESCE 0x10
+  #define BLADERF_META_FLAG_RX_NOW 0x80000000
+  #define BLADERF_META_FLAG_RX_RESYNC 0x40000000
   struct bladerf_metadata
   {
     bladerf_timestamp timestamp;
     uint32_t flags;
     uint32_t status;
     unsigned int actual_count;
-    uint8_t reserved[32];
+    uint64_t gap;
+    uint8_t reserved[24];
   };
   int bladerf_interleave_stream_buffer(bladerf_channel_layout layout,
     bladerf_format format, unsigned int buffer_size, void *samples);
@@ -321,6 +346,14 @@ header = """
   int bladerf_sync_rx(struct bladerf *dev, void *samples, unsigned int
     num_samples, struct bladerf_metadata *metadata, unsigned int
     timeout_ms);
+  int bladerf_sync_tx_acquire(struct bladerf *dev, void **samples,
+    unsigned int *num_samples, unsigned int timeout_ms);
+  int bladerf_sync_tx_commit(struct bladerf *dev, const void *samples,
+    unsigned int num_samples);
+  int bladerf_sync_rx_acquire(struct bladerf *dev, void **samples,
+    unsigned int *num_samples, struct bladerf_metadata *metadata, unsigned
+    int timeout_ms);
+  int bladerf_sync_rx_release(struct bladerf *dev, const void *samples);
   struct bladerf_stream;
   typedef void *(*bladerf_stream_cb)(struct bladerf *dev, struct
     bladerf_stream *stream, struct bladerf_metadata *meta, void *samples,
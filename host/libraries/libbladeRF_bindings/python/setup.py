@@ -19,7 +19,7 @@ with open(path.join(here, 'README.md'), encoding='utf-8') as f:
 
 setup(
     name='bladerf',
-    version='1.2.0',
+    version='1.3.0',
     description='CFFI-based Python 3 binding to libbladeRF',
     long_description=long_description,
     url='https://github.com/Nuand/bladeRF',
@@ -41,6 +41,9 @@ setup(
     keywords='bladerf sdr cffi radio libbladerf',
     packages=find_packages(exclude=['contrib', 'docs', 'tests']),
     install_requires=['cffi'],
+    extras_require={
+        'numpy': ['numpy'],
+    },
     entry_points={
         'console_scripts': [
             'bladerf-tool=bladerf._tool:main',
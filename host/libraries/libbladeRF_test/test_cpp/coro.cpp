@@ -0,0 +1,200 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This program exercises the libbladeRF_coro.hpp tasks and epoll executor,
+ * without a device. Control operations are stood in for by a thread that
+ * completes them, as the control worker would.
+ */
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <libbladeRF.h>
+#include <libbladeRF_coro.hpp>
+
+using namespace bladeRF;
+
+static coro::task<int> add_one(int v)
+{
+    co_return v + 1;
+}
+
+static coro::task<int> chain(int v)
+{
+    int a = co_await add_one(v);
+    int b = co_await add_one(a);
+    co_return b;
+}
+
+static coro::task<int> interleave(coro::executor &exec,
+                                  std::vector<int> &order,
+                                  int id)
+{
+    for (int i = 0; i < 3; i++) {
+        order.push_back(id);
+        co_await coro::yield(exec);
+    }
+    co_return 0;
+}
+
+static coro::task<int> wait_pipe(coro::executor &exec, int fd, int &result)
+{
+    char c = 0;
+
+    result = co_await coro::readable(exec, fd);
+    if (result == 0 && ::read(fd, &c, 1) != 1) {
+        result = -1;
+    }
+
+    result = (result == 0 && c == 'x') ? 0 : -1;
+    co_return result;
+}
+
+static coro::task<int> fake_ctrl(coro::executor &exec,
+                                 std::vector<std::thread> &workers,
+                                 int status,
+                                 int &result)
+{
+    auto submit = [&workers, status](bladerf_ctrl_cb cb, void *user_data) {
+        if (status == BLADERF_ERR_QUEUE_FULL) {
+            return status;
+        }
+
+        workers.emplace_back([cb, user_data, status] {
+            usleep(1000);
+            cb(nullptr, 1, status, user_data);
+        });
+        return 0;
+    };
+
+    result = co_await coro::ctrl_awaitable<decltype(submit)>(exec, submit);
+    co_return result;
+}
+
+/* Not run, as it requires a device, but checks that the stream and control
+ * awaitables compile */
+[[maybe_unused]] static coro::task<int> relay(coro::executor &exec,
+                                              device &dev,
+                                              rx_stream<sc16q11, true> &rx,
+                                              tx_stream<sc16q11, true> &tx,
+                                              span<sc16q11> buf)
+{
+    struct bladerf_metadata meta = {};
+    bladerf_bandwidth actual;
+    int status;
+
+    status = co_await coro::set_frequency(exec, dev, BLADERF_CHANNEL_RX(0),
+                                          915000000);
+    if (status == 0) {
+        status = co_await coro::set_gain(exec, dev, BLADERF_CHANNEL_RX(0), 30);
+    }
+    if (status == 0) {
+        status = co_await coro::set_bandwidth(exec, dev, BLADERF_CHANNEL_RX(0),
+                                              5000000, &actual);
+    }
+    while (status == 0) {
+        meta.flags = BLADERF_META_FLAG_RX_NOW;
+        status     = co_await coro::read(exec, rx, buf, &meta);
+        if (status == 0) {
+            status = co_await coro::write(exec, tx, span<const sc16q11>(buf),
+                                          &meta);
+        }
+    }
+    co_return status;
+}
+
+int main(int argc, char *argv[])
+{
+    coro::epoll_executor exec;
+    std::vector<int> order;
+    std::vector<std::thread> workers;
+    int pipe_result = -1, ok_result = -1, fail_result = 0, full_result = 0;
+    int fds[2];
+    int failures = 0;
+
+    if (!exec || pipe(fds) != 0) {
+        std::cerr << "Failed to create executor" << std::endl;
+        return 1;
+    }
+
+    coro::task<int> t = chain(1);
+    int chained = -1;
+    coro::spawn([](coro::task<int> &t, int &out) -> coro::task<int> {
+        out = co_await t;
+        co_return 0;
+    }(t, chained));
+
+    if (chained != 3) {
+        std::cerr << "Unexpected chained result " << chained << std::endl;
+        failures++;
+    }
+
+    coro::spawn(interleave(exec, order, 1));
+    coro::spawn(interleave(exec, order, 2));
+    coro::spawn(wait_pipe(exec, fds[0], pipe_result));
+    coro::spawn(fake_ctrl(exec, workers, 0, ok_result));
+    coro::spawn(fake_ctrl(exec, workers, BLADERF_ERR_TIMEOUT, fail_result));
+    coro::spawn(fake_ctrl(exec, workers, BLADERF_ERR_QUEUE_FULL,
+                          full_result));
+
+    std::thread writer([&] {
+        usleep(5000);
+        if (::write(fds[1], "x", 1) != 1) {
+            std::cerr << "Pipe write failed" << std::endl;
+        }
+    });
+
+    if (exec.run() != 0) {
+        std::cerr << "run() failed" << std::endl;
+        failures++;
+    }
+
+    writer.join();
+    for (std::thread &w : workers) {
+        w.join();
+    }
+
+    const std::vector<int> expected = { 1, 2, 1, 2, 1, 2 };
+    if (order != expected) {
+        std::cerr << "Coroutines did not interleave" << std::endl;
+        failures++;
+    }
+
+    if (pipe_result != 0) {
+        std::cerr << "Readiness wait failed" << std::endl;
+        failures++;
+    }
+
+    if (ok_result != 0 || fail_result != BLADERF_ERR_TIMEOUT ||
+        full_result != BLADERF_ERR_QUEUE_FULL) {
+        std::cerr << "Unexpected control results " << ok_result << ", "
+                  << fail_result << ", " << full_result << std::endl;
+        failures++;
+    }
+
+    close(fds[0]);
+    close(fds[1]);
+
+    return failures == 0 ? 0 : 1;
+}
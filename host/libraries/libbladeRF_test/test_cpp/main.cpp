@@ -23,15 +23,106 @@
  * THE SOFTWARE.
  *
  * This program is intended to verify that C++ programs build against
- * libbladeRF without any unintended dependencies.
+ * libbladeRF without any unintended dependencies, and exercises the parts of
+ * the libbladeRF.hpp wrapper that do not require a device.
  */
+#include <array>
 #include <iostream>
+#include <type_traits>
+#include <vector>
 #include <libbladeRF.h>
+#include <libbladeRF.hpp>
+
+using namespace bladeRF;
+
+static_assert(format_v<sc16q11> == BLADERF_FORMAT_SC16_Q11, "");
+static_assert(format_v<sc16q11, true> == BLADERF_FORMAT_SC16_Q11_META, "");
+static_assert(format_v<cf32, true> == BLADERF_FORMAT_CF32_META, "");
+static_assert(format_v<sc8q7> == BLADERF_FORMAT_SC8_Q7, "");
+static_assert(rx_stream<cf32>::format == BLADERF_FORMAT_CF32, "");
+
+/* Handles are movable but not copyable */
+static_assert(!std::is_copy_constructible_v<device>, "");
+static_assert(std::is_nothrow_move_constructible_v<device>, "");
+static_assert(std::is_nothrow_move_assignable_v<device>, "");
+static_assert(!std::is_copy_constructible_v<rx_stream<sc16q11>>, "");
+static_assert(std::is_nothrow_move_constructible_v<tx_stream<cf32, true>>, "");
+static_assert(std::is_nothrow_move_assignable_v<async_stream<sc16q11>>, "");
+
+/* The handles add nothing beyond the C handles they hold */
+static_assert(sizeof(device) == sizeof(struct bladerf *), "");
+
+static int test_convert()
+{
+    const std::array<sc16q11, 4> in = { { { 0, 0 },
+                                          { 1024, -1024 },
+                                          { 2047, -2048 },
+                                          { -1, 1 } } };
+    std::vector<cf32> f(in.size());
+    std::vector<sc16q11> back(in.size());
+    std::array<sc8q7, 2> narrow;
+    const cf32 big[] = { cf32(2.0f, -2.0f), cf32(0.5f, -0.5f) };
+    int failures = 0;
+
+    if (convert<sc16q11, cf32>(in, f) != in.size() ||
+        convert<cf32, sc16q11>(f, back) != in.size()) {
+        failures++;
+    }
+
+    for (size_t k = 0; k < in.size(); k++) {
+        if (back[k].i != in[k].i || back[k].q != in[k].q) {
+            std::cerr << "SC16 Q11 round trip mismatch at " << k << std::endl;
+            failures++;
+        }
+    }
+
+    if (f[1] != cf32(0.5f, -0.5f)) {
+        std::cerr << "Unexpected CF32 scaling" << std::endl;
+        failures++;
+    }
+
+    /* Saturation */
+    convert<cf32, sc8q7>(big, narrow);
+    if (narrow[0].i != 127 || narrow[0].q != -128 || narrow[1].i != 64 ||
+        narrow[1].q != -64) {
+        std::cerr << "Unexpected SC8 Q7 conversion" << std::endl;
+        failures++;
+    }
+
+    return failures;
+}
+
+static int test_handles()
+{
+    device dev;
+    rx_stream<sc16q11> rx;
+    int failures = 0;
+
+    /* Default-constructed and moved-from handles are empty, and may be
+     * destroyed or closed */
+    device other(std::move(dev));
+    rx_stream<sc16q11> rx2(std::move(rx));
+
+    if (dev || other || rx || rx2) {
+        std::cerr << "Unexpected non-empty handle" << std::endl;
+        failures++;
+    }
+
+    other.close();
+    rx2.close();
+
+    return failures;
+}
 
 int main(int argc, char *argv[])
 {
     struct bladerf_version version;
+    int failures;
+
     bladerf_version(&version);
     std::cout << "libbladeRF " << version.describe << std::endl;
-    return 0;
+
+    failures = test_convert() + test_handles();
+
+    return failures == 0 ? 0 : 1;
 }
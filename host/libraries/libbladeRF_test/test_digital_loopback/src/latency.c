@@ -0,0 +1,705 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* TX to RX latency measurement
+ *
+ * A burst carrying a 127-chip pseudo-random preamble is transmitted,
+ * one at a time, and detected in the RX stream: an energy threshold
+ * triggers a capture, and the preamble's correlation peak within it gives
+ * the burst's RX timestamp. The time sync service maps that timestamp to
+ * host time, splitting the round trip into:
+ *
+ *  - submit→air: from bladerf_sync_tx() being called to the burst reaching
+ *    the loopback point
+ *  - air→host: from the loopback point to bladerf_sync_rx() delivering the
+ *    buffer containing the start of the burst
+ */
+
+#include <inttypes.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <pthread.h>
+
+#include "conversions.h"
+#include "host_config.h"
+#include "latency.h"
+#include "log.h"
+
+#define PREAMBLE_LEN    127
+#define BURST_LEN       256
+#define AMPLITUDE       1500
+
+/* Samples captured ahead of the trigger, and lags searched for the
+ * correlation peak */
+#define PRE_TRIGGER     32
+#define SEARCH_LEN      64
+#define CAPTURE_LEN     (PRE_TRIGGER + SEARCH_LEN + PREAMBLE_LEN)
+
+/* Minimum normalized correlation, squared, of a detected preamble */
+#define MIN_CORR_SQ     0.25
+
+#define SYNC_TIMEOUT_MS 1000
+#define DETECT_TIMEOUT_MS 1000
+#define SETTLE_MS       100
+
+struct detector {
+    unsigned int threshold;
+    const int8_t *chips;
+
+    /* Timestamp of the next sample expected */
+    uint64_t next_ts;
+    bool synced;
+
+    /* Most recent samples, ahead of a trigger */
+    int16_t history[2 * PRE_TRIGGER];
+    unsigned int hist_head;
+    unsigned int hist_count;
+
+    bool capturing;
+    int16_t capture[2 * CAPTURE_LEN];
+    unsigned int cap_len;
+    uint64_t cap_ts;
+};
+
+struct rx_ctx {
+    struct bladerf *dev;
+    unsigned int samples_per_call;
+    int16_t *buf;
+
+    pthread_mutex_t lock;
+    bool stop;
+    int status;
+
+    /* Set by the TX side before each burst. Cleared upon detection. */
+    bool armed;
+    bool detected;
+    uint64_t det_ts;
+    uint64_t det_host_ns;
+
+    uint64_t overruns;
+    struct detector det;
+};
+
+/* Latencies, in ns, of each detected burst */
+struct latency_samples {
+    uint64_t *submit_to_air;
+    uint64_t *air_to_host;
+    uint64_t *round_trip;
+    unsigned int count;
+    unsigned int missed;
+};
+
+/******************************************************************************
+ * Burst generation and detection
+ ******************************************************************************/
+
+/* Maximal-length sequence from x^7 + x^6 + 1 */
+static void gen_preamble(int8_t chips[PREAMBLE_LEN])
+{
+    unsigned int lfsr = 0x7f;
+    unsigned int i, bit;
+
+    for (i = 0; i < PREAMBLE_LEN; i++) {
+        chips[i] = (lfsr & 1) ? 1 : -1;
+        bit      = ((lfsr >> 6) ^ (lfsr >> 5)) & 1;
+        lfsr     = ((lfsr << 1) | bit) & 0x7f;
+    }
+}
+
+static void gen_burst(const int8_t chips[PREAMBLE_LEN], int16_t *burst)
+{
+    unsigned int i;
+
+    memset(burst, 0, 2 * BURST_LEN * sizeof(burst[0]));
+
+    for (i = 0; i < PREAMBLE_LEN; i++) {
+        burst[2 * i]     = chips[i] * AMPLITUDE;
+        burst[2 * i + 1] = chips[i] * AMPLITUDE;
+    }
+}
+
+/* Find the preamble's correlation peak in a completed capture. The chips
+ * are applied to both I and Q, so the magnitude of the complex correlation
+ * is independent of any phase rotation over an RF loopback. */
+static bool find_peak(const struct detector *d, unsigned int *lag)
+{
+    double best = 0.0, best_energy = 0.0;
+    unsigned int l, k;
+
+    for (l = 0; l + PREAMBLE_LEN <= d->cap_len; l++) {
+        const int16_t *s = &d->capture[2 * l];
+        double acc_i = 0.0, acc_q = 0.0, energy = 0.0, mag_sq;
+
+        for (k = 0; k < PREAMBLE_LEN; k++) {
+            acc_i += d->chips[k] * s[2 * k];
+            acc_q += d->chips[k] * s[2 * k + 1];
+            energy += (double)s[2 * k] * s[2 * k] +
+                      (double)s[2 * k + 1] * s[2 * k + 1];
+        }
+
+        mag_sq = acc_i * acc_i + acc_q * acc_q;
+        if (mag_sq > best) {
+            best        = mag_sq;
+            best_energy = energy;
+            *lag        = l;
+        }
+    }
+
+    return best_energy > 0.0 &&
+           best >= MIN_CORR_SQ * best_energy * PREAMBLE_LEN;
+}
+
+static void detector_reset(struct detector *d)
+{
+    d->synced     = false;
+    d->hist_count = 0;
+    d->capturing  = false;
+}
+
+/* Feed a buffer of samples to the detector. Returns true once the burst's
+ * first sample has been found, with its timestamp in *burst_ts. */
+static bool detector_process(struct detector *d, bool armed,
+                             const int16_t *samples, unsigned int n,
+                             uint64_t ts, uint64_t *burst_ts)
+{
+    unsigned int i, lag;
+    bool found = false;
+
+    if (d->synced && ts != d->next_ts) {
+        log_debug("RX discontinuity: expected %" PRIu64 ", got %" PRIu64
+                  "\n", d->next_ts, ts);
+        detector_reset(d);
+    }
+
+    d->synced  = true;
+    d->next_ts = ts + n;
+
+    for (i = 0; i < n; i++) {
+        const int16_t si = samples[2 * i];
+        const int16_t sq = samples[2 * i + 1];
+
+        if (d->capturing) {
+            d->capture[2 * d->cap_len]     = si;
+            d->capture[2 * d->cap_len + 1] = sq;
+
+            if (++d->cap_len == CAPTURE_LEN) {
+                d->capturing = false;
+
+                if (find_peak(d, &lag)) {
+                    *burst_ts = d->cap_ts + lag;
+                    found     = true;
+                } else {
+                    log_debug("Trigger at %" PRIu64 " without a preamble\n",
+                              d->cap_ts + PRE_TRIGGER);
+                }
+            }
+        } else if (armed && !found &&
+                   (unsigned int)(abs(si) + abs(sq)) > d->threshold) {
+            unsigned int k, idx;
+
+            /* Start the capture with the samples preceding the trigger */
+            d->cap_len = 0;
+            for (k = 0; k < d->hist_count; k++) {
+                idx = (d->hist_head + PRE_TRIGGER - d->hist_count + k) %
+                      PRE_TRIGGER;
+                d->capture[2 * d->cap_len]     = d->history[2 * idx];
+                d->capture[2 * d->cap_len + 1] = d->history[2 * idx + 1];
+                d->cap_len++;
+            }
+
+            d->cap_ts = ts + i - d->hist_count;
+            d->capture[2 * d->cap_len]     = si;
+            d->capture[2 * d->cap_len + 1] = sq;
+            d->cap_len++;
+            d->capturing = true;
+        }
+
+        d->history[2 * d->hist_head]     = si;
+        d->history[2 * d->hist_head + 1] = sq;
+        d->hist_head = (d->hist_head + 1) % PRE_TRIGGER;
+        if (d->hist_count < PRE_TRIGGER) {
+            d->hist_count++;
+        }
+    }
+
+    return found;
+}
+
+/******************************************************************************
+ * Streaming
+ ******************************************************************************/
+
+static void *rx_task(void *arg)
+{
+    struct rx_ctx *rx = arg;
+    struct bladerf_metadata meta;
+    uint64_t host_ns, burst_ts = 0;
+    bool armed, found;
+    int status = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&rx->lock);
+        if (rx->stop) {
+            pthread_mutex_unlock(&rx->lock);
+            break;
+        }
+        pthread_mutex_unlock(&rx->lock);
+
+        memset(&meta, 0, sizeof(meta));
+        meta.flags = BLADERF_META_FLAG_RX_NOW;
+
+        status = bladerf_sync_rx(rx->dev, rx->buf, rx->samples_per_call,
+                                 &meta, SYNC_TIMEOUT_MS);
+        host_ns = bladerf_time_sync_host_ns();
+
+        if (status != 0) {
+            log_error("RX failed: %s\n", bladerf_strerror(status));
+            break;
+        }
+
+        pthread_mutex_lock(&rx->lock);
+
+        if (meta.status & BLADERF_META_STATUS_OVERRUN) {
+            rx->overruns++;
+        }
+
+        armed = rx->armed;
+        found = detector_process(&rx->det, armed, rx->buf, meta.actual_count,
+                                 meta.timestamp, &burst_ts);
+
+        if (armed && found) {
+            rx->armed       = false;
+            rx->detected    = true;
+            rx->det_ts      = burst_ts;
+            rx->det_host_ns = host_ns;
+        }
+
+        pthread_mutex_unlock(&rx->lock);
+    }
+
+    pthread_mutex_lock(&rx->lock);
+    rx->status = status;
+    pthread_mutex_unlock(&rx->lock);
+
+    return NULL;
+}
+
+static int send_burst(struct bladerf *dev, const struct latency_config *cfg,
+                      const int16_t *burst, uint64_t *submit_ns)
+{
+    struct bladerf_metadata meta;
+    int status;
+
+    memset(&meta, 0, sizeof(meta));
+    meta.flags = BLADERF_META_FLAG_TX_BURST_START |
+                 BLADERF_META_FLAG_TX_BURST_END;
+
+    *submit_ns = bladerf_time_sync_host_ns();
+
+    if (cfg->lead_us == 0) {
+        meta.flags |= BLADERF_META_FLAG_TX_NOW;
+    } else {
+        status = bladerf_time_sync_host_to_device(
+            dev, BLADERF_TX, *submit_ns + (uint64_t)cfg->lead_us * 1000,
+            &meta.timestamp);
+        if (status != 0) {
+            log_error("Failed to schedule burst: %s\n",
+                      bladerf_strerror(status));
+            return status;
+        }
+    }
+
+    status = bladerf_sync_tx(dev, burst, BURST_LEN, &meta, SYNC_TIMEOUT_MS);
+    if (status != 0) {
+        log_error("TX failed: %s\n", bladerf_strerror(status));
+    }
+
+    return status;
+}
+
+/* Wait for the RX side to detect the burst, or give up on it */
+static int wait_for_burst(struct rx_ctx *rx, uint64_t *ts, uint64_t *host_ns,
+                          bool *detected)
+{
+    unsigned int waited_us = 0;
+    int status;
+
+    for (;;) {
+        pthread_mutex_lock(&rx->lock);
+        *detected = rx->detected;
+        *ts       = rx->det_ts;
+        *host_ns  = rx->det_host_ns;
+        status    = rx->status;
+
+        if (!*detected && (status != 0 ||
+                           waited_us >= DETECT_TIMEOUT_MS * 1000)) {
+            rx->armed = false;
+        }
+        pthread_mutex_unlock(&rx->lock);
+
+        if (*detected || status != 0 ||
+            waited_us >= DETECT_TIMEOUT_MS * 1000) {
+            return status;
+        }
+
+        usleep(100);
+        waited_us += 100;
+    }
+}
+
+/******************************************************************************
+ * Reporting
+ ******************************************************************************/
+
+static int cmp_u64(const void *a, const void *b)
+{
+    const uint64_t x = *(const uint64_t *)a;
+    const uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile, in microseconds */
+static double pct_us(const uint64_t *sorted, unsigned int n, unsigned int pct)
+{
+    unsigned int rank = (n * pct + 99) / 100;
+
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    return sorted[rank - 1] / 1000.0;
+}
+
+static void print_dist(const char *name, uint64_t *v, unsigned int n)
+{
+    uint64_t sum = 0;
+    unsigned int i;
+
+    if (n == 0) {
+        printf("    %-12s  no bursts detected\n", name);
+        return;
+    }
+
+    qsort(v, n, sizeof(v[0]), cmp_u64);
+
+    for (i = 0; i < n; i++) {
+        sum += v[i];
+    }
+
+    printf("    %-12s  min %9.1f  mean %9.1f  p50 %9.1f  p90 %9.1f  "
+           "p99 %9.1f  max %9.1f us\n",
+           name, v[0] / 1000.0, (double)sum / n / 1000.0, pct_us(v, n, 50),
+           pct_us(v, n, 90), pct_us(v, n, 99), v[n - 1] / 1000.0);
+}
+
+static void print_summary(const struct latency_config *cfg,
+                          unsigned int num_buffers,
+                          unsigned int buffer_size,
+                          unsigned int num_transfers,
+                          struct latency_samples *s,
+                          uint64_t overruns)
+{
+    printf("buffers %u, buffer size %u, transfers %u: %u of %u bursts "
+           "detected, %" PRIu64 " RX overruns\n",
+           num_buffers, buffer_size, num_transfers, s->count,
+           s->count + s->missed, overruns);
+
+    if (!cfg->fw_loopback) {
+        print_dist("submit->air", s->submit_to_air, s->count);
+        print_dist("air->host", s->air_to_host, s->count);
+    }
+
+    print_dist("round trip", s->round_trip, s->count);
+}
+
+/******************************************************************************
+ * Measurement
+ ******************************************************************************/
+
+static int enable_time_sync(struct bladerf *dev, bladerf_direction dir)
+{
+    struct bladerf_time_sync_config ts_cfg;
+    int status;
+
+    memset(&ts_cfg, 0, sizeof(ts_cfg));
+    ts_cfg.interval_ms = 100;
+
+    status = bladerf_time_sync_configure(dev, dir, &ts_cfg);
+    if (status != 0) {
+        log_error("Failed to enable %s time sync: %s\n",
+                  dir == BLADERF_RX ? "RX" : "TX", bladerf_strerror(status));
+    }
+
+    return status;
+}
+
+static int run_config(struct bladerf *dev, const struct latency_config *cfg,
+                      const int16_t *burst, const int8_t *chips,
+                      unsigned int num_buffers, unsigned int buffer_size,
+                      unsigned int num_transfers)
+{
+    struct rx_ctx rx;
+    struct latency_samples s;
+    pthread_t rx_thread;
+    bool thread_started = false, detected;
+    uint64_t submit_ns, burst_ts, host_ns, air_ns;
+    unsigned int b;
+    int status;
+
+    memset(&rx, 0, sizeof(rx));
+    memset(&s, 0, sizeof(s));
+
+    rx.dev              = dev;
+    rx.samples_per_call = buffer_size;
+    rx.det.threshold    = cfg->threshold;
+    rx.det.chips        = chips;
+    pthread_mutex_init(&rx.lock, NULL);
+
+    rx.buf          = malloc(2 * buffer_size * sizeof(rx.buf[0]));
+    s.submit_to_air = calloc(cfg->bursts, sizeof(uint64_t));
+    s.air_to_host   = calloc(cfg->bursts, sizeof(uint64_t));
+    s.round_trip    = calloc(cfg->bursts, sizeof(uint64_t));
+
+    if (rx.buf == NULL || s.submit_to_air == NULL || s.air_to_host == NULL ||
+        s.round_trip == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto out;
+    }
+
+    status = bladerf_sync_config(dev, BLADERF_RX_X1,
+                                 BLADERF_FORMAT_SC16_Q11_META, num_buffers,
+                                 buffer_size, num_transfers, SYNC_TIMEOUT_MS);
+    if (status == 0) {
+        status = bladerf_sync_config(dev, BLADERF_TX_X1,
+                                     BLADERF_FORMAT_SC16_Q11_META,
+                                     num_buffers, buffer_size, num_transfers,
+                                     SYNC_TIMEOUT_MS);
+    }
+
+    if (status != 0) {
+        log_error("Failed to configure sync interfaces: %s\n",
+                  bladerf_strerror(status));
+        goto out;
+    }
+
+    status = bladerf_enable_module(dev, BLADERF_CHANNEL_RX(0), true);
+    if (status == 0) {
+        status = bladerf_enable_module(dev, BLADERF_CHANNEL_TX(0), true);
+    }
+
+    if (status != 0) {
+        log_error("Failed to enable channels: %s\n", bladerf_strerror(status));
+        goto out;
+    }
+
+    /* RX timestamps are only mapped to host time to split the round trip,
+     * which is not possible with the firmware loopback */
+    if (!cfg->fw_loopback) {
+        status = enable_time_sync(dev, BLADERF_RX);
+        if (status != 0) {
+            goto out;
+        }
+    }
+
+    if (cfg->lead_us != 0) {
+        status = enable_time_sync(dev, BLADERF_TX);
+        if (status != 0) {
+            goto out;
+        }
+    }
+
+    status = pthread_create(&rx_thread, NULL, rx_task, &rx);
+    if (status != 0) {
+        log_error("pthread_create(RX): %s\n", strerror(status));
+        status = BLADERF_ERR_UNEXPECTED;
+        goto out;
+    }
+
+    thread_started = true;
+    usleep(SETTLE_MS * 1000);
+
+    for (b = 0; b < cfg->bursts; b++) {
+        usleep(cfg->period_ms * 1000);
+
+        pthread_mutex_lock(&rx.lock);
+        rx.armed    = true;
+        rx.detected = false;
+        pthread_mutex_unlock(&rx.lock);
+
+        status = send_burst(dev, cfg, burst, &submit_ns);
+        if (status != 0) {
+            break;
+        }
+
+        status = wait_for_burst(&rx, &burst_ts, &host_ns, &detected);
+        if (status != 0) {
+            break;
+        }
+
+        if (!detected) {
+            log_debug("Burst %u not detected\n", b);
+            s.missed++;
+            continue;
+        }
+
+        air_ns = 0;
+        if (!cfg->fw_loopback) {
+            status = bladerf_time_sync_device_to_host(dev, BLADERF_RX,
+                                                      burst_ts, &air_ns);
+            if (status != 0) {
+                log_error("Failed to map RX timestamp: %s\n",
+                          bladerf_strerror(status));
+                break;
+            }
+
+            /* Guard against mapping error placing the burst outside the
+             * interval it was observed in */
+            if (air_ns < submit_ns) {
+                air_ns = submit_ns;
+            } else if (air_ns > host_ns) {
+                air_ns = host_ns;
+            }
+        }
+
+        s.submit_to_air[s.count] = air_ns - submit_ns;
+        s.air_to_host[s.count]   = host_ns - air_ns;
+        s.round_trip[s.count]    = host_ns - submit_ns;
+
+        if (cfg->csv != NULL) {
+            fprintf(cfg->csv, "%u,%u,%u,%u,%" PRIu64 ",%.3f,%.3f,%.3f\n",
+                    num_buffers, buffer_size, num_transfers, b, burst_ts,
+                    s.submit_to_air[s.count] / 1000.0,
+                    s.air_to_host[s.count] / 1000.0,
+                    s.round_trip[s.count] / 1000.0);
+        }
+
+        s.count++;
+    }
+
+out:
+    if (thread_started) {
+        pthread_mutex_lock(&rx.lock);
+        rx.stop = true;
+        pthread_mutex_unlock(&rx.lock);
+        pthread_join(rx_thread, NULL);
+    }
+
+    bladerf_time_sync_configure(dev, BLADERF_RX, NULL);
+    bladerf_time_sync_configure(dev, BLADERF_TX, NULL);
+
+    bladerf_enable_module(dev, BLADERF_CHANNEL_TX(0), false);
+    bladerf_enable_module(dev, BLADERF_CHANNEL_RX(0), false);
+
+    if (status == 0) {
+        print_summary(cfg, num_buffers, buffer_size, num_transfers, &s,
+                      rx.overruns);
+    }
+
+    pthread_mutex_destroy(&rx.lock);
+    free(rx.buf);
+    free(s.submit_to_air);
+    free(s.air_to_host);
+    free(s.round_trip);
+
+    return status;
+}
+
+int latency_parse_list(const char *str, unsigned int min,
+                       struct latency_list *list)
+{
+    char token[16];
+    const char *comma;
+    size_t len;
+    bool ok = true;
+
+    list->count = 0;
+
+    while (ok) {
+        comma = strchr(str, ',');
+        len   = (comma != NULL) ? (size_t)(comma - str) : strlen(str);
+
+        if (list->count >= LATENCY_MAX_CONFIGS || len == 0 ||
+            len >= sizeof(token)) {
+            return -1;
+        }
+
+        memcpy(token, str, len);
+        token[len] = '\0';
+
+        list->values[list->count++] = str2uint(token, min, UINT_MAX, &ok);
+
+        if (comma == NULL) {
+            break;
+        }
+
+        str = comma + 1;
+    }
+
+    return ok ? 0 : -1;
+}
+
+int latency_run(struct bladerf *dev, const struct latency_config *cfg)
+{
+    int8_t chips[PREAMBLE_LEN];
+    int16_t burst[2 * BURST_LEN];
+    unsigned int n, b, x;
+    int status = 0;
+
+    gen_preamble(chips);
+    gen_burst(chips, burst);
+
+    if (cfg->csv != NULL) {
+        fprintf(cfg->csv, "num_buffers,buffer_size,num_transfers,burst,"
+                          "rx_timestamp,submit_to_air_us,air_to_host_us,"
+                          "round_trip_us\n");
+    }
+
+    for (n = 0; n < cfg->num_buffers.count; n++) {
+    for (b = 0; b < cfg->buffer_sizes.count; b++) {
+    for (x = 0; x < cfg->num_transfers.count; x++) {
+        const unsigned int num_buffers   = cfg->num_buffers.values[n];
+        const unsigned int buffer_size   = cfg->buffer_sizes.values[b];
+        const unsigned int num_transfers = cfg->num_transfers.values[x];
+
+        if (num_transfers >= num_buffers || (buffer_size % 1024) != 0) {
+            log_info("Skipping buffers %u, buffer size %u, transfers %u\n",
+                     num_buffers, buffer_size, num_transfers);
+            continue;
+        }
+
+        status = run_config(dev, cfg, burst, chips, num_buffers, buffer_size,
+                            num_transfers);
+        if (status != 0) {
+            return status;
+        }
+    }
+    }
+    }
+
+    return status;
+}
@@ -0,0 +1,77 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LATENCY_H_
+#define LATENCY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <libbladeRF.h>
+
+#define LATENCY_MAX_CONFIGS 8
+
+/* Stream buffer parameter values to sweep */
+struct latency_list {
+    unsigned int values[LATENCY_MAX_CONFIGS];
+    unsigned int count;
+};
+
+struct latency_config {
+    /* Samples do not pass through the FPGA, whose timestamps are therefore
+     * not meaningful. Only the round trip is reported. */
+    bool fw_loopback;
+
+    unsigned int bursts;    /* Bursts per buffer configuration */
+    unsigned int period_ms; /* Interval between bursts */
+    unsigned int lead_us;   /* TX schedule lead, or 0 to send immediately */
+    unsigned int threshold; /* Detection threshold, |I| + |Q| */
+
+    struct latency_list num_buffers;
+    struct latency_list buffer_sizes;
+    struct latency_list num_transfers;
+
+    FILE *csv; /* Per-burst measurements, or NULL */
+};
+
+/**
+ * Parse a comma-separated list of values, each at least `min`
+ *
+ * @return 0 on success, -1 on failure
+ */
+int latency_parse_list(const char *str, unsigned int min,
+                       struct latency_list *list);
+
+/**
+ * Measure TX to RX latency over the configured loopback, for each buffer
+ * configuration. The RX and TX channels must already be configured, and the
+ * loopback selected.
+ *
+ * @return 0 on success, or a libbladeRF error code
+ */
+int latency_run(struct bladerf *dev, const struct latency_config *cfg);
+
+#endif
@@ -23,6 +23,7 @@
  * THE SOFTWARE.
  */
 
+#include <errno.h>
 #include <getopt.h>
 #include <inttypes.h>
 #include <signal.h>
@@ -32,6 +33,7 @@
 #include <pthread.h>
 
 #include "conversions.h"
+#include "latency.h"
 #include "log.h"
 #include "test_common.h"
 #include <libbladeRF.h>
@@ -41,7 +43,7 @@
  ******************************************************************************/
 
 enum data_mode { DATA_CONSTANT, DATA_COUNTING, DATA_RANDOM };
-enum loopback_mode { LOOPBACK_FW, LOOPBACK_FPGA, LOOPBACK_RFIC };
+enum loopback_mode { LOOPBACK_FW, LOOPBACK_FPGA, LOOPBACK_RFIC, LOOPBACK_RF };
 
 struct tx_buffer_state {
     void **buffers;
@@ -89,6 +91,15 @@ static struct option const long_options[] = {
     { "help", no_argument, NULL, 'h' },
     { "verbosity", required_argument, 0, 1 },
     { "lib-verbosity", required_argument, 0, 2 },
+    { "latency", no_argument, NULL, 'L' },
+    { "bursts", required_argument, 0, 3 },
+    { "period", required_argument, 0, 4 },
+    { "lead", required_argument, 0, 5 },
+    { "threshold", required_argument, 0, 6 },
+    { "buffers", required_argument, 0, 7 },
+    { "buffer-sizes", required_argument, 0, 8 },
+    { "xfers", required_argument, 0, 9 },
+    { "csv", required_argument, 0, 10 },
     { NULL, 0, NULL, 0 },
 };
 
@@ -423,6 +434,99 @@ int configure_module(struct bladerf *dev,
     return 0;
 }
 
+int set_loopback(struct bladerf *dev, enum loopback_mode mode)
+{
+    int status;
+
+    // Default: disable loopback mode
+    status = bladerf_set_loopback(dev, BLADERF_LB_NONE);
+    if (status < 0) {
+        log_error("bladerf_set_loopback(): %s\n", bladerf_strerror(status));
+        return status;
+    }
+
+    // Default: baseband mux
+    status = bladerf_set_rx_mux(dev, BLADERF_RX_MUX_BASEBAND);
+    if (status < 0) {
+        log_error("bladerf_set_rx_mux(): %s\n", bladerf_strerror(status));
+        return status;
+    }
+
+    switch (mode) {
+        case LOOPBACK_FW:
+            status = bladerf_set_loopback(dev, BLADERF_LB_FIRMWARE);
+            if (status < 0) {
+                log_error("bladerf_set_loopback(): %s\n",
+                          bladerf_strerror(status));
+            }
+            break;
+
+        case LOOPBACK_FPGA:
+            status = bladerf_set_rx_mux(dev, BLADERF_RX_MUX_DIGITAL_LOOPBACK);
+            if (status < 0) {
+                log_error("bladerf_set_rx_mux(): %s\n",
+                          bladerf_strerror(status));
+            }
+            break;
+
+        case LOOPBACK_RFIC:
+            status = bladerf_set_loopback(dev, BLADERF_LB_RFIC_BIST);
+            if (status < 0) {
+                log_error("bladerf_set_loopback(): %s\n",
+                          bladerf_strerror(status));
+            }
+            break;
+
+        case LOOPBACK_RF:
+            // External cable from TX to RX
+            break;
+    }
+
+    return status;
+}
+
+/* Measure TX to RX latency, in place of the data integrity test */
+int run_latency(struct bladerf *dev,
+                uint32_t sample_rate,
+                enum loopback_mode lb_mode,
+                struct latency_config *cfg,
+                const char *csv_file)
+{
+    int status;
+
+    status = configure_module(dev, BLADERF_RX, sample_rate);
+    if (status == 0) {
+        status = configure_module(dev, BLADERF_TX, sample_rate);
+    }
+
+    if (status == 0) {
+        status = set_loopback(dev, lb_mode);
+    }
+
+    if (status != 0) {
+        return status;
+    }
+
+    cfg->fw_loopback = (lb_mode == LOOPBACK_FW);
+    cfg->csv         = NULL;
+
+    if (csv_file != NULL) {
+        cfg->csv = fopen(csv_file, "w");
+        if (cfg->csv == NULL) {
+            log_error("Failed to open %s: %s\n", csv_file, strerror(errno));
+            return BLADERF_ERR_IO;
+        }
+    }
+
+    status = latency_run(dev, cfg);
+
+    if (cfg->csv != NULL) {
+        fclose(cfg->csv);
+    }
+
+    return status;
+}
+
 int main(int argc, char *argv[])
 {
     uint32_t sample_rate                  = 7680000;
@@ -430,6 +534,9 @@ int main(int argc, char *argv[])
     enum data_mode test_data_mode         = DATA_CONSTANT;
     char *devstr                          = NULL;
     size_t max_count                      = 0;
+    bool latency_mode                     = false;
+    char const *csv_file                  = NULL;
+    struct latency_config latency_cfg;
 
     struct bladerf *dev;
     struct rx_buffer_state rx_state;
@@ -443,11 +550,22 @@ int main(int argc, char *argv[])
     log_set_verbosity(BLADERF_LOG_LEVEL_INFO);
     bladerf_log_set_verbosity(BLADERF_LOG_LEVEL_INFO);
 
+    memset(&latency_cfg, 0, sizeof(latency_cfg));
+    latency_cfg.bursts                  = 100;
+    latency_cfg.period_ms               = 20;
+    latency_cfg.threshold               = 500;
+    latency_cfg.num_buffers.values[0]   = 16;
+    latency_cfg.num_buffers.count       = 1;
+    latency_cfg.buffer_sizes.values[0]  = 8192;
+    latency_cfg.buffer_sizes.count      = 1;
+    latency_cfg.num_transfers.values[0] = 8;
+    latency_cfg.num_transfers.count     = 1;
+
     int opt     = 0;
     int opt_ind = 0;
 
     while (opt != -1) {
-        opt = getopt_long(argc, argv, "d:l:c:D:s:h", long_options, &opt_ind);
+        opt = getopt_long(argc, argv, "d:l:c:D:s:Lh", long_options, &opt_ind);
 
         switch (opt) {
             case 'd':
@@ -461,6 +579,8 @@ int main(int argc, char *argv[])
                     test_loopback_mode = LOOPBACK_FPGA;
                 } else if (strcmp(optarg, "rfic") == 0) {
                     test_loopback_mode = LOOPBACK_RFIC;
+                } else if (strcmp(optarg, "rf") == 0) {
+                    test_loopback_mode = LOOPBACK_RF;
                 } else {
                     log_error("Unknown loopback mode: %s\n", optarg);
                     return -1;
@@ -519,6 +639,69 @@ int main(int argc, char *argv[])
                 }
                 break;
 
+            case 'L':
+                latency_mode = true;
+                break;
+
+            case 3:
+                latency_cfg.bursts = str2uint(optarg, 1, UINT32_MAX, &ok);
+                if (!ok) {
+                    log_error("Invalid burst count: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 4:
+                latency_cfg.period_ms = str2uint(optarg, 1, 10000, &ok);
+                if (!ok) {
+                    log_error("Invalid burst period: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 5:
+                latency_cfg.lead_us = str2uint(optarg, 0, 1000000, &ok);
+                if (!ok) {
+                    log_error("Invalid lead time: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 6:
+                latency_cfg.threshold = str2uint(optarg, 1, 4094, &ok);
+                if (!ok) {
+                    log_error("Invalid threshold: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 7:
+                if (latency_parse_list(optarg, 2, &latency_cfg.num_buffers)) {
+                    log_error("Invalid buffer counts: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 8:
+                if (latency_parse_list(optarg, 1024,
+                                       &latency_cfg.buffer_sizes)) {
+                    log_error("Invalid buffer sizes: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 9:
+                if (latency_parse_list(optarg, 1,
+                                       &latency_cfg.num_transfers)) {
+                    log_error("Invalid transfer counts: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 10:
+                csv_file = optarg;
+                break;
+
             case 'h':
                 printf("Usage: %s [options]\n", argv[0]);
                 printf("  -d, --device <str>       Specify device to open.\n");
@@ -526,6 +709,8 @@ int main(int argc, char *argv[])
                 printf("                             fw (default)\n");
                 printf("                             fpga\n");
                 printf("                             rfic\n");
+                printf("                             rf (external cable, "
+                       "latency only)\n");
                 printf("  -s, --samplerate <sps>   Specify sample rate.\n");
                 printf("  -c, --count <num>        Specify number of samples "
                        "to test (0 = unlimited).\n");
@@ -538,6 +723,31 @@ int main(int argc, char *argv[])
                 printf("  --lib-verbosity <level>  Set libbladeRF "
                        "verbosity (Default: info)\n");
                 printf("  -h, --help               Show this text.\n");
+                printf("\n");
+                printf("Latency measurement:\n");
+                printf("  -L, --latency            Measure TX to RX latency "
+                       "instead.\n");
+                printf("  --bursts <num>           Bursts per configuration "
+                       "(Default: 100)\n");
+                printf("  --period <ms>            Time between bursts "
+                       "(Default: 20)\n");
+                printf("  --lead <us>              Schedule bursts this far "
+                       "ahead, or 0\n");
+                printf("                           to send them immediately "
+                       "(Default: 0)\n");
+                printf("  --threshold <value>      Detection threshold, "
+                       "|I| + |Q| (Default: 500)\n");
+                printf("  --buffers <list>         Comma-separated buffer "
+                       "counts (Default: 16)\n");
+                printf("  --buffer-sizes <list>    Comma-separated buffer "
+                       "sizes (Default: 8192)\n");
+                printf("  --xfers <list>           Comma-separated transfer "
+                       "counts (Default: 8)\n");
+                printf("  --csv <file>             Write per-burst results "
+                       "to a CSV file.\n");
+                printf("\n");
+                printf("  A summary is printed for each combination of the "
+                       "lists.\n");
                 return 0;
 
             default:
@@ -545,12 +755,24 @@ int main(int argc, char *argv[])
         }
     }
 
+    if (test_loopback_mode == LOOPBACK_RF && !latency_mode) {
+        log_error("The rf loopback mode is only supported with --latency\n");
+        return -1;
+    }
+
     status = bladerf_open(&dev, devstr);
     if (status < 0) {
         log_error("bladerf_open(): %s\n", bladerf_strerror(status));
         return 1;
     }
 
+    if (latency_mode) {
+        status = run_latency(dev, sample_rate, test_loopback_mode,
+                             &latency_cfg, csv_file);
+        bladerf_close(dev);
+        return (status == 0) ? 0 : 1;
+    }
+
     rx_state.idx       = 0;
     rx_state.num       = NUM_TRANSFERS;
     rx_state.i_count   = 0;
@@ -602,54 +824,12 @@ int main(int argc, char *argv[])
         return -1;
     }
 
-    // Default: disable loopback mode
-    status = bladerf_set_loopback(dev, BLADERF_LB_NONE);
-    if (status < 0) {
-        log_error("bladerf_set_loopback(): %s\n", bladerf_strerror(status));
-        bladerf_close(dev);
-        return -1;
-    }
-
-    // Default: baseband mux
-    status = bladerf_set_rx_mux(dev, BLADERF_RX_MUX_BASEBAND);
+    status = set_loopback(dev, test_loopback_mode);
     if (status < 0) {
-        log_error("bladerf_set_rx_mux(): %s\n", bladerf_strerror(status));
         bladerf_close(dev);
         return -1;
     }
 
-    switch (test_loopback_mode) {
-        case LOOPBACK_FW:
-            status = bladerf_set_loopback(dev, BLADERF_LB_FIRMWARE);
-            if (status < 0) {
-                log_error("bladerf_set_loopback(): %s\n",
-                          bladerf_strerror(status));
-                bladerf_close(dev);
-                return -1;
-            }
-            break;
-
-        case LOOPBACK_FPGA:
-            status = bladerf_set_rx_mux(dev, BLADERF_RX_MUX_DIGITAL_LOOPBACK);
-            if (status < 0) {
-                log_error("bladerf_set_rx_mux(): %s\n",
-                          bladerf_strerror(status));
-                bladerf_close(dev);
-                return -1;
-            }
-            break;
-
-        case LOOPBACK_RFIC:
-            status = bladerf_set_loopback(dev, BLADERF_LB_RFIC_BIST);
-            if (status < 0) {
-                log_error("bladerf_set_loopback(): %s\n",
-                          bladerf_strerror(status));
-                bladerf_close(dev);
-                return -1;
-            }
-            break;
-    }
-
     if (signal(SIGINT, handler) == SIG_ERR) {
         perror("signal()");
         return -1;
@@ -28,6 +28,7 @@
  */
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <getopt.h>
 #include <inttypes.h>
 #include <libbladeRF.h>
@@ -38,10 +39,19 @@
 
 #define TEST_OPTIONS_STR    DEVCFG_OPTIONS_BASE"i:S:"
 
+/* Sweep mode parameters */
+#define SWEEP_START         70000000
+#define SWEEP_STOP          6000000000
+#define SWEEP_STEP          50000000
+#define SWEEP_SETTLE_US     100
+#define SWEEP_DEFAULT_COUNT 10
+
 struct app_params {
     struct devcfg dev_config;
     bool rx;
     bool tx;
+    bool sweep;
+    bool iterations_set;
     uint64_t iterations;
     uint64_t randval_seed;
     uint64_t randval_state;
@@ -50,6 +60,7 @@ struct app_params {
 static struct option app_long_options[] = {
     { "rx",         no_argument,        0,      1 },
     { "tx",         no_argument,        0,      2 },
+    { "sweep",      no_argument,        0,      3 },
     { "iterations", required_argument,  0,      'i' },
     { "seed",       required_argument,  0,      'S' },
     { NULL,         0,                  0,      0 },
@@ -74,12 +85,17 @@ int app_handle_args(int argc, char **argv,
                 p->tx = true;
                 break;
 
+            case 3:
+                p->sweep = true;
+                break;
+
             case 'i':
                 p->iterations = str2uint64(optarg, 1, UINT64_MAX, &ok);
                 if (!ok) {
                     fprintf(stderr, "Invalid # iterations: %s\n", optarg);
                     return -1;
                 }
+                p->iterations_set = true;
                 break;
 
             case 'S':
@@ -102,11 +118,17 @@ void print_usage(const char *argv0)
     printf("%s: Exercise frequency changes within an RX/TX thread\n", argv0);
     printf("\n");
     printf("Test-specific options:\n");
-    printf("  -i, --iterations <value>  Number of iterations to run.\n");
+    printf("  -i, --iterations <value>  Number of iterations to run, or the number\n");
+    printf("                             of sweeps with --sweep.\n");
     printf("  -S, --seed <value>        PRNG seed for random frequencies.\n");
     printf("  --rx                      Enable bladerf_sync_rx() calls.\n");
     printf("  --tx                      Enable bladerf_sync_tx() calls.\n");
     printf("                             Requires device to be in loopback mode.\n");
+    printf("  --sweep                   Sweep RX across the device's frequency range\n");
+    printf("                             (limited to %u-%" PRIu64 " MHz) in %u MHz\n",
+           SWEEP_START / 1000000, (uint64_t)SWEEP_STOP / 1000000,
+           SWEEP_STEP / 1000000);
+    printf("                             steps, via bladerf_sweep().\n");
     printf("\n");
     devcfg_print_common_help("Device configuration arguments\n");
     printf("\n");
@@ -253,6 +275,102 @@ out:
     return status;
 }
 
+struct sweep_stats {
+    uint64_t blocks;
+    uint64_t samples;
+    uint64_t short_blocks;
+    uint64_t total_blocks;
+};
+
+static int sweep_cb(struct bladerf *dev,
+                    const struct bladerf_sweep_block *block,
+                    void *user_data)
+{
+    struct sweep_stats *stats = user_data;
+
+    stats->blocks++;
+    stats->samples += block->num_samples;
+
+    if (block->status & BLADERF_META_STATUS_OVERRUN) {
+        stats->short_blocks++;
+    }
+
+    if (block->step == 0) {
+        printf("\rSweep: %8u  Blocks: %10" PRIu64 " of %-10" PRIu64
+               "  Overruns: %" PRIu64, block->sweep, stats->blocks,
+               stats->total_blocks, stats->short_blocks);
+        fflush(stdout);
+    }
+
+    return 0;
+}
+
+int run_sweep(struct bladerf *dev, struct app_params *p)
+{
+    int status;
+    int disable_status;
+    const struct bladerf_range *range;
+    struct bladerf_sweep_config config;
+    struct sweep_stats stats;
+    const bladerf_channel ch = BLADERF_CHANNEL_RX(0);
+
+    status = bladerf_get_frequency_range(dev, ch, &range);
+    if (status != 0) {
+        fprintf(stderr, "Failed to get frequency range: %s\n",
+                bladerf_strerror(status));
+        return -1;
+    }
+
+    memset(&config, 0, sizeof(config));
+    config.start = (range->min > SWEEP_START) ?
+                        (bladerf_frequency)range->min : SWEEP_START;
+    config.stop  = (range->max < SWEEP_STOP) ?
+                        (bladerf_frequency)range->max : SWEEP_STOP;
+    config.step  = SWEEP_STEP;
+    config.samples_per_step = p->dev_config.samples_per_buffer;
+    config.settle_samples   = (unsigned int)
+        ((uint64_t)p->dev_config.rx_samplerate * SWEEP_SETTLE_US / 1000000);
+    config.timeout_ms       = p->dev_config.sync_timeout_ms;
+
+    memset(&stats, 0, sizeof(stats));
+    stats.total_blocks = p->iterations *
+                         ((config.stop - config.start) / config.step + 1);
+
+    status = devcfg_perform_sync_config(dev, BLADERF_MODULE_RX,
+                                        BLADERF_FORMAT_SC16_Q11_META,
+                                        &p->dev_config, true);
+    if (status != 0) {
+        return -1;
+    }
+
+    printf("Sweeping %" PRIu64 " - %" PRIu64 " Hz in %" PRIu64
+           " Hz steps, discarding %u samples per step.\n",
+           config.start, config.stop, config.step, config.settle_samples);
+
+    status = bladerf_sweep(dev, ch, &config, (unsigned int)p->iterations,
+                           sweep_cb, &stats);
+
+    printf("\n");
+
+    if (status != 0) {
+        fprintf(stderr, "Sweep failed: %s\n", bladerf_strerror(status));
+        status = -1;
+    } else {
+        printf("Received %" PRIu64 " blocks (%" PRIu64 " samples), %" PRIu64
+               " with overruns.\n", stats.blocks, stats.samples,
+               stats.short_blocks);
+    }
+
+    disable_status = bladerf_enable_module(dev, BLADERF_MODULE_RX, false);
+    if (disable_status != 0) {
+        fprintf(stderr, "Failed to disable RX module: %s\n",
+                bladerf_strerror(disable_status));
+        status = -1;
+    }
+
+    return status;
+}
+
 int main(int argc, char *argv[])
 {
     int status;
@@ -265,6 +383,8 @@ int main(int argc, char *argv[])
     params.randval_seed = 1;
     params.rx = false;
     params.tx = false;
+    params.sweep = false;
+    params.iterations_set = false;
 
     options = devcfg_get_long_options(app_long_options);
     if (options == NULL) {
@@ -292,6 +412,10 @@ int main(int argc, char *argv[])
         goto error_no_dev;
     }
 
+    if (params.sweep && !params.iterations_set) {
+        params.iterations = SWEEP_DEFAULT_COUNT;
+    }
+
     if (params.tx && params.dev_config.loopback == BLADERF_LB_NONE) {
         fprintf(stderr, "--tx requires the device to be put in a loopback mode.\n");
         status = -1;
@@ -308,7 +432,11 @@ int main(int argc, char *argv[])
 
     status = devcfg_apply(dev, &params.dev_config);
     if (status == 0) {
-        status = run_test(dev, &params);
+        if (params.sweep) {
+            status = run_sweep(dev, &params);
+        } else {
+            status = run_test(dev, &params);
+        }
     }
 
 
@@ -0,0 +1,261 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * This program streams samples through the FX3 firmware loopback, over a
+ * range of buffer sizes and transfer depths, to measure what the host and
+ * USB link can sustain with the FPGA out of the path.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <getopt.h>
+#include <libbladeRF.h>
+#include "conversions.h"
+
+#define OPTARG_STR "d:s:t:c:v:h"
+
+#define MAX_VALUES 16
+
+/* Default buffer sizes, in samples, and transfers in flight */
+static const unsigned int DEFAULT_SIZES[]     = { 4096, 16384, 65536 };
+static const unsigned int DEFAULT_TRANSFERS[] = { 4, 8, 16, 32 };
+
+#define DEFAULT_BYTES (256u * 1024 * 1024)
+
+static struct option long_options[] = {
+    { "device",         required_argument,  0,  'd'},
+    { "sizes",          required_argument,  0,  's'},
+    { "transfers",      required_argument,  0,  't'},
+    { "count",          required_argument,  0,  'c'},
+    { "verbosity",      required_argument,  0,  'v'},
+    { "help",           no_argument,        0,  'h'},
+    { 0,                0,                  0,  0},
+};
+
+struct app_config {
+    const char *device_str;
+    unsigned int sizes[MAX_VALUES];
+    unsigned int num_sizes;
+    unsigned int transfers[MAX_VALUES];
+    unsigned int num_transfers;
+    unsigned int count;
+    bladerf_log_level verbosity;
+};
+
+static void usage(const char *argv0)
+{
+    printf("FX3 firmware loopback throughput and latency benchmark\n\n");
+    printf("Usage: %s [options]\n\n", argv0);
+    printf("  -d, --device <device>     Device to use. If not specified, the\n"
+           "                            first device found will be used.\n\n");
+
+    printf("  -s, --sizes <n,...>       Comma-separated samples per buffer.\n"
+           "                            Each must be a multiple of 1024.\n"
+           "                            Default is 4096,16384,65536.\n\n");
+
+    printf("  -t, --transfers <n,...>   Comma-separated transfers in flight.\n"
+           "                            Twice as many buffers are used.\n"
+           "                            Default is 4,8,16,32.\n\n");
+
+    printf("  -c, --count <n>           Buffers to loop back per run. By\n"
+           "                            default, %u MiB are looped back.\n\n",
+           DEFAULT_BYTES / (1024 * 1024));
+
+    printf("  -v, --verbosity <level>   Set libbladeRF verbosity level.\n\n");
+
+    printf("  -h, --help                Show this text\n\n");
+}
+
+static int parse_list(const char *str, unsigned int min,
+                      unsigned int *values, unsigned int *num)
+{
+    char *copy, *tok;
+    bool ok = true;
+
+    copy = strdup(str);
+    if (copy == NULL) {
+        perror("strdup");
+        return -1;
+    }
+
+    *num = 0;
+    for (tok = strtok(copy, ","); tok != NULL && ok; tok = strtok(NULL, ",")) {
+        if (*num == MAX_VALUES) {
+            ok = false;
+            break;
+        }
+
+        values[(*num)++] = str2uint(tok, min, UINT_MAX, &ok);
+    }
+
+    free(copy);
+    return (ok && *num > 0) ? 0 : -1;
+}
+
+static int handle_args(int argc, char *argv[], struct app_config *config)
+{
+    int opt, opt_idx;
+    unsigned int i;
+    bool ok;
+
+    memset(config, 0, sizeof(*config));
+    config->verbosity = BLADERF_LOG_LEVEL_INFO;
+
+    memcpy(config->sizes, DEFAULT_SIZES, sizeof(DEFAULT_SIZES));
+    config->num_sizes = sizeof(DEFAULT_SIZES) / sizeof(DEFAULT_SIZES[0]);
+
+    memcpy(config->transfers, DEFAULT_TRANSFERS, sizeof(DEFAULT_TRANSFERS));
+    config->num_transfers =
+        sizeof(DEFAULT_TRANSFERS) / sizeof(DEFAULT_TRANSFERS[0]);
+
+    opt = getopt_long(argc, argv, OPTARG_STR, long_options, &opt_idx);
+    while (opt != -1) {
+        switch (opt) {
+            case 'd':
+                config->device_str = optarg;
+                break;
+
+            case 's':
+                if (parse_list(optarg, 1024, config->sizes,
+                               &config->num_sizes) != 0) {
+                    fprintf(stderr, "\nError: Invalid buffer sizes: %s\n\n",
+                            optarg);
+                    return -1;
+                }
+
+                for (i = 0; i < config->num_sizes; i++) {
+                    if (config->sizes[i] % 1024 != 0) {
+                        fprintf(stderr, "\nError: Buffer size %u is not a "
+                                "multiple of 1024\n\n", config->sizes[i]);
+                        return -1;
+                    }
+                }
+                break;
+
+            case 't':
+                if (parse_list(optarg, 1, config->transfers,
+                               &config->num_transfers) != 0) {
+                    fprintf(stderr, "\nError: Invalid transfer counts: %s\n\n",
+                            optarg);
+                    return -1;
+                }
+                break;
+
+            case 'c':
+                config->count = str2uint(optarg, 1, UINT_MAX, &ok);
+                if (!ok) {
+                    fprintf(stderr, "\nError: Invalid count: %s\n\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'v':
+                config->verbosity = str2loglevel(optarg, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Unknown verbosity level: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'h':
+                return 1;
+
+            default:
+                return -1;
+        }
+
+        opt = getopt_long(argc, argv, OPTARG_STR, long_options, &opt_idx);
+    }
+
+    return 0;
+}
+
+static int run(struct bladerf *dev, const struct app_config *config)
+{
+    struct bladerf_fw_loopback_bench_config bench;
+    struct bladerf_fw_loopback_bench_results results;
+    unsigned int s, t;
+    int status;
+
+    printf("\n  Samples  Xfers      MB/s   Min us   p50 us   p90 us   p99 us"
+           "   Max us  Errors\n");
+    printf("  -------  -----  --------  -------  -------  -------  -------"
+           "  -------  ------\n");
+
+    for (s = 0; s < config->num_sizes; s++) {
+        for (t = 0; t < config->num_transfers; t++) {
+            bench.buffer_size   = config->sizes[s];
+            bench.num_transfers = config->transfers[t];
+            bench.num_buffers   = 2 * config->transfers[t];
+            bench.count         = config->count;
+
+            if (bench.count == 0) {
+                bench.count = DEFAULT_BYTES / (bench.buffer_size * 4);
+            }
+
+            status = bladerf_fw_loopback_bench(dev, &bench, &results);
+            if (status != 0) {
+                fprintf(stderr, "Benchmark of %u samples x %u transfers "
+                        "failed: %s\n", bench.buffer_size,
+                        bench.num_transfers, bladerf_strerror(status));
+                return status;
+            }
+
+            printf("  %7u  %5u  %8.1f  %7.0f  %7.0f  %7.0f  %7.0f  %7.0f  "
+                   "%6llu\n", bench.buffer_size, bench.num_transfers,
+                   results.throughput / 1e6, results.latency_min,
+                   results.latency_p50, results.latency_p90,
+                   results.latency_p99, results.latency_max,
+                   (unsigned long long)results.errors);
+        }
+    }
+
+    printf("\n");
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    struct app_config config;
+    struct bladerf *dev;
+    int status;
+
+    status = handle_args(argc, argv, &config);
+    if (status != 0) {
+        usage(argv[0]);
+        return status < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    bladerf_log_set_verbosity(config.verbosity);
+
+    status = bladerf_open(&dev, config.device_str);
+    if (status != 0) {
+        fprintf(stderr, "Failed to open device: %s\n",
+                bladerf_strerror(status));
+        return EXIT_FAILURE;
+    }
+
+    status = run(dev, &config);
+
+    bladerf_close(dev);
+    return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
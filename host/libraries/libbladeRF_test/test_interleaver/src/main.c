@@ -1,5 +1,8 @@
 #include <libbladeRF.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #include "helpers/interleave.h"
 
@@ -282,11 +285,129 @@ error:
     return status;
 }
 
+/* Checks the 2-channel out-of-place kernels against a scalar reference */
+int test_kernels(size_t samps_per_ch)
+{
+    uint32_t *src = NULL, *ch0 = NULL, *ch1 = NULL, *dst = NULL;
+    int status    = -1;
+    size_t i;
+
+    PRINT_INFO("beginning kernel test: samps_per_ch = %zu... ", samps_per_ch);
+
+    src = create_buf(2 * samps_per_ch * sizeof(uint32_t));
+    ch0 = calloc(samps_per_ch, sizeof(uint32_t));
+    ch1 = calloc(samps_per_ch, sizeof(uint32_t));
+    dst = calloc(2 * samps_per_ch, sizeof(uint32_t));
+
+    if (NULL == src || NULL == ch0 || NULL == ch1 || NULL == dst) {
+        PRINT_ERROR("%s: allocation failed\n", __FUNCTION__);
+        goto out;
+    }
+
+    _interleave_deinterleave2(src, ch0, ch1, samps_per_ch);
+
+    for (i = 0; i < samps_per_ch; ++i) {
+        if (ch0[i] != src[2 * i] || ch1[i] != src[2 * i + 1]) {
+            PRINT_ERROR("deinterleave mismatch at sample %zu\n", i);
+            goto out;
+        }
+    }
+
+    _interleave_interleave2(ch0, ch1, dst, samps_per_ch);
+
+    if (memcmp(src, dst, 2 * samps_per_ch * sizeof(uint32_t)) != 0) {
+        PRINT_ERROR("interleave did not invert deinterleave\n");
+        goto out;
+    }
+
+    PRINT_INFO("good!\n");
+    status = 0;
+
+out:
+    free(src);
+    free(ch0);
+    free(ch1);
+    free(dst);
+    return status;
+}
+
+static double elapsed_sec(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static void print_rate(char const *name, size_t samples, double sec)
+{
+    if (sec > 0) {
+        PRINT_INFO("  %-28s %10.2f Msps\n", name, samples / sec / 1e6);
+    } else {
+        PRINT_INFO("  %-28s (too fast to measure)\n", name);
+    }
+}
+
+/* Reports the throughput of the in-place and out-of-place (de)interleavers */
+int benchmark(size_t num_samples, unsigned int iterations)
+{
+    size_t const bytes = num_samples * sizeof(uint32_t);
+    size_t const total = num_samples * iterations;
+    void *buf = NULL, *ch0 = NULL, *ch1 = NULL;
+    unsigned int i;
+    clock_t start;
+    int status = 0;
+
+    buf = create_buf(bytes);
+    ch0 = malloc(bytes / 2);
+    ch1 = malloc(bytes / 2);
+    if (NULL == buf || NULL == ch0 || NULL == ch1) {
+        PRINT_ERROR("%s: allocation failed\n", __FUNCTION__);
+        status = -1;
+        goto out;
+    }
+
+    PRINT_INFO("benchmark: %zu samples x %u iterations\n", num_samples,
+               iterations);
+
+    start = clock();
+    for (i = 0; i < iterations && status == 0; ++i) {
+        status = _interleave_interleave_buf(BLADERF_TX_X2,
+                                            BLADERF_FORMAT_SC16_Q11,
+                                            (unsigned int)num_samples, buf);
+    }
+    print_rate("interleave (in place)", total, elapsed_sec(start));
+
+    start = clock();
+    for (i = 0; i < iterations && status == 0; ++i) {
+        status = _interleave_deinterleave_buf(BLADERF_RX_X2,
+                                              BLADERF_FORMAT_SC16_Q11,
+                                              (unsigned int)num_samples, buf);
+    }
+    print_rate("deinterleave (in place)", total, elapsed_sec(start));
+
+    start = clock();
+    for (i = 0; i < iterations; ++i) {
+        _interleave_interleave2(ch0, ch1, buf, num_samples / 2);
+    }
+    print_rate("interleave (out of place)", total, elapsed_sec(start));
+
+    start = clock();
+    for (i = 0; i < iterations; ++i) {
+        _interleave_deinterleave2(buf, ch0, ch1, num_samples / 2);
+    }
+    print_rate("deinterleave (out of place)", total, elapsed_sec(start));
+
+out:
+    free(buf);
+    free(ch0);
+    free(ch1);
+    return status;
+}
+
 /* it's main */
 int main(int argc, char *argv[])
 {
     int status               = 0;
     size_t const NUM_SAMPLES = 16384;
+    size_t const NUM_SAMPLES_ODD = 2 * 5003;
 
     PRINT_INFO("*** BEGINNING 1-CHANNEL TESTS: interleaving should be noop\n");
 
@@ -316,6 +437,41 @@ int main(int argc, char *argv[])
         goto error;
     }
 
+    PRINT_INFO("*** BEGINNING 2-CHANNEL TESTS (non-power-of-2 size)\n");
+
+    status = test(BLADERF_RX_X2, BLADERF_TX_X2, BLADERF_FORMAT_SC16_Q11,
+                  NUM_SAMPLES_ODD);
+    if (status < 0) {
+        goto error;
+    }
+
+    status = test(BLADERF_RX_X2, BLADERF_TX_X2, BLADERF_FORMAT_SC16_Q11_META,
+                  NUM_SAMPLES_ODD);
+    if (status < 0) {
+        goto error;
+    }
+
+    PRINT_INFO("*** BEGINNING 2-CHANNEL KERNEL TESTS\n");
+
+    status = test_kernels(NUM_SAMPLES / 2);
+    if (status < 0) {
+        goto error;
+    }
+
+    status = test_kernels(NUM_SAMPLES_ODD / 2);
+    if (status < 0) {
+        goto error;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--benchmark") == 0) {
+        PRINT_INFO("*** BEGINNING BENCHMARK\n");
+
+        status = benchmark(NUM_SAMPLES * 16, 500);
+        if (status < 0) {
+            goto error;
+        }
+    }
+
 error:
     if (status < 0) {
         PRINT_ERROR("test returned %d, failing\n", status);
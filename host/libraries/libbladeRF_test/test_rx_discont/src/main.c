@@ -28,6 +28,7 @@
 #include <string.h>
 #include <errno.h>
 #include <limits.h>
+#include <inttypes.h>
 
 #include <libbladeRF.h>
 #include <getopt.h>
@@ -42,13 +43,19 @@
 
 #define RESET_EXPECTED  UINT32_MAX
 
-#define OPTSTR "hs:i:t:v"
+/* In the rx_resync test, stall the receive loop once per this many
+ * iterations, for twice the time the sync interface's buffers can hold */
+#define STALL_INTERVAL  256
+
+#define OPTSTR "hd:s:i:t:v"
 const struct option long_options[] = {
     { "help",           no_argument,        0,          'h' },
     { "device",         required_argument,  0,          'd' },
     { "samplerate",     required_argument,  0,          's' },
     { "iterations",     required_argument,  0,          'i' },
+    { "test",           required_argument,  0,          't' },
     { "verbose",        no_argument,        0,          'v' },
+    { NULL,             0,                  0,          0   },
 };
 
 const struct numeric_suffix freq_suffixes[] = {
@@ -70,6 +77,7 @@ struct app_params {
     unsigned int samplerate;
     unsigned int iterations;
     char *device_str;
+    char *test_name;
 };
 
 static void print_usage(const char *argv0)
@@ -86,7 +94,13 @@ static void print_usage(const char *argv0)
     printf("\n");
     printf("Available tests:\n");
     printf("    rx_counter  -   Received samples are derived from the internal\n"
-           "                    FPGA counter. Gaps are reported.\n");
+           "                    FPGA counter. Gaps are reported. (Default)\n");
+    printf("    rx_resync   -   As rx_counter, but with metadata. The receive\n"
+           "                    loop is periodically stalled to force overruns,\n"
+           "                    from which it recovers via\n"
+           "                    BLADERF_META_FLAG_RX_RESYNC. Reported gaps are\n"
+           "                    checked against the counter, and the recovery\n"
+           "                    latency is compared to that of a restart.\n");
     printf("\n");
 }
 
@@ -100,6 +114,7 @@ int handle_cmdline(int argc, char *argv[], struct app_params *p)
     p->samplerate = 1000000;
     p->iterations = 10000;
     p->device_str = NULL;
+    p->test_name = "rx_counter";
 
     while ((c = getopt_long(argc, argv, OPTSTR, long_options, &idx)) >= 0) {
         switch (c) {
@@ -133,6 +148,10 @@ int handle_cmdline(int argc, char *argv[], struct app_params *p)
                 p->device_str = optarg;
                 break;
 
+            case 't':
+                p->test_name = optarg;
+                break;
+
             case 'v':
                 bladerf_log_set_verbosity(BLADERF_LOG_LEVEL_VERBOSE);
                 break;
@@ -146,10 +165,36 @@ int handle_cmdline(int argc, char *argv[], struct app_params *p)
     return 0;
 }
 
+/* Switch the RX sample source to the FPGA's internal counter */
+static int enable_counter(struct bladerf *dev, uint32_t *gpio_backup)
+{
+    int status;
+    uint32_t gpio_val;
+
+    status = bladerf_config_gpio_read(dev, &gpio_val);
+    if (status != 0) {
+        fprintf(stderr, "Failed to read device IO configuration: %s\n",
+                bladerf_strerror(status));
+        return status;
+    }
+
+    /* TODO use API macro (in upcoming changeset) */
+    *gpio_backup = gpio_val;
+    gpio_val |= 0x200;
+
+    status = bladerf_config_gpio_write(dev, gpio_val);
+    if (status != 0) {
+        fprintf(stderr, "Failed to write device IO configuration: %s\n",
+                bladerf_strerror(status));
+    }
+
+    return status;
+}
+
 int run_test(struct bladerf *dev, struct app_params *p)
 {
     int status;
-    uint32_t gpio_val, gpio_backup;
+    uint32_t gpio_backup;
     unsigned int i, j;
     uint32_t *data = NULL;
     unsigned int discontinuities = 0;
@@ -171,21 +216,8 @@ int run_test(struct bladerf *dev, struct app_params *p)
         return status;
     }
 
-    status = bladerf_config_gpio_read(dev, &gpio_val);
+    status = enable_counter(dev, &gpio_backup);
     if (status != 0) {
-        fprintf(stderr, "Failed to read device IO configuration: %s\n",
-                bladerf_strerror(status));
-        return status;
-    }
-
-    /* TODO use API macro (in upcoming changeset) */
-    gpio_backup = gpio_val;
-    gpio_val |= 0x200;
-
-    status = bladerf_config_gpio_write(dev, gpio_val);
-    if (status != 0) {
-        fprintf(stderr, "Failed to write device IO configuration: %s\n",
-                bladerf_strerror(status));
         return status;
     }
 
@@ -248,6 +280,244 @@ out:
     return status;
 }
 
+struct latency {
+    uint64_t min, max, total;
+    unsigned int count;
+};
+
+static void latency_add(struct latency *l, uint64_t ns)
+{
+    if (l->count == 0 || ns < l->min) {
+        l->min = ns;
+    }
+
+    if (ns > l->max) {
+        l->max = ns;
+    }
+
+    l->total += ns;
+    l->count++;
+}
+
+static void latency_print(const char *name, const struct latency *l)
+{
+    if (l->count == 0) {
+        printf("  %-20s n/a\n", name);
+    } else {
+        printf("  %-20s min %8.3f ms, avg %8.3f ms, max %8.3f ms (%u)\n",
+               name, l->min / 1e6, (l->total / l->count) / 1e6, l->max / 1e6,
+               l->count);
+    }
+}
+
+static int config_rx(struct bladerf *dev, bladerf_format format)
+{
+    int status = bladerf_sync_config(dev,
+                                     BLADERF_MODULE_RX,
+                                     format,
+                                     NUM_BUFFERS,
+                                     BUFFER_SIZE,
+                                     NUM_XFERS,
+                                     TIMEOUT_MS);
+
+    if (status != 0) {
+        fprintf(stderr, "Failed to configure RX sync i/f: %s\n",
+                bladerf_strerror(status));
+    }
+
+    return status;
+}
+
+/* Disable, reconfigure and re-enable RX, and receive the first samples
+ * thereafter: the recovery path available before BLADERF_META_FLAG_RX_RESYNC */
+static int time_restart(struct bladerf *dev, uint32_t *data,
+                        struct latency *l)
+{
+    int status;
+    struct bladerf_metadata meta;
+    uint64_t start;
+
+    start = bladerf_get_deadline_clock_ns();
+
+    status = bladerf_enable_module(dev, BLADERF_MODULE_RX, false);
+    if (status == 0) {
+        status = config_rx(dev, BLADERF_FORMAT_SC16_Q11_META);
+    }
+
+    if (status == 0) {
+        status = bladerf_enable_module(dev, BLADERF_MODULE_RX, true);
+    }
+
+    if (status == 0) {
+        memset(&meta, 0, sizeof(meta));
+        meta.flags = BLADERF_META_FLAG_RX_NOW;
+        status = bladerf_sync_rx(dev, data, BUFFER_SIZE, &meta, TIMEOUT_MS);
+    }
+
+    if (status != 0) {
+        fprintf(stderr, "\nRestart failed: %s\n", bladerf_strerror(status));
+    } else {
+        latency_add(l, bladerf_get_deadline_clock_ns() - start);
+    }
+
+    return status;
+}
+
+int run_resync_test(struct bladerf *dev, struct app_params *p)
+{
+    int status;
+    uint32_t gpio_backup;
+    unsigned int i, j;
+    uint32_t *data = NULL;
+    struct bladerf_metadata meta;
+    bladerf_timestamp ts_exp;
+    uint32_t count_exp;
+    unsigned int overruns = 0, resyncs = 0, errors = 0;
+    uint64_t total_gap = 0;
+    uint64_t overrun_time = 0;
+    struct latency resync_lat, restart_lat;
+    const unsigned int update_interval = p->samplerate / BUFFER_SIZE;
+
+    /* Stall for twice as long as the sync buffers can hold */
+    const unsigned int stall_us = (unsigned int)
+        (2ull * NUM_BUFFERS * BUFFER_SIZE * 1000000 / p->samplerate);
+
+    memset(&resync_lat, 0, sizeof(resync_lat));
+    memset(&restart_lat, 0, sizeof(restart_lat));
+
+    status = config_rx(dev, BLADERF_FORMAT_SC16_Q11_META);
+    if (status != 0) {
+        return status;
+    }
+
+    status = enable_counter(dev, &gpio_backup);
+    if (status != 0) {
+        return status;
+    }
+
+    data = malloc(BUFFER_SIZE * sizeof(data[0]));
+    if (data == NULL) {
+        perror("malloc");
+        status = BLADERF_ERR_UNEXPECTED;
+        goto out;
+    }
+
+    status = bladerf_enable_module(dev, BLADERF_MODULE_RX, true);
+    if (status != 0) {
+        fprintf(stderr, "Failed to enable RX module: %s\n",
+                bladerf_strerror(status));
+        goto out;
+    }
+
+    memset(&meta, 0, sizeof(meta));
+    meta.flags = BLADERF_META_FLAG_RX_NOW;
+    status = bladerf_sync_rx(dev, data, BUFFER_SIZE, &meta, TIMEOUT_MS);
+    if (status != 0) {
+        fprintf(stderr, "RX failed: %s\n", bladerf_strerror(status));
+        goto out;
+    }
+
+    ts_exp    = meta.timestamp + meta.actual_count;
+    count_exp = data[meta.actual_count - 1] + 1;
+
+    printf("Running %u iterations, stalling for %u us every %u.\n\n",
+           p->iterations, stall_us, STALL_INTERVAL);
+
+    for (i = 0; i < p->iterations && status == 0; i++) {
+        uint64_t start, end;
+
+        if (i % update_interval == 0) {
+            printf("\rCurrent iteration %10u / %-10u", i, p->iterations);
+            fflush(stdout);
+        }
+
+        if (i % STALL_INTERVAL == STALL_INTERVAL - 1) {
+            usleep(stall_us);
+        }
+
+        memset(&meta, 0, sizeof(meta));
+        meta.flags     = BLADERF_META_FLAG_RX_RESYNC;
+        meta.timestamp = ts_exp;
+
+        start  = bladerf_get_deadline_clock_ns();
+        status = bladerf_sync_rx(dev, data, BUFFER_SIZE, &meta, TIMEOUT_MS);
+        end    = bladerf_get_deadline_clock_ns();
+
+        if (status != 0) {
+            fprintf(stderr, "\nRX failed: %s\n", bladerf_strerror(status));
+            break;
+        }
+
+        if (meta.timestamp != ts_exp) {
+            /* Resynchronized past a gap */
+            if (meta.gap != meta.timestamp - ts_exp) {
+                fprintf(stderr, "\nGap of %" PRIu64 " samples reported, "
+                        "but timestamp advanced by %" PRIu64 "\n",
+                        meta.gap, meta.timestamp - ts_exp);
+                errors++;
+            }
+
+            if (data[0] != (uint32_t)(count_exp + meta.gap)) {
+                fprintf(stderr, "\nGap of %" PRIu64 " samples reported, "
+                        "but counter advanced by %u\n",
+                        meta.gap, data[0] - count_exp);
+                errors++;
+            }
+
+            /* Recovery latency is measured from the call that observed the
+             * overrun, if any, to the return of the resynchronized one */
+            latency_add(&resync_lat,
+                        end - (overrun_time != 0 ? overrun_time : start));
+
+            total_gap += meta.gap;
+            resyncs++;
+            overrun_time = 0;
+        } else if (meta.status & BLADERF_META_STATUS_OVERRUN) {
+            /* Returned what preceded a discontinuity */
+            overruns++;
+            overrun_time = start;
+        }
+
+        count_exp = data[0];
+        for (j = 0; j < meta.actual_count; j++, count_exp++) {
+            if (data[j] != count_exp) {
+                fprintf(stderr, "\nDiscontinuity @ sample %u of "
+                        "t=%" PRIu64 ": Expected 0x%08x, Got 0x%08x\n",
+                        j, meta.timestamp, count_exp, data[j]);
+                errors++;
+                break;
+            }
+        }
+
+        ts_exp    = meta.timestamp + meta.actual_count;
+        count_exp = data[meta.actual_count - 1] + 1;
+    }
+
+    printf("\n\n%u overruns, %u resynchronizations, %" PRIu64
+           " samples lost, %u errors.\n", overruns, resyncs, total_gap, errors);
+
+    /* For comparison, the cost of recovering via a stream restart */
+    for (i = 0; i < 10 && status == 0; i++) {
+        status = time_restart(dev, data, &restart_lat);
+    }
+
+    printf("\nRecovery latency:\n");
+    latency_print("Resynchronization:", &resync_lat);
+    latency_print("Stream restart:", &restart_lat);
+
+    if (status == 0 && errors != 0) {
+        status = BLADERF_ERR_UNEXPECTED;
+    }
+
+out:
+    if (bladerf_config_gpio_write(dev, gpio_backup) != 0) {
+        fprintf(stderr, "Failed to restore device IO configuration\n");
+    }
+
+    free(data);
+    return status;
+}
+
 int main(int argc, char *argv[])
 {
     int status;
@@ -282,7 +552,14 @@ int main(int argc, char *argv[])
         goto out;
     }
 
-    status = run_test(dev, &params);
+    if (!strcasecmp(params.test_name, "rx_counter")) {
+        status = run_test(dev, &params);
+    } else if (!strcasecmp(params.test_name, "rx_resync")) {
+        status = run_resync_test(dev, &params);
+    } else {
+        fprintf(stderr, "Unknown test: %s\n", params.test_name);
+        status = -1;
+    }
 
 out:
     bladerf_close(dev);
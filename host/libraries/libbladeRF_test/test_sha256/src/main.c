@@ -0,0 +1,233 @@
+/*
+ * Checks each SHA-256 implementation this CPU supports against known answers
+ * and against the portable implementation, over a range of lengths,
+ * alignments and update sizes, then measures their throughput.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Included directly, to select each block implementation in turn */
+#include "sha256.c"
+
+struct impl {
+    const char *name;
+    sha256_blocks_fn fn;
+};
+
+struct known_answer {
+    const char *msg;
+    size_t repeat;
+    const char *digest;
+};
+
+static const struct known_answer known_answers[] = {
+    { "", 1,
+      "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+    { "abc", 1,
+      "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+    { "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1,
+      "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+    { "a", 1000000,
+      "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" },
+};
+
+/* Keeps benchmarked results from being optimized out */
+static volatile unsigned char bench_sink;
+
+static unsigned int get_impls(struct impl *impls)
+{
+    unsigned int n = 0;
+
+    impls[n].name = "portable";
+    impls[n++].fn = SHA256_Blocks_Portable;
+
+#ifdef SHA256_HAVE_SHANI
+    if (have_shani()) {
+        impls[n].name = "sha-ni";
+        impls[n++].fn = SHA256_Blocks_SHANI;
+    }
+#endif
+
+#ifdef SHA256_HAVE_ARMV8
+    if (have_armv8_sha2()) {
+        impls[n].name = "armv8";
+        impls[n++].fn = SHA256_Blocks_ARMv8;
+    }
+#endif
+
+    return n;
+}
+
+/* Hash buf, passing it to SHA256_Update() `chunk` bytes at a time */
+static void hash(const struct impl *impl, const void *buf, size_t len,
+                 size_t chunk, unsigned char digest[SHA256_DIGEST_SIZE])
+{
+    const unsigned char *p = buf;
+    SHA256_CTX ctx;
+    size_t n;
+
+    sha256_blocks = impl->fn;
+
+    SHA256_Init(&ctx);
+    while (len > 0) {
+        n = (len < chunk) ? len : chunk;
+        SHA256_Update(&ctx, p, n);
+        p += n;
+        len -= n;
+    }
+    SHA256_Final(digest, &ctx);
+}
+
+static void to_hex(const unsigned char digest[SHA256_DIGEST_SIZE], char *hex)
+{
+    unsigned int i;
+
+    for (i = 0; i < SHA256_DIGEST_SIZE; i++) {
+        sprintf(&hex[2 * i], "%02x", digest[i]);
+    }
+}
+
+static bool check_known_answers(const struct impl *impl)
+{
+    unsigned char digest[SHA256_DIGEST_SIZE];
+    char hex[2 * SHA256_DIGEST_SIZE + 1];
+    unsigned char *buf;
+    size_t i, j, len;
+    bool ok = true;
+
+    for (i = 0; i < sizeof(known_answers) / sizeof(known_answers[0]); i++) {
+        const struct known_answer *ka = &known_answers[i];
+        const size_t msg_len = strlen(ka->msg);
+
+        len = msg_len * ka->repeat;
+        buf = malloc(len + 1);
+        if (buf == NULL) {
+            return false;
+        }
+
+        for (j = 0; j < ka->repeat; j++) {
+            memcpy(&buf[j * msg_len], ka->msg, msg_len);
+        }
+
+        hash(impl, buf, len, (len > 0) ? len : 1, digest);
+        to_hex(digest, hex);
+        free(buf);
+
+        if (strcmp(hex, ka->digest) != 0) {
+            fprintf(stderr, "%s: known answer %u: got %s\n", impl->name,
+                    (unsigned int)i, hex);
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+static bool check_against_portable(const struct impl *impls,
+                                   const struct impl *impl,
+                                   const unsigned char *buf)
+{
+    static const size_t chunks[] = { 1, 7, 63, 64, 65, 1000, 4096 };
+    unsigned char expected[SHA256_DIGEST_SIZE];
+    unsigned char actual[SHA256_DIGEST_SIZE];
+    size_t len, offset, c;
+
+    for (offset = 0; offset < 8; offset++) {
+        for (len = 0; len <= 1100; len++) {
+            hash(&impls[0], buf + offset, len, 4096, expected);
+
+            for (c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+                hash(impl, buf + offset, len, chunks[c], actual);
+
+                if (memcmp(expected, actual, sizeof(actual)) != 0) {
+                    fprintf(stderr, "%s: mismatch at length %u, offset %u, "
+                            "updates of %u bytes\n", impl->name,
+                            (unsigned int)len, (unsigned int)offset,
+                            (unsigned int)chunks[c]);
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+int main(void)
+{
+    const size_t bench_bytes = 64 * 1024 * 1024;
+    const size_t buf_len     = 2 * 1024 * 1024;
+    unsigned char digest[SHA256_DIGEST_SIZE];
+    struct impl impls[4];
+    unsigned int num_impls, i;
+    unsigned char *buf;
+    size_t n;
+    clock_t start;
+    double secs;
+    int status = EXIT_SUCCESS;
+
+    buf = malloc(buf_len);
+    if (buf == NULL) {
+        perror("malloc");
+        return EXIT_FAILURE;
+    }
+
+    srand(1);
+    for (n = 0; n < buf_len; n++) {
+        buf[n] = (unsigned char)rand();
+    }
+
+    num_impls = get_impls(impls);
+
+    for (i = 0; i < num_impls; i++) {
+        if (!check_known_answers(&impls[i]) ||
+            (i > 0 && !check_against_portable(impls, &impls[i], buf))) {
+            status = EXIT_FAILURE;
+            goto out;
+        }
+    }
+
+    printf("Selected implementation: %s\n",
+           (select_blocks() == SHA256_Blocks_Portable) ? "portable"
+                                                        : "hardware");
+    printf("%-14s %10s\n", "Implementation", "MB/s");
+
+    for (i = 0; i < num_impls; i++) {
+        start = clock();
+        for (n = 0; n < bench_bytes / buf_len; n++) {
+            hash(&impls[i], buf, buf_len, buf_len, digest);
+            bench_sink ^= digest[0];
+        }
+        secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        printf("%-14s %10.1f\n", impls[i].name,
+               (secs > 0) ? bench_bytes / secs / 1e6 : 0.0);
+    }
+
+    printf("All checks passed.\n");
+
+out:
+    free(buf);
+    return status;
+}
@@ -36,7 +36,7 @@
 #include "log.h"
 #include "test.h"
 
-#define OPTSTR "hd:s:f:l:i:o:r:c:b:X:B:C:T:"
+#define OPTSTR "hd:s:f:l:i:o:r:c:b:X:B:C:T:A"
 const struct option long_options[] = {
     { "help",           no_argument,        0,  'h' },
 
@@ -52,6 +52,7 @@ const struct option long_options[] = {
     { "tx-repetitions", required_argument,  0,  'r' },
     { "rx-count",       required_argument,  0,  'c' },
     { "block-size",     required_argument,  0,  'b' },
+    { "check-allocs",   no_argument,        0,  'A' },
 
     /* Stream configuration */
     { "num-xfers",      required_argument,  0,  'X' },
@@ -117,6 +118,8 @@ static void print_usage(const char *argv0)
     printf("    -r, --tx-repetitions <n>    # of times to repeat input file. Default = %u\n", DEFAULT_TX_REPETITIONS);
     printf("    -c, --rx-count <n>          # of samples to receive. Defauilt = %u.\n", DEFAULT_RX_COUNT);
     printf("    -b, --block-size <n>        # samples to RX/TX per sync call. Default = %u.\n", DEFAULT_BLOCK_SIZE);
+    printf("    -A, --check-allocs          Fail if libbladeRF allocates memory once\n");
+    printf("                                the streams have started.\n");
     printf("\n");
 
     printf("Stream configuration options:\n");
@@ -289,6 +292,10 @@ int handle_cmdline(int argc, char *argv[], struct test_params *p)
                 }
                 break;
 
+            case 'A':
+                p->check_allocs = true;
+                break;
+
             case 'X':
                 p->num_xfers = str2uint(optarg, 1, UINT_MAX, &ok);
                 if (!ok) {
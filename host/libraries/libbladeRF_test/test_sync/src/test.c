@@ -45,6 +45,55 @@ static struct task_args {
     bool quit;
 } rx_args, tx_args;
 
+/* Allocation tracking for --check-allocs. Once every running task has
+ * received or transmitted its first block, libbladeRF should not allocate
+ * until the tasks stop. */
+static struct alloc_stats {
+    pthread_mutex_t lock;
+    unsigned int tasks_running;
+    unsigned int tasks_steady;
+    uint64_t steady_allocs;
+} alloc_stats = { PTHREAD_MUTEX_INITIALIZER, 0, 0, 0 };
+
+static void *count_alloc(size_t size, void *user_data)
+{
+    struct alloc_stats *a = user_data;
+
+    pthread_mutex_lock(&a->lock);
+    if (a->tasks_running > 0 && a->tasks_steady == a->tasks_running) {
+        a->steady_allocs++;
+    }
+    pthread_mutex_unlock(&a->lock);
+
+    return malloc(size);
+}
+
+static void count_free(void *ptr, void *user_data)
+{
+    free(ptr);
+}
+
+static void set_steady(void)
+{
+    pthread_mutex_lock(&alloc_stats.lock);
+    alloc_stats.tasks_steady++;
+    pthread_mutex_unlock(&alloc_stats.lock);
+}
+
+/* A task that has stopped no longer holds the others back */
+static void task_done(bool steady)
+{
+    pthread_mutex_lock(&alloc_stats.lock);
+    if (alloc_stats.tasks_running > 0) {
+        alloc_stats.tasks_running--;
+    }
+
+    if (steady) {
+        alloc_stats.tasks_steady--;
+    }
+    pthread_mutex_unlock(&alloc_stats.lock);
+}
+
 #if BLADERF_OS_WINDOWS
 static void ctrlc_handler(int signal)
 {
@@ -204,10 +253,12 @@ void *rx_task(void *args)
     struct test_params *p = task->p;
     bool done = false;
     size_t n;
+    bool steady = false;
 
     samples = (int16_t *)calloc(p->block_size, 2 * sizeof(samples[0]));
     if (samples == NULL) {
         perror("calloc");
+        task_done(false);
         return NULL;
     }
 
@@ -243,6 +294,13 @@ void *rx_task(void *args)
             done = true;
         } else {
             log_verbose("RX'd %llu samples.\n", (unsigned long long)to_rx);
+
+            if (!steady) {
+                /* The first block started the stream */
+                set_steady();
+                steady = true;
+            }
+
             n = fwrite(samples, 2 * sizeof(samples[0]), to_rx, p->out_file);
 
             if (n != to_rx) {
@@ -260,6 +318,8 @@ void *rx_task(void *args)
     }
 
 rx_task_out:
+    task_done(steady);
+
     free(samples);
 
     status = bladerf_enable_module(task->dev, BLADERF_MODULE_RX, false);
@@ -278,10 +338,12 @@ void *tx_task(void *arg)
     struct task_args *task = (struct task_args*) arg;
     struct test_params *p = task->p;
     bool done = false;
+    bool steady = false;
 
     samples = (int16_t *)calloc(p->block_size, 2 * sizeof(samples[0]));
     if (samples == NULL) {
         perror("calloc");
+        task_done(false);
         return NULL;
     }
 
@@ -316,6 +378,10 @@ void *tx_task(void *arg)
             if (status != 0) {
                 log_error("TX failed: %s\n", bladerf_strerror(status));
                 done = true;
+            } else if (!steady) {
+                /* The first block started the stream */
+                set_steady();
+                steady = true;
             }
 
         } else {
@@ -333,6 +399,8 @@ void *tx_task(void *arg)
     }
 
 tx_task_out:
+    task_done(steady);
+
     free(samples);
 
     status = bladerf_enable_module(task->dev, BLADERF_MODULE_TX, false);
@@ -349,11 +417,29 @@ int test_run(struct test_params *p)
 {
     int status;
     struct bladerf *dev;
+    struct bladerf_allocator allocator;
 
     init_signal_handling();
 
+    if (p->check_allocs) {
+        allocator.alloc     = count_alloc;
+        allocator.free      = count_free;
+        allocator.user_data = &alloc_stats;
+
+        status = bladerf_set_allocator(&allocator);
+        if (status != 0) {
+            log_error("Failed to install allocator: %s\n",
+                      bladerf_strerror(status));
+            return -1;
+        }
+
+        alloc_stats.tasks_running = (p->in_file != NULL) +
+                                    (p->out_file != NULL);
+    }
+
     dev = initialize_device(p);
     if (dev == NULL) {
+        bladerf_set_allocator(NULL);
         return -1;
     }
 
@@ -368,6 +454,7 @@ int test_run(struct test_params *p)
         if (pthread_create(&tx_args.thread, NULL, tx_task, &tx_args) != 0) {
             fclose(p->in_file);
             p->in_file = NULL;
+            task_done(false);
         }
     }
 
@@ -381,6 +468,7 @@ int test_run(struct test_params *p)
         if (pthread_create(&rx_args.thread, NULL, rx_task, &rx_args) != 0) {
             fclose(p->out_file);
             p->out_file = NULL;
+            task_done(false);
         }
     }
 
@@ -403,6 +491,17 @@ int test_run(struct test_params *p)
     }
 
     bladerf_close(dev);
+    bladerf_set_allocator(NULL);
+
+    if (p->check_allocs) {
+        if (alloc_stats.steady_allocs != 0) {
+            log_error("libbladeRF made %llu allocation(s) while streaming.\n",
+                      (unsigned long long)alloc_stats.steady_allocs);
+            return -1;
+        }
+
+        log_info("No allocations were made while streaming.\n");
+    }
 
     if (p->in_file != NULL && tx_args.status != 0) {
         return -1;
@@ -22,6 +22,7 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
  * THE SOFTWARE.
  */
+#include <stdbool.h>
 #include <stdio.h>
 #include <libbladeRF.h>
 
@@ -59,6 +60,9 @@ struct test_params {
     unsigned int stream_buffer_count;
     unsigned int stream_buffer_size;    /* Units of samples */
     unsigned int timeout_ms;
+
+    /* Fail if libbladeRF allocates once the streams are running */
+    bool check_allocs;
 };
 
 void test_init_params(struct test_params *p);
@@ -52,6 +52,7 @@ DECLARE_TEST(rx_scheduled);
 DECLARE_TEST(tx_onoff);
 DECLARE_TEST(tx_onoff_nowsched);
 DECLARE_TEST(tx_gmsk_bursts);
+DECLARE_TEST(tx_coalesce);
 DECLARE_TEST(loopback_onoff);
 DECLARE_TEST(loopback_onoff_zp);
 DECLARE_TEST(format_mismatch);
@@ -64,6 +65,7 @@ static const struct test *tests[] = {
     TEST(tx_onoff),
     TEST(tx_onoff_nowsched),
     TEST(tx_gmsk_bursts),
+    TEST(tx_coalesce),
     TEST(loopback_onoff),
     TEST(loopback_onoff_zp),
     TEST(format_mismatch),
@@ -134,6 +136,8 @@ static void usage(const char *argv0)
     printf("                                Requires external verification.\n");
     printf("         tx_gmsk_bursts       Transmits GMSK bursts.\n");
     printf("                                Requires external verification.\n");
+    printf("         tx_coalesce          Compares the USB traffic of short bursts\n");
+    printf("                                with and without TX burst coalescing.\n");
     printf("         loopback_onoff       Transmits ON-OFF bursts which are verified\n");
     printf("         loopback_onoff_zp    Transmits ON-OFF bursts with zero-padding,\n");
     printf("                                which are verified via baseband loopback\n");
@@ -0,0 +1,203 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <libbladeRF.h>
+#include "test_timestamps.h"
+
+/* This test transmits a series of short ON bursts, first with each burst end
+ * flushing the sync interface's working buffer, and then with
+ * BLADERF_META_FLAG_TX_COALESCE packing consecutive bursts into shared
+ * buffers. It reports the number of transfers and bytes each approach moved
+ * over USB, and the time spent in bladerf_sync_tx().
+ *
+ * The bursts themselves may be verified externally via a spectrum analyzer;
+ * both passes should look identical.
+ */
+
+#define MAGNITUDE 2000
+
+struct test_case {
+    unsigned int buf_len;
+    unsigned int burst_len;     /* Length of a burst, in samples */
+    unsigned int period;        /* Burst start to start, in samples */
+    unsigned int iterations;
+};
+
+/* The period must be at least a buffer, such that bursts may be scheduled
+ * back-to-back without BLADERF_META_FLAG_TX_COALESCE */
+static const struct test_case tests[] = {
+    { 4096,  16,    4096,   256 },
+    { 4096,  128,   4096,   256 },
+    { 4096,  1006,  4096,   256 },
+    { 16384, 16,    16384,  128 },
+    { 16384, 128,   16384,  128 },
+    { 16384, 1006,  16384,  128 },
+    { 16384, 4000,  16384,  128 },
+};
+
+struct result {
+    uint64_t transfers;
+    uint64_t bytes;
+    uint64_t tx_ns;
+};
+
+static int run(struct bladerf *dev, struct app_params *p,
+               const struct test_case *t, bool coalesce,
+               struct result *r)
+{
+    int status, status_out, status_wait;
+    unsigned int i;
+    struct bladerf_metadata meta;
+    struct bladerf_stream_stats stats;
+    int16_t *samples;
+    uint64_t start;
+
+    samples = calloc(2 * sizeof(int16_t), t->burst_len);
+    if (samples == NULL) {
+        perror("malloc");
+        return BLADERF_ERR_MEM;
+    }
+
+    for (i = 0; i < (2 * t->burst_len); i += 2) {
+        samples[i] = samples[i + 1] = MAGNITUDE;
+    }
+
+    memset(r, 0, sizeof(r[0]));
+    memset(&meta, 0, sizeof(meta));
+
+    status = perform_sync_init(dev, BLADERF_MODULE_TX, t->buf_len, p);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = bladerf_get_timestamp(dev, BLADERF_MODULE_TX, &meta.timestamp);
+    if (status != 0) {
+        fprintf(stderr, "Failed to get timestamp: %s\n",
+                bladerf_strerror(status));
+        goto out;
+    }
+
+    /* Coalesced bursts wait in the working buffer until it fills, so leave
+     * enough lead time for a buffer's worth of them. This is at most one
+     * burst per message, and a message holds at least 252 samples. */
+    meta.timestamp += 200000 + (uint64_t)(t->buf_len / 252 + 1) * t->period;
+
+    for (i = 0; i < t->iterations && status == 0; i++) {
+        meta.flags = BLADERF_META_FLAG_TX_BURST_START |
+                     BLADERF_META_FLAG_TX_BURST_END;
+
+        /* The last burst must flush the working buffer */
+        if (coalesce && i != (t->iterations - 1)) {
+            meta.flags |= BLADERF_META_FLAG_TX_COALESCE;
+        }
+
+        start = bladerf_get_deadline_clock_ns();
+        status = bladerf_sync_tx(dev, samples, t->burst_len, &meta,
+                                 p->timeout_ms);
+        r->tx_ns += bladerf_get_deadline_clock_ns() - start;
+
+        if (status != 0) {
+            fprintf(stderr, "TX failed @ iteration (%u) %s\n",
+                    i, bladerf_strerror(status));
+        } else {
+            meta.timestamp += t->period;
+        }
+    }
+
+    /* Wait for samples to be transmitted before shutting down the TX module */
+    status_wait = wait_for_timestamp(dev, BLADERF_MODULE_TX,
+                                     meta.timestamp, p->timeout_ms);
+    if (status_wait != 0) {
+        status = first_error(status, status_wait);
+        fprintf(stderr, "Failed to wait for TX to finish: %s\n",
+                bladerf_strerror(status_wait));
+    }
+
+    if (status == 0) {
+        status = bladerf_get_sync_stats(dev, BLADERF_TX, &stats);
+        if (status != 0) {
+            fprintf(stderr, "Failed to get TX stats: %s\n",
+                    bladerf_strerror(status));
+        } else {
+            r->transfers = stats.transfers;
+            r->bytes     = stats.bytes;
+        }
+    }
+
+out:
+    status_out = bladerf_enable_module(dev, BLADERF_MODULE_TX, false);
+    if (status_out != 0) {
+        fprintf(stderr, "Failed to disable TX module: %s\n",
+                bladerf_strerror(status_out));
+    }
+
+    status = first_error(status, status_out);
+
+    free(samples);
+    return status;
+}
+
+static void print_result(const char *name, const struct test_case *t,
+                         const struct result *r)
+{
+    const uint64_t payload = 4 * (uint64_t)t->burst_len * t->iterations;
+
+    printf("  %-10s %8" PRIu64 " transfers, %10" PRIu64 " bytes "
+           "(%5.1f%% payload), %8.3f ms in sync_tx\n",
+           name, r->transfers, r->bytes,
+           r->bytes == 0 ? 0.0 : 100.0 * payload / r->bytes,
+           r->tx_ns / 1e6);
+}
+
+int test_fn_tx_coalesce(struct bladerf *dev, struct app_params *p)
+{
+    int status = 0;
+    size_t i;
+    struct result flushed, coalesced;
+
+    for (i = 0; i < ARRAY_SIZE(tests) && status == 0; i++) {
+        printf("\nTest %u: %u bursts of %u samples every %u, "
+               "%u-sample buffers\n", (unsigned int)i + 1,
+               tests[i].iterations, tests[i].burst_len, tests[i].period,
+               tests[i].buf_len);
+
+        status = run(dev, p, &tests[i], false, &flushed);
+        if (status == 0) {
+            status = run(dev, p, &tests[i], true, &coalesced);
+        }
+
+        if (status == 0) {
+            print_result("Flushed:", &tests[i], &flushed);
+            print_result("Coalesced:", &tests[i], &coalesced);
+        }
+    }
+
+    return status;
+}
@@ -31,12 +31,23 @@
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
+#include <inttypes.h>
 #include <libbladeRF.h>
 #include "test_common.h"
 
 #define ITERATIONS 2500u
 #define FIXED_FREQ 2405000000u
 
+/* Settling time table parameters */
+#define SETTLE_BAND_WIDTH   500000000u
+#define SETTLE_ITERATIONS   8u
+
+struct settle_stats {
+    double min_us, max_us, total_us;
+    unsigned int count;
+    unsigned int unlocked;
+};
+
 double fixed_retune(struct bladerf *dev)
 {
     int status;
@@ -181,6 +192,158 @@ double quick_retune(struct bladerf *dev)
     return calc_avg_duration(&start, &end, ITERATIONS);
 }
 
+static void settle_stats_init(struct settle_stats *s)
+{
+    memset(s, 0, sizeof(*s));
+}
+
+/* Record the most recent FPGA retune */
+static int settle_stats_update(struct bladerf *dev, struct settle_stats *s,
+                               bladerf_sample_rate samplerate)
+{
+    int status;
+    struct bladerf_retune_stats stats;
+    double us;
+
+    status = bladerf_get_retune_stats(dev, BLADERF_CHANNEL_RX(0), &stats);
+    if (status != 0) {
+        fprintf(stderr, "Failed to get retune stats: %s\n",
+                bladerf_strerror(status));
+        return status;
+    }
+
+    us = (double)(stats.complete - stats.start) * 1e6 / samplerate;
+
+    if (s->count == 0 || us < s->min_us) {
+        s->min_us = us;
+    }
+
+    if (s->count == 0 || us > s->max_us) {
+        s->max_us = us;
+    }
+
+    s->total_us += us;
+    s->count++;
+
+    if (!stats.locked) {
+        s->unlocked++;
+    }
+
+    return 0;
+}
+
+static void settle_stats_print(const struct settle_stats *s)
+{
+    if (s->count == 0) {
+        printf("  %8s %8s %8s %4s", "-", "-", "-", "-");
+    } else {
+        printf("  %8.1f %8.1f %8.1f %4u", s->min_us, s->total_us / s->count,
+               s->max_us, s->unlocked);
+    }
+}
+
+/* Build a table of the time the FPGA takes to retune and settle, per band.
+ * The timestamp counter must be running for this. */
+int settle_table(struct bladerf *dev, bool full_tune)
+{
+    int status;
+    const struct bladerf_range *range;
+    bladerf_sample_rate samplerate;
+    bladerf_frequency fmin, fmax, band_min, band_max, freq, away;
+    struct bladerf_quick_tune qt;
+    struct settle_stats quick, full;
+    unsigned int i;
+    uint64_t prng;
+
+    randval_init(&prng, 1);
+
+    status = bladerf_get_frequency_range(dev, BLADERF_CHANNEL_RX(0), &range);
+    if (status != 0) {
+        return status;
+    }
+
+    status = bladerf_get_sample_rate(dev, BLADERF_CHANNEL_RX(0), &samplerate);
+    if (status != 0) {
+        return status;
+    }
+
+    fmin = (bladerf_frequency)range->min;
+    fmax = (bladerf_frequency)range->max;
+
+    printf("  %-21s  %26s  %26s\n", "", "Quick tune settling (us)",
+           "Full tune settling (us)");
+    printf("  %-21s  %8s %8s %8s %4s  %8s %8s %8s %4s\n", "Band (MHz)",
+           "min", "avg", "max", "unl", "min", "avg", "max", "unl");
+
+    for (band_min = fmin; band_min < fmax; band_min = band_max) {
+        band_max = band_min + SETTLE_BAND_WIDTH;
+        if (band_max > fmax) {
+            band_max = fmax;
+        }
+
+        settle_stats_init(&quick);
+        settle_stats_init(&full);
+
+        for (i = 0; i < SETTLE_ITERATIONS; i++) {
+            freq = band_min + randval_update(&prng) % (band_max - band_min);
+
+            status = bladerf_set_frequency(dev, BLADERF_CHANNEL_RX(0), freq);
+            if (status != 0) {
+                fprintf(stderr, "Failed to set frequency (%" PRIu64 "): %s\n",
+                        freq, bladerf_strerror(status));
+                return status;
+            }
+
+            if (full_tune) {
+                status = settle_stats_update(dev, &full, samplerate);
+                if (status != 0) {
+                    return status;
+                }
+            }
+
+            status = bladerf_get_quick_tune(dev, BLADERF_CHANNEL_RX(0), &qt);
+            if (status != 0) {
+                fprintf(stderr, "Failed to get quick tune: %s\n",
+                        bladerf_strerror(status));
+                return status;
+            }
+
+            /* Move away from the frequency, so the quick tune has to settle */
+            if (freq < (fmin + fmax) / 2) {
+                away = freq + (fmax - fmin) / 2;
+            } else {
+                away = freq - (fmax - fmin) / 2;
+            }
+
+            status = bladerf_set_frequency(dev, BLADERF_CHANNEL_RX(0), away);
+            if (status != 0) {
+                return status;
+            }
+
+            status = bladerf_schedule_retune(dev, BLADERF_CHANNEL_RX(0),
+                                             BLADERF_RETUNE_NOW, 0, &qt);
+            if (status != 0) {
+                fprintf(stderr, "Failed to quick tune: %s\n",
+                        bladerf_strerror(status));
+                return status;
+            }
+
+            status = settle_stats_update(dev, &quick, samplerate);
+            if (status != 0) {
+                return status;
+            }
+        }
+
+        printf("  %9" PRIu64 " - %9" PRIu64, band_min / 1000000,
+               band_max / 1000000);
+        settle_stats_print(&quick);
+        settle_stats_print(&full);
+        printf("\n");
+    }
+
+    return 0;
+}
+
 int main(int argc, char *argv[])
 {
     int status;
@@ -327,6 +490,36 @@ int main(int argc, char *argv[])
         }
     }
 
+    printf("Measuring retune settling time per band...\n");
+
+    /* Retunes are timed against the RX timestamp counter, which only runs
+     * while RX is enabled with the timestamped sample format. */
+    status = bladerf_sync_config(dev, BLADERF_RX_X1,
+                                 BLADERF_FORMAT_SC16_Q11_META, 16, 8192, 8,
+                                 3500);
+    if (status != 0) {
+        fprintf(stderr, "Failed to configure RX stream: %s\n",
+                bladerf_strerror(status));
+        goto out;
+    }
+
+    status = bladerf_enable_module(dev, BLADERF_CHANNEL_RX(0), true);
+    if (status != 0) {
+        fprintf(stderr, "Failed to enable RX: %s\n",
+                bladerf_strerror(status));
+        goto out;
+    }
+
+    /* bladeRF1 full retunes are only performed by the FPGA in FPGA tuning
+     * mode, and that was the last mode selected above */
+    status = settle_table(dev, strcmp(board_name, "bladerf1") == 0);
+    if (status == BLADERF_ERR_UNSUPPORTED) {
+        printf("  Not supported by this FPGA version.\n");
+        status = 0;
+    }
+
+    bladerf_enable_module(dev, BLADERF_CHANNEL_RX(0), false);
+
 out:
     bladerf_close(dev);
     return status;
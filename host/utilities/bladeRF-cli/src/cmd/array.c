@@ -0,0 +1,1098 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* Capture from several devices at once.
+ *
+ * The devices are opened and configured identically, and captured from as a
+ * bladerf_group: the group arms each device's trigger and starts its stream,
+ * each on its own reader thread, before the master fires the trigger. A
+ * writer thread takes the blocks of every device together, so each file
+ * receives the same blocks, timed from the same trigger. */
+
+#include <inttypes.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <conversions.h>
+
+#include "array.h"
+#include "cmd.h"
+#include "rxtx_impl.h"
+#include "sigmf.h"
+#include "thread.h"
+
+/* Samples per channel in each block, by default */
+#define ARRAY_DEFAULT_BLOCK 32768
+
+/* Stream timeout, which also bounds the wait for the trigger */
+#define ARRAY_STREAM_TIMEOUT_MS 5000
+
+/* Wait for a block to be received, after which a stop request is checked */
+#define ARRAY_POLL_MS 250
+
+/* Stream parameters of each device */
+#define ARRAY_NUM_BUFFERS 32
+#define ARRAY_BUFFER_SIZE 32768
+#define ARRAY_NUM_TRANSFERS 16
+
+/* Bytes per sample per channel, as SC16 Q11 */
+#define ARRAY_SAMPLE_BYTES (2 * sizeof(int16_t))
+
+enum array_fmt {
+    ARRAY_FMT_BIN,   /* Raw SC16 Q11 samples */
+    ARRAY_FMT_SIGMF, /* SC16 Q11 samples with a SigMF metadata file */
+};
+
+struct array_config {
+    /* Applied to every device. 0 (or !gain_set) keeps each device's own. */
+    bladerf_frequency frequency;
+    bladerf_sample_rate samplerate;
+    bladerf_bandwidth bandwidth;
+    bool gain_set;
+    int gain;
+
+    unsigned int channels; /* RX channels per device, 1 or 2 */
+    char *file;            /* Path, in which %s is replaced by the serial */
+    enum array_fmt format;
+    uint64_t n;             /* Samples per channel, or 0 to run until stopped */
+    unsigned int block;     /* Samples per channel in each block */
+    bladerf_trigger_signal trigger;
+    unsigned int master;    /* Index of the device that fires the trigger */
+
+    /* CPU each device's threads are run on. Empty if they aren't pinned. */
+    unsigned int cpus[BLADERF_GROUP_MAX_DEVICES];
+    unsigned int num_cpus;
+};
+
+struct array_member {
+    struct bladerf *dev;
+    char serial[BLADERF_SERIAL_LENGTH];
+    char *path;
+    FILE *out;
+    struct sigmf_meta sigmf;
+
+    /* Protected by array_data.lock */
+    uint64_t samples; /* Samples per channel written, including fill */
+    uint64_t filled;  /* Samples per channel of zeros written over gaps */
+};
+
+struct array_data {
+    struct array_member members[BLADERF_GROUP_MAX_DEVICES];
+    unsigned int num_devices;
+    struct array_config config;
+    struct bladerf_group *group;
+
+    pthread_t thread;
+    bool joinable;
+
+    pthread_mutex_t lock;
+    pthread_cond_t done;
+
+    /* Protected by lock */
+    bool running;
+    bool stop;
+    bool received;         /* The first block has been received */
+    struct timespec start; /* Host time of the first block */
+    struct timespec end;   /* Host time the capture ended */
+    int status;            /* CLI_RET_* result of the capture */
+    int lib_status;        /* libbladeRF error, for CLI_RET_LIBBLADERF */
+};
+
+static struct array_data *array_data_alloc(void)
+{
+    struct array_data *a = calloc(1, sizeof(*a));
+
+    if (a != NULL) {
+        a->config.channels = 1;
+        a->config.format   = ARRAY_FMT_BIN;
+        a->config.block    = ARRAY_DEFAULT_BLOCK;
+        a->config.trigger  = BLADERF_TRIGGER_MINI_EXP_1;
+
+        pthread_mutex_init(&a->lock, NULL);
+        pthread_cond_init(&a->done, NULL);
+    }
+
+    return a;
+}
+
+static double elapsed_sec(const struct timespec *from,
+                          const struct timespec *to)
+{
+    return (double)(to->tv_sec - from->tv_sec) +
+           (double)(to->tv_nsec - from->tv_nsec) / 1e9;
+}
+
+static int write_zeros(FILE *f, const void *zeros, size_t len, uint64_t bytes)
+{
+    while (bytes > 0) {
+        const size_t n = (bytes < len) ? (size_t)bytes : len;
+
+        if (fwrite(zeros, 1, n, f) != n) {
+            return CLI_RET_FILEOP;
+        }
+
+        bytes -= n;
+    }
+
+    return 0;
+}
+
+/* Write one aligned block to every member's file. `gap' blocks were
+ * skipped before it, and are written as zeros to raw files so that a
+ * sample's offset in any file gives its time since the trigger. */
+static int write_block(struct array_data *a,
+                       void *const *samples,
+                       const void *zeros,
+                       uint64_t block,
+                       uint64_t gap)
+{
+    const struct array_config *c = &a->config;
+    const size_t frame           = c->channels * ARRAY_SAMPLE_BYTES;
+    unsigned int i;
+    int status;
+
+    for (i = 0; i < a->num_devices; i++) {
+        struct array_member *m = &a->members[i];
+        uint64_t remaining     = (c->n != 0) ? c->n - m->samples : UINT64_MAX;
+        uint64_t fill          = 0;
+        uint64_t n             = c->block;
+
+        if (c->format == ARRAY_FMT_BIN && gap > 0) {
+            fill = gap * c->block;
+            if (fill > remaining) {
+                fill = remaining;
+            }
+
+            status = write_zeros(m->out, zeros, c->block * frame, fill * frame);
+            if (status != 0) {
+                return status;
+            }
+
+            remaining -= fill;
+        }
+
+        if (n > remaining) {
+            n = remaining;
+        }
+
+        if (n > 0) {
+            if (c->format == ARRAY_FMT_SIGMF) {
+                status = sigmf_meta_block(&m->sigmf, block * c->block,
+                                          (size_t)n);
+                if (status != 0) {
+                    return status;
+                }
+            }
+
+            if (fwrite(samples[i], frame, (size_t)n, m->out) != n) {
+                return CLI_RET_FILEOP;
+            }
+        }
+
+        MUTEX_LOCK(&a->lock);
+        m->samples += fill + n;
+        m->filled += fill;
+        MUTEX_UNLOCK(&a->lock);
+    }
+
+    return 0;
+}
+
+static void *array_capture(void *arg)
+{
+    struct array_data *a         = arg;
+    const struct array_config *c = &a->config;
+    const size_t block_bytes     = c->block * c->channels * ARRAY_SAMPLE_BYTES;
+    void *samples[BLADERF_GROUP_MAX_DEVICES] = { NULL };
+    void *zeros                              = NULL;
+    uint64_t next                            = 0; /* Block expected next */
+    struct timespec start;
+    unsigned int i;
+    int status      = 0;
+    int lib_status  = 0;
+    int stop_status = 0;
+    bool stop       = false;
+
+    zeros = calloc(1, block_bytes);
+    if (zeros == NULL) {
+        status = CLI_RET_MEM;
+    }
+
+    for (i = 0; i < a->num_devices && status == 0; i++) {
+        samples[i] = malloc(block_bytes);
+        if (samples[i] == NULL) {
+            status = CLI_RET_MEM;
+        }
+    }
+
+    while (status == 0 && !stop) {
+        uint64_t block;
+
+        lib_status = bladerf_group_rx(a->group, samples, &block, NULL,
+                                      ARRAY_POLL_MS);
+
+        if (lib_status == BLADERF_ERR_TIMEOUT) {
+            lib_status = 0;
+        } else if (lib_status != 0) {
+            status = CLI_RET_LIBBLADERF;
+            break;
+        } else {
+            if (next == 0) {
+                clock_gettime(CLOCK_REALTIME, &start);
+            }
+
+            status = write_block(a, samples, zeros, block, block - next);
+
+            /* Every member's metadata starts at the same host time */
+            if (next == 0) {
+                for (i = 0; i < a->num_devices; i++) {
+                    a->members[i].sigmf.start = start;
+                }
+
+                MUTEX_LOCK(&a->lock);
+                a->received = true;
+                a->start    = start;
+                MUTEX_UNLOCK(&a->lock);
+            }
+
+            next = block + 1;
+
+            if (c->n != 0 && a->members[0].samples >= c->n) {
+                break;
+            }
+        }
+
+        MUTEX_LOCK(&a->lock);
+        stop = a->stop;
+        MUTEX_UNLOCK(&a->lock);
+    }
+
+    stop_status = bladerf_group_stop(a->group);
+    if (status == 0 && stop_status != 0) {
+        lib_status = stop_status;
+        status     = CLI_RET_LIBBLADERF;
+    }
+
+    for (i = 0; i < a->num_devices; i++) {
+        struct array_member *m = &a->members[i];
+
+        if (fclose(m->out) != 0 && status == 0) {
+            status = CLI_RET_FILEOP;
+        }
+        m->out = NULL;
+
+        if (c->format == ARRAY_FMT_SIGMF) {
+            if (m->sigmf.num_segments > 0) {
+                const int meta_status = sigmf_meta_write(&m->sigmf, m->path);
+                if (status == 0) {
+                    status = meta_status;
+                }
+            }
+            sigmf_meta_deinit(&m->sigmf);
+        }
+
+        free(samples[i]);
+    }
+
+    free(zeros);
+
+    MUTEX_LOCK(&a->lock);
+    clock_gettime(CLOCK_REALTIME, &a->end);
+    a->status     = status;
+    a->lib_status = lib_status;
+    a->running    = false;
+    pthread_cond_broadcast(&a->done);
+    MUTEX_UNLOCK(&a->lock);
+
+    return NULL;
+}
+
+/* Collect a finished capture's thread, returning the capture's result */
+static int array_join(struct cli_state *s, struct array_data *a)
+{
+    int status;
+
+    if (!a->joinable) {
+        return 0;
+    }
+
+    pthread_join(a->thread, NULL);
+    a->joinable = false;
+
+    status = a->status;
+    if (status == CLI_RET_LIBBLADERF) {
+        s->last_lib_error = a->lib_status;
+    }
+
+    return status;
+}
+
+static int array_stop(struct cli_state *s, struct array_data *a)
+{
+    MUTEX_LOCK(&a->lock);
+    a->stop = true;
+    MUTEX_UNLOCK(&a->lock);
+
+    return array_join(s, a);
+}
+
+void array_data_free(struct array_data *a)
+{
+    unsigned int i;
+
+    if (a == NULL) {
+        return;
+    }
+
+    MUTEX_LOCK(&a->lock);
+    a->stop = true;
+    MUTEX_UNLOCK(&a->lock);
+
+    if (a->joinable) {
+        pthread_join(a->thread, NULL);
+    }
+
+    if (a->group != NULL) {
+        bladerf_group_close(a->group);
+    }
+
+    for (i = 0; i < a->num_devices; i++) {
+        bladerf_close(a->members[i].dev);
+        free(a->members[i].path);
+    }
+
+    pthread_cond_destroy(&a->done);
+    pthread_mutex_destroy(&a->lock);
+    free(a->config.file);
+    free(a);
+}
+
+static bool array_is_running(struct array_data *a)
+{
+    bool running;
+
+    MUTEX_LOCK(&a->lock);
+    running = a->running;
+    MUTEX_UNLOCK(&a->lock);
+
+    return running;
+}
+
+static int array_cmd_open(struct cli_state *s, struct array_data *a,
+                          int argc, char **argv)
+{
+    char devstr[BLADERF_SERIAL_LENGTH + 16];
+    int i;
+
+    if (argc < 3) {
+        return CLI_RET_NARGS;
+    }
+
+    if (array_is_running(a)) {
+        return CLI_RET_STATE;
+    }
+
+    for (i = 2; i < argc; i++) {
+        struct array_member *m = &a->members[a->num_devices];
+        struct bladerf_serial sn;
+        const char *id = argv[i];
+        unsigned int j;
+        int status;
+
+        if (a->num_devices == BLADERF_GROUP_MAX_DEVICES) {
+            cli_err(s, argv[0], "An array holds at most %u devices\n",
+                    BLADERF_GROUP_MAX_DEVICES);
+            return CLI_RET_INVPARAM;
+        }
+
+        /* A bare serial (or prefix of one) is the usual way to name a
+         * device, but a full device identifier may be given instead */
+        if (strchr(id, ':') == NULL) {
+            if (snprintf(devstr, sizeof(devstr), "*:serial=%s", id) >=
+                (int)sizeof(devstr)) {
+                cli_err(s, argv[0], "Invalid serial: %s\n", id);
+                return CLI_RET_INVPARAM;
+            }
+            id = devstr;
+        }
+
+        status = bladerf_open(&m->dev, id);
+        if (status == 0) {
+            status = bladerf_get_serial_struct(m->dev, &sn);
+            if (status != 0) {
+                bladerf_close(m->dev);
+            }
+        }
+
+        if (status != 0) {
+            m->dev = NULL;
+            cli_err(s, argv[0], "Failed to open %s: %s\n", argv[i],
+                    bladerf_strerror(status));
+            return CLI_RET_CMD_HANDLED;
+        }
+
+        for (j = 0; j < a->num_devices; j++) {
+            if (!strcmp(a->members[j].serial, sn.serial)) {
+                break;
+            }
+        }
+
+        if (j != a->num_devices) {
+            bladerf_close(m->dev);
+            m->dev = NULL;
+            cli_err(s, argv[0], "%s is already in the array\n", argv[i]);
+            return CLI_RET_INVPARAM;
+        }
+
+        memcpy(m->serial, sn.serial, sizeof(m->serial));
+        a->num_devices++;
+
+        printf("\n  Opened %s as array device %u.\n", m->serial,
+               a->num_devices - 1);
+    }
+
+    printf("\n");
+    return 0;
+}
+
+static int parse_cpus(struct array_config *c, const char *val)
+{
+    unsigned int n = 0;
+    const char *p  = val;
+
+    if (!strcasecmp(val, "none")) {
+        c->num_cpus = 0;
+        return 0;
+    }
+
+    while (*p != '\0') {
+        char *end;
+        unsigned long first, last;
+
+        first = strtoul(p, &end, 10);
+        last  = first;
+        if (end == p) {
+            return -1;
+        }
+
+        if (*end == '-') {
+            p    = end + 1;
+            last = strtoul(p, &end, 10);
+            if (end == p || last < first) {
+                return -1;
+            }
+        }
+
+        for (; first <= last; first++) {
+            if (first >= 64 || n == BLADERF_GROUP_MAX_DEVICES) {
+                return -1;
+            }
+            c->cpus[n++] = (unsigned int)first;
+        }
+
+        if (*end == ',') {
+            end++;
+        } else if (*end != '\0') {
+            return -1;
+        }
+        p = end;
+    }
+
+    c->num_cpus = n;
+    return 0;
+}
+
+static int array_config_param(struct cli_state *s,
+                              struct array_config *c,
+                              const char *argv0,
+                              char *param)
+{
+    char *val = strchr(param, '=');
+    bool ok   = false;
+
+    if (val == NULL || val[1] == '\0') {
+        cli_err(s, argv0, "No value provided for parameter \"%s\"\n", param);
+        return CLI_RET_INVPARAM;
+    }
+
+    *val++ = '\0';
+
+    if (!strcasecmp(param, "frequency")) {
+        bladerf_frequency f = str2uint64_suffix(val, 1, UINT64_MAX,
+                                                freq_suffixes,
+                                                NUM_FREQ_SUFFIXES, &ok);
+        if (ok) {
+            c->frequency = f;
+        }
+    } else if (!strcasecmp(param, "samplerate")) {
+        unsigned int r = str2uint_suffix(val, 1, UINT_MAX, freq_suffixes,
+                                         NUM_FREQ_SUFFIXES, &ok);
+        if (ok) {
+            c->samplerate = r;
+        }
+    } else if (!strcasecmp(param, "bandwidth")) {
+        unsigned int bw = str2uint_suffix(val, 1, UINT_MAX, freq_suffixes,
+                                          NUM_FREQ_SUFFIXES, &ok);
+        if (ok) {
+            c->bandwidth = bw;
+        }
+    } else if (!strcasecmp(param, "gain")) {
+        int gain = str2int(val, -100, 100, &ok);
+        if (ok) {
+            c->gain_set = true;
+            c->gain     = gain;
+        }
+    } else if (!strcasecmp(param, "channels")) {
+        unsigned int n = str2uint(val, 1, 2, &ok);
+        if (ok) {
+            c->channels = n;
+        }
+    } else if (!strcasecmp(param, "file")) {
+        char *file = strdup(val);
+        if (file == NULL) {
+            return CLI_RET_MEM;
+        }
+        free(c->file);
+        c->file = file;
+        ok      = true;
+    } else if (!strcasecmp(param, "format")) {
+        ok = true;
+        if (!strcasecmp(val, "bin")) {
+            c->format = ARRAY_FMT_BIN;
+        } else if (!strcasecmp(val, "sigmf")) {
+            c->format = ARRAY_FMT_SIGMF;
+        } else {
+            ok = false;
+        }
+    } else if (!strcasecmp(param, "n")) {
+        uint64_t n = str2uint64_suffix(val, 0, UINT64_MAX, rxtx_kmg_suffixes,
+                                       rxtx_kmg_suffixes_len, &ok);
+        if (ok) {
+            c->n = n;
+        }
+    } else if (!strcasecmp(param, "block")) {
+        unsigned int n = str2uint_suffix(val, 1, UINT_MAX / 16,
+                                         rxtx_kmg_suffixes,
+                                         rxtx_kmg_suffixes_len, &ok);
+        if (ok) {
+            c->block = n;
+        }
+    } else if (!strcasecmp(param, "trigger")) {
+        bladerf_trigger_signal trigger = str2trigger(val);
+        if (trigger != BLADERF_TRIGGER_INVALID) {
+            c->trigger = trigger;
+            ok         = true;
+        }
+    } else if (!strcasecmp(param, "master")) {
+        unsigned int master =
+            str2uint(val, 0, BLADERF_GROUP_MAX_DEVICES - 1, &ok);
+        if (ok) {
+            c->master = master;
+        }
+    } else if (!strcasecmp(param, "cpus")) {
+        ok = parse_cpus(c, val) == 0;
+    } else {
+        cli_err(s, argv0, "Unrecognized config parameter: %s\n", param);
+        return CLI_RET_INVPARAM;
+    }
+
+    if (!ok) {
+        cli_err(s, argv0, "Invalid %s value (%s)\n", param, val);
+        return CLI_RET_INVPARAM;
+    }
+
+    return 0;
+}
+
+static void array_print_config(struct array_data *a)
+{
+    const struct array_config *c = &a->config;
+    unsigned int i;
+
+    printf("\n  Devices: %u\n", a->num_devices);
+    for (i = 0; i < a->num_devices; i++) {
+        printf("    %2u: %s%s", i, a->members[i].serial,
+               (i == c->master) ? " (master)" : "");
+        if (i < c->num_cpus) {
+            printf(", CPU %u", c->cpus[i]);
+        }
+        printf("\n");
+    }
+
+    printf("\n");
+
+    if (c->frequency != 0) {
+        printf("    Frequency:      %" PRIu64 " Hz\n", c->frequency);
+    }
+    if (c->samplerate != 0) {
+        printf("    Sample rate:    %u sps\n", c->samplerate);
+    }
+    if (c->bandwidth != 0) {
+        printf("    Bandwidth:      %u Hz\n", c->bandwidth);
+    }
+    if (c->gain_set) {
+        printf("    Gain:           %d dB\n", c->gain);
+    }
+
+    printf("    Channels:       %u\n", c->channels);
+    printf("    File:           %s\n",
+           (c->file != NULL) ? c->file : "(not set)");
+    printf("    Format:         %s\n",
+           (c->format == ARRAY_FMT_SIGMF) ? "SigMF" : "bin");
+    if (c->n != 0) {
+        printf("    Samples:        %" PRIu64 "\n", c->n);
+    } else {
+        printf("    Samples:        until stopped\n");
+    }
+    printf("    Block samples:  %u\n", c->block);
+    printf("    Trigger:        %s\n\n", trigger2str(c->trigger));
+}
+
+static int array_cmd_config(struct cli_state *s, struct array_data *a,
+                            int argc, char **argv)
+{
+    int i;
+
+    if (argc == 2) {
+        array_print_config(a);
+        return 0;
+    }
+
+    if (array_is_running(a)) {
+        return CLI_RET_STATE;
+    }
+
+    for (i = 2; i < argc; i++) {
+        const int status = array_config_param(s, &a->config, argv[0], argv[i]);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    return 0;
+}
+
+/* Apply the configuration to every device's RX channels */
+static int array_configure(struct cli_state *s, struct array_data *a,
+                           const char *argv0)
+{
+    const struct array_config *c = &a->config;
+    bladerf_sample_rate rate     = 0;
+    unsigned int i, j;
+    int status = 0;
+
+    for (i = 0; i < a->num_devices; i++) {
+        struct array_member *m = &a->members[i];
+        bladerf_sample_rate actual_rate;
+        bladerf_bandwidth actual_bw;
+        bladerf_frequency freq;
+
+        for (j = 0; j < c->channels && status == 0; j++) {
+            const bladerf_channel ch = BLADERF_CHANNEL_RX(j);
+
+            if (c->samplerate != 0) {
+                status = bladerf_set_sample_rate(m->dev, ch, c->samplerate,
+                                                 &actual_rate);
+            }
+
+            if (status == 0 && c->bandwidth != 0) {
+                status = bladerf_set_bandwidth(m->dev, ch, c->bandwidth,
+                                               &actual_bw);
+            }
+
+            if (status == 0 && c->frequency != 0) {
+                status = bladerf_set_frequency(m->dev, ch, c->frequency);
+            }
+
+            if (status == 0 && c->gain_set) {
+                status = bladerf_set_gain_mode(m->dev, ch, BLADERF_GAIN_MGC);
+                if (status == BLADERF_ERR_UNSUPPORTED) {
+                    status = 0;
+                }
+
+                if (status == 0) {
+                    status = bladerf_set_gain(m->dev, ch, c->gain);
+                }
+            }
+        }
+
+        if (status == 0) {
+            status = bladerf_get_sample_rate(m->dev, BLADERF_CHANNEL_RX(0),
+                                             &actual_rate);
+        }
+
+        if (status == 0) {
+            status =
+                bladerf_get_frequency(m->dev, BLADERF_CHANNEL_RX(0), &freq);
+        }
+
+        if (status != 0) {
+            cli_err(s, argv0, "Failed to configure %s: %s\n", m->serial,
+                    bladerf_strerror(status));
+            return CLI_RET_CMD_HANDLED;
+        }
+
+        /* The files are only aligned if every device samples alike */
+        if (i == 0) {
+            rate = actual_rate;
+        } else if (actual_rate != rate) {
+            cli_err(s, argv0, "%s samples at %u sps, but %s at %u sps\n",
+                    m->serial, actual_rate, a->members[0].serial, rate);
+            return CLI_RET_INVPARAM;
+        }
+
+        sigmf_meta_init(&m->sigmf);
+        m->sigmf.sample_rate  = actual_rate;
+        m->sigmf.frequency    = freq;
+        m->sigmf.num_channels = c->channels;
+        snprintf(m->sigmf.hw, sizeof(m->sigmf.hw),
+                 "%s (serial %s, array device %u of %u)",
+                 bladerf_get_board_name(m->dev), m->serial, i,
+                 a->num_devices);
+    }
+
+    return 0;
+}
+
+/* Substitute the serial for each %s in the path template */
+static char *member_path(const char *template, const char *serial)
+{
+    const size_t serial_len = strlen(serial);
+    size_t len              = strlen(template) + 1;
+    const char *p;
+    char *path, *q;
+
+    for (p = strstr(template, "%s"); p != NULL; p = strstr(p + 2, "%s")) {
+        len += serial_len;
+    }
+
+    path = malloc(len);
+    if (path == NULL) {
+        return NULL;
+    }
+
+    for (p = template, q = path; *p != '\0';) {
+        if (p[0] == '%' && p[1] == 's') {
+            memcpy(q, serial, serial_len);
+            q += serial_len;
+            p += 2;
+        } else {
+            *q++ = *p++;
+        }
+    }
+    *q = '\0';
+
+    return path;
+}
+
+static void close_files(struct array_data *a)
+{
+    unsigned int i;
+
+    for (i = 0; i < a->num_devices; i++) {
+        if (a->members[i].out != NULL) {
+            fclose(a->members[i].out);
+            a->members[i].out = NULL;
+        }
+        sigmf_meta_deinit(&a->members[i].sigmf);
+    }
+}
+
+static int array_cmd_start(struct cli_state *s, struct array_data *a,
+                           const char *argv0)
+{
+    const struct array_config *c = &a->config;
+    struct bladerf_group_config gc;
+    struct bladerf_stream_thread_attrs attrs[BLADERF_GROUP_MAX_DEVICES];
+    struct bladerf *devices[BLADERF_GROUP_MAX_DEVICES];
+    unsigned int i;
+    int status;
+
+    if (a->num_devices == 0) {
+        cli_err(s, argv0, "No devices have been opened\n");
+        return CLI_RET_INVPARAM;
+    }
+
+    if (array_is_running(a)) {
+        return CLI_RET_STATE;
+    }
+
+    if (c->file == NULL) {
+        cli_err(s, argv0, "File not set\n");
+        return CLI_RET_INVPARAM;
+    }
+
+    if (a->num_devices > 1 && strstr(c->file, "%s") == NULL) {
+        cli_err(s, argv0, "File must contain %%s, to be replaced by each "
+                          "device's serial\n");
+        return CLI_RET_INVPARAM;
+    }
+
+    if (c->master >= a->num_devices) {
+        cli_err(s, argv0, "Master %u is not an array device\n", c->master);
+        return CLI_RET_INVPARAM;
+    }
+
+    if (c->num_cpus != 0 && c->num_cpus != a->num_devices) {
+        cli_err(s, argv0, "%u CPUs given for %u devices\n", c->num_cpus,
+                a->num_devices);
+        return CLI_RET_INVPARAM;
+    }
+
+    /* The last capture's result has already been reported, if asked for */
+    array_join(s, a);
+
+    if (a->group != NULL) {
+        bladerf_group_close(a->group);
+        a->group = NULL;
+    }
+
+    status = array_configure(s, a, argv0);
+    if (status != 0) {
+        close_files(a);
+        return status;
+    }
+
+    for (i = 0; i < a->num_devices; i++) {
+        struct array_member *m = &a->members[i];
+
+        free(m->path);
+        m->path    = member_path(c->file, m->serial);
+        m->samples = 0;
+        m->filled  = 0;
+
+        if (m->path == NULL) {
+            close_files(a);
+            return CLI_RET_MEM;
+        }
+
+        status = expand_and_open(m->path, "wb", &m->out);
+        if (status != 0) {
+            close_files(a);
+            return status;
+        }
+
+        devices[i]        = m->dev;
+        attrs[i].cpu_mask = (c->num_cpus != 0) ? (UINT64_C(1) << c->cpus[i])
+                                               : 0;
+        attrs[i].priority = 0;
+    }
+
+    memset(&gc, 0, sizeof(gc));
+    gc.layout         = (c->channels == 2) ? BLADERF_RX_X2 : BLADERF_RX_X1;
+    gc.format         = BLADERF_FORMAT_SC16_Q11_META;
+    gc.num_buffers    = ARRAY_NUM_BUFFERS;
+    gc.buffer_size    = ARRAY_BUFFER_SIZE;
+    gc.num_transfers  = ARRAY_NUM_TRANSFERS;
+    gc.stream_timeout = ARRAY_STREAM_TIMEOUT_MS;
+    gc.block_samples  = c->block;
+    gc.trigger        = c->trigger;
+    gc.master         = c->master;
+    gc.thread_attrs   = (c->num_cpus != 0) ? attrs : NULL;
+
+    status = bladerf_group_open(&a->group, devices, a->num_devices, &gc);
+    if (status == 0) {
+        status = bladerf_group_start(a->group);
+    }
+
+    if (status != 0) {
+        close_files(a);
+        s->last_lib_error = status;
+        return CLI_RET_LIBBLADERF;
+    }
+
+    MUTEX_LOCK(&a->lock);
+    a->running    = true;
+    a->stop       = false;
+    a->received   = false;
+    a->status     = 0;
+    a->lib_status = 0;
+    MUTEX_UNLOCK(&a->lock);
+
+    status = pthread_create(&a->thread, NULL, array_capture, a);
+    if (status != 0) {
+        a->running = false;
+        bladerf_group_stop(a->group);
+        close_files(a);
+        return CLI_RET_UNKNOWN;
+    }
+
+    a->joinable = true;
+    return 0;
+}
+
+static int array_cmd_wait(struct cli_state *s, struct array_data *a,
+                          int argc, char **argv)
+{
+    static const struct numeric_suffix times[] = {
+        { "ms", 1 }, { "s", 1000 }, { "m", 60 * 1000 }, { "h", 60 * 60 * 1000 },
+    };
+
+    unsigned int timeout_ms = 0;
+    struct timespec deadline;
+    bool running;
+    bool ok;
+
+    if (argc > 3) {
+        return CLI_RET_NARGS;
+    }
+
+    if (argc == 3) {
+        timeout_ms = str2uint_suffix(argv[2], 0, UINT_MAX, times,
+                                     sizeof(times) / sizeof(times[0]), &ok);
+        if (!ok) {
+            cli_err(s, argv[0], "Invalid wait timeout: \"%s\"\n", argv[2]);
+            return CLI_RET_INVPARAM;
+        }
+    }
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+
+    MUTEX_LOCK(&a->lock);
+    while (a->running) {
+        if (timeout_ms == 0) {
+            pthread_cond_wait(&a->done, &a->lock);
+        } else if (pthread_cond_timedwait(&a->done, &a->lock, &deadline) != 0) {
+            break;
+        }
+    }
+    running = a->running;
+    MUTEX_UNLOCK(&a->lock);
+
+    return running ? 0 : array_join(s, a);
+}
+
+static int array_cmd_stats(struct cli_state *s, struct array_data *a)
+{
+    const struct array_config *c = &a->config;
+    uint64_t samples[BLADERF_GROUP_MAX_DEVICES];
+    uint64_t filled[BLADERF_GROUP_MAX_DEVICES];
+    uint64_t total = 0;
+    struct timespec start, end;
+    bool running, received;
+    double elapsed = 0;
+    unsigned int i;
+
+    if (a->group == NULL) {
+        printf("\n  No capture has been started.\n\n");
+        return 0;
+    }
+
+    MUTEX_LOCK(&a->lock);
+    running  = a->running;
+    received = a->received;
+    start    = a->start;
+    end      = a->end;
+    for (i = 0; i < a->num_devices; i++) {
+        samples[i] = a->members[i].samples;
+        filled[i]  = a->members[i].filled;
+    }
+    MUTEX_UNLOCK(&a->lock);
+
+    if (running) {
+        clock_gettime(CLOCK_REALTIME, &end);
+    }
+
+    printf("\n  Capture %s.\n\n", running ? "running" : "finished");
+
+    for (i = 0; i < a->num_devices; i++) {
+        struct bladerf_group_stats stats;
+        const int status = bladerf_group_get_stats(a->group, i, &stats);
+
+        if (status != 0) {
+            s->last_lib_error = status;
+            return CLI_RET_LIBBLADERF;
+        }
+
+        printf("    %2u: %" PRIu64 " samples (%" PRIu64 " filled), %" PRIu64
+               " blocks, %" PRIu64 " skipped, %" PRIu64 " discarded, %" PRIu64
+               " overruns\n",
+               i, samples[i], filled[i], stats.blocks, stats.skipped,
+               stats.discarded, stats.overruns);
+
+        total += (samples[i] - filled[i]) * c->channels;
+    }
+
+    if (received) {
+        elapsed = elapsed_sec(&start, &end);
+    }
+
+    if (elapsed > 0) {
+        printf("\n  Throughput: %.2f Msps, %.1f MB/s over %.1f s\n\n",
+               total / elapsed / 1e6,
+               total * ARRAY_SAMPLE_BYTES / elapsed / 1e6, elapsed);
+    } else {
+        printf("\n  Throughput: waiting for the trigger\n\n");
+    }
+
+    return 0;
+}
+
+int cmd_array(struct cli_state *s, int argc, char **argv)
+{
+    struct array_data *a;
+    int status;
+
+    if (s->array == NULL) {
+        s->array = array_data_alloc();
+        if (s->array == NULL) {
+            return CLI_RET_MEM;
+        }
+    }
+
+    a = s->array;
+
+    if (argc == 1 || !strcasecmp(argv[1], "config")) {
+        status = array_cmd_config(s, a, argc == 1 ? 2 : argc, argv);
+    } else if (!strcasecmp(argv[1], "open")) {
+        status = array_cmd_open(s, a, argc, argv);
+    } else if (!strcasecmp(argv[1], "close")) {
+        if (argc != 2) {
+            return CLI_RET_NARGS;
+        }
+
+        status = array_stop(s, a);
+        array_data_free(a);
+        s->array = NULL;
+    } else if (!strcasecmp(argv[1], "start")) {
+        status = (argc == 2) ? array_cmd_start(s, a, argv[0]) : CLI_RET_NARGS;
+    } else if (!strcasecmp(argv[1], "stop")) {
+        status = (argc == 2) ? array_stop(s, a) : CLI_RET_NARGS;
+    } else if (!strcasecmp(argv[1], "wait")) {
+        status = array_cmd_wait(s, a, argc, argv);
+    } else if (!strcasecmp(argv[1], "stats")) {
+        status = (argc == 2) ? array_cmd_stats(s, a) : CLI_RET_NARGS;
+    } else {
+        cli_err(s, argv[0], "Invalid command: \"%s\"\n", argv[1]);
+        status = CLI_RET_INVPARAM;
+    }
+
+    return status;
+}
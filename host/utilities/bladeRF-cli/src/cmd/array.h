@@ -0,0 +1,37 @@
+/**
+ * @file array.h
+ *
+ * @brief Devices opened and captured from together by the array command
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef ARRAY_H__
+#define ARRAY_H__
+
+struct array_data;
+
+/**
+ * Stop any capture in progress, then close the array's devices and free
+ * its state
+ *
+ * @param   a       Array state. May be NULL.
+ */
+void array_data_free(struct array_data *a);
+
+#endif
@@ -21,13 +21,26 @@
 #include <string.h>
 #include <errno.h>
 #include <limits.h>
+#include <inttypes.h>
 #include <libbladeRF.h>
 
+#include "host_config.h"
+
+#if BLADERF_OS_WINDOWS
+#include "nanosleep.h"
+#else
+#include <time.h>
+#endif
+
+#if BLADERF_OS_WINDOWS || BLADERF_OS_OSX
+#include "clock_gettime.h"
+#endif
 #include "dc_calibration.h"
 #include "rel_assert.h"
 #include "calibrate.h"
 #include "common.h"
 #include "cmd.h"
+#include "flash_init_cal.h"
 
 #define MAX_PHASE   4096
 #define MIN_PHASE   (-MAX_PHASE)
@@ -35,6 +48,22 @@
 #define MAX_GAIN    4096
 #define MIN_GAIN    (-MAX_GAIN)
 
+/* bladeRF2 correction tables. See libbladeRF's board/bladerf2/corr_tbl.h for
+ * the packed table data format. */
+#define IQ_TBL_NUM_CHANNELS 2
+#define IQ_TBL_NUM_CORR     4
+#define IQ_TBL_ENTRY_SIZE   (sizeof(uint64_t) + \
+                             IQ_TBL_NUM_CHANNELS * IQ_TBL_NUM_CORR * \
+                             sizeof(int16_t))
+
+/* Time allowed for the AD9361 tracking loops to converge after a retune */
+#define IQ_TBL_SETTLE_NSEC  50000000
+
+struct iq_table_entry {
+    uint64_t frequency;
+    int16_t corr[IQ_TBL_NUM_CHANNELS][IQ_TBL_NUM_CORR];
+};
+
 static int show_lms_cals(struct cli_state *s)
 {
     int status = 0;
@@ -394,51 +423,190 @@ static struct dc_calibration_params * prepare_dc_cal_params(unsigned int f_min,
     return p;
 }
 
-static int save_table_results(const char *filename,
-                              struct bladerf *dev, bladerf_module module,
+/* The packed DC calibration table format is described in libbladeRF's
+ * board/bladerf1/calibration.c. Entries are delta-encoded in blocks of
+ * DC_TBL_BLOCK_LEN, so that libbladeRF can use the table in place. */
+#define DC_TBL_HDR_SIZE     0x20
+#define DC_TBL_IDX_SIZE     (2 * sizeof(uint32_t))
+#define DC_TBL_NUM_VALUES   8
+#define DC_TBL_BASE_SIZE    (sizeof(uint32_t) + \
+                             DC_TBL_NUM_VALUES * sizeof(int16_t))
+#define DC_TBL_BLOCK_LEN    16
+
+/* Worst case size of a delta-encoded entry: a 32-bit frequency and eight
+ * 17-bit differences, at 7 bits per LEB128 byte */
+#define DC_TBL_DELTA_MAX    (5 + DC_TBL_NUM_VALUES * 3)
+
+static inline void put_le16(uint8_t *buf, uint16_t value)
+{
+    value = HOST_TO_LE16(value);
+    memcpy(buf, &value, sizeof(value));
+}
+
+static inline void put_le32(uint8_t *buf, uint32_t value)
+{
+    value = HOST_TO_LE32(value);
+    memcpy(buf, &value, sizeof(value));
+}
+
+static size_t put_varint(uint8_t *buf, uint32_t value)
+{
+    size_t n = 0;
+
+    while (value >= 0x80) {
+        buf[n++] = (uint8_t)(value & 0x7f) | 0x80;
+        value >>= 7;
+    }
+
+    buf[n++] = (uint8_t)value;
+    return n;
+}
+
+static void get_table_values(const struct dc_calibration_params *p,
+                             int16_t values[DC_TBL_NUM_VALUES])
+{
+    values[0] = p->corr_i;
+    values[1] = p->corr_q;
+    values[2] = p->max_dc_i;
+    values[3] = p->max_dc_q;
+    values[4] = p->mid_dc_i;
+    values[5] = p->mid_dc_q;
+    values[6] = p->min_dc_i;
+    values[7] = p->min_dc_q;
+}
+
+static int save_table_results(const char *filename, struct bladerf *dev,
                               const struct dc_calibration_params *params,
                               size_t num_params)
 {
     int status = 0;
     struct bladerf_lms_dc_cals lms_dc_cals;
-    struct bladerf_image *image = NULL;
-    size_t i;
-    size_t off = 0;
-    uint32_t n_frequencies_le = 0;
+    const size_t n_blocks = (num_params + DC_TBL_BLOCK_LEN - 1) /
+                            DC_TBL_BLOCK_LEN;
+    int16_t values[DC_TBL_NUM_VALUES], prev[DC_TBL_NUM_VALUES];
+    uint8_t *buf = NULL, *idx;
+    size_t i, v, off;
+    FILE *f = NULL;
 
-    static const uint16_t magic = HOST_TO_LE16_CONST(0x1ab1);
-    static const uint32_t reserved = HOST_TO_LE32_CONST(0x00000000);
-    static const uint32_t tbl_version = HOST_TO_LE32_CONST(0x00000002);
-    static const size_t lms_data_size = 10; /* 10 uint8_t register values */
+    assert(num_params > 0 && num_params < UINT32_MAX);
+
+    status = bladerf_lms_get_dc_cals(dev, &lms_dc_cals);
+    if (status != 0) {
+        return status;
+    }
 
+    /* Allocate for the worst case and write out only what is used */
+    buf = calloc(1, DC_TBL_HDR_SIZE + n_blocks * DC_TBL_IDX_SIZE +
+                    n_blocks * DC_TBL_BASE_SIZE +
+                    num_params * DC_TBL_DELTA_MAX);
+    if (buf == NULL) {
+        return BLADERF_ERR_MEM;
+    }
 
-    const size_t entry_size = sizeof(uint32_t) +   /* Frequency */
-                              8 * sizeof(int16_t); /* DC I and Q valus */
+    /* Fill in header */
+    put_le16(&buf[0x00], 0x1ab2);
+    put_le16(&buf[0x02], 1);
+    put_le32(&buf[0x04], 2);
+    put_le32(&buf[0x08], (uint32_t) num_params);
+    put_le32(&buf[0x0c], (uint32_t) n_blocks);
+    put_le16(&buf[0x10], DC_TBL_BLOCK_LEN);
+
+    off = 0x12;
+    buf[off++] = (uint8_t)lms_dc_cals.lpf_tuning;
+    buf[off++] = (uint8_t)lms_dc_cals.tx_lpf_i;
+    buf[off++] = (uint8_t)lms_dc_cals.tx_lpf_q;
+    buf[off++] = (uint8_t)lms_dc_cals.rx_lpf_i;
+    buf[off++] = (uint8_t)lms_dc_cals.rx_lpf_q;
+    buf[off++] = (uint8_t)lms_dc_cals.dc_ref;
+    buf[off++] = (uint8_t)lms_dc_cals.rxvga2a_i;
+    buf[off++] = (uint8_t)lms_dc_cals.rxvga2a_q;
+    buf[off++] = (uint8_t)lms_dc_cals.rxvga2b_i;
+    buf[off++] = (uint8_t)lms_dc_cals.rxvga2b_q;
+
+    idx = &buf[DC_TBL_HDR_SIZE];
+    off = DC_TBL_HDR_SIZE + n_blocks * DC_TBL_IDX_SIZE;
 
-    const size_t table_size = num_params * entry_size;
+    for (i = 0; i < num_params; i++) {
+        const uint32_t freq = (uint32_t) params[i].frequency;
 
-    const size_t data_size = sizeof(magic) + sizeof(reserved) +
-                             sizeof(tbl_version) + sizeof(n_frequencies_le) +
-                             lms_data_size + table_size;
+        get_table_values(&params[i], values);
 
-    assert(num_params < UINT32_MAX);
-    assert(data_size <= UINT_MAX);
+        if (i % DC_TBL_BLOCK_LEN == 0) {
+            /* Blocks start with a full entry */
+            put_le32(idx, freq);
+            put_le32(idx + sizeof(uint32_t), (uint32_t) off);
+            idx += DC_TBL_IDX_SIZE;
 
-    n_frequencies_le = HOST_TO_LE32((uint32_t) num_params);
+            put_le32(&buf[off], freq);
+            off += sizeof(uint32_t);
 
-    status = bladerf_lms_get_dc_cals(dev, &lms_dc_cals);
-    if (status != 0) {
-        return status;
+            for (v = 0; v < DC_TBL_NUM_VALUES; v++) {
+                put_le16(&buf[off], (uint16_t) values[v]);
+                off += sizeof(int16_t);
+            }
+        } else {
+            const int32_t df = (int32_t) (freq - params[i - 1].frequency);
+
+            assert(df > 0);
+            off += put_varint(&buf[off], (uint32_t) df);
+
+            for (v = 0; v < DC_TBL_NUM_VALUES; v++) {
+                const int32_t d = (int32_t) values[v] - prev[v];
+                const uint32_t zz = ((uint32_t) d << 1) ^
+                                    (uint32_t) (d >> 31);
+
+                off += put_varint(&buf[off], zz);
+            }
+        }
+
+        memcpy(prev, values, sizeof(prev));
     }
 
-    if (module == BLADERF_MODULE_RX) {
-        image = bladerf_alloc_image(dev, BLADERF_IMAGE_TYPE_RX_DC_CAL,
-                                    0xffffffff, (unsigned int) data_size);
+    f = fopen(filename, "wb");
+    if (f == NULL) {
+        status = (errno == EACCES) ? BLADERF_ERR_PERMISSION : BLADERF_ERR_IO;
     } else {
-        image = bladerf_alloc_image(dev, BLADERF_IMAGE_TYPE_TX_DC_CAL,
-                                    0xffffffff, (unsigned int) data_size);
+        if (fwrite(buf, 1, off, f) != off) {
+            status = BLADERF_ERR_IO;
+        }
+
+        if (fclose(f) != 0 && status == 0) {
+            status = BLADERF_ERR_IO;
+        }
     }
 
+    free(buf);
+    return status;
+}
+
+static int save_iq_table_results(const char *filename,
+                                 struct bladerf *dev, bladerf_direction dir,
+                                 const struct iq_table_entry *entries,
+                                 size_t num_entries)
+{
+    int status;
+    struct bladerf_image *image = NULL;
+    size_t i, c, v;
+    size_t off = 0;
+    uint32_t n_entries_le;
+
+    static const uint16_t magic = HOST_TO_LE16_CONST(0x2ab2);
+    static const uint32_t reserved = HOST_TO_LE32_CONST(0x00000000);
+    static const uint32_t tbl_version = HOST_TO_LE32_CONST(0x00000001);
+
+    const size_t data_size = sizeof(magic) + sizeof(reserved) +
+                             sizeof(tbl_version) + sizeof(n_entries_le) +
+                             num_entries * IQ_TBL_ENTRY_SIZE;
+
+    assert(num_entries < UINT32_MAX);
+    assert(data_size <= UINT_MAX);
+
+    n_entries_le = HOST_TO_LE32((uint32_t) num_entries);
+
+    image = bladerf_alloc_image(dev, (dir == BLADERF_RX) ?
+                                        BLADERF_IMAGE_TYPE_RX_IQ_CAL :
+                                        BLADERF_IMAGE_TYPE_TX_IQ_CAL,
+                                0xffffffff, (unsigned int) data_size);
     if (image == NULL) {
         return BLADERF_ERR_MEM;
     }
@@ -453,76 +621,306 @@ static int save_table_results(const char *filename,
     memcpy(&image->data[off], &tbl_version, sizeof(tbl_version));
     off += sizeof(tbl_version);
 
-    memcpy(&image->data[off], &n_frequencies_le, sizeof(n_frequencies_le));
-    off += sizeof(n_frequencies_le);
+    memcpy(&image->data[off], &n_entries_le, sizeof(n_entries_le));
+    off += sizeof(n_entries_le);
 
-    image->data[off++] = (uint8_t)lms_dc_cals.lpf_tuning;
-    image->data[off++] = (uint8_t)lms_dc_cals.tx_lpf_i;
-    image->data[off++] = (uint8_t)lms_dc_cals.tx_lpf_q;
-    image->data[off++] = (uint8_t)lms_dc_cals.rx_lpf_i;
-    image->data[off++] = (uint8_t)lms_dc_cals.rx_lpf_q;
-    image->data[off++] = (uint8_t)lms_dc_cals.dc_ref;
-    image->data[off++] = (uint8_t)lms_dc_cals.rxvga2a_i;
-    image->data[off++] = (uint8_t)lms_dc_cals.rxvga2a_q;
-    image->data[off++] = (uint8_t)lms_dc_cals.rxvga2b_i;
-    image->data[off++] = (uint8_t)lms_dc_cals.rxvga2b_q;
-
-    for (i = 0; i < num_params; i++) {
-        uint32_t freq;
-        int16_t corr_i, corr_q;
-        int16_t max_dc_i, max_dc_q;
-        int16_t mid_dc_i, mid_dc_q;
-        int16_t min_dc_i, min_dc_q;
-
-        freq   = HOST_TO_LE32((uint32_t) params[i].frequency);
-        corr_i = HOST_TO_LE16(params[i].corr_i);
-        corr_q = HOST_TO_LE16(params[i].corr_q);
-        max_dc_i = HOST_TO_LE16(params[i].max_dc_i);
-        max_dc_q = HOST_TO_LE16(params[i].max_dc_q);
-        mid_dc_i = HOST_TO_LE16(params[i].mid_dc_i);
-        mid_dc_q = HOST_TO_LE16(params[i].mid_dc_q);
-        min_dc_i = HOST_TO_LE16(params[i].min_dc_i);
-        min_dc_q = HOST_TO_LE16(params[i].min_dc_q);
+    for (i = 0; i < num_entries; i++) {
+        uint64_t freq = HOST_TO_LE64(entries[i].frequency);
 
         memcpy(&image->data[off], &freq, sizeof(freq));
         off += sizeof(freq);
 
-        memcpy(&image->data[off], &corr_i, sizeof(corr_i));
-        off += sizeof(corr_q);
+        for (c = 0; c < IQ_TBL_NUM_CHANNELS; c++) {
+            for (v = 0; v < IQ_TBL_NUM_CORR; v++) {
+                int16_t value = HOST_TO_LE16(entries[i].corr[c][v]);
 
-        memcpy(&image->data[off], &corr_q, sizeof(corr_q));
-        off += sizeof(corr_q);
+                memcpy(&image->data[off], &value, sizeof(value));
+                off += sizeof(value);
+            }
+        }
+    }
 
-        memcpy(&image->data[off], &max_dc_i, sizeof(max_dc_i));
-        off += sizeof(max_dc_i);
+    assert(off == data_size);
 
-        memcpy(&image->data[off], &max_dc_q, sizeof(max_dc_q));
-        off += sizeof(max_dc_q);
+    status = bladerf_image_write(dev, image, filename);
 
-        memcpy(&image->data[off], &mid_dc_i, sizeof(mid_dc_i));
-        off += sizeof(mid_dc_i);
+    bladerf_free_image(image);
+    return status;
+}
 
-        memcpy(&image->data[off], &mid_dc_q, sizeof(mid_dc_q));
-        off += sizeof(mid_dc_q);
+static inline bladerf_channel iq_table_channel(bladerf_direction dir,
+                                               size_t c)
+{
+    return (dir == BLADERF_RX) ? BLADERF_CHANNEL_RX(c) : BLADERF_CHANNEL_TX(c);
+}
 
-        memcpy(&image->data[off], &min_dc_i, sizeof(min_dc_i));
-        off += sizeof(min_dc_i);
+/* Record the correction values the AD9361 arrives at for each frequency */
+static int measure_iq_table(struct bladerf *dev, bladerf_direction dir,
+                            struct iq_table_entry *entries, size_t num_entries)
+{
+    const struct timespec settle = { 0, IQ_TBL_SETTLE_NSEC };
+    bool enabled[IQ_TBL_NUM_CHANNELS] = { false, false };
+    size_t i, c, v;
+    int status = 0, disable_status;
+
+    /* The RX tracking loops only run while the receiver is enabled. The TX
+     * corrections come from the quadrature calibration performed while
+     * tuning, so the transmitter is left disabled. */
+    if (dir == BLADERF_RX) {
+        for (c = 0; c < IQ_TBL_NUM_CHANNELS && status == 0; c++) {
+            status = bladerf_enable_module(dev, BLADERF_CHANNEL_RX(c), true);
+            enabled[c] = (status == 0);
+        }
+    }
+
+    for (i = 0; i < num_entries && status == 0; i++) {
+        printf("\r  Measuring @ %" PRIu64 " Hz...", entries[i].frequency);
+        fflush(stdout);
+
+        for (c = 0; c < IQ_TBL_NUM_CHANNELS && status == 0; c++) {
+            status = bladerf_set_frequency(dev, iq_table_channel(dir, c),
+                                           entries[i].frequency);
+        }
+
+        nanosleep(&settle, NULL);
 
-        memcpy(&image->data[off], &min_dc_q, sizeof(min_dc_q));
-        off += sizeof(min_dc_q);
+        for (c = 0; c < IQ_TBL_NUM_CHANNELS && status == 0; c++) {
+            for (v = 0; v < IQ_TBL_NUM_CORR && status == 0; v++) {
+                status = bladerf_get_correction(dev, iq_table_channel(dir, c),
+                                                (bladerf_correction) v,
+                                                &entries[i].corr[c][v]);
+            }
+        }
     }
 
-    status = bladerf_image_write(dev, image, filename);
+    putchar('\n');
+
+    for (c = 0; c < IQ_TBL_NUM_CHANNELS; c++) {
+        if (enabled[c]) {
+            disable_status = bladerf_enable_module(dev, BLADERF_CHANNEL_RX(c),
+                                                   false);
+            if (status == 0) {
+                status = disable_status;
+            }
+        }
+    }
+
+    return status;
+}
+
+static int cal_table_iq(struct cli_state *s, int argc, char **argv)
+{
+    int status;
+    bool ok;
+    bladerf_direction dir;
+    struct bladerf_serial serial;
+    const struct bladerf_range *range = NULL;
+    char filename[BLADERF_SERIAL_LENGTH + 16];
+    FILE *write_check = NULL;
+
+    struct iq_table_entry *entries = NULL;
+    size_t num_entries, i;
+
+    uint64_t f_min, f_max;
+    uint64_t f_inc = 10000000;
+
+    if (!s->dev_info.is_bladerf_micro) {
+        cli_err(s, argv[0], "IQ correction tables are only supported on"
+                            " bladeRF xA4 and xA9 devices.\n");
+        return CLI_RET_INVPARAM;
+    }
+
+    if (argc != 4 && argc != 6 && argc != 7) {
+        return CLI_RET_NARGS;
+    }
+
+    if (!strcasecmp(argv[3], "rx")) {
+        dir = BLADERF_RX;
+    } else if (!strcasecmp(argv[3], "tx")) {
+        dir = BLADERF_TX;
+    } else {
+        cli_err(s, argv[0], "Invalid module: %s\n", argv[3]);
+        return CLI_RET_INVPARAM;
+    }
+
+    status = bladerf_get_frequency_range(s->dev, iq_table_channel(dir, 0),
+                                         &range);
+    if (status != 0) {
+        goto out;
+    }
+
+    f_min = (uint64_t) range->min;
+    f_max = (uint64_t) range->max;
+
+    if (argc >= 6) {
+        f_min = str2uint64_suffix(argv[4], (uint64_t) range->min,
+                                  (uint64_t) range->max, freq_suffixes,
+                                  NUM_FREQ_SUFFIXES, &ok);
+        if (!ok) {
+            cli_err(s, argv[0], "Invalid min frequency (%s)\n", argv[4]);
+            return CLI_RET_INVPARAM;
+        }
+
+        f_max = str2uint64_suffix(argv[5], (uint64_t) range->min,
+                                  (uint64_t) range->max, freq_suffixes,
+                                  NUM_FREQ_SUFFIXES, &ok);
+        if (!ok) {
+            cli_err(s, argv[0], "Invalid max frequency (%s)\n", argv[5]);
+            return CLI_RET_INVPARAM;
+        }
+
+        if (argc >= 7) {
+            f_inc = str2uint64_suffix(argv[6], 1, (uint64_t) range->max,
+                                      freq_suffixes, NUM_FREQ_SUFFIXES, &ok);
+            if (!ok) {
+                cli_err(s, argv[0],
+                        "Invalid frequency increment (%s)\n", argv[6]);
+                return CLI_RET_INVPARAM;
+            }
+        }
+    }
+
+    if (f_min >= f_max) {
+        cli_err(s, argv[0], "Low frequency cannot be >= high frequency\n");
+        return CLI_RET_INVPARAM;
+    }
+
+    if (((f_max - f_min) / f_inc) == 0) {
+        cli_err(s, argv[0], "The specified frequency increment would yield "
+                            "an empty table.\n");
+
+        return CLI_RET_INVPARAM;
+    }
+
+    status = bladerf_get_serial_struct(s->dev, &serial);
+    if (status != 0) {
+        goto out;
+    }
+
+    snprintf(filename, sizeof(filename), "%s_iq_%s.tbl", serial.serial,
+             (dir == BLADERF_RX) ? "rx" : "tx");
+
+    /* As with DC tables, check for write access before kicking things off */
+    write_check = fopen(filename, "wb");
+    if (!write_check) {
+        if (errno == EACCES) {
+            status = BLADERF_ERR_PERMISSION;
+        } else {
+            status = BLADERF_ERR_IO;
+        }
+        goto out;
+    }
+
+    fclose(write_check);
+    write_check = NULL;
+    (void) remove(filename);
+
+    num_entries = (size_t) ((f_max - f_min) / f_inc) + 1;
+
+    entries = calloc(num_entries, sizeof(entries[0]));
+    if (entries == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto out;
+    }
+
+    for (i = 0; i < num_entries; i++) {
+        entries[i].frequency = f_min + i * f_inc;
+    }
+
+    /* Measure what the AD9361 calibrations and tracking loops produce,
+     * rather than the values of a table already in use */
+    status = bladerf_load_correction_table(s->dev, dir, NULL);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = measure_iq_table(s->dev, dir, entries, num_entries);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = save_iq_table_results(filename, s->dev, dir, entries,
+                                   num_entries);
+    if (status == 0) {
+        printf("\n  Wrote %s. Copy it to a libbladeRF search directory to "
+               "apply it when the device is next opened.\n\n", filename);
+    }
+
+out:
+    if (status != 0) {
+        s->last_lib_error = status;
+        status = CLI_RET_LIBBLADERF;
+    }
+
+    free(entries);
 
-    bladerf_free_image(image);
     return status;
 }
 
 /* See libbladeRF's dc_cal_table.c for the packed table data format */
+/* Parse the optional [<f_min> <f_max> [f_inc]] arguments of a DC table
+ * command, starting at argv[first] */
+static int get_dc_table_freqs(struct cli_state *s, int argc, char **argv,
+                              int first, unsigned int *f_min,
+                              unsigned int *f_max, unsigned int *f_inc)
+{
+    bool ok;
+
+    /* The XB-200 does not affect the minimum, as we're tuning the LMS here. */
+    *f_min = BLADERF_FREQUENCY_MIN;
+    *f_max = BLADERF_FREQUENCY_MAX;
+    *f_inc = 10000000;
+
+    if (argc >= first + 2) {
+        *f_min = str2uint_suffix(argv[first],
+                                 BLADERF_FREQUENCY_MIN, BLADERF_FREQUENCY_MAX,
+                                 freq_suffixes, NUM_FREQ_SUFFIXES, &ok);
+
+        if (!ok) {
+            cli_err(s, argv[0], "Invalid min frequency (%s)\n", argv[first]);
+            return CLI_RET_INVPARAM;
+        }
+
+        *f_max = str2uint_suffix(argv[first + 1],
+                                 BLADERF_FREQUENCY_MIN, BLADERF_FREQUENCY_MAX,
+                                 freq_suffixes, NUM_FREQ_SUFFIXES, &ok);
+
+        if (!ok) {
+            cli_err(s, argv[0], "Invalid max frequency (%s)\n",
+                    argv[first + 1]);
+            return CLI_RET_INVPARAM;
+        }
+
+        if (argc >= first + 3) {
+            *f_inc = str2uint_suffix(argv[first + 2], 1, BLADERF_FREQUENCY_MAX,
+                                     freq_suffixes, NUM_FREQ_SUFFIXES, &ok);
+
+            if (!ok) {
+                cli_err(s, argv[0],
+                        "Invalid frequency increment (%s)\n", argv[first + 2]);
+                return CLI_RET_INVPARAM;
+            }
+        }
+    }
+
+    if (*f_min >= *f_max) {
+        cli_err(s, argv[0], "Low frequency cannot be >= high frequency\n");
+        return CLI_RET_INVPARAM;
+    }
+
+    if (((*f_max - *f_min) / *f_inc) == 0) {
+        cli_err(s, argv[0], "The specified frequency increment would yield "
+                            "an empty table.\n");
+
+        return CLI_RET_INVPARAM;
+    }
+
+    return 0;
+}
+
 static int cal_table(struct cli_state *s, int argc, char **argv)
 {
     int status;
-    bool ok;
     bladerf_module module;
     char *filename = NULL;
     size_t filename_len = 1024;
@@ -531,10 +929,11 @@ static int cal_table(struct cli_state *s, int argc, char **argv)
     struct dc_calibration_params *params = NULL;
     size_t num_params = 0;
 
-    /* The XB-200 does not affect the minimum, as we're tuning the LMS here. */
-    unsigned int f_min = BLADERF_FREQUENCY_MIN;
-    unsigned int f_inc = 10000000;
-    unsigned int f_max = BLADERF_FREQUENCY_MAX;
+    unsigned int f_min, f_max, f_inc;
+
+    if (argc >= 3 && !strcasecmp(argv[2], "iq")) {
+        return cal_table_iq(s, argc, argv);
+    }
 
     if (!s->dev_info.is_bladerf_x40_x115) {
        cli_err(s, argv[0], "Only use this calibration on"
@@ -543,8 +942,7 @@ static int cal_table(struct cli_state *s, int argc, char **argv)
     }
 
     if (argc == 4 || argc == 6 || argc == 7) {
-        /* Only DC tables are currently supported.
-         * IQ tables may be added in the future */
+        /* IQ tables are handled by cal_table_iq() */
         if (strcasecmp(argv[2], "dc") && strcasecmp(argv[2], "agc")) {
             cli_err(s, argv[0], "Invalid table type: %s\n", argv[2]);
             return CLI_RET_INVPARAM;
@@ -580,48 +978,9 @@ static int cal_table(struct cli_state *s, int argc, char **argv)
         }
     }
 
-    if (argc >= 6) {
-        f_min = str2uint_suffix(argv[4],
-                                BLADERF_FREQUENCY_MIN, BLADERF_FREQUENCY_MAX,
-                                freq_suffixes, NUM_FREQ_SUFFIXES, &ok);
-
-        if (!ok) {
-            cli_err(s, argv[0], "Invalid min frequency (%s)\n", argv[4]);
-            return CLI_RET_INVPARAM;
-        }
-
-        f_max = str2uint_suffix(argv[5],
-                                BLADERF_FREQUENCY_MIN, BLADERF_FREQUENCY_MAX,
-                                freq_suffixes, NUM_FREQ_SUFFIXES, &ok);
-
-        if (!ok) {
-            cli_err(s, argv[0], "Invalid max frequency (%s)\n", argv[5]);
-            return CLI_RET_INVPARAM;
-        }
-
-        if (argc >= 7) {
-            f_inc = str2uint_suffix(argv[6], 1, BLADERF_FREQUENCY_MAX,
-                                    freq_suffixes, NUM_FREQ_SUFFIXES, &ok);
-
-            if (!ok) {
-                cli_err(s, argv[0],
-                        "Invalid frequency increment (%s)\n", argv[6]);
-                return CLI_RET_INVPARAM;
-            }
-        }
-
-    }
-
-    if (f_min >= f_max) {
-        cli_err(s, argv[0], "Low frequency cannot be >= high frequency\n");
-        return CLI_RET_INVPARAM;
-    }
-
-    if (((f_max - f_min) / f_inc) == 0) {
-        cli_err(s, argv[0], "The specified frequency increment would yield "
-                            "an empty table.\n");
-
-        return CLI_RET_INVPARAM;
+    status = get_dc_table_freqs(s, argc, argv, 4, &f_min, &f_max, &f_inc);
+    if (status != 0) {
+        return status;
     }
 
     filename = calloc(1, filename_len + 1);
@@ -673,7 +1032,7 @@ static int cal_table(struct cli_state *s, int argc, char **argv)
         goto out;
     }
 
-    status = save_table_results(filename, s->dev, module, params, num_params);
+    status = save_table_results(filename, s->dev, params, num_params);
     if (status == 0) {
         printf("\n  Done.\n\n");
     }
@@ -690,6 +1049,303 @@ out:
     return status;
 }
 
+/* A board calibrated by `calibrate batch` */
+struct batch_board {
+    struct bladerf *dev;
+    bool opened;                        /* Opened here, rather than the CLI's
+                                         * current device */
+    char serial[BLADERF_SERIAL_LENGTH];
+    int status;
+};
+
+static int batch_open_boards(struct cli_state *s, struct batch_board **boards,
+                             size_t *num_boards)
+{
+    struct bladerf_devinfo *list = NULL;
+    struct bladerf_serial serial;
+    struct batch_board *b;
+    int n, i, status;
+
+    n = bladerf_get_device_list(&list);
+    if (n < 0) {
+        return n;
+    }
+
+    status = bladerf_get_serial_struct(s->dev, &serial);
+    if (status != 0) {
+        goto out;
+    }
+
+    *boards = calloc((size_t) n, sizeof((*boards)[0]));
+    if (*boards == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto out;
+    }
+
+    *num_boards = 0;
+
+    for (i = 0; i < n; i++) {
+        b = &(*boards)[*num_boards];
+
+        /* The device already open in the CLI cannot be opened again */
+        if (!strcmp(list[i].serial, serial.serial)) {
+            b->dev = s->dev;
+            b->opened = false;
+        } else {
+            status = bladerf_open_with_devinfo(&b->dev, &list[i]);
+            if (status != 0) {
+                printf("  %s: failed to open: %s\n", list[i].serial,
+                       bladerf_strerror(status));
+                continue;
+            }
+
+            b->opened = true;
+        }
+
+        snprintf(b->serial, sizeof(b->serial), "%s", list[i].serial);
+
+        if (strcmp(bladerf_get_board_name(b->dev), "bladerf1")) {
+            printf("  %s: skipping, not a bladeRF x40 or x115.\n", b->serial);
+        } else if (bladerf_is_fpga_configured(b->dev) != 1) {
+            printf("  %s: skipping, FPGA is not loaded.\n", b->serial);
+        } else {
+            (*num_boards)++;
+            continue;
+        }
+
+        if (b->opened) {
+            bladerf_close(b->dev);
+        }
+
+        memset(b, 0, sizeof(*b));
+    }
+
+    status = 0;
+
+out:
+    bladerf_free_device_list(list);
+    return status;
+}
+
+static void batch_close_boards(struct batch_board *boards, size_t num_boards)
+{
+    size_t i;
+
+    for (i = 0; i < num_boards; i++) {
+        if (boards[i].opened) {
+            bladerf_close(boards[i].dev);
+        }
+    }
+
+    free(boards);
+}
+
+/* Write a calibrated board's table and, if requested, its calibration
+ * region. Returns the first failure. */
+static int batch_save_board(struct batch_board *b,
+                            const struct dc_calibration_job *jobs,
+                            size_t num_jobs, bool flash)
+{
+    char filename[BLADERF_SERIAL_LENGTH + 16];
+    bladerf_fpga_size fpga_size;
+    uint16_t trim;
+    size_t i;
+    int status;
+
+    for (i = 0; i < num_jobs; i++) {
+        if (jobs[i].dev != b->dev) {
+            continue;
+        }
+
+        if (jobs[i].status != 0) {
+            return jobs[i].status;
+        }
+
+        snprintf(filename, sizeof(filename), "%s_dc_%s.tbl", b->serial,
+                 (jobs[i].module == BLADERF_MODULE_RX) ? "rx" : "tx");
+
+        status = save_table_results(filename, b->dev, jobs[i].params,
+                                    jobs[i].num_params);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    if (!flash) {
+        return 0;
+    }
+
+    status = bladerf_get_fpga_size(b->dev, &fpga_size);
+    if (status != 0) {
+        return status;
+    }
+
+    status = bladerf_get_vctcxo_trim(b->dev, &trim);
+    if (status != 0) {
+        return status;
+    }
+
+    return flash_init_cal_write(b->dev, fpga_size, trim);
+}
+
+static int cal_batch(struct cli_state *s, int argc, char **argv)
+{
+    int status;
+    bool do_rx, do_tx;
+    bool flash = false;
+    unsigned int f_min, f_max, f_inc;
+    struct timespec start, end;
+    double elapsed;
+
+    struct batch_board *boards = NULL;
+    size_t num_boards = 0, num_ok = 0;
+
+    struct dc_calibration_job *jobs = NULL;
+    size_t num_jobs = 0;
+    size_t i;
+
+    if (argc >= 4 && !strcasecmp(argv[argc - 1], "flash")) {
+        flash = true;
+        argc--;
+    }
+
+    if (argc != 3 && argc != 5 && argc != 6) {
+        return CLI_RET_NARGS;
+    }
+
+    if (!strcasecmp(argv[2], "rx")) {
+        do_rx = true;
+        do_tx = false;
+    } else if (!strcasecmp(argv[2], "tx")) {
+        do_rx = false;
+        do_tx = true;
+    } else if (!strcasecmp(argv[2], "rxtx")) {
+        do_rx = true;
+        do_tx = true;
+    } else {
+        cli_err(s, argv[0], "Invalid module: %s\n", argv[2]);
+        return CLI_RET_INVPARAM;
+    }
+
+    status = get_dc_table_freqs(s, argc, argv, 3, &f_min, &f_max, &f_inc);
+    if (status != 0) {
+        return status;
+    }
+
+    putchar('\n');
+
+    status = batch_open_boards(s, &boards, &num_boards);
+    if (status != 0) {
+        goto out;
+    }
+
+    if (num_boards == 0) {
+        printf("  No bladeRF x40 or x115 devices to calibrate.\n\n");
+        status = BLADERF_ERR_NODEV;
+        goto out;
+    }
+
+    jobs = calloc(num_boards * 2, sizeof(jobs[0]));
+    if (jobs == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto out;
+    }
+
+    status = clock_gettime(CLOCK_REALTIME, &start);
+    if (status != 0) {
+        status = BLADERF_ERR_UNEXPECTED;
+        goto out;
+    }
+
+    printf("  Calibrating %u board(s)...\n", (unsigned int) num_boards);
+    fflush(stdout);
+
+    /* The LMS6002D calibrations are brief, so these are run one board at a
+     * time before the table sweeps are started concurrently */
+    for (i = 0; i < num_boards; i++) {
+        boards[i].status = dc_calibration_lms6(boards[i].dev, "all");
+        if (boards[i].status != 0) {
+            continue;
+        }
+
+        /* RX first, as the TX calibration uses the RX module */
+        if (do_rx) {
+            jobs[num_jobs].dev = boards[i].dev;
+            jobs[num_jobs].module = BLADERF_MODULE_RX;
+            jobs[num_jobs].params =
+                prepare_dc_cal_params(f_min, f_max, f_inc,
+                                      &jobs[num_jobs].num_params);
+            num_jobs++;
+        }
+
+        if (do_tx) {
+            jobs[num_jobs].dev = boards[i].dev;
+            jobs[num_jobs].module = BLADERF_MODULE_TX;
+            jobs[num_jobs].params =
+                prepare_dc_cal_params(f_min, f_max, f_inc,
+                                      &jobs[num_jobs].num_params);
+            num_jobs++;
+        }
+    }
+
+    for (i = 0; i < num_jobs; i++) {
+        if (jobs[i].params == NULL) {
+            status = BLADERF_ERR_MEM;
+            goto out;
+        }
+    }
+
+    if (num_jobs > 0) {
+        /* Per-job results are checked below */
+        (void) dc_calibration_multi(jobs, num_jobs);
+    }
+
+    for (i = 0; i < num_boards; i++) {
+        if (boards[i].status == 0) {
+            boards[i].status = batch_save_board(&boards[i], jobs, num_jobs,
+                                                flash);
+        }
+
+        if (boards[i].status == 0) {
+            printf("  %s: OK\n", boards[i].serial);
+            num_ok++;
+        } else {
+            printf("  %s: FAILED (%s)\n", boards[i].serial,
+                   bladerf_strerror(boards[i].status));
+            status = boards[i].status;
+        }
+    }
+
+    if (clock_gettime(CLOCK_REALTIME, &end) == 0) {
+        elapsed = (end.tv_sec - start.tv_sec) +
+                  (end.tv_nsec - start.tv_nsec) / 1e9;
+
+        printf("\n  Calibrated %u of %u board(s) in %.1f s",
+               (unsigned int) num_ok, (unsigned int) num_boards, elapsed);
+
+        if (elapsed > 0) {
+            printf(" (%.1f boards/hour)", num_ok * 3600.0 / elapsed);
+        }
+
+        printf(".\n\n");
+    }
+
+out:
+    if (status != 0) {
+        s->last_lib_error = status;
+        status = CLI_RET_LIBBLADERF;
+    }
+
+    for (i = 0; i < num_jobs; i++) {
+        free(jobs[i].params);
+    }
+
+    free(jobs);
+    batch_close_boards(boards, num_boards);
+
+    return status;
+}
+
 int cmd_calibrate(struct cli_state *state, int argc, char **argv)
 {
     int status;
@@ -699,6 +1355,8 @@ int cmd_calibrate(struct cli_state *state, int argc, char **argv)
             status = cal_lms(state, argc, argv);
         } else if (!strcasecmp(argv[1], "table")) {
             status = cal_table(state, argc, argv);
+        } else if (!strcasecmp(argv[1], "batch")) {
+            status = cal_batch(state, argc, argv);
         } else if (!strcasecmp(argv[1], "dc")) {
             status = cal_dc_correction_params(state, argc, argv);
         } else if (!strcasecmp(argv[1], "iq")) {
@@ -34,6 +34,7 @@
     int cmd_##x(struct cli_state *, int, char **); \
     static char const *cmd_names_##x[] = { __VA_ARGS__, NULL };
 
+DECLARE_CMD(array, "array");
 DECLARE_CMD(calibrate, "calibrate", "cal");
 DECLARE_CMD(clear, "clear", "cls");
 DECLARE_CMD(echo, "echo");
@@ -43,6 +44,7 @@ DECLARE_CMD(flash_image, "flash_image", "fi");
 DECLARE_CMD(flash_init_cal, "flash_init_cal", "fic");
 DECLARE_CMD(flash_restore, "flash_restore", "fr");
 DECLARE_CMD(fw_log, "fw_log");
+DECLARE_CMD(fw_stats, "fw_stats");
 DECLARE_CMD(help, "help", "h", "?");
 DECLARE_CMD(info, "info", "i");
 DECLARE_CMD(jump_to_bootloader, "jump_to_boot", "j");
@@ -58,8 +60,11 @@ DECLARE_CMD(recover, "recover", "r");
 DECLARE_CMD(run, "run");
 DECLARE_CMD(rx, "rx", "receive");
 DECLARE_CMD(set, "set", "s");
+DECLARE_CMD(trace, "trace");
 DECLARE_CMD(trigger, "trigger", "tr");
+DECLARE_CMD(tune_host, "tune_host", "tune-host");
 DECLARE_CMD(tx, "tx", "transmit");
+DECLARE_CMD(usb_bench, "usb_bench");
 DECLARE_CMD(version, "version", "ver", "v");
 DECLARE_CMD(xb, "xb");
 
@@ -78,6 +83,15 @@ struct cmd {
 
 // clang-format off
 static struct cmd const cmd_table[] = {
+    {
+        FIELD_INIT(.names, cmd_names_array),
+        FIELD_INIT(.exec, cmd_array),
+        FIELD_INIT(.desc, "Capture from several devices at once"),
+        FIELD_INIT(.help, CLI_CMD_HELPTEXT_array),
+        FIELD_INIT(.requires_device, false),
+        FIELD_INIT(.requires_fpga, false),
+        FIELD_INIT(.allow_while_streaming, true),
+    },
     {
         FIELD_INIT(.names, cmd_names_calibrate),
         FIELD_INIT(.exec, cmd_calibrate),
@@ -161,6 +175,15 @@ static struct cmd const cmd_table[] = {
         FIELD_INIT(.requires_fpga, false),
         FIELD_INIT(.allow_while_streaming, true),
     },
+    {
+        FIELD_INIT(.names, cmd_names_fw_stats),
+        FIELD_INIT(.exec, cmd_fw_stats),
+        FIELD_INIT(.desc, "Read or reset FX3 sample path counters"),
+        FIELD_INIT(.help, CLI_CMD_HELPTEXT_fw_stats),
+        FIELD_INIT(.requires_device, true),
+        FIELD_INIT(.requires_fpga, false),
+        FIELD_INIT(.allow_while_streaming, true),
+    },
     {
         FIELD_INIT(.names, cmd_names_help),
         FIELD_INIT(.exec, cmd_help),
@@ -299,6 +322,15 @@ static struct cmd const cmd_table[] = {
         FIELD_INIT(.requires_fpga, true),
         FIELD_INIT(.allow_while_streaming, true),
     },
+    {
+        FIELD_INIT(.names, cmd_names_trace),
+        FIELD_INIT(.exec, cmd_trace),
+        FIELD_INIT(.desc, "Trace control-path transactions"),
+        FIELD_INIT(.help, CLI_CMD_HELPTEXT_trace),
+        FIELD_INIT(.requires_device, true),
+        FIELD_INIT(.requires_fpga, false),
+        FIELD_INIT(.allow_while_streaming, true),
+    },
     {
         FIELD_INIT(.names, cmd_names_trigger),
         FIELD_INIT(.exec, cmd_trigger),
@@ -309,6 +341,15 @@ static struct cmd const cmd_table[] = {
         FIELD_INIT(.allow_while_streaming, true),   /* Can control trigger 
                                                      * while running */
     },
+    {
+        FIELD_INIT(.names, cmd_names_tune_host),
+        FIELD_INIT(.exec, cmd_tune_host),
+        FIELD_INIT(.desc, "Find the lowest-latency stream sizing for this host"),
+        FIELD_INIT(.help, CLI_CMD_HELPTEXT_tune_host),
+        FIELD_INIT(.requires_device, true),
+        FIELD_INIT(.requires_fpga, true),
+        FIELD_INIT(.allow_while_streaming, false),
+    },
     {
         FIELD_INIT(.names, cmd_names_tx),
         FIELD_INIT(.exec, cmd_tx),
@@ -318,6 +359,15 @@ static struct cmd const cmd_table[] = {
         FIELD_INIT(.requires_fpga, true),
         FIELD_INIT(.allow_while_streaming, true),   /* Can tx while rx'ing */
     },
+    {
+        FIELD_INIT(.names, cmd_names_usb_bench),
+        FIELD_INIT(.exec, cmd_usb_bench),
+        FIELD_INIT(.desc, "Benchmark USB via the FX3 firmware loopback"),
+        FIELD_INIT(.help, CLI_CMD_HELPTEXT_usb_bench),
+        FIELD_INIT(.requires_device, true),
+        FIELD_INIT(.requires_fpga, true),
+        FIELD_INIT(.allow_while_streaming, false),
+    },
     {
         FIELD_INIT(.names, cmd_names_version),
         FIELD_INIT(.exec, cmd_version),
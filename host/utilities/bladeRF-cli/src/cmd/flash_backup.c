@@ -43,8 +43,6 @@ static uint32_t const LEGACY_FLASH_BYTE_LEN_FPGA = 0x00370000;
 int cmd_flash_backup(struct cli_state *state, int argc, char **argv)
 {
     int status = 0;
-    struct bladerf_devinfo info;
-    struct bladerf_image *image = NULL;
     bladerf_image_type image_type;
     uint32_t address, length;
     char *filename = NULL;
@@ -106,37 +104,14 @@ int cmd_flash_backup(struct cli_state *state, int argc, char **argv)
         image_type = BLADERF_IMAGE_TYPE_RAW;
     }
 
-    image = bladerf_alloc_image(state->dev, image_type, address, length);
-    if (!image) {
-        status = CLI_RET_MEM;
-        goto out;
-    }
-
-    status = bladerf_get_devinfo(state->dev, &info);
-    if (status < 0) {
-        lib_error(status, "Failed to get serial number");
-        goto out;
-    }
-
-    strncpy(image->serial, info.serial, BLADERF_SERIAL_LENGTH);
-
-    status = bladerf_read_flash_bytes(state->dev, image->data, address, length);
+    status = bladerf_image_backup(state->dev, image_type, address, length,
+                                  filename);
     if (status < 0) {
-        lib_error(status, "Failed to read flash region");
-        goto out;
-    }
-
-    status = bladerf_image_write(state->dev, image, filename);
-    if (status < 0) {
-        lib_error(status, "Failed to write image file.");
+        lib_error(status, "Failed to back up flash region to image file.");
         goto out;
     }
 
 out:
-    if (image) {
-        bladerf_free_image(image);
-    }
-
     if (filename) {
         free(filename);
     }
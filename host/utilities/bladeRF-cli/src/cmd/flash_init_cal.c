@@ -28,6 +28,7 @@
 
 #include "conversions.h"
 #include "cmd.h"
+#include "flash_init_cal.h"
 #include "input.h"
 #include "minmax.h"
 #include "rel_assert.h"
@@ -51,6 +52,28 @@ int str2fpga(const char *str, bladerf_fpga_size *fpga_size)
     }
 }
 
+int flash_init_cal_write(struct bladerf *dev, bladerf_fpga_size fpga_size,
+                         uint16_t dac)
+{
+    int status;
+    struct bladerf_image *image;
+
+    image = bladerf_alloc_cal_image(dev, fpga_size, dac);
+    if (!image) {
+        return BLADERF_ERR_MEM;
+    }
+
+    status = bladerf_erase_flash_bytes(dev, BLADERF_FLASH_ADDR_CAL,
+                                       BLADERF_FLASH_BYTE_LEN_CAL);
+    if (status == 0) {
+        status = bladerf_write_flash_bytes(dev, image->data, image->address,
+                                           image->length);
+    }
+
+    bladerf_free_image(image);
+    return (status < 0) ? status : 0;
+}
+
 int cmd_flash_init_cal(struct cli_state *state, int argc, char **argv)
 {
     int rv;
@@ -75,20 +98,8 @@ int cmd_flash_init_cal(struct cli_state *state, int argc, char **argv)
         return CLI_RET_INVPARAM;
     }
 
-    image = bladerf_alloc_cal_image(state->dev, fpga_size, dac);
-    if (!image) {
-        return CLI_RET_MEM;
-    }
-
     if (argc == 3) {
-        rv = bladerf_erase_flash_bytes(state->dev, BLADERF_FLASH_ADDR_CAL,
-                                       BLADERF_FLASH_BYTE_LEN_CAL);
-        if (rv != 0) {
-            goto cmd_flash_init_cal_out;
-        }
-
-        rv = bladerf_write_flash_bytes(state->dev, image->data,
-                                       image->address, image->length);
+        rv = flash_init_cal_write(state->dev, fpga_size, dac);
         if(rv < 0) {
             cli_err(state, argv[0],
             "Failed to write calibration data.\n"
@@ -109,12 +120,17 @@ int cmd_flash_init_cal(struct cli_state *state, int argc, char **argv)
         char *filename;
         assert(argc == 4);
 
+        image = bladerf_alloc_cal_image(state->dev, fpga_size, dac);
+        if (!image) {
+            return CLI_RET_MEM;
+        }
+
         filename = input_expand_path(argv[3]);
         rv = bladerf_image_write(state->dev, image, filename);
         free(filename);
+
+        bladerf_free_image(image);
     }
 
-cmd_flash_init_cal_out:
-    bladerf_free_image(image);
     return rv;
 }
@@ -0,0 +1,39 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef CMD_FLASH_INIT_CAL_H_
+#define CMD_FLASH_INIT_CAL_H_
+
+#include <stdint.h>
+#include <libbladeRF.h>
+
+/**
+ * Erase the calibration region of a device's flash and write calibration
+ * data containing the specified FPGA size and VCTCXO trim DAC value
+ *
+ * @param   dev         Device handle
+ * @param   fpga_size   FPGA size
+ * @param   dac         VCTCXO trim DAC value
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int flash_init_cal_write(struct bladerf *dev, bladerf_fpga_size fpga_size,
+                         uint16_t dac);
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "cmd.h"
+
+int cmd_fw_stats(struct cli_state *state, int argc, char **argv)
+{
+    struct bladerf_fx3_stats stats;
+    bool reset = false;
+    int status;
+
+    if (argc == 2) {
+        if (strcasecmp(argv[1], "reset") != 0) {
+            cli_err(state, argv[0], "Invalid argument (%s)\n", argv[1]);
+            return CLI_RET_INVPARAM;
+        }
+
+        reset = true;
+    } else if (argc != 1) {
+        return CLI_RET_NARGS;
+    }
+
+    status = bladerf_get_fx3_stats(state->dev, &stats, reset);
+    if (status != 0) {
+        state->last_lib_error = status;
+        return CLI_RET_LIBBLADERF;
+    }
+
+    printf("\n");
+    printf("  TX buffers (host to FPGA):  %u\n", stats.tx_buffers);
+    printf("  RX buffers (FPGA to host):  %u\n", stats.rx_buffers);
+    printf("  RX overruns:                %u\n", stats.rx_overruns);
+    printf("  TX underruns:               %u\n", stats.tx_underruns);
+    printf("  FPGA interface errors:      %u\n", stats.pib_errors);
+    printf("  USB retries:                %u\n", stats.usb_retries);
+    printf("  USB 3.0 PHY errors:         %u\n", stats.usb_phy_errors);
+    printf("  USB 3.0 link errors:        %u\n", stats.usb_link_errors);
+    printf("\n");
+
+    if (reset) {
+        printf("  Counters have been reset.\n\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,503 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* sendmmsg() */
+#endif
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_config.h"
+
+#if !BLADERF_OS_WINDOWS
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include "cmd.h"
+#include "net_stream.h"
+
+#define UDP_PREFIX "udp://"
+#define TCP_PREFIX "tcp://"
+
+/* Requested socket send buffer size, to absorb bursts at high rates */
+#define SNDBUF_SIZE (8 * 1024 * 1024)
+
+bool net_stream_is_uri(const char *path)
+{
+    return !strncasecmp(path, UDP_PREFIX, strlen(UDP_PREFIX)) ||
+           !strncasecmp(path, TCP_PREFIX, strlen(TCP_PREFIX));
+}
+
+#if BLADERF_OS_WINDOWS
+int net_stream_open_sink(struct cli_state *s,
+                         const char *argv0,
+                         const char *uri,
+                         unsigned int nchans,
+                         struct net_stream **ns)
+{
+    cli_err(s, argv0, "Network endpoints are not supported on this "
+                      "platform.\n");
+    return CLI_RET_INVPARAM;
+}
+
+int net_stream_open_source(struct cli_state *s,
+                           const char *argv0,
+                           const char *uri,
+                           FILE **file)
+{
+    cli_err(s, argv0, "Network endpoints are not supported on this "
+                      "platform.\n");
+    return CLI_RET_INVPARAM;
+}
+
+int net_stream_send(struct net_stream *ns,
+                    const int16_t *samples,
+                    size_t n,
+                    uint64_t timestamp)
+{
+    return CLI_RET_FILEOP;
+}
+
+void net_stream_set_decimation(struct net_stream *ns, unsigned int factor)
+{
+}
+
+void net_stream_close(struct net_stream *ns)
+{
+}
+#else
+struct net_stream {
+    int fd;
+    bool udp;
+    unsigned int nchans;
+    unsigned int ticks_per_sample; /* Timestamp increment per sample */
+
+    uint32_t sequence;
+    uint64_t next_ts; /* Timestamp expected of the next block */
+    bool started;
+
+    /* Headers and I/O vectors for each datagram of a batch */
+    uint8_t (*headers)[NET_STREAM_HEADER_LEN];
+    struct iovec *iov;
+#if BLADERF_OS_LINUX
+    struct mmsghdr *msgs;
+#endif
+    size_t max_dgrams;
+};
+
+static inline void put_le16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_le32(uint8_t *p, uint32_t v)
+{
+    put_le16(p, (uint16_t)v);
+    put_le16(p + 2, (uint16_t)(v >> 16));
+}
+
+static inline void put_le64(uint8_t *p, uint64_t v)
+{
+    put_le32(p, (uint32_t)v);
+    put_le32(p + 4, (uint32_t)(v >> 32));
+}
+
+static void put_header(struct net_stream *ns, uint8_t *hdr, uint64_t ts,
+                       size_t n, uint16_t flags)
+{
+    put_le32(hdr, NET_STREAM_MAGIC);
+    put_le32(hdr + 4, ns->sequence++);
+    put_le64(hdr + 8, ts);
+    put_le32(hdr + 16, (uint32_t)n);
+    put_le16(hdr + 20, (uint16_t)ns->nchans);
+    put_le16(hdr + 22, flags);
+}
+
+/* Split "proto://host:port" into host and port. An IPv6 host is given in
+ * brackets. */
+static int parse_uri(const char *uri, bool *udp, char **host, char **port)
+{
+    const char *p, *end, *colon;
+    size_t host_len;
+
+    *udp = !strncasecmp(uri, UDP_PREFIX, strlen(UDP_PREFIX));
+    p    = uri + strlen(UDP_PREFIX); /* Same length as TCP_PREFIX */
+
+    if (*p == '[') {
+        end = strchr(++p, ']');
+        if (end == NULL || end[1] != ':') {
+            return CLI_RET_INVPARAM;
+        }
+        host_len = (size_t)(end - p);
+        colon    = end + 1;
+    } else {
+        colon = strrchr(p, ':');
+        if (colon == NULL) {
+            return CLI_RET_INVPARAM;
+        }
+        host_len = (size_t)(colon - p);
+    }
+
+    if (host_len == 0 || colon[1] == '\0') {
+        return CLI_RET_INVPARAM;
+    }
+
+    *host = malloc(host_len + 1);
+    *port = strdup(colon + 1);
+    if (*host == NULL || *port == NULL) {
+        free(*host);
+        free(*port);
+        return CLI_RET_MEM;
+    }
+
+    memcpy(*host, p, host_len);
+    (*host)[host_len] = '\0';
+
+    return 0;
+}
+
+/* Connect a socket to the endpoint named by a URI */
+static int net_connect(struct cli_state *s, const char *argv0,
+                       const char *uri, bool *udp, int *fd)
+{
+    struct addrinfo hints, *res, *ai;
+    char *host, *port;
+    int status, err = 0;
+
+    status = parse_uri(uri, udp, &host, &port);
+    if (status == CLI_RET_INVPARAM) {
+        cli_err(s, argv0, "Invalid network endpoint: %s\n", uri);
+    }
+    if (status != 0) {
+        return status;
+    }
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = *udp ? SOCK_DGRAM : SOCK_STREAM;
+
+    status = getaddrinfo(host, port, &hints, &res);
+    if (status != 0) {
+        cli_err(s, argv0, "Failed to resolve %s: %s\n", host,
+                gai_strerror(status));
+        free(host);
+        free(port);
+        return CLI_RET_INVPARAM;
+    }
+
+    *fd = -1;
+    for (ai = res; ai != NULL && *fd < 0; ai = ai->ai_next) {
+        *fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (*fd < 0) {
+            err = errno;
+        } else if (connect(*fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+            err = errno;
+            close(*fd);
+            *fd = -1;
+        }
+    }
+
+    freeaddrinfo(res);
+
+    if (*fd < 0) {
+        cli_err(s, argv0, "Failed to connect to %s:%s: %s\n", host, port,
+                strerror(err));
+        status = CLI_RET_FILEOP;
+    } else {
+#ifdef SO_NOSIGPIPE
+        int one = 1;
+        setsockopt(*fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+    }
+
+    free(host);
+    free(port);
+    return status;
+}
+
+int net_stream_open_sink(struct cli_state *s,
+                         const char *argv0,
+                         const char *uri,
+                         unsigned int nchans,
+                         struct net_stream **ns)
+{
+    struct net_stream *ret;
+    int sndbuf = SNDBUF_SIZE;
+    int status;
+
+    ret = calloc(1, sizeof(*ret));
+    if (ret == NULL) {
+        return CLI_RET_MEM;
+    }
+
+    status = net_connect(s, argv0, uri, &ret->udp, &ret->fd);
+    if (status != 0) {
+        free(ret);
+        return status;
+    }
+
+    /* This is only a request, and the system may limit it */
+    setsockopt(ret->fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+
+    ret->nchans           = nchans;
+    ret->ticks_per_sample = 1;
+    *ns                   = ret;
+    return 0;
+}
+
+int net_stream_open_source(struct cli_state *s,
+                           const char *argv0,
+                           const char *uri,
+                           FILE **file)
+{
+    bool udp;
+    int fd, status;
+
+    if (strncasecmp(uri, TCP_PREFIX, strlen(TCP_PREFIX))) {
+        cli_err(s, argv0, "Samples to transmit can only be read from a "
+                          "tcp:// endpoint.\n");
+        return CLI_RET_INVPARAM;
+    }
+
+    status = net_connect(s, argv0, uri, &udp, &fd);
+    if (status != 0) {
+        return status;
+    }
+
+    *file = fdopen(fd, "rb");
+    if (*file == NULL) {
+        close(fd);
+        return CLI_RET_FILEOP;
+    }
+
+    return 0;
+}
+
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+
+/* Send a header and payload over TCP, continuing after partial sends. A
+ * slow peer blocks this, which backs up into the RX sample ring. */
+static int send_frame(struct net_stream *ns, struct iovec iov[2])
+{
+    struct msghdr msg;
+    ssize_t sent;
+    size_t i = 0;
+
+    memset(&msg, 0, sizeof(msg));
+
+    while (i < 2) {
+        msg.msg_iov    = &iov[i];
+        msg.msg_iovlen = 2 - i;
+
+        sent = sendmsg(ns->fd, &msg, SEND_FLAGS);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0) {
+            return CLI_RET_FILEOP;
+        }
+
+        while (i < 2 && (size_t)sent >= iov[i].iov_len) {
+            sent -= (ssize_t)iov[i].iov_len;
+            i++;
+        }
+
+        if (i < 2) {
+            iov[i].iov_base = (uint8_t *)iov[i].iov_base + sent;
+            iov[i].iov_len -= (size_t)sent;
+        }
+    }
+
+    return 0;
+}
+
+/* Datagrams are lost, rather than the capture failed, if the receiver is
+ * absent or the system is short of buffers */
+static bool dgram_lost(int err)
+{
+    return err == ECONNREFUSED || err == ENOBUFS || err == EAGAIN;
+}
+
+static int send_dgrams(struct net_stream *ns, size_t count)
+{
+#if BLADERF_OS_LINUX
+    size_t done;
+    int sent;
+
+    for (done = 0; done < count; done++) {
+        memset(&ns->msgs[done].msg_hdr, 0, sizeof(ns->msgs[done].msg_hdr));
+        ns->msgs[done].msg_hdr.msg_iov    = &ns->iov[2 * done];
+        ns->msgs[done].msg_hdr.msg_iovlen = 2;
+    }
+
+    /* Send the whole batch with as few system calls as possible */
+    done = 0;
+    while (done < count) {
+        sent = sendmmsg(ns->fd, &ns->msgs[done], (unsigned int)(count - done),
+                        SEND_FLAGS);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0 && dgram_lost(errno)) {
+            done++;
+        } else if (sent < 0) {
+            return CLI_RET_FILEOP;
+        } else {
+            done += (size_t)sent;
+        }
+    }
+#else
+    struct msghdr msg;
+    size_t i;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iovlen = 2;
+
+    for (i = 0; i < count; i++) {
+        msg.msg_iov = &ns->iov[2 * i];
+
+        while (sendmsg(ns->fd, &msg, SEND_FLAGS) < 0) {
+            if (dgram_lost(errno)) {
+                break;
+            } else if (errno != EINTR) {
+                return CLI_RET_FILEOP;
+            }
+        }
+    }
+#endif
+
+    return 0;
+}
+
+static int reserve_dgrams(struct net_stream *ns, size_t count)
+{
+    void *headers, *iov;
+#if BLADERF_OS_LINUX
+    void *msgs;
+#endif
+
+    if (count <= ns->max_dgrams) {
+        return 0;
+    }
+
+    headers = realloc(ns->headers, count * sizeof(ns->headers[0]));
+    if (headers == NULL) {
+        return CLI_RET_MEM;
+    }
+    ns->headers = headers;
+
+    iov = realloc(ns->iov, 2 * count * sizeof(ns->iov[0]));
+    if (iov == NULL) {
+        return CLI_RET_MEM;
+    }
+    ns->iov = iov;
+
+#if BLADERF_OS_LINUX
+    msgs = realloc(ns->msgs, count * sizeof(ns->msgs[0]));
+    if (msgs == NULL) {
+        return CLI_RET_MEM;
+    }
+    ns->msgs = msgs;
+#endif
+
+    ns->max_dgrams = count;
+    return 0;
+}
+
+void net_stream_set_decimation(struct net_stream *ns, unsigned int factor)
+{
+    ns->ticks_per_sample = factor;
+}
+
+int net_stream_send(struct net_stream *ns,
+                    const int16_t *samples,
+                    size_t n,
+                    uint64_t timestamp)
+{
+    uint16_t flags = 0;
+    size_t count, i, off, len;
+    int status;
+
+    if (ns->started && timestamp != ns->next_ts) {
+        flags |= NET_STREAM_FLAG_DISCONTINUITY;
+    }
+
+    ns->started = true;
+    ns->next_ts = timestamp + n / ns->nchans * ns->ticks_per_sample;
+
+    if (!ns->udp) {
+        uint8_t hdr[NET_STREAM_HEADER_LEN];
+        struct iovec iov[2];
+
+        put_header(ns, hdr, timestamp, n, flags);
+
+        iov[0].iov_base = hdr;
+        iov[0].iov_len  = sizeof(hdr);
+        iov[1].iov_base = (void *)samples;
+        iov[1].iov_len  = n * 2 * sizeof(int16_t);
+
+        return send_frame(ns, iov);
+    }
+
+    count  = (n + NET_STREAM_DGRAM_SAMPLES - 1) / NET_STREAM_DGRAM_SAMPLES;
+    status = reserve_dgrams(ns, count);
+    if (status != 0) {
+        return status;
+    }
+
+    for (i = 0, off = 0; i < count; i++, off += len) {
+        len = (n - off < NET_STREAM_DGRAM_SAMPLES) ? (n - off)
+                                                    : NET_STREAM_DGRAM_SAMPLES;
+
+        put_header(ns, ns->headers[i],
+                   timestamp + off / ns->nchans * ns->ticks_per_sample, len,
+                   (i == 0) ? flags : 0);
+
+        ns->iov[2 * i].iov_base     = ns->headers[i];
+        ns->iov[2 * i].iov_len      = NET_STREAM_HEADER_LEN;
+        ns->iov[2 * i + 1].iov_base = (void *)&samples[2 * off];
+        ns->iov[2 * i + 1].iov_len  = len * 2 * sizeof(int16_t);
+    }
+
+    return send_dgrams(ns, count);
+}
+
+void net_stream_close(struct net_stream *ns)
+{
+    if (ns != NULL) {
+        close(ns->fd);
+        free(ns->headers);
+        free(ns->iov);
+#if BLADERF_OS_LINUX
+        free(ns->msgs);
+#endif
+        free(ns);
+    }
+}
+#endif
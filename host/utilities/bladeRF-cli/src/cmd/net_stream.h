@@ -0,0 +1,138 @@
+/**
+ * @file net_stream.h
+ *
+ * @brief UDP and TCP endpoints for streaming samples
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef NET_STREAM_H__
+#define NET_STREAM_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+struct cli_state;
+
+/*
+ * Each datagram (UDP) or frame (TCP) of received samples starts with this
+ * header. All fields are little-endian, as are the SC16 Q11 samples that
+ * follow it.
+ *
+ *   Offset  Size  Field
+ *   0       4     Magic, NET_STREAM_MAGIC
+ *   4       4     Sequence number, incremented for each datagram or frame
+ *   8       8     Device timestamp of the first sample
+ *   16      4     Number of samples (I,Q pairs) in the payload
+ *   20      2     Number of interleaved channels
+ *   22      2     Flags, NET_STREAM_FLAG_*
+ */
+#define NET_STREAM_HEADER_LEN 24
+
+/* "bRFs" */
+#define NET_STREAM_MAGIC 0x73465262
+
+/* Samples were lost before this datagram or frame */
+#define NET_STREAM_FLAG_DISCONTINUITY (1 << 0)
+
+/* Most samples in each UDP datagram */
+#define NET_STREAM_DGRAM_SAMPLES 1024
+
+struct net_stream;
+
+/**
+ * Check whether a file path names a network endpoint, i.e., it starts
+ * with "udp://" or "tcp://"
+ *
+ * @param   path    File path
+ *
+ * @return true for a network endpoint
+ */
+bool net_stream_is_uri(const char *path);
+
+/**
+ * Connect to a network endpoint that received samples are sent to
+ *
+ * @param       s           CLI state, for error messages
+ * @param       argv0       Error message prefix
+ * @param       uri         udp://host:port or tcp://host:port. An IPv6
+ *                          host is given in brackets.
+ * @param       nchans      Number of interleaved channels
+ * @param[out]  ns          Stream handle
+ *
+ * @return 0 on success, CLI_RET_* on failure. An error is printed.
+ */
+int net_stream_open_sink(struct cli_state *s,
+                         const char *argv0,
+                         const char *uri,
+                         unsigned int nchans,
+                         struct net_stream **ns);
+
+/**
+ * Connect to a TCP endpoint that samples to transmit are read from. The
+ * endpoint supplies raw SC16 Q11 samples, without headers.
+ *
+ * @param       s           CLI state, for error messages
+ * @param       argv0       Error message prefix
+ * @param       uri         tcp://host:port
+ * @param[out]  file        Stream reading from the connection. Closing it
+ *                          closes the connection.
+ *
+ * @return 0 on success, CLI_RET_* on failure. An error is printed.
+ */
+int net_stream_open_source(struct cli_state *s,
+                           const char *argv0,
+                           const char *uri,
+                           FILE **file);
+
+/**
+ * Send a block of samples. Over TCP, this blocks until the peer accepts
+ * them. Over UDP, the block is split into datagrams that are sent in
+ * batches, and datagrams that cannot be delivered are lost.
+ *
+ * @param   ns          Stream handle
+ * @param   samples     Samples
+ * @param   n           Number of samples (I,Q pairs), across all channels
+ * @param   timestamp   Device timestamp of the first sample
+ *
+ * @return 0 on success, CLI_RET_FILEOP on failure
+ */
+int net_stream_send(struct net_stream *ns,
+                    const int16_t *samples,
+                    size_t n,
+                    uint64_t timestamp);
+
+/**
+ * Account for samples that are decimated before they are sent, so that
+ * each sample advances the device timestamp by the decimation factor
+ *
+ * @param   ns          Stream handle
+ * @param   factor      Decimation factor
+ */
+void net_stream_set_decimation(struct net_stream *ns, unsigned int factor);
+
+/**
+ * Close a network endpoint
+ *
+ * @param   ns      Stream handle. May be NULL.
+ */
+void net_stream_close(struct net_stream *ns);
+
+#endif
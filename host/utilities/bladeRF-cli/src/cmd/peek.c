@@ -61,6 +61,7 @@ int cmd_peek(struct cli_state *state, int argc, char **argv)
     int (*f)(struct bladerf *, uint8_t, uint8_t *)   = NULL;
     int (*f2)(struct bladerf *, uint16_t, uint8_t *) = NULL;
     int (*f3)(struct bladerf *, uint8_t, uint32_t *) = NULL;
+    int (*fb)(struct bladerf *, uint8_t, uint8_t *, unsigned int) = NULL;
     unsigned int count, address, max_address;
 
     if (argc == 3 || argc == 4) {
@@ -111,6 +112,7 @@ int cmd_peek(struct cli_state *state, int argc, char **argv)
                 rv = CLI_RET_INVPARAM;
             } else {
                 f           = bladerf_lms_read;
+                fb          = bladerf_lms_read_block;
                 max_address = LMS_MAX_ADDRESS;
             }
         }
@@ -124,6 +126,7 @@ int cmd_peek(struct cli_state *state, int argc, char **argv)
                 rv = CLI_RET_INVPARAM;
             } else {
                 f           = bladerf_si5338_read;
+                fb          = bladerf_si5338_read_block;
                 max_address = SI_MAX_ADDRESS;
             }
         }
@@ -139,11 +142,32 @@ int cmd_peek(struct cli_state *state, int argc, char **argv)
             int status = BLADERF_ERR_UNEXPECTED;
             uint8_t val;
             uint32_t val32;
+            uint8_t block[MAX_NUM_ADDRESSES];
+            unsigned int i = 0;
 
             putchar('\n');
 
+            /* Fetch consecutive registers up front, allowing the library
+             * to batch them into as few transactions as possible */
+            if (fb && count > 1) {
+                if (count > (max_address - address + 1)) {
+                    count = max_address - address + 1;
+                }
+
+                status = fb(state->dev, (uint8_t)address, block, count);
+                if (status < 0) {
+                    state->last_lib_error = status;
+                    rv                    = CLI_RET_LIBBLADERF;
+                    count                 = 0;
+                }
+            } else {
+                fb = NULL;
+            }
+
             for (; count > 0 && address <= max_address; count--) {
-                if (f) {
+                if (fb) {
+                    val = block[i++];
+                } else if (f) {
                     status = f(state->dev, (uint8_t)address, &val);
                 } else if (f2) {
                     status = f2(state->dev, (uint16_t)address, &val);
@@ -30,6 +30,8 @@ static inline const char *backend2str(bladerf_backend b)
             return "CyUSB driver";
         case BLADERF_BACKEND_LINUX:
             return "Linux kernel driver";
+        case BLADERF_BACKEND_SHM:
+            return "Device server";
         default:
             return "Unknown";
     }
@@ -17,6 +17,10 @@
  * with this program; if not, write to the Free Software Foundation, Inc.,
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* O_DIRECT */
+#endif
+
 #include <errno.h>
 #include <inttypes.h>
 #include <limits.h>
@@ -30,46 +34,48 @@
 #include "host_config.h"
 #include "minmax.h"
 #include "rel_assert.h"
+#include "sample_convert.h"
+#include "input/input.h"
+#include "rx_decim.h"
+#include "rx_ring.h"
 #include "rxtx_impl.h"
+#include "sc16q11_csv.h"
+#include "sigmf.h"
 
-#if BLADERF_OS_WINDOWS
-#define EOL "\r\n"
-#else
-#define EOL "\n"
+#if BLADERF_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
-/**
- * Peform adjustments on received samples before writing them out:
- *  (1) Mask off FPGA markers
- *  (2) Convert little-endian samples to host endianness, if needed.
- *
- *  @param  buff    Sample buffer
- *  @param  n       Number of samples
- */
-static inline void sc16q11_sample_fixup(int16_t *buf, size_t n)
-{
-    size_t i;
+/* An output file of the ring's writer thread */
+struct rx_writer_file {
+    FILE *file;
+    int fd;      /* Binary output is written here directly, if >= 0 */
+    bool direct; /* fd has O_DIRECT set */
+};
 
-    for (i = 0; i < n; i++) {
-        /* I - Mask off the marker and sign extend */
-        //        *buf &= (*buf) & 0x0fff;
-        //        if (*buf & 0x800) {
-        //            *buf |= 0xf000;
-        //        }
+/* State of the ring's writer thread */
+struct rx_writer {
+    struct rxtx_data *rx;
+    int (*write_samples)(struct rxtx_data *rx, int16_t *samples, size_t n);
+    bool fixup; /* Convert samples to host endianness before writing */
 
-        *buf = LE16_TO_HOST(*buf);
-        buf++;
+    /* Samples are sent here, little-endian, instead of to a file */
+    struct net_stream *net;
 
-        /* Q - Mask off the marker and sign extend */
-        //        *buf = HOST_TO_LE16(*buf) & 0x0fff;
-        //        if (*buf & 0x800) {
-        //            *buf |= 0xf000;
-        //        }
+    /* With a planar layout, each ring block holds `plane_samples' samples of
+     * RX1, followed by the same number of RX2, and each channel is written
+     * to its own file */
+    bool planar;
+    size_t plane_samples;
 
-        *buf = LE16_TO_HOST(*buf);
-        buf++;
-    }
-}
+    /* If not NULL, samples are filtered and decimated in place before they
+     * are written: by decim[0] for interleaved blocks, or by decim[ch] for
+     * each plane of planar ones */
+    struct rx_decim *decim[RXTX_MAX_CHANNELS];
+
+    struct rx_writer_file out[RXTX_MAX_CHANNELS];
+};
 
 /*
  * @pre data_mgmt lock is held
@@ -100,12 +106,10 @@ static int rx_write_csv_sc16q11(struct rxtx_data *rx,
                                 int16_t *samples,
                                 size_t n_samples)
 {
-    const size_t MAXLEN = 128; /* max line length (with newline and null) */
-
-    char *line = NULL;
-    char *tmp  = NULL;
-
-    size_t i, j, nchans;
+    struct rx_params *rx_params = rx->params;
+    char *text = NULL;
+    size_t len, needed;
+    unsigned int nchans;
     int status = 0;
 
     MUTEX_LOCK(&rx->data_mgmt.lock);
@@ -125,51 +129,743 @@ static int rx_write_csv_sc16q11(struct rxtx_data *rx,
     MUTEX_UNLOCK(&rx->data_mgmt.lock);
 
     if (status != 0) {
-        goto out;
+        return status;
+    }
+
+    // Output 2 columns for each enabled channel
+    // (2 cols for BLADERF_RX_X1, 4 cols for BLADERF_RX_X2, etc)
+    //
+    // The buffer is kept across writes, and only grown when a larger block
+    // is provided, so that steady-state captures do not allocate.
+    needed = n_samples * SC16Q11_CSV_MAX_SAMPLE_CHARS;
+    if (needed > rx_params->csv_text_len) {
+        text = realloc(rx_params->csv_text, needed);
+        if (NULL == text) {
+            status = errno;
+            set_last_error(&rx->last_error, ETYPE_ERRNO, status);
+            return CLI_RET_MEM;
+        }
+
+        rx_params->csv_text     = text;
+        rx_params->csv_text_len = needed;
+    }
+
+    text = rx_params->csv_text;
+    len  = sc16q11_csv_format(text, samples, n_samples, nchans);
+
+    MUTEX_LOCK(&rx->file_mgmt.file_lock);
+    if (fwrite(text, 1, len, rx->file_mgmt.file) != len) {
+        set_last_error(&rx->last_error, ETYPE_ERRNO, errno);
+        status = CLI_RET_FILEOP;
+    }
+    MUTEX_UNLOCK(&rx->file_mgmt.file_lock);
+
+    if (status == 0) {
+        rxtx_stats_add(rx, 0, len);
+    }
+
+    return status;
+}
+
+#if BLADERF_OS_LINUX
+static void rx_writer_set_direct(struct rx_writer_file *f, bool direct)
+{
+#ifdef O_DIRECT
+    int flags = fcntl(f->fd, F_GETFL);
+
+    if (flags != -1) {
+        flags = direct ? (flags | O_DIRECT) : (flags & ~O_DIRECT);
+        f->direct = (fcntl(f->fd, F_SETFL, flags) == 0) && direct;
+    } else {
+        f->direct = false;
     }
+#else
+    f->direct = false;
+#endif
+}
+
+/* Write binary samples straight to the file descriptor, bypassing stdio and,
+ * where the filesystem allows it, the page cache */
+static int rx_write_fd(struct rx_writer *w, struct rx_writer_file *f,
+                       int16_t *samples, size_t n)
+{
+    const uint8_t *buf = (const uint8_t *)samples;
+    size_t len         = n * 2 * sizeof(int16_t);
+    ssize_t written;
+
+    /* O_DIRECT requires whole, aligned blocks. Only a final partial block
+     * is not, and it is written through the page cache. */
+    if (f->direct && (len % RX_RING_ALIGNMENT) != 0) {
+        rx_writer_set_direct(f, false);
+    }
+
+    while (len > 0) {
+        written = write(f->fd, buf, len);
+
+        if (written < 0 && errno == EINTR) {
+            continue;
+        } else if (written < 0 && errno == EINVAL && f->direct) {
+            /* Not supported for this file after all */
+            rx_writer_set_direct(f, false);
+            continue;
+        } else if (written < 0) {
+            set_last_error(&w->rx->last_error, ETYPE_ERRNO, errno);
+            return CLI_RET_FILEOP;
+        }
 
-    line = calloc(MAXLEN, 1);
-    if (NULL == line) {
-        status = errno;
-        set_last_error(&rx->last_error, ETYPE_ERRNO, status);
-        goto out;
+        buf += written;
+        len -= (size_t)written;
     }
 
-    tmp = calloc(MAXLEN, 1);
-    if (NULL == tmp) {
-        status = errno;
-        set_last_error(&rx->last_error, ETYPE_ERRNO, status);
-        goto out;
+    return 0;
+}
+#endif
+
+static int rx_write_file(struct rx_writer *w, unsigned int i,
+                         int16_t *samples, size_t n)
+{
+    struct rx_writer_file *f = &w->out[i];
+    size_t written;
+    int status;
+
+#if BLADERF_OS_LINUX
+    if (f->fd >= 0) {
+        status = rx_write_fd(w, f, samples, n);
+        if (status == 0) {
+            rxtx_stats_add(w->rx, 0, n * 2 * sizeof(int16_t));
+        }
+        return status;
+    }
+#endif
+
+    if (i == 0) {
+        /* The CSV writer counts the text it writes */
+        status = w->write_samples(w->rx, samples, n);
+        if (status == 0 && w->write_samples != rx_write_csv_sc16q11) {
+            rxtx_stats_add(w->rx, 0, n * 2 * sizeof(int16_t));
+        }
+        return status;
     }
 
+    /* Only binary output is planar */
+    MUTEX_LOCK(&w->rx->file_mgmt.file_lock);
+    written = fwrite(samples, 2 * sizeof(int16_t), n, f->file);
+    MUTEX_UNLOCK(&w->rx->file_mgmt.file_lock);
+
+    if (written != n) {
+        set_last_error(&w->rx->last_error, ETYPE_CLI, CLI_RET_FILEOP);
+        return CLI_RET_FILEOP;
+    }
+
+    rxtx_stats_add(w->rx, 0, n * 2 * sizeof(int16_t));
+    return 0;
+}
+
+/* Filter and decimate samples in place. The filter works in host byte
+ * order, so samples that are otherwise sent or written as received are
+ * converted for it, and back. */
+static size_t rx_decimate(struct rx_writer *w, unsigned int i,
+                          int16_t *samples, size_t n, uint64_t *timestamp)
+{
+    const bool le = (w->net != NULL) || !w->fixup;
+    size_t offset;
+
+    if (le) {
+        sc16q11_le_to_host(samples, samples, n);
+    }
+
+    n = rx_decim_run(w->decim[i], samples, n, samples, &offset);
+
+    if (le) {
+        sc16q11_le_to_host(samples, samples, n);
+    }
+
+    *timestamp += offset;
+    return n;
+}
+
+/* Called from the ring's writer thread for each block received */
+static int rx_write_block(void *arg, int16_t *samples, size_t n,
+                          uint64_t timestamp)
+{
+    struct rx_writer *w = arg;
+    int16_t *plane2;
+    int status;
+
+    if (w->net != NULL) {
+        if (w->decim[0] != NULL) {
+            n = rx_decimate(w, 0, samples, n, &timestamp);
+            if (n == 0) {
+                return 0;
+            }
+        }
+
+        status = net_stream_send(w->net, samples, n, timestamp);
+        if (status == 0) {
+            rxtx_stats_add(w->rx, 0, n * 2 * sizeof(int16_t));
+        } else {
+            set_last_error(&w->rx->last_error, ETYPE_ERRNO, errno);
+        }
+        return status;
+    }
+
+    if (!w->planar) {
+        if (w->fixup) {
+            sc16q11_le_to_host(samples, samples, n);
+        }
+
+        if (w->decim[0] != NULL) {
+            n = rx_decimate(w, 0, samples, n, &timestamp);
+        }
+
+        return rx_write_file(w, 0, samples, n);
+    }
+
+    plane2 = samples + 2 * w->plane_samples;
+    n /= 2;
+
+    if (w->fixup) {
+        sc16q11_le_to_host(samples, samples, n);
+        sc16q11_le_to_host(plane2, plane2, n);
+    }
+
+    /* Both planes are the same length, so they decimate alike */
+    if (w->decim[0] != NULL) {
+        uint64_t timestamp2 = timestamp;
+
+        rx_decimate(w, 1, plane2, n, &timestamp2);
+        n = rx_decimate(w, 0, samples, n, &timestamp);
+    }
+
+    status = rx_write_file(w, 0, samples, n);
+    if (status == 0) {
+        status = rx_write_file(w, 1, plane2, n);
+    }
+
+    return status;
+}
+
+static void rx_writer_init(struct rx_writer *w, struct rxtx_data *rx,
+                           int (*write_samples)(struct rxtx_data *rx,
+                                                int16_t *samples, size_t n),
+                           bool fixup, bool planar, size_t plane_samples,
+                           unsigned int decim)
+{
+    unsigned int i;
+
+    memset(w, 0, sizeof(*w));
+    w->rx            = rx;
+    w->write_samples = write_samples;
+    w->fixup         = fixup;
+    w->planar        = planar;
+    w->plane_samples = plane_samples;
+
     MUTEX_LOCK(&rx->file_mgmt.file_lock);
+    w->out[0].file = rx->file_mgmt.file;
+    w->out[1].file = rx->file_mgmt.file2;
+    w->net         = rx->file_mgmt.net;
 
-    // Output 2 columns for each enabled channel
-    // (2 cols for BLADERF_RX_X1, 4 cols for BLADERF_RX_X2, etc)
-    for (i = 0; i < 2 * n_samples; i += 2 * nchans) {
-        memset(line, 0, MAXLEN);
-        memset(tmp, 0, MAXLEN);
-
-        for (j = 0; j < 2 * nchans; j += 2) {
-            snprintf(tmp, MAXLEN, "%s%d, %d", (j > 0) ? ", " : "",
-                     samples[i + j], samples[i + j + 1]);
-            strncat(line, tmp, MAXLEN - 1);
+    if (w->net != NULL && decim > 1) {
+        net_stream_set_decimation(w->net, decim);
+    }
+
+    for (i = 0; i < RXTX_MAX_CHANNELS; i++) {
+        w->out[i].fd = -1;
+
+#if BLADERF_OS_LINUX
+        if (write_samples == rx_write_bin_sc16q11 && w->out[i].file != NULL &&
+            fflush(w->out[i].file) == 0) {
+            w->out[i].fd = fileno(w->out[i].file);
+
+            /* Decimated blocks are rarely whole O_DIRECT blocks */
+            rx_writer_set_direct(&w->out[i], decim <= 1);
         }
+#endif
+    }
+    MUTEX_UNLOCK(&rx->file_mgmt.file_lock);
+}
 
-        strncat(line, EOL, MAXLEN - 1);
+/* Find the first enabled channel */
+static bladerf_channel rx_first_channel(struct rxtx_data *rx)
+{
+    bladerf_channel ch = BLADERF_CHANNEL_RX(0);
+    size_t i;
 
-        if (fputs(line, rx->file_mgmt.file) < 0) {
-            set_last_error(&rx->last_error, ETYPE_ERRNO, errno);
-            status = CLI_RET_FILEOP;
+    MUTEX_LOCK(&rx->param_lock);
+    for (i = 0; i < RXTX_MAX_CHANNELS; i++) {
+        if (rx->channel_enable[i]) {
+            ch = BLADERF_CHANNEL_RX(i);
             break;
         }
     }
+    MUTEX_UNLOCK(&rx->param_lock);
 
-    MUTEX_UNLOCK(&rx->file_mgmt.file_lock);
+    return ch;
+}
+
+/* Set up the channel filter and decimation for a capture, if configured */
+static int rx_writer_init_decim(struct rx_writer *w, struct cli_state *s,
+                                const struct rx_params *params,
+                                unsigned int nchans,
+                                size_t samples_per_buffer)
+{
+    bladerf_sample_rate rate;
+    unsigned int threads, i;
+    double cutoff;
+    int status;
+
+    if (params->decim <= 1) {
+        return 0;
+    }
+
+    status = bladerf_get_sample_rate(s->dev, rx_first_channel(w->rx), &rate);
+    if (status != 0) {
+        set_last_error(&w->rx->last_error, ETYPE_BLADERF, status);
+        return CLI_RET_LIBBLADERF;
+    }
+
+    cutoff = (params->decim_fc != 0.0) ? params->decim_fc / rate
+                                       : RX_DECIM_DEFAULT_CUTOFF /
+                                             params->decim;
+
+    /* The threads are shared between the planes of planar blocks */
+    threads = rx_decim_default_threads();
+
+    for (i = 0; i < (w->planar ? nchans : 1); i++) {
+        w->decim[i] = rx_decim_create(params->decim, cutoff,
+                                      w->planar ? 1 : nchans,
+                                      w->planar ? w->plane_samples
+                                                : samples_per_buffer,
+                                      w->planar ? (threads + 1) / 2
+                                                : threads);
+        if (w->decim[i] == NULL) {
+            set_last_error(&w->rx->last_error, ETYPE_CLI, CLI_RET_INVPARAM);
+            return CLI_RET_INVPARAM;
+        }
+    }
+
+    return 0;
+}
+
+static void rx_writer_deinit(struct rx_writer *w)
+{
+    unsigned int i;
+
+    for (i = 0; i < RXTX_MAX_CHANNELS; i++) {
+        rx_decim_destroy(w->decim[i]);
+        w->decim[i] = NULL;
+
+#if BLADERF_OS_LINUX
+        if (w->out[i].direct) {
+            rx_writer_set_direct(&w->out[i], false);
+        }
+#endif
+    }
+}
 
-out:
-    free(line);
-    free(tmp);
+static char *rx_channel_path(const char *path, unsigned int ch)
+{
+    const char *base = strrchr(path, '/');
+    const char *ext;
+    size_t len = strlen(path) + 8;
+    char *ret;
+
+#if BLADERF_OS_WINDOWS
+    if (strrchr(path, '\\') > base) {
+        base = strrchr(path, '\\');
+    }
+#endif
+
+    ret = malloc(len);
+    if (ret == NULL) {
+        return NULL;
+    }
+
+    /* Insert the channel before the extension, if there is one */
+    ext = strrchr((base != NULL) ? base : path, '.');
+    if (ext == NULL || ext == base + 1 || ext == path) {
+        ext = path + strlen(path);
+    }
+
+    snprintf(ret, len, "%.*s-rx%u%s", (int)(ext - path), path, ch + 1, ext);
+    return ret;
+}
+
+/* Describe the capture about to start in a SigMF sidecar */
+static int rx_sigmf_init(struct rxtx_data *rx, struct cli_state *s,
+                         struct sigmf_meta *meta)
+{
+    bladerf_channel ch = rx_first_channel(rx);
+    bladerf_sample_rate rate;
+    bladerf_frequency freq;
+    char serial[BLADERF_SERIAL_LENGTH];
+    int status;
+
+    sigmf_meta_init(meta);
+
+    MUTEX_LOCK(&rx->data_mgmt.lock);
+    meta->num_channels = (rx->data_mgmt.layout == BLADERF_RX_X2) ? 2 : 1;
+    MUTEX_UNLOCK(&rx->data_mgmt.lock);
+
+    status = bladerf_get_sample_rate(s->dev, ch, &rate);
+    if (status == 0) {
+        status = bladerf_get_frequency(s->dev, ch, &freq);
+    }
+    if (status == 0) {
+        status = bladerf_get_serial(s->dev, serial);
+    }
+
+    if (status != 0) {
+        set_last_error(&rx->last_error, ETYPE_BLADERF, status);
+        return CLI_RET_LIBBLADERF;
+    }
+
+    meta->sample_rate = rate;
+    meta->frequency   = freq;
+    snprintf(meta->hw, sizeof(meta->hw), "%s (serial %s)",
+             bladerf_get_board_name(s->dev), serial);
+
+    return 0;
+}
+
+static int rx_sigmf_write_one(const struct sigmf_meta *meta, const char *path)
+{
+    char *expanded;
+    int status;
+
+    expanded = input_expand_path(path);
+    if (expanded == NULL) {
+        return CLI_RET_MEM;
+    }
+
+    status = sigmf_meta_write(meta, expanded);
+    free(expanded);
+
+    return status;
+}
+
+static int rx_sigmf_write(struct rxtx_data *rx, struct sigmf_meta *meta,
+                          bool planar)
+{
+    char *path;
+    unsigned int ch;
+    int status = 0;
+
+    MUTEX_LOCK(&rx->file_mgmt.file_meta_lock);
+
+    if (!planar) {
+        status = rx_sigmf_write_one(meta, rx->file_mgmt.path);
+    } else {
+        /* Each channel's data file is described by its own sidecar */
+        meta->num_channels = 1;
+
+        for (ch = 0; ch < RXTX_MAX_CHANNELS && status == 0; ch++) {
+            path = rx_channel_path(rx->file_mgmt.path, ch);
+            if (path == NULL) {
+                status = CLI_RET_MEM;
+            } else {
+                status = rx_sigmf_write_one(meta, path);
+                free(path);
+            }
+        }
+    }
+
+    MUTEX_UNLOCK(&rx->file_mgmt.file_meta_lock);
+
+    if (status != 0) {
+        set_last_error(&rx->last_error, ETYPE_CLI, status);
+    }
+
+    return status;
+}
+
+/* State of a capture, shared by the untriggered and triggered loops */
+struct rx_capture {
+    struct rxtx_data *rx;
+    struct cli_state *s;
+    struct rx_ring *ring;
+    struct sigmf_meta sigmf;
+
+    bool use_sigmf;
+    bool use_meta;  /* Receive with timestamps */
+    bool scheduled; /* The next block is to start at `start_ts' */
+    uint64_t start_ts;
+    bool planar;
+    unsigned int timeout_ms;
+    size_t samples_per_buffer;
+    size_t plane_samples; /* Each channel's half of a planar block */
+
+    size_t num_samples; /* Samples to capture, or 0 for no limit */
+    size_t samples_read;
+};
+
+/* Receive a block of samples. Timestamps are used to detect discontinuities
+ * in SigMF and network output, and to begin a scheduled capture. An overrun
+ * ends a block early, and the next begins after the gap. */
+static int rx_receive(struct rx_capture *c,
+                      int16_t *samples,
+                      size_t *received,
+                      uint64_t *timestamp)
+{
+    struct bladerf_metadata meta;
+    int status;
+
+    memset(&meta, 0, sizeof(meta));
+
+    if (c->scheduled) {
+        /* The samples before the start are discarded by libbladeRF */
+        meta.timestamp = c->start_ts;
+        c->scheduled   = false;
+    } else {
+        meta.flags = BLADERF_META_FLAG_RX_NOW;
+    }
+
+    if (c->planar) {
+        /* Deinterleave into the block's halves as samples are copied
+         * out of the stream, rather than in a pass of their own */
+        void *const planes[2] = { samples, samples + 2 * c->plane_samples };
+
+        status    = bladerf_sync_rx_planar(c->s->dev, planes,
+                                           (unsigned int)c->plane_samples,
+                                           c->use_meta ? &meta : NULL,
+                                           c->timeout_ms);
+        *received = c->use_meta ? 2 * meta.actual_count
+                                 : 2 * c->plane_samples;
+    } else {
+        status    = bladerf_sync_rx(c->s->dev, samples,
+                                    (unsigned int)c->samples_per_buffer,
+                                    c->use_meta ? &meta : NULL,
+                                    c->timeout_ms);
+        *received = c->use_meta ? meta.actual_count : c->samples_per_buffer;
+    }
+
+    *timestamp = meta.timestamp;
+
+    if (status != 0) {
+        set_last_error(&c->rx->last_error, ETYPE_BLADERF, status);
+    } else {
+        rxtx_stats_add(c->rx, *received, 0);
+        rxtx_stats_tick(c->s, c->rx);
+    }
+
+    return status;
+}
+
+/* Queue the block last returned by rx_ring_next() to be written to the
+ * output file */
+static int rx_queue(struct rx_capture *c,
+                    size_t received,
+                    uint64_t timestamp,
+                    size_t *queued)
+{
+    size_t to_write = received;
+    int status      = 0;
+
+    if (c->num_samples != 0) {
+        to_write = min_sz(to_write, c->num_samples - c->samples_read);
+    }
+
+    /* Planar files are kept the same length */
+    if (c->planar) {
+        to_write -= to_write % 2;
+    }
+
+    if (c->use_sigmf && !rx_ring_will_drop(c->ring)) {
+        status = sigmf_meta_block(&c->sigmf, timestamp,
+                                  to_write / c->sigmf.num_channels);
+    }
+
+    if (status == 0) {
+        struct rx_ring_stats stats;
+
+        status = rx_ring_commit(c->ring, to_write, timestamp);
+
+        rx_ring_get_stats(c->ring, &stats);
+        rxtx_stats_set_ring(c->rx, &stats);
+    }
+
+    *queued = to_write;
+    return status;
+}
+
+static bool rx_stop_requested(struct rxtx_data *rx)
+{
+    /*
+     * Stop stream on STOP or SHUTDOWN, but only clear STOP. This will keep
+     * the SHUTDOWN request around so we can read it when determining our
+     * state transition
+     */
+    unsigned char requests = rxtx_get_requests(rx, RXTX_TASK_REQ_STOP);
+    return (requests & (RXTX_TASK_REQ_STOP | RXTX_TASK_REQ_SHUTDOWN)) != 0;
+}
+
+/* Keep reading samples until a failure or until all requested samples have
+ * been read */
+static int rx_capture_all(struct rx_capture *c)
+{
+    int status = 0;
+    int16_t *samples;
+    size_t received, queued;
+    uint64_t timestamp;
+
+    while (status == 0 &&
+           (c->num_samples == 0 || c->samples_read < c->num_samples)) {
+        if (rx_stop_requested(c->rx)) {
+            break;
+        }
+
+        /* Read the samples into the next block of the ring */
+        samples = rx_ring_next(c->ring);
+
+        status = rx_receive(c, samples, &received, &timestamp);
+        if (status == 0) {
+            status = rx_queue(c, received, timestamp, &queued);
+        }
+
+        c->samples_read += received;
+    }
+
+    return status;
+}
+
+/* Copy a held block into the ring */
+static int rx_queue_held(struct rx_capture *c,
+                         const struct rx_trigger_block *block,
+                         size_t *queued)
+{
+    int16_t *samples = rx_ring_next(c->ring);
+
+    /* A planar block's second half is at a fixed offset, so whole blocks are
+     * copied */
+    memcpy(samples, block->samples,
+           c->samples_per_buffer * 2 * sizeof(int16_t));
+
+    return rx_queue(c, block->n, block->timestamp, queued);
+}
+
+/* Receive into a rolling pre-trigger history, and only queue samples for
+ * writing around blocks whose power reaches the trigger level. Until all
+ * requested samples are written, each event is captured from `pre' samples
+ * before the block that triggered it to `post' samples after the last block
+ * at or above the level. */
+static int rx_capture_triggered(struct rx_capture *c,
+                                const struct rx_params *p,
+                                unsigned int nchans,
+                                uint64_t *events)
+{
+    int status = 0;
+    struct rx_trigger *history;
+    int16_t *samples;
+    size_t received, queued;
+    size_t post_remaining = 0;
+    uint64_t timestamp;
+    uint64_t pre, post;
+    double threshold;
+    bladerf_sample_rate rate;
+    unsigned int i, num_blocks;
+    bool active = false;
+
+    status = bladerf_get_sample_rate(c->s->dev, BLADERF_CHANNEL_RX(0), &rate);
+    if (status != 0) {
+        set_last_error(&c->rx->last_error, ETYPE_BLADERF, status);
+        return status;
+    }
+
+    /* Durations are converted to samples across all channels */
+    pre  = (uint64_t)p->trigger_pre_ms * rate / 1000 * nchans;
+    post = (uint64_t)p->trigger_post_ms * rate / 1000 * nchans;
+
+    num_blocks = (unsigned int)((pre + c->samples_per_buffer - 1) /
+                                c->samples_per_buffer);
+
+    history = rx_trigger_create(num_blocks, c->samples_per_buffer);
+    if (history == NULL) {
+        status = CLI_RET_MEM;
+        set_last_error(&c->rx->last_error, ETYPE_CLI, status);
+        return status;
+    }
+
+    threshold = rx_trigger_dbfs_to_power(p->trigger_dbfs);
+
+    while (status == 0 &&
+           (c->num_samples == 0 || c->samples_read < c->num_samples)) {
+        if (rx_stop_requested(c->rx)) {
+            break;
+        }
+
+        /* Between events, samples are only held in memory */
+        samples = active ? rx_ring_next(c->ring) : rx_trigger_next(history);
+
+        status = rx_receive(c, samples, &received, &timestamp);
+        if (status != 0) {
+            break;
+        }
+
+        if (rx_trigger_power(samples, received) >= threshold) {
+            post_remaining = post;
+
+            if (!active) {
+                /* Write out the history, ending with this block */
+                rx_trigger_push(history, received, timestamp);
+                active = true;
+                (*events)++;
+
+                for (i = 0; i < rx_trigger_count(history) && status == 0 &&
+                            (c->num_samples == 0 ||
+                             c->samples_read < c->num_samples);
+                     i++) {
+                    status = rx_queue_held(c, rx_trigger_get(history, i),
+                                           &queued);
+                    c->samples_read += queued;
+                }
+
+                rx_trigger_clear(history);
+                continue;
+            }
+        } else if (!active) {
+            rx_trigger_push(history, received, timestamp);
+            continue;
+        }
+
+        status = rx_queue(c, received, timestamp, &queued);
+        c->samples_read += queued;
+
+        if (post_remaining > received) {
+            post_remaining -= received;
+        } else {
+            /* The history is rebuilt from the next block */
+            active = false;
+        }
+    }
+
+    rx_trigger_destroy(history);
+    return status;
+}
+
+/* Hold off a scheduled capture until shortly before its start */
+static int rx_wait_for_start(struct rx_capture *c)
+{
+    bladerf_sample_rate rate;
+    bool scheduled;
+    int status;
+
+    MUTEX_LOCK(&c->rx->data_mgmt.lock);
+    scheduled = c->rx->data_mgmt.start_scheduled;
+    MUTEX_UNLOCK(&c->rx->data_mgmt.lock);
+
+    if (!scheduled) {
+        return 0;
+    }
+
+    status = bladerf_get_sample_rate(c->s->dev, rx_first_channel(c->rx), &rate);
+    if (status == 0) {
+        status = rxtx_wait_for_start(c->s, c->rx, rate, &c->scheduled,
+                                     &c->start_ts);
+    }
+
+    if (status != 0) {
+        set_last_error(&c->rx->last_error, ETYPE_BLADERF, status);
+    }
 
     return status;
 }
@@ -177,71 +873,120 @@ out:
 static int rx_task_exec_running(struct rxtx_data *rx, struct cli_state *s)
 {
     int status = 0;
-    int samples_per_buffer;
-    void *samples;
-    size_t num_samples;
-    size_t samples_read = 0;
+    int ring_status;
+    size_t ring_size;
     int (*write_samples)(struct rxtx_data * rx, int16_t * samples, size_t n);
-    unsigned int timeout_ms;
+    struct rx_params params;
+    struct rx_ring_stats stats;
+    struct rx_writer writer;
+    struct rx_capture c;
+    unsigned int nchans;
+    uint64_t events = 0;
+
+    memset(&c, 0, sizeof(c));
+    c.rx = rx;
+    c.s  = s;
 
     /* Read the parameters that will be used for the sync transfers */
     MUTEX_LOCK(&rx->data_mgmt.lock);
-    timeout_ms         = rx->data_mgmt.timeout_ms;
-    samples_per_buffer = rx->data_mgmt.samples_per_buffer;
+    c.timeout_ms         = rx->data_mgmt.timeout_ms;
+    c.samples_per_buffer = rx->data_mgmt.samples_per_buffer;
+    nchans               = (rx->data_mgmt.layout == BLADERF_RX_X2) ? 2 : 1;
     MUTEX_UNLOCK(&rx->data_mgmt.lock);
 
     MUTEX_LOCK(&rx->param_lock);
-    num_samples   = ((struct rx_params *)rx->params)->n_samples;
-    write_samples = ((struct rx_params *)rx->params)->write_samples;
+    params = *(struct rx_params *)rx->params;
     MUTEX_UNLOCK(&rx->param_lock);
 
-    /* Allocate a buffer for the block of samples */
-    samples = malloc(samples_per_buffer * sizeof(uint16_t) * 2);
-    if (samples == NULL) {
-        status = errno;
-        set_last_error(&rx->last_error, ETYPE_ERRNO, status);
+    c.num_samples = params.n_samples;
+    write_samples = params.write_samples;
+    ring_size     = params.ring_size;
+    c.planar      = params.planar && nchans == 2;
+
+    c.plane_samples = c.samples_per_buffer / nchans;
+
+    MUTEX_LOCK(&rx->file_mgmt.file_meta_lock);
+    c.use_sigmf = (rx->file_mgmt.format == RXTX_FMT_SIGMF_SC16Q11);
+    MUTEX_LOCK(&rx->file_mgmt.file_lock);
+    c.use_meta = c.use_sigmf || (rx->file_mgmt.net != NULL);
+    MUTEX_UNLOCK(&rx->file_mgmt.file_lock);
+    MUTEX_UNLOCK(&rx->file_mgmt.file_meta_lock);
+
+    status = rx_wait_for_start(&c);
+    if (status != 0) {
+        return status;
     }
+    c.use_meta = c.use_meta || c.scheduled;
 
-    /*
-     * Keep reading samples until a failure or until all requested samples
-     * have been read
-     */
-    while (status == 0 && (num_samples == 0 || samples_read < num_samples)) {
-        /*
-         * Stop stream on STOP or SHUTDOWN, but only clear STOP. This will keep
-         * the SHUTDOWN request around so we can read it when determining our
-         * state transition
-         */
-        unsigned char requests = rxtx_get_requests(rx, RXTX_TASK_REQ_STOP);
-        if (requests & (RXTX_TASK_REQ_STOP | RXTX_TASK_REQ_SHUTDOWN)) {
-            break;
+    if (c.use_sigmf) {
+        status = rx_sigmf_init(rx, s, &c.sigmf);
+        if (status != 0) {
+            return status;
         }
 
-        /* Read the samples into the sample buffer */
-        status = bladerf_sync_rx(s->dev, samples, samples_per_buffer, NULL,
-                                 timeout_ms);
+        c.sigmf.decimation = (params.decim > 1) ? params.decim : 1;
+    }
 
-        if (status != 0) {
-            set_last_error(&rx->last_error, ETYPE_BLADERF, status);
-        } else {
-            size_t to_write =
-                min_sz(samples_per_buffer, (num_samples - samples_read));
+    /* Samples are received into a ring that a separate thread drains to the
+     * output file, so that a stall in writing does not stall reception.
+     * SigMF data is little-endian, as received, so it is not converted. */
+    rx_writer_init(&writer, rx, write_samples, !c.use_sigmf, c.planar,
+                   c.plane_samples, params.decim);
+
+    status = rx_writer_init_decim(&writer, s, &params, nchans,
+                                  c.samples_per_buffer);
+
+    if (status == 0) {
+        c.ring = rx_ring_create(ring_size, c.samples_per_buffer,
+                                rx_write_block, &writer);
+        if (c.ring == NULL) {
+            status = CLI_RET_MEM;
+            set_last_error(&rx->last_error, ETYPE_CLI, status);
+        }
+    }
+
+    if (status != 0) {
+        rx_writer_deinit(&writer);
+        if (c.use_sigmf) {
+            sigmf_meta_deinit(&c.sigmf);
+        }
+        return status;
+    }
 
-            /* Write the samples to the output file */
-            sc16q11_sample_fixup(samples, to_write);
-            status = write_samples(rx, samples, to_write);
+    rxtx_stats_start(rx);
 
-            if (status != 0) {
-                set_last_error(&rx->last_error, ETYPE_CLI, status);
-            }
+    if (params.trigger) {
+        status = rx_capture_triggered(&c, &params, nchans, &events);
+    } else {
+        status = rx_capture_all(&c);
+    }
+
+    /* Any error is recorded by the writer when it occurs */
+    ring_status = rx_ring_destroy(c.ring, &stats);
+    if (status == 0) {
+        status = ring_status;
+    }
+
+    rx_writer_deinit(&writer);
+    rxtx_stats_stop(rx);
+
+    if (c.use_sigmf) {
+        ring_status = rx_sigmf_write(rx, &c.sigmf, c.planar);
+        if (status == 0) {
+            status = ring_status;
         }
 
-        samples_read += samples_per_buffer;
+        sigmf_meta_deinit(&c.sigmf);
     }
 
-    /* Free the sample buffer */
-    if (samples != NULL) {
-        free(samples);
+    MUTEX_LOCK(&rx->param_lock);
+    ((struct rx_params *)rx->params)->ring_stats     = stats;
+    ((struct rx_params *)rx->params)->trigger_events = events;
+    MUTEX_UNLOCK(&rx->param_lock);
+
+    if (stats.dropped != 0) {
+        printf("\n  RX: %" PRIu64 " block(s) were dropped because the "
+               "sample ring was full.\n", stats.dropped);
     }
 
     return status;
@@ -277,6 +1022,7 @@ void *rx_task(void *cli_state_arg)
                 /* This should be set to an appropriate value upon
                  * encountering an error condition */
                 enum error_type err_type = ETYPE_BUG;
+                bladerf_format format    = BLADERF_FORMAT_SC16_Q11;
 
                 /* Clear the last error */
                 set_last_error(&rx->last_error, ETYPE_ERRNO, 0);
@@ -294,6 +1040,11 @@ void *rx_task(void *cli_state_arg)
                         rx_params->write_samples = rx_write_bin_sc16q11;
                         break;
 
+                    case RXTX_FMT_SIGMF_SC16Q11:
+                        rx_params->write_samples = rx_write_bin_sc16q11;
+                        format = BLADERF_FORMAT_SC16_Q11_META;
+                        break;
+
                     default:
                         status = CLI_RET_INVPARAM;
                         set_last_error(&rx->last_error, ETYPE_CLI, status);
@@ -304,15 +1055,29 @@ void *rx_task(void *cli_state_arg)
                     assert(rx->file_mgmt.path);
                 }
 
+                /* Network headers carry each block's timestamp */
+                MUTEX_LOCK(&rx->file_mgmt.file_lock);
+                if (rx->file_mgmt.net != NULL) {
+                    format = BLADERF_FORMAT_SC16_Q11_META;
+                }
+                MUTEX_UNLOCK(&rx->file_mgmt.file_lock);
+
                 MUTEX_UNLOCK(&rx->file_mgmt.file_meta_lock);
 
+                /* A scheduled start is requested by timestamp */
+                MUTEX_LOCK(&rx->data_mgmt.lock);
+                if (rx->data_mgmt.start_scheduled) {
+                    format = BLADERF_FORMAT_SC16_Q11_META;
+                }
+                MUTEX_UNLOCK(&rx->data_mgmt.lock);
+
                 /* Set up the reception stream and buffer information */
                 if (status == 0) {
                     MUTEX_LOCK(&rx->data_mgmt.lock);
 
                     status = bladerf_sync_config(
                         cli_state->dev, rx->data_mgmt.layout,
-                        BLADERF_FORMAT_SC16_Q11, rx->data_mgmt.num_buffers,
+                        format, rx->data_mgmt.num_buffers,
                         rx->data_mgmt.samples_per_buffer,
                         rx->data_mgmt.num_transfers, rx->data_mgmt.timeout_ms);
 
@@ -373,9 +1138,102 @@ void *rx_task(void *cli_state_arg)
     return NULL;
 }
 
+/* A planar layout applies only when two channels are received */
+static bool rx_is_planar(struct rxtx_data *rx)
+{
+    bool planar;
+
+    MUTEX_LOCK(&rx->param_lock);
+    planar = ((struct rx_params *)rx->params)->planar;
+    MUTEX_UNLOCK(&rx->param_lock);
+
+    MUTEX_LOCK(&rx->data_mgmt.lock);
+    planar = planar && (rx->data_mgmt.layout == BLADERF_RX_X2);
+    MUTEX_UNLOCK(&rx->data_mgmt.lock);
+
+    return planar;
+}
+
+/* Open one file per channel, named after the configured path. The caller
+ * must hold the file lock. */
+static int rx_open_planar(struct rxtx_data *rx)
+{
+    FILE **files[2] = { &rx->file_mgmt.file, &rx->file_mgmt.file2 };
+    char *path;
+    unsigned int ch;
+    int status = 0;
+
+    MUTEX_LOCK(&rx->file_mgmt.file_meta_lock);
+    for (ch = 0; ch < 2 && status == 0; ch++) {
+        path = rx_channel_path(rx->file_mgmt.path, ch);
+        if (path == NULL) {
+            status = CLI_RET_MEM;
+        } else {
+            status = expand_and_open(path, "wb", files[ch]);
+            free(path);
+        }
+    }
+    MUTEX_UNLOCK(&rx->file_mgmt.file_meta_lock);
+
+    if (status != 0 && rx->file_mgmt.file != NULL) {
+        fclose(rx->file_mgmt.file);
+        rx->file_mgmt.file = NULL;
+    }
+
+    return status;
+}
+
+/* Connect to the network endpoint that samples are sent to, in place of
+ * an output file. The caller must hold the file lock. */
+static int rx_open_net(struct cli_state *s, bool planar, unsigned int nchans)
+{
+    if (s->rx->file_mgmt.format != RXTX_FMT_BIN_SC16Q11 || planar) {
+        cli_err(s, "rx", "Network endpoints require the bin format and an "
+                         "interleaved layout.\n");
+        return CLI_RET_INVPARAM;
+    }
+
+    return net_stream_open_sink(s, "rx", s->rx->file_mgmt.path, nchans,
+                                &s->rx->file_mgmt.net);
+}
+
+/* The channel filter must fit within the decimated bandwidth */
+static int rx_check_decim(struct cli_state *s)
+{
+    bladerf_sample_rate rate;
+    unsigned int decim;
+    double fc;
+    int status;
+
+    MUTEX_LOCK(&s->rx->param_lock);
+    decim = ((struct rx_params *)s->rx->params)->decim;
+    fc    = ((struct rx_params *)s->rx->params)->decim_fc;
+    MUTEX_UNLOCK(&s->rx->param_lock);
+
+    if (decim <= 1 || fc == 0.0) {
+        return 0;
+    }
+
+    status = bladerf_get_sample_rate(s->dev, rx_first_channel(s->rx), &rate);
+    if (status != 0) {
+        s->last_lib_error = status;
+        return CLI_RET_LIBBLADERF;
+    }
+
+    if (fc > rate / (2.0 * decim)) {
+        cli_err(s, "rx", "fc=%.0f Hz exceeds half the decimated sample "
+                         "rate, %.0f Hz.\n", fc, rate / (2.0 * decim));
+        return CLI_RET_INVPARAM;
+    }
+
+    return 0;
+}
+
 static int rx_cmd_start(struct cli_state *s)
 {
     int status;
+    unsigned int nchans;
+    bool planar;
 
     /* Check that we can start up in our current state */
     status = rxtx_cmd_start_check(s, s->rx, "rx");
@@ -383,14 +1241,34 @@ static int rx_cmd_start(struct cli_state *s)
         return status;
     }
 
+    planar = rx_is_planar(s->rx);
+    if (planar && s->rx->file_mgmt.format == RXTX_FMT_CSV_SC16Q11) {
+        cli_err(s, "rx", "A planar layout requires the bin or sigmf format.\n");
+        return CLI_RET_INVPARAM;
+    }
+
+    status = rx_check_decim(s);
+    if (status != 0) {
+        return status;
+    }
+
+    MUTEX_LOCK(&s->rx->data_mgmt.lock);
+    nchans = (s->rx->data_mgmt.layout == BLADERF_RX_X2) ? 2 : 1;
+    MUTEX_UNLOCK(&s->rx->data_mgmt.lock);
+
     /* Set up output file */
     MUTEX_LOCK(&s->rx->file_mgmt.file_lock);
-    if (s->rx->file_mgmt.format == RXTX_FMT_CSV_SC16Q11) {
+    if (net_stream_is_uri(s->rx->file_mgmt.path)) {
+        status = rx_open_net(s, planar, nchans);
+    } else if (planar) {
+        status = rx_open_planar(s->rx);
+    } else if (s->rx->file_mgmt.format == RXTX_FMT_CSV_SC16Q11) {
         status =
             expand_and_open(s->rx->file_mgmt.path, "w", &s->rx->file_mgmt.file);
 
     } else {
-        /* RXTX_FMT_BIN_SC16Q11, open file in binary mode */
+        /* RXTX_FMT_BIN_SC16Q11 or RXTX_FMT_SIGMF_SC16Q11, open file in
+         * binary mode */
         status = expand_and_open(s->rx->file_mgmt.path, "wb",
                                  &s->rx->file_mgmt.file);
     }
@@ -416,11 +1294,18 @@ static int rx_cmd_start(struct cli_state *s)
 
 static void rx_print_config(struct rxtx_data *rx)
 {
-    size_t n_samples;
+    size_t n_samples, ring_size;
+    struct rx_ring_stats stats;
     struct rx_params *rx_params = rx->params;
+    struct rx_params params;
+    bool planar;
 
     MUTEX_LOCK(&rx->param_lock);
     n_samples = rx_params->n_samples;
+    ring_size = rx_params->ring_size;
+    stats     = rx_params->ring_stats;
+    planar    = rx_params->planar;
+    params    = *rx_params;
     MUTEX_UNLOCK(&rx->param_lock);
 
     printf("\n");
@@ -437,9 +1322,60 @@ static void rx_print_config(struct rxtx_data *rx)
     }
     rxtx_print_stream_info(rx, "  ", "\n");
 
+    if (planar) {
+        printf("  Layout: planar (RX1 and RX2 in <file>-rx1, <file>-rx2)\n");
+    } else {
+        printf("  Layout: interleaved (RX1 I, RX1 Q, RX2 I, RX2 Q)\n");
+    }
+
+    printf("  Ring size: %" PRIu64 " KiB\n", (uint64_t)ring_size / 1024);
+    if (stats.num_blocks != 0) {
+        printf("  Last capture: ring high-water %u of %u blocks, "
+               "%" PRIu64 " written, %" PRIu64 " dropped\n",
+               stats.high_water, stats.num_blocks, stats.written,
+               stats.dropped);
+    }
+
+    if (params.trigger) {
+        printf("  Trigger: %.1f dBFS, %u ms before, %u ms after\n",
+               params.trigger_dbfs, params.trigger_pre_ms,
+               params.trigger_post_ms);
+        if (stats.num_blocks != 0) {
+            printf("  Last capture: %" PRIu64 " event(s)\n",
+                   params.trigger_events);
+        }
+    } else {
+        printf("  Trigger: off\n");
+    }
+
+    if (params.decim > 1 && params.decim_fc != 0.0) {
+        printf("  Decimation: %u, cutoff %.0f Hz\n", params.decim,
+               params.decim_fc);
+    } else if (params.decim > 1) {
+        printf("  Decimation: %u, cutoff %.2f x the decimated rate\n",
+               params.decim, RX_DECIM_DEFAULT_CUTOFF);
+    } else {
+        printf("  Decimation: off\n");
+    }
+
     printf("\n");
 }
 
+/* Parse a channel filter cutoff, or "auto" for the default */
+static bool rx_parse_fc(const char *val, double *fc)
+{
+    bool ok = true;
+
+    if (!strcasecmp("auto", val)) {
+        *fc = 0.0;
+    } else {
+        *fc = (double)str2uint64_suffix(val, 1, UINT32_MAX, freq_suffixes,
+                                        NUM_FREQ_SUFFIXES, &ok);
+    }
+
+    return ok;
+}
+
 static int rx_cmd_config(struct cli_state *s, int argc, char **argv)
 {
     int i;
@@ -476,6 +1412,123 @@ static int rx_cmd_config(struct cli_state *s, int argc, char **argv)
                     cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
                     return CLI_RET_INVPARAM;
                 }
+            } else if (!strcasecmp("ring", argv[i])) {
+                /* Configure the size of the ring drained by the writer */
+                unsigned int n;
+                bool ok;
+
+                n = str2uint_suffix(val, RX_RING_ALIGNMENT, UINT_MAX,
+                                    rxtx_kmg_suffixes,
+                                    (int)rxtx_kmg_suffixes_len, &ok);
+
+                if (ok) {
+                    MUTEX_LOCK(&s->rx->param_lock);
+                    rx_params->ring_size = n;
+                    MUTEX_UNLOCK(&s->rx->param_lock);
+                } else {
+                    cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
+                    return CLI_RET_INVPARAM;
+                }
+            } else if (!strcasecmp("trigger", argv[i])) {
+                /* Configure the power level that triggers an event */
+                double dbfs = 0.0;
+                bool enable = strcasecmp("off", val) != 0;
+                bool ok     = true;
+
+                if (enable) {
+                    dbfs = str2double(val, -200.0, 10.0, &ok);
+                }
+
+                if (!ok) {
+                    cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
+                    return CLI_RET_INVPARAM;
+                }
+
+                MUTEX_LOCK(&s->rx->param_lock);
+                rx_params->trigger = enable;
+                if (enable) {
+                    rx_params->trigger_dbfs = dbfs;
+                }
+                MUTEX_UNLOCK(&s->rx->param_lock);
+            } else if (!strcasecmp("pretrigger", argv[i]) ||
+                       !strcasecmp("posttrigger", argv[i])) {
+                /* Configure the duration written around an event */
+                unsigned int ms;
+                bool ok;
+
+                ms = str2uint(val, 0, 3600 * 1000, &ok);
+                if (!ok) {
+                    cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
+                    return CLI_RET_INVPARAM;
+                }
+
+                MUTEX_LOCK(&s->rx->param_lock);
+                if (!strcasecmp("pretrigger", argv[i])) {
+                    rx_params->trigger_pre_ms = ms;
+                } else {
+                    rx_params->trigger_post_ms = ms;
+                }
+                MUTEX_UNLOCK(&s->rx->param_lock);
+            } else if (!strcasecmp("decim", argv[i])) {
+                /* Configure decimation, and optionally the channel filter
+                 * cutoff, as decim=<N>[,fc=<Hz>] */
+                char *fc_val = strchr(val, ',');
+                unsigned int decim = 1;
+                double fc          = 0.0;
+                bool ok            = true;
+
+                if (fc_val != NULL) {
+                    *fc_val = '\0';
+                    ok      = !strncasecmp("fc=", fc_val + 1, 3) &&
+                              rx_parse_fc(fc_val + 4, &fc);
+                }
+
+                if (ok && strcasecmp("off", val) != 0) {
+                    decim = str2uint(val, 1, RX_DECIM_MAX_FACTOR, &ok);
+                }
+
+                if (!ok) {
+                    if (fc_val != NULL) {
+                        *fc_val = ',';
+                    }
+                    cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
+                    return CLI_RET_INVPARAM;
+                }
+
+                MUTEX_LOCK(&s->rx->param_lock);
+                rx_params->decim = decim;
+                if (fc_val != NULL) {
+                    rx_params->decim_fc = fc;
+                }
+                MUTEX_UNLOCK(&s->rx->param_lock);
+            } else if (!strcasecmp("fc", argv[i])) {
+                /* Configure the channel filter cutoff used with decim */
+                double fc;
+
+                if (!rx_parse_fc(val, &fc)) {
+                    cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
+                    return CLI_RET_INVPARAM;
+                }
+
+                MUTEX_LOCK(&s->rx->param_lock);
+                rx_params->decim_fc = fc;
+                MUTEX_UNLOCK(&s->rx->param_lock);
+            } else if (!strcasecmp("layout", argv[i])) {
+                /* Configure how MIMO captures are laid out in files */
+                bool planar;
+
+                if (!strcasecmp("planar", val)) {
+                    planar = true;
+                } else if (!strcasecmp("interleaved", val)) {
+                    planar = false;
+                } else {
+                    cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
+                    return CLI_RET_INVPARAM;
+                }
+
+                MUTEX_LOCK(&s->rx->param_lock);
+                rx_params->planar = planar;
+                MUTEX_UNLOCK(&s->rx->param_lock);
             } else if (!strcasecmp("channel", argv[i])) {
                 /* Configure RX channels */
                 status = rxtx_handle_channel_list(s, s->rx, val);
@@ -513,6 +1566,8 @@ int cmd_rx(struct cli_state *s, int argc, char **argv)
         ret = rx_cmd_config(s, argc, argv);
     } else if (!strcasecmp(argv[1], RXTX_CMD_WAIT)) {
         ret = rxtx_handle_wait(s, s->rx, argc, argv);
+    } else if (!strcasecmp(argv[1], RXTX_CMD_STATS)) {
+        ret = rxtx_cmd_stats(s, s->rx);
     } else {
         cli_err(s, argv[0], "Invalid command: \"%s\"\n", argv[1]);
         ret = CLI_RET_INVPARAM;
@@ -0,0 +1,449 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_config.h"
+#include "rel_assert.h"
+#include "thread.h"
+
+#if BLADERF_OS_LINUX || BLADERF_OS_OSX || BLADERF_OS_FREEBSD
+#include <unistd.h>
+#endif
+
+#include "rx_decim.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RX_DECIM_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RX_DECIM_NEON 1
+#endif
+
+/* The filter is zero-padded to a whole number of these */
+#define TAP_VECTOR 8
+
+/* Threads are only woken for blocks with at least this many outputs */
+#define MIN_OUTPUTS_PER_THREAD 64
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+struct rx_decim;
+
+struct rx_decim_worker {
+    struct rx_decim *d;
+    unsigned int index;
+    pthread_t thread;
+};
+
+struct rx_decim {
+    unsigned int factor;
+    unsigned int nchans;
+
+    int16_t *taps;    /* Time-reversed Q15 taps, zero-padded */
+    size_t num_taps;  /* A multiple of TAP_VECTOR */
+
+    /* A row of samples for the I and for the Q of each channel. Each row
+     * holds the last num_taps - 1 samples of the previous block, followed
+     * by the current block. */
+    int16_t *rows;
+    size_t row_len;
+    size_t max_block; /* Samples per channel */
+
+    size_t phase; /* Input samples, per channel, before the next output */
+
+    /* The block being processed */
+    int16_t *out;
+    size_t out_count; /* Outputs, per channel */
+    size_t out_first; /* Row index of the first output's oldest sample */
+    unsigned int active; /* Threads sharing the block */
+
+    struct rx_decim_worker *workers;
+    unsigned int num_workers;
+    MUTEX lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    unsigned int generation;
+    unsigned int pending;
+    bool stop;
+};
+
+static inline int16_t fir_round(int32_t acc)
+{
+    acc = (acc + (1 << 14)) >> 15;
+
+    if (acc > INT16_MAX) {
+        return INT16_MAX;
+    } else if (acc < INT16_MIN) {
+        return INT16_MIN;
+    }
+
+    return (int16_t)acc;
+}
+
+#if defined(RX_DECIM_SSE2)
+static inline int16_t fir_dot(const int16_t *h, const int16_t *x, size_t n)
+{
+    __m128i acc = _mm_setzero_si128();
+    size_t k;
+
+    for (k = 0; k < n; k += TAP_VECTOR) {
+        __m128i vh = _mm_loadu_si128((const __m128i *)(h + k));
+        __m128i vx = _mm_loadu_si128((const __m128i *)(x + k));
+        acc        = _mm_add_epi32(acc, _mm_madd_epi16(vh, vx));
+    }
+
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4e));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xb1));
+
+    return fir_round(_mm_cvtsi128_si32(acc));
+}
+#elif defined(RX_DECIM_NEON)
+static inline int16_t fir_dot(const int16_t *h, const int16_t *x, size_t n)
+{
+    int32x4_t acc = vdupq_n_s32(0);
+    int32x2_t sum;
+    size_t k;
+
+    for (k = 0; k < n; k += TAP_VECTOR) {
+        int16x8_t vh = vld1q_s16(h + k);
+        int16x8_t vx = vld1q_s16(x + k);
+        acc = vmlal_s16(acc, vget_low_s16(vh), vget_low_s16(vx));
+        acc = vmlal_s16(acc, vget_high_s16(vh), vget_high_s16(vx));
+    }
+
+    sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+    sum = vpadd_s32(sum, sum);
+
+    return fir_round(vget_lane_s32(sum, 0));
+}
+#else
+static inline int16_t fir_dot(const int16_t *h, const int16_t *x, size_t n)
+{
+    int32_t acc = 0;
+    size_t k;
+
+    for (k = 0; k < n; k++) {
+        acc += (int32_t)h[k] * x[k];
+    }
+
+    return fir_round(acc);
+}
+#endif
+
+static int16_t *row(struct rx_decim *d, unsigned int r)
+{
+    return d->rows + r * d->row_len;
+}
+
+/* Compute outputs [j0, j1) of the current block, for every channel */
+static void decim_range(struct rx_decim *d, size_t j0, size_t j1)
+{
+    const size_t stride = 2 * d->nchans;
+    unsigned int c;
+    size_t j;
+
+    for (c = 0; c < d->nchans; c++) {
+        const int16_t *xi = row(d, 2 * c) + d->out_first;
+        const int16_t *xq = row(d, 2 * c + 1) + d->out_first;
+        int16_t *out      = d->out + 2 * c;
+
+        for (j = j0; j < j1; j++) {
+            const size_t p = j * d->factor;
+
+            out[j * stride]     = fir_dot(d->taps, xi + p, d->num_taps);
+            out[j * stride + 1] = fir_dot(d->taps, xq + p, d->num_taps);
+        }
+    }
+}
+
+/* Compute this thread's share of the current block's outputs */
+static void decim_share(struct rx_decim *d, unsigned int index)
+{
+    const size_t j0 = d->out_count * index / d->active;
+    const size_t j1 = d->out_count * (index + 1) / d->active;
+
+    decim_range(d, j0, j1);
+}
+
+static void *decim_worker(void *arg)
+{
+    struct rx_decim_worker *w = arg;
+    struct rx_decim *d        = w->d;
+    unsigned int generation   = 0;
+
+    MUTEX_LOCK(&d->lock);
+
+    while (true) {
+        while (d->generation == generation && !d->stop) {
+            pthread_cond_wait(&d->start, &d->lock);
+        }
+
+        if (d->stop) {
+            break;
+        }
+
+        generation = d->generation;
+
+        /* Workers beyond those needed for a small block sit it out */
+        if (w->index < d->active) {
+            MUTEX_UNLOCK(&d->lock);
+            decim_share(d, w->index);
+            MUTEX_LOCK(&d->lock);
+
+            if (--d->pending == 0) {
+                pthread_cond_signal(&d->done);
+            }
+        }
+    }
+
+    MUTEX_UNLOCK(&d->lock);
+    return NULL;
+}
+
+/* Blackman-windowed sinc, normalized to unity gain at DC */
+static int design_taps(struct rx_decim *d, double cutoff)
+{
+    const size_t len = (size_t)RX_DECIM_TAPS_PER_PHASE * d->factor + 1;
+    const double mid = (double)(len - 1) / 2.0;
+    double *h;
+    double sum = 0.0;
+    size_t i;
+
+    d->num_taps = (len + TAP_VECTOR - 1) / TAP_VECTOR * TAP_VECTOR;
+    d->taps     = calloc(d->num_taps, sizeof(d->taps[0]));
+    h           = malloc(len * sizeof(h[0]));
+
+    if (d->taps == NULL || h == NULL) {
+        free(h);
+        return -1;
+    }
+
+    for (i = 0; i < len; i++) {
+        const double t = (double)i - mid;
+        const double w = 0.42 - 0.5 * cos(2.0 * M_PI * i / (len - 1)) +
+                         0.08 * cos(4.0 * M_PI * i / (len - 1));
+        const double s = (t == 0.0) ? 2.0 * cutoff
+                                    : sin(2.0 * M_PI * cutoff * t) / (M_PI * t);
+
+        h[i] = s * w;
+        sum += h[i];
+    }
+
+    /* The filter is symmetric, so reversing it for the dot product in
+     * fir_dot() only moves the zero padding to the front */
+    for (i = 0; i < len; i++) {
+        d->taps[d->num_taps - len + i] = (int16_t)lrint(h[i] / sum * 32768.0);
+    }
+
+    free(h);
+    return 0;
+}
+
+unsigned int rx_decim_default_threads(void)
+{
+    long n = 1;
+
+#ifdef _SC_NPROCESSORS_ONLN
+    n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+    /* Leave a CPU for the RX thread, and a little for everything else */
+    if (n > 5) {
+        n = 4;
+    } else if (n > 1) {
+        n--;
+    } else {
+        n = 1;
+    }
+
+    return (unsigned int)n;
+}
+
+struct rx_decim *rx_decim_create(unsigned int factor,
+                                 double cutoff,
+                                 unsigned int nchans,
+                                 size_t block_samples,
+                                 unsigned int num_threads)
+{
+    struct rx_decim *d;
+    unsigned int i;
+
+    if (factor < 2 || factor > RX_DECIM_MAX_FACTOR || nchans == 0 ||
+        !(cutoff > 0.0 && cutoff <= 0.5 / factor) || num_threads == 0) {
+        return NULL;
+    }
+
+    d = calloc(1, sizeof(*d));
+    if (d == NULL) {
+        return NULL;
+    }
+
+    d->factor    = factor;
+    d->nchans    = nchans;
+    d->max_block = block_samples / nchans;
+
+    if (design_taps(d, cutoff) != 0) {
+        free(d);
+        return NULL;
+    }
+
+    d->row_len = d->num_taps - 1 + d->max_block;
+    d->rows    = calloc(2 * nchans * d->row_len, sizeof(d->rows[0]));
+    d->workers = calloc(num_threads, sizeof(d->workers[0]));
+
+    if (d->rows == NULL || d->workers == NULL) {
+        free(d->workers);
+        free(d->rows);
+        free(d->taps);
+        free(d);
+        return NULL;
+    }
+
+    MUTEX_INIT(&d->lock);
+    pthread_cond_init(&d->start, NULL);
+    pthread_cond_init(&d->done, NULL);
+
+    /* The caller computes the first share of each block */
+    for (i = 1; i < num_threads; i++) {
+        struct rx_decim_worker *w = &d->workers[d->num_workers];
+
+        w->d     = d;
+        w->index = i;
+        if (pthread_create(&w->thread, NULL, decim_worker, w) != 0) {
+            break;
+        }
+
+        d->num_workers++;
+    }
+
+    return d;
+}
+
+size_t rx_decim_run(struct rx_decim *d,
+                    const int16_t *in,
+                    size_t n,
+                    int16_t *out,
+                    size_t *offset)
+{
+    const size_t hist = d->num_taps - 1;
+    const size_t m    = n / d->nchans;
+    unsigned int c, r;
+    size_t i, count;
+
+    assert(m <= d->max_block);
+
+    /* Deinterleave each channel's I and Q after the previous history */
+    for (c = 0; c < d->nchans; c++) {
+        int16_t *xi     = row(d, 2 * c) + hist;
+        int16_t *xq     = row(d, 2 * c + 1) + hist;
+        const int16_t *s = in + 2 * c;
+
+        for (i = 0; i < m; i++) {
+            xi[i] = s[0];
+            xq[i] = s[1];
+            s += 2 * d->nchans;
+        }
+    }
+
+    count = (m > d->phase) ? (m - d->phase + d->factor - 1) / d->factor : 0;
+
+    if (offset != NULL) {
+        *offset = d->phase;
+    }
+
+    d->out       = out;
+    d->out_count = count;
+    d->out_first = d->phase;
+
+    if (count != 0) {
+        unsigned int active = 1 + d->num_workers;
+
+        if (count < (size_t)active * MIN_OUTPUTS_PER_THREAD) {
+            active = (unsigned int)(count / MIN_OUTPUTS_PER_THREAD);
+            if (active == 0) {
+                active = 1;
+            }
+        }
+
+        /* A worker left out of the last block may only now be checking
+         * whether it is needed, so this is updated under the lock */
+        MUTEX_LOCK(&d->lock);
+        d->active = active;
+        if (active > 1) {
+            d->pending = active - 1;
+            d->generation++;
+            pthread_cond_broadcast(&d->start);
+        }
+        MUTEX_UNLOCK(&d->lock);
+
+        decim_share(d, 0);
+
+        if (active > 1) {
+            MUTEX_LOCK(&d->lock);
+            while (d->pending != 0) {
+                pthread_cond_wait(&d->done, &d->lock);
+            }
+            MUTEX_UNLOCK(&d->lock);
+        }
+    }
+
+    d->phase = d->phase + count * d->factor - m;
+
+    /* Keep the end of this block as the history for the next */
+    for (r = 0; r < 2 * d->nchans; r++) {
+        memmove(row(d, r), row(d, r) + m, hist * sizeof(int16_t));
+    }
+
+    return count * d->nchans;
+}
+
+void rx_decim_destroy(struct rx_decim *d)
+{
+    unsigned int i;
+
+    if (d == NULL) {
+        return;
+    }
+
+    MUTEX_LOCK(&d->lock);
+    d->stop = true;
+    pthread_cond_broadcast(&d->start);
+    MUTEX_UNLOCK(&d->lock);
+
+    for (i = 0; i < d->num_workers; i++) {
+        pthread_join(d->workers[i].thread, NULL);
+    }
+
+    pthread_cond_destroy(&d->done);
+    pthread_cond_destroy(&d->start);
+    MUTEX_DESTROY(&d->lock);
+    free(d->workers);
+    free(d->rows);
+    free(d->taps);
+    free(d);
+}
@@ -0,0 +1,104 @@
+/**
+ * @file rx_decim.h
+ *
+ * @brief Decimating channel filter for captured samples
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef RX_DECIM_H__
+#define RX_DECIM_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Largest supported decimation factor */
+#define RX_DECIM_MAX_FACTOR 256
+
+/* Filter taps per output sample. The filter is this many times the
+ * decimation factor long, which keeps the cost per input sample constant. */
+#define RX_DECIM_TAPS_PER_PHASE 24
+
+/* Default cutoff, as a fraction of the output sample rate */
+#define RX_DECIM_DEFAULT_CUTOFF 0.4
+
+struct rx_decim;
+
+/**
+ * Create a decimator for a stream of interleaved channels
+ *
+ * The lowpass filter is a Blackman-windowed sinc with unity gain at DC, in
+ * Q15. Only the outputs that are kept are computed, so the cost is that of
+ * a polyphase filter bank.
+ *
+ * @param   factor          Decimation factor, from 2 to RX_DECIM_MAX_FACTOR
+ * @param   cutoff          Cutoff (-6 dB point), as a fraction of the input
+ *                          sample rate. Must be in (0, 0.5 / factor].
+ * @param   nchans          Number of interleaved channels
+ * @param   block_samples   Most samples, across all channels, passed to
+ *                          each rx_decim_run() call
+ * @param   num_threads     Threads that share the work of each block,
+ *                          including the caller's
+ *
+ * @return decimator handle, or NULL on failure
+ */
+struct rx_decim *rx_decim_create(unsigned int factor,
+                                 double cutoff,
+                                 unsigned int nchans,
+                                 size_t block_samples,
+                                 unsigned int num_threads);
+
+/**
+ * Suggest a thread count for rx_decim_create(), based on the CPUs online
+ *
+ * @return thread count, at least 1
+ */
+unsigned int rx_decim_default_threads(void);
+
+/**
+ * Filter and decimate a block of samples. Filter state and the decimation
+ * phase carry over from the previous block, so the output is the same
+ * however the input is split into blocks.
+ *
+ * Samples are in host byte order.
+ *
+ * @param   d           Decimator handle
+ * @param   in          Interleaved input samples
+ * @param   n           Number of input samples (I,Q pairs), a multiple of
+ *                      the channel count
+ * @param   out         Interleaved output samples. May be the same as `in'.
+ * @param   offset      If not NULL, updated with the index of the input
+ *                      sample, per channel, that the first output
+ *                      corresponds to.
+ *
+ * @return number of output samples (I,Q pairs) across all channels
+ */
+size_t rx_decim_run(struct rx_decim *d,
+                    const int16_t *in,
+                    size_t n,
+                    int16_t *out,
+                    size_t *offset);
+
+/**
+ * Stop the decimator's threads and free it
+ *
+ * @param   d       Decimator handle. May be NULL.
+ */
+void rx_decim_destroy(struct rx_decim *d);
+
+#endif
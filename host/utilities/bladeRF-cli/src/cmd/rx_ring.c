@@ -0,0 +1,281 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_config.h"
+#include "rel_assert.h"
+#include "thread.h"
+
+#include "rx_ring.h"
+
+struct rx_ring {
+    MUTEX lock;
+    pthread_cond_t data_ready; /* Signalled when a block is queued */
+    pthread_t thread;
+
+    void *mem;            /* Allocation backing all blocks */
+    int16_t **blocks;     /* num_blocks ring blocks, followed by scratch */
+    size_t *lengths;      /* Samples queued in each ring block */
+    uint64_t *timestamps; /* Timestamp of each ring block */
+    size_t block_samples;
+
+    unsigned int num_blocks;
+    unsigned int head;    /* Next block to receive into */
+    unsigned int tail;    /* Next block to write out */
+    unsigned int count;   /* Blocks queued for writing */
+    int16_t *current;     /* Block last returned by rx_ring_next() */
+
+    bool stop;
+    int status;           /* First error reported by write_fn */
+
+    rx_ring_write_fn write_fn;
+    void *arg;
+
+    struct rx_ring_stats stats;
+};
+
+static void *alloc_aligned(size_t len)
+{
+#if BLADERF_OS_WINDOWS
+    return _aligned_malloc(len, RX_RING_ALIGNMENT);
+#else
+    void *ret;
+
+    if (posix_memalign(&ret, RX_RING_ALIGNMENT, len) != 0) {
+        return NULL;
+    }
+
+    return ret;
+#endif
+}
+
+static void free_aligned(void *mem)
+{
+#if BLADERF_OS_WINDOWS
+    _aligned_free(mem);
+#else
+    free(mem);
+#endif
+}
+
+static void *rx_ring_writer(void *arg)
+{
+    struct rx_ring *ring = arg;
+    int16_t *block;
+    size_t n;
+    uint64_t ts;
+    int status;
+
+    MUTEX_LOCK(&ring->lock);
+
+    while (true) {
+        while (ring->count == 0 && !ring->stop) {
+            pthread_cond_wait(&ring->data_ready, &ring->lock);
+        }
+
+        if (ring->count == 0) {
+            break;
+        }
+
+        block = ring->blocks[ring->tail];
+        n     = ring->lengths[ring->tail];
+        ts    = ring->timestamps[ring->tail];
+
+        /* The producer does not touch a queued block, so it may be written
+         * without holding the lock */
+        MUTEX_UNLOCK(&ring->lock);
+        status = 0;
+        if (ring->status == 0) {
+            status = ring->write_fn(ring->arg, block, n, ts);
+        }
+        MUTEX_LOCK(&ring->lock);
+
+        if (status != 0 && ring->status == 0) {
+            ring->status = status;
+        }
+
+        if (ring->status == 0) {
+            ring->stats.written++;
+        }
+
+        ring->tail = (ring->tail + 1) % ring->num_blocks;
+        ring->count--;
+    }
+
+    MUTEX_UNLOCK(&ring->lock);
+    return NULL;
+}
+
+struct rx_ring *rx_ring_create(size_t ring_bytes,
+                               size_t block_samples,
+                               rx_ring_write_fn write_fn,
+                               void *arg)
+{
+    struct rx_ring *ring;
+    size_t block_bytes, i;
+
+    /* Each block is kept aligned by rounding its size up */
+    block_bytes = block_samples * 2 * sizeof(int16_t);
+    block_bytes = (block_bytes + RX_RING_ALIGNMENT - 1) &
+                  ~((size_t)RX_RING_ALIGNMENT - 1);
+
+    ring = calloc(1, sizeof(*ring));
+    if (ring == NULL) {
+        return NULL;
+    }
+
+    ring->num_blocks = (unsigned int)(ring_bytes / block_bytes);
+    if (ring->num_blocks < 2) {
+        ring->num_blocks = 2;
+    }
+
+    ring->block_samples    = block_samples;
+    ring->write_fn         = write_fn;
+    ring->arg              = arg;
+    ring->stats.num_blocks = ring->num_blocks;
+
+    ring->mem     = alloc_aligned((ring->num_blocks + 1) * block_bytes);
+    ring->blocks  = calloc(ring->num_blocks + 1, sizeof(ring->blocks[0]));
+    ring->lengths = calloc(ring->num_blocks, sizeof(ring->lengths[0]));
+    ring->timestamps =
+        calloc(ring->num_blocks, sizeof(ring->timestamps[0]));
+
+    if (ring->mem == NULL || ring->blocks == NULL || ring->lengths == NULL ||
+        ring->timestamps == NULL) {
+        goto error;
+    }
+
+    for (i = 0; i <= ring->num_blocks; i++) {
+        ring->blocks[i] = (int16_t *)((uint8_t *)ring->mem + i * block_bytes);
+    }
+
+    MUTEX_INIT(&ring->lock);
+    pthread_cond_init(&ring->data_ready, NULL);
+
+    if (pthread_create(&ring->thread, NULL, rx_ring_writer, ring) != 0) {
+        pthread_cond_destroy(&ring->data_ready);
+        MUTEX_DESTROY(&ring->lock);
+        goto error;
+    }
+
+    return ring;
+
+error:
+    if (ring->mem != NULL) {
+        free_aligned(ring->mem);
+    }
+    free(ring->blocks);
+    free(ring->lengths);
+    free(ring->timestamps);
+    free(ring);
+    return NULL;
+}
+
+int16_t *rx_ring_next(struct rx_ring *ring)
+{
+    MUTEX_LOCK(&ring->lock);
+
+    if (ring->count < ring->num_blocks) {
+        ring->current = ring->blocks[ring->head];
+    } else {
+        ring->current = ring->blocks[ring->num_blocks];
+    }
+
+    MUTEX_UNLOCK(&ring->lock);
+
+    return ring->current;
+}
+
+bool rx_ring_will_drop(const struct rx_ring *ring)
+{
+    /* Only the producer updates `current', so no lock is needed */
+    return ring->current == ring->blocks[ring->num_blocks];
+}
+
+int rx_ring_commit(struct rx_ring *ring, size_t n, uint64_t timestamp)
+{
+    int status;
+
+    assert(n <= ring->block_samples);
+
+    MUTEX_LOCK(&ring->lock);
+
+    if (ring->current == ring->blocks[ring->num_blocks]) {
+        ring->stats.dropped++;
+    } else {
+        assert(ring->current == ring->blocks[ring->head]);
+
+        ring->lengths[ring->head]    = n;
+        ring->timestamps[ring->head] = timestamp;
+        ring->head = (ring->head + 1) % ring->num_blocks;
+        ring->count++;
+
+        if (ring->count > ring->stats.high_water) {
+            ring->stats.high_water = ring->count;
+        }
+
+        pthread_cond_signal(&ring->data_ready);
+    }
+
+    ring->current = NULL;
+    status        = ring->status;
+
+    MUTEX_UNLOCK(&ring->lock);
+
+    return status;
+}
+
+void rx_ring_get_stats(struct rx_ring *ring, struct rx_ring_stats *stats)
+{
+    MUTEX_LOCK(&ring->lock);
+    *stats         = ring->stats;
+    stats->pending = ring->count;
+    MUTEX_UNLOCK(&ring->lock);
+}
+
+int rx_ring_destroy(struct rx_ring *ring, struct rx_ring_stats *stats)
+{
+    int status;
+
+    MUTEX_LOCK(&ring->lock);
+    ring->stop = true;
+    pthread_cond_signal(&ring->data_ready);
+    MUTEX_UNLOCK(&ring->lock);
+
+    pthread_join(ring->thread, NULL);
+
+    status = ring->status;
+    if (stats != NULL) {
+        *stats = ring->stats;
+    }
+
+    pthread_cond_destroy(&ring->data_ready);
+    MUTEX_DESTROY(&ring->lock);
+    free_aligned(ring->mem);
+    free(ring->blocks);
+    free(ring->lengths);
+    free(ring->timestamps);
+    free(ring);
+
+    return status;
+}
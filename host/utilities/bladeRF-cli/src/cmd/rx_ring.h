@@ -0,0 +1,127 @@
+/**
+ * @file rx_ring.h
+ *
+ * @brief Sample ring between the RX task and a file writer thread
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef RX_RING_H__
+#define RX_RING_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Alignment of each block in the ring, suitable for O_DIRECT writes */
+#define RX_RING_ALIGNMENT 4096
+
+/* Default ring size, in bytes */
+#define RX_RING_DEFAULT_SIZE (128 * 1024 * 1024)
+
+struct rx_ring;
+
+struct rx_ring_stats {
+    unsigned int num_blocks; /* Blocks in the ring */
+    unsigned int high_water; /* Most blocks that were ever pending */
+    uint64_t written;        /* Blocks written out */
+    uint64_t dropped;        /* Blocks dropped because the ring was full */
+    unsigned int pending;    /* Blocks queued when the stats were read */
+};
+
+/**
+ * Write a block of samples drained from the ring
+ *
+ * @param   arg         User data provided to rx_ring_create()
+ * @param   samples     Samples
+ * @param   n           Number of samples (I,Q pairs)
+ * @param   timestamp   Timestamp provided to rx_ring_commit()
+ *
+ * @return 0 on success, CLI_RET_* on failure. Draining stops on failure.
+ */
+typedef int (*rx_ring_write_fn)(void *arg,
+                                int16_t *samples,
+                                size_t n,
+                                uint64_t timestamp);
+
+/**
+ * Allocate a ring and start its writer thread
+ *
+ * @param   ring_bytes      Ring size, in bytes. At least two blocks are used.
+ * @param   block_samples   Samples per block
+ * @param   write_fn        Called from the writer thread for each block
+ * @param   arg             Passed to write_fn
+ *
+ * @return ring handle, or NULL on failure
+ */
+struct rx_ring *rx_ring_create(size_t ring_bytes,
+                               size_t block_samples,
+                               rx_ring_write_fn write_fn,
+                               void *arg);
+
+/**
+ * Get the next block to receive samples into. This never blocks: if the
+ * ring is full, a scratch block is returned and is dropped on commit.
+ *
+ * @param   ring    Ring handle
+ *
+ * @return block of `block_samples' samples, aligned to RX_RING_ALIGNMENT
+ */
+int16_t *rx_ring_next(struct rx_ring *ring);
+
+/**
+ * Check whether the block returned by the last rx_ring_next() call is a
+ * scratch block, which will be dropped when it is committed
+ *
+ * @param   ring    Ring handle
+ *
+ * @return true if the block will be dropped
+ */
+bool rx_ring_will_drop(const struct rx_ring *ring);
+
+/**
+ * Queue the block returned by the last rx_ring_next() call for writing
+ *
+ * @param   ring        Ring handle
+ * @param   n           Number of samples to write from the block
+ * @param   timestamp   Timestamp of the block's first sample, if known
+ *
+ * @return 0, or the writer's CLI_RET_* status if writing has failed
+ */
+int rx_ring_commit(struct rx_ring *ring, size_t n, uint64_t timestamp);
+
+/**
+ * Read the ring's statistics while it is in use
+ *
+ * @param   ring    Ring handle
+ * @param   stats   Updated with ring statistics
+ */
+void rx_ring_get_stats(struct rx_ring *ring, struct rx_ring_stats *stats);
+
+/**
+ * Wait for all queued blocks to be written, stop the writer thread, and
+ * free the ring
+ *
+ * @param   ring    Ring handle
+ * @param   stats   Updated with ring statistics. May be NULL.
+ *
+ * @return 0, or the writer's CLI_RET_* status if writing failed
+ */
+int rx_ring_destroy(struct rx_ring *ring, struct rx_ring_stats *stats);
+
+#endif
@@ -0,0 +1,144 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <math.h>
+#include <stdlib.h>
+
+#include "rel_assert.h"
+
+#include "rx_trigger.h"
+
+/* SC16 Q11 full scale */
+#define FULL_SCALE 2048.0
+
+struct rx_trigger {
+    void *mem;   /* Allocation backing all blocks */
+    struct rx_trigger_block *blocks;
+
+    /* One more block than requested is held, for the latest */
+    unsigned int num_blocks;
+    unsigned int head;  /* Next block to receive into */
+    unsigned int count; /* Blocks held */
+};
+
+double rx_trigger_power(const int16_t *samples, size_t n)
+{
+    const size_t window = 2 * RX_TRIGGER_WINDOW;
+    size_t len = 2 * n;
+    size_t i, j, w;
+    int64_t sum, max = 0;
+    size_t max_len = 1;
+
+    for (i = 0; i < len; i += w) {
+        w   = (len - i < window) ? (len - i) : window;
+        sum = 0;
+
+        /* Each product fits in 31 bits, so this vectorizes as 32-bit
+         * multiplies into 64-bit accumulators */
+        for (j = 0; j < w; j++) {
+            sum += (int32_t)samples[i + j] * samples[i + j];
+        }
+
+        /* Compare mean powers, as the final window may be short */
+        if ((double)sum * max_len > (double)max * w) {
+            max     = sum;
+            max_len = w;
+        }
+    }
+
+    /* Per I,Q pair */
+    return 2.0 * (double)max / (double)max_len;
+}
+
+double rx_trigger_dbfs_to_power(double dbfs)
+{
+    return FULL_SCALE * FULL_SCALE * pow(10.0, dbfs / 10.0);
+}
+
+struct rx_trigger *rx_trigger_create(unsigned int num_blocks,
+                                     size_t block_samples)
+{
+    struct rx_trigger *t;
+    size_t block_bytes = block_samples * 2 * sizeof(int16_t);
+    unsigned int i;
+
+    t = calloc(1, sizeof(*t));
+    if (t == NULL) {
+        return NULL;
+    }
+
+    t->num_blocks = num_blocks + 1;
+    t->mem        = malloc(t->num_blocks * block_bytes);
+    t->blocks     = calloc(t->num_blocks, sizeof(t->blocks[0]));
+
+    if (t->mem == NULL || t->blocks == NULL) {
+        rx_trigger_destroy(t);
+        return NULL;
+    }
+
+    for (i = 0; i < t->num_blocks; i++) {
+        t->blocks[i].samples =
+            (int16_t *)((uint8_t *)t->mem + (size_t)i * block_bytes);
+    }
+
+    return t;
+}
+
+int16_t *rx_trigger_next(struct rx_trigger *t)
+{
+    return t->blocks[t->head].samples;
+}
+
+void rx_trigger_push(struct rx_trigger *t, size_t n, uint64_t timestamp)
+{
+    t->blocks[t->head].n         = n;
+    t->blocks[t->head].timestamp = timestamp;
+
+    t->head = (t->head + 1) % t->num_blocks;
+    if (t->count < t->num_blocks) {
+        t->count++;
+    }
+}
+
+unsigned int rx_trigger_count(const struct rx_trigger *t)
+{
+    return t->count;
+}
+
+const struct rx_trigger_block *rx_trigger_get(const struct rx_trigger *t,
+                                              unsigned int i)
+{
+    assert(i < t->count);
+    return &t->blocks[(t->head + t->num_blocks - t->count + i) %
+                      t->num_blocks];
+}
+
+void rx_trigger_clear(struct rx_trigger *t)
+{
+    t->count = 0;
+}
+
+void rx_trigger_destroy(struct rx_trigger *t)
+{
+    if (t != NULL) {
+        free(t->mem);
+        free(t->blocks);
+        free(t);
+    }
+}
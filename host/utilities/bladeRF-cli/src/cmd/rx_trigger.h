@@ -0,0 +1,128 @@
+/**
+ * @file rx_trigger.h
+ *
+ * @brief Power trigger and pre-trigger history for RX captures
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef RX_TRIGGER_H__
+#define RX_TRIGGER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Samples over which power is averaged by rx_trigger_power() */
+#define RX_TRIGGER_WINDOW 256
+
+/* Default pre-trigger and post-trigger durations, in ms */
+#define RX_TRIGGER_DEFAULT_PRE_MS 10
+#define RX_TRIGGER_DEFAULT_POST_MS 100
+
+struct rx_trigger;
+
+/* A block held in the pre-trigger history */
+struct rx_trigger_block {
+    int16_t *samples;
+    size_t n;           /* Number of samples (I,Q pairs) received */
+    uint64_t timestamp; /* Timestamp of the first sample */
+};
+
+/**
+ * Compute the highest mean power of any window of RX_TRIGGER_WINDOW
+ * samples in a block. The loop is kept simple enough for the compiler to
+ * vectorize, as it runs on every block received.
+ *
+ * @param   samples     Samples
+ * @param   n           Number of samples (I,Q pairs)
+ *
+ * @return mean I^2 + Q^2, in LSB^2. Full scale is 2048^2.
+ */
+double rx_trigger_power(const int16_t *samples, size_t n);
+
+/**
+ * Convert a level in dBFS to a power comparable with rx_trigger_power()
+ *
+ * @param   dbfs    Level, relative to a full scale of 2048
+ *
+ * @return power in LSB^2
+ */
+double rx_trigger_dbfs_to_power(double dbfs);
+
+/**
+ * Allocate a pre-trigger history
+ *
+ * @param   num_blocks      Blocks to hold before the one that triggers
+ * @param   block_samples   Samples per block
+ *
+ * @return history handle, or NULL on failure
+ */
+struct rx_trigger *rx_trigger_create(unsigned int num_blocks,
+                                     size_t block_samples);
+
+/**
+ * Get the block to receive samples into. This overwrites the oldest block
+ * once the history is full.
+ *
+ * @param   t   History handle
+ *
+ * @return block of `block_samples' samples
+ */
+int16_t *rx_trigger_next(struct rx_trigger *t);
+
+/**
+ * Add the block returned by the last rx_trigger_next() call to the history
+ *
+ * @param   t           History handle
+ * @param   n           Number of samples received into the block
+ * @param   timestamp   Timestamp of the block's first sample
+ */
+void rx_trigger_push(struct rx_trigger *t, size_t n, uint64_t timestamp);
+
+/**
+ * @param   t   History handle
+ *
+ * @return number of blocks in the history, including the latest
+ */
+unsigned int rx_trigger_count(const struct rx_trigger *t);
+
+/**
+ * @param   t   History handle
+ * @param   i   Index, from 0 for the oldest block to rx_trigger_count() - 1
+ *              for the latest
+ *
+ * @return block
+ */
+const struct rx_trigger_block *rx_trigger_get(const struct rx_trigger *t,
+                                              unsigned int i);
+
+/**
+ * Empty the history, e.g., once it has been written out
+ *
+ * @param   t   History handle
+ */
+void rx_trigger_clear(struct rx_trigger *t);
+
+/**
+ * Free a pre-trigger history
+ *
+ * @param   t   History handle. May be NULL.
+ */
+void rx_trigger_destroy(struct rx_trigger *t);
+
+#endif
@@ -241,6 +241,9 @@ void rxtx_print_file_format(struct rxtx_data *rxtx,
         case RXTX_FMT_BIN_SC16Q11:
             printf("%sSC16 Q11, Binary%s", prefix, suffix);
             break;
+        case RXTX_FMT_SIGMF_SC16Q11:
+            printf("%sSC16 Q11, SigMF%s", prefix, suffix);
+            break;
         default:
             printf("%sNot configured%s", prefix, suffix);
     }
@@ -281,19 +284,210 @@ void rxtx_print_stream_info(struct rxtx_data *rxtx,
                             const char *prefix,
                             const char *suffix)
 {
-    unsigned int bufs, samps, xfers, timeout;
+    unsigned int bufs, samps, xfers, timeout, status_ms;
+    bool start_scheduled, start_relative;
+    uint64_t start_ts;
 
     MUTEX_LOCK(&rxtx->data_mgmt.lock);
-    bufs    = (unsigned int)rxtx->data_mgmt.num_buffers;
-    samps   = (unsigned int)rxtx->data_mgmt.samples_per_buffer;
-    xfers   = (unsigned int)rxtx->data_mgmt.num_transfers;
-    timeout = rxtx->data_mgmt.timeout_ms;
+    bufs            = (unsigned int)rxtx->data_mgmt.num_buffers;
+    samps           = (unsigned int)rxtx->data_mgmt.samples_per_buffer;
+    xfers           = (unsigned int)rxtx->data_mgmt.num_transfers;
+    timeout         = rxtx->data_mgmt.timeout_ms;
+    status_ms       = rxtx->data_mgmt.status_ms;
+    start_scheduled = rxtx->data_mgmt.start_scheduled;
+    start_relative  = rxtx->data_mgmt.start_relative;
+    start_ts        = rxtx->data_mgmt.start_ts;
     MUTEX_UNLOCK(&rxtx->data_mgmt.lock);
 
     printf("%s# Buffers: %u%s", prefix, bufs, suffix);
     printf("%s# Samples per buffer: %u%s", prefix, samps, suffix);
     printf("%s# Transfers: %u%s", prefix, xfers, suffix);
     printf("%sTimeout (ms): %u%s", prefix, timeout, suffix);
+
+    if (status_ms != 0) {
+        printf("%sStatus interval (ms): %u%s", prefix, status_ms, suffix);
+    } else {
+        printf("%sStatus interval: off%s", prefix, suffix);
+    }
+
+    if (!start_scheduled) {
+        printf("%sStart: now%s", prefix, suffix);
+    } else if (start_relative) {
+        printf("%sStart: %" PRIu64 " samples after start%s", prefix, start_ts,
+               suffix);
+    } else {
+        printf("%sStart: timestamp %" PRIu64 "%s", prefix, start_ts, suffix);
+    }
+}
+
+static double timespec_diff(const struct timespec *end,
+                            const struct timespec *start)
+{
+    return (double)(end->tv_sec - start->tv_sec) +
+           (double)(end->tv_nsec - start->tv_nsec) / NSEC_PER_SEC;
+}
+
+/* Take a consistent copy of the live counters, and the time they cover */
+static double rxtx_stats_snapshot(struct rxtx_data *rxtx,
+                                  struct rxtx_stats *copy)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    MUTEX_LOCK(&rxtx->stats_lock);
+    *copy = rxtx->stats;
+    MUTEX_UNLOCK(&rxtx->stats_lock);
+
+    if (copy->start.tv_sec == 0 && copy->start.tv_nsec == 0) {
+        return 0.0;
+    }
+
+    return timespec_diff(copy->running ? &now : &copy->end, &copy->start);
+}
+
+void rxtx_stats_start(struct rxtx_data *rxtx)
+{
+    MUTEX_LOCK(&rxtx->stats_lock);
+    rxtx->stats.running    = true;
+    rxtx->stats.samples    = 0;
+    rxtx->stats.file_bytes = 0;
+    memset(&rxtx->stats.ring, 0, sizeof(rxtx->stats.ring));
+    clock_gettime(CLOCK_REALTIME, &rxtx->stats.start);
+    rxtx->stats.last_status = rxtx->stats.start;
+    MUTEX_UNLOCK(&rxtx->stats_lock);
+}
+
+void rxtx_stats_add(struct rxtx_data *rxtx,
+                    uint64_t samples,
+                    uint64_t file_bytes)
+{
+    MUTEX_LOCK(&rxtx->stats_lock);
+    rxtx->stats.samples += samples;
+    rxtx->stats.file_bytes += file_bytes;
+    MUTEX_UNLOCK(&rxtx->stats_lock);
+}
+
+void rxtx_stats_set_ring(struct rxtx_data *rxtx,
+                         const struct rx_ring_stats *ring)
+{
+    MUTEX_LOCK(&rxtx->stats_lock);
+    rxtx->stats.ring = *ring;
+    MUTEX_UNLOCK(&rxtx->stats_lock);
+}
+
+void rxtx_stats_stop(struct rxtx_data *rxtx)
+{
+    MUTEX_LOCK(&rxtx->stats_lock);
+    rxtx->stats.running = false;
+    clock_gettime(CLOCK_REALTIME, &rxtx->stats.end);
+    MUTEX_UNLOCK(&rxtx->stats_lock);
+}
+
+void rxtx_stats_tick(struct cli_state *s, struct rxtx_data *rxtx)
+{
+    const bool tx = rxtx_is_tx(rxtx->direction);
+    struct bladerf_stream_stats stream;
+    struct rxtx_stats stats;
+    struct timespec now;
+    unsigned int status_ms;
+    double elapsed;
+
+    MUTEX_LOCK(&rxtx->data_mgmt.lock);
+    status_ms = rxtx->data_mgmt.status_ms;
+    MUTEX_UNLOCK(&rxtx->data_mgmt.lock);
+
+    if (status_ms == 0) {
+        return;
+    }
+
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    MUTEX_LOCK(&rxtx->stats_lock);
+    if (timespec_diff(&now, &rxtx->stats.last_status) * 1000 < status_ms) {
+        MUTEX_UNLOCK(&rxtx->stats_lock);
+        return;
+    }
+    rxtx->stats.last_status = now;
+    MUTEX_UNLOCK(&rxtx->stats_lock);
+
+    elapsed = rxtx_stats_snapshot(rxtx, &stats);
+    if (elapsed <= 0.0) {
+        return;
+    }
+
+    if (bladerf_get_sync_stats(s->dev, rxtx->direction, &stream) != 0) {
+        memset(&stream, 0, sizeof(stream));
+    }
+
+    printf("  %s: %.1f s, %.3f Msps, %.1f MB/s %s file", tx ? "TX" : "RX",
+           elapsed, stats.samples / elapsed / 1e6,
+           stats.file_bytes / elapsed / 1e6, tx ? "from" : "to");
+
+    if (tx) {
+        printf(", %" PRIu64 " underruns\n", stream.underruns);
+    } else {
+        printf(", ring %u/%u, %" PRIu64 " dropped, %" PRIu64 " overruns\n",
+               stats.ring.pending, stats.ring.num_blocks, stats.ring.dropped,
+               stream.overruns);
+    }
+}
+
+int rxtx_cmd_stats(struct cli_state *s, struct rxtx_data *rxtx)
+{
+    const bool tx = rxtx_is_tx(rxtx->direction);
+    struct bladerf_stream_stats stream;
+    struct rxtx_stats stats;
+    double elapsed;
+    int status;
+
+    elapsed = rxtx_stats_snapshot(rxtx, &stats);
+
+    printf("\n");
+    rxtx_print_state(rxtx, "  State: ", "\n");
+
+    if (elapsed <= 0.0) {
+        printf("  No %s has been run.\n\n", tx ? "transmission" : "reception");
+        return 0;
+    }
+
+    printf("  %s: %.3f s\n", stats.running ? "Running for" : "Last ran for",
+           elapsed);
+    printf("  Samples: %" PRIu64 " (%.3f Msps)\n", stats.samples,
+           stats.samples / elapsed / 1e6);
+    printf("  File: %" PRIu64 " bytes %s (%.3f MB/s)\n", stats.file_bytes,
+           tx ? "read" : "written", stats.file_bytes / elapsed / 1e6);
+
+    if (!tx && stats.ring.num_blocks != 0) {
+        printf("  Ring: %u of %u blocks pending, high-water %u, "
+               "%" PRIu64 " dropped\n",
+               stats.ring.pending, stats.ring.num_blocks,
+               stats.ring.high_water, stats.ring.dropped);
+    }
+
+    /* The stream's counters persist until it is next configured */
+    if (s->dev == NULL) {
+        status = BLADERF_ERR_NODEV;
+    } else {
+        status = bladerf_get_sync_stats(s->dev, rxtx->direction, &stream);
+    }
+
+    if (status == 0) {
+        if (tx) {
+            printf("  Underruns: %" PRIu64 "\n", stream.underruns);
+        } else {
+            printf("  Overruns: %" PRIu64 "\n", stream.overruns);
+        }
+        printf("  Timeouts: %" PRIu64 "\n", stream.timeouts);
+        printf("  Max buffer wait: %" PRIu64 " us\n",
+               stream.max_buffer_full_us);
+    } else {
+        printf("  Stream statistics unavailable: %s\n",
+               bladerf_strerror(status));
+    }
+
+    printf("\n");
+    return 0;
 }
 
 void rxtx_print_channel(struct rxtx_data *rxtx,
@@ -338,6 +532,8 @@ enum rxtx_fmt rxtx_str2fmt(const char *str)
         ret = RXTX_FMT_CSV_SC16Q11;
     } else if (!strcasecmp("bin", str)) {
         ret = RXTX_FMT_BIN_SC16Q11;
+    } else if (!strcasecmp("sigmf", str)) {
+        ret = RXTX_FMT_SIGMF_SC16Q11;
     }
 
     return ret;
@@ -369,6 +565,7 @@ struct rxtx_data *rxtx_data_alloc(bladerf_direction dir)
         } else {
             tx_params->repeat       = 1;
             tx_params->repeat_delay = 0;
+            tx_params->mmap         = true;
             ret->params             = tx_params;
         }
     } else {
@@ -379,7 +576,13 @@ struct rxtx_data *rxtx_data_alloc(bladerf_direction dir)
             free(ret);
             return NULL;
         } else {
+            memset(rx_params, 0, sizeof(*rx_params));
             rx_params->n_samples = 100000;
+            rx_params->ring_size = RX_RING_DEFAULT_SIZE;
+            rx_params->trigger_dbfs    = -30.0;
+            rx_params->trigger_pre_ms  = RX_TRIGGER_DEFAULT_PRE_MS;
+            rx_params->trigger_post_ms = RX_TRIGGER_DEFAULT_POST_MS;
+            rx_params->decim           = 1;
             ret->params          = rx_params;
         }
     }
@@ -396,12 +599,18 @@ struct rxtx_data *rxtx_data_alloc(bladerf_direction dir)
     ret->data_mgmt.samples_per_buffer = 32 * 1024;
     ret->data_mgmt.num_transfers      = 16;
     ret->data_mgmt.timeout_ms         = 1000;
+    ret->data_mgmt.status_ms          = 0;
+    ret->data_mgmt.start_scheduled    = false;
+    ret->data_mgmt.start_relative     = false;
+    ret->data_mgmt.start_ts           = 0;
     ret->data_mgmt.layout = rxtx_is_tx(dir) ? BLADERF_TX_X1 : BLADERF_RX_X1;
 
     MUTEX_INIT(&ret->data_mgmt.lock);
 
     /* Initialize file management items */
     ret->file_mgmt.file   = NULL;
+    ret->file_mgmt.file2  = NULL;
+    ret->file_mgmt.net    = NULL;
     ret->file_mgmt.path   = NULL;
     ret->file_mgmt.format = RXTX_FMT_BIN_SC16Q11;
     MUTEX_INIT(&ret->file_mgmt.file_lock);
@@ -420,6 +629,9 @@ struct rxtx_data *rxtx_data_alloc(bladerf_direction dir)
     /* Initialize error management */
     cli_error_init(&ret->last_error);
 
+    memset(&ret->stats, 0, sizeof(ret->stats));
+    MUTEX_INIT(&ret->stats_lock);
+
     ret->direction = dir;
 
     return ret;
@@ -484,6 +696,10 @@ void rxtx_shutdown(struct cli_state *s, struct rxtx_data *rxtx)
 void rxtx_data_free(struct rxtx_data *rxtx)
 {
     if (rxtx) {
+        if (!rxtx_is_tx(rxtx->direction)) {
+            free(((struct rx_params *)rxtx->params)->csv_text);
+        }
+
         free(rxtx->params);
         free(rxtx);
     }
@@ -578,6 +794,50 @@ int rxtx_handle_config_param(struct cli_state *s,
                 MUTEX_UNLOCK(&rxtx->data_mgmt.lock);
                 status = 1;
             }
+        } else if (!strcasecmp("status", param)) {
+            /* Interval of the periodic status line, or off */
+            if (!strcasecmp("off", *val)) {
+                tmp = 0;
+                ok  = true;
+            } else {
+                tmp = str2uint_suffix(*val, 1, UINT_MAX, rxtx_time_suffixes,
+                                      rxtx_time_suffixes_len, &ok);
+            }
+
+            if (!ok) {
+                cli_err(s, argv0, RXTX_ERRMSG_VALUE(param, *val));
+                status = CLI_RET_INVPARAM;
+            } else {
+                MUTEX_LOCK(&rxtx->data_mgmt.lock);
+                rxtx->data_mgmt.status_ms = tmp;
+                MUTEX_UNLOCK(&rxtx->data_mgmt.lock);
+                status = 1;
+            }
+        } else if (!strcasecmp("start_ts", param)) {
+            /* Start at a timestamp, after a number of samples prefixed with
+             * '+', or now */
+            const bool relative = ((*val)[0] == '+');
+            const bool now      = !strcasecmp("now", *val);
+            uint64_t ts         = 0;
+
+            ok = true;
+            if (!now) {
+                ts = str2uint64_suffix(relative ? &(*val)[1] : *val, 0,
+                                       UINT64_MAX, rxtx_kmg_suffixes,
+                                       rxtx_kmg_suffixes_len, &ok);
+            }
+
+            if (!ok) {
+                cli_err(s, argv0, RXTX_ERRMSG_VALUE(param, *val));
+                status = CLI_RET_INVPARAM;
+            } else {
+                MUTEX_LOCK(&rxtx->data_mgmt.lock);
+                rxtx->data_mgmt.start_scheduled = !now;
+                rxtx->data_mgmt.start_relative  = relative;
+                rxtx->data_mgmt.start_ts        = ts;
+                MUTEX_UNLOCK(&rxtx->data_mgmt.lock);
+                status = 1;
+            }
         } else if (!strcasecmp("timeout", param)) {
             tmp = str2uint_suffix(*val, 1, UINT_MAX, rxtx_time_suffixes,
                                   rxtx_time_suffixes_len, &ok);
@@ -733,6 +993,93 @@ int rxtx_cmd_stop(struct cli_state *s, struct rxtx_data *rxtx)
     return status;
 }
 
+int rxtx_wait_for_timestamp(struct cli_state *s,
+                            struct rxtx_data *rxtx,
+                            bladerf_sample_rate rate,
+                            uint64_t timestamp)
+{
+    struct timespec deadline;
+    uint64_t now, ns;
+    bool stop;
+    int status;
+
+    status = bladerf_get_timestamp(s->dev, rxtx->direction, &now);
+
+    while (status == 0 && now < timestamp) {
+        /* Sleep for at most a second between reads of the timestamp, which
+         * may tick more slowly than the sample rate (e.g., when decimating
+         * in the FPGA) */
+        ns = timestamp - now;
+        ns = (ns < rate) ? ns * NSEC_PER_SEC / rate : NSEC_PER_SEC;
+
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += (long)ns;
+        if (deadline.tv_nsec >= NSEC_PER_SEC) {
+            deadline.tv_sec += deadline.tv_nsec / NSEC_PER_SEC;
+            deadline.tv_nsec %= NSEC_PER_SEC;
+        }
+
+        /* A stop request signals the task, ending the wait */
+        MUTEX_LOCK(&rxtx->task_mgmt.lock);
+        stop = (rxtx->task_mgmt.req &
+                (RXTX_TASK_REQ_STOP | RXTX_TASK_REQ_SHUTDOWN)) != 0;
+        if (!stop) {
+            pthread_cond_timedwait(&rxtx->task_mgmt.signal_req,
+                                   &rxtx->task_mgmt.lock, &deadline);
+            stop = (rxtx->task_mgmt.req &
+                    (RXTX_TASK_REQ_STOP | RXTX_TASK_REQ_SHUTDOWN)) != 0;
+        }
+        MUTEX_UNLOCK(&rxtx->task_mgmt.lock);
+
+        if (stop) {
+            break;
+        }
+
+        status = bladerf_get_timestamp(s->dev, rxtx->direction, &now);
+    }
+
+    return status;
+}
+
+int rxtx_wait_for_start(struct cli_state *s,
+                        struct rxtx_data *rxtx,
+                        bladerf_sample_rate rate,
+                        bool *scheduled,
+                        uint64_t *start_ts)
+{
+    uint64_t now, margin;
+    unsigned int timeout_ms;
+    bool relative;
+    int status;
+
+    MUTEX_LOCK(&rxtx->data_mgmt.lock);
+    *scheduled = rxtx->data_mgmt.start_scheduled;
+    relative   = rxtx->data_mgmt.start_relative;
+    *start_ts  = rxtx->data_mgmt.start_ts;
+    timeout_ms = rxtx->data_mgmt.timeout_ms;
+    MUTEX_UNLOCK(&rxtx->data_mgmt.lock);
+
+    if (!*scheduled) {
+        return 0;
+    }
+
+    if (relative) {
+        status = bladerf_get_timestamp(s->dev, rxtx->direction, &now);
+        if (status != 0) {
+            return status;
+        }
+
+        *start_ts += now;
+    }
+
+    margin = (uint64_t)rate * timeout_ms / 2000;
+    if (*start_ts <= margin) {
+        return 0;
+    }
+
+    return rxtx_wait_for_timestamp(s, rxtx, rate, *start_ts - margin);
+}
+
 void rxtx_task_exec_idle(struct rxtx_data *rxtx, unsigned char *requests)
 {
     /* Wait until we're asked to start or shutdown */
@@ -767,6 +1114,14 @@ void rxtx_task_exec_stop(struct cli_state *s,
         fclose(rxtx->file_mgmt.file);
         rxtx->file_mgmt.file = NULL;
     }
+
+    if (rxtx->file_mgmt.file2 != NULL) {
+        fclose(rxtx->file_mgmt.file2);
+        rxtx->file_mgmt.file2 = NULL;
+    }
+
+    net_stream_close(rxtx->file_mgmt.net);
+    rxtx->file_mgmt.net = NULL;
     MUTEX_UNLOCK(&rxtx->file_mgmt.file_lock);
 
     if (*requests & RXTX_TASK_REQ_SHUTDOWN) {
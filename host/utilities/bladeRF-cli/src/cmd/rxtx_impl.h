@@ -29,8 +29,19 @@
 
 #include <libbladeRF.h>
 
+#include "host_config.h"
+
+#if BLADERF_OS_WINDOWS || BLADERF_OS_OSX
+#include "clock_gettime.h"
+#else
+#include <time.h>
+#endif
+
 #include "cmd.h"
 #include "conversions.h"
+#include "net_stream.h"
+#include "rx_ring.h"
+#include "rx_trigger.h"
 #include "thread.h"
 
 #define RXTX_ERRMSG_VALUE(param, value) \
@@ -49,6 +60,7 @@
 #define RXTX_CMD_STOP "stop"
 #define RXTX_CMD_CONFIG "config"
 #define RXTX_CMD_WAIT "wait"
+#define RXTX_CMD_STATS "stats"
 
 #define RXTX_MAX_CHANNELS 2 /* how many channels to support per direction */
 
@@ -56,8 +68,9 @@
 
 enum rxtx_fmt {
     RXTX_FMT_INVALID = -1,
-    RXTX_FMT_CSV_SC16Q11, /* CSV (Comma-separated, one entry per line) */
-    RXTX_FMT_BIN_SC16Q11  /* Binary (big-endian), c16 I,Q */
+    RXTX_FMT_CSV_SC16Q11,  /* CSV (Comma-separated, one entry per line) */
+    RXTX_FMT_BIN_SC16Q11,  /* Binary (big-endian), c16 I,Q */
+    RXTX_FMT_SIGMF_SC16Q11 /* SigMF ci16_le data, with a .sigmf-meta file */
 };
 
 enum rxtx_state {
@@ -82,13 +95,20 @@ struct data_mgmt {
     unsigned int samples_per_buffer; /* Size of each buffer (in samples) */
     unsigned int num_transfers;      /* # of transfers to use in the stream */
     unsigned int timeout_ms;         /* Stream timeout, in ms */
+    unsigned int status_ms;          /* Status line interval, or 0 for none */
     bladerf_channel_layout layout;   /* Channel layout (SISO vs MIMO, etc) */
+    bool start_scheduled;            /* Start at 'start_ts', with timestamps */
+    bool start_relative;             /* 'start_ts' is an offset from the
+                                      *    timestamp when the task starts */
+    uint64_t start_ts;               /* Start timestamp, in samples */
 };
 
 /* Input/Ouput file and related metadata.
  * If acuiring both the locks, acquire file_meta_lock first, then file_lock */
 struct file_mgmt {
     FILE *file;      /* File to read/write samples from/to */
+    FILE *file2;     /* RX2 samples, when RX writes planar files */
+    struct net_stream *net; /* RX network endpoint, used instead of 'file' */
     MUTEX file_lock; /* Thread using 'file' must hold this lock */
 
 
@@ -114,6 +134,17 @@ struct task_mgmt {
     bool main_task_waiting;             /* Main task is blocked waiting */
 };
 
+/* Live counters, shown by the "stats" command and periodic status line */
+struct rxtx_stats {
+    bool running;                /* Task is running */
+    struct timespec start;       /* Time the task started running */
+    struct timespec end;         /* Time it stopped, if not running */
+    struct timespec last_status; /* Time the status line was last printed */
+    uint64_t samples;            /* Samples received or transmitted */
+    uint64_t file_bytes;         /* Bytes written to or read from the file */
+    struct rx_ring_stats ring;   /* RX writer ring, as of the last block */
+};
+
 /* RX or TX-specific parameters */
 struct params;
 
@@ -125,6 +156,9 @@ struct rxtx_data {
     struct task_mgmt task_mgmt;
     struct cli_error last_error;
 
+    MUTEX stats_lock; /* Must be held to access 'stats' */
+    struct rxtx_stats stats;
+
     /* Must be held to access the following items */
     MUTEX param_lock;
     void *params;
@@ -134,11 +168,29 @@ struct rxtx_data {
 struct tx_params {
     unsigned int repeat_delay; /* us delay between repetitions */
     unsigned int repeat;       /* # of repetitions */
+    bool mmap;                 /* Play back from a mapping of the file */
 };
 
 struct rx_params {
     size_t n_samples; /* Number of samples to receive */
     int (*write_samples)(struct rxtx_data *rx, int16_t *samples, size_t n);
+
+    size_t ring_size;                /* Sample ring size, in bytes */
+    struct rx_ring_stats ring_stats; /* Ring statistics from last capture */
+
+    bool planar; /* Write each channel of a MIMO capture to its own file */
+
+    bool trigger;                 /* Only write samples around events */
+    double trigger_dbfs;          /* Power at which an event is triggered */
+    unsigned int trigger_pre_ms;  /* Duration written before an event */
+    unsigned int trigger_post_ms; /* Duration written after an event */
+    uint64_t trigger_events;      /* Events in the last capture */
+
+    unsigned int decim; /* Decimation factor, or 1 for none */
+    double decim_fc;    /* Channel filter cutoff in Hz, or 0 for default */
+
+    char *csv_text;      /* CSV formatting buffer, reused across writes */
+    size_t csv_text_len; /* Size of csv_text, in bytes */
 };
 
 /* Multipliers in units of 1024 */
@@ -300,6 +352,45 @@ void rxtx_submit_request(struct rxtx_data *rxtx, unsigned char req);
  */
 unsigned char rxtx_get_requests(struct rxtx_data *rxtx, unsigned char mask);
 
+/**
+ * Sleep until the device's timestamp for the task's direction reaches
+ * `timestamp'. The wait ends early if a stop or shutdown is requested; the
+ * request is left pending for the caller.
+ *
+ * @param[in]   s           CLI state
+ * @param[in]   rxtx        RX/TX data handle
+ * @param[in]   rate        Sample rate of the task's channels
+ * @param[in]   timestamp   Timestamp to wait for
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int rxtx_wait_for_timestamp(struct cli_state *s,
+                            struct rxtx_data *rxtx,
+                            bladerf_sample_rate rate,
+                            uint64_t timestamp);
+
+/**
+ * Wait for a scheduled start, if one is configured
+ *
+ * A relative start time is resolved against the device's current timestamp.
+ * The task then sleeps until the start is half a stream timeout away, so
+ * that the first sync call can request the start timestamp without timing
+ * out. As with rxtx_wait_for_timestamp(), a stop request ends the wait.
+ *
+ * @param[in]   s           CLI state
+ * @param[in]   rxtx        RX/TX data handle
+ * @param[in]   rate        Sample rate of the task's channels
+ * @param[out]  scheduled   Set to true if a start is scheduled
+ * @param[out]  start_ts    Set to the start timestamp, if scheduled
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int rxtx_wait_for_start(struct cli_state *s,
+                        struct rxtx_data *rxtx,
+                        bladerf_sample_rate rate,
+                        bool *scheduled,
+                        uint64_t *start_ts);
+
 /**
  * Handle rx/tx config parameters
  *
@@ -372,6 +463,62 @@ int rxtx_cmd_start_check(struct cli_state *s,
  */
 int rxtx_cmd_stop(struct cli_state *s, struct rxtx_data *rxtx);
 
+/**
+ * RX/TX stats command, common items
+ *
+ * Prints the achieved sample rate and file throughput of the running (or
+ * last) task, along with the stream's overrun and underrun counts.
+ *
+ * @param   s       CLI state
+ * @param   rxtx    RX/TX data handle
+ *
+ * @return 0 on success, CLI_RET_* for any errors
+ */
+int rxtx_cmd_stats(struct cli_state *s, struct rxtx_data *rxtx);
+
+/**
+ * Reset the live counters as a task starts running
+ *
+ * @param   rxtx    RX/TX data handle
+ */
+void rxtx_stats_start(struct rxtx_data *rxtx);
+
+/**
+ * Add to the live counters
+ *
+ * @param   rxtx        RX/TX data handle
+ * @param   samples     Samples received or transmitted
+ * @param   file_bytes  Bytes written to or read from the file
+ */
+void rxtx_stats_add(struct rxtx_data *rxtx,
+                    uint64_t samples,
+                    uint64_t file_bytes);
+
+/**
+ * Record a snapshot of the RX writer ring's statistics
+ *
+ * @param   rxtx    RX/TX data handle
+ * @param   ring    Ring statistics
+ */
+void rxtx_stats_set_ring(struct rxtx_data *rxtx,
+                         const struct rx_ring_stats *ring);
+
+/**
+ * Print a status line if the configured interval has elapsed since the
+ * last one. This is called by the task after each buffer.
+ *
+ * @param   s       CLI state
+ * @param   rxtx    RX/TX data handle
+ */
+void rxtx_stats_tick(struct cli_state *s, struct rxtx_data *rxtx);
+
+/**
+ * Stop the live counters' clock as a task stops running
+ *
+ * @param   rxtx    RX/TX data handle
+ */
+void rxtx_stats_stop(struct rxtx_data *rxtx);
+
 /**
  * Handle the rx/tx task's IDLE state
  *
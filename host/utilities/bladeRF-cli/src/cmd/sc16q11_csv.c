@@ -0,0 +1,292 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_config.h"
+
+#include "cmd.h"
+#include "sc16q11_csv.h"
+
+/* Size of each block read from a CSV file */
+#define CSV_READ_SIZE (256 * 1024)
+
+/* Values buffered before each write to the binary file */
+#define BIN_WRITE_VALUES (64 * 1024)
+
+/* Magnitude beyond which digits stop accumulating. Anything this large is
+ * clamped anyway, and this keeps the accumulator from overflowing. */
+#define VALUE_SATURATE 1000000
+
+static inline char *format_int(char *out, int value)
+{
+    char digits[8];
+    unsigned int v;
+    int n = 0;
+
+    if (value < 0) {
+        *out++ = '-';
+        v      = (unsigned int)(-(long)value);
+    } else {
+        v = (unsigned int)value;
+    }
+
+    do {
+        digits[n++] = (char)('0' + (v % 10));
+        v /= 10;
+    } while (v != 0);
+
+    while (n > 0) {
+        *out++ = digits[--n];
+    }
+
+    return out;
+}
+
+size_t sc16q11_csv_format(char *out,
+                          const int16_t *samples,
+                          size_t n_samples,
+                          unsigned int nchans)
+{
+    char *p = out;
+    size_t i;
+    unsigned int c;
+
+    for (i = 0; i + nchans <= n_samples; i += nchans) {
+        for (c = 0; c < nchans; c++) {
+            if (c != 0) {
+                *p++ = ',';
+                *p++ = ' ';
+            }
+
+            p    = format_int(p, samples[0]);
+            *p++ = ',';
+            *p++ = ' ';
+            p    = format_int(p, samples[1]);
+
+            samples += 2;
+        }
+
+        /* CSV files are written in text mode, which supplies the '\r' on
+         * Windows */
+        *p++ = '\n';
+    }
+
+    return (size_t)(p - out);
+}
+
+static inline bool is_delim(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == ',' || c == '.' ||
+           c == ':';
+}
+
+static inline int hex_digit(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+struct csv_state {
+    FILE *bin;
+    int min, max;
+    int16_t *values;
+    size_t n_values;
+    struct sc16q11_csv_result *result;
+};
+
+static int flush_values(struct csv_state *st)
+{
+    size_t n = st->n_values;
+
+    st->n_values = 0;
+
+    if (n != 0 && fwrite(st->values, sizeof(st->values[0]), n, st->bin) != n) {
+        return CLI_RET_FILEOP;
+    }
+
+    return 0;
+}
+
+/* Parse one line, excluding its '\n' */
+static int parse_line(struct csv_state *st, const char *p, const char *end)
+{
+    unsigned int cols = 0;
+    int status;
+
+    while (p < end) {
+        bool neg = false;
+        long value = 0;
+        int base = 10, d;
+        const char *digits;
+
+        if (is_delim(*p)) {
+            p++;
+            continue;
+        }
+
+        if (*p == '-' || *p == '+') {
+            neg = (*p == '-');
+            p++;
+        }
+
+        if (end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+            base = 16;
+            p += 2;
+        }
+
+        for (digits = p; p < end; p++) {
+            d = (base == 16) ? hex_digit(*p) : (*p - '0');
+            if (d < 0 || d >= base) {
+                break;
+            }
+
+            if (value < VALUE_SATURATE) {
+                value = value * base + d;
+            }
+        }
+
+        /* A value must have digits and end at a delimiter */
+        if (p == digits || (p < end && !is_delim(*p))) {
+            return CLI_RET_INVPARAM;
+        }
+
+        if (neg) {
+            value = -value;
+        }
+
+        if (value < st->min) {
+            value = st->min;
+            st->result->n_clamped++;
+        } else if (value > st->max) {
+            value = st->max;
+            st->result->n_clamped++;
+        }
+
+        if (st->n_values == BIN_WRITE_VALUES) {
+            status = flush_values(st);
+            if (status != 0) {
+                return status;
+            }
+        }
+
+        st->values[st->n_values++] = (int16_t)value;
+        cols++;
+    }
+
+    if (cols % 2 != 0) {
+        st->result->odd_cols = true;
+        st->result->cols     = cols;
+        return CLI_RET_INVPARAM;
+    }
+
+    return 0;
+}
+
+int sc16q11_csv_to_bin(FILE *csv, FILE *bin, int min, int max,
+                       struct sc16q11_csv_result *result)
+{
+    struct csv_state st;
+    char *buf, *tmp;
+    size_t buf_size = CSV_READ_SIZE;
+    size_t len      = 0; /* Bytes in buf, of which a partial line may remain */
+    size_t n, start, i;
+    bool eof   = false;
+    int status = 0;
+
+    memset(result, 0, sizeof(*result));
+    result->line = 1;
+
+    st.bin      = bin;
+    st.min      = min;
+    st.max      = max;
+    st.n_values = 0;
+    st.result   = result;
+    st.values   = malloc(BIN_WRITE_VALUES * sizeof(st.values[0]));
+
+    buf = malloc(buf_size);
+
+    if (buf == NULL || st.values == NULL) {
+        status = CLI_RET_MEM;
+        goto out;
+    }
+
+    while (!eof && status == 0) {
+        /* Grow the buffer if a single line fills it */
+        if (len == buf_size) {
+            tmp = realloc(buf, 2 * buf_size);
+            if (tmp == NULL) {
+                status = CLI_RET_MEM;
+                break;
+            }
+
+            buf = tmp;
+            buf_size *= 2;
+        }
+
+        n = fread(buf + len, 1, buf_size - len, csv);
+        if (n < buf_size - len) {
+            if (ferror(csv)) {
+                status = CLI_RET_FILEOP;
+                break;
+            }
+
+            eof = true;
+        }
+
+        len += n;
+
+        /* Parse each complete line, and the last one at the end of file */
+        for (start = 0, i = 0; i < len && status == 0; i++) {
+            if (buf[i] == '\n') {
+                status = parse_line(&st, buf + start, buf + i);
+                if (status == 0) {
+                    result->line++;
+                    start = i + 1;
+                }
+            }
+        }
+
+        if (status == 0 && eof && start < len) {
+            status = parse_line(&st, buf + start, buf + len);
+            start  = len;
+        }
+
+        /* Carry any partial line over to the next block */
+        memmove(buf, buf + start, len - start);
+        len -= start;
+    }
+
+    if (status == 0) {
+        status = flush_values(&st);
+    }
+
+out:
+    free(buf);
+    free(st.values);
+    return status;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file sc16q11_csv.h
+ *
+ * @brief Bulk conversion of SC16 Q11 samples to and from CSV
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef SC16Q11_CSV_H__
+#define SC16Q11_CSV_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* Most characters a single I,Q pair occupies in formatted output, including
+ * the following separator or line ending: "-32768, -32768, " */
+#define SC16Q11_CSV_MAX_SAMPLE_CHARS 16
+
+/**
+ * Format samples as CSV, with one line per sample time and an I,Q column
+ * pair per channel
+ *
+ * @param[out]  out         Output buffer. Must have room for at least
+ *                          n_samples * SC16Q11_CSV_MAX_SAMPLE_CHARS chars.
+ * @param[in]   samples     Interleaved samples
+ * @param[in]   n_samples   Number of samples (I,Q pairs), a multiple of
+ *                          nchans
+ * @param[in]   nchans      Number of channels
+ *
+ * @return number of characters written. The output is not NUL-terminated.
+ */
+size_t sc16q11_csv_format(char *out,
+                          const int16_t *samples,
+                          size_t n_samples,
+                          unsigned int nchans);
+
+/* Result of sc16q11_csv_to_bin() */
+struct sc16q11_csv_result {
+    unsigned int line;  /* Line on which an error occurred */
+    unsigned int cols;  /* Column count of that line, for odd_cols */
+    bool odd_cols;      /* Error was an odd number of columns */
+    size_t n_clamped;   /* Values clamped to [min, max] */
+};
+
+/**
+ * Convert a CSV file of I,Q values to binary SC16 Q11 samples
+ *
+ * Values may be separated by any of " \t\r,.:", and are clamped to the
+ * range [min, max]. Empty lines are ignored. The input is read and parsed
+ * in large blocks, rather than line-by-line.
+ *
+ * @param[in]   csv         Input file
+ * @param[in]   bin         Output file
+ * @param[in]   min         Minimum value
+ * @param[in]   max         Maximum value
+ * @param[out]  result      Error location and clamp count
+ *
+ * @return 0 on success, CLI_RET_INVPARAM on a parse error, or another
+ *         CLI_RET_* value on failure
+ */
+int sc16q11_csv_to_bin(FILE *csv, FILE *bin, int min, int max,
+                       struct sc16q11_csv_result *result);
+
+#endif
@@ -0,0 +1,237 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_config.h"
+
+#if BLADERF_OS_WINDOWS || BLADERF_OS_OSX
+#include "clock_gettime.h"
+#endif
+
+#include "cmd.h"
+#include "sigmf.h"
+
+void sigmf_meta_init(struct sigmf_meta *m)
+{
+    memset(m, 0, sizeof(*m));
+    m->num_channels = 1;
+    m->decimation   = 1;
+}
+
+/* Index in the data file of the sample received at `index'. Decimation
+ * keeps every sample whose index is a multiple of the factor. */
+static uint64_t file_index(const struct sigmf_meta *m, uint64_t index)
+{
+    return (index + m->decimation - 1) / m->decimation;
+}
+
+int sigmf_meta_block(struct sigmf_meta *m, uint64_t timestamp, size_t n)
+{
+    struct sigmf_segment *seg;
+
+    if (m->num_segments == 0 || timestamp != m->next_ts) {
+        if (m->num_segments == m->max_segments) {
+            size_t max = (m->max_segments == 0) ? 16 : 2 * m->max_segments;
+
+            seg = realloc(m->segments, max * sizeof(m->segments[0]));
+            if (seg == NULL) {
+                return CLI_RET_MEM;
+            }
+
+            m->segments     = seg;
+            m->max_segments = max;
+        }
+
+        if (m->num_segments == 0) {
+            clock_gettime(CLOCK_REALTIME, &m->start);
+        }
+
+        seg               = &m->segments[m->num_segments];
+        seg->sample_start = m->num_samples;
+        seg->global_index = timestamp;
+        seg->lost         = (m->num_segments == 0) ? 0 : timestamp - m->next_ts;
+
+        m->num_segments++;
+    }
+
+    m->num_samples += n;
+    m->next_ts = timestamp + n;
+
+    return 0;
+}
+
+/* Print the host time at which the device timestamp `ts' was sampled */
+static void print_datetime(FILE *f, const struct sigmf_meta *m, uint64_t ts)
+{
+    uint64_t offset_ns = 0;
+    uint64_t ns;
+    time_t secs;
+    struct tm *tm;
+    char buf[32];
+
+    if (m->sample_rate != 0) {
+        uint64_t delta = ts - m->segments[0].global_index;
+        offset_ns = (delta / m->sample_rate) * 1000000000 +
+                    (delta % m->sample_rate) * 1000000000 / m->sample_rate;
+    }
+
+    ns   = (uint64_t)m->start.tv_nsec + offset_ns;
+    secs = m->start.tv_sec + (time_t)(ns / 1000000000);
+    ns  %= 1000000000;
+
+    tm = gmtime(&secs);
+    if (tm == NULL || strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S",
+                               tm) == 0) {
+        buf[0] = '\0';
+    }
+
+    fprintf(f, "\"%s.%06uZ\"", buf, (unsigned int)(ns / 1000));
+}
+
+static void print_string(FILE *f, const char *str)
+{
+    fputc('"', f);
+
+    for (; *str != '\0'; str++) {
+        if (*str == '"' || *str == '\\') {
+            fputc('\\', f);
+            fputc(*str, f);
+        } else if ((unsigned char)*str >= 0x20) {
+            fputc(*str, f);
+        }
+    }
+
+    fputc('"', f);
+}
+
+static char *meta_path(const char *data_path)
+{
+    const size_t ext_len = strlen(SIGMF_DATA_EXT);
+    size_t len           = strlen(data_path);
+    char *ret;
+
+    if (len > ext_len && !strcmp(data_path + len - ext_len, SIGMF_DATA_EXT)) {
+        len -= ext_len;
+    }
+
+    ret = malloc(len + strlen(SIGMF_META_EXT) + 1);
+    if (ret != NULL) {
+        memcpy(ret, data_path, len);
+        strcpy(ret + len, SIGMF_META_EXT);
+    }
+
+    return ret;
+}
+
+int sigmf_meta_write(const struct sigmf_meta *m, const char *data_path)
+{
+    FILE *f;
+    char *path;
+    size_t i;
+    int status = 0;
+
+    path = meta_path(data_path);
+    if (path == NULL) {
+        return CLI_RET_MEM;
+    }
+
+    f = fopen(path, "w");
+    free(path);
+
+    if (f == NULL) {
+        return (errno == EACCES) ? CLI_RET_PERMISSION : CLI_RET_FILEOP;
+    }
+
+    fprintf(f, "{\n");
+    fprintf(f, "    \"global\": {\n");
+    fprintf(f, "        \"core:datatype\": \"ci16_le\",\n");
+    fprintf(f, "        \"core:version\": \"1.0.0\",\n");
+    if (m->sample_rate % m->decimation == 0) {
+        fprintf(f, "        \"core:sample_rate\": %" PRIu64 ",\n",
+                m->sample_rate / m->decimation);
+    } else {
+        fprintf(f, "        \"core:sample_rate\": %.6f,\n",
+                (double)m->sample_rate / m->decimation);
+    }
+    fprintf(f, "        \"core:num_channels\": %u,\n", m->num_channels);
+    fprintf(f, "        \"core:hw\": ");
+    print_string(f, m->hw);
+    fprintf(f, ",\n");
+    fprintf(f, "        \"core:recorder\": \"bladeRF-cli\",\n");
+    fprintf(f, "        \"core:description\": \"SC16 Q11 samples, full "
+               "scale is +/-2048\"\n");
+    fprintf(f, "    },\n");
+
+    /* Each discontinuity in the device timestamps starts a new capture
+     * segment, as its first sample no longer follows on from the last */
+    fprintf(f, "    \"captures\": [");
+    for (i = 0; i < m->num_segments; i++) {
+        const struct sigmf_segment *seg = &m->segments[i];
+
+        fprintf(f, "%s\n        {\n", (i == 0) ? "" : ",");
+        fprintf(f, "            \"core:sample_start\": %" PRIu64 ",\n",
+                file_index(m, seg->sample_start));
+        fprintf(f, "            \"core:global_index\": %" PRIu64 ",\n",
+                file_index(m, seg->global_index));
+        fprintf(f, "            \"core:frequency\": %" PRIu64 ",\n",
+                m->frequency);
+        fprintf(f, "            \"core:datetime\": ");
+        print_datetime(f, m, seg->global_index);
+        fprintf(f, "\n        }");
+    }
+    fprintf(f, "%s],\n", (m->num_segments == 0) ? "" : "\n    ");
+
+    fprintf(f, "    \"annotations\": [");
+    for (i = 1; i < m->num_segments; i++) {
+        const struct sigmf_segment *seg = &m->segments[i];
+
+        fprintf(f, "%s\n        {\n", (i == 1) ? "" : ",");
+        fprintf(f, "            \"core:sample_start\": %" PRIu64 ",\n",
+                file_index(m, seg->sample_start));
+        fprintf(f, "            \"core:comment\": \"Discontinuity: "
+                   "%" PRIu64 " samples lost\"\n",
+                seg->lost / m->decimation);
+        fprintf(f, "        }");
+    }
+    fprintf(f, "%s]\n", (m->num_segments <= 1) ? "" : "\n    ");
+    fprintf(f, "}\n");
+
+    if (ferror(f)) {
+        status = CLI_RET_FILEOP;
+    }
+
+    if (fclose(f) != 0 && status == 0) {
+        status = CLI_RET_FILEOP;
+    }
+
+    return status;
+}
+
+void sigmf_meta_deinit(struct sigmf_meta *m)
+{
+    free(m->segments);
+    m->segments     = NULL;
+    m->num_segments = 0;
+    m->max_segments = 0;
+}
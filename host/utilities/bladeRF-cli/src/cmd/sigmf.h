@@ -0,0 +1,103 @@
+/**
+ * @file sigmf.h
+ *
+ * @brief SigMF metadata for RX captures
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef SIGMF_H__
+#define SIGMF_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#define SIGMF_DATA_EXT ".sigmf-data"
+#define SIGMF_META_EXT ".sigmf-meta"
+
+/* A contiguous run of samples in the data file */
+struct sigmf_segment {
+    uint64_t sample_start; /* Index of the first sample in the file */
+    uint64_t global_index; /* Device timestamp of the first sample */
+    uint64_t lost;         /* Samples lost before this segment */
+};
+
+struct sigmf_meta {
+    /* Filled in by the caller before the capture starts */
+    uint64_t sample_rate;
+    uint64_t frequency;
+    unsigned int num_channels;
+    unsigned int decimation; /* Samples are decimated before being written */
+    char hw[128]; /* Description of the device */
+
+    /* Updated by sigmf_meta_block(), at the device's sample rate */
+    struct timespec start; /* Host time of the first block */
+    uint64_t num_samples;  /* Samples, per channel, received so far */
+    uint64_t next_ts;      /* Expected timestamp of the next block */
+
+    struct sigmf_segment *segments;
+    size_t num_segments;
+    size_t max_segments;
+};
+
+/**
+ * Initialize a metadata structure. The caller then fills in the capture
+ * parameters.
+ *
+ * @param   m       Metadata
+ */
+void sigmf_meta_init(struct sigmf_meta *m);
+
+/**
+ * Account for a block of samples written to the data file. A new segment is
+ * started whenever the block's timestamp does not follow on from the last.
+ *
+ * Blocks are counted before any decimation, which sigmf_meta_write() then
+ * accounts for.
+ *
+ * This is called once per block, so it costs nothing per sample.
+ *
+ * @param   m           Metadata
+ * @param   timestamp   Device timestamp of the block's first sample
+ * @param   n           Samples in the block, per channel
+ *
+ * @return 0 on success, CLI_RET_MEM on allocation failure
+ */
+int sigmf_meta_block(struct sigmf_meta *m, uint64_t timestamp, size_t n);
+
+/**
+ * Write the .sigmf-meta sidecar for a data file. If `data_path' ends in
+ * .sigmf-data, that suffix is replaced. Otherwise, .sigmf-meta is appended.
+ *
+ * @param   m           Metadata
+ * @param   data_path   Path of the data file
+ *
+ * @return 0 on success, CLI_RET_* on failure
+ */
+int sigmf_meta_write(const struct sigmf_meta *m, const char *data_path);
+
+/**
+ * Free resources associated with the metadata
+ *
+ * @param   m       Metadata
+ */
+void sigmf_meta_deinit(struct sigmf_meta *m);
+
+#endif
@@ -0,0 +1,311 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cmd.h"
+
+/* Distinct (kind, opcode, target) combinations tracked by `trace show` */
+#define MAX_GROUPS 64
+
+/* Latency histogram bins. Bin n counts durations below
+ * (HIST_BASE_US << n) us, with the final bin counting everything else. */
+#define HIST_BINS 10
+#define HIST_BASE_US 32
+
+struct trace_group {
+    bladerf_ctrl_trace_kind kind;
+    uint8_t opcode;
+    uint8_t target;
+    uint64_t count;
+    uint64_t errors;
+    uint64_t total_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t hist[HIST_BINS];
+};
+
+static const char *nios_format(uint8_t magic)
+{
+    switch (magic) {
+        case 'A':
+            return "8x8";
+        case 'B':
+            return "8x16";
+        case 'C':
+            return "8x32";
+        case 'D':
+            return "8x64";
+        case 'E':
+            return "16x64";
+        case 'F':
+            return "8x8 batch";
+        case 'G':
+            return "8x8 block";
+        case 'K':
+            return "32x32";
+        case 'N':
+            return "legacy";
+        case 'T':
+            return "retune";
+        case 'U':
+            return "retune2";
+        default:
+            return "unknown";
+    }
+}
+
+static void group_name(const struct trace_group *g, char *buf, size_t len)
+{
+    if (g->kind == BLADERF_CTRL_TRACE_NIOS) {
+        snprintf(buf, len, "NIOS '%c' %-9s 0x%02x", g->opcode,
+                 nios_format(g->opcode), g->target);
+    } else {
+        snprintf(buf, len, "Vendor 0x%02x", g->opcode);
+    }
+}
+
+static void group_add(struct trace_group *g,
+                      const struct bladerf_ctrl_trace_entry *e)
+{
+    uint64_t limit_us = HIST_BASE_US;
+    unsigned int bin;
+
+    if (g->count == 0 || e->duration < g->min_ns) {
+        g->min_ns = e->duration;
+    }
+
+    if (e->duration > g->max_ns) {
+        g->max_ns = e->duration;
+    }
+
+    for (bin = 0; bin < (HIST_BINS - 1); bin++, limit_us <<= 1) {
+        if (e->duration < limit_us * 1000) {
+            break;
+        }
+    }
+
+    g->hist[bin]++;
+    g->count++;
+    g->total_ns += e->duration;
+
+    if (e->status != 0) {
+        g->errors++;
+    }
+}
+
+static struct trace_group *group_find(struct trace_group *groups,
+                                      unsigned int *num_groups,
+                                      const struct bladerf_ctrl_trace_entry *e)
+{
+    unsigned int i;
+
+    for (i = 0; i < *num_groups; i++) {
+        if (groups[i].kind == e->kind && groups[i].opcode == e->opcode &&
+            groups[i].target == e->target) {
+            return &groups[i];
+        }
+    }
+
+    if (*num_groups == MAX_GROUPS) {
+        return NULL;
+    }
+
+    groups[i].kind   = e->kind;
+    groups[i].opcode = e->opcode;
+    groups[i].target = e->target;
+    (*num_groups)++;
+
+    return &groups[i];
+}
+
+static void print_groups(const struct trace_group *groups,
+                         unsigned int num_groups,
+                         uint64_t total,
+                         uint64_t dropped)
+{
+    unsigned int i, bin;
+    uint64_t limit_us;
+    char name[64];
+
+    printf("\n  %" PRIu64 " transactions", total);
+    if (dropped != 0) {
+        printf(" (%" PRIu64 " dropped)", dropped);
+    }
+    printf("\n");
+
+    for (i = 0; i < num_groups; i++) {
+        const struct trace_group *g = &groups[i];
+
+        group_name(g, name, sizeof(name));
+
+        printf("\n  %s: %" PRIu64 " transactions, %" PRIu64 " errors\n", name,
+               g->count, g->errors);
+        printf("    Round trip (us): min %.1f, mean %.1f, max %.1f\n",
+               g->min_ns / 1e3, (g->total_ns / (double)g->count) / 1e3,
+               g->max_ns / 1e3);
+
+        limit_us = HIST_BASE_US;
+        for (bin = 0; bin < HIST_BINS; bin++, limit_us <<= 1) {
+            if (g->hist[bin] == 0) {
+                continue;
+            }
+
+            if (bin == (HIST_BINS - 1)) {
+                printf("      >= %6" PRIu64 " us: %" PRIu64 "\n",
+                       limit_us >> 1, g->hist[bin]);
+            } else {
+                printf("       < %6" PRIu64 " us: %" PRIu64 "\n", limit_us,
+                       g->hist[bin]);
+            }
+        }
+    }
+
+    printf("\n");
+}
+
+/* Read all pending entries, either aggregating them into groups or
+ * writing them to `out` */
+static int drain(struct cli_state *state,
+                 struct trace_group *groups,
+                 unsigned int *num_groups,
+                 FILE *out,
+                 uint64_t *total,
+                 uint64_t *dropped)
+{
+    struct bladerf_ctrl_trace_entry entries[256];
+    unsigned int n, i;
+    uint64_t d;
+    int status;
+
+    *total   = 0;
+    *dropped = 0;
+
+    do {
+        status = bladerf_read_ctrl_trace(state->dev, entries,
+                                         ARRAY_SIZE(entries), &n, &d);
+        if (status != 0) {
+            state->last_lib_error = status;
+            return CLI_RET_LIBBLADERF;
+        }
+
+        *total += n;
+        *dropped += d;
+
+        for (i = 0; i < n; i++) {
+            const struct bladerf_ctrl_trace_entry *e = &entries[i];
+
+            if (out != NULL) {
+                fprintf(out,
+                        "%" PRIu64 ",%" PRIu64 ",%s,0x%02x,0x%02x,%s,%d\n",
+                        e->timestamp, e->duration,
+                        e->kind == BLADERF_CTRL_TRACE_NIOS ? "nios" : "vendor",
+                        e->opcode, e->target, e->write ? "w" : "r",
+                        e->status);
+            } else {
+                struct trace_group *g = group_find(groups, num_groups, e);
+                if (g != NULL) {
+                    group_add(g, e);
+                }
+            }
+        }
+    } while (n == ARRAY_SIZE(entries));
+
+    return 0;
+}
+
+int cmd_trace(struct cli_state *state, int argc, char **argv)
+{
+    struct trace_group *groups = NULL;
+    unsigned int num_groups    = 0;
+    uint64_t total, dropped;
+    int status;
+
+    if (argc < 2 || !strcasecmp(argv[1], "show")) {
+        if (argc > 2) {
+            return CLI_RET_NARGS;
+        }
+
+        groups = calloc(MAX_GROUPS, sizeof(groups[0]));
+        if (groups == NULL) {
+            return CLI_RET_MEM;
+        }
+
+        status = drain(state, groups, &num_groups, NULL, &total, &dropped);
+        if (status == 0) {
+            print_groups(groups, num_groups, total, dropped);
+        }
+
+        free(groups);
+    } else if (!strcasecmp(argv[1], "on") || !strcasecmp(argv[1], "off")) {
+        if (argc != 2) {
+            return CLI_RET_NARGS;
+        }
+
+        status = bladerf_enable_ctrl_trace(state->dev,
+                                           !strcasecmp(argv[1], "on"));
+        if (status != 0) {
+            state->last_lib_error = status;
+            status = CLI_RET_LIBBLADERF;
+        }
+    } else if (!strcasecmp(argv[1], "dump")) {
+        FILE *out;
+
+        if (argc != 3) {
+            return CLI_RET_NARGS;
+        }
+
+        status = expand_and_open(argv[2], "w", &out);
+        if (status != 0) {
+            return status;
+        }
+
+        fprintf(out, "timestamp_ns,duration_ns,kind,opcode,target,dir,status\n");
+        status = drain(state, NULL, NULL, out, &total, &dropped);
+        fclose(out);
+
+        if (status == 0) {
+            printf("\n  Wrote %" PRIu64 " transactions", total);
+            if (dropped != 0) {
+                printf(" (%" PRIu64 " dropped)", dropped);
+            }
+            printf(".\n\n");
+        }
+    } else if (!strcasecmp(argv[1], "clear")) {
+        if (argc != 2) {
+            return CLI_RET_NARGS;
+        }
+
+        groups = calloc(MAX_GROUPS, sizeof(groups[0]));
+        if (groups == NULL) {
+            return CLI_RET_MEM;
+        }
+
+        status = drain(state, groups, &num_groups, NULL, &total, &dropped);
+        free(groups);
+    } else {
+        cli_err(state, argv[0], "Invalid operation: %s\n", argv[1]);
+        status = CLI_RET_INVPARAM;
+    }
+
+    return status;
+}
@@ -0,0 +1,681 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <inttypes.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <conversions.h>
+
+#include "host_config.h"
+#include "cmd.h"
+
+/* Time spent measuring each candidate, after the stream has settled */
+#define DEFAULT_DURATION_MS 1000
+#define WARMUP_MS 100
+#define TIMEOUT_MS 1000
+
+/* Candidate sizes, in samples, beyond those of the low-latency profile */
+#define MIN_BUFFER_SIZE 1024
+#define MAX_BUFFER_SIZE 32768
+
+#define MAX_CPUS 64
+#define MAX_CANDIDATES 64
+
+/* Marks the block of the config file that is replaced on each save */
+#define CONF_BEGIN "# Begin tune_host recommendation for "
+#define CONF_END "# End tune_host recommendation for "
+
+struct tune_params {
+    unsigned int rate;
+    unsigned int duration_ms;
+    bool loopback;
+    unsigned int cpus[MAX_CPUS];
+    unsigned int num_cpus;
+    bool save;
+    const char *path;
+};
+
+struct tune_candidate {
+    unsigned int num_buffers;
+    unsigned int buffer_size;
+    unsigned int num_transfers;
+    bool low_latency;
+    double latency_us; /* Time spanned by the transfers in flight */
+};
+
+struct tune_result {
+    bool sustained;
+    uint64_t overruns;
+    double rate;       /* Samples per second received */
+    double latency_us; /* Measured latency */
+};
+
+static const unsigned int transfer_counts[] = { 4, 8, 16, 32 };
+
+/* The low-latency profile supports more, shorter transfers */
+#define LL_MAX_TRANSFERS 64
+
+static double elapsed_ms(const struct timespec *start)
+{
+    struct timespec now;
+
+    if (clock_gettime(CLOCK_REALTIME, &now) != 0) {
+        return 0.0;
+    }
+
+    return (now.tv_sec - start->tv_sec) * 1e3 +
+           (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+static int parse_cpus(struct tune_params *p, const char *val)
+{
+    const char *p_str = val;
+
+    p->num_cpus = 0;
+
+    if (!strcasecmp(val, "none")) {
+        return 0;
+    }
+
+    while (*p_str != '\0') {
+        char *end;
+        unsigned long first, last;
+
+        first = strtoul(p_str, &end, 10);
+        last  = first;
+        if (end == p_str) {
+            return -1;
+        }
+
+        if (*end == '-') {
+            p_str = end + 1;
+            last  = strtoul(p_str, &end, 10);
+            if (end == p_str || last < first) {
+                return -1;
+            }
+        }
+
+        for (; first <= last; first++) {
+            if (first >= MAX_CPUS || p->num_cpus == MAX_CPUS) {
+                return -1;
+            }
+            p->cpus[p->num_cpus++] = (unsigned int)first;
+        }
+
+        if (*end == ',') {
+            end++;
+        } else if (*end != '\0') {
+            return -1;
+        }
+        p_str = end;
+    }
+
+    return 0;
+}
+
+static int parse_param(struct cli_state *s,
+                       struct tune_params *p,
+                       const char *argv0,
+                       char *param)
+{
+    char *val;
+    bool ok = false;
+
+    if (!strcasecmp(param, "save")) {
+        p->save = true;
+        return 0;
+    }
+
+    val = strchr(param, '=');
+    if (val == NULL || val[1] == '\0') {
+        cli_err(s, argv0, "No value provided for parameter \"%s\"\n", param);
+        return CLI_RET_INVPARAM;
+    }
+
+    *val++ = '\0';
+
+    if (!strcasecmp(param, "rate")) {
+        unsigned int r = str2uint_suffix(val, 1, UINT_MAX, freq_suffixes,
+                                         NUM_FREQ_SUFFIXES, &ok);
+        if (ok) {
+            p->rate = r;
+        }
+    } else if (!strcasecmp(param, "duration")) {
+        unsigned int d = str2uint(val, 1, UINT_MAX / 2, &ok);
+        if (ok) {
+            p->duration_ms = d;
+        }
+    } else if (!strcasecmp(param, "mode")) {
+        ok = true;
+        if (!strcasecmp(val, "stream")) {
+            p->loopback = false;
+        } else if (!strcasecmp(val, "loopback")) {
+            p->loopback = true;
+        } else {
+            ok = false;
+        }
+    } else if (!strcasecmp(param, "cpus")) {
+        ok = parse_cpus(p, val) == 0;
+    } else if (!strcasecmp(param, "save")) {
+        p->save = true;
+        p->path = val;
+        ok      = true;
+    } else {
+        cli_err(s, argv0, "Unrecognized parameter: %s\n", param);
+        return CLI_RET_INVPARAM;
+    }
+
+    if (!ok) {
+        cli_err(s, argv0, "Invalid %s value (%s)\n", param, val);
+        return CLI_RET_INVPARAM;
+    }
+
+    return 0;
+}
+
+static int compare_candidates(const void *a, const void *b)
+{
+    const struct tune_candidate *ca = a;
+    const struct tune_candidate *cb = b;
+
+    if (ca->latency_us != cb->latency_us) {
+        return (ca->latency_us < cb->latency_us) ? -1 : 1;
+    }
+
+    /* Of equal latencies, fewer and larger transfers incur less overhead */
+    return (int)ca->num_transfers - (int)cb->num_transfers;
+}
+
+static void add_candidate(struct tune_candidate *c,
+                          unsigned int *n,
+                          unsigned int rate,
+                          unsigned int buffer_size,
+                          unsigned int num_transfers,
+                          bool low_latency)
+{
+    if (*n == MAX_CANDIDATES) {
+        return;
+    }
+
+    c[*n].num_buffers   = 2 * num_transfers;
+    c[*n].buffer_size   = buffer_size;
+    c[*n].num_transfers = num_transfers;
+    c[*n].low_latency   = low_latency;
+    c[*n].latency_us    = 1e6 * buffer_size * num_transfers / rate;
+    (*n)++;
+}
+
+/* Enumerate the candidate sizings, from lowest to highest latency */
+static unsigned int get_candidates(struct bladerf *dev,
+                                   const struct tune_params *p,
+                                   struct tune_candidate *c)
+{
+    unsigned int n = 0;
+    unsigned int size, i;
+
+    /* The firmware loopback benchmark requires multiples of 1024 samples.
+     * Otherwise, buffers of one or more USB messages are also tried, under
+     * the low-latency profile. */
+    if (!p->loopback) {
+        const unsigned int msg_samples =
+            (bladerf_device_speed(dev) == BLADERF_DEVICE_SPEED_SUPER) ? 512
+                                                                       : 256;
+
+        for (size = msg_samples; size < MIN_BUFFER_SIZE; size *= 2) {
+            for (i = 0; i < ARRAY_SIZE(transfer_counts); i++) {
+                add_candidate(c, &n, p->rate, size, transfer_counts[i], true);
+            }
+            add_candidate(c, &n, p->rate, size, LL_MAX_TRANSFERS, true);
+        }
+    }
+
+    for (size = MIN_BUFFER_SIZE; size <= MAX_BUFFER_SIZE; size *= 2) {
+        for (i = 0; i < ARRAY_SIZE(transfer_counts); i++) {
+            add_candidate(c, &n, p->rate, size, transfer_counts[i], false);
+        }
+    }
+
+    qsort(c, n, sizeof(c[0]), compare_candidates);
+    return n;
+}
+
+static int set_placement(struct bladerf *dev,
+                         const struct tune_params *p,
+                         uint64_t cpu_mask)
+{
+    struct bladerf_stream_thread_attrs attrs = { 0, 0 };
+    int status;
+
+    attrs.cpu_mask = cpu_mask;
+
+    status = bladerf_set_stream_thread_attrs(dev, BLADERF_RX, &attrs);
+    if (status == 0 && p->loopback) {
+        status = bladerf_set_stream_thread_attrs(dev, BLADERF_TX, &attrs);
+    }
+
+    return status;
+}
+
+/* Receive at the target rate, stopping at the first overrun */
+static int run_stream(struct bladerf *dev,
+                      const struct tune_params *p,
+                      const struct tune_candidate *c,
+                      struct tune_result *r)
+{
+    struct bladerf_metadata meta;
+    struct bladerf_stream_stats start_stats, stats;
+    struct bladerf_sync_latency latency;
+    struct timespec start, measure_start;
+    uint64_t samples  = 0;
+    uint64_t expected = 0;
+    bool measuring    = false;
+    bool first        = true;
+    double elapsed    = 0.0;
+    int16_t *buf;
+    int status;
+
+    memset(&start_stats, 0, sizeof(start_stats));
+
+    buf = malloc(c->buffer_size * 2 * sizeof(int16_t));
+    if (buf == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    status = bladerf_set_sync_low_latency(dev, BLADERF_RX, c->low_latency);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = bladerf_sync_config(dev, BLADERF_RX_X1,
+                                 BLADERF_FORMAT_SC16_Q11_META, c->num_buffers,
+                                 c->buffer_size, c->num_transfers, TIMEOUT_MS);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = bladerf_enable_module(dev, BLADERF_CHANNEL_RX(0), true);
+    if (status != 0) {
+        goto out;
+    }
+
+    clock_gettime(CLOCK_REALTIME, &start);
+
+    r->sustained = true;
+
+    while (elapsed < p->duration_ms) {
+        memset(&meta, 0, sizeof(meta));
+        meta.flags = BLADERF_META_FLAG_RX_NOW;
+
+        status = bladerf_sync_rx(dev, buf, c->buffer_size, &meta, TIMEOUT_MS);
+        if (status == BLADERF_ERR_TIMEOUT) {
+            /* The stream could not keep up at all */
+            r->sustained = false;
+            status       = 0;
+            break;
+        } else if (status != 0) {
+            break;
+        }
+
+        /* Overruns while the stream starts up are not held against it */
+        if (!measuring && elapsed_ms(&start) >= WARMUP_MS) {
+            measuring = true;
+            samples   = 0;
+            clock_gettime(CLOCK_REALTIME, &measure_start);
+            bladerf_get_sync_stats(dev, BLADERF_RX, &start_stats);
+        } else if (measuring) {
+            if ((meta.status & BLADERF_META_STATUS_OVERRUN) ||
+                (!first && meta.timestamp != expected)) {
+                r->overruns++;
+            }
+            samples += meta.actual_count;
+            elapsed = elapsed_ms(&measure_start);
+        }
+
+        if (r->overruns != 0) {
+            break;
+        }
+
+        expected = meta.timestamp + meta.actual_count;
+        first    = false;
+    }
+
+    if (status == 0 &&
+        bladerf_get_sync_stats(dev, BLADERF_RX, &stats) == 0 && measuring &&
+        stats.overruns - start_stats.overruns > r->overruns) {
+        r->overruns = stats.overruns - start_stats.overruns;
+    }
+
+    if (status == 0 &&
+        bladerf_get_sync_latency(dev, BLADERF_RX, &latency) == 0) {
+        r->latency_us = (double)latency.total_us;
+    }
+
+    if (elapsed > 0) {
+        r->rate = samples * 1e3 / elapsed;
+    }
+
+    if (r->overruns != 0) {
+        r->sustained = false;
+    }
+
+    bladerf_enable_module(dev, BLADERF_CHANNEL_RX(0), false);
+
+out:
+    free(buf);
+    return status;
+}
+
+/* Loop samples through the FX3 at the fastest rate it sustains */
+static int run_loopback(struct bladerf *dev,
+                        const struct tune_params *p,
+                        const struct tune_candidate *c,
+                        struct tune_result *r)
+{
+    struct bladerf_fw_loopback_bench_config config;
+    struct bladerf_fw_loopback_bench_results results;
+    uint64_t count;
+    int status;
+
+    count = (uint64_t)p->rate * p->duration_ms / 1000 / c->buffer_size;
+    if (count < 2 * c->num_buffers) {
+        count = 2 * c->num_buffers;
+    } else if (count > UINT_MAX) {
+        count = UINT_MAX;
+    }
+
+    config.num_buffers   = c->num_buffers;
+    config.buffer_size   = c->buffer_size;
+    config.num_transfers = c->num_transfers;
+    config.count         = (unsigned int)count;
+
+    status = bladerf_fw_loopback_bench(dev, &config, &results);
+    if (status != 0) {
+        return status;
+    }
+
+    /* SC16 Q11 samples occupy 4 bytes */
+    r->rate       = results.throughput / 4;
+    r->latency_us = results.latency_p99;
+    r->overruns   = results.errors;
+    r->sustained  = (results.errors == 0 && r->rate >= p->rate);
+
+    return 0;
+}
+
+static void print_placement(char *str, size_t len, const struct tune_params *p,
+                            int placement)
+{
+    if (placement < 0) {
+        snprintf(str, len, "any");
+    } else {
+        snprintf(str, len, "%u", p->cpus[placement]);
+    }
+}
+
+static int get_default_path(char *path, size_t len)
+{
+#if BLADERF_OS_WINDOWS
+    const char *base = getenv("APPDATA");
+    const char *dir  = "\\Nuand\\bladeRF\\bladeRF.conf";
+#else
+    const char *base = getenv("HOME");
+    const char *dir  = "/.config/Nuand/bladeRF/bladeRF.conf";
+#endif
+
+    if (base == NULL || strlen(base) + strlen(dir) >= len) {
+        return -1;
+    }
+
+    snprintf(path, len, "%s%s", base, dir);
+    return 0;
+}
+
+/* Copy a config file, without any block previously written for this
+ * device, and append the recommendation */
+static int save_recommendation(struct cli_state *s,
+                               const char *argv0,
+                               const char *serial,
+                               const char *path,
+                               const char *lines)
+{
+    char begin[BLADERF_SERIAL_LENGTH + sizeof(CONF_BEGIN) + 1];
+    char end[BLADERF_SERIAL_LENGTH + sizeof(CONF_END) + 1];
+    char *contents = NULL;
+    size_t len     = 0;
+    FILE *f;
+    int status = CLI_RET_OK;
+
+    snprintf(begin, sizeof(begin), "%s%s\n", CONF_BEGIN, serial);
+    snprintf(end, sizeof(end), "%s%s\n", CONF_END, serial);
+
+    f = fopen(path, "rb");
+    if (f != NULL) {
+        long size;
+
+        if (fseek(f, 0, SEEK_END) == 0 && (size = ftell(f)) >= 0 &&
+            fseek(f, 0, SEEK_SET) == 0) {
+            contents = calloc(1, (size_t)size + 1);
+            if (contents == NULL) {
+                fclose(f);
+                return CLI_RET_MEM;
+            }
+            len = fread(contents, 1, (size_t)size, f);
+            contents[len] = '\0';
+        }
+        fclose(f);
+    }
+
+    if (contents != NULL) {
+        char *b = strstr(contents, begin);
+
+        if (b != NULL) {
+            char *e = strstr(b, end);
+
+            e = (e != NULL) ? e + strlen(end) : contents + len;
+            memmove(b, e, strlen(e) + 1);
+            len = strlen(contents);
+        }
+    }
+
+    f = fopen(path, "wb");
+    if (f == NULL) {
+        cli_err(s, argv0, "Failed to open %s for writing. Does its directory "
+                "exist?\n", path);
+        free(contents);
+        return CLI_RET_FILEOP;
+    }
+
+    if (len != 0) {
+        fwrite(contents, 1, len, f);
+        if (contents[len - 1] != '\n') {
+            fputc('\n', f);
+        }
+    }
+
+    fprintf(f, "%s[*:serial=%s]\n%s[*]\n%s", begin, serial, lines, end);
+
+    if (fclose(f) != 0) {
+        cli_err(s, argv0, "Failed to write %s\n", path);
+        status = CLI_RET_FILEOP;
+    }
+
+    free(contents);
+    return status;
+}
+
+int cmd_tune_host(struct cli_state *state, int argc, char **argv)
+{
+    struct bladerf *dev = state->dev;
+    struct tune_params p;
+    struct tune_candidate *candidates = NULL;
+    const struct tune_candidate *best = NULL;
+    struct tune_result result;
+    struct bladerf_serial sn;
+    bladerf_sample_rate prev_rate = 0;
+    unsigned int num_candidates, i;
+    int placement, best_placement = -1;
+    char cpu_str[16];
+    char lines[256];
+    char path[1024];
+    int status;
+    int ret = CLI_RET_OK;
+
+    memset(&p, 0, sizeof(p));
+    p.duration_ms = DEFAULT_DURATION_MS;
+
+    for (i = 1; i < (unsigned int)argc; i++) {
+        status = parse_param(state, &p, argv[0], argv[i]);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    status = bladerf_get_sample_rate(dev, BLADERF_CHANNEL_RX(0), &prev_rate);
+    if (status != 0) {
+        goto out_lib;
+    }
+
+    if (p.rate == 0) {
+        p.rate = prev_rate;
+    }
+
+    if (!p.loopback) {
+        status = bladerf_set_sample_rate(dev, BLADERF_CHANNEL_RX(0), p.rate,
+                                         &p.rate);
+        if (status != 0) {
+            goto out_lib;
+        }
+    }
+
+    candidates = calloc(MAX_CANDIDATES, sizeof(candidates[0]));
+    if (candidates == NULL) {
+        return CLI_RET_MEM;
+    }
+
+    num_candidates = get_candidates(dev, &p, candidates);
+
+    printf("\n  Searching for the lowest latency sustaining %u samples/s via "
+           "%s...\n\n", p.rate,
+           p.loopback ? "the firmware loopback" : "an RX stream");
+    printf("  Buffers  Samples  Transfers  CPU   Latency (us)    Result\n");
+
+    /* Candidates are in order of increasing latency, so the first to be
+     * sustained, in any placement, is the one recommended */
+    for (i = 0; i < num_candidates && best == NULL; i++) {
+        const struct tune_candidate *c = &candidates[i];
+
+        for (placement = -1; placement < (int)p.num_cpus; placement++) {
+            const uint64_t mask =
+                (placement < 0) ? 0 : (UINT64_C(1) << p.cpus[placement]);
+
+            memset(&result, 0, sizeof(result));
+
+            status = set_placement(dev, &p, mask);
+            if (status == 0) {
+                status = p.loopback ? run_loopback(dev, &p, c, &result)
+                                    : run_stream(dev, &p, c, &result);
+            }
+
+            if (status != 0) {
+                goto out_lib;
+            }
+
+            print_placement(cpu_str, sizeof(cpu_str), &p, placement);
+            printf("  %7u  %7u  %9u  %-4s  %12.0f    %s", c->num_buffers,
+                   c->buffer_size, c->num_transfers, cpu_str,
+                   result.latency_us, result.sustained ? "ok" : "failed");
+
+            if (!result.sustained && result.overruns != 0) {
+                printf(" (%" PRIu64 " %s)", result.overruns,
+                       p.loopback ? "errors" : "overruns");
+            } else if (!result.sustained) {
+                printf(" (%.0f samples/s)", result.rate);
+            }
+            printf("\n");
+
+            if (result.sustained) {
+                best           = c;
+                best_placement = placement;
+                break;
+            }
+        }
+    }
+
+    if (best == NULL) {
+        printf("\n  No configuration sustained %u samples/s.\n\n", p.rate);
+        goto out;
+    }
+
+    snprintf(lines, sizeof(lines),
+             "sync_sizing_rx %u,%u,%u\n"
+             "sync_low_latency_rx %s\n"
+             "stream_cpu_mask_rx 0x%" PRIx64 "\n",
+             best->num_buffers, best->buffer_size, best->num_transfers,
+             best->low_latency ? "on" : "off",
+             (best_placement < 0) ? UINT64_C(0)
+                                  : (UINT64_C(1) << p.cpus[best_placement]));
+
+    printf("\n  Recommended bladeRF.conf options:\n\n%s\n", lines);
+
+    if (p.save) {
+        status = bladerf_get_serial_struct(dev, &sn);
+        if (status != 0) {
+            goto out_lib;
+        }
+
+        if (p.path == NULL) {
+            if (get_default_path(path, sizeof(path)) != 0) {
+                cli_err(state, argv[0], "Could not determine the config "
+                        "directory. Specify a file via save=<file>.\n");
+                ret = CLI_RET_INVPARAM;
+                goto out;
+            }
+            p.path = path;
+        }
+
+        ret = save_recommendation(state, argv[0], sn.serial, p.path, lines);
+        if (ret == CLI_RET_OK) {
+            printf("  Saved to %s\n\n", p.path);
+        }
+    }
+
+    goto out;
+
+out_lib:
+    state->last_lib_error = status;
+    ret                   = CLI_RET_LIBBLADERF;
+
+out:
+    free(candidates);
+
+    /* Restore the stream settings that were changed by the search */
+    bladerf_set_stream_thread_attrs(dev, BLADERF_RX, NULL);
+    bladerf_set_stream_thread_attrs(dev, BLADERF_TX, NULL);
+    bladerf_set_sync_low_latency(dev, BLADERF_RX, false);
+    if (prev_rate != 0) {
+        bladerf_set_sample_rate(dev, BLADERF_CHANNEL_RX(0), prev_rate, NULL);
+    }
+
+    return ret;
+}
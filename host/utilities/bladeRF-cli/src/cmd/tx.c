@@ -32,11 +32,142 @@
 #include "parse.h"
 #include "rel_assert.h"
 #include "rxtx_impl.h"
+#include "sc16q11_csv.h"
+
+#if !BLADERF_OS_WINDOWS
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define TX_HAVE_MMAP 1
+#else
+#define TX_HAVE_MMAP 0
+#endif
 
 /* The DAC range is [-2048, 2047] */
 #define SC16Q11_IQ_MIN (-2048)
 #define SC16Q11_IQ_MAX (2047)
 
+/* Parameters for playback of a mapped file */
+struct tx_playback {
+    unsigned int repeats_remaining;
+    bool repeat_infinite;
+    unsigned int delay_samples;
+    unsigned int timeout_ms;
+};
+
+#if TX_HAVE_MMAP
+/* Map the input file. Returns false if it cannot be, in which case the file
+ * is read into buffers instead. */
+static bool tx_map_file(struct rxtx_data *tx, const int16_t **data,
+                        size_t *len)
+{
+    struct stat st;
+    void *map;
+    int fd;
+
+    MUTEX_LOCK(&tx->file_mgmt.file_lock);
+    fd = fileno(tx->file_mgmt.file);
+    MUTEX_UNLOCK(&tx->file_mgmt.file_lock);
+
+    if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) ||
+        st.st_size < (off_t)(2 * sizeof(int16_t)) ||
+        (uint64_t)st.st_size > SIZE_MAX) {
+        return false;
+    }
+
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+
+#ifdef MADV_SEQUENTIAL
+    madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+
+    *data = map;
+    *len  = (size_t)st.st_size;
+    return true;
+}
+
+/* Transmit a zero-filled region of up to `n' samples, returning the number
+ * committed via `committed' */
+static int tx_commit_zeros(struct cli_state *s, unsigned int n,
+                           unsigned int timeout_ms, unsigned int *committed)
+{
+    void *buf;
+    unsigned int avail;
+    int status;
+
+    status = bladerf_sync_tx_acquire(s->dev, &buf, &avail, timeout_ms);
+    if (status != 0) {
+        return status;
+    }
+
+    avail = uint_min(avail, n);
+    memset(buf, 0, avail * 2 * sizeof(int16_t));
+
+    *committed = avail;
+    return bladerf_sync_tx_commit(s->dev, buf, avail);
+}
+
+/* Play back a mapped file, copying it straight into the stream's buffers.
+ *
+ * Repetitions follow each other in the continuous sample stream, with
+ * exactly `delay_samples' zero samples between them, so they are gapless
+ * and sample-accurate without needing timestamps. */
+static int tx_play_mapped(struct rxtx_data *tx, struct cli_state *s,
+                          struct tx_playback *pb,
+                          const int16_t *data, size_t len)
+{
+    const size_t file_samples = len / (2 * sizeof(int16_t));
+    size_t pos                = 0;
+    unsigned int delay        = 0;
+    unsigned int n, committed;
+    unsigned int avail;
+    void *buf;
+    int status = 0;
+
+    while (status == 0) {
+        unsigned char requests = rxtx_get_requests(tx, RXTX_TASK_REQ_STOP);
+        if (requests & (RXTX_TASK_REQ_STOP | RXTX_TASK_REQ_SHUTDOWN)) {
+            break;
+        }
+
+        if (delay != 0) {
+            status = tx_commit_zeros(s, delay, pb->timeout_ms, &committed);
+            delay -= committed;
+            rxtx_stats_add(tx, committed, 0);
+            continue;
+        }
+
+        status = bladerf_sync_tx_acquire(s->dev, &buf, &avail, pb->timeout_ms);
+        if (status != 0) {
+            break;
+        }
+
+        n = (unsigned int)min_sz(avail, file_samples - pos);
+        memcpy(buf, &data[2 * pos], n * 2 * sizeof(int16_t));
+
+        status = bladerf_sync_tx_commit(s->dev, buf, n);
+        pos += n;
+
+        rxtx_stats_add(tx, n, n * 2 * sizeof(int16_t));
+        rxtx_stats_tick(s, tx);
+
+        if (pos == file_samples) {
+            pos = 0;
+
+            if (!pb->repeat_infinite && --pb->repeats_remaining == 0) {
+                break;
+            }
+
+            delay = pb->delay_samples;
+        }
+    }
+
+    return status;
+}
+#endif
+
 static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
 {
     int status = 0;
@@ -50,6 +181,12 @@ static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
     bool repeat_infinite;
     unsigned int timeout_ms;
     bladerf_sample_rate sample_rate = 0;
+    bool use_mmap;
+    struct bladerf_metadata meta;
+    bool scheduled;
+    uint64_t start_ts;
+    uint64_t samples_sent = 0;
+    unsigned int nchans;
     int i;
 
     enum state { INIT, READ_FILE, DELAY, PAD_TRAILING, DONE };
@@ -59,6 +196,7 @@ static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
     MUTEX_LOCK(&tx->param_lock);
     repeats_remaining = tx_params->repeat;
     delay_us          = tx_params->repeat_delay;
+    use_mmap          = tx_params->mmap;
     MUTEX_UNLOCK(&tx->param_lock);
 
     repeat_infinite = (repeats_remaining == 0);
@@ -66,6 +204,7 @@ static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
     MUTEX_LOCK(&tx->data_mgmt.lock);
     samples_per_buffer = (unsigned int)tx->data_mgmt.samples_per_buffer;
     timeout_ms         = tx->data_mgmt.timeout_ms;
+    nchans             = (tx->data_mgmt.layout == BLADERF_TX_X2) ? 2 : 1;
     MUTEX_UNLOCK(&tx->data_mgmt.lock);
 
     for (i = 0; i < RXTX_MAX_CHANNELS; ++i) {
@@ -89,6 +228,50 @@ static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
     delay_samples = (unsigned int)((uint64_t)sample_rate * delay_us / 1000000);
     delay_samples_remaining = delay_samples;
 
+    status = rxtx_wait_for_start(s, tx, sample_rate, &scheduled, &start_ts);
+    if (status != 0) {
+        set_last_error(&tx->last_error, ETYPE_BLADERF, status);
+        return CLI_RET_LIBBLADERF;
+    }
+
+    /* A scheduled start is sent as a single timestamped burst. Mapped
+     * playback commits raw stream buffers, which carry no timestamps, so the
+     * file is read instead. */
+    memset(&meta, 0, sizeof(meta));
+    if (scheduled) {
+        meta.flags     = BLADERF_META_FLAG_TX_BURST_START;
+        meta.timestamp = start_ts;
+        use_mmap       = false;
+    }
+
+#if TX_HAVE_MMAP
+    if (use_mmap) {
+        const int16_t *data;
+        size_t len;
+
+        if (tx_map_file(tx, &data, &len)) {
+            struct tx_playback pb;
+
+            pb.repeats_remaining = repeats_remaining;
+            pb.repeat_infinite   = repeat_infinite;
+            pb.delay_samples     = delay_samples;
+            pb.timeout_ms        = timeout_ms;
+
+            status = tx_play_mapped(tx, s, &pb, data, len);
+            munmap((void *)data, len);
+
+            if (status != 0) {
+                set_last_error(&tx->last_error, ETYPE_BLADERF, status);
+                return CLI_RET_LIBBLADERF;
+            }
+
+            state = DONE;
+        }
+    }
+#else
+    (void)use_mmap;
+#endif
+
     /* Allocate a buffer to hold each block of samples to transmit */
     tx_buffer = (int16_t *)malloc(samples_per_buffer * 2 * sizeof(int16_t));
     if (tx_buffer == NULL) {
@@ -128,6 +311,8 @@ static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
                               buffer_samples_remaining, tx->file_mgmt.file);
 
                     assert(samples_populated <= UINT_MAX);
+                    rxtx_stats_add(tx, 0,
+                                   samples_populated * 2 * sizeof(int16_t));
 
                     /* If the end of the file was reached, determine whether
                      * to delay, re-read from the file, or pad the rest of the
@@ -144,9 +329,13 @@ static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
                             state = PAD_TRAILING;
                         }
 
-                        /* Clear the EOF condition and rewind the file */
+                        /* Clear the EOF condition and rewind the file. A
+                         * stream that cannot be rewound, such as a network
+                         * connection, ends at its EOF. */
                         clearerr(tx->file_mgmt.file);
-                        rewind(tx->file_mgmt.file);
+                        if (fseek(tx->file_mgmt.file, 0, SEEK_SET) != 0) {
+                            state = PAD_TRAILING;
+                        }
                     }
 
                     /* Check for errors */
@@ -194,17 +383,53 @@ static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
         }
 
         /* If there were no errors, transmit the data buffer */
-        if (status == 0) {
+        if (status == 0 && scheduled) {
+            if (state == DONE) {
+                meta.flags |= BLADERF_META_FLAG_TX_BURST_END;
+            }
+
+            status = bladerf_sync_tx(s->dev, tx_buffer, samples_per_buffer,
+                                     &meta, timeout_ms);
+            if (status != 0) {
+                set_last_error(&tx->last_error, ETYPE_BLADERF, status);
+            }
+
+            meta.flags = 0;
+            samples_sent += samples_per_buffer;
+
+            rxtx_stats_add(tx, samples_per_buffer, 0);
+            rxtx_stats_tick(s, tx);
+        } else if (status == 0) {
             bladerf_sync_tx(s->dev, tx_buffer, samples_per_buffer, NULL,
                             timeout_ms);
+
+            rxtx_stats_add(tx, samples_per_buffer, 0);
+            rxtx_stats_tick(s, tx);
         }
     }
 
-    /* Flush zero samples through the device to ensure samples reach the RFFE
-     * before we exit and then disable the TX channel.
-     *
-     * This is a bit excessive, but sufficient for the time being. */
-    if (status == 0) {
+    if (status == 0 && scheduled) {
+        /* A stop leaves the burst open, so end it with zeros */
+        if (state != DONE && samples_sent != 0) {
+            memset(tx_buffer, 0, samples_per_buffer * 2 * sizeof(int16_t));
+            meta.flags = BLADERF_META_FLAG_TX_BURST_END;
+
+            status = bladerf_sync_tx(s->dev, tx_buffer, samples_per_buffer,
+                                     &meta, timeout_ms);
+            samples_sent += samples_per_buffer;
+        }
+
+        /* Wait for the end of the burst, rather than flushing zeros through
+         * the device, which would each need a burst of their own */
+        if (status == 0 && samples_sent != 0) {
+            status = rxtx_wait_for_timestamp(s, tx, sample_rate,
+                                             start_ts + samples_sent / nchans);
+        }
+    } else if (status == 0) {
+        /* Flush zero samples through the device to ensure samples reach the
+         * RFFE before we exit and then disable the TX channel.
+         *
+         * This is a bit excessive, but sufficient for the time being. */
         const unsigned int num_buffers = tx->data_mgmt.num_buffers;
         unsigned int i;
 
@@ -231,13 +456,10 @@ static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
 static int tx_csv_to_sc16q11(struct cli_state *s)
 {
     struct rxtx_data *tx = s->tx;
-    char buf[81]         = { 0 };
     FILE *bin            = NULL;
     FILE *csv            = NULL;
     char *bin_name       = NULL;
-    int16_t *tmp_iq      = NULL;
-    int line             = 1;
-    size_t n_clamped     = 0;
+    struct sc16q11_csv_result result;
 
     int status;
 
@@ -259,72 +481,27 @@ static int tx_csv_to_sc16q11(struct cli_state *s)
         goto tx_csv_to_sc16q11_out;
     }
 
-    while (fgets(buf, sizeof(buf), csv)) {
-        int i, cols, tmp_int;
-        int **args = NULL;
-
-        cols = csv2int(buf, &args);
+    status = sc16q11_csv_to_bin(csv, bin, SC16Q11_IQ_MIN, SC16Q11_IQ_MAX,
+                                &result);
 
-        if (cols < 0) {
-            cli_err(s, "tx", "Line (%d): Parsing failed.\n", line);
-            status = CLI_RET_INVPARAM;
-            break;
-        }
-
-        if (cols == 0) {
-            // empty line...?
-            continue;
-        }
-
-        tmp_iq = realloc(tmp_iq, cols * sizeof(int16_t));
-
-        for (i = 0; i < cols; ++i) {
-            tmp_int = *args[i];
-
-            if (tmp_int < SC16Q11_IQ_MIN) {
-                tmp_int = SC16Q11_IQ_MIN;
-                n_clamped++;
-            } else if (tmp_int > SC16Q11_IQ_MAX) {
-                tmp_int = SC16Q11_IQ_MAX;
-                n_clamped++;
-            }
-
-            tmp_iq[i] = tmp_int;
-        }
-
-        free_csv2int(cols, args);
-
-        if (cols % 2 != 0) {
-            cli_err(
-                s, "tx",
-                "Line (%d): Encountered %d value%s (values must be in pairs)\n",
-                line, cols, 1 == cols ? "" : "s");
-            status = CLI_RET_INVPARAM;
-            break;
-        }
-
-        if ((int)fwrite(tmp_iq, sizeof(tmp_iq[0]), cols, bin) != cols) {
-            status = CLI_RET_FILEOP;
-            break;
-        }
-
-        line++;
+    if (status == CLI_RET_INVPARAM && result.odd_cols) {
+        cli_err(s, "tx",
+                "Line (%u): Encountered %u value%s (values must be in pairs)\n",
+                result.line, result.cols, 1 == result.cols ? "" : "s");
+    } else if (status == CLI_RET_INVPARAM) {
+        cli_err(s, "tx", "Line (%u): Parsing failed.\n", result.line);
     }
 
     if (status == 0) {
-        if (feof(csv)) {
-            tx->file_mgmt.format = RXTX_FMT_BIN_SC16Q11;
-            free(tx->file_mgmt.path);
-            tx->file_mgmt.path = bin_name;
-
-            if (n_clamped != 0) {
-                printf("  Warning: %zu value%s clamped within DAC SC16 Q11 "
-                       "range of [%d, %d].\n",
-                       n_clamped, 1 == n_clamped ? "" : "s", SC16Q11_IQ_MIN,
-                       SC16Q11_IQ_MAX);
-            }
-        } else {
-            status = CLI_RET_FILEOP;
+        tx->file_mgmt.format = RXTX_FMT_BIN_SC16Q11;
+        free(tx->file_mgmt.path);
+        tx->file_mgmt.path = bin_name;
+
+        if (result.n_clamped != 0) {
+            printf("  Warning: %zu value%s clamped within DAC SC16 Q11 "
+                   "range of [%d, %d].\n",
+                   result.n_clamped, 1 == result.n_clamped ? "" : "s",
+                   SC16Q11_IQ_MIN, SC16Q11_IQ_MAX);
         }
     }
 
@@ -333,8 +510,6 @@ tx_csv_to_sc16q11_out:
         free(bin_name);
     }
 
-    free(tmp_iq);
-
     if (csv) {
         fclose(csv);
     }
@@ -386,12 +561,17 @@ void *tx_task(void *cli_state_arg)
                 assert(tx->file_mgmt.file != NULL);
                 MUTEX_UNLOCK(&tx->file_mgmt.file_meta_lock);
 
-                /* Initialize the TX synchronous data configuration */
+                /* Initialize the TX synchronous data configuration. A
+                 * scheduled start is sent by timestamp. */
+                MUTEX_LOCK(&tx->data_mgmt.lock);
                 status = bladerf_sync_config(
                     cli_state->dev, tx->data_mgmt.layout,
-                    BLADERF_FORMAT_SC16_Q11, tx->data_mgmt.num_buffers,
+                    tx->data_mgmt.start_scheduled ? BLADERF_FORMAT_SC16_Q11_META
+                                                  : BLADERF_FORMAT_SC16_Q11,
+                    tx->data_mgmt.num_buffers,
                     tx->data_mgmt.samples_per_buffer,
                     tx->data_mgmt.num_transfers, tx->data_mgmt.timeout_ms);
+                MUTEX_UNLOCK(&tx->data_mgmt.lock);
 
                 if (status < 0) {
                     err_type = ETYPE_BLADERF;
@@ -411,7 +591,9 @@ void *tx_task(void *cli_state_arg)
                 if (status < 0) {
                     set_last_error(&tx->last_error, ETYPE_BLADERF, status);
                 } else {
+                    rxtx_stats_start(tx);
                     status = tx_task_exec_running(tx, cli_state);
+                    rxtx_stats_stop(tx);
 
                     if (status < 0) {
                         set_last_error(&tx->last_error, ETYPE_BLADERF, status);
@@ -448,6 +630,7 @@ void *tx_task(void *cli_state_arg)
 static int tx_cmd_start(struct cli_state *s)
 {
     int status = 0;
+    bool net;
 
     /* Check that we're able to start up in our current state */
     status = rxtx_cmd_start_check(s, s->tx, "tx");
@@ -458,7 +641,12 @@ static int tx_cmd_start(struct cli_state *s)
     /* Perform file conversion (if needed) and open input file */
     MUTEX_LOCK(&s->tx->file_mgmt.file_meta_lock);
 
-    if (s->tx->file_mgmt.format == RXTX_FMT_CSV_SC16Q11) {
+    net = net_stream_is_uri(s->tx->file_mgmt.path);
+
+    if (net && s->tx->file_mgmt.format == RXTX_FMT_CSV_SC16Q11) {
+        cli_err(s, "tx", "Network endpoints require the bin format.\n");
+        status = CLI_RET_INVPARAM;
+    } else if (s->tx->file_mgmt.format == RXTX_FMT_CSV_SC16Q11) {
         status = tx_csv_to_sc16q11(s);
 
         if (status == 0) {
@@ -470,9 +658,18 @@ static int tx_cmd_start(struct cli_state *s)
     if (status == 0) {
         MUTEX_LOCK(&s->tx->file_mgmt.file_lock);
 
-        assert(s->tx->file_mgmt.format == RXTX_FMT_BIN_SC16Q11);
-        status = expand_and_open(s->tx->file_mgmt.path, "rb",
-                                 &s->tx->file_mgmt.file);
+        /* SigMF data files are raw ci16_le, and are transmitted as-is */
+        assert(s->tx->file_mgmt.format == RXTX_FMT_BIN_SC16Q11 ||
+               s->tx->file_mgmt.format == RXTX_FMT_SIGMF_SC16Q11);
+
+        if (net) {
+            /* Samples are read from the connection as they are sent */
+            status = net_stream_open_source(s, "tx", s->tx->file_mgmt.path,
+                                            &s->tx->file_mgmt.file);
+        } else {
+            status = expand_and_open(s->tx->file_mgmt.path, "rb",
+                                     &s->tx->file_mgmt.file);
+        }
         MUTEX_UNLOCK(&s->tx->file_mgmt.file_lock);
     }
 
@@ -499,11 +696,13 @@ static int tx_cmd_start(struct cli_state *s)
 static void tx_print_config(struct rxtx_data *tx)
 {
     unsigned int repetitions, repeat_delay;
+    bool use_mmap;
     struct tx_params *tx_params = tx->params;
 
     MUTEX_LOCK(&tx->param_lock);
     repetitions  = tx_params->repeat;
     repeat_delay = tx_params->repeat_delay;
+    use_mmap     = tx_params->mmap;
     MUTEX_UNLOCK(&tx->param_lock);
 
     printf("\n");
@@ -525,6 +724,8 @@ static void tx_print_config(struct rxtx_data *tx)
         printf("  Repetition delay: none\n");
     }
 
+    printf("  Memory-mapped playback: %s\n", use_mmap ? "on" : "off");
+
     rxtx_print_stream_info(tx, "  ", "\n");
 
     printf("\n");
@@ -579,6 +780,18 @@ static int tx_config(struct cli_state *s, int argc, char **argv)
                     cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
                     return CLI_RET_INVPARAM;
                 }
+            } else if (!strcasecmp("mmap", argv[i])) {
+                /* Play back from a mapping of the file, where possible */
+                bool tmp;
+
+                if (str2bool(val, &tmp) == 0) {
+                    MUTEX_LOCK(&s->tx->param_lock);
+                    tx_params->mmap = tmp;
+                    MUTEX_UNLOCK(&s->tx->param_lock);
+                } else {
+                    cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
+                    return CLI_RET_INVPARAM;
+                }
             } else if (!strcasecmp("channel", argv[i])) {
                 /* Configure TX channels */
                 status = rxtx_handle_channel_list(s, s->tx, val);
@@ -616,6 +829,8 @@ int cmd_tx(struct cli_state *s, int argc, char **argv)
         status = tx_config(s, argc, argv);
     } else if (!strcasecmp(argv[1], RXTX_CMD_WAIT)) {
         status = rxtx_handle_wait(s, s->tx, argc, argv);
+    } else if (!strcasecmp(argv[1], RXTX_CMD_STATS)) {
+        status = rxtx_cmd_stats(s, s->tx);
     } else {
         cli_err(s, argv[0], "Invalid command: \"%s\"\n", argv[1]);
         status = CLI_RET_INVPARAM;
@@ -0,0 +1,102 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <inttypes.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <conversions.h>
+
+#include "cmd.h"
+
+#define DEFAULT_SAMPLES 16384
+#define DEFAULT_TRANSFERS 16
+
+/* Bytes looped back when no buffer count is given */
+#define DEFAULT_BYTES (64u * 1024 * 1024)
+
+int cmd_usb_bench(struct cli_state *state, int argc, char **argv)
+{
+    struct bladerf_fw_loopback_bench_config config;
+    struct bladerf_fw_loopback_bench_results results;
+    int status;
+    bool ok;
+
+    if (argc > 4) {
+        return CLI_RET_NARGS;
+    }
+
+    config.buffer_size   = DEFAULT_SAMPLES;
+    config.num_transfers = DEFAULT_TRANSFERS;
+    config.count         = 0;
+
+    if (argc > 1) {
+        config.buffer_size = str2uint(argv[1], 1024, UINT_MAX, &ok);
+        if (!ok || (config.buffer_size % 1024) != 0) {
+            cli_err(state, argv[0], "Invalid number of samples (%s)\n",
+                    argv[1]);
+            return CLI_RET_INVPARAM;
+        }
+    }
+
+    if (argc > 2) {
+        config.num_transfers = str2uint(argv[2], 1, UINT_MAX / 2, &ok);
+        if (!ok) {
+            cli_err(state, argv[0], "Invalid number of transfers (%s)\n",
+                    argv[2]);
+            return CLI_RET_INVPARAM;
+        }
+    }
+
+    if (argc > 3) {
+        config.count = str2uint(argv[3], 1, UINT_MAX, &ok);
+        if (!ok) {
+            cli_err(state, argv[0], "Invalid number of buffers (%s)\n",
+                    argv[3]);
+            return CLI_RET_INVPARAM;
+        }
+    } else {
+        config.count = DEFAULT_BYTES / (config.buffer_size * 4);
+        if (config.count == 0) {
+            config.count = 1;
+        }
+    }
+
+    config.num_buffers = 2 * config.num_transfers;
+
+    printf("\n  Looping back %u buffers of %u samples, %u transfers in "
+           "flight...\n", config.count, config.buffer_size,
+           config.num_transfers);
+
+    status = bladerf_fw_loopback_bench(state->dev, &config, &results);
+    if (status != 0) {
+        state->last_lib_error = status;
+        return CLI_RET_LIBBLADERF;
+    }
+
+    printf("\n  Throughput:    %.1f MB/s (%" PRIu64 " bytes)\n",
+           results.throughput / 1e6, results.bytes);
+    printf("  Latency (us):  min %.0f, p50 %.0f, p90 %.0f, p99 %.0f, "
+           "max %.0f\n", results.latency_min, results.latency_p50,
+           results.latency_p90, results.latency_p99, results.latency_max);
+    printf("  Out of sequence buffers: %" PRIu64 "\n\n", results.errors);
+
+    return CLI_RET_OK;
+}
@@ -28,6 +28,7 @@
 #include <sys/types.h>
 
 #include "cmd.h"
+#include "cmd/array.h"
 #include "cmd/rxtx.h"
 #include "input.h"
 #include "script.h"
@@ -99,6 +100,7 @@ struct cli_state *cli_state_create()
         cli_state->dev            = NULL;
         cli_state->last_lib_error = 0;
         cli_state->scripts        = NULL;
+        cli_state->array          = NULL;
 
         cli_state->dev_info.fpga_size = BLADERF_FPGA_UNKNOWN;
         cli_state->dev_info.is_bladerf_x40_x115 = false;
@@ -162,6 +164,9 @@ void cli_state_destroy(struct cli_state *s)
             s->tx = NULL;
         }
 
+        array_data_free(s->array);
+        s->array = NULL;
+
         if (s->dev) {
             bladerf_close(s->dev);
         }
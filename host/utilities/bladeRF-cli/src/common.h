@@ -115,6 +115,8 @@ struct cli_state {
 
     struct rxtx_data *rx; /**< Data for sample reception */
     struct rxtx_data *tx; /**< Data for sample transmission */
+
+    struct array_data *array; /**< Devices opened by the array command */
 };
 
 /**
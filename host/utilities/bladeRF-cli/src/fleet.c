@@ -0,0 +1,299 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <libbladeRF.h>
+
+#include "host_config.h"
+#include "fleet.h"
+
+#if BLADERF_OS_WINDOWS
+#include "setenv.h"
+#endif
+
+/* A device being updated, and what has been done to it */
+struct fleet_device {
+    const struct fleet_files *files;
+    struct bladerf_devinfo info;
+    pthread_t thread;
+    bool started;
+
+    const char *step; /* Step that failed, if status != 0 */
+    int status;
+
+    double elapsed;
+    uint32_t blocks_total;
+    uint32_t blocks_updated;
+    uint64_t bytes_written;
+};
+
+/* Serializes progress output, and counts completed devices */
+static pthread_mutex_t fleet_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int fleet_done;
+static unsigned int fleet_count;
+
+static double elapsed_since(const struct timespec *start)
+{
+    struct timespec now;
+
+    if (clock_gettime(CLOCK_REALTIME, &now) != 0) {
+        return 0.0;
+    }
+
+    return (double)(now.tv_sec - start->tv_sec) +
+           (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void fleet_progress(struct fleet_device *d, const char *step,
+                           const struct bladerf_flash_write_stats *stats,
+                           double elapsed)
+{
+    pthread_mutex_lock(&fleet_lock);
+
+    printf("  %s: %s ", d->info.serial, step);
+
+    if (d->status != 0) {
+        printf("FAILED (%s)\n", bladerf_strerror(d->status));
+    } else if (stats != NULL && stats->blocks_total != 0) {
+        printf("OK, %u of %u erase blocks rewritten (%.1f s)\n",
+               stats->blocks_updated, stats->blocks_total, elapsed);
+    } else {
+        printf("OK (%.1f s)\n", elapsed);
+    }
+
+    fflush(stdout);
+    pthread_mutex_unlock(&fleet_lock);
+}
+
+/* Record the outcome of a step begun at `start'. Flash write statistics
+ * are only gathered for steps that write flash. */
+static void fleet_step_done(struct fleet_device *d, struct bladerf *dev,
+                            const char *step, const struct timespec *start,
+                            bool writes_flash)
+{
+    struct bladerf_flash_write_stats stats;
+
+    memset(&stats, 0, sizeof(stats));
+
+    if (d->status != 0) {
+        d->step = step;
+    } else if (writes_flash &&
+               bladerf_get_flash_write_stats(dev, &stats) == 0) {
+        d->blocks_total   += stats.blocks_total;
+        d->blocks_updated += stats.blocks_updated;
+        d->bytes_written  += stats.bytes_written;
+    }
+
+    fleet_progress(d, step, &stats, elapsed_since(start));
+}
+
+static void *fleet_worker(void *arg)
+{
+    struct fleet_device *d = arg;
+    const struct fleet_files *files = d->files;
+    struct bladerf *dev = NULL;
+    struct timespec start, step_start;
+
+    clock_gettime(CLOCK_REALTIME, &start);
+
+    d->status = bladerf_open_with_devinfo(&dev, &d->info);
+    if (d->status != 0) {
+        d->step = "open";
+        fleet_progress(d, "open", NULL, 0.0);
+        goto out;
+    }
+
+    d->status = bladerf_set_flash_write_mode(dev,
+                                             BLADERF_FLASH_WRITE_DIFFERENTIAL);
+    if (d->status != 0) {
+        d->step = "open";
+        fleet_progress(d, "open", NULL, 0.0);
+        goto out;
+    }
+
+    if (files->fw_file != NULL) {
+        clock_gettime(CLOCK_REALTIME, &step_start);
+        d->status = bladerf_flash_firmware(dev, files->fw_file);
+        fleet_step_done(d, dev, "firmware", &step_start, true);
+    }
+
+    if (d->status == 0 && files->flash_fpga_file != NULL) {
+        clock_gettime(CLOCK_REALTIME, &step_start);
+
+        if (!strcmp(files->flash_fpga_file, "X")) {
+            d->status = bladerf_erase_stored_fpga(dev);
+            fleet_step_done(d, dev, "FPGA erase", &step_start, false);
+        } else {
+            d->status = bladerf_flash_fpga(dev, files->flash_fpga_file);
+            fleet_step_done(d, dev, "FPGA flash", &step_start, true);
+        }
+    }
+
+    if (d->status == 0 && files->fpga_file != NULL) {
+        clock_gettime(CLOCK_REALTIME, &step_start);
+        d->status = bladerf_load_fpga(dev, files->fpga_file);
+        fleet_step_done(d, dev, "FPGA load", &step_start, false);
+    }
+
+out:
+    if (dev != NULL) {
+        bladerf_close(dev);
+    }
+
+    d->elapsed = elapsed_since(&start);
+
+    pthread_mutex_lock(&fleet_lock);
+    fleet_done++;
+    printf("  [%u/%u] %s: %s\n", fleet_done, fleet_count, d->info.serial,
+           (d->status == 0) ? "done" : "FAILED");
+    fflush(stdout);
+    pthread_mutex_unlock(&fleet_lock);
+
+    return NULL;
+}
+
+static void fleet_report(const struct fleet_device *devs, unsigned int n,
+                         double elapsed)
+{
+    unsigned int i, num_ok = 0;
+    uint32_t blocks_total = 0, blocks_updated = 0;
+    uint64_t bytes_written = 0;
+
+    printf("\n  %-32s  %-8s  %-9s  %s\n", "Serial", "Result", "Blocks",
+           "Time");
+
+    for (i = 0; i < n; i++) {
+        const struct fleet_device *d = &devs[i];
+
+        if (d->status == 0) {
+            num_ok++;
+            printf("  %-32s  %-8s  %4u/%-4u  %.1f s\n", d->info.serial, "OK",
+                   d->blocks_updated, d->blocks_total, d->elapsed);
+        } else {
+            printf("  %-32s  %-8s  %-9s  %.1f s (%s: %s)\n", d->info.serial,
+                   "FAILED", "-", d->elapsed, d->step ? d->step : "start",
+                   bladerf_strerror(d->status));
+        }
+
+        blocks_total   += d->blocks_total;
+        blocks_updated += d->blocks_updated;
+        bytes_written  += d->bytes_written;
+    }
+
+    printf("\n  Updated %u of %u device(s) in %.1f s.\n", num_ok, n, elapsed);
+
+    if (blocks_total != 0) {
+        printf("  Rewrote %u of %u erase blocks, %" PRIu64 " bytes; "
+               "%u unchanged blocks were skipped.\n",
+               blocks_updated, blocks_total, bytes_written,
+               blocks_total - blocks_updated);
+    }
+
+    printf("\n");
+}
+
+int fleet_update(const struct fleet_files *files)
+{
+    struct bladerf_devinfo *list = NULL;
+    struct fleet_device *devs = NULL;
+    struct timespec start;
+    bool unset_env = false;
+    unsigned int i, n;
+    int status;
+
+    status = bladerf_get_device_list(&list);
+    if (status == BLADERF_ERR_NODEV) {
+        fprintf(stderr, "\nNo bladeRF device(s) available.\n\n");
+        return status;
+    } else if (status < 0) {
+        fprintf(stderr, "Failed to find devices: %s\n",
+                bladerf_strerror(status));
+        return status;
+    }
+
+    n = (unsigned int)status;
+    status = 0;
+
+    devs = calloc(n, sizeof(devs[0]));
+    if (devs == NULL) {
+        bladerf_free_device_list(list);
+        return BLADERF_ERR_MEM;
+    }
+
+    /* As with -f and -L on a single device, the FPGA need not be loaded and
+     * the device initialized just to write flash */
+    if (files->fpga_file == NULL && !getenv("BLADERF_FORCE_NO_FPGA_PRESENT")) {
+        if (setenv("BLADERF_FORCE_NO_FPGA_PRESENT", "true", 0) != 0) {
+            fprintf(stderr, "Failed to setenv: %s\n", strerror(errno));
+        } else {
+            unset_env = true;
+        }
+    }
+
+    printf("\n  Updating %u device(s)...\n\n", n);
+
+    fleet_done  = 0;
+    fleet_count = n;
+
+    clock_gettime(CLOCK_REALTIME, &start);
+
+    for (i = 0; i < n; i++) {
+        devs[i].files = files;
+        devs[i].info  = list[i];
+
+        status = pthread_create(&devs[i].thread, NULL, fleet_worker,
+                                &devs[i]);
+        if (status != 0) {
+            devs[i].step   = "start";
+            devs[i].status = BLADERF_ERR_UNEXPECTED;
+        } else {
+            devs[i].started = true;
+        }
+    }
+
+    status = 0;
+
+    for (i = 0; i < n; i++) {
+        if (devs[i].started) {
+            pthread_join(devs[i].thread, NULL);
+        }
+
+        if (devs[i].status != 0) {
+            status = devs[i].status;
+        }
+    }
+
+    fleet_report(devs, n, elapsed_since(&start));
+
+    if (unset_env) {
+        unsetenv("BLADERF_FORCE_NO_FPGA_PRESENT");
+    }
+
+    free(devs);
+    bladerf_free_device_list(list);
+
+    return status;
+}
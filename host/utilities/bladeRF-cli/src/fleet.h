@@ -0,0 +1,44 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef FLEET_H__
+#define FLEET_H__
+
+/* Files to apply to every attached device. NULL entries are skipped. */
+struct fleet_files {
+    const char *fw_file;         /**< FX3 firmware to write to flash */
+    const char *flash_fpga_file; /**< FPGA bitstream to write to flash, or
+                                  *   "X" to disable autoloading */
+    const char *fpga_file;       /**< FPGA bitstream to load */
+};
+
+/**
+ * Update every attached device concurrently, one thread per device
+ *
+ * Flash is written in differential mode, so only erase blocks that differ
+ * are rewritten, and is verified as it is written. A line is printed as each
+ * device completes each step, followed by a per-device and aggregate report.
+ *
+ * @param[in]   files       Files to apply
+ *
+ * @return 0 if every device was updated, non-zero otherwise
+ */
+int fleet_update(const struct fleet_files *files);
+
+#endif
@@ -0,0 +1,434 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_config.h"
+
+#include "cmd.h"
+#include "daemon.h"
+#include "input_impl.h"
+#include "script.h"
+
+#if BLADERF_OS_WINDOWS
+int daemon_run(struct cli_state *s, const char *path)
+{
+    cli_err(s, "Error", "Daemon mode is not supported on this platform.\n");
+    return CLI_RET_UNKNOWN;
+}
+
+int daemon_client(const char *path, struct str_queue *exec_list,
+                  const char *script, bool interactive)
+{
+    fprintf(stderr, "Error: Daemon mode is not supported on this "
+                    "platform.\n");
+    return 1;
+}
+#else
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/* Marks the end of each reply's output */
+#define REPLY_END '\0'
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void daemon_signal(int signal)
+{
+    stop_requested = 1;
+}
+
+static int set_address(struct sockaddr_un *addr, const char *path)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+
+    if (strlen(path) >= sizeof(addr->sun_path)) {
+        return -1;
+    }
+
+    strcpy(addr->sun_path, path);
+    return 0;
+}
+
+/* Write all of a buffer, despite signals and partial writes */
+static int write_all(int fd, const char *buf, size_t len)
+{
+    ssize_t n;
+
+    while (len > 0) {
+        n = write(fd, buf, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0) {
+            return -1;
+        }
+
+        buf += n;
+        len -= (size_t)n;
+    }
+
+    return 0;
+}
+
+static int exec_script(struct cli_state *s);
+
+/* Execute each of a line's commands, stopping at the first error */
+static int exec_line(struct cli_state *s, char *line)
+{
+    char *next_cmd = line;
+    char *cmd;
+    const char *error;
+    int status = 0;
+
+    do {
+        cmd      = next_cmd;
+        next_cmd = input_split_command(cmd);
+
+        status = cmd_handle(s, cmd);
+
+        if (status < 0 && status != CLI_RET_QUIT) {
+            error = cli_strerror(status, s->last_lib_error);
+            if (error) {
+                cli_err(s, "Error", "%s\n", error);
+            }
+        } else if (status == CLI_RET_RUN_SCRIPT) {
+            /* Any error was reported by the script's own line */
+            status = exec_script(s);
+        } else if (status == CLI_RET_CLEAR_TERM) {
+            status = 0;
+        }
+    } while (next_cmd != NULL && status == 0);
+
+    return status;
+}
+
+/* Execute a script opened by the "run" command, then close it */
+static int exec_script(struct cli_state *s)
+{
+    char line[CLI_MAX_LINE_LEN + 1];
+    char *eol;
+    int status = 0;
+
+    while (status == 0 && fgets(line, sizeof(line), cli_script_file(
+                                                        s->scripts))) {
+        cli_script_bump_line_count(s->scripts);
+
+        if ((eol = strchr(line, '\r')) || (eol = strchr(line, '\n'))) {
+            *eol = '\0';
+        }
+
+        status = exec_line(s, line);
+    }
+
+    if (cli_close_script(&s->scripts) < 0) {
+        cli_err(s, "Error", "Failed to close script.\n");
+    }
+
+    /* The client's connection stays open */
+    return (status == CLI_RET_QUIT) ? 0 : status;
+}
+
+/* Execute a line with stdout and stderr sent to the client */
+static int exec_redirected(struct cli_state *s, int fd, char *line)
+{
+    int saved_out, saved_err;
+    int status;
+
+    fflush(stdout);
+    fflush(stderr);
+
+    saved_out = dup(STDOUT_FILENO);
+    saved_err = dup(STDERR_FILENO);
+    if (saved_out < 0 || saved_err < 0 || dup2(fd, STDOUT_FILENO) < 0 ||
+        dup2(fd, STDERR_FILENO) < 0) {
+        status = CLI_RET_UNKNOWN;
+    } else {
+        status = exec_line(s, line);
+        fflush(stdout);
+        fflush(stderr);
+    }
+
+    if (saved_out >= 0) {
+        dup2(saved_out, STDOUT_FILENO);
+        close(saved_out);
+    }
+
+    if (saved_err >= 0) {
+        dup2(saved_err, STDERR_FILENO);
+        close(saved_err);
+    }
+
+    return status;
+}
+
+/* Serve one client until it disconnects or quits */
+static void serve_client(struct cli_state *s, int fd)
+{
+    FILE *in = fdopen(fd, "r");
+    char *line = NULL;
+    size_t line_size = 0;
+    char reply[16];
+    char *eol;
+    int status = 0;
+    int len;
+
+    if (in == NULL) {
+        close(fd);
+        return;
+    }
+
+    while (status != CLI_RET_QUIT && !stop_requested &&
+           getline(&line, &line_size, in) >= 0) {
+        if ((eol = strchr(line, '\r')) || (eol = strchr(line, '\n'))) {
+            *eol = '\0';
+        }
+
+        status = exec_redirected(s, fd, line);
+
+        len = snprintf(reply, sizeof(reply), "%c%d\n", REPLY_END, status);
+        if (write_all(fd, reply, (size_t)len) != 0 || cli_fatal(status)) {
+            break;
+        }
+    }
+
+    free(line);
+    fclose(in);
+}
+
+/* Bind to the socket path, replacing a socket that no daemon is using */
+static int listen_at(const char *path)
+{
+    struct sockaddr_un addr;
+    struct stat st;
+    int fd, probe;
+    mode_t mask;
+
+    if (set_address(&addr, path) != 0) {
+        fprintf(stderr, "Error: Socket path is too long: %s\n", path);
+        return -1;
+    }
+
+    if (stat(path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+        probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (probe >= 0 &&
+            connect(probe, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+            close(probe);
+            fprintf(stderr, "Error: A daemon is already running at %s\n",
+                    path);
+            return -1;
+        }
+
+        if (probe >= 0) {
+            close(probe);
+        }
+        unlink(path);
+    }
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    /* Only the daemon's user may connect */
+    mask = umask(0077);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        umask(mask);
+        fprintf(stderr, "Error: Failed to bind to %s: %s\n", path,
+                strerror(errno));
+        close(fd);
+        return -1;
+    }
+    umask(mask);
+
+    if (listen(fd, 4) != 0) {
+        perror("listen");
+        close(fd);
+        unlink(path);
+        return -1;
+    }
+
+    return fd;
+}
+
+int daemon_run(struct cli_state *s, const char *path)
+{
+    struct sigaction sa;
+    int fd, client;
+
+    fd = listen_at(path);
+    if (fd < 0) {
+        return CLI_RET_FILEOP;
+    }
+
+    /* Without SA_RESTART, so that accept() is interrupted */
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = daemon_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    /* A client that disconnects mid-reply must not end the daemon */
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("Accepting commands at %s\n", path);
+    fflush(stdout);
+
+    while (!stop_requested) {
+        client = accept(fd, NULL, NULL);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+
+            perror("accept");
+            break;
+        }
+
+        serve_client(s, client);
+    }
+
+    close(fd);
+    unlink(path);
+
+    return 0;
+}
+
+/* Send a line, and print the reply's output. Returns the line's status. */
+static int client_exec(int fd, FILE *in, const char *line)
+{
+    int c, status;
+
+    if (write_all(fd, line, strlen(line)) != 0 || write_all(fd, "\n", 1)) {
+        perror("Error: Failed to send command");
+        return CLI_RET_UNKNOWN;
+    }
+
+    while ((c = getc(in)) != EOF && c != REPLY_END) {
+        putchar(c);
+    }
+
+    if (c == EOF || fscanf(in, "%d", &status) != 1 || getc(in) != '\n') {
+        fflush(stdout);
+        fprintf(stderr, "Error: Lost connection to the daemon.\n");
+        return CLI_RET_UNKNOWN;
+    }
+
+    fflush(stdout);
+    return status;
+}
+
+/* Send each line of a file. Returns the first failing status. */
+static int client_exec_file(int fd, FILE *in, FILE *f, bool prompt)
+{
+    char line[CLI_MAX_LINE_LEN + 1];
+    char *eol;
+    int status = 0;
+
+    while (status == 0) {
+        if (prompt) {
+            fputs(CLI_DEFAULT_PROMPT, stdout);
+            fflush(stdout);
+        }
+
+        if (fgets(line, sizeof(line), f) == NULL) {
+            break;
+        }
+
+        if ((eol = strchr(line, '\r')) || (eol = strchr(line, '\n'))) {
+            *eol = '\0';
+        }
+
+        status = client_exec(fd, in, line);
+
+        /* At a prompt, carry on after an error, as interactive mode does */
+        if (prompt && status != CLI_RET_UNKNOWN && status != CLI_RET_QUIT) {
+            status = 0;
+        }
+    }
+
+    return status;
+}
+
+int daemon_client(const char *path, struct str_queue *exec_list,
+                  const char *script, bool interactive)
+{
+    struct sockaddr_un addr;
+    FILE *in, *f;
+    char *line;
+    int fd;
+    int status = 0;
+
+    if (set_address(&addr, path) != 0) {
+        fprintf(stderr, "Error: Socket path is too long: %s\n", path);
+        return 1;
+    }
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        fprintf(stderr, "Error: Failed to connect to a daemon at %s: %s\n",
+                path, strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        return 1;
+    }
+
+    in = fdopen(fd, "r");
+    if (in == NULL) {
+        close(fd);
+        return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+
+    while (status == 0 && !str_queue_empty(exec_list)) {
+        line   = str_queue_deq(exec_list);
+        status = client_exec(fd, in, line);
+        free(line);
+    }
+
+    if (status == 0 && script != NULL) {
+        f = fopen(script, "r");
+        if (f == NULL) {
+            fprintf(stderr, "Failed to open script file \"%s\": %s\n",
+                    script, strerror(errno));
+            status = CLI_RET_NOFILE;
+        } else {
+            status = client_exec_file(fd, in, f, false);
+            fclose(f);
+        }
+    }
+
+    if (status == 0 && interactive) {
+        status = client_exec_file(fd, in, stdin, isatty(STDIN_FILENO));
+    }
+
+    /* Stop at the first error, as a script run locally would */
+    fclose(in);
+    return (status == 0 || status == CLI_RET_QUIT) ? 0 : 1;
+}
+#endif
@@ -0,0 +1,67 @@
+/**
+ * @file daemon.h
+ *
+ * @brief Persistent command server, and its client
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef DAEMON_H__
+#define DAEMON_H__
+
+#include "common.h"
+#include "str_queue.h"
+
+/*
+ * Commands are sent to the daemon over a local (UNIX-domain) stream socket,
+ * one line at a time, in the same syntax as interactive mode, including ';'
+ * separators. For each line, the daemon replies with the commands' output,
+ * followed by a NUL byte, the CLI_RET_* status of the line as a decimal
+ * number, and '\n'.
+ */
+
+/**
+ * Hold the device open and execute commands received on a local socket,
+ * until SIGINT or SIGTERM is caught. Clients are served one at a time.
+ *
+ * @param   s       CLI state, with the device open and tasks started
+ * @param   path    Socket path. A stale socket left at this path is
+ *                  replaced.
+ *
+ * @return 0 on success, CLI_RET_* on failure
+ */
+int daemon_run(struct cli_state *s, const char *path);
+
+/**
+ * Execute commands in a running daemon, printing their output
+ *
+ * Commands from `exec_list' are sent first, then those from `script', if
+ * not NULL, then lines from stdin if `interactive' is set. Execution stops
+ * at the first command that fails.
+ *
+ * @param   path        Socket path of the daemon
+ * @param   exec_list   Commands to execute
+ * @param   script      Script file to execute. May be NULL.
+ * @param   interactive Read commands from stdin after the others
+ *
+ * @return 0 if all commands succeeded, 1 otherwise
+ */
+int daemon_client(const char *path, struct str_queue *exec_list,
+                  const char *script, bool interactive);
+
+#endif
@@ -50,11 +50,7 @@ static void exit_script(struct cli_state *s)
     }
 }
 
-/* Terminate the current command, as denoted by any delmiters,  with a '\0' and
- * return a pointer to the next command.
- *
- * Returns NULL if the end of the line was hit */
-static inline char * zeroize_next_delimiter(char *line)
+char * input_split_command(char *line)
 {
     size_t len, i;
     char * next_cmd = NULL;
@@ -152,7 +148,7 @@ int input_loop(struct cli_state *s, bool interactive)
 
             do {
                 cmd = next_cmd;
-                next_cmd = zeroize_next_delimiter(cmd);
+                next_cmd = input_split_command(cmd);
 
 				status = cmd_handle(s, cmd);
 
@@ -82,6 +82,16 @@ char * input_get_line(const char *prompt);
  */
 int input_set_input(FILE *input);
 
+/**
+ * Terminate the current command of a line, as denoted by any delimiters,
+ * with a '\0', and return a pointer to the next command.
+ *
+ * @param   line    Line, which is modified
+ *
+ * @return next command, or NULL if the end of the line was hit
+ */
+char * input_split_command(char *line);
+
 /**
  * Clear the terminal
  */
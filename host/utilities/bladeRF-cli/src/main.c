@@ -26,23 +26,26 @@
 #include <pthread.h>
 #include <string.h>
 #include <libbladeRF.h>
+#include "input/daemon.h"
 #include "input/input.h"
 #include "str_queue.h"
 #include "script.h"
 #include "common.h"
 #include "cmd.h"
+#include "fleet.h"
 #include "version.h"
 
 #if BLADERF_OS_WINDOWS
 #include "setenv.h"
 #endif
 
-#define OPTSTR "e:L:d:f:l:s:ipv:h"
+#define OPTSTR "e:L:d:f:l:s:aipv:h"
 
 static const struct option longopts[] = {
     { "exec",               required_argument,  0, 'e' },
     { "flash-fpga",         required_argument,  0, 'L' },
     { "device",             required_argument,  0, 'd' },
+    { "all-devices",        no_argument,        0, 'a' },
     { "flash-firmware",     required_argument,  0, 'f' },
     { "load-fpga",          required_argument,  0, 'l' },
     { "script",             required_argument,  0, 's' },
@@ -53,6 +56,8 @@ static const struct option longopts[] = {
     { "version",            no_argument,        0,  2  },
     { "help",               no_argument,        0, 'h' },
     { "help-interactive",   no_argument,        0,  3  },
+    { "daemon",             required_argument,  0,  4  },
+    { "connect",            required_argument,  0,  5  },
     { 0,                    0,                  0,  0  },
 };
 
@@ -62,6 +67,7 @@ struct rc_config {
     bool flash_fw;
     bool flash_fpga;
     bool load_fpga;
+    bool all_devices;
     bool probe;
     bool show_help;
     bool show_help_interactive;
@@ -76,6 +82,8 @@ struct rc_config {
     char *flash_fpga_file;
     char *fpga_file;
     char *script_file;
+    char *daemon_path;
+    char *connect_path;
 };
 
 static void init_rc_config(struct rc_config *rc)
@@ -84,6 +92,7 @@ static void init_rc_config(struct rc_config *rc)
     rc->flash_fw              = false;
     rc->flash_fpga            = false;
     rc->load_fpga             = false;
+    rc->all_devices           = false;
     rc->probe                 = false;
     rc->show_help             = false;
     rc->show_help_interactive = false;
@@ -98,6 +107,8 @@ static void init_rc_config(struct rc_config *rc)
     rc->flash_fpga_file = NULL;
     rc->fpga_file       = NULL;
     rc->script_file     = NULL;
+    rc->daemon_path     = NULL;
+    rc->connect_path    = NULL;
 }
 
 static void deinit_rc_config(struct rc_config *rc)
@@ -107,6 +118,8 @@ static void deinit_rc_config(struct rc_config *rc)
     free(rc->flash_fpga_file);
     free(rc->fpga_file);
     free(rc->script_file);
+    free(rc->daemon_path);
+    free(rc->connect_path);
 }
 
 /* Fetch runtime-configuration info
@@ -196,6 +209,10 @@ int get_rc_config(int argc, char *argv[], struct rc_config *rc,
                 }
                 break;
 
+            case 'a':
+                rc->all_devices = true;
+                break;
+
             case 'i':
                 rc->interactive_mode = true;
                 break;
@@ -239,6 +256,23 @@ int get_rc_config(int argc, char *argv[], struct rc_config *rc,
                 rc->show_help_interactive = true;
                 break;
 
+            case 4:
+            case 5: {
+                char **path = (c == 4) ? &rc->daemon_path : &rc->connect_path;
+
+                if (*path != NULL) {
+                    fprintf(stderr, "Error: Socket path specified more "
+                            "than once.\n");
+                    return -1;
+                }
+
+                *path = strdup(optarg);
+                if (!*path) {
+                    perror("strdup");
+                    return -1;
+                }
+            } break;
+
             default:
                 return -1;
         }
@@ -255,6 +289,9 @@ void usage(const char *argv0)
     printf("bladeRF command line interface and test utility (" BLADERF_CLI_VERSION ")\n\n");
     printf("Options:\n");
     printf("  -d, --device <device>            Use the specified bladeRF device.\n");
+    printf("  -a, --all-devices                Apply -f, -L, and -l to all attached devices\n");
+    printf("                                   in parallel, then exit. Flash is written\n");
+    printf("                                   differentially and verified.\n");
     printf("  -f, --flash-firmware <file>      Write the provided FX3 firmware file to flash.\n");
     printf("  -l, --load-fpga <file>           Load the provided FPGA bitstream.\n");
     printf("  -L, --flash-fpga <file>          Write the provided FPGA image to flash for\n");
@@ -277,6 +314,11 @@ void usage(const char *argv0)
     printf("  -h, --help                       Show this help text.\n");
     printf("      --help-interactive           Print help information for all interactive\n");
     printf("                                   commands.\n");
+    printf("      --daemon <socket>            Keep the device open, and execute commands\n");
+    printf("                                   received on the given local socket (after\n");
+    printf("                                   any -e and -s commands) until signalled.\n");
+    printf("      --connect <socket>           Send -e, -s, and -i commands to a daemon,\n");
+    printf("                                   rather than opening a device.\n");
     printf("\n");
     printf("Notes:\n");
     printf("  The -d option takes a device specifier string. See the bladerf_open()\n");
@@ -289,6 +331,12 @@ void usage(const char *argv0)
     printf("  Commands are executed in the following order:\n");
     printf("    Command line options, -e <command>, script commands, interactive mode commands.\n");
     printf("\n");
+    printf("  A daemon serves one client at a time, and replies to each line with its\n");
+    printf("  output, a NUL byte, and the line's status (0 on success) and a newline.\n");
+    printf("  For example:\n");
+    printf("    %s -d '*:serial=f12ce1' --daemon /tmp/bladerf.sock &\n", argv0);
+    printf("    %s --connect /tmp/bladerf.sock -e 'set frequency rx 915M'\n", argv0);
+    printf("\n");
     printf("  When running 'rx/tx start' from a script or via -e, ensure these commands\n");
     printf("  are later followed by 'rx/tx wait [timeout]' to ensure the program will\n");
     printf("  not attempt to exit before reception/transmission is complete.\n");
@@ -530,6 +578,35 @@ int main(int argc, char *argv[])
         exit_immediately = true;
     } else if (rc.probe) {
         status           = cmd_handle(state, "probe strict");
+        exit_immediately = true;
+    } else if (rc.connect_path) {
+        /* The daemon already has the device open */
+        status = daemon_client(rc.connect_path, &exec_list, rc.script_file,
+                               rc.interactive_mode);
+        exit_immediately = true;
+    } else if (rc.daemon_path && rc.interactive_mode) {
+        fprintf(stderr, "Error: --daemon and -i may not be used together.\n");
+        status           = 1;
+        exit_immediately = true;
+    }
+
+    if (!exit_immediately && rc.all_devices) {
+        struct fleet_files files;
+
+        if (rc.device != NULL) {
+            fprintf(stderr, "Error: -a and -d may not be used together.\n");
+            status = 1;
+        } else if (!rc.fw_file && !rc.flash_fpga_file && !rc.fpga_file) {
+            fprintf(stderr, "Error: -a requires -f, -L, or -l.\n");
+            status = 1;
+        } else {
+            files.fw_file         = rc.fw_file;
+            files.flash_fpga_file = rc.flash_fpga_file;
+            files.fpga_file       = rc.fpga_file;
+
+            status = fleet_update(&files) == 0 ? 0 : 1;
+        }
+
         exit_immediately = true;
     }
 
@@ -582,7 +659,17 @@ int main(int argc, char *argv[])
         /* Drop into interactive mode or begin executing commands from a
          * command-line list or a script. If we're not requested to do either,
          * exit cleanly */
-        if (!str_queue_empty(&exec_list) || rc.interactive_mode ||
+        if (rc.daemon_path) {
+            status = cli_start_tasks(state);
+            if (status == 0 && (!str_queue_empty(&exec_list) ||
+                                cli_script_loaded(state->scripts))) {
+                status = input_loop(state, false);
+            }
+
+            if (status == 0) {
+                status = daemon_run(state, rc.daemon_path);
+            }
+        } else if (!str_queue_empty(&exec_list) || rc.interactive_mode ||
             cli_script_loaded(state->scripts)) {
             status = cli_start_tasks(state);
             if (status == 0) {
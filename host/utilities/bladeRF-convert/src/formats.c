@@ -0,0 +1,302 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <string.h>
+#include <strings.h>
+
+#include "formats.h"
+
+/* Magnitude beyond which digits stop accumulating. Anything this large is
+ * clamped anyway, and this keeps the accumulator from overflowing. */
+#define VALUE_SATURATE 1000000
+
+const struct file_format formats[] = {
+    {
+        "sc16q11",
+        "SC16 Q11, little-endian (bladeRF-cli \"bin\")",
+        BLADERF_FORMAT_SC16_Q11, 2 * sizeof(int16_t), false, false,
+        "ci16_le",
+    },
+    {
+        "sc16q11be",
+        "SC16 Q11, big-endian",
+        BLADERF_FORMAT_SC16_Q11, 2 * sizeof(int16_t), true, false,
+        "ci16_be",
+    },
+    {
+        "cf32",
+        "Complex float, little-endian, full scale +/-1.0",
+        BLADERF_FORMAT_CF32, 2 * sizeof(float), false, false,
+        "cf32_le",
+    },
+    {
+        "cs8",
+        "Complex signed 8-bit (SC8 Q7)",
+        BLADERF_FORMAT_SC8_Q7, 2 * sizeof(int8_t), false, false,
+        "ci8",
+    },
+    {
+        "csv",
+        "SC16 Q11 values as text, one line per sample time",
+        BLADERF_FORMAT_SC16_Q11, 0, false, true,
+        NULL,
+    },
+};
+
+const size_t num_formats = sizeof(formats) / sizeof(formats[0]);
+
+static const struct {
+    const char *ext;
+    const char *format;
+} extensions[] = {
+    { ".bin", "sc16q11" },
+    { ".sc16", "sc16q11" },
+    { ".sc16q11", "sc16q11" },
+    { ".cf32", "cf32" },
+    { ".fc32", "cf32" },
+    { ".cfile", "cf32" },
+    { ".cs8", "cs8" },
+    { ".sc8", "cs8" },
+    { ".csv", "csv" },
+};
+
+const struct file_format *format_lookup(const char *name)
+{
+    size_t i;
+
+    for (i = 0; i < num_formats; i++) {
+        if (!strcasecmp(name, formats[i].name)) {
+            return &formats[i];
+        }
+    }
+
+    if (!strcasecmp(name, "bin")) {
+        return &formats[0];
+    }
+
+    return NULL;
+}
+
+const struct file_format *format_lookup_sigmf(const char *datatype)
+{
+    size_t i;
+
+    for (i = 0; i < num_formats; i++) {
+        if (formats[i].sigmf_datatype != NULL &&
+            !strcmp(datatype, formats[i].sigmf_datatype)) {
+            return &formats[i];
+        }
+    }
+
+    return NULL;
+}
+
+const struct file_format *format_from_extension(const char *path)
+{
+    const size_t len = strlen(path);
+    size_t i, ext_len;
+
+    for (i = 0; i < sizeof(extensions) / sizeof(extensions[0]); i++) {
+        ext_len = strlen(extensions[i].ext);
+        if (len > ext_len &&
+            !strcasecmp(path + len - ext_len, extensions[i].ext)) {
+            return format_lookup(extensions[i].format);
+        }
+    }
+
+    return NULL;
+}
+
+static inline bool is_delim(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == ',' || c == ';';
+}
+
+static inline int hex_digit(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+/* Parse one line, excluding its '\n'. Returns the number of values parsed,
+ * or -1 on error. */
+static long parse_line(const char *p,
+                       const char *end,
+                       int16_t *values,
+                       struct csv_parse_result *result)
+{
+    long n = 0;
+
+    while (p < end) {
+        bool neg  = false;
+        long value = 0;
+        int base  = 10, d;
+        const char *digits;
+
+        if (is_delim(*p)) {
+            p++;
+            continue;
+        }
+
+        if (*p == '-' || *p == '+') {
+            neg = (*p == '-');
+            p++;
+        }
+
+        if (end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+            base = 16;
+            p += 2;
+        }
+
+        for (digits = p; p < end; p++) {
+            d = (base == 16) ? hex_digit(*p) : (*p - '0');
+            if (d < 0 || d >= base) {
+                break;
+            }
+
+            if (value < VALUE_SATURATE) {
+                value = value * base + d;
+            }
+        }
+
+        /* A value must have digits and end at a delimiter */
+        if (p == digits || (p < end && !is_delim(*p))) {
+            return -1;
+        }
+
+        if (neg) {
+            value = -value;
+        }
+
+        if (value < CSV_VALUE_MIN) {
+            value = CSV_VALUE_MIN;
+            result->clamped++;
+        } else if (value > CSV_VALUE_MAX) {
+            value = CSV_VALUE_MAX;
+            result->clamped++;
+        }
+
+        values[n++] = (int16_t)value;
+    }
+
+    if (n % 2 != 0) {
+        result->odd_cols = true;
+        result->cols     = (unsigned int)n;
+        return -1;
+    }
+
+    return n;
+}
+
+bool csv_parse(const char *text,
+               size_t len,
+               int16_t *samples,
+               size_t *n_samples,
+               struct csv_parse_result *result)
+{
+    const char *p   = text;
+    const char *end = text + len;
+    size_t n_values = 0;
+    const char *eol;
+    long n;
+
+    memset(result, 0, sizeof(*result));
+
+    while (p < end) {
+        eol = memchr(p, '\n', (size_t)(end - p));
+        if (eol == NULL) {
+            eol = end;
+        }
+
+        n = parse_line(p, eol, samples + n_values, result);
+        if (n < 0) {
+            *n_samples = n_values / 2;
+            return false;
+        }
+
+        n_values += (size_t)n;
+        result->lines++;
+        p = eol + 1;
+    }
+
+    *n_samples = n_values / 2;
+    return true;
+}
+
+static inline char *format_int(char *out, int value)
+{
+    char digits[8];
+    unsigned int v;
+    int n = 0;
+
+    if (value < 0) {
+        *out++ = '-';
+        v      = (unsigned int)(-(long)value);
+    } else {
+        v = (unsigned int)value;
+    }
+
+    do {
+        digits[n++] = (char)('0' + (v % 10));
+        v /= 10;
+    } while (v != 0);
+
+    while (n > 0) {
+        *out++ = digits[--n];
+    }
+
+    return out;
+}
+
+size_t csv_format(char *out,
+                  const int16_t *samples,
+                  size_t n_samples,
+                  unsigned int nchans)
+{
+    char *p = out;
+    size_t i;
+    unsigned int c;
+
+    for (i = 0; i + nchans <= n_samples; i += nchans) {
+        for (c = 0; c < nchans; c++) {
+            if (c != 0) {
+                *p++ = ',';
+                *p++ = ' ';
+            }
+
+            p    = format_int(p, samples[0]);
+            *p++ = ',';
+            *p++ = ' ';
+            p    = format_int(p, samples[1]);
+
+            samples += 2;
+        }
+
+        *p++ = '\n';
+    }
+
+    return (size_t)(p - out);
+}
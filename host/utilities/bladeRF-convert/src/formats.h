@@ -0,0 +1,141 @@
+/**
+ * @file formats.h
+ *
+ * @brief Sample file formats, and conversion of blocks of samples between
+ *        them
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef FORMATS_H__
+#define FORMATS_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+/* Range of CSV values, which are SC16 Q11 values */
+#define CSV_VALUE_MIN (-2048)
+#define CSV_VALUE_MAX 2047
+
+/* Most characters a single I,Q pair occupies in CSV output, including the
+ * following separator or line ending: "-32768, -32768, " */
+#define CSV_MAX_SAMPLE_CHARS 16
+
+/* Fewest characters a single I,Q pair occupies in CSV input: "0,0\n" */
+#define CSV_MIN_SAMPLE_CHARS 4
+
+struct file_format {
+    const char *name;
+    const char *description;
+
+    /* Format of the samples, once in memory. CSV values are read into, and
+     * written from, SC16 Q11 samples. */
+    bladerf_format samples;
+
+    /* Size of each sample in the file, or 0 for CSV */
+    size_t sample_size;
+
+    bool big_endian; /* SC16 Q11 values are stored big-endian */
+    bool text;       /* One line of CSV values per sample time */
+
+    /* SigMF core:datatype of the format, or NULL */
+    const char *sigmf_datatype;
+};
+
+extern const struct file_format formats[];
+extern const size_t num_formats;
+
+/**
+ * Look up a format by name
+ *
+ * @param[in]   name    Format name, case-insensitive
+ *
+ * @return format, or NULL if not found
+ */
+const struct file_format *format_lookup(const char *name);
+
+/**
+ * Look up a format by its SigMF core:datatype
+ *
+ * @param[in]   datatype    SigMF datatype (e.g., "ci16_le")
+ *
+ * @return format, or NULL if it is not supported
+ */
+const struct file_format *format_lookup_sigmf(const char *datatype);
+
+/**
+ * Select a format based upon a file name's extension
+ *
+ * @param[in]   path    File name
+ *
+ * @return format, or NULL if the extension is not recognized
+ */
+const struct file_format *format_from_extension(const char *path);
+
+/* Counts reported by csv_parse() */
+struct csv_parse_result {
+    uint64_t lines;     /* Lines parsed */
+    uint64_t clamped;   /* Values clamped to [CSV_VALUE_MIN, CSV_VALUE_MAX] */
+    unsigned int cols;  /* Value count of the failing line, if odd_cols */
+    bool odd_cols;      /* Parsing failed on an odd number of values */
+};
+
+/**
+ * Parse CSV text into SC16 Q11 samples. Lines hold any number of I,Q value
+ * pairs, which are appended in order. Values may be separated by any of
+ * " \t\r,;" and may be given in hexadecimal with a 0x prefix. Empty lines
+ * are ignored.
+ *
+ * @param[in]   text        Text to parse
+ * @param[in]   len         Length of `text`. This should end on a line
+ *                          boundary, or at the end of the file.
+ * @param[out]  samples     Parsed samples. This must have room for at least
+ *                          len / CSV_MIN_SAMPLE_CHARS + 1 samples.
+ * @param[out]  n_samples   Number of samples parsed
+ * @param[out]  result      Line and clamp counts. On failure, `lines` is the
+ *                          number of lines preceding the failing line.
+ *
+ * @return true on success, false on a parse error
+ */
+bool csv_parse(const char *text,
+               size_t len,
+               int16_t *samples,
+               size_t *n_samples,
+               struct csv_parse_result *result);
+
+/**
+ * Format SC16 Q11 samples as CSV, with one line per sample time and an I,Q
+ * column pair per channel
+ *
+ * @param[out]  out         Output buffer. Must have room for at least
+ *                          n_samples * CSV_MAX_SAMPLE_CHARS characters.
+ * @param[in]   samples     Interleaved samples
+ * @param[in]   n_samples   Number of samples, a multiple of `nchans`
+ * @param[in]   nchans      Number of channels
+ *
+ * @return number of characters written. The output is not NUL-terminated.
+ */
+size_t csv_format(char *out,
+                  const int16_t *samples,
+                  size_t n_samples,
+                  unsigned int nchans);
+
+#endif
@@ -0,0 +1,567 @@
+/**
+ * @file
+ * @brief   Sample file format converter
+ *
+ * Converts files of samples between SC16 Q11 (little or big-endian), complex
+ * float, complex signed 8-bit, CSV and SigMF recordings, using the SIMD
+ * sample conversions of libbladeRF. The conversion is spread across worker
+ * threads while the output remains in order, and runs in constant memory
+ * regardless of the size of the file.
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <libbladeRF.h>
+
+#include "conversions.h"
+#include "formats.h"
+#include "pipeline.h"
+
+#define BLADERF_CONVERT_VERSION "0.1.0"
+
+#define DEFAULT_CHUNK_SIZE (4 * 1024 * 1024)
+#define DEFAULT_SIGMF_TYPE "ci16_le"
+#define MAX_THREADS 256
+#define MAX_CHANNELS 16
+
+#define SIGMF_META_EXT ".sigmf-meta"
+#define SIGMF_DATA_EXT ".sigmf-data"
+
+/* Largest SigMF metadata file read */
+#define SIGMF_META_MAX (1024 * 1024)
+
+#define OPTION_SIGMF_TYPE 0x80
+
+struct file {
+    const char *path;               /* Path given on the command line */
+    char *data_path;                /* File holding the samples */
+    char *meta_path;                /* SigMF metadata, or NULL */
+    const struct file_format *format;
+};
+
+struct options {
+    struct file in;
+    struct file out;
+    const char *sigmf_type;
+    unsigned int channels;
+    unsigned int threads;
+    size_t chunk_size;
+    double samplerate;
+    uint64_t frequency;
+    bool verbose;
+};
+
+static struct option long_options[] = {
+    { "from", required_argument, 0, 'f' },
+    { "to", required_argument, 0, 't' },
+    { "sigmf-type", required_argument, 0, OPTION_SIGMF_TYPE },
+    { "channels", required_argument, 0, 'n' },
+    { "threads", required_argument, 0, 'j' },
+    { "chunk-size", required_argument, 0, 'c' },
+    { "samplerate", required_argument, 0, 'r' },
+    { "frequency", required_argument, 0, 'F' },
+    { "verbose", no_argument, 0, 'v' },
+    { "version", no_argument, 0, 'V' },
+    { "help", no_argument, 0, 'h' },
+    { 0, 0, 0, 0 },
+};
+
+static const struct numeric_suffix size_suffixes[] = {
+    { "K", 1024 },
+    { "KiB", 1024 },
+    { "M", 1024 * 1024 },
+    { "MiB", 1024 * 1024 },
+};
+
+static const struct numeric_suffix freq_suffixes[] = {
+    { "K", 1000 },
+    { "k", 1000 },
+    { "M", 1000 * 1000 },
+    { "G", 1000 * 1000 * 1000 },
+};
+
+static void usage(const char *argv0)
+{
+    size_t i;
+
+    printf("Usage: %s [options] <input> <output>\n", argv0);
+    printf("Convert a file of samples from one format to another.\n\n");
+    printf("Formats are determined from the file extensions, unless given:\n");
+    printf("  -f, --from <format>       Input format.\n");
+    printf("  -t, --to <format>         Output format.\n\n");
+
+    for (i = 0; i < num_formats; i++) {
+        printf("    %-12s  %s\n", formats[i].name, formats[i].description);
+    }
+    printf("    %-12s  %s\n", "sigmf",
+           "SigMF recording (.sigmf-meta and .sigmf-data)");
+
+    printf("\nOptions:\n");
+    printf("  --sigmf-type <datatype>   SigMF output datatype. Default: %s\n",
+           DEFAULT_SIGMF_TYPE);
+    printf("  -n, --channels <n>        Channels per CSV line, or recorded in\n"
+           "                            SigMF metadata. Default: 1\n");
+    printf("  -j, --threads <n>         Worker threads. Default: online "
+           "CPUs\n");
+    printf("  -c, --chunk-size <size>   Input bytes converted at a time, per\n"
+           "                            thread. Default: %u MiB\n",
+           DEFAULT_CHUNK_SIZE / (1024 * 1024));
+    printf("  -r, --samplerate <rate>   Sample rate recorded in SigMF "
+           "metadata.\n");
+    printf("  -F, --frequency <freq>    Frequency recorded in SigMF "
+           "metadata.\n");
+    printf("  -v, --verbose             Report progress.\n");
+    printf("  --version                 Print version information.\n");
+    printf("  -h, --help                Show this text.\n\n");
+
+    printf("CSV values are SC16 Q11 values, one I,Q pair per channel per "
+           "line.\n");
+    printf("Values outside of [%d, %d] are clamped.\n", CSV_VALUE_MIN,
+           CSV_VALUE_MAX);
+    printf("A path of - writes to stdout. Input must be a regular file.\n");
+}
+
+static bool has_suffix(const char *str, const char *suffix)
+{
+    const size_t len = strlen(str), suffix_len = strlen(suffix);
+    return len >= suffix_len && !strcmp(str + len - suffix_len, suffix);
+}
+
+/* Return a copy of path, with the extension ext (if present) replaced by
+ * new_ext */
+static char *replace_ext(const char *path, const char *ext, const char *new_ext)
+{
+    size_t len = strlen(path);
+    char *ret;
+
+    if (has_suffix(path, ext)) {
+        len -= strlen(ext);
+    }
+
+    ret = malloc(len + strlen(new_ext) + 1);
+    if (ret != NULL) {
+        memcpy(ret, path, len);
+        strcpy(ret + len, new_ext);
+    }
+
+    return ret;
+}
+
+static bool is_sigmf(const char *format_name, const char *path)
+{
+    if (format_name != NULL) {
+        return !strcasecmp(format_name, "sigmf");
+    }
+
+    return has_suffix(path, SIGMF_META_EXT) || has_suffix(path, SIGMF_DATA_EXT);
+}
+
+/* Find the value of a key in SigMF metadata. This is not a general JSON
+ * parser; it expects each key to appear once, which holds for the core
+ * fields of the global object. */
+static const char *sigmf_find(const char *meta, const char *key)
+{
+    const size_t key_len = strlen(key);
+    const char *p        = meta;
+
+    while ((p = strchr(p, '"')) != NULL) {
+        if (!strncmp(p + 1, key, key_len) && p[key_len + 1] == '"') {
+            p += key_len + 2;
+            p += strspn(p, " \t\r\n");
+            if (*p == ':') {
+                p++;
+                return p + strspn(p, " \t\r\n");
+            }
+        }
+        p++;
+    }
+
+    return NULL;
+}
+
+static int sigmf_read_meta(struct options *opts)
+{
+    const char *value;
+    char datatype[32];
+    char *meta;
+    FILE *f;
+    size_t n, len;
+    int status = -1;
+
+    f = fopen(opts->in.meta_path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "Failed to open %s: %s\n", opts->in.meta_path,
+                strerror(errno));
+        return -1;
+    }
+
+    meta = malloc(SIGMF_META_MAX + 1);
+    if (meta == NULL) {
+        goto out;
+    }
+
+    len       = fread(meta, 1, SIGMF_META_MAX, f);
+    meta[len] = '\0';
+
+    value = sigmf_find(meta, "core:datatype");
+    if (value == NULL || *value != '"') {
+        fprintf(stderr, "%s does not specify core:datatype.\n",
+                opts->in.meta_path);
+        goto out;
+    }
+
+    n = strcspn(value + 1, "\"");
+    if (n >= sizeof(datatype)) {
+        n = sizeof(datatype) - 1;
+    }
+    memcpy(datatype, value + 1, n);
+    datatype[n] = '\0';
+
+    opts->in.format = format_lookup_sigmf(datatype);
+    if (opts->in.format == NULL) {
+        fprintf(stderr, "Unsupported SigMF datatype: %s\n", datatype);
+        goto out;
+    }
+
+    /* Carry these over to SigMF output, unless overridden */
+    value = sigmf_find(meta, "core:sample_rate");
+    if (value != NULL && opts->samplerate == 0) {
+        opts->samplerate = strtod(value, NULL);
+    }
+
+    value = sigmf_find(meta, "core:num_channels");
+    if (value != NULL && opts->channels == 0) {
+        opts->channels = (unsigned int)strtoul(value, NULL, 10);
+    }
+
+    status = 0;
+
+out:
+    free(meta);
+    fclose(f);
+    return status;
+}
+
+static int sigmf_write_meta(const struct options *opts)
+{
+    const char *base = strrchr(opts->in.path, '/');
+    time_t t         = time(NULL);
+    char datetime[32];
+    struct tm tm;
+    FILE *f;
+
+    base = (base == NULL) ? opts->in.path : base + 1;
+
+    gmtime_r(&t, &tm);
+    strftime(datetime, sizeof(datetime), "%Y-%m-%dT%H:%M:%SZ", &tm);
+
+    f = fopen(opts->out.meta_path, "w");
+    if (f == NULL) {
+        fprintf(stderr, "Failed to open %s: %s\n", opts->out.meta_path,
+                strerror(errno));
+        return -1;
+    }
+
+    fprintf(f, "{\n");
+    fprintf(f, "    \"global\": {\n");
+    fprintf(f, "        \"core:datatype\": \"%s\",\n",
+            opts->out.format->sigmf_datatype);
+    if (opts->samplerate > 0) {
+        fprintf(f, "        \"core:sample_rate\": %.17g,\n", opts->samplerate);
+    }
+    if (opts->channels > 1) {
+        fprintf(f, "        \"core:num_channels\": %u,\n", opts->channels);
+    }
+    fprintf(f, "        \"core:recorder\": \"bladeRF-convert %s\",\n",
+            BLADERF_CONVERT_VERSION);
+    fprintf(f, "        \"core:description\": \"Converted from %s\",\n", base);
+    fprintf(f, "        \"core:version\": \"1.0.0\"\n");
+    fprintf(f, "    },\n");
+    fprintf(f, "    \"captures\": [\n");
+    fprintf(f, "        {\n");
+    fprintf(f, "            \"core:sample_start\": 0,\n");
+    if (opts->frequency > 0) {
+        fprintf(f, "            \"core:frequency\": %" PRIu64 ",\n",
+                opts->frequency);
+    }
+    fprintf(f, "            \"core:datetime\": \"%s\"\n", datetime);
+    fprintf(f, "        }\n");
+    fprintf(f, "    ],\n");
+    fprintf(f, "    \"annotations\": []\n");
+    fprintf(f, "}\n");
+
+    if (fclose(f) != 0) {
+        fprintf(stderr, "Failed to write %s\n", opts->out.meta_path);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Determine the format and paths of a file */
+static int setup_file(struct options *opts,
+                      struct file *file,
+                      const char *format_name,
+                      bool output)
+{
+    if (is_sigmf(format_name, file->path)) {
+        const char *ext = has_suffix(file->path, SIGMF_META_EXT)
+                              ? SIGMF_META_EXT
+                              : SIGMF_DATA_EXT;
+
+        file->data_path = replace_ext(file->path, ext, SIGMF_DATA_EXT);
+        file->meta_path = replace_ext(file->path, ext, SIGMF_META_EXT);
+        if (file->data_path == NULL || file->meta_path == NULL) {
+            return -1;
+        }
+
+        if (!output) {
+            return sigmf_read_meta(opts);
+        }
+
+        file->format = format_lookup_sigmf(opts->sigmf_type);
+        if (file->format == NULL) {
+            fprintf(stderr, "Unsupported SigMF datatype: %s\n",
+                    opts->sigmf_type);
+            return -1;
+        }
+
+        return 0;
+    }
+
+    file->data_path = strdup(file->path);
+    if (file->data_path == NULL) {
+        return -1;
+    }
+
+    if (format_name != NULL) {
+        file->format = format_lookup(format_name);
+        if (file->format == NULL) {
+            fprintf(stderr, "Unknown format: %s\n", format_name);
+            return -1;
+        }
+    } else {
+        file->format = format_from_extension(file->path);
+        if (file->format == NULL) {
+            fprintf(stderr, "Cannot determine the format of %s. "
+                    "Specify it with --%s.\n",
+                    file->path, output ? "to" : "from");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    struct options opts;
+    struct pipeline_config config;
+    struct pipeline_stats stats;
+    const char *from = NULL, *to = NULL;
+    struct stat st;
+    bool ok = true;
+    long cpus;
+    int c;
+    int status = EXIT_FAILURE;
+
+    memset(&opts, 0, sizeof(opts));
+    memset(&config, 0, sizeof(config));
+    config.in_fd  = -1;
+    config.out_fd = -1;
+
+    opts.sigmf_type = DEFAULT_SIGMF_TYPE;
+    opts.chunk_size = DEFAULT_CHUNK_SIZE;
+
+    cpus         = sysconf(_SC_NPROCESSORS_ONLN);
+    opts.threads = (cpus > 0 && cpus <= MAX_THREADS) ? (unsigned int)cpus : 1;
+
+    while ((c = getopt_long(argc, argv, "f:t:n:j:c:r:F:vh", long_options,
+                            NULL)) != -1) {
+        switch (c) {
+            case 'f':
+                from = optarg;
+                break;
+
+            case 't':
+                to = optarg;
+                break;
+
+            case OPTION_SIGMF_TYPE:
+                opts.sigmf_type = optarg;
+                break;
+
+            case 'n':
+                opts.channels = str2uint(optarg, 1, MAX_CHANNELS, &ok);
+                break;
+
+            case 'j':
+                opts.threads = str2uint(optarg, 1, MAX_THREADS, &ok);
+                break;
+
+            case 'c':
+                opts.chunk_size = (size_t)str2uint64_suffix(
+                    optarg, 4096, 1024 * 1024 * 1024, size_suffixes,
+                    sizeof(size_suffixes) / sizeof(size_suffixes[0]), &ok);
+                break;
+
+            case 'r':
+                opts.samplerate = str2double(optarg, 1, 1e12, &ok);
+                break;
+
+            case 'F':
+                opts.frequency = str2uint64_suffix(
+                    optarg, 1, UINT64_MAX, freq_suffixes,
+                    sizeof(freq_suffixes) / sizeof(freq_suffixes[0]), &ok);
+                break;
+
+            case 'v':
+                opts.verbose = true;
+                break;
+
+            case 'V': {
+                struct bladerf_version ver;
+                bladerf_version(&ver);
+                printf("bladeRF-convert %s (libbladeRF %s)\n",
+                       BLADERF_CONVERT_VERSION, ver.describe);
+                return EXIT_SUCCESS;
+            }
+
+            case 'h':
+                usage(argv[0]);
+                return EXIT_SUCCESS;
+
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+
+        if (!ok) {
+            fprintf(stderr, "Invalid value: %s\n", optarg);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - optind != 2) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    opts.in.path  = argv[optind];
+    opts.out.path = argv[optind + 1];
+
+    if (setup_file(&opts, &opts.in, from, false) != 0 ||
+        setup_file(&opts, &opts.out, to, true) != 0) {
+        goto out;
+    }
+
+    if (opts.channels == 0) {
+        opts.channels = 1;
+    }
+
+    config.in_fd = open(opts.in.data_path, O_RDONLY);
+    if (config.in_fd < 0) {
+        fprintf(stderr, "Failed to open %s: %s\n", opts.in.data_path,
+                strerror(errno));
+        goto out;
+    }
+
+    if (fstat(config.in_fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        fprintf(stderr, "%s is not a regular file.\n", opts.in.data_path);
+        goto out;
+    }
+
+    if (!strcmp(opts.out.data_path, "-")) {
+        config.out_fd = STDOUT_FILENO;
+    } else {
+        config.out_fd = open(opts.out.data_path, O_WRONLY | O_CREAT | O_TRUNC,
+                             0644);
+        if (config.out_fd < 0) {
+            fprintf(stderr, "Failed to open %s: %s\n", opts.out.data_path,
+                    strerror(errno));
+            goto out;
+        }
+    }
+
+    config.in_size    = (uint64_t)st.st_size;
+    config.in         = opts.in.format;
+    config.out        = opts.out.format;
+    config.channels   = opts.channels;
+    config.threads    = opts.threads;
+    config.chunk_size = opts.chunk_size;
+    config.verbose    = opts.verbose;
+
+    if (pipeline_run(&config, &stats) != 0) {
+        goto out;
+    }
+
+    if (opts.out.meta_path != NULL && sigmf_write_meta(&opts) != 0) {
+        goto out;
+    }
+
+    if (stats.clamped > 0) {
+        fprintf(stderr, "Warning: %" PRIu64 " value%s clamped to [%d, %d].\n",
+                stats.clamped, stats.clamped == 1 ? " was" : "s were",
+                CSV_VALUE_MIN, CSV_VALUE_MAX);
+    }
+
+    if (stats.ignored > 0) {
+        fprintf(stderr, "Warning: ignored %" PRIu64 " trailing byte%s that "
+                "did not form a whole sample.\n",
+                stats.ignored, stats.ignored == 1 ? "" : "s");
+    }
+
+    if (opts.verbose) {
+        fprintf(stderr, "Converted %" PRIu64 " samples (%s -> %s), "
+                "wrote %" PRIu64 " bytes.\n",
+                stats.samples, config.in->name, config.out->name, stats.bytes);
+    }
+
+    status = EXIT_SUCCESS;
+
+out:
+    if (config.in_fd >= 0) {
+        close(config.in_fd);
+    }
+
+    if (config.out_fd >= 0 && config.out_fd != STDOUT_FILENO) {
+        if (close(config.out_fd) != 0 && status == EXIT_SUCCESS) {
+            fprintf(stderr, "Failed to write %s: %s\n", opts.out.data_path,
+                    strerror(errno));
+            status = EXIT_FAILURE;
+        }
+    }
+
+    free(opts.in.data_path);
+    free(opts.in.meta_path);
+    free(opts.out.data_path);
+    free(opts.out.meta_path);
+
+    return status;
+}
@@ -0,0 +1,572 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "pipeline.h"
+#include "sample_convert.h"
+
+/* Chunks in flight per worker thread. One is being converted while the
+ * other waits to be written. */
+#define SLOTS_PER_THREAD 2
+
+enum slot_state {
+    SLOT_FREE, /* Available for the next chunk */
+    SLOT_BUSY, /* Being converted by a worker */
+    SLOT_DONE, /* Converted, waiting to be written */
+};
+
+struct slot {
+    enum slot_state state;
+    uint64_t chunk;
+
+    /* Mapping of the chunk's part of the input file */
+    void *map;
+    size_t map_len;
+    off_t map_offset;
+
+    int16_t *pivot; /* SC16 Q11 samples decoded from CSV or big-endian */
+    int16_t *conv;  /* SC16 Q11 samples for CSV or big-endian output */
+    void *out;      /* Converted output */
+
+    /* Result of the conversion, which may point into the mapping */
+    const void *data;
+    size_t len;
+    size_t samples;
+
+    bool ok;
+    char error[128];
+    struct csv_parse_result csv;
+};
+
+struct pipeline {
+    const struct pipeline_config *config;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond; /* Broadcast whenever a slot changes state */
+
+    struct slot *slots;
+    size_t num_slots;
+
+    uint64_t num_chunks;
+    uint64_t next_chunk; /* Next chunk to be claimed by a worker */
+    uint64_t size;       /* Bytes of input to convert */
+    size_t chunk_size;
+    size_t max_samples;  /* Most samples a chunk may produce */
+    long page_size;
+    bool abort;
+};
+
+/* Find the start of the line following the first '\n' in [from, to), as an
+ * offset from p. Returns -1 if there is none. */
+static long next_line(const char *p, size_t from, size_t to)
+{
+    const char *nl;
+
+    if (from >= to) {
+        return -1;
+    }
+
+    nl = memchr(p + from, '\n', to - from);
+    return (nl == NULL) ? -1 : (long)(nl - p) + 1;
+}
+
+static bool map_chunk(struct pipeline *pl,
+                      struct slot *slot,
+                      uint64_t start,
+                      uint64_t end)
+{
+    const struct pipeline_config *config = pl->config;
+    const uint64_t offset = config->in_offset + start;
+    const uint64_t aligned = offset - offset % (uint64_t)pl->page_size;
+
+    slot->map_offset = (off_t)aligned;
+    slot->map_len    = (size_t)(end - start + (offset - aligned));
+    slot->map        = mmap(NULL, slot->map_len, PROT_READ, MAP_PRIVATE,
+                            config->in_fd, slot->map_offset);
+
+    if (slot->map == MAP_FAILED) {
+        slot->map = NULL;
+        snprintf(slot->error, sizeof(slot->error),
+                 "Failed to map input: %s", strerror(errno));
+        return false;
+    }
+
+#ifdef MADV_SEQUENTIAL
+    madvise(slot->map, slot->map_len, MADV_SEQUENTIAL);
+#endif
+
+    return true;
+}
+
+static void unmap_chunk(struct pipeline *pl, struct slot *slot)
+{
+    if (slot->map != NULL) {
+        munmap(slot->map, slot->map_len);
+
+#ifdef POSIX_FADV_DONTNEED
+        /* The input is read once, so don't let it crowd out the page cache */
+        posix_fadvise(pl->config->in_fd, slot->map_offset,
+                      (off_t)slot->map_len, POSIX_FADV_DONTNEED);
+#endif
+
+        slot->map = NULL;
+    }
+}
+
+/* Decode a chunk of the input into samples. Returns a pointer to them. */
+static const void *decode_chunk(struct pipeline *pl,
+                                struct slot *slot,
+                                size_t *n_samples)
+{
+    const struct pipeline_config *config = pl->config;
+    const struct file_format *in         = config->in;
+    const uint64_t start = slot->chunk * pl->chunk_size;
+    const uint64_t end   = start + pl->chunk_size < pl->size
+                               ? start + pl->chunk_size
+                               : pl->size;
+    const char *text;
+    uint64_t map_start, map_end;
+    long line_start, line_end;
+
+    if (!in->text) {
+        if (!map_chunk(pl, slot, start, end)) {
+            return NULL;
+        }
+
+        text       = (const char *)slot->map + (start + config->in_offset -
+                                                (uint64_t)slot->map_offset);
+        *n_samples = (size_t)((end - start) / in->sample_size);
+
+        if (in->big_endian) {
+            sc16q11_swap((const int16_t *)text, slot->pivot, *n_samples);
+            return slot->pivot;
+        }
+
+        return text;
+    }
+
+    /* A chunk of CSV begins after the first line ending at or beyond its
+     * nominal start, and ends at the first line ending at or beyond its
+     * nominal end. Either chunk sharing a boundary finds the same line
+     * ending, so every line belongs to exactly one chunk. */
+    map_start = (start == 0) ? 0 : start - 1;
+    map_end   = end + PIPELINE_MAX_LINE < pl->size ? end + PIPELINE_MAX_LINE
+                                                   : pl->size;
+
+    if (!map_chunk(pl, slot, map_start, map_end)) {
+        return NULL;
+    }
+
+    text = (const char *)slot->map + (map_start + config->in_offset -
+                                      (uint64_t)slot->map_offset);
+
+    if (start == 0) {
+        line_start = 0;
+    } else {
+        line_start = next_line(text, 0, (size_t)(end - map_start));
+        if (line_start < 0) {
+            /* The chunk lies within a line begun by an earlier one */
+            *n_samples = 0;
+            return slot->pivot;
+        }
+    }
+
+    if (end == pl->size) {
+        line_end = (long)(map_end - map_start);
+    } else {
+        line_end = next_line(text, (size_t)(end - 1 - map_start),
+                             (size_t)(map_end - map_start));
+        if (line_end < 0) {
+            if (map_end != pl->size) {
+                snprintf(slot->error, sizeof(slot->error),
+                         "Line exceeds %u bytes", PIPELINE_MAX_LINE);
+                return NULL;
+            }
+
+            line_end = (long)(map_end - map_start);
+        }
+    }
+
+    if (line_end <= line_start) {
+        *n_samples = 0;
+        return slot->pivot;
+    }
+
+    if (!csv_parse(text + line_start, (size_t)(line_end - line_start),
+                   slot->pivot, n_samples, &slot->csv)) {
+        if (slot->csv.odd_cols) {
+            snprintf(slot->error, sizeof(slot->error),
+                     "Encountered %u value%s (values must be in pairs)",
+                     slot->csv.cols, slot->csv.cols == 1 ? "" : "s");
+        } else {
+            snprintf(slot->error, sizeof(slot->error), "Parsing failed");
+        }
+        return NULL;
+    }
+
+    return slot->pivot;
+}
+
+static bool convert_chunk(struct pipeline *pl, struct slot *slot)
+{
+    const struct pipeline_config *config = pl->config;
+    const struct file_format *in         = config->in;
+    const struct file_format *out        = config->out;
+    const int16_t *sc16;
+    const void *samples;
+    size_t n;
+    int status;
+
+    memset(&slot->csv, 0, sizeof(slot->csv));
+    slot->len = 0;
+
+    samples = decode_chunk(pl, slot, &n);
+    if (samples == NULL) {
+        return false;
+    }
+
+    slot->samples = n;
+
+    if (out->text || out->big_endian) {
+        if (in->samples != BLADERF_FORMAT_SC16_Q11) {
+            status = bladerf_convert_samples(in->samples, samples,
+                                             BLADERF_FORMAT_SC16_Q11,
+                                             slot->conv, n);
+            if (status != 0) {
+                goto convert_failed;
+            }
+
+            sc16 = slot->conv;
+        } else {
+            sc16 = samples;
+        }
+
+        if (out->text) {
+            if (n % config->channels != 0) {
+                snprintf(slot->error, sizeof(slot->error),
+                         "%zu samples do not divide into %u channels", n,
+                         config->channels);
+                return false;
+            }
+
+            slot->len = csv_format(slot->out, sc16, n, config->channels);
+        } else {
+            sc16q11_swap(sc16, slot->out, n);
+            slot->len = n * out->sample_size;
+        }
+
+        slot->data = slot->out;
+    } else if (in->samples == out->samples) {
+        /* Written straight from the input mapping, when possible */
+        slot->data = samples;
+        slot->len  = n * out->sample_size;
+    } else {
+        status = bladerf_convert_samples(in->samples, samples, out->samples,
+                                         slot->out, n);
+        if (status != 0) {
+            goto convert_failed;
+        }
+
+        slot->data = slot->out;
+        slot->len  = n * out->sample_size;
+    }
+
+    return true;
+
+convert_failed:
+    snprintf(slot->error, sizeof(slot->error), "Conversion failed: %s",
+             bladerf_strerror(status));
+    return false;
+}
+
+static void *worker(void *arg)
+{
+    struct pipeline *pl = arg;
+    struct slot *slot;
+    bool ok;
+
+    pthread_mutex_lock(&pl->lock);
+
+    while (true) {
+        /* Chunks are claimed in order, and each waits for its slot to be
+         * written out, which bounds how far ahead of the writer they get */
+        while (!pl->abort && pl->next_chunk < pl->num_chunks &&
+               pl->slots[pl->next_chunk % pl->num_slots].state != SLOT_FREE) {
+            pthread_cond_wait(&pl->cond, &pl->lock);
+        }
+
+        if (pl->abort || pl->next_chunk >= pl->num_chunks) {
+            break;
+        }
+
+        slot        = &pl->slots[pl->next_chunk % pl->num_slots];
+        slot->chunk = pl->next_chunk++;
+        slot->state = SLOT_BUSY;
+        pthread_mutex_unlock(&pl->lock);
+
+        ok = convert_chunk(pl, slot);
+
+        pthread_mutex_lock(&pl->lock);
+        slot->ok    = ok;
+        slot->state = SLOT_DONE;
+        pthread_cond_broadcast(&pl->cond);
+    }
+
+    pthread_mutex_unlock(&pl->lock);
+    return NULL;
+}
+
+static bool write_all(int fd, const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    ssize_t n;
+
+    while (len > 0) {
+        n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return false;
+        }
+
+        p += n;
+        len -= (size_t)n;
+    }
+
+    return true;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int alloc_slots(struct pipeline *pl)
+{
+    const struct pipeline_config *config = pl->config;
+    const struct file_format *in         = config->in;
+    const struct file_format *out        = config->out;
+    const size_t sc16_size = pl->max_samples * 2 * sizeof(int16_t);
+    size_t out_size        = 0;
+    size_t i;
+
+    if (out->text) {
+        out_size = pl->max_samples * CSV_MAX_SAMPLE_CHARS;
+    } else if (out->big_endian || in->samples != out->samples) {
+        out_size = pl->max_samples * out->sample_size;
+    }
+
+    pl->slots = calloc(pl->num_slots, sizeof(pl->slots[0]));
+    if (pl->slots == NULL) {
+        return -1;
+    }
+
+    for (i = 0; i < pl->num_slots; i++) {
+        struct slot *slot = &pl->slots[i];
+
+        if (in->text || in->big_endian) {
+            slot->pivot = malloc(sc16_size);
+            if (slot->pivot == NULL) {
+                return -1;
+            }
+        }
+
+        if ((out->text || out->big_endian) &&
+            in->samples != BLADERF_FORMAT_SC16_Q11) {
+            slot->conv = malloc(sc16_size);
+            if (slot->conv == NULL) {
+                return -1;
+            }
+        }
+
+        if (out_size != 0) {
+            slot->out = malloc(out_size);
+            if (slot->out == NULL) {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static void free_slots(struct pipeline *pl)
+{
+    size_t i;
+
+    if (pl->slots == NULL) {
+        return;
+    }
+
+    for (i = 0; i < pl->num_slots; i++) {
+        unmap_chunk(pl, &pl->slots[i]);
+        free(pl->slots[i].pivot);
+        free(pl->slots[i].conv);
+        free(pl->slots[i].out);
+    }
+
+    free(pl->slots);
+}
+
+int pipeline_run(const struct pipeline_config *config,
+                 struct pipeline_stats *stats)
+{
+    struct pipeline pl;
+    pthread_t *threads     = NULL;
+    unsigned int n_threads = config->threads > 0 ? config->threads : 1;
+    unsigned int started   = 0;
+    uint64_t lines         = 0;
+    double last_report     = now();
+    uint64_t k;
+    unsigned int i;
+    int status = -1;
+
+    memset(stats, 0, sizeof(*stats));
+    memset(&pl, 0, sizeof(pl));
+
+    pl.config    = config;
+    pl.page_size = sysconf(_SC_PAGESIZE);
+    pl.num_slots = (size_t)n_threads * SLOTS_PER_THREAD;
+
+    if (config->in->text) {
+        pl.size        = config->in_size;
+        pl.chunk_size  = config->chunk_size;
+        pl.max_samples = (pl.chunk_size + PIPELINE_MAX_LINE) /
+                             CSV_MIN_SAMPLE_CHARS + 1;
+    } else {
+        /* Keep chunks to whole samples, on each channel */
+        const size_t unit = config->in->sample_size * config->channels;
+
+        pl.size       = config->in_size - config->in_size % unit;
+        pl.chunk_size = config->chunk_size - config->chunk_size % unit;
+        if (pl.chunk_size == 0) {
+            pl.chunk_size = unit;
+        }
+
+        pl.max_samples = pl.chunk_size / config->in->sample_size;
+        stats->ignored = config->in_size - pl.size;
+    }
+
+    pl.num_chunks = (pl.size + pl.chunk_size - 1) / pl.chunk_size;
+
+    pthread_mutex_init(&pl.lock, NULL);
+    pthread_cond_init(&pl.cond, NULL);
+
+    if (alloc_slots(&pl) != 0) {
+        fprintf(stderr, "Failed to allocate %zu chunk buffers.\n",
+                pl.num_slots);
+        goto out;
+    }
+
+    threads = calloc(n_threads, sizeof(threads[0]));
+    if (threads == NULL) {
+        goto out;
+    }
+
+    for (started = 0; started < n_threads; started++) {
+        if (pthread_create(&threads[started], NULL, worker, &pl) != 0) {
+            fprintf(stderr, "Failed to start worker threads.\n");
+            break;
+        }
+    }
+
+    /* Write each chunk out in order, as it becomes available */
+    for (k = 0, status = 0; k < pl.num_chunks && status == 0 && started > 0;
+         k++) {
+        struct slot *slot = &pl.slots[k % pl.num_slots];
+
+        pthread_mutex_lock(&pl.lock);
+        while (slot->state != SLOT_DONE || slot->chunk != k) {
+            pthread_cond_wait(&pl.cond, &pl.lock);
+        }
+        pthread_mutex_unlock(&pl.lock);
+
+        if (!slot->ok) {
+            if (config->in->text) {
+                fprintf(stderr, "Line %" PRIu64 ": %s.\n",
+                        lines + slot->csv.lines + 1, slot->error);
+            } else {
+                fprintf(stderr, "Chunk %" PRIu64 ": %s.\n", k, slot->error);
+            }
+            status = -1;
+        } else if (!write_all(config->out_fd, slot->data, slot->len)) {
+            fprintf(stderr, "Failed to write output: %s\n", strerror(errno));
+            status = -1;
+        } else {
+            lines += slot->csv.lines;
+            stats->samples += slot->samples;
+            stats->bytes += slot->len;
+            stats->clamped += slot->csv.clamped;
+        }
+
+        unmap_chunk(&pl, slot);
+
+        pthread_mutex_lock(&pl.lock);
+        slot->state = SLOT_FREE;
+        if (status != 0) {
+            pl.abort = true;
+        }
+        pthread_cond_broadcast(&pl.cond);
+        pthread_mutex_unlock(&pl.lock);
+
+        if (config->verbose && now() - last_report >= 1.0) {
+            last_report = now();
+            fprintf(stderr, "\r%5.1f%%", 100.0 * (k + 1) / pl.num_chunks);
+        }
+    }
+
+    if (started < n_threads) {
+        status = -1;
+    }
+
+    if (config->verbose && pl.num_chunks > 0) {
+        fprintf(stderr, "\r%5.1f%%\n", status == 0 ? 100.0 : 0.0);
+    }
+
+out:
+    pthread_mutex_lock(&pl.lock);
+    pl.abort = true;
+    pthread_cond_broadcast(&pl.cond);
+    pthread_mutex_unlock(&pl.lock);
+
+    for (i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    free(threads);
+    free_slots(&pl);
+    pthread_cond_destroy(&pl.cond);
+    pthread_mutex_destroy(&pl.lock);
+
+    return status;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file pipeline.h
+ *
+ * @brief Multi-threaded, order-preserving conversion of a sample file
+ *
+ * The input file is split into chunks, each of which a worker thread maps,
+ * converts, and unmaps. Converted chunks are written out in order by the
+ * calling thread. A fixed number of chunks are in flight at once, so memory
+ * use does not depend upon the size of the file.
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef PIPELINE_H__
+#define PIPELINE_H__
+
+#include <stdint.h>
+
+#include "formats.h"
+
+/* Longest CSV line accepted, in bytes */
+#define PIPELINE_MAX_LINE (64 * 1024)
+
+struct pipeline_config {
+    int in_fd;
+    uint64_t in_offset; /* Offset of the first sample in the input file */
+    uint64_t in_size;   /* Bytes of samples, from in_offset */
+    int out_fd;
+
+    const struct file_format *in;
+    const struct file_format *out;
+
+    unsigned int channels;   /* Channels per CSV line, for CSV output */
+    unsigned int threads;    /* Worker threads */
+    size_t chunk_size;       /* Input bytes per chunk */
+    bool verbose;            /* Report progress on stderr */
+};
+
+struct pipeline_stats {
+    uint64_t samples;   /* Samples written */
+    uint64_t bytes;     /* Bytes written */
+    uint64_t clamped;   /* CSV values clamped */
+    uint64_t ignored;   /* Trailing input bytes that did not form a sample */
+};
+
+/**
+ * Convert a file
+ *
+ * Errors are reported on stderr.
+ *
+ * @param[in]   config      Input, output and conversion parameters
+ * @param[out]  stats       Conversion statistics
+ *
+ * @return 0 on success, -1 on failure
+ */
+int pipeline_run(const struct pipeline_config *config,
+                 struct pipeline_stats *stats);
+
+#endif
@@ -190,6 +190,10 @@ struct bladerf_fsk_handle *start(struct config *config)
     if (handle->link == NULL){
         goto error;
     }
+    status = link_set_window_size(handle->link, config->window_size);
+    if (status != 0){
+        goto error;
+    }
 
     //Start the receiver thread
     status = pthread_create(&(handle->rx.thread), NULL, receiver, handle);
@@ -0,0 +1,661 @@
+/**
+ * @brief   Polyphase FFT channelizer
+ *
+ * The analysis bank computes, for channel k centered at k/N of the wideband rate:
+ *
+ *    y_k[m] = sum_l h[l] x[mN - l] e^(j2pi kl/N)
+ *
+ * Splitting l into tN + p, this is an N-point DFT across the polyphase branches
+ * u_p[m] = sum_t h[tN + p] x[(m - t)N - p], so every channel costs one FFT per N
+ * wideband samples, plus the taps. The synthesis bank is its transpose: an N-point
+ * DFT across the channels, followed by the polyphase branches of the interpolating
+ * filter.
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2016 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "host_config.h"
+
+#include "channelizer.h"
+
+#ifndef M_PI
+#   define M_PI 3.14159265358979323846
+#endif
+
+//SC16 Q11 sample range
+#define SAMPLE_MIN -2048
+#define SAMPLE_MAX 2047
+
+struct cfloat {
+    float re;
+    float im;
+};
+
+//N-point DFT with a positive exponent, e^(j2pi kn/N)
+struct fft {
+    unsigned int n;
+    unsigned int *bitrev;       //Input index of each output position
+    struct cfloat *twiddle;     //e^(j2pi k/N), for k < N/2
+};
+
+struct chan_analysis {
+    unsigned int num_channels;
+    size_t length;              //Prototype length, num_channels * taps_per_branch
+    float *taps;
+
+    //Wideband samples, newest first, from 'pos'. Each sample is written at both pos
+    //and pos + length, so the newest 'length' samples are always contiguous.
+    struct cfloat *hist;
+    size_t pos;
+    unsigned int phase;         //Samples until the next output, modulo num_channels
+
+    struct cfloat *branch;      //Polyphase branch outputs, then channel outputs
+    struct fft fft;
+};
+
+struct chan_synthesis {
+    unsigned int num_channels;
+    unsigned int taps_per_branch;
+    float *taps;
+
+    //DFT outputs, newest first from row 'pos', one row of num_channels per channel
+    //sample. As in chan_analysis, each row is written twice.
+    struct cfloat *hist;
+    size_t pos;
+
+    struct cfloat *bins;        //Channel samples, then their DFT
+    float *acc_re;              //Branch outputs
+    float *acc_im;
+    struct fft fft;
+};
+
+int chan_offset(unsigned int num_channels, unsigned int channel)
+{
+    return (channel < num_channels / 2) ? (int) channel
+                                        : (int) channel - (int) num_channels;
+}
+
+static bool valid_num_channels(unsigned int num_channels)
+{
+    return num_channels >= 2 && num_channels <= CHAN_MAX_CHANNELS &&
+           (num_channels & (num_channels - 1)) == 0;
+}
+
+static inline int16_t to_sample(float x)
+{
+    long v = lrintf(x);
+
+    if (v < SAMPLE_MIN) {
+        return SAMPLE_MIN;
+    } else if (v > SAMPLE_MAX) {
+        return SAMPLE_MAX;
+    }
+    return (int16_t) v;
+}
+
+/**
+ * Design the prototype: a Blackman-windowed sinc, cut off at half of the channel
+ * spacing, with a DC gain of 1
+ */
+static float *design_prototype(unsigned int num_channels, size_t length)
+{
+    float *taps;
+    double center = (length - 1) / 2.0;
+    double sum = 0.0;
+    double x, w;
+    size_t i;
+
+    taps = malloc(length * sizeof(taps[0]));
+    if (taps == NULL) {
+        perror("malloc");
+        return NULL;
+    }
+
+    for (i = 0; i < length; i++) {
+        x = (i - center) / num_channels;
+        w = 0.42 - 0.5 * cos(2 * M_PI * i / (length - 1)) +
+            0.08 * cos(4 * M_PI * i / (length - 1));
+        taps[i] = (float) (w * (x == 0.0 ? 1.0 : sin(M_PI * x) / (M_PI * x)));
+        sum += taps[i];
+    }
+
+    for (i = 0; i < length; i++) {
+        taps[i] = (float) (taps[i] / sum);
+    }
+
+    return taps;
+}
+
+static int fft_init(struct fft *fft, unsigned int n)
+{
+    unsigned int i, j, bits;
+
+    fft->n = n;
+    fft->bitrev = malloc(n * sizeof(fft->bitrev[0]));
+    fft->twiddle = malloc(n / 2 * sizeof(fft->twiddle[0]));
+    if (fft->bitrev == NULL || fft->twiddle == NULL) {
+        perror("malloc");
+        return -1;
+    }
+
+    for (bits = 0; (1u << bits) < n; bits++);
+
+    for (i = 0; i < n; i++) {
+        fft->bitrev[i] = 0;
+        for (j = 0; j < bits; j++) {
+            if (i & (1u << j)) {
+                fft->bitrev[i] |= 1u << (bits - 1 - j);
+            }
+        }
+    }
+
+    for (i = 0; i < n / 2; i++) {
+        fft->twiddle[i].re = (float) cos(2 * M_PI * i / n);
+        fft->twiddle[i].im = (float) sin(2 * M_PI * i / n);
+    }
+
+    return 0;
+}
+
+static void fft_deinit(struct fft *fft)
+{
+    free(fft->bitrev);
+    free(fft->twiddle);
+}
+
+/**
+ * In-place radix-2 decimation in time DFT
+ */
+static void fft_run(const struct fft *fft, struct cfloat *data)
+{
+    unsigned int n = fft->n;
+    unsigned int i, j, k, half, stride;
+    struct cfloat tmp, w, a, b;
+
+    for (i = 0; i < n; i++) {
+        j = fft->bitrev[i];
+        if (j > i) {
+            tmp = data[i];
+            data[i] = data[j];
+            data[j] = tmp;
+        }
+    }
+
+    for (half = 1, stride = n / 2; half < n; half *= 2, stride /= 2) {
+        for (i = 0; i < n; i += 2 * half) {
+            for (k = 0; k < half; k++) {
+                w = fft->twiddle[k * stride];
+                a = data[i + k];
+                b = data[i + k + half];
+                tmp.re = b.re * w.re - b.im * w.im;
+                tmp.im = b.re * w.im + b.im * w.re;
+                data[i + k].re = a.re + tmp.re;
+                data[i + k].im = a.im + tmp.im;
+                data[i + k + half].re = a.re - tmp.re;
+                data[i + k + half].im = a.im - tmp.im;
+            }
+        }
+    }
+}
+
+/****************************************
+ *                                      *
+ *               ANALYSIS               *
+ *                                      *
+ ****************************************/
+
+struct chan_analysis *chan_analysis_init(unsigned int num_channels,
+                                         unsigned int taps_per_branch)
+{
+    struct chan_analysis *chan;
+
+    if (!valid_num_channels(num_channels)) {
+        fprintf(stderr, "%s: Invalid number of channels: %u\n", __FUNCTION__,
+                num_channels);
+        return NULL;
+    }
+    if (taps_per_branch == 0) {
+        taps_per_branch = CHAN_DEFAULT_TAPS_PER_BRANCH;
+    }
+
+    chan = calloc(1, sizeof(*chan));
+    if (chan == NULL) {
+        perror("calloc");
+        return NULL;
+    }
+
+    chan->num_channels = num_channels;
+    chan->length = (size_t) num_channels * taps_per_branch;
+
+    chan->taps = design_prototype(num_channels, chan->length);
+    chan->hist = calloc(2 * chan->length, sizeof(chan->hist[0]));
+    chan->branch = malloc(num_channels * sizeof(chan->branch[0]));
+    if (chan->taps == NULL || chan->hist == NULL || chan->branch == NULL) {
+        perror("[CHAN] malloc");
+        goto error;
+    }
+    if (fft_init(&chan->fft, num_channels) != 0) {
+        goto error;
+    }
+
+    chan->pos = 0;
+    chan->phase = 0;
+
+    return chan;
+
+error:
+    chan_analysis_deinit(chan);
+    return NULL;
+}
+
+void chan_analysis_deinit(struct chan_analysis *chan)
+{
+    if (chan == NULL) {
+        return;
+    }
+
+    fft_deinit(&chan->fft);
+    free(chan->branch);
+    free(chan->hist);
+    free(chan->taps);
+    free(chan);
+}
+
+size_t chan_analyze(struct chan_analysis *chan, const int16_t *input, size_t count,
+                    int16_t *const *outputs)
+{
+    const unsigned int n = chan->num_channels;
+    const size_t length = chan->length;
+    const float *taps = chan->taps;
+    struct cfloat *branch = chan->branch;
+    const struct cfloat *window;
+    size_t i, t, out = 0;
+    unsigned int p, k;
+
+    for (i = 0; i < count; i++) {
+        chan->pos = (chan->pos == 0 ? length : chan->pos) - 1;
+        chan->hist[chan->pos].re = chan->hist[chan->pos + length].re = input[2*i];
+        chan->hist[chan->pos].im = chan->hist[chan->pos + length].im = input[2*i + 1];
+
+        if (chan->phase != 0) {
+            chan->phase--;
+            continue;
+        }
+        chan->phase = n - 1;
+
+        //Polyphase branches, over the newest 'length' samples
+        window = &chan->hist[chan->pos];
+        for (p = 0; p < n; p++) {
+            branch[p].re = 0.0f;
+            branch[p].im = 0.0f;
+        }
+        for (t = 0; t < length; t += n) {
+            for (p = 0; p < n; p++) {
+                branch[p].re += taps[t + p] * window[t + p].re;
+                branch[p].im += taps[t + p] * window[t + p].im;
+            }
+        }
+
+        //Mix each channel down to baseband
+        fft_run(&chan->fft, branch);
+
+        for (k = 0; k < n; k++) {
+            outputs[k][2*out]     = to_sample(branch[k].re);
+            outputs[k][2*out + 1] = to_sample(branch[k].im);
+        }
+        out++;
+    }
+
+    return out;
+}
+
+/****************************************
+ *                                      *
+ *               SYNTHESIS              *
+ *                                      *
+ ****************************************/
+
+struct chan_synthesis *chan_synthesis_init(unsigned int num_channels,
+                                           unsigned int taps_per_branch)
+{
+    struct chan_synthesis *chan;
+
+    if (!valid_num_channels(num_channels)) {
+        fprintf(stderr, "%s: Invalid number of channels: %u\n", __FUNCTION__,
+                num_channels);
+        return NULL;
+    }
+    if (taps_per_branch == 0) {
+        taps_per_branch = CHAN_DEFAULT_TAPS_PER_BRANCH;
+    }
+
+    chan = calloc(1, sizeof(*chan));
+    if (chan == NULL) {
+        perror("calloc");
+        return NULL;
+    }
+
+    chan->num_channels = num_channels;
+    chan->taps_per_branch = taps_per_branch;
+
+    chan->taps = design_prototype(num_channels,
+                                  (size_t) num_channels * taps_per_branch);
+    chan->hist = calloc(2 * (size_t) num_channels * taps_per_branch,
+                        sizeof(chan->hist[0]));
+    chan->bins = malloc(num_channels * sizeof(chan->bins[0]));
+    chan->acc_re = malloc(num_channels * sizeof(chan->acc_re[0]));
+    chan->acc_im = malloc(num_channels * sizeof(chan->acc_im[0]));
+    if (chan->taps == NULL || chan->hist == NULL || chan->bins == NULL ||
+        chan->acc_re == NULL || chan->acc_im == NULL) {
+        perror("[CHAN] malloc");
+        goto error;
+    }
+    if (fft_init(&chan->fft, num_channels) != 0) {
+        goto error;
+    }
+
+    chan->pos = 0;
+
+    return chan;
+
+error:
+    chan_synthesis_deinit(chan);
+    return NULL;
+}
+
+void chan_synthesis_deinit(struct chan_synthesis *chan)
+{
+    if (chan == NULL) {
+        return;
+    }
+
+    fft_deinit(&chan->fft);
+    free(chan->acc_im);
+    free(chan->acc_re);
+    free(chan->bins);
+    free(chan->hist);
+    free(chan->taps);
+    free(chan);
+}
+
+void chan_synthesize(struct chan_synthesis *chan, const int16_t *const *inputs,
+                     size_t count, int16_t *output)
+{
+    const unsigned int n = chan->num_channels;
+    const unsigned int taps_per_branch = chan->taps_per_branch;
+    const float *taps = chan->taps;
+    struct cfloat *bins = chan->bins;
+    struct cfloat *row, *row2;
+    const struct cfloat *h;
+    float *acc_re = chan->acc_re;
+    float *acc_im = chan->acc_im;
+    size_t m;
+    unsigned int k, r, t;
+
+    for (m = 0; m < count; m++) {
+        for (k = 0; k < n; k++) {
+            if (inputs[k] != NULL) {
+                bins[k].re = inputs[k][2*m];
+                bins[k].im = inputs[k][2*m + 1];
+            } else {
+                bins[k].re = 0.0f;
+                bins[k].im = 0.0f;
+            }
+        }
+
+        //Mix each channel up to its center
+        fft_run(&chan->fft, bins);
+
+        chan->pos = (chan->pos == 0 ? taps_per_branch : chan->pos) - 1;
+        row  = &chan->hist[chan->pos * n];
+        row2 = &chan->hist[(chan->pos + taps_per_branch) * n];
+        memcpy(row, bins, n * sizeof(bins[0]));
+        memcpy(row2, bins, n * sizeof(bins[0]));
+
+        //Polyphase branches of the interpolating filter, one output each
+        for (r = 0; r < n; r++) {
+            acc_re[r] = 0.0f;
+            acc_im[r] = 0.0f;
+        }
+        for (t = 0; t < taps_per_branch; t++) {
+            h = &row[t * n];
+            for (r = 0; r < n; r++) {
+                acc_re[r] += taps[t * n + r] * h[r].re;
+                acc_im[r] += taps[t * n + r] * h[r].im;
+            }
+        }
+
+        for (r = 0; r < n; r++) {
+            output[2*(m*n + r)]     = to_sample(acc_re[r]);
+            output[2*(m*n + r) + 1] = to_sample(acc_im[r]);
+        }
+    }
+}
+
+#ifdef CHANNELIZER_TEST
+
+#define TEST_NUM_CHANNELS 8
+#define TEST_NUM_SAMPLES 4096       //Per channel
+#define TEST_SETTLE 64              //Channel samples skipped while the filters fill
+#define TEST_AMPLITUDE 1600.0
+#define TEST_MIN_ISOLATION_DB 40.0
+
+/**
+ * Pass a tone on each active channel through synthesis and then analysis, and
+ * measure each channel's output power in dB relative to the expected level
+ */
+static int run_pass(const bool *active, double *power_db)
+{
+    struct chan_synthesis *synth = NULL;
+    struct chan_analysis *analysis = NULL;
+    int16_t *inputs[TEST_NUM_CHANNELS] = { NULL };
+    int16_t *outputs[TEST_NUM_CHANNELS] = { NULL };
+    int16_t *wide = NULL;
+    double expected, power, freq;
+    size_t count, i;
+    unsigned int k;
+    int status = -1;
+
+    synth = chan_synthesis_init(TEST_NUM_CHANNELS, 0);
+    analysis = chan_analysis_init(TEST_NUM_CHANNELS, 0);
+    wide = malloc(2 * sizeof(int16_t) * TEST_NUM_SAMPLES * TEST_NUM_CHANNELS);
+    if (synth == NULL || analysis == NULL || wide == NULL) {
+        goto out;
+    }
+
+    for (k = 0; k < TEST_NUM_CHANNELS; k++) {
+        inputs[k] = malloc(2 * sizeof(int16_t) * TEST_NUM_SAMPLES);
+        outputs[k] = malloc(2 * sizeof(int16_t) * (TEST_NUM_SAMPLES + 1));
+        if (inputs[k] == NULL || outputs[k] == NULL) {
+            goto out;
+        }
+
+        //A different in-band tone on each channel, within a fifth of the spacing
+        freq = (k % 2 ? -0.2 : 0.2) * (k + 1) / TEST_NUM_CHANNELS;
+        for (i = 0; i < TEST_NUM_SAMPLES; i++) {
+            if (active[k]) {
+                inputs[k][2*i]     = (int16_t) lrint(TEST_AMPLITUDE *
+                                                     cos(2 * M_PI * freq * i));
+                inputs[k][2*i + 1] = (int16_t) lrint(TEST_AMPLITUDE *
+                                                     sin(2 * M_PI * freq * i));
+            } else {
+                inputs[k][2*i] = inputs[k][2*i + 1] = 0;
+            }
+        }
+    }
+
+    chan_synthesize(synth, (const int16_t *const *) inputs, TEST_NUM_SAMPLES, wide);
+    count = chan_analyze(analysis, wide, TEST_NUM_SAMPLES * TEST_NUM_CHANNELS,
+                         outputs);
+    if (count != TEST_NUM_SAMPLES) {
+        fprintf(stderr, "Expected %u samples per channel, got %u\n",
+                TEST_NUM_SAMPLES, (unsigned int) count);
+        goto out;
+    }
+
+    expected = TEST_AMPLITUDE / TEST_NUM_CHANNELS;
+    expected *= expected;
+    for (k = 0; k < TEST_NUM_CHANNELS; k++) {
+        power = 0.0;
+        for (i = TEST_SETTLE; i < count; i++) {
+            power += (double) outputs[k][2*i] * outputs[k][2*i] +
+                     (double) outputs[k][2*i + 1] * outputs[k][2*i + 1];
+        }
+        power /= count - TEST_SETTLE;
+        power_db[k] = 10 * log10((power + 1e-9) / expected);
+    }
+
+    status = 0;
+
+out:
+    for (k = 0; k < TEST_NUM_CHANNELS; k++) {
+        free(inputs[k]);
+        free(outputs[k]);
+    }
+    free(wide);
+    chan_analysis_deinit(analysis);
+    chan_synthesis_deinit(synth);
+    return status;
+}
+
+/**
+ * Analyze a wideband tone placed 0.1 of the spacing above a channel's center, and
+ * measure each channel's output power in dB relative to the tone's
+ */
+static int run_tone(unsigned int channel, double *power_db)
+{
+    struct chan_analysis *analysis = NULL;
+    int16_t *outputs[TEST_NUM_CHANNELS] = { NULL };
+    int16_t *wide = NULL;
+    const size_t num_wide = TEST_NUM_SAMPLES * TEST_NUM_CHANNELS;
+    double power, freq;
+    size_t count, i;
+    unsigned int k;
+    int status = -1;
+
+    analysis = chan_analysis_init(TEST_NUM_CHANNELS, 0);
+    wide = malloc(2 * sizeof(int16_t) * num_wide);
+    if (analysis == NULL || wide == NULL) {
+        goto out;
+    }
+    for (k = 0; k < TEST_NUM_CHANNELS; k++) {
+        outputs[k] = malloc(2 * sizeof(int16_t) * (TEST_NUM_SAMPLES + 1));
+        if (outputs[k] == NULL) {
+            goto out;
+        }
+    }
+
+    freq = (chan_offset(TEST_NUM_CHANNELS, channel) + 0.1) / TEST_NUM_CHANNELS;
+    for (i = 0; i < num_wide; i++) {
+        wide[2*i]     = (int16_t) lrint(TEST_AMPLITUDE * cos(2 * M_PI * freq * i));
+        wide[2*i + 1] = (int16_t) lrint(TEST_AMPLITUDE * sin(2 * M_PI * freq * i));
+    }
+
+    count = chan_analyze(analysis, wide, num_wide, outputs);
+
+    for (k = 0; k < TEST_NUM_CHANNELS; k++) {
+        power = 0.0;
+        for (i = TEST_SETTLE; i < count; i++) {
+            power += (double) outputs[k][2*i] * outputs[k][2*i] +
+                     (double) outputs[k][2*i + 1] * outputs[k][2*i + 1];
+        }
+        power /= count - TEST_SETTLE;
+        power_db[k] = 10 * log10((power + 1e-9) / (TEST_AMPLITUDE * TEST_AMPLITUDE));
+    }
+
+    status = 0;
+
+out:
+    for (k = 0; k < TEST_NUM_CHANNELS; k++) {
+        free(outputs[k]);
+    }
+    free(wide);
+    chan_analysis_deinit(analysis);
+    return status;
+}
+
+static bool check_isolation(const char *what, unsigned int on, const double *power_db)
+{
+    bool passed = true;
+    unsigned int k;
+
+    printf("%s %u (%+d):", what, on, chan_offset(TEST_NUM_CHANNELS, on));
+    for (k = 0; k < TEST_NUM_CHANNELS; k++) {
+        printf(" %6.1f", power_db[k]);
+        if (k == on ? fabs(power_db[k]) > 0.5
+                    : power_db[k] > -TEST_MIN_ISOLATION_DB) {
+            passed = false;
+        }
+    }
+    printf(" dB\n");
+
+    return passed;
+}
+
+int main(void)
+{
+    bool active[TEST_NUM_CHANNELS];
+    double power_db[TEST_NUM_CHANNELS];
+    unsigned int k, on;
+    bool passed = true;
+
+    //Every channel at once: each should come back at the level it was sent at
+    for (k = 0; k < TEST_NUM_CHANNELS; k++) {
+        active[k] = true;
+    }
+    if (run_pass(active, power_db) != 0) {
+        return EXIT_FAILURE;
+    }
+    printf("All channels:");
+    for (k = 0; k < TEST_NUM_CHANNELS; k++) {
+        printf(" %5.2f", power_db[k]);
+        if (fabs(power_db[k]) > 0.5) {
+            passed = false;
+        }
+    }
+    printf(" dB\n");
+
+    //One channel at a time: the others should stay quiet
+    for (on = 0; on < TEST_NUM_CHANNELS; on++) {
+        for (k = 0; k < TEST_NUM_CHANNELS; k++) {
+            active[k] = (k == on);
+        }
+        if (run_pass(active, power_db) != 0) {
+            return EXIT_FAILURE;
+        }
+        passed &= check_isolation("Channel", on, power_db);
+    }
+
+    //A wideband tone at each channel's center should land in that channel alone
+    for (on = 0; on < TEST_NUM_CHANNELS; on++) {
+        if (run_tone(on, power_db) != 0) {
+            return EXIT_FAILURE;
+        }
+        passed &= check_isolation("Tone at channel", on, power_db);
+    }
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+#endif
@@ -0,0 +1,135 @@
+/**
+ * @file
+ * @brief   Polyphase FFT channelizer
+ *
+ * Splits a wideband signal into num_channels narrowband channels, and combines
+ * narrowband channels back into a wideband signal. The channels are spaced evenly
+ * across the wideband sample rate, and each one is sampled at the wideband rate
+ * divided by num_channels, so a bank of num_channels channels covers the whole band.
+ *
+ * Channel k is centered at chan_offset(num_channels, k) channel spacings from the
+ * center of the band: channels 0 to num_channels/2 - 1 are at and above the center,
+ * and the rest are below it. Channel 0 sits on the center frequency, where the
+ * device's DC offset and LO leakage are.
+ *
+ * Both directions filter with a windowed-sinc prototype, cut off half a channel
+ * from each channel's center, applied as num_channels polyphase branches followed by
+ * an FFT across the branches. A signal should stay within about a third of the channel
+ * spacing of its channel's center; beyond that it is attenuated, and aliases into the
+ * neighbouring channel.
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2016 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef CHANNELIZER_H_
+#define CHANNELIZER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+//Most channels a channelizer may have. The number of channels must be a power of 2.
+#define CHAN_MAX_CHANNELS 64
+
+//Prototype filter taps per polyphase branch, if 0 is given
+#define CHAN_DEFAULT_TAPS_PER_BRANCH 16
+
+struct chan_analysis;
+struct chan_synthesis;
+
+/**
+ * Get a channel's center, relative to the center of the band
+ *
+ * @param[in]   num_channels    Number of channels
+ * @param[in]   channel         Channel, from 0 to num_channels - 1
+ *
+ * @return      Offset of the channel's center, in channel spacings
+ */
+int chan_offset(unsigned int num_channels, unsigned int channel);
+
+/**
+ * Create an analysis channelizer, which splits a wideband signal into channels
+ *
+ * @param[in]   num_channels        Number of channels, a power of 2 from 2 to
+ *                                  CHAN_MAX_CHANNELS
+ * @param[in]   taps_per_branch     Prototype filter length, in taps per channel, or
+ *                                  0 for CHAN_DEFAULT_TAPS_PER_BRANCH. Longer filters
+ *                                  have sharper channel edges, and cost more.
+ *
+ * @return      Channelizer on success, or NULL on failure or invalid parameter
+ */
+struct chan_analysis *chan_analysis_init(unsigned int num_channels,
+                                         unsigned int taps_per_branch);
+
+/**
+ * Free an analysis channelizer. Does nothing if chan is NULL.
+ *
+ * @param[in]   chan        Channelizer to free
+ */
+void chan_analysis_deinit(struct chan_analysis *chan);
+
+/**
+ * Split wideband samples into channels. The channelizer's state carries over between
+ * calls, so a stream may be split into blocks of any size.
+ *
+ * @param[in]   chan        Channelizer
+ * @param[in]   input       Wideband SC16 Q11 samples
+ * @param[in]   count       Number of wideband samples
+ * @param[out]  outputs     One buffer of SC16 Q11 samples per channel. Each must have
+ *                          room for count / num_channels + 1 samples.
+ *
+ * @return      Number of samples written to each channel's buffer
+ */
+size_t chan_analyze(struct chan_analysis *chan, const int16_t *input, size_t count,
+                    int16_t *const *outputs);
+
+/**
+ * Create a synthesis channelizer, which combines channels into a wideband signal
+ *
+ * Each channel appears in the wideband signal at 1/num_channels of its amplitude, so
+ * that every channel may transmit at full scale at once without clipping.
+ *
+ * @param[in]   num_channels        Number of channels, a power of 2 from 2 to
+ *                                  CHAN_MAX_CHANNELS
+ * @param[in]   taps_per_branch     As for chan_analysis_init()
+ *
+ * @return      Channelizer on success, or NULL on failure or invalid parameter
+ */
+struct chan_synthesis *chan_synthesis_init(unsigned int num_channels,
+                                           unsigned int taps_per_branch);
+
+/**
+ * Free a synthesis channelizer. Does nothing if chan is NULL.
+ *
+ * @param[in]   chan        Channelizer to free
+ */
+void chan_synthesis_deinit(struct chan_synthesis *chan);
+
+/**
+ * Combine channels into wideband samples. The channelizer's state carries over between
+ * calls.
+ *
+ * @param[in]   chan        Channelizer
+ * @param[in]   inputs      One buffer of count SC16 Q11 samples per channel. A NULL
+ *                          buffer is treated as silence.
+ * @param[in]   count       Number of samples per channel
+ * @param[out]  output      Buffer for count * num_channels wideband SC16 Q11 samples
+ */
+void chan_synthesize(struct chan_synthesis *chan, const int16_t *const *inputs,
+                     size_t count, int16_t *output);
+
+#endif
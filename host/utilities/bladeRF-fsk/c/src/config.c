@@ -29,6 +29,7 @@
 
 #include "config.h"
 #include "conversions.h"
+#include "link.h"
 
 #ifdef DEBUG_CONFIG
 #   define pr_dbg(...) fprintf(stderr, "[CONFIG] " __VA_ARGS__)
@@ -36,11 +37,12 @@
 #   define pr_dbg(...) do {} while (0)
 #endif
 
-#define OPTIONS "hd:r:o:t:i:q"
+#define OPTIONS "hd:r:o:t:i:qw:"
 
 #define OPTION_HELP     'h'
 #define OPTION_DEVICE   'd'
 #define OPTION_QUIET    'q'
+#define OPTION_WINDOW   'w'
 
 #define OPTION_RXFREQ   'r'
 #define OPTION_INPUT    'i'
@@ -66,6 +68,7 @@ static struct option long_options[] = {
     { "help",     no_argument,        NULL,   OPTION_HELP     },
     { "device",   required_argument,  NULL,   OPTION_DEVICE   },
     { "quiet",    no_argument,        NULL,   OPTION_QUIET    },
+    { "window",   required_argument,  NULL,   OPTION_WINDOW   },
 
     { "output",   required_argument,  NULL,   OPTION_OUTPUT   },
     { "rx-lna",   required_argument,  NULL,   OPTION_RXLNA    },
@@ -123,6 +126,9 @@ static struct config *alloc_config_with_defaults()
     config->params.tx_vga1_gain    = TX_VGA1_DEFAULT;
     config->params.tx_vga2_gain    = TX_VGA2_DEFAULT;
 
+    /* Link defaults */
+    config->window_size         = LINK_DEFAULT_WINDOW;
+
     return config;
 }
 
@@ -321,6 +327,17 @@ int config_init_from_cmdline(int argc, char * const argv[],
             case OPTION_QUIET:
                 config->quiet = true;
                 break;
+
+            case OPTION_WINDOW:
+                config->window_size =
+                    str2uint(optarg, 1, LINK_MAX_WINDOW, &valid);
+
+                if (!valid) {
+                    status = -1;
+                    fprintf(stderr, "Invalid window size: %s\n", optarg);
+                    goto out;
+                }
+                break;
         }
     }
 
@@ -373,6 +390,8 @@ void config_print_options()
 "   -d, --device <str>      Open the specified bladeRF device.\n"
 "                            Any available device is used if not specified.\n"
 "   -q, --quiet             Suppress printing of banner/exit messages.\n"
+"   -w, --window <n>        Number of frames which may await acknowledgement\n"
+"                            at once. Range: 1 to %d. Default: %d\n"
 "\n"
 "   -r, --rx-freq <freq>    RX frequency in Hz. Default: %d\n"
 "   -o, --output <file>     RX data output. stdout is used if not specified.\n"
@@ -385,6 +404,8 @@ void config_print_options()
 "   --tx-vga1 <value>       TX VGA1 gain. Range: %d to %d. Default = %d.\n"
 "   --tx-vga2 <value>       TX VGA2 gain. Range: %d to %d. Default = %d.\n",
 
+    LINK_MAX_WINDOW, LINK_DEFAULT_WINDOW,
+
     RX_FREQ_DEFAULT,
     BLADERF_RXVGA1_GAIN_MIN, BLADERF_RXVGA1_GAIN_MAX, RX_VGA1_DEFAULT,
     BLADERF_RXVGA2_GAIN_MIN, BLADERF_RXVGA2_GAIN_MAX, RX_VGA2_DEFAULT,
@@ -423,6 +444,9 @@ void print_config(const struct config *config)
     printf("    VGA1 gain:      %d\n", config->params.tx_vga1_gain);
     printf("    VGA2 gain:      %d\n", config->params.tx_vga2_gain);
     printf("\n");
+    printf("Link Parameters:\n");
+    printf("    Window size:    %u\n", config->window_size);
+    printf("\n");
 }
 
 int main(int argc, char *argv[])
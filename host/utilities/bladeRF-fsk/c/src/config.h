@@ -37,6 +37,7 @@ struct config {
     FILE *tx_input;                 //File to read transmitted data from
     long int tx_filesize;           //Size of the tx_input file, if it is not stdin
     bool quiet;                     //Option to suppress printing of banner message
+    unsigned int window_size;       //Link layer window size
 };
 
 
@@ -28,9 +28,24 @@
 #include <string.h>
 #include <limits.h>
 #include <inttypes.h>
+#include <math.h>
 
 #include "correlator.h"
 #include "host_config.h"
+#include "sample_convert.h"
+
+#if DECIMATION_FACTOR != 2
+#error "The decimating sample conversions assume DECIMATION_FACTOR is 2"
+#endif
+
+#if defined(__SSE__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#   include <xmmintrin.h>
+#   define CORR_HAVE_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   include <arm_neon.h>
+#   define CORR_HAVE_NEON 1
+#endif
 
 #ifdef ENABLE_CORR_DEBUG_MSG
 #   define DBG(...) fprintf(stderr, "[Corr]  " __VA_ARGS__)
@@ -42,14 +57,22 @@
 
 #define LOG_FILE_SUFFIX  "_correlator_log.csv"
 
+/* Direct-form taps are padded to a multiple of this, the SIMD width */
+#define CORR_VEC_LEN 4
+
+/* The FFT length is the smallest power of two that is at least this many
+ * times the reference length. Each transform then yields outputs for
+ * roughly 3/4 of its length. */
+#define CORR_FFT_OVERLAP 4
+
 struct complexf {
     float real;
     float imag;
 };
 
 struct correlator {
-    struct complexf *ref;       /* Reference signal to correlate against */
     size_t len;                 /* Length of reference sig, insamples */
+    enum corr_mode mode;        /* CORR_MODE_DIRECT or CORR_MODE_FFT */
 
     float threshold_pwr;        /* Correlation power threshold */
 
@@ -67,10 +90,26 @@ struct correlator {
     uint64_t match_timestamp;   /* Timestamp when we found our max
                                  * correlation value */
 
-    struct complexf *buf;       /* Sample buffer */
-    struct complexf *ins1;      /* Insertion points */
-    struct complexf *ins2;
-    struct complexf *end;       /* Pointer to element past buf */
+    /* Direct form. The conjugated reference is split into real and
+     * imaginary parts and front-padded with zeros to `taps` entries. The
+     * sample buffer shares this layout, and is 2x as a means to implement a
+     * shift register using a moving insertion point: the last `taps`
+     * samples always start at buf_*[ins + 1]. */
+    size_t taps;
+    float *ref_re, *ref_im;
+    float *buf_re, *buf_im;
+    size_t ins;
+
+    /* FFT overlap-save. Each transform of fft_len samples covers the last
+     * len - 1 samples of the previous block, followed by up to block_len
+     * new ones. */
+    size_t fft_len;
+    size_t block_len;
+    struct complexf *ref_fft;   /* Spectrum of the time-reversed reference,
+                                 * scaled by 1/fft_len */
+    struct complexf *twiddle;   /* fft_len/2 twiddle factors */
+    struct complexf *in;        /* History, followed by new samples */
+    struct complexf *seg;       /* Transform working buffer */
 
 #   ifdef LOG_CORRELATOR_OUTPUT
     FILE *out;
@@ -95,6 +134,113 @@ static void save_reference_sig(struct complexf *ref, size_t len)
 }
 #endif
 
+/* In-place, iterative radix-2 decimation-in-time FFT */
+static void fft(struct complexf *x, size_t n, const struct complexf *twiddle)
+{
+    size_t i, j, k, bit, size, half, step;
+    struct complexf tmp;
+
+    for (i = 1, j = 0; i < n; i++) {
+        for (bit = n >> 1; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+
+        if (i < j) {
+            tmp  = x[i];
+            x[i] = x[j];
+            x[j] = tmp;
+        }
+    }
+
+    for (size = 2; size <= n; size <<= 1) {
+        half = size / 2;
+        step = n / size;
+
+        for (i = 0; i < n; i += size) {
+            struct complexf *a = &x[i];
+            struct complexf *b = &x[i + half];
+
+            for (k = 0; k < half; k++) {
+                const struct complexf w = twiddle[k * step];
+                const float re = b[k].real * w.real - b[k].imag * w.imag;
+                const float im = b[k].real * w.imag + b[k].imag * w.real;
+
+                b[k].real = a[k].real - re;
+                b[k].imag = a[k].imag - im;
+                a[k].real += re;
+                a[k].imag += im;
+            }
+        }
+    }
+}
+
+static int init_direct(struct correlator *corr, const struct complexf *ref)
+{
+    size_t i, pad;
+
+    corr->taps = (corr->len + CORR_VEC_LEN - 1) & ~(size_t)(CORR_VEC_LEN - 1);
+    pad = corr->taps - corr->len;
+
+    corr->ref_re = calloc(corr->taps, sizeof(float));
+    corr->ref_im = calloc(corr->taps, sizeof(float));
+    corr->buf_re = calloc(2 * corr->taps, sizeof(float));
+    corr->buf_im = calloc(2 * corr->taps, sizeof(float));
+
+    if (corr->ref_re == NULL || corr->ref_im == NULL ||
+        corr->buf_re == NULL || corr->buf_im == NULL) {
+        perror("calloc");
+        return -1;
+    }
+
+    for (i = 0; i < corr->len; i++) {
+        corr->ref_re[pad + i] = ref[i].real;
+        corr->ref_im[pad + i] = ref[i].imag;
+    }
+
+    return 0;
+}
+
+static int init_fft(struct correlator *corr, const struct complexf *ref)
+{
+    const double pi = 3.14159265358979323846;
+    size_t i;
+
+    for (corr->fft_len = 1; corr->fft_len < CORR_FFT_OVERLAP * corr->len;
+         corr->fft_len <<= 1);
+
+    corr->block_len = corr->fft_len - corr->len + 1;
+
+    corr->ref_fft = calloc(corr->fft_len, sizeof(corr->ref_fft[0]));
+    corr->twiddle = malloc(corr->fft_len / 2 * sizeof(corr->twiddle[0]));
+    corr->in      = calloc(corr->fft_len, sizeof(corr->in[0]));
+    corr->seg     = malloc(corr->fft_len * sizeof(corr->seg[0]));
+
+    if (corr->ref_fft == NULL || corr->twiddle == NULL ||
+        corr->in == NULL || corr->seg == NULL) {
+        perror("malloc");
+        return -1;
+    }
+
+    for (i = 0; i < corr->fft_len / 2; i++) {
+        const double theta = -2.0 * pi * i / corr->fft_len;
+        corr->twiddle[i].real = (float)cos(theta);
+        corr->twiddle[i].imag = (float)sin(theta);
+    }
+
+    /* The newest sample pairs with the last reference sample, so the
+     * filter is the time-reversed (conjugated) reference. The 1/fft_len
+     * inverse transform scaling is folded in here. */
+    for (i = 0; i < corr->len; i++) {
+        corr->ref_fft[i].real = ref[corr->len - 1 - i].real / corr->fft_len;
+        corr->ref_fft[i].imag = ref[corr->len - 1 - i].imag / corr->fft_len;
+    }
+
+    fft(corr->ref_fft, corr->fft_len, corr->twiddle);
+
+    return 0;
+}
+
 struct correlator *corr_init(uint8_t *syms, size_t n, unsigned int sps)
 {
     int status = -1;
@@ -102,6 +248,7 @@ struct correlator *corr_init(uint8_t *syms, size_t n, unsigned int sps)
     struct correlator *ret = NULL;
     struct fsk_handle *fsk = NULL;
     struct complex_sample *raw_samples = NULL;
+    struct complexf *ref = NULL;
 #ifdef LOG_CORRELATOR_OUTPUT
     char log_name[] = "correlator_log.csv";
 #endif
@@ -131,21 +278,15 @@ struct correlator *corr_init(uint8_t *syms, size_t n, unsigned int sps)
     //Length is the ceiling of (sps*n/DECIMATION_FACTOR)
     ret->len = 1 + (sps*n-1)/DECIMATION_FACTOR;
 
-    ret->ref = malloc(ret->len * sizeof(ret->ref[0]));
-    if (ret->ref == NULL) {
+    ref = malloc(ret->len * sizeof(ref[0]));
+    if (ref == NULL) {
         perror("malloc");
         goto out;
     }
 
-    /* Buffer is 2x as a means to implement a shift register using
-     * moving insertion points */
-    ret->buf = malloc(2 * ret->len * sizeof(ret->buf[0]));
-    if (ret->buf == NULL) {
-        perror("malloc");
-        goto out;
-    }
-
-    raw_samples = malloc(sps * n * sizeof(raw_samples[0]));
+    /* The modulator always produces SAMP_PER_SYMB samples per symbol */
+    raw_samples = malloc((sps > SAMP_PER_SYMB ? sps : SAMP_PER_SYMB) * n *
+                         sizeof(raw_samples[0]));
     if (raw_samples == NULL) {
         perror("malloc");
         goto out;
@@ -159,28 +300,29 @@ struct correlator *corr_init(uint8_t *syms, size_t n, unsigned int sps)
     }
     fsk_mod(fsk, syms, (int)n/8, raw_samples);
     //Convert sc16q11 to complexf and decimate
-       for (i = 0; i < ret->len; i ++){
-        ret->ref[i].real = raw_samples[i*DECIMATION_FACTOR].i/2048.0f;
-        ret->ref[i].imag = raw_samples[i*DECIMATION_FACTOR].q/2048.0f;
-       }
+    sc16q11_to_float_decim2(&raw_samples[0].i, &ref[0].real, ret->len);
 
     /* Take the complex conjugate of our modulated reference signal
      * to avoid needing to do this each time we perform a dot product
      * operation later */
     for (i = 0; i < ret->len; i++) {
-        ret->ref[i].imag = -ret->ref[i].imag;
+        ref[i].imag = -ref[i].imag;
+    }
+
+    /* Both forms are set up, so that corr_set_mode() can't fail */
+    if (init_direct(ret, ref) != 0 || init_fft(ret, ref) != 0) {
+        goto out;
     }
 
-    ret->end = &ret->buf[2 * ret->len];
     //Maximum power is ret->len/DECIMATION_FACTOR * ret->len/DECIMATION_FACTOR
     ret->threshold_pwr = ret->len * ret->len * 0.5625f;
 
     ret->num_counts = sps/DECIMATION_FACTOR - 1;
 
-    corr_reset(ret);
+    corr_set_mode(ret, CORR_MODE_AUTO);
 
 #   ifdef LOG_CORRELATION_SIGNAL
-    save_reference_sig(ret->ref, ret->len);
+    save_reference_sig(ref, ret->len);
 #   endif
 
     status = 0;
@@ -188,6 +330,8 @@ struct correlator *corr_init(uint8_t *syms, size_t n, unsigned int sps)
     DBG("Correlator decimation factor = %u\n", DECIMATION_FACTOR);
     DBG("Correlator length: %zd symbols (%zd samples)\n",
         n, ret->len);
+    DBG("Correlator mode: %s (FFT length %zd)\n",
+        ret->mode == CORR_MODE_FFT ? "FFT" : "direct", ret->fft_len);
 
     DBG("Correlator power threshold: %f\n", ret->threshold_pwr);
 
@@ -200,6 +344,7 @@ out:
 
     fsk_close(fsk);
     free(raw_samples);
+    free(ref);
 
     return ret;
 }
@@ -207,8 +352,14 @@ out:
 void corr_deinit(struct correlator *corr)
 {
     if (corr) {
-        free(corr->ref);
-        free(corr->buf);
+        free(corr->ref_re);
+        free(corr->ref_im);
+        free(corr->buf_re);
+        free(corr->buf_im);
+        free(corr->ref_fft);
+        free(corr->twiddle);
+        free(corr->in);
+        free(corr->seg);
 
 #       ifdef LOG_CORRELATOR_OUTPUT
         if (corr->out != NULL) {
@@ -220,103 +371,242 @@ void corr_deinit(struct correlator *corr)
     }
 }
 
-static inline void reset_insertion_points(struct correlator *corr)
-{
-    corr->ins1 = corr->buf;
-    corr->ins2 = corr->buf + corr->len;
-}
-
 void corr_reset(struct correlator *corr)
 {
-    size_t i;
-
     if (corr != NULL) {
-        reset_insertion_points(corr);
         corr->match_timestamp = CORRELATOR_NO_RESULT;
         corr->max = corr->threshold_pwr;
         corr->countdown = COUNTDOWN_INACTIVE;
 
-        for (i = 0; i < (2 * corr->len); i++) {
-            corr->buf[i].real = corr->buf[i].imag = 0.0f;
+        corr->ins = 0;
+        memset(corr->buf_re, 0, 2 * corr->taps * sizeof(float));
+        memset(corr->buf_im, 0, 2 * corr->taps * sizeof(float));
+        memset(corr->in, 0, (corr->len - 1) * sizeof(corr->in[0]));
+    }
+}
+
+void corr_set_mode(struct correlator *corr, enum corr_mode mode)
+{
+    if (mode == CORR_MODE_AUTO) {
+        mode = (corr->len >= CORR_FFT_MIN_LEN) ? CORR_MODE_FFT
+                                               : CORR_MODE_DIRECT;
+    }
+
+    corr->mode = mode;
+    corr_reset(corr);
+}
+
+enum corr_mode corr_get_mode(const struct correlator *corr)
+{
+    return corr->mode;
+}
+
+/* Update the peak search with the correlation power of the sample at
+ * `timestamp'. Returns true, with the correlator reset, once a match is
+ * acquired. */
+static inline bool check_peak(struct correlator *corr, float result_pwr,
+                              uint64_t timestamp, uint64_t *detected)
+{
+#   ifdef LOG_CORRELATOR_OUTPUT
+    fprintf(corr->out, "%f, %"PRIu64"\n", result_pwr, timestamp);
+#   endif
+
+    if (result_pwr > corr->max) {
+        corr->max = result_pwr;
+        corr->countdown = corr->num_counts;
+        corr->match_timestamp = timestamp;
+
+        DBG("Got a match at %"PRIu64", result_pwr=%f. Resetting countdown.\n",
+            timestamp, result_pwr);
+
+    } else if (corr->countdown != COUNTDOWN_INACTIVE) {
+        //Find the peak
+
+        if (--corr->countdown == 0) {
+            /* We have a result! */
+            *detected = corr->match_timestamp;
+
+            DBG("Countdown complete. Acquired at: %"PRIu64"\n", *detected);
+
+            corr_reset(corr);
+            return true;
+        } else {
+            DBG("Countdown @ %u\n", corr->countdown);
         }
     }
+
+    return false;
 }
 
-uint64_t corr_process(struct correlator *corr,
-                      const struct complex_sample *samples, size_t n,
-                      uint64_t timestamp)
+/* Correlation power of the `n` (a multiple of CORR_VEC_LEN) most recent
+ * samples in `re`/`im` against the reference */
+static inline float dot_pwr(const float *ref_re, const float *ref_im,
+                            const float *re, const float *im, size_t n)
 {
-    size_t i, j;
+    size_t j;
+    float real, imag;
+
+#if defined(CORR_HAVE_SSE)
+    __m128 acc_re = _mm_setzero_ps();
+    __m128 acc_im = _mm_setzero_ps();
+    float tmp[4];
+
+    for (j = 0; j < n; j += 4) {
+        const __m128 rr = _mm_loadu_ps(&ref_re[j]);
+        const __m128 ri = _mm_loadu_ps(&ref_im[j]);
+        const __m128 br = _mm_loadu_ps(&re[j]);
+        const __m128 bi = _mm_loadu_ps(&im[j]);
+
+        acc_re = _mm_add_ps(acc_re, _mm_sub_ps(_mm_mul_ps(rr, br),
+                                               _mm_mul_ps(ri, bi)));
+        acc_im = _mm_add_ps(acc_im, _mm_add_ps(_mm_mul_ps(rr, bi),
+                                               _mm_mul_ps(ri, br)));
+    }
 
+    _mm_storeu_ps(tmp, acc_re);
+    real = (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+    _mm_storeu_ps(tmp, acc_im);
+    imag = (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+#elif defined(CORR_HAVE_NEON)
+    float32x4_t acc_re = vdupq_n_f32(0.0f);
+    float32x4_t acc_im = vdupq_n_f32(0.0f);
+    float tmp[4];
+
+    for (j = 0; j < n; j += 4) {
+        const float32x4_t rr = vld1q_f32(&ref_re[j]);
+        const float32x4_t ri = vld1q_f32(&ref_im[j]);
+        const float32x4_t br = vld1q_f32(&re[j]);
+        const float32x4_t bi = vld1q_f32(&im[j]);
+
+        acc_re = vmlaq_f32(acc_re, rr, br);
+        acc_re = vmlsq_f32(acc_re, ri, bi);
+        acc_im = vmlaq_f32(acc_im, rr, bi);
+        acc_im = vmlaq_f32(acc_im, ri, br);
+    }
+
+    vst1q_f32(tmp, acc_re);
+    real = (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+    vst1q_f32(tmp, acc_im);
+    imag = (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+#else
+    real = imag = 0.0f;
+
+    for (j = 0; j < n; j++) {
+        real += ref_re[j] * re[j] - ref_im[j] * im[j];
+        imag += ref_re[j] * im[j] + ref_im[j] * re[j];
+    }
+#endif
+
+    return real * real + imag * imag;
+}
+
+static uint64_t process_direct(struct correlator *corr,
+                               const struct complex_sample *samples, size_t n,
+                               uint64_t timestamp)
+{
+    const size_t taps = corr->taps;
     uint64_t detected = CORRELATOR_NO_RESULT;
+    size_t i;
 
     for (i = 0; i < n; i += DECIMATION_FACTOR) {
-        struct complexf *ref = corr->ref + corr->len - 1;
-        struct complexf *buf = corr->ins2;
-        struct complexf result;
         float result_pwr;
 
         /* Insert sample */
         //Scale by 1/2048
-        corr->ins1->real = corr->ins2->real = samples[i].i/2048.0f;
-        corr->ins1->imag = corr->ins2->imag = samples[i].q/2048.0f;
-
-        result.real = result.imag = 0;
+        corr->buf_re[corr->ins] = corr->buf_re[corr->ins + taps] =
+            samples[i].i / SC16Q11_SCALE;
+        corr->buf_im[corr->ins] = corr->buf_im[corr->ins + taps] =
+            samples[i].q / SC16Q11_SCALE;
 
         /* Cross correlate */
-        for (j = 0; j < corr->len; j ++) {
-            result.real += ref->real * buf->real - ref->imag * buf->imag;
-            result.imag += ref->real * buf->imag + ref->imag * buf->real;
+        result_pwr = dot_pwr(corr->ref_re, corr->ref_im,
+                             &corr->buf_re[corr->ins + 1],
+                             &corr->buf_im[corr->ins + 1], taps);
 
-            ref--;
-            buf--;
+        if (check_peak(corr, result_pwr, timestamp, &detected)) {
+            return detected;
         }
 
-        result_pwr = result.real * result.real + result.imag * result.imag;
+        /* Update insertion point */
+        if (++corr->ins == taps) {
+            corr->ins = 0;
+        }
 
-#       ifdef LOG_CORRELATOR_OUTPUT
-        fprintf(corr->out, "%f, %"PRIu64"\n", result_pwr, timestamp);
-#       endif
+        /* Update record of which timestamp we're on...*/
+        timestamp += DECIMATION_FACTOR;
+    }
 
-        if (result_pwr > corr->max) {
-            corr->max = result_pwr;
-            corr->countdown = corr->num_counts;
-            corr->match_timestamp = timestamp;
+    return detected;
+}
 
-            DBG("Got a match at %"PRIu64", result_pwr=%f. Resetting countdown.\n",
-                timestamp, result_pwr);
+static uint64_t process_fft(struct correlator *corr,
+                            const struct complex_sample *samples, size_t n,
+                            uint64_t timestamp)
+{
+    const size_t hist = corr->len - 1;
+    struct complexf *in = corr->in;
+    struct complexf *seg = corr->seg;
+    uint64_t detected = CORRELATOR_NO_RESULT;
+    size_t i = 0, j, count;
 
-        } else if (corr->countdown != COUNTDOWN_INACTIVE) {
-            //Find the peak
+    while (i < n) {
+        /* Gather the next block of decimated samples after the history */
+        count = (n - i + DECIMATION_FACTOR - 1) / DECIMATION_FACTOR;
+        if (count > corr->block_len) {
+            count = corr->block_len;
+        }
 
-            if (--corr->countdown == 0) {
-                /* We have a result! Exit early with it */
-                detected = corr->match_timestamp;
+        sc16q11_to_float_decim2(&samples[i].i, &in[hist].real, count);
+        i += count * DECIMATION_FACTOR;
 
-                DBG("Countdown complete. Acquired at: %"PRIu64"\n", detected);
+        memcpy(seg, in, (hist + count) * sizeof(seg[0]));
+        memset(&seg[hist + count], 0,
+               (corr->fft_len - hist - count) * sizeof(seg[0]));
 
-                corr_reset(corr);
+        /* The inverse transform is computed as the conjugate of the forward
+         * transform of the conjugate. Only the power of each output is of
+         * interest, so the final conjugation is skipped. */
+        fft(seg, corr->fft_len, corr->twiddle);
+
+        for (j = 0; j < corr->fft_len; j++) {
+            const struct complexf h = corr->ref_fft[j];
+            const struct complexf x = seg[j];
+
+            seg[j].real = x.real * h.real - x.imag * h.imag;
+            seg[j].imag = -(x.real * h.imag + x.imag * h.real);
+        }
+
+        fft(seg, corr->fft_len, corr->twiddle);
+
+        /* The first `hist` outputs wrap around the block and are dropped */
+        for (j = 0; j < count; j++) {
+            const struct complexf y = seg[hist + j];
+            const float result_pwr = y.real * y.real + y.imag * y.imag;
+
+            if (check_peak(corr, result_pwr, timestamp, &detected)) {
                 return detected;
-            } else {
-                DBG("Countdown @ %u\n", corr->countdown);
             }
-        }
 
-        /* Update insertion points */
-        corr->ins2++;
-        if (corr->ins2 == corr->end) {
-            reset_insertion_points(corr);
-        } else {
-            corr->ins1++;
+            timestamp += DECIMATION_FACTOR;
         }
 
-        /* Update record of which timestamp we're on...*/
-        timestamp += 2;
+        memmove(in, &in[count], hist * sizeof(in[0]));
     }
 
     return detected;
 }
 
+uint64_t corr_process(struct correlator *corr,
+                      const struct complex_sample *samples, size_t n,
+                      uint64_t timestamp)
+{
+    if (corr->mode == CORR_MODE_FFT) {
+        return process_fft(corr, samples, n, timestamp);
+    } else {
+        return process_direct(corr, samples, n, timestamp);
+    }
+}
+
 #ifdef CORRELATOR_TEST
 #include <string.h>
 #include <errno.h>
@@ -324,6 +614,98 @@ uint64_t corr_process(struct correlator *corr,
 
 static uint8_t code_a[] = { 0x2E, 0x69, 0x2C, 0xF0 };
 
+static const char *mode_str(enum corr_mode mode)
+{
+    return mode == CORR_MODE_FFT ? "FFT" : "direct";
+}
+
+static double elapsed(const struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (now.tv_sec - start->tv_sec) +
+           (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/* Bury the code in noise, check that each mode acquires it at the same
+ * point, and then time each mode over noise alone */
+static int run_throughput(unsigned int sps, size_t num_samples)
+{
+    const enum corr_mode modes[] = { CORR_MODE_DIRECT, CORR_MODE_FFT };
+    const size_t code_len = 8 * sizeof(code_a) * SAMP_PER_SYMB;
+    const size_t offset = num_samples / 2;
+    struct complex_sample *samples = NULL;
+    struct correlator *corr = NULL;
+    struct fsk_handle *fsk = NULL;
+    uint64_t acquisition[2];
+    uint64_t total;
+    struct timespec start;
+    double secs;
+    size_t i, m;
+    int status = -1;
+
+    if (num_samples < 2 * code_len) {
+        fprintf(stderr, "At least %zd samples are required.\n", 2 * code_len);
+        return -1;
+    }
+
+    samples = calloc(num_samples, sizeof(samples[0]));
+    fsk = fsk_init();
+    corr = corr_init(code_a, 8 * sizeof(code_a), sps);
+    if (samples == NULL || fsk == NULL || corr == NULL) {
+        fprintf(stderr, "Failed to initialize test.\n");
+        goto out;
+    }
+
+    fsk_mod(fsk, code_a, sizeof(code_a), &samples[offset]);
+
+    srand(1);
+    for (i = 0; i < num_samples; i++) {
+        samples[i].i += (int16_t)(rand() % 513 - 256);
+        samples[i].q += (int16_t)(rand() % 513 - 256);
+    }
+
+    for (m = 0; m < 2; m++) {
+        corr_set_mode(corr, modes[m]);
+
+        acquisition[m] = corr_process(corr, samples, num_samples, 0);
+        if (acquisition[m] == CORRELATOR_NO_RESULT) {
+            printf("%s: correlation symbols not found.\n",
+                   mode_str(modes[m]));
+            goto out;
+        }
+
+        printf("%s: acquired code at %"PRIu64"\n", mode_str(modes[m]),
+               acquisition[m]);
+
+        corr_reset(corr);
+        total = 0;
+        clock_gettime(CLOCK_REALTIME, &start);
+
+        do {
+            corr_process(corr, samples, offset, total);
+            total += offset;
+            secs = elapsed(&start);
+        } while (secs < 1.0);
+
+        printf("%s: %.2f Msps\n", mode_str(modes[m]), total / secs / 1e6);
+    }
+
+    if (acquisition[0] != acquisition[1]) {
+        fprintf(stderr, "Acquisition mismatch between modes.\n");
+        goto out;
+    }
+
+    status = 0;
+
+out:
+    corr_deinit(corr);
+    fsk_close(fsk);
+    free(samples);
+    return status;
+}
+
 int main(int argc, char *argv[])
 {
     FILE *in = NULL;
@@ -338,8 +720,14 @@ int main(int argc, char *argv[])
 
     int num_samples;
 
+    if (argc >= 3 && !strcmp(argv[1], "-t")) {
+        size_t n = (argc > 3) ? strtoul(argv[3], NULL, 0) : 1000000;
+        return run_throughput(atoi(argv[2]), n) == 0 ? 0 : EXIT_FAILURE;
+    }
+
     if (argc != 3) {
         fprintf(stderr, "Usage: %s <CSV input file> <sps>\n", argv[0]);
+        fprintf(stderr, "       %s -t <sps> [num samples]\n", argv[0]);
         return EXIT_FAILURE;
     }
 
@@ -35,6 +35,16 @@ struct correlator;
 //use every other sample. If 3 the correlator will use every third sample. And so on.
 #define DECIMATION_FACTOR 2
 
+/* References at least this many (decimated) samples long are correlated in
+ * the frequency domain by CORR_MODE_AUTO */
+#define CORR_FFT_MIN_LEN 64
+
+enum corr_mode {
+    CORR_MODE_AUTO,     /* Pick based upon the reference length */
+    CORR_MODE_DIRECT,   /* Direct-form dot product per output */
+    CORR_MODE_FFT,      /* FFT overlap-save, a block of outputs at a time */
+};
+
 /**
  * Create a correlator. This is currently limited to symbol lengths that are
  * a multiple of 8 (a byte).
@@ -47,6 +57,20 @@ struct correlator;
  */
 struct correlator *corr_init(uint8_t *syms, size_t n, unsigned int sps);
 
+/**
+ * Select how the correlation is computed. Both modes report the same
+ * matches; they differ only in throughput. This resets the correlator.
+ *
+ * @param   corr    Correlator handle
+ * @param   mode    Correlation mode
+ */
+void corr_set_mode(struct correlator *corr, enum corr_mode mode);
+
+/**
+ * Get the correlation mode in use. This is never CORR_MODE_AUTO.
+ */
+enum corr_mode corr_get_mode(const struct correlator *corr);
+
 /**
  * Deinitialize and deallocate the provided correlator
  */
@@ -23,47 +23,69 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <math.h>
 #include "host_config.h"
 
 #include "fir_filter.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define FIR_HAVE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   include <arm_neon.h>
+#   define FIR_HAVE_NEON 1
+#endif
+
 #ifdef ENABLE_FIR_FILTER_DEBUG_MSG
 #   define DBG(...) fprintf(stderr, "[FIR] " __VA_ARGS__)
 #else
 #   define DBG(...)
 #endif
 
-struct fir_filter {
+/* Each polyphase branch is zero-padded to a multiple of this, the SIMD
+ * width in taps */
+#define FIR_VEC_LEN 8
 
-    float *taps;        /* Filter taps */
-    size_t length;      /* Length of the filter, in taps */
+/* Input samples deinterleaved and filtered at a time */
+#define FIR_BLOCK_LEN 4096
 
-    /* Interpolation or decimation factor */
-    unsigned int factor;
+struct fir_filter {
 
-    /* Insertion points into "shift register" implementation that utilizes
-     * two copies of data to achieve a contiguious shifting window. */
-    size_t ins1;
-    size_t ins2;
+    size_t length;      /* Length of the filter, in taps */
 
-    /* Filter state buffers */
-    int32_t *i;
-    int32_t *q;
+    /* Interpolation and decimation factors */
+    unsigned int interp;
+    unsigned int decim;
+
+    /* Polyphase branches: `interp` rows of `phase_len` fixed-point taps.
+     * Each row is reversed, so that it lines up with a window of samples
+     * in time order, and is front-padded with zeros. */
+    int16_t *taps;
+    size_t phase_len;
+    unsigned int shift;  /* Fractional bits in `taps` */
+
+    /* Deinterleaved I and Q samples: the last phase_len - 1 samples of
+     * the previous block, followed by the current block */
+    int16_t *i;
+    int16_t *q;
+
+    /* Input index, relative to the current block, and polyphase branch of
+     * the next output */
+    size_t next;
+    unsigned int phase;
 };
 
-static void fir_reset(struct fir_filter *filt)
+void fir_reset(struct fir_filter *filt)
 {
-    size_t n;
+    const size_t hist = filt->phase_len - 1;
 
-    for (n = 0; n < (2 * filt->length); n++) {
-        filt->i[n] = 0;
-        filt->q[n] = 0;
-    }
+    memset(filt->i, 0, hist * sizeof(filt->i[0]));
+    memset(filt->q, 0, hist * sizeof(filt->q[0]));
 
-    /* Remember, state is 2 copies: array len is 2 * filt->length elts */
-    filt->ins1  = 0;
-    filt->ins2  = filt->length;
+    filt->next  = 0;
+    filt->phase = 0;
 }
 
 void fir_deinit(struct fir_filter *filt)
@@ -76,9 +98,19 @@ void fir_deinit(struct fir_filter *filt)
     }
 }
 
-struct fir_filter * fir_init(const float *taps, size_t length)
+struct fir_filter * fir_init_resampler(const float *taps, size_t length,
+                                       unsigned int interp,
+                                       unsigned int decim)
 {
     struct fir_filter *filt;
+    float max = 0.0f, sum = 0.0f;
+    size_t n, k, state_len;
+    unsigned int p;
+
+    if (taps == NULL || length == 0 || interp == 0 || decim == 0) {
+        fprintf(stderr, "[FIR] Invalid filter parameters.\n");
+        return NULL;
+    }
 
     filt = calloc(1, sizeof(filt[0]));
     if (!filt) {
@@ -86,89 +118,274 @@ struct fir_filter * fir_init(const float *taps, size_t length)
         return NULL;
     }
 
-    /* Filter state is a sliding window implemented with 2 copies of data */
-    filt->i = calloc(2 * length, sizeof(filt->i[0]));
-    if (!filt->i) {
+    filt->length = length;
+    filt->interp = interp;
+    filt->decim  = decim;
+
+    filt->phase_len = (length + interp - 1) / interp;
+    filt->phase_len = (filt->phase_len + FIR_VEC_LEN - 1) &
+                      ~((size_t)FIR_VEC_LEN - 1);
+
+    filt->taps = calloc(interp * filt->phase_len, sizeof(filt->taps[0]));
+    if (!filt->taps) {
         perror("calloc");
         fir_deinit(filt);
         return NULL;
     }
 
-    filt->q = calloc(2 * length, sizeof(filt->q[0]));
+    /* Filter state is the history, followed by a block of new samples */
+    state_len = filt->phase_len - 1 + FIR_BLOCK_LEN;
+
+    filt->i = calloc(state_len, sizeof(filt->i[0]));
     if (!filt->i) {
         perror("calloc");
         fir_deinit(filt);
         return NULL;
     }
 
-    filt->taps = calloc(length, sizeof(filt->taps[0]));
-    if (!filt->taps) {
+    filt->q = calloc(state_len, sizeof(filt->q[0]));
+    if (!filt->q) {
         perror("calloc");
         fir_deinit(filt);
         return NULL;
     }
 
-    memcpy(filt->taps, taps, length * sizeof(filt->taps[0]));
-    filt->length = length;
+    /* Use as many fractional bits as fit, while keeping a full-scale
+     * int16 input from overflowing a 32-bit accumulator */
+    for (n = 0; n < length; n++) {
+        max  = fmaxf(max, fabsf(taps[n]));
+        sum += fabsf(taps[n]);
+    }
+
+    for (filt->shift = 15; filt->shift > 0; filt->shift--) {
+        const float scale = (float)(1u << filt->shift);
+        if (max * scale < 32767.0f && sum * scale < 65536.0f) {
+            break;
+        }
+    }
+
+    for (n = 0; n < length; n++) {
+        p = (unsigned int)(n % interp);
+        k = n / interp;
+
+        filt->taps[p * filt->phase_len + filt->phase_len - 1 - k] =
+            (int16_t)lrintf(taps[n] * (float)(1u << filt->shift));
+    }
+
+    DBG("%zd taps, %u/%u, %zd taps per phase, Q%u\n", length, interp, decim,
+        filt->phase_len, filt->shift);
 
     fir_reset(filt);
     return filt;
 }
 
-void fir_process(struct fir_filter *f, int16_t *input,
-                    struct complex_sample *output, size_t count)
+struct fir_filter * fir_init(const float *taps, size_t length)
 {
-    /* Index into input/output buffers */
-    size_t inout_idx;
+    return fir_init_resampler(taps, length, 1, 1);
+}
+
+size_t fir_max_output(const struct fir_filter *filt, size_t count)
+{
+    return (count * filt->interp + filt->decim - 1) / filt->decim;
+}
+
+static inline int16_t fir_round(const struct fir_filter *f, int32_t acc)
+{
+    acc = (acc + (1 << f->shift >> 1)) >> f->shift;
+
+    if (acc > INT16_MAX) {
+        return INT16_MAX;
+    } else if (acc < INT16_MIN) {
+        return INT16_MIN;
+    }
+
+    return (int16_t)acc;
+}
 
-    /* Index into f->taps array */
+/* Apply `taps` to the `n` (a multiple of FIR_VEC_LEN) samples in `i` and
+ * `q`, in time order */
+static inline void fir_dot(const int16_t *taps, const int16_t *i,
+                           const int16_t *q, size_t n,
+                           int32_t *acc_i, int32_t *acc_q)
+{
     size_t t;
 
-    /* Index into f->i and f->q state arrays */
-    size_t s;
+#if defined(FIR_HAVE_SSE2)
+    __m128i sum_i = _mm_setzero_si128();
+    __m128i sum_q = _mm_setzero_si128();
 
-    for (inout_idx = 0; inout_idx < (2*count); inout_idx += 2) {
-        int32_t i = input[inout_idx];
-        int32_t q = input[inout_idx+1];
-        float result_i = 0;
-        float result_q = 0;
+    for (t = 0; t < n; t += 8) {
+        const __m128i h = _mm_loadu_si128((const __m128i *)&taps[t]);
 
-        /* Insert samples */
-        f->i[f->ins1] = f->i[f->ins2] = i;
-        f->q[f->ins1] = f->q[f->ins2] = q;
+        sum_i = _mm_add_epi32(sum_i, _mm_madd_epi16(h,
+                    _mm_loadu_si128((const __m128i *)&i[t])));
+        sum_q = _mm_add_epi32(sum_q, _mm_madd_epi16(h,
+                    _mm_loadu_si128((const __m128i *)&q[t])));
+    }
 
-        /* Convolve */
-        for (t = 0, s = f->ins2; t < f->length; t++, s--) {
-            float tmp_i, tmp_q;
+    /* Horizontal sums of both accumulators */
+    sum_i = _mm_add_epi32(_mm_unpacklo_epi32(sum_i, sum_q),
+                          _mm_unpackhi_epi32(sum_i, sum_q));
+    sum_i = _mm_add_epi32(sum_i, _mm_srli_si128(sum_i, 8));
+
+    *acc_i = _mm_cvtsi128_si32(sum_i);
+    *acc_q = _mm_cvtsi128_si32(_mm_srli_si128(sum_i, 4));
+#elif defined(FIR_HAVE_NEON)
+    int32x4_t sum_i = vdupq_n_s32(0);
+    int32x4_t sum_q = vdupq_n_s32(0);
+
+    for (t = 0; t < n; t += 8) {
+        const int16x8_t h  = vld1q_s16(&taps[t]);
+        const int16x8_t vi = vld1q_s16(&i[t]);
+        const int16x8_t vq = vld1q_s16(&q[t]);
+
+        sum_i = vmlal_s16(sum_i, vget_low_s16(h), vget_low_s16(vi));
+        sum_i = vmlal_s16(sum_i, vget_high_s16(h), vget_high_s16(vi));
+        sum_q = vmlal_s16(sum_q, vget_low_s16(h), vget_low_s16(vq));
+        sum_q = vmlal_s16(sum_q, vget_high_s16(h), vget_high_s16(vq));
+    }
 
-            tmp_i = f->taps[t] * f->i[s];
-            tmp_q = f->taps[t] * f->q[s];
+    *acc_i = vgetq_lane_s32(sum_i, 0) + vgetq_lane_s32(sum_i, 1) +
+             vgetq_lane_s32(sum_i, 2) + vgetq_lane_s32(sum_i, 3);
+    *acc_q = vgetq_lane_s32(sum_q, 0) + vgetq_lane_s32(sum_q, 1) +
+             vgetq_lane_s32(sum_q, 2) + vgetq_lane_s32(sum_q, 3);
+#else
+    int32_t sum_i = 0, sum_q = 0;
 
-            result_i += tmp_i;
-            result_q += tmp_q;
+    for (t = 0; t < n; t++) {
+        sum_i += (int32_t)taps[t] * i[t];
+        sum_q += (int32_t)taps[t] * q[t];
+    }
+
+    *acc_i = sum_i;
+    *acc_q = sum_q;
+#endif
+}
+
+size_t fir_resample(struct fir_filter *f, const int16_t *input,
+                    size_t count, struct complex_sample *output)
+{
+    const size_t hist = f->phase_len - 1;
+    size_t num_out = 0;
+    size_t block, n;
+    int32_t acc_i, acc_q;
+
+    while (count > 0) {
+        block = (count < FIR_BLOCK_LEN) ? count : FIR_BLOCK_LEN;
+
+        /* Deinterleave after the history */
+        for (n = 0; n < block; n++) {
+            f->i[hist + n] = input[2*n];
+            f->q[hist + n] = input[2*n + 1];
         }
 
-        /* Update output sample */
-        output[inout_idx/2].i = (int16_t) roundf(result_i);
-        output[inout_idx/2].q = (int16_t) roundf(result_q);
-
-        /* Advance insertion points */
-        f->ins2++;
-        if (f->ins2 == (2 * f->length)) {
-            f->ins1 = 0;
-            f->ins2 = f->length;
-        } else {
-            f->ins1++;
+        /* The window for input sample `next` starts at f->i[next] */
+        while (f->next < block) {
+            fir_dot(&f->taps[f->phase * f->phase_len],
+                    &f->i[f->next], &f->q[f->next], f->phase_len,
+                    &acc_i, &acc_q);
+
+            output[num_out].i = fir_round(f, acc_i);
+            output[num_out].q = fir_round(f, acc_q);
+            num_out++;
+
+            f->phase += f->decim;
+            f->next  += f->phase / f->interp;
+            f->phase %= f->interp;
         }
+
+        f->next -= block;
+
+        memmove(f->i, &f->i[block], hist * sizeof(f->i[0]));
+        memmove(f->q, &f->q[block], hist * sizeof(f->q[0]));
+
+        input += 2 * block;
+        count -= block;
     }
+
+    return num_out;
+}
+
+void fir_process(struct fir_filter *f, const int16_t *input,
+                    struct complex_sample *output, size_t count)
+{
+    fir_resample(f, input, count, output);
 }
 
 #ifdef FIR_FILTER_TEST
 #include <stdbool.h>
+#include <inttypes.h>
 #include "conversions.h"
 #include "rx_ch_filter.h"
 #include "utils.h"
 
+static double elapsed(const struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (now.tv_sec - start->tv_sec) +
+           (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/* Time the channel filter on noise at a few resampling ratios */
+static int run_throughput(size_t count)
+{
+    static const unsigned int ratios[][2] = { { 1, 1 }, { 1, 2 }, { 2, 1 } };
+    struct fir_filter *filt = NULL;
+    struct complex_sample *outbuf = NULL;
+    int16_t *inbuf = NULL;
+    struct timespec start;
+    uint64_t total;
+    double secs;
+    size_t n, r;
+    int status = EXIT_FAILURE;
+
+    inbuf  = malloc(2 * count * sizeof(inbuf[0]));
+    outbuf = malloc(2 * count * sizeof(outbuf[0]));
+    if (!inbuf || !outbuf) {
+        perror("malloc");
+        goto out;
+    }
+
+    srand(1);
+    for (n = 0; n < 2 * count; n++) {
+        inbuf[n] = (int16_t)(rand() % 4096 - 2048);
+    }
+
+    for (r = 0; r < sizeof(ratios) / sizeof(ratios[0]); r++) {
+        filt = fir_init_resampler(rx_ch_filter, rx_ch_filter_len,
+                                  ratios[r][0], ratios[r][1]);
+        if (!filt) {
+            fprintf(stderr, "Failed to allocate filter.\n");
+            goto out;
+        }
+
+        total = 0;
+        clock_gettime(CLOCK_REALTIME, &start);
+
+        do {
+            fir_resample(filt, inbuf, count, outbuf);
+            total += count;
+            secs = elapsed(&start);
+        } while (secs < 1.0);
+
+        printf("%u/%u: %.2f Msps in\n", ratios[r][0], ratios[r][1],
+               total / secs / 1e6);
+
+        fir_deinit(filt);
+        filt = NULL;
+    }
+
+    status = 0;
+
+out:
+    fir_deinit(filt);
+    free(inbuf);
+    free(outbuf);
+    return status;
+}
+
 int main(int argc, char *argv[])
 {
     int status              = EXIT_FAILURE;
@@ -186,6 +403,25 @@ int main(int argc, char *argv[])
     size_t n_read, n_written;
     bool done = false;
 
+    struct timespec start;
+    double secs = 0;
+    uint64_t total = 0;
+
+    if (argc >= 2 && !strcmp(argv[1], "-t")) {
+        bool valid = true;
+
+        if (argc > 2) {
+            chunk_size = str2uint(argv[2], 1, max_chunk_size, &valid);
+        }
+
+        if (!valid) {
+            fprintf(stderr, "Invalid chunk size: %s samples\n", argv[2]);
+            return EXIT_FAILURE;
+        }
+
+        return run_throughput(chunk_size);
+    }
+
     if (argc < 3 || argc > 4) {
         fprintf(stderr,
                 "Filter sc16q11 samples from <infile> and write"
@@ -195,6 +431,9 @@ int main(int argc, char *argv[])
                 "Usage: %s <infile> <outfile> [# chunk size(samples)]\n",
                 argv[0]);
 
+        fprintf(stderr,
+                "       %s -t [# chunk size(samples)]\n", argv[0]);
+
         return EXIT_FAILURE;
     }
 
@@ -246,7 +485,11 @@ int main(int argc, char *argv[])
         n_read = fread(inbuf, 2*sizeof(int16_t), chunk_size, infile);
         done = n_read != chunk_size;
 
+        clock_gettime(CLOCK_REALTIME, &start);
         fir_process(filt, inbuf, outbuf, n_read);
+        secs += elapsed(&start);
+        total += n_read;
+
         //convert
         conv_struct_to_samples(outbuf, (unsigned int) n_read, tempbuf);
 
@@ -258,6 +501,11 @@ int main(int argc, char *argv[])
         }
     }
 
+    if (secs > 0) {
+        printf("Filtered %"PRIu64" samples at %.2f Msps\n", total,
+               total / secs / 1e6);
+    }
+
     status = 0;
 
 out:
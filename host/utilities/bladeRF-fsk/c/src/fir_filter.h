@@ -28,7 +28,8 @@
 struct fir_filter;
 
 /**
- * Construct a FIR filter with provided taps and decimation factor
+ * Construct a FIR filter with provided taps. Each input sample produces one
+ * output sample.
  *
  * @param[in]   taps        Filter taps.
  *
@@ -39,6 +40,26 @@ struct fir_filter;
  */
 struct fir_filter * fir_init(const float *taps, size_t num_taps);
 
+/**
+ * Construct a polyphase FIR filter that resamples by interp/decim.
+ *
+ * The taps are designed at the interpolated rate, and are applied as-is, so
+ * interpolating filters should include a gain of `interp`. They are
+ * quantized to 16-bit fixed point, with as many fractional bits as the
+ * largest tap allows.
+ *
+ * @param[in]   taps        Filter taps.
+ * @param[in]   num_taps    Number of taps contained within `taps`
+ * @param[in]   interp      Interpolation factor, >= 1
+ * @param[in]   decim       Decimation factor, >= 1
+ *
+ * @return      `fir_filter` handle on success,
+ *              or NULL on failure or invalid parameter
+ */
+struct fir_filter * fir_init_resampler(const float *taps, size_t num_taps,
+                                       unsigned int interp,
+                                       unsigned int decim);
+
 /**
  * Deinitialize and deallocate the provided filter
  *
@@ -47,7 +68,26 @@ struct fir_filter * fir_init(const float *taps, size_t num_taps);
 void fir_deinit(struct fir_filter *filt);
 
 /**
- * Perform filter operation over the provided samples
+ * Clear the filter's history, as if it had only been given zeros
+ *
+ * @param   filt        Filter to reset
+ */
+void fir_reset(struct fir_filter *filt);
+
+/**
+ * Get the most output samples fir_resample() can produce from `count`
+ * input samples
+ *
+ * @param[in]   filt        Filter to use
+ * @param[in]   count       Number of input samples
+ *
+ * @return      Maximum number of output samples
+ */
+size_t fir_max_output(const struct fir_filter *filt, size_t count);
+
+/**
+ * Perform filter operation over the provided samples. The filter must have
+ * been created by fir_init().
  *
  * @parm[in]    filt        Filter to use
  *
@@ -56,7 +96,22 @@ void fir_deinit(struct fir_filter *filt);
  * @param[in]   count       Number samples to process
  *
  */
-void fir_process(struct fir_filter *filt, int16_t *input,
+void fir_process(struct fir_filter *filt, const int16_t *input,
                     struct complex_sample *output, size_t count);
 
+/**
+ * Filter and resample the provided samples. The resampling phase carries
+ * over between calls, so a stream may be split into blocks of any size.
+ *
+ * @param[in]   filt        Filter to use
+ * @param[in]   input       Input SC16Q11 samples
+ * @param[in]   count       Number of input samples
+ * @param[out]  output      Output SC16Q11 samples. Must have room for
+ *                          fir_max_output(filt, count) samples.
+ *
+ * @return      Number of output samples produced
+ */
+size_t fir_resample(struct fir_filter *filt, const int16_t *input,
+                    size_t count, struct complex_sample *output);
+
 #endif
@@ -24,9 +24,29 @@
  * with this program; if not, write to the Free Software Foundation, Inc.,
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
+#include <string.h>
+
 #include "host_config.h"
 #include "fsk.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define FSK_HAVE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define FSK_HAVE_NEON 1
+#endif
+
+//Number of phase changes computed at a time by the demodulator
+#define DISC_BLOCK_LEN 256
+
+//atan(a) ~= a*(A1 + A3*a^2 + A5*a^4 + A7*a^6) for a in [0,1]. Max error ~1e-5 rad.
+#define ATAN_A1  0.99997726f
+#define ATAN_A3 -0.33262347f
+#define ATAN_A5  0.19354346f
+#define ATAN_A7 -0.11643287f
+
 #ifdef DEBUG_MODE
     #define DEBUG_MSG(...) fprintf(stderr, __VA_ARGS__)
 #else
@@ -38,13 +58,21 @@ struct fsk_handle {
     struct complex_sample *sample_table;
     int points_per_rev;
     int samp_per_symb;
+    //Modulated waveform of every byte, from each phase a byte can start at. Entry
+    //(state*256 + byte) holds the byte's 8*samp_per_symb samples, and the state the
+    //byte ends at is in byte_table_next. State s is sample table position s*phase_step.
+    enum fsk_mod_mode mod_mode;
+    struct complex_sample *byte_table;
+    uint8_t *byte_table_next;
+    int phase_step;
     //These variables keep track of the demodulator's state when a call to fsk_demod()
     //did not fully demodulate the last byte, meaning it needs to be called again with
     //more samples to finish demodulating that last byte
     bool last_byte_demod_complete;  //False if the last byte was partially demodulated
                                     //in a call to fsk_demod()
     uint8_t last_byte;
-    double last_phase;
+    struct complex_sample last_sample;  //Last sample demodulated
+    enum fsk_demod_mode demod_mode;
     double curr_dphase_tot;
     int curr_samp_index;            //Current samples index (0 - SAMP_PER_SYMB-1)
     int curr_bit_index;
@@ -52,8 +80,14 @@ struct fsk_handle {
 
 //internal functions
 static struct complex_sample *fsk_gen_samples_table(int points_per_rev);
+static int fsk_gen_byte_table(struct fsk_handle *fsk);
+static unsigned int mod_byte(struct fsk_handle *fsk, uint8_t data, int *samp_table_pos,
+                                struct complex_sample *samples);
 static double angle(int i, int q);
 static void angle_unwrap(double angle_prev, double *angle);
+static void discriminate(enum fsk_demod_mode mode, struct complex_sample prev,
+                        const struct complex_sample *samples, int num_samples,
+                        float *dphase);
 
 /**
  * Generate 16bit two's complement IQ samples (SC16 Q11 format) corresponding to angles
@@ -108,49 +142,143 @@ static struct complex_sample *fsk_gen_samples_table(int points_per_rev)
     return sample_table;
 }
 
-unsigned int fsk_mod(struct fsk_handle *fsk, uint8_t *data_buf, int num_bytes,
-                        struct complex_sample *samples)
+/**
+ * Modulate one byte, symbol by symbol
+ *
+ * @param[in]       fsk             pointer to fsk handle
+ * @param[in]       data            byte to modulate
+ * @param[inout]    samp_table_pos  position in the samples table before/after the byte
+ * @param[out]      samples         buffer to place 8*samp_per_symb IQ samples in
+ *
+ * @return      number of IQ samples modulated
+ */
+static unsigned int mod_byte(struct fsk_handle *fsk, uint8_t data, int *samp_table_pos,
+                                struct complex_sample *samples)
 {
-
-    int samp_table_pos;        //current position in samples table
-    int byte;                //current byte (0-(num_bytes-1))
     int bit;                //current bit (0-7) in byte
-    int samp;                //current sample in symbol period (0-(samps_per_symb-1))
-    int i;                    //index in samples buffer
+    int samp;               //current sample in symbol period (0-(samps_per_symb-1))
+    int pos = *samp_table_pos;
+    unsigned int i = 0;     //index in samples buffer
 
-    //Set initial position to 0 (1 + 0j)
-    samp_table_pos = 0;
-    i = 0;
-    for (byte = 0; byte < num_bytes; byte++){
-        for (bit = 0; bit < 8; bit++){
-            //Check for 1
-            if ( ((data_buf[byte] >> bit) & 0x01) == 0x01 ){
-                //This bit is a 1. Rotate phase CCW
-                for (samp = 0; samp < fsk->samp_per_symb; samp++){
-                    if (samp_table_pos == fsk->points_per_rev - 1){
-                        samp_table_pos = 0;
-                    }else{
-                        samp_table_pos += 1;    //Increment phase
-                    }
-                    samples[i].i = fsk->sample_table[samp_table_pos].i;
-                    samples[i].q = fsk->sample_table[samp_table_pos].q;
-                    i++;
+    for (bit = 0; bit < 8; bit++){
+        //Check for 1
+        if ( ((data >> bit) & 0x01) == 0x01 ){
+            //This bit is a 1. Rotate phase CCW
+            for (samp = 0; samp < fsk->samp_per_symb; samp++){
+                if (pos == fsk->points_per_rev - 1){
+                    pos = 0;
+                }else{
+                    pos += 1;    //Increment phase
                 }
-            }else{
-                //This bit is a 0. Rotate phase CW
-                for (samp = 0; samp < fsk->samp_per_symb; samp++){
-                    if (samp_table_pos == 0){
-                        samp_table_pos = fsk->points_per_rev - 1;
-                    }else{
-                        samp_table_pos -= 1;    //Decrement phase
-                    }
-                    samples[i].i = fsk->sample_table[samp_table_pos].i;
-                    samples[i].q = fsk->sample_table[samp_table_pos].q;
-                    i++;
+                samples[i] = fsk->sample_table[pos];
+                i++;
+            }
+        }else{
+            //This bit is a 0. Rotate phase CW
+            for (samp = 0; samp < fsk->samp_per_symb; samp++){
+                if (pos == 0){
+                    pos = fsk->points_per_rev - 1;
+                }else{
+                    pos -= 1;    //Decrement phase
                 }
+                samples[i] = fsk->sample_table[pos];
+                i++;
             }
         }
     }
+    *samp_table_pos = pos;
+    return i;
+}
+
+/**
+ * Generate the byte waveform table. Each symbol rotates the phase by samp_per_symb
+ * points, so starting from position 0, bytes only ever start at multiples of
+ * gcd(points_per_rev, samp_per_symb). With 32 points and 8 samples per symbol, there
+ * are 4 such phase states, and the table is 4*256*64 samples (256 KiB).
+ *
+ * @return      0 on success, -1 on failure
+ */
+static int fsk_gen_byte_table(struct fsk_handle *fsk)
+{
+    unsigned int samp_per_byte = 8*fsk->samp_per_symb;
+    int a = fsk->points_per_rev, b = fsk->samp_per_symb, t;
+    int num_states, state, data, pos;
+    size_t entry;
+
+    //phase_step = gcd(points_per_rev, samp_per_symb)
+    while (b != 0){
+        t = a % b;
+        a = b;
+        b = t;
+    }
+    fsk->phase_step = a;
+    num_states = fsk->points_per_rev / fsk->phase_step;
+
+    fsk->byte_table = malloc(num_states * 256 * samp_per_byte *
+                                sizeof(struct complex_sample));
+    fsk->byte_table_next = malloc(num_states * 256);
+    if (fsk->byte_table == NULL || fsk->byte_table_next == NULL){
+        perror("malloc");
+        free(fsk->byte_table);
+        free(fsk->byte_table_next);
+        return -1;
+    }
+
+    for (state = 0; state < num_states; state++){
+        for (data = 0; data < 256; data++){
+            entry = (size_t) state*256 + data;
+            pos = state * fsk->phase_step;
+            mod_byte(fsk, (uint8_t) data, &pos, &fsk->byte_table[entry*samp_per_byte]);
+            fsk->byte_table_next[entry] = (uint8_t) (pos / fsk->phase_step);
+        }
+    }
+    return 0;
+}
+
+void fsk_set_mod_mode(struct fsk_handle *fsk, enum fsk_mod_mode mode)
+{
+    fsk->mod_mode = mode;
+}
+
+unsigned int fsk_mod(struct fsk_handle *fsk, uint8_t *data_buf, int num_bytes,
+                        struct complex_sample *samples)
+{
+    return fsk_mod_scrambled(fsk, data_buf, num_bytes, num_bytes, NULL, samples);
+}
+
+unsigned int fsk_mod_scrambled(struct fsk_handle *fsk, const uint8_t *data_buf,
+                                int num_bytes, int scramble_start,
+                                const uint8_t *scrambling_sequence,
+                                struct complex_sample *samples)
+{
+    const unsigned int samp_per_byte = 8*fsk->samp_per_symb;
+    const size_t entry_size = samp_per_byte * sizeof(struct complex_sample);
+    int samp_table_pos = 0;     //Set initial position to 0 (1 + 0j)
+    unsigned int state = 0;     //Phase state of the byte table, for the same position
+    unsigned int i = 0;         //index in samples buffer
+    size_t entry;
+    uint8_t data;
+    int byte;
+
+    if (scrambling_sequence == NULL){
+        scramble_start = num_bytes;
+    }
+
+    for (byte = 0; byte < num_bytes; byte++){
+        data = data_buf[byte];
+        if (byte >= scramble_start){
+            //XOR byte with byte from scrambling sequence
+            data ^= scrambling_sequence[byte - scramble_start];
+        }
+        if (fsk->mod_mode == FSK_MOD_TABLE){
+            entry = (size_t) state*256 + data;
+            memcpy(&samples[i], &fsk->byte_table[entry*samp_per_byte], entry_size);
+            state = fsk->byte_table_next[entry];
+            i += samp_per_byte;
+        }else{
+            i += mod_byte(fsk, data, &samp_table_pos, &samples[i]);
+        }
+    }
     return i;
 }
 
@@ -194,6 +322,168 @@ static double angle(int i, int q)
     }
 }
 
+/**
+ * Branch-free atan2(y, x), using the interval [-pi, pi]. Returns 0 for 0+j0.
+ */
+static inline float fast_atan2f(float y, float x)
+{
+    float ax = fabsf(x), ay = fabsf(y);
+    float mx = ax > ay ? ax : ay;
+    float mn = ax > ay ? ay : ax;
+    float a = mn / (mx > 0.0f ? mx : 1.0f);
+    float s = a * a;
+    float r = a * (ATAN_A1 + s * (ATAN_A3 + s * (ATAN_A5 + s * ATAN_A7)));
+
+    r = ay > ax ? (float)M_PI_2 - r : r;
+    r = x < 0.0f ? (float)M_PI - r : r;
+    return y < 0.0f ? -r : r;
+}
+
+#if defined(FSK_HAVE_SSE2)
+/**
+ * fast_atan2f() on 4 values at a time
+ */
+static inline __m128 fast_atan2f_sse(__m128 y, __m128 x)
+{
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 ax = _mm_andnot_ps(sign, x);
+    __m128 ay = _mm_andnot_ps(sign, y);
+    __m128 mx = _mm_max_ps(ax, ay);
+    __m128 mn = _mm_min_ps(ax, ay);
+    __m128 zero = _mm_cmpeq_ps(mx, _mm_setzero_ps());
+    __m128 a, s, r, swap;
+
+    //Avoid 0/0 for 0+j0
+    mx = _mm_or_ps(_mm_andnot_ps(zero, mx), _mm_and_ps(zero, _mm_set1_ps(1.0f)));
+    a = _mm_div_ps(mn, mx);
+    s = _mm_mul_ps(a, a);
+
+    r = _mm_add_ps(_mm_set1_ps(ATAN_A5), _mm_mul_ps(s, _mm_set1_ps(ATAN_A7)));
+    r = _mm_add_ps(_mm_set1_ps(ATAN_A3), _mm_mul_ps(s, r));
+    r = _mm_add_ps(_mm_set1_ps(ATAN_A1), _mm_mul_ps(s, r));
+    r = _mm_mul_ps(a, r);
+
+    //Reflect into the right octant and quadrant
+    swap = _mm_cmpgt_ps(ay, ax);
+    r = _mm_or_ps(_mm_andnot_ps(swap, r),
+                  _mm_and_ps(swap, _mm_sub_ps(_mm_set1_ps((float)M_PI_2), r)));
+    swap = _mm_cmplt_ps(x, _mm_setzero_ps());
+    r = _mm_or_ps(_mm_andnot_ps(swap, r),
+                  _mm_and_ps(swap, _mm_sub_ps(_mm_set1_ps((float)M_PI), r)));
+    return _mm_xor_ps(r, _mm_and_ps(sign, y));
+}
+#elif defined(FSK_HAVE_NEON)
+/**
+ * fast_atan2f() on 4 values at a time
+ */
+static inline float32x4_t fast_atan2f_neon(float32x4_t y, float32x4_t x)
+{
+    float32x4_t ax = vabsq_f32(x);
+    float32x4_t ay = vabsq_f32(y);
+    float32x4_t mx = vmaxq_f32(ax, ay);
+    float32x4_t mn = vminq_f32(ax, ay);
+    float32x4_t a, s, r, inv;
+
+    //Avoid 0/0 for 0+j0
+    mx = vbslq_f32(vceqq_f32(mx, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f), mx);
+
+    //Reciprocal estimate with two Newton-Raphson steps
+    inv = vrecpeq_f32(mx);
+    inv = vmulq_f32(inv, vrecpsq_f32(mx, inv));
+    inv = vmulq_f32(inv, vrecpsq_f32(mx, inv));
+    a = vmulq_f32(mn, inv);
+    s = vmulq_f32(a, a);
+
+    r = vmlaq_f32(vdupq_n_f32(ATAN_A5), s, vdupq_n_f32(ATAN_A7));
+    r = vmlaq_f32(vdupq_n_f32(ATAN_A3), s, r);
+    r = vmlaq_f32(vdupq_n_f32(ATAN_A1), s, r);
+    r = vmulq_f32(a, r);
+
+    //Reflect into the right octant and quadrant
+    r = vbslq_f32(vcgtq_f32(ay, ax), vsubq_f32(vdupq_n_f32((float)M_PI_2), r), r);
+    r = vbslq_f32(vcltq_f32(x, vdupq_n_f32(0.0f)),
+                  vsubq_f32(vdupq_n_f32((float)M_PI), r), r);
+    return vbslq_f32(vcltq_f32(y, vdupq_n_f32(0.0f)), vnegq_f32(r), r);
+}
+#endif
+
+/**
+ * Compute the phase change into each of 'num_samples' samples, in radians.
+ * 'prev' is the sample preceding samples[0].
+ *
+ * In FSK_DEMOD_FAST mode this is arg(x[n]*conj(x[n-1])), which is already
+ * in (-pi, pi] and so needs no unwrapping.
+ */
+static void discriminate(enum fsk_demod_mode mode, struct complex_sample prev,
+                        const struct complex_sample *samples, int num_samples,
+                        float *dphase)
+{
+    int n = 0;
+
+    if (mode == FSK_DEMOD_EXACT){
+        double phase_prev = angle(prev.i, prev.q);
+        double phase;
+
+        for (n = 0; n < num_samples; n++){
+            phase = angle(samples[n].i, samples[n].q);
+            angle_unwrap(phase_prev, &phase);
+            dphase[n] = (float)(phase - phase_prev);
+            phase_prev = phase;
+        }
+        return;
+    }
+
+    //x[n]*conj(x[n-1]) = (i1*i0 + q1*q0) + j(q1*i0 - i1*q0). SC16Q11 products
+    //are exact in int32.
+    if (num_samples > 0){
+        int32_t re = samples[0].i * prev.i + samples[0].q * prev.q;
+        int32_t im = samples[0].q * prev.i - samples[0].i * prev.q;
+        dphase[0] = fast_atan2f((float)im, (float)re);
+        n = 1;
+    }
+
+#if defined(FSK_HAVE_SSE2)
+    //Selects the I lane of each sample
+    const __m128i even = _mm_set1_epi32(0x0000ffff);
+
+    for (; n + 4 <= num_samples; n += 4){
+        //Load 4 samples and their predecessors, as [i q i q i q i q]
+        const __m128i cur = _mm_loadu_si128((const __m128i *)&samples[n]);
+        const __m128i old = _mm_loadu_si128((const __m128i *)&samples[n - 1]);
+        //re = i1*i0 + q1*q0
+        const __m128i re = _mm_madd_epi16(cur, old);
+        //im = q1*i0 - i1*q0: rearrange the predecessors to [-q0 i0] and
+        //multiply-add
+        const __m128i swapped = _mm_shufflelo_epi16(
+                                    _mm_shufflehi_epi16(old, 0xb1), 0xb1);
+        const __m128i im = _mm_madd_epi16(cur, _mm_sub_epi16(
+                                    _mm_xor_si128(swapped, even), even));
+
+        _mm_storeu_ps(&dphase[n], fast_atan2f_sse(_mm_cvtepi32_ps(im),
+                                                  _mm_cvtepi32_ps(re)));
+    }
+#elif defined(FSK_HAVE_NEON)
+    for (; n + 4 <= num_samples; n += 4){
+        const int16x4x2_t cur = vld2_s16(&samples[n].i);
+        const int16x4x2_t old = vld2_s16(&samples[n - 1].i);
+        int32x4_t re = vmull_s16(cur.val[0], old.val[0]);
+        int32x4_t im = vmull_s16(cur.val[1], old.val[0]);
+
+        re = vmlal_s16(re, cur.val[1], old.val[1]);
+        im = vmlsl_s16(im, cur.val[0], old.val[1]);
+
+        vst1q_f32(&dphase[n], fast_atan2f_neon(vcvtq_f32_s32(im),
+                                               vcvtq_f32_s32(re)));
+    }
+#endif
+
+    for (; n < num_samples; n++){
+        int32_t re = samples[n].i * samples[n-1].i + samples[n].q * samples[n-1].q;
+        int32_t im = samples[n].q * samples[n-1].i - samples[n].i * samples[n-1].q;
+        dphase[n] = fast_atan2f((float)im, (float)re);
+    }
+}
+
 unsigned int fsk_demod(struct fsk_handle *fsk, struct complex_sample *samples,
                     int num_samples, bool new_signal, int num_bytes, uint8_t *data_buf)
 {
@@ -201,18 +491,22 @@ unsigned int fsk_demod(struct fsk_handle *fsk, struct complex_sample *samples,
     int byte = 0;
     int bit;
     int samp;
-    double phase, phase_prev, dphase_tot;
+    double dphase_tot;
+    float dphase[DISC_BLOCK_LEN];   //Phase changes into samples[disc_start...]
+    int disc_start, disc_end;
 
     i = 0;
     if (new_signal){
-        //Reset everything, calculate initial phase
+        //Reset everything, the first sample defines the initial phase
         fsk->curr_samp_index = 0;
         fsk->curr_dphase_tot = 0;
         fsk->curr_bit_index = 0;
-        fsk->last_phase = angle(samples[0].i, samples[0].q);
-        i++;
+        if (num_samples > 0){
+            fsk->last_sample = samples[0];
+            i++;
+        }
     }
-    phase = fsk->last_phase;
+    disc_start = disc_end = i;
     //Initialize byte appropriately if last demod was not fully completed
     //(i.e. last byte was partially demodulated)
     if (!fsk->last_byte_demod_complete){
@@ -227,12 +521,17 @@ unsigned int fsk_demod(struct fsk_handle *fsk, struct complex_sample *samples,
             dphase_tot = fsk->curr_dphase_tot;
             for (samp = fsk->curr_samp_index; (samp < fsk->samp_per_symb) && i < num_samples;
                     samp++){
-                phase_prev = phase;
-                phase = angle(samples[i].i, samples[i].q);
-                //Unwrap angle
-                angle_unwrap(phase_prev, &phase);
+                //Compute the next block of phase changes
+                if (i == disc_end){
+                    disc_start = i;
+                    disc_end = (num_samples - i < DISC_BLOCK_LEN) ? num_samples
+                                                                : i + DISC_BLOCK_LEN;
+                    discriminate(fsk->demod_mode,
+                                 (i == 0) ? fsk->last_sample : samples[i-1],
+                                 &samples[i], disc_end - disc_start, dphase);
+                }
                 //Add this angle change to the total angle change
-                dphase_tot += phase - phase_prev;
+                dphase_tot += dphase[i - disc_start];
                 i++;
             }
             //Check to see if we broke out of the loop before demodulating the full bit
@@ -240,7 +539,6 @@ unsigned int fsk_demod(struct fsk_handle *fsk, struct complex_sample *samples,
                 //Set demod state information
                 fsk->last_byte_demod_complete = false;
                 fsk->last_byte = data_buf[byte];
-                fsk->last_phase = phase;
                 fsk->curr_dphase_tot = dphase_tot;
                 fsk->curr_samp_index = samp;
                 fsk->curr_bit_index = bit;
@@ -257,15 +555,23 @@ unsigned int fsk_demod(struct fsk_handle *fsk, struct complex_sample *samples,
             fsk->curr_samp_index = 0;
             fsk->curr_dphase_tot = 0;
         }
-        fsk->last_phase = phase;
         fsk->curr_bit_index = 0;
         fsk->last_byte_demod_complete = true;
     }
 
     out:
+        //The next call continues from the last sample consumed
+        if (i > 0){
+            fsk->last_sample = samples[i-1];
+        }
         return byte;
 }
 
+void fsk_set_demod_mode(struct fsk_handle *fsk, enum fsk_demod_mode mode)
+{
+    fsk->demod_mode = mode;
+}
+
 struct fsk_handle *fsk_init(void)
 {
     struct fsk_handle *fsk;
@@ -286,11 +592,21 @@ struct fsk_handle *fsk_init(void)
         free(fsk);
         return NULL;
     }
+    //Generate the byte waveform table from it
+    if (fsk_gen_byte_table(fsk) != 0){
+        fprintf(stderr, "Couldn't generate byte waveform table\n");
+        free(fsk->sample_table);
+        free(fsk);
+        return NULL;
+    }
+    fsk->mod_mode = FSK_MOD_TABLE;
     //Initialize demod state variables
     fsk->last_byte_demod_complete = true;
     fsk->last_byte = 0x00;
     fsk->curr_dphase_tot = 0;
-    fsk->last_phase = 0;
+    fsk->last_sample.i = 2047;
+    fsk->last_sample.q = 0;
+    fsk->demod_mode = FSK_DEMOD_FAST;
     fsk->curr_samp_index = 0;
     fsk->curr_bit_index = 0;
     return fsk;
@@ -300,6 +616,8 @@ void fsk_close(struct fsk_handle *fsk)
 {
     if (fsk != NULL){
         free(fsk->sample_table);
+        free(fsk->byte_table);
+        free(fsk->byte_table_next);
     }
     free(fsk);
 }
@@ -49,6 +49,18 @@
 
 struct fsk_handle;
 
+//How fsk_mod() produces the samples of each byte
+enum fsk_mod_mode {
+    FSK_MOD_TABLE,      //Copy the byte's waveform from a precomputed table (default)
+    FSK_MOD_SYMBOL,     //Step through the samples table one sample at a time
+};
+
+//How fsk_demod() measures the phase change between samples
+enum fsk_demod_mode {
+    FSK_DEMOD_FAST,     //arg(x[n]*conj(x[n-1])) with a polynomial atan2 (default)
+    FSK_DEMOD_EXACT,    //Difference of each sample's atan() angle, unwrapped
+};
+
 /**
  * Initialize an allocate memory for an fsk handle
  *
@@ -63,6 +75,24 @@ struct fsk_handle *fsk_init(void);
  */
 void fsk_close(struct fsk_handle *fsk);
 
+/**
+ * Select the demodulator's phase discriminator. FSK_DEMOD_FAST's angles are
+ * within about 1e-5 radians of FSK_DEMOD_EXACT's, so both produce the same bits
+ * for all but vanishingly rare ties.
+ *
+ * @param   fsk     pointer to fsk handle
+ * @param   mode    discriminator to use
+ */
+void fsk_set_demod_mode(struct fsk_handle *fsk, enum fsk_demod_mode mode);
+
+/**
+ * Select how the modulator produces samples. Both modes produce identical samples.
+ *
+ * @param   fsk     pointer to fsk handle
+ * @param   mode    modulator to use
+ */
+void fsk_set_mod_mode(struct fsk_handle *fsk, enum fsk_mod_mode mode);
+
 /**
  * Convert an array of bytes to an array of CPFSK modulated IQ samples
  * Bit order: LSb transmitted first, MSb last
@@ -78,6 +108,27 @@ void fsk_close(struct fsk_handle *fsk);
 unsigned int fsk_mod(struct fsk_handle *fsk, uint8_t *data_buf, int num_bytes,
                         struct complex_sample *samples);
 
+/**
+ * Same as fsk_mod(), but scrambles the bytes as they are modulated. Bytes from index
+ * 'scramble_start' onward are XORed with scrambling_sequence[0], [1], ... before
+ * modulation. data_buf itself is not modified.
+ *
+ * @param[in]   fsk                 pointer to fsk handle
+ * @param[in]   data_buf            bytes to transmit
+ * @param[in]   num_bytes           number of bytes to transmit from data_buf
+ * @param[in]   scramble_start      index of the first byte to scramble
+ * @param[in]   scrambling_sequence scrambling sequence, at least
+ *                                  (num_bytes - scramble_start) bytes long. If NULL,
+ *                                  no bytes are scrambled.
+ * @param[out]  samples             buffer to place modulated IQ samples in
+ *
+ * @return      number of IQ samples modulated
+ */
+unsigned int fsk_mod_scrambled(struct fsk_handle *fsk, const uint8_t *data_buf,
+                                int num_bytes, int scramble_start,
+                                const uint8_t *scrambling_sequence,
+                                struct complex_sample *samples);
+
 /**
  * Convert an array of modulated CPFSK IQ samples into an array of bytes.
  * Expected bit order: LSb arrives first, MSb arrives last.
@@ -49,52 +49,82 @@
  *                                          *
  ********************************************/
 
-struct data_frame {
-    //Total frame length = 1009 bytes (8072 bits)
-    uint8_t type;               //0x00 = data frame, 0xFF = ack frame
-    uint16_t seq_num;           //Sequence number
-    uint16_t payload_length;    //Length of used payload data in bytes
-    uint8_t payload[PAYLOAD_LENGTH];    //payload data
-    uint32_t crc32;             //32-bit CRC
-};
+//Set in a data frame's payload length on the first frame of a new sequence. The
+//receiver resynchronizes its window to the sequence number of such a frame.
+#define DATA_FRAME_FLAG_SYNC 0x8000
+
+//Data frames are built and parsed in place in PHY frame buffers. Their layout is:
+//Total frame length = 1009 bytes (8072 bits)
+//  uint8_t type;               //0x00 = data frame, 0xFF = ack frame
+//  uint16_t seq_num;           //Sequence number
+//  uint16_t payload_length;    //Length of used payload data in bytes, plus
+//                              //DATA_FRAME_FLAG_SYNC
+//  uint8_t payload[PAYLOAD_LENGTH];    //payload data
+//  uint32_t crc32;             //32-bit CRC
+#define DATA_FRAME_SEQ_NUM_OFFSET           1
+#define DATA_FRAME_PAYLOAD_LENGTH_OFFSET    3
+#define DATA_FRAME_PAYLOAD_OFFSET           5
+#define DATA_FRAME_CRC_OFFSET               (DATA_FRAME_PAYLOAD_OFFSET + PAYLOAD_LENGTH)
+
+#if DATA_FRAME_CRC_OFFSET + 4 != DATA_FRAME_LENGTH
+#error "Link layer data frame length differs from DATA_FRAME_LENGTH in phy.h"
+#endif
 
 struct ack_frame {
-    //Total frame length = 7 bytes (56 bits)
+    //Total frame length = 11 bytes (88 bits)
     uint8_t type;               //0x00 = data frame, 0xFF = ack frame
-    uint16_t ack_num;           //Acknowledgement number
+    uint16_t ack_num;           //Cumulative ack: all frames before this number were
+                                //received
+    uint32_t sack_bits;         //Selective ack: bit n is set if frame ack_num+1+n was
+                                //received
     uint32_t crc32;             //32-bit CRC
 };
 
+//A frame in the transmitter's window
+struct tx_frame {
+    uint8_t *buf;                       //Frame to send, including its CRC. A PHY frame
+                                        //buffer, held for the life of the link.
+    bool sending;                       //Is the frame being passed to the PHY
+    bool sent;                          //Has the frame been sent at least once
+    bool acked;                         //Has the frame been acknowledged
+    unsigned int tries;                 //Number of times the frame has been sent
+    struct timespec deadline;           //Time to resend the frame if it isn't acked
+};
+
 struct tx {
-    struct data_frame data_frame_buf;   //Input data frame buffer
-    struct ack_frame ack_frame_buf;     //Input ack frame buffer
+    //Frames awaiting acknowledgement, indexed by seq_num % LINK_MAX_WINDOW
+    struct tx_frame window[LINK_MAX_WINDOW];
+    unsigned int window_size;           //Most frames awaiting acknowledgement at once
+    uint16_t base;                      //Oldest unacknowledged sequence number
+    uint16_t next;                      //Sequence number of the next new frame
+    bool synced;                        //Has the first frame of the sequence been acked
+    bool failed;                        //Did a frame exceed LINK_MAX_TRIES
     bool stop;                          //Signal to stop tx thread
-    bool data_buf_filled;               //Is the data frame buffer filled
     pthread_t thread;                   //Transmitter thread
-    pthread_cond_t data_buf_filled_cond;    //pthread condition corresponding to
-                                            //data_buf_filled
-    pthread_mutex_t data_buf_status_lock;   //Mutex for data_buf_filled_cond
+    pthread_cond_t window_cond;         //Signaled when the window changes
+    pthread_mutex_t window_lock;        //Mutex for the window and window_cond
+    pthread_mutex_t phy_lock;           //Serializes phy_fill_tx_buf() calls, which are
+                                        //made for data frames and acks
     bool link_on;   //Is the transmitter on
-    bool done;      //Has the transmitter finished a transmission
-    bool success;   //Was the transmitter transmission successful
 };
 
 struct rx {
-    struct data_frame data_frame_buf;   //Output data frame buffer
-    struct ack_frame ack_frame_buf;     //Output ack frame buffer
+    //Received frames, indexed by seq_num % LINK_MAX_WINDOW. Frames from 'base' up to
+    //'next' were received in order and are waiting to be returned to the user. Each
+    //is the PHY frame buffer it was received in, or NULL for an empty slot.
+    uint8_t *window[LINK_MAX_WINDOW];
+    uint16_t base;                      //Sequence number of the next frame to return
+    uint16_t next;                      //Sequence number of the next in-order frame
+    bool synced;                        //Has a frame starting a sequence been received
     //Leftover bytes received but not returned to the user after a call to
     //link_receive_data()
     uint8_t extra_bytes[PAYLOAD_LENGTH];
     unsigned int num_extra_bytes;       //Number of bytes in 'extra_bytes' buffer
     pthread_t thread;                   //Receiver thread
     bool stop;                          //Signal to stop rx thread
-    bool data_buf_filled;               //Is the data frame buffer filled
-    pthread_cond_t data_buf_filled_cond;    //pthread condition for data_buf_filled
-    pthread_mutex_t data_buf_status_lock;   //mutex for data_buf_filled_cond
-    bool ack_buf_filled;                    //Is the ack frame buffer filled
-    pthread_cond_t ack_buf_filled_cond;     //pthread condition for ack_buf_filled
-    pthread_mutex_t ack_buf_status_lock;    //mutex for ack_buf_filled_cond
-    bool link_on;                           //Is the receiver on
+    pthread_cond_t window_cond;         //Signaled when an in-order frame is received
+    pthread_mutex_t window_lock;        //Mutex for the window and window_cond
+    bool link_on;                       //Is the receiver on
 };
 
 struct link_handle {
@@ -112,19 +142,23 @@ static int stop_transmitter(struct link_handle *link);
 void *transmit_data_frames(void *arg);
 static int send_payload(struct link_handle *link, uint8_t *payload,
                         uint16_t used_payload_length);
+static int wait_for_acks(struct link_handle *link);
+static int send_frame(struct link_handle *link, uint8_t *frame, unsigned int length);
+static void process_ack(struct link_handle *link, struct ack_frame *ack);
 //rx:
 static int start_receiver(struct link_handle *link);
 static int stop_receiver(struct link_handle *link);
 void *receive_frames(void *arg);
-static int receive_ack(struct link_handle *link, uint16_t ack_num,
-                        unsigned int timeout_ms);
 static int receive_payload(struct link_handle *link, uint8_t *payload,
                             unsigned int timeout_ms);
+static int process_data_frame(struct link_handle *link, uint8_t *frame,
+                                struct ack_frame *ack);
 //utility:
-static void convert_data_frame_struct_to_buf(struct data_frame *frame, uint8_t *buf);
+static uint16_t get_u16(const uint8_t *buf);
+static void put_u16(uint8_t *buf, uint16_t value);
 static void convert_ack_frame_struct_to_buf(struct ack_frame *frame, uint8_t *buf);
-static void convert_buf_to_data_frame_struct(uint8_t *buf, struct data_frame *frame);
 static void convert_buf_to_ack_frame_struct(uint8_t *buf, struct ack_frame *frame);
+static bool time_before(const struct timespec *a, const struct timespec *b);
 
 /****************************************
  *                                      *
@@ -133,9 +167,24 @@ static void convert_buf_to_ack_frame_struct(uint8_t *buf, struct ack_frame *fram
  ****************************************/
 
 struct link_handle *link_init(struct bladerf *dev, struct radio_params *params)
+{
+    struct phy_handle *phy;
+
+    //---------------Open/Initialize phy handle--------------------------
+    phy = phy_init(dev, params);
+    if (phy == NULL){
+        fprintf(stderr, "[LINK] Couldn't initialize phy handle\n");
+        return NULL;
+    }
+
+    return link_init_phy(phy);
+}
+
+struct link_handle *link_init_phy(struct phy_handle *phy)
 {
     int status;
     struct link_handle *link;
+    unsigned int i;
 
     DEBUG_MSG("[LINK] Initializing\n");
     //-------------Allocate memory for link handle struct--------------
@@ -144,15 +193,11 @@ struct link_handle *link_init(struct bladerf *dev, struct radio_params *params)
     link = calloc(1, sizeof(struct link_handle));
     if (link == NULL){
         perror("malloc");
+        phy_close(phy);
         return NULL;
     }
+    link->phy = phy;
 
-    //---------------Open/Initialize phy handle--------------------------
-    link->phy = phy_init(dev, params);
-    if (link->phy == NULL){
-        fprintf(stderr, "[LINK] Couldn't initialize phy handle\n");
-        goto error;
-    }
     //Start phy receiver
     status = phy_start_receiver(link->phy);
     if (status != 0){
@@ -169,60 +214,61 @@ struct link_handle *link_init(struct bladerf *dev, struct radio_params *params)
     link->phy_tx_on = true;
 
     //------------------Allocate memory for tx struct and initialize-----
-    link->tx = malloc(sizeof(struct tx));
+    //Calloc so the window's buffer pointers are initialized to NULL
+    link->tx = calloc(1, sizeof(struct tx));
     if (link->tx == NULL){
         perror("malloc");
         goto error;
     }
+    //Take a frame buffer for each window slot
+    for (i = 0; i < LINK_MAX_WINDOW; i++){
+        link->tx->window[i].buf = phy_alloc_frame_buf(link->phy);
+        if (link->tx->window[i].buf == NULL){
+            fprintf(stderr, "[LINK] Couldn't allocate a frame buffer\n");
+            goto error;
+        }
+    }
     //Initialize control/state variables
     link->tx->stop = false;
-    link->tx->data_buf_filled = false;
-    link->tx->done = false;
-    link->tx->success = false;
+    link->tx->window_size = LINK_DEFAULT_WINDOW;
+    link->tx->failed = false;
     link->tx->link_on = false;
     //Initialize pthread condition variable
-    status = pthread_cond_init(&(link->tx->data_buf_filled_cond), NULL);
+    status = pthread_cond_init(&(link->tx->window_cond), NULL);
     if (status != 0){
         fprintf(stderr, "[LINK] Error initializing pthread_cond: %s\n",
                     strerror(status));
         goto error;
     }
-    //Initialize pthread mutex variable
-    status = pthread_mutex_init(&(link->tx->data_buf_status_lock), NULL);
+    //Initialize pthread mutex variables
+    status = pthread_mutex_init(&(link->tx->window_lock), NULL);
     if (status != 0){
         fprintf(stderr, "[LINK] Error initializing pthread_mutex: %s\n",
                     strerror(status));
         goto error;
     }
-    //------------------Allocate memory for rx struct and initialize-----
-    link->rx = malloc(sizeof(struct rx));
-    if (link->rx == NULL){
-        perror("malloc");
-        goto error;
-    }
-    //Initialize pthread condition variable for data
-    status = pthread_cond_init(&(link->rx->data_buf_filled_cond), NULL);
+    status = pthread_mutex_init(&(link->tx->phy_lock), NULL);
     if (status != 0){
-        fprintf(stderr, "[LINK] Error initializing pthread_cond: %s\n",
+        fprintf(stderr, "[LINK] Error initializing pthread_mutex: %s\n",
                     strerror(status));
         goto error;
     }
-    //Initialize pthread mutex variable for data
-    status = pthread_mutex_init(&(link->rx->data_buf_status_lock), NULL);
-    if (status != 0){
-        fprintf(stderr, "[LINK] Error initializing pthread_mutex: %s\n",
-                    strerror(status));
+    //------------------Allocate memory for rx struct and initialize-----
+    //Calloc so the window's buffer pointers are initialized to NULL
+    link->rx = calloc(1, sizeof(struct rx));
+    if (link->rx == NULL){
+        perror("malloc");
         goto error;
     }
-    //Initialize pthread condition variable for ack
-    status = pthread_cond_init(&(link->rx->ack_buf_filled_cond), NULL);
+    //Initialize pthread condition variable
+    status = pthread_cond_init(&(link->rx->window_cond), NULL);
     if (status != 0){
         fprintf(stderr, "[LINK] Error initializing pthread_cond: %s\n",
                     strerror(status));
         goto error;
     }
-    //Initialize pthread mutex variable for ack
-    status = pthread_mutex_init(&(link->rx->ack_buf_status_lock), NULL);
+    //Initialize pthread mutex variable
+    status = pthread_mutex_init(&(link->rx->window_lock), NULL);
     if (status != 0){
         fprintf(stderr, "[LINK] Error initializing pthread_mutex: %s\n",
                     strerror(status));
@@ -230,8 +276,9 @@ struct link_handle *link_init(struct bladerf *dev, struct radio_params *params)
     }
     //Initialize control/state variables
     link->rx->stop = false;
-    link->rx->data_buf_filled = false;
-    link->rx->ack_buf_filled = false;
+    link->rx->base = 0;
+    link->rx->next = 0;
+    link->rx->synced = false;
     link->rx->num_extra_bytes = 0;
     link->rx->link_on = false;
 
@@ -261,6 +308,7 @@ struct link_handle *link_init(struct bladerf *dev, struct radio_params *params)
 void link_close(struct link_handle *link)
 {
     int status;
+    unsigned int i;
 
     DEBUG_MSG("[LINK] Closing\n");
 
@@ -275,14 +323,21 @@ void link_close(struct link_handle *link)
                     fprintf(stderr, "[LINK] Error stopping link transmitter\n");
                 }
             }
-            status = pthread_mutex_destroy(&(link->tx->data_buf_status_lock));
+            status = pthread_mutex_destroy(&(link->tx->window_lock));
             if (status != 0){
                 fprintf(stderr, "[LINK] Error destroying pthread_mutex\n");
             }
-            status = pthread_cond_destroy(&(link->tx->data_buf_filled_cond));
+            status = pthread_mutex_destroy(&(link->tx->phy_lock));
+            if (status != 0){
+                fprintf(stderr, "[LINK] Error destroying pthread_mutex\n");
+            }
+            status = pthread_cond_destroy(&(link->tx->window_cond));
             if (status != 0){
                 fprintf(stderr, "[LINK] Error destroying pthread_cond\n");
             }
+            for (i = 0; i < LINK_MAX_WINDOW; i++){
+                phy_free_frame_buf(link->phy, link->tx->window[i].buf);
+            }
         }
         free(link->tx);
         //Cleanup rx struct
@@ -294,21 +349,17 @@ void link_close(struct link_handle *link)
                     fprintf(stderr, "[LINK] Error stopping link receiver\n");
                 }
             }
-            status = pthread_mutex_destroy(&(link->rx->data_buf_status_lock));
+            status = pthread_mutex_destroy(&(link->rx->window_lock));
             if (status != 0){
                 fprintf(stderr, "[LINK] Error destroying pthread_mutex\n");
             }
-            status = pthread_cond_destroy(&(link->rx->data_buf_filled_cond));
+            status = pthread_cond_destroy(&(link->rx->window_cond));
             if (status != 0){
                 fprintf(stderr, "[LINK] Error destroying pthread_cond\n");
             }
-            status = pthread_mutex_destroy(&(link->rx->ack_buf_status_lock));
-            if (status != 0){
-                fprintf(stderr, "[LINK] Error destroying pthread_mutex\n");
-            }
-            status = pthread_cond_destroy(&(link->rx->ack_buf_filled_cond));
-            if (status != 0){
-                fprintf(stderr, "[LINK] Error destroying pthread_cond\n");
+            //Return any frames the user didn't read
+            for (i = 0; i < LINK_MAX_WINDOW; i++){
+                phy_free_frame_buf(link->phy, link->rx->window[i]);
             }
         }
         free(link->rx);
@@ -335,37 +386,53 @@ void link_close(struct link_handle *link)
     link = NULL;
 }
 
+int link_set_window_size(struct link_handle *link, unsigned int window_size)
+{
+    int status;
+
+    if (window_size < 1 || window_size > LINK_MAX_WINDOW){
+        fprintf(stderr, "[LINK] %s: Invalid window size of %u (must be 1 to %d)\n",
+                __FUNCTION__, window_size, LINK_MAX_WINDOW);
+        return -1;
+    }
+    status = pthread_mutex_lock(&(link->tx->window_lock));
+    if (status != 0){
+        fprintf(stderr, "[LINK] Error locking pthread_mutex: %s\n", strerror(status));
+        return -1;
+    }
+    link->tx->window_size = window_size;
+    pthread_cond_broadcast(&(link->tx->window_cond));
+    pthread_mutex_unlock(&(link->tx->window_lock));
+    return 0;
+}
+
 /**
- * Convert data frame struct to a buffer of uint8_t
- * @param[in]   frame   pointer to data_frame structure to convert
- * @param[out]  buf     pointer to buffer to place the frame in
+ * Check whether one time is before another
+ *
+ * @return      true if a is before b
  */
-static void convert_data_frame_struct_to_buf(struct data_frame *frame, uint8_t *buf)
+static bool time_before(const struct timespec *a, const struct timespec *b)
 {
-    int i = 0;
+    return a->tv_sec < b->tv_sec || (a->tv_sec == b->tv_sec && a->tv_nsec < b->tv_nsec);
+}
 
-    //Frame type
-    memcpy(&buf[i], &(frame->type), sizeof(frame->type));
-    i += sizeof(frame->type);
-    //Seq num
-    memcpy(&buf[i], &(frame->seq_num), sizeof(frame->seq_num));
-    i += sizeof(frame->seq_num);
-    //payload length
-    memcpy(&buf[i], &(frame->payload_length), sizeof(frame->payload_length));
-    i += sizeof(frame->payload_length);
-    //payload
-    memcpy(&buf[i], frame->payload, PAYLOAD_LENGTH);
-    i += PAYLOAD_LENGTH;
-    //crc
-    memcpy(&buf[i], &(frame->crc32), sizeof(frame->crc32));
-    i += sizeof(frame->crc32);
+/**
+ * Read a 16-bit field from a frame buffer
+ */
+static uint16_t get_u16(const uint8_t *buf)
+{
+    uint16_t value;
 
-    if (i != DATA_FRAME_LENGTH){
-        fprintf(stderr, "[LINK] %s: ERROR: Link layer is using a different data frame "
-                        "length (%d) than the phy layer (%d). Update the DATA_FRAME_LENGTH"
-                        " macro in phy.h and recompile or there will be unexpected results\n",
-                        __FUNCTION__, i, DATA_FRAME_LENGTH);
-    }
+    memcpy(&value, buf, sizeof(value));
+    return value;
+}
+
+/**
+ * Write a 16-bit field to a frame buffer
+ */
+static void put_u16(uint8_t *buf, uint16_t value)
+{
+    memcpy(buf, &value, sizeof(value));
 }
 
 /**
@@ -383,6 +450,9 @@ static void convert_ack_frame_struct_to_buf(struct ack_frame *frame, uint8_t *bu
     //ack num
     memcpy(&buf[i], &(frame->ack_num), sizeof(frame->ack_num));
     i += sizeof(frame->ack_num);
+    //selective ack bits
+    memcpy(&buf[i], &(frame->sack_bits), sizeof(frame->sack_bits));
+    i += sizeof(frame->sack_bits);
     //crc
     memcpy(&buf[i], &(frame->crc32), sizeof(frame->crc32));
     i += sizeof(frame->crc32);
@@ -395,40 +465,6 @@ static void convert_ack_frame_struct_to_buf(struct ack_frame *frame, uint8_t *bu
     }
 }
 
-/**
- * Convert uint8_t buffer to data frame struct
- *
- * @param[in]   buf     pointer to buffer holding a data frame
- * @param[out]  frame   pointer to data_frame struct to place frame in
- */
-static void convert_buf_to_data_frame_struct(uint8_t *buf, struct data_frame *frame)
-{
-    int i = 0;
-
-    //Frame type
-    memcpy(&(frame->type), &buf[i], sizeof(frame->type));
-    i += sizeof(frame->type);
-    //Seq num
-    memcpy(&(frame->seq_num), &buf[i], sizeof(frame->seq_num));
-    i += sizeof(frame->seq_num);
-    //payload length
-    memcpy(&(frame->payload_length), &buf[i], sizeof(frame->payload_length));
-    i += sizeof(frame->payload_length);
-    //payload
-    memcpy(frame->payload, &buf[i], PAYLOAD_LENGTH);
-    i += PAYLOAD_LENGTH;
-    //crc
-    memcpy(&(frame->crc32), &buf[i], sizeof(frame->crc32));
-    i += sizeof(frame->crc32);
-
-    if (i != DATA_FRAME_LENGTH){
-        fprintf(stderr, "[LINK] %s: ERROR: Link layer is using a different data frame "
-                        "length (%d) than the phy layer (%d). Update the DATA_FRAME_LENGTH"
-                        " macro in phy.h and recompile or there will be unexpected results\n",
-                        __FUNCTION__, i, DATA_FRAME_LENGTH);
-    }
-}
-
 /**
  * Convert uint8_t buffer to ack frame struct
  *
@@ -445,6 +481,9 @@ static void convert_buf_to_ack_frame_struct(uint8_t *buf, struct ack_frame *fram
     //ack num
     memcpy(&(frame->ack_num), &buf[i], sizeof(frame->ack_num));
     i += sizeof(frame->ack_num);
+    //selective ack bits
+    memcpy(&(frame->sack_bits), &buf[i], sizeof(frame->sack_bits));
+    i += sizeof(frame->sack_bits);
     //crc
     memcpy(&(frame->crc32), &buf[i], sizeof(frame->crc32));
     i += sizeof(frame->crc32);
@@ -474,8 +513,12 @@ static int start_transmitter(struct link_handle *link)
 {
     int status;
 
-    link->tx->done = false;
-    link->tx->success = false;
+    //Set initial sequence number to random value
+    srand((unsigned int)time(NULL));
+    link->tx->next = (uint16_t) (rand() % 65536);
+    link->tx->base = link->tx->next;
+    link->tx->synced = false;
+    DEBUG_MSG("[LINK] TX: Initial seq num = %hu\n", link->tx->next);
     //be sure stop signal is off
     link->tx->stop = false;
     //Kick off transmitter thread
@@ -500,19 +543,17 @@ static int stop_transmitter(struct link_handle *link)
     int status;
 
     DEBUG_MSG("[LINK] TX: Stopping transmitter...\n");
-    //signal stop
-    link->tx->stop = true;
-    //Signal the buffer filled condition so the thread will stop waiting
-    //for a filled buffer
-    status = pthread_mutex_lock(&(link->tx->data_buf_status_lock));
+    //Signal stop, and wake the thread (and any senders) so they stop waiting
+    status = pthread_mutex_lock(&(link->tx->window_lock));
     if (status != 0){
         fprintf(stderr, "[LINK] Error locking pthread_mutex\n");
     }
-    status = pthread_cond_signal(&(link->tx->data_buf_filled_cond));
+    link->tx->stop = true;
+    status = pthread_cond_broadcast(&(link->tx->window_cond));
     if (status != 0){
         fprintf(stderr, "[LINK] Error signaling pthread_cond\n");
     }
-    status = pthread_mutex_unlock(&(link->tx->data_buf_status_lock));
+    status = pthread_mutex_unlock(&(link->tx->window_lock));
     if (status != 0){
         fprintf(stderr, "[LINK] Error unlocking pthread_mutex\n");
     }
@@ -534,16 +575,25 @@ int link_send_data(struct link_handle *link, uint8_t *data, unsigned int data_le
     unsigned int last_payload_length;
     int status;
 
+    //Clear any failure from a previous call
+    status = pthread_mutex_lock(&(link->tx->window_lock));
+    if (status != 0){
+        fprintf(stderr, "[LINK] Error locking pthread_mutex: %s\n", strerror(status));
+        return -1;
+    }
+    link->tx->failed = false;
+    pthread_mutex_unlock(&(link->tx->window_lock));
+
     num_full_payloads = data_length/PAYLOAD_LENGTH;
 
     //Loop through each full payload
     for(i = 0; i < num_full_payloads; i++){
-        //Send the frame
+        //Queue the frame
         status = send_payload(link, &data[i*PAYLOAD_LENGTH], PAYLOAD_LENGTH);
         if (status != 0){
             if (status == -2){
                 DEBUG_MSG("[LINK] TX: Send data failed: "
-                            "No response for payload #%d\n", i+1);
+                            "No response before payload #%d\n", i+1);
             }else{
                 fprintf(stderr, "[LINK] TX: Send data failed: "
                             "Unexpected error sending payload #%d\n", i+1);
@@ -560,7 +610,7 @@ int link_send_data(struct link_handle *link, uint8_t *data, unsigned int data_le
         if (status != 0){
             if (status == -2){
                 DEBUG_MSG("[LINK] TX: Send data failed: "
-                            "No response for payload #%d\n", i+1);
+                            "No response before payload #%d\n", i+1);
             }else{
                 fprintf(stderr, "[LINK] TX: Send data failed: "
                             "Unexpected error sending payload #%d\n", i+1);
@@ -568,23 +618,36 @@ int link_send_data(struct link_handle *link, uint8_t *data, unsigned int data_le
             return status;
         }
     }
-    return 0;
+
+    //Wait for the rest of the window to be acknowledged
+    status = wait_for_acks(link);
+    if (status == -2){
+        DEBUG_MSG("[LINK] TX: Send data failed: No response\n");
+    }
+    return status;
 }
 
 /**
- * Sends a payload. Blocks until either the transmission was successful (with an
- * acknowledgement) or there was no response (exceeded max number of retransmissions)
+ * Queues a payload to be sent by the transmitter thread. Blocks while the window is
+ * full, i.e. while the window size's worth of frames are awaiting acknowledgement.
+ * Until the first frame of a sequence is acknowledged, the window size is 1. The frame
+ * is built in place in its window slot's frame buffer.
  *
  * @param[in]   link                    pointer to link handle
  * @param[in]   payload                 buffer of bytes to send
  * @param[in]   used_payload_length     number of bytes to send in 'payload'. If less
  *                                      than PAYLOAD_LENGTH, zeros will be padded.
- * @return      0 on success, -1 on error, -2 on timeout/no response
+ * @return      0 on success, -1 on error, -2 if a previous frame had no response
+ *              (exceeded max number of retransmissions)
  */
 static int send_payload(struct link_handle *link, uint8_t *payload,
                     uint16_t used_payload_length)
 {
-    int status;
+    struct tx *tx = link->tx;
+    struct tx_frame *slot;
+    uint16_t payload_length = used_payload_length;
+    uint32_t crc_32;
+    int status, ret = 0;
 
     if (used_payload_length > PAYLOAD_LENGTH){
         fprintf(stderr, "[LINK] %s: Invalid payload length of %hu\n", __FUNCTION__,
@@ -592,55 +655,172 @@ static int send_payload(struct link_handle *link, uint8_t *payload,
         return -1;
     }
 
-    //Wait for tx buf to be empty
-    while(link->tx->data_buf_filled){
-        usleep(50);
-    }
-    //Copy payload data into frame buffer
-    memcpy(link->tx->data_frame_buf.payload, payload, used_payload_length);
-    //Pad zeros to unused portion of the payload
-    memset(&(link->tx->data_frame_buf.payload[used_payload_length]), 0,
-            PAYLOAD_LENGTH - used_payload_length);
-    //Set payload length
-    link->tx->data_frame_buf.payload_length = used_payload_length;
-    //Mark tx not done
-    link->tx->done = false;
-    //Mark buffer filled
-    link->tx->data_buf_filled = true;
-    //Signal the buffer filled condition
-    status = pthread_mutex_lock(&(link->tx->data_buf_status_lock));
+    status = pthread_mutex_lock(&(tx->window_lock));
     if (status != 0){
         fprintf(stderr, "[LINK] Error locking pthread_mutex: %s\n",
                     strerror(status));
         return -1;
     }
-    status = pthread_cond_signal(&(link->tx->data_buf_filled_cond));
-    if (status != 0){
-        fprintf(stderr, "[LINK] Error signaling pthread_cond: %s\n",
-                    strerror(status));
-        return -1;
+    //Wait for room in the window, and for the PHY to finish with any earlier frame
+    //sent from the slot
+    slot = &(tx->window[tx->next % LINK_MAX_WINDOW]);
+    while (!tx->failed && !tx->stop &&
+            ((uint16_t)(tx->next - tx->base) >= (tx->synced ? tx->window_size : 1) ||
+             slot->sending)){
+        status = pthread_cond_wait(&(tx->window_cond), &(tx->window_lock));
+        if (status != 0){
+            fprintf(stderr, "[LINK] %s: Condition wait failed: %s\n", __FUNCTION__,
+                        strerror(status));
+            ret = -1;
+            goto out;
+        }
+    }
+    if (tx->failed){
+        ret = -2;
+        goto out;
+    }
+    if (tx->stop){
+        ret = -1;
+        goto out;
+    }
+
+    //The first frame of a sequence tells the receiver to resynchronize to it
+    if (!tx->synced){
+        payload_length |= DATA_FRAME_FLAG_SYNC;
     }
-    status = pthread_mutex_unlock(&(link->tx->data_buf_status_lock));
+    //Build the frame in the window
+    slot->buf[0] = DATA_FRAME_CODE;
+    put_u16(&(slot->buf[DATA_FRAME_SEQ_NUM_OFFSET]), tx->next);
+    put_u16(&(slot->buf[DATA_FRAME_PAYLOAD_LENGTH_OFFSET]), payload_length);
+    //Copy payload data into the frame, and pad zeros to the unused portion
+    memcpy(&(slot->buf[DATA_FRAME_PAYLOAD_OFFSET]), payload, used_payload_length);
+    memset(&(slot->buf[DATA_FRAME_PAYLOAD_OFFSET + used_payload_length]), 0,
+            PAYLOAD_LENGTH - used_payload_length);
+    //Calculate the CRC, and copy it to the frame
+    crc_32 = crc32(slot->buf, DATA_FRAME_CRC_OFFSET);
+    memcpy(&(slot->buf[DATA_FRAME_CRC_OFFSET]), &crc_32, sizeof(crc_32));
+    slot->sent = false;
+    slot->acked = false;
+    slot->tries = 0;
+    tx->next++;
+    //Wake the transmitter thread
+    pthread_cond_broadcast(&(tx->window_cond));
+
+    out:
+        status = pthread_mutex_unlock(&(tx->window_lock));
+        if (status != 0){
+            fprintf(stderr, "[LINK] Error unlocking pthread_mutex: %s\n",
+                        strerror(status));
+            ret = -1;
+        }
+        return ret;
+}
+
+/**
+ * Waits for every queued frame to be acknowledged
+ *
+ * @param[in]   link    pointer to link handle
+ *
+ * @return      0 on success, -1 on error, -2 on timeout/no response
+ */
+static int wait_for_acks(struct link_handle *link)
+{
+    struct tx *tx = link->tx;
+    int status, ret = 0;
+
+    status = pthread_mutex_lock(&(tx->window_lock));
     if (status != 0){
-        fprintf(stderr, "[LINK] Error unlocking pthread_mutex: %s\n",
-                    strerror(status));
+        fprintf(stderr, "[LINK] Error locking pthread_mutex: %s\n", strerror(status));
         return -1;
     }
-    //Wait for the transmission to complete
-    //TODO: Change this to a pthread condition signal
-    while (!link->tx->done){
-        usleep(100);
+    while (!tx->failed && !tx->stop && tx->base != tx->next){
+        status = pthread_cond_wait(&(tx->window_cond), &(tx->window_lock));
+        if (status != 0){
+            fprintf(stderr, "[LINK] %s: Condition wait failed: %s\n", __FUNCTION__,
+                        strerror(status));
+            ret = -1;
+            break;
+        }
     }
-    //Check the status of the transmission
-    if (!link->tx->success){
-        return -2;
+    if (ret == 0 && tx->failed){
+        ret = -2;
+    }else if (ret == 0 && tx->stop){
+        ret = -1;
     }
+    pthread_mutex_unlock(&(tx->window_lock));
+    return ret;
+}
+
+/**
+ * Passes a frame to the PHY to transmit. Data frames (from the transmitter thread) and
+ * acks (from the receiver thread) both go through here, one at a time.
+ *
+ * @return      0 on success, -1 on failure
+ */
+static int send_frame(struct link_handle *link, uint8_t *frame, unsigned int length)
+{
+    int status;
 
+    status = pthread_mutex_lock(&(link->tx->phy_lock));
+    if (status != 0){
+        fprintf(stderr, "[LINK] Error locking pthread_mutex: %s\n", strerror(status));
+        return -1;
+    }
+    status = phy_fill_tx_buf(link->phy, frame, length);
+    pthread_mutex_unlock(&(link->tx->phy_lock));
+    if (status != 0){
+        fprintf(stderr, "[LINK] Couldn't fill phy tx buffer\n");
+        return -1;
+    }
     return 0;
 }
 
 /**
- * Thread function that transmits data frames and waits for acks.
+ * Marks the frames acknowledged by an ack frame, and slides the window forward past
+ * the oldest acknowledged frames. Called by the receiver thread.
+ *
+ * @param[in]   link    pointer to link handle
+ * @param[in]   ack     received ack frame
+ */
+static void process_ack(struct link_handle *link, struct ack_frame *ack)
+{
+    struct tx *tx = link->tx;
+    uint16_t in_flight, seq;
+    unsigned int n;
+
+    if (pthread_mutex_lock(&(tx->window_lock)) != 0){
+        fprintf(stderr, "[LINK] %s: Error locking pthread_mutex\n", __FUNCTION__);
+        return;
+    }
+    in_flight = (uint16_t)(tx->next - tx->base);
+    //Cumulative ack. Ignore acks for frames outside the window (e.g. stale acks).
+    if ((uint16_t)(ack->ack_num - tx->base) <= in_flight){
+        for (seq = tx->base; seq != ack->ack_num; seq++){
+            tx->window[seq % LINK_MAX_WINDOW].acked = true;
+        }
+    }
+    //Selective acks
+    for (n = 0; n < 32; n++){
+        seq = (uint16_t)(ack->ack_num + 1 + n);
+        if ((ack->sack_bits & (1u << n)) && (uint16_t)(seq - tx->base) < in_flight){
+            tx->window[seq % LINK_MAX_WINDOW].acked = true;
+        }
+    }
+    //Slide the window
+    while (tx->base != tx->next && tx->window[tx->base % LINK_MAX_WINDOW].acked){
+        DEBUG_MSG("[LINK] TX: Frame %hu acknowledged\n", tx->base);
+        tx->base++;
+        tx->synced = true;
+    }
+    pthread_cond_broadcast(&(tx->window_cond));
+    pthread_mutex_unlock(&(tx->window_lock));
+}
+
+/**
+ * Thread function that transmits data frames from the window, and retransmits each
+ * one if it is not acknowledged within ACK_TIMEOUT_MS. If a frame has been sent
+ * LINK_MAX_TRIES times without an acknowledgement, the whole window is dropped, the
+ * transmission is marked failed, and the next frame starts a new sequence.
  * Does not directly receive acks - the receive_frames() function does this.
  * Does not transmit acks - the receive_frames function does this.
  *
@@ -649,110 +829,100 @@ static int send_payload(struct link_handle *link, uint8_t *payload,
 void *transmit_data_frames(void *arg)
 {
     int status;
-    uint16_t seq_num;
-    uint32_t crc_32;
-    unsigned int tries;
-    uint8_t data_send_buf[DATA_FRAME_LENGTH];
-    bool failed;
+    struct tx_frame *frame;
+    struct timespec now, deadline;
+    bool have_deadline, give_up;
+    uint16_t seq;
 
     //cast arg
     struct link_handle *link = (struct link_handle *) arg;
-    //Set initial sequence number to random value
-    srand((unsigned int)time(NULL));
-    seq_num = rand() % 65536;
-    DEBUG_MSG("[LINK] TX: Initial seq num = %hu\n", seq_num);
-    tries = 1;
-
-    while (!link->tx->stop){
-        if (tries > LINK_MAX_TRIES){
-            DEBUG_MSG("[LINK] TX: Exceeded max tries (%u) without an ACK."
-                            " Skipping frame\n", tries-1);
-            link->tx->success = false;
-            link->tx->done = true;
-            tries = 1;
-        }
-        if (tries == 1){
-            //---------Wait for data buffer to be filled-----------
-            //Lock mutex
-            status = pthread_mutex_lock(&(link->tx->data_buf_status_lock));
-            if (status != 0){
-                fprintf(stderr, "[LINK] Mutex lock failed: %s\n",
-                        strerror(status));
-                goto out;
+    struct tx *tx = link->tx;
+
+    status = pthread_mutex_lock(&(tx->window_lock));
+    if (status != 0){
+        fprintf(stderr, "[LINK] Mutex lock failed: %s\n", strerror(status));
+        return NULL;
+    }
+    while (!tx->stop){
+        //Look for a frame which is new, or whose ack timed out
+        frame = NULL;
+        have_deadline = false;
+        give_up = false;
+        clock_gettime(CLOCK_REALTIME, &now);
+        for (seq = tx->base; seq != tx->next; seq++){
+            struct tx_frame *f = &(tx->window[seq % LINK_MAX_WINDOW]);
+
+            if (f->acked){
+                continue;
             }
-            //Wait for condition signal - meaning buffer is full
-            failed = false;
-            while (!link->tx->data_buf_filled && !link->tx->stop){
-                DEBUG_MSG("[LINK] TX: Waiting for buffer to be filled\n");
-                status = pthread_cond_wait(&(link->tx->data_buf_filled_cond),
-                                            &(link->tx->data_buf_status_lock));
-                if (status != 0){
-                    fprintf(stderr, "[LINK] transmit_frames(): "
-                            "Condition wait failed: %s\n", strerror(status));
-                    failed = true;
-                    break;
+            if (!f->sent || !time_before(&now, &(f->deadline))){
+                if (f->tries >= LINK_MAX_TRIES){
+                    DEBUG_MSG("[LINK] TX: Exceeded max tries (%u) without an ACK "
+                                "for frame %hu. Dropping window\n", f->tries, seq);
+                    give_up = true;
+                }else{
+                    frame = f;
                 }
+                break;
+            }
+            if (!have_deadline || time_before(&(f->deadline), &deadline)){
+                deadline = f->deadline;
+                have_deadline = true;
+            }
+        }
+
+        if (give_up){
+            tx->failed = true;
+            tx->base = tx->next;
+            tx->synced = false;
+            pthread_cond_broadcast(&(tx->window_cond));
+            continue;
+        }
+
+        if (frame != NULL){
+            if (frame->sent){
+                DEBUG_MSG("[LINK] TX: Didn't get an ACK (timed out). Resending\n");
             }
-            //Unlock mutex
-            status = pthread_mutex_unlock(&(link->tx->data_buf_status_lock));
+            //The frame is sent from the window, so keep send_payload() from reusing
+            //its slot until the PHY is done with it (e.g. if it's acked meanwhile)
+            frame->sending = true;
+            frame->sent = true;
+            frame->tries++;
+            create_timeout_abs(ACK_TIMEOUT_MS, &(frame->deadline));
+            pthread_mutex_unlock(&(tx->window_lock));
+
+            //Transmit the frame
+            status = send_frame(link, frame->buf, DATA_FRAME_LENGTH);
             if (status != 0){
-                fprintf(stderr, "[LINK] transmit_frames(): Mutex unlock failed: %s\n",
-                        strerror(status));
-                failed = true;
+                return NULL;
             }
-            //Stop thread if stop variable is true, or something with pthreads went wrong
-            if (link->tx->stop || failed){
-                link->tx->data_buf_filled = false;
-                goto out;
+            DEBUG_MSG("[LINK] TX: Frame sent to PHY\n");
+
+            status = pthread_mutex_lock(&(tx->window_lock));
+            if (status != 0){
+                fprintf(stderr, "[LINK] Mutex lock failed: %s\n", strerror(status));
+                return NULL;
             }
-            DEBUG_MSG("[LINK] TX: Frame buffer filled. Sending...\n");
-            //Set frame type
-            link->tx->data_frame_buf.type = DATA_FRAME_CODE;
-            //Set sequence number
-            link->tx->data_frame_buf.seq_num = seq_num;
-            //Copy frame into send buf
-            convert_data_frame_struct_to_buf(&(link->tx->data_frame_buf), data_send_buf);
-            //Calculate the CRC
-            crc_32 = crc32(data_send_buf, DATA_FRAME_LENGTH - sizeof(crc_32));
-            //Copy this CRC to the send buf
-            memcpy(&data_send_buf[DATA_FRAME_LENGTH - sizeof(crc_32)],
-                    &crc_32, sizeof(crc_32));
-            //Mark tx data buffer empty
-            link->tx->data_buf_filled = false;
+            frame->sending = false;
+            pthread_cond_broadcast(&(tx->window_cond));
+            continue;
         }
-        //Transmit the frame
-        status = phy_fill_tx_buf(link->phy, data_send_buf, DATA_FRAME_LENGTH);
-        if (status != 0){
-            fprintf(stderr, "[LINK] Couldn't fill phy tx buffer\n");
-            goto out;
+
+        //Nothing to send. Wait for a new frame, an ack, or the next timeout.
+        if (have_deadline){
+            status = pthread_cond_timedwait(&(tx->window_cond), &(tx->window_lock),
+                                            &deadline);
+        }else{
+            status = pthread_cond_wait(&(tx->window_cond), &(tx->window_lock));
         }
-        DEBUG_MSG("[LINK] TX: Frame sent to PHY. Waiting for ACK...\n");
-        //Wait for an ack
-        status = receive_ack(link, seq_num, ACK_TIMEOUT_MS);
-        if (status == -2){
-            DEBUG_MSG("[LINK] TX: Didn't get an ACK (timed out). Resending\n");
-            tries++;
-            continue;
-        }else if (status == -3){
-            DEBUG_MSG("[LINK] TX: Received wrong ACK number. Resending\n");
-            tries++;
-            continue;
-        }else if (status < 0){
-            fprintf(stderr, "[LINK] TX: Error receiving ACK. "
-                            "Stopping transmitter\n");
-            goto out;
+        if (status != 0 && status != ETIMEDOUT){
+            fprintf(stderr, "[LINK] transmit_frames(): "
+                    "Condition wait failed: %s\n", strerror(status));
+            break;
         }
-        //Success!
-        DEBUG_MSG("[LINK] TX: Got an ACK\n");
-        link->tx->success = true;
-        link->tx->done = true;
-        tries = 1;
-        seq_num++;
     }
-
-    out:
-        link->tx->done = true;
-        return NULL;
+    pthread_mutex_unlock(&(tx->window_lock));
+    return NULL;
 }
 
 /****************************************
@@ -885,7 +1055,7 @@ int link_receive_data(struct link_handle *link, int size, int max_timeouts,
 }
 
 /**
- * Receives a payload and copies it into the given buffer
+ * Receives the next in-order payload and copies it into the given buffer
  * @param[in]   link            pointer to link handle
  * @param[in]   timeout_ms      Amount of time to wait for a received payload
  * @param[out]  payload         pointer to buffer to place payload in
@@ -897,6 +1067,7 @@ static int receive_payload(struct link_handle *link, uint8_t *payload, unsigned
 {
     int payload_length = 10;    //must be initialized above 0
     struct timespec timeout_abs;
+    uint8_t **frame;
     int status;
 
     //Create absolute time format timeout
@@ -907,16 +1078,16 @@ static int receive_payload(struct link_handle *link, uint8_t *payload, unsigned
     }
 
     //Prepare to wait with pthread_cond_timedwait()
-    status = pthread_mutex_lock(&(link->rx->data_buf_status_lock));
+    status = pthread_mutex_lock(&(link->rx->window_lock));
     if (status != 0){
         fprintf(stderr, "[LINK] RX: receive_payload(): Error locking mutex: %s\n",
                     strerror(status));
         return -1;
     }
-    //Wait for condition signal - meaning rx data buffer is full
-    while (!link->rx->data_buf_filled){
-        status = pthread_cond_timedwait(&(link->rx->data_buf_filled_cond),
-                                    &(link->rx->data_buf_status_lock), &timeout_abs);
+    //Wait for condition signal - meaning an in-order frame was received
+    while (link->rx->base == link->rx->next){
+        status = pthread_cond_timedwait(&(link->rx->window_cond),
+                                    &(link->rx->window_lock), &timeout_abs);
         if (status != 0){
             if (status == ETIMEDOUT){
                 payload_length = -2;
@@ -928,100 +1099,150 @@ static int receive_payload(struct link_handle *link, uint8_t *payload, unsigned
             break;
         }
     }
-    //Waiting is done. Unlock mutex.
-    status = pthread_mutex_unlock(&(link->rx->data_buf_status_lock));
+    if (payload_length >= 0){
+        frame = &(link->rx->window[link->rx->base % LINK_MAX_WINDOW]);
+        //Get the length of the used portion of the payload
+        payload_length = get_u16(&((*frame)[DATA_FRAME_PAYLOAD_LENGTH_OFFSET])) &
+                            ~DATA_FRAME_FLAG_SYNC;
+        //Copy the used portion of the payload
+        memcpy(payload, &((*frame)[DATA_FRAME_PAYLOAD_OFFSET]), payload_length);
+        //Free the window slot, returning its buffer to the PHY
+        phy_free_frame_buf(link->phy, *frame);
+        *frame = NULL;
+        link->rx->base++;
+    }
+    //Done. Unlock mutex.
+    status = pthread_mutex_unlock(&(link->rx->window_lock));
     if (status != 0){
         fprintf(stderr, "[LINK] RX: receive_payload(): Mutex unlock failed: %s\n",
                 strerror(status));
         payload_length = -1;
     }
-    //Did we error or timeout? Return
-    if (payload_length < 0){
-        return payload_length;
-    }
-
-    //Get the length of the used portion of the payload
-    payload_length = link->rx->data_frame_buf.payload_length;
-    //Copy the used portion of the payload
-    memcpy(payload, link->rx->data_frame_buf.payload, payload_length);
-    //Mark the rx data buffer empty
-    link->rx->data_buf_filled = false;
 
     return payload_length;
 }
 
 /**
- * Attempts to receive an ACK with the given ACK number
- * Waits until it either receives an ack or times out.
+ * Places a received data frame in the receive window, and fills in the ack to send for
+ * it. Frames older than the window were already received, and are only acked again.
+ * A frame flagged with DATA_FRAME_FLAG_SYNC (which is not a duplicate) moves the window
+ * to its sequence number, once every frame in the window has been returned to the user.
+ * The frame's buffer is kept in the window, or returned to the PHY.
  *
- * @param[in]   link        pointer to link handle
- * @param[in]   ack_num     acknowledgement number to look for
- * @param[in]   timeout_ms  amount of time to wait for an ACK, in milliseconds
+ * @param[in]   link    pointer to link handle
+ * @param[in]   frame   PHY frame buffer holding the received data frame
+ * @param[out]  ack     ack frame to send
  *
- * @return      0 if successfully received ack, -1 if pthread error or wrong ack number,
- *              -2 if timed out, -3 if wrong ack number
+ * @return      1 if an ack should be sent, 0 if the frame was dropped without an ack,
+ *              -1 on error
  */
-static int receive_ack(struct link_handle *link, uint16_t ack_num, unsigned int timeout_ms)
+static int process_data_frame(struct link_handle *link, uint8_t *frame,
+                                struct ack_frame *ack)
 {
-    struct timespec timeout_abs;
-    int status, ret = 0;
+    struct rx *rx = link->rx;
+    uint16_t seq_num = get_u16(&frame[DATA_FRAME_SEQ_NUM_OFFSET]);
+    uint16_t payload_length = get_u16(&frame[DATA_FRAME_PAYLOAD_LENGTH_OFFSET]);
+    bool sync = (payload_length & DATA_FRAME_FLAG_SYNC) != 0;
+    uint16_t offset, seq;
+    unsigned int index, n;
+    bool duplicate;
+    int status, ret = 1;
 
-    //Create absolute time format timeout
-    status = create_timeout_abs(timeout_ms, &timeout_abs);
-    if (status != 0){
-        fprintf(stderr, "[LINK] RX: receive_ack(): Error creating timeout\n");
-        return -1;
+    payload_length &= ~DATA_FRAME_FLAG_SYNC;
+    if (payload_length > PAYLOAD_LENGTH){
+        NOTE("[LINK] RX: Invalid payload length %hu. Dropping.\n", payload_length);
+        phy_free_frame_buf(link->phy, frame);
+        return 0;
     }
+    index = seq_num % LINK_MAX_WINDOW;
 
-    //Prepare to wait with pthread_cond_timedwait()
-    status = pthread_mutex_lock(&(link->rx->ack_buf_status_lock));
+    status = pthread_mutex_lock(&(rx->window_lock));
     if (status != 0){
-        fprintf(stderr, "[LINK] RX: receive_ack(): Error locking mutex: %s\n",
-                    strerror(status));
+        fprintf(stderr, "[LINK] RX: %s: Error locking pthread_mutex\n", __FUNCTION__);
+        phy_free_frame_buf(link->phy, frame);
         return -1;
     }
-    //Wait for condition signal - meaning buffer is full
-    while (!link->rx->ack_buf_filled){
-        status = pthread_cond_timedwait(&(link->rx->ack_buf_filled_cond),
-                                    &(link->rx->ack_buf_status_lock), &timeout_abs);
-        if (status != 0){
-            if (status == ETIMEDOUT){
-                ret = -2;
-            }else{
-                fprintf(stderr, "[LINK] RX: receive_ack(): Condition wait failed: %s\n",
-                    strerror(status));
-                ret = -1;
-            }
-            break;
+
+    offset = (uint16_t)(seq_num - rx->base);
+    duplicate = rx->synced && (offset >= (uint16_t)(-LINK_MAX_WINDOW) ||
+                (offset < LINK_MAX_WINDOW && rx->window[index] != NULL &&
+                 get_u16(&(rx->window[index][DATA_FRAME_SEQ_NUM_OFFSET])) == seq_num));
+
+    if (sync && !duplicate){
+        if (rx->base != rx->next){
+            //The user hasn't read every frame of the previous sequence yet. Don't ack,
+            //so this frame is resent later.
+            NOTE("[LINK] RX: New sequence while frames are unread. Dropping.\n");
+            ret = 0;
+            goto out;
+        }
+        DEBUG_MSG("[LINK] RX: New sequence starting at %hu\n", seq_num);
+        //Drop any frames held beyond the previous sequence's window
+        for (n = 0; n < LINK_MAX_WINDOW; n++){
+            phy_free_frame_buf(link->phy, rx->window[n]);
+            rx->window[n] = NULL;
         }
+        rx->base = seq_num;
+        rx->next = seq_num;
+        rx->synced = true;
+        offset = 0;
+    }else if (!rx->synced){
+        //Wait for the start of a sequence
+        ret = 0;
+        goto out;
     }
-    //Waiting is done. Unlock mutex.
-    status = pthread_mutex_unlock(&(link->rx->ack_buf_status_lock));
-    if (status != 0){
-        fprintf(stderr, "[LINK] RX: receive_ack(): Mutex unlock failed: %s\n",
-                strerror(status));
-        ret = -1;
+
+    if (duplicate){
+        DEBUG_MSG("[LINK] RX: Received a duplicate frame.\n");
+    }else if (offset < LINK_MAX_WINDOW){
+        //Keep the frame's buffer in the window
+        rx->window[index] = frame;
+        frame = NULL;
+        //Advance past any frames which are now in order
+        seq = rx->next;
+        while ((uint16_t)(rx->next - rx->base) < LINK_MAX_WINDOW &&
+                rx->window[rx->next % LINK_MAX_WINDOW] != NULL){
+            rx->next++;
+        }
+        if (rx->next != seq){
+            pthread_cond_signal(&(rx->window_cond));
+        }
+    }else if (offset < 2*LINK_MAX_WINDOW){
+        //Beyond the window, since the user hasn't read enough frames yet
+        NOTE("[LINK] RX: Data frame beyond window dropped!\n");
+    }else{
+        //Not from this sequence
+        NOTE("[LINK] RX: Data frame with unexpected seq num %hu dropped!\n", seq_num);
+        ret = 0;
+        goto out;
     }
-    //Check the sequence number if nothing failed
-    if (ret == 0 && link->rx->ack_frame_buf.ack_num != ack_num){
-        fprintf(stderr, "[LINK] RX: receive_ack(): Incorrect ack number %hu "
-                    "(expected %hu)\n", link->rx->ack_frame_buf.ack_num, ack_num);
-        ret = -3;
+
+    //Acknowledge every frame before 'next', and each received frame after it
+    ack->type = ACK_FRAME_CODE;
+    ack->ack_num = rx->next;
+    ack->sack_bits = 0;
+    for (n = 0; n < 32; n++){
+        seq = (uint16_t)(rx->next + 1 + n);
+        if ((uint16_t)(seq - rx->base) < LINK_MAX_WINDOW &&
+                rx->window[seq % LINK_MAX_WINDOW] != NULL){
+            ack->sack_bits |= 1u << n;
+        }
     }
-    //mark the rx ack buffer empty
-    link->rx->ack_buf_filled = false;
 
-    return ret;
+    out:
+        pthread_mutex_unlock(&(rx->window_lock));
+        //Return the frame's buffer to the PHY unless it was kept
+        phy_free_frame_buf(link->phy, frame);
+        return ret;
 }
 
 /**
  * Thread function which receives data and ACK frames from the PHY, and transmits ACKs.
- * Checks CRC on all received frames before copying them to a buffer which other
- * functions can use. If the CRC is incorrect, it disregards the frame and does not
- * copy it. If a data frame is received, it checks sequence number for duplicate.
- * If not a duplicate, it copies the frame to rx data_frame_buf and marks the buffer
- * full. An acknowledgement is always sent, regardless of whether or not the received
- * data frame is a duplicate. This is the only function that sends acks.
+ * Checks CRC on all received frames. If the CRC is incorrect, it disregards the frame.
+ * Data frames are placed in the receive window, which puts them back in order and
+ * discards duplicates. An acknowledgement is sent for every data frame in (or behind)
+ * the window, including duplicates. This is the only function that sends acks.
+ * Received acks are passed to the transmitter's window.
  *
  * @param[in]   arg     pointer to link handle
  */
@@ -1032,10 +1253,8 @@ void *receive_frames(void *arg)
     uint32_t crc_32, crc_32_rx;
     bool is_data_frame = false;
     int status;
-    uint8_t ack_send_buf[ACK_FRAME_LENGTH];
-    uint16_t seq_num = 0;
-    bool first_frame = true;
-    bool duplicate;
+    uint8_t *ack_send_buf;              //PHY frame buffer to build acks in
+    struct ack_frame ack_frame;         //Received ack, or ack to send
 
     //cast arg
     struct link_handle *link = (struct link_handle *) arg;
@@ -1044,6 +1263,13 @@ void *receive_frames(void *arg)
     //current state variable
     enum states state = WAIT;
 
+    memset(&ack_frame, 0, sizeof(ack_frame));
+    ack_send_buf = phy_alloc_frame_buf(link->phy);
+    if (ack_send_buf == NULL){
+        fprintf(stderr, "[LINK] receive_frames(): Couldn't allocate a frame buffer\n");
+        return NULL;
+    }
+
     while(!link->rx->stop){
         switch(state){
             case WAIT:
@@ -1078,8 +1304,8 @@ void *receive_frames(void *arg)
                 //Compare received CRC vs expected CRC
                 if (crc_32_rx != crc_32){
                     //Drop the frame since there was an error
-                    //First release the buffer for the PHY
-                    phy_release_rx_buf(link->phy);
+                    //First return the buffer to the PHY
+                    phy_free_frame_buf(link->phy, rx_buf);
                     NOTE("[LINK] RX: Frame received with errors. Dropping.\n");
                     state = WAIT;
                 }else{
@@ -1088,111 +1314,41 @@ void *receive_frames(void *arg)
                 }
                 break;
             case COPY:
-                //--CRC passed. Now copy the frame to link layer buffer
-                //--if it is not a duplicate frame
+                //--CRC passed. Now pass the frame to the rx or tx window
                 DEBUG_MSG("[LINK] RX: State = COPY\n");
                 if (is_data_frame){
-                    //Is the previous data frame still being worked with?
-                    if (link->rx->data_buf_filled){
-                        //Instead of causing a disruption, drop the current frame
-                        fprintf(stderr, "[LINK] RX: Data frame dropped!\n");
-                        phy_release_rx_buf(link->phy);
-                        break;
-                    }
-                    //Copy/convert to data frame struct
-                    convert_buf_to_data_frame_struct(rx_buf,
-                                                &(link->rx->data_frame_buf));
-                    //Release buffer from the phy
-                    phy_release_rx_buf(link->phy);
-                    //Is this frame a duplicate of the last frame?
-                    if (link->rx->data_frame_buf.seq_num == seq_num && !first_frame){
-                        DEBUG_MSG("[LINK] RX: Received a duplicate frame.\n");
-                        duplicate = true;
-                    }else{
-                        duplicate = false;
-                    }
-                    seq_num = link->rx->data_frame_buf.seq_num;
-                    first_frame = false;
-                    //Mark buffer filled if not a duplicate data frame
-                    if (!duplicate){
-                        //Signal that the link data buffer is filled
-                        link->rx->data_buf_filled = true;
-                        status = pthread_mutex_lock(&(link->rx->data_buf_status_lock));
-                        if (status != 0){
-                            fprintf(stderr, "[LINK] RX: receive_frames(): "
-                                            "Error locking pthread_mutex\n");
-                            return NULL;
-                        }
-                        status = pthread_cond_signal(&(link->rx->data_buf_filled_cond));
-                        if (status != 0){
-                            fprintf(stderr, "[LINK] RX: receive_frames(): "
-                                            "Error signaling pthread_cond\n");
-                            return NULL;
-                        }
-                        status = pthread_mutex_unlock(&(link->rx->data_buf_status_lock));
-                        if (status != 0){
-                            fprintf(stderr, "[LINK] RX: receive_frames(): "
-                                            "Error unlocking pthread_mutex\n");
-                            return NULL;
-                        }
+                    //The frame's buffer is handed over to the rx window
+                    status = process_data_frame(link, rx_buf, &ack_frame);
+                    if (status < 0){
+                        goto out;
                     }
                     //Transition to send acknowledgement
-                    state = SEND_ACK;
+                    state = (status == 1) ? SEND_ACK : WAIT;
                 }else{
-                    //Is the previous ack frame still being worked with?
-                    if (link->rx->ack_buf_filled){
-                        //Instead of causing a disruption, drop the current frame
-                        fprintf(stderr, "[LINK] RX: ACK frame dropped!\n");
-                        phy_release_rx_buf(link->phy);
-                        break;
-                    }
-                    //Copy/convert to ack frame struct and mark ack buffer filled
-                    convert_buf_to_ack_frame_struct(rx_buf, &(link->rx->ack_frame_buf));
-                    //Release buffer from the phy
-                    phy_release_rx_buf(link->phy);
-                    //Signal that the link ack buffer is filled
-                    link->rx->ack_buf_filled = true;
-                    status = pthread_mutex_lock(&(link->rx->ack_buf_status_lock));
-                    if (status != 0){
-                        fprintf(stderr, "[LINK] RX: receive_frames(): "
-                                        "Error locking pthread_mutex\n");
-                        return NULL;
-                    }
-                    status = pthread_cond_signal(&(link->rx->ack_buf_filled_cond));
-                    if (status != 0){
-                        fprintf(stderr, "[LINK] RX: receive_frames(): "
-                                        "Error signaling pthread_cond\n");
-                        return NULL;
-                    }
-                    status = pthread_mutex_unlock(&(link->rx->ack_buf_status_lock));
-                    if (status != 0){
-                        fprintf(stderr, "[LINK] RX: receive_frames(): "
-                                        "Error unlocking pthread_mutex\n");
-                        return NULL;
-                    }
+                    //Copy/convert to ack frame struct
+                    convert_buf_to_ack_frame_struct(rx_buf, &ack_frame);
+                    //Return the buffer to the PHY
+                    phy_free_frame_buf(link->phy, rx_buf);
+                    process_ack(link, &ack_frame);
                     //Done with the frame. Go back to WAIT state
                     state = WAIT;
                 }
                 break;
             case SEND_ACK:
                 //--We received a data frame, now it's time to send the ack
-                DEBUG_MSG("[LINK] RX: State = SEND_ACK (ack# = %hu)\n", seq_num);
-
-                link->tx->ack_frame_buf.type = 0xFF;
-                link->tx->ack_frame_buf.ack_num = seq_num;
+                DEBUG_MSG("[LINK] RX: State = SEND_ACK (ack# = %hu, sack = 0x%08x)\n",
+                            ack_frame.ack_num, ack_frame.sack_bits);
 
-                //Copy frame into send buf
-                convert_ack_frame_struct_to_buf(&(link->tx->ack_frame_buf),
-                                                ack_send_buf);
+                //Build the frame in the send buf
+                convert_ack_frame_struct_to_buf(&ack_frame, ack_send_buf);
                 //Calculate the CRC
                 crc_32 = crc32(ack_send_buf, ACK_FRAME_LENGTH - sizeof(crc_32));
                 //Copy this CRC to the send buf
                 memcpy(&ack_send_buf[ACK_FRAME_LENGTH - sizeof(crc_32)], &crc_32,
                         sizeof(crc_32));
                 //Transmit with phy
-                status = phy_fill_tx_buf(link->phy, ack_send_buf, ACK_FRAME_LENGTH);
+                status = send_frame(link, ack_send_buf, ACK_FRAME_LENGTH);
                 if (status != 0){
-                    fprintf(stderr, "[LINK] Couldn't fill phy tx buffer\n");
                     goto out;
                 }
                 //Done; go back to the WAIT state
@@ -1200,9 +1356,10 @@ void *receive_frames(void *arg)
                 break;
             default:
                 fprintf(stderr, "[LINK] receive_frames(): invalid state\n");
-                return NULL;
+                goto out;
         }
     }
     out:
+        phy_free_frame_buf(link->phy, ack_send_buf);
         return NULL;
 }
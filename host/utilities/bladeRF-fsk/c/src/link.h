@@ -4,10 +4,11 @@
  *
  * This file handles framing, error detection, and guaranteed delivery of frames.
  * On the sender side, this file formats payload data into packets to transmit
- * using phy.c, and waits for acknowledgements. A retransmission is automatically
- * sent if no acknowledgement is received within the timeout period. On the receiver
- * side, this file extracts payload data from a packet received using phy.c, and sends
- * acknowledgements.
+ * using phy.c, and waits for acknowledgements. Packets are sent with a selective-repeat
+ * sliding window, so several may be awaiting acknowledgement at once. A retransmission
+ * of a packet is automatically sent if no acknowledgement is received within the
+ * timeout period. On the receiver side, this file puts received packets back in order,
+ * extracts their payload data, and sends cumulative and selective acknowledgements.
  *
  * This file is part of the bladeRF project
  *
@@ -42,17 +43,26 @@
 #include "common.h"
 
 #define PAYLOAD_LENGTH 1000     //If you change this, DATA_FRAME_LENGTH
-                                //ACK_FRAME_LENGTH must also be changed in phy.h
-#define ACK_TIMEOUT_MS 500      //Timeout to wait for an acknowledgement
-#define LINK_MAX_TRIES 3        //Maximum number of frame retransmissions before the
+                                //must also be changed in phy.h
+#define ACK_TIMEOUT_MS 500      //Timeout to wait for a frame's acknowledgement before
+                                //resending it
+#define LINK_MAX_TRIES 3        //Maximum number of times a frame is sent before the
                                 //transmitter gives up
+#define LINK_MAX_WINDOW 32      //Maximum window size. Selective acks cover 32 frames,
+                                //so ACK_FRAME_LENGTH in phy.h depends on this.
+#define LINK_DEFAULT_WINDOW 8   //Default number of frames which may be awaiting
+                                //acknowledgement at once
 
 /** Opaque handle to link data structure */
 struct link_handle;
 
+struct phy_handle;
+
 /**
- * Send data of arbitrary length. Breaks data up into packets (if needed) and sends each
- * packet one-by-one.
+ * Send data of arbitrary length. Breaks data up into packets (if needed) and sends them
+ * with a sliding window: up to the window size's worth of packets may be awaiting
+ * acknowledgement at once, and each is resent if its acknowledgement times out.
+ * Returns once every packet has been acknowledged.
  *
  * @param[in]   link            pointer to link handle
  * @param[in]   data            Data to send
@@ -79,6 +89,18 @@ int link_send_data(struct link_handle *link, uint8_t *data, unsigned int data_le
 int link_receive_data(struct link_handle *link, int size, int max_timeouts,
                         uint8_t *data_buf);
 
+/**
+ * Set the transmitter's window size: the number of frames which may be awaiting
+ * acknowledgement at once. A window size of 1 is stop-and-wait.
+ *
+ * @param[in]   link            pointer to link handle
+ * @param[in]   window_size     window size, from 1 to LINK_MAX_WINDOW. Default is
+ *                              LINK_DEFAULT_WINDOW.
+ *
+ * @return      0 on success, -1 on invalid window size or error
+ */
+int link_set_window_size(struct link_handle *link, unsigned int window_size);
+
 /**
  * Initializes/allocates a link handle data structure and starts all threads
  *
@@ -89,6 +111,19 @@ int link_receive_data(struct link_handle *link, int size, int max_timeouts,
  */
 struct link_handle *link_init(struct bladerf *dev, struct radio_params *params);
 
+/**
+ * Initializes/allocates a link handle data structure over an existing PHY, e.g. one
+ * receiving from a source set with phy_set_rx_source() and transmitting to a sink set
+ * with phy_set_tx_sink(), and starts all threads. The PHY's transmitter and receiver
+ * must not have been started.
+ *
+ * @param[in]   phy         PHY handle from phy_init(). The link takes ownership of it,
+ *                          and closes it with link_close(), or on failure.
+ *
+ * @return      pointer to allocated link_handle struct on success, NULL on error
+ */
+struct link_handle *link_init_phy(struct phy_handle *phy);
+
 /**
  * Deinitializes/closes/frees a link_handle struct. Does nothing if link is NULL
  *
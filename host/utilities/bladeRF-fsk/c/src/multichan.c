@@ -0,0 +1,627 @@
+/**
+ * @brief   Multi-channel radio, running a link on each of several channels
+ *
+ * A receiving thread channelizes each block of received samples into every channel's
+ * RX queue, which its PHY reads through phy_set_rx_source(). Each PHY's bursts are
+ * queued through phy_set_tx_sink(), and a transmitting thread combines the TX queues
+ * into bursts on the device: a burst starts when any channel has samples to send, and
+ * ends once all of the queues run dry.
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2016 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include <libbladeRF.h>
+#include "host_config.h"
+
+#include "multichan.h"
+#include "channelizer.h"
+#include "phy.h"
+#include "radio_config.h"
+
+#ifdef DEBUG_MODE
+    #define DEBUG_MSG(...) fprintf(stderr, __VA_ARGS__)
+#else
+    #define DEBUG_MSG(...)
+#endif
+
+//Wideband samples received or transmitted at a time
+#define MCHAN_BLOCK SYNC_BUFFER_SIZE
+//Capacity of each channel's RX queue, in PHY reads
+#define MCHAN_RX_QUEUE_READS 4
+//Capacity of each channel's TX queue, in the PHY's longest bursts
+#define MCHAN_TX_QUEUE_BURSTS 2
+
+//Queue of SC16 Q11 samples. Protected by the radio's lock.
+struct sample_queue {
+    int16_t *buf;
+    size_t capacity;            //In samples
+    size_t head;                //Index of the oldest sample
+    size_t count;               //Samples in the queue
+    uint64_t timestamp;         //Channel sample index following the newest sample
+    bool overrun;               //Samples were dropped since the last read
+    bool closed;                //No more samples will be written/read
+};
+
+struct mchan_channel {
+    struct mchan *mchan;
+    unsigned int index;
+    bool open;                  //Has a link, so its queues are in use
+    struct link_handle *link;
+    struct sample_queue rx;     //Channelized samples, waiting for the PHY
+    struct sample_queue tx;     //The PHY's bursts, waiting to be transmitted
+};
+
+struct mchan {
+    struct bladerf *dev;        //bladeRF device handle
+    struct radio_params params;
+    unsigned int num_channels;
+    bool radio_on;              //Device configured, and must be stopped
+    struct mchan_channel channels[MCHAN_MAX_CHANNELS];
+
+    struct chan_analysis *analysis;
+    struct chan_synthesis *synthesis;
+    int16_t *rx_wide;                               //Received samples
+    int16_t *rx_narrow[MCHAN_MAX_CHANNELS];         //...channelized
+    int16_t *tx_wide;                               //Samples to transmit
+    int16_t *tx_narrow[MCHAN_MAX_CHANNELS];         //...per channel
+
+    pthread_mutex_t lock;
+    pthread_cond_t rx_cond;             //Samples were added to an RX queue
+    pthread_cond_t tx_space_cond;       //Samples were taken from a TX queue
+    pthread_cond_t tx_data_cond;        //Samples were added to a TX queue
+    bool lock_init;
+    bool stop;                          //Control variable to stop the threads
+    bool rx_done;                       //Receiving thread has finished
+    bool tx_done;                       //Transmitting thread has finished
+    pthread_t rx_thread;
+    pthread_t tx_thread;
+    bool rx_on;
+    bool tx_on;
+};
+
+/****************************************
+ *                                      *
+ *             SAMPLE QUEUES            *
+ *                                      *
+ ****************************************/
+
+static int queue_init(struct sample_queue *q, size_t capacity, bool closed)
+{
+    q->buf = malloc(capacity * 2 * sizeof(int16_t));
+    if (q->buf == NULL){
+        perror("[MCHAN] malloc");
+        return -1;
+    }
+    q->capacity = capacity;
+    q->head = 0;
+    q->count = 0;
+    q->timestamp = 0;
+    q->overrun = false;
+    q->closed = closed;
+    return 0;
+}
+
+static void queue_deinit(struct sample_queue *q)
+{
+    free(q->buf);
+    q->buf = NULL;
+}
+
+static size_t queue_space(const struct sample_queue *q)
+{
+    return q->capacity - q->count;
+}
+
+//Add n samples; there must be room for them
+static void queue_write(struct sample_queue *q, const int16_t *samples, size_t n)
+{
+    size_t tail = (q->head + q->count) % q->capacity;
+    size_t first = q->capacity - tail;
+
+    if (first > n){
+        first = n;
+    }
+    memcpy(&q->buf[2*tail], samples, first * 2 * sizeof(int16_t));
+    memcpy(q->buf, &samples[2*first], (n - first) * 2 * sizeof(int16_t));
+    q->count += n;
+    q->timestamp += n;
+}
+
+//Take n samples; the queue must hold at least that many
+static void queue_read(struct sample_queue *q, int16_t *samples, size_t n)
+{
+    size_t first = q->capacity - q->head;
+
+    if (first > n){
+        first = n;
+    }
+    memcpy(samples, &q->buf[2*q->head], first * 2 * sizeof(int16_t));
+    memcpy(&samples[2*first], q->buf, (n - first) * 2 * sizeof(int16_t));
+    q->head = (q->head + n) % q->capacity;
+    q->count -= n;
+}
+
+/****************************************
+ *                                      *
+ *         PHY SOURCES AND SINKS        *
+ *                                      *
+ ****************************************/
+
+/**
+ * phy_rx_source_fn for a channel: waits for num_samples channelized samples. Samples
+ * dropped because the PHY fell behind are reported as an overrun.
+ */
+static int mchan_rx_source(void *arg, int16_t *samples, unsigned int num_samples,
+                           struct bladerf_metadata *metadata)
+{
+    struct mchan_channel *ch = (struct mchan_channel *) arg;
+    struct mchan *mchan = ch->mchan;
+    struct sample_queue *q = &ch->rx;
+
+    pthread_mutex_lock(&mchan->lock);
+    while (q->count < num_samples && !q->closed){
+        pthread_cond_wait(&mchan->rx_cond, &mchan->lock);
+    }
+    if (q->count < num_samples){
+        pthread_mutex_unlock(&mchan->lock);
+        return 1;
+    }
+
+    metadata->timestamp = q->timestamp - q->count;
+    metadata->actual_count = num_samples;
+    metadata->status = q->overrun ? BLADERF_META_STATUS_OVERRUN : 0;
+    q->overrun = false;
+    queue_read(q, samples, num_samples);
+    pthread_mutex_unlock(&mchan->lock);
+
+    return 0;
+}
+
+/**
+ * phy_tx_sink_fn for a channel: queues a burst, waiting for room for all of it
+ */
+static int mchan_tx_sink(void *arg, const int16_t *samples, unsigned int num_samples)
+{
+    struct mchan_channel *ch = (struct mchan_channel *) arg;
+    struct mchan *mchan = ch->mchan;
+    struct sample_queue *q = &ch->tx;
+
+    if (num_samples > q->capacity){
+        return BLADERF_ERR_INVAL;
+    }
+
+    pthread_mutex_lock(&mchan->lock);
+    while (queue_space(q) < num_samples && !q->closed){
+        pthread_cond_wait(&mchan->tx_space_cond, &mchan->lock);
+    }
+    if (q->closed){
+        pthread_mutex_unlock(&mchan->lock);
+        return BLADERF_ERR_IO;
+    }
+    queue_write(q, samples, num_samples);
+    pthread_cond_signal(&mchan->tx_data_cond);
+    pthread_mutex_unlock(&mchan->lock);
+
+    return 0;
+}
+
+/****************************************
+ *                                      *
+ *        RECEIVING/TRANSMITTING        *
+ *                                      *
+ ****************************************/
+
+/**
+ * Thread function which receives the band, and channelizes it into the RX queues of
+ * the channels with a link
+ */
+static void *mchan_receive(void *arg)
+{
+    struct mchan *mchan = (struct mchan *) arg;
+    struct bladerf_metadata metadata;
+    struct sample_queue *q;
+    size_t count;
+    unsigned int k;
+    int status;
+
+    memset(&metadata, 0, sizeof(metadata));
+    metadata.flags = BLADERF_META_FLAG_RX_NOW;
+
+    while (!mchan->stop){
+        status = bladerf_sync_rx(mchan->dev, mchan->rx_wide, MCHAN_BLOCK, &metadata,
+                                 5000);
+        if (status != 0){
+            fprintf(stderr, "[MCHAN] %s: Couldn't receive samples from bladeRF: %s\n",
+                    __FUNCTION__, bladerf_strerror(status));
+            break;
+        }
+
+        count = chan_analyze(mchan->analysis, mchan->rx_wide, MCHAN_BLOCK,
+                             mchan->rx_narrow);
+
+        pthread_mutex_lock(&mchan->lock);
+        for (k = 0; k < mchan->num_channels; k++){
+            if (!mchan->channels[k].open){
+                continue;
+            }
+            q = &mchan->channels[k].rx;
+            if (metadata.status & BLADERF_META_STATUS_OVERRUN){
+                q->overrun = true;
+            }
+            if (queue_space(q) < count){
+                //The channel's PHY is behind; drop these samples
+                q->overrun = true;
+                q->timestamp += count;
+            }else{
+                queue_write(q, mchan->rx_narrow[k], count);
+            }
+        }
+        pthread_cond_broadcast(&mchan->rx_cond);
+        pthread_mutex_unlock(&mchan->lock);
+    }
+
+    //Wake the PHYs, which will find no more samples
+    pthread_mutex_lock(&mchan->lock);
+    mchan->rx_done = true;
+    for (k = 0; k < mchan->num_channels; k++){
+        mchan->channels[k].rx.closed = true;
+    }
+    pthread_cond_broadcast(&mchan->rx_cond);
+    pthread_mutex_unlock(&mchan->lock);
+
+    return NULL;
+}
+
+/**
+ * Thread function which combines the channels' TX queues into bursts. Once every
+ * queue is empty, a block of silence flushes the synthesis filter and ends the burst.
+ */
+static void *mchan_transmit(void *arg)
+{
+    struct mchan *mchan = (struct mchan *) arg;
+    const size_t per_channel = MCHAN_BLOCK / mchan->num_channels;
+    const int16_t *inputs[MCHAN_MAX_CHANNELS];
+    struct bladerf_metadata metadata;
+    struct sample_queue *q;
+    bool in_burst = false;
+    bool pending;
+    size_t n;
+    unsigned int k;
+    int status;
+
+    memset(&metadata, 0, sizeof(metadata));
+
+    pthread_mutex_lock(&mchan->lock);
+    while (!mchan->stop){
+        //Wait for a burst to start
+        pending = false;
+        for (k = 0; k < mchan->num_channels; k++){
+            pending |= mchan->channels[k].open && mchan->channels[k].tx.count > 0;
+        }
+        if (!in_burst && !pending){
+            pthread_cond_wait(&mchan->tx_data_cond, &mchan->lock);
+            continue;
+        }
+
+        //Take the next block of each channel, padding with silence
+        for (k = 0; k < mchan->num_channels; k++){
+            q = &mchan->channels[k].tx;
+            n = mchan->channels[k].open ? q->count : 0;
+            if (n > per_channel){
+                n = per_channel;
+            }
+            if (n == 0){
+                inputs[k] = NULL;
+                continue;
+            }
+            queue_read(q, mchan->tx_narrow[k], n);
+            memset(&mchan->tx_narrow[k][2*n], 0,
+                   (per_channel - n) * 2 * sizeof(int16_t));
+            inputs[k] = mchan->tx_narrow[k];
+        }
+        pthread_cond_broadcast(&mchan->tx_space_cond);
+        pthread_mutex_unlock(&mchan->lock);
+
+        chan_synthesize(mchan->synthesis, inputs, per_channel, mchan->tx_wide);
+
+        metadata.flags = in_burst ? 0 : (BLADERF_META_FLAG_TX_BURST_START |
+                                         BLADERF_META_FLAG_TX_NOW);
+        if (!pending){
+            metadata.flags |= BLADERF_META_FLAG_TX_BURST_END;
+        }
+        status = bladerf_sync_tx(mchan->dev, mchan->tx_wide, MCHAN_BLOCK, &metadata,
+                                 5000);
+        in_burst = pending;
+
+        pthread_mutex_lock(&mchan->lock);
+        if (status != 0){
+            fprintf(stderr, "[MCHAN] %s: Couldn't transmit samples with bladeRF: %s\n",
+                    __FUNCTION__, bladerf_strerror(status));
+            in_burst = false;
+            break;
+        }
+    }
+
+    //Wake the PHYs, whose bursts will no longer be sent
+    mchan->tx_done = true;
+    for (k = 0; k < mchan->num_channels; k++){
+        mchan->channels[k].tx.closed = true;
+    }
+    pthread_cond_broadcast(&mchan->tx_space_cond);
+    pthread_mutex_unlock(&mchan->lock);
+
+    if (in_burst){
+        memset(mchan->tx_wide, 0, MCHAN_BLOCK * 2 * sizeof(int16_t));
+        metadata.flags = BLADERF_META_FLAG_TX_BURST_END;
+        status = bladerf_sync_tx(mchan->dev, mchan->tx_wide, MCHAN_BLOCK, &metadata,
+                                 5000);
+        if (status != 0){
+            fprintf(stderr, "[MCHAN] %s: Couldn't end burst: %s\n", __FUNCTION__,
+                    bladerf_strerror(status));
+        }
+    }
+
+    return NULL;
+}
+
+/****************************************
+ *                                      *
+ *        INIT/DEINIT  FUNCTIONS        *
+ *                                      *
+ ****************************************/
+
+struct mchan *mchan_init(struct bladerf *dev, struct radio_params *params,
+                         unsigned int num_channels)
+{
+    struct mchan *mchan;
+    unsigned int k;
+    int status;
+
+    if (num_channels < 2 || num_channels > MCHAN_MAX_CHANNELS ||
+        (num_channels & (num_channels - 1)) != 0){
+        fprintf(stderr, "[MCHAN] %s: Invalid number of channels: %u\n", __FUNCTION__,
+                num_channels);
+        return NULL;
+    }
+
+    //Calloc so all pointers are initialized to NULL
+    mchan = calloc(1, sizeof(struct mchan));
+    if (mchan == NULL){
+        perror("[MCHAN] calloc");
+        return NULL;
+    }
+    mchan->dev = dev;
+    mchan->params = *params;
+    mchan->num_channels = num_channels;
+
+    DEBUG_MSG("[MCHAN] Initializing %u channels\n", num_channels);
+
+    //--------Configure the bladeRF device for the whole band----------
+    status = radio_init_and_configure_rate(dev, params,
+                                           num_channels * BLADERF_SAMPLE_RATE,
+                                           num_channels * BLADERF_BANDWIDTH);
+    mchan->radio_on = true;
+    if (status != 0){
+        fprintf(stderr, "[MCHAN] %s: Couldn't configure bladeRF\n", __FUNCTION__);
+        goto error;
+    }
+
+    //-------------------Create channelizers---------------------
+    mchan->analysis = chan_analysis_init(num_channels, 0);
+    mchan->synthesis = chan_synthesis_init(num_channels, 0);
+    if (mchan->analysis == NULL || mchan->synthesis == NULL){
+        fprintf(stderr, "[MCHAN] %s: Couldn't create channelizers\n", __FUNCTION__);
+        goto error;
+    }
+
+    //-------------------Allocate sample buffers-----------------
+    mchan->rx_wide = malloc(MCHAN_BLOCK * 2 * sizeof(int16_t));
+    mchan->tx_wide = malloc(MCHAN_BLOCK * 2 * sizeof(int16_t));
+    if (mchan->rx_wide == NULL || mchan->tx_wide == NULL){
+        perror("[MCHAN] malloc");
+        goto error;
+    }
+    for (k = 0; k < num_channels; k++){
+        mchan->channels[k].mchan = mchan;
+        mchan->channels[k].index = k;
+        mchan->rx_narrow[k] = malloc((MCHAN_BLOCK / num_channels + 1) * 2 *
+                                     sizeof(int16_t));
+        mchan->tx_narrow[k] = malloc(MCHAN_BLOCK / num_channels * 2 *
+                                     sizeof(int16_t));
+        if (mchan->rx_narrow[k] == NULL || mchan->tx_narrow[k] == NULL){
+            perror("[MCHAN] malloc");
+            goto error;
+        }
+    }
+
+    //-------------------Start the threads-----------------------
+    if (pthread_mutex_init(&mchan->lock, NULL) != 0 ||
+        pthread_cond_init(&mchan->rx_cond, NULL) != 0 ||
+        pthread_cond_init(&mchan->tx_space_cond, NULL) != 0 ||
+        pthread_cond_init(&mchan->tx_data_cond, NULL) != 0){
+        fprintf(stderr, "[MCHAN] %s: Error initializing pthread variables\n",
+                __FUNCTION__);
+        goto error;
+    }
+    mchan->lock_init = true;
+
+    status = pthread_create(&mchan->rx_thread, NULL, mchan_receive, mchan);
+    if (status != 0){
+        fprintf(stderr, "[MCHAN] %s: Error creating rx thread: %s\n", __FUNCTION__,
+                strerror(status));
+        goto error;
+    }
+    mchan->rx_on = true;
+
+    status = pthread_create(&mchan->tx_thread, NULL, mchan_transmit, mchan);
+    if (status != 0){
+        fprintf(stderr, "[MCHAN] %s: Error creating tx thread: %s\n", __FUNCTION__,
+                strerror(status));
+        goto error;
+    }
+    mchan->tx_on = true;
+
+    DEBUG_MSG("[MCHAN] Initialization done\n");
+    return mchan;
+
+    error:
+        mchan_close(mchan);
+        return NULL;
+}
+
+unsigned int mchan_get_frequency(struct mchan *mchan, bladerf_direction dir,
+                                 unsigned int channel)
+{
+    unsigned int center = (dir == BLADERF_TX) ? mchan->params.tx_freq
+                                              : mchan->params.rx_freq;
+
+    return (unsigned int) ((long long) center +
+                           (long long) chan_offset(mchan->num_channels, channel) *
+                           BLADERF_SAMPLE_RATE);
+}
+
+struct link_handle *mchan_open_link(struct mchan *mchan, unsigned int channel)
+{
+    struct mchan_channel *ch;
+    struct phy_handle *phy;
+    struct link_handle *link;
+
+    if (channel >= mchan->num_channels){
+        fprintf(stderr, "[MCHAN] %s: Invalid channel: %u\n", __FUNCTION__, channel);
+        return NULL;
+    }
+    ch = &mchan->channels[channel];
+    if (ch->link != NULL){
+        fprintf(stderr, "[MCHAN] %s: Channel %u already has a link\n", __FUNCTION__,
+                channel);
+        return NULL;
+    }
+
+    //The channel's PHY receives from and transmits to the channelizer
+    phy = phy_init(NULL, NULL);
+    if (phy == NULL){
+        fprintf(stderr, "[MCHAN] %s: Couldn't initialize phy handle\n", __FUNCTION__);
+        return NULL;
+    }
+    if (queue_init(&ch->rx, MCHAN_RX_QUEUE_READS * NUM_SAMPLES_RX,
+                   mchan->rx_done) != 0 ||
+        queue_init(&ch->tx, MCHAN_TX_QUEUE_BURSTS * phy_max_tx_samples(phy),
+                   mchan->tx_done) != 0){
+        queue_deinit(&ch->rx);
+        phy_close(phy);
+        return NULL;
+    }
+    phy_set_rx_source(phy, mchan_rx_source, ch);
+    phy_set_tx_sink(phy, mchan_tx_sink, ch);
+
+    pthread_mutex_lock(&mchan->lock);
+    ch->open = true;
+    pthread_mutex_unlock(&mchan->lock);
+
+    link = link_init_phy(phy);
+    if (link == NULL){
+        pthread_mutex_lock(&mchan->lock);
+        ch->open = false;
+        pthread_mutex_unlock(&mchan->lock);
+        queue_deinit(&ch->tx);
+        queue_deinit(&ch->rx);
+        return NULL;
+    }
+    ch->link = link;
+
+    DEBUG_MSG("[MCHAN] Channel %u: RX %u Hz, TX %u Hz\n", channel,
+              mchan_get_frequency(mchan, BLADERF_RX, channel),
+              mchan_get_frequency(mchan, BLADERF_TX, channel));
+    return link;
+}
+
+void mchan_close(struct mchan *mchan)
+{
+    struct mchan_channel *ch;
+    unsigned int k;
+    int status;
+
+    if (mchan == NULL){
+        return;
+    }
+    DEBUG_MSG("[MCHAN] Closing\n");
+
+    //Close the links while the threads still run, so their PHYs wind down normally
+    for (k = 0; k < mchan->num_channels; k++){
+        ch = &mchan->channels[k];
+        if (ch->link == NULL){
+            continue;
+        }
+        link_close(ch->link);
+        ch->link = NULL;
+
+        pthread_mutex_lock(&mchan->lock);
+        ch->open = false;
+        pthread_mutex_unlock(&mchan->lock);
+        queue_deinit(&ch->tx);
+        queue_deinit(&ch->rx);
+    }
+
+    //Stop the threads
+    if (mchan->lock_init){
+        pthread_mutex_lock(&mchan->lock);
+        mchan->stop = true;
+        pthread_cond_broadcast(&mchan->tx_data_cond);
+        pthread_mutex_unlock(&mchan->lock);
+    }
+    if (mchan->tx_on){
+        status = pthread_join(mchan->tx_thread, NULL);
+        if (status != 0){
+            fprintf(stderr, "[MCHAN] %s: Error joining tx thread: %s\n", __FUNCTION__,
+                    strerror(status));
+        }
+    }
+    if (mchan->rx_on){
+        status = pthread_join(mchan->rx_thread, NULL);
+        if (status != 0){
+            fprintf(stderr, "[MCHAN] %s: Error joining rx thread: %s\n", __FUNCTION__,
+                    strerror(status));
+        }
+    }
+    if (mchan->lock_init){
+        pthread_cond_destroy(&mchan->tx_data_cond);
+        pthread_cond_destroy(&mchan->tx_space_cond);
+        pthread_cond_destroy(&mchan->rx_cond);
+        pthread_mutex_destroy(&mchan->lock);
+    }
+
+    //Stop bladeRF (handle closed elsewhere)
+    if (mchan->radio_on){
+        radio_stop(mchan->dev);
+    }
+
+    for (k = 0; k < mchan->num_channels; k++){
+        free(mchan->rx_narrow[k]);
+        free(mchan->tx_narrow[k]);
+    }
+    free(mchan->rx_wide);
+    free(mchan->tx_wide);
+    chan_synthesis_deinit(mchan->synthesis);
+    chan_analysis_deinit(mchan->analysis);
+    free(mchan);
+}
@@ -0,0 +1,106 @@
+/**
+ * @file
+ * @brief   Multi-channel radio, running a link on each of several channels
+ *
+ * This file runs several independent links on one bladeRF device. The device samples a
+ * band num_channels channels wide, and channelizer.c splits the received band into
+ * channels and combines the channels to transmit back into one band. Each channel is
+ * sampled at BLADERF_SAMPLE_RATE, as a single-channel PHY would be, and carries its own
+ * PHY and link layer, which receive from and transmit to the channelizer in place of
+ * the device.
+ *
+ * ```
+ *                            / PHY + link (channel 0)
+ *    bladeRF -- channelizer -- PHY + link (channel 1)
+ *                           \  ...
+ * ```
+ *
+ * Each PHY runs its receive pipeline on its own threads, so the channels are processed
+ * in parallel.
+ *
+ * Channel k is centered chan_offset(num_channels, k) * BLADERF_SAMPLE_RATE from the RX
+ * and TX frequencies. Channel 0 is centered on them, where the device's DC offset and
+ * LO leakage are, and is best left unused. Every channel is transmitted at
+ * 1/num_channels of a single-channel PHY's amplitude, so the transmit gains may need
+ * raising to match.
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2016 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef MULTICHAN_H
+#define MULTICHAN_H
+
+#include <libbladeRF.h>
+
+#include "common.h"
+#include "link.h"
+
+//Most channels a multi-channel radio may have. This keeps the band within 32 MHz.
+#define MCHAN_MAX_CHANNELS 16
+
+struct mchan;
+
+/**
+ * Configure a device for num_channels channels, and start receiving and transmitting
+ *
+ * @param[in]   dev             pointer to opened bladeRF device handle
+ * @param[in]   params          radio parameters. The frequencies are the centers of the
+ *                              RX and TX bands.
+ * @param[in]   num_channels    number of channels, a power of 2 from 2 to
+ *                              MCHAN_MAX_CHANNELS
+ *
+ * @return      multi-channel radio on success, NULL on failure
+ */
+struct mchan *mchan_init(struct bladerf *dev, struct radio_params *params,
+                         unsigned int num_channels);
+
+/**
+ * Get the RX or TX frequency a channel is centered on
+ *
+ * @param[in]   mchan       multi-channel radio
+ * @param[in]   dir         BLADERF_RX or BLADERF_TX
+ * @param[in]   channel     channel, from 0 to num_channels - 1
+ *
+ * @return      frequency, in Hz
+ */
+unsigned int mchan_get_frequency(struct mchan *mchan, bladerf_direction dir,
+                                 unsigned int channel);
+
+/**
+ * Start a link on a channel. Until a channel's link is started, the samples received
+ * on it are discarded.
+ *
+ * @param[in]   mchan       multi-channel radio
+ * @param[in]   channel     channel, from 0 to num_channels - 1
+ *
+ * @return      link handle on success, NULL on failure or if the channel already has
+ *              a link. The link belongs to the radio, and is closed by mchan_close();
+ *              don't pass it to link_close().
+ */
+struct link_handle *mchan_open_link(struct mchan *mchan, unsigned int channel);
+
+/**
+ * Close every channel's link, stop receiving and transmitting, and free the radio.
+ * The device must be closed elsewhere. Does nothing if mchan is NULL.
+ *
+ * @param[in]   mchan       multi-channel radio
+ */
+void mchan_close(struct mchan *mchan);
+
+#endif
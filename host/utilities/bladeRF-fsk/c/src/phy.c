@@ -4,9 +4,9 @@
  * This file handles transmission/reception of data frames over the air. It uses fsk.c to
  * perform baseband IQ modulation and demodulation, and libbladeRF to transmit/receive
  * samples using the bladeRF device. A different modulator could be used by swapping
- * fsk.c with a file that implements a different modulator. On the receive side the file
- * uses fir_filter.c to low-pass filter the received signal, pnorm.c to power normalize
- * the input signal, and correlator.c to correlate the received signal with a preamble.
+ * fsk.c with a file that implements a different modulator. Both the transmitted and the
+ * received signals are low-pass filtered with fir_filter.c. On the receive side the file
+ * also uses pnorm.c to power normalize the input signal, and correlator.c to correlate the received signal with a preamble.
  * waveform.
  *
  * The structure of a physical layer transmission is as follows:
@@ -32,6 +32,9 @@
  * with this program; if not, write to the Free Software Foundation, Inc.,
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
+#include <assert.h>
+#include <inttypes.h>
+
 #include "phy.h"
 #include "fir_filter.h"
 #include "rx_ch_filter.h"
@@ -56,23 +59,92 @@
     #define NOTE(...)
 #endif
 
+//The TX channel filter is the RX channel filter scaled by this gain, so that
+//its overshoot on the ramps stays within SC16Q11 full scale
+#define TX_CH_FILTER_GAIN 0.95f
+
+//Zeros appended to a burst so the TX channel filter's output decays to 0
+#define TX_CH_FILTER_TAIL (rx_ch_filter_len - 1)
+
+//Number of sample blocks in flight in the RX pipeline
+#define RX_PIPE_NUM_BLOCKS 8
+//Most preamble matches recorded per block
+#define RX_PIPE_MAX_MATCHES 16
+
 //Internal structs
+
+//Pool of frame buffers, shared with the link layer
+struct frame_pool {
+    uint8_t *mem;                               //Backs every buffer
+    uint8_t *free_bufs[PHY_FRAME_POOL_SIZE];    //Stack of free buffers
+    unsigned int num_free;                      //Number of buffers in 'free_bufs'
+    pthread_mutex_t lock;                       //Mutex for free_bufs/num_free
+};
+
+//A block of samples passed between RX pipeline stages
+struct rx_block {
+    int16_t *raw;                       //Raw input samples from device
+    struct complex_sample *samples;     //Filtered, then power normalized samples
+    unsigned int num_matches;           //Preamble matches found in 'samples'
+    unsigned int matches[RX_PIPE_MAX_MATCHES];  //Index of each match
+};
+
+//Queue of blocks between two RX pipeline stages. Every queue can hold all of the
+//blocks, so pushing never waits; readers wait for a block or for the queue to close.
+struct block_queue {
+    struct rx_block *blocks[RX_PIPE_NUM_BLOCKS];
+    unsigned int head;
+    unsigned int count;
+    bool closed;                        //No more blocks will be pushed
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+};
+
+//RX pipeline stage, which processes blocks from one queue and passes them to the next
+struct rx_stage {
+    struct phy_handle *phy;
+    struct block_queue *in;
+    struct block_queue *out;
+    void (*process)(struct phy_handle *phy, struct rx_block *block);
+    pthread_t thread;
+    double cpu_secs;                    //CPU time used by the thread, once finished
+};
+
+//State of the frame being demodulated, which may span several blocks
+struct rx_frame {
+    bool active;                        //A preamble was matched; demodulating a frame
+    bool new_frame;                     //Next demod is the start of the frame
+    int length;                         //Link layer frame length, 0 until known
+    unsigned int data_index;            //Bytes demodulated so far
+    unsigned int num_bytes_to_demod;    //Bytes left to demodulate
+    uint8_t *buf;                       //Demodulated bytes, in a pool buffer. NULL
+                                        //once handed to the link layer.
+};
+
 struct rx {
-    int16_t *in_samples;        //Raw input samples from device
+    struct rx_block blocks[RX_PIPE_NUM_BLOCKS];     //Sample blocks
+    //free_blocks feeds the receiving stage; queues[n] feeds stage n
+    struct block_queue free_blocks;
+    struct block_queue queues[PHY_RX_NUM_STAGES];
+    struct rx_stage stages[PHY_RX_NUM_STAGES];
+    bool failed;                        //A stage failed; stop receiving
+    phy_rx_source_fn source;            //Provides samples instead of the device, if set
+    void *source_arg;                   //Argument for 'source'
+    struct phy_rx_stats stats;          //Receiver statistics
+    struct rx_frame frame;
     struct fir_filter *ch_filt;             //Channel filter
     struct pnorm_state_t *pnorm;            //Power normalizer
     struct correlator *corr;                //Correlator
-    struct complex_sample *filt_samples;    //Filtered input samples
-    struct complex_sample *pnorm_samples;    //power normalized samples
-    uint8_t *data_buf;            //received data output buffer (no training seq/preamble)
-    bool buf_filled;            //is the rx data buffer filled
+    uint8_t *data_buf;            //received frame waiting for phy_request_rx_buf()
+    bool buf_filled;            //is a received frame waiting in data_buf
     bool stop;                    //control variable to stop the receiver
     pthread_t thread;            //pthread for the receiver
     pthread_cond_t buf_filled_cond;        //condition variable for buf_filled
+    pthread_cond_t buf_taken_cond;      //signalled when data_buf is taken
     pthread_mutex_t buf_status_lock;    //mutex variable for accessing buf_filled
 };
 struct tx {
-    uint8_t *data_buf;            //input data to transmit (including training seq/preamble)
+    uint8_t *data_buf;            //frame buffer to transmit, lent by phy_fill_tx_buf()
     unsigned int data_length;    //length of data to transmit (not including preamble)
     bool buf_filled;
     bool stop;
@@ -81,6 +153,9 @@ struct tx {
     pthread_mutex_t buf_status_lock;
     unsigned int max_num_samples;        //Maximum number of tx samples to transmit
     struct complex_sample *samples;        //output samples to transmit
+    struct fir_filter *ch_filt;            //Channel filter
+    phy_tx_sink_fn sink;                //Takes bursts instead of the device, if set
+    void *sink_arg;                     //Argument for 'sink'
 };
 
 struct phy_handle {
@@ -88,14 +163,17 @@ struct phy_handle {
     struct fsk_handle *fsk;        //fsk handle
     struct tx *tx;                //tx data structure
     struct rx *rx;                //rx data structure
+    struct frame_pool pool;        //frame buffers
+    bool pool_init;                //is the pool's mutex initialized
     uint8_t *scrambling_sequence;
 };
 
 //Internal functions
 void *phy_receive_frames(void *arg);
 void *phy_transmit_frames(void *arg);
-static void scramble_frame(uint8_t *frame, int frame_length, uint8_t *scrambling_sequence);
 static void unscramble_frame(uint8_t *frame, int frame_length, uint8_t *scrambling_sequence);
+static int tx_build_burst(struct phy_handle *phy, uint8_t *data_buf, unsigned int length,
+                            int16_t *samples_raw);
 static void create_ramps(unsigned int ramp_length, struct complex_sample ramp_down_init,
                     struct complex_sample *ramp_up, struct complex_sample *ramp_down);
 
@@ -111,6 +189,8 @@ struct phy_handle *phy_init(struct bladerf *dev, struct radio_params *params)
     struct phy_handle *phy;
     uint64_t prng_seed;
     uint8_t preamble[PREAMBLE_LENGTH] = PREAMBLE;
+    float tx_ch_filter[sizeof(rx_ch_filter) / sizeof(rx_ch_filter[0])];
+    size_t i;
 
     //------------Allocate memory for phy handle struct--------------
     //Calloc so all pointers are initialized to NULL
@@ -122,18 +202,19 @@ struct phy_handle *phy_init(struct bladerf *dev, struct radio_params *params)
 
     DEBUG_MSG("[PHY] Initializing...\n");
 
-    if (dev == NULL){
-        fprintf(stderr, "[PHY] %s: BladeRF device uninitialized", __FUNCTION__);
-    }
     phy->dev = dev;
 
     //--------Initialize and configure bladeRF device-------------
-    status = radio_init_and_configure(phy->dev, params);
-    if (status != 0){
-        fprintf(stderr, "[PHY] %s: Couldn't configure bladeRF\n", __FUNCTION__);
-        goto error;
+    if (dev != NULL){
+        status = radio_init_and_configure(phy->dev, params);
+        if (status != 0){
+            fprintf(stderr, "[PHY] %s: Couldn't configure bladeRF\n", __FUNCTION__);
+            goto error;
+        }
+        DEBUG_MSG("[PHY] BladeRF initialized and configured successfully\n");
+    }else{
+        DEBUG_MSG("[PHY] Running without a bladeRF device\n");
     }
-    DEBUG_MSG("[PHY] BladeRF initialized and configured successfully\n");
 
     //-------------------Open fsk handle------------------------
     phy->fsk = fsk_init();
@@ -143,28 +224,49 @@ struct phy_handle *phy_init(struct bladerf *dev, struct radio_params *params)
     }
     DEBUG_MSG("[PHY] FSK Initialized\n");
 
-    //------------------Initialize TX struct--------------------
-    phy->tx = calloc(1, sizeof(struct tx));
-    if (phy->tx == NULL){
+    //-------------------Allocate frame buffers---------------------
+    phy->pool.mem = malloc(PHY_FRAME_POOL_SIZE * (PHY_FRAME_HEADROOM +
+                                MAX_LINK_FRAME_SIZE));
+    if (phy->pool.mem == NULL){
         perror("[PHY] malloc");
         goto error;
     }
-    //Allocate memory for tx data buffer
-    phy->tx->data_buf = malloc(TRAINING_SEQ_LENGTH + PREAMBLE_LENGTH +
-                                MAX_LINK_FRAME_SIZE);
-    if (phy->tx->data_buf == NULL){
+    for (i = 0; i < PHY_FRAME_POOL_SIZE; i++){
+        phy->pool.free_bufs[i] = &(phy->pool.mem[i * (PHY_FRAME_HEADROOM +
+                                MAX_LINK_FRAME_SIZE) + PHY_FRAME_HEADROOM]);
+    }
+    phy->pool.num_free = PHY_FRAME_POOL_SIZE;
+    status = pthread_mutex_init(&(phy->pool.lock), NULL);
+    if (status != 0){
+        fprintf(stderr, "[PHY] %s: Error initializing pthread_mutex\n", __FUNCTION__);
+        goto error;
+    }
+    phy->pool_init = true;
+
+    //------------------Initialize TX struct--------------------
+    phy->tx = calloc(1, sizeof(struct tx));
+    if (phy->tx == NULL){
         perror("[PHY] malloc");
         goto error;
     }
     //Allocate memory for tx samples buffer
-    //2*RAMP_LENGTH for the ramp up/ramp down
+    //2*RAMP_LENGTH for the ramp up/ramp down, plus the channel filter's tail
     phy->tx->max_num_samples = 2*RAMP_LENGTH + (TRAINING_SEQ_LENGTH + PREAMBLE_LENGTH +
-                    MAX_LINK_FRAME_SIZE) * 8 * SAMP_PER_SYMB;
+                    MAX_LINK_FRAME_SIZE) * 8 * SAMP_PER_SYMB + TX_CH_FILTER_TAIL;
     phy->tx->samples = malloc(phy->tx->max_num_samples * sizeof(struct complex_sample));
     if (phy->tx->samples == NULL){
         perror("[PHY] malloc");
         goto error;
     }
+    // Create TX Channel Filter
+    for (i = 0; i < rx_ch_filter_len; i++) {
+        tx_ch_filter[i] = rx_ch_filter[i] * TX_CH_FILTER_GAIN;
+    }
+    phy->tx->ch_filt = fir_init(tx_ch_filter, rx_ch_filter_len);
+    if (phy->tx->ch_filt == NULL) {
+        fprintf(stderr, "[PHY] %s: Failed to create TX channel filter.\n", __FUNCTION__);
+        goto error;
+    }
     //Initialize control variables
     phy->tx->data_length = 0;
     phy->tx->buf_filled = false;
@@ -188,31 +290,15 @@ struct phy_handle *phy_init(struct bladerf *dev, struct radio_params *params)
         perror("[PHY] malloc");
         goto error;
     }
-    //Allocate memory for rx data buffer
-    phy->rx->data_buf = malloc(MAX_LINK_FRAME_SIZE);
-    if (phy->rx->data_buf == NULL){
-        perror("[PHY] malloc");
-        goto error;
-    }
-    //Allocate memory for rx samples buffer
-    phy->rx->in_samples = malloc(NUM_SAMPLES_RX * 2 * sizeof(phy->rx->in_samples[0]));
-    if (phy->rx->in_samples == NULL){
-        perror("[PHY] malloc");
-        goto error;
-    }
-
-    // Allocate memory for filtered RX samples
-    phy->rx->filt_samples = malloc(NUM_SAMPLES_RX * sizeof(struct complex_sample));
-    if (phy->rx->filt_samples == NULL){
-        perror("[PHY] malloc");
-        goto error;
-    }
-
-    //Allocate memory for power normalized samples
-    phy->rx->pnorm_samples = malloc(NUM_SAMPLES_RX * sizeof(struct complex_sample));
-    if (phy->rx->pnorm_samples == NULL){
-        perror("[PHY] malloc");
-        goto error;
+    //Allocate memory for the RX pipeline's sample blocks
+    for (i = 0; i < RX_PIPE_NUM_BLOCKS; i++){
+        phy->rx->blocks[i].raw = malloc(NUM_SAMPLES_RX * 2 * sizeof(int16_t));
+        phy->rx->blocks[i].samples = malloc(NUM_SAMPLES_RX *
+                                            sizeof(struct complex_sample));
+        if (phy->rx->blocks[i].raw == NULL || phy->rx->blocks[i].samples == NULL){
+            perror("[PHY] malloc");
+            goto error;
+        }
     }
 
     // Create RX Channel Filter
@@ -229,6 +315,10 @@ struct phy_handle *phy_init(struct bladerf *dev, struct radio_params *params)
                 __FUNCTION__);
         goto error;
     }
+    //Update the gain once per symbol
+    if (pnorm_set_block_len(phy->rx->pnorm, SAMP_PER_SYMB) != 0){
+        goto error;
+    }
 
     //Create RX correlator
     phy->rx->corr = corr_init(preamble, 8*PREAMBLE_LENGTH, SAMP_PER_SYMB);
@@ -246,6 +336,11 @@ struct phy_handle *phy_init(struct bladerf *dev, struct radio_params *params)
         fprintf(stderr, "[PHY] %s: Error initializing pthread_cond\n", __FUNCTION__);
         goto error;
     }
+    status = pthread_cond_init(&(phy->rx->buf_taken_cond), NULL);
+    if (status != 0){
+        fprintf(stderr, "[PHY] %s: Error initializing pthread_cond\n", __FUNCTION__);
+        goto error;
+    }
     //Initialize pthread mutex variable for buf_filled
     status = pthread_mutex_init(&(phy->rx->buf_status_lock), NULL);
     if (status != 0){
@@ -283,19 +378,22 @@ struct phy_handle *phy_init(struct bladerf *dev, struct radio_params *params)
 void phy_close(struct phy_handle *phy)
 {
     int status;
+    size_t i;
 
     DEBUG_MSG("[PHY] Closing\n");
     if (phy != NULL){
         //close fsk handle
         fsk_close(phy->fsk);
         //Stop bladeRF (handle closed elsewhere)
-        radio_stop(phy->dev);
+        if (phy->dev != NULL){
+            radio_stop(phy->dev);
+        }
         //free scrambling sequence buffer
         free(phy->scrambling_sequence);
         //free TX struct and its buffers
         if (phy->tx != NULL){
-            free(phy->tx->data_buf);
             free(phy->tx->samples);
+            fir_deinit(phy->tx->ch_filt);
             status = pthread_mutex_destroy(&(phy->tx->buf_status_lock));
             if (status != 0){
                 fprintf(stderr, "[PHY] %s: Error destroying pthread_mutex\n",
@@ -310,13 +408,13 @@ void phy_close(struct phy_handle *phy)
         free(phy->tx);
         //free RX struct and its buffers
         if (phy->rx != NULL){
-            free(phy->rx->data_buf);
             fir_deinit(phy->rx->ch_filt);
             corr_deinit(phy->rx->corr);
             pnorm_deinit(phy->rx->pnorm);
-            free(phy->rx->in_samples);
-            free(phy->rx->filt_samples);
-            free(phy->rx->pnorm_samples);
+            for (i = 0; i < RX_PIPE_NUM_BLOCKS; i++){
+                free(phy->rx->blocks[i].raw);
+                free(phy->rx->blocks[i].samples);
+            }
             status = pthread_mutex_destroy(&(phy->rx->buf_status_lock));
             if (status != 0){
                 fprintf(stderr, "[PHY] %s: Error destroying pthread_mutex\n",
@@ -327,14 +425,57 @@ void phy_close(struct phy_handle *phy)
                 fprintf(stderr, "[PHY] %s: Error destroying pthread_cond\n",
                         __FUNCTION__);
             }
+            status = pthread_cond_destroy(&(phy->rx->buf_taken_cond));
+            if (status != 0){
+                fprintf(stderr, "[PHY] %s: Error destroying pthread_cond\n",
+                        __FUNCTION__);
+            }
         }
         free(phy->rx);
+        //free frame buffers, including any not returned to the pool
+        free(phy->pool.mem);
+        if (phy->pool_init){
+            status = pthread_mutex_destroy(&(phy->pool.lock));
+            if (status != 0){
+                fprintf(stderr, "[PHY] %s: Error destroying pthread_mutex\n",
+                        __FUNCTION__);
+            }
+        }
     }
     //free phy struct
     free(phy);
     phy = NULL;
 }
 
+/****************************************
+ *                                      *
+ *         FRAME BUFFER FUNCTIONS       *
+ *                                      *
+ ****************************************/
+
+uint8_t *phy_alloc_frame_buf(struct phy_handle *phy)
+{
+    uint8_t *buf = NULL;
+
+    pthread_mutex_lock(&(phy->pool.lock));
+    if (phy->pool.num_free > 0){
+        buf = phy->pool.free_bufs[--phy->pool.num_free];
+    }
+    pthread_mutex_unlock(&(phy->pool.lock));
+    return buf;
+}
+
+void phy_free_frame_buf(struct phy_handle *phy, uint8_t *buf)
+{
+    if (buf == NULL){
+        return;
+    }
+    pthread_mutex_lock(&(phy->pool.lock));
+    assert(phy->pool.num_free < PHY_FRAME_POOL_SIZE);
+    phy->pool.free_bufs[phy->pool.num_free++] = buf;
+    pthread_mutex_unlock(&(phy->pool.lock));
+}
+
 /****************************************
  *                                      *
  *          TRANSMITTER FUNCTIONS       *
@@ -345,6 +486,11 @@ int phy_start_transmitter(struct phy_handle *phy)
 {
     int status;
 
+    if (phy->dev == NULL && phy->tx->sink == NULL){
+        fprintf(stderr, "[PHY] %s: No bladeRF device or sample sink to transmit to\n",
+                __FUNCTION__);
+        return -1;
+    }
     //turn off stop signal
     phy->tx->stop = false;
     //Kick off frame transmitter thread
@@ -411,8 +557,8 @@ int phy_fill_tx_buf(struct phy_handle *phy, uint8_t *data_buf, unsigned int leng
         usleep(50);
     }
 
-    //Copy the tx data into the phy's tx data buf, just after where the preamble goes
-    memcpy(&(phy->tx->data_buf[TRAINING_SEQ_LENGTH+PREAMBLE_LENGTH]), data_buf, length);
+    //Lend the frame buffer to the transmitter thread
+    phy->tx->data_buf = data_buf;
     //Set the data length
     phy->tx->data_length = length;
     //Mark the buffer filled
@@ -433,9 +579,99 @@ int phy_fill_tx_buf(struct phy_handle *phy, uint8_t *data_buf, unsigned int leng
         fprintf(stderr, "[PHY] %s: Error unlocking pthread_mutex\n", __FUNCTION__);
         return -1;
     }
+    //The frame is modulated straight from the caller's buffer, so wait for that
+    //before handing the buffer back
+    while(phy->tx->buf_filled){
+        usleep(50);
+    }
     return 0;
 }
 
+unsigned int phy_max_tx_samples(struct phy_handle *phy)
+{
+    return phy->tx->max_num_samples;
+}
+
+void phy_set_tx_sink(struct phy_handle *phy, phy_tx_sink_fn sink, void *arg)
+{
+    phy->tx->sink = sink;
+    phy->tx->sink_arg = arg;
+}
+
+int phy_modulate_frame(struct phy_handle *phy, uint8_t *data_buf, unsigned int length,
+                        int16_t *samples)
+{
+    if (data_buf == NULL || length > MAX_LINK_FRAME_SIZE){
+        fprintf(stderr, "[PHY] %s: Invalid frame\n", __FUNCTION__);
+        return -1;
+    }
+    return tx_build_burst(phy, data_buf, length, samples);
+}
+
+/**
+ * Builds the samples of the burst for a frame: ramp up, training sequence, preamble,
+ * frame (scrambled as it is modulated), ramp down, and the channel filter's tail. The
+ * training sequence and preamble are written into the frame buffer's headroom.
+ *
+ * @param[in]   phy             pointer to phy handle struct
+ * @param[in]   data_buf        frame buffer holding the frame to transmit
+ * @param[in]   length          length of the frame
+ * @param[out]  samples_raw     burst samples
+ *
+ * @return      number of samples in the burst
+ */
+static int tx_build_burst(struct phy_handle *phy, uint8_t *data_buf, unsigned int length,
+                            int16_t *samples_raw)
+{
+    uint8_t preamble[PREAMBLE_LENGTH] = PREAMBLE;
+    uint8_t training_seq[TRAINING_SEQ_LENGTH] = TRAINING_SEQ;
+    int ramp_down_index;
+    int num_mod_samples, num_samples;
+    uint8_t *frame;                     //Frame, including the training seq/preamble
+    uint8_t *scrambling_sequence;       //NULL if frames are sent unscrambled
+
+    //Calculate the number of samples to transmit.
+    num_samples = 2*RAMP_LENGTH + (TRAINING_SEQ_LENGTH + PREAMBLE_LENGTH +
+                length) * 8 * SAMP_PER_SYMB;
+    #ifndef BYPASS_TX_CHANNEL_FILTER
+        num_samples += TX_CH_FILTER_TAIL;
+    #endif
+    //Add training sequence and preamble to the frame buffer's headroom
+    frame = data_buf - PHY_FRAME_HEADROOM;
+    memcpy(frame, &training_seq, TRAINING_SEQ_LENGTH);
+    memcpy(&frame[TRAINING_SEQ_LENGTH], &preamble, PREAMBLE_LENGTH);
+    //modulate samples - leave space for ramp up/ramp down in the samples buffer
+    #ifndef BYPASS_PHY_SCRAMBLING
+        //Scramble the frame data (not including the training sequence or preamble)
+        //as it is modulated
+        scrambling_sequence = phy->scrambling_sequence;
+    #else
+        scrambling_sequence = NULL;
+    #endif
+    num_mod_samples = fsk_mod_scrambled(phy->fsk, frame, PHY_FRAME_HEADROOM + length,
+                        PHY_FRAME_HEADROOM, scrambling_sequence,
+                        &(phy->tx->samples[RAMP_LENGTH]));
+
+    //Add the ramp up/ ramp down of samples
+    ramp_down_index = RAMP_LENGTH+num_mod_samples;
+    create_ramps(RAMP_LENGTH, phy->tx->samples[ramp_down_index-1], phy->tx->samples,
+                    &(phy->tx->samples[ramp_down_index]));
+    //zero the rest of the tx samples buffer
+    memset(&(phy->tx->samples[ramp_down_index + RAMP_LENGTH]), 0,
+            (num_samples - ramp_down_index - RAMP_LENGTH) *
+            sizeof(struct complex_sample));
+    //Convert samples
+    conv_struct_to_samples(phy->tx->samples, num_samples, samples_raw);
+    #ifndef BYPASS_TX_CHANNEL_FILTER
+        // Apply channel filter. Each burst starts from a clean state.
+        fir_reset(phy->tx->ch_filt);
+        fir_process(phy->tx->ch_filt, samples_raw, phy->tx->samples, num_samples);
+        conv_struct_to_samples(phy->tx->samples, num_samples, samples_raw);
+    #endif
+
+    return num_samples;
+}
+
 /**
  * Thread function which transmits data frames
  *
@@ -446,10 +682,7 @@ void *phy_transmit_frames(void *arg)
     int status;
     //Cast arg
     struct phy_handle *phy = (struct phy_handle *) arg;
-    uint8_t preamble[PREAMBLE_LENGTH] = PREAMBLE;
-    uint8_t training_seq[TRAINING_SEQ_LENGTH] = TRAINING_SEQ;
-    int ramp_down_index;
-    int num_mod_samples, num_samples;
+    int num_samples;
     bool failed = false;
     struct bladerf_metadata metadata;
     int16_t *out_samples_raw = NULL;
@@ -500,37 +733,19 @@ void *phy_transmit_frames(void *arg)
         }
         //------------Transmit the frame-------------
         DEBUG_MSG("[PHY] TX: Buffer filled. Transmitting.\n");
-        //Calculate the number of samples to transmit.
-        num_samples = 2*RAMP_LENGTH + (TRAINING_SEQ_LENGTH + PREAMBLE_LENGTH +
-                    phy->tx->data_length) * 8 * SAMP_PER_SYMB;
-        //Add training sequence to tx data buffer
-        memcpy(phy->tx->data_buf, &training_seq, TRAINING_SEQ_LENGTH);
-        //Add preamble to tx data buffer
-        memcpy(&(phy->tx->data_buf[TRAINING_SEQ_LENGTH]), &preamble, PREAMBLE_LENGTH);
-        #ifndef BYPASS_PHY_SCRAMBLING
-            //Scramble the frame data (not including the training sequence or preamble)
-            scramble_frame(&(phy->tx->data_buf[TRAINING_SEQ_LENGTH + PREAMBLE_LENGTH]),
-                            phy->tx->data_length, phy->scrambling_sequence);
-        #endif
-        //zero the tx samples buffer
-        memset(phy->tx->samples, 0, sizeof(int16_t) * 2 * num_samples);
-        //modulate samples - leave space for ramp up/ramp down in the samples buffer
-        num_mod_samples = fsk_mod(phy->fsk, phy->tx->data_buf,
-                            TRAINING_SEQ_LENGTH + PREAMBLE_LENGTH + phy->tx->data_length,
-                            &(phy->tx->samples[RAMP_LENGTH]));
-        //Mark the buffer empty
+        num_samples = tx_build_burst(phy, phy->tx->data_buf, phy->tx->data_length,
+                                        out_samples_raw);
+        //Mark the buffer empty, handing it back to phy_fill_tx_buf()
         phy->tx->buf_filled = false;
 
-        //Add the ramp up/ ramp down of samples
-        ramp_down_index = RAMP_LENGTH+num_mod_samples;
-        create_ramps(RAMP_LENGTH, phy->tx->samples[ramp_down_index-1], phy->tx->samples,
-                        &(phy->tx->samples[ramp_down_index]));
-        //Convert samples
-        conv_struct_to_samples(phy->tx->samples, num_samples, out_samples_raw);
-
         //transmit all samples. TX_NOW
-        status = bladerf_sync_tx(phy->dev, out_samples_raw, num_samples,
-                                &metadata, 5000);
+        if (phy->tx->sink != NULL){
+            status = phy->tx->sink(phy->tx->sink_arg, out_samples_raw,
+                                    (unsigned int) num_samples);
+        }else{
+            status = bladerf_sync_tx(phy->dev, out_samples_raw, num_samples,
+                                    &metadata, 5000);
+        }
         if (status != 0){
             fprintf(stderr, "[PHY] %s: Couldn't transmit samples with bladeRF: %s\n",
                     __FUNCTION__, bladerf_strerror(status));
@@ -592,20 +807,6 @@ static void create_ramps(unsigned int ramp_length, struct complex_sample ramp_do
     ramp_down[ramp_length-1].q = 0;        //Q
 }
 
-/**
- * Scrambles the given data with the given scrambling sequence. The size of the
- * scrambling sequence array must be at least as large as the frame.
- */
-static void scramble_frame(uint8_t *frame, int frame_length,
-                            uint8_t *scrambling_sequence)
-{
-    int i;
-    for (i = 0; i < frame_length; i++){
-        //XOR byte with byte from scrambling sequence
-        frame[i] ^= scrambling_sequence[i];
-    }
-}
-
 /****************************************
  *                                      *
  *          RECEIVER FUNCTIONS          *
@@ -616,6 +817,11 @@ int phy_start_receiver(struct phy_handle *phy)
 {
     int status;
 
+    if (phy->dev == NULL && phy->rx->source == NULL){
+        fprintf(stderr, "[PHY] %s: No bladeRF device or sample source to receive from\n",
+                __FUNCTION__);
+        return -1;
+    }
     //turn off stop signal
     phy->rx->stop = false;
     //Kick off frame receiver thread
@@ -633,8 +839,11 @@ int phy_stop_receiver(struct phy_handle *phy)
     int status;
 
     DEBUG_MSG("[PHY] RX: Stopping receiver...\n");
-    //signal stop
+    //signal stop, waking the receiver if it is waiting for a frame to be taken
+    pthread_mutex_lock(&(phy->rx->buf_status_lock));
     phy->rx->stop = true;
+    pthread_cond_broadcast(&(phy->rx->buf_taken_cond));
+    pthread_mutex_unlock(&(phy->rx->buf_status_lock));
     //Wait for rx thread to finish
     status = pthread_join(phy->rx->thread, NULL);
     if (status != 0){
@@ -650,7 +859,7 @@ uint8_t *phy_request_rx_buf(struct phy_handle *phy, unsigned int timeout_ms)
 {
     int status;
     struct timespec timeout_abs;
-    bool failed = false;
+    uint8_t *buf = NULL;
 
     //Create absolute time format timeout
     status = create_timeout_abs(timeout_ms, &timeout_abs);
@@ -677,259 +886,502 @@ uint8_t *phy_request_rx_buf(struct phy_handle *phy, unsigned int timeout_ms)
                 fprintf(stderr, "[PHY] %s: Condition wait failed: %s\n", __FUNCTION__,
                             strerror(status));
             }
-            failed = true;
             break;
         }
     }
+    //Take the frame, which makes room for the next one
+    if (phy->rx->buf_filled){
+        buf = phy->rx->data_buf;
+        phy->rx->data_buf = NULL;
+        phy->rx->buf_filled = false;
+        pthread_cond_signal(&(phy->rx->buf_taken_cond));
+    }
     //Unlock mutex
     status = pthread_mutex_unlock(&(phy->rx->buf_status_lock));
     if (status != 0){
         fprintf(stderr, "[PHY] %s: Mutex unlock failed: %s\n", __FUNCTION__,
                 strerror(status));
-        failed = true;
     }
 
-    if (failed){
-        return NULL;
+    return buf;
+}
+
+/**
+ * Initialize an empty block queue
+ *
+ * @return      0 on success, -1 on failure
+ */
+static int queue_init(struct block_queue *q)
+{
+    int status;
+
+    q->head = 0;
+    q->count = 0;
+    q->closed = false;
+
+    status = pthread_mutex_init(&q->lock, NULL);
+    if (status != 0){
+        fprintf(stderr, "[PHY] %s: Error initializing pthread_mutex\n", __FUNCTION__);
+        return -1;
     }
-    return phy->rx->data_buf;
+    status = pthread_cond_init(&q->not_empty, NULL);
+    if (status != 0){
+        fprintf(stderr, "[PHY] %s: Error initializing pthread_cond\n", __FUNCTION__);
+        pthread_mutex_destroy(&q->lock);
+        return -1;
+    }
+    return 0;
 }
 
-void phy_release_rx_buf(struct phy_handle *phy)
+static void queue_deinit(struct block_queue *q)
 {
-    phy->rx->buf_filled = false;
+    pthread_cond_destroy(&q->not_empty);
+    pthread_mutex_destroy(&q->lock);
+}
+
+/**
+ * Append a block to a queue. This never waits, as a queue can hold every block.
+ */
+static void queue_push(struct block_queue *q, struct rx_block *block)
+{
+    pthread_mutex_lock(&q->lock);
+    assert(q->count < RX_PIPE_NUM_BLOCKS);
+    q->blocks[(q->head + q->count) % RX_PIPE_NUM_BLOCKS] = block;
+    q->count++;
+    pthread_cond_signal(&q->not_empty);
+    pthread_mutex_unlock(&q->lock);
+}
+
+/**
+ * Wait for the next block in a queue
+ *
+ * @return      the block, or NULL once the queue is closed and empty
+ */
+static struct rx_block *queue_pop(struct block_queue *q)
+{
+    struct rx_block *block = NULL;
+
+    pthread_mutex_lock(&q->lock);
+    while (q->count == 0 && !q->closed){
+        pthread_cond_wait(&q->not_empty, &q->lock);
+    }
+    if (q->count > 0){
+        block = q->blocks[q->head];
+        q->head = (q->head + 1) % RX_PIPE_NUM_BLOCKS;
+        q->count--;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return block;
+}
+
+/**
+ * Close a queue, so its reader finishes once the queue is drained
+ */
+static void queue_close(struct block_queue *q)
+{
+    pthread_mutex_lock(&q->lock);
+    q->closed = true;
+    pthread_cond_signal(&q->not_empty);
+    pthread_mutex_unlock(&q->lock);
+}
+
+/**
+ * CPU time used by the calling thread, in seconds, or -1 if it isn't available
+ */
+static double thread_cpu_secs(void)
+{
+    #ifdef CLOCK_THREAD_CPUTIME_ID
+        struct timespec ts;
+
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0){
+            return ts.tv_sec + ts.tv_nsec / 1e9;
+        }
+    #endif
+    return -1;
+}
+
+/**
+ * Thread function for a pipeline stage. Passes each block from the stage's input queue
+ * through its process function to its output queue, until the input queue is closed.
+ */
+static void *rx_stage_run(void *arg)
+{
+    struct rx_stage *stage = (struct rx_stage *) arg;
+    struct rx_block *block;
+
+    while ((block = queue_pop(stage->in)) != NULL){
+        //After a failure, blocks are only recycled
+        if (!stage->phy->rx->failed){
+            stage->process(stage->phy, block);
+        }
+        queue_push(stage->out, block);
+    }
+    stage->cpu_secs = thread_cpu_secs();
+    queue_close(stage->out);
+    return NULL;
+}
+
+/**
+ * Pipeline stage: low pass filter the samples
+ */
+static void rx_filter_block(struct phy_handle *phy, struct rx_block *block)
+{
+    #ifndef BYPASS_RX_CHANNEL_FILTER
+        // Apply channel filter
+        fir_process(phy->rx->ch_filt, block->raw, block->samples, NUM_SAMPLES_RX);
+    #else
+        conv_samples_to_struct(block->raw, NUM_SAMPLES_RX, block->samples);
+    #endif
+}
+
+/**
+ * Pipeline stage: power normalize the samples, in place
+ */
+static void rx_pnorm_block(struct phy_handle *phy, struct rx_block *block)
+{
+    #ifndef BYPASS_RX_PNORM
+        pnorm(phy->rx->pnorm, NUM_SAMPLES_RX, block->samples, block->samples, NULL, NULL);
+    #else
+        (void) phy;
+        (void) block;
+    #endif
+}
+
+/**
+ * Pipeline stage: cross correlate the samples with the preamble waveform, recording
+ * the index of each match. The correlator runs over every sample, including those
+ * of frames being demodulated, and the demod stage skips matches within a frame.
+ */
+static void rx_correlate_block(struct phy_handle *phy, struct rx_block *block)
+{
+    uint64_t match;
+    size_t index = 0;
+
+    block->num_matches = 0;
+    while (index < NUM_SAMPLES_RX){
+        match = corr_process(phy->rx->corr, &block->samples[index],
+                             NUM_SAMPLES_RX - index, index);
+        if (match == CORRELATOR_NO_RESULT){
+            break;
+        }
+        DEBUG_MSG("[PHY] RX: Preamble matched @ index %"PRIu64"\n", match);
+        if (block->num_matches < RX_PIPE_MAX_MATCHES){
+            block->matches[block->num_matches++] = (unsigned int) match;
+        }else{
+            NOTE("[PHY] RX: Too many preamble matches in one block\n");
+        }
+        //The correlator resets after each match
+        index = (size_t) match + 1;
+    }
+}
+
+/**
+ * Hand the received frame's buffer to phy_request_rx_buf(), or drop the frame if the
+ * link layer hasn't taken the previous one yet. A dropped frame's buffer is kept for
+ * the next frame. With a sample source set by phy_set_rx_source(), there is no sample
+ * rate to keep up with, so this waits for the previous frame to be taken instead.
+ *
+ * @return      0 on success, -1 on failure
+ */
+static int rx_pass_frame(struct phy_handle *phy, struct rx_frame *frame)
+{
+    int status;
+
+    status = pthread_mutex_lock(&(phy->rx->buf_status_lock));
+    if (status != 0){
+        fprintf(stderr, "[PHY] %s: Error locking pthread_mutex\n", __FUNCTION__);
+        return -1;
+    }
+    //Is the link layer still to take the previous frame?
+    phy->rx->stats.frames++;
+    while (phy->rx->source != NULL && phy->rx->buf_filled && !phy->rx->stop){
+        pthread_cond_wait(&(phy->rx->buf_taken_cond), &(phy->rx->buf_status_lock));
+    }
+    if (phy->rx->buf_filled){
+        //Instead of disrupting the link layer, drop this frame
+        phy->rx->stats.frames_dropped++;
+        pthread_mutex_unlock(&(phy->rx->buf_status_lock));
+        NOTE("[PHY] RX: Frame dropped!\n");
+        return 0;
+    }
+    phy->rx->data_buf = frame->buf;
+    phy->rx->buf_filled = true;
+    frame->buf = NULL;
+    //Signal that the buffer is filled
+    status = pthread_cond_signal(&(phy->rx->buf_filled_cond));
+    if (status != 0){
+        fprintf(stderr, "[PHY] %s: Error signaling pthread_cond\n", __FUNCTION__);
+        pthread_mutex_unlock(&(phy->rx->buf_status_lock));
+        return -1;
+    }
+    status = pthread_mutex_unlock(&(phy->rx->buf_status_lock));
+    if (status != 0){
+        fprintf(stderr, "[PHY] %s: Error unlocking pthread_mutex\n", __FUNCTION__);
+        return -1;
+    }
+    DEBUG_MSG("[PHY] RX: Frame ready\n");
+    return 0;
+}
+
+/**
+ * Pipeline stage: demodulate frames starting at the preamble matches, unscramble them,
+ * and hand them to the link layer. A frame may continue into following blocks.
+ */
+static void rx_demod_block(struct phy_handle *phy, struct rx_block *block)
+{
+    struct rx_frame *frame = &phy->rx->frame;
+    unsigned int samples_index = 0;     //Current index of samples to demod from
+    unsigned int match = 0;             //Next preamble match to consider
+    unsigned int num_bytes_rx;
+    uint8_t frame_type;
+    bool new_frame;
+
+    while (samples_index < NUM_SAMPLES_RX){
+        if (!frame->active){
+            //Find the next preamble match, skipping any within the previous frame
+            while (match < block->num_matches && block->matches[match] < samples_index){
+                match++;
+            }
+            if (match == block->num_matches){
+                break;
+            }
+            samples_index = block->matches[match++];
+            //Demodulate into a buffer which can be handed to the link layer
+            if (frame->buf == NULL){
+                frame->buf = phy_alloc_frame_buf(phy);
+                if (frame->buf == NULL){
+                    NOTE("[PHY] RX: No free frame buffer. Frame dropped!\n");
+                    pthread_mutex_lock(&(phy->rx->buf_status_lock));
+                    phy->rx->stats.frames++;
+                    phy->rx->stats.frames_dropped++;
+                    pthread_mutex_unlock(&(phy->rx->buf_status_lock));
+                    continue;
+                }
+            }
+            frame->active = true;
+            frame->new_frame = true;
+            frame->length = 0;
+            frame->data_index = 0;
+            //First we only demod the first byte to determine frame type
+            frame->num_bytes_to_demod = 1;
+        }
+
+        //--Demod samples
+        DEBUG_MSG("[PHY] RX: State = DEMOD\n");
+        new_frame = frame->new_frame;
+        num_bytes_rx = fsk_demod(phy->fsk, &block->samples[samples_index],
+                                NUM_SAMPLES_RX - (int)samples_index, new_frame,
+                                frame->num_bytes_to_demod, &frame->buf[frame->data_index]);
+        frame->new_frame = false;
+        frame->data_index += num_bytes_rx;
+        if (num_bytes_rx < frame->num_bytes_to_demod){
+            //The rest of the frame is in the next block
+            frame->num_bytes_to_demod -= num_bytes_rx;
+            break;
+        }
+        //Account for extra sample which defines initial phase
+        if (new_frame){
+            samples_index++;
+        }
+        samples_index += num_bytes_rx*8*SAMP_PER_SYMB;
+
+        if (frame->length == 0){
+            //--Check the frame type byte
+            DEBUG_MSG("[PHY] RX: State = CHECK_FRAME_TYPE\n");
+            #ifndef BYPASS_PHY_SCRAMBLING
+                frame_type = frame->buf[0] ^ phy->scrambling_sequence[0];
+            #else
+                frame_type = frame->buf[0];
+            #endif
+            //Set frame length according to what type of frame it is
+            if (frame_type == ACK_FRAME_CODE){
+                DEBUG_MSG("[PHY] RX: Getting an ACK frame...\n");
+                frame->length = ACK_FRAME_LENGTH;
+            }else if(frame_type == DATA_FRAME_CODE){
+                DEBUG_MSG("[PHY] RX: Getting a data frame...\n");
+                frame->length = DATA_FRAME_LENGTH;
+            }else{
+                NOTE("[PHY] %s: rx'ed unknown frame type 0x%.2X\n",
+                        __FUNCTION__, frame_type);
+                frame->active = false;
+                continue;
+            }
+            //Demod the rest of the bytes
+            frame->num_bytes_to_demod = frame->length-1;
+            continue;
+        }
+
+        //--Remove any phy encoding on the received frame
+        DEBUG_MSG("[PHY] RX: State = DECODE\n");
+        #ifndef BYPASS_PHY_SCRAMBLING
+            //Unscramble the frame
+            unscramble_frame(frame->buf, frame->length, phy->scrambling_sequence);
+        #endif
+        //--Hand the frame to the link layer
+        DEBUG_MSG("[PHY] RX: State = PASS\n");
+        if (rx_pass_frame(phy, frame) != 0){
+            phy->rx->failed = true;
+            return;
+        }
+        frame->active = false;
+    }
+}
+
+void phy_set_rx_source(struct phy_handle *phy, phy_rx_source_fn source, void *arg)
+{
+    phy->rx->source = source;
+    phy->rx->source_arg = arg;
+}
+
+void phy_get_rx_stats(struct phy_handle *phy, struct phy_rx_stats *stats)
+{
+    pthread_mutex_lock(&(phy->rx->buf_status_lock));
+    *stats = phy->rx->stats;
+    pthread_mutex_unlock(&(phy->rx->buf_status_lock));
 }
 
 /**
- * Thread function which listens for and receives frames. The steps are:
- * 1) Receive samples with libbladeRF
- * 2) Low pass filter the samples
- * 3) Power normalize the samples
- * 4) Correlate the samples with the preamble waveform
- * 5) If a match is found, demodulate the samples into data bytes
- * 6) Unscramble the data
- * 7) Copy the frame to a buffer which can be acquired with phy_request_rx_buf(), or
- *    drop the frame if the buffer is still in use
+ * Thread function which listens for and receives frames. It receives samples with
+ * libbladeRF, or from the sample source set with phy_set_rx_source(), and passes them
+ * through a pipeline of stages, each on its own thread:
+ * 1) Low pass filter the samples
+ * 2) Power normalize the samples
+ * 3) Correlate the samples with the preamble waveform
+ * 4) From each match, demodulate the samples into a frame buffer, unscramble the
+ *    data, and hand the buffer to phy_request_rx_buf(), or drop the frame if the
+ *    link layer hasn't taken the previous one yet
+ *
+ * Blocks of samples are recycled from the last stage back to the receiver. If the
+ * pipeline falls behind, the receiver waits for a free block, and libbladeRF reports
+ * an overrun.
  *
  * @param    arg        pointer to phy_handle struct
  */
 void *phy_receive_frames(void *arg)
 {
+    typedef void (*process_fn)(struct phy_handle *, struct rx_block *);
+    static const process_fn process[PHY_RX_NUM_STAGES] = {
+        rx_filter_block, rx_pnorm_block, rx_correlate_block, rx_demod_block
+    };
     struct phy_handle *phy = (struct phy_handle *) arg;
+    struct rx *rx = phy->rx;
     int status;
-    unsigned int num_bytes_rx;
-    unsigned int data_index;        //Current index of rx_buffer to receive new bytes on
-                                    //doubles as the current received frame length
-    uint64_t samples_index=0;            //Current index of samples buffer to correlate/demod
-                                    //samples from
-    bool preamble_detected;
-    bool new_frame = false;
-    int frame_length = 0;            //link layer frame length
-    uint8_t *rx_buffer = NULL;    //local rx data buffer
-    uint8_t frame_type;
     struct bladerf_metadata metadata;            //bladerf metadata for sync_rx()
-    unsigned int num_bytes_to_demod = 0;
     uint64_t timestamp = UINT64_MAX;
+    struct rx_block *block;
+    int num_queues = 0, num_threads = 0;
+    int i;
+    struct timespec start, end;
 
-    enum states {RECEIVE, PREAMBLE_CORRELATE, DEMOD,
-                    CHECK_FRAME_TYPE, DECODE, COPY};
-    enum states state;                //current state variable
+    rx->failed = false;
+    rx->frame.active = false;
+    pthread_mutex_lock(&(rx->buf_status_lock));
+    memset(&rx->stats, 0, sizeof(rx->stats));
+    pthread_mutex_unlock(&(rx->buf_status_lock));
+    clock_gettime(CLOCK_REALTIME, &start);
 
-    /* corr_process() takes a size_t count.
-     * Ensure a cast from uint64_t to size_t is valid. */
-    assert(NUM_SAMPLES_RX < SIZE_MAX);
+    //Set up the queues, with every block free
+    if (queue_init(&rx->free_blocks) != 0){
+        return NULL;
+    }
+    for (num_queues = 0; num_queues < PHY_RX_NUM_STAGES; num_queues++){
+        if (queue_init(&rx->queues[num_queues]) != 0){
+            goto out;
+        }
+    }
+    for (i = 0; i < RX_PIPE_NUM_BLOCKS; i++){
+        queue_push(&rx->free_blocks, &rx->blocks[i]);
+    }
 
-    //Allocate memory for buffer
-    rx_buffer = malloc(MAX_LINK_FRAME_SIZE);
-    if (rx_buffer == NULL){
-        perror("[PHY] malloc");
-        goto out;
+    //Start the stages
+    for (num_threads = 0; num_threads < PHY_RX_NUM_STAGES; num_threads++){
+        struct rx_stage *stage = &rx->stages[num_threads];
+
+        stage->phy = phy;
+        stage->in = &rx->queues[num_threads];
+        stage->out = (num_threads + 1 < PHY_RX_NUM_STAGES) ?
+                        &rx->queues[num_threads + 1] : &rx->free_blocks;
+        stage->process = process[num_threads];
+
+        status = pthread_create(&stage->thread, NULL, rx_stage_run, stage);
+        if (status != 0){
+            fprintf(stderr, "[PHY] %s: Error creating rx stage thread: %s\n",
+                    __FUNCTION__, strerror(status));
+            goto out;
+        }
     }
 
     //Set bladeRF metadata
     memset(&metadata, 0, sizeof(metadata));
     metadata.flags = BLADERF_META_FLAG_RX_NOW;
 
-    preamble_detected = false;
-    data_index = 0;
-    state = RECEIVE;
     //Loop until stop signal detected
-    while(!phy->rx->stop){
-        switch(state){
-            case RECEIVE:
-                //--Receive samples, filter, and power normalize
-                //DEBUG_MSG("[PHY] RX: State = RECEIVE\n");
-                samples_index = 0;
-                status = bladerf_sync_rx(phy->dev, phy->rx->in_samples, NUM_SAMPLES_RX,
-                                            &metadata, 5000);
-                if (status != 0){
-                    fprintf(stderr, "[PHY] %s: Couldn't receive samples from bladeRF\n",
-                            __FUNCTION__);
-                    goto out;
-                }
-                //Check metadata
-                if (metadata.status & BLADERF_META_STATUS_OVERRUN){
-                    NOTE("[PHY] %s: Got an overrun. Expected count = %u;"
-                                " actual count = %u. Skipping these samples.\n",
-                                __FUNCTION__, NUM_SAMPLES_RX, metadata.actual_count);
-                    break;
-                }
-                if (timestamp != UINT64_MAX && metadata.timestamp != timestamp+NUM_SAMPLES_RX){
-                    NOTE("[PHY] %s: Unexpected timestamp. Expected %lu, got %lu.\n",
-                            __FUNCTION__, timestamp+NUM_SAMPLES_RX, metadata.timestamp);
-                }
-                timestamp = metadata.timestamp;
-
-                #ifndef BYPASS_RX_CHANNEL_FILTER
-                    // Apply channel filter
-                    fir_process(phy->rx->ch_filt, phy->rx->in_samples,
-                                phy->rx->filt_samples, NUM_SAMPLES_RX);
-                #else
-                    conv_samples_to_struct(phy->rx->in_samples, NUM_SAMPLES_RX,
-                                            phy->rx->filt_samples);
-                #endif
-                //Power normalize
-                #ifndef BYPASS_RX_PNORM
-                    pnorm(phy->rx->pnorm, NUM_SAMPLES_RX, phy->rx->filt_samples,
-                            phy->rx->pnorm_samples, NULL, NULL);
-                #else
-                    memcpy(phy->rx->pnorm_samples, phy->rx->filt_samples,
-                            NUM_SAMPLES_RX * sizeof(struct complex_sample));
-                #endif
-                if (preamble_detected){
-                    state = DEMOD;
-                }else{
-                    state = PREAMBLE_CORRELATE;
-                }
-                break;
-            case PREAMBLE_CORRELATE:
-                //--Cross correlate received samples with preamble to find start
-                //--of the data frame
-                //DEBUG_MSG("[PHY] RX: State = PREAMBLE_CORRELATE\n");
-                samples_index = corr_process(phy->rx->corr,
-                                            &(phy->rx->pnorm_samples[samples_index]),
-                                            (size_t) (NUM_SAMPLES_RX-samples_index), 0);
-                if (samples_index != CORRELATOR_NO_RESULT){
-                    DEBUG_MSG("[PHY] RX: Preamble matched @ index %lu\n", samples_index);
-                    preamble_detected = true;
-                    new_frame = true;
-                    //First we only demod the first byte to determine frame type
-                    num_bytes_to_demod = 1;
-                    data_index = 0;
-                    state = DEMOD;
-                }else{
-                    //No preamble match. Receive more samples
-                    state = RECEIVE;
-                }
-                break;
-            case DEMOD:
-                //--Demod samples
-                DEBUG_MSG("[PHY] RX: State = DEMOD\n");
-                num_bytes_rx = fsk_demod(phy->fsk, &(phy->rx->pnorm_samples[samples_index]),
-                                        NUM_SAMPLES_RX-(int)samples_index, new_frame,
-                                        num_bytes_to_demod, &rx_buffer[data_index]);
-                if (num_bytes_rx < num_bytes_to_demod){
-                    //Receive more samples
-                    num_bytes_to_demod -= num_bytes_rx;
-                    state = RECEIVE;
-                }else{
-                    if (new_frame){
-                        state = CHECK_FRAME_TYPE;
-                        //Account for extra sample which defines initial phase
-                        samples_index++;
-                    }else{
-                        //We demoded all samples in the frame
-                        state = DECODE;
-                    }
-                }
-                data_index += num_bytes_rx;
-                samples_index += num_bytes_rx*8*SAMP_PER_SYMB;
-                new_frame = false;
-                break;
-            case CHECK_FRAME_TYPE:
-                //--Check the frame type byte
-                DEBUG_MSG("[PHY] RX: State = CHECK_FRAME_TYPE\n");
-                #ifndef BYPASS_PHY_SCRAMBLING
-                    frame_type = rx_buffer[0] ^ phy->scrambling_sequence[0];
-                #else
-                    frame_type = rx_buffer[0];
-                #endif
-                //Set frame length according to what type of frame it is
-                if (frame_type == ACK_FRAME_CODE){
-                    DEBUG_MSG("[PHY] RX: Getting an ACK frame...\n");
-                    frame_length = ACK_FRAME_LENGTH;
-                }else if(frame_type == DATA_FRAME_CODE){
-                    DEBUG_MSG("[PHY] RX: Getting a data frame...\n");
-                    frame_length = DATA_FRAME_LENGTH;
-                }else{
-                    NOTE("[PHY] %s: rx'ed unknown frame type 0x%.2X\n",
-                            __FUNCTION__, frame_type);
-                    data_index = 0;
-                    preamble_detected = false;
-                    state = RECEIVE;
-                    break;
-                }
-                //Demod the rest of the bytes
-                num_bytes_to_demod = frame_length-1;
-                state = DEMOD;
-                break;
-            case DECODE:
-                //--Remove any phy encoding on the received frame
-                DEBUG_MSG("[PHY] RX: State = DECODE\n");
-                #ifndef BYPASS_PHY_SCRAMBLING
-                    //Unscramble the frame
-                    unscramble_frame(rx_buffer, frame_length, phy->scrambling_sequence);
-                #endif
-                state = COPY;
-                break;
-            case COPY:
-                //--Copy frame into buffer which can be accessed by the link layer
-                DEBUG_MSG("[PHY] RX: State = COPY\n");
-                //Is the link layer still working with the previous frame?
-                if (phy->rx->buf_filled){
-                    //Instead of disrupting the link layer, drop this frame
-                    NOTE("[PHY] RX: Frame dropped!\n");
-                }else{
-                    //Copy frame into rx_data_buf
-                    memcpy(phy->rx->data_buf, rx_buffer,
-                            frame_length);
-                    phy->rx->buf_filled = true;
-                    //Signal that the buffer is filled
-                    status = pthread_mutex_lock(&(phy->rx->buf_status_lock));
-                    if (status != 0){
-                        fprintf(stderr, "[PHY] %s: Error locking pthread_mutex\n",
-                                __FUNCTION__);
-                        goto out;
-                    }
-                    status = pthread_cond_signal(&(phy->rx->buf_filled_cond));
-                    if (status != 0){
-                        fprintf(stderr, "[PHY] %s: Error signaling pthread_cond\n",
-                                __FUNCTION__);
-                        goto out;
-                    }
-                    status = pthread_mutex_unlock(&(phy->rx->buf_status_lock));
-                    if (status != 0){
-                        fprintf(stderr, "[PHY] %s: Error unlocking pthread_mutex\n",
-                                __FUNCTION__);
-                        goto out;
-                    }
-                    DEBUG_MSG("[PHY] RX: Frame ready\n");
-                }
-                preamble_detected = false;
-
-                if (samples_index == NUM_SAMPLES_RX){
-                    state = RECEIVE;
-                }else{
-                    state = PREAMBLE_CORRELATE;
-                }
-                break;
-            default:
-                fprintf(stderr, "[PHY] %s: Invalid state\n", __FUNCTION__);
+    while(!rx->stop && !rx->failed){
+        block = queue_pop(&rx->free_blocks);
+        //--Receive samples
+        if (rx->source != NULL){
+            status = rx->source(rx->source_arg, block->raw, NUM_SAMPLES_RX, &metadata);
+            if (status > 0){
+                DEBUG_MSG("[PHY] RX: End of input\n");
+                queue_push(&rx->free_blocks, block);
                 goto out;
+            }
+        }else{
+            status = bladerf_sync_rx(phy->dev, block->raw, NUM_SAMPLES_RX,
+                                        &metadata, 5000);
+        }
+        if (status != 0){
+            fprintf(stderr, "[PHY] %s: Couldn't receive samples from bladeRF\n",
+                    __FUNCTION__);
+            queue_push(&rx->free_blocks, block);
+            goto out;
+        }
+        //Check metadata
+        if (metadata.status & BLADERF_META_STATUS_OVERRUN){
+            NOTE("[PHY] %s: Got an overrun. Expected count = %u;"
+                        " actual count = %u. Skipping these samples.\n",
+                        __FUNCTION__, NUM_SAMPLES_RX, metadata.actual_count);
+            queue_push(&rx->free_blocks, block);
+            continue;
         }
+        if (timestamp != UINT64_MAX && metadata.timestamp != timestamp+NUM_SAMPLES_RX){
+            NOTE("[PHY] %s: Unexpected timestamp. Expected %lu, got %lu.\n",
+                    __FUNCTION__, timestamp+NUM_SAMPLES_RX, metadata.timestamp);
+        }
+        timestamp = metadata.timestamp;
+
+        pthread_mutex_lock(&(rx->buf_status_lock));
+        rx->stats.blocks++;
+        pthread_mutex_unlock(&(rx->buf_status_lock));
+        queue_push(&rx->queues[0], block);
     }
+
     out:
-        free(rx_buffer);
+        //Drain and stop the pipeline
+        if (num_queues == PHY_RX_NUM_STAGES){
+            queue_close(&rx->queues[0]);
+        }
+        for (i = 0; i < num_threads; i++){
+            status = pthread_join(rx->stages[i].thread, NULL);
+            if (status != 0){
+                fprintf(stderr, "[PHY] %s: Error joining rx stage thread: %s\n",
+                        __FUNCTION__, strerror(status));
+            }
+        }
+        for (i = 0; i < num_queues; i++){
+            queue_deinit(&rx->queues[i]);
+        }
+        queue_deinit(&rx->free_blocks);
+        //Record the time taken, now that every stage has finished
+        clock_gettime(CLOCK_REALTIME, &end);
+        pthread_mutex_lock(&(rx->buf_status_lock));
+        rx->stats.rx_secs = (end.tv_sec - start.tv_sec) +
+                            (end.tv_nsec - start.tv_nsec) / 1e9;
+        rx->stats.receive_cpu_secs = thread_cpu_secs();
+        for (i = 0; i < PHY_RX_NUM_STAGES; i++){
+            rx->stats.stage_cpu_secs[i] = (i < num_threads) ? rx->stages[i].cpu_secs : -1;
+        }
+        pthread_mutex_unlock(&(rx->buf_status_lock));
         return NULL;
 }
 
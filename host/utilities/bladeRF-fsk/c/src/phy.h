@@ -64,9 +64,15 @@
 #define ACK_FRAME_CODE 0xFF
 //Frame lengths
 #define DATA_FRAME_LENGTH 1009
-#define ACK_FRAME_LENGTH 7
+#define ACK_FRAME_LENGTH 11
 //Maximum frame size in bytes
 #define MAX_LINK_FRAME_SIZE DATA_FRAME_LENGTH
+//Bytes reserved in front of each frame buffer, where the PHY places the training
+//sequence and preamble
+#define PHY_FRAME_HEADROOM (TRAINING_SEQ_LENGTH + PREAMBLE_LENGTH)
+//Number of frame buffers shared by the PHY and the link layer. This covers the
+//link layer's TX and RX windows (2 * LINK_MAX_WINDOW), plus frames in flight.
+#define PHY_FRAME_POOL_SIZE 72
 //Seed for pseudorandom number sequence generator
 #define PRNG_SEED 0x0109BBA53CFFD081
 //Length (in samples) of ramp up/ramp down
@@ -78,6 +84,80 @@
 
 struct phy_handle;
 
+//RX pipeline stages, which run after the stage receiving samples
+enum phy_rx_stage {
+    PHY_RX_STAGE_FILTER,        //Channel filter
+    PHY_RX_STAGE_PNORM,         //Power normalization
+    PHY_RX_STAGE_CORRELATE,     //Preamble correlation
+    PHY_RX_STAGE_DEMOD,         //Demodulation
+    PHY_RX_NUM_STAGES
+};
+
+//Receiver statistics, from the last time the receiver was started
+struct phy_rx_stats {
+    uint64_t blocks;                    //Blocks of NUM_SAMPLES_RX samples received
+    uint64_t frames;                    //Frames passed to phy_request_rx_buf()
+    uint64_t frames_dropped;            //Frames dropped because the previous one wasn't
+                                        //requested yet, or no frame buffer was free
+    double rx_secs;                     //Time the receiver ran for, until its pipeline
+                                        //drained. 0 until the receiver has finished.
+    //CPU time used by the receiving thread and by each stage's thread, in seconds, or
+    //-1 if it can't be measured on this platform. These are updated when the receiver
+    //stops.
+    double receive_cpu_secs;
+    double stage_cpu_secs[PHY_RX_NUM_STAGES];
+};
+
+/**
+ * Function which provides received samples in place of bladerf_sync_rx(), e.g. to
+ * replay a capture through the receiver without a device
+ *
+ * @param[in]   arg             argument given to phy_set_rx_source()
+ * @param[out]  samples         buffer for num_samples SC16 Q11 samples
+ * @param[in]   num_samples     number of samples to provide
+ * @param[out]  metadata        metadata for the samples, as from bladerf_sync_rx()
+ *
+ * @return      0 on success, 1 at the end of the input, or a negative BLADERF_ERR_*
+ *              value on failure. The receiver stops on anything but 0.
+ */
+typedef int (*phy_rx_source_fn)(void *arg, int16_t *samples, unsigned int num_samples,
+                                struct bladerf_metadata *metadata);
+
+/**
+ * Function which takes transmitted bursts in place of bladerf_sync_tx(), e.g. to
+ * combine several PHYs' transmissions into one stream
+ *
+ * @param[in]   arg             argument given to phy_set_tx_sink()
+ * @param[in]   samples         the burst's SC16 Q11 samples
+ * @param[in]   num_samples     number of samples in the burst
+ *
+ * @return      0 on success, or a negative BLADERF_ERR_* value on failure. The
+ *              transmitter stops on failure.
+ */
+typedef int (*phy_tx_sink_fn)(void *arg, const int16_t *samples,
+                              unsigned int num_samples);
+
+//----------------------Frame buffer functions-------------------------
+/**
+ * Take a frame buffer from the PHY's pool. Frame buffers are passed between the PHY
+ * and the link layer by reference, so frames are built, transmitted, received and
+ * parsed in place without being copied.
+ *
+ * @param[in]   phy     pointer to phy_handle struct
+ *
+ * @return      buffer of MAX_LINK_FRAME_SIZE bytes, preceded by PHY_FRAME_HEADROOM
+ *              bytes reserved for the PHY, or NULL if the pool is empty
+ */
+uint8_t *phy_alloc_frame_buf(struct phy_handle *phy);
+
+/**
+ * Return a frame buffer to the PHY's pool. Does nothing if buf is NULL.
+ *
+ * @param[in]   phy     pointer to phy_handle struct
+ * @param[in]   buf     buffer from phy_alloc_frame_buf() or phy_request_rx_buf()
+ */
+void phy_free_frame_buf(struct phy_handle *phy, uint8_t *buf);
+
 //----------------------Transmitter functions---------------------------
 /**
  * Start the PHY transmitter thread
@@ -98,16 +178,56 @@ int phy_start_transmitter(struct phy_handle *phy);
 int phy_stop_transmitter(struct phy_handle *phy);
 
 /**
- * Fill the tx buffer so its data will be transmitted using phy_transmit_frames()
+ * Pass a frame to phy_transmit_frames() to be transmitted. The frame is modulated
+ * straight from data_buf, with the training sequence and preamble written into its
+ * headroom, so this returns once the frame has been modulated. The caller keeps the
+ * buffer, and may send it again.
  *
  * @param[in]   phy         pointer to phy handle structure
- * @param[in]   data_buf    bytes to transmit
+ * @param[in]   data_buf    frame buffer from phy_alloc_frame_buf() holding the bytes
+ *                          to transmit
  * @param[in]   length      length of data buf
  *
  * @return      0 on success, -1 on failure
  */
 int phy_fill_tx_buf(struct phy_handle *phy, uint8_t *data_buf, unsigned int length);
 
+/**
+ * Build the samples of the burst phy_transmit_frames() transmits for a frame: the ramp
+ * up, training sequence, preamble, frame, ramp down, and channel filter tail. This can
+ * be used to synthesize received signals. It must not be called while the transmitter
+ * is running.
+ *
+ * @param[in]   phy         pointer to phy handle structure
+ * @param[in]   data_buf    frame buffer from phy_alloc_frame_buf() holding the bytes
+ *                          to transmit
+ * @param[in]   length      length of data buf
+ * @param[out]  samples     buffer for phy_max_tx_samples() SC16 Q11 samples
+ *
+ * @return      number of samples in the burst, or -1 on failure
+ */
+int phy_modulate_frame(struct phy_handle *phy, uint8_t *data_buf, unsigned int length,
+                        int16_t *samples);
+
+/**
+ * Get the most samples phy_modulate_frame() produces for a frame
+ *
+ * @param[in]   phy         pointer to phy handle structure
+ *
+ * @return      maximum number of samples in a burst
+ */
+unsigned int phy_max_tx_samples(struct phy_handle *phy);
+
+/**
+ * Pass transmitted bursts to a function rather than to bladerf_sync_tx(). Call this
+ * before phy_start_transmitter().
+ *
+ * @param[in]   phy     pointer to phy_handle struct
+ * @param[in]   fn      function taking bursts, or NULL to transmit with the device
+ * @param[in]   arg     argument passed to fn
+ */
+void phy_set_tx_sink(struct phy_handle *phy, phy_tx_sink_fn fn, void *arg);
+
 //------------------------Receiver functions---------------------------
 /**
  * Start the PHY receiver  thread
@@ -128,30 +248,49 @@ int phy_start_receiver(struct phy_handle *phy);
 int phy_stop_receiver(struct phy_handle *phy);
 
 /**
- * Request a received frame from phy_receive_frames(). Caller should call
- * phy_release_rx_buf() when done with the received frame so that 
- * phy_receive_frames() does not drop any frames.
+ * Receive samples from a function rather than with bladerf_sync_rx(). Call this
+ * before phy_start_receiver(). The receiver then runs as fast as it can, and rather
+ * than dropping a frame when the previous one hasn't been requested yet, it waits
+ * for it to be requested.
  *
- * @param[in]   phy             pointer to phy_handle struct
- * @param[in]   timeout_ms      amount of time to wait for a buffer from the PHY
- *
- * @return      pointer to filled buffer with received frame inside
+ * @param[in]   phy     pointer to phy_handle struct
+ * @param[in]   fn      function providing samples, or NULL to receive from the device
+ * @param[in]   arg     argument passed to fn
  */
-uint8_t *phy_request_rx_buf(struct phy_handle *phy, unsigned int timeout_ms);
+void phy_set_rx_source(struct phy_handle *phy, phy_rx_source_fn fn, void *arg);
 
 /**
- * Release RX buffer so that phy_receive_frames() can copy new frames into the buffer
+ * Get the receiver's statistics. The CPU times are only complete once the receiver
+ * has stopped.
  *
  * @param[in]   phy     pointer to phy_handle struct
+ * @param[out]  stats   receiver statistics
  */
-void phy_release_rx_buf(struct phy_handle *phy);
+void phy_get_rx_stats(struct phy_handle *phy, struct phy_rx_stats *stats);
+
+/**
+ * Request a received frame from phy_receive_frames(). The frame is received into a
+ * buffer from the pool, and ownership of that buffer passes to the caller, who must
+ * return it with phy_free_frame_buf() when done with the frame. Frames received
+ * before the previous one was requested are dropped, so request them promptly.
+ *
+ * @param[in]   phy             pointer to phy_handle struct
+ * @param[in]   timeout_ms      amount of time to wait for a buffer from the PHY
+ *
+ * @return      pointer to filled buffer with received frame inside, or NULL on
+ *              timeout or failure
+ */
+uint8_t *phy_request_rx_buf(struct phy_handle *phy, unsigned int timeout_ms);
 
 //-----------------------Init/Deinit functions-------------------------
 /**
  * Open/Initialize a phy_handle
  * 
- * @param[in]   dev     pointer to opened bladeRF device handle
- * @param[in]   params  pointer to radio parameters struct
+ * @param[in]   dev     pointer to opened bladeRF device handle, or NULL to run without
+ *                      a device. Without a device, the transmitter needs a sink set
+ *                      with phy_set_tx_sink(), and the receiver needs a source set
+ *                      with phy_set_rx_source().
+ * @param[in]   params  pointer to radio parameters struct. Unused if dev is NULL.
  *
  * @return      allocated phy_handle on success, NULL on failure
  */
@@ -0,0 +1,581 @@
+/**
+ * @file
+ * @brief   Offline PHY receiver benchmark
+ *
+ * Feeds SC16 Q11 samples through the PHY receive chain (phy_receive_frames()) as fast
+ * as it can process them, without a bladeRF device. The samples are either a recorded
+ * capture, or a synthetic signal of data frames modulated with phy_modulate_frame(),
+ * with configurable SNR and frequency offset. The throughput, the CPU time used by each
+ * stage of the receive pipeline, and for synthetic signals the bit and frame error
+ * rates, are reported.
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2016 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <getopt.h>
+#include <math.h>
+#include <libbladeRF.h>
+
+#include "phy.h"
+#include "crc32.h"
+#include "prng.h"
+#include "radio_config.h"
+
+#define DEFAULT_NUM_FRAMES 200
+#define DEFAULT_GAP 4096            //Samples between bursts
+#define DEFAULT_SEED 0x5EED5EED5EED5EEDULL
+#define SAMPLE_MAX 2047
+
+//Offset of the frame index in a synthetic data frame. This is where the link layer
+//puts its sequence number.
+#define FRAME_INDEX_OFFSET 1
+
+//Samples fed to the receiver
+struct source {
+    int16_t *samples;
+    uint64_t num_samples;
+    uint64_t pos;
+};
+
+//Error counts for synthetic signals
+struct results {
+    uint64_t frames_rx;             //Data frames received
+    uint64_t frames_matched;        //Frames matched to a transmitted frame by index
+    uint64_t frames_ok;             //Frames received without errors
+    uint64_t frames_duplicate;      //Frames received more than once, or false matches
+    uint64_t bit_errors;            //Bit errors in matched frames
+    uint64_t crc_ok;                //Frames with a valid CRC
+    uint64_t acks;                  //ACK frames (with a valid CRC)
+    uint64_t unknown;               //Frames of an unknown type
+};
+
+static struct option long_options[] = {
+    { "help",           no_argument,        NULL,   'h' },
+    { "input",          required_argument,  NULL,   'i' },
+    { "frames",         required_argument,  NULL,   'n' },
+    { "snr",            required_argument,  NULL,   's' },
+    { "freq-offset",    required_argument,  NULL,   'f' },
+    { "gap",            required_argument,  NULL,   'g' },
+    { "output",         required_argument,  NULL,   'o' },
+    { "seed",           required_argument,  NULL,   'S' },
+    { NULL,             0,                  NULL,   0   },
+};
+
+static void usage(const char *argv0)
+{
+    printf("Usage: %s [options]\n", argv0);
+    printf("Runs the PHY receiver over recorded or synthetic samples, without a "
+           "device.\n\n");
+    printf("Options:\n");
+    printf("  -i, --input <file>        Replay a capture of SC16 Q11 samples, recorded\n");
+    printf("                            at %d Hz, instead of synthesizing a signal.\n",
+            BLADERF_SAMPLE_RATE);
+    printf("  -n, --frames <n>          Number of data frames to synthesize. Default: %d\n",
+            DEFAULT_NUM_FRAMES);
+    printf("  -s, --snr <dB>            Add white Gaussian noise at this SNR.\n");
+    printf("                            Default: no noise\n");
+    printf("  -f, --freq-offset <Hz>    Frequency offset to apply. Default: 0\n");
+    printf("  -g, --gap <samples>       Samples between bursts. Default: %d\n",
+            DEFAULT_GAP);
+    printf("  -o, --output <file>       Save the synthetic signal as SC16 Q11 samples.\n");
+    printf("      --seed <n>            Seed for the frame contents and noise.\n");
+    printf("  -h, --help                Show this text.\n");
+}
+
+//Uniform random number in (0, 1), from a xorshift64* generator
+static double rand_uniform(uint64_t *state)
+{
+    uint64_t x = *state;
+
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return ((x * 0x2545F4914F6CDD1DULL >> 11) + 0.5) / 9007199254740992.0;
+}
+
+//Pair of independent zero mean, unit variance Gaussian random numbers (Box-Muller)
+static void rand_gauss(uint64_t *state, double *a, double *b)
+{
+    double r = sqrt(-2.0 * log(rand_uniform(state)));
+    double theta = 2.0 * M_PI * rand_uniform(state);
+
+    *a = r * cos(theta);
+    *b = r * sin(theta);
+}
+
+static int16_t clip_sample(double x)
+{
+    if (x > SAMPLE_MAX){
+        return SAMPLE_MAX;
+    }else if (x < -SAMPLE_MAX){
+        return -SAMPLE_MAX;
+    }
+    return (int16_t) lround(x);
+}
+
+/**
+ * Build the synthetic data frames. Each one holds its index where a link layer frame
+ * holds its sequence number, and has a valid CRC, so it is also a valid link frame.
+ *
+ * @return      num_frames frames of DATA_FRAME_LENGTH bytes, or NULL on failure
+ */
+static uint8_t *make_frames(unsigned int num_frames, uint64_t seed)
+{
+    uint8_t *frames, *frame, *content;
+    uint32_t crc_32;
+    unsigned int i;
+
+    frames = malloc((size_t) num_frames * DATA_FRAME_LENGTH);
+    if (frames == NULL){
+        perror("malloc");
+        return NULL;
+    }
+    for (i = 0; i < num_frames; i++){
+        frame = &frames[(size_t) i * DATA_FRAME_LENGTH];
+        content = prng_fill(&seed, DATA_FRAME_LENGTH);
+        if (content == NULL){
+            free(frames);
+            return NULL;
+        }
+        memcpy(frame, content, DATA_FRAME_LENGTH);
+        free(content);
+        frame[0] = DATA_FRAME_CODE;
+        frame[FRAME_INDEX_OFFSET] = i & 0xff;
+        frame[FRAME_INDEX_OFFSET + 1] = (i >> 8) & 0xff;
+        crc_32 = crc32(frame, DATA_FRAME_LENGTH - sizeof(crc_32));
+        memcpy(&frame[DATA_FRAME_LENGTH - sizeof(crc_32)], &crc_32, sizeof(crc_32));
+    }
+    return frames;
+}
+
+/**
+ * Synthesize the received signal: each frame's burst preceded by a gap, with a gap
+ * after the last burst, rotated by the frequency offset. Noise is added throughout,
+ * including the gaps, at the given SNR relative to the bursts' mean power.
+ *
+ * @return      0 on success, -1 on failure
+ */
+static int synthesize(struct phy_handle *phy, const uint8_t *frames,
+                        unsigned int num_frames, unsigned int gap, bool add_noise,
+                        double snr_db, double freq_offset, uint64_t seed,
+                        struct source *src)
+{
+    uint8_t *tx_buf;
+    int16_t *burst;
+    int num_burst_samples;
+    unsigned int i;
+    uint64_t pos = 0, n, signal_samples = 0;
+    double power = 0, sigma = 0, phase_step, x, y, c, s, nx, ny;
+    int status = -1;
+
+    tx_buf = phy_alloc_frame_buf(phy);
+    burst = malloc(phy_max_tx_samples(phy) * 2 * sizeof(int16_t));
+    if (tx_buf == NULL || burst == NULL){
+        fprintf(stderr, "Couldn't allocate TX buffers\n");
+        goto out;
+    }
+    //Every data frame's burst has the same length
+    src->num_samples = (uint64_t) num_frames * (gap + phy_max_tx_samples(phy)) + gap;
+    src->samples = calloc(src->num_samples, 2 * sizeof(int16_t));
+    if (src->samples == NULL){
+        perror("calloc");
+        goto out;
+    }
+
+    for (i = 0; i < num_frames; i++){
+        pos += gap;
+        memcpy(tx_buf, &frames[(size_t) i * DATA_FRAME_LENGTH], DATA_FRAME_LENGTH);
+        num_burst_samples = phy_modulate_frame(phy, tx_buf, DATA_FRAME_LENGTH, burst);
+        if (num_burst_samples < 0){
+            goto out;
+        }
+        memcpy(&src->samples[2*pos], burst, num_burst_samples * 2 * sizeof(int16_t));
+        for (n = 0; n < (uint64_t) num_burst_samples; n++){
+            power += (double) burst[2*n] * burst[2*n] +
+                     (double) burst[2*n+1] * burst[2*n+1];
+        }
+        signal_samples += num_burst_samples;
+        pos += num_burst_samples;
+    }
+    src->num_samples = pos + gap;
+
+    if (add_noise && signal_samples > 0){
+        //Noise power is split between I and Q
+        sigma = sqrt(power / signal_samples / pow(10.0, snr_db / 10.0) / 2.0);
+    }
+    phase_step = 2.0 * M_PI * freq_offset / BLADERF_SAMPLE_RATE;
+    if (sigma == 0 && phase_step == 0){
+        status = 0;
+        goto out;
+    }
+    for (n = 0; n < src->num_samples; n++){
+        x = src->samples[2*n];
+        y = src->samples[2*n+1];
+        if (phase_step != 0){
+            //fmod() keeps the phase accurate over long signals
+            c = cos(fmod(phase_step * n, 2.0 * M_PI));
+            s = sin(fmod(phase_step * n, 2.0 * M_PI));
+            nx = x * c - y * s;
+            y = x * s + y * c;
+            x = nx;
+        }
+        if (sigma != 0){
+            rand_gauss(&seed, &nx, &ny);
+            x += sigma * nx;
+            y += sigma * ny;
+        }
+        src->samples[2*n] = clip_sample(x);
+        src->samples[2*n+1] = clip_sample(y);
+    }
+    status = 0;
+
+    out:
+        phy_free_frame_buf(phy, tx_buf);
+        free(burst);
+        return status;
+}
+
+static int load_file(const char *path, struct source *src)
+{
+    FILE *f;
+    long size;
+
+    f = fopen(path, "rb");
+    if (f == NULL){
+        perror(path);
+        return -1;
+    }
+    if (fseek(f, 0, SEEK_END) != 0 || (size = ftell(f)) < 0 || fseek(f, 0, SEEK_SET)){
+        perror(path);
+        fclose(f);
+        return -1;
+    }
+    src->num_samples = size / (2 * sizeof(int16_t));
+    if (src->num_samples == 0){
+        fprintf(stderr, "%s holds no samples\n", path);
+        fclose(f);
+        return -1;
+    }
+    src->samples = malloc(src->num_samples * 2 * sizeof(int16_t));
+    if (src->samples == NULL){
+        perror("malloc");
+        fclose(f);
+        return -1;
+    }
+    if (fread(src->samples, 2 * sizeof(int16_t), src->num_samples, f) !=
+            src->num_samples){
+        fprintf(stderr, "Couldn't read %s\n", path);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+    return 0;
+}
+
+static int save_file(const char *path, const struct source *src)
+{
+    FILE *f;
+    int status = 0;
+
+    f = fopen(path, "wb");
+    if (f == NULL){
+        perror(path);
+        return -1;
+    }
+    if (fwrite(src->samples, 2 * sizeof(int16_t), src->num_samples, f) !=
+            src->num_samples){
+        fprintf(stderr, "Couldn't write %s\n", path);
+        status = -1;
+    }
+    if (fclose(f) != 0){
+        status = -1;
+    }
+    return status;
+}
+
+/**
+ * Sample source for the PHY receiver. The last block is padded with zeros.
+ */
+static int source_read(void *arg, int16_t *samples, unsigned int num_samples,
+                        struct bladerf_metadata *metadata)
+{
+    struct source *src = (struct source *) arg;
+    uint64_t n;
+
+    if (src->pos >= src->num_samples){
+        return 1;
+    }
+
+    n = src->num_samples - src->pos;
+    if (n > num_samples){
+        n = num_samples;
+    }
+    memcpy(samples, &src->samples[2*src->pos], n * 2 * sizeof(int16_t));
+    memset(&samples[2*n], 0, (num_samples - n) * 2 * sizeof(int16_t));
+
+    memset(metadata, 0, sizeof(*metadata));
+    metadata->timestamp = src->pos;
+    metadata->actual_count = num_samples;
+    src->pos += num_samples;
+    return 0;
+}
+
+static unsigned int count_bit_errors(const uint8_t *a, const uint8_t *b, size_t len)
+{
+    unsigned int errors = 0;
+    uint8_t diff;
+    size_t i;
+
+    for (i = 0; i < len; i++){
+        for (diff = a[i] ^ b[i]; diff != 0; diff &= diff - 1){
+            errors++;
+        }
+    }
+    return errors;
+}
+
+/**
+ * Check a received frame. Synthetic data frames are matched to the transmitted frame
+ * by the index they carry, and compared with it.
+ */
+static void check_frame(const uint8_t *buf, const uint8_t *frames, unsigned int num_frames,
+                        bool *received, struct results *results)
+{
+    unsigned int index, length;
+    uint32_t crc_32, crc_rx;
+    const uint8_t *expected;
+
+    if (buf[0] == DATA_FRAME_CODE){
+        length = DATA_FRAME_LENGTH;
+        results->frames_rx++;
+    }else if (buf[0] == ACK_FRAME_CODE){
+        length = ACK_FRAME_LENGTH;
+    }else{
+        results->unknown++;
+        return;
+    }
+    crc_32 = crc32((void *) buf, length - sizeof(crc_32));
+    memcpy(&crc_rx, &buf[length - sizeof(crc_rx)], sizeof(crc_rx));
+    if (crc_32 == crc_rx){
+        if (buf[0] == ACK_FRAME_CODE){
+            results->acks++;
+        }else{
+            results->crc_ok++;
+        }
+    }
+
+    if (frames == NULL || buf[0] != DATA_FRAME_CODE){
+        return;
+    }
+    index = buf[FRAME_INDEX_OFFSET] | (buf[FRAME_INDEX_OFFSET + 1] << 8);
+    if (index >= num_frames || received[index]){
+        results->frames_duplicate++;
+        return;
+    }
+    received[index] = true;
+    expected = &frames[(size_t) index * DATA_FRAME_LENGTH];
+    results->frames_matched++;
+    length = count_bit_errors(buf, expected, DATA_FRAME_LENGTH);
+    results->bit_errors += length;
+    if (length == 0){
+        results->frames_ok++;
+    }
+}
+
+static void print_cpu(const char *name, double cpu_secs, double rx_secs)
+{
+    if (cpu_secs < 0){
+        printf("    %-12s n/a\n", name);
+    }else{
+        printf("    %-12s %8.3f s  (%5.1f%% of one core)\n", name, cpu_secs,
+                rx_secs > 0 ? 100.0 * cpu_secs / rx_secs : 0.0);
+    }
+}
+
+static void print_report(const struct phy_rx_stats *stats, const struct source *src,
+                            bool synthetic, unsigned int num_frames,
+                            const struct results *results)
+{
+    static const char *stage_names[PHY_RX_NUM_STAGES] = {
+        "filter", "pnorm", "correlate", "demod"
+    };
+    double rate = stats->rx_secs > 0 ? src->num_samples / stats->rx_secs : 0;
+    uint64_t bits = results->frames_matched * DATA_FRAME_LENGTH * 8;
+    int i;
+
+    printf("Samples:        %"PRIu64" (%.3f s of signal)\n", src->num_samples,
+            (double) src->num_samples / BLADERF_SAMPLE_RATE);
+    printf("Time:           %.3f s\n", stats->rx_secs);
+    printf("Throughput:     %.2f Msps (%.1fx real time), %.1f frames/s\n",
+            rate / 1e6, rate / BLADERF_SAMPLE_RATE,
+            stats->rx_secs > 0 ? stats->frames / stats->rx_secs : 0.0);
+    printf("Frames:         %"PRIu64" received, %"PRIu64" dropped\n",
+            stats->frames, stats->frames_dropped);
+    printf("CPU time:\n");
+    print_cpu("receive", stats->receive_cpu_secs, stats->rx_secs);
+    for (i = 0; i < PHY_RX_NUM_STAGES; i++){
+        print_cpu(stage_names[i], stats->stage_cpu_secs[i], stats->rx_secs);
+    }
+
+    printf("Data frames:    %"PRIu64" received, %"PRIu64" with a valid CRC\n",
+            results->frames_rx, results->crc_ok);
+    if (!synthetic){
+        printf("ACK frames:     %"PRIu64" with a valid CRC\n", results->acks);
+        printf("Unknown frames: %"PRIu64"\n", results->unknown);
+        return;
+    }
+    printf("Matched:        %"PRIu64" of %u sent, %"PRIu64" error-free,"
+            " %"PRIu64" duplicate/unmatched\n", results->frames_matched, num_frames,
+            results->frames_ok, results->frames_duplicate);
+    printf("BER:            %.3e (%"PRIu64" bit errors in matched frames)\n",
+            bits > 0 ? (double) results->bit_errors / bits : 0.0, results->bit_errors);
+    printf("FER:            %.3e\n",
+            num_frames > 0 ? 1.0 - (double) results->frames_ok / num_frames : 0.0);
+}
+
+int main(int argc, char *argv[])
+{
+    struct phy_handle *phy = NULL;
+    struct source src;
+    struct results results;
+    struct phy_rx_stats stats;
+    const char *input = NULL, *output = NULL;
+    unsigned int num_frames = DEFAULT_NUM_FRAMES, gap = DEFAULT_GAP;
+    double snr_db = 0, freq_offset = 0;
+    bool add_noise = false, done = false;
+    uint64_t seed = DEFAULT_SEED;
+    uint8_t *frames = NULL, *buf;
+    bool *received = NULL;
+    char *end;
+    int c, status = EXIT_FAILURE;
+
+    memset(&src, 0, sizeof(src));
+    memset(&results, 0, sizeof(results));
+
+    while ((c = getopt_long(argc, argv, "hi:n:s:f:g:o:", long_options, NULL)) != -1){
+        end = NULL;
+        switch (c){
+            case 'h':
+                usage(argv[0]);
+                return EXIT_SUCCESS;
+            case 'i':
+                input = optarg;
+                break;
+            case 'n':
+                num_frames = (unsigned int) strtoul(optarg, &end, 0);
+                if (num_frames > 0xffff + 1){
+                    fprintf(stderr, "At most %u frames can be identified\n",
+                            0xffff + 1);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 's':
+                snr_db = strtod(optarg, &end);
+                add_noise = true;
+                break;
+            case 'f':
+                freq_offset = strtod(optarg, &end);
+                break;
+            case 'g':
+                gap = (unsigned int) strtoul(optarg, &end, 0);
+                break;
+            case 'o':
+                output = optarg;
+                break;
+            case 'S':
+                seed = strtoull(optarg, &end, 0);
+                break;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+        if (end != NULL && (end == optarg || *end != '\0')){
+            fprintf(stderr, "Invalid value: %s\n", optarg);
+            return EXIT_FAILURE;
+        }
+    }
+
+    //No device: the receiver is fed from the source
+    phy = phy_init(NULL, NULL);
+    if (phy == NULL){
+        return EXIT_FAILURE;
+    }
+
+    if (input != NULL){
+        if (load_file(input, &src) != 0){
+            goto out;
+        }
+    }else{
+        frames = make_frames(num_frames, seed);
+        received = calloc(num_frames + 1, sizeof(bool));
+        if (frames == NULL || received == NULL){
+            goto out;
+        }
+        if (synthesize(phy, frames, num_frames, gap, add_noise, snr_db, freq_offset,
+                        seed, &src) != 0){
+            goto out;
+        }
+        if (output != NULL && save_file(output, &src) != 0){
+            goto out;
+        }
+    }
+
+    phy_set_rx_source(phy, source_read, &src);
+    if (phy_start_receiver(phy) != 0){
+        goto out;
+    }
+    //Take frames until the receiver has finished with the last block. rx_secs is only
+    //set once it has.
+    while (!done){
+        buf = phy_request_rx_buf(phy, 100);
+        if (buf == NULL){
+            phy_get_rx_stats(phy, &stats);
+            done = stats.rx_secs > 0;
+            continue;
+        }
+        check_frame(buf, frames, num_frames, received, &results);
+        phy_free_frame_buf(phy, buf);
+    }
+    if (phy_stop_receiver(phy) != 0){
+        goto out;
+    }
+    //Take the frame passed while finishing, if any
+    buf = phy_request_rx_buf(phy, 0);
+    if (buf != NULL){
+        check_frame(buf, frames, num_frames, received, &results);
+        phy_free_frame_buf(phy, buf);
+    }
+
+    phy_get_rx_stats(phy, &stats);
+    print_report(&stats, &src, input == NULL, num_frames, &results);
+    status = EXIT_SUCCESS;
+
+    out:
+        phy_close(phy);
+        free(src.samples);
+        free(frames);
+        free(received);
+        return status;
+}
@@ -31,6 +31,25 @@
 
 #include "pnorm.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define PNORM_HAVE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   include <arm_neon.h>
+#   define PNORM_HAVE_NEON 1
+#endif
+
+//Fractional bits of the fixed point gain applied in block mode. Q10 holds gains up
+//to 32 with 0.1% resolution.
+#define GAIN_FRAC_BITS 10
+#define GAIN_MAX_FIXED (INT16_MAX / (float)(1 << GAIN_FRAC_BITS))
+
+//Block mode skips the impulse blanking, which a clamped sample can't trigger
+#if 2 * CLAMP_VAL_ABS * CLAMP_VAL_ABS >= 10 * SAMP_MAX_ABS * SAMP_MAX_ABS
+#   error "Clamped samples may reach the impulse blanking threshold"
+#endif
+
 struct pnorm_state_t {
     float est ;            //Estimate of signal power (essentially a running average)
     bool hold ;            //Hold the current gain?
@@ -38,11 +57,15 @@ struct pnorm_state_t {
     float invalpha ;
     float min_gain ;
     float max_gain ;
+
+    unsigned int block_len ;    //Samples per gain update
+    float *weights ;       //Weight of each sample's power in a block's estimate
+    float *alpha_pow ;     //alpha^n, for n = 0 to block_len
 } ;
 
 struct pnorm_state_t *pnorm_init(float alpha, float min_gain, float max_gain) {
     struct pnorm_state_t *state ;
-    state = malloc(sizeof(state[0])) ;
+    state = calloc(1, sizeof(state[0])) ;
     if( state == NULL ) {
         perror("malloc") ;
         return NULL ;
@@ -56,6 +79,8 @@ struct pnorm_state_t *pnorm_init(float alpha, float min_gain, float max_gain) {
     state->min_gain = min_gain ;
     state->max_gain = max_gain ;
 
+    state->block_len = 1 ;
+
     return state ;
 }
 
@@ -65,6 +90,10 @@ void pnorm_reset(struct pnorm_state_t *state) {
 }
 
 void pnorm_deinit(struct pnorm_state_t *state) {
+    if( state != NULL ) {
+        free(state->weights) ;
+        free(state->alpha_pow) ;
+    }
     free(state) ;
     return ;
 }
@@ -74,6 +103,196 @@ void pnorm_hold(struct pnorm_state_t *state, bool val) {
     return ;
 }
 
+int pnorm_set_block_len(struct pnorm_state_t *state, unsigned int block_len) {
+    float *weights = NULL, *alpha_pow = NULL ;
+    unsigned int i ;
+
+    if( block_len < 1 || block_len > PNORM_MAX_BLOCK_LEN ) {
+        fprintf(stderr, "Invalid pnorm block length: %u\n", block_len) ;
+        return -1 ;
+    }
+
+    if( block_len > 1 ) {
+        weights = malloc(block_len * sizeof(weights[0])) ;
+        alpha_pow = malloc((block_len + 1) * sizeof(alpha_pow[0])) ;
+        if( weights == NULL || alpha_pow == NULL ) {
+            perror("malloc") ;
+            free(weights) ;
+            free(alpha_pow) ;
+            return -1 ;
+        }
+
+        /* Unrolling the IIR over n samples gives
+         *   est' = alpha^n * est + sum_k (1-alpha) * alpha^(n-1-k) * power[k]
+         * so a block of n samples uses the last n weights */
+        alpha_pow[0] = 1.0f ;
+        for( i = 1 ; i <= block_len ; i++ ) {
+            alpha_pow[i] = alpha_pow[i-1] * state->alpha ;
+        }
+        for( i = 0 ; i < block_len ; i++ ) {
+            weights[i] = state->invalpha * alpha_pow[block_len - 1 - i] /
+                            (SAMP_MAX_ABS*SAMP_MAX_ABS) ;
+        }
+    }
+
+    free(state->weights) ;
+    free(state->alpha_pow) ;
+    state->weights = weights ;
+    state->alpha_pow = alpha_pow ;
+    state->block_len = block_len ;
+
+    return 0 ;
+}
+
+/* Weighted sum of the power of n samples */
+static inline float block_power(const struct complex_sample *in, const float *w,
+                                unsigned int n) {
+    unsigned int i = 0 ;
+    float sum = 0.0f ;
+
+#if defined(PNORM_HAVE_SSE2)
+    __m128 acc = _mm_setzero_ps() ;
+    float tmp[4] ;
+
+    for( ; i + 4 <= n ; i += 4 ) {
+        /* i*i + q*q of 4 samples */
+        const __m128i x = _mm_loadu_si128((const __m128i *)&in[i]) ;
+        const __m128 p = _mm_cvtepi32_ps(_mm_madd_epi16(x, x)) ;
+        acc = _mm_add_ps(acc, _mm_mul_ps(p, _mm_loadu_ps(&w[i]))) ;
+    }
+
+    _mm_storeu_ps(tmp, acc) ;
+    sum = (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]) ;
+#elif defined(PNORM_HAVE_NEON)
+    float32x4_t acc = vdupq_n_f32(0.0f) ;
+
+    for( ; i + 4 <= n ; i += 4 ) {
+        const int16x4x2_t x = vld2_s16(&in[i].i) ;
+        int32x4_t p = vmull_s16(x.val[0], x.val[0]) ;
+        p = vmlal_s16(p, x.val[1], x.val[1]) ;
+        acc = vmlaq_f32(acc, vcvtq_f32_s32(p), vld1q_f32(&w[i])) ;
+    }
+
+    sum = vgetq_lane_f32(acc, 0) + vgetq_lane_f32(acc, 1) +
+          vgetq_lane_f32(acc, 2) + vgetq_lane_f32(acc, 3) ;
+#endif
+
+    for( ; i < n ; i++ ) {
+        sum += w[i] * (float)(in[i].i*in[i].i + in[i].q*in[i].q) ;
+    }
+
+    return sum ;
+}
+
+static inline int16_t apply_gain(int16_t x, int32_t gain) {
+    int32_t temp = (x * gain + (1 << (GAIN_FRAC_BITS - 1))) >> GAIN_FRAC_BITS ;
+
+    if (temp > CLAMP_VAL_ABS){
+        temp = CLAMP_VAL_ABS;
+    }else if (temp < -CLAMP_VAL_ABS){
+        temp = -CLAMP_VAL_ABS;
+    }
+
+    return (int16_t) temp ;
+}
+
+/* Scale n samples by a Q10 gain, saturating to +/- CLAMP_VAL_ABS */
+static inline void block_gain(const struct complex_sample *in, struct complex_sample *out,
+                                int16_t gain, unsigned int n) {
+    unsigned int i = 0 ;
+
+#if defined(PNORM_HAVE_SSE2)
+    const __m128i g = _mm_set1_epi16(gain) ;
+    const __m128i rnd = _mm_set1_epi32(1 << (GAIN_FRAC_BITS - 1)) ;
+    const __m128i hi_clamp = _mm_set1_epi16(CLAMP_VAL_ABS) ;
+    const __m128i lo_clamp = _mm_set1_epi16(-CLAMP_VAL_ABS) ;
+
+    for( ; i + 4 <= n ; i += 4 ) {
+        const __m128i x = _mm_loadu_si128((const __m128i *)&in[i]) ;
+        const __m128i lo = _mm_mullo_epi16(x, g) ;
+        const __m128i hi = _mm_mulhi_epi16(x, g) ;
+        __m128i p0 = _mm_unpacklo_epi16(lo, hi) ;
+        __m128i p1 = _mm_unpackhi_epi16(lo, hi) ;
+        __m128i y ;
+
+        p0 = _mm_srai_epi32(_mm_add_epi32(p0, rnd), GAIN_FRAC_BITS) ;
+        p1 = _mm_srai_epi32(_mm_add_epi32(p1, rnd), GAIN_FRAC_BITS) ;
+        y = _mm_packs_epi32(p0, p1) ;
+        y = _mm_min_epi16(_mm_max_epi16(y, lo_clamp), hi_clamp) ;
+
+        _mm_storeu_si128((__m128i *)&out[i], y) ;
+    }
+#elif defined(PNORM_HAVE_NEON)
+    const int16x4_t g = vdup_n_s16(gain) ;
+    const int16x8_t hi_clamp = vdupq_n_s16(CLAMP_VAL_ABS) ;
+    const int16x8_t lo_clamp = vdupq_n_s16(-CLAMP_VAL_ABS) ;
+
+    for( ; i + 4 <= n ; i += 4 ) {
+        const int16x8_t x = vld1q_s16(&in[i].i) ;
+        const int32x4_t p0 = vmull_s16(vget_low_s16(x), g) ;
+        const int32x4_t p1 = vmull_s16(vget_high_s16(x), g) ;
+        int16x8_t y = vcombine_s16(vqrshrn_n_s32(p0, GAIN_FRAC_BITS),
+                                   vqrshrn_n_s32(p1, GAIN_FRAC_BITS)) ;
+
+        y = vminq_s16(vmaxq_s16(y, lo_clamp), hi_clamp) ;
+        vst1q_s16(&out[i].i, y) ;
+    }
+#endif
+
+    for( ; i < n ; i++ ) {
+        out[i].i = apply_gain(in[i].i, gain) ;
+        out[i].q = apply_gain(in[i].q, gain) ;
+    }
+}
+
+static void pnorm_blocks(struct pnorm_state_t *state, uint16_t length,
+                         struct complex_sample *in, struct complex_sample *out,
+                         float *ests, float *gains) {
+    unsigned int start, n, trace = 0 ;
+    float gain ;
+    int16_t gain_fixed ;
+
+    for( start = 0 ; start < length ; start += n ) {
+        n = length - start ;
+        if( n > state->block_len ) {
+            n = state->block_len ;
+        }
+
+        /* Power IIR filter, evaluated at the end of the block */
+        if( state->hold == false ) {
+            state->est = state->alpha_pow[n] * state->est +
+                block_power(&in[start], &state->weights[state->block_len - n], n) ;
+        }
+
+        /* Ideal power is 1.0, so to get x to 1.0, we need to multiply by 1/est */
+        gain = 1.0f/sqrtf(state->est) ;
+
+        /* Clamp to [min gain, max gain], and what the fixed point gain can hold */
+        if( gain < state->min_gain ) {
+            gain = state->min_gain ;
+        }
+        if( gain > state->max_gain ) {
+            gain = state->max_gain ;
+        }
+        if( gain > GAIN_MAX_FIXED ) {
+            gain = GAIN_MAX_FIXED ;
+        }
+
+        /* Apply gain */
+        gain_fixed = (int16_t) lrintf(gain * (1 << GAIN_FRAC_BITS)) ;
+        block_gain(&in[start], &out[start], gain_fixed, n) ;
+
+        //Write to debug buffers
+        if (ests != NULL){
+            ests[trace] = state->est;
+        }
+        if (gains != NULL){
+            gains[trace] = gain;
+        }
+        trace++ ;
+    }
+}
+
 void pnorm(struct pnorm_state_t *state, uint16_t length, struct complex_sample *in,
             struct complex_sample *out, float *ests, float *gains) {
     int i ;
@@ -81,6 +300,11 @@ void pnorm(struct pnorm_state_t *state, uint16_t length, struct complex_sample *
     int32_t temp;
     float gain, est;
 
+    if( state->block_len > 1 ) {
+        pnorm_blocks(state, length, in, out, ests, gains) ;
+        return ;
+    }
+
     for( i = 0 ; i < length ; i++ ) {
         /* Power IIR filter */
         if( state->hold == false ) {
@@ -154,14 +378,19 @@ int main(int argc, char *argv[]) {
     FILE *fin, *fout ;
     struct pnorm_state_t *state ;
     float alpha, min_gain, max_gain ;
-    unsigned int count, i ;
+    unsigned int count, i, block_len = 1 ;
     int result;
 
     if( argc < 6 ) {
-        fprintf(stderr, "Usage: %s <alpha> <min gain> <max gain> <input csv> <output csv>\n", argv[0]) ;
+        fprintf(stderr, "Usage: %s <alpha> <min gain> <max gain> <input csv> <output csv> "
+                        "[block length]\n", argv[0]) ;
         return 1 ;
     }
 
+    if( argc > 6 ) {
+        block_len = (unsigned int) atoi(argv[6]) ;
+    }
+
     fin = fopen( argv[4], "r" ) ;
     if( fin == NULL ) {
         fprintf( stderr, "Couldn't open %s\n for input csv",argv[2] ) ;
@@ -178,9 +407,13 @@ int main(int argc, char *argv[]) {
     max_gain = (float) atof(argv[3]) ;
 
     state = pnorm_init(alpha, min_gain, max_gain) ;
+    if( state == NULL || pnorm_set_block_len(state, block_len) != 0 ) {
+        return 1 ;
+    }
+
     while (!feof(fin)) {
         count = 0 ;
-        while( count < sizeof(input) && !feof(fin) ) {
+        while( count < NUM_SAMPLES && !feof(fin) ) {
             result = fscanf( fin, "%hi,%hi\n", &input[count].i, &input[count].q ) ;
             if (result == EOF){
                 break;
@@ -189,8 +422,9 @@ int main(int argc, char *argv[]) {
         }
         pnorm( state, count, input, output, est, gain ) ;
         for( i = 0 ; i < count ; i++ ) {
+            //Estimates and gains are per block
             fprintf( fout, "%hi,%hi,%15.9f,%15.9f\n", output[i].i,
-                    output[i].q, est[i], gain[i] ) ;
+                    output[i].q, est[i / block_len], gain[i / block_len] ) ;
         }
     }
 
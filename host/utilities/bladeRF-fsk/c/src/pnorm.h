@@ -30,6 +30,9 @@
 #define SAMP_MAX_ABS 2048
 #define CLAMP_VAL_ABS 3072
 
+//Longest gain update interval supported by pnorm_set_block_len()
+#define PNORM_MAX_BLOCK_LEN 1024
+
 struct pnorm_state_t ;
 
 struct pnorm_state_t *pnorm_init(float alpha, float min_gain, float max_gain) ;
@@ -37,10 +40,27 @@ void pnorm_reset(struct pnorm_state_t *state) ;
 void pnorm_deinit(struct pnorm_state_t *state) ;
 void pnorm_hold(struct pnorm_state_t *state, bool val) ;
 
+/**
+ * Set how often the gain is updated, in samples. The default, 1, updates the power
+ * estimate and gain for every sample.
+ *
+ * For longer blocks, the power estimate is still the same per-sample IIR average, but it
+ * is evaluated once per block. Each block's gain comes from the estimate at its end, and
+ * is applied to the whole block in fixed point. Blocks restart at each call to pnorm().
+ *
+ * @param   state       power normalizer
+ * @param   block_len   samples per gain update, 1 to PNORM_MAX_BLOCK_LEN
+ *
+ * @return  0 on success, -1 on an invalid length or allocation failure
+ */
+int pnorm_set_block_len(struct pnorm_state_t *state, unsigned int block_len) ;
+
 /**
  * Power normalize a set of samples.
  * The 'ests' and 'gains' output buffers are for extra debug information. If they are NULL,
- * the function will not attempt to place values in them.
+ * the function will not attempt to place values in them. They receive one value per gain
+ * update: 'length' values with the default block length of 1, and otherwise one per block
+ * (ceil(length / block_len) values).
  */
 void pnorm(struct pnorm_state_t *state, uint16_t length, struct complex_sample *in,
             struct complex_sample *out, float *est, float *gain);
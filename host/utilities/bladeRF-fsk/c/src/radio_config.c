@@ -151,6 +151,13 @@ static int radio_init_sync(struct bladerf *dev)
 }
 
 int radio_init_and_configure(struct bladerf *dev, struct radio_params *params)
+{
+    return radio_init_and_configure_rate(dev, params, BLADERF_SAMPLE_RATE,
+                                         BLADERF_BANDWIDTH);
+}
+
+int radio_init_and_configure_rate(struct bladerf *dev, struct radio_params *params,
+                                  unsigned int samplerate, unsigned int bandwidth)
 {
     struct module_config config;
     int status;
@@ -162,8 +169,8 @@ int radio_init_and_configure(struct bladerf *dev, struct radio_params *params)
     //Configure TX parameters
     config.module       = BLADERF_MODULE_TX;
     config.frequency    = params->tx_freq;
-    config.bandwidth    = BLADERF_BANDWIDTH;
-    config.samplerate   = BLADERF_SAMPLE_RATE;
+    config.bandwidth    = bandwidth;
+    config.samplerate   = samplerate;
     config.vga1         = params->tx_vga1_gain;
     config.vga2         = params->tx_vga2_gain;
     status = radio_configure_module(dev, &config);
@@ -175,8 +182,8 @@ int radio_init_and_configure(struct bladerf *dev, struct radio_params *params)
     //Configure RX parameters
     config.module       = BLADERF_MODULE_RX;
     config.frequency    = params->rx_freq;
-    config.bandwidth    = BLADERF_BANDWIDTH;
-    config.samplerate   = BLADERF_SAMPLE_RATE;
+    config.bandwidth    = bandwidth;
+    config.samplerate   = samplerate;
     config.rx_lna       = params->rx_lna_gain;
     config.vga1         = params->rx_vga1_gain;
     config.vga2         = params->rx_vga2_gain;
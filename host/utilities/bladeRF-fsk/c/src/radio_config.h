@@ -45,6 +45,20 @@
  */
 int radio_init_and_configure(struct bladerf *dev, struct radio_params *params);
 
+/**
+ * Configure bladeRF device for a sample rate and bandwidth other than
+ * BLADERF_SAMPLE_RATE and BLADERF_BANDWIDTH, e.g. to carry several channels
+ *
+ * @param[in]   dev         pointer to bladeRF device handle
+ * @param[in]   params      pointer to radio_params struct specifying frequencies/gains
+ * @param[in]   samplerate  RX and TX sample rate, in samples per second
+ * @param[in]   bandwidth   RX and TX bandwidth, in Hz
+ *
+ * @return      0 on success, <0 on error
+ */
+int radio_init_and_configure_rate(struct bladerf *dev, struct radio_params *params,
+                                  unsigned int samplerate, unsigned int bandwidth);
+
 /**
  * Stop transmitting/receiving with bladerf. Device must be closed elsewhere.
  *
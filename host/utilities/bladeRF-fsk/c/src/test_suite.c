@@ -24,6 +24,8 @@
 #include <stdint.h>
 #include <libbladeRF.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 //Utility files
 #include "utils.h"
 #include "prng.h"
@@ -31,6 +33,7 @@
 #include "phy.h"
 #include "link.h"
 #include "fsk.h"
+#include "multichan.h"
 
 #ifdef DEBUG_MODE
     #define DEBUG_MSG(...) fprintf(stderr, __VA_ARGS__)
@@ -150,6 +153,112 @@ int link_test(char *dev_id1, char *dev_id2, unsigned int tx_freq1, unsigned int
         return status;
 }
 
+/**
+ * Test multi-channel links with data transfer on several channels at once between two
+ * devices
+ */
+int mchan_test(char *dev_id1, char *dev_id2, unsigned int tx_freq1, unsigned int tx_freq2)
+{
+    const unsigned int num_channels = 4;
+    //Channel 0 is on the LO, so it is not used
+    const unsigned int channels[] = {1, 2, 3};
+    const unsigned int num_used = sizeof(channels) / sizeof(channels[0]);
+    struct mchan *mchan1 = NULL, *mchan2 = NULL;
+    struct link_handle *tx_links[sizeof(channels) / sizeof(channels[0])];
+    struct link_handle *rx_links[sizeof(channels) / sizeof(channels[0])];
+    struct radio_params params;
+    struct bladerf *dev1 = NULL, *dev2 = NULL;
+    uint8_t tx_data[sizeof(channels) / sizeof(channels[0])][64];
+    uint8_t rx_data[64];
+    int bytes_received;
+    int status = 0;
+    unsigned int i;
+
+    printf("---------BEGINNING MULTI-CHANNEL TEST-----\n");
+    //Open bladeRFs
+    status = bladerf_open(&dev1, dev_id1);
+    if (status != 0){
+        fprintf(stderr, "Couldn't open bladeRF device #1: %s\n", bladerf_strerror(status));
+        goto out;
+    }
+    status = bladerf_open(&dev2, dev_id2);
+    if (status != 0){
+        fprintf(stderr, "Couldn't open bladeRF device #2: %s\n", bladerf_strerror(status));
+        goto out;
+    }
+
+    //Init the radios. Each channel transmits at 1/num_channels amplitude.
+    params.tx_freq         = tx_freq1;
+    params.tx_vga1_gain = -4;
+    params.tx_vga2_gain = 12;
+    params.rx_freq         = tx_freq2;
+    params.rx_lna_gain    = BLADERF_LNA_GAIN_MAX;
+    params.rx_vga1_gain = 23;
+    params.rx_vga2_gain = 0;
+    mchan1 = mchan_init(dev1, &params, num_channels);
+    if (mchan1 == NULL){
+        fprintf(stderr, "Couldn't initialize radio #1\n");
+        status = -1;
+        goto out;
+    }
+    params.tx_freq         = tx_freq2;
+    params.rx_freq         = tx_freq1;
+    mchan2 = mchan_init(dev2, &params, num_channels);
+    if (mchan2 == NULL){
+        fprintf(stderr, "Couldn't initialize radio #2\n");
+        status = -1;
+        goto out;
+    }
+
+    for (i = 0; i < num_used; i++){
+        tx_links[i] = mchan_open_link(mchan1, channels[i]);
+        rx_links[i] = mchan_open_link(mchan2, channels[i]);
+        if (tx_links[i] == NULL || rx_links[i] == NULL){
+            fprintf(stderr, "Couldn't open links on channel %u\n", channels[i]);
+            status = -1;
+            goto out;
+        }
+    }
+
+    //Send a different message on every channel before receiving any of them
+    for (i = 0; i < num_used; i++){
+        memset(tx_data[i], 0, sizeof(tx_data[i]));
+        snprintf((char *) tx_data[i], sizeof(tx_data[i]), "Message on channel %u (%u Hz)",
+                 channels[i], mchan_get_frequency(mchan1, BLADERF_TX, channels[i]));
+        status = link_send_data(tx_links[i], tx_data[i], sizeof(tx_data[i]));
+        if (status != 0){
+            fprintf(stderr, "Couldn't send data on channel %u\n", channels[i]);
+            goto out;
+        }
+    }
+
+    for (i = 0; i < num_used; i++){
+        bytes_received = link_receive_data(rx_links[i], sizeof(rx_data), 5, rx_data);
+        if (bytes_received != (int) sizeof(rx_data)){
+            fprintf(stderr, "Channel %u receive failed or timed out\n", channels[i]);
+            status = -1;
+            goto out;
+        }
+        if (memcmp(rx_data, tx_data[i], sizeof(rx_data)) != 0){
+            fprintf(stderr, "Channel %u received the wrong data\n", channels[i]);
+            status = -1;
+            goto out;
+        }
+        printf("Received on channel %u: '%s'\n", channels[i], rx_data);
+    }
+
+    out:
+        DEBUG_MSG("Closing radio 1\n");
+        mchan_close(mchan1);
+        DEBUG_MSG("Closing radio 2\n");
+        mchan_close(mchan2);
+        DEBUG_MSG("Closing bladeRFs\n");
+        bladerf_close(dev1);
+        bladerf_close(dev2);
+        printf("---------ENDING MULTI-CHANNEL TEST--------\n");
+        return status;
+}
+
 /**
  * Test phy layer code with data transfer between two devices
  */
@@ -159,6 +268,7 @@ int phy_test(char *dev_id1, char *dev_id2, unsigned int tx_freq1, unsigned int t
     struct phy_handle *phy2 = NULL;
     uint8_t tx_data[DATA_FRAME_LENGTH];
     uint8_t *tx_data3 = NULL;
+    uint8_t *tx_buf = NULL;             //phy1 frame buffer to transmit from
     uint8_t *rx_data;
     uint64_t prng_seed = 29398283513841632;
     int status = 0, ret;
@@ -201,6 +311,12 @@ int phy_test(char *dev_id1, char *dev_id2, unsigned int tx_freq1, unsigned int t
         status = -1;
         goto out;
     }
+    tx_buf = phy_alloc_frame_buf(phy1);
+    if (tx_buf == NULL){
+        fprintf(stderr, "Couldn't allocate phy1 frame buffer\n");
+        status = -1;
+        goto out;
+    }
 
     //Init phy2
     status = bladerf_open(&dev2, dev_id2);
@@ -236,7 +352,8 @@ int phy_test(char *dev_id1, char *dev_id2, unsigned int tx_freq1, unsigned int t
     }
     tx_on = true;
     DEBUG_MSG("Transmitting on phy1\n");
-    status = phy_fill_tx_buf(phy1, tx_data, sizeof(tx_data));
+    memcpy(tx_buf, tx_data, sizeof(tx_data));
+    status = phy_fill_tx_buf(phy1, tx_buf, sizeof(tx_data));
     if (status != 0){
         fprintf(stderr, "Couldn't fill tx buffer\n");
         goto out;
@@ -251,15 +368,16 @@ int phy_test(char *dev_id1, char *dev_id2, unsigned int tx_freq1, unsigned int t
     printf("Received from phy2: ");
     //print what is in the buffer
     print_chars(&rx_data[1], DATA_FRAME_LENGTH-1);
-    //Release the rx buffer
-    phy_release_rx_buf(phy2);
+    //Return the rx buffer
+    phy_free_frame_buf(phy2, rx_data);
 
 
     //Transmit a pseudo random sequence with phy1
     tx_data3 = prng_fill(&prng_seed, DATA_FRAME_LENGTH);
     tx_data3[0] = 0x00;        //Set frame type to data frame
     DEBUG_MSG("Transmitting pseudo random sequence on phy1\n");
-    status = phy_fill_tx_buf(phy1, tx_data3, DATA_FRAME_LENGTH);
+    memcpy(tx_buf, tx_data3, DATA_FRAME_LENGTH);
+    status = phy_fill_tx_buf(phy1, tx_buf, DATA_FRAME_LENGTH);
     if (status != 0){
         fprintf(stderr, "Couldn't transmit frame\n");
         goto out;
@@ -277,7 +395,7 @@ int phy_test(char *dev_id1, char *dev_id2, unsigned int tx_freq1, unsigned int t
     }else{
         printf("RX data matched TX data. Test passed.\n");
     }
-    phy_release_rx_buf(phy2);
+    phy_free_frame_buf(phy2, rx_data);
 
     out:
         ret = status;
@@ -295,6 +413,7 @@ int phy_test(char *dev_id1, char *dev_id2, unsigned int tx_freq1, unsigned int t
             }
         }
         free(tx_data3);
+        phy_free_frame_buf(phy1, tx_buf);
         DEBUG_MSG("\tClosing phy1 and phy2\n");
         phy_close(phy1);
         phy_close(phy2);
@@ -354,7 +473,7 @@ int phy_receive_test(void)
         fprintf(stderr, "Request buffer failed\n");
         goto out;
     }
-    phy_release_rx_buf(phy);
+    phy_free_frame_buf(phy, rx_data);
 
 
     out:
@@ -455,6 +574,164 @@ int fsk_test1(void)
         return status;
 }
 
+/**
+ * FSK discriminator test.
+ * Demodulates a noisy signal with both of fsk_demod()'s phase discriminators, checking
+ * that their bit error rates match, and reports each one's throughput.
+ */
+int fsk_test2(void)
+{
+    const enum fsk_demod_mode modes[] = { FSK_DEMOD_EXACT, FSK_DEMOD_FAST };
+    const char *mode_names[] = { "exact", "fast" };
+    const int num_bytes = 4096;
+    const double noise_rms = 600.0;     //~5 dB SNR per sample
+    struct fsk_handle *fsk = NULL;
+    struct complex_sample *samples = NULL;
+    uint8_t *tx_data = NULL, *rx_data = NULL;
+    uint64_t prng_state = 0x0123456789abcdefULL;
+    unsigned int num_samples, bit_errors[2];
+    struct timespec start, end;
+    double secs, u1, u2;
+    unsigned int i, m, reps;
+    int status = -1;
+
+    printf("------------BEGINNING FSK TEST 2-------------\n");
+    fsk = fsk_init();
+    tx_data = prng_fill(&prng_state, num_bytes);
+    rx_data = malloc(num_bytes);
+    num_samples = num_bytes*8*SAMP_PER_SYMB + 1;
+    samples = malloc(num_samples * sizeof(samples[0]));
+    if (fsk == NULL || tx_data == NULL || rx_data == NULL || samples == NULL){
+        fprintf(stderr, "Couldn't allocate test buffers\n");
+        goto out;
+    }
+
+    samples[0].i = 2047;
+    samples[0].q = 0;
+    fsk_mod(fsk, tx_data, num_bytes, &samples[1]);
+
+    //Add gaussian noise
+    srand(1);
+    for (i = 0; i < num_samples; i++){
+        u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+        u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+        samples[i].i = (int16_t) lround(samples[i].i +
+                                noise_rms * sqrt(-2*log(u1)) * cos(2*M_PI*u2));
+        samples[i].q = (int16_t) lround(samples[i].q +
+                                noise_rms * sqrt(-2*log(u1)) * sin(2*M_PI*u2));
+    }
+
+    for (m = 0; m < 2; m++){
+        fsk_set_demod_mode(fsk, modes[m]);
+
+        clock_gettime(CLOCK_REALTIME, &start);
+        for (reps = 0; reps < 20; reps++){
+            fsk_demod(fsk, samples, num_samples, true, num_bytes, rx_data);
+        }
+        clock_gettime(CLOCK_REALTIME, &end);
+
+        bit_errors[m] = 0;
+        for (i = 0; i < (unsigned int) num_bytes; i++){
+            uint8_t diff = tx_data[i] ^ rx_data[i];
+            for (; diff != 0; diff &= diff - 1){
+                bit_errors[m]++;
+            }
+        }
+
+        secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+        printf("%s: BER = %.5f, %.2f Msps\n", mode_names[m],
+                bit_errors[m] / (num_bytes * 8.0), reps * num_samples / secs / 1e6);
+    }
+
+    //The discriminators differ by ~1e-5 rad, so at most a handful of ties may differ
+    if (abs((int) bit_errors[0] - (int) bit_errors[1]) > 2){
+        fprintf(stderr, "Discriminator bit error counts differ. Test failed.\n");
+        goto out;
+    }
+
+    status = 0;
+
+    out:
+        free(samples);
+        free(rx_data);
+        free(tx_data);
+        fsk_close(fsk);
+        if (status != 0){
+            fprintf(stderr, "ERROR: Test did not complete successfully\n");
+        }
+        printf("------------ENDING FSK TEST 2----------------\n");
+        return status;
+}
+
+/**
+ * FSK modulator test.
+ * Modulates and scrambles random data with both of fsk_mod()'s modes, checking that
+ * their samples are identical, and reports each one's throughput.
+ */
+int fsk_test3(void)
+{
+    const enum fsk_mod_mode modes[] = { FSK_MOD_SYMBOL, FSK_MOD_TABLE };
+    const char *mode_names[] = { "symbol", "table" };
+    const int num_bytes = 4096;
+    const int scramble_start = 8;
+    struct fsk_handle *fsk = NULL;
+    struct complex_sample *samples[2] = { NULL, NULL };
+    uint8_t *tx_data = NULL, *sequence = NULL;
+    uint64_t prng_state = 0x0123456789abcdefULL;
+    uint64_t seq_state = 0xfedcba9876543210ULL;
+    unsigned int num_samples[2];
+    struct timespec start, end;
+    double secs;
+    unsigned int m, reps;
+    int status = -1;
+
+    printf("------------BEGINNING FSK TEST 3-------------\n");
+    fsk = fsk_init();
+    tx_data = prng_fill(&prng_state, num_bytes);
+    sequence = prng_fill(&seq_state, num_bytes);
+    samples[0] = malloc(num_bytes*8*SAMP_PER_SYMB * sizeof(samples[0][0]));
+    samples[1] = malloc(num_bytes*8*SAMP_PER_SYMB * sizeof(samples[1][0]));
+    if (fsk == NULL || tx_data == NULL || sequence == NULL || samples[0] == NULL ||
+        samples[1] == NULL){
+        fprintf(stderr, "Couldn't allocate test buffers\n");
+        goto out;
+    }
+
+    for (m = 0; m < 2; m++){
+        fsk_set_mod_mode(fsk, modes[m]);
+
+        clock_gettime(CLOCK_REALTIME, &start);
+        for (reps = 0; reps < 100; reps++){
+            num_samples[m] = fsk_mod_scrambled(fsk, tx_data, num_bytes, scramble_start,
+                                                sequence, samples[m]);
+        }
+        clock_gettime(CLOCK_REALTIME, &end);
+
+        secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+        printf("%s: %.2f Msps\n", mode_names[m], reps * num_samples[m] / secs / 1e6);
+    }
+
+    if (num_samples[0] != num_samples[1] ||
+        memcmp(samples[0], samples[1], num_samples[0] * sizeof(samples[0][0])) != 0){
+        fprintf(stderr, "Modulator outputs differ. Test failed.\n");
+        goto out;
+    }
+
+    status = 0;
+
+    out:
+        free(samples[0]);
+        free(samples[1]);
+        free(sequence);
+        free(tx_data);
+        fsk_close(fsk);
+        if (status != 0){
+            fprintf(stderr, "ERROR: Test did not complete successfully\n");
+        }
+        printf("------------ENDING FSK TEST 3----------------\n");
+        return status;
+}
+
 /**
  * Run all tests
  */
@@ -474,10 +751,13 @@ int main(int argc, char *argv[])
     dev_id2 = argv[2];
 
     fsk_test1();
+    fsk_test2();
+    fsk_test3();
     phy_receive_test();
     phy_test(dev_id1, dev_id2, 904000000, 924000000);
     phy_test(dev_id2, dev_id1, 904000000, 924000000);
     link_test(dev_id1, dev_id2, 904000000, 924000000);
+    mchan_test(dev_id1, dev_id2, 904000000, 924000000);
 
     return 0;
 }
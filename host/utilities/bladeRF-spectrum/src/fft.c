@@ -0,0 +1,118 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <math.h>
+#include <stdlib.h>
+
+#include "fft.h"
+
+struct fft {
+    unsigned int size;
+    unsigned int *reverse; /* Bit-reversed index of each point */
+    float *twiddles;       /* exp(-2*pi*i*k/size) for k < size/2 */
+};
+
+struct fft *fft_init(unsigned int size)
+{
+    struct fft *fft;
+    unsigned int bits, i, j;
+
+    if (size < FFT_SIZE_MIN || size > FFT_SIZE_MAX || (size & (size - 1))) {
+        return NULL;
+    }
+
+    fft = calloc(1, sizeof(*fft));
+    if (fft == NULL) {
+        return NULL;
+    }
+
+    fft->size     = size;
+    fft->reverse  = malloc(size * sizeof(fft->reverse[0]));
+    fft->twiddles = malloc(size * sizeof(fft->twiddles[0]));
+    if (fft->reverse == NULL || fft->twiddles == NULL) {
+        fft_deinit(fft);
+        return NULL;
+    }
+
+    for (bits = 0; (1u << bits) < size; bits++)
+        ;
+
+    for (i = 0; i < size; i++) {
+        unsigned int r = 0;
+        for (j = 0; j < bits; j++) {
+            r |= ((i >> j) & 1) << (bits - 1 - j);
+        }
+        fft->reverse[i] = r;
+    }
+
+    for (i = 0; i < size / 2; i++) {
+        const double phase = -2.0 * M_PI * i / size;
+        fft->twiddles[2 * i]     = (float)cos(phase);
+        fft->twiddles[2 * i + 1] = (float)sin(phase);
+    }
+
+    return fft;
+}
+
+void fft_run(const struct fft *fft, float *buf)
+{
+    const unsigned int n = fft->size;
+    unsigned int i, len, k;
+
+    for (i = 0; i < n; i++) {
+        const unsigned int r = fft->reverse[i];
+        if (r > i) {
+            float t;
+            t = buf[2 * i], buf[2 * i] = buf[2 * r], buf[2 * r] = t;
+            t = buf[2 * i + 1], buf[2 * i + 1] = buf[2 * r + 1],
+            buf[2 * r + 1] = t;
+        }
+    }
+
+    for (len = 2; len <= n; len <<= 1) {
+        const unsigned int half   = len / 2;
+        const unsigned int stride = n / len;
+
+        for (i = 0; i < n; i += len) {
+            float *a = &buf[2 * i];
+            float *b = &buf[2 * (i + half)];
+
+            for (k = 0; k < half; k++) {
+                const float wr = fft->twiddles[2 * k * stride];
+                const float wi = fft->twiddles[2 * k * stride + 1];
+                const float tr = b[2 * k] * wr - b[2 * k + 1] * wi;
+                const float ti = b[2 * k] * wi + b[2 * k + 1] * wr;
+
+                b[2 * k]     = a[2 * k] - tr;
+                b[2 * k + 1] = a[2 * k + 1] - ti;
+                a[2 * k] += tr;
+                a[2 * k + 1] += ti;
+            }
+        }
+    }
+}
+
+void fft_deinit(struct fft *fft)
+{
+    if (fft != NULL) {
+        free(fft->reverse);
+        free(fft->twiddles);
+        free(fft);
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ * @file fft.h
+ *
+ * @brief Radix-2 complex FFT
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef FFT_H__
+#define FFT_H__
+
+/* Range of supported FFT sizes. Sizes must be powers of 2. */
+#define FFT_SIZE_MIN 16
+#define FFT_SIZE_MAX 65536
+
+/* Twiddle factors and bit-reversal table for one FFT size. This is read-only
+ * once created, so one instance may be shared by any number of threads. */
+struct fft;
+
+/**
+ * Prepare an FFT
+ *
+ * @param[in]   size    Number of points, a power of 2 from FFT_SIZE_MIN to
+ *                      FFT_SIZE_MAX
+ *
+ * @return FFT on success, NULL on an invalid size or allocation failure
+ */
+struct fft *fft_init(unsigned int size);
+
+/**
+ * Compute a forward FFT in place
+ *
+ * @param[in]       fft     FFT
+ * @param[inout]    buf     `size` complex values, as interleaved real and
+ *                          imaginary parts
+ */
+void fft_run(const struct fft *fft, float *buf);
+
+/**
+ * Free an FFT. Does nothing if fft is NULL.
+ */
+void fft_deinit(struct fft *fft);
+
+#endif
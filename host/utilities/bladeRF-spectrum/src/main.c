@@ -0,0 +1,530 @@
+/**
+ * @file
+ * @brief   Spectrum sweep utility
+ *
+ * Sweeps an RX channel across a frequency range with bladerf_sweep(), and
+ * streams out the averaged power spectrum of each step as CSV or binary
+ * records. Retunes are scheduled ahead of the step being captured, and the
+ * FFTs are spread across worker threads, so a sweep takes little more than
+ * the time spent capturing its samples.
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <libbladeRF.h>
+
+#include "conversions.h"
+#include "fft.h"
+#include "spectrum.h"
+
+#define BLADERF_SPECTRUM_VERSION "0.1.0"
+
+#define DEFAULT_SAMPLERATE 20000000
+#define DEFAULT_FFT_SIZE 1024
+#define DEFAULT_AVERAGES 16
+#define DEFAULT_USABLE 0.75
+#define DEFAULT_SETTLE_US 100
+#define MAX_AVERAGES 4096
+#define MAX_THREADS 256
+#define OUTPUT_BUFFER_SIZE (1024 * 1024)
+
+/* Synchronous interface configuration */
+#define SYNC_NUM_BUFFERS 32
+#define SYNC_BUFFER_SIZE 8192
+#define SYNC_NUM_TRANSFERS 16
+#define SYNC_TIMEOUT_MS 1000
+
+#define OPTION_FORMAT 0x80
+#define OPTION_LOOKAHEAD 0x81
+#define OPTION_NO_DC_FIX 0x82
+
+struct options {
+    const char *device;
+    bladerf_frequency start;
+    bladerf_frequency stop;
+    bladerf_sample_rate samplerate;
+    bladerf_bandwidth bandwidth;
+    unsigned int fft_size;
+    unsigned int averages;
+    double usable;
+    unsigned int settle_us;
+    bool gain_set;
+    int gain;
+    unsigned int lookahead;
+    unsigned int sweeps;
+    const char *output;
+    enum spectrum_output format;
+    unsigned int threads;
+    bool dc_fix;
+    bool verbose;
+};
+
+static struct option long_options[] = {
+    { "device", required_argument, 0, 'd' },
+    { "start", required_argument, 0, 'f' },
+    { "stop", required_argument, 0, 't' },
+    { "samplerate", required_argument, 0, 'r' },
+    { "bandwidth", required_argument, 0, 'w' },
+    { "bins", required_argument, 0, 'b' },
+    { "averages", required_argument, 0, 'a' },
+    { "usable", required_argument, 0, 'u' },
+    { "settle", required_argument, 0, 'S' },
+    { "gain", required_argument, 0, 'g' },
+    { "lookahead", required_argument, 0, OPTION_LOOKAHEAD },
+    { "sweeps", required_argument, 0, 'n' },
+    { "output", required_argument, 0, 'o' },
+    { "format", required_argument, 0, OPTION_FORMAT },
+    { "threads", required_argument, 0, 'j' },
+    { "no-dc-fix", no_argument, 0, OPTION_NO_DC_FIX },
+    { "verbose", no_argument, 0, 'v' },
+    { "version", no_argument, 0, 'V' },
+    { "help", no_argument, 0, 'h' },
+    { 0, 0, 0, 0 },
+};
+
+static const struct numeric_suffix freq_suffixes[] = {
+    { "K", 1000 },
+    { "k", 1000 },
+    { "M", 1000 * 1000 },
+    { "G", 1000 * 1000 * 1000 },
+};
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void handle_signal(int signum)
+{
+    (void)signum;
+    interrupted = 1;
+}
+
+static void usage(const char *argv0)
+{
+    printf("Usage: %s [options] -f <start> -t <stop>\n", argv0);
+    printf("Sweep the power spectrum from <start> to <stop> Hz.\n\n");
+    printf("Options:\n");
+    printf("  -d, --device <str>        Device to open. Default: first found.\n");
+    printf("  -f, --start <freq>        Lower edge of the sweep.\n");
+    printf("  -t, --stop <freq>         Upper edge of the sweep.\n");
+    printf("  -r, --samplerate <rate>   Sample rate. Default: %u MHz\n",
+           DEFAULT_SAMPLERATE / 1000000);
+    printf("  -w, --bandwidth <bw>      RX bandwidth. Default: the sample rate\n");
+    printf("  -b, --bins <n>            FFT size, a power of 2 from %u to %u.\n"
+           "                            Default: %u\n",
+           FFT_SIZE_MIN, FFT_SIZE_MAX, DEFAULT_FFT_SIZE);
+    printf("  -a, --averages <n>        FFTs averaged per step. Default: %u\n",
+           DEFAULT_AVERAGES);
+    printf("  -u, --usable <fraction>   Fraction of each step's bins kept, and\n"
+           "                            so the step size. Default: %.2f\n",
+           DEFAULT_USABLE);
+    printf("  -S, --settle <us>         Time discarded after each retune.\n"
+           "                            Default: %u us\n", DEFAULT_SETTLE_US);
+    printf("  -g, --gain <dB>           Manual RX gain. Default: device "
+           "default\n");
+    printf("  --lookahead <n>           Retunes scheduled ahead. Default: %u\n",
+           BLADERF_SWEEP_LOOKAHEAD_DEFAULT);
+    printf("  -n, --sweeps <n>          Number of sweeps. Default: 0, which\n"
+           "                            runs until interrupted.\n");
+    printf("  -o, --output <file>       Output file, or - for stdout. Default: "
+           "-\n");
+    printf("  --format <csv|bin>        Output format. Default: csv\n");
+    printf("  -j, --threads <n>         FFT worker threads. Default: online "
+           "CPUs\n");
+    printf("  --no-dc-fix               Keep the DC bin, rather than\n"
+           "                            interpolating over the LO leakage.\n");
+    printf("  -v, --verbose             Report the sweep rate.\n");
+    printf("  --version                 Print version information.\n");
+    printf("  -h, --help                Show this text.\n\n");
+
+    printf("CSV lines are those of rtl_power: date, time, Hz low, Hz high,\n");
+    printf("Hz step, samples, then one dBFS value per bin.\n");
+}
+
+struct sweep_state {
+    struct spectrum *spectrum;
+};
+
+static int sweep_cb(struct bladerf *dev,
+                    const struct bladerf_sweep_block *block,
+                    void *user_data)
+{
+    struct sweep_state *state = user_data;
+    (void)dev;
+
+    if (interrupted) {
+        return 1;
+    }
+
+    return (spectrum_submit(state->spectrum, block) != 0) ? 1 : 0;
+}
+
+static int configure_device(struct bladerf *dev, struct options *opts)
+{
+    const bladerf_channel ch = BLADERF_CHANNEL_RX(0);
+    bladerf_sample_rate rate;
+    int status;
+
+    status = bladerf_set_sample_rate(dev, ch, opts->samplerate, &rate);
+    if (status != 0) {
+        fprintf(stderr, "Failed to set sample rate: %s\n",
+                bladerf_strerror(status));
+        return status;
+    }
+    opts->samplerate = rate;
+
+    status = bladerf_set_bandwidth(dev, ch, opts->bandwidth ? opts->bandwidth
+                                                            : rate, NULL);
+    if (status != 0) {
+        fprintf(stderr, "Failed to set bandwidth: %s\n",
+                bladerf_strerror(status));
+        return status;
+    }
+
+    if (opts->gain_set) {
+        status = bladerf_set_gain_mode(dev, ch, BLADERF_GAIN_MGC);
+        if (status == 0) {
+            status = bladerf_set_gain(dev, ch, opts->gain);
+        }
+        if (status != 0) {
+            fprintf(stderr, "Failed to set gain: %s\n",
+                    bladerf_strerror(status));
+            return status;
+        }
+    }
+
+    status = bladerf_sync_config(dev, BLADERF_RX_X1,
+                                 BLADERF_FORMAT_SC16_Q11_META,
+                                 SYNC_NUM_BUFFERS, SYNC_BUFFER_SIZE,
+                                 SYNC_NUM_TRANSFERS, SYNC_TIMEOUT_MS);
+    if (status != 0) {
+        fprintf(stderr, "Failed to configure RX stream: %s\n",
+                bladerf_strerror(status));
+        return status;
+    }
+
+    status = bladerf_enable_module(dev, ch, true);
+    if (status != 0) {
+        fprintf(stderr, "Failed to enable RX: %s\n", bladerf_strerror(status));
+    }
+
+    return status;
+}
+
+static int run(struct bladerf *dev, struct options *opts, FILE *out)
+{
+    const bladerf_channel ch = BLADERF_CHANNEL_RX(0);
+    const struct bladerf_range *range;
+    struct bladerf_sweep_config sweep;
+    struct spectrum_config config;
+    struct spectrum_stats stats;
+    struct sweep_state state;
+    unsigned int kept;
+    double bin_width;
+    bladerf_frequency step, first, last;
+    uint64_t num_steps;
+    int status, finish_status;
+
+    status = configure_device(dev, opts);
+    if (status != 0) {
+        return -1;
+    }
+
+    status = bladerf_get_frequency_range(dev, ch, &range);
+    if (status != 0) {
+        fprintf(stderr, "Failed to get frequency range: %s\n",
+                bladerf_strerror(status));
+        return -1;
+    }
+
+    /* Each step keeps `kept` bins from the middle of its band, so that
+     * consecutive steps' bins tile the sweep. The first bin's lower edge
+     * is the start of the sweep. */
+    kept = (unsigned int)(opts->usable * opts->fft_size + 0.5) & ~1u;
+    if (kept < 2) {
+        kept = 2;
+    }
+
+    bin_width = (double)opts->samplerate / opts->fft_size;
+    step      = (bladerf_frequency)(kept * bin_width + 0.5);
+    num_steps = (opts->stop - opts->start + step - 1) / step;
+    if (num_steps == 0) {
+        num_steps = 1;
+    }
+
+    first = opts->start + (bladerf_frequency)((kept / 2 + 0.5) * bin_width);
+    last  = first + (num_steps - 1) * step;
+
+    if (first < (bladerf_frequency)range->min ||
+        last > (bladerf_frequency)range->max) {
+        fprintf(stderr, "Steps from %" PRIu64 " to %" PRIu64 " Hz are outside "
+                "of the device's range of %" PRIi64 " to %" PRIi64 " Hz.\n",
+                first, last, range->min, range->max);
+        return -1;
+    }
+
+    if (num_steps > UINT32_MAX) {
+        fprintf(stderr, "Too many steps.\n");
+        return -1;
+    }
+
+    memset(&sweep, 0, sizeof(sweep));
+    sweep.start            = first;
+    sweep.stop             = last;
+    sweep.step             = step;
+    sweep.samples_per_step = opts->fft_size * opts->averages;
+    sweep.settle_samples   = (unsigned int)((uint64_t)opts->samplerate *
+                                          opts->settle_us / 1000000);
+    sweep.lookahead        = opts->lookahead;
+    sweep.timeout_ms       = SYNC_TIMEOUT_MS;
+
+    memset(&config, 0, sizeof(config));
+    config.fft_size   = opts->fft_size;
+    config.averages   = opts->averages;
+    config.kept_bins  = kept;
+    config.num_steps  = (unsigned int)num_steps;
+    config.samplerate = opts->samplerate;
+    config.threads    = opts->threads;
+    config.dc_fix     = opts->dc_fix;
+    config.output     = opts->format;
+    config.out        = out;
+    config.verbose    = opts->verbose;
+
+    state.spectrum = spectrum_init(&config);
+    if (state.spectrum == NULL) {
+        fprintf(stderr, "Failed to start FFT threads.\n");
+        return -1;
+    }
+
+    fprintf(stderr, "Sweeping %" PRIu64 " - %" PRIu64 " Hz in %" PRIu64
+            " steps of %" PRIu64 " Hz, with %u bins of %.1f Hz per step.\n",
+            opts->start, opts->start + num_steps * step, num_steps, step,
+            kept, bin_width);
+
+    status = bladerf_sweep(dev, ch, &sweep, opts->sweeps, sweep_cb, &state);
+    if (status != 0) {
+        fprintf(stderr, "Sweep failed: %s\n", bladerf_strerror(status));
+    }
+
+    finish_status = spectrum_finish(state.spectrum, &stats);
+
+    fprintf(stderr, "%" PRIu64 " sweeps (%" PRIu64 " steps) in %.2f s",
+            stats.sweeps, stats.steps, stats.elapsed);
+    if (stats.sweeps > 0 && stats.elapsed > 0) {
+        fprintf(stderr, ": %.2f sweeps/s", stats.sweeps / stats.elapsed);
+    }
+    fprintf(stderr, ".\n");
+
+    if (stats.dropped > 0) {
+        fprintf(stderr, "Warning: %" PRIu64 " step%s dropped due to "
+                "overruns.\n", stats.dropped, stats.dropped == 1 ? " was" :
+                "s were");
+    }
+
+    return (status != 0 || finish_status != 0) ? -1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    struct options opts;
+    struct bladerf *dev = NULL;
+    FILE *out = NULL;
+    bool ok = true;
+    long cpus;
+    int c;
+    int status = EXIT_FAILURE;
+
+    memset(&opts, 0, sizeof(opts));
+    opts.samplerate = DEFAULT_SAMPLERATE;
+    opts.fft_size   = DEFAULT_FFT_SIZE;
+    opts.averages   = DEFAULT_AVERAGES;
+    opts.usable     = DEFAULT_USABLE;
+    opts.settle_us  = DEFAULT_SETTLE_US;
+    opts.output     = "-";
+    opts.format     = SPECTRUM_OUTPUT_CSV;
+    opts.dc_fix     = true;
+
+    cpus         = sysconf(_SC_NPROCESSORS_ONLN);
+    opts.threads = (cpus > 0 && cpus <= MAX_THREADS) ? (unsigned int)cpus : 1;
+
+    while ((c = getopt_long(argc, argv, "d:f:t:r:w:b:a:u:S:g:n:o:j:vh",
+                            long_options, NULL)) != -1) {
+        switch (c) {
+            case 'd':
+                opts.device = optarg;
+                break;
+
+            case 'f':
+                opts.start = str2uint64_suffix(
+                    optarg, 0, UINT64_MAX, freq_suffixes,
+                    sizeof(freq_suffixes) / sizeof(freq_suffixes[0]), &ok);
+                break;
+
+            case 't':
+                opts.stop = str2uint64_suffix(
+                    optarg, 0, UINT64_MAX, freq_suffixes,
+                    sizeof(freq_suffixes) / sizeof(freq_suffixes[0]), &ok);
+                break;
+
+            case 'r':
+                opts.samplerate = str2uint_suffix(
+                    optarg, 1, UINT32_MAX, freq_suffixes,
+                    sizeof(freq_suffixes) / sizeof(freq_suffixes[0]), &ok);
+                break;
+
+            case 'w':
+                opts.bandwidth = str2uint_suffix(
+                    optarg, 1, UINT32_MAX, freq_suffixes,
+                    sizeof(freq_suffixes) / sizeof(freq_suffixes[0]), &ok);
+                break;
+
+            case 'b':
+                opts.fft_size = str2uint(optarg, FFT_SIZE_MIN, FFT_SIZE_MAX,
+                                         &ok);
+                if (opts.fft_size & (opts.fft_size - 1)) {
+                    ok = false;
+                }
+                break;
+
+            case 'a':
+                opts.averages = str2uint(optarg, 1, MAX_AVERAGES, &ok);
+                break;
+
+            case 'u':
+                opts.usable = str2double(optarg, 0.01, 1.0, &ok);
+                break;
+
+            case 'S':
+                opts.settle_us = str2uint(optarg, 0, 1000000, &ok);
+                break;
+
+            case 'g':
+                opts.gain     = str2int(optarg, -100, 100, &ok);
+                opts.gain_set = true;
+                break;
+
+            case OPTION_LOOKAHEAD:
+                opts.lookahead = str2uint(optarg, 1, 256, &ok);
+                break;
+
+            case 'n':
+                opts.sweeps = str2uint(optarg, 0, UINT32_MAX, &ok);
+                break;
+
+            case 'o':
+                opts.output = optarg;
+                break;
+
+            case OPTION_FORMAT:
+                if (!strcasecmp(optarg, "csv")) {
+                    opts.format = SPECTRUM_OUTPUT_CSV;
+                } else if (!strcasecmp(optarg, "bin")) {
+                    opts.format = SPECTRUM_OUTPUT_BINARY;
+                } else {
+                    ok = false;
+                }
+                break;
+
+            case 'j':
+                opts.threads = str2uint(optarg, 1, MAX_THREADS, &ok);
+                break;
+
+            case OPTION_NO_DC_FIX:
+                opts.dc_fix = false;
+                break;
+
+            case 'v':
+                opts.verbose = true;
+                break;
+
+            case 'V': {
+                struct bladerf_version ver;
+                bladerf_version(&ver);
+                printf("bladeRF-spectrum %s (libbladeRF %s)\n",
+                       BLADERF_SPECTRUM_VERSION, ver.describe);
+                return EXIT_SUCCESS;
+            }
+
+            case 'h':
+                usage(argv[0]);
+                return EXIT_SUCCESS;
+
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+
+        if (!ok) {
+            fprintf(stderr, "Invalid value: %s\n", optarg);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (optind != argc || opts.stop <= opts.start) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (!strcmp(opts.output, "-")) {
+        out = stdout;
+    } else {
+        out = fopen(opts.output, "wb");
+        if (out == NULL) {
+            fprintf(stderr, "Failed to open %s: %s\n", opts.output,
+                    strerror(errno));
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* Sweeps are flushed as they complete */
+    setvbuf(out, NULL, _IOFBF, OUTPUT_BUFFER_SIZE);
+
+    /* Report a closed pipe as a write error, rather than being killed */
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, handle_signal);
+    signal(SIGTERM, handle_signal);
+
+    status = bladerf_open(&dev, opts.device);
+    if (status != 0) {
+        fprintf(stderr, "Failed to open device: %s\n",
+                bladerf_strerror(status));
+        status = EXIT_FAILURE;
+        goto out;
+    }
+
+    status = (run(dev, &opts, out) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    bladerf_enable_module(dev, BLADERF_CHANNEL_RX(0), false);
+    bladerf_close(dev);
+
+out:
+    if (out != stdout && fclose(out) != 0 && status == EXIT_SUCCESS) {
+        fprintf(stderr, "Failed to write %s: %s\n", opts.output,
+                strerror(errno));
+        status = EXIT_FAILURE;
+    }
+
+    return status;
+}
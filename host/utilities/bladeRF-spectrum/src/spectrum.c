@@ -0,0 +1,496 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <errno.h>
+#include <inttypes.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "fft.h"
+#include "spectrum.h"
+
+/* Slots in flight per worker thread. One is being processed while the
+ * other waits to be written. A few more absorb jitter in the writer. */
+#define SLOTS_PER_THREAD 2
+#define EXTRA_SLOTS 4
+
+/* Full scale of SC16 Q11 samples */
+#define SAMPLE_SCALE 2048.0
+
+/* Floor on power values, to keep log10() finite */
+#define POWER_FLOOR 1e-20
+
+enum slot_state {
+    SLOT_FREE,   /* Available for the next step */
+    SLOT_FILLED, /* Holds samples, waiting for a worker */
+    SLOT_BUSY,   /* Being processed by a worker */
+    SLOT_DONE,   /* Processed, waiting to be written */
+};
+
+struct slot {
+    enum slot_state state;
+
+    unsigned int sweep;
+    unsigned int step;
+    bladerf_frequency frequency;
+    bladerf_timestamp timestamp;
+    time_t captured; /* Wall clock time of capture, for CSV output */
+
+    int16_t *samples;
+    unsigned int num_ffts;
+    float *power; /* dBFS of the kept bins */
+};
+
+struct worker {
+    struct spectrum *s;
+    pthread_t thread;
+    bool started;
+    float *buf; /* FFT input and output */
+    double *acc; /* Accumulated power of each bin */
+};
+
+struct spectrum {
+    const struct spectrum_config *config;
+    struct fft *fft;
+    float *window;
+    double scale; /* Normalizes accumulated power to dBFS, per FFT */
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond; /* Broadcast whenever a slot changes state */
+
+    struct slot *slots;
+    size_t num_slots;
+
+    uint64_t next_submit;  /* Sequence number of the next step queued */
+    uint64_t next_process; /* Next step to be claimed by a worker */
+    uint64_t next_write;   /* Next step to be written */
+    bool finishing;        /* No more steps will be submitted */
+    bool failed;           /* Output failed */
+
+    struct worker *workers;
+    pthread_t writer;
+    bool writer_started;
+
+    struct spectrum_stats stats;
+    bool timing;           /* The first step has been submitted */
+    struct timespec first;
+    struct timespec sweep_start;
+};
+
+static double elapsed_since(const struct timespec *t)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - t->tv_sec) + (now.tv_nsec - t->tv_nsec) / 1e9;
+}
+
+/* Window, FFT and average a slot's samples into its kept bins */
+static void process(struct worker *w, struct slot *slot)
+{
+    const struct spectrum_config *config = w->s->config;
+    const unsigned int n    = config->fft_size;
+    const unsigned int kept = config->kept_bins;
+    const float *window     = w->s->window;
+    unsigned int i, j, k;
+
+    memset(w->acc, 0, n * sizeof(w->acc[0]));
+
+    for (i = 0; i < slot->num_ffts; i++) {
+        const int16_t *x = &slot->samples[2 * (size_t)i * n];
+
+        for (j = 0; j < n; j++) {
+            w->buf[2 * j]     = x[2 * j] * window[j];
+            w->buf[2 * j + 1] = x[2 * j + 1] * window[j];
+        }
+
+        fft_run(w->s->fft, w->buf);
+
+        for (j = 0; j < n; j++) {
+            const double re = w->buf[2 * j], im = w->buf[2 * j + 1];
+            w->acc[j] += re * re + im * im;
+        }
+    }
+
+    /* Replace the LO leakage and DC offset at bin 0 with its neighbours */
+    if (config->dc_fix) {
+        w->acc[0] = (w->acc[1] + w->acc[n - 1]) / 2;
+    }
+
+    /* Output the kept bins in order of frequency, centered on bin 0 */
+    for (k = 0; k < kept; k++) {
+        const double p = w->acc[(n - kept / 2 + k) % n] * w->s->scale /
+                         slot->num_ffts;
+        slot->power[k] = (float)(10.0 * log10(p + POWER_FLOOR));
+    }
+}
+
+static void *worker_thread(void *arg)
+{
+    struct worker *w   = arg;
+    struct spectrum *s = w->s;
+    struct slot *slot;
+
+    pthread_mutex_lock(&s->lock);
+
+    while (true) {
+        while (s->next_process == s->next_submit && !s->finishing) {
+            pthread_cond_wait(&s->cond, &s->lock);
+        }
+
+        if (s->next_process == s->next_submit) {
+            break;
+        }
+
+        slot        = &s->slots[s->next_process % s->num_slots];
+        slot->state = SLOT_BUSY;
+        s->next_process++;
+        pthread_mutex_unlock(&s->lock);
+
+        process(w, slot);
+
+        pthread_mutex_lock(&s->lock);
+        slot->state = SLOT_DONE;
+        pthread_cond_broadcast(&s->cond);
+    }
+
+    pthread_mutex_unlock(&s->lock);
+    return NULL;
+}
+
+static int write_csv(struct spectrum *s, const struct slot *slot,
+                     double bin_width, bladerf_frequency hz_low,
+                     bladerf_frequency hz_high)
+{
+    const struct spectrum_config *config = s->config;
+    FILE *out = config->out;
+    char datetime[32];
+    struct tm tm;
+    unsigned int k;
+
+    gmtime_r(&slot->captured, &tm);
+    strftime(datetime, sizeof(datetime), "%Y-%m-%d, %H:%M:%S", &tm);
+
+    fprintf(out, "%s, %" PRIu64 ", %" PRIu64 ", %.2f, %u", datetime, hz_low,
+            hz_high, bin_width, slot->num_ffts * config->fft_size);
+
+    for (k = 0; k < config->kept_bins; k++) {
+        fprintf(out, ", %.2f", slot->power[k]);
+    }
+
+    return (fputc('\n', out) == EOF) ? -1 : 0;
+}
+
+static int write_binary(struct spectrum *s, const struct slot *slot,
+                        bladerf_frequency hz_low, bladerf_frequency hz_high)
+{
+    const struct spectrum_config *config = s->config;
+    struct spectrum_record rec;
+
+    rec.length    = (uint32_t)(sizeof(rec) - sizeof(rec.length) +
+                            config->kept_bins * sizeof(float));
+    rec.sweep     = slot->sweep;
+    rec.step      = slot->step;
+    rec.num_bins  = config->kept_bins;
+    rec.hz_low    = hz_low;
+    rec.hz_high   = hz_high;
+    rec.timestamp = slot->timestamp;
+
+    if (fwrite(&rec, sizeof(rec), 1, config->out) != 1 ||
+        fwrite(slot->power, sizeof(float), config->kept_bins, config->out) !=
+            config->kept_bins) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static int write_slot(struct spectrum *s, const struct slot *slot)
+{
+    const struct spectrum_config *config = s->config;
+    const double bin_width = (double)config->samplerate / config->fft_size;
+    /* Bins are centered on multiples of bin_width from the step's frequency */
+    const bladerf_frequency hz_low = slot->frequency -
+        (bladerf_frequency)(bin_width * (config->kept_bins / 2 + 0.5) + 0.5);
+    const bladerf_frequency hz_high =
+        hz_low + (bladerf_frequency)(bin_width * config->kept_bins + 0.5);
+    int status;
+
+    if (config->output == SPECTRUM_OUTPUT_CSV) {
+        status = write_csv(s, slot, bin_width, hz_low, hz_high);
+    } else {
+        status = write_binary(s, slot, hz_low, hz_high);
+    }
+
+    if (status != 0) {
+        return status;
+    }
+
+    s->stats.steps++;
+
+    /* Make each complete sweep available to readers of a pipe */
+    if (slot->step + 1 == config->num_steps) {
+        s->stats.sweeps++;
+
+        if (fflush(config->out) != 0) {
+            return -1;
+        }
+
+        if (config->verbose) {
+            fprintf(stderr, "Sweep %u: %.1f sweeps/s\n", slot->sweep,
+                    1.0 / elapsed_since(&s->sweep_start));
+            clock_gettime(CLOCK_MONOTONIC, &s->sweep_start);
+        }
+    }
+
+    return 0;
+}
+
+static void *writer_thread(void *arg)
+{
+    struct spectrum *s = arg;
+    struct slot *slot;
+    bool failed = false;
+
+    pthread_mutex_lock(&s->lock);
+
+    while (true) {
+        while (s->next_write == s->next_submit && !s->finishing) {
+            pthread_cond_wait(&s->cond, &s->lock);
+        }
+
+        if (s->next_write == s->next_submit) {
+            break;
+        }
+
+        slot = &s->slots[s->next_write % s->num_slots];
+        while (slot->state != SLOT_DONE) {
+            pthread_cond_wait(&s->cond, &s->lock);
+        }
+        pthread_mutex_unlock(&s->lock);
+
+        /* After a failure, keep freeing slots so the sweep can end */
+        if (!failed && write_slot(s, slot) != 0) {
+            fprintf(stderr, "Failed to write output: %s\n", strerror(errno));
+            failed = true;
+        }
+
+        pthread_mutex_lock(&s->lock);
+        s->failed   = failed;
+        slot->state = SLOT_FREE;
+        s->next_write++;
+        pthread_cond_broadcast(&s->cond);
+    }
+
+    pthread_mutex_unlock(&s->lock);
+    return NULL;
+}
+
+static void free_state(struct spectrum *s)
+{
+    size_t i;
+
+    if (s->workers != NULL) {
+        for (i = 0; i < s->config->threads; i++) {
+            free(s->workers[i].buf);
+            free(s->workers[i].acc);
+        }
+    }
+
+    if (s->slots != NULL) {
+        for (i = 0; i < s->num_slots; i++) {
+            free(s->slots[i].samples);
+            free(s->slots[i].power);
+        }
+    }
+
+    free(s->workers);
+    free(s->slots);
+    free(s->window);
+    fft_deinit(s->fft);
+    pthread_cond_destroy(&s->cond);
+    pthread_mutex_destroy(&s->lock);
+    free(s);
+}
+
+struct spectrum *spectrum_init(const struct spectrum_config *config)
+{
+    const unsigned int n = config->fft_size;
+    struct spectrum *s;
+    double window_sum = 0;
+    unsigned int i;
+    int status;
+
+    s = calloc(1, sizeof(*s));
+    if (s == NULL) {
+        return NULL;
+    }
+
+    s->config = config;
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_cond_init(&s->cond, NULL);
+
+    s->fft = fft_init(n);
+    s->window = malloc(n * sizeof(s->window[0]));
+    s->num_slots = config->threads * SLOTS_PER_THREAD + EXTRA_SLOTS;
+    s->slots = calloc(s->num_slots, sizeof(s->slots[0]));
+    s->workers = calloc(config->threads, sizeof(s->workers[0]));
+    if (s->fft == NULL || s->window == NULL || s->slots == NULL ||
+        s->workers == NULL) {
+        goto error;
+    }
+
+    /* Hann window */
+    for (i = 0; i < n; i++) {
+        s->window[i] = (float)(0.5 - 0.5 * cos(2.0 * M_PI * i / n));
+        window_sum += s->window[i];
+    }
+
+    /* A full scale tone, centered in a bin, reads 0 dBFS */
+    s->scale = 1.0 / (SAMPLE_SCALE * SAMPLE_SCALE * window_sum * window_sum);
+
+    for (i = 0; i < s->num_slots; i++) {
+        s->slots[i].samples = malloc((size_t)n * config->averages * 2 *
+                                     sizeof(int16_t));
+        s->slots[i].power   = malloc(config->kept_bins * sizeof(float));
+        if (s->slots[i].samples == NULL || s->slots[i].power == NULL) {
+            goto error;
+        }
+    }
+
+    for (i = 0; i < config->threads; i++) {
+        s->workers[i].s   = s;
+        s->workers[i].buf = malloc(2 * n * sizeof(float));
+        s->workers[i].acc = malloc(n * sizeof(double));
+        if (s->workers[i].buf == NULL || s->workers[i].acc == NULL) {
+            goto error;
+        }
+
+        status = pthread_create(&s->workers[i].thread, NULL, worker_thread,
+                                &s->workers[i]);
+        if (status != 0) {
+            fprintf(stderr, "Failed to start worker thread: %s\n",
+                    strerror(status));
+            goto error;
+        }
+        s->workers[i].started = true;
+    }
+
+    status = pthread_create(&s->writer, NULL, writer_thread, s);
+    if (status != 0) {
+        fprintf(stderr, "Failed to start writer thread: %s\n",
+                strerror(status));
+        goto error;
+    }
+    s->writer_started = true;
+
+    return s;
+
+error:
+    spectrum_finish(s, NULL);
+    return NULL;
+}
+
+int spectrum_submit(struct spectrum *s, const struct bladerf_sweep_block *block)
+{
+    const struct spectrum_config *config = s->config;
+    const unsigned int num_ffts = block->num_samples / config->fft_size;
+    struct slot *slot;
+    bool failed;
+
+    if (!s->timing) {
+        clock_gettime(CLOCK_MONOTONIC, &s->first);
+        s->sweep_start = s->first;
+        s->timing      = true;
+    }
+
+    pthread_mutex_lock(&s->lock);
+
+    if (num_ffts == 0) {
+        /* Not even one FFT's worth, due to an overrun */
+        s->stats.dropped++;
+        failed = s->failed;
+        pthread_mutex_unlock(&s->lock);
+        return failed ? -1 : 0;
+    }
+
+    slot = &s->slots[s->next_submit % s->num_slots];
+    while (slot->state != SLOT_FREE) {
+        pthread_cond_wait(&s->cond, &s->lock);
+    }
+
+    pthread_mutex_unlock(&s->lock);
+
+    slot->sweep     = block->sweep;
+    slot->step      = block->step;
+    slot->frequency = block->frequency;
+    slot->timestamp = block->timestamp;
+    slot->captured  = time(NULL);
+    slot->num_ffts  = (num_ffts > config->averages) ? config->averages
+                                                    : num_ffts;
+    memcpy(slot->samples, block->samples,
+           (size_t)slot->num_ffts * config->fft_size * 2 * sizeof(int16_t));
+
+    pthread_mutex_lock(&s->lock);
+    slot->state = SLOT_FILLED;
+    s->next_submit++;
+    failed = s->failed;
+    pthread_cond_broadcast(&s->cond);
+    pthread_mutex_unlock(&s->lock);
+
+    return failed ? -1 : 0;
+}
+
+int spectrum_finish(struct spectrum *s, struct spectrum_stats *stats)
+{
+    unsigned int i;
+    int status;
+
+    pthread_mutex_lock(&s->lock);
+    s->finishing = true;
+    pthread_cond_broadcast(&s->cond);
+    pthread_mutex_unlock(&s->lock);
+
+    for (i = 0; s->workers != NULL && i < s->config->threads; i++) {
+        if (s->workers[i].started) {
+            pthread_join(s->workers[i].thread, NULL);
+        }
+    }
+
+    if (s->writer_started) {
+        pthread_join(s->writer, NULL);
+    }
+
+    if (fflush(s->config->out) != 0 && !s->failed) {
+        fprintf(stderr, "Failed to write output: %s\n", strerror(errno));
+        s->failed = true;
+    }
+
+    if (stats != NULL) {
+        *stats         = s->stats;
+        stats->elapsed = s->timing ? elapsed_since(&s->first) : 0;
+    }
+
+    status = s->failed ? -1 : 0;
+    free_state(s);
+
+    return status;
+}
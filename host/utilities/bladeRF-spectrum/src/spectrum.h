@@ -0,0 +1,111 @@
+/**
+ * @file spectrum.h
+ *
+ * @brief Multi-threaded, order-preserving power spectra of sweep steps
+ *
+ * Each step of a sweep is copied into a free slot. Worker threads window,
+ * FFT and average the slots' samples, and a writer thread streams the
+ * resulting power spectra out in step order. A fixed number of slots are in
+ * flight at once; if they are all busy, spectrum_submit() blocks, and the
+ * sweep falls behind its schedule and restarts.
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef SPECTRUM_H__
+#define SPECTRUM_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <libbladeRF.h>
+
+enum spectrum_output {
+    SPECTRUM_OUTPUT_CSV,    /* rtl_power-style CSV lines */
+    SPECTRUM_OUTPUT_BINARY, /* Records of float32 dBFS values */
+};
+
+/* Header of each binary record, in host byte order. `num_bins` float32
+ * dBFS values follow it. */
+struct spectrum_record {
+    uint32_t length;    /* Bytes following this field */
+    uint32_t sweep;     /* Sweep number, starting at 0 */
+    uint32_t step;      /* Step number within the sweep */
+    uint32_t num_bins;  /* Number of values */
+    uint64_t hz_low;    /* Lower edge of the first bin */
+    uint64_t hz_high;   /* Upper edge of the last bin */
+    uint64_t timestamp; /* Device timestamp of the step's first sample */
+};
+
+struct spectrum_config {
+    unsigned int fft_size;    /* FFT points */
+    unsigned int averages;    /* FFTs averaged into each step's spectrum */
+    unsigned int kept_bins;   /* Bins output from the center of each step */
+    unsigned int num_steps;   /* Steps per sweep */
+    bladerf_sample_rate samplerate;
+    unsigned int threads;     /* Worker threads */
+    bool dc_fix;              /* Interpolate over the DC bin */
+
+    enum spectrum_output output;
+    FILE *out;
+    bool verbose;             /* Report the sweep rate on stderr */
+};
+
+struct spectrum_stats {
+    uint64_t steps;   /* Steps written */
+    uint64_t sweeps;  /* Complete sweeps written */
+    uint64_t dropped; /* Steps too short to compute a spectrum from */
+    double elapsed;   /* Seconds from the first step to the last */
+};
+
+struct spectrum;
+
+/**
+ * Start the worker and writer threads
+ *
+ * @param[in]   config      Spectrum parameters. The config must remain valid
+ *                          until spectrum_finish().
+ *
+ * @return state on success, NULL on failure
+ */
+struct spectrum *spectrum_init(const struct spectrum_config *config);
+
+/**
+ * Queue a step's samples, which must be SC16 Q11. This copies the samples,
+ * waiting for a free slot if necessary.
+ *
+ * @param       s           State
+ * @param[in]   block       Block passed to the sweep callback
+ *
+ * @return 0 on success, -1 if output has failed and the sweep should end
+ */
+int spectrum_submit(struct spectrum *s, const struct bladerf_sweep_block *block);
+
+/**
+ * Write out the queued steps, stop the threads and free the state
+ *
+ * Errors are reported on stderr.
+ *
+ * @param       s           State
+ * @param[out]  stats       Statistics
+ *
+ * @return 0 on success, -1 if output failed
+ */
+int spectrum_finish(struct spectrum *s, struct spectrum_stats *stats);
+
+#endif
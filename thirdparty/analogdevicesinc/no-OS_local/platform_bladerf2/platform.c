@@ -1,6 +1,8 @@
 #include <stdint.h>
 
 #include "board/board.h"
+#include "board/bladerf2/rfic_snapshot.h"
+#include "board/bladerf2/rfic_spi_batch.h"
 
 #include "platform.h"
 
@@ -35,6 +37,21 @@ int spi_write(struct spi_device *spi, uint16_t cmd, const uint8_t *buf,
         data |= (((uint64_t)buf[i]) << 8*(7-i));
     }
 
+    /* Writes that start calibrations are dropped during a warm init */
+    if (rfic_snapshot_spi_write(dev, cmd, data)) {
+        return 0;
+    }
+
+    /* Single-byte writes are queued while an SPI batch is active */
+    if (rfic_spi_batch_write(dev, cmd, data, &status)) {
+        return (status < 0) ? -EIO : 0;
+    }
+
+    status = rfic_spi_batch_flush(dev);
+    if (status < 0) {
+        return -EIO;
+    }
+
     /* SPI transaction */
     status = dev->backend->ad9361_spi_write(dev, cmd, data);
     if (status < 0) {
@@ -58,10 +75,19 @@ int spi_read(struct spi_device *spi, uint16_t cmd, uint8_t *buf,
     uint64_t data = 0;
     unsigned int i;
 
-    /* SPI transaction */
-    status = dev->backend->ad9361_spi_read(dev, cmd, &data);
-    if (status < 0) {
-        return -EIO;
+    /* During a warm init, most reads are served from the RFIC snapshot */
+    if (!rfic_snapshot_spi_read(dev, cmd, &data)) {
+        /* Queued writes must land before the register is read */
+        status = rfic_spi_batch_flush(dev);
+        if (status < 0) {
+            return -EIO;
+        }
+
+        /* SPI transaction */
+        status = dev->backend->ad9361_spi_read(dev, cmd, &data);
+        if (status < 0) {
+            return -EIO;
+        }
     }
 
     /* Copy data to buf */